@@ -1,7 +1,9 @@
 // This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
 #pragma once
 
+#include <functional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace Luau
@@ -13,4 +15,11 @@ struct Comment;
 std::string toJson(AstNode* node);
 std::string toJson(AstNode* node, const std::vector<Comment>& commentLocations);
 
+// Receives consecutive pieces of the JSON document; the data is only valid for the duration of the call
+using AstJsonSink = std::function<void(std::string_view)>;
+
+// Streaming variants that pass the document to the sink while the tree is traversed, so that the whole document is never kept in memory
+void toJson(AstNode* node, const AstJsonSink& sink);
+void toJson(AstNode* node, const std::vector<Comment>& commentLocations, const AstJsonSink& sink);
+
 } // namespace Luau
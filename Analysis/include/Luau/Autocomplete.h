@@ -6,6 +6,7 @@
 
 #include <unordered_map>
 #include <string>
+#include <string_view>
 #include <memory>
 #include <optional>
 
@@ -15,6 +16,7 @@ namespace Luau
 struct Frontend;
 struct SourceModule;
 struct Module;
+struct TypeArena;
 struct TypeChecker;
 
 using ModulePtr = std::shared_ptr<Module>;
@@ -99,6 +101,20 @@ using StringCompletionCallback =
 
 AutocompleteResult autocomplete(Frontend& frontend, const ModuleName& moduleName, Position position, StringCompletionCallback callback);
 
+struct FragmentAutocompleteResult
+{
+    // Owns the AST and the types that the autocomplete result refers to
+    ModulePtr incrementalModule;
+    std::shared_ptr<TypeArena> clonedTypes;
+
+    AutocompleteResult acResults;
+};
+
+// Provides autocomplete for the edited source 'src' of a module without checking the whole module again
+// Only the top-level statement around the cursor is typechecked, the rest of the module comes from its last autocomplete check
+FragmentAutocompleteResult autocompleteFragment(
+    Frontend& frontend, const ModuleName& moduleName, std::string_view src, Position position, StringCompletionCallback callback);
+
 constexpr char kGeneratedAnonymousFunctionEntryName[] = "function (anonymous autofilled)";
 
 } // namespace Luau
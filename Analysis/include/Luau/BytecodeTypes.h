@@ -0,0 +1,21 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#pragma once
+
+#include "Luau/Bytecode.h"
+#include "Luau/DenseHash.h"
+#include "Luau/TypeFwd.h"
+
+namespace Luau
+{
+
+struct AstLocal;
+struct Module;
+
+// Converts a type to the closest bytecode type that is checked by CodeGen; types that can't be described are reported as 'any'
+LuauBytecodeType getBytecodeType(TypeId ty, const char* vectorType = nullptr);
+
+// Collects inferred types of function arguments for the compiler (see Luau::InferredTypes in Compiler.h)
+// Module has to be checked with FrontendOptions::retainFullTypeGraphs so that expression types are kept after the check
+DenseHashMap<const AstLocal*, LuauBytecodeType> getInferredArgumentTypes(const Module& module, const char* vectorType = nullptr);
+
+} // namespace Luau
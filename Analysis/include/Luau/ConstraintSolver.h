@@ -8,6 +8,7 @@
 #include "Luau/Location.h"
 #include "Luau/Module.h"
 #include "Luau/Normalize.h"
+#include "Luau/SolverProfile.h"
 #include "Luau/ToString.h"
 #include "Luau/Type.h"
 #include "Luau/TypeCheckLimits.h"
@@ -95,6 +96,11 @@ struct ConstraintSolver
     DcrLogger* logger;
     TypeCheckLimits limits;
 
+    // When set, time and dispatch attempts are recorded for every constraint, see getProfile
+    bool profile = false;
+    std::vector<SolverProfileEntry> profileByKind;
+    DenseHashMap<const Constraint*, SolverProfileEntry> profileByConstraint{nullptr};
+
     explicit ConstraintSolver(NotNull<Normalizer> normalizer, NotNull<Scope> rootScope, std::vector<NotNull<Constraint>> constraints,
         ModuleName moduleName, NotNull<ModuleResolver> moduleResolver, std::vector<RequireCycle> requireCycles, DcrLogger* logger,
         TypeCheckLimits limits);
@@ -102,6 +108,9 @@ struct ConstraintSolver
     // Randomize the order in which to dispatch constraints
     void randomize(unsigned seed);
 
+    // Summarize the recorded dispatch times by constraint kind and by the slowest constraints
+    SolverProfile getProfile() const;
+
     /**
      * Attempts to dispatch all pending constraints and reach a type solution
      * that satisfies all of the constraints.
@@ -54,7 +54,15 @@ private:
     DefArena defArena;
     RefinementKeyArena keyArena;
 
-    DenseHashMap<const AstExpr*, const Def*> astDefs{nullptr};
+    // Every visited expression has a def and may have a refinement key. Keeping both in one entry stores each
+    // expression pointer once and lets the builder fetch both with a single probe.
+    struct ExprEntry
+    {
+        const Def* def = nullptr;
+        const RefinementKey* key = nullptr;
+    };
+
+    DenseHashMap<const AstExpr*, ExprEntry> astExprs{nullptr};
 
     // Sometimes we don't have the AstExprLocal* but we have AstLocal*, and sometimes we need to extract that DefId.
     DenseHashMap<const AstLocal*, const Def*> localDefs{nullptr};
@@ -67,8 +75,6 @@ private:
     // previous type implicitly in an rvalue position. This map provides the previous binding.
     DenseHashMap<const AstExpr*, const Def*> compoundAssignDefs{nullptr};
 
-    DenseHashMap<const AstExpr*, const RefinementKey*> astRefinementKeys{nullptr};
-
     friend struct DataFlowGraphBuilder;
 };
 
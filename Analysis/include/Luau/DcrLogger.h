@@ -132,11 +132,14 @@ struct DcrLogger
 
     void captureTypeCheckError(const TypeError& error);
 
+    void captureSolverProfile(const SolverProfile& profile);
+
 private:
     ConstraintGenerationLog generationLog;
     std::unordered_map<NotNull<const Constraint>, std::vector<ConstraintBlockTarget>> constraintBlocks;
     TypeSolveLog solveLog;
     TypeCheckLog checkLog;
+    std::optional<SolverProfile> solverProfile;
 
     ToStringOptions opts{true};
 
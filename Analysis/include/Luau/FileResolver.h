@@ -1,7 +1,9 @@
 // This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
 #pragma once
 
+#include <memory>
 #include <string>
+#include <string_view>
 #include <optional>
 
 namespace Luau
@@ -23,6 +25,15 @@ struct SourceCode
 
     std::string source;
     Type type;
+
+    // When set, the source text is read from this view instead of 'source', so that resolvers can provide memory they own
+    // (like a memory-mapped file) without copying it; the view is kept alive for as long as the SourceCode is
+    std::shared_ptr<const std::string_view> view = nullptr;
+
+    std::string_view text() const
+    {
+        return view ? *view : std::string_view(source);
+    }
 };
 
 struct ModuleInfo
@@ -10,6 +10,7 @@
 #include "Luau/TypeCheckLimits.h"
 #include "Luau/Variant.h"
 
+#include <memory>
 #include <mutex>
 #include <string>
 #include <vector>
@@ -30,7 +31,9 @@ struct ModuleResolver;
 struct ParseResult;
 struct HotComment;
 struct BuildQueueItem;
+struct ParseQueueItem;
 struct FrontendCancellationToken;
+struct ModuleInterfaceCache;
 
 struct LoadDefinitionFileResult
 {
@@ -77,6 +80,18 @@ struct SourceNode
     bool dirtyModule = true;
     bool dirtyModuleForAutocomplete = true;
     double autocompleteLimitsMult = 1.0;
+
+    // Hash of the source text and environment, computed when the source is read
+    uint64_t sourceHash = 0;
+
+    // Hash of the module interface after the last check, used by the check keys of dependent modules; 0 if not known
+    uint64_t interfaceHash = 0;
+
+    // Hash of the source, configuration and dependency interfaces used in the last check; 0 if the module has to be checked again
+    uint64_t checkKey = 0;
+
+    // True if the module was checked with full type graphs retained
+    bool hasFullTypeGraphs = false;
 };
 
 struct FrontendOptions
@@ -106,6 +121,30 @@ struct FrontendOptions
 
     // When true, some internal complexity limits will be scaled down for modules that miss the limit set by moduleTimeLimitSec
     bool applyInternalLimitScaling = false;
+
+    // When true together with retainFullTypeGraphs, full type information is
+    // only retained for the modules that were requested to be checked. Their
+    // dependencies only keep the public interface, and are checked again when
+    // they are requested themselves.
+    bool compactDependencyTypeGraphs = false;
+
+    // When true, the new solver records where it spends time in Module::solverProfile and Frontend::Stats::solverProfile.
+    bool profileSolver = false;
+
+    // When true, each module that is checked adds a record with its phase times and type arena sizes to Frontend::Stats::modules.
+    bool recordModuleStats = false;
+
+    // When true together with runLintChecks, only lint results are produced. Type errors are not reported, and
+    // modules aren't type checked at all unless one of the enabled lints uses type information.
+    bool lintOnly = false;
+
+    // When true, modules whose results were delivered to the 'streamResult' callback of checkQueuedModules
+    // release their errors, lint results and full type graphs; only their public interface is kept.
+    // Modules are modified in place, so this can't be combined with publishSnapshots.
+    bool releaseStreamedResults = false;
+
+    // When true, check and checkQueuedModules publish a new FrontendSnapshot after they are done, see Frontend::getSnapshot.
+    bool publishSnapshots = false;
 };
 
 struct CheckResult
@@ -136,8 +175,56 @@ private:
     std::unordered_map<ModuleName, ModulePtr> modules;
 };
 
+// Read-only view of the module graph at the time it was published by Frontend::publishSnapshot
+// Snapshots are never modified, so any number of threads can query them while the frontend checks the next version; modules that
+// didn't change share their entries with the previous snapshot
+struct FrontendSnapshot
+{
+    struct ModuleEntry
+    {
+        std::shared_ptr<const SourceModule> sourceModule;
+        ModulePtr module;                // nullptr if the module wasn't checked
+        ModulePtr moduleForAutocomplete; // nullptr if the module wasn't checked for autocomplete
+        std::vector<ModuleName> dependencies;
+
+        // the module was changed after the last check, so its results are out of date
+        bool dirtyModule = true;
+        bool dirtyModuleForAutocomplete = true;
+    };
+
+    // increases with each snapshot that the frontend publishes
+    uint64_t version = 0;
+
+    std::unordered_map<ModuleName, std::shared_ptr<const ModuleEntry>> modules;
+
+    const ModuleEntry* getEntry(const ModuleName& name) const;
+    const SourceModule* getSourceModule(const ModuleName& name) const;
+    ModulePtr getModule(const ModuleName& name, bool forAutocomplete = false) const;
+
+    // Same as Frontend::getCheckResult, but the results come from the snapshot
+    std::optional<CheckResult> getCheckResult(const ModuleName& name, bool accumulateNested, bool forAutocomplete = false) const;
+};
+
 struct Frontend
 {
+    struct ModuleStats
+    {
+        ModuleName name;
+
+        double timeCheck = 0;
+        double timeConstraintGeneration = 0;
+        double timeSolve = 0;
+        double timeTypeCheck = 0;
+        double timeLint = 0;
+
+        // Arenas only grow during the check, so their size when it completes is the peak; type graphs can be dropped afterwards
+        size_t types = 0;
+        size_t typePacks = 0;
+        size_t interfaceTypes = 0;
+        size_t interfaceTypePacks = 0;
+        size_t arenaBytes = 0;
+    };
+
     struct Stats
     {
         size_t files = 0;
@@ -150,6 +237,11 @@ struct Frontend
         double timeParse = 0;
         double timeCheck = 0;
         double timeLint = 0;
+
+        SolverProfile solverProfile;
+
+        // Filled in when FrontendOptions::recordModuleStats is set, in the order in which modules completed
+        std::vector<ModuleStats> modules;
     };
 
     Frontend(FileResolver* fileResolver, ConfigResolver* configResolver, const FrontendOptions& options = {});
@@ -183,24 +275,43 @@ struct Frontend
     void registerBuiltinDefinition(const std::string& name, std::function<void(Frontend&, GlobalTypes&, ScopePtr)>);
     void applyBuiltinDefinitionToEnvironment(const std::string& environmentName, const std::string& definitionName);
 
+    // When interfaceCache is set, checked declarations are stored in it under a key derived from the source and are loaded without parsing
+    // or type checking the next time the same source is loaded; parseResult and sourceModule of such results are empty
     LoadDefinitionFileResult loadDefinitionFile(GlobalTypes& globals, ScopePtr targetScope, std::string_view source, const std::string& packageName,
         bool captureComments, bool typeCheckForAutocomplete = false);
 
     // Batch module checking. Queue modules and check them together, retrieve results with 'getCheckResult'
     // If provided, 'executeTask' function is allowed to call the 'task' function on any thread and return without waiting for 'task' to complete
+    // If provided, 'streamResult' receives the result of each checked or already up-to-date queued module (without errors of its dependencies)
+    // as soon as it's available; it is called on the thread that called checkQueuedModules
     void queueModuleCheck(const std::vector<ModuleName>& names);
     void queueModuleCheck(const ModuleName& name);
     std::vector<ModuleName> checkQueuedModules(std::optional<FrontendOptions> optionOverride = {},
-        std::function<void(std::function<void()> task)> executeTask = {}, std::function<void(size_t done, size_t total)> progress = {});
+        std::function<void(std::function<void()> task)> executeTask = {}, std::function<void(size_t done, size_t total)> progress = {},
+        std::function<void(const ModuleName& name, CheckResult result)> streamResult = {});
 
     std::optional<CheckResult> getCheckResult(const ModuleName& name, bool accumulateNested, bool forAutocomplete = false);
 
+    // Typecheck a standalone source module for autocomplete in the given environment without reading or updating the module cache
+    // This is used to re-check a fragment of a module that was edited since its last autocomplete check
+    ModulePtr checkFragment(const SourceModule& sourceModule, const ScopePtr& environmentScope, std::optional<FrontendOptions> optionOverride = {});
+
+    // Publish the current state of all modules as a new snapshot; must be called on the thread that checks modules
+    std::shared_ptr<const FrontendSnapshot> publishSnapshot();
+
+    // Get the last published snapshot, or nullptr if there is none; can be called on any thread, including while modules are being checked
+    std::shared_ptr<const FrontendSnapshot> getSnapshot() const;
+
 private:
     ModulePtr check(const SourceModule& sourceModule, Mode mode, std::vector<RequireCycle> requireCycles, std::optional<ScopePtr> environmentScope,
         bool forAutocomplete, bool recordJsonLog, TypeCheckLimits typeCheckLimits);
 
     std::pair<SourceNode*, SourceModule*> getSourceNode(const ModuleName& name);
-    SourceModule parse(const ModuleName& name, std::string_view src, const ParseOptions& parseOptions);
+    SourceModule parse(const ModuleName& name, std::string_view src, const ParseOptions& parseOptions, Stats& parseStats) const;
+
+    void parseQueueItem(ParseQueueItem& item) const;
+    std::pair<SourceNode*, SourceModule*> recordParseQueueItem(ParseQueueItem& item);
+    void parseGraphSources(const std::vector<ModuleName>& roots, bool forAutocomplete, std::function<void(std::function<void()> task)> executeTask);
 
     bool parseGraph(
         std::vector<ModuleName>& buildQueue, const ModuleName& root, bool forAutocomplete, std::function<bool(const ModuleName&)> canSkip = {});
@@ -210,6 +321,8 @@ private:
     void checkBuildQueueItem(BuildQueueItem& item);
     void checkBuildQueueItems(std::vector<BuildQueueItem>& items);
     void recordItemResult(const BuildQueueItem& item);
+    void streamCheckResult(const ModuleName& name, const FrontendOptions& frontendOptions,
+        const std::function<void(const ModuleName& name, CheckResult result)>& streamResult);
 
     static LintResult classifyLints(const std::vector<LintWarning>& warnings, const Config& config);
 
@@ -218,6 +331,9 @@ private:
     std::unordered_map<std::string, ScopePtr> environments;
     std::unordered_map<std::string, std::function<void(Frontend&, GlobalTypes&, ScopePtr)>> builtinDefinitions;
 
+    // only accessed with std::atomic_load/std::atomic_store
+    std::shared_ptr<const FrontendSnapshot> snapshot;
+
     BuiltinTypes builtinTypes_;
 
 public:
@@ -237,6 +353,13 @@ public:
     std::function<void(const ModuleName& name, const ScopePtr& scope, bool forAutocomplete)> prepareModuleScope;
     std::function<void(const ModuleName& name, std::string log)> writeJsonLog = {};
 
+    // When set, interfaces of the modules that checked without errors are stored in the cache and modules with unchanged sources and
+    // dependency interfaces are not checked again. Cache keys don't include prepareModuleScope effects and definition files,
+    // so the cache has to be cleared when those change.
+    // Only used by the old solver when full type graphs are not retained; modules loaded from the cache have no errors or lint warnings.
+    // Declarations of definition files are stored in the cache as well, see loadDefinitionFile.
+    ModuleInterfaceCache* interfaceCache = nullptr;
+
     std::unordered_map<ModuleName, std::shared_ptr<SourceNode>> sourceNodes;
     std::unordered_map<ModuleName, std::shared_ptr<SourceModule>> sourceModules;
     std::unordered_map<ModuleName, RequireTraceResult> requireTrace;
@@ -14,6 +14,7 @@ namespace Luau
 struct GlobalTypes
 {
     explicit GlobalTypes(NotNull<BuiltinTypes> builtinTypes);
+    ~GlobalTypes();
 
     NotNull<BuiltinTypes> builtinTypes; // Global types are based on builtin types
 
@@ -30,4 +30,7 @@ std::vector<LintWarning> lint(AstStat* root, const AstNameTable& names, const Sc
 
 std::vector<AstName> getDeprecatedGlobals(const AstNameTable& names);
 
+// Returns true if any of the enabled lints use the type information of the module
+bool hasTypeAwareLints(const LintOptions& options);
+
 } // namespace Luau
@@ -4,9 +4,12 @@
 #include "Luau/Error.h"
 #include "Luau/Linter.h"
 #include "Luau/FileResolver.h"
+#include "Luau/FlatHash.h"
 #include "Luau/ParseOptions.h"
 #include "Luau/ParseResult.h"
 #include "Luau/Scope.h"
+#include "Luau/SolverProfile.h"
+#include "Luau/ToString.h"
 #include "Luau/TypeArena.h"
 
 #include <memory>
@@ -77,7 +80,7 @@ struct Module
 
     std::vector<std::pair<Location, ScopePtr>> scopes; // never empty
 
-    DenseHashMap<const AstExpr*, TypeId> astTypes{nullptr};
+    FlatHashMap<const AstExpr*, TypeId> astTypes{nullptr};
     DenseHashMap<const AstExpr*, TypePackId> astTypePacks{nullptr};
     DenseHashMap<const AstExpr*, TypeId> astExpectedTypes{nullptr};
 
@@ -114,12 +117,27 @@ struct Module
     Mode mode;
     SourceCode::Type type;
     double checkDurationSec = 0.0;
+
+    // Time spent in the phases of the check; the old solver only records typeCheckDurationSec, which covers its whole inference pass
+    double constraintGenerationDurationSec = 0.0;
+    double solveDurationSec = 0.0;
+    double typeCheckDurationSec = 0.0;
+
+    SolverProfile solverProfile;
     bool timeout = false;
     bool cancelled = false;
 
     TypePackId returnType = nullptr;
     std::unordered_map<Name, TypeFun> exportedTypeBindings;
 
+    // Interface types can refer to the interface types of required modules, which have to outlive this module
+    // Frontend only records them when its dependencies might be checked again without this module
+    std::vector<std::shared_ptr<Module>> requiredModules;
+
+    // Stringified types of this module for hover, autocomplete and diagnostics.
+    // Only valid to use once the module has been checked, since types are frozen then.
+    ToStringCache toStringCache;
+
     bool hasModuleScope() const;
     ScopePtr getModuleScope() const;
 
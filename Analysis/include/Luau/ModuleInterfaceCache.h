@@ -0,0 +1,60 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#pragma once
+
+#include "Luau/NotNull.h"
+#include "Luau/TypeFwd.h"
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace Luau
+{
+
+struct Module;
+struct Scope;
+
+using ScopePtr = std::shared_ptr<Scope>;
+
+// Storage for serialized module interfaces. Frontend computes the keys from the module source, its configuration and the interfaces of
+// its dependencies, so the storage doesn't need to perform any validation of its own.
+// Frontend can call these methods from multiple threads when modules are checked in parallel.
+struct ModuleInterfaceCache
+{
+    virtual ~ModuleInterfaceCache() {}
+
+    virtual std::optional<std::string> readInterface(const std::string& key) = 0;
+    virtual void writeInterface(const std::string& key, const std::string& data) = 0;
+};
+
+// Combines a cache local to the machine with one that is shared between machines, such as a network store used by CI agents.
+// Keys don't depend on the machine, so an interface stored by one machine is loaded by others checking the same sources.
+// Interfaces found only in the shared cache are copied into the local one; new interfaces are written to both, unless the shared
+// cache is read only. Either cache can be null.
+struct LayeredModuleInterfaceCache : ModuleInterfaceCache
+{
+    LayeredModuleInterfaceCache(ModuleInterfaceCache* local, ModuleInterfaceCache* shared, bool writeShared = true);
+
+    std::optional<std::string> readInterface(const std::string& key) override;
+    void writeInterface(const std::string& key, const std::string& data) override;
+
+    ModuleInterfaceCache* local = nullptr;
+    ModuleInterfaceCache* shared = nullptr;
+    bool writeShared = true;
+};
+
+// Serializes the public interface of a checked module: return type pack, exported type bindings and declared globals.
+// Types owned by the global scope are stored by name and have to be available under the same name when the interface is loaded.
+// Returns an empty string when the interface has types that can't be serialized, such as classes that aren't a part of the global scope.
+std::string serializeModuleInterface(const Module& module, NotNull<BuiltinTypes> builtinTypes, const ScopePtr& globalScope);
+
+// Serializes the declarations of a checked definition file in the same format, including the classes it declares.
+// Loading the data creates new class types, so it should only be used for modules whose declarations are persisted once.
+std::string serializeDefinitionModule(const Module& module, NotNull<BuiltinTypes> builtinTypes, const ScopePtr& globalScope);
+
+// Fills in the public interface of the module from serialized data, allocating types in module.interfaceTypes
+// Returns false if the data is malformed or refers to global types that no longer exist; the module must be discarded in that case
+bool deserializeModuleInterface(Module& module, std::string_view data, NotNull<BuiltinTypes> builtinTypes, const ScopePtr& globalScope);
+
+} // namespace Luau
@@ -1,6 +1,7 @@
 // This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
 #pragma once
 
+#include "Luau/FlatHash.h"
 #include "Luau/NotNull.h"
 #include "Luau/Set.h"
 #include "Luau/TypeFwd.h"
@@ -9,6 +10,7 @@
 #include <initializer_list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 
@@ -311,6 +313,22 @@ struct NormalizedType
 
 
 
+// Normal forms of persistent types are shared by the normalizers of all modules.
+// Only normal forms that refer to persistent types alone are stored, so entries stay valid for as long as the global types do.
+class SharedNormalizerCache
+{
+    mutable std::mutex mutex;
+    std::unordered_map<TypeId, std::unique_ptr<NormalizedType>> cachedNormals;
+
+public:
+    const NormalizedType* find(TypeId ty) const;
+
+    // Returns the stored normal form, which is a different one if another thread stored it first
+    const NormalizedType* insert(TypeId ty, std::unique_ptr<NormalizedType> norm);
+
+    void clear();
+};
+
 class Normalizer
 {
     std::unordered_map<TypeId, std::unique_ptr<NormalizedType>> cachedNormals;
@@ -318,8 +336,8 @@ class Normalizer
     std::unordered_map<const TypeIds*, TypeId> cachedUnions;
     std::unordered_map<const TypeIds*, std::unique_ptr<TypeIds>> cachedTypeIds;
 
-    DenseHashMap<TypeId, bool> cachedIsInhabited{nullptr};
-    DenseHashMap<std::pair<TypeId, TypeId>, bool, TypeIdPairHash> cachedIsInhabitedIntersection{{nullptr, nullptr}};
+    FlatHashMap<TypeId, bool> cachedIsInhabited{nullptr};
+    FlatHashMap<std::pair<TypeId, TypeId>, bool, TypeIdPairHash> cachedIsInhabitedIntersection{{nullptr, nullptr}};
 
     bool withinResourceLimits();
 
@@ -52,7 +52,8 @@ struct Scope
     std::unordered_map<Name, Location> typeAliasLocations;
     std::unordered_map<Name, Location> typeAliasNameLocations;
     std::unordered_map<Name, ModuleName> importedModules; // Mapping from the name in the require statement to the internal moduleName.
-    std::unordered_map<Name, std::unordered_map<Name, TypeFun>> importedTypeBindings;
+    // Exported type bindings of required modules are shared with the module, unless they had to be changed for this scope
+    std::unordered_map<Name, std::shared_ptr<const std::unordered_map<Name, TypeFun>>> importedTypeBindings;
 
     DenseHashSet<Name> builtinTypeNames{""};
     void addBuiltinTypeBinding(const Name& name, const TypeFun& tyFun);
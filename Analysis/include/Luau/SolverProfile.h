@@ -0,0 +1,51 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#pragma once
+
+#include "Luau/Location.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace Luau
+{
+
+struct SolverProfileEntry
+{
+    double time = 0.0;
+
+    // Number of times constraints were handed to the solver, including attempts that left them blocked
+    size_t attempts = 0;
+    size_t dispatched = 0;
+};
+
+struct HotConstraint
+{
+    std::string moduleName;
+    std::string kind;
+    Location location;
+
+    SolverProfileEntry entry;
+};
+
+// Summary of the time spent in the constraint solver and in the type checker that runs after it
+// Only collected when FrontendOptions::profileSolver is set
+struct SolverProfile
+{
+    static constexpr size_t kHotConstraintLimit = 16;
+
+    // Keyed by the name of the constraint kind
+    std::map<std::string, SolverProfileEntry> constraintKinds;
+
+    // Constraints that took the most time, slowest first
+    std::vector<HotConstraint> hotConstraints;
+
+    double timeSolve = 0.0;
+    double timeTypeCheck = 0.0;
+
+    bool empty() const;
+
+    void merge(const SolverProfile& other);
+};
+
+} // namespace Luau
@@ -65,6 +65,10 @@ struct SubtypingResult
     bool isSubtype = false;
     bool normalizationTooComplex = false;
     bool isCacheable = true;
+    /// Whether the result depends on the scope of the test, which determines
+    /// how generics are treated. Such results are not shared between
+    /// Subtyping instances.
+    bool isScopeDependent = false;
     ErrorVec errors;
     /// The reason for isSubtype to be false. May not be present even if
     /// isSubtype is false, depending on the input types.
@@ -86,6 +90,8 @@ struct SubtypingResult
     static SubtypingResult any(const std::vector<SubtypingResult>& results);
 };
 
+using SubtypingResultCache = DenseHashMap<std::pair<TypeId, TypeId>, SubtypingResult, TypePairHash>;
+
 struct SubtypingEnvironment
 {
     struct GenericBounds
@@ -101,7 +107,7 @@ struct SubtypingEnvironment
     DenseHashMap<TypeId, GenericBounds> mappedGenerics{nullptr};
     DenseHashMap<TypePackId, TypePackId> mappedGenericPacks{nullptr};
 
-    DenseHashMap<std::pair<TypeId, TypeId>, SubtypingResult, TypePairHash> ephemeralCache{{}};
+    SubtypingResultCache ephemeralCache{{}};
 };
 
 struct Subtyping
@@ -126,6 +132,11 @@ struct Subtyping
 
     SeenSet seenTypes{{}};
 
+    // Optional cache of results that do not depend on the scope, shared with
+    // other Subtyping instances that test the same types with the same
+    // normalizer, like the overload resolvers created while checking a module.
+    SubtypingResultCache* sharedCache = nullptr;
+
     Subtyping(NotNull<BuiltinTypes> builtinTypes, NotNull<TypeArena> typeArena, NotNull<Normalizer> normalizer,
         NotNull<InternalErrorReporter> iceReporter, NotNull<Scope> scope);
 
@@ -136,7 +147,7 @@ struct Subtyping
     Subtyping& operator=(Subtyping&&) = default;
 
     // Only used by unit tests to test that the cache works.
-    const DenseHashMap<std::pair<TypeId, TypeId>, SubtypingResult, TypePairHash>& peekCache() const
+    const SubtypingResultCache& peekCache() const
     {
         return resultCache;
     }
@@ -149,7 +160,7 @@ struct Subtyping
     SubtypingResult isSubtype(TypePackId subTy, TypePackId superTy);
 
 private:
-    DenseHashMap<std::pair<TypeId, TypeId>, SubtypingResult, TypePairHash> resultCache{{}};
+    SubtypingResultCache resultCache{{}};
 
     SubtypingResult cache(SubtypingEnvironment& env, SubtypingResult res, TypeId subTy, TypeId superTy);
 
@@ -70,6 +70,52 @@ ToStringResult toStringDetailed(TypePackId ty, ToStringOptions& opts);
 std::string toString(TypeId ty, ToStringOptions& opts);
 std::string toString(TypePackId ty, ToStringOptions& opts);
 
+// Remembers stringified types so that asking for the same type again does not walk it again.
+// This is only sound for types that no longer change, such as those of a module that has
+// finished type checking. Calls with a non-empty nameMap or namedFunctionOverrideArgNames
+// are passed through uncached, since their output depends on names chosen by earlier calls.
+struct ToStringCache
+{
+    ToStringResult toStringDetailed(TypeId ty, ToStringOptions& opts);
+    ToStringResult toStringDetailed(TypePackId tp, ToStringOptions& opts);
+
+    std::string toString(TypeId ty, ToStringOptions& opts);
+    std::string toString(TypePackId tp, ToStringOptions& opts);
+
+    size_t size() const;
+    void clear();
+
+private:
+    struct Key
+    {
+        const void* ty;
+        const Scope* scope;
+        size_t maxTableLength;
+        size_t maxTypeLength;
+        size_t compositeTypesSingleLineLimit;
+        unsigned flags;
+
+        bool operator==(const Key& rhs) const;
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key& key) const;
+    };
+
+    struct Entry
+    {
+        ToStringResult result;
+        // Names generated for free types and cycles, handed back to the caller on a hit.
+        ToStringNameMap nameMap;
+    };
+
+    template<typename T>
+    ToStringResult lookup(T ty, ToStringOptions& opts);
+
+    std::unordered_map<Key, Entry, KeyHash> entries;
+};
+
 // These overloads are selected when a temporary ToStringOptions is passed. (eg
 // via an initializer list)
 inline std::string toString(TypePackId ty, ToStringOptions&& opts)
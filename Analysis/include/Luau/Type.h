@@ -847,6 +847,9 @@ public:
     const TypePackId neverTypePack;
     const TypePackId uninhabitableTypePack;
     const TypePackId errorTypePack;
+
+    // Normal forms of persistent types, shared by all normalizers that use these builtin types
+    std::unique_ptr<class SharedNormalizerCache> normalizerCache;
 };
 
 void persist(TypeId ty);
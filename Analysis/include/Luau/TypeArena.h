@@ -1,10 +1,13 @@
 // This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
 #pragma once
 
+#include "Luau/DenseHash.h"
 #include "Luau/TypedAllocator.h"
 #include "Luau/Type.h"
 #include "Luau/TypePack.h"
 
+#include <string>
+
 #include <vector>
 
 namespace Luau
@@ -19,6 +22,10 @@ struct TypeArena
     // Owning module, if any
     Module* owningModule = nullptr;
 
+    // Types shared by addInternedType, keyed by their structure
+    DenseHashMap<std::string, TypeId> internedTypes{""};
+    DenseHashSet<TypeId> internedTypeSet{nullptr};
+
     void clear();
 
     template<typename T>
@@ -32,6 +39,12 @@ struct TypeArena
 
     TypeId addTV(Type&& tv);
 
+    // Structurally identical singletons, and unions and intersections of persistent or interned types, are allocated only once
+    // Interned types are shared between all their uses, so they must not be mutated
+    TypeId addInternedType(const SingletonType& tv);
+    TypeId addInternedType(UnionType tv);
+    TypeId addInternedType(IntersectionType tv);
+
     TypeId freshType(TypeLevel level);
     TypeId freshType(Scope* scope);
     TypeId freshType(Scope* scope, TypeLevel level);
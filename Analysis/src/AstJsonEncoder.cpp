@@ -14,19 +14,43 @@ namespace Luau
 struct AstJsonEncoder : public AstVisitor
 {
     static constexpr int CHUNK_SIZE = 1024;
+    static constexpr int SINK_BUFFER_SIZE = 64 * 1024;
     std::vector<std::string> chunks;
     bool comma = false;
 
+    // when set, output is passed to the sink in blocks of roughly SINK_BUFFER_SIZE bytes instead of being accumulated
+    const AstJsonSink* sink = nullptr;
+
     AstJsonEncoder()
     {
         newChunk();
     }
 
+    AstJsonEncoder(const AstJsonSink& sink)
+        : sink(&sink)
+    {
+        chunks.emplace_back();
+        chunks.back().reserve(SINK_BUFFER_SIZE);
+    }
+
     std::string str()
     {
         return join(chunks, "");
     }
 
+    void flush()
+    {
+        LUAU_ASSERT(sink);
+
+        std::string& buffer = chunks.back();
+
+        if (!buffer.empty())
+        {
+            (*sink)(buffer);
+            buffer.clear();
+        }
+    }
+
     bool pushComma()
     {
         bool c = comma;
@@ -47,6 +71,17 @@ struct AstJsonEncoder : public AstVisitor
 
     void appendChunk(std::string_view sv)
     {
+        if (sink)
+        {
+            std::string& buffer = chunks.back();
+            buffer.append(sv.data(), sv.size());
+
+            if (buffer.size() >= SINK_BUFFER_SIZE)
+                flush();
+
+            return;
+        }
+
         if (sv.size() > CHUNK_SIZE)
         {
             chunks.emplace_back(sv);
@@ -1273,4 +1308,22 @@ std::string toJson(AstNode* node, const std::vector<Comment>& commentLocations)
     return encoder.str();
 }
 
+void toJson(AstNode* node, const AstJsonSink& sink)
+{
+    AstJsonEncoder encoder(sink);
+    node->visit(&encoder);
+    encoder.flush();
+}
+
+void toJson(AstNode* node, const std::vector<Comment>& commentLocations, const AstJsonSink& sink)
+{
+    AstJsonEncoder encoder(sink);
+    encoder.writeRaw(R"({"root":)");
+    node->visit(&encoder);
+    encoder.writeRaw(R"(,"commentLocations":[)");
+    encoder.writeComments(commentLocations);
+    encoder.writeRaw("]}");
+    encoder.flush();
+}
+
 } // namespace Luau
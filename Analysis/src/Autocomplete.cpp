@@ -3,7 +3,9 @@
 
 #include "Luau/AstQuery.h"
 #include "Luau/BuiltinDefinitions.h"
+#include "Luau/Clone.h"
 #include "Luau/Frontend.h"
+#include "Luau/Parser.h"
 #include "Luau/ToString.h"
 #include "Luau/Subtyping.h"
 #include "Luau/TypeInfer.h"
@@ -455,7 +457,7 @@ AutocompleteEntryMap autocompleteModuleTypes(const Module& module, Position posi
     {
         if (auto it = scope->importedTypeBindings.find(std::string(moduleName)); it != scope->importedTypeBindings.end())
         {
-            for (const auto& [name, ty] : it->second)
+            for (const auto& [name, ty] : *it->second)
                 result[name] = AutocompleteEntry{AutocompleteEntryKind::Type, ty.type};
 
             break;
@@ -1847,4 +1849,135 @@ AutocompleteResult autocomplete(Frontend& frontend, const ModuleName& moduleName
     return autocomplete(*sourceModule, module, builtinTypes, &typeArena, globalScope, position, callback);
 }
 
+static void collectTopLevelLocals(AstStat* stat, std::unordered_map<std::string, std::vector<AstLocal*>>& locals)
+{
+    if (AstStatLocal* statLocal = stat->as<AstStatLocal>())
+    {
+        for (AstLocal* local : statLocal->vars)
+            locals[local->name.value].push_back(local);
+    }
+    else if (AstStatLocalFunction* localFunction = stat->as<AstStatLocalFunction>())
+    {
+        locals[localFunction->name->name.value].push_back(localFunction->name);
+    }
+}
+
+// Fragments are checked in a copy of the module scope from the last autocomplete check
+// Bindings of top-level locals are matched with the locals of the edited source by name and declaration order and their types are cloned,
+// so that checking the fragment can't modify the types of the previous module
+static ScopePtr makeFragmentEnvironment(
+    const Module& staleModule, const AstStatBlock& root, size_t fragmentIndex, TypeArena& arena, NotNull<BuiltinTypes> builtinTypes)
+{
+    ScopePtr staleScope = staleModule.getModuleScope();
+    ScopePtr environment = std::make_shared<Scope>(staleScope->parent);
+
+    environment->exportedTypeBindings = staleScope->exportedTypeBindings;
+    environment->privateTypeBindings = staleScope->privateTypeBindings;
+    environment->importedTypeBindings = staleScope->importedTypeBindings;
+    environment->importedModules = staleScope->importedModules;
+
+    CloneState cloneState{builtinTypes};
+
+    std::unordered_map<std::string, std::vector<std::pair<AstLocal*, const Binding*>>> staleLocals;
+
+    for (const auto& [symbol, binding] : staleScope->bindings)
+    {
+        if (symbol.local)
+        {
+            staleLocals[symbol.local->name.value].push_back({symbol.local, &binding});
+        }
+        else
+        {
+            Binding copy = binding;
+            copy.typeId = clone(binding.typeId, arena, cloneState);
+            environment->bindings[symbol] = std::move(copy);
+        }
+    }
+
+    std::unordered_map<std::string, std::vector<AstLocal*>> locals;
+
+    for (size_t i = 0; i < fragmentIndex; ++i)
+        collectTopLevelLocals(root.body.data[i], locals);
+
+    for (const auto& [name, declared] : locals)
+    {
+        auto it = staleLocals.find(name);
+        if (it == staleLocals.end())
+            continue;
+
+        std::vector<std::pair<AstLocal*, const Binding*>>& previous = it->second;
+        std::sort(previous.begin(), previous.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs.first->location.begin < rhs.first->location.begin;
+        });
+
+        for (size_t i = 0; i < declared.size() && i < previous.size(); ++i)
+        {
+            Binding copy = *previous[i].second;
+            copy.typeId = clone(copy.typeId, arena, cloneState);
+            copy.location = declared[i]->location;
+            environment->bindings[declared[i]] = std::move(copy);
+        }
+    }
+
+    return environment;
+}
+
+FragmentAutocompleteResult autocompleteFragment(
+    Frontend& frontend, const ModuleName& moduleName, std::string_view src, Position position, StringCompletionCallback callback)
+{
+    ModulePtr staleModule = frontend.moduleResolverForAutocomplete.getModule(moduleName);
+    if (!staleModule || staleModule->scopes.empty())
+        return {};
+
+    SourceModule sourceModule;
+    sourceModule.name = moduleName;
+    sourceModule.humanReadableName = staleModule->humanReadableName;
+    sourceModule.type = staleModule->type;
+
+    ParseOptions parseOptions = frontend.configResolver->getConfig(moduleName).parseOptions;
+    parseOptions.captureComments = true;
+
+    ParseResult parseResult = Parser::parse(src.data(), src.size(), *sourceModule.names, *sourceModule.allocator, parseOptions);
+    if (!parseResult.root)
+        return {};
+
+    sourceModule.root = parseResult.root;
+    sourceModule.mode = Mode::Strict;
+    sourceModule.parseErrors = std::move(parseResult.errors);
+    sourceModule.commentLocations = std::move(parseResult.commentLocations);
+    sourceModule.hotcomments = std::move(parseResult.hotcomments);
+
+    std::shared_ptr<TypeArena> clonedTypes = std::make_shared<TypeArena>();
+
+    SourceModule fragment = sourceModule;
+    ScopePtr environment;
+
+    if (FFlag::DebugLuauDeferredConstraintResolution)
+    {
+        // The new solver resolves locals through the dataflow graph of the AST being checked, so the whole edited source is checked
+        environment = staleModule->getModuleScope()->parent;
+    }
+    else
+    {
+        AstStatBlock* root = sourceModule.root;
+
+        size_t fragmentIndex = 0;
+        while (fragmentIndex < root->body.size && root->body.data[fragmentIndex]->location.end < position)
+            fragmentIndex++;
+
+        // When the cursor is between statements, nothing has to be checked and the fragment is empty
+        size_t fragmentSize = fragmentIndex < root->body.size && root->body.data[fragmentIndex]->location.begin <= position ? 1 : 0;
+
+        fragment.root = sourceModule.allocator->alloc<AstStatBlock>(root->location, AstArray<AstStat*>{root->body.data + fragmentIndex, fragmentSize});
+        environment = makeFragmentEnvironment(*staleModule, *root, fragmentIndex, *clonedTypes, frontend.builtinTypes);
+    }
+
+    ModulePtr module = frontend.checkFragment(fragment, environment);
+
+    AutocompleteResult result = autocomplete(sourceModule, module, frontend.builtinTypes, clonedTypes.get(),
+        frontend.globalsForAutocomplete.globalScope.get(), position, std::move(callback));
+
+    return {std::move(module), std::move(clonedTypes), std::move(result)};
+}
+
 } // namespace Luau
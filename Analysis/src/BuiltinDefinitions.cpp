@@ -783,7 +783,25 @@ TypeId makeStringMetatable(NotNull<BuiltinTypes> builtinTypes)
     attachMagicFunction(findFunc, magicFunctionFind);
     attachDcrMagicFunction(findFunc, dcrMagicFunctionFind);
 
+    // string.builder objects are userdata; for the type checker they are a sealed table of their methods
+    const TypeId builderType = arena->addType(TableType{TableState::Sealed, TypeLevel{}});
+    const TypePackId builderPack = arena->addTypePack({builderType});
+    const TypePackId appendArgs = arena->addTypePack(TypePackVar{VariadicTypePack{arena->addType(UnionType{{stringType, numberType}})}});
+
+    if (TableType* ttv = getMutable<TableType>(builderType))
+    {
+        ttv->name = "StringBuilder";
+        ttv->props = {
+            {"append", {arena->addType(FunctionType{arena->addTypePack(TypePack{{builderType}, appendArgs}), builderPack})}},
+            {"appendf", {arena->addType(FunctionType{arena->addTypePack(TypePack{{builderType, stringType}, anyTypePack}), builderPack})}},
+            {"tostring", {makeFunction(*arena, builderType, {}, {}, {}, {}, {stringType})}},
+            {"len", {makeFunction(*arena, builderType, {}, {}, {}, {}, {numberType})}},
+            {"clear", {makeFunction(*arena, builderType, {}, {}, {}, {}, {builderType})}},
+        };
+    }
+
     TableType::Props stringLib = {
+        {"builder", {makeFunction(*arena, std::nullopt, {}, {}, {optionalNumber}, {}, {builderType})}},
         {"byte", {arena->addType(FunctionType{arena->addTypePack({stringType, optionalNumber, optionalNumber}), numberVariadicList})}},
         {"char", {arena->addType(FunctionType{numberVariadicList, arena->addTypePack({stringType})})}},
         {"find", {findFunc}},
@@ -805,7 +823,7 @@ TypeId makeStringMetatable(NotNull<BuiltinTypes> builtinTypes)
                  })}},
         {"packsize", {makeFunction(*arena, stringType, {}, {}, {}, {}, {numberType})}},
         {"unpack", {arena->addType(FunctionType{
-                       arena->addTypePack(TypePack{{stringType, stringType, optionalNumber}}),
+                       arena->addTypePack(TypePack{{stringType, arena->addType(UnionType{{stringType, builtinTypes->bufferType}}), optionalNumber}}),
                        anyTypePack,
                    })}},
     };
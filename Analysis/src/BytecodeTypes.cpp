@@ -0,0 +1,121 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#include "Luau/BytecodeTypes.h"
+
+#include "Luau/Ast.h"
+#include "Luau/Module.h"
+#include "Luau/Type.h"
+#include "Luau/TypePack.h"
+
+namespace Luau
+{
+
+static LuauBytecodeType getPrimitiveBytecodeType(PrimitiveType::Type type)
+{
+    switch (type)
+    {
+    case PrimitiveType::NilType:
+        return LBC_TYPE_NIL;
+    case PrimitiveType::Boolean:
+        return LBC_TYPE_BOOLEAN;
+    case PrimitiveType::Number:
+        return LBC_TYPE_NUMBER;
+    case PrimitiveType::String:
+        return LBC_TYPE_STRING;
+    case PrimitiveType::Thread:
+        return LBC_TYPE_THREAD;
+    case PrimitiveType::Function:
+        return LBC_TYPE_FUNCTION;
+    case PrimitiveType::Table:
+        return LBC_TYPE_TABLE;
+    case PrimitiveType::Buffer:
+        return LBC_TYPE_BUFFER;
+    }
+
+    return LBC_TYPE_ANY;
+}
+
+LuauBytecodeType getBytecodeType(TypeId ty, const char* vectorType)
+{
+    ty = follow(ty);
+
+    if (const PrimitiveType* prim = get<PrimitiveType>(ty))
+        return getPrimitiveBytecodeType(prim->type);
+
+    if (const SingletonType* singleton = get<SingletonType>(ty))
+        return get<BooleanSingleton>(singleton) ? LBC_TYPE_BOOLEAN : LBC_TYPE_STRING;
+
+    if (get<TableType>(ty) || get<MetatableType>(ty))
+        return LBC_TYPE_TABLE;
+
+    if (get<FunctionType>(ty))
+        return LBC_TYPE_FUNCTION;
+
+    if (const ClassType* ctv = get<ClassType>(ty))
+        return vectorType && ctv->name == vectorType ? LBC_TYPE_VECTOR : LBC_TYPE_USERDATA;
+
+    if (const UnionType* utv = get<UnionType>(ty))
+    {
+        bool optional = false;
+        LuauBytecodeType type = LBC_TYPE_INVALID;
+
+        for (TypeId option : utv)
+        {
+            LuauBytecodeType et = getBytecodeType(option, vectorType);
+
+            if (et == LBC_TYPE_NIL)
+            {
+                optional = true;
+                continue;
+            }
+
+            if (type == LBC_TYPE_INVALID)
+            {
+                type = et;
+                continue;
+            }
+
+            if (type != et)
+                return LBC_TYPE_ANY;
+        }
+
+        if (type == LBC_TYPE_INVALID || type == LBC_TYPE_ANY)
+            return LBC_TYPE_ANY;
+
+        return LuauBytecodeType(type | (optional ? LBC_TYPE_OPTIONAL_BIT : 0));
+    }
+
+    // free, generic, intersection and error types don't guarantee a specific tag at runtime
+    return LBC_TYPE_ANY;
+}
+
+DenseHashMap<const AstLocal*, LuauBytecodeType> getInferredArgumentTypes(const Module& module, const char* vectorType)
+{
+    DenseHashMap<const AstLocal*, LuauBytecodeType> result{nullptr};
+
+    for (auto [expr, ty] : module.astTypes)
+    {
+        const AstExprFunction* func = expr->as<AstExprFunction>();
+        if (!func)
+            continue;
+
+        const FunctionType* ftv = get<FunctionType>(follow(ty));
+        if (!ftv)
+            continue;
+
+        // function type lists 'self' as the first argument of methods
+        std::vector<TypeId> argTypes = flatten(ftv->argTypes).first;
+        size_t offset = func->self ? 1 : 0;
+
+        for (size_t i = 0; i < func->args.size && offset + i < argTypes.size(); i++)
+        {
+            LuauBytecodeType type = getBytecodeType(argTypes[offset + i], vectorType);
+
+            if (type != LBC_TYPE_ANY)
+                result[func->args.data[i]] = type;
+        }
+    }
+
+    return result;
+}
+
+} // namespace Luau
@@ -762,7 +762,8 @@ ControlFlow ConstraintGenerator::visit(const ScopePtr& scope, AstStatLocal* stat
                 continue;
 
             const Name name{statLocal->vars.data[i]->name.value};
-            scope->importedTypeBindings[name] = module->exportedTypeBindings;
+            // Bindings are shared with the module instead of being copied for every require
+            scope->importedTypeBindings[name] = std::shared_ptr<const std::unordered_map<Name, TypeFun>>(module, &module->exportedTypeBindings);
             scope->importedModules[name] = moduleInfo->name;
 
             // Imported types of requires that transitively refer to current module have to be replaced with 'any'
@@ -771,8 +772,12 @@ ControlFlow ConstraintGenerator::visit(const ScopePtr& scope, AstStatLocal* stat
                 if (path.empty() || path.front() != moduleInfo->name)
                     continue;
 
-                for (auto& [name, tf] : scope->importedTypeBindings[name])
+                auto bindings = std::make_shared<std::unordered_map<Name, TypeFun>>(module->exportedTypeBindings);
+
+                for (auto& [name, tf] : *bindings)
                     tf = TypeFun{{}, {}, builtinTypes->anyType};
+
+                scope->importedTypeBindings[name] = std::move(bindings);
             }
         }
     }
@@ -1804,10 +1809,10 @@ Inference ConstraintGenerator::check(const ScopePtr& scope, AstExpr* expr, std::
 Inference ConstraintGenerator::check(const ScopePtr& scope, AstExprConstantString* string, std::optional<TypeId> expectedType, bool forceSingleton)
 {
     if (forceSingleton)
-        return Inference{arena->addType(SingletonType{StringSingleton{std::string{string->value.data, string->value.size}}})};
+        return Inference{arena->addInternedType(SingletonType{StringSingleton{std::string{string->value.data, string->value.size}}})};
 
     FreeType ft = FreeType{scope.get()};
-    ft.lowerBound = arena->addType(SingletonType{StringSingleton{std::string{string->value.data, string->value.size}}});
+    ft.lowerBound = arena->addInternedType(SingletonType{StringSingleton{std::string{string->value.data, string->value.size}}});
     ft.upperBound = builtinTypes->stringType;
     const TypeId freeTy = arena->addType(ft);
     addConstraint(scope, string->location, PrimitiveTypeConstraint{freeTy, expectedType, builtinTypes->stringType});
@@ -315,6 +315,43 @@ void ConstraintSolver::randomize(unsigned seed)
     }
 }
 
+// Has to match the order of constraints in ConstraintV
+static const char* kConstraintKindNames[] = {"SubtypeConstraint", "PackSubtypeConstraint", "GeneralizationConstraint", "InstantiationConstraint",
+    "IterableConstraint", "NameConstraint", "TypeAliasExpansionConstraint", "FunctionCallConstraint", "FunctionCheckConstraint",
+    "PrimitiveTypeConstraint", "HasPropConstraint", "SetPropConstraint", "SetIndexerConstraint", "SingletonOrTopTypeConstraint", "UnpackConstraint",
+    "SetOpConstraint", "ReduceConstraint", "ReducePackConstraint"};
+
+SolverProfile ConstraintSolver::getProfile() const
+{
+    SolverProfile result;
+
+    for (size_t i = 0; i < profileByKind.size(); i++)
+    {
+        if (profileByKind[i].attempts != 0)
+            result.constraintKinds[kConstraintKindNames[i]] = profileByKind[i];
+    }
+
+    std::vector<std::pair<const Constraint*, SolverProfileEntry>> slowest;
+    slowest.reserve(profileByConstraint.size());
+
+    for (const auto& [c, entry] : profileByConstraint)
+        slowest.push_back({c, entry});
+
+    size_t count = std::min(slowest.size(), SolverProfile::kHotConstraintLimit);
+
+    std::partial_sort(slowest.begin(), slowest.begin() + count, slowest.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.second.time > rhs.second.time;
+    });
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const Constraint* c = slowest[i].first;
+        result.hotConstraints.push_back(HotConstraint{currentModuleName, kConstraintKindNames[c->c.index()], c->location, slowest[i].second});
+    }
+
+    return result;
+}
+
 void ConstraintSolver::run()
 {
     if (isDone())
@@ -336,12 +373,22 @@ void ConstraintSolver::run()
     auto runSolverPass = [&](bool force) {
         bool progress = false;
 
+        // Dispatched constraints are dropped by moving the remaining ones down instead of erasing them one by one
+        // This keeps a pass linear in the number of unsolved constraints, which matters for modules with a lot of them
         size_t i = 0;
+        size_t kept = 0;
+
+        auto compact = [&]() {
+            unsolvedConstraints.erase(unsolvedConstraints.begin() + kept, unsolvedConstraints.begin() + i);
+            i = kept;
+        };
+
         while (i < unsolvedConstraints.size())
         {
             NotNull<const Constraint> c = unsolvedConstraints[i];
             if (!force && isBlocked(c))
             {
+                unsolvedConstraints[kept++] = c;
                 ++i;
                 continue;
             }
@@ -356,17 +403,36 @@ void ConstraintSolver::run()
 
             if (logger)
             {
+                compact();
                 snapshot = logger->prepareStepSnapshot(rootScope, c, force, unsolvedConstraints);
             }
 
+            double dispatchStart = profile ? TimeTrace::getClock() : 0.0;
+
             bool success = tryDispatch(c, force);
 
+            if (profile)
+            {
+                double duration = TimeTrace::getClock() - dispatchStart;
+                size_t kind = c->c.index();
+
+                if (kind >= profileByKind.size())
+                    profileByKind.resize(kind + 1);
+
+                for (SolverProfileEntry* entry : {&profileByKind[kind], &profileByConstraint[c.get()]})
+                {
+                    entry->time += duration;
+                    entry->attempts++;
+                    entry->dispatched += success;
+                }
+            }
+
             progress |= success;
 
             if (success)
             {
                 unblock(c);
-                unsolvedConstraints.erase(unsolvedConstraints.begin() + i);
+                ++i;
 
                 // decrement the referenced free types for this constraint if we dispatched successfully!
                 for (auto ty : c->getFreeTypes())
@@ -409,16 +475,24 @@ void ConstraintSolver::run()
                         }
                     }
 
+                    compact();
                     dump(this, opts);
                 }
             }
             else
+            {
+                unsolvedConstraints[kept++] = c;
                 ++i;
+            }
 
             if (force && success)
+            {
+                compact();
                 return true;
+            }
         }
 
+        compact();
         return progress;
     };
 
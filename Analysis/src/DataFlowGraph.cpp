@@ -30,9 +30,9 @@ const RefinementKey* RefinementKeyArena::node(const RefinementKey* parent, DefId
 
 DefId DataFlowGraph::getDef(const AstExpr* expr) const
 {
-    auto def = astDefs.find(expr);
-    LUAU_ASSERT(def);
-    return NotNull{*def};
+    auto entry = astExprs.find(expr);
+    LUAU_ASSERT(entry && entry->def);
+    return NotNull{entry->def};
 }
 
 std::optional<DefId> DataFlowGraph::getRValueDefForCompoundAssign(const AstExpr* expr) const
@@ -64,8 +64,8 @@ DefId DataFlowGraph::getDef(const AstStatDeclareFunction* func) const
 
 const RefinementKey* DataFlowGraph::getRefinementKey(const AstExpr* expr) const
 {
-    if (auto key = astRefinementKeys.find(expr))
-        return *key;
+    if (auto entry = astExprs.find(expr))
+        return entry->key;
 
     return nullptr;
 }
@@ -675,11 +675,8 @@ ControlFlow DataFlowGraphBuilder::visit(DfgScope* scope, AstStatError* error)
 DataFlowResult DataFlowGraphBuilder::visitExpr(DfgScope* scope, AstExpr* e)
 {
     // Some subexpressions could be visited two times. If we've already seen it, just extract it.
-    if (auto def = graph.astDefs.find(e))
-    {
-        auto key = graph.astRefinementKeys.find(e);
-        return {NotNull{*def}, key ? *key : nullptr};
-    }
+    if (auto entry = graph.astExprs.find(e); entry && entry->def)
+        return {NotNull{entry->def}, entry->key};
 
     auto go = [&]() -> DataFlowResult {
         if (auto g = e->as<AstExprGroup>())
@@ -725,9 +722,7 @@ DataFlowResult DataFlowGraphBuilder::visitExpr(DfgScope* scope, AstExpr* e)
     };
 
     auto [def, key] = go();
-    graph.astDefs[e] = def;
-    if (key)
-        graph.astRefinementKeys[e] = key;
+    graph.astExprs[e] = {def, key};
     return {def, key};
 }
 
@@ -914,7 +909,8 @@ void DataFlowGraphBuilder::visitLValue(DfgScope* scope, AstExpr* e, DefId incomi
             handle->ice("Unknown AstExpr in DataFlowGraphBuilder::visitLValue");
     };
 
-    graph.astDefs[e] = go();
+    DefId def = go();
+    graph.astExprs[e].def = def;
 }
 
 DefId DataFlowGraphBuilder::visitLValue(DfgScope* scope, AstExprLocal* l, DefId incomingDef, bool isCompoundAssignment)
@@ -195,6 +195,44 @@ void write(JsonEmitter& emitter, const TypeCheckLog& log)
     o.finish();
 }
 
+void write(JsonEmitter& emitter, const SolverProfileEntry& entry)
+{
+    ObjectEmitter o = emitter.writeObject();
+    o.writePair("time", entry.time);
+    o.writePair("attempts", entry.attempts);
+    o.writePair("dispatched", entry.dispatched);
+    o.finish();
+}
+
+void write(JsonEmitter& emitter, const std::map<std::string, SolverProfileEntry>& entries)
+{
+    ObjectEmitter o = emitter.writeObject();
+    for (const auto& [name, entry] : entries)
+        o.writePair(name, entry);
+    o.finish();
+}
+
+void write(JsonEmitter& emitter, const HotConstraint& hot)
+{
+    ObjectEmitter o = emitter.writeObject();
+    o.writePair("kind", hot.kind);
+    o.writePair("location", hot.location);
+    o.writePair("time", hot.entry.time);
+    o.writePair("attempts", hot.entry.attempts);
+    o.writePair("dispatched", hot.entry.dispatched);
+    o.finish();
+}
+
+void write(JsonEmitter& emitter, const SolverProfile& profile)
+{
+    ObjectEmitter o = emitter.writeObject();
+    o.writePair("timeSolve", profile.timeSolve);
+    o.writePair("timeTypeCheck", profile.timeTypeCheck);
+    o.writePair("constraintKinds", profile.constraintKinds);
+    o.writePair("hotConstraints", profile.hotConstraints);
+    o.finish();
+}
+
 } // namespace Json
 
 static ScopeSnapshot snapshotScope(const Scope* scope, ToStringOptions& opts)
@@ -266,6 +304,8 @@ std::string DcrLogger::compileOutput()
     o.writePair("generation", generationLog);
     o.writePair("solve", solveLog);
     o.writePair("check", checkLog);
+    if (solverProfile)
+        o.writePair("profile", *solverProfile);
     o.finish();
 
     return emitter.str();
@@ -436,6 +476,11 @@ void DcrLogger::captureTypeCheckError(const TypeError& error)
     });
 }
 
+void DcrLogger::captureSolverProfile(const SolverProfile& profile)
+{
+    solverProfile = profile;
+}
+
 std::vector<ConstraintBlock> DcrLogger::snapshotBlocks(NotNull<const Constraint> c)
 {
     auto it = constraintBlocks.find(c);
@@ -34,6 +34,17 @@ declare buffer: {
     writef64: (b: buffer, offset: number, value: number) -> (),
     readstring: (b: buffer, offset: number, count: number) -> string,
     writestring: (b: buffer, offset: number, value: string, count: number?) -> (),
+    readi32array: (b: buffer, offset: number, count: number) -> { number },
+    readf32array: (b: buffer, offset: number, count: number) -> { number },
+    writei32array: (b: buffer, offset: number, values: { number }, count: number?) -> (),
+    writef32array: (b: buffer, offset: number, values: { number }, count: number?) -> (),
+    find: (b: buffer, offset: number, value: string) -> number?,
+    equal: (a: buffer, aOffset: number, b: buffer, bOffset: number, count: number) -> boolean,
+}
+
+declare json: {
+    encode: (value: any) -> string,
+    decode: (str: string) -> any,
 }
 
 declare bit32: {
@@ -97,6 +108,9 @@ declare math: {
     clamp: (n: number, min: number, max: number) -> number,
     noise: (x: number, y: number?, z: number?) -> number,
     round: (n: number) -> number,
+    noisegrid: (b: buffer, offset: number, sizex: number, sizey: number, sizez: number, x: number, y: number, z: number, step: number?) -> (),
+    sqrtbuffer: (b: buffer, offset: number, count: number) -> (),
+    sinbuffer: (b: buffer, offset: number, count: number) -> (),
 }
 
 type DateTypeArg = {
@@ -203,6 +217,7 @@ declare table: {
 
     move: <V>(src: {V}, a: number, b: number, t: number, dst: {V}?) -> {V},
     clear: <K, V>(table: {[K]: V}) -> (),
+    reserve: <K, V>(t: {[K]: V}, narray: number, nhash: number?) -> (),
 
     isfrozen: <K, V>(t: {[K]: V}) -> boolean,
 }
@@ -289,6 +304,9 @@ declare math: {
     clamp: @checked (n: number, min: number, max: number) -> number,
     noise: @checked (x: number, y: number?, z: number?) -> number,
     round: @checked (n: number) -> number,
+    noisegrid: @checked (b: buffer, offset: number, sizex: number, sizey: number, sizez: number, x: number, y: number, z: number, step: number?) -> (),
+    sqrtbuffer: @checked (b: buffer, offset: number, count: number) -> (),
+    sinbuffer: @checked (b: buffer, offset: number, count: number) -> (),
 }
 
 type DateTypeArg = {
@@ -395,6 +413,7 @@ declare table: {
 
     move: <V>(src: {V}, a: number, b: number, t: number, dst: {V}?) -> {V},
     clear: <K, V>(table: {[K]: V}) -> (),
+    reserve: <K, V>(t: {[K]: V}, narray: number, nhash: number?) -> (),
 
     isfrozen: <K, V>(t: {[K]: V}) -> boolean,
 }
@@ -443,6 +462,12 @@ declare buffer: {
     writef64: @checked (b: buffer, offset: number, value: number) -> (),
     readstring: @checked (b: buffer, offset: number, count: number) -> string,
     writestring: @checked (b: buffer, offset: number, value: string, count: number?) -> (),
+    readi32array: @checked (b: buffer, offset: number, count: number) -> { number },
+    readf32array: @checked (b: buffer, offset: number, count: number) -> { number },
+    writei32array: @checked (b: buffer, offset: number, values: { number }, count: number?) -> (),
+    writef32array: @checked (b: buffer, offset: number, values: { number }, count: number?) -> (),
+    find: @checked (b: buffer, offset: number, value: string) -> number?,
+    equal: @checked (a: buffer, aOffset: number, b: buffer, bOffset: number, count: number) -> boolean,
 }
 
 )BUILTIN_SRC";
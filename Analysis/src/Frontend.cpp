@@ -10,6 +10,8 @@
 #include "Luau/DataFlowGraph.h"
 #include "Luau/DcrLogger.h"
 #include "Luau/FileResolver.h"
+#include "Luau/Hash.h"
+#include "Luau/ModuleInterfaceCache.h"
 #include "Luau/Parser.h"
 #include "Luau/Scope.h"
 #include "Luau/StringUtils.h"
@@ -23,10 +25,13 @@
 #include <chrono>
 #include <condition_variable>
 #include <exception>
+#include <memory>
 #include <mutex>
 #include <stdexcept>
 #include <string>
 
+#include <stdio.h>
+
 LUAU_FASTINT(LuauTypeInferIterationLimit)
 LUAU_FASTINT(LuauTypeInferRecursionLimit)
 LUAU_FASTINT(LuauTarjanChildLimit)
@@ -59,12 +64,32 @@ struct BuildQueueItem
     int dirtyDependencies = 0;
     bool processing = false;
 
+    // Estimated cost of checking this item and the longest chain of items that depend on it
+    size_t criticalPath = 0;
+
     // Result
     std::exception_ptr exception;
     ModulePtr module;
     Frontend::Stats stats;
 };
 
+struct ParseQueueItem
+{
+    ModuleName name;
+
+    // Parameters
+    ParseOptions parseOptions;
+
+    // Result
+    std::optional<SourceCode> source;
+    std::optional<std::string> environmentName;
+    SourceModule sourceModule;
+    RequireTraceResult require;
+
+    std::exception_ptr exception;
+    Frontend::Stats stats;
+};
+
 std::optional<Mode> parseMode(const std::vector<HotComment>& hotcomments)
 {
     for (const HotComment& hc : hotcomments)
@@ -124,6 +149,53 @@ static ParseResult parseSourceForModule(std::string_view source, Luau::SourceMod
     return parseResult;
 }
 
+struct InterfaceCacheHash : Fnv1aHash
+{
+    void addInt(int64_t v)
+    {
+        addBytes(&v, sizeof(v));
+    }
+
+    // length prefix keeps adjacent strings from aliasing each other
+    void addString(std::string_view str)
+    {
+        addInt(int64_t(str.size()));
+        addBytes(str.data(), str.size());
+    }
+};
+
+template<typename T>
+static uint64_t getFlagsHash()
+{
+    // flag list order depends on static initialization order, so flag hashes are combined in an order-independent way
+    uint64_t result = 0;
+
+    for (FValue<T>* flag = FValue<T>::list; flag; flag = flag->next)
+    {
+        InterfaceCacheHash hash;
+        hash.addString(flag->name);
+        hash.addInt(int64_t(flag->value));
+
+        result += hash.value;
+    }
+
+    return result;
+}
+
+// Declarations of a definition file depend on its source and on the global types it refers to; the latter are matched by name on load
+static std::string getDefinitionCacheKey(std::string_view source, const std::string& packageName)
+{
+    InterfaceCacheHash hash;
+    hash.addString(packageName);
+    hash.addString(source);
+    hash.addInt(int64_t(getFlagsHash<bool>()));
+    hash.addInt(int64_t(getFlagsHash<int>()));
+
+    char result[48];
+    snprintf(result, sizeof(result), "definition-%016llx", (unsigned long long)hash.value);
+    return result;
+}
+
 static void persistCheckedTypes(ModulePtr checkedModule, GlobalTypes& globals, ScopePtr targetScope, const std::string& packageName)
 {
     CloneState cloneState{globals.builtinTypes};
@@ -166,6 +238,25 @@ LoadDefinitionFileResult Frontend::loadDefinitionFile(GlobalTypes& globals, Scop
     sourceModule.name = packageName;
     sourceModule.humanReadableName = packageName;
 
+    std::string cacheKey = interfaceCache && !captureComments ? getDefinitionCacheKey(source, packageName) : std::string();
+
+    if (!cacheKey.empty())
+    {
+        if (std::optional<std::string> data = interfaceCache->readInterface(cacheKey))
+        {
+            ModulePtr cachedModule = std::make_shared<Module>();
+            cachedModule->name = packageName;
+            cachedModule->humanReadableName = packageName;
+
+            if (deserializeModuleInterface(*cachedModule, *data, builtinTypes, this->globals.globalScope))
+            {
+                persistCheckedTypes(cachedModule, globals, targetScope, packageName);
+
+                return LoadDefinitionFileResult{true, {}, sourceModule, cachedModule};
+            }
+        }
+    }
+
     Luau::ParseResult parseResult = parseSourceForModule(source, sourceModule, captureComments);
     if (parseResult.errors.size() > 0)
         return LoadDefinitionFileResult{false, parseResult, sourceModule, nullptr};
@@ -175,6 +266,15 @@ LoadDefinitionFileResult Frontend::loadDefinitionFile(GlobalTypes& globals, Scop
     if (checkedModule->errors.size() > 0)
         return LoadDefinitionFileResult{false, parseResult, sourceModule, checkedModule};
 
+    // declarations are checked against the default environment, which is also used to find the global types they refer to on load
+    if (!cacheKey.empty())
+    {
+        std::string data = serializeDefinitionModule(*checkedModule, builtinTypes, this->globals.globalScope);
+
+        if (!data.empty())
+            interfaceCache->writeInterface(cacheKey, data);
+    }
+
     persistCheckedTypes(checkedModule, globals, targetScope, packageName);
 
     return LoadDefinitionFileResult{true, parseResult, sourceModule, checkedModule};
@@ -249,8 +349,9 @@ std::optional<std::string> pathExprToModuleName(const ModuleName& currentModuleN
 namespace
 {
 
+// 'visit' adds the dependencies of the module to the queue and returns the module, or nullptr if it's not known
 static ErrorVec accumulateErrors(
-    const std::unordered_map<ModuleName, std::shared_ptr<SourceNode>>& sourceNodes, ModuleResolver& moduleResolver, const ModuleName& name)
+    const ModuleName& name, const std::function<ModulePtr(const ModuleName& name, std::vector<ModuleName>& queue)>& visit)
 {
     DenseHashSet<ModuleName> seen{{}};
     std::vector<ModuleName> queue{name};
@@ -266,27 +367,20 @@ static ErrorVec accumulateErrors(
             continue;
         seen.insert(next);
 
-        auto it = sourceNodes.find(next);
-        if (it == sourceNodes.end())
-            continue;
-
-        const SourceNode& sourceNode = *it->second;
-        queue.insert(queue.end(), sourceNode.requireSet.begin(), sourceNode.requireSet.end());
-
         // FIXME: If a module has a syntax error, we won't be able to re-report it here.
         // The solution is probably to move errors from Module to SourceNode
 
-        auto modulePtr = moduleResolver.getModule(next);
-        if (!modulePtr)
+        ModulePtr module = visit(next, queue);
+        if (!module)
             continue;
 
-        Module& module = *modulePtr;
+        // modules can be shared with snapshots that are read by other threads, so their errors are sorted in the result
+        size_t start = result.size();
+        result.insert(result.end(), module->errors.begin(), module->errors.end());
 
-        std::sort(module.errors.begin(), module.errors.end(), [](const TypeError& e1, const TypeError& e2) -> bool {
+        std::sort(result.begin() + start, result.end(), [](const TypeError& e1, const TypeError& e2) -> bool {
             return e1.location.begin > e2.location.begin;
         });
-
-        result.insert(result.end(), module.errors.begin(), module.errors.end());
     }
 
     std::reverse(result.begin(), result.end());
@@ -437,6 +531,13 @@ CheckResult Frontend::check(const ModuleName& name, std::optional<FrontendOption
 
     FrontendOptions frontendOptions = optionOverride.value_or(options);
 
+    // Modules that were compacted as a dependency of another module are checked again to get their full type graphs
+    if (frontendOptions.retainFullTypeGraphs && frontendOptions.compactDependencyTypeGraphs && !frontendOptions.forAutocomplete)
+    {
+        if (auto it = sourceNodes.find(name); it != sourceNodes.end() && !it->second->hasFullTypeGraphs)
+            it->second->dirtyModule = true;
+    }
+
     if (std::optional<CheckResult> result = getCheckResult(name, true, frontendOptions.forAutocomplete))
         return std::move(*result);
 
@@ -448,6 +549,15 @@ CheckResult Frontend::check(const ModuleName& name, std::optional<FrontendOption
     addBuildQueueItems(buildQueueItems, buildQueue, cycleDetected, seen, frontendOptions);
     LUAU_ASSERT(!buildQueueItems.empty());
 
+    if (frontendOptions.compactDependencyTypeGraphs)
+    {
+        for (BuildQueueItem& item : buildQueueItems)
+        {
+            if (item.name != name)
+                item.options.retainFullTypeGraphs = false;
+        }
+    }
+
     if (FFlag::DebugLuauLogSolverToJson)
     {
         LUAU_ASSERT(buildQueueItems.back().name == name);
@@ -474,6 +584,9 @@ CheckResult Frontend::check(const ModuleName& name, std::optional<FrontendOption
             checkResult.lintResult = item.module->lintResult;
     }
 
+    if (frontendOptions.publishSnapshots)
+        publishSnapshot();
+
     return checkResult;
 }
 
@@ -487,8 +600,76 @@ void Frontend::queueModuleCheck(const ModuleName& name)
     moduleQueue.push_back(name);
 }
 
+// Modules on the longest chain of dependents limit the total check time when modules are checked in parallel, so they are started first
+// Check cost is estimated by the number of lines in the module
+static void computeCriticalPaths(std::vector<BuildQueueItem>& items)
+{
+    enum class State : uint8_t
+    {
+        Unvisited,
+        Visiting,
+        Done,
+    };
+
+    std::vector<State> state(items.size(), State::Unvisited);
+    std::vector<std::pair<size_t, size_t>> stack;
+
+    for (size_t root = 0; root < items.size(); root++)
+    {
+        if (state[root] != State::Unvisited)
+            continue;
+
+        state[root] = State::Visiting;
+        stack.push_back({root, 0});
+
+        while (!stack.empty())
+        {
+            auto& [i, next] = stack.back();
+            BuildQueueItem& item = items[i];
+
+            if (next < item.reverseDeps.size())
+            {
+                size_t dep = item.reverseDeps[next++];
+
+                // items in a require cycle don't contribute to each other's paths
+                if (state[dep] == State::Unvisited)
+                {
+                    state[dep] = State::Visiting;
+                    stack.push_back({dep, 0});
+                }
+
+                continue;
+            }
+
+            size_t longestDependent = 0;
+
+            for (size_t dep : item.reverseDeps)
+            {
+                if (state[dep] == State::Done)
+                    longestDependent = std::max(longestDependent, items[dep].criticalPath);
+            }
+
+            size_t cost = item.sourceModule->root ? item.sourceModule->root->location.end.line + 1 : 1;
+
+            item.criticalPath = cost + longestDependent;
+            state[i] = State::Done;
+            stack.pop_back();
+        }
+    }
+}
+
+// Filtering by hot comments and module mode can only disable lints, so the configured set is enough to tell if type information is needed
+static bool isSyntaxLintItem(const BuildQueueItem& item)
+{
+    if (item.options.forAutocomplete || !item.options.runLintChecks || !item.options.lintOnly)
+        return false;
+
+    return !hasTypeAwareLints(item.options.enabledLintWarnings.value_or(item.config.enabledLint));
+}
+
 std::vector<ModuleName> Frontend::checkQueuedModules(std::optional<FrontendOptions> optionOverride,
-    std::function<void(std::function<void()> task)> executeTask, std::function<void(size_t done, size_t total)> progress)
+    std::function<void(std::function<void()> task)> executeTask, std::function<void(size_t done, size_t total)> progress,
+    std::function<void(const ModuleName& name, CheckResult result)> streamResult)
 {
     FrontendOptions frontendOptions = optionOverride.value_or(options);
 
@@ -499,6 +680,20 @@ std::vector<ModuleName> Frontend::checkQueuedModules(std::optional<FrontendOptio
     DenseHashSet<Luau::ModuleName> seen{{}};
     std::vector<BuildQueueItem> buildQueueItems;
 
+    // With a task executor, module sources are read and parsed in parallel before the graph is traversed
+    if (executeTask)
+    {
+        std::vector<ModuleName> dirtyModules;
+
+        for (const ModuleName& name : currModuleQueue)
+        {
+            if (isDirty(name, frontendOptions.forAutocomplete))
+                dirtyModules.push_back(name);
+        }
+
+        parseGraphSources(dirtyModules, frontendOptions.forAutocomplete, executeTask);
+    }
+
     for (const ModuleName& name : currModuleQueue)
     {
         if (seen.contains(name))
@@ -507,6 +702,11 @@ std::vector<ModuleName> Frontend::checkQueuedModules(std::optional<FrontendOptio
         if (!isDirty(name, frontendOptions.forAutocomplete))
         {
             seen.insert(name);
+
+            // results of modules that are already checked are available right away
+            if (streamResult)
+                streamCheckResult(name, frontendOptions, streamResult);
+
             continue;
         }
 
@@ -521,6 +721,20 @@ std::vector<ModuleName> Frontend::checkQueuedModules(std::optional<FrontendOptio
     if (buildQueueItems.empty())
         return {};
 
+    if (frontendOptions.compactDependencyTypeGraphs)
+    {
+        DenseHashSet<Luau::ModuleName> requested{{}};
+
+        for (const ModuleName& name : currModuleQueue)
+            requested.insert(name);
+
+        for (BuildQueueItem& item : buildQueueItems)
+        {
+            if (!requested.contains(item.name))
+                item.options.retainFullTypeGraphs = false;
+        }
+    }
+
     // We need a mapping from modules to build queue slots
     std::unordered_map<ModuleName, size_t> moduleNameToQueue;
 
@@ -542,10 +756,29 @@ std::vector<ModuleName> Frontend::checkQueuedModules(std::optional<FrontendOptio
     std::condition_variable cv;
     std::vector<size_t> readyQueueItems;
 
+    // Items that can be checked are ordered by the length of their critical path
+    // Each submitted task takes the best item available when it starts running, so the ordering works with any task executor
+    std::vector<size_t> runnableItems;
+
+    auto compareCriticalPath = [&buildQueueItems](size_t lhs, size_t rhs) {
+        return buildQueueItems[lhs].criticalPath < buildQueueItems[rhs].criticalPath;
+    };
+
     size_t processing = 0;
     size_t remaining = buildQueueItems.size();
 
-    auto itemTask = [&](size_t i) {
+    auto itemTask = [&]() {
+        size_t i = 0;
+
+        {
+            std::unique_lock guard(mtx);
+
+            LUAU_ASSERT(!runnableItems.empty());
+            std::pop_heap(runnableItems.begin(), runnableItems.end(), compareCriticalPath);
+            i = runnableItems.back();
+            runnableItems.pop_back();
+        }
+
         BuildQueueItem& item = buildQueueItems[i];
 
         try
@@ -571,8 +804,15 @@ std::vector<ModuleName> Frontend::checkQueuedModules(std::optional<FrontendOptio
         item.processing = true;
         processing++;
 
-        executeTask([&itemTask, i]() {
-            itemTask(i);
+        {
+            std::unique_lock guard(mtx);
+
+            runnableItems.push_back(i);
+            std::push_heap(runnableItems.begin(), runnableItems.end(), compareCriticalPath);
+        }
+
+        executeTask([&itemTask]() {
+            itemTask();
         });
     };
 
@@ -589,11 +829,15 @@ std::vector<ModuleName> Frontend::checkQueuedModules(std::optional<FrontendOptio
         }
     };
 
-    // In a first pass, check modules that have no dependencies and record info of those modules that wait
+    // Record info of modules that wait for their dependencies
     for (size_t i = 0; i < buildQueueItems.size(); i++)
     {
         BuildQueueItem& item = buildQueueItems[i];
 
+        // modules that are only linted without type information can be processed in any order
+        if (isSyntaxLintItem(item))
+            continue;
+
         for (const ModuleName& dep : item.sourceNode->requireSet)
         {
             if (auto it = sourceNodes.find(dep); it != sourceNodes.end())
@@ -606,8 +850,14 @@ std::vector<ModuleName> Frontend::checkQueuedModules(std::optional<FrontendOptio
                 }
             }
         }
+    }
 
-        if (item.dirtyDependencies == 0)
+    computeCriticalPaths(buildQueueItems);
+
+    // In a first pass, check modules that have no dependencies
+    for (size_t i = 0; i < buildQueueItems.size(); i++)
+    {
+        if (buildQueueItems[i].dirtyDependencies == 0)
             sendItemTask(i);
     }
 
@@ -616,6 +866,7 @@ std::vector<ModuleName> Frontend::checkQueuedModules(std::optional<FrontendOptio
         sendCycleItemTask();
 
     std::vector<size_t> nextItems;
+    std::vector<size_t> finishedItems;
     std::optional<size_t> itemWithException;
     bool cancelled = false;
 
@@ -638,14 +889,24 @@ std::vector<ModuleName> Frontend::checkQueuedModules(std::optional<FrontendOptio
                 if (item.exception)
                     itemWithException = i;
 
-                if (item.module && item.module->cancelled)
-                    cancelled = true;
-
-                if (itemWithException || cancelled)
+                if (itemWithException)
                     break;
 
+                if (item.module->cancelled)
+                {
+                    cancelled = true;
+                    continue;
+                }
+
+                // Modules that completed are kept after a cancellation, so that the next check doesn't have to repeat them
                 recordItemResult(item);
 
+                if (cancelled)
+                    continue;
+
+                if (streamResult)
+                    finishedItems.push_back(i);
+
                 // Notify items that were waiting for this dependency
                 for (size_t reverseDep : item.reverseDeps)
                 {
@@ -671,6 +932,11 @@ std::vector<ModuleName> Frontend::checkQueuedModules(std::optional<FrontendOptio
         if (progress)
             progress(buildQueueItems.size() - remaining, buildQueueItems.size());
 
+        // Results are delivered outside of the lock; modules that depend on them haven't been submitted yet
+        for (size_t i : finishedItems)
+            streamCheckResult(buildQueueItems[i].name, frontendOptions, streamResult);
+        finishedItems.clear();
+
         // Items cannot be submitted while holding the lock
         for (size_t i : nextItems)
             sendItemTask(i);
@@ -698,6 +964,9 @@ std::vector<ModuleName> Frontend::checkQueuedModules(std::optional<FrontendOptio
     for (size_t i = 0; i < buildQueueItems.size(); i++)
         checkedModules.push_back(std::move(buildQueueItems[i].name));
 
+    if (frontendOptions.publishSnapshots)
+        publishSnapshot();
+
     return checkedModules;
 }
 
@@ -721,7 +990,18 @@ std::optional<CheckResult> Frontend::getCheckResult(const ModuleName& name, bool
         checkResult.timeoutHits.push_back(name);
 
     if (accumulateNested)
-        checkResult.errors = accumulateErrors(sourceNodes, resolver, name);
+    {
+        checkResult.errors = accumulateErrors(name, [&](const ModuleName& name, std::vector<ModuleName>& queue) -> ModulePtr {
+            auto it = sourceNodes.find(name);
+            if (it == sourceNodes.end())
+                return nullptr;
+
+            const SourceNode& sourceNode = *it->second;
+            queue.insert(queue.end(), sourceNode.requireSet.begin(), sourceNode.requireSet.end());
+
+            return resolver.getModule(name);
+        });
+    }
     else
         checkResult.errors.insert(checkResult.errors.end(), module->errors.begin(), module->errors.end());
 
@@ -731,6 +1011,126 @@ std::optional<CheckResult> Frontend::getCheckResult(const ModuleName& name, bool
     return checkResult;
 }
 
+const FrontendSnapshot::ModuleEntry* FrontendSnapshot::getEntry(const ModuleName& name) const
+{
+    auto it = modules.find(name);
+    return it != modules.end() ? it->second.get() : nullptr;
+}
+
+const SourceModule* FrontendSnapshot::getSourceModule(const ModuleName& name) const
+{
+    const ModuleEntry* entry = getEntry(name);
+    return entry ? entry->sourceModule.get() : nullptr;
+}
+
+ModulePtr FrontendSnapshot::getModule(const ModuleName& name, bool forAutocomplete) const
+{
+    const ModuleEntry* entry = getEntry(name);
+
+    if (!entry)
+        return nullptr;
+
+    return forAutocomplete ? entry->moduleForAutocomplete : entry->module;
+}
+
+std::optional<CheckResult> FrontendSnapshot::getCheckResult(const ModuleName& name, bool accumulateNested, bool forAutocomplete) const
+{
+    const ModuleEntry* entry = getEntry(name);
+
+    if (!entry || (forAutocomplete ? entry->dirtyModuleForAutocomplete : entry->dirtyModule))
+        return std::nullopt;
+
+    ModulePtr module = forAutocomplete ? entry->moduleForAutocomplete : entry->module;
+
+    if (!module)
+        return std::nullopt;
+
+    CheckResult checkResult;
+
+    if (module->timeout)
+        checkResult.timeoutHits.push_back(name);
+
+    if (accumulateNested)
+    {
+        checkResult.errors = accumulateErrors(name, [&](const ModuleName& name, std::vector<ModuleName>& queue) -> ModulePtr {
+            const ModuleEntry* entry = getEntry(name);
+            if (!entry)
+                return nullptr;
+
+            queue.insert(queue.end(), entry->dependencies.begin(), entry->dependencies.end());
+
+            return forAutocomplete ? entry->moduleForAutocomplete : entry->module;
+        });
+    }
+    else
+    {
+        checkResult.errors = module->errors;
+    }
+
+    checkResult.lintResult = module->lintResult;
+
+    return checkResult;
+}
+
+std::shared_ptr<const FrontendSnapshot> Frontend::publishSnapshot()
+{
+    LUAU_TIMETRACE_SCOPE("Frontend::publishSnapshot", "Frontend");
+
+    std::shared_ptr<const FrontendSnapshot> previous = getSnapshot();
+
+    auto result = std::make_shared<FrontendSnapshot>();
+    result->version = previous ? previous->version + 1 : 1;
+    result->modules.reserve(sourceNodes.size());
+
+    for (const auto& [name, sourceNode] : sourceNodes)
+    {
+        auto sourceModule = sourceModules.find(name);
+
+        FrontendSnapshot::ModuleEntry entry;
+        entry.sourceModule = sourceModule != sourceModules.end() ? sourceModule->second : nullptr;
+        entry.module = moduleResolver.getModule(name);
+        entry.moduleForAutocomplete = moduleResolverForAutocomplete.getModule(name);
+        entry.dirtyModule = sourceNode->dirtyModule;
+        entry.dirtyModuleForAutocomplete = sourceNode->dirtyModuleForAutocomplete;
+
+        // entries of modules that didn't change are shared with the previous snapshot
+        if (const FrontendSnapshot::ModuleEntry* prev = previous ? previous->getEntry(name) : nullptr)
+        {
+            bool same = prev->sourceModule == entry.sourceModule && prev->module == entry.module &&
+                        prev->moduleForAutocomplete == entry.moduleForAutocomplete && prev->dirtyModule == entry.dirtyModule &&
+                        prev->dirtyModuleForAutocomplete == entry.dirtyModuleForAutocomplete &&
+                        prev->dependencies.size() == sourceNode->requireSet.size();
+
+            if (same)
+            {
+                bool sameDependencies = true;
+
+                for (const ModuleName& dep : prev->dependencies)
+                    sameDependencies &= sourceNode->requireSet.contains(dep);
+
+                if (sameDependencies)
+                {
+                    result->modules[name] = previous->modules.at(name);
+                    continue;
+                }
+            }
+        }
+
+        entry.dependencies.assign(sourceNode->requireSet.begin(), sourceNode->requireSet.end());
+
+        result->modules[name] = std::make_shared<const FrontendSnapshot::ModuleEntry>(std::move(entry));
+    }
+
+    std::atomic_store(&snapshot, std::shared_ptr<const FrontendSnapshot>(result));
+
+    return result;
+}
+
+std::shared_ptr<const FrontendSnapshot> Frontend::getSnapshot() const
+{
+    return std::atomic_load(&snapshot);
+}
+
 bool Frontend::parseGraph(
     std::vector<ModuleName>& buildQueue, const ModuleName& root, bool forAutocomplete, std::function<bool(const ModuleName&)> canSkip)
 {
@@ -834,6 +1234,138 @@ bool Frontend::parseGraph(
     return cyclic;
 }
 
+// Parses modules that parseGraph would visit from 'roots' using tasks provided by 'executeTask'
+// Each parsed module submits its dependencies right away, so the serial parseGraph traversal that follows finds all sources parsed
+void Frontend::parseGraphSources(
+    const std::vector<ModuleName>& roots, bool forAutocomplete, std::function<void(std::function<void()> task)> executeTask)
+{
+    LUAU_TIMETRACE_SCOPE("Frontend::parseGraphSources", "Frontend");
+
+    std::vector<std::unique_ptr<ParseQueueItem>> items;
+    DenseHashSet<ModuleName> seen{{}};
+
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::vector<ParseQueueItem*> readyQueueItems;
+
+    size_t processing = 0;
+
+    // Same traversal rules as in parseGraph: subtrees that are not dirty are skipped and modules that are already parsed are only traversed
+    std::vector<ModuleName> stack;
+
+    auto visitModules = [&]() {
+        while (!stack.empty())
+        {
+            ModuleName name = std::move(stack.back());
+            stack.pop_back();
+
+            if (seen.contains(name))
+                continue;
+
+            seen.insert(name);
+
+            if (auto it = sourceNodes.find(name); it != sourceNodes.end() && !it->second->hasDirtySourceModule())
+            {
+                for (const ModuleName& dep : it->second->requireSet)
+                {
+                    auto depIt = sourceNodes.find(dep);
+
+                    if (depIt == sourceNodes.end() || depIt->second->hasDirtyModule(forAutocomplete))
+                        stack.push_back(dep);
+                }
+
+                continue;
+            }
+
+            ParseQueueItem* item = items.emplace_back(std::make_unique<ParseQueueItem>()).get();
+            item->name = name;
+            item->parseOptions = configResolver->getConfig(name).parseOptions;
+            item->parseOptions.captureComments = true;
+
+            processing++;
+
+            executeTask([this, item, &mtx, &cv, &readyQueueItems]() {
+                try
+                {
+                    parseQueueItem(*item);
+                }
+                catch (...)
+                {
+                    item->exception = std::current_exception();
+                }
+
+                {
+                    std::unique_lock guard(mtx);
+                    readyQueueItems.push_back(item);
+                }
+
+                cv.notify_one();
+            });
+        }
+    };
+
+    for (const ModuleName& root : roots)
+        stack.push_back(root);
+
+    visitModules();
+
+    std::exception_ptr exception;
+    std::vector<ParseQueueItem*> ready;
+
+    while (processing != 0)
+    {
+        {
+            std::unique_lock guard(mtx);
+
+            cv.wait(guard, [&readyQueueItems] {
+                return !readyQueueItems.empty();
+            });
+
+            std::swap(ready, readyQueueItems);
+        }
+
+        LUAU_ASSERT(processing >= ready.size());
+        processing -= ready.size();
+
+        for (ParseQueueItem* item : ready)
+        {
+            // If exception was thrown, stop adding new items and wait for processing items to complete
+            if (item->exception)
+            {
+                if (!exception)
+                    exception = item->exception;
+
+                continue;
+            }
+
+            if (exception)
+                continue;
+
+            auto [sourceNode, _] = recordParseQueueItem(*item);
+
+            if (sourceNode)
+            {
+                for (const ModuleName& dep : sourceNode->requireSet)
+                {
+                    auto it = sourceNodes.find(dep);
+
+                    if (it == sourceNodes.end() || it->second->hasDirtyModule(forAutocomplete))
+                        stack.push_back(dep);
+                }
+            }
+        }
+
+        ready.clear();
+
+        // Items cannot be submitted while holding the lock
+        if (!exception)
+            visitModules();
+    }
+
+    if (exception)
+        std::rethrow_exception(exception);
+}
+
 void Frontend::addBuildQueueItems(std::vector<BuildQueueItem>& items, std::vector<ModuleName>& buildQueue, bool cycleDetected,
     DenseHashSet<Luau::ModuleName>& seen, const FrontendOptions& frontendOptions)
 {
@@ -884,8 +1416,148 @@ static void applyInternalLimitScaling(SourceNode& sourceNode, const ModulePtr mo
         sourceNode.autocompleteLimitsMult = std::min(sourceNode.autocompleteLimitsMult * 2.0, 1.0);
 }
 
+static uint64_t getSourceHash(const SourceCode& source, const std::optional<std::string>& environmentName)
+{
+    InterfaceCacheHash hash;
+    hash.addString(source.text());
+    hash.addInt(source.type);
+    hash.addInt(environmentName ? 1 : 0);
+    hash.addString(environmentName ? *environmentName : "");
+
+    // 0 is reserved for unknown interfaces
+    return hash.value ? hash.value : 1;
+}
+
+static uint64_t getInterfaceHash(const std::string& interface, SourceCode::Type type)
+{
+    InterfaceCacheHash hash;
+    hash.addString(interface);
+    hash.addInt(type);
+
+    return hash.value ? hash.value : 1;
+}
+
+// Result of a module check depends on its source, its configuration and the interfaces of its dependencies
+static std::optional<uint64_t> getModuleCheckKey(
+    const std::unordered_map<ModuleName, std::shared_ptr<SourceNode>>& sourceNodes, const BuildQueueItem& item, Mode mode)
+{
+    InterfaceCacheHash hash;
+
+    hash.addString(item.name);
+    hash.addInt(int64_t(item.sourceNode->sourceHash));
+    hash.addInt(int64_t(mode));
+
+    for (const std::string& global : item.config.globals)
+        hash.addString(global);
+
+    hash.addInt(-1);
+
+    hash.addInt(item.options.runLintChecks);
+    hash.addInt(item.options.lintOnly);
+
+    if (item.options.runLintChecks)
+        hash.addInt(int64_t(item.options.enabledLintWarnings.value_or(item.config.enabledLint).warningMask));
+
+    hash.addInt(int64_t(getFlagsHash<bool>()));
+    hash.addInt(int64_t(getFlagsHash<int>()));
+
+    std::vector<ModuleName> dependencies;
+    for (const ModuleName& dep : item.sourceNode->requireSet)
+        dependencies.push_back(dep);
+
+    std::sort(dependencies.begin(), dependencies.end());
+
+    for (const ModuleName& dep : dependencies)
+    {
+        hash.addString(dep);
+
+        auto it = sourceNodes.find(dep);
+
+        if (it == sourceNodes.end())
+        {
+            hash.addInt(0);
+            continue;
+        }
+
+        // when the dependency interface can't be serialized, the cache can't tell if it has changed
+        if (it->second->interfaceHash == 0)
+            return std::nullopt;
+
+        hash.addInt(int64_t(it->second->interfaceHash));
+    }
+
+    // 0 is reserved for unknown keys
+    return hash.value ? hash.value : 1;
+}
+
+static std::string getInterfaceCacheKey(uint64_t checkKey)
+{
+    char result[32];
+    snprintf(result, sizeof(result), "%016llx", (unsigned long long)checkKey);
+    return result;
+}
+
+// Keeps only the public interface of the module; errors are moved into the interface arena so that they stay valid
+static void dropFullTypeGraphs(Module& module, NotNull<BuiltinTypes> builtinTypes)
+{
+    // copyErrors needs to allocate into interfaceTypes as it copies
+    // types out of internalTypes, so we unfreeze it here.
+    unfreeze(module.interfaceTypes);
+    copyErrors(module.errors, module.interfaceTypes, builtinTypes);
+    freeze(module.interfaceTypes);
+
+    module.internalTypes.clear();
+
+    module.astTypes.clear();
+    module.astTypePacks.clear();
+    module.astExpectedTypes.clear();
+    module.astOriginalCallTypes.clear();
+    module.astOverloadResolvedTypes.clear();
+    module.astForInNextTypes.clear();
+    module.astResolvedTypes.clear();
+    module.astResolvedTypePacks.clear();
+    module.astScopes.clear();
+    module.upperBoundContributors.clear();
+
+    if (!FFlag::DebugLuauDeferredConstraintResolution)
+        module.scopes.clear();
+}
+
+static void recordModuleStats(BuildQueueItem& item, const Module& module)
+{
+    if (!item.options.recordModuleStats)
+        return;
+
+    Frontend::ModuleStats result;
+    result.name = item.name;
+
+    result.timeCheck = module.checkDurationSec;
+    result.timeConstraintGeneration = module.constraintGenerationDurationSec;
+    result.timeSolve = module.solveDurationSec;
+    result.timeTypeCheck = module.typeCheckDurationSec;
+    result.timeLint = item.stats.timeLint;
+
+    result.types = module.internalTypes.types.size();
+    result.typePacks = module.internalTypes.typePacks.size();
+    result.interfaceTypes = module.interfaceTypes.types.size();
+    result.interfaceTypePacks = module.interfaceTypes.typePacks.size();
+    result.arenaBytes = (result.types + result.interfaceTypes) * sizeof(Type) + (result.typePacks + result.interfaceTypePacks) * sizeof(TypePackVar);
+
+    item.stats.modules.push_back(std::move(result));
+}
+
 void Frontend::checkBuildQueueItem(BuildQueueItem& item)
 {
+    // modules that didn't start before the check was cancelled stay dirty, and the next check resumes from them
+    if (item.options.cancellationToken && item.options.cancellationToken->requested())
+    {
+        item.module = std::make_shared<Module>();
+        item.module->name = item.name;
+        item.module->humanReadableName = item.humanReadableName;
+        item.module->cancelled = true;
+        return;
+    }
+
     SourceNode& sourceNode = *item.sourceNode;
     const SourceModule& sourceModule = *item.sourceModule;
     const Config& config = item.config;
@@ -935,10 +1607,109 @@ void Frontend::checkBuildQueueItem(BuildQueueItem& item)
         item.stats.timeCheck += duration;
         item.stats.filesStrict += 1;
 
+        recordModuleStats(item, *moduleForAutocomplete);
+
         item.module = moduleForAutocomplete;
         return;
     }
 
+    LintOptions lintOptions = item.options.enabledLintWarnings.value_or(config.enabledLint);
+    filterLintOptions(lintOptions, sourceModule.hotcomments, mode);
+
+    auto runLintChecks = [&](const Module* module) {
+        LUAU_TIMETRACE_SCOPE("lint", "Frontend");
+
+        double timestamp = getTimestamp();
+
+        std::vector<LintWarning> warnings =
+            Luau::lint(sourceModule.root, *sourceModule.names, environmentScope, module, sourceModule.hotcomments, lintOptions);
+
+        item.stats.timeLint += getTimestamp() - timestamp;
+
+        return classifyLints(warnings, config);
+    };
+
+    // lints that don't use type information only need the AST, so lint-only runs can skip type inference
+    if (item.options.runLintChecks && item.options.lintOnly && !hasTypeAwareLints(lintOptions))
+    {
+        ModulePtr module = std::make_shared<Module>();
+        module->name = item.name;
+        module->humanReadableName = item.humanReadableName;
+        module->type = sourceModule.type;
+        module->mode = mode;
+        module->allocator = sourceModule.allocator;
+        module->names = sourceModule.names;
+
+        // dependents that are type checked see the result of the require as 'any'
+        module->returnType = builtinTypes->anyTypePack;
+
+        module->lintResult = runLintChecks(nullptr);
+
+        recordModuleStats(item, *module);
+
+        sourceNode.interfaceHash = 0;
+        sourceNode.checkKey = 0;
+        sourceNode.hasFullTypeGraphs = false;
+
+        item.module = module;
+        return;
+    }
+
+    // modules in require cycles see 'any' in place of the cyclic requires, so their results aren't a function of their dependencies
+    // retained type graphs refer to the AST, which is parsed again when a dependency changes
+    std::optional<uint64_t> checkKey;
+
+    if (!item.options.retainFullTypeGraphs && !FFlag::DebugLuauDeferredConstraintResolution && requireCycles.empty() && !item.recordJsonLog)
+        checkKey = getModuleCheckKey(sourceNodes, item, mode);
+
+    // markDirty invalidates all dependents of a changed module, but the ones that see the same dependency interfaces don't have to be checked
+    if (checkKey && *checkKey == sourceNode.checkKey)
+    {
+        if (ModulePtr module = moduleResolver.getModule(item.name))
+        {
+            sourceNode.hasFullTypeGraphs = false;
+
+            item.module = module;
+            return;
+        }
+    }
+
+    if (checkKey && interfaceCache)
+    {
+        if (std::optional<std::string> interface = interfaceCache->readInterface(getInterfaceCacheKey(*checkKey)))
+        {
+            ModulePtr module = std::make_shared<Module>();
+            module->name = item.name;
+            module->humanReadableName = item.humanReadableName;
+            module->type = sourceModule.type;
+            module->mode = mode;
+            module->allocator = sourceModule.allocator;
+            module->names = sourceModule.names;
+
+            if (deserializeModuleInterface(*module, *interface, builtinTypes, environmentScope))
+            {
+                freeze(module->interfaceTypes);
+
+                double duration = getTimestamp() - timestamp;
+
+                module->checkDurationSec = duration;
+
+                item.stats.timeCheck += duration;
+                item.stats.filesStrict += mode == Mode::Strict;
+                item.stats.filesNonstrict += mode == Mode::Nonstrict;
+
+                sourceNode.interfaceHash = getInterfaceHash(*interface, sourceModule.type);
+                sourceNode.checkKey = *checkKey;
+                sourceNode.hasFullTypeGraphs = false;
+
+                recordModuleStats(item, *module);
+
+                item.module = module;
+                return;
+            }
+        }
+    }
+
     ModulePtr module = check(sourceModule, mode, requireCycles, environmentScope, /*forAutocomplete*/ false, item.recordJsonLog, typeCheckLimits);
 
     double duration = getTimestamp() - timestamp;
@@ -960,45 +1731,16 @@ void Frontend::checkBuildQueueItem(BuildQueueItem& item)
 
     if (item.options.runLintChecks)
     {
-        LUAU_TIMETRACE_SCOPE("lint", "Frontend");
+        module->lintResult = runLintChecks(module.get());
 
-        LintOptions lintOptions = item.options.enabledLintWarnings.value_or(config.enabledLint);
-        filterLintOptions(lintOptions, sourceModule.hotcomments, mode);
-
-        double timestamp = getTimestamp();
-
-        std::vector<LintWarning> warnings =
-            Luau::lint(sourceModule.root, *sourceModule.names, environmentScope, module.get(), sourceModule.hotcomments, lintOptions);
-
-        item.stats.timeLint += getTimestamp() - timestamp;
-
-        module->lintResult = classifyLints(warnings, config);
+        if (item.options.lintOnly)
+            module->errors.clear();
     }
 
-    if (!item.options.retainFullTypeGraphs)
-    {
-        // copyErrors needs to allocate into interfaceTypes as it copies
-        // types out of internalTypes, so we unfreeze it here.
-        unfreeze(module->interfaceTypes);
-        copyErrors(module->errors, module->interfaceTypes, builtinTypes);
-        freeze(module->interfaceTypes);
-
-        module->internalTypes.clear();
+    recordModuleStats(item, *module);
 
-        module->astTypes.clear();
-        module->astTypePacks.clear();
-        module->astExpectedTypes.clear();
-        module->astOriginalCallTypes.clear();
-        module->astOverloadResolvedTypes.clear();
-        module->astForInNextTypes.clear();
-        module->astResolvedTypes.clear();
-        module->astResolvedTypePacks.clear();
-        module->astScopes.clear();
-        module->upperBoundContributors.clear();
-
-        if (!FFlag::DebugLuauDeferredConstraintResolution)
-            module->scopes.clear();
-    }
+    if (!item.options.retainFullTypeGraphs)
+        dropFullTypeGraphs(*module, builtinTypes);
 
     if (mode != Mode::NoCheck)
     {
@@ -1017,6 +1759,36 @@ void Frontend::checkBuildQueueItem(BuildQueueItem& item)
 
     module->errors.insert(module->errors.begin(), parseErrors.begin(), parseErrors.end());
 
+    sourceNode.interfaceHash = 0;
+    sourceNode.checkKey = 0;
+    sourceNode.hasFullTypeGraphs = item.options.retainFullTypeGraphs;
+
+    // dependencies can be checked again without this module when the check result is reused or when they are requested with full type graphs
+    if ((checkKey || item.options.compactDependencyTypeGraphs) && !module->timeout && !module->cancelled)
+    {
+        for (const ModuleName& dep : sourceNode.requireSet)
+        {
+            if (ModulePtr depModule = moduleResolver.getModule(dep))
+                module->requiredModules.push_back(depModule);
+        }
+    }
+
+    if (checkKey && !module->timeout && !module->cancelled)
+    {
+        sourceNode.checkKey = *checkKey;
+
+        std::string interface = serializeModuleInterface(*module, builtinTypes, environmentScope);
+
+        if (!interface.empty())
+        {
+            sourceNode.interfaceHash = getInterfaceHash(interface, sourceModule.type);
+
+            // errors and lint warnings are not stored, so only the modules without them can be skipped
+            if (interfaceCache && module->errors.empty() && module->lintResult.errors.empty() && module->lintResult.warnings.empty())
+                interfaceCache->writeInterface(getInterfaceCacheKey(*checkKey), interface);
+        }
+    }
+
     item.module = module;
 }
 
@@ -1033,6 +1805,46 @@ void Frontend::checkBuildQueueItems(std::vector<BuildQueueItem>& items)
     }
 }
 
+void Frontend::streamCheckResult(const ModuleName& name, const FrontendOptions& frontendOptions,
+    const std::function<void(const ModuleName& name, CheckResult result)>& streamResult)
+{
+    auto& resolver = frontendOptions.forAutocomplete ? moduleResolverForAutocomplete : moduleResolver;
+
+    ModulePtr module = resolver.getModule(name);
+
+    if (!module)
+        return;
+
+    CheckResult checkResult;
+
+    if (module->timeout)
+        checkResult.timeoutHits.push_back(name);
+
+    if (frontendOptions.releaseStreamedResults)
+    {
+        auto it = sourceNodes.find(name);
+
+        if (it != sourceNodes.end() && it->second->hasFullTypeGraphs)
+        {
+            dropFullTypeGraphs(*module, builtinTypes);
+            it->second->hasFullTypeGraphs = false;
+        }
+
+        checkResult.errors = std::move(module->errors);
+        checkResult.lintResult = std::move(module->lintResult);
+
+        module->errors.clear();
+        module->lintResult = {};
+    }
+    else
+    {
+        checkResult.errors = module->errors;
+        checkResult.lintResult = module->lintResult;
+    }
+
+    streamResult(name, std::move(checkResult));
+}
+
 void Frontend::recordItemResult(const BuildQueueItem& item)
 {
     if (item.exception)
@@ -1054,6 +1866,11 @@ void Frontend::recordItemResult(const BuildQueueItem& item)
 
     stats.filesStrict += item.stats.filesStrict;
     stats.filesNonstrict += item.stats.filesNonstrict;
+
+    stats.modules.insert(stats.modules.end(), item.stats.modules.begin(), item.stats.modules.end());
+
+    if (!item.module->solverProfile.empty())
+        stats.solverProfile.merge(item.module->solverProfile);
 }
 
 ScopePtr Frontend::getModuleEnvironment(const SourceModule& module, const Config& config, bool forAutocomplete) const
@@ -1182,7 +1999,7 @@ ModulePtr check(const SourceModule& sourceModule, Mode mode, const std::vector<R
         std::optional<SourceCode> source = fileResolver->readSource(result->name);
         if (source)
         {
-            logger->captureSource(source->source);
+            logger->captureSource(std::string(source->text()));
         }
     }
 
@@ -1197,15 +2014,23 @@ ModulePtr check(const SourceModule& sourceModule, Mode mode, const std::vector<R
     ConstraintGenerator cg{result, NotNull{&normalizer}, moduleResolver, builtinTypes, iceHandler, parentScope, std::move(prepareModuleScope),
         logger.get(), NotNull{&dfg}, requireCycles};
 
+    double timestamp = getTimestamp();
+
     cg.visitModuleRoot(sourceModule.root);
     result->errors = std::move(cg.errors);
 
+    result->constraintGenerationDurationSec = getTimestamp() - timestamp;
+
     ConstraintSolver cs{NotNull{&normalizer}, NotNull(cg.rootScope), borrowConstraints(cg.constraints), result->humanReadableName, moduleResolver,
         requireCycles, logger.get(), limits};
 
     if (options.randomizeConstraintResolutionSeed)
         cs.randomize(*options.randomizeConstraintResolutionSeed);
 
+    cs.profile = options.profileSolver;
+
+    timestamp = getTimestamp();
+
     try
     {
         cs.run();
@@ -1219,6 +2044,15 @@ ModulePtr check(const SourceModule& sourceModule, Mode mode, const std::vector<R
         result->cancelled = true;
     }
 
+    result->solveDurationSec = getTimestamp() - timestamp;
+
+    // profile is collected for modules that hit the time limit as well, since those are the ones that need it the most
+    if (options.profileSolver)
+    {
+        result->solverProfile = cs.getProfile();
+        result->solverProfile.timeSolve = result->solveDurationSec;
+    }
+
     for (TypeError& e : cs.errors)
         result->errors.emplace_back(std::move(e));
 
@@ -1243,12 +2077,29 @@ ModulePtr check(const SourceModule& sourceModule, Mode mode, const std::vector<R
     }
     else
     {
-        if (mode == Mode::Nonstrict)
-            Luau::checkNonStrict(builtinTypes, iceHandler, NotNull{&unifierState}, NotNull{&dfg}, NotNull{&limits}, sourceModule, result.get());
-        else
-            Luau::check(builtinTypes, NotNull{&unifierState}, NotNull{&limits}, logger.get(), sourceModule, result.get());
+        timestamp = getTimestamp();
+
+        try
+        {
+            if (mode == Mode::Nonstrict)
+                Luau::checkNonStrict(builtinTypes, iceHandler, NotNull{&unifierState}, NotNull{&dfg}, NotNull{&limits}, sourceModule, result.get());
+            else
+                Luau::check(builtinTypes, NotNull{&unifierState}, NotNull{&limits}, logger.get(), sourceModule, result.get());
+        }
+        catch (const UserCancelError&)
+        {
+            result->cancelled = true;
+        }
+
+        result->typeCheckDurationSec = getTimestamp() - timestamp;
+
+        if (options.profileSolver)
+            result->solverProfile.timeTypeCheck = result->typeCheckDurationSec;
     }
 
+    if (logger && options.profileSolver)
+        logger->captureSolverProfile(result->solverProfile);
+
     // It would be nice if we could freeze the arenas before doing type
     // checking, but we'll have to do some work to get there.
     //
@@ -1275,6 +2126,32 @@ ModulePtr check(const SourceModule& sourceModule, Mode mode, const std::vector<R
     return result;
 }
 
+ModulePtr Frontend::checkFragment(const SourceModule& sourceModule, const ScopePtr& environmentScope, std::optional<FrontendOptions> optionOverride)
+{
+    LUAU_TIMETRACE_SCOPE("Frontend::checkFragment", "Frontend");
+    LUAU_TIMETRACE_ARGUMENT("module", sourceModule.name.c_str());
+
+    FrontendOptions frontendOptions = optionOverride.value_or(options);
+
+    TypeCheckLimits typeCheckLimits;
+
+    if (frontendOptions.moduleTimeLimitSec)
+        typeCheckLimits.finishTime = TimeTrace::getClock() + *frontendOptions.moduleTimeLimitSec;
+
+    typeCheckLimits.cancellationToken = frontendOptions.cancellationToken;
+
+    double timestamp = getTimestamp();
+
+    // Same as the regular autocomplete typecheck, fragments are checked in strict mode
+    ModulePtr module =
+        check(sourceModule, Mode::Strict, {}, environmentScope, /*forAutocomplete*/ true, /*recordJsonLog*/ false, typeCheckLimits);
+
+    module->checkDurationSec = getTimestamp() - timestamp;
+    stats.timeCheck += module->checkDurationSec;
+
+    return module;
+}
+
 ModulePtr Frontend::check(const SourceModule& sourceModule, Mode mode, std::vector<RequireCycle> requireCycles,
     std::optional<ScopePtr> environmentScope, bool forAutocomplete, bool recordJsonLog, TypeCheckLimits typeCheckLimits)
 {
@@ -1318,7 +2195,13 @@ ModulePtr Frontend::check(const SourceModule& sourceModule, Mode mode, std::vect
         typeChecker.unifierIterationLimit = typeCheckLimits.unifierIterationLimit;
         typeChecker.cancellationToken = typeCheckLimits.cancellationToken;
 
-        return typeChecker.check(sourceModule, mode, environmentScope);
+        double timestamp = getTimestamp();
+
+        ModulePtr module = typeChecker.check(sourceModule, mode, environmentScope);
+
+        module->typeCheckDurationSec = getTimestamp() - timestamp;
+
+        return module;
     }
 }
 
@@ -1338,51 +2221,76 @@ std::pair<SourceNode*, SourceModule*> Frontend::getSourceNode(const ModuleName&
         }
     }
 
+    ParseQueueItem item;
+    item.name = name;
+    item.parseOptions = configResolver->getConfig(name).parseOptions;
+    item.parseOptions.captureComments = true;
+
+    parseQueueItem(item);
+
+    return recordParseQueueItem(item);
+}
+
+// Reads and parses the module source without modifying the frontend state, so that multiple items can be processed in parallel
+void Frontend::parseQueueItem(ParseQueueItem& item) const
+{
     LUAU_TIMETRACE_SCOPE("Frontend::getSourceNode", "Frontend");
-    LUAU_TIMETRACE_ARGUMENT("name", name.c_str());
+    LUAU_TIMETRACE_ARGUMENT("name", item.name.c_str());
 
     double timestamp = getTimestamp();
 
-    std::optional<SourceCode> source = fileResolver->readSource(name);
-    std::optional<std::string> environmentName = fileResolver->getEnvironmentForModule(name);
+    item.source = fileResolver->readSource(item.name);
+    item.environmentName = fileResolver->getEnvironmentForModule(item.name);
+
+    item.stats.timeRead += getTimestamp() - timestamp;
 
-    stats.timeRead += getTimestamp() - timestamp;
+    if (!item.source)
+        return;
+
+    item.sourceModule = parse(item.name, item.source->text(), item.parseOptions, item.stats);
+    item.sourceModule.type = item.source->type;
+
+    item.require = traceRequires(fileResolver, item.sourceModule.root, item.name);
+}
 
-    if (!source)
+std::pair<SourceNode*, SourceModule*> Frontend::recordParseQueueItem(ParseQueueItem& item)
+{
+    const ModuleName& name = item.name;
+
+    stats.timeRead += item.stats.timeRead;
+    stats.timeParse += item.stats.timeParse;
+    stats.files += item.stats.files;
+    stats.lines += item.stats.lines;
+
+    if (!item.source)
     {
         sourceModules.erase(name);
         return {nullptr, nullptr};
     }
 
-    const Config& config = configResolver->getConfig(name);
-    ParseOptions opts = config.parseOptions;
-    opts.captureComments = true;
-    SourceModule result = parse(name, source->source, opts);
-    result.type = source->type;
-
     RequireTraceResult& require = requireTrace[name];
-    require = traceRequires(fileResolver, result.root, name);
+    require = std::move(item.require);
 
     std::shared_ptr<SourceNode>& sourceNode = sourceNodes[name];
 
+    bool newNode = !sourceNode;
+
     if (!sourceNode)
         sourceNode = std::make_shared<SourceNode>();
 
+    // published snapshots can still refer to the previous source module, so it's replaced instead of being updated
     std::shared_ptr<SourceModule>& sourceModule = sourceModules[name];
-
-    if (!sourceModule)
-        sourceModule = std::make_shared<SourceModule>();
-
-    *sourceModule = std::move(result);
-    sourceModule->environmentName = environmentName;
+    sourceModule = std::make_shared<SourceModule>(std::move(item.sourceModule));
+    sourceModule->environmentName = item.environmentName;
 
     sourceNode->name = sourceModule->name;
     sourceNode->humanReadableName = sourceModule->humanReadableName;
+    sourceNode->sourceHash = getSourceHash(*item.source, item.environmentName);
     sourceNode->requireSet.clear();
     sourceNode->requireLocations.clear();
     sourceNode->dirtySourceModule = false;
 
-    if (it == sourceNodes.end())
+    if (newNode)
     {
         sourceNode->dirtyModule = true;
         sourceNode->dirtyModuleForAutocomplete = true;
@@ -1409,7 +2317,7 @@ std::pair<SourceNode*, SourceModule*> Frontend::getSourceNode(const ModuleName&
  * We also translate Luau::ParseError into a Luau::TypeError so that we can use a vector<TypeError> to describe the
  * result of the check()
  */
-SourceModule Frontend::parse(const ModuleName& name, std::string_view src, const ParseOptions& parseOptions)
+SourceModule Frontend::parse(const ModuleName& name, std::string_view src, const ParseOptions& parseOptions, Stats& parseStats) const
 {
     LUAU_TIMETRACE_SCOPE("Frontend::parse", "Frontend");
     LUAU_TIMETRACE_ARGUMENT("name", name.c_str());
@@ -1420,9 +2328,9 @@ SourceModule Frontend::parse(const ModuleName& name, std::string_view src, const
 
     Luau::ParseResult parseResult = Luau::Parser::parse(src.data(), src.size(), *sourceModule.names, *sourceModule.allocator, parseOptions);
 
-    stats.timeParse += getTimestamp() - timestamp;
-    stats.files++;
-    stats.lines += parseResult.lines;
+    parseStats.timeParse += getTimestamp() - timestamp;
+    parseStats.files++;
+    parseStats.lines += parseResult.lines;
 
     if (!parseResult.errors.empty())
         sourceModule.parseErrors.insert(sourceModule.parseErrors.end(), parseResult.errors.begin(), parseResult.errors.end());
@@ -2,6 +2,8 @@
 
 #include "Luau/GlobalTypes.h"
 
+#include "Luau/Normalize.h"
+
 namespace Luau
 {
 
@@ -27,4 +29,10 @@ GlobalTypes::GlobalTypes(NotNull<BuiltinTypes> builtinTypes)
     freeze(*builtinTypes->arena);
 }
 
+GlobalTypes::~GlobalTypes()
+{
+    // Shared normal forms can refer to the global types, which are about to be destroyed
+    builtinTypes->normalizerCache->clear();
+}
+
 } // namespace Luau
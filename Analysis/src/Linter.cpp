@@ -195,25 +195,182 @@ static bool similar(AstExpr* lhs, AstExpr* rhs)
 #undef CASE
 }
 
-class LintGlobalLocal : AstVisitor
+class LintPass : public AstVisitor
 {
 public:
-    LUAU_NOINLINE static void process(LintContext& context)
+    // Called once the traversal of the whole tree is complete
+    virtual void finish() {}
+};
+
+// Runs all enabled lint passes over the tree in a single traversal instead of one traversal per pass
+// A pass that doesn't descend into a node (or traverses its children on its own) is not given the nodes of that subtree
+class LintFusedVisitor : public AstVisitor
+{
+public:
+    void add(std::unique_ptr<LintPass> pass)
     {
-        LintGlobalLocal pass;
-        pass.context = &context;
+        passes.push_back(std::move(pass));
+    }
+
+    void run(AstStat* root)
+    {
+        for (const std::unique_ptr<LintPass>& pass : passes)
+            active.push_back(pass.get());
+
+        if (!active.empty())
+            root->visit(this);
+
+        for (const std::unique_ptr<LintPass>& pass : passes)
+            pass->finish();
+    }
+
+private:
+    std::vector<std::unique_ptr<LintPass>> passes;
+
+    // Passes that are interested in the current node are stored in [activeBegin, active.size())
+    std::vector<LintPass*> active;
+    size_t activeBegin = 0;
+
+    struct ChildVisitor : AstVisitor
+    {
+        LintFusedVisitor* owner;
+        AstNode* parent;
+
+        ChildVisitor(LintFusedVisitor* owner, AstNode* parent)
+            : owner(owner)
+            , parent(parent)
+        {
+        }
+
+        bool visit(AstNode* node) override
+        {
+            if (node == parent)
+                return true;
+
+            node->visit(owner);
+            return false;
+        }
+
+        bool visit(AstType* node) override
+        {
+            return visit(static_cast<AstNode*>(node));
+        }
+
+        bool visit(AstTypePack* node) override
+        {
+            return visit(static_cast<AstNode*>(node));
+        }
+    };
+
+    template<typename T>
+    bool dispatch(T* node)
+    {
+        size_t begin = activeBegin;
+        size_t end = active.size();
+
+        for (size_t i = begin; i < end; ++i)
+        {
+            LintPass* pass = active[i];
+
+            if (pass->visit(node))
+                active.push_back(pass);
+        }
+
+        if (active.size() != end)
+        {
+            activeBegin = end;
+
+            ChildVisitor children{this, node};
+            node->visit(&children);
+
+            active.resize(end);
+            activeBegin = begin;
+        }
+
+        return false;
+    }
+
+#define LINT_FUSED_VISIT(T) \
+    bool visit(T* node) override \
+    { \
+        return dispatch(node); \
+    }
+
+    LINT_FUSED_VISIT(AstExprGroup)
+    LINT_FUSED_VISIT(AstExprConstantNil)
+    LINT_FUSED_VISIT(AstExprConstantBool)
+    LINT_FUSED_VISIT(AstExprConstantNumber)
+    LINT_FUSED_VISIT(AstExprConstantString)
+    LINT_FUSED_VISIT(AstExprLocal)
+    LINT_FUSED_VISIT(AstExprGlobal)
+    LINT_FUSED_VISIT(AstExprVarargs)
+    LINT_FUSED_VISIT(AstExprCall)
+    LINT_FUSED_VISIT(AstExprIndexName)
+    LINT_FUSED_VISIT(AstExprIndexExpr)
+    LINT_FUSED_VISIT(AstExprFunction)
+    LINT_FUSED_VISIT(AstExprTable)
+    LINT_FUSED_VISIT(AstExprUnary)
+    LINT_FUSED_VISIT(AstExprBinary)
+    LINT_FUSED_VISIT(AstExprTypeAssertion)
+    LINT_FUSED_VISIT(AstExprIfElse)
+    LINT_FUSED_VISIT(AstExprInterpString)
+    LINT_FUSED_VISIT(AstExprError)
+
+    LINT_FUSED_VISIT(AstStatBlock)
+    LINT_FUSED_VISIT(AstStatIf)
+    LINT_FUSED_VISIT(AstStatWhile)
+    LINT_FUSED_VISIT(AstStatRepeat)
+    LINT_FUSED_VISIT(AstStatBreak)
+    LINT_FUSED_VISIT(AstStatContinue)
+    LINT_FUSED_VISIT(AstStatReturn)
+    LINT_FUSED_VISIT(AstStatExpr)
+    LINT_FUSED_VISIT(AstStatLocal)
+    LINT_FUSED_VISIT(AstStatFor)
+    LINT_FUSED_VISIT(AstStatForIn)
+    LINT_FUSED_VISIT(AstStatAssign)
+    LINT_FUSED_VISIT(AstStatCompoundAssign)
+    LINT_FUSED_VISIT(AstStatFunction)
+    LINT_FUSED_VISIT(AstStatLocalFunction)
+    LINT_FUSED_VISIT(AstStatTypeAlias)
+    LINT_FUSED_VISIT(AstStatDeclareFunction)
+    LINT_FUSED_VISIT(AstStatDeclareGlobal)
+    LINT_FUSED_VISIT(AstStatDeclareClass)
+    LINT_FUSED_VISIT(AstStatError)
+
+    LINT_FUSED_VISIT(AstTypeReference)
+    LINT_FUSED_VISIT(AstTypeTable)
+    LINT_FUSED_VISIT(AstTypeFunction)
+    LINT_FUSED_VISIT(AstTypeTypeof)
+    LINT_FUSED_VISIT(AstTypeUnion)
+    LINT_FUSED_VISIT(AstTypeIntersection)
+    LINT_FUSED_VISIT(AstTypeSingletonBool)
+    LINT_FUSED_VISIT(AstTypeSingletonString)
+    LINT_FUSED_VISIT(AstTypeError)
+
+    LINT_FUSED_VISIT(AstTypePackExplicit)
+    LINT_FUSED_VISIT(AstTypePackVariadic)
+    LINT_FUSED_VISIT(AstTypePackGeneric)
+
+#undef LINT_FUSED_VISIT
+};
+
+class LintGlobalLocal : public LintPass
+{
+public:
+    LUAU_NOINLINE static void process(LintContext& context, LintFusedVisitor& fused)
+    {
+        std::unique_ptr<LintGlobalLocal> pass(new LintGlobalLocal());
+        pass->context = &context;
 
         for (auto& global : context.builtinGlobals)
         {
-            Global& g = pass.globals[global.first];
+            Global& g = pass->globals[global.first];
 
             g.builtin = true;
             g.deprecated = global.second.deprecated;
         }
 
-        context.root->visit(&pass);
-
-        pass.report();
+        fused.add(std::move(pass));
     }
 
 private:
@@ -257,7 +414,7 @@ private:
     {
     }
 
-    void report()
+    void finish() override
     {
         for (size_t i = 0; i < globalRefs.size(); ++i)
         {
@@ -520,17 +677,17 @@ private:
     }
 };
 
-class LintSameLineStatement : AstVisitor
+class LintSameLineStatement : public LintPass
 {
 public:
-    LUAU_NOINLINE static void process(LintContext& context)
+    LUAU_NOINLINE static void process(LintContext& context, LintFusedVisitor& fused)
     {
-        LintSameLineStatement pass;
+        std::unique_ptr<LintSameLineStatement> pass(new LintSameLineStatement());
 
-        pass.context = &context;
-        pass.lastLine = ~0u;
+        pass->context = &context;
+        pass->lastLine = ~0u;
 
-        context.root->visit(&pass);
+        fused.add(std::move(pass));
     }
 
 private:
@@ -569,15 +726,15 @@ private:
     }
 };
 
-class LintMultiLineStatement : AstVisitor
+class LintMultiLineStatement : public LintPass
 {
 public:
-    LUAU_NOINLINE static void process(LintContext& context)
+    LUAU_NOINLINE static void process(LintContext& context, LintFusedVisitor& fused)
     {
-        LintMultiLineStatement pass;
-        pass.context = &context;
+        std::unique_ptr<LintMultiLineStatement> pass(new LintMultiLineStatement());
+        pass->context = &context;
 
-        context.root->visit(&pass);
+        fused.add(std::move(pass));
     }
 
 private:
@@ -649,20 +806,18 @@ private:
     }
 };
 
-class LintLocalHygiene : AstVisitor
+class LintLocalHygiene : public LintPass
 {
 public:
-    LUAU_NOINLINE static void process(LintContext& context)
+    LUAU_NOINLINE static void process(LintContext& context, LintFusedVisitor& fused)
     {
-        LintLocalHygiene pass;
-        pass.context = &context;
+        std::unique_ptr<LintLocalHygiene> pass(new LintLocalHygiene());
+        pass->context = &context;
 
         for (auto& global : context.builtinGlobals)
-            pass.globals[global.first].builtin = true;
-
-        context.root->visit(&pass);
+            pass->globals[global.first].builtin = true;
 
-        pass.report();
+        fused.add(std::move(pass));
     }
 
 private:
@@ -695,7 +850,7 @@ private:
     {
     }
 
-    void report()
+    void finish() override
     {
         for (auto& l : locals)
         {
@@ -872,17 +1027,15 @@ private:
     }
 };
 
-class LintUnusedFunction : AstVisitor
+class LintUnusedFunction : public LintPass
 {
 public:
-    LUAU_NOINLINE static void process(LintContext& context)
+    LUAU_NOINLINE static void process(LintContext& context, LintFusedVisitor& fused)
     {
-        LintUnusedFunction pass;
-        pass.context = &context;
-
-        context.root->visit(&pass);
+        std::unique_ptr<LintUnusedFunction> pass(new LintUnusedFunction());
+        pass->context = &context;
 
-        pass.report();
+        fused.add(std::move(pass));
     }
 
 private:
@@ -902,7 +1055,7 @@ private:
     {
     }
 
-    void report()
+    void finish() override
     {
         for (auto& g : globals)
         {
@@ -939,16 +1092,17 @@ private:
     }
 };
 
-class LintUnreachableCode : AstVisitor
+class LintUnreachableCode : public LintPass
 {
 public:
-    LUAU_NOINLINE static void process(LintContext& context)
+    LUAU_NOINLINE static void process(LintContext& context, LintFusedVisitor& fused)
     {
-        LintUnreachableCode pass;
-        pass.context = &context;
+        std::unique_ptr<LintUnreachableCode> pass(new LintUnreachableCode());
+        pass->context = &context;
+
+        pass->analyze(context.root);
 
-        pass.analyze(context.root);
-        context.root->visit(&pass);
+        fused.add(std::move(pass));
     }
 
 private:
@@ -1080,15 +1234,15 @@ private:
     }
 };
 
-class LintUnknownType : AstVisitor
+class LintUnknownType : public LintPass
 {
 public:
-    LUAU_NOINLINE static void process(LintContext& context)
+    LUAU_NOINLINE static void process(LintContext& context, LintFusedVisitor& fused)
     {
-        LintUnknownType pass;
-        pass.context = &context;
+        std::unique_ptr<LintUnknownType> pass(new LintUnknownType());
+        pass->context = &context;
 
-        context.root->visit(&pass);
+        fused.add(std::move(pass));
     }
 
 private:
@@ -1169,15 +1323,15 @@ private:
     }
 };
 
-class LintForRange : AstVisitor
+class LintForRange : public LintPass
 {
 public:
-    LUAU_NOINLINE static void process(LintContext& context)
+    LUAU_NOINLINE static void process(LintContext& context, LintFusedVisitor& fused)
     {
-        LintForRange pass;
-        pass.context = &context;
+        std::unique_ptr<LintForRange> pass(new LintForRange());
+        pass->context = &context;
 
-        context.root->visit(&pass);
+        fused.add(std::move(pass));
     }
 
 private:
@@ -1225,15 +1379,15 @@ private:
     }
 };
 
-class LintUnbalancedAssignment : AstVisitor
+class LintUnbalancedAssignment : public LintPass
 {
 public:
-    LUAU_NOINLINE static void process(LintContext& context)
+    LUAU_NOINLINE static void process(LintContext& context, LintFusedVisitor& fused)
     {
-        LintUnbalancedAssignment pass;
-        pass.context = &context;
+        std::unique_ptr<LintUnbalancedAssignment> pass(new LintUnbalancedAssignment());
+        pass->context = &context;
 
-        context.root->visit(&pass);
+        fused.add(std::move(pass));
     }
 
 private:
@@ -1274,15 +1428,15 @@ private:
     }
 };
 
-class LintImplicitReturn : AstVisitor
+class LintImplicitReturn : public LintPass
 {
 public:
-    LUAU_NOINLINE static void process(LintContext& context)
+    LUAU_NOINLINE static void process(LintContext& context, LintFusedVisitor& fused)
     {
-        LintImplicitReturn pass;
-        pass.context = &context;
+        std::unique_ptr<LintImplicitReturn> pass(new LintImplicitReturn());
+        pass->context = &context;
 
-        context.root->visit(&pass);
+        fused.add(std::move(pass));
     }
 
 private:
@@ -1351,15 +1505,15 @@ private:
     }
 };
 
-class LintFormatString : AstVisitor
+class LintFormatString : public LintPass
 {
 public:
-    LUAU_NOINLINE static void process(LintContext& context)
+    LUAU_NOINLINE static void process(LintContext& context, LintFusedVisitor& fused)
     {
-        LintFormatString pass;
-        pass.context = &context;
+        std::unique_ptr<LintFormatString> pass(new LintFormatString());
+        pass->context = &context;
 
-        context.root->visit(&pass);
+        fused.add(std::move(pass));
     }
 
     static void fuzz(const char* data, size_t size)
@@ -1780,15 +1934,15 @@ private:
     }
 };
 
-class LintTableLiteral : AstVisitor
+class LintTableLiteral : public LintPass
 {
 public:
-    LUAU_NOINLINE static void process(LintContext& context)
+    LUAU_NOINLINE static void process(LintContext& context, LintFusedVisitor& fused)
     {
-        LintTableLiteral pass;
-        pass.context = &context;
+        std::unique_ptr<LintTableLiteral> pass(new LintTableLiteral());
+        pass->context = &context;
 
-        context.root->visit(&pass);
+        fused.add(std::move(pass));
     }
 
 private:
@@ -1878,17 +2032,15 @@ private:
     };
 };
 
-class LintUninitializedLocal : AstVisitor
+class LintUninitializedLocal : public LintPass
 {
 public:
-    LUAU_NOINLINE static void process(LintContext& context)
+    LUAU_NOINLINE static void process(LintContext& context, LintFusedVisitor& fused)
     {
-        LintUninitializedLocal pass;
-        pass.context = &context;
-
-        context.root->visit(&pass);
+        std::unique_ptr<LintUninitializedLocal> pass(new LintUninitializedLocal());
+        pass->context = &context;
 
-        pass.report();
+        fused.add(std::move(pass));
     }
 
 private:
@@ -1908,7 +2060,7 @@ private:
     {
     }
 
-    void report()
+    void finish() override
     {
         for (auto& lp : locals)
         {
@@ -1984,13 +2136,12 @@ private:
     }
 };
 
-class LintDuplicateFunction : AstVisitor
+class LintDuplicateFunction : public LintPass
 {
 public:
-    LUAU_NOINLINE static void process(LintContext& context)
+    LUAU_NOINLINE static void process(LintContext& context, LintFusedVisitor& fused)
     {
-        LintDuplicateFunction pass{&context};
-        context.root->visit(&pass);
+        fused.add(std::unique_ptr<LintDuplicateFunction>(new LintDuplicateFunction(&context)));
     }
 
 private:
@@ -2058,13 +2209,12 @@ private:
     }
 };
 
-class LintDeprecatedApi : AstVisitor
+class LintDeprecatedApi : public LintPass
 {
 public:
-    LUAU_NOINLINE static void process(LintContext& context)
+    LUAU_NOINLINE static void process(LintContext& context, LintFusedVisitor& fused)
     {
-        LintDeprecatedApi pass{&context};
-        context.root->visit(&pass);
+        fused.add(std::unique_ptr<LintDeprecatedApi>(new LintDeprecatedApi(&context)));
     }
 
 private:
@@ -2160,16 +2310,15 @@ private:
     }
 };
 
-class LintTableOperations : AstVisitor
+class LintTableOperations : public LintPass
 {
 public:
-    LUAU_NOINLINE static void process(LintContext& context)
+    LUAU_NOINLINE static void process(LintContext& context, LintFusedVisitor& fused)
     {
         if (!context.module)
             return;
 
-        LintTableOperations pass{&context};
-        context.root->visit(&pass);
+        fused.add(std::unique_ptr<LintTableOperations>(new LintTableOperations(&context)));
     }
 
 private:
@@ -2339,13 +2488,12 @@ private:
     }
 };
 
-class LintDuplicateCondition : AstVisitor
+class LintDuplicateCondition : public LintPass
 {
 public:
-    LUAU_NOINLINE static void process(LintContext& context)
+    LUAU_NOINLINE static void process(LintContext& context, LintFusedVisitor& fused)
     {
-        LintDuplicateCondition pass{&context};
-        context.root->visit(&pass);
+        fused.add(std::unique_ptr<LintDuplicateCondition>(new LintDuplicateCondition(&context)));
     }
 
 private:
@@ -2506,15 +2654,15 @@ private:
     }
 };
 
-class LintDuplicateLocal : AstVisitor
+class LintDuplicateLocal : public LintPass
 {
 public:
-    LUAU_NOINLINE static void process(LintContext& context)
+    LUAU_NOINLINE static void process(LintContext& context, LintFusedVisitor& fused)
     {
-        LintDuplicateLocal pass;
-        pass.context = &context;
+        std::unique_ptr<LintDuplicateLocal> pass(new LintDuplicateLocal());
+        pass->context = &context;
 
-        context.root->visit(&pass);
+        fused.add(std::move(pass));
     }
 
 private:
@@ -2588,15 +2736,15 @@ private:
     }
 };
 
-class LintMisleadingAndOr : AstVisitor
+class LintMisleadingAndOr : public LintPass
 {
 public:
-    LUAU_NOINLINE static void process(LintContext& context)
+    LUAU_NOINLINE static void process(LintContext& context, LintFusedVisitor& fused)
     {
-        LintMisleadingAndOr pass;
-        pass.context = &context;
+        std::unique_ptr<LintMisleadingAndOr> pass(new LintMisleadingAndOr());
+        pass->context = &context;
 
-        context.root->visit(&pass);
+        fused.add(std::move(pass));
     }
 
 private:
@@ -2628,15 +2776,15 @@ private:
     }
 };
 
-class LintIntegerParsing : AstVisitor
+class LintIntegerParsing : public LintPass
 {
 public:
-    LUAU_NOINLINE static void process(LintContext& context)
+    LUAU_NOINLINE static void process(LintContext& context, LintFusedVisitor& fused)
     {
-        LintIntegerParsing pass;
-        pass.context = &context;
+        std::unique_ptr<LintIntegerParsing> pass(new LintIntegerParsing());
+        pass->context = &context;
 
-        context.root->visit(&pass);
+        fused.add(std::move(pass));
     }
 
 private:
@@ -2667,15 +2815,15 @@ private:
     }
 };
 
-class LintComparisonPrecedence : AstVisitor
+class LintComparisonPrecedence : public LintPass
 {
 public:
-    LUAU_NOINLINE static void process(LintContext& context)
+    LUAU_NOINLINE static void process(LintContext& context, LintFusedVisitor& fused)
     {
-        LintComparisonPrecedence pass;
-        pass.context = &context;
+        std::unique_ptr<LintComparisonPrecedence> pass(new LintComparisonPrecedence());
+        pass->context = &context;
 
-        context.root->visit(&pass);
+        fused.add(std::move(pass));
     }
 
 private:
@@ -2890,78 +3038,82 @@ std::vector<LintWarning> lint(AstStat* root, const AstNameTable& names, const Sc
 
     fillBuiltinGlobals(context, names, env);
 
+    LintFusedVisitor fused;
+
     if (context.warningEnabled(LintWarning::Code_UnknownGlobal) || context.warningEnabled(LintWarning::Code_DeprecatedGlobal) ||
         context.warningEnabled(LintWarning::Code_GlobalUsedAsLocal) || context.warningEnabled(LintWarning::Code_PlaceholderRead) ||
         context.warningEnabled(LintWarning::Code_BuiltinGlobalWrite))
     {
-        LintGlobalLocal::process(context);
+        LintGlobalLocal::process(context, fused);
     }
 
     if (context.warningEnabled(LintWarning::Code_MultiLineStatement))
-        LintMultiLineStatement::process(context);
+        LintMultiLineStatement::process(context, fused);
 
     if (context.warningEnabled(LintWarning::Code_SameLineStatement))
-        LintSameLineStatement::process(context);
+        LintSameLineStatement::process(context, fused);
 
     if (context.warningEnabled(LintWarning::Code_LocalShadow) || context.warningEnabled(LintWarning::Code_FunctionUnused) ||
         context.warningEnabled(LintWarning::Code_ImportUnused) || context.warningEnabled(LintWarning::Code_LocalUnused))
     {
-        LintLocalHygiene::process(context);
+        LintLocalHygiene::process(context, fused);
     }
 
     if (context.warningEnabled(LintWarning::Code_FunctionUnused))
-        LintUnusedFunction::process(context);
+        LintUnusedFunction::process(context, fused);
 
     if (context.warningEnabled(LintWarning::Code_UnreachableCode))
-        LintUnreachableCode::process(context);
+        LintUnreachableCode::process(context, fused);
 
     if (context.warningEnabled(LintWarning::Code_UnknownType))
-        LintUnknownType::process(context);
+        LintUnknownType::process(context, fused);
 
     if (context.warningEnabled(LintWarning::Code_ForRange))
-        LintForRange::process(context);
+        LintForRange::process(context, fused);
 
     if (context.warningEnabled(LintWarning::Code_UnbalancedAssignment))
-        LintUnbalancedAssignment::process(context);
+        LintUnbalancedAssignment::process(context, fused);
 
     if (context.warningEnabled(LintWarning::Code_ImplicitReturn))
-        LintImplicitReturn::process(context);
+        LintImplicitReturn::process(context, fused);
 
     if (context.warningEnabled(LintWarning::Code_FormatString))
-        LintFormatString::process(context);
+        LintFormatString::process(context, fused);
 
     if (context.warningEnabled(LintWarning::Code_TableLiteral))
-        LintTableLiteral::process(context);
+        LintTableLiteral::process(context, fused);
 
     if (context.warningEnabled(LintWarning::Code_UninitializedLocal))
-        LintUninitializedLocal::process(context);
+        LintUninitializedLocal::process(context, fused);
 
     if (context.warningEnabled(LintWarning::Code_DuplicateFunction))
-        LintDuplicateFunction::process(context);
+        LintDuplicateFunction::process(context, fused);
 
     if (context.warningEnabled(LintWarning::Code_DeprecatedApi))
-        LintDeprecatedApi::process(context);
+        LintDeprecatedApi::process(context, fused);
 
     if (context.warningEnabled(LintWarning::Code_TableOperations))
-        LintTableOperations::process(context);
+        LintTableOperations::process(context, fused);
 
     if (context.warningEnabled(LintWarning::Code_DuplicateCondition))
-        LintDuplicateCondition::process(context);
+        LintDuplicateCondition::process(context, fused);
 
     if (context.warningEnabled(LintWarning::Code_DuplicateLocal))
-        LintDuplicateLocal::process(context);
+        LintDuplicateLocal::process(context, fused);
 
     if (context.warningEnabled(LintWarning::Code_MisleadingAndOr))
-        LintMisleadingAndOr::process(context);
-
-    if (context.warningEnabled(LintWarning::Code_CommentDirective))
-        lintComments(context, hotcomments);
+        LintMisleadingAndOr::process(context, fused);
 
     if (context.warningEnabled(LintWarning::Code_IntegerParsing))
-        LintIntegerParsing::process(context);
+        LintIntegerParsing::process(context, fused);
 
     if (context.warningEnabled(LintWarning::Code_ComparisonPrecedence))
-        LintComparisonPrecedence::process(context);
+        LintComparisonPrecedence::process(context, fused);
+
+    fused.run(root);
+
+    if (context.warningEnabled(LintWarning::Code_CommentDirective))
+        lintComments(context, hotcomments);
 
     std::sort(context.result.begin(), context.result.end(), WarningComparator());
 
@@ -2982,6 +3134,12 @@ std::vector<AstName> getDeprecatedGlobals(const AstNameTable& names)
     return result;
 }
 
+bool hasTypeAwareLints(const LintOptions& options)
+{
+    return options.isEnabled(LintWarning::Code_FormatString) || options.isEnabled(LintWarning::Code_DeprecatedApi) ||
+           options.isEnabled(LintWarning::Code_TableOperations);
+}
+
 void fuzzFormatString(const char* data, size_t size)
 {
     LintFormatString::fuzz(data, size);
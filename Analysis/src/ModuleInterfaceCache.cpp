@@ -0,0 +1,1237 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#include "Luau/ModuleInterfaceCache.h"
+
+#include "Luau/Common.h"
+#include "Luau/Module.h"
+#include "Luau/Scope.h"
+#include "Luau/Type.h"
+#include "Luau/TypePack.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+LUAU_FASTFLAG(DebugLuauReadWriteProperties)
+
+namespace Luau
+{
+
+static const char kInterfaceMagic[] = "LUAUI";
+static const uint8_t kInterfaceVersion = 2;
+
+enum class InterfaceRecord : uint8_t
+{
+    // Types
+    BuiltinType,
+    GlobalType,
+    Primitive,
+    BooleanSingleton,
+    StringSingleton,
+    Function,
+    Table,
+    Metatable,
+    Generic,
+    Any,
+    Unknown,
+    Never,
+    Union,
+    Intersection,
+    Negation,
+    ErrorType,
+    Class,
+
+    // Type packs
+    BuiltinPack,
+    List,
+    Variadic,
+    GenericPack,
+    ErrorPack,
+};
+
+static std::vector<TypeId> getBuiltinTypeList(NotNull<BuiltinTypes> builtinTypes)
+{
+    return {builtinTypes->nilType, builtinTypes->numberType, builtinTypes->stringType, builtinTypes->booleanType, builtinTypes->threadType,
+        builtinTypes->bufferType, builtinTypes->functionType, builtinTypes->classType, builtinTypes->tableType, builtinTypes->emptyTableType,
+        builtinTypes->trueType, builtinTypes->falseType, builtinTypes->anyType, builtinTypes->unknownType, builtinTypes->neverType,
+        builtinTypes->errorType, builtinTypes->falsyType, builtinTypes->truthyType, builtinTypes->optionalNumberType,
+        builtinTypes->optionalStringType};
+}
+
+static std::vector<TypePackId> getBuiltinPackList(NotNull<BuiltinTypes> builtinTypes)
+{
+    return {builtinTypes->emptyTypePack, builtinTypes->anyTypePack, builtinTypes->neverTypePack, builtinTypes->uninhabitableTypePack,
+        builtinTypes->errorTypePack};
+}
+
+// Types of the global environment are shared by all modules, so they are referred to by their path in the global scope
+// Names in inner scopes shadow the names in outer scopes; the result is sorted to keep the serialized data stable between runs
+static std::vector<std::pair<std::string, TypeId>> getGlobalNames(const ScopePtr& globalScope)
+{
+    std::unordered_map<std::string, TypeId> names;
+
+    auto addValue = [&](const std::string& name, TypeId ty) {
+        ty = follow(ty);
+
+        if (!names.try_emplace(name, ty).second)
+            return;
+
+        if (const MetatableType* mtv = get<MetatableType>(ty))
+            ty = follow(mtv->table);
+
+        // library tables are traversed one level deep, so that the functions like 'math.floor' can be stored as well
+        if (const TableType* ttv = get<TableType>(ty))
+        {
+            for (const auto& [propName, prop] : ttv->props)
+            {
+                std::optional<TypeId> propTy = FFlag::DebugLuauReadWriteProperties ? prop.readType() : prop.type();
+
+                if (propTy)
+                    names.try_emplace(name + "." + propName, follow(*propTy));
+            }
+        }
+    };
+
+    for (const Scope* scope = globalScope.get(); scope; scope = scope->parent.get())
+    {
+        for (const auto& [name, tf] : scope->exportedTypeBindings)
+        {
+            if (tf.typeParams.empty() && tf.typePackParams.empty())
+                names.try_emplace("type " + name, follow(tf.type));
+        }
+
+        for (const auto& [symbol, binding] : scope->bindings)
+        {
+            if (symbol.global.value)
+                addValue(symbol.global.value, binding.typeId);
+        }
+    }
+
+    std::vector<std::pair<std::string, TypeId>> result(names.begin(), names.end());
+    std::sort(result.begin(), result.end(), [](auto& lhs, auto& rhs) {
+        return lhs.first < rhs.first;
+    });
+
+    return result;
+}
+
+struct InterfaceWriter
+{
+    void addKnownTypes(NotNull<BuiltinTypes> builtinTypes, const ScopePtr& globalScope)
+    {
+        std::vector<TypeId> builtinTypeList = getBuiltinTypeList(builtinTypes);
+        for (size_t i = 0; i < builtinTypeList.size(); ++i)
+            builtinTypeIndex.try_emplace(builtinTypeList[i], uint32_t(i));
+
+        std::vector<TypePackId> builtinPackList = getBuiltinPackList(builtinTypes);
+        for (size_t i = 0; i < builtinPackList.size(); ++i)
+            builtinPackIndex.try_emplace(builtinPackList[i], uint32_t(i));
+
+        for (const auto& [name, ty] : getGlobalNames(globalScope))
+            globalNames.try_emplace(ty, name);
+    }
+
+    void writeVarInt(uint64_t value)
+    {
+        do
+        {
+            uint8_t byte = value & 127;
+            value >>= 7;
+            data.push_back(char(value ? byte | 128 : byte));
+        } while (value);
+    }
+
+    void writeByte(uint8_t value)
+    {
+        data.push_back(char(value));
+    }
+
+    void writeBool(bool value)
+    {
+        writeByte(value ? 1 : 0);
+    }
+
+    void writeString(const std::string& value)
+    {
+        writeVarInt(value.size());
+        data.append(value);
+    }
+
+    void writeOptionalString(const std::optional<std::string>& value)
+    {
+        writeBool(value.has_value());
+
+        if (value)
+            writeString(*value);
+    }
+
+    void writeInt(int value)
+    {
+        // zigzag encoding keeps negative values short
+        writeVarInt((uint64_t(value) << 1) ^ uint64_t(int64_t(value) >> 63));
+    }
+
+    void writeLocation(const Location& location)
+    {
+        writeVarInt(location.begin.line);
+        writeVarInt(location.begin.column);
+        writeVarInt(location.end.line);
+        writeVarInt(location.end.column);
+    }
+
+    void writeOptionalLocation(const std::optional<Location>& location)
+    {
+        writeBool(location.has_value());
+
+        if (location)
+            writeLocation(*location);
+    }
+
+    void writeLevel(const TypeLevel& level)
+    {
+        writeInt(level.level);
+        writeInt(level.subLevel);
+    }
+
+    void writeTags(const Tags& tags)
+    {
+        writeVarInt(tags.size());
+
+        for (const std::string& tag : tags)
+            writeString(tag);
+    }
+
+    void writeType(TypeId ty)
+    {
+        ty = follow(ty);
+
+        auto [it, inserted] = typeIds.try_emplace(ty, uint32_t(typeIds.size()));
+
+        if (inserted)
+            queue.push_back({ty, nullptr});
+
+        writeVarInt(it->second);
+    }
+
+    void writeOptionalType(std::optional<TypeId> ty)
+    {
+        writeBool(ty.has_value());
+
+        if (ty)
+            writeType(*ty);
+    }
+
+    void writeTypes(const std::vector<TypeId>& types)
+    {
+        writeVarInt(types.size());
+
+        for (TypeId ty : types)
+            writeType(ty);
+    }
+
+    void writePack(TypePackId tp)
+    {
+        tp = follow(tp);
+
+        auto [it, inserted] = packIds.try_emplace(tp, uint32_t(packIds.size()));
+
+        if (inserted)
+            queue.push_back({nullptr, tp});
+
+        writeVarInt(it->second);
+    }
+
+    void writeOptionalPack(std::optional<TypePackId> tp)
+    {
+        writeBool(tp.has_value());
+
+        if (tp)
+            writePack(*tp);
+    }
+
+    void writePacks(const std::vector<TypePackId>& packs)
+    {
+        writeVarInt(packs.size());
+
+        for (TypePackId tp : packs)
+            writePack(tp);
+    }
+
+    void writeTypeFun(const TypeFun& tf)
+    {
+        writeVarInt(tf.typeParams.size());
+
+        for (const GenericTypeDefinition& param : tf.typeParams)
+        {
+            writeType(param.ty);
+            writeOptionalType(param.defaultValue);
+        }
+
+        writeVarInt(tf.typePackParams.size());
+
+        for (const GenericTypePackDefinition& param : tf.typePackParams)
+        {
+            writePack(param.tp);
+            writeOptionalPack(param.defaultValue);
+        }
+
+        writeType(tf.type);
+    }
+
+    void writeProperty(const Property& prop)
+    {
+        std::optional<TypeId> readTy = FFlag::DebugLuauReadWriteProperties ? prop.readType() : prop.type();
+        std::optional<TypeId> writeTy = FFlag::DebugLuauReadWriteProperties ? prop.writeType() : std::nullopt;
+
+        writeOptionalType(readTy);
+        writeOptionalType(writeTy);
+        writeBool(prop.deprecated);
+        writeString(prop.deprecatedSuggestion);
+        writeOptionalLocation(prop.location);
+        writeOptionalLocation(prop.typeLocation);
+        writeTags(prop.tags);
+        writeOptionalString(prop.documentationSymbol);
+    }
+
+    void writeRecord(InterfaceRecord record, uint32_t id)
+    {
+        writeByte(uint8_t(record));
+        writeVarInt(id);
+    }
+
+    void writeTypeRecord(TypeId ty)
+    {
+        uint32_t id = typeIds[ty];
+
+        if (auto it = builtinTypeIndex.find(ty); it != builtinTypeIndex.end())
+        {
+            writeRecord(InterfaceRecord::BuiltinType, id);
+            writeVarInt(it->second);
+            return;
+        }
+
+        if (auto it = globalNames.find(ty); it != globalNames.end())
+        {
+            writeRecord(InterfaceRecord::GlobalType, id);
+            writeString(it->second);
+            return;
+        }
+
+        // other persistent types are owned by the environment, but can't be found by name
+        if (ty->persistent)
+        {
+            failed = true;
+            return;
+        }
+
+        if (const PrimitiveType* ptv = get<PrimitiveType>(ty))
+        {
+            writeRecord(InterfaceRecord::Primitive, id);
+            writeByte(uint8_t(ptv->type));
+            writeOptionalType(ptv->metatable);
+        }
+        else if (const SingletonType* stv = get<SingletonType>(ty))
+        {
+            if (const BooleanSingleton* bs = get<BooleanSingleton>(stv))
+            {
+                writeRecord(InterfaceRecord::BooleanSingleton, id);
+                writeBool(bs->value);
+            }
+            else if (const StringSingleton* ss = get<StringSingleton>(stv))
+            {
+                writeRecord(InterfaceRecord::StringSingleton, id);
+                writeString(ss->value);
+            }
+            else
+            {
+                failed = true;
+                return;
+            }
+        }
+        else if (const FunctionType* ftv = get<FunctionType>(ty))
+        {
+            // functions with custom inference callbacks can only come from the environment
+            if (ftv->magicFunction || ftv->dcrMagicFunction || ftv->dcrMagicRefinement)
+            {
+                failed = true;
+                return;
+            }
+
+            writeRecord(InterfaceRecord::Function, id);
+            writeLevel(ftv->level);
+            writeTypes(ftv->generics);
+            writePacks(ftv->genericPacks);
+
+            writeVarInt(ftv->argNames.size());
+
+            for (const std::optional<FunctionArgument>& arg : ftv->argNames)
+            {
+                writeBool(arg.has_value());
+
+                if (arg)
+                {
+                    writeString(arg->name);
+                    writeLocation(arg->location);
+                }
+            }
+
+            writeTags(ftv->tags);
+            writePack(ftv->argTypes);
+            writePack(ftv->retTypes);
+            writeBool(ftv->hasSelf);
+            writeBool(ftv->hasNoFreeOrGenericTypes);
+            writeBool(ftv->isCheckedFunction);
+
+            writeBool(ftv->definition.has_value());
+
+            if (ftv->definition)
+            {
+                writeOptionalString(ftv->definition->definitionModuleName);
+                writeLocation(ftv->definition->definitionLocation);
+                writeOptionalLocation(ftv->definition->varargLocation);
+                writeLocation(ftv->definition->originalNameLocation);
+            }
+        }
+        else if (const TableType* ttv = get<TableType>(ty))
+        {
+            LUAU_ASSERT(!ttv->boundTo);
+
+            writeRecord(InterfaceRecord::Table, id);
+            writeVarInt(ttv->props.size());
+
+            for (const auto& [name, prop] : ttv->props)
+            {
+                writeString(name);
+                writeProperty(prop);
+            }
+
+            writeBool(ttv->indexer.has_value());
+
+            if (ttv->indexer)
+            {
+                writeType(ttv->indexer->indexType);
+                writeType(ttv->indexer->indexResultType);
+            }
+
+            writeByte(uint8_t(ttv->state));
+            writeLevel(ttv->level);
+            writeOptionalString(ttv->name);
+            writeOptionalString(ttv->syntheticName);
+            writeTypes(ttv->instantiatedTypeParams);
+            writePacks(ttv->instantiatedTypePackParams);
+            writeString(ttv->definitionModuleName);
+            writeLocation(ttv->definitionLocation);
+            writeTags(ttv->tags);
+        }
+        else if (const ClassType* ctv = get<ClassType>(ty))
+        {
+            // classes declared by a module keep their identity only when the whole definition module is stored
+            // host data attached to the class can't be restored
+            if (!copyClasses || ctv->userData)
+            {
+                failed = true;
+                return;
+            }
+
+            writeRecord(InterfaceRecord::Class, id);
+            writeString(ctv->name);
+            writeVarInt(ctv->props.size());
+
+            for (const auto& [name, prop] : ctv->props)
+            {
+                writeString(name);
+                writeProperty(prop);
+            }
+
+            writeOptionalType(ctv->parent);
+            writeOptionalType(ctv->metatable);
+            writeTags(ctv->tags);
+            writeString(ctv->definitionModuleName);
+
+            writeBool(ctv->indexer.has_value());
+
+            if (ctv->indexer)
+            {
+                writeType(ctv->indexer->indexType);
+                writeType(ctv->indexer->indexResultType);
+            }
+        }
+        else if (const MetatableType* mtv = get<MetatableType>(ty))
+        {
+            writeRecord(InterfaceRecord::Metatable, id);
+            writeType(mtv->table);
+            writeType(mtv->metatable);
+            writeOptionalString(mtv->syntheticName);
+        }
+        else if (const GenericType* gtv = get<GenericType>(ty))
+        {
+            writeRecord(InterfaceRecord::Generic, id);
+            writeLevel(gtv->level);
+            writeString(gtv->name);
+            writeBool(gtv->explicitName);
+        }
+        else if (get<AnyType>(ty))
+        {
+            writeRecord(InterfaceRecord::Any, id);
+        }
+        else if (get<UnknownType>(ty))
+        {
+            writeRecord(InterfaceRecord::Unknown, id);
+        }
+        else if (get<NeverType>(ty))
+        {
+            writeRecord(InterfaceRecord::Never, id);
+        }
+        else if (const UnionType* utv = get<UnionType>(ty))
+        {
+            writeRecord(InterfaceRecord::Union, id);
+            writeTypes(utv->options);
+        }
+        else if (const IntersectionType* itv = get<IntersectionType>(ty))
+        {
+            writeRecord(InterfaceRecord::Intersection, id);
+            writeTypes(itv->parts);
+        }
+        else if (const NegationType* ntv = get<NegationType>(ty))
+        {
+            writeRecord(InterfaceRecord::Negation, id);
+            writeType(ntv->ty);
+        }
+        else if (get<ErrorType>(ty))
+        {
+            writeRecord(InterfaceRecord::ErrorType, id);
+        }
+        else
+        {
+            // free and blocked types, classes that aren't known to the environment and type family instances are not supported
+            failed = true;
+            return;
+        }
+
+        writeOptionalString(ty->documentationSymbol);
+    }
+
+    void writePackRecord(TypePackId tp)
+    {
+        uint32_t id = packIds[tp];
+
+        if (auto it = builtinPackIndex.find(tp); it != builtinPackIndex.end())
+        {
+            writeRecord(InterfaceRecord::BuiltinPack, id);
+            writeVarInt(it->second);
+        }
+        else if (tp->persistent)
+        {
+            failed = true;
+        }
+        else if (const TypePack* pack = get<TypePack>(tp))
+        {
+            writeRecord(InterfaceRecord::List, id);
+            writeTypes(pack->head);
+            writeOptionalPack(pack->tail);
+        }
+        else if (const VariadicTypePack* vtp = get<VariadicTypePack>(tp))
+        {
+            writeRecord(InterfaceRecord::Variadic, id);
+            writeType(vtp->ty);
+            writeBool(vtp->hidden);
+        }
+        else if (const GenericTypePack* gtp = get<GenericTypePack>(tp))
+        {
+            writeRecord(InterfaceRecord::GenericPack, id);
+            writeLevel(gtp->level);
+            writeString(gtp->name);
+            writeBool(gtp->explicitName);
+        }
+        else if (get<ErrorTypePack>(tp))
+        {
+            writeRecord(InterfaceRecord::ErrorPack, id);
+        }
+        else
+        {
+            failed = true;
+        }
+    }
+
+    void writeQueuedRecords()
+    {
+        // records can reference types that haven't been written yet, the queue grows while the records are written
+        for (size_t i = 0; i < queue.size() && !failed; ++i)
+        {
+            if (queue[i].first)
+                writeTypeRecord(queue[i].first);
+            else
+                writePackRecord(queue[i].second);
+        }
+    }
+
+    std::unordered_map<TypeId, uint32_t> builtinTypeIndex;
+    std::unordered_map<TypePackId, uint32_t> builtinPackIndex;
+    std::unordered_map<TypeId, std::string> globalNames;
+
+    std::unordered_map<TypeId, uint32_t> typeIds;
+    std::unordered_map<TypePackId, uint32_t> packIds;
+    std::vector<std::pair<TypeId, TypePackId>> queue;
+
+    std::string data;
+    bool copyClasses = false;
+    bool failed = false;
+};
+
+static std::string serializeInterface(const Module& module, NotNull<BuiltinTypes> builtinTypes, const ScopePtr& globalScope, bool copyClasses)
+{
+    LUAU_ASSERT(module.returnType);
+
+    InterfaceWriter writer;
+    writer.copyClasses = copyClasses;
+    writer.addKnownTypes(builtinTypes, globalScope);
+
+    writer.writePack(module.returnType);
+
+    std::vector<const std::pair<const Name, TypeFun>*> typeBindings;
+    for (const auto& binding : module.exportedTypeBindings)
+        typeBindings.push_back(&binding);
+
+    std::sort(typeBindings.begin(), typeBindings.end(), [](auto lhs, auto rhs) {
+        return lhs->first < rhs->first;
+    });
+
+    writer.writeVarInt(typeBindings.size());
+
+    for (auto binding : typeBindings)
+    {
+        writer.writeString(binding->first);
+        writer.writeTypeFun(binding->second);
+    }
+
+    std::vector<const std::pair<const Name, TypeId>*> globals;
+    for (const auto& global : module.declaredGlobals)
+        globals.push_back(&global);
+
+    std::sort(globals.begin(), globals.end(), [](auto lhs, auto rhs) {
+        return lhs->first < rhs->first;
+    });
+
+    writer.writeVarInt(globals.size());
+
+    for (auto global : globals)
+    {
+        writer.writeString(global->first);
+        writer.writeType(global->second);
+    }
+
+    writer.writeQueuedRecords();
+
+    if (writer.failed)
+        return {};
+
+    // placeholders for all types are allocated before anything else is read, so the header has the type counts
+    InterfaceWriter header;
+
+    header.data.append(kInterfaceMagic, sizeof(kInterfaceMagic) - 1);
+    header.writeByte(kInterfaceVersion);
+    header.writeVarInt(writer.typeIds.size());
+    header.writeVarInt(writer.packIds.size());
+
+    return header.data + writer.data;
+}
+
+std::string serializeModuleInterface(const Module& module, NotNull<BuiltinTypes> builtinTypes, const ScopePtr& globalScope)
+{
+    return serializeInterface(module, builtinTypes, globalScope, /* copyClasses */ false);
+}
+
+std::string serializeDefinitionModule(const Module& module, NotNull<BuiltinTypes> builtinTypes, const ScopePtr& globalScope)
+{
+    return serializeInterface(module, builtinTypes, globalScope, /* copyClasses */ true);
+}
+
+struct InterfaceReader
+{
+    InterfaceReader(std::string_view data, NotNull<BuiltinTypes> builtinTypes, const ScopePtr& globalScope)
+        : data(data)
+        , builtinTypeList(getBuiltinTypeList(builtinTypes))
+        , builtinPackList(getBuiltinPackList(builtinTypes))
+    {
+        for (auto& [name, ty] : getGlobalNames(globalScope))
+            globalNames.try_emplace(name, ty);
+    }
+
+    uint64_t readVarInt()
+    {
+        uint64_t result = 0;
+
+        for (unsigned shift = 0; shift < 64; shift += 7)
+        {
+            if (offset >= data.size())
+                break;
+
+            uint8_t byte = uint8_t(data[offset++]);
+            result |= uint64_t(byte & 127) << shift;
+
+            if ((byte & 128) == 0)
+                return result;
+        }
+
+        failed = true;
+        return 0;
+    }
+
+    uint8_t readByte()
+    {
+        if (offset >= data.size())
+        {
+            failed = true;
+            return 0;
+        }
+
+        return uint8_t(data[offset++]);
+    }
+
+    bool readBool()
+    {
+        return readByte() != 0;
+    }
+
+    std::string readString()
+    {
+        uint64_t size = readVarInt();
+
+        if (size > data.size() - offset)
+        {
+            failed = true;
+            return {};
+        }
+
+        std::string result{data.substr(offset, size)};
+        offset += size;
+        return result;
+    }
+
+    std::optional<std::string> readOptionalString()
+    {
+        if (!readBool())
+            return std::nullopt;
+
+        return readString();
+    }
+
+    int readInt()
+    {
+        uint64_t value = readVarInt();
+        return int(int64_t(value >> 1) ^ -int64_t(value & 1));
+    }
+
+    Location readLocation()
+    {
+        Location location;
+        location.begin.line = unsigned(readVarInt());
+        location.begin.column = unsigned(readVarInt());
+        location.end.line = unsigned(readVarInt());
+        location.end.column = unsigned(readVarInt());
+        return location;
+    }
+
+    std::optional<Location> readOptionalLocation()
+    {
+        if (!readBool())
+            return std::nullopt;
+
+        return readLocation();
+    }
+
+    TypeLevel readLevel()
+    {
+        TypeLevel level;
+        level.level = readInt();
+        level.subLevel = readInt();
+        return level;
+    }
+
+    Tags readTags()
+    {
+        Tags tags;
+
+        for (uint64_t i = 0, count = readVarInt(); i < count && !failed; ++i)
+            tags.push_back(readString());
+
+        return tags;
+    }
+
+    TypeId readType()
+    {
+        uint64_t id = readVarInt();
+
+        if (id >= types.size())
+        {
+            failed = true;
+            return nullptr;
+        }
+
+        return types[id];
+    }
+
+    std::optional<TypeId> readOptionalType()
+    {
+        if (!readBool())
+            return std::nullopt;
+
+        return readType();
+    }
+
+    std::vector<TypeId> readTypes()
+    {
+        std::vector<TypeId> result;
+
+        for (uint64_t i = 0, count = readVarInt(); i < count && !failed; ++i)
+            result.push_back(readType());
+
+        return result;
+    }
+
+    TypePackId readPack()
+    {
+        uint64_t id = readVarInt();
+
+        if (id >= packs.size())
+        {
+            failed = true;
+            return nullptr;
+        }
+
+        return packs[id];
+    }
+
+    std::optional<TypePackId> readOptionalPack()
+    {
+        if (!readBool())
+            return std::nullopt;
+
+        return readPack();
+    }
+
+    std::vector<TypePackId> readPacks()
+    {
+        std::vector<TypePackId> result;
+
+        for (uint64_t i = 0, count = readVarInt(); i < count && !failed; ++i)
+            result.push_back(readPack());
+
+        return result;
+    }
+
+    TypeFun readTypeFun()
+    {
+        TypeFun tf;
+
+        for (uint64_t i = 0, count = readVarInt(); i < count && !failed; ++i)
+        {
+            TypeId ty = readType();
+            std::optional<TypeId> defaultValue = readOptionalType();
+            tf.typeParams.push_back(GenericTypeDefinition{ty, defaultValue});
+        }
+
+        for (uint64_t i = 0, count = readVarInt(); i < count && !failed; ++i)
+        {
+            TypePackId tp = readPack();
+            std::optional<TypePackId> defaultValue = readOptionalPack();
+            tf.typePackParams.push_back(GenericTypePackDefinition{tp, defaultValue});
+        }
+
+        tf.type = readType();
+        return tf;
+    }
+
+    Property readProperty()
+    {
+        std::optional<TypeId> readTy = readOptionalType();
+        std::optional<TypeId> writeTy = readOptionalType();
+
+        Property prop;
+
+        if (FFlag::DebugLuauReadWriteProperties)
+        {
+            if (!readTy && !writeTy)
+                failed = true;
+            else
+                prop = Property::create(readTy, writeTy);
+        }
+        else if (readTy && !writeTy)
+        {
+            prop.setType(*readTy);
+        }
+        else
+        {
+            // interface was written with a different property model
+            failed = true;
+        }
+
+        prop.deprecated = readBool();
+        prop.deprecatedSuggestion = readString();
+        prop.location = readOptionalLocation();
+        prop.typeLocation = readOptionalLocation();
+        prop.tags = readTags();
+        prop.documentationSymbol = readOptionalString();
+        return prop;
+    }
+
+    void readTypeRecord(InterfaceRecord record, Type& ty)
+    {
+        switch (record)
+        {
+        case InterfaceRecord::BuiltinType:
+        {
+            uint64_t index = readVarInt();
+
+            if (index < builtinTypeList.size())
+                ty.ty.emplace<BoundType>(builtinTypeList[index]);
+            else
+                failed = true;
+            return;
+        }
+        case InterfaceRecord::GlobalType:
+        {
+            auto it = globalNames.find(readString());
+
+            if (it != globalNames.end())
+                ty.ty.emplace<BoundType>(it->second);
+            else
+                failed = true;
+            return;
+        }
+        case InterfaceRecord::Primitive:
+        {
+            PrimitiveType::Type type = PrimitiveType::Type(readByte());
+            std::optional<TypeId> metatable = readOptionalType();
+
+            if (type > PrimitiveType::Buffer)
+                failed = true;
+            else if (metatable)
+                ty.ty.emplace<PrimitiveType>(type, *metatable);
+            else
+                ty.ty.emplace<PrimitiveType>(type);
+            break;
+        }
+        case InterfaceRecord::BooleanSingleton:
+            ty.ty.emplace<SingletonType>(BooleanSingleton{readBool()});
+            break;
+        case InterfaceRecord::StringSingleton:
+            ty.ty.emplace<SingletonType>(StringSingleton{readString()});
+            break;
+        case InterfaceRecord::Function:
+        {
+            TypeLevel level = readLevel();
+            std::vector<TypeId> generics = readTypes();
+            std::vector<TypePackId> genericPacks = readPacks();
+
+            std::vector<std::optional<FunctionArgument>> argNames;
+
+            for (uint64_t i = 0, count = readVarInt(); i < count && !failed; ++i)
+            {
+                if (readBool())
+                {
+                    std::string name = readString();
+                    argNames.push_back(FunctionArgument{name, readLocation()});
+                }
+                else
+                {
+                    argNames.push_back(std::nullopt);
+                }
+            }
+
+            Tags tags = readTags();
+            TypePackId argTypes = readPack();
+            TypePackId retTypes = readPack();
+
+            FunctionType& ftv = ty.ty.emplace<FunctionType>(level, std::move(generics), std::move(genericPacks), argTypes, retTypes);
+            ftv.argNames = std::move(argNames);
+            ftv.tags = std::move(tags);
+            ftv.hasSelf = readBool();
+            ftv.hasNoFreeOrGenericTypes = readBool();
+            ftv.isCheckedFunction = readBool();
+
+            if (readBool())
+            {
+                FunctionDefinition definition;
+                definition.definitionModuleName = readOptionalString();
+                definition.definitionLocation = readLocation();
+                definition.varargLocation = readOptionalLocation();
+                definition.originalNameLocation = readLocation();
+                ftv.definition = definition;
+            }
+            break;
+        }
+        case InterfaceRecord::Table:
+        {
+            TableType ttv;
+
+            for (uint64_t i = 0, count = readVarInt(); i < count && !failed; ++i)
+            {
+                std::string name = readString();
+                ttv.props[name] = readProperty();
+            }
+
+            if (readBool())
+            {
+                TypeId indexType = readType();
+                TypeId indexResultType = readType();
+                ttv.indexer = TableIndexer{indexType, indexResultType};
+            }
+
+            uint8_t state = readByte();
+
+            if (state > uint8_t(TableState::Generic))
+                failed = true;
+
+            ttv.state = TableState(state);
+            ttv.level = readLevel();
+            ttv.name = readOptionalString();
+            ttv.syntheticName = readOptionalString();
+            ttv.instantiatedTypeParams = readTypes();
+            ttv.instantiatedTypePackParams = readPacks();
+            ttv.definitionModuleName = readString();
+            ttv.definitionLocation = readLocation();
+            ttv.tags = readTags();
+
+            ty.ty.emplace<TableType>(std::move(ttv));
+            break;
+        }
+        case InterfaceRecord::Class:
+        {
+            Name name = readString();
+            ClassType::Props props;
+
+            for (uint64_t i = 0, count = readVarInt(); i < count && !failed; ++i)
+            {
+                std::string propName = readString();
+                props[propName] = readProperty();
+            }
+
+            std::optional<TypeId> parent = readOptionalType();
+            std::optional<TypeId> metatable = readOptionalType();
+            Tags tags = readTags();
+            ModuleName definitionModuleName = readString();
+
+            std::optional<TableIndexer> indexer;
+
+            if (readBool())
+            {
+                TypeId indexType = readType();
+                TypeId indexResultType = readType();
+                indexer = TableIndexer{indexType, indexResultType};
+            }
+
+            ty.ty.emplace<ClassType>(
+                std::move(name), std::move(props), parent, metatable, std::move(tags), nullptr, std::move(definitionModuleName), indexer);
+            break;
+        }
+        case InterfaceRecord::Metatable:
+        {
+            TypeId table = readType();
+            TypeId metatable = readType();
+            ty.ty.emplace<MetatableType>(MetatableType{table, metatable, readOptionalString()});
+            break;
+        }
+        case InterfaceRecord::Generic:
+        {
+            TypeLevel level = readLevel();
+            GenericType& gtv = ty.ty.emplace<GenericType>(level, readString());
+            gtv.explicitName = readBool();
+            break;
+        }
+        case InterfaceRecord::Any:
+            ty.ty.emplace<AnyType>();
+            break;
+        case InterfaceRecord::Unknown:
+            ty.ty.emplace<UnknownType>();
+            break;
+        case InterfaceRecord::Never:
+            ty.ty.emplace<NeverType>();
+            break;
+        case InterfaceRecord::Union:
+            ty.ty.emplace<UnionType>(UnionType{readTypes()});
+            break;
+        case InterfaceRecord::Intersection:
+            ty.ty.emplace<IntersectionType>(IntersectionType{readTypes()});
+            break;
+        case InterfaceRecord::Negation:
+            ty.ty.emplace<NegationType>(NegationType{readType()});
+            break;
+        case InterfaceRecord::ErrorType:
+            ty.ty.emplace<ErrorType>();
+            break;
+        default:
+            failed = true;
+            return;
+        }
+
+        ty.documentationSymbol = readOptionalString();
+    }
+
+    void readPackRecord(InterfaceRecord record, TypePackVar& tp)
+    {
+        switch (record)
+        {
+        case InterfaceRecord::BuiltinPack:
+        {
+            uint64_t index = readVarInt();
+
+            if (index < builtinPackList.size())
+                tp.ty.emplace<BoundTypePack>(builtinPackList[index]);
+            else
+                failed = true;
+            break;
+        }
+        case InterfaceRecord::List:
+        {
+            std::vector<TypeId> head = readTypes();
+            tp.ty.emplace<TypePack>(TypePack{std::move(head), readOptionalPack()});
+            break;
+        }
+        case InterfaceRecord::Variadic:
+        {
+            TypeId ty = readType();
+            tp.ty.emplace<VariadicTypePack>(VariadicTypePack{ty, readBool()});
+            break;
+        }
+        case InterfaceRecord::GenericPack:
+        {
+            TypeLevel level = readLevel();
+            GenericTypePack& gtp = tp.ty.emplace<GenericTypePack>(level, readString());
+            gtp.explicitName = readBool();
+            break;
+        }
+        case InterfaceRecord::ErrorPack:
+            tp.ty.emplace<ErrorTypePack>();
+            break;
+        default:
+            failed = true;
+            break;
+        }
+    }
+
+    std::string_view data;
+    size_t offset = 0;
+
+    std::vector<TypeId> builtinTypeList;
+    std::vector<TypePackId> builtinPackList;
+    std::unordered_map<std::string, TypeId> globalNames;
+
+    std::vector<TypeId> types;
+    std::vector<TypePackId> packs;
+
+    bool failed = false;
+};
+
+bool deserializeModuleInterface(Module& module, std::string_view data, NotNull<BuiltinTypes> builtinTypes, const ScopePtr& globalScope)
+{
+    const size_t magicSize = sizeof(kInterfaceMagic) - 1;
+
+    if (data.size() < magicSize + 1 || data.substr(0, magicSize) != kInterfaceMagic || uint8_t(data[magicSize]) != kInterfaceVersion)
+        return false;
+
+    InterfaceReader reader{data.substr(magicSize + 1), builtinTypes, globalScope};
+
+    uint64_t typeCount = reader.readVarInt();
+    uint64_t packCount = reader.readVarInt();
+
+    // every record takes at least 2 bytes, which bounds the amount of placeholders created for malformed data
+    if (reader.failed || typeCount > data.size() / 2 || packCount > data.size() / 2)
+        return false;
+
+    for (uint64_t i = 0; i < typeCount; ++i)
+        reader.types.push_back(module.interfaceTypes.addType(AnyType{}));
+
+    for (uint64_t i = 0; i < packCount; ++i)
+        reader.packs.push_back(module.interfaceTypes.addTypePack(TypePackVar{ErrorTypePack{}}));
+
+    TypePackId returnType = reader.readPack();
+
+    std::unordered_map<Name, TypeFun> exportedTypeBindings;
+
+    for (uint64_t i = 0, count = reader.readVarInt(); i < count && !reader.failed; ++i)
+    {
+        std::string name = reader.readString();
+        exportedTypeBindings[name] = reader.readTypeFun();
+    }
+
+    std::unordered_map<Name, TypeId> declaredGlobals;
+
+    for (uint64_t i = 0, count = reader.readVarInt(); i < count && !reader.failed; ++i)
+    {
+        std::string name = reader.readString();
+        declaredGlobals[name] = reader.readType();
+    }
+
+    std::vector<bool> typeDone(typeCount);
+    std::vector<bool> packDone(packCount);
+    size_t remaining = typeCount + packCount;
+
+    while (remaining != 0 && !reader.failed)
+    {
+        InterfaceRecord record = InterfaceRecord(reader.readByte());
+        uint64_t id = reader.readVarInt();
+
+        if (record < InterfaceRecord::BuiltinPack)
+        {
+            if (id >= typeCount || typeDone[id])
+                return false;
+
+            typeDone[id] = true;
+            reader.readTypeRecord(record, *asMutable(reader.types[id]));
+        }
+        else
+        {
+            if (id >= packCount || packDone[id])
+                return false;
+
+            packDone[id] = true;
+            reader.readPackRecord(record, *asMutable(reader.packs[id]));
+        }
+
+        remaining--;
+    }
+
+    if (reader.failed || reader.offset != reader.data.size())
+        return false;
+
+    module.returnType = returnType;
+    module.exportedTypeBindings = std::move(exportedTypeBindings);
+    module.declaredGlobals = std::move(declaredGlobals);
+    return true;
+}
+
+LayeredModuleInterfaceCache::LayeredModuleInterfaceCache(ModuleInterfaceCache* local, ModuleInterfaceCache* shared, bool writeShared)
+    : local(local)
+    , shared(shared)
+    , writeShared(writeShared)
+{
+}
+
+std::optional<std::string> LayeredModuleInterfaceCache::readInterface(const std::string& key)
+{
+    if (local)
+    {
+        if (std::optional<std::string> data = local->readInterface(key))
+            return data;
+    }
+
+    if (!shared)
+        return std::nullopt;
+
+    std::optional<std::string> data = shared->readInterface(key);
+
+    if (data && local)
+        local->writeInterface(key, *data);
+
+    return data;
+}
+
+void LayeredModuleInterfaceCache::writeInterface(const std::string& key, const std::string& data)
+{
+    if (local)
+        local->writeInterface(key, data);
+
+    if (shared && writeShared)
+        shared->writeInterface(key, data);
+}
+
+} // namespace Luau
@@ -781,6 +781,70 @@ static void assertInvariant(const NormalizedType& norm)
 #endif
 }
 
+const NormalizedType* SharedNormalizerCache::find(TypeId ty) const
+{
+    std::unique_lock guard(mutex);
+
+    auto found = cachedNormals.find(ty);
+    return found != cachedNormals.end() ? found->second.get() : nullptr;
+}
+
+const NormalizedType* SharedNormalizerCache::insert(TypeId ty, std::unique_ptr<NormalizedType> norm)
+{
+    std::unique_lock guard(mutex);
+
+    auto [it, inserted] = cachedNormals.try_emplace(ty, std::move(norm));
+    return it->second.get();
+}
+
+void SharedNormalizerCache::clear()
+{
+    std::unique_lock guard(mutex);
+
+    cachedNormals.clear();
+}
+
+static bool isPersistent(const TypeIds& tys)
+{
+    for (TypeId ty : tys)
+    {
+        if (!ty->persistent)
+            return false;
+    }
+
+    return true;
+}
+
+static bool isPersistent(const NormalizedType& norm)
+{
+    if (!norm.tops->persistent || !norm.booleans->persistent || !norm.errors->persistent || !norm.nils->persistent || !norm.numbers->persistent ||
+        !norm.threads->persistent || !norm.buffers->persistent)
+        return false;
+
+    for (const auto& [ty, negations] : norm.classes.classes)
+    {
+        if (!ty->persistent || !isPersistent(negations))
+            return false;
+    }
+
+    for (const auto& [_, ty] : norm.strings.singletons)
+    {
+        if (!ty->persistent)
+            return false;
+    }
+
+    if (!isPersistent(norm.tables) || !isPersistent(norm.functions.parts))
+        return false;
+
+    for (const auto& [tyvar, intersect] : norm.tyvars)
+    {
+        if (!tyvar->persistent || !isPersistent(*intersect))
+            return false;
+    }
+
+    return true;
+}
+
 Normalizer::Normalizer(TypeArena* arena, NotNull<BuiltinTypes> builtinTypes, NotNull<UnifierSharedState> sharedState, bool cacheInhabitance)
     : arena(arena)
     , builtinTypes(builtinTypes)
@@ -798,6 +862,13 @@ const NormalizedType* Normalizer::normalize(TypeId ty)
     if (found != cachedNormals.end())
         return found->second.get();
 
+    // Types from the global scope are normalized by most modules, so their normal forms are shared
+    if (ty->persistent)
+    {
+        if (const NormalizedType* shared = builtinTypes->normalizerCache->find(ty))
+            return shared;
+    }
+
     NormalizedType norm{builtinTypes};
     Set<TypeId> seenSetTypes{nullptr};
     if (!unionNormalWithTy(norm, ty, seenSetTypes))
@@ -808,6 +879,10 @@ const NormalizedType* Normalizer::normalize(TypeId ty)
         norm.tops = builtinTypes->unknownType;
     }
     std::unique_ptr<NormalizedType> uniq = std::make_unique<NormalizedType>(std::move(norm));
+
+    if (ty->persistent && isPersistent(*uniq))
+        return builtinTypes->normalizerCache->insert(ty, std::move(uniq));
+
     const NormalizedType* result = uniq.get();
     cachedNormals[ty] = std::move(uniq);
     return result;
@@ -902,7 +977,7 @@ TypeId Normalizer::unionType(TypeId here, TypeId there)
 
     std::vector<TypeId> parts;
     parts.insert(parts.end(), tmps.begin(), tmps.end());
-    TypeId result = arena->addType(UnionType{std::move(parts)});
+    TypeId result = arena->addInternedType(UnionType{std::move(parts)});
     cachedUnions[cacheTypeIds(std::move(tmps))] = result;
 
     return result;
@@ -951,7 +1026,7 @@ TypeId Normalizer::intersectionType(TypeId here, TypeId there)
 
     std::vector<TypeId> parts;
     parts.insert(parts.end(), tmps.begin(), tmps.end());
-    TypeId result = arena->addType(IntersectionType{std::move(parts)});
+    TypeId result = arena->addInternedType(IntersectionType{std::move(parts)});
     cachedIntersections[cacheTypeIds(std::move(tmps))] = result;
 
     return result;
@@ -3027,7 +3102,7 @@ TypeId Normalizer::typeFromNormal(const NormalizedType& norm)
     else if (result.size() == 1)
         return result[0];
     else
-        return arena->addType(UnionType{std::move(result)});
+        return arena->addInternedType(UnionType{std::move(result)});
 }
 
 bool isSubtype(TypeId subTy, TypeId superTy, NotNull<Scope> scope, NotNull<BuiltinTypes> builtinTypes, InternalErrorReporter& ice)
@@ -128,8 +128,8 @@ std::optional<TypeFun> Scope::lookupImportedType(const Name& moduleAlias, const
             continue;
         }
 
-        auto it2 = it->second.find(name);
-        if (it2 == it->second.end())
+        auto it2 = it->second->find(name);
+        if (it2 == it->second->end())
         {
             scope = scope->parent.get();
             continue;
@@ -0,0 +1,37 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#include "Luau/SolverProfile.h"
+
+#include <algorithm>
+
+namespace Luau
+{
+
+bool SolverProfile::empty() const
+{
+    return constraintKinds.empty() && timeTypeCheck == 0.0;
+}
+
+void SolverProfile::merge(const SolverProfile& other)
+{
+    for (const auto& [kind, entry] : other.constraintKinds)
+    {
+        SolverProfileEntry& target = constraintKinds[kind];
+        target.time += entry.time;
+        target.attempts += entry.attempts;
+        target.dispatched += entry.dispatched;
+    }
+
+    hotConstraints.insert(hotConstraints.end(), other.hotConstraints.begin(), other.hotConstraints.end());
+
+    std::stable_sort(hotConstraints.begin(), hotConstraints.end(), [](const HotConstraint& lhs, const HotConstraint& rhs) {
+        return lhs.entry.time > rhs.entry.time;
+    });
+
+    if (hotConstraints.size() > kHotConstraintLimit)
+        hotConstraints.resize(kHotConstraintLimit);
+
+    timeSolve += other.timeSolve;
+    timeTypeCheck += other.timeTypeCheck;
+}
+
+} // namespace Luau
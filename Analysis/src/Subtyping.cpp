@@ -126,6 +126,7 @@ SubtypingResult& SubtypingResult::andAlso(const SubtypingResult& other)
     isSubtype &= other.isSubtype;
     normalizationTooComplex |= other.normalizationTooComplex;
     isCacheable &= other.isCacheable;
+    isScopeDependent |= other.isScopeDependent;
     errors.insert(errors.end(), other.errors.begin(), other.errors.end());
 
     return *this;
@@ -148,6 +149,7 @@ SubtypingResult& SubtypingResult::orElse(const SubtypingResult& other)
     isSubtype |= other.isSubtype;
     normalizationTooComplex |= other.normalizationTooComplex;
     isCacheable &= other.isCacheable;
+    isScopeDependent |= other.isScopeDependent;
     errors.insert(errors.end(), other.errors.begin(), other.errors.end());
 
     return *this;
@@ -223,10 +225,14 @@ SubtypingResult& SubtypingResult::withErrors(ErrorVec& err)
 
 SubtypingResult SubtypingResult::negate(const SubtypingResult& result)
 {
-    return SubtypingResult{
+    SubtypingResult negated{
         !result.isSubtype,
         result.normalizationTooComplex,
     };
+
+    negated.isCacheable = result.isCacheable;
+    negated.isScopeDependent = result.isScopeDependent;
+    return negated;
 }
 
 SubtypingResult SubtypingResult::all(const std::vector<SubtypingResult>& results)
@@ -309,8 +315,13 @@ SubtypingResult Subtyping::isSubtype(TypeId subTy, TypeId superTy)
      */
 
     if (result.isCacheable)
+    {
         resultCache[{subTy, superTy}] = result;
 
+        if (sharedCache && !result.isScopeDependent)
+            (*sharedCache)[{subTy, superTy}] = result;
+    }
+
     return result;
 }
 
@@ -324,7 +335,12 @@ SubtypingResult Subtyping::cache(SubtypingEnvironment& env, SubtypingResult resu
 {
     const std::pair<TypeId, TypeId> p{subTy, superTy};
     if (result.isCacheable)
+    {
         resultCache[p] = result;
+
+        if (sharedCache && !result.isScopeDependent)
+            (*sharedCache)[p] = result;
+    }
     else
         env.ephemeralCache[p] = result;
 
@@ -360,6 +376,13 @@ SubtypingResult Subtyping::isCovariantWith(SubtypingEnvironment& env, TypeId sub
     if (cachedResult)
         return *cachedResult;
 
+    if (sharedCache)
+    {
+        cachedResult = sharedCache->find({subTy, superTy});
+        if (cachedResult)
+            return *cachedResult;
+    }
+
     cachedResult = env.ephemeralCache.find({subTy, superTy});
     if (cachedResult)
         return *cachedResult;
@@ -403,9 +426,17 @@ SubtypingResult Subtyping::isCovariantWith(SubtypingEnvironment& env, TypeId sub
     // tested as though it were its upper bounds.  We do not yet support bounded
     // generics, so the upper bound is always unknown.
     if (auto subGeneric = get<GenericType>(subTy); subGeneric && subsumes(subGeneric->scope, scope))
-        return isCovariantWith(env, builtinTypes->unknownType, superTy);
+    {
+        SubtypingResult result = isCovariantWith(env, builtinTypes->unknownType, superTy);
+        result.isScopeDependent = true;
+        return result;
+    }
     if (auto superGeneric = get<GenericType>(superTy); superGeneric && subsumes(superGeneric->scope, scope))
-        return isCovariantWith(env, subTy, builtinTypes->unknownType);
+    {
+        SubtypingResult result = isCovariantWith(env, subTy, builtinTypes->unknownType);
+        result.isScopeDependent = true;
+        return result;
+    }
 
     SubtypingResult result;
 
@@ -493,9 +524,16 @@ SubtypingResult Subtyping::isCovariantWith(SubtypingEnvironment& env, TypeId sub
         }
     }
     else if (auto subTypeFamilyInstance = get<TypeFamilyInstanceType>(subTy))
+    {
+        // type families are reduced in the scope of the test
         result = isCovariantWith(env, subTypeFamilyInstance, superTy);
+        result.isScopeDependent = true;
+    }
     else if (auto superTypeFamilyInstance = get<TypeFamilyInstanceType>(superTy))
+    {
         result = isCovariantWith(env, subTy, superTypeFamilyInstance);
+        result.isScopeDependent = true;
+    }
     else if (auto subGeneric = get<GenericType>(subTy); subGeneric && variance == Variance::Covariant)
     {
         bool ok = bindGeneric(env, subTy, superTy);
@@ -531,6 +569,10 @@ SubtypingResult Subtyping::isCovariantWith(SubtypingEnvironment& env, TypeId sub
     else if (auto p = get2<SingletonType, TableType>(subTy, superTy))
         result = isCovariantWith(env, p);
 
+    // generics that are not bound in the scope of the test are only subtypes of themselves
+    if (get<GenericType>(subTy) || get<GenericType>(superTy))
+        result.isScopeDependent = true;
+
     assertReasoningValid(subTy, superTy, result, builtinTypes);
 
     return cache(env, result, subTy, superTy);
@@ -161,7 +161,7 @@ static std::pair<bool, std::optional<Luau::Name>> canUseTypeNameInScope(ScopePtr
     {
         for (const auto& [importName, nameTable] : curr->importedTypeBindings)
         {
-            if (nameTable.count(name))
+            if (nameTable->count(name))
                 return {true, importName};
         }
 
@@ -260,9 +260,16 @@ struct StringifierState
         return generateName(s);
     }
 
+    // Once the result is over the length limit every further emit is discarded, so
+    // stringifiers can stop walking the type as soon as this becomes true.
+    bool isTruncated() const
+    {
+        return opts.maxTypeLength > 0 && result.name.length() > opts.maxTypeLength;
+    }
+
     void emit(const std::string& s)
     {
-        if (opts.maxTypeLength > 0 && result.name.length() > opts.maxTypeLength)
+        if (isTruncated())
             return;
 
         result.name += s;
@@ -295,7 +302,7 @@ struct StringifierState
 
     void emit(const char* s)
     {
-        if (opts.maxTypeLength > 0 && result.name.length() > opts.maxTypeLength)
+        if (isTruncated())
             return;
 
         result.name += s;
@@ -351,7 +358,7 @@ struct TypeStringifier
 
     void stringify(TypeId tv)
     {
-        if (state.opts.maxTypeLength > 0 && state.result.name.length() > state.opts.maxTypeLength)
+        if (state.isTruncated())
             return;
 
         if (tv->ty.valueless_by_exception())
@@ -804,6 +811,9 @@ struct TypeStringifier
         size_t oldLength = state.result.name.length();
         for (const auto& [name, prop] : ttv.props)
         {
+            if (state.isTruncated())
+                break;
+
             if (comma)
             {
                 state.emit(",");
@@ -1099,7 +1109,7 @@ struct TypePackStringifier
 
     void stringify(TypePackId tp)
     {
-        if (state.opts.maxTypeLength > 0 && state.result.name.length() > state.opts.maxTypeLength)
+        if (state.isTruncated())
             return;
 
         if (tp->ty.valueless_by_exception())
@@ -1135,6 +1145,9 @@ struct TypePackStringifier
 
         for (const auto& typeId : tp.head)
         {
+            if (state.isTruncated())
+                break;
+
             if (first)
                 first = false;
             else
@@ -1525,6 +1538,73 @@ std::string toString(TypePackId tp, ToStringOptions& opts)
     return toStringDetailed(tp, opts).name;
 }
 
+bool ToStringCache::Key::operator==(const Key& rhs) const
+{
+    return ty == rhs.ty && scope == rhs.scope && maxTableLength == rhs.maxTableLength && maxTypeLength == rhs.maxTypeLength &&
+           compositeTypesSingleLineLimit == rhs.compositeTypesSingleLineLimit && flags == rhs.flags;
+}
+
+size_t ToStringCache::KeyHash::operator()(const Key& key) const
+{
+    size_t seed = (uintptr_t(key.ty) >> 4) ^ (uintptr_t(key.ty) >> 9);
+    seed ^= ((uintptr_t(key.scope) >> 4) ^ (uintptr_t(key.scope) >> 9)) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    seed ^= (key.maxTypeLength * 31 + key.maxTableLength) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    seed ^= (key.compositeTypesSingleLineLimit * 64 + key.flags) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    return seed;
+}
+
+template<typename T>
+ToStringResult ToStringCache::lookup(T ty, ToStringOptions& opts)
+{
+    if (!opts.nameMap.types.empty() || !opts.nameMap.typePacks.empty() || !opts.namedFunctionOverrideArgNames.empty())
+        return Luau::toStringDetailed(ty, opts);
+
+    unsigned flags = (opts.exhaustive ? 1 : 0) | (opts.useLineBreaks ? 2 : 0) | (opts.functionTypeArguments ? 4 : 0) | (opts.hideTableKind ? 8 : 0) |
+                     (opts.hideNamedFunctionTypeParameters ? 16 : 0) | (opts.hideFunctionSelfArgument ? 32 : 0);
+
+    Key key{ty, opts.scope.get(), opts.maxTableLength, opts.maxTypeLength, opts.compositeTypesSingleLineLimit, flags};
+
+    if (auto it = entries.find(key); it != entries.end())
+    {
+        opts.nameMap = it->second.nameMap;
+        return it->second.result;
+    }
+
+    ToStringResult result = Luau::toStringDetailed(ty, opts);
+    entries.emplace(key, Entry{result, opts.nameMap});
+    return result;
+}
+
+ToStringResult ToStringCache::toStringDetailed(TypeId ty, ToStringOptions& opts)
+{
+    return lookup(ty, opts);
+}
+
+ToStringResult ToStringCache::toStringDetailed(TypePackId tp, ToStringOptions& opts)
+{
+    return lookup(tp, opts);
+}
+
+std::string ToStringCache::toString(TypeId ty, ToStringOptions& opts)
+{
+    return lookup(ty, opts).name;
+}
+
+std::string ToStringCache::toString(TypePackId tp, ToStringOptions& opts)
+{
+    return lookup(tp, opts).name;
+}
+
+size_t ToStringCache::size() const
+{
+    return entries.size();
+}
+
+void ToStringCache::clear()
+{
+    entries.clear();
+}
+
 std::string toString(const Type& tv, ToStringOptions& opts)
 {
     return toString(const_cast<TypeId>(&tv), opts);
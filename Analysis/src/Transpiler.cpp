@@ -45,6 +45,7 @@ struct Writer
     virtual void space() = 0;
     virtual void maybeSpace(const Position& newPos, int reserve) = 0;
     virtual void write(std::string_view) = 0;
+    virtual void writeEscaped(std::string_view, bool escapeForInterpString) = 0;
     virtual void identifier(std::string_view name) = 0;
     virtual void keyword(std::string_view) = 0;
     virtual void symbol(std::string_view) = 0;
@@ -58,6 +59,14 @@ struct StringWriter : Writer
     Position pos{0, 0};
     char lastChar = '\0'; // used to determine whether we need to inject an extra space to preserve grammatical correctness.
 
+    StringWriter() = default;
+
+    // output is written into a single buffer, reserving the expected size up front avoids reallocating it as the output grows
+    explicit StringWriter(size_t sizeHint)
+    {
+        ss.reserve(sizeHint);
+    }
+
     const std::string& str() const
     {
         return ss;
@@ -69,7 +78,11 @@ struct StringWriter : Writer
             newline();
 
         if (pos.column < newPos.column)
-            write(std::string(newPos.column - pos.column, ' '));
+        {
+            ss.append(newPos.column - pos.column, ' ');
+            pos.column = newPos.column;
+            lastChar = ' ';
+        }
     }
 
     void maybeSpace(const Position& newPos, int reserve) override
@@ -103,6 +116,20 @@ struct StringWriter : Writer
         lastChar = s[s.size() - 1];
     }
 
+    void writeEscaped(std::string_view s, bool escapeForInterpString) override
+    {
+        size_t start = ss.size();
+
+        escapeAppend(ss, s, escapeForInterpString);
+
+        // escape sequences don't contain line breaks
+        if (ss.size() != start)
+        {
+            pos.column += unsigned(ss.size() - start);
+            lastChar = ss.back();
+        }
+    }
+
     void write(char c)
     {
         ss += c;
@@ -158,7 +185,7 @@ struct StringWriter : Writer
             quote = '\"';
 
         write(quote);
-        write(escape(s));
+        writeEscaped(s, /* escapeForInterpString = */ false);
         write(quote);
     }
 };
@@ -326,7 +353,11 @@ struct Printer
             else
             {
                 if (isIntegerish(a->value))
-                    writer.literal(std::to_string(int(a->value)));
+                {
+                    char buffer[16];
+                    size_t len = snprintf(buffer, sizeof(buffer), "%d", int(a->value));
+                    writer.literal(std::string_view{buffer, len});
+                }
                 else
                 {
                     char buffer[100];
@@ -372,7 +403,7 @@ struct Printer
         else if (const auto& a = expr.as<AstExprIndexName>())
         {
             visualize(*a->expr);
-            writer.symbol(std::string(1, a->op));
+            writer.symbol(std::string_view(&a->op, 1));
             writer.write(a->index.value);
         }
         else if (const auto& a = expr.as<AstExprIndexExpr>())
@@ -523,7 +554,7 @@ struct Printer
 
             for (const auto& string : a->strings)
             {
-                writer.write(escape(std::string_view(string.data, string.size), /* escapeForInterpString = */ true));
+                writer.writeEscaped(std::string_view(string.data, string.size), /* escapeForInterpString = */ true);
 
                 if (index < a->expressions.size)
                 {
@@ -1197,20 +1228,29 @@ void dump(AstNode* node)
     printf("%s\n", toString(node).c_str());
 }
 
-std::string transpile(AstStatBlock& block)
+// Output keeps statements on their original lines, so its size is close to the size of the source
+static size_t estimateOutputSize(const AstStatBlock& block)
 {
-    StringWriter writer;
-    Printer(writer).visualizeBlock(block);
-    return writer.str();
+    return (block.location.end.line + 1) * 32;
 }
 
-std::string transpileWithTypes(AstStatBlock& block)
+static std::string transpileBlock(AstStatBlock& block, bool withTypes, size_t sizeHint)
 {
-    StringWriter writer;
+    StringWriter writer(sizeHint);
     Printer printer(writer);
-    printer.writeTypes = true;
+    printer.writeTypes = withTypes;
     printer.visualizeBlock(block);
-    return writer.str();
+    return std::move(writer.ss);
+}
+
+std::string transpile(AstStatBlock& block)
+{
+    return transpileBlock(block, /* withTypes */ false, estimateOutputSize(block));
+}
+
+std::string transpileWithTypes(AstStatBlock& block)
+{
+    return transpileBlock(block, /* withTypes */ true, estimateOutputSize(block));
 }
 
 TranspileResult transpile(std::string_view source, ParseOptions options, bool withTypes)
@@ -1231,10 +1271,8 @@ TranspileResult transpile(std::string_view source, ParseOptions options, bool wi
     if (!parseResult.root)
         return TranspileResult{"", {}, "Internal error: Parser yielded empty parse tree"};
 
-    if (withTypes)
-        return TranspileResult{transpileWithTypes(*parseResult.root)};
-
-    return TranspileResult{transpile(*parseResult.root)};
+    // some room is left for the spaces inserted between tokens
+    return TranspileResult{transpileBlock(*parseResult.root, withTypes, source.size() + source.size() / 8)};
 }
 
 } // namespace Luau
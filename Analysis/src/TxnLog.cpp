@@ -69,23 +69,58 @@ const TxnLog* TxnLog::empty()
     return &emptyLog;
 }
 
-void TxnLog::concat(TxnLog rhs)
+static bool isDead(const std::unique_ptr<PendingType>& rep)
+{
+    return rep->dead;
+}
+
+static bool isDead(const std::unique_ptr<PendingTypePack>&)
 {
-    for (auto& [ty, rep] : rhs.typeVarChanges)
+    return false;
+}
+
+// Moves every live entry of rhs into lhs, with rhs taking priority. Child logs
+// are merged into their parents after every successful speculative unification,
+// so instead of rehashing the larger map we swap storage and only reinsert the
+// smaller side. Entries of rhs that are dead never shadow live entries of lhs.
+template<typename K, typename V>
+static void mergeChanges(DenseHashMap<K, std::unique_ptr<V>>& lhs, DenseHashMap<K, std::unique_ptr<V>>& rhs)
+{
+    if (lhs.size() < rhs.size())
     {
-        if (rep->dead)
-            continue;
-        typeVarChanges[ty] = std::move(rep);
+        std::swap(lhs, rhs);
+
+        for (auto& [key, rep] : rhs)
+        {
+            std::unique_ptr<V>& slot = lhs[key];
+            if (!slot || isDead(slot))
+                slot = std::move(rep);
+        }
     }
+    else
+    {
+        for (auto& [key, rep] : rhs)
+        {
+            if (!isDead(rep))
+                lhs[key] = std::move(rep);
+        }
+    }
+}
 
-    for (auto& [tp, rep] : rhs.typePackChanges)
-        typePackChanges[tp] = std::move(rep);
+void TxnLog::concat(TxnLog rhs)
+{
+    mergeChanges(typeVarChanges, rhs.typeVarChanges);
+    mergeChanges(typePackChanges, rhs.typePackChanges);
 
     radioactive |= rhs.radioactive;
 }
 
 void TxnLog::concatAsIntersections(TxnLog rhs, NotNull<TypeArena> arena)
 {
+    // With nothing to collide with, this is a plain concatenation.
+    if (typeVarChanges.empty())
+        return concat(std::move(rhs));
+
     for (auto& [ty, rightRep] : rhs.typeVarChanges)
     {
         if (rightRep->dead)
@@ -109,6 +144,9 @@ void TxnLog::concatAsIntersections(TxnLog rhs, NotNull<TypeArena> arena)
 
 void TxnLog::concatAsUnion(TxnLog rhs, NotNull<TypeArena> arena)
 {
+    if (typeVarChanges.empty())
+        return concat(std::move(rhs));
+
     /*
      * Check for cycles.
      *
@@ -503,8 +541,11 @@ std::pair<std::vector<TypeId>, std::vector<TypePackId>> TxnLog::getChanges() con
 {
     std::pair<std::vector<TypeId>, std::vector<TypePackId>> result;
 
-    for (const auto& [typeId, _newState] : typeVarChanges)
-        result.first.push_back(typeId);
+    for (const auto& [typeId, newState] : typeVarChanges)
+    {
+        if (!newState->dead)
+            result.first.push_back(typeId);
+    }
     for (const auto& [typePackId, _newState] : typePackChanges)
         result.second.push_back(typePackId);
 
@@ -11,6 +11,9 @@ void TypeArena::clear()
 {
     types.clear();
     typePacks.clear();
+
+    internedTypes.clear();
+    internedTypeSet.clear();
 }
 
 TypeId TypeArena::addTV(Type&& tv)
@@ -22,6 +25,80 @@ TypeId TypeArena::addTV(Type&& tv)
     return allocated;
 }
 
+static bool isImmutable(const TypeArena& arena, TypeId ty)
+{
+    return ty->persistent || arena.internedTypeSet.contains(ty);
+}
+
+static void appendTypeIds(std::string& key, const std::vector<TypeId>& types)
+{
+    key.append(reinterpret_cast<const char*>(types.data()), types.size() * sizeof(TypeId));
+}
+
+TypeId TypeArena::addInternedType(const SingletonType& tv)
+{
+    std::string key;
+
+    if (const BooleanSingleton* bs = get<BooleanSingleton>(&tv))
+        key = bs->value ? "bt" : "bf";
+    else
+        key = "s" + get<StringSingleton>(&tv)->value;
+
+    TypeId& result = internedTypes[key];
+
+    if (!result)
+    {
+        result = addTV(Type(tv));
+        internedTypeSet.insert(result);
+    }
+
+    return result;
+}
+
+TypeId TypeArena::addInternedType(UnionType tv)
+{
+    for (TypeId option : tv.options)
+    {
+        if (!isImmutable(*this, option))
+            return addType(std::move(tv));
+    }
+
+    std::string key = "u";
+    appendTypeIds(key, tv.options);
+
+    TypeId& result = internedTypes[key];
+
+    if (!result)
+    {
+        result = addType(std::move(tv));
+        internedTypeSet.insert(result);
+    }
+
+    return result;
+}
+
+TypeId TypeArena::addInternedType(IntersectionType tv)
+{
+    for (TypeId part : tv.parts)
+    {
+        if (!isImmutable(*this, part))
+            return addType(std::move(tv));
+    }
+
+    std::string key = "i";
+    appendTypeIds(key, tv.parts);
+
+    TypeId& result = internedTypes[key];
+
+    if (!result)
+    {
+        result = addType(std::move(tv));
+        internedTypeSet.insert(result);
+    }
+
+    return result;
+}
+
 TypeId TypeArena::freshType(TypeLevel level)
 {
     TypeId allocated = types.allocate(FreeType{level});
@@ -244,6 +244,7 @@ struct TypeChecker2
     DenseHashSet<TypeId> seenTypeFamilyInstances{nullptr};
 
     Normalizer normalizer;
+    SubtypingResultCache subtypingCache{{}};
     Subtyping _subtyping;
     NotNull<Subtyping> subtyping;
 
@@ -260,6 +261,7 @@ struct TypeChecker2
               NotNull{module->getModuleScope().get()}}
         , subtyping(&_subtyping)
     {
+        _subtyping.sharedCache = &subtypingCache;
     }
 
     static bool allowsNoReturnValues(const TypePackId tp)
@@ -610,7 +612,12 @@ struct TypeChecker2
         auto StackPusher = pushStack(block);
 
         for (AstStat* statement : block->body)
+        {
+            if (limits->cancellationToken && limits->cancellationToken->requested())
+                throw UserCancelError(module->name);
+
             visit(statement);
+        }
     }
 
     void visit(AstStatIf* ifStatement)
@@ -1320,6 +1327,7 @@ struct TypeChecker2
             call->location,
         };
 
+        resolver.subtyping.sharedCache = &subtypingCache;
         resolver.resolve(fnTy, &args, call->func, &argExprs);
         auto norm = normalizer.normalize(fnTy);
         if (!norm)
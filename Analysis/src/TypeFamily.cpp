@@ -1343,9 +1343,9 @@ TypeFamilyReductionResult<TypeId> keyofFamilyImpl(
     singletons.reserve(keys.size());
 
     for (std::string key : keys)
-        singletons.push_back(ctx->arena->addType(SingletonType{StringSingleton{key}}));
+        singletons.push_back(ctx->arena->addInternedType(SingletonType{StringSingleton{key}}));
 
-    return {ctx->arena->addType(UnionType{singletons}), false, {}, {}};
+    return {ctx->arena->addInternedType(UnionType{singletons}), false, {}, {}};
 }
 
 TypeFamilyReductionResult<TypeId> keyofFamilyFn(
@@ -1180,7 +1180,8 @@ ControlFlow TypeChecker::check(const ScopePtr& scope, const AstStatLocal& local)
 
                     if (ModulePtr module = resolver->getModule(moduleInfo->name))
                     {
-                        scope->importedTypeBindings[name] = module->exportedTypeBindings;
+                        // Bindings are shared with the module instead of being copied for every require
+                        scope->importedTypeBindings[name] = std::shared_ptr<const std::unordered_map<Name, TypeFun>>(module, &module->exportedTypeBindings);
                         scope->importedModules[name] = moduleInfo->name;
 
                         // Imported types of requires that transitively refer to current module have to be replaced with 'any'
@@ -1188,8 +1189,12 @@ ControlFlow TypeChecker::check(const ScopePtr& scope, const AstStatLocal& local)
                         {
                             if (!path.empty() && path.front() == moduleInfo->name)
                             {
-                                for (auto& [name, tf] : scope->importedTypeBindings[name])
+                                auto bindings = std::make_shared<std::unordered_map<Name, TypeFun>>(module->exportedTypeBindings);
+
+                                for (auto& [name, tf] : *bindings)
                                     tf = TypeFun{{}, {}, anyType};
+
+                                scope->importedTypeBindings[name] = std::move(bindings);
                             }
                         }
                     }
@@ -2904,7 +2909,8 @@ TypeId TypeChecker::checkRelationalOperation(
         {
             // If lhs is free, we can't tell which 'falsy' components it has, if any
             if (get<FreeType>(lhsType))
-                return unionOfTypes(addType(UnionType{{nilType, singletonType(false)}}), rhsType, scope, expr.location, false);
+                return unionOfTypes(
+                    currentModule->internalTypes.addInternedType(UnionType{{nilType, singletonType(false)}}), rhsType, scope, expr.location, false);
 
             auto [oty, notNever] = pickTypesFromSense(lhsType, false, neverType); // Filter out falsy types
 
@@ -3065,8 +3071,8 @@ TypeId TypeChecker::checkBinaryOperation(
     switch (expr.op)
     {
     case AstExprBinary::Concat:
-        reportErrors(tryUnify(lhsType, addType(UnionType{{stringType, numberType}}), scope, expr.left->location));
-        reportErrors(tryUnify(rhsType, addType(UnionType{{stringType, numberType}}), scope, expr.right->location));
+        reportErrors(tryUnify(lhsType, currentModule->internalTypes.addInternedType(UnionType{{stringType, numberType}}), scope, expr.left->location));
+        reportErrors(tryUnify(rhsType, currentModule->internalTypes.addInternedType(UnionType{{stringType, numberType}}), scope, expr.right->location));
         return stringType;
     case AstExprBinary::Add:
     case AstExprBinary::Sub:
@@ -5083,8 +5089,7 @@ TypeId TypeChecker::singletonType(bool value)
 
 TypeId TypeChecker::singletonType(std::string value)
 {
-    // TODO: cache singleton types
-    return currentModule->internalTypes.addType(Type(SingletonType(StringSingleton{std::move(value)})));
+    return currentModule->internalTypes.addInternedType(SingletonType(StringSingleton{std::move(value)}));
 }
 
 TypeId TypeChecker::errorRecoveryType(const ScopePtr& scope)
@@ -5501,7 +5506,7 @@ TypeId TypeChecker::resolveTypeWorker(const ScopePtr& scope, const AstType& anno
     }
     else if (const auto& tss = annotation.as<AstTypeSingletonString>())
     {
-        return singletonType(std::string(tss->value.data, tss->value.size));
+        return addType(SingletonType(StringSingleton{std::string(tss->value.data, tss->value.size)}));
     }
     else if (annotation.is<AstTypeError>())
         return errorRecoveryType(scope);
@@ -2460,7 +2460,7 @@ TypeId Unifier::deeplyOptional(TypeId ty, std::unordered_map<TypeId, TypeId> see
         return types->addType(UnionType{{builtinTypes->nilType, result}});
     }
     else
-        return types->addType(UnionType{{builtinTypes->nilType, ty}});
+        return types->addInternedType(UnionType{{builtinTypes->nilType, ty}});
 }
 
 void Unifier::tryUnifyWithMetatable(TypeId subTy, TypeId superTy, bool reversed)
@@ -0,0 +1,42 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#pragma once
+
+#include "Luau/Ast.h"
+
+#include <string>
+
+#include <stddef.h>
+
+namespace Luau
+{
+
+// Structural description of an AST subtree that ignores source locations, names of locals, debug names and purely syntactic details
+// Locals declared inside the subtree are identified by their declaration order and locals declared outside of it by their identity, so
+// subtrees with equal fingerprints behave identically when they are placed in the same module
+struct AstFingerprint
+{
+    std::string data;
+    size_t hash = 0;
+
+    bool operator==(const AstFingerprint& rhs) const
+    {
+        return hash == rhs.hash && data == rhs.data;
+    }
+
+    bool operator!=(const AstFingerprint& rhs) const
+    {
+        return !(*this == rhs);
+    }
+};
+
+struct AstFingerprintHash
+{
+    size_t operator()(const AstFingerprint& fingerprint) const
+    {
+        return fingerprint.hash;
+    }
+};
+
+AstFingerprint getFingerprint(AstNode* node);
+
+} // namespace Luau
@@ -15,6 +15,8 @@ class Allocator
 {
 public:
     Allocator();
+    // Pages will be at least 'pageSize' bytes large; sizing them to the input avoids chains of small pages when parsing large sources
+    explicit Allocator(size_t pageSize);
     Allocator(Allocator&&);
 
     Allocator& operator=(Allocator&&) = delete;
@@ -37,10 +39,14 @@ private:
     struct Page
     {
         Page* next;
+        size_t size;
 
         char data[8192];
     };
 
+    static Page* newPage(size_t size);
+    static void deletePage(Page* page);
+
     Page* root;
     size_t offset;
 };
@@ -142,6 +148,9 @@ class AstNameTable
 {
 public:
     AstNameTable(Allocator& allocator);
+    // Starts with all names of 'seed', which can be filled once with common names and shared between parses; names are not copied, so
+    // the seed and its allocator have to outlive this table
+    AstNameTable(Allocator& allocator, const AstNameTable& seed);
 
     AstName addStatic(const char* name, Lexeme::Type type = Lexeme::Name);
 
@@ -156,6 +165,8 @@ private:
     {
         AstName value;
         uint32_t length;
+        // hash of the name is stored to make comparisons and table growth cheaper
+        uint32_t hash;
         Lexeme::Type type;
 
         bool operator==(const Entry& other) const;
@@ -166,6 +177,8 @@ private:
         size_t operator()(const Entry& e) const;
     };
 
+    static const DenseHashSet<Entry, EntryHash>& getReservedNames();
+
     DenseHashSet<Entry, EntryHash> data;
 
     Allocator& allocator;
@@ -174,7 +187,8 @@ private:
 class Lexer
 {
 public:
-    Lexer(const char* buffer, std::size_t bufferSize, AstNameTable& names);
+    // Lexing starts at startPosition, which has to be the start of a lexeme outside of any interpolated string
+    Lexer(const char* buffer, std::size_t bufferSize, AstNameTable& names, Position startPosition = Position(0, 0));
 
     void setSkipComments(bool skip);
     void setReadNames(bool read);
@@ -209,6 +223,9 @@ private:
     // consume() assumes current character is not a newline for performance; when that is not known, consumeAny() should be used instead.
     void consume();
     void consumeAny();
+    // consumeSpaces() skips a run of whitespace and consumeRun() skips 'length' characters, both keep track of newlines
+    void consumeSpaces();
+    void consumeRun(unsigned int length);
 
     Lexeme readCommentBody();
 
@@ -51,17 +51,35 @@ private:
     size_t size_;
 };
 
+// Replacement of a range of the source text, see Parser::parseIncremental
+struct ParseEdit
+{
+    // Range of the previous source text that was replaced
+    Location range;
+
+    // Position in the new source text where the replacement ends
+    Position newEnd{0, 0};
+};
+
 class Parser
 {
 public:
     static ParseResult parse(
         const char* buffer, std::size_t bufferSize, AstNameTable& names, Allocator& allocator, ParseOptions options = ParseOptions());
 
+    // Parses the source text again after an edit, reusing the top-level statements of the previous result that the edit can't affect.
+    // Only the statements around the edit are lexed and parsed again; the result is the same as the one of a full parse.
+    // Reused statements have their locations updated in place and new nodes are allocated from the same allocator, so the
+    // previous result can't be used afterwards, and names and allocator have to be the ones the previous result was parsed with.
+    static ParseResult parseIncremental(const char* buffer, std::size_t bufferSize, AstNameTable& names, Allocator& allocator,
+        ParseResult& previous, const ParseEdit& edit, ParseOptions options = ParseOptions());
+
 private:
     struct Name;
     struct Binding;
 
-    Parser(const char* buffer, std::size_t bufferSize, AstNameTable& names, Allocator& allocator, const ParseOptions& options);
+    Parser(const char* buffer, std::size_t bufferSize, AstNameTable& names, Allocator& allocator, const ParseOptions& options,
+        Position startPosition = Position(0, 0));
 
     bool blockFollow(const Lexeme& l);
 
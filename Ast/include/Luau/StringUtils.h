@@ -32,5 +32,6 @@ bool equalsLower(std::string_view lhs, std::string_view rhs);
 size_t hashRange(const char* data, size_t size);
 
 std::string escape(std::string_view s, bool escapeForInterpString = false);
+void escapeAppend(std::string& result, std::string_view s, bool escapeForInterpString = false);
 bool isIdentifier(std::string_view s);
 } // namespace Luau
@@ -5,10 +5,15 @@
 
 #include <vector>
 #include <memory>
+#include <mutex>
+#include <string>
 
 #include <stdint.h>
+#include <string.h>
 
 LUAU_FASTFLAG(DebugLuauTimeTracing)
+LUAU_FASTINT(LuauTimeTraceRingSize)
+LUAU_FASTINT(LuauTimeTraceTailSampleRate)
 
 namespace Luau
 {
@@ -55,12 +60,32 @@ struct Event
 struct GlobalContext;
 struct ThreadContext;
 
+// Events are streamed to trace.json while DebugLuauTimeTracing is set and kept in per-thread ring buffers while LuauTimeTraceRingSize is non-zero
+inline bool isEnabled()
+{
+    return FFlag::DebugLuauTimeTracing || FInt::LuauTimeTraceRingSize > 0;
+}
+
+// Fixed-size buffer of the most recent events of a thread; old events are overwritten instead of being flushed
+struct RingBuffer
+{
+    std::mutex mutex;
+    std::vector<Event> events;
+    std::vector<std::string> data; // argument strings, stored in the slot of their event
+    size_t head = 0;
+    size_t size = 0;
+};
+
 std::shared_ptr<GlobalContext> getGlobalContext();
 
 uint16_t createToken(GlobalContext& context, const char* name, const char* category);
 uint32_t createThread(GlobalContext& context, ThreadContext* threadContext);
 void releaseThread(GlobalContext& context, ThreadContext* threadContext);
 void flushEvents(GlobalContext& context, uint32_t threadId, const std::vector<Event>& events, const std::vector<char>& data);
+void recordEvent(RingBuffer& ring, const Event& ev, const char* str);
+
+// Formats the events currently held in the ring buffers of all threads as Chrome trace JSON (also accepted by Perfetto)
+std::string exportTrace();
 
 struct ThreadContext
 {
@@ -99,7 +124,7 @@ struct ThreadContext
 
     void eventEnter(uint16_t token, uint32_t microsec)
     {
-        events.push_back({EventType::Enter, token, {microsec}});
+        record({EventType::Enter, token, {microsec}});
     }
 
     void eventLeave()
@@ -109,7 +134,7 @@ struct ThreadContext
 
     void eventLeave(uint32_t microsec)
     {
-        events.push_back({EventType::Leave, 0, {microsec}});
+        record({EventType::Leave, 0, {microsec}});
 
         if (events.size() > kEventFlushLimit)
             flushEvents();
@@ -117,19 +142,52 @@ struct ThreadContext
 
     void eventArgument(const char* name, const char* value)
     {
-        uint32_t pos = uint32_t(data.size());
-        data.insert(data.end(), name, name + strlen(name) + 1);
-        events.push_back({EventType::ArgName, 0, {pos}});
+        if (FFlag::DebugLuauTimeTracing)
+        {
+            uint32_t pos = uint32_t(data.size());
+            data.insert(data.end(), name, name + strlen(name) + 1);
+            events.push_back({EventType::ArgName, 0, {pos}});
+
+            pos = uint32_t(data.size());
+            data.insert(data.end(), value, value + strlen(value) + 1);
+            events.push_back({EventType::ArgValue, 0, {pos}});
+        }
+
+        if (FInt::LuauTimeTraceRingSize > 0)
+        {
+            recordEvent(ring, {EventType::ArgName, 0, {0}}, name);
+            recordEvent(ring, {EventType::ArgValue, 0, {0}}, value);
+        }
+
+        eventCount += 2;
+    }
+
+    void record(const Event& ev)
+    {
+        if (FFlag::DebugLuauTimeTracing)
+            events.push_back(ev);
+
+        if (FInt::LuauTimeTraceRingSize > 0)
+            recordEvent(ring, ev, nullptr);
+
+        eventCount++;
+    }
+
+    // Short tail scopes are kept once in every LuauTimeTraceTailSampleRate runs, so frequent small scopes remain visible at a fraction of the cost
+    bool sampleTail()
+    {
+        int rate = FInt::LuauTimeTraceTailSampleRate;
 
-        pos = uint32_t(data.size());
-        data.insert(data.end(), value, value + strlen(value) + 1);
-        events.push_back({EventType::ArgValue, 0, {pos}});
+        return rate > 0 && ++tailCount % unsigned(rate) == 0;
     }
 
     std::shared_ptr<GlobalContext> globalContext;
     uint32_t threadId;
     std::vector<Event> events;
     std::vector<char> data;
+    RingBuffer ring;
+    uint32_t eventCount = 0;
+    uint32_t tailCount = 0;
 
     static constexpr size_t kEventFlushLimit = 8192;
 };
@@ -141,7 +199,7 @@ struct Scope
     explicit Scope(uint16_t token)
         : context(getThreadContext())
     {
-        if (!FFlag::DebugLuauTimeTracing)
+        if (!isEnabled())
             return;
 
         context.eventEnter(token);
@@ -149,7 +207,7 @@ struct Scope
 
     ~Scope()
     {
-        if (!FFlag::DebugLuauTimeTracing)
+        if (!isEnabled())
             return;
 
         context.eventLeave();
@@ -165,23 +223,23 @@ struct OptionalTailScope
         , token(token)
         , threshold(threshold)
     {
-        if (!FFlag::DebugLuauTimeTracing)
+        if (!isEnabled())
             return;
 
-        pos = uint32_t(context.events.size());
+        pos = context.eventCount;
         microsec = getClockMicroseconds();
     }
 
     ~OptionalTailScope()
     {
-        if (!FFlag::DebugLuauTimeTracing)
+        if (!isEnabled())
             return;
 
-        if (pos == context.events.size())
+        if (pos == context.eventCount)
         {
             uint32_t curr = getClockMicroseconds();
 
-            if (curr - microsec > threshold)
+            if (curr - microsec > threshold || context.sampleTail())
             {
                 context.eventEnter(token, microsec);
                 context.eventLeave(curr);
@@ -206,7 +264,7 @@ LUAU_NOINLINE uint16_t createScopeData(const char* name, const char* category);
     static uint16_t lttScopeStatic = Luau::TimeTrace::createScopeData(name, category); \
     Luau::TimeTrace::Scope lttScope(lttScopeStatic)
 
-// A scope without nested scopes that may be skipped if the time it took is less than the threshold
+// A scope without nested scopes that may be skipped if the time it took is less than the threshold; short runs are sampled at LuauTimeTraceTailSampleRate
 #define LUAU_TIMETRACE_OPTIONAL_TAIL_SCOPE(name, category, microsec) \
     static uint16_t lttScopeStaticOptTail = Luau::TimeTrace::createScopeData(name, category); \
     Luau::TimeTrace::OptionalTailScope lttScope(lttScopeStaticOptTail, microsec)
@@ -215,7 +273,7 @@ LUAU_NOINLINE uint16_t createScopeData(const char* name, const char* category);
 #define LUAU_TIMETRACE_ARGUMENT(name, value) \
     do \
     { \
-        if (FFlag::DebugLuauTimeTracing) \
+        if (Luau::TimeTrace::isEnabled()) \
             lttScope.context.eventArgument(name, value); \
     } while (false)
 
@@ -0,0 +1,541 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#include "Luau/AstFingerprint.h"
+
+#include "Luau/Common.h"
+#include "Luau/DenseHash.h"
+#include "Luau/Hash.h"
+
+namespace Luau
+{
+
+// Every node is serialized as its class index followed by its own data and its children in a fixed order; array sizes and presence markers
+// for optional children are recorded as well, which makes the serialized form unambiguous
+struct FingerprintBuilder
+{
+    std::string& data;
+    DenseHashMap<AstLocal*, uint32_t> locals{nullptr};
+
+    explicit FingerprintBuilder(std::string& data)
+        : data(data)
+    {
+    }
+
+    void writeBytes(const void* bytes, size_t size)
+    {
+        data.append(static_cast<const char*>(bytes), size);
+    }
+
+    void writeInt(uint64_t value)
+    {
+        // variable-length encoding, since most of the values are small
+        do
+        {
+            data.push_back(char((value & 127) | (value > 127 ? 128 : 0)));
+            value >>= 7;
+        } while (value);
+    }
+
+    void writeBool(bool value)
+    {
+        data.push_back(value ? 1 : 0);
+    }
+
+    void writeString(const char* value, size_t size)
+    {
+        writeInt(size);
+        writeBytes(value, size);
+    }
+
+    void writeName(const AstName& name)
+    {
+        writeBool(name.value != nullptr);
+
+        if (name.value)
+            writeString(name.value, strlen(name.value));
+    }
+
+    void writeName(const std::optional<AstName>& name)
+    {
+        writeBool(name.has_value());
+
+        if (name)
+            writeName(*name);
+    }
+
+    void declare(AstLocal* local)
+    {
+        locals[local] = uint32_t(locals.size());
+
+        writeType(local->annotation);
+    }
+
+    void writeLocal(AstLocal* local)
+    {
+        if (const uint32_t* index = locals.find(local))
+        {
+            writeBool(true);
+            writeInt(*index);
+        }
+        else
+        {
+            writeBool(false);
+            writeInt(uint64_t(uintptr_t(local)));
+        }
+    }
+
+    void writeExpr(AstExpr* node)
+    {
+        writeBool(node != nullptr);
+
+        if (node)
+            write(node);
+    }
+
+    void writeExprs(const AstArray<AstExpr*>& list)
+    {
+        writeInt(list.size);
+
+        for (AstExpr* expr : list)
+            writeExpr(expr);
+    }
+
+    void writeStat(AstStat* node)
+    {
+        writeBool(node != nullptr);
+
+        if (node)
+            write(node);
+    }
+
+    void writeType(AstType* node)
+    {
+        writeBool(node != nullptr);
+
+        if (node)
+            write(node);
+    }
+
+    void writeTypePack(AstTypePack* node)
+    {
+        writeBool(node != nullptr);
+
+        if (node)
+            write(node);
+    }
+
+    void writeTypeList(const AstTypeList& list)
+    {
+        writeInt(list.types.size);
+
+        for (AstType* type : list.types)
+            writeType(type);
+
+        writeTypePack(list.tailType);
+    }
+
+    void writeGenerics(const AstArray<AstGenericType>& generics, const AstArray<AstGenericTypePack>& genericPacks)
+    {
+        writeInt(generics.size);
+
+        for (const AstGenericType& generic : generics)
+        {
+            writeName(generic.name);
+            writeType(generic.defaultValue);
+        }
+
+        writeInt(genericPacks.size);
+
+        for (const AstGenericTypePack& genericPack : genericPacks)
+        {
+            writeName(genericPack.name);
+            writeTypePack(genericPack.defaultValue);
+        }
+    }
+
+    void writeIndexer(AstTableIndexer* indexer)
+    {
+        writeBool(indexer != nullptr);
+
+        if (indexer)
+        {
+            writeType(indexer->indexType);
+            writeType(indexer->resultType);
+            writeInt(unsigned(indexer->access));
+        }
+    }
+
+    void write(AstNode* node)
+    {
+        writeInt(node->classIndex);
+
+        if (AstExprGroup* expr = node->as<AstExprGroup>())
+        {
+            writeExpr(expr->expr);
+        }
+        else if (node->is<AstExprConstantNil>())
+        {
+        }
+        else if (AstExprConstantBool* expr = node->as<AstExprConstantBool>())
+        {
+            writeBool(expr->value);
+        }
+        else if (AstExprConstantNumber* expr = node->as<AstExprConstantNumber>())
+        {
+            writeBytes(&expr->value, sizeof(expr->value));
+        }
+        else if (AstExprConstantString* expr = node->as<AstExprConstantString>())
+        {
+            writeString(expr->value.data, expr->value.size);
+        }
+        else if (AstExprLocal* expr = node->as<AstExprLocal>())
+        {
+            writeLocal(expr->local);
+        }
+        else if (AstExprGlobal* expr = node->as<AstExprGlobal>())
+        {
+            writeName(expr->name);
+        }
+        else if (node->is<AstExprVarargs>())
+        {
+        }
+        else if (AstExprCall* expr = node->as<AstExprCall>())
+        {
+            writeExpr(expr->func);
+            writeExprs(expr->args);
+            writeBool(expr->self);
+        }
+        else if (AstExprIndexName* expr = node->as<AstExprIndexName>())
+        {
+            writeExpr(expr->expr);
+            writeName(expr->index);
+            writeInt(uint8_t(expr->op));
+        }
+        else if (AstExprIndexExpr* expr = node->as<AstExprIndexExpr>())
+        {
+            writeExpr(expr->expr);
+            writeExpr(expr->index);
+        }
+        else if (AstExprFunction* expr = node->as<AstExprFunction>())
+        {
+            writeGenerics(expr->generics, expr->genericPacks);
+
+            writeBool(expr->self != nullptr);
+
+            if (expr->self)
+                declare(expr->self);
+
+            writeInt(expr->args.size);
+
+            for (AstLocal* arg : expr->args)
+                declare(arg);
+
+            writeBool(expr->vararg);
+            writeTypePack(expr->varargAnnotation);
+
+            writeBool(expr->returnAnnotation.has_value());
+
+            if (expr->returnAnnotation)
+                writeTypeList(*expr->returnAnnotation);
+
+            writeStat(expr->body);
+        }
+        else if (AstExprTable* expr = node->as<AstExprTable>())
+        {
+            writeInt(expr->items.size);
+
+            for (const AstExprTable::Item& item : expr->items)
+            {
+                writeInt(item.kind);
+                writeExpr(item.key);
+                writeExpr(item.value);
+            }
+        }
+        else if (AstExprUnary* expr = node->as<AstExprUnary>())
+        {
+            writeInt(expr->op);
+            writeExpr(expr->expr);
+        }
+        else if (AstExprBinary* expr = node->as<AstExprBinary>())
+        {
+            writeInt(expr->op);
+            writeExpr(expr->left);
+            writeExpr(expr->right);
+        }
+        else if (AstExprTypeAssertion* expr = node->as<AstExprTypeAssertion>())
+        {
+            writeExpr(expr->expr);
+            writeType(expr->annotation);
+        }
+        else if (AstExprIfElse* expr = node->as<AstExprIfElse>())
+        {
+            writeExpr(expr->condition);
+            writeExpr(expr->trueExpr);
+            writeExpr(expr->falseExpr);
+        }
+        else if (AstExprInterpString* expr = node->as<AstExprInterpString>())
+        {
+            writeInt(expr->strings.size);
+
+            for (const AstArray<char>& string : expr->strings)
+                writeString(string.data, string.size);
+
+            writeExprs(expr->expressions);
+        }
+        else if (AstExprError* expr = node->as<AstExprError>())
+        {
+            writeExprs(expr->expressions);
+            writeInt(expr->messageIndex);
+        }
+        else if (AstStatBlock* stat = node->as<AstStatBlock>())
+        {
+            writeInt(stat->body.size);
+
+            for (AstStat* child : stat->body)
+                writeStat(child);
+        }
+        else if (AstStatIf* stat = node->as<AstStatIf>())
+        {
+            writeExpr(stat->condition);
+            writeStat(stat->thenbody);
+            writeStat(stat->elsebody);
+        }
+        else if (AstStatWhile* stat = node->as<AstStatWhile>())
+        {
+            writeExpr(stat->condition);
+            writeStat(stat->body);
+        }
+        else if (AstStatRepeat* stat = node->as<AstStatRepeat>())
+        {
+            // condition can refer to the locals declared in the body
+            writeStat(stat->body);
+            writeExpr(stat->condition);
+        }
+        else if (node->is<AstStatBreak>() || node->is<AstStatContinue>())
+        {
+        }
+        else if (AstStatReturn* stat = node->as<AstStatReturn>())
+        {
+            writeExprs(stat->list);
+        }
+        else if (AstStatExpr* stat = node->as<AstStatExpr>())
+        {
+            writeExpr(stat->expr);
+        }
+        else if (AstStatLocal* stat = node->as<AstStatLocal>())
+        {
+            writeExprs(stat->values);
+
+            writeInt(stat->vars.size);
+
+            for (AstLocal* var : stat->vars)
+                declare(var);
+        }
+        else if (AstStatFor* stat = node->as<AstStatFor>())
+        {
+            writeExpr(stat->from);
+            writeExpr(stat->to);
+            writeExpr(stat->step);
+            declare(stat->var);
+            writeStat(stat->body);
+        }
+        else if (AstStatForIn* stat = node->as<AstStatForIn>())
+        {
+            writeExprs(stat->values);
+
+            writeInt(stat->vars.size);
+
+            for (AstLocal* var : stat->vars)
+                declare(var);
+
+            writeStat(stat->body);
+        }
+        else if (AstStatAssign* stat = node->as<AstStatAssign>())
+        {
+            writeExprs(stat->vars);
+            writeExprs(stat->values);
+        }
+        else if (AstStatCompoundAssign* stat = node->as<AstStatCompoundAssign>())
+        {
+            writeInt(stat->op);
+            writeExpr(stat->var);
+            writeExpr(stat->value);
+        }
+        else if (AstStatFunction* stat = node->as<AstStatFunction>())
+        {
+            writeExpr(stat->name);
+            writeExpr(stat->func);
+        }
+        else if (AstStatLocalFunction* stat = node->as<AstStatLocalFunction>())
+        {
+            // function body can refer to itself
+            declare(stat->name);
+            writeExpr(stat->func);
+        }
+        else if (AstStatTypeAlias* stat = node->as<AstStatTypeAlias>())
+        {
+            writeName(stat->name);
+            writeGenerics(stat->generics, stat->genericPacks);
+            writeType(stat->type);
+            writeBool(stat->exported);
+        }
+        else if (AstStatDeclareGlobal* stat = node->as<AstStatDeclareGlobal>())
+        {
+            writeName(stat->name);
+            writeType(stat->type);
+        }
+        else if (AstStatDeclareFunction* stat = node->as<AstStatDeclareFunction>())
+        {
+            writeName(stat->name);
+            writeGenerics(stat->generics, stat->genericPacks);
+            writeTypeList(stat->params);
+
+            writeInt(stat->paramNames.size);
+
+            for (const AstArgumentName& name : stat->paramNames)
+                writeName(name.first);
+
+            writeTypeList(stat->retTypes);
+            writeBool(stat->checkedFunction);
+        }
+        else if (AstStatDeclareClass* stat = node->as<AstStatDeclareClass>())
+        {
+            writeName(stat->name);
+            writeName(stat->superName);
+
+            writeInt(stat->props.size);
+
+            for (const AstDeclaredClassProp& prop : stat->props)
+            {
+                writeName(prop.name);
+                writeType(prop.ty);
+                writeBool(prop.isMethod);
+            }
+
+            writeIndexer(stat->indexer);
+        }
+        else if (AstStatError* stat = node->as<AstStatError>())
+        {
+            writeExprs(stat->expressions);
+
+            writeInt(stat->statements.size);
+
+            for (AstStat* child : stat->statements)
+                writeStat(child);
+
+            writeInt(stat->messageIndex);
+        }
+        else if (AstTypeReference* type = node->as<AstTypeReference>())
+        {
+            writeName(type->prefix);
+            writeName(type->name);
+            writeBool(type->hasParameterList);
+
+            writeInt(type->parameters.size);
+
+            for (const AstTypeOrPack& parameter : type->parameters)
+            {
+                writeType(parameter.type);
+                writeTypePack(parameter.typePack);
+            }
+        }
+        else if (AstTypeTable* type = node->as<AstTypeTable>())
+        {
+            writeInt(type->props.size);
+
+            for (const AstTableProp& prop : type->props)
+            {
+                writeName(prop.name);
+                writeType(prop.type);
+                writeInt(unsigned(prop.access));
+            }
+
+            writeIndexer(type->indexer);
+        }
+        else if (AstTypeFunction* type = node->as<AstTypeFunction>())
+        {
+            writeGenerics(type->generics, type->genericPacks);
+            writeTypeList(type->argTypes);
+
+            writeInt(type->argNames.size);
+
+            for (const std::optional<AstArgumentName>& name : type->argNames)
+            {
+                writeBool(name.has_value());
+
+                if (name)
+                    writeName(name->first);
+            }
+
+            writeTypeList(type->returnTypes);
+            writeBool(type->checkedFunction);
+        }
+        else if (AstTypeTypeof* type = node->as<AstTypeTypeof>())
+        {
+            writeExpr(type->expr);
+        }
+        else if (AstTypeUnion* type = node->as<AstTypeUnion>())
+        {
+            writeInt(type->types.size);
+
+            for (AstType* option : type->types)
+                writeType(option);
+        }
+        else if (AstTypeIntersection* type = node->as<AstTypeIntersection>())
+        {
+            writeInt(type->types.size);
+
+            for (AstType* part : type->types)
+                writeType(part);
+        }
+        else if (AstTypeError* type = node->as<AstTypeError>())
+        {
+            writeInt(type->types.size);
+
+            for (AstType* child : type->types)
+                writeType(child);
+
+            writeBool(type->isMissing);
+            writeInt(type->messageIndex);
+        }
+        else if (AstTypeSingletonBool* type = node->as<AstTypeSingletonBool>())
+        {
+            writeBool(type->value);
+        }
+        else if (AstTypeSingletonString* type = node->as<AstTypeSingletonString>())
+        {
+            writeString(type->value.data, type->value.size);
+        }
+        else if (AstTypePackExplicit* pack = node->as<AstTypePackExplicit>())
+        {
+            writeTypeList(pack->typeList);
+        }
+        else if (AstTypePackVariadic* pack = node->as<AstTypePackVariadic>())
+        {
+            writeType(pack->variadicType);
+        }
+        else if (AstTypePackGeneric* pack = node->as<AstTypePackGeneric>())
+        {
+            writeName(pack->genericName);
+        }
+        else
+        {
+            LUAU_ASSERT(!"Unknown AST node kind");
+        }
+    }
+};
+
+AstFingerprint getFingerprint(AstNode* node)
+{
+    AstFingerprint result;
+
+    FingerprintBuilder builder(result.data);
+    builder.write(node);
+
+    Fnv1aHash hash;
+    hash.addBytes(result.data.data(), result.data.size());
+
+    result.hash = size_t(hash.value);
+    return result;
+}
+
+} // namespace Luau
@@ -6,6 +6,19 @@
 #include "Luau/StringUtils.h"
 
 #include <limits.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LUAU_LEXER_SSE2 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define LUAU_LEXER_NEON 1
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 LUAU_FASTFLAGVARIABLE(LuauLexerLookaheadRemembersBraceType, false)
 LUAU_FASTFLAGVARIABLE(LuauCheckedFunctionSyntax, false)
@@ -13,11 +26,78 @@ LUAU_FASTFLAGVARIABLE(LuauCheckedFunctionSyntax, false)
 namespace Luau
 {
 
+// Pages of the default size are kept in a per-thread pool when an allocator is destroyed, so that parsing many sources in a row
+// reuses memory instead of going through the system allocator for every page
+static const size_t kMaxPooledPages = 64;
+
+struct AllocatorPagePool
+{
+    void* head = nullptr;
+    size_t count = 0;
+
+    ~AllocatorPagePool()
+    {
+        while (head)
+        {
+            void* next = *static_cast<void**>(head);
+
+            operator delete(head);
+
+            head = next;
+        }
+    }
+};
+
+static thread_local AllocatorPagePool allocatorPagePool;
+
+Allocator::Page* Allocator::newPage(size_t size)
+{
+    AllocatorPagePool& pool = allocatorPagePool;
+
+    Page* page = nullptr;
+
+    if (size == sizeof(page->data) && pool.head)
+    {
+        page = static_cast<Page*>(pool.head);
+        pool.head = page->next;
+        pool.count--;
+    }
+    else
+    {
+        page = static_cast<Page*>(operator new(offsetof(Page, data) + size));
+    }
+
+    page->next = nullptr;
+    page->size = size;
+    return page;
+}
+
+void Allocator::deletePage(Page* page)
+{
+    AllocatorPagePool& pool = allocatorPagePool;
+
+    if (page->size == sizeof(page->data) && pool.count < kMaxPooledPages)
+    {
+        page->next = static_cast<Page*>(pool.head);
+        pool.head = page;
+        pool.count++;
+    }
+    else
+    {
+        operator delete(page);
+    }
+}
+
 Allocator::Allocator()
-    : root(static_cast<Page*>(operator new(sizeof(Page))))
+    : root(newPage(sizeof(root->data)))
+    , offset(0)
+{
+}
+
+Allocator::Allocator(size_t pageSize)
+    : root(newPage(pageSize > sizeof(root->data) ? pageSize : sizeof(root->data)))
     , offset(0)
 {
-    root->next = nullptr;
 }
 
 Allocator::Allocator(Allocator&& rhs)
@@ -36,7 +116,7 @@ Allocator::~Allocator()
     {
         Page* next = page->next;
 
-        operator delete(page);
+        deletePage(page);
 
         page = next;
     }
@@ -50,7 +130,7 @@ void* Allocator::allocate(size_t size)
     {
         uintptr_t data = reinterpret_cast<uintptr_t>(root->data);
         uintptr_t result = (data + offset + align - 1) & ~(align - 1);
-        if (result + size <= data + sizeof(root->data))
+        if (result + size <= data + root->size)
         {
             offset = result - data + size;
             return reinterpret_cast<void*>(result);
@@ -59,9 +139,7 @@ void* Allocator::allocate(size_t size)
 
     // allocate new page
     size_t pageSize = size > sizeof(root->data) ? size : sizeof(root->data);
-    void* pageData = operator new(offsetof(Page, data) + pageSize);
-
-    Page* page = static_cast<Page*>(pageData);
+    Page* page = newPage(pageSize);
 
     page->next = root;
 
@@ -224,40 +302,76 @@ std::string Lexeme::toString() const
     }
 }
 
-bool AstNameTable::Entry::operator==(const Entry& other) const
-{
-    return length == other.length && memcmp(value.value, other.value.value, length) == 0;
-}
-
-size_t AstNameTable::EntryHash::operator()(const Entry& e) const
+static uint32_t hashName(const char* name, size_t length)
 {
     // FNV1a
     uint32_t hash = 2166136261;
 
-    for (size_t i = 0; i < e.length; ++i)
+    for (size_t i = 0; i < length; ++i)
     {
-        hash ^= uint8_t(e.value.value[i]);
+        hash ^= uint8_t(name[i]);
         hash *= 16777619;
     }
 
     return hash;
 }
 
+bool AstNameTable::Entry::operator==(const Entry& other) const
+{
+    return hash == other.hash && length == other.length && memcmp(value.value, other.value.value, length) == 0;
+}
+
+size_t AstNameTable::EntryHash::operator()(const Entry& e) const
+{
+    return e.hash;
+}
+
+const DenseHashSet<AstNameTable::Entry, AstNameTable::EntryHash>& AstNameTable::getReservedNames()
+{
+    // reserved words point to static strings, so the same set can be used to start every table
+    static const DenseHashSet<Entry, EntryHash> reserved = []() {
+        static_assert(sizeof(kReserved) / sizeof(kReserved[0]) == Lexeme::Reserved_END - Lexeme::Reserved_BEGIN);
+
+        DenseHashSet<Entry, EntryHash> result({AstName(""), 0, hashName("", 0), Lexeme::Eof}, 128);
+
+        for (int i = Lexeme::Reserved_BEGIN; i < Lexeme::Reserved_END; ++i)
+        {
+            const char* name = kReserved[i - Lexeme::Reserved_BEGIN];
+            size_t length = strlen(name);
+
+            result.insert({AstName(name), uint32_t(length), hashName(name, length), static_cast<Lexeme::Type>(i)});
+        }
+
+        return result;
+    }();
+
+    return reserved;
+}
+
 AstNameTable::AstNameTable(Allocator& allocator)
-    : data({AstName(""), 0, Lexeme::Eof}, 128)
+    : data(getReservedNames())
     , allocator(allocator)
 {
-    static_assert(sizeof(kReserved) / sizeof(kReserved[0]) == Lexeme::Reserved_END - Lexeme::Reserved_BEGIN);
+}
 
-    for (int i = Lexeme::Reserved_BEGIN; i < Lexeme::Reserved_END; ++i)
-        addStatic(kReserved[i - Lexeme::Reserved_BEGIN], static_cast<Lexeme::Type>(i));
+AstNameTable::AstNameTable(Allocator& allocator, const AstNameTable& seed)
+    : data(seed.data)
+    , allocator(allocator)
+{
 }
 
 AstName AstNameTable::addStatic(const char* name, Lexeme::Type type)
 {
-    AstNameTable::Entry entry = {AstName(name), uint32_t(strlen(name)), type};
+    size_t length = strlen(name);
+    AstNameTable::Entry entry = {AstName(name), uint32_t(length), hashName(name, length), type};
+
+    // Tables that are reused between parses or seeded from another table already have the static names
+    if (const AstNameTable::Entry* existing = data.find(entry))
+    {
+        LUAU_ASSERT(existing->type == type);
+        return existing->value;
+    }
 
-    LUAU_ASSERT(!data.contains(entry));
     data.insert(entry);
 
     return entry.value;
@@ -265,7 +379,7 @@ AstName AstNameTable::addStatic(const char* name, Lexeme::Type type)
 
 std::pair<AstName, Lexeme::Type> AstNameTable::getOrAddWithType(const char* name, size_t length)
 {
-    AstNameTable::Entry key = {AstName(name), uint32_t(length), Lexeme::Eof};
+    AstNameTable::Entry key = {AstName(name), uint32_t(length), hashName(name, length), Lexeme::Eof};
     const Entry& entry = data.insert(key);
 
     // entry already was inserted
@@ -286,7 +400,7 @@ std::pair<AstName, Lexeme::Type> AstNameTable::getOrAddWithType(const char* name
 
 std::pair<AstName, Lexeme::Type> AstNameTable::getWithType(const char* name, size_t length) const
 {
-    if (const Entry* entry = data.find({AstName(name), uint32_t(length), Lexeme::Eof}))
+    if (const Entry* entry = data.find({AstName(name), uint32_t(length), hashName(name, length), Lexeme::Eof}))
     {
         return std::make_pair(entry->value, entry->type);
     }
@@ -325,6 +439,138 @@ inline bool isNewline(char ch)
     return ch == '\n';
 }
 
+inline int countrz(uint32_t n)
+{
+#ifdef _MSC_VER
+    unsigned long rl;
+    return _BitScanForward(&rl, n) ? int(rl) : 32;
+#else
+    return n == 0 ? 32 : __builtin_ctz(n);
+#endif
+}
+
+inline int countlz(uint32_t n)
+{
+#ifdef _MSC_VER
+    unsigned long rl;
+    return _BitScanReverse(&rl, n) ? 31 - int(rl) : 32;
+#else
+    return n == 0 ? 32 : __builtin_clz(n);
+#endif
+}
+
+// Hot lexer loops scan 16 bytes at a time when the buffer has enough data left; each block is turned into a bit mask with a bit per
+// byte that matches a character class, and the remaining tail of the buffer is handled by the regular per-character loops
+#if defined(LUAU_LEXER_SSE2) || defined(LUAU_LEXER_NEON)
+#define LUAU_LEXER_SIMD 1
+
+const unsigned int kSimdBlockSize = 16;
+
+#if defined(LUAU_LEXER_SSE2)
+typedef __m128i SimdBlock;
+
+LUAU_FORCEINLINE SimdBlock simdLoad(const char* data)
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+}
+
+LUAU_FORCEINLINE SimdBlock simdEq(SimdBlock block, char ch)
+{
+    return _mm_cmpeq_epi8(block, _mm_set1_epi8(ch));
+}
+
+LUAU_FORCEINLINE SimdBlock simdOr(SimdBlock lhs, SimdBlock rhs)
+{
+    return _mm_or_si128(lhs, rhs);
+}
+
+// Matches bytes in range [first, first + count)
+LUAU_FORCEINLINE SimdBlock simdInRange(SimdBlock block, char first, char count)
+{
+    SimdBlock rel = _mm_sub_epi8(block, _mm_set1_epi8(first));
+    return _mm_cmpeq_epi8(_mm_min_epu8(rel, _mm_set1_epi8(char(count - 1))), rel);
+}
+
+LUAU_FORCEINLINE SimdBlock simdLower(SimdBlock block)
+{
+    return _mm_or_si128(block, _mm_set1_epi8(' '));
+}
+
+LUAU_FORCEINLINE uint32_t simdMask(SimdBlock block)
+{
+    return uint32_t(_mm_movemask_epi8(block));
+}
+#else
+typedef uint8x16_t SimdBlock;
+
+LUAU_FORCEINLINE SimdBlock simdLoad(const char* data)
+{
+    return vld1q_u8(reinterpret_cast<const uint8_t*>(data));
+}
+
+LUAU_FORCEINLINE SimdBlock simdEq(SimdBlock block, char ch)
+{
+    return vceqq_u8(block, vdupq_n_u8(uint8_t(ch)));
+}
+
+LUAU_FORCEINLINE SimdBlock simdOr(SimdBlock lhs, SimdBlock rhs)
+{
+    return vorrq_u8(lhs, rhs);
+}
+
+// Matches bytes in range [first, first + count)
+LUAU_FORCEINLINE SimdBlock simdInRange(SimdBlock block, char first, char count)
+{
+    return vcleq_u8(vsubq_u8(block, vdupq_n_u8(uint8_t(first))), vdupq_n_u8(uint8_t(count - 1)));
+}
+
+LUAU_FORCEINLINE SimdBlock simdLower(SimdBlock block)
+{
+    return vorrq_u8(block, vdupq_n_u8(' '));
+}
+
+LUAU_FORCEINLINE uint32_t simdMask(SimdBlock block)
+{
+    static const uint8_t kBits[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+
+    uint8x16_t bits = vandq_u8(block, vld1q_u8(kBits));
+    return uint32_t(vaddv_u8(vget_low_u8(bits))) | (uint32_t(vaddv_u8(vget_high_u8(bits))) << 8);
+}
+#endif
+
+LUAU_FORCEINLINE uint32_t simdSpaceMask(SimdBlock block)
+{
+    // ' ' and '\t' '\n' '\v' '\f' '\r' which are consecutive
+    return simdMask(simdOr(simdEq(block, ' '), simdInRange(block, '\t', 5)));
+}
+
+LUAU_FORCEINLINE uint32_t simdNameMask(SimdBlock block)
+{
+    SimdBlock alpha = simdInRange(simdLower(block), 'a', 26);
+    SimdBlock digit = simdInRange(block, '0', 10);
+
+    return simdMask(simdOr(simdOr(alpha, digit), simdEq(block, '_')));
+}
+
+// Returns the number of bytes at the start of [data, data + size) that come before the first byte matched by 'stopMask'
+// Only full blocks are scanned, so the result is a multiple of the block size when no match is found
+template<typename F>
+LUAU_FORCEINLINE unsigned int simdScan(const char* data, size_t size, F stopMask)
+{
+    unsigned int length = 0;
+
+    while (length + kSimdBlockSize <= size)
+    {
+        if (uint32_t mask = stopMask(simdLoad(data + length)))
+            return length + countrz(mask);
+
+        length += kSimdBlockSize;
+    }
+
+    return length;
+}
+#endif
+
 static char unescape(char ch)
 {
     switch (ch)
@@ -348,17 +594,26 @@ static char unescape(char ch)
     }
 }
 
-Lexer::Lexer(const char* buffer, size_t bufferSize, AstNameTable& names)
+Lexer::Lexer(const char* buffer, size_t bufferSize, AstNameTable& names, Position startPosition)
     : buffer(buffer)
     , bufferSize(bufferSize)
     , offset(0)
-    , line(0)
+    , line(startPosition.line)
     , lineOffset(0)
-    , lexeme(Location(Position(0, 0), 0), Lexeme::Eof)
+    , lexeme(Location(startPosition, 0), Lexeme::Eof)
     , names(names)
     , skipComments(false)
     , readNames(true)
 {
+    for (unsigned int i = 0; i < startPosition.line; ++i)
+    {
+        const char* newline = static_cast<const char*>(memchr(buffer + lineOffset, '\n', bufferSize - lineOffset));
+        LUAU_ASSERT(newline);
+
+        lineOffset = unsigned(newline - buffer) + 1;
+    }
+
+    offset = lineOffset + startPosition.column;
 }
 
 void Lexer::setSkipComments(bool skip)
@@ -382,8 +637,7 @@ const Lexeme& Lexer::next(bool skipComments, bool updatePrevLocation)
     do
     {
         // consume whitespace before the token
-        while (isSpace(peekch()))
-            consumeAny();
+        consumeSpaces();
 
         if (updatePrevLocation)
             prevLocation = lexeme.location;
@@ -478,6 +732,51 @@ void Lexer::consumeAny()
     offset++;
 }
 
+void Lexer::consumeSpaces()
+{
+#ifdef LUAU_LEXER_SIMD
+    while (offset + kSimdBlockSize <= bufferSize)
+    {
+        SimdBlock block = simdLoad(buffer + offset);
+
+        // the mask has no bits set past the block, so the run is at most the block size
+        unsigned int run = countrz(~simdSpaceMask(block));
+        uint32_t newlines = simdMask(simdEq(block, '\n')) & ((1u << run) - 1);
+
+        if (newlines)
+        {
+            for (uint32_t mask = newlines; mask; mask &= mask - 1)
+                line++;
+
+            lineOffset = offset + (31 - countlz(newlines)) + 1;
+        }
+
+        offset += run;
+
+        if (run < kSimdBlockSize)
+            return;
+    }
+#endif
+
+    while (isSpace(peekch()))
+        consumeAny();
+}
+
+void Lexer::consumeRun(unsigned int length)
+{
+    LUAU_ASSERT(offset + length <= bufferSize);
+
+    const char* end = buffer + offset + length;
+
+    for (const char* ch = buffer + offset; (ch = static_cast<const char*>(memchr(ch, '\n', end - ch))) != nullptr; ++ch)
+    {
+        line++;
+        lineOffset = unsigned(ch - buffer) + 1;
+    }
+
+    offset += length;
+}
+
 Lexeme Lexer::readCommentBody()
 {
     Position start = position();
@@ -499,6 +798,12 @@ Lexeme Lexer::readCommentBody()
     }
 
     // fall back to single-line comment
+#ifdef LUAU_LEXER_SIMD
+    offset += simdScan(buffer + offset, bufferSize - offset, [](SimdBlock block) {
+        return simdMask(simdOr(simdOr(simdEq(block, '\r'), simdEq(block, '\n')), simdEq(block, 0)));
+    });
+#endif
+
     while (peekch() != 0 && peekch() != '\r' && !isNewline(peekch()))
         consume();
 
@@ -553,6 +858,19 @@ Lexeme Lexer::readLongString(const Position& start, int sep, Lexeme::Type ok, Le
         }
         else
         {
+#ifdef LUAU_LEXER_SIMD
+            // skip ahead to the next ] that could close the string
+            unsigned int length = simdScan(buffer + offset, bufferSize - offset, [](SimdBlock block) {
+                return simdMask(simdOr(simdEq(block, ']'), simdEq(block, 0)));
+            });
+
+            if (length)
+            {
+                consumeRun(length);
+                continue;
+            }
+#endif
+
             consumeAny();
         }
     }
@@ -577,8 +895,7 @@ void Lexer::readBackslashInString()
 
     case 'z':
         consume();
-        while (isSpace(peekch()))
-            consumeAny();
+        consumeSpaces();
         break;
 
     default:
@@ -611,6 +928,14 @@ Lexeme Lexer::readQuotedString()
 
         default:
             consume();
+
+#ifdef LUAU_LEXER_SIMD
+            offset += simdScan(buffer + offset, bufferSize - offset, [delimiter](SimdBlock block) {
+                SimdBlock special = simdOr(simdEq(block, delimiter), simdEq(block, '\\'));
+                SimdBlock broken = simdOr(simdOr(simdEq(block, '\r'), simdEq(block, '\n')), simdEq(block, 0));
+                return simdMask(simdOr(special, broken));
+            });
+#endif
         }
     }
 
@@ -674,6 +999,14 @@ Lexeme Lexer::readInterpolatedStringSection(Position start, Lexeme::Type formatT
 
         default:
             consume();
+
+#ifdef LUAU_LEXER_SIMD
+            offset += simdScan(buffer + offset, bufferSize - offset, [](SimdBlock block) {
+                SimdBlock special = simdOr(simdOr(simdEq(block, '`'), simdEq(block, '\\')), simdEq(block, '{'));
+                SimdBlock broken = simdOr(simdOr(simdEq(block, '\r'), simdEq(block, '\n')), simdEq(block, 0));
+                return simdMask(simdOr(special, broken));
+            });
+#endif
         }
     }
 
@@ -714,9 +1047,16 @@ std::pair<AstName, Lexeme::Type> Lexer::readName()
 
     unsigned int startOffset = offset;
 
-    do
+    consume();
+
+#ifdef LUAU_LEXER_SIMD
+    offset += simdScan(buffer + offset, bufferSize - offset, [](SimdBlock block) {
+        return ~simdNameMask(block) & 0xffff;
+    });
+#endif
+
+    while (isAlpha(peekch()) || isDigit(peekch()) || peekch() == '_')
         consume();
-    while (isAlpha(peekch()) || isDigit(peekch()) || peekch() == '_');
 
     return readNames ? names.getOrAddWithType(&buffer[startOffset], offset - startOffset)
                      : names.getWithType(&buffer[startOffset], offset - startOffset);
@@ -2,6 +2,7 @@
 #include "Luau/Parser.h"
 
 #include "Luau/Common.h"
+#include "Luau/NumberParse.h"
 #include "Luau/TimeTrace.h"
 
 #include <algorithm>
@@ -163,9 +164,10 @@ ParseResult Parser::parse(const char* buffer, size_t bufferSize, AstNameTable& n
     }
 }
 
-Parser::Parser(const char* buffer, size_t bufferSize, AstNameTable& names, Allocator& allocator, const ParseOptions& options)
+Parser::Parser(
+    const char* buffer, size_t bufferSize, AstNameTable& names, Allocator& allocator, const ParseOptions& options, Position startPosition)
     : options(options)
-    , lexer(buffer, bufferSize, names)
+    , lexer(buffer, bufferSize, names, startPosition)
     , allocator(allocator)
     , recursionCounter(0)
     , endMismatchSuspect(Lexeme(Location(), Lexeme::Eof))
@@ -237,6 +239,534 @@ static bool isStatLast(AstStat* stat)
     return stat->is<AstStatBreak>() || stat->is<AstStatContinue>() || stat->is<AstStatReturn>();
 }
 
+// Moves the nodes of a statement that follows an edit of the source text to their new locations
+class ShiftLocationsVisitor : public AstVisitor
+{
+public:
+    explicit ShiftLocationsVisitor(const ParseEdit& edit)
+        : start(edit.range.begin)
+        , oldEnd(edit.range.end)
+        , newEnd(edit.newEnd)
+    {
+    }
+
+    bool visit(AstNode* node) override
+    {
+        shift(node->location);
+        return true;
+    }
+
+    bool visit(AstType* node) override
+    {
+        return visit(static_cast<AstNode*>(node));
+    }
+
+    bool visit(AstTypePack* node) override
+    {
+        return visit(static_cast<AstNode*>(node));
+    }
+
+    bool visit(AstExprCall* node) override
+    {
+        shift(node->argLocation);
+        return visit(static_cast<AstNode*>(node));
+    }
+
+    bool visit(AstExprIndexName* node) override
+    {
+        shift(node->indexLocation);
+        node->opPosition.shift(start, oldEnd, newEnd);
+        return visit(static_cast<AstNode*>(node));
+    }
+
+    bool visit(AstExprFunction* node) override
+    {
+        shift(node->generics);
+        shift(node->genericPacks);
+
+        if (node->self)
+            shift(node->self->location);
+
+        for (AstLocal* arg : node->args)
+            shift(arg->location);
+
+        shift(node->varargLocation);
+        shift(node->argLocation);
+        return visit(static_cast<AstNode*>(node));
+    }
+
+    bool visit(AstStatIf* node) override
+    {
+        shift(node->thenLocation);
+        shift(node->elseLocation);
+        return visit(static_cast<AstNode*>(node));
+    }
+
+    bool visit(AstStatWhile* node) override
+    {
+        shift(node->doLocation);
+        return visit(static_cast<AstNode*>(node));
+    }
+
+    bool visit(AstStatLocal* node) override
+    {
+        for (AstLocal* var : node->vars)
+            shift(var->location);
+
+        shift(node->equalsSignLocation);
+        return visit(static_cast<AstNode*>(node));
+    }
+
+    bool visit(AstStatFor* node) override
+    {
+        shift(node->var->location);
+        shift(node->doLocation);
+        return visit(static_cast<AstNode*>(node));
+    }
+
+    bool visit(AstStatForIn* node) override
+    {
+        for (AstLocal* var : node->vars)
+            shift(var->location);
+
+        shift(node->inLocation);
+        shift(node->doLocation);
+        return visit(static_cast<AstNode*>(node));
+    }
+
+    bool visit(AstStatLocalFunction* node) override
+    {
+        shift(node->name->location);
+        return visit(static_cast<AstNode*>(node));
+    }
+
+    bool visit(AstStatTypeAlias* node) override
+    {
+        shift(node->nameLocation);
+        shift(node->generics);
+        shift(node->genericPacks);
+        return visit(static_cast<AstNode*>(node));
+    }
+
+    bool visit(AstStatDeclareFunction* node) override
+    {
+        shift(node->generics);
+        shift(node->genericPacks);
+
+        for (size_t i = 0; i < node->paramNames.size; ++i)
+            shift(node->paramNames.data[i].second);
+
+        return visit(static_cast<AstNode*>(node));
+    }
+
+    bool visit(AstStatDeclareClass* node) override
+    {
+        if (node->indexer)
+            shift(*node->indexer);
+
+        return visit(static_cast<AstNode*>(node));
+    }
+
+    bool visit(AstTypeReference* node) override
+    {
+        shift(node->prefixLocation);
+        shift(node->nameLocation);
+        return visit(static_cast<AstNode*>(node));
+    }
+
+    bool visit(AstTypeTable* node) override
+    {
+        for (size_t i = 0; i < node->props.size; ++i)
+        {
+            shift(node->props.data[i].location);
+            shift(node->props.data[i].accessLocation);
+        }
+
+        if (node->indexer)
+            shift(*node->indexer);
+
+        return visit(static_cast<AstNode*>(node));
+    }
+
+    bool visit(AstTypeFunction* node) override
+    {
+        shift(node->generics);
+        shift(node->genericPacks);
+
+        for (size_t i = 0; i < node->argNames.size; ++i)
+        {
+            if (node->argNames.data[i])
+                shift(node->argNames.data[i]->second);
+        }
+
+        return visit(static_cast<AstNode*>(node));
+    }
+
+    void shift(Location& location)
+    {
+        location.shift(start, oldEnd, newEnd);
+    }
+
+    void shift(std::optional<Location>& location)
+    {
+        if (location)
+            shift(*location);
+    }
+
+    void shift(AstTableIndexer& indexer)
+    {
+        shift(indexer.location);
+        shift(indexer.accessLocation);
+    }
+
+    template<typename T>
+    void shift(AstArray<T>& generics)
+    {
+        for (size_t i = 0; i < generics.size; ++i)
+            shift(generics.data[i].location);
+    }
+
+private:
+    Position start;
+    Position oldEnd;
+    Position newEnd;
+};
+
+// Makes the statements parsed again after an edit refer to the top-level locals they replace
+class RemapLocalsVisitor : public AstVisitor
+{
+public:
+    DenseHashMap<AstLocal*, AstLocal*> locals{nullptr};
+
+    bool visit(AstType* node) override
+    {
+        return true;
+    }
+
+    bool visit(AstTypePack* node) override
+    {
+        return true;
+    }
+
+    bool visit(AstExprLocal* node) override
+    {
+        remap(node->local);
+        return true;
+    }
+
+    bool visit(AstExprFunction* node) override
+    {
+        if (node->self)
+            declare(node->self);
+
+        for (AstLocal* arg : node->args)
+            declare(arg);
+
+        return true;
+    }
+
+    bool visit(AstStatLocal* node) override
+    {
+        for (size_t i = 0; i < node->vars.size; ++i)
+        {
+            remap(node->vars.data[i]);
+            declare(node->vars.data[i]);
+        }
+
+        return true;
+    }
+
+    bool visit(AstStatFor* node) override
+    {
+        declare(node->var);
+        return true;
+    }
+
+    bool visit(AstStatForIn* node) override
+    {
+        for (AstLocal* var : node->vars)
+            declare(var);
+
+        return true;
+    }
+
+    bool visit(AstStatLocalFunction* node) override
+    {
+        remap(node->name);
+        declare(node->name);
+        return true;
+    }
+
+    void remap(AstLocal*& local)
+    {
+        if (AstLocal** replacement = locals.find(local))
+            local = *replacement;
+    }
+
+    void declare(AstLocal* local)
+    {
+        if (local->shadow)
+            remap(local->shadow);
+    }
+};
+
+// Locals declared by a top-level statement, which stay in scope for the statements that follow it
+static void getTopLevelLocals(AstStat* stat, std::vector<AstLocal*>& result)
+{
+    if (AstStatLocal* local = stat->as<AstStatLocal>())
+    {
+        for (AstLocal* var : local->vars)
+            result.push_back(var);
+    }
+    else if (AstStatLocalFunction* function = stat->as<AstStatLocalFunction>())
+    {
+        result.push_back(function->name);
+    }
+    else if (AstStatError* error = stat->as<AstStatError>())
+    {
+        for (AstStat* inner : error->statements)
+            getTopLevelLocals(inner, result);
+    }
+}
+
+static bool hasErrorAt(const std::vector<ParseError>& errors, const Position& position)
+{
+    for (const ParseError& error : errors)
+    {
+        if (error.getLocation().begin == position)
+            return true;
+    }
+
+    return false;
+}
+
+static bool hasErrorAfter(const std::vector<ParseError>& errors, const Position& position)
+{
+    for (const ParseError& error : errors)
+    {
+        if (error.getLocation().begin >= position)
+            return true;
+    }
+
+    return false;
+}
+
+ParseResult Parser::parseIncremental(const char* buffer, size_t bufferSize, AstNameTable& names, Allocator& allocator, ParseResult& previous,
+    const ParseEdit& edit, ParseOptions options)
+{
+    LUAU_TIMETRACE_SCOPE("Parser::parseIncremental", "Parser");
+
+    if (!previous.root)
+        return parse(buffer, bufferSize, names, allocator, options);
+
+    AstArray<AstStat*> body = previous.root->body;
+
+    // statements that end before the edit are reused, except for the last one which might continue into the edited text
+    // a statement also has to be parsed again if an error was reported at its start, which could have come from the statement before it
+    size_t prefix = 0;
+
+    while (prefix < body.size && body.data[prefix]->location.end < edit.range.begin)
+        prefix++;
+
+    if (prefix > 0)
+        prefix--;
+
+    while (prefix > 0 && hasErrorAt(previous.errors, body.data[prefix]->location.begin))
+        prefix--;
+
+    if (prefix == 0)
+        return parse(buffer, bufferSize, names, allocator, options);
+
+    Position restart = body.data[prefix]->location.begin;
+
+    Parser p(buffer, bufferSize, names, allocator, options, restart);
+
+    // the parser continues in the scope of the reused statements
+    std::vector<AstLocal*> prefixLocals;
+
+    for (size_t i = 0; i < prefix; ++i)
+        getTopLevelLocals(body.data[i], prefixLocals);
+
+    for (AstLocal* local : prefixLocals)
+    {
+        p.localMap[local->name] = local;
+        p.localStack.push_back(local);
+    }
+
+    for (const ParseError& error : previous.errors)
+    {
+        if (error.getLocation().begin < restart)
+            p.parseErrors.push_back(error);
+    }
+
+    std::vector<AstStat*> stats(body.data, body.data + prefix);
+
+    // statements after the edit are reused as soon as the parser reaches the start of one of them in the same state as before
+    // error nodes refer to the errors by index and error messages can mention line numbers, so only statements without errors are reused
+    size_t suffix = prefix + 1;
+
+    while (suffix < body.size && body.data[suffix]->location.begin < edit.range.end)
+        suffix++;
+
+    bool resynced = false;
+    std::vector<AstLocal*> oldLocals;
+    std::vector<AstLocal*> newLocals;
+
+    try
+    {
+        while (!p.blockFollow(p.lexer.current()))
+        {
+            unsigned int oldRecursionCount = p.recursionCounter;
+
+            p.incrementRecursionCounter("block");
+
+            AstStat* stat = p.parseStat();
+
+            p.recursionCounter = oldRecursionCount;
+
+            if (p.lexer.current().type == ';')
+            {
+                p.nextLexeme();
+                stat->hasSemicolon = true;
+            }
+
+            stats.push_back(stat);
+
+            if (isStatLast(stat))
+                break;
+
+            const Position& next = p.lexer.current().location.begin;
+
+            while (suffix < body.size)
+            {
+                Location location = body.data[suffix]->location;
+                location.shift(edit.range.begin, edit.range.end, edit.newEnd);
+
+                if (location.begin < next)
+                {
+                    suffix++;
+                    continue;
+                }
+
+                if (next == location.begin && !hasErrorAfter(previous.errors, body.data[suffix]->location.begin))
+                {
+                    oldLocals.clear();
+                    newLocals.clear();
+
+                    for (size_t i = prefix; i < suffix; ++i)
+                        getTopLevelLocals(body.data[i], oldLocals);
+
+                    for (size_t i = prefix; i < stats.size(); ++i)
+                        getTopLevelLocals(stats[i], newLocals);
+
+                    // the reused statements refer to the locals declared by the statements that were replaced
+                    resynced = oldLocals.size() == newLocals.size() && std::equal(oldLocals.begin(), oldLocals.end(), newLocals.begin(),
+                                                                          [](AstLocal* lhs, AstLocal* rhs) {
+                                                                              return lhs->name == rhs->name;
+                                                                          });
+                }
+
+                break;
+            }
+
+            if (resynced)
+                break;
+        }
+
+        if (!resynced && p.lexer.current().type != Lexeme::Eof)
+            p.expectAndConsumeFail(Lexeme::Eof, nullptr);
+    }
+    catch (ParseError&)
+    {
+        return parse(buffer, bufferSize, names, allocator, options);
+    }
+
+    std::vector<HotComment> hotcomments;
+    std::vector<Comment> commentLocations;
+
+    for (const HotComment& hc : previous.hotcomments)
+    {
+        if (hc.location.begin < restart)
+            hotcomments.push_back(hc);
+    }
+
+    for (const Comment& comment : previous.commentLocations)
+    {
+        if (comment.location.begin < restart)
+            commentLocations.push_back(comment);
+    }
+
+    hotcomments.insert(hotcomments.end(), p.hotcomments.begin(), p.hotcomments.end());
+    commentLocations.insert(commentLocations.end(), p.commentLocations.begin(), p.commentLocations.end());
+
+    Location rootLocation = previous.root->location;
+    size_t lines = 0;
+
+    if (resynced)
+    {
+        Position reused = body.data[suffix]->location.begin;
+
+        RemapLocalsVisitor remapLocals;
+
+        for (size_t i = 0; i < oldLocals.size(); ++i)
+        {
+            remapLocals.locals[newLocals[i]] = oldLocals[i];
+            *oldLocals[i] = *newLocals[i];
+        }
+
+        for (AstLocal* local : oldLocals)
+        {
+            if (local->shadow)
+                remapLocals.remap(local->shadow);
+        }
+
+        for (size_t i = prefix; i < stats.size(); ++i)
+            stats[i]->visit(&remapLocals);
+
+        ShiftLocationsVisitor shiftLocations(edit);
+
+        for (size_t i = suffix; i < body.size; ++i)
+        {
+            body.data[i]->visit(&shiftLocations);
+            stats.push_back(body.data[i]);
+        }
+
+        for (const HotComment& hc : previous.hotcomments)
+        {
+            if (hc.location.begin >= reused)
+            {
+                hotcomments.push_back(hc);
+                shiftLocations.shift(hotcomments.back().location);
+            }
+        }
+
+        for (const Comment& comment : previous.commentLocations)
+        {
+            if (comment.location.begin >= reused)
+            {
+                commentLocations.push_back(comment);
+                shiftLocations.shift(commentLocations.back().location);
+            }
+        }
+
+        shiftLocations.shift(rootLocation);
+        lines = previous.lines + edit.newEnd.line - edit.range.end.line;
+    }
+    else
+    {
+        rootLocation.end = p.lexer.current().location.begin;
+        lines = p.lexer.current().location.end.line + (bufferSize > 0 && buffer[bufferSize - 1] != '\n');
+    }
+
+    // the full parse would have stopped at the error limit
+    if (p.parseErrors.size() >= unsigned(FInt::LuauParseErrorLimit))
+        return parse(buffer, bufferSize, names, allocator, options);
+
+    AstStatBlock* root = allocator.alloc<AstStatBlock>(rootLocation, p.copy(stats.data(), stats.size()));
+
+    return ParseResult{root, lines, std::move(hotcomments), std::move(p.parseErrors), std::move(commentLocations)};
+}
+
 AstStatBlock* Parser::parseBlockNoScope()
 {
     TempVector<AstStat*> body(scratchStat);
@@ -2189,6 +2719,11 @@ static ConstantNumberParseResult parseDouble(double& result, const char* data)
     if (data[0] == '0' && (data[1] == 'x' || data[1] == 'X') && data[2])
         return parseInteger(result, data, 16); // pass in '0x' prefix, it's handled by 'strtoull'
 
+    // most literals can be converted exactly without going through strtod
+    const char* fastend = parseDecimalFast(data, result);
+    if (fastend && *fastend == 0)
+        return ConstantNumberParseResult::Ok;
+
     char* end = nullptr;
     double value = strtod(data, &end);
 
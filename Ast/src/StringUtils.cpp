@@ -235,11 +235,8 @@ bool isIdentifier(std::string_view s)
     return (s.find_first_not_of("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ01234567890_") == std::string::npos);
 }
 
-std::string escape(std::string_view s, bool escapeForInterpString)
+void escapeAppend(std::string& r, std::string_view s, bool escapeForInterpString)
 {
-    std::string r;
-    r.reserve(s.size() + 50); // arbitrary number to guess how many characters we'll be inserting
-
     for (uint8_t c : s)
     {
         if (c >= ' ' && c != '\\' && c != '\'' && c != '\"' && c != '`' && c != '{')
@@ -291,6 +288,14 @@ std::string escape(std::string_view s, bool escapeForInterpString)
             }
         }
     }
+}
+
+std::string escape(std::string_view s, bool escapeForInterpString)
+{
+    std::string r;
+    r.reserve(s.size() + 50); // arbitrary number to guess how many characters we'll be inserting
+
+    escapeAppend(r, s, escapeForInterpString);
 
     return r;
 }
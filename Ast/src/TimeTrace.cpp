@@ -3,6 +3,7 @@
 
 #include "Luau/StringUtils.h"
 
+#include <algorithm>
 #include <mutex>
 #include <string>
 
@@ -26,6 +27,8 @@
 #include <time.h>
 
 LUAU_FASTFLAGVARIABLE(DebugLuauTimeTracing, false)
+LUAU_FASTINTVARIABLE(LuauTimeTraceRingSize, 0)
+LUAU_FASTINTVARIABLE(LuauTimeTraceTailSampleRate, 0)
 namespace Luau
 {
 namespace TimeTrace
@@ -140,23 +143,12 @@ void releaseThread(GlobalContext& context, ThreadContext* threadContext)
         context.threads.erase(it);
 }
 
-void flushEvents(GlobalContext& context, uint32_t threadId, const std::vector<Event>& events, const std::vector<char>& data)
+// When a file is provided, formatted events are written to it in chunks; otherwise they are all accumulated in 'temp'
+static void formatEvents(
+    std::string& temp, GlobalContext& context, uint32_t threadId, const std::vector<Event>& events, const std::vector<char>& data, FILE* file)
 {
-    std::scoped_lock lock(context.mutex);
-
-    if (!context.traceFile)
-    {
-        context.traceFile = fopen("trace.json", "w");
-
-        if (!context.traceFile)
-            return;
-
-        fprintf(context.traceFile, "[\n");
-    }
-
-    std::string temp;
     const unsigned tempReserve = 64 * 1024;
-    temp.reserve(tempReserve);
+    temp.reserve(temp.size() + tempReserve);
 
     const char* rawData = data.data();
 
@@ -226,7 +218,7 @@ void flushEvents(GlobalContext& context, uint32_t threadId, const std::vector<Ev
         }
 
         // Don't want to hit the string capacity and reallocate
-        if (temp.size() > tempReserve - 1024)
+        if (file && temp.size() > tempReserve - 1024)
         {
             fwrite(temp.data(), 1, temp.size(), context.traceFile);
             temp.clear();
@@ -243,11 +235,128 @@ void flushEvents(GlobalContext& context, uint32_t threadId, const std::vector<Ev
         formatAppend(temp, "},\n");
         unfinishedEnter = false;
     }
+}
+
+void flushEvents(GlobalContext& context, uint32_t threadId, const std::vector<Event>& events, const std::vector<char>& data)
+{
+    std::scoped_lock lock(context.mutex);
+
+    if (!context.traceFile)
+    {
+        context.traceFile = fopen("trace.json", "w");
+
+        if (!context.traceFile)
+            return;
+
+        fprintf(context.traceFile, "[\n");
+    }
+
+    std::string temp;
+    formatEvents(temp, context, threadId, events, data, context.traceFile);
 
     fwrite(temp.data(), 1, temp.size(), context.traceFile);
     fflush(context.traceFile);
 }
 
+void recordEvent(RingBuffer& ring, const Event& ev, const char* str)
+{
+    std::scoped_lock lock(ring.mutex);
+
+    size_t capacity = size_t(FInt::LuauTimeTraceRingSize);
+
+    if (capacity == 0)
+        return;
+
+    // Buffer size change discards the previous events
+    if (ring.events.size() != capacity)
+    {
+        ring.events.assign(capacity, Event{});
+        ring.data.assign(capacity, std::string());
+        ring.head = 0;
+        ring.size = 0;
+    }
+
+    ring.events[ring.head] = ev;
+
+    if (str)
+        ring.data[ring.head] = str;
+
+    ring.head = (ring.head + 1) % capacity;
+    ring.size = std::min(ring.size + 1, capacity);
+}
+
+// Copies ring buffer contents in the order they were recorded; events that lost their scope entry to an overwrite are dropped
+static void collectEvents(RingBuffer& ring, std::vector<Event>& events, std::vector<char>& data)
+{
+    std::scoped_lock lock(ring.mutex);
+
+    size_t capacity = ring.events.size();
+    size_t depth = 0;
+    bool orphanArgs = true;
+
+    for (size_t i = 0; i < ring.size; ++i)
+    {
+        size_t slot = (ring.head + capacity - ring.size + i) % capacity;
+        const Event& ev = ring.events[slot];
+
+        switch (ev.type)
+        {
+        case EventType::Enter:
+            depth++;
+            orphanArgs = false;
+            events.push_back(ev);
+            break;
+        case EventType::Leave:
+            if (depth == 0)
+                continue;
+
+            depth--;
+            orphanArgs = true;
+            events.push_back(ev);
+            break;
+        case EventType::ArgName:
+        case EventType::ArgValue:
+        {
+            if (orphanArgs)
+                continue;
+
+            const std::string& str = ring.data[slot];
+            events.push_back({ev.type, 0, {uint32_t(data.size())}});
+            data.insert(data.end(), str.c_str(), str.c_str() + str.size() + 1);
+        }
+        break;
+        }
+    }
+}
+
+std::string exportTrace()
+{
+    GlobalContext& context = *getGlobalContext();
+
+    std::scoped_lock lock(context.mutex);
+
+    std::string result = "{\"traceEvents\": [\n";
+
+    std::vector<Event> events;
+    std::vector<char> data;
+
+    for (ThreadContext* thread : context.threads)
+    {
+        events.clear();
+        data.clear();
+
+        collectEvents(thread->ring, events, data);
+        formatEvents(result, context, thread->threadId, events, data, nullptr);
+    }
+
+    // Drop the separator after the last event
+    if (result.size() > 2 && result[result.size() - 2] == ',')
+        result.erase(result.size() - 2, 1);
+
+    result += "]}\n";
+    return result;
+}
+
 ThreadContext& getThreadContext()
 {
     thread_local ThreadContext context;
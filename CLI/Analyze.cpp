@@ -3,17 +3,22 @@
 #include "Luau/TypeInfer.h"
 #include "Luau/BuiltinDefinitions.h"
 #include "Luau/Frontend.h"
+#include "Luau/JsonEmitter.h"
+#include "Luau/ModuleInterfaceCache.h"
 #include "Luau/TypeAttach.h"
 #include "Luau/Transpiler.h"
 
 #include "FileUtils.h"
 #include "Flags.h"
 
+#include <algorithm>
 #include <condition_variable>
 #include <functional>
 #include <mutex>
 #include <queue>
+#include <random>
 #include <thread>
+#include <unordered_map>
 #include <utility>
 #include <fstream>
 
@@ -21,6 +26,16 @@
 #include <valgrind/callgrind.h>
 #endif
 
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
 LUAU_FASTFLAG(DebugLuauTimeTracing)
 LUAU_FASTFLAG(DebugLuauLogSolverToJsonFile)
 
@@ -73,29 +88,22 @@ static void reportWarning(ReportFormat format, const char* name, const Luau::Lin
     report(format, name, warning.location, Luau::LintWarning::getName(warning.code), warning.text.c_str());
 }
 
-static bool reportModuleResult(Luau::Frontend& frontend, const Luau::ModuleName& name, ReportFormat format, bool annotate)
+static bool reportModuleResult(
+    Luau::Frontend& frontend, const Luau::ModuleName& name, const Luau::CheckResult& cr, ReportFormat format, bool annotate)
 {
-    std::optional<Luau::CheckResult> cr = frontend.getCheckResult(name, false);
-
-    if (!cr)
-    {
-        fprintf(stderr, "Failed to find result for %s\n", name.c_str());
-        return false;
-    }
-
     if (!frontend.getSourceModule(name))
     {
         fprintf(stderr, "Error opening %s\n", name.c_str());
         return false;
     }
 
-    for (auto& error : cr->errors)
+    for (auto& error : cr.errors)
         reportError(frontend, format, error);
 
     std::string humanReadableName = frontend.fileResolver->getHumanReadableModuleName(name);
-    for (auto& error : cr->lintResult.errors)
+    for (auto& error : cr.lintResult.errors)
         reportWarning(format, humanReadableName.c_str(), error);
-    for (auto& warning : cr->lintResult.warnings)
+    for (auto& warning : cr.lintResult.warnings)
         reportWarning(format, humanReadableName.c_str(), warning);
 
     if (annotate)
@@ -110,7 +118,97 @@ static bool reportModuleResult(Luau::Frontend& frontend, const Luau::ModuleName&
         printf("%s", annotated.c_str());
     }
 
-    return cr->errors.empty() && cr->lintResult.errors.empty();
+    return cr.errors.empty() && cr.lintResult.errors.empty();
+}
+
+// returns the peak resident memory of the process in bytes
+static size_t getPeakMemory()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters = {};
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return counters.PeakWorkingSetSize;
+
+    return 0;
+#else
+    struct rusage usage = {};
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+
+#ifdef __APPLE__
+    return size_t(usage.ru_maxrss);
+#else
+    return size_t(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+static void reportStats(const Luau::Frontend::Stats& stats)
+{
+    printf("Stats: files %zu\n", stats.files);
+    printf("Stats: lines %zu\n", stats.lines);
+    printf("Stats: read %.6f\n", stats.timeRead);
+    printf("Stats: parse %.6f\n", stats.timeParse);
+    printf("Stats: check %.6f\n", stats.timeCheck);
+    printf("Stats: lint %.6f\n", stats.timeLint);
+    printf("Stats: peakmem %zu\n", getPeakMemory());
+}
+
+static bool writeStatsJson(const std::string& path, const Luau::Frontend::Stats& stats)
+{
+    using namespace Luau::Json;
+
+    std::vector<const Luau::Frontend::ModuleStats*> modules;
+    for (const Luau::Frontend::ModuleStats& module : stats.modules)
+        modules.push_back(&module);
+
+    // modules are recorded in the order in which they complete, sorting keeps the output stable between runs
+    std::sort(modules.begin(), modules.end(), [](auto lhs, auto rhs) {
+        return lhs->name < rhs->name;
+    });
+
+    JsonEmitter emitter;
+    ObjectEmitter o = emitter.writeObject();
+    o.writePair("files", stats.files);
+    o.writePair("lines", stats.lines);
+    o.writePair("timeRead", stats.timeRead);
+    o.writePair("timeParse", stats.timeParse);
+    o.writePair("timeCheck", stats.timeCheck);
+    o.writePair("timeLint", stats.timeLint);
+    o.writePair("peakMemory", getPeakMemory());
+
+    emitter.writeComma();
+    write(emitter, "modules");
+    emitter.writeRaw(':');
+
+    ArrayEmitter a = emitter.writeArray();
+
+    for (const Luau::Frontend::ModuleStats* module : modules)
+    {
+        emitter.writeComma();
+
+        ObjectEmitter m = emitter.writeObject();
+        m.writePair("name", module->name);
+        m.writePair("timeCheck", module->timeCheck);
+        m.writePair("timeConstraintGeneration", module->timeConstraintGeneration);
+        m.writePair("timeSolve", module->timeSolve);
+        m.writePair("timeTypeCheck", module->timeTypeCheck);
+        m.writePair("timeLint", module->timeLint);
+        m.writePair("types", module->types);
+        m.writePair("typePacks", module->typePacks);
+        m.writePair("interfaceTypes", module->interfaceTypes);
+        m.writePair("interfaceTypePacks", module->interfaceTypePacks);
+        m.writePair("arenaBytes", module->arenaBytes);
+        m.finish();
+    }
+
+    a.finish();
+    o.finish();
+
+    std::ofstream os(path);
+    os << emitter.str() << std::endl;
+
+    return bool(os);
 }
 
 static void displayHelp(const char* argv0)
@@ -120,12 +218,18 @@ static void displayHelp(const char* argv0)
     printf("Available modes:\n");
     printf("  omitted: typecheck and lint input files\n");
     printf("  --annotate: typecheck input files and output source with type annotations\n");
+    printf("  --lint-only: lint input files, typechecking them only when an enabled lint needs type information\n");
     printf("\n");
     printf("Available options:\n");
     printf("  --formatter=plain: report analysis errors in Luacheck-compatible format\n");
     printf("  --formatter=gnu: report analysis errors in GNU-compatible format\n");
     printf("  --mode=strict: default to strict mode when typechecking\n");
+    printf("  --cache=<dir>: store interfaces of modules without errors in the directory and skip checking unchanged modules\n");
+    printf("  --shared-cache=<dir>: also use interfaces from a directory shared between machines, copying them into --cache\n");
+    printf("  --shared-cache-readonly: only read from --shared-cache\n");
     printf("  --timetrace: record compiler time tracing information into trace.json\n");
+    printf("  --stats: print time spent in each analysis phase and peak memory use after all files are checked\n");
+    printf("  --stats=<file>: write the same information as JSON to the file, along with phase times and type arena sizes of each module\n");
 }
 
 static int assertionHandler(const char* expr, const char* file, int line, const char* function)
@@ -139,25 +243,24 @@ struct CliFileResolver : Luau::FileResolver
 {
     std::optional<Luau::SourceCode> readSource(const Luau::ModuleName& name) override
     {
-        Luau::SourceCode::Type sourceType;
-        std::optional<std::string> source = std::nullopt;
-
         // If the module name is "-", then read source from stdin
         if (name == "-")
         {
-            source = readStdin();
-            sourceType = Luau::SourceCode::Script;
-        }
-        else
-        {
-            source = readFile(name);
-            sourceType = Luau::SourceCode::Module;
+            std::optional<std::string> source = readStdin();
+
+            if (!source)
+                return std::nullopt;
+
+            return Luau::SourceCode{*source, Luau::SourceCode::Script};
         }
 
-        if (!source)
+        // Files are mapped into memory and parsed in place instead of being copied
+        std::shared_ptr<const std::string_view> view = mapFile(name);
+
+        if (!view)
             return std::nullopt;
 
-        return Luau::SourceCode{*source, sourceType};
+        return Luau::SourceCode{std::string(), Luau::SourceCode::Module, std::move(view)};
     }
 
     std::optional<Luau::ModuleInfo> resolveModule(const Luau::ModuleInfo* context, Luau::AstExpr* node) override
@@ -165,7 +268,7 @@ struct CliFileResolver : Luau::FileResolver
         if (Luau::AstExprConstantString* expr = node->as<Luau::AstExprConstantString>())
         {
             Luau::ModuleName name = std::string(expr->value.data, expr->value.size) + ".luau";
-            if (!readFile(name))
+            if (!mapFile(name))
             {
                 // fall back to .lua if a module with .luau doesn't exist
                 name = std::string(expr->value.data, expr->value.size) + ".lua";
@@ -185,46 +288,98 @@ struct CliFileResolver : Luau::FileResolver
     }
 };
 
+struct CliInterfaceCache : Luau::ModuleInterfaceCache
+{
+    explicit CliInterfaceCache(const std::string& directory)
+        : directory(directory)
+    {
+    }
+
+    std::optional<std::string> readInterface(const std::string& key) override
+    {
+        return readFile(joinPaths(directory, key + ".luaui"));
+    }
+
+    void writeInterface(const std::string& key, const std::string& data) override
+    {
+        std::string path = joinPaths(directory, key + ".luaui");
+
+        // interface is written under a unique name and renamed so that concurrent runs never observe a partial file
+        char suffix[32];
+        snprintf(suffix, sizeof(suffix), ".%08x.tmp", unsigned(std::random_device()()));
+
+        std::string tempPath = path + suffix;
+
+        FILE* file = fopen(tempPath.c_str(), "wb");
+        if (!file)
+            return;
+
+        bool written = fwrite(data.data(), 1, data.size(), file) == data.size();
+        written &= fclose(file) == 0;
+
+        if (!written || rename(tempPath.c_str(), path.c_str()) != 0)
+            remove(tempPath.c_str());
+    }
+
+    std::string directory;
+};
+
+struct CliConfigFileSource : Luau::ConfigFileSource
+{
+    std::optional<std::string> getParentDirectory(const std::string& directory) const override
+    {
+        return getParentPath(directory);
+    }
+
+    std::optional<std::string> readConfigFile(const std::string& directory) const override
+    {
+        return readFile(joinPaths(directory, Luau::kConfigName));
+    }
+
+    uint64_t getConfigFileVersion(const std::string& directory) const override
+    {
+        // missing files are version 0, so that creating a configuration file is noticed as well
+        return getFileModificationTime(joinPaths(directory, Luau::kConfigName)).value_or(0);
+    }
+};
+
 struct CliConfigResolver : Luau::ConfigResolver
 {
     Luau::Config defaultConfig;
 
-    mutable std::unordered_map<std::string, Luau::Config> configCache;
-    mutable std::vector<std::pair<std::string, std::string>> configErrors;
+    CliConfigFileSource configFileSource;
+    mutable Luau::ConfigCache configCache;
 
     CliConfigResolver(Luau::Mode mode)
+        : configCache(configFileSource, makeDefaultConfig(mode))
     {
         defaultConfig.mode = mode;
     }
 
+    static Luau::Config makeDefaultConfig(Luau::Mode mode)
+    {
+        Luau::Config result;
+        result.mode = mode;
+        return result;
+    }
+
     const Luau::Config& getConfig(const Luau::ModuleName& name) const override
     {
         std::optional<std::string> path = getParentPath(name);
         if (!path)
             return defaultConfig;
 
-        return readConfigRec(*path);
+        return configCache.getConfig(*path);
     }
 
-    const Luau::Config& readConfigRec(const std::string& path) const
+    std::vector<std::pair<std::string, std::string>> getConfigErrors() const
     {
-        auto it = configCache.find(path);
-        if (it != configCache.end())
-            return it->second;
+        std::vector<std::pair<std::string, std::string>> result = configCache.getErrors();
 
-        std::optional<std::string> parent = getParentPath(path);
-        Luau::Config result = parent ? readConfigRec(*parent) : defaultConfig;
+        for (auto& [path, error] : result)
+            path = joinPaths(path, Luau::kConfigName);
 
-        std::string configPath = joinPaths(path, Luau::kConfigName);
-
-        if (std::optional<std::string> contents = readFile(configPath))
-        {
-            std::optional<std::string> error = Luau::parseConfig(*contents, result);
-            if (error)
-                configErrors.push_back({configPath, *error});
-        }
-
-        return configCache[path] = result;
+        return result;
     }
 };
 
@@ -307,8 +462,14 @@ int main(int argc, char** argv)
     ReportFormat format = ReportFormat::Default;
     Luau::Mode mode = Luau::Mode::Nonstrict;
     bool annotate = false;
+    bool lintOnly = false;
+    bool stats = false;
+    std::string statsPath;
     int threadCount = 0;
     std::string basePath = "";
+    std::string cachePath;
+    std::string sharedCachePath;
+    bool sharedCacheReadOnly = false;
 
     for (int i = 1; i < argc; ++i)
     {
@@ -323,14 +484,26 @@ int main(int argc, char** argv)
             mode = Luau::Mode::Strict;
         else if (strcmp(argv[i], "--annotate") == 0)
             annotate = true;
+        else if (strcmp(argv[i], "--lint-only") == 0)
+            lintOnly = true;
         else if (strcmp(argv[i], "--timetrace") == 0)
             FFlag::DebugLuauTimeTracing.value = true;
+        else if (strcmp(argv[i], "--stats") == 0)
+            stats = true;
+        else if (strncmp(argv[i], "--stats=", 8) == 0)
+            statsPath = std::string{argv[i] + 8};
         else if (strncmp(argv[i], "--fflags=", 9) == 0)
             setLuauFlags(argv[i] + 9);
         else if (strncmp(argv[i], "-j", 2) == 0)
             threadCount = int(strtol(argv[i] + 2, nullptr, 10));
         else if (strncmp(argv[i], "--logbase=", 10) == 0)
             basePath = std::string{argv[i] + 10};
+        else if (strncmp(argv[i], "--cache=", 8) == 0)
+            cachePath = std::string{argv[i] + 8};
+        else if (strncmp(argv[i], "--shared-cache=", 15) == 0)
+            sharedCachePath = std::string{argv[i] + 15};
+        else if (strcmp(argv[i], "--shared-cache-readonly") == 0)
+            sharedCacheReadOnly = true;
     }
 
 #if !defined(LUAU_ENABLE_TIME_TRACE)
@@ -344,11 +517,37 @@ int main(int argc, char** argv)
     Luau::FrontendOptions frontendOptions;
     frontendOptions.retainFullTypeGraphs = annotate;
     frontendOptions.runLintChecks = true;
+    frontendOptions.lintOnly = lintOnly && !annotate;
+    frontendOptions.recordModuleStats = !statsPath.empty();
+
+    // results are reported as soon as each module is checked; annotations need full type graphs so they are kept in that case
+    frontendOptions.releaseStreamedResults = !annotate;
 
     CliFileResolver fileResolver;
     CliConfigResolver configResolver(mode);
     Luau::Frontend frontend(&fileResolver, &configResolver, frontendOptions);
 
+    std::optional<CliInterfaceCache> interfaceCache;
+    std::optional<CliInterfaceCache> sharedInterfaceCache;
+    std::optional<Luau::LayeredModuleInterfaceCache> layeredInterfaceCache;
+
+    if (!cachePath.empty())
+        interfaceCache.emplace(cachePath);
+
+    if (!sharedCachePath.empty())
+        sharedInterfaceCache.emplace(sharedCachePath);
+
+    if (sharedInterfaceCache)
+    {
+        // interfaces are written under unique names and renamed into place, so many machines can share the directory
+        layeredInterfaceCache.emplace(interfaceCache ? &*interfaceCache : nullptr, &*sharedInterfaceCache, !sharedCacheReadOnly);
+        frontend.interfaceCache = &*layeredInterfaceCache;
+    }
+    else if (interfaceCache)
+    {
+        frontend.interfaceCache = &*interfaceCache;
+    }
+
     if (FFlag::DebugLuauLogSolverToJsonFile)
     {
         frontend.writeJsonLog = [&basePath](const Luau::ModuleName& moduleName, std::string log) {
@@ -376,10 +575,23 @@ int main(int argc, char** argv)
 
     std::vector<std::string> files = getSourceFiles(argc, argv);
 
+    // results are reported in the order of the input files, so that the output doesn't depend on the order in which modules finish
+    std::unordered_map<std::string, size_t> fileOrder;
+    std::vector<std::string> orderedFiles;
+
     for (const std::string& path : files)
+    {
+        if (fileOrder.try_emplace(path, orderedFiles.size()).second)
+            orderedFiles.push_back(path);
+    }
+
+    for (const std::string& path : orderedFiles)
         frontend.queueModuleCheck(path);
 
-    std::vector<Luau::ModuleName> checkedModules;
+    int failed = 0;
+
+    std::vector<std::optional<Luau::CheckResult>> pendingResults(orderedFiles.size());
+    size_t nextResult = 0;
 
     // If thread count is not set, try to use HW thread count, but with an upper limit
     // When we improve scalability of typechecking, upper limit can be adjusted/removed
@@ -390,9 +602,29 @@ int main(int argc, char** argv)
     {
         TaskScheduler scheduler(threadCount);
 
-        checkedModules = frontend.checkQueuedModules(std::nullopt, [&](std::function<void()> f) {
-            scheduler.push(std::move(f));
-        });
+        frontend.checkQueuedModules(
+            std::nullopt,
+            [&](std::function<void()> f) {
+                scheduler.push(std::move(f));
+            },
+            {},
+            [&](const Luau::ModuleName& name, Luau::CheckResult result) {
+                auto it = fileOrder.find(name);
+
+                if (it == fileOrder.end())
+                {
+                    failed += !reportModuleResult(frontend, name, result, format, annotate);
+                    return;
+                }
+
+                pendingResults[it->second] = std::move(result);
+
+                for (; nextResult < orderedFiles.size() && pendingResults[nextResult]; nextResult++)
+                {
+                    failed += !reportModuleResult(frontend, orderedFiles[nextResult], *pendingResults[nextResult], format, annotate);
+                    pendingResults[nextResult].reset();
+                }
+            });
     }
     catch (const Luau::InternalCompilerError& ice)
     {
@@ -408,19 +640,25 @@ int main(int argc, char** argv)
         return 1;
     }
 
-    int failed = 0;
+    std::vector<std::pair<std::string, std::string>> configErrors = configResolver.getConfigErrors();
 
-    for (const Luau::ModuleName& name : checkedModules)
-        failed += !reportModuleResult(frontend, name, format, annotate);
-
-    if (!configResolver.configErrors.empty())
+    if (!configErrors.empty())
     {
-        failed += int(configResolver.configErrors.size());
+        failed += int(configErrors.size());
 
-        for (const auto& pair : configResolver.configErrors)
+        for (const auto& pair : configErrors)
             fprintf(stderr, "%s: %s\n", pair.first.c_str(), pair.second.c_str());
     }
 
+    if (stats)
+        reportStats(frontend.stats);
+
+    if (!statsPath.empty() && !writeStatsJson(statsPath, frontend.stats))
+    {
+        fprintf(stderr, "Error writing %s\n", statsPath.c_str());
+        failed++;
+    }
+
     if (format == ReportFormat::Luacheck)
         return 0;
     else
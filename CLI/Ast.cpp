@@ -78,7 +78,9 @@ int main(int argc, char** argv)
         fprintf(stderr, "\n");
     }
 
-    printf("%s", Luau::toJson(parseResult.root, parseResult.commentLocations).c_str());
+    Luau::toJson(parseResult.root, parseResult.commentLocations, [](std::string_view chunk) {
+        fwrite(chunk.data(), 1, chunk.size(), stdout);
+    });
 
     return parseResult.errors.size() > 0 ? 1 : 0;
 }
@@ -209,7 +209,28 @@ static void serializeFunctionSummary(const FunctionBytecodeSummary& summary, FIL
             fprintf(fp, ",");
     }
 
-    fprintf(fp, "\n            ]");
+    fprintf(fp, "\n            ],");
+
+    // pairs are sparse, so only the pairs that are present are recorded as [first, second, count]
+    fprintf(fp, "\n            \"pairs\": [");
+
+    bool firstPair = true;
+
+    for (unsigned first = 0; first < opLimit; ++first)
+    {
+        for (unsigned second = 0; second < opLimit; ++second)
+        {
+            unsigned count = summary.getPairCount(uint8_t(first), uint8_t(second));
+
+            if (count == 0)
+                continue;
+
+            fprintf(fp, "%s[%u, %u, %u]", firstPair ? "" : ", ", first, second, count);
+            firstPair = false;
+        }
+    }
+
+    fprintf(fp, "]");
     fprintf(fp, "\n        }");
 }
 
@@ -0,0 +1,279 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#include "BytecodeCache.h"
+
+#include "Luau/Bytecode.h"
+#include "Luau/Common.h"
+#include "Luau/Compiler.h"
+#include "Luau/Hash.h"
+
+#include "FileUtils.h"
+
+#include <map>
+#include <random>
+#include <unordered_map>
+
+#include <stdio.h>
+#include <string.h>
+
+struct CacheKeyHash : Luau::Fnv1aHash
+{
+    void addInt(int64_t v)
+    {
+        addBytes(&v, sizeof(v));
+    }
+
+    // length prefix keeps adjacent strings from aliasing each other
+    void addString(const char* str)
+    {
+        size_t size = str ? strlen(str) : 0;
+        addInt(str ? int64_t(size) : -1);
+        addBytes(str, size);
+    }
+};
+
+template<typename T>
+static uint64_t getFlagsHash()
+{
+    // flag list order depends on static initialization order, so flag hashes are combined in an order-independent way
+    uint64_t result = 0;
+
+    for (Luau::FValue<T>* flag = Luau::FValue<T>::list; flag; flag = flag->next)
+    {
+        CacheKeyHash hash;
+        hash.addString(flag->name);
+        hash.addInt(int64_t(flag->value));
+
+        result += hash.value;
+    }
+
+    return result;
+}
+
+std::string getBytecodeCacheKey(const std::string& source, const Luau::CompileOptions& options)
+{
+    CacheKeyHash hash;
+
+    hash.addInt(LBC_VERSION_TARGET);
+    hash.addInt(LBC_TYPE_VERSION);
+
+    hash.addInt(options.optimizationLevel);
+    hash.addInt(options.debugLevel);
+    hash.addInt(options.coverageLevel);
+    hash.addString(options.vectorLib);
+    hash.addString(options.vectorCtor);
+    hash.addString(options.vectorType);
+
+    if (options.mutableGlobals)
+    {
+        for (const char* const* ptr = options.mutableGlobals; *ptr; ++ptr)
+            hash.addString(*ptr);
+    }
+
+    hash.addString(nullptr);
+
+    if (options.hotFunctions)
+    {
+        for (const int* ptr = options.hotFunctions; *ptr; ++ptr)
+            hash.addInt(*ptr);
+    }
+
+    hash.addInt(options.hotFunctions ? 0 : -1);
+
+    hash.addInt(int64_t(getFlagsHash<bool>()));
+    hash.addInt(int64_t(getFlagsHash<int>()));
+
+    hash.addInt(int64_t(source.size()));
+    hash.addBytes(source.data(), source.size());
+
+    char result[32];
+    snprintf(result, sizeof(result), "%016llx.luauc", (unsigned long long)hash.value);
+    return result;
+}
+
+std::optional<std::string> readCachedBytecode(const std::string& directory, const std::string& key)
+{
+    return readFile(joinPaths(directory, key));
+}
+
+void writeCachedBytecode(const std::string& directory, const std::string& key, const std::string& bytecode)
+{
+    std::string path = joinPaths(directory, key);
+
+    // blob is written under a unique name and renamed so that concurrent compilations never observe a partial file
+    char suffix[32];
+    snprintf(suffix, sizeof(suffix), ".%08x.tmp", unsigned(std::random_device()()));
+
+    std::string tempPath = path + suffix;
+
+    FILE* file = fopen(tempPath.c_str(), "wb");
+    if (!file)
+        return;
+
+    bool written = fwrite(bytecode.data(), 1, bytecode.size(), file) == bytecode.size();
+    written &= fclose(file) == 0;
+
+    // when another process has stored the same blob first, rename can fail on some platforms; the blobs are identical
+    if (!written || rename(tempPath.c_str(), path.c_str()) != 0)
+        remove(tempPath.c_str());
+}
+
+std::string compileCached(const std::string& directory, const std::string& source, const Luau::CompileOptions& options)
+{
+    // folded constants of other modules are not a part of the key
+    if (directory.empty() || options.requireConstantCb)
+        return Luau::compile(source, options);
+
+    std::string key = getBytecodeCacheKey(source, options);
+
+    if (std::optional<std::string> bytecode = readCachedBytecode(directory, key); bytecode && !bytecode->empty())
+        return *bytecode;
+
+    std::string bytecode = Luau::compile(source, options);
+
+    // first byte of the blob is 0 when compilation produced an error message
+    if (!bytecode.empty() && bytecode[0] != 0)
+        writeCachedBytecode(directory, key, bytecode);
+
+    return bytecode;
+}
+
+static const char kBundleMagic[] = "LUAUBNDL";
+static const uint32_t kBundleVersion = 2;
+
+// magic, version, module count
+static const size_t kBundleHeaderSize = 8 + 4 + 4;
+
+// path offset, path size, bytecode offset, bytecode size
+static const size_t kBundleIndexEntrySize = 4 * 4;
+
+static void writeBundleInt(std::string& result, uint32_t value)
+{
+    result.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static uint32_t readBundleInt(const char* data)
+{
+    uint32_t result;
+    memcpy(&result, data, sizeof(result));
+    return result;
+}
+
+bool writeBytecodeBundle(const std::string& path, const BytecodeBundle& bundle)
+{
+    // later modules with the same path replace the earlier ones
+    std::map<std::string_view, std::string_view> modules;
+
+    for (const auto& [name, bytecode] : bundle)
+        modules[name] = bytecode;
+
+    std::string index;
+    std::string blobs;
+    std::unordered_map<std::string_view, uint32_t> blobOffsets;
+
+    size_t blobStart = kBundleHeaderSize + modules.size() * kBundleIndexEntrySize;
+
+    auto addBlob = [&](std::string_view blob) {
+        auto [it, inserted] = blobOffsets.try_emplace(blob, uint32_t(blobStart + blobs.size()));
+
+        if (inserted)
+            blobs.append(blob);
+
+        writeBundleInt(index, it->second);
+        writeBundleInt(index, uint32_t(blob.size()));
+    };
+
+    for (const auto& [name, bytecode] : modules)
+    {
+        addBlob(name);
+        addBlob(bytecode);
+    }
+
+    if (blobStart + blobs.size() > UINT32_MAX)
+        return false;
+
+    std::string data(kBundleMagic, 8);
+    writeBundleInt(data, kBundleVersion);
+    writeBundleInt(data, uint32_t(modules.size()));
+    data += index;
+    data += blobs;
+
+    FILE* file = fopen(path.c_str(), "wb");
+    if (!file)
+        return false;
+
+    bool written = fwrite(data.data(), 1, data.size(), file) == data.size();
+    written &= fclose(file) == 0;
+    return written;
+}
+
+std::optional<BytecodeBundleFile> BytecodeBundleFile::open(const std::string& path)
+{
+    std::shared_ptr<const std::string_view> data = mapFile(path);
+    if (!data || data->size() < kBundleHeaderSize || data->compare(0, 8, kBundleMagic) != 0)
+        return std::nullopt;
+
+    const char* start = data->data();
+
+    if (readBundleInt(start + 8) != kBundleVersion)
+        return std::nullopt;
+
+    size_t count = readBundleInt(start + 12);
+
+    if ((data->size() - kBundleHeaderSize) / kBundleIndexEntrySize < count)
+        return std::nullopt;
+
+    // only the index is validated; blobs are read lazily when the modules are loaded
+    for (size_t i = 0; i < count * 4; i += 2)
+    {
+        size_t offset = readBundleInt(start + kBundleHeaderSize + i * 4);
+        size_t size = readBundleInt(start + kBundleHeaderSize + i * 4 + 4);
+
+        if (offset > data->size() || size > data->size() - offset)
+            return std::nullopt;
+    }
+
+    BytecodeBundleFile result;
+    result.data = std::move(data);
+    result.count = count;
+    return result;
+}
+
+size_t BytecodeBundleFile::size() const
+{
+    return count;
+}
+
+std::string_view BytecodeBundleFile::getPath(size_t index) const
+{
+    LUAU_ASSERT(index < count);
+    const char* entry = data->data() + kBundleHeaderSize + index * kBundleIndexEntrySize;
+    return data->substr(readBundleInt(entry), readBundleInt(entry + 4));
+}
+
+std::string_view BytecodeBundleFile::getBytecode(size_t index) const
+{
+    LUAU_ASSERT(index < count);
+    const char* entry = data->data() + kBundleHeaderSize + index * kBundleIndexEntrySize;
+    return data->substr(readBundleInt(entry + 8), readBundleInt(entry + 12));
+}
+
+std::optional<std::string_view> BytecodeBundleFile::find(std::string_view path) const
+{
+    size_t begin = 0;
+    size_t end = count;
+
+    while (begin < end)
+    {
+        size_t mid = begin + (end - begin) / 2;
+        int cmp = getPath(mid).compare(path);
+
+        if (cmp == 0)
+            return getBytecode(mid);
+        else if (cmp < 0)
+            begin = mid + 1;
+        else
+            end = mid;
+    }
+
+    return std::nullopt;
+}
@@ -0,0 +1,49 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace Luau
+{
+struct CompileOptions;
+}
+
+// Bytecode blobs are stored in the cache directory under a hash of the source text, compile options and compiler flags
+// Cache doesn't track the compiler version, so the directory has to be cleared when a different compiler build is used
+std::string getBytecodeCacheKey(const std::string& source, const Luau::CompileOptions& options);
+
+std::optional<std::string> readCachedBytecode(const std::string& directory, const std::string& key);
+void writeCachedBytecode(const std::string& directory, const std::string& key, const std::string& bytecode);
+
+// Same as Luau::compile, but reuses bytecode from the cache directory when it's not empty
+// Failed compilations and compilations that fold constants of required modules are not cached
+std::string compileCached(const std::string& directory, const std::string& source, const Luau::CompileOptions& options);
+
+// Bundles store bytecode of several modules in one file, keyed by the path of each module file
+// Bundles don't track sources or compile options, so they have to be written again when either changes
+using BytecodeBundle = std::vector<std::pair<std::string, std::string>>;
+
+// Bundle files start with an index of modules sorted by path, so that a mapped bundle can find a module without reading the rest of the file
+// Identical paths and bytecode blobs are stored once
+bool writeBytecodeBundle(const std::string& path, const BytecodeBundle& bundle);
+
+class BytecodeBundleFile
+{
+public:
+    static std::optional<BytecodeBundleFile> open(const std::string& path);
+
+    size_t size() const;
+    std::string_view getPath(size_t index) const;
+    std::string_view getBytecode(size_t index) const;
+
+    std::optional<std::string_view> find(std::string_view path) const;
+
+private:
+    std::shared_ptr<const std::string_view> data;
+    size_t count = 0;
+};
@@ -6,12 +6,19 @@
 #include "Luau/Compiler.h"
 #include "Luau/BytecodeBuilder.h"
 #include "Luau/Parser.h"
+#include "Luau/StringUtils.h"
 #include "Luau/TimeTrace.h"
 
+#include "BytecodeCache.h"
 #include "FileUtils.h"
 #include "Flags.h"
 
+#include <atomic>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
 
 #ifdef _WIN32
 #include <io.h>
@@ -50,9 +57,171 @@ struct GlobalOptions
     std::string vectorCtor;
     std::string vectorType;
 
+    // directory of the bytecode cache used by binary output; disabled when empty
+    std::string bytecodeCache;
+
+    // zero-terminated lines of hot function definitions for each source file of the execution profile
+    std::optional<std::unordered_map<std::string, std::vector<int>>> hotFunctions;
+
+    // fold constant fields of modules required with a relative path
+    bool wholeProgram = false;
+
+    // binary output is compressed; the cache keeps uncompressed bytecode
+    bool compress = false;
+
+    // binary output of all files is written into a bytecode bundle instead of stdout; disabled when empty
+    std::string bundle;
+
 } globalOptions;
 
-static Luau::CompileOptions copts()
+struct ModuleConstant
+{
+    Luau::CompileConstant value;
+    std::string string;
+};
+
+// Constant fields of modules used in whole-program compilation, keyed by module path; shared between compilation threads
+struct ModuleConstants
+{
+    std::mutex mutex;
+
+    // node-based containers keep the string data of the values stable
+    std::unordered_map<std::string, std::unordered_map<std::string, ModuleConstant>> modules;
+} gModuleConstants;
+
+static std::optional<ModuleConstant> getModuleConstant(Luau::AstExpr* expr)
+{
+    ModuleConstant result;
+
+    if (expr->is<Luau::AstExprConstantNil>())
+    {
+        result.value.type = 1;
+    }
+    else if (Luau::AstExprConstantBool* value = expr->as<Luau::AstExprConstantBool>())
+    {
+        result.value.type = 2;
+        result.value.valueBoolean = value->value;
+    }
+    else if (Luau::AstExprConstantNumber* value = expr->as<Luau::AstExprConstantNumber>())
+    {
+        result.value.type = 3;
+        result.value.valueNumber = value->value;
+    }
+    else if (Luau::AstExprConstantString* value = expr->as<Luau::AstExprConstantString>())
+    {
+        result.value.type = 4;
+        result.string = std::string(value->value.data, value->value.size);
+    }
+    else if (Luau::AstExprUnary* value = expr->as<Luau::AstExprUnary>(); value && value->op == Luau::AstExprUnary::Minus)
+    {
+        Luau::AstExprConstantNumber* number = value->expr->as<Luau::AstExprConstantNumber>();
+        if (!number)
+            return std::nullopt;
+
+        result.value.type = 3;
+        result.value.valueNumber = -number->value;
+    }
+    else
+    {
+        return std::nullopt;
+    }
+
+    return result;
+}
+
+// Only modules that consist of a single 'return { ... }' statement, optionally wrapped in table.freeze, with literal field values are folded
+static std::unordered_map<std::string, ModuleConstant> readModuleConstants(const std::string& path)
+{
+    std::unordered_map<std::string, ModuleConstant> result;
+
+    std::optional<std::string> source;
+
+    for (const char* suffix : {"", ".luau", ".lua", "/init.luau", "/init.lua"})
+    {
+        if (!isDirectory(path + suffix) && (source = readFile(path + suffix)))
+            break;
+    }
+
+    if (!source)
+        return result;
+
+    Luau::Allocator allocator;
+    Luau::AstNameTable names(allocator);
+    Luau::ParseResult parse = Luau::Parser::parse(source->c_str(), source->size(), names, allocator);
+
+    if (!parse.errors.empty() || parse.root->body.size != 1)
+        return result;
+
+    Luau::AstStatReturn* ret = parse.root->body.data[0]->as<Luau::AstStatReturn>();
+    if (!ret || ret->list.size != 1)
+        return result;
+
+    Luau::AstExpr* value = ret->list.data[0];
+
+    if (Luau::AstExprCall* call = value->as<Luau::AstExprCall>(); call && call->args.size == 1)
+    {
+        Luau::AstExprIndexName* func = call->func->as<Luau::AstExprIndexName>();
+        Luau::AstExprGlobal* lib = func ? func->expr->as<Luau::AstExprGlobal>() : nullptr;
+
+        if (lib && lib->name == "table" && func->index == "freeze")
+            value = call->args.data[0];
+    }
+
+    Luau::AstExprTable* table = value->as<Luau::AstExprTable>();
+    if (!table)
+        return result;
+
+    for (const Luau::AstExprTable::Item& item : table->items)
+    {
+        if (item.kind != Luau::AstExprTable::Item::Record)
+            continue;
+
+        Luau::AstExprConstantString* key = item.key->as<Luau::AstExprConstantString>();
+
+        // a field that is assigned twice is left to the runtime
+        std::string name(key->value.data, key->value.size);
+
+        if (result.count(name))
+            result[name].value.type = 0;
+        else if (std::optional<ModuleConstant> constant = getModuleConstant(item.value))
+            result[name] = *constant;
+        else
+            result[name] = {};
+    }
+
+    return result;
+}
+
+static void getRequireConstant(void* context, const char* path, const char* member, Luau::CompileConstant* constant)
+{
+    const char* requirer = static_cast<const char*>(context);
+
+    // only relative paths can be resolved statically
+    if (strncmp(path, "./", 2) != 0 && strncmp(path, "../", 3) != 0)
+        return;
+
+    std::string modulePath = resolvePath(path, requirer);
+
+    std::unique_lock guard(gModuleConstants.mutex);
+
+    auto it = gModuleConstants.modules.find(modulePath);
+    if (it == gModuleConstants.modules.end())
+        it = gModuleConstants.modules.emplace(modulePath, readModuleConstants(modulePath)).first;
+
+    auto field = it->second.find(member);
+    if (field == it->second.end())
+        return;
+
+    *constant = field->second.value;
+
+    if (constant->type == 4)
+    {
+        constant->valueString = field->second.string.data();
+        constant->stringLength = field->second.string.size();
+    }
+}
+
+static Luau::CompileOptions copts(const char* name)
 {
     Luau::CompileOptions result = {};
     result.optimizationLevel = globalOptions.optimizationLevel;
@@ -63,9 +232,105 @@ static Luau::CompileOptions copts()
     result.vectorCtor = globalOptions.vectorCtor.c_str();
     result.vectorType = globalOptions.vectorType.c_str();
 
+    if (globalOptions.wholeProgram)
+    {
+        result.requireConstantCb = getRequireConstant;
+        result.requireConstantContext = const_cast<char*>(name);
+    }
+
+    // files that are missing from the profile didn't run at all, so none of their functions are hot
+    if (globalOptions.hotFunctions)
+    {
+        static const int kNoHotFunctions[] = {0};
+
+        auto it = globalOptions.hotFunctions->find(name);
+        result.hotFunctions = it != globalOptions.hotFunctions->end() ? it->second.data() : kNoHotFunctions;
+    }
+
     return result;
 }
 
+// Reads the profile written by 'luau --profile'; every line has a sample weight followed by a stack of 'source,name,linedefined' frames
+// Function is hot when the time spent in it or in the functions it calls directly reaches the given fraction of the total time
+static bool readHotFunctions(const char* path, double hotFraction)
+{
+    std::optional<std::string> profile = readFile(path);
+    if (!profile)
+        return false;
+
+    struct Frame
+    {
+        std::string source;
+        int line = 0;
+    };
+
+    auto parseFrame = [](std::string_view frame) -> std::optional<Frame> {
+        // source names can contain commas, so the frame is parsed from the end
+        size_t lineSep = frame.rfind(',');
+        if (lineSep == std::string_view::npos || lineSep == 0)
+            return std::nullopt;
+
+        size_t nameSep = frame.rfind(',', lineSep - 1);
+        if (nameSep == std::string_view::npos)
+            return std::nullopt;
+
+        int line = atoi(std::string(frame.substr(lineSep + 1)).c_str());
+        if (line <= 0)
+            return std::nullopt;
+
+        return Frame{std::string(frame.substr(0, nameSep)), line};
+    };
+
+    std::map<std::pair<std::string, int>, double> weights;
+    double total = 0;
+
+    size_t pos = 0;
+
+    while (pos < profile->size())
+    {
+        size_t end = profile->find('\n', pos);
+        if (end == std::string::npos)
+            end = profile->size();
+
+        std::string_view line = std::string_view(*profile).substr(pos, end - pos);
+        pos = end + 1;
+
+        size_t space = line.find(' ');
+        if (space == std::string_view::npos)
+            continue;
+
+        double weight = atof(std::string(line.substr(0, space)).c_str());
+        std::string_view stack = line.substr(space + 1);
+
+        total += weight;
+
+        // innermost frame comes first; samples are attributed to it and to its caller
+        for (int depth = 0; depth < 2 && !stack.empty(); depth++)
+        {
+            size_t sep = stack.find(';');
+            std::string_view frame = stack.substr(0, sep);
+            stack = sep == std::string_view::npos ? std::string_view() : stack.substr(sep + 1);
+
+            if (std::optional<Frame> f = parseFrame(frame))
+                weights[{f->source, f->line}] += weight;
+        }
+    }
+
+    // ordered map keeps the lines sorted and the result deterministic
+    globalOptions.hotFunctions.emplace();
+
+    for (const auto& [function, weight] : weights)
+    {
+        if (total > 0 && weight >= total * hotFraction)
+            (*globalOptions.hotFunctions)[function.first].push_back(function.second);
+    }
+
+    for (auto& [source, lines] : *globalOptions.hotFunctions)
+        lines.push_back(0);
+
+    return true;
+}
+
 static std::optional<CompileFormat> getCompileFormat(const char* name)
 {
     if (strcmp(name, "text") == 0)
@@ -92,23 +357,30 @@ static std::optional<CompileFormat> getCompileFormat(const char* name)
         return std::nullopt;
 }
 
-static void report(const char* name, const Luau::Location& location, const char* type, const char* message)
+// Output of a single file is buffered so that files compiled in parallel are printed in the order they were specified
+struct CompileOutput
 {
-    fprintf(stderr, "%s(%d,%d): %s: %s\n", name, location.begin.line + 1, location.begin.column + 1, type, message);
+    std::string output;
+    std::string errors;
+};
+
+static void report(CompileOutput& out, const char* name, const Luau::Location& location, const char* type, const char* message)
+{
+    out.errors += Luau::format("%s(%d,%d): %s: %s\n", name, location.begin.line + 1, location.begin.column + 1, type, message);
 }
 
-static void reportError(const char* name, const Luau::ParseError& error)
+static void reportError(CompileOutput& out, const char* name, const Luau::ParseError& error)
 {
-    report(name, error.getLocation(), "SyntaxError", error.what());
+    report(out, name, error.getLocation(), "SyntaxError", error.what());
 }
 
-static void reportError(const char* name, const Luau::CompileError& error)
+static void reportError(CompileOutput& out, const char* name, const Luau::CompileError& error)
 {
-    report(name, error.getLocation(), "CompileError", error.what());
+    report(out, name, error.getLocation(), "CompileError", error.what());
 }
 
-static std::string getCodegenAssembly(
-    const char* name, const std::string& bytecode, Luau::CodeGen::AssemblyOptions options, Luau::CodeGen::LoweringStats* stats)
+static std::string getCodegenAssembly(CompileOutput& out, const char* name, const std::string& bytecode, Luau::CodeGen::AssemblyOptions options,
+    Luau::CodeGen::LoweringStats* stats)
 {
     std::unique_ptr<lua_State, void (*)(lua_State*)> globalState(luaL_newstate(), lua_close);
     lua_State* L = globalState.get();
@@ -116,7 +388,7 @@ static std::string getCodegenAssembly(
     if (luau_load(L, name, bytecode.data(), bytecode.size(), 0) == 0)
         return Luau::CodeGen::getAssembly(L, -1, options, stats);
 
-    fprintf(stderr, "Error loading bytecode %s\n", name);
+    out.errors += Luau::format("Error loading bytecode %s\n", name);
     return "";
 }
 
@@ -218,6 +490,18 @@ void serializeBlockLinearizationStats(FILE* fp, const Luau::CodeGen::BlockLinear
     fprintf(fp, "            }");
 }
 
+void serializePhaseTimeStats(FILE* fp, const Luau::CodeGen::PhaseTimeStats& stats)
+{
+    fprintf(fp, "{\n");
+
+    WRITE_PAIR("                ", irBuildSeconds, "%f,\n");
+    WRITE_PAIR("                ", optimizeSeconds, "%f,\n");
+    WRITE_PAIR("                ", loweringSeconds, "%f,\n");
+    WRITE_PAIR("                ", finalizeSeconds, "%f\n");
+
+    fprintf(fp, "            }");
+}
+
 void serializeLoweringStats(FILE* fp, const Luau::CodeGen::LoweringStats& stats)
 {
     fprintf(fp, "{\n");
@@ -237,6 +521,10 @@ void serializeLoweringStats(FILE* fp, const Luau::CodeGen::LoweringStats& stats)
     serializeBlockLinearizationStats(fp, stats.blockLinearizationStats);
     fprintf(fp, ",\n");
 
+    WRITE_NAME("            ", phaseTimeStats);
+    serializePhaseTimeStats(fp, stats.phaseTimeStats);
+    fprintf(fp, ",\n");
+
     WRITE_NAME("            ", functions);
     const size_t functionCount = stats.functions.size();
 
@@ -289,19 +577,38 @@ static double recordDeltaTime(double& timer)
     return delta;
 }
 
-static bool compileFile(const char* name, CompileFormat format, Luau::CodeGen::AssemblyOptions::Target assemblyTarget, CompileStats& stats)
+static bool compileFile(
+    const char* name, CompileFormat format, Luau::CodeGen::AssemblyOptions::Target assemblyTarget, CompileStats& stats, CompileOutput& out)
 {
     double currts = Luau::TimeTrace::getClock();
 
     std::optional<std::string> source = readFile(name);
     if (!source)
     {
-        fprintf(stderr, "Error opening %s\n", name);
+        out.errors += Luau::format("Error opening %s\n", name);
         return false;
     }
 
     stats.readTime += recordDeltaTime(currts);
 
+    // Cached bytecode can only be reused when nothing except the bytecode is printed
+    // Whole-program compilation depends on the contents of other files which are not a part of the key
+    std::string cacheKey;
+
+    if (format == CompileFormat::Binary && !globalOptions.bytecodeCache.empty() && !globalOptions.wholeProgram)
+    {
+        cacheKey = getBytecodeCacheKey(*source, copts(name));
+
+        if (std::optional<std::string> bytecode = readCachedBytecode(globalOptions.bytecodeCache, cacheKey); bytecode && !bytecode->empty())
+        {
+            stats.bytecode += bytecode->size();
+            stats.miscTime += recordDeltaTime(currts);
+
+            out.output += globalOptions.compress ? Luau::BytecodeBuilder::compress(*bytecode) : *bytecode;
+            return true;
+        }
+    }
+
     // NOTE: Normally, you should use Luau::compile or luau_compile (see lua_require as an example)
     // This function is much more complicated because it supports many output human-readable formats through internal interfaces
 
@@ -354,7 +661,7 @@ static bool compileFile(const char* name, CompileFormat format, Luau::CodeGen::A
         stats.lines += result.lines;
         stats.parseTime += recordDeltaTime(currts);
 
-        Luau::compileOrThrow(bcb, result, names, copts());
+        Luau::compileOrThrow(bcb, result, names, copts(name));
         stats.bytecode += bcb.getBytecode().size();
         stats.bytecodeInstructionCount = bcb.getTotalInstructionCount();
         stats.compileTime += recordDeltaTime(currts);
@@ -362,22 +669,25 @@ static bool compileFile(const char* name, CompileFormat format, Luau::CodeGen::A
         switch (format)
         {
         case CompileFormat::Text:
-            printf("%s", bcb.dumpEverything().c_str());
+            out.output += bcb.dumpEverything();
             break;
         case CompileFormat::Remarks:
-            printf("%s", bcb.dumpSourceRemarks().c_str());
+            out.output += bcb.dumpSourceRemarks();
             break;
         case CompileFormat::Binary:
-            fwrite(bcb.getBytecode().data(), 1, bcb.getBytecode().size(), stdout);
+            out.output += globalOptions.compress ? Luau::BytecodeBuilder::compress(bcb.getBytecode()) : bcb.getBytecode();
+
+            if (!cacheKey.empty())
+                writeCachedBytecode(globalOptions.bytecodeCache, cacheKey, bcb.getBytecode());
             break;
         case CompileFormat::Codegen:
         case CompileFormat::CodegenAsm:
         case CompileFormat::CodegenIr:
         case CompileFormat::CodegenVerbose:
-            printf("%s", getCodegenAssembly(name, bcb.getBytecode(), options, &stats.lowerStats).c_str());
+            out.output += getCodegenAssembly(out, name, bcb.getBytecode(), options, &stats.lowerStats);
             break;
         case CompileFormat::CodegenNull:
-            stats.codegen += getCodegenAssembly(name, bcb.getBytecode(), options, &stats.lowerStats).size();
+            stats.codegen += getCodegenAssembly(out, name, bcb.getBytecode(), options, &stats.lowerStats).size();
             stats.codegenTime += recordDeltaTime(currts);
             break;
         case CompileFormat::Null:
@@ -389,12 +699,12 @@ static bool compileFile(const char* name, CompileFormat format, Luau::CodeGen::A
     catch (Luau::ParseErrors& e)
     {
         for (auto& error : e.getErrors())
-            reportError(name, error);
+            reportError(out, name, error);
         return false;
     }
     catch (Luau::CompileError& e)
     {
-        reportError(name, e);
+        reportError(out, name, e);
         return false;
     }
 }
@@ -410,6 +720,7 @@ static void displayHelp(const char* argv0)
     printf("  -h, --help: Display this usage message.\n");
     printf("  -O<n>: compile with optimization level n (default 1, n should be between 0 and 2).\n");
     printf("  -g<n>: compile with debug level n (default 1, n should be between 0 and 2).\n");
+    printf("  -j<n>: compile files using n threads (default 1, 0 uses hardware thread count); output is printed in file order.\n");
     printf("  --target=<target>: compile code for specific architecture (a64, x64, a64_nf, x64_ms).\n");
     printf("  --timetrace: record compiler time tracing information into trace.json\n");
     printf("  --record-stats=<granularity>: granularity of compilation stats (total, file, function).\n");
@@ -418,6 +729,11 @@ static void displayHelp(const char* argv0)
     printf("  --vector-lib=<name>: name of the library providing vector type operations.\n");
     printf("  --vector-ctor=<name>: name of the function constructing a vector value.\n");
     printf("  --vector-type=<name>: name of the vector type.\n");
+    printf("  --profile-guided=<file>: use profile written by 'luau --profile' to inline calls and unroll loops in hot functions only.\n");
+    printf("  --whole-program: fold constant fields of modules required with relative paths; mutation of the module tables is not supported.\n");
+    printf("  --bytecode-cache=<dir>: reuse binary output of unchanged files from the directory (has to be cleared when compiler is updated).\n");
+    printf("  --compress: compress binary output; compressed bytecode can be loaded by luau_load directly.\n");
+    printf("  --bundle=<file>: write binary output of all files into a bytecode bundle that 'luau --bytecode-bundle' loads modules from.\n");
 }
 
 static int assertionHandler(const char* expr, const char* file, int line, const char* function)
@@ -461,6 +777,7 @@ int main(int argc, char** argv)
     RecordStats recordStats = RecordStats::None;
     std::string statsFile("stats.json");
     bool bytecodeSummary = false;
+    int threadCount = 1;
 
     for (int i = 1; i < argc; i++)
     {
@@ -489,6 +806,15 @@ int main(int argc, char** argv)
             }
             globalOptions.debugLevel = level;
         }
+        else if (strncmp(argv[i], "-j", 2) == 0)
+        {
+            threadCount = int(strtol(argv[i] + 2, nullptr, 10));
+            if (threadCount < 0)
+            {
+                fprintf(stderr, "Error: Thread count must be non-negative.\n");
+                return 1;
+            }
+        }
         else if (strncmp(argv[i], "--target=", 9) == 0)
         {
             const char* value = argv[i] + 9;
@@ -557,6 +883,37 @@ int main(int argc, char** argv)
         {
             globalOptions.vectorType = argv[i] + 14;
         }
+        else if (strcmp(argv[i], "--whole-program") == 0)
+        {
+            globalOptions.wholeProgram = true;
+        }
+        else if (strcmp(argv[i], "--compress") == 0)
+        {
+            globalOptions.compress = true;
+        }
+        else if (strncmp(argv[i], "--profile-guided=", 17) == 0)
+        {
+            // functions responsible for at least 1% of the profile are considered hot
+            if (!readHotFunctions(argv[i] + 17, 0.01))
+            {
+                fprintf(stderr, "Error: failed to read profile '%s'.\n", argv[i] + 17);
+                return 1;
+            }
+        }
+        else if (strncmp(argv[i], "--bundle=", 9) == 0)
+        {
+            globalOptions.bundle = argv[i] + 9;
+        }
+        else if (strncmp(argv[i], "--bytecode-cache=", 17) == 0)
+        {
+            globalOptions.bytecodeCache = argv[i] + 17;
+
+            if (!isDirectory(globalOptions.bytecodeCache))
+            {
+                fprintf(stderr, "Error: bytecode cache directory '%s' doesn't exist.\n", globalOptions.bytecodeCache.c_str());
+                return 1;
+            }
+        }
         else if (argv[i][0] == '-' && argv[i][1] == '-' && getCompileFormat(argv[i] + 2))
         {
             compileFormat = *getCompileFormat(argv[i] + 2);
@@ -583,6 +940,9 @@ int main(int argc, char** argv)
     }
 #endif
 
+    if (!globalOptions.bundle.empty())
+        compileFormat = CompileFormat::Binary;
+
     const std::vector<std::string> files = getSourceFiles(argc, argv);
 
 #ifdef _WIN32
@@ -593,21 +953,76 @@ int main(int argc, char** argv)
     const size_t fileCount = files.size();
     CompileStats stats = {};
 
-    std::vector<CompileStats> fileStats;
-    if (recordStats == RecordStats::File || recordStats == RecordStats::Function)
-        fileStats.reserve(fileCount);
-
-    int failed = 0;
     unsigned functionStats = (recordStats == RecordStats::Function ? Luau::CodeGen::FunctionStats_Enable : 0) |
                              (bytecodeSummary ? Luau::CodeGen::FunctionStats_BytecodeSummary : 0);
-    for (const std::string& path : files)
-    {
-        CompileStats fileStat = {};
-        fileStat.lowerStats.functionStatsFlags = functionStats;
-        failed += !compileFile(path.c_str(), compileFormat, assemblyTarget, fileStat);
-        stats += fileStat;
-        if (recordStats == RecordStats::File || recordStats == RecordStats::Function)
-            fileStats.push_back(fileStat);
+
+    std::vector<CompileStats> fileStats(fileCount);
+    std::vector<CompileOutput> fileOutputs(fileCount);
+    std::vector<uint8_t> fileResults(fileCount);
+
+    auto compileNext = [&](size_t i) {
+        fileStats[i] = {};
+        fileStats[i].lowerStats.functionStatsFlags = functionStats;
+        fileResults[i] = compileFile(files[i].c_str(), compileFormat, assemblyTarget, fileStats[i], fileOutputs[i]);
+    };
+
+    BytecodeBundle bundle;
+
+    auto flushOutput = [&](size_t i) {
+        // modules are found by the path they are required with, which is relative to the directory luau runs from
+        if (!globalOptions.bundle.empty())
+            bundle.emplace_back(normalizePath(files[i]), std::move(fileOutputs[i].output));
+        else
+            fwrite(fileOutputs[i].output.data(), 1, fileOutputs[i].output.size(), stdout);
+        fwrite(fileOutputs[i].errors.data(), 1, fileOutputs[i].errors.size(), stderr);
+        fileOutputs[i] = {};
+    };
+
+    if (threadCount == 0)
+        threadCount = std::max(int(std::thread::hardware_concurrency()), 1);
+
+    if (threadCount == 1 || fileCount <= 1)
+    {
+        for (size_t i = 0; i < fileCount; i++)
+        {
+            compileNext(i);
+            flushOutput(i);
+        }
+    }
+    else
+    {
+        // Each file is compiled with its own allocator, name table and bytecode builder, so workers only share the file index
+        std::atomic<size_t> nextFile = 0;
+        std::vector<std::thread> workers;
+
+        for (int i = 0; i < std::min(threadCount, int(fileCount)); i++)
+        {
+            workers.emplace_back([&] {
+                for (size_t file = nextFile++; file < fileCount; file = nextFile++)
+                    compileNext(file);
+            });
+        }
+
+        for (std::thread& worker : workers)
+            worker.join();
+
+        for (size_t i = 0; i < fileCount; i++)
+            flushOutput(i);
+    }
+
+    // Stats are merged in file order, so the totals don't depend on the thread count
+    int failed = 0;
+
+    for (size_t i = 0; i < fileCount; i++)
+    {
+        failed += !fileResults[i];
+        stats += fileStats[i];
+    }
+
+    if (!globalOptions.bundle.empty() && !failed && !writeBytecodeBundle(globalOptions.bundle, bundle))
+    {
+        fprintf(stderr, "Error: bytecode bundle '%s' can't be written.\n", globalOptions.bundle.c_str());
+        return 1;
     }
 
     if (compileFormat == CompileFormat::Null)
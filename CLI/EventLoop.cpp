@@ -0,0 +1,530 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#include "EventLoop.h"
+
+#include "FileUtils.h"
+
+#include "lua.h"
+#include "lualib.h"
+
+#include "Luau/Common.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <iterator>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+using EventLoopClock = std::chrono::steady_clock;
+
+struct EventLoopRequest
+{
+    enum Kind
+    {
+        // opens the file for reading and finds its size; the file is then read by a Read request into a buffer of that size
+        Open,
+        Read,
+        Write,
+    };
+
+    Kind kind = Open;
+    lua_State* thread = nullptr; // task waiting for the request
+
+    std::string path;
+    FILE* file = nullptr;
+
+    // memory of the buffer or string that is read into or written from; the object is kept alive by `dataRef`
+    char* data = nullptr;
+    size_t size = 0;
+    int dataRef = LUA_NOREF;
+
+    size_t result = 0;
+    std::string error;
+};
+
+struct EventLoopTask
+{
+    int ref = LUA_NOREF; // spawned tasks are referenced by the loop; the first task is owned by the caller
+    bool waiting = false;
+};
+
+struct EventLoopResume
+{
+    lua_State* thread = nullptr;
+    int nargs = 0;
+};
+
+struct EventLoopTimer
+{
+    EventLoopClock::time_point deadline;
+    uint64_t sequence = 0; // keeps the wakeup order of timers with the same deadline stable
+    lua_State* thread = nullptr;
+
+    bool operator>(const EventLoopTimer& other) const
+    {
+        return deadline != other.deadline ? deadline > other.deadline : sequence > other.sequence;
+    }
+};
+
+struct EventLoopImpl
+{
+    std::vector<std::thread> ioThreads;
+
+    // requests travel from the loop to I/O threads through `requests` and back through `completions`
+    std::mutex mtx;
+    std::condition_variable requestCv;
+    std::condition_variable completionCv;
+    std::deque<std::unique_ptr<EventLoopRequest>> requests;
+    std::deque<std::unique_ptr<EventLoopRequest>> completions;
+    bool stop = false;
+
+    // the rest of the state is only accessed by the thread that runs the loop
+    std::unordered_map<lua_State*, EventLoopTask> tasks;
+    std::deque<EventLoopResume> ready;
+    std::priority_queue<EventLoopTimer, std::vector<EventLoopTimer>, std::greater<EventLoopTimer>> timers;
+    uint64_t timerSequence = 0;
+    size_t inflight = 0;
+    unsigned failedTasks = 0;
+
+    void submit(std::unique_ptr<EventLoopRequest> request)
+    {
+        inflight++;
+
+        {
+            std::unique_lock guard(mtx);
+            requests.push_back(std::move(request));
+        }
+
+        requestCv.notify_one();
+    }
+
+    void complete(std::unique_ptr<EventLoopRequest> request)
+    {
+        {
+            std::unique_lock guard(mtx);
+            completions.push_back(std::move(request));
+        }
+
+        completionCv.notify_one();
+    }
+};
+
+static void setRequestError(EventLoopRequest& request, const char* action)
+{
+    char message[256];
+    snprintf(message, sizeof(message), "cannot %s %s: %s", action, request.path.c_str(), strerror(errno));
+    request.error = message;
+}
+
+static void performRequest(EventLoopRequest& request)
+{
+    switch (request.kind)
+    {
+    case EventLoopRequest::Open:
+    {
+        request.file = openFile(request.path, "rb");
+
+        if (!request.file)
+        {
+            setRequestError(request, "open");
+            break;
+        }
+
+        long length = -1;
+        if (fseek(request.file, 0, SEEK_END) == 0)
+            length = ftell(request.file);
+
+        if (length < 0 || fseek(request.file, 0, SEEK_SET) != 0)
+        {
+            setRequestError(request, "read");
+            fclose(request.file);
+            request.file = nullptr;
+            break;
+        }
+
+        request.result = size_t(length);
+        break;
+    }
+    case EventLoopRequest::Read:
+    {
+        request.result = request.size ? fread(request.data, 1, request.size, request.file) : 0;
+
+        if (ferror(request.file))
+            setRequestError(request, "read");
+
+        fclose(request.file);
+        request.file = nullptr;
+        break;
+    }
+    case EventLoopRequest::Write:
+    {
+        FILE* file = openFile(request.path, "wb");
+
+        if (!file)
+        {
+            setRequestError(request, "open");
+            break;
+        }
+
+        request.result = request.size ? fwrite(request.data, 1, request.size, file) : 0;
+
+        if (request.result != request.size)
+            setRequestError(request, "write");
+
+        if (fclose(file) != 0 && request.error.empty())
+            setRequestError(request, "write");
+        break;
+    }
+    default:
+        LUAU_ASSERT(!"Unknown request kind");
+    }
+}
+
+static void ioThreadFunction(EventLoopImpl& impl)
+{
+    for (;;)
+    {
+        std::unique_ptr<EventLoopRequest> request;
+
+        {
+            std::unique_lock guard(impl.mtx);
+
+            impl.requestCv.wait(guard, [&] {
+                return impl.stop || !impl.requests.empty();
+            });
+
+            if (impl.requests.empty())
+                break;
+
+            request = std::move(impl.requests.front());
+            impl.requests.pop_front();
+        }
+
+        performRequest(*request);
+        impl.complete(std::move(request));
+    }
+}
+
+static EventLoopImpl* getImpl(lua_State* L)
+{
+    return static_cast<EventLoopImpl*>(lua_tolightuserdata(L, lua_upvalueindex(1)));
+}
+
+// only the tasks themselves can wait; nested coroutines would be resumed by the loop behind the back of the code that resumes them
+static void markTaskWaiting(lua_State* L, EventLoopImpl* impl, const char* name)
+{
+    auto it = impl->tasks.find(L);
+
+    if (it == impl->tasks.end() || !lua_isyieldable(L))
+        luaL_error(L, "io.%s can only be called from the main script or from tasks created with io.spawn", name);
+
+    it->second.waiting = true;
+}
+
+static int io_readfile(lua_State* L)
+{
+    EventLoopImpl* impl = getImpl(L);
+    const char* path = luaL_checkstring(L, 1);
+
+    markTaskWaiting(L, impl, "readfile");
+
+    std::unique_ptr<EventLoopRequest> request = std::make_unique<EventLoopRequest>();
+    request->kind = EventLoopRequest::Open;
+    request->thread = L;
+    request->path = path;
+    impl->submit(std::move(request));
+
+    return lua_yield(L, 0);
+}
+
+static int io_writefile(lua_State* L)
+{
+    EventLoopImpl* impl = getImpl(L);
+    const char* path = luaL_checkstring(L, 1);
+
+    size_t size = 0;
+    const void* data = lua_isbuffer(L, 2) ? lua_tobuffer(L, 2, &size) : lua_tolstring(L, 2, &size);
+
+    if (!data)
+        luaL_typeerror(L, 2, "string or buffer");
+
+    markTaskWaiting(L, impl, "writefile");
+
+    std::unique_ptr<EventLoopRequest> request = std::make_unique<EventLoopRequest>();
+    request->kind = EventLoopRequest::Write;
+    request->thread = L;
+    request->path = path;
+    request->data = static_cast<char*>(const_cast<void*>(data));
+    request->size = size;
+
+    lua_pushvalue(L, 2);
+    request->dataRef = lua_ref(L, -1);
+    lua_pop(L, 1);
+
+    impl->submit(std::move(request));
+
+    return lua_yield(L, 0);
+}
+
+static int io_sleep(lua_State* L)
+{
+    EventLoopImpl* impl = getImpl(L);
+    double seconds = std::max(luaL_checknumber(L, 1), 0.0);
+
+    markTaskWaiting(L, impl, "sleep");
+
+    EventLoopTimer timer;
+    timer.deadline = EventLoopClock::now() + std::chrono::duration_cast<EventLoopClock::duration>(std::chrono::duration<double>(seconds));
+    timer.sequence = impl->timerSequence++;
+    timer.thread = L;
+    impl->timers.push(timer);
+
+    return lua_yield(L, 0);
+}
+
+static int io_spawn(lua_State* L)
+{
+    EventLoopImpl* impl = getImpl(L);
+    luaL_checktype(L, 1, LUA_TFUNCTION);
+
+    int n = lua_gettop(L);
+
+    lua_State* NL = lua_newthread(L);
+
+    EventLoopTask task;
+    task.ref = lua_ref(L, -1);
+    impl->tasks[NL] = task;
+
+    // move the function and its arguments to the new thread, leaving the thread as the result
+    lua_insert(L, 1);
+    lua_xmove(L, NL, n);
+
+    impl->ready.push_back({NL, n - 1});
+    return 1;
+}
+
+// resumes the task and handles its completion; the thread that the loop was started with is left for the caller to inspect
+static int resumeTask(EventLoopImpl& impl, lua_State* L, lua_State* thread, int nargs)
+{
+    auto it = impl.tasks.find(thread);
+    LUAU_ASSERT(it != impl.tasks.end());
+
+    it->second.waiting = false;
+
+    int status = lua_resume(thread, nullptr, nargs);
+
+    if (status == LUA_YIELD || status == LUA_BREAK)
+    {
+        // tasks that yield without waiting for anything are resumed again after the other ready tasks
+        if (!it->second.waiting)
+        {
+            lua_settop(thread, 0);
+            impl.ready.push_back({thread, 0});
+        }
+
+        return status;
+    }
+
+    int ref = it->second.ref;
+    impl.tasks.erase(it);
+
+    if (thread == L)
+        return status;
+
+    if (status != LUA_OK)
+    {
+        const char* error = lua_tostring(thread, -1);
+
+        fprintf(stderr, "%s\nstacktrace:\n%s", error ? error : "error object is not a string", lua_debugtrace(thread));
+        impl.failedTasks++;
+    }
+
+    lua_unref(L, ref);
+    return status;
+}
+
+static int completeRequest(EventLoopImpl& impl, std::unique_ptr<EventLoopRequest> request)
+{
+    lua_State* thread = request->thread;
+
+    if (!request->error.empty())
+    {
+        if (request->dataRef != LUA_NOREF)
+            lua_unref(thread, request->dataRef);
+
+        lua_pushnil(thread);
+        lua_pushlstring(thread, request->error.data(), request->error.size());
+        return 2;
+    }
+
+    switch (request->kind)
+    {
+    case EventLoopRequest::Open:
+    {
+        // the buffer is created here so that the I/O thread can read the file straight into it
+        request->size = request->result;
+        request->data = static_cast<char*>(lua_newbuffer(thread, request->size));
+        request->dataRef = lua_ref(thread, -1);
+        lua_pop(thread, 1);
+
+        request->kind = EventLoopRequest::Read;
+        impl.submit(std::move(request));
+        return -1;
+    }
+    case EventLoopRequest::Read:
+    {
+        lua_getref(thread, request->dataRef);
+        lua_unref(thread, request->dataRef);
+
+        // the file has been truncated after its size was taken
+        if (request->result < request->size)
+        {
+            void* data = lua_newbuffer(thread, request->result);
+            if (request->result)
+                memcpy(data, request->data, request->result);
+            lua_remove(thread, -2);
+        }
+
+        return 1;
+    }
+    case EventLoopRequest::Write:
+    {
+        lua_unref(thread, request->dataRef);
+        lua_pushboolean(thread, 1);
+        return 1;
+    }
+    default:
+        LUAU_ASSERT(!"Unknown request kind");
+        return 0;
+    }
+}
+
+EventLoop::EventLoop(unsigned ioThreadCount)
+    : impl(std::make_unique<EventLoopImpl>())
+{
+    for (unsigned i = 0; i < std::max(ioThreadCount, 1u); i++)
+    {
+        impl->ioThreads.emplace_back([impl = impl.get()] {
+            ioThreadFunction(*impl);
+        });
+    }
+}
+
+EventLoop::~EventLoop()
+{
+    {
+        std::unique_lock guard(impl->mtx);
+        impl->stop = true;
+    }
+
+    impl->requestCv.notify_all();
+
+    for (std::thread& thread : impl->ioThreads)
+        thread.join();
+}
+
+void EventLoop::open(lua_State* L)
+{
+    static const luaL_Reg funcs[] = {
+        {"readfile", io_readfile},
+        {"writefile", io_writefile},
+        {"sleep", io_sleep},
+        {"spawn", io_spawn},
+    };
+
+    lua_createtable(L, 0, int(std::size(funcs)));
+
+    for (const luaL_Reg& func : funcs)
+    {
+        lua_pushlightuserdata(L, impl.get());
+        lua_pushcclosure(L, func.func, func.name, 1);
+        lua_setfield(L, -2, func.name);
+    }
+
+    lua_setglobal(L, "io");
+}
+
+int EventLoop::run(lua_State* L, int nargs)
+{
+    LUAU_ASSERT(impl->tasks.empty() && impl->ready.empty());
+
+    impl->tasks[L] = EventLoopTask();
+
+    int status = resumeTask(*impl, L, L, nargs);
+
+    while (!impl->tasks.empty())
+    {
+        if (!impl->ready.empty())
+        {
+            EventLoopResume next = impl->ready.front();
+            impl->ready.pop_front();
+
+            int result = resumeTask(*impl, L, next.thread, next.nargs);
+
+            if (next.thread == L)
+                status = result;
+
+            continue;
+        }
+
+        EventLoopClock::time_point now = EventLoopClock::now();
+
+        if (!impl->timers.empty() && impl->timers.top().deadline <= now)
+        {
+            while (!impl->timers.empty() && impl->timers.top().deadline <= now)
+            {
+                impl->ready.push_back({impl->timers.top().thread, 0});
+                impl->timers.pop();
+            }
+
+            continue;
+        }
+
+        // every task that hasn't finished is either ready, sleeping or waiting for a request
+        LUAU_ASSERT(impl->inflight != 0 || !impl->timers.empty());
+
+        std::deque<std::unique_ptr<EventLoopRequest>> completed;
+
+        {
+            std::unique_lock guard(impl->mtx);
+
+            auto hasCompletions = [&] {
+                return !impl->completions.empty();
+            };
+
+            if (impl->timers.empty())
+                impl->completionCv.wait(guard, hasCompletions);
+            else
+                impl->completionCv.wait_until(guard, impl->timers.top().deadline, hasCompletions);
+
+            completed.swap(impl->completions);
+        }
+
+        for (std::unique_ptr<EventLoopRequest>& request : completed)
+        {
+            impl->inflight--;
+
+            lua_State* thread = request->thread;
+            int nresults = completeRequest(*impl, std::move(request));
+
+            if (nresults >= 0)
+                impl->ready.push_back({thread, nresults});
+        }
+    }
+
+    return status;
+}
+
+unsigned EventLoop::getFailedTaskCount() const
+{
+    return impl->failedTasks;
+}
@@ -0,0 +1,31 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#pragma once
+
+#include <memory>
+
+struct lua_State;
+
+struct EventLoopImpl;
+
+// Runs scripts as a set of tasks that suspend while waiting for file I/O or timers instead of blocking the VM
+// Scripts get an `io` library with `readfile(path)`, `writefile(path, data)`, `sleep(seconds)` and `spawn(f, ...)`
+// Blocking file operations run on I/O threads; tasks are only ever resumed on the thread that calls `run`
+class EventLoop
+{
+public:
+    explicit EventLoop(unsigned ioThreadCount);
+    ~EventLoop();
+
+    // Registers the `io` library in the globals of the state; has to be called before the globals are sandboxed
+    void open(lua_State* L);
+
+    // Resumes the thread with `nargs` arguments from its stack as the first task and runs the loop until all tasks have finished
+    // Returns the final status of the thread; errors of the tasks created with io.spawn are reported to stderr
+    int run(lua_State* L, int nargs);
+
+    // Number of tasks created with io.spawn that have failed with an error since the loop was created
+    unsigned getFailedTaskCount() const;
+
+private:
+    std::unique_ptr<EventLoopImpl> impl;
+};
@@ -0,0 +1,420 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#include "Executor.h"
+
+#include "lua.h"
+#include "lualib.h"
+
+#include "Luau/Common.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <iterator>
+#include <mutex>
+#include <thread>
+
+#include <string.h>
+
+struct ExecutorTask
+{
+    std::string entry;
+    ExecutorMessage message;
+    Executor::CompletionCallback onComplete;
+};
+
+struct ExecutorWorker
+{
+    ExecutorImpl* owner = nullptr;
+    unsigned index = 0;
+
+    // tasks that haven't started yet; the owner takes them from the front and other workers steal them from the back
+    std::mutex mtx;
+    std::deque<ExecutorTask> tasks;
+
+    std::thread thread;
+};
+
+struct ExecutorImpl
+{
+    Executor::SetupCallback setup;
+    std::vector<std::unique_ptr<ExecutorWorker>> workers;
+
+    std::atomic<size_t> queued{0};  // tasks waiting in worker queues
+    std::atomic<size_t> pending{0}; // tasks that haven't finished yet
+    std::atomic<unsigned> nextVm{0};
+
+    std::mutex mtx;
+    std::condition_variable workCv;
+    std::condition_variable doneCv;
+    bool stop = false;
+
+    void spawn(unsigned vm, ExecutorTask task)
+    {
+        ExecutorWorker& worker = *workers[vm % workers.size()];
+
+        pending++;
+
+        {
+            std::unique_lock guard(worker.mtx);
+            worker.tasks.push_back(std::move(task));
+        }
+
+        queued++;
+
+        {
+            // the lock orders the update of `queued` with workers that are about to wait
+            std::unique_lock guard(mtx);
+        }
+
+        workCv.notify_one();
+    }
+
+    bool takeTask(ExecutorWorker& worker, ExecutorTask& task)
+    {
+        {
+            std::unique_lock guard(worker.mtx);
+
+            if (!worker.tasks.empty())
+            {
+                task = std::move(worker.tasks.front());
+                worker.tasks.pop_front();
+                queued--;
+                return true;
+            }
+        }
+
+        for (size_t i = 1; i < workers.size(); i++)
+        {
+            ExecutorWorker& victim = *workers[(worker.index + i) % workers.size()];
+            std::unique_lock guard(victim.mtx);
+
+            if (!victim.tasks.empty())
+            {
+                task = std::move(victim.tasks.back());
+                victim.tasks.pop_back();
+                queued--;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void finishTask()
+    {
+        if (--pending == 0)
+        {
+            std::unique_lock guard(mtx);
+            doneCv.notify_all();
+        }
+    }
+};
+
+// coroutine of a task that has started running
+struct ExecutorCoroutine
+{
+    lua_State* thread = nullptr;
+    int ref = LUA_NOREF;
+    Executor::CompletionCallback onComplete;
+};
+
+bool executorSerialize(lua_State* L, int idx, int count, ExecutorMessage& message)
+{
+    // tasks that return nothing serialize an empty range, where the index doesn't have to be valid
+    if (count == 0)
+        return true;
+
+    idx = lua_absindex(L, idx);
+
+    for (int i = 0; i < count; i++)
+    {
+        ExecutorValue value;
+
+        switch (lua_type(L, idx + i))
+        {
+        case LUA_TNIL:
+            value.type = ExecutorValue::Nil;
+            break;
+        case LUA_TBOOLEAN:
+            value.type = ExecutorValue::Boolean;
+            value.number = lua_toboolean(L, idx + i);
+            break;
+        case LUA_TNUMBER:
+            value.type = ExecutorValue::Number;
+            value.number = lua_tonumber(L, idx + i);
+            break;
+        case LUA_TSTRING:
+        {
+            size_t len = 0;
+            const char* str = lua_tolstring(L, idx + i, &len);
+            value.type = ExecutorValue::String;
+            value.data.assign(str, len);
+            break;
+        }
+        case LUA_TBUFFER:
+        {
+            size_t len = 0;
+            const char* data = static_cast<const char*>(lua_tobuffer(L, idx + i, &len));
+            value.type = ExecutorValue::Buffer;
+            value.data.assign(data, len);
+            break;
+        }
+        default:
+            return false;
+        }
+
+        message.push_back(std::move(value));
+    }
+
+    return true;
+}
+
+int executorDeserialize(lua_State* L, const ExecutorMessage& message)
+{
+    lua_rawcheckstack(L, int(message.size()));
+
+    for (const ExecutorValue& value : message)
+    {
+        switch (value.type)
+        {
+        case ExecutorValue::Nil:
+            lua_pushnil(L);
+            break;
+        case ExecutorValue::Boolean:
+            lua_pushboolean(L, value.number != 0);
+            break;
+        case ExecutorValue::Number:
+            lua_pushnumber(L, value.number);
+            break;
+        case ExecutorValue::String:
+            lua_pushlstring(L, value.data.data(), value.data.size());
+            break;
+        case ExecutorValue::Buffer:
+        {
+            void* data = lua_newbuffer(L, value.data.size());
+            if (!value.data.empty())
+                memcpy(data, value.data.data(), value.data.size());
+            break;
+        }
+        default:
+            LUAU_ASSERT(!"Unknown value type");
+            lua_pushnil(L);
+        }
+    }
+
+    return int(message.size());
+}
+
+static ExecutorWorker* getWorker(lua_State* L)
+{
+    return static_cast<ExecutorWorker*>(lua_tolightuserdata(L, lua_upvalueindex(1)));
+}
+
+static int executor_spawn(lua_State* L)
+{
+    ExecutorWorker* worker = getWorker(L);
+    const char* entry = luaL_checkstring(L, 1);
+
+    ExecutorMessage message;
+    if (!executorSerialize(L, 2, lua_gettop(L) - 1, message))
+        luaL_error(L, "only nil, boolean, number, string and buffer values can be sent to other VMs");
+
+    ExecutorImpl* impl = worker->owner;
+    impl->spawn(impl->nextVm++, ExecutorTask{entry, std::move(message), {}});
+    return 0;
+}
+
+static int executor_yield(lua_State* L)
+{
+    return lua_yield(L, 0);
+}
+
+static int executor_vm(lua_State* L)
+{
+    lua_pushinteger(L, getWorker(L)->index);
+    return 1;
+}
+
+static int executor_count(lua_State* L)
+{
+    lua_pushinteger(L, int(getWorker(L)->owner->workers.size()));
+    return 1;
+}
+
+static void openExecutorLib(lua_State* L, ExecutorWorker* worker)
+{
+    static const luaL_Reg funcs[] = {
+        {"spawn", executor_spawn},
+        {"yield", executor_yield},
+        {"vm", executor_vm},
+        {"count", executor_count},
+    };
+
+    lua_createtable(L, 0, int(std::size(funcs)));
+
+    for (const luaL_Reg& func : funcs)
+    {
+        lua_pushlightuserdata(L, worker);
+        lua_pushcclosure(L, func.func, func.name, 1);
+        lua_setfield(L, -2, func.name);
+    }
+
+    lua_setglobal(L, "executor");
+}
+
+// resumes the coroutine and returns true if it has yielded and needs to be resumed again
+static bool resumeCoroutine(lua_State* L, ExecutorCoroutine& co, int nargs)
+{
+    int status = lua_resume(co.thread, nullptr, nargs);
+
+    if (status == LUA_YIELD)
+    {
+        lua_settop(co.thread, 0);
+        return true;
+    }
+
+    ExecutorMessage result;
+    bool ok = status == LUA_OK;
+
+    if (ok)
+    {
+        if (!executorSerialize(co.thread, 1, lua_gettop(co.thread), result))
+        {
+            ok = false;
+            result.clear();
+            result.push_back({ExecutorValue::String, 0, "only nil, boolean, number, string and buffer values can be returned from tasks"});
+        }
+    }
+    else
+    {
+        const char* error = lua_tostring(co.thread, -1);
+        result.push_back({ExecutorValue::String, 0, error ? error : "error object is not a string"});
+    }
+
+    if (co.onComplete)
+        co.onComplete(ok, result);
+
+    // finished coroutines are recycled together with their stacks
+    lua_releasethread(L, co.thread);
+    lua_unref(L, co.ref);
+    return false;
+}
+
+static void workerFunction(ExecutorWorker& worker)
+{
+    ExecutorImpl& impl = *worker.owner;
+
+    std::unique_ptr<lua_State, void (*)(lua_State*)> state(luaL_newstate(), lua_close);
+    lua_State* L = state.get();
+
+    lua_setthreadpool(L, 64, 1024);
+    openExecutorLib(L, &worker);
+
+    if (impl.setup)
+        impl.setup(L, worker.index);
+
+    // coroutines of this VM that have yielded and are ready to continue; they can't move to other VMs
+    std::deque<ExecutorCoroutine> ready;
+
+    for (;;)
+    {
+        if (!ready.empty())
+        {
+            ExecutorCoroutine co = std::move(ready.front());
+            ready.pop_front();
+
+            if (resumeCoroutine(L, co, 0))
+                ready.push_back(std::move(co));
+            else
+                impl.finishTask();
+
+            continue;
+        }
+
+        ExecutorTask task;
+
+        if (impl.takeTask(worker, task))
+        {
+            ExecutorCoroutine co;
+            co.thread = lua_acquirethread(L);
+            co.ref = lua_ref(L, -1);
+            co.onComplete = std::move(task.onComplete);
+            lua_pop(L, 1);
+
+            lua_getglobal(co.thread, task.entry.c_str());
+            int nargs = executorDeserialize(co.thread, task.message);
+
+            if (resumeCoroutine(L, co, nargs))
+                ready.push_back(std::move(co));
+            else
+                impl.finishTask();
+
+            continue;
+        }
+
+        std::unique_lock guard(impl.mtx);
+
+        impl.workCv.wait(guard, [&] {
+            return impl.stop || impl.queued.load() != 0;
+        });
+
+        if (impl.stop && impl.queued.load() == 0)
+            break;
+    }
+}
+
+Executor::Executor(unsigned vmCount, SetupCallback setup)
+    : impl(std::make_unique<ExecutorImpl>())
+{
+    impl->setup = std::move(setup);
+
+    // all workers have to exist before any of them starts stealing tasks
+    for (unsigned i = 0; i < std::max(vmCount, 1u); i++)
+    {
+        impl->workers.push_back(std::make_unique<ExecutorWorker>());
+        impl->workers.back()->owner = impl.get();
+        impl->workers.back()->index = i;
+    }
+
+    for (std::unique_ptr<ExecutorWorker>& worker : impl->workers)
+    {
+        worker->thread = std::thread([worker = worker.get()] {
+            workerFunction(*worker);
+        });
+    }
+}
+
+Executor::~Executor()
+{
+    wait();
+
+    {
+        std::unique_lock guard(impl->mtx);
+        impl->stop = true;
+    }
+
+    impl->workCv.notify_all();
+
+    for (std::unique_ptr<ExecutorWorker>& worker : impl->workers)
+        worker->thread.join();
+}
+
+void Executor::spawn(unsigned vm, std::string entry, ExecutorMessage message, CompletionCallback onComplete)
+{
+    impl->spawn(vm, ExecutorTask{std::move(entry), std::move(message), std::move(onComplete)});
+}
+
+void Executor::wait()
+{
+    std::unique_lock guard(impl->mtx);
+
+    impl->doneCv.wait(guard, [this] {
+        return impl->pending.load() == 0;
+    });
+}
+
+unsigned Executor::getVmCount() const
+{
+    return unsigned(impl->workers.size());
+}
@@ -0,0 +1,62 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+struct lua_State;
+
+// Value that can be sent between VMs; tables, functions and other references can't be shared between VMs and are not supported
+struct ExecutorValue
+{
+    enum Type
+    {
+        Nil,
+        Boolean,
+        Number,
+        String,
+        Buffer,
+    };
+
+    Type type = Nil;
+    double number = 0; // value of numbers and booleans
+    std::string data;  // contents of strings and buffers
+};
+
+using ExecutorMessage = std::vector<ExecutorValue>;
+
+// Copies `count` values starting at stack index `idx` into the message; returns false if one of the values can't be sent
+bool executorSerialize(lua_State* L, int idx, int count, ExecutorMessage& message);
+// Pushes the values of the message to the stack and returns their number
+int executorDeserialize(lua_State* L, const ExecutorMessage& message);
+
+struct ExecutorImpl;
+
+// Runs tasks on a set of independent VMs, each one owned by its own worker thread
+// Scripts get an `executor` library with `spawn(entry, ...)` to queue a task on any VM, `yield()` to let other tasks of the same VM run
+// and `vm()`/`count()` to query the VM index and the number of VMs
+class Executor
+{
+public:
+    // Called on the worker thread of each VM before it runs any tasks to open libraries and load the code that tasks call into
+    using SetupCallback = std::function<void(lua_State* L, unsigned vm)>;
+    // Called on the worker thread when a task finishes with the values returned by the entry function, or the error message
+    using CompletionCallback = std::function<void(bool ok, const ExecutorMessage& result)>;
+
+    Executor(unsigned vmCount, SetupCallback setup);
+    ~Executor();
+
+    // Queues a call to the global function `entry` with the message values as arguments
+    // The task is queued on VM `vm % vmCount` but idle VMs steal queued tasks; once the task starts, it stays on the same VM
+    void spawn(unsigned vm, std::string entry, ExecutorMessage message, CompletionCallback onComplete = {});
+
+    // Blocks until all tasks, including the tasks spawned by scripts, have finished
+    void wait();
+
+    unsigned getVmCount() const;
+
+private:
+    std::unique_ptr<ExecutorImpl> impl;
+};
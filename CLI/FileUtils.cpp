@@ -16,9 +16,12 @@
 #include <dirent.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #endif
 
+#include <algorithm>
+
 #include <string.h>
 
 #ifdef _WIN32
@@ -187,13 +190,18 @@ std::string resolvePath(std::string_view path, std::string_view baseFilePath)
     return resolvedPath;
 }
 
-std::optional<std::string> readFile(const std::string& name)
+FILE* openFile(const std::string& name, const char* mode)
 {
 #ifdef _WIN32
-    FILE* file = _wfopen(fromUtf8(name).c_str(), L"rb");
+    return _wfopen(fromUtf8(name).c_str(), fromUtf8(mode).c_str());
 #else
-    FILE* file = fopen(name.c_str(), "rb");
+    return fopen(name.c_str(), mode);
 #endif
+}
+
+std::optional<std::string> readFile(const std::string& name)
+{
+    FILE* file = openFile(name, "rb");
 
     if (!file)
         return std::nullopt;
@@ -222,6 +230,93 @@ std::optional<std::string> readFile(const std::string& name)
     return result;
 }
 
+// Skip first line if it's a shebang, keeping the newline so that line numbers don't change
+static std::string_view skipShebang(std::string_view source)
+{
+    if (source.size() > 2 && source[0] == '#' && source[1] == '!')
+    {
+        size_t newline = source.find('\n');
+        return newline == std::string_view::npos ? std::string_view() : source.substr(newline);
+    }
+
+    return source;
+}
+
+std::shared_ptr<const std::string_view> mapFile(const std::string& name)
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileW(fromUtf8(name).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return nullptr;
+
+    LARGE_INTEGER size = {};
+    if (!GetFileSizeEx(file, &size))
+    {
+        CloseHandle(file);
+        return nullptr;
+    }
+
+    // empty files can't be mapped
+    if (size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return std::make_shared<const std::string_view>();
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+
+    if (!mapping)
+        return nullptr;
+
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+
+    if (!data)
+        return nullptr;
+
+    std::string_view source = skipShebang(std::string_view(static_cast<const char*>(data), size_t(size.QuadPart)));
+
+    return std::shared_ptr<const std::string_view>(new std::string_view(source), [data](const std::string_view* view) {
+        UnmapViewOfFile(data);
+        delete view;
+    });
+#else
+    int fd = open(name.c_str(), O_RDONLY);
+    if (fd < 0)
+        return nullptr;
+
+    struct stat st = {};
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))
+    {
+        close(fd);
+        return nullptr;
+    }
+
+    size_t length = size_t(st.st_size);
+
+    // empty files can't be mapped
+    if (length == 0)
+    {
+        close(fd);
+        return std::make_shared<const std::string_view>();
+    }
+
+    void* data = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (data == MAP_FAILED)
+        return nullptr;
+
+    std::string_view source = skipShebang(std::string_view(static_cast<const char*>(data), length));
+
+    return std::shared_ptr<const std::string_view>(new std::string_view(source), [data, length](const std::string_view* view) {
+        munmap(data, length);
+        delete view;
+    });
+#endif
+}
+
 std::optional<std::string> readStdin()
 {
     std::string result;
@@ -367,6 +462,25 @@ bool isDirectory(const std::string& path)
 #endif
 }
 
+std::optional<uint64_t> getFileModificationTime(const std::string& path)
+{
+#ifdef _WIN32
+    WIN32_FILE_ATTRIBUTE_DATA data = {};
+    if (!GetFileAttributesExW(fromUtf8(path).c_str(), GetFileExInfoStandard, &data))
+        return std::nullopt;
+    return (uint64_t(data.ftLastWriteTime.dwHighDateTime) << 32) | data.ftLastWriteTime.dwLowDateTime;
+#else
+    struct stat st = {};
+    if (stat(path.c_str(), &st) != 0)
+        return std::nullopt;
+#ifdef __APPLE__
+    return uint64_t(st.st_mtimespec.tv_sec) * 1000000000 + uint64_t(st.st_mtimespec.tv_nsec);
+#else
+    return uint64_t(st.st_mtim.tv_sec) * 1000000000 + uint64_t(st.st_mtim.tv_nsec);
+#endif
+#endif
+}
+
 std::vector<std::string_view> splitPath(std::string_view path)
 {
     std::vector<std::string_view> components;
@@ -438,12 +552,17 @@ std::vector<std::string> getSourceFiles(int argc, char** argv)
 
         if (isDirectory(argv[i]))
         {
+            size_t start = files.size();
+
             traverseDirectory(argv[i], [&](const std::string& name) {
                 std::string ext = getExtension(name);
 
                 if (ext == ".lua" || ext == ".luau")
                     files.push_back(name);
             });
+
+            // directory listing order depends on the file system, sorting keeps the output of the tools stable
+            std::sort(files.begin() + start, files.end());
         }
         else
         {
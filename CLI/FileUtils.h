@@ -1,23 +1,33 @@
 // This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
 #pragma once
 
+#include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
 #include <functional>
 #include <vector>
 
+#include <stdint.h>
+#include <stdio.h>
+
 std::optional<std::string> getCurrentWorkingDirectory();
 
 std::string normalizePath(std::string_view path);
 std::string resolvePath(std::string_view relativePath, std::string_view baseFilePath);
 
+// Opens the file with fopen mode flags; the name is UTF-8 on all platforms
+FILE* openFile(const std::string& name, const char* mode);
 std::optional<std::string> readFile(const std::string& name);
+// Maps the file into memory instead of copying it; the mapping is released when the last reference to the view goes away
+std::shared_ptr<const std::string_view> mapFile(const std::string& name);
 std::optional<std::string> readStdin();
 
 bool isAbsolutePath(std::string_view path);
 bool isExplicitlyRelative(std::string_view path);
 bool isDirectory(const std::string& path);
+// Returns the modification time of the file in implementation-defined units, if the file exists
+std::optional<uint64_t> getFileModificationTime(const std::string& path);
 bool traverseDirectory(const std::string& path, const std::function<void(const std::string& name)>& callback);
 
 std::vector<std::string_view> splitPath(std::string_view path);
@@ -0,0 +1,142 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#include "GcStats.h"
+
+#include "lua.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// GC states reported by the gcstep callback
+const int kGcStatePause = 0;
+const int kGcStateAtomic = 3;
+
+struct GcStats
+{
+    double starttime = 0.0;
+    size_t allocated = 0;
+
+    std::vector<double> pauses;
+    size_t cycles = 0;
+
+    double assisttime = 0.0;
+    double explicittime = 0.0;
+    double atomictime = 0.0;
+    double atomicmax = 0.0;
+
+    size_t heappeak = 0;
+
+    // heap size at the start of each cycle
+    std::vector<std::pair<double, size_t>> heap;
+} gGcStats;
+
+void* gcStatsAlloc(void* ud, void* ptr, size_t osize, size_t nsize)
+{
+    if (nsize == 0)
+    {
+        free(ptr);
+        return nullptr;
+    }
+
+    gGcStats.allocated += nsize;
+
+    return realloc(ptr, nsize);
+}
+
+static void gcStepCallback(lua_State* L, int gcstate, double time, int assist)
+{
+    GcStats& stats = gGcStats;
+
+    stats.pauses.push_back(time);
+
+    size_t heapsize = size_t(lua_gc(L, LUA_GCCOUNT, 0)) * 1024 + size_t(lua_gc(L, LUA_GCCOUNTB, 0));
+    stats.heappeak = std::max(stats.heappeak, heapsize);
+
+    if (gcstate == kGcStatePause)
+    {
+        stats.cycles++;
+        stats.heap.push_back({lua_clock() - stats.starttime, heapsize});
+    }
+
+    if (gcstate == kGcStateAtomic)
+    {
+        stats.atomictime += time;
+        stats.atomicmax = std::max(stats.atomicmax, time);
+    }
+
+    if (assist)
+        stats.assisttime += time;
+    else
+        stats.explicittime += time;
+}
+
+void gcStatsInit(lua_State* L)
+{
+    gGcStats.starttime = lua_clock();
+
+    lua_callbacks(L)->gcstep = gcStepCallback;
+}
+
+static double percentile(const std::vector<double>& sorted, double p)
+{
+    if (sorted.empty())
+        return 0.0;
+
+    size_t index = size_t(p * double(sorted.size() - 1) + 0.5);
+    return sorted[std::min(index, sorted.size() - 1)];
+}
+
+void gcStatsDump(const char* path)
+{
+    GcStats& stats = gGcStats;
+
+    FILE* f = fopen(path, "w");
+    if (!f)
+    {
+        fprintf(stderr, "Error opening GC stats %s\n", path);
+        return;
+    }
+
+    double runtime = lua_clock() - stats.starttime;
+
+    std::vector<double> pauses = stats.pauses;
+    std::sort(pauses.begin(), pauses.end());
+
+    double pausetotal = 0.0;
+    for (double p : pauses)
+        pausetotal += p;
+
+    double heapsum = 0.0;
+
+    for (auto [time, size] : stats.heap)
+        heapsum += double(size);
+
+    // times are in milliseconds and sizes are in bytes
+    fprintf(f, "runtime %f\n", runtime * 1e3);
+    fprintf(f, "allocated %zu\n", stats.allocated);
+    fprintf(f, "allocrate %f\n", runtime > 0.0 ? double(stats.allocated) / runtime : 0.0);
+    fprintf(f, "cycles %zu\n", stats.cycles);
+    fprintf(f, "steps %zu\n", pauses.size());
+    fprintf(f, "gctime %f\n", pausetotal * 1e3);
+    fprintf(f, "assisttime %f\n", stats.assisttime * 1e3);
+    fprintf(f, "explicittime %f\n", stats.explicittime * 1e3);
+    fprintf(f, "atomictime %f\n", stats.atomictime * 1e3);
+    fprintf(f, "atomicmax %f\n", stats.atomicmax * 1e3);
+    fprintf(f, "pausep50 %f\n", percentile(pauses, 0.5) * 1e3);
+    fprintf(f, "pausep90 %f\n", percentile(pauses, 0.9) * 1e3);
+    fprintf(f, "pausep99 %f\n", percentile(pauses, 0.99) * 1e3);
+    fprintf(f, "pausemax %f\n", pauses.empty() ? 0.0 : pauses.back() * 1e3);
+    fprintf(f, "heappeak %zu\n", stats.heappeak);
+    fprintf(f, "heapavg %f\n", stats.heap.empty() ? 0.0 : heapsum / double(stats.heap.size()));
+
+    fprintf(f, "\nheap:\n");
+
+    for (auto [time, size] : stats.heap)
+        fprintf(f, "%f %zu\n", time * 1e3, size);
+
+    fclose(f);
+
+    printf("GC stats written to %s (%zu steps, %zu cycles)\n", path, pauses.size(), stats.cycles);
+}
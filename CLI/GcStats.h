@@ -0,0 +1,11 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#pragma once
+
+#include <stddef.h>
+
+struct lua_State;
+
+void* gcStatsAlloc(void* ud, void* ptr, size_t osize, size_t nsize);
+
+void gcStatsInit(lua_State* L);
+void gcStatsDump(const char* path);
@@ -0,0 +1,120 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#include "OpcodeStats.h"
+
+#include "lua.h"
+
+#include "Luau/BytecodeBuilder.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+struct OpcodeStats
+{
+    lua_State* L = nullptr;
+    std::vector<int> functions;
+} gOpcodeStats;
+
+struct FunctionCount
+{
+    std::string name;
+    uint64_t count;
+};
+
+void opcodeStatsInit(lua_State* L)
+{
+    gOpcodeStats.L = lua_mainthread(L);
+
+    lua_setopcodecounters(gOpcodeStats.L, 1);
+}
+
+bool opcodeStatsActive()
+{
+    return gOpcodeStats.L != nullptr;
+}
+
+void opcodeStatsTrack(lua_State* L, int funcindex)
+{
+    int ref = lua_ref(L, funcindex);
+    gOpcodeStats.functions.push_back(ref);
+}
+
+static void opcodeCountsCallback(void* context, const char* function, int linedefined, int depth, uint64_t count)
+{
+    std::vector<FunctionCount>* result = static_cast<std::vector<FunctionCount>*>(context);
+
+    if (count == 0)
+        return;
+
+    std::string name;
+
+    if (depth == 0)
+        name = "<main>";
+    else if (function)
+        name = std::string(function) + ":" + std::to_string(linedefined);
+    else
+        name = "<anonymous>:" + std::to_string(linedefined);
+
+    result->push_back({name, count});
+}
+
+void opcodeStatsDump(const char* path)
+{
+    lua_State* L = gOpcodeStats.L;
+
+    FILE* f = fopen(path, "w");
+    if (!f)
+    {
+        fprintf(stderr, "Error opening opcode stats %s\n", path);
+        return;
+    }
+
+    std::vector<std::pair<uint64_t, int>> opcodes;
+    uint64_t total = 0;
+
+    for (int op = 0; op < LUA_OPCODECOUNT; ++op)
+    {
+        if (uint64_t count = lua_getopcodecount(L, op))
+        {
+            opcodes.push_back({count, op});
+            total += count;
+        }
+    }
+
+    std::sort(opcodes.begin(), opcodes.end(), std::greater<std::pair<uint64_t, int>>());
+
+    fprintf(f, "opcodes:\n");
+
+    for (auto [count, op] : opcodes)
+    {
+        const char* name = Luau::BytecodeBuilder::getOpcodeName(uint8_t(op));
+
+        fprintf(f, "%-20s %12llu %6.2f%%\n", name ? name : "?", (unsigned long long)count, double(count) * 100.0 / double(total));
+    }
+
+    fprintf(f, "\nfunctions:\n");
+
+    for (int fref : gOpcodeStats.functions)
+    {
+        lua_getref(L, fref);
+
+        lua_Debug ar = {};
+        lua_getinfo(L, -1, "s", &ar);
+
+        std::vector<FunctionCount> functions;
+        lua_getopcodecounts(L, -1, &functions, opcodeCountsCallback);
+
+        std::stable_sort(functions.begin(), functions.end(), [](const FunctionCount& l, const FunctionCount& r) {
+            return l.count > r.count;
+        });
+
+        for (const FunctionCount& fc : functions)
+            fprintf(f, "%s %-30s %12llu\n", ar.short_src, fc.name.c_str(), (unsigned long long)fc.count);
+
+        lua_pop(L, 1);
+    }
+
+    fclose(f);
+
+    printf("Opcode stats written to %s (%llu instructions)\n", path, (unsigned long long)total);
+}
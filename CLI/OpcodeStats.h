@@ -0,0 +1,10 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#pragma once
+
+struct lua_State;
+
+void opcodeStatsInit(lua_State* L);
+bool opcodeStatsActive();
+
+void opcodeStatsTrack(lua_State* L, int funcindex);
+void opcodeStatsDump(const char* path);
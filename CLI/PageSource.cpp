@@ -0,0 +1,227 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#include "PageSource.h"
+
+#include "lua.h"
+
+#include "Luau/Common.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+#include <mutex>
+
+#include <stdint.h>
+
+// Regions are aligned to their size so that the region header can be found from any page in it; the first slot holds the header.
+// Memory is committed by the OS on first touch, so as long as each VM uses its own source, its pages end up local to the NUMA node
+// of the thread that runs it. Regions that become empty are returned to the OS, except for one that is kept to absorb churn.
+const size_t kRegionSize = 2 * 1024 * 1024;
+const size_t kSlotSize = 16 * 1024;
+const int kRegionSlots = int(kRegionSize / kSlotSize);
+
+struct Region
+{
+    // list of regions with free slots
+    Region* prev;
+    Region* next;
+
+    void* mapping; // start of the OS allocation, which can be larger than the region
+    size_t mappingSize;
+
+    void* freeList; // slots freed by the VM; linked through their first pointer
+    int nextSlot;   // next slot that was never used
+    int busySlots;
+};
+
+struct RegionPageSource
+{
+    lua_PageSource source = {};
+
+    std::mutex mutex;
+
+    Region* available = nullptr; // regions with free slots
+    Region* spare = nullptr;     // empty region kept around instead of being returned to the OS
+} gPageSource;
+
+#ifdef _WIN32
+static Region* allocateRegion()
+{
+    // reserve twice the size to find an aligned range and commit only that part
+    char* mapping = (char*)VirtualAlloc(nullptr, kRegionSize * 2, MEM_RESERVE, PAGE_NOACCESS);
+    if (!mapping)
+        return nullptr;
+
+    char* start = (char*)((uintptr_t(mapping) + kRegionSize - 1) & ~(kRegionSize - 1));
+
+    if (!VirtualAlloc(start, kRegionSize, MEM_COMMIT, PAGE_READWRITE))
+    {
+        VirtualFree(mapping, 0, MEM_RELEASE);
+        return nullptr;
+    }
+
+    Region* region = (Region*)start;
+    region->mapping = mapping;
+    region->mappingSize = kRegionSize * 2;
+    return region;
+}
+
+static void freeRegion(Region* region)
+{
+    if (VirtualFree(region->mapping, 0, MEM_RELEASE) == 0)
+        LUAU_ASSERT(!"failed to deallocate region memory");
+}
+#else
+static Region* allocateRegion()
+{
+    // over-allocate to find an aligned range and unmap the rest
+    char* mapping = (char*)mmap(nullptr, kRegionSize * 2, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+    if (mapping == MAP_FAILED)
+        return nullptr;
+
+    char* start = (char*)((uintptr_t(mapping) + kRegionSize - 1) & ~(kRegionSize - 1));
+
+    if (start != mapping)
+        munmap(mapping, start - mapping);
+
+    if (size_t tail = (mapping + kRegionSize * 2) - (start + kRegionSize))
+        munmap(start + kRegionSize, tail);
+
+#ifdef MADV_HUGEPAGE
+    // this is only a hint, regions still work with regular pages when transparent huge pages are disabled
+    madvise(start, kRegionSize, MADV_HUGEPAGE);
+#endif
+
+    Region* region = (Region*)start;
+    region->mapping = start;
+    region->mappingSize = kRegionSize;
+    return region;
+}
+
+static void freeRegion(Region* region)
+{
+    if (munmap(region->mapping, region->mappingSize) != 0)
+        LUAU_ASSERT(!"failed to deallocate region memory");
+}
+#endif
+
+static void linkRegion(RegionPageSource* source, Region* region)
+{
+    region->prev = nullptr;
+    region->next = source->available;
+
+    if (region->next)
+        region->next->prev = region;
+
+    source->available = region;
+}
+
+static void unlinkRegion(RegionPageSource* source, Region* region)
+{
+    if (region->next)
+        region->next->prev = region->prev;
+
+    if (region->prev)
+        region->prev->next = region->next;
+    else
+        source->available = region->next;
+}
+
+static void* allocPage(void* context, size_t size)
+{
+    RegionPageSource* source = static_cast<RegionPageSource*>(context);
+
+    LUAU_ASSERT(size <= kSlotSize);
+
+    std::lock_guard<std::mutex> lock(source->mutex);
+
+    Region* region = source->available;
+
+    if (!region)
+    {
+        if (source->spare)
+        {
+            region = source->spare;
+            source->spare = nullptr;
+        }
+        else
+        {
+            region = allocateRegion();
+            if (!region)
+                return nullptr;
+
+            region->freeList = nullptr;
+            region->nextSlot = 1;
+            region->busySlots = 0;
+        }
+
+        linkRegion(source, region);
+    }
+
+    void* page = region->freeList;
+
+    if (page)
+    {
+        region->freeList = *(void**)page;
+    }
+    else
+    {
+        LUAU_ASSERT(region->nextSlot < kRegionSlots);
+        page = (char*)region + region->nextSlot * kSlotSize;
+        region->nextSlot++;
+    }
+
+    region->busySlots++;
+
+    // full regions are only reachable from their pages until one of them is freed
+    if (!region->freeList && region->nextSlot == kRegionSlots)
+        unlinkRegion(source, region);
+
+    return page;
+}
+
+static void freePage(void* context, void* page, size_t size)
+{
+    RegionPageSource* source = static_cast<RegionPageSource*>(context);
+
+    Region* region = (Region*)(uintptr_t(page) & ~(kRegionSize - 1));
+    LUAU_ASSERT(page != region);
+
+    std::lock_guard<std::mutex> lock(source->mutex);
+
+    bool wasFull = !region->freeList && region->nextSlot == kRegionSlots;
+
+    *(void**)page = region->freeList;
+    region->freeList = page;
+    region->busySlots--;
+
+    if (wasFull)
+        linkRegion(source, region);
+
+    if (region->busySlots == 0)
+    {
+        unlinkRegion(source, region);
+
+        if (source->spare)
+            freeRegion(source->spare);
+
+        source->spare = region;
+    }
+}
+
+void pageSourceInit(lua_State* L)
+{
+    gPageSource.source.context = &gPageSource;
+    gPageSource.source.allocpage = allocPage;
+    gPageSource.source.freepage = freePage;
+
+    lua_setpagesource(L, &gPageSource.source);
+}
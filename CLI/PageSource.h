@@ -0,0 +1,7 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#pragma once
+
+struct lua_State;
+
+// installs a page source that carves VM pages out of 2MB aligned regions, backed by transparent huge pages where the OS supports them
+void pageSourceInit(lua_State* L);
@@ -10,6 +10,7 @@
 struct Profiler
 {
     // static state
+    lua_State* L = nullptr;
     lua_Callbacks* callbacks = nullptr;
     int frequency = 1000;
     std::thread thread;
@@ -21,51 +22,87 @@ struct Profiler
 
     // private state for trigger
     uint64_t currentTicks = 0;
+
+    // private state for flush; function names are only cached for one batch since functions can be collected once their samples are read
     std::string stackScratch;
+    Luau::DenseHashMap<const void*, std::string> functions{nullptr};
 
-    // statistics, updated by trigger
+    // statistics, updated by flush
     Luau::DenseHashMap<std::string, uint64_t> data{""};
     uint64_t gc[16] = {};
+    size_t dropped = 0;
 } gProfiler;
 
-static void profilerTrigger(lua_State* L, int gc)
+// size of the VM sample buffer in frames; samples are symbolized in batches when it becomes half full
+const int kProfilerBufferSize = 64 * 1024;
+
+static const std::string& profilerFunction(const lua_ProfilerFrame& frame)
 {
-    uint64_t currentTicks = gProfiler.ticks.load();
-    uint64_t elapsedTicks = currentTicks - gProfiler.currentTicks;
+    std::string& result = gProfiler.functions[frame.function];
 
-    if (elapsedTicks)
+    if (result.empty())
     {
-        std::string& stack = gProfiler.stackScratch;
+        lua_Debug ar;
+        lua_getprofilerframe(gProfiler.L, &frame, &ar);
+
+        result += ar.short_src;
+        result += ',';
+        if (ar.name)
+            result += ar.name;
+        result += ',';
+        if (ar.linedefined > 0)
+            result += std::to_string(ar.linedefined);
+    }
 
-        stack.clear();
+    return result;
+}
 
-        if (gc > 0)
-            stack += "GC,GC,";
+static void profilerRecord(void* context, int tag, unsigned weight, const lua_ProfilerFrame* frames, int depth)
+{
+    std::string& stack = gProfiler.stackScratch;
 
-        lua_Debug ar;
-        for (int level = 0; lua_getinfo(L, level, "sn", &ar); ++level)
-        {
-            if (!stack.empty())
-                stack += ';';
-
-            stack += ar.short_src;
-            stack += ',';
-            if (ar.name)
-                stack += ar.name;
-            stack += ',';
-            if (ar.linedefined > 0)
-                stack += std::to_string(ar.linedefined);
-        }
+    stack.clear();
+
+    if (tag > 0)
+        stack += "GC,GC,";
 
+    for (int i = 0; i < depth; ++i)
+    {
         if (!stack.empty())
-        {
-            gProfiler.data[stack] += elapsedTicks;
-        }
+            stack += ';';
 
-        if (gc > 0)
-        {
-            gProfiler.gc[gc] += elapsedTicks;
-        }
+        stack += profilerFunction(frames[i]);
+    }
+
+    if (!stack.empty())
+    {
+        gProfiler.data[stack] += weight;
+    }
+
+    if (tag > 0)
+    {
+        gProfiler.gc[tag] += weight;
+    }
+}
+
+static void profilerFlush()
+{
+    gProfiler.dropped += lua_getprofilersamples(gProfiler.L, nullptr, profilerRecord);
+    gProfiler.functions.clear();
+}
+
+static void profilerTrigger(lua_State* L, int gc)
+{
+    uint64_t currentTicks = gProfiler.ticks.load();
+    uint64_t elapsedTicks = currentTicks - gProfiler.currentTicks;
+
+    if (elapsedTicks)
+    {
+        // recording only captures raw frames; names are resolved later, outside of the interrupt
+        int entries = lua_profilersample(L, gc > 0 ? gc : 0, unsigned(elapsedTicks));
+
+        if (entries > kProfilerBufferSize / 2)
+            profilerFlush();
     }
 
     gProfiler.currentTicks = currentTicks;
@@ -99,9 +136,12 @@ static void profilerLoop()
 
 void profilerStart(lua_State* L, int frequency)
 {
+    gProfiler.L = L;
     gProfiler.frequency = frequency;
     gProfiler.callbacks = lua_callbacks(L);
 
+    lua_startprofiler(L, kProfilerBufferSize);
+
     gProfiler.exit = false;
     gProfiler.thread = std::thread(profilerLoop);
 }
@@ -110,6 +150,11 @@ void profilerStop()
 {
     gProfiler.exit = true;
     gProfiler.thread.join();
+
+    gProfiler.callbacks->interrupt = nullptr;
+
+    profilerFlush();
+    lua_stopprofiler(gProfiler.L);
 }
 
 void profilerDump(const char* path)
@@ -134,6 +179,9 @@ void profilerDump(const char* path)
     printf("Profiler dump written to %s (total runtime %.3f seconds, %lld samples, %lld stacks)\n", path, double(total) / 1e6,
         static_cast<long long>(gProfiler.samples.load()), static_cast<long long>(gProfiler.data.size()));
 
+    if (gProfiler.dropped)
+        printf("Profiler buffer overflowed, %lld samples were dropped\n", static_cast<long long>(gProfiler.dropped));
+
     uint64_t totalgc = 0;
     for (uint64_t p : gProfiler.gc)
         totalgc += p;
@@ -155,3 +203,89 @@ void profilerDump(const char* path)
         printf("\n");
     }
 }
+
+struct HeapProfiler
+{
+    lua_State* L = nullptr;
+
+    Luau::DenseHashMap<const void*, std::string> functions{nullptr};
+    Luau::DenseHashMap<std::string, uint64_t> data{""};
+    size_t samples = 0;
+} gHeapProfiler;
+
+// number of live objects the VM keeps samples for; samples past that are dropped until sampled objects are freed
+const int kHeapProfilerCapacity = 64 * 1024;
+
+static const std::string& heapProfilerFunction(const lua_ProfilerFrame& frame)
+{
+    std::string& result = gHeapProfiler.functions[frame.function];
+
+    if (result.empty())
+    {
+        lua_Debug ar;
+        lua_getprofilerframe(gHeapProfiler.L, &frame, &ar);
+
+        result += ar.short_src;
+        result += ',';
+        if (ar.name)
+            result += ar.name;
+        result += ',';
+        if (ar.linedefined > 0)
+            result += std::to_string(ar.linedefined);
+    }
+
+    return result;
+}
+
+static void heapProfilerRecord(void* context, int type, int memcat, size_t size, size_t weight, const lua_ProfilerFrame* frames, int depth)
+{
+    // the object type is the innermost frame so that flame graphs split each allocation site by type
+    std::string stack = "[heap],";
+    stack += lua_typename(gHeapProfiler.L, type);
+    stack += ',';
+
+    for (int i = 0; i < depth; ++i)
+    {
+        stack += ';';
+        stack += heapProfilerFunction(frames[i]);
+    }
+
+    gHeapProfiler.data[stack] += weight;
+    gHeapProfiler.samples++;
+}
+
+void heapProfilerStart(lua_State* L, int rateKB)
+{
+    gHeapProfiler.L = L;
+
+    lua_startheapprofiler(L, size_t(rateKB) * 1024, kHeapProfilerCapacity);
+}
+
+void heapProfilerDump(lua_State* L, const char* path)
+{
+    size_t dropped = lua_getheapprofile(L, nullptr, heapProfilerRecord);
+    lua_stopheapprofiler(L);
+
+    FILE* f = fopen(path, "wb");
+    if (!f)
+    {
+        fprintf(stderr, "Error opening heap profile %s\n", path);
+        return;
+    }
+
+    uint64_t total = 0;
+
+    for (auto& p : gHeapProfiler.data)
+    {
+        fprintf(f, "%lld %s\n", static_cast<long long>(p.second), p.first.c_str());
+        total += p.second;
+    }
+
+    fclose(f);
+
+    printf("Heap profile written to %s (%.1f KB in live sampled allocations, %lld samples, %lld stacks)\n", path, double(total) / 1024.0,
+        static_cast<long long>(gHeapProfiler.samples), static_cast<long long>(gHeapProfiler.data.size()));
+
+    if (dropped)
+        printf("Heap profiler ran out of space, %lld samples were dropped\n", static_cast<long long>(dropped));
+}
@@ -6,3 +6,6 @@ struct lua_State;
 void profilerStart(lua_State* L, int frequency);
 void profilerStop();
 void profilerDump(const char* path);
+
+void heapProfilerStart(lua_State* L, int rateKB);
+void heapProfilerDump(lua_State* L, const char* path);
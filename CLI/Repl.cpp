@@ -10,9 +10,14 @@
 #include "Luau/Parser.h"
 #include "Luau/TimeTrace.h"
 
+#include "BytecodeCache.h"
 #include "Coverage.h"
+#include "EventLoop.h"
 #include "FileUtils.h"
 #include "Flags.h"
+#include "GcStats.h"
+#include "OpcodeStats.h"
+#include "PageSource.h"
 #include "Profiler.h"
 #include "Require.h"
 
@@ -30,6 +35,9 @@
 
 #ifdef __linux__
 #include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
 #endif
 
 #ifdef CALLGRIND
@@ -46,6 +54,34 @@ LUAU_FASTFLAGVARIABLE(LuauUpdatedRequireByStringSemantics, false)
 constexpr int MaxTraversalLimit = 50;
 
 static bool codegen = false;
+static unsigned int codegenFlags = 0;
+
+// native compilation statistics accumulated over all loaded chunks when --codegen-stats is used
+static bool codegenStats = false;
+static Luau::CodeGen::CompilationStats codegenTotals;
+static double codegenTime = 0.0;
+
+static void compileNative(lua_State* L, int idx)
+{
+    if (!codegenStats)
+    {
+        Luau::CodeGen::compile(L, idx, codegenFlags);
+        return;
+    }
+
+    Luau::CodeGen::CompilationStats stats;
+
+    double start = lua_clock();
+    Luau::CodeGen::compile(L, idx, codegenFlags, &stats);
+    codegenTime += lua_clock() - start;
+
+    codegenTotals.bytecodeSizeBytes += stats.bytecodeSizeBytes;
+    codegenTotals.nativeCodeSizeBytes += stats.nativeCodeSizeBytes;
+    codegenTotals.nativeDataSizeBytes += stats.nativeDataSizeBytes;
+    codegenTotals.nativeMetadataSizeBytes += stats.nativeMetadataSizeBytes;
+    codegenTotals.functionsTotal += stats.functionsTotal;
+    codegenTotals.functionsCompiled += stats.functionsCompiled;
+}
 
 // Ctrl-C handling
 static void sigintCallback(lua_State* L, int gc)
@@ -80,8 +116,17 @@ struct GlobalOptions
 {
     int optimizationLevel = 1;
     int debugLevel = 1;
+
+    // directory of the bytecode cache used for files and required modules; disabled when empty
+    std::string bytecodeCache;
+
+    // bundle that receives bytecode of modules compiled by require when the run is over; disabled when empty
+    std::string bytecodeBundleOutput;
 } globalOptions;
 
+// set by --async; scripts then run as event loop tasks that can wait for file I/O and timers
+static std::unique_ptr<EventLoop> eventLoop;
+
 static Luau::CompileOptions copts()
 {
     Luau::CompileOptions result = {};
@@ -92,6 +137,18 @@ static Luau::CompileOptions copts()
     return result;
 }
 
+static BytecodeBundle requiredModules;
+
+static std::string_view compileModule(const std::string& path, const std::string& source, std::string& bytecode)
+{
+    bytecode = compileCached(globalOptions.bytecodeCache, source, copts());
+
+    if (!globalOptions.bytecodeBundleOutput.empty())
+        requiredModules.emplace_back(path, bytecode);
+
+    return bytecode;
+}
+
 static int lua_loadstring(lua_State* L)
 {
     size_t l = 0;
@@ -140,14 +197,18 @@ static int lua_require(lua_State* L)
         luaL_sandboxthread(ML);
 
         // now we can compile & run module on the new thread
-        std::string bytecode = Luau::compile(resolvedRequire.sourceCode, copts());
+        std::string compiled;
+        std::string_view bytecode =
+            resolvedRequire.bytecode ? *resolvedRequire.bytecode : compileModule(resolvedRequire.absolutePath, resolvedRequire.sourceCode, compiled);
         if (luau_load(ML, resolvedRequire.chunkName.c_str(), bytecode.data(), bytecode.size(), 0) == 0)
         {
             if (codegen)
-                Luau::CodeGen::compile(ML, -1);
+                compileNative(ML, -1);
 
             if (coverageActive())
                 coverageTrack(ML, -1);
+            if (opcodeStatsActive())
+                opcodeStatsTrack(ML, -1);
 
             int status = lua_resume(ML, L, 0);
 
@@ -193,12 +254,27 @@ static int lua_require(lua_State* L)
 
         lua_pop(L, 1);
 
-        std::optional<std::string> source = readFile(name + ".luau");
-        if (!source)
+        std::string path = name + ".luau";
+        std::optional<std::string_view> preloaded = findPreloadedModuleBytecode(path);
+
+        if (!preloaded)
+        {
+            path = name + ".lua";
+            preloaded = findPreloadedModuleBytecode(path);
+        }
+
+        std::optional<std::string> source;
+        if (!preloaded)
         {
-            source = readFile(name + ".lua"); // try .lua if .luau doesn't exist
+            path = name + ".luau";
+            source = readFile(path);
             if (!source)
-                luaL_argerrorL(L, 1, ("error loading " + name).c_str()); // if neither .luau nor .lua exist, we have an error
+            {
+                path = name + ".lua";
+                source = readFile(path); // try .lua if .luau doesn't exist
+                if (!source)
+                    luaL_argerrorL(L, 1, ("error loading " + name).c_str()); // if neither .luau nor .lua exist, we have an error
+            }
         }
 
         // module needs to run in a new thread, isolated from the rest
@@ -210,13 +286,16 @@ static int lua_require(lua_State* L)
         luaL_sandboxthread(ML);
 
         // now we can compile & run module on the new thread
-        std::string bytecode = Luau::compile(*source, copts());
+        std::string compiled;
+        std::string_view bytecode = preloaded ? *preloaded : compileModule(path, *source, compiled);
         if (luau_load(ML, chunkname.c_str(), bytecode.data(), bytecode.size(), 0) == 0)
         {
             if (codegen)
-                Luau::CodeGen::compile(ML, -1);
+                compileNative(ML, -1);
             if (coverageActive())
                 coverageTrack(ML, -1);
+            if (opcodeStatsActive())
+                opcodeStatsTrack(ML, -1);
             int status = lua_resume(ML, L, 0);
             if (status == 0)
             {
@@ -315,6 +394,9 @@ void setupState(lua_State* L)
     luaL_register(L, NULL, funcs);
     lua_pop(L, 1);
 
+    if (eventLoop)
+        eventLoop->open(L);
+
     luaL_sandbox(L);
 }
 
@@ -657,18 +739,21 @@ static bool runFile(const char* name, lua_State* GL, bool repl)
 
     std::string chunkname = "=" + std::string(name);
 
-    std::string bytecode = Luau::compile(*source, copts());
+    std::string bytecode = compileCached(globalOptions.bytecodeCache, *source, copts());
     int status = 0;
 
     if (luau_load(L, chunkname.c_str(), bytecode.data(), bytecode.size(), 0) == 0)
     {
         if (codegen)
-            Luau::CodeGen::compile(L, -1);
+            compileNative(L, -1);
 
         if (coverageActive())
             coverageTrack(L, -1);
 
-        status = lua_resume(L, NULL, 0);
+        if (opcodeStatsActive())
+            opcodeStatsTrack(L, -1);
+
+        status = eventLoop ? eventLoop->run(L, 0) : lua_resume(L, NULL, 0);
     }
     else
     {
@@ -702,6 +787,102 @@ static bool runFile(const char* name, lua_State* GL, bool repl)
     return status == 0;
 }
 
+#if __linux__
+// perf jitdump format, see tools/perf/Documentation/jitdump-specification.txt in Linux sources
+// Unlike the perf map, the dump carries a copy of the generated code, so 'perf inject --jit' can annotate native functions
+struct JitDumpHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t totalSize;
+    uint32_t elfMach;
+    uint32_t pad1;
+    uint32_t pid;
+    uint64_t timestamp;
+    uint64_t flags;
+};
+
+struct JitDumpCodeLoad
+{
+    uint32_t id;
+    uint32_t totalSize;
+    uint64_t timestamp;
+    uint32_t pid;
+    uint32_t tid;
+    uint64_t vma;
+    uint64_t codeAddr;
+    uint64_t codeSize;
+    uint64_t codeIndex;
+};
+
+static uint64_t getJitDumpTimestamp()
+{
+    // matches the clock used by 'perf record -k mono'
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return uint64_t(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+static bool startJitDump()
+{
+    char path[128];
+    snprintf(path, sizeof(path), "/tmp/jit-%d.dump", getpid());
+
+    FILE* dump = fopen(path, "w+");
+    if (!dump)
+        return false;
+
+    // perf discovers the dump through an executable mapping of the file recorded in the trace
+    long pageSize = sysconf(_SC_PAGESIZE);
+    if (mmap(nullptr, pageSize, PROT_READ | PROT_EXEC, MAP_PRIVATE, fileno(dump), 0) == MAP_FAILED)
+    {
+        fclose(dump);
+        return false;
+    }
+
+    JitDumpHeader header = {};
+    header.magic = 0x4A695444;
+    header.version = 1;
+    header.totalSize = sizeof(header);
+#if defined(__aarch64__)
+    header.elfMach = 183; // EM_AARCH64
+#else
+    header.elfMach = 62; // EM_X86_64
+#endif
+    header.pid = uint32_t(getpid());
+    header.timestamp = getJitDumpTimestamp();
+
+    fwrite(&header, sizeof(header), 1, dump);
+    fflush(dump);
+
+    // note, there's no need to close the dump explicitly as it will be closed when the process exits
+    Luau::CodeGen::setPerfLog(dump, [](void* context, uintptr_t addr, unsigned size, const char* symbol) {
+        static uint64_t codeIndex = 0;
+
+        FILE* dump = static_cast<FILE*>(context);
+        size_t nameSize = strlen(symbol) + 1;
+
+        JitDumpCodeLoad record = {};
+        record.id = 0; // JIT_CODE_LOAD
+        record.totalSize = uint32_t(sizeof(record) + nameSize + size);
+        record.timestamp = getJitDumpTimestamp();
+        record.pid = uint32_t(getpid());
+        record.tid = uint32_t(syscall(SYS_gettid));
+        record.vma = addr;
+        record.codeAddr = addr;
+        record.codeSize = size;
+        record.codeIndex = codeIndex++;
+
+        fwrite(&record, sizeof(record), 1, dump);
+        fwrite(symbol, nameSize, 1, dump);
+        fwrite(reinterpret_cast<const void*>(addr), size, 1, dump);
+        fflush(dump);
+    });
+
+    return true;
+}
+#endif
+
 static void displayHelp(const char* argv0)
 {
     printf("Usage: %s [options] [file list]\n", argv0);
@@ -709,14 +890,27 @@ static void displayHelp(const char* argv0)
     printf("When file list is omitted, an interactive REPL is started instead.\n");
     printf("\n");
     printf("Available options:\n");
+    printf("  --async: run scripts on an event loop and provide the io library for reading and writing files and sleeping without blocking other tasks\n");
     printf("  --coverage: collect code coverage while running the code and output results to coverage.out\n");
+    printf("  --coverage=firsthit: same as --coverage, but only record whether each line was reached to reduce the overhead\n");
     printf("  -h, --help: Display this usage message.\n");
     printf("  -i, --interactive: Run an interactive REPL after executing the last script specified.\n");
     printf("  -O<n>: compile with optimization level n (default 1, n should be between 0 and 2).\n");
+    printf("  --gcstats: record duration of every garbage collector step, allocation volume and heap size and output results to gcstats.out\n");
+    printf("  --opcodes: count executed instructions per opcode and function and output results to opcodes.out\n");
+    printf("  --tablefeedback: create tables with the sizes that previous tables created by the same constructor have reached\n");
+    printf("  --hugepages: allocate VM pages from 2MB aligned regions backed by transparent huge pages where supported\n");
     printf("  -g<n>: compile with debug level n (default 1, n should be between 0 and 2).\n");
     printf("  --profile[=N]: profile the code using N Hz sampling (default 10000) and output results to profile.out\n");
+    printf("  --heapprofile[=N]: sample an allocation every N KB (default 64) and output call stacks of objects alive at exit to heap.out\n");
     printf("  --timetrace: record compiler time tracing information into trace.json\n");
+    printf("  --bytecode-cache=<dir>: reuse bytecode of unchanged files and modules from the directory (has to be cleared when compiler is updated)\n");
+    printf("  --bytecode-bundle=<file>: load required modules from a bytecode bundle (written by luau or luau-compile) instead of compiling their source files\n");
+    printf("  --write-bytecode-bundle=<file>: write bytecode of all modules compiled by require during the run into a bundle\n");
     printf("  --codegen: execute code using native code generation\n");
+    printf("  --codegen-stats: execute code using native code generation and report size of native code and time spent generating it\n");
+    printf("  --codegen-perf[=jitdump]: execute code using native code generation and write symbols of generated functions to /tmp/perf-<pid>.map\n");
+    printf("    (or /tmp/jit-<pid>.dump for 'perf record -k mono' and 'perf inject --jit' when jitdump is specified)\n");
 }
 
 static int assertionHandler(const char* expr, const char* file, int line, const char* function)
@@ -736,9 +930,16 @@ int replMain(int argc, char** argv)
 #endif
 
     int profile = 0;
+    int heapProfile = 0;
     bool coverage = false;
+    bool coverageFirstHit = false;
+    bool opcodes = false;
+    bool gcstats = false;
+    bool hugePages = false;
+    bool tableFeedback = false;
     bool interactive = false;
     bool codegenPerf = false;
+    bool codegenJitDump = false;
 
     for (int i = 1; i < argc; i++)
     {
@@ -779,23 +980,94 @@ int replMain(int argc, char** argv)
         {
             profile = atoi(argv[i] + 10);
         }
+        else if (strcmp(argv[i], "--heapprofile") == 0)
+        {
+            heapProfile = 64;
+        }
+        else if (strncmp(argv[i], "--heapprofile=", 14) == 0)
+        {
+            heapProfile = atoi(argv[i] + 14);
+        }
         else if (strcmp(argv[i], "--codegen") == 0)
         {
             codegen = true;
         }
+        else if (strcmp(argv[i], "--codegen-stats") == 0)
+        {
+            codegen = true;
+            codegenStats = true;
+        }
         else if (strcmp(argv[i], "--codegen-perf") == 0)
         {
             codegen = true;
             codegenPerf = true;
         }
+        else if (strcmp(argv[i], "--codegen-perf=jitdump") == 0)
+        {
+            codegen = true;
+            codegenPerf = true;
+            codegenJitDump = true;
+        }
+        else if (strcmp(argv[i], "--async") == 0)
+        {
+            eventLoop = std::make_unique<EventLoop>(4);
+        }
         else if (strcmp(argv[i], "--coverage") == 0)
         {
             coverage = true;
         }
+        else if (strcmp(argv[i], "--coverage=firsthit") == 0)
+        {
+            coverage = true;
+            coverageFirstHit = true;
+            codegenFlags |= Luau::CodeGen::CodeGen_CoverageFirstHit;
+        }
+        else if (strcmp(argv[i], "--gcstats") == 0)
+        {
+            gcstats = true;
+        }
+        else if (strcmp(argv[i], "--hugepages") == 0)
+        {
+            hugePages = true;
+        }
+        else if (strcmp(argv[i], "--tablefeedback") == 0)
+        {
+            tableFeedback = true;
+        }
+        else if (strcmp(argv[i], "--opcodes") == 0)
+        {
+            opcodes = true;
+        }
         else if (strcmp(argv[i], "--timetrace") == 0)
         {
             FFlag::DebugLuauTimeTracing.value = true;
         }
+        else if (strncmp(argv[i], "--bytecode-cache=", 17) == 0)
+        {
+            globalOptions.bytecodeCache = argv[i] + 17;
+
+            if (!isDirectory(globalOptions.bytecodeCache))
+            {
+                fprintf(stderr, "Error: bytecode cache directory '%s' doesn't exist.\n", globalOptions.bytecodeCache.c_str());
+                return 1;
+            }
+        }
+        else if (strncmp(argv[i], "--bytecode-bundle=", 18) == 0)
+        {
+            std::optional<BytecodeBundleFile> bundle = BytecodeBundleFile::open(argv[i] + 18);
+
+            if (!bundle)
+            {
+                fprintf(stderr, "Error: bytecode bundle '%s' can't be read.\n", argv[i] + 18);
+                return 1;
+            }
+
+            preloadModuleBundle(std::move(*bundle));
+        }
+        else if (strncmp(argv[i], "--write-bytecode-bundle=", 24) == 0)
+        {
+            globalOptions.bytecodeBundleOutput = argv[i] + 24;
+        }
         else if (strncmp(argv[i], "--fflags=", 9) == 0)
         {
             setLuauFlags(argv[i] + 9);
@@ -819,15 +1091,26 @@ int replMain(int argc, char** argv)
     if (codegenPerf)
     {
 #if __linux__
-        char path[128];
-        snprintf(path, sizeof(path), "/tmp/perf-%d.map", getpid());
+        if (codegenJitDump)
+        {
+            if (!startJitDump())
+            {
+                fprintf(stderr, "Error: failed to create the jitdump file\n");
+                return 1;
+            }
+        }
+        else
+        {
+            char path[128];
+            snprintf(path, sizeof(path), "/tmp/perf-%d.map", getpid());
 
-        // note, there's no need to close the log explicitly as it will be closed when the process exits
-        FILE* codegenPerfLog = fopen(path, "w");
+            // note, there's no need to close the log explicitly as it will be closed when the process exits
+            FILE* codegenPerfLog = fopen(path, "w");
 
-        Luau::CodeGen::setPerfLog(codegenPerfLog, [](void* context, uintptr_t addr, unsigned size, const char* symbol) {
-            fprintf(static_cast<FILE*>(context), "%016lx %08x %s\n", long(addr), size, symbol);
-        });
+            Luau::CodeGen::setPerfLog(codegenPerfLog, [](void* context, uintptr_t addr, unsigned size, const char* symbol) {
+                fprintf(static_cast<FILE*>(context), "%016lx %08x %s\n", long(addr), size, symbol);
+            });
+        }
 #else
         fprintf(stderr, "--codegen-perf option is only supported on Linux\n");
         return 1;
@@ -846,17 +1129,36 @@ int replMain(int argc, char** argv)
     }
     else
     {
-        std::unique_ptr<lua_State, void (*)(lua_State*)> globalState(luaL_newstate(), lua_close);
+        // allocations are counted by the allocator itself since the VM only tracks the current heap size
+        std::unique_ptr<lua_State, void (*)(lua_State*)> globalState(gcstats ? lua_newstate(gcStatsAlloc, nullptr) : luaL_newstate(), lua_close);
         lua_State* L = globalState.get();
 
+        if (hugePages)
+            pageSourceInit(L);
+
         setupState(L);
 
+        if (gcstats)
+            gcStatsInit(L);
+
         if (profile)
             profilerStart(L, profile);
 
+        if (heapProfile)
+            heapProfilerStart(L, heapProfile);
+
         if (coverage)
             coverageInit(L);
 
+        if (coverageFirstHit)
+            lua_setcoveragefirsthit(L, 1);
+
+        if (opcodes)
+            opcodeStatsInit(L);
+
+        if (tableFeedback)
+            lua_settablefeedback(L, 1);
+
         int failed = 0;
 
         for (size_t i = 0; i < files.size(); ++i)
@@ -871,9 +1173,32 @@ int replMain(int argc, char** argv)
             profilerDump("profile.out");
         }
 
+        if (heapProfile)
+            heapProfilerDump(L, "heap.out");
+
         if (coverage)
             coverageDump("coverage.out");
 
+        if (opcodes)
+            opcodeStatsDump("opcodes.out");
+
+        if (gcstats)
+            gcStatsDump("gcstats.out");
+
+        if (!globalOptions.bytecodeBundleOutput.empty() && !writeBytecodeBundle(globalOptions.bytecodeBundleOutput, requiredModules))
+        {
+            fprintf(stderr, "Error: bytecode bundle '%s' can't be written.\n", globalOptions.bytecodeBundleOutput.c_str());
+            failed++;
+        }
+
+        if (eventLoop && eventLoop->getFailedTaskCount() != 0)
+            failed++;
+
+        if (codegenStats)
+            printf("Codegen: %u/%u functions, %zu bytes bytecode => %zu bytes native code, %zu bytes data, %zu bytes metadata, %f seconds\n",
+                codegenTotals.functionsCompiled, codegenTotals.functionsTotal, codegenTotals.bytecodeSizeBytes, codegenTotals.nativeCodeSizeBytes,
+                codegenTotals.nativeDataSizeBytes, codegenTotals.nativeMetadataSizeBytes, codegenTime);
+
         return failed ? 1 : 0;
     }
 }
@@ -6,8 +6,69 @@
 
 #include <algorithm>
 #include <array>
+#include <unordered_map>
 #include <utility>
 
+// Configuration files are only read once per directory; the parsed contribution of each file is merged into resolver's config
+struct DirectoryConfig
+{
+    std::string error;
+
+    std::vector<std::string> paths;
+    std::unordered_map<std::string, std::string> aliases;
+};
+
+static std::unordered_map<std::string, DirectoryConfig> configCache;
+
+// Maps the requiring chunk and the required path to the key of the module in _MODULES, so that repeated requires skip path resolution
+static std::unordered_map<std::string, std::string> resolvedPathCache;
+
+static std::unordered_map<std::string, std::string> preloadedModules;
+static std::vector<BytecodeBundleFile> preloadedBundles;
+
+void preloadModuleBytecode(std::string path, std::string bytecode)
+{
+    preloadedModules[std::move(path)] = std::move(bytecode);
+}
+
+void preloadModuleBundle(BytecodeBundleFile bundle)
+{
+    preloadedBundles.push_back(std::move(bundle));
+}
+
+static std::optional<std::string_view> findPreloadedModuleBytecodeExact(std::string_view path)
+{
+    if (auto it = preloadedModules.find(std::string(path)); it != preloadedModules.end())
+        return it->second;
+
+    for (const BytecodeBundleFile& bundle : preloadedBundles)
+        if (std::optional<std::string_view> bytecode = bundle.find(path))
+            return bytecode;
+
+    return std::nullopt;
+}
+
+std::optional<std::string_view> findPreloadedModuleBytecode(const std::string& path)
+{
+    if (preloadedModules.empty() && preloadedBundles.empty())
+        return std::nullopt;
+
+    if (std::optional<std::string_view> bytecode = findPreloadedModuleBytecodeExact(path))
+        return bytecode;
+
+    // bundles made for deployment store paths relative to the directory they are run from
+    static const std::string cwd = [] {
+        std::string result = getCurrentWorkingDirectory().value_or("");
+        std::replace(result.begin(), result.end(), '\\', '/');
+        return result;
+    }();
+
+    if (!cwd.empty() && path.size() > cwd.size() && path.compare(0, cwd.size(), cwd) == 0 && path[cwd.size()] == '/')
+        return findPreloadedModuleBytecodeExact(std::string_view(path).substr(cwd.size() + 1));
+
+    return std::nullopt;
+}
+
 RequireResolver::RequireResolver(lua_State* L, std::string path)
     : pathToResolve(std::move(path))
     , L(L)
@@ -29,12 +90,34 @@ RequireResolver::RequireResolver(lua_State* L, std::string path)
 
 [[nodiscard]] RequireResolver::ResolvedRequire RequireResolver::resolveRequire(lua_State* L, std::string path)
 {
+    lua_Debug ar;
+    lua_getinfo(L, 1, "s", &ar);
+
+    std::string cacheKey = std::string(ar.source) + '\n' + path;
+
+    if (auto it = resolvedPathCache.find(cacheKey); it != resolvedPathCache.end())
+    {
+        luaL_findtable(L, LUA_REGISTRYINDEX, "_MODULES", 1);
+
+        lua_getfield(L, -1, it->second.c_str());
+        if (!lua_isnil(L, -1))
+            return ResolvedRequire{ModuleStatus::Cached};
+
+        // module isn't loaded in this state yet (e.g. it's a different state or a cyclic require), so the path has to be resolved again
+        lua_pop(L, 2);
+    }
+
     RequireResolver resolver(L, std::move(path));
     ModuleStatus status = resolver.findModule();
+
+    if (status != ModuleStatus::NotFound)
+        resolvedPathCache[std::move(cacheKey)] = resolver.absolutePath;
+
     if (status != ModuleStatus::FileRead)
         return ResolvedRequire{status};
     else
-        return ResolvedRequire{status, std::move(resolver.chunkname), std::move(resolver.absolutePath), std::move(resolver.sourceCode)};
+        return ResolvedRequire{
+            status, std::move(resolver.chunkname), std::move(resolver.absolutePath), std::move(resolver.sourceCode), resolver.bytecode};
 }
 
 RequireResolver::ModuleStatus RequireResolver::findModule()
@@ -98,6 +181,14 @@ RequireResolver::ModuleStatus RequireResolver::findModuleImpl()
         }
         lua_pop(L, 1);
 
+        // Preloaded bytecode doesn't need the source
+        if (std::optional<std::string_view> preloaded = findPreloadedModuleBytecode(absolutePath))
+        {
+            chunkname = "=" + chunkname + possibleSuffix;
+            bytecode = preloaded;
+            return ModuleStatus::FileRead;
+        }
+
         // Try to read the matching file
         std::optional<std::string> source = readFile(absolutePath);
         if (source)
@@ -262,28 +353,57 @@ void RequireResolver::parseNextConfig()
         isConfigFullyResolved = true;
 }
 
-void RequireResolver::parseConfigInDirectory(const std::string& directory)
+static DirectoryConfig parseDirectoryConfig(const std::string& directory)
 {
     std::string configPath = joinPaths(directory, Luau::kConfigName);
 
-    size_t numPaths = config.paths.size();
+    DirectoryConfig result;
+    Luau::Config config;
 
     if (std::optional<std::string> contents = readFile(configPath))
     {
         std::optional<std::string> error = Luau::parseConfig(*contents, config);
         if (error)
-            luaL_errorL(L, "error parsing %s (%s)", configPath.c_str(), (*error).c_str());
+        {
+            result.error = "error parsing " + configPath + " (" + *error + ")";
+            return result;
+        }
     }
 
     // Resolve any newly obtained relative paths in "paths" in relation to configPath
-    for (auto it = config.paths.begin() + numPaths; it != config.paths.end(); ++it)
+    for (std::string& path : config.paths)
     {
-        if (!isAbsolutePath(*it))
+        if (!isAbsolutePath(path))
         {
-            if (std::optional<std::string> resolvedPath = resolvePath(*it, configPath))
-                *it = std::move(*resolvedPath);
+            if (std::optional<std::string> resolvedPath = resolvePath(path, configPath))
+                path = std::move(*resolvedPath);
             else
-                luaL_errorL(L, "error requiring module");
+            {
+                result.error = "error requiring module";
+                return result;
+            }
         }
     }
+
+    result.paths = std::move(config.paths);
+    result.aliases = std::move(config.aliases);
+    return result;
+}
+
+void RequireResolver::parseConfigInDirectory(const std::string& directory)
+{
+    auto it = configCache.find(directory);
+    if (it == configCache.end())
+        it = configCache.emplace(directory, parseDirectoryConfig(directory)).first;
+
+    const DirectoryConfig& directoryConfig = it->second;
+
+    if (!directoryConfig.error.empty())
+        luaL_errorL(L, "%s", directoryConfig.error.c_str());
+
+    config.paths.insert(config.paths.end(), directoryConfig.paths.begin(), directoryConfig.paths.end());
+
+    // aliases of closer configuration files take precedence
+    for (const auto& [alias, value] : directoryConfig.aliases)
+        config.aliases.try_emplace(alias, value);
 }
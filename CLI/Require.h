@@ -6,6 +6,9 @@
 
 #include "Luau/Config.h"
 
+#include "BytecodeCache.h"
+
+#include <optional>
 #include <string>
 #include <string_view>
 
@@ -15,6 +18,7 @@ public:
     std::string chunkname;
     std::string absolutePath;
     std::string sourceCode;
+    std::optional<std::string_view> bytecode;
 
     enum class ModuleStatus
     {
@@ -29,6 +33,9 @@ public:
         std::string chunkName;
         std::string absolutePath;
         std::string sourceCode;
+
+        // set instead of the source code when the module was preloaded from a bytecode bundle
+        std::optional<std::string_view> bytecode;
     };
 
     [[nodiscard]] ResolvedRequire static resolveRequire(lua_State* L, std::string path);
@@ -60,3 +67,9 @@ private:
     void parseNextConfig();
     void parseConfigInDirectory(const std::string& path);
 };
+
+// Modules preloaded from a bytecode bundle are found without reading or compiling their source
+// Modules are looked up by the path of the module file, either absolute or relative to the current directory
+void preloadModuleBytecode(std::string path, std::string bytecode);
+void preloadModuleBundle(BytecodeBundleFile bundle);
+std::optional<std::string_view> findPreloadedModuleBytecode(const std::string& path);
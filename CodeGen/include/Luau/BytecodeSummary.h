@@ -67,6 +67,20 @@ public:
         return counts[nesting];
     }
 
+    // Counts of instruction pairs that follow each other in the bytecode, indexed by first * getOpLimit() + second
+    // These are used to find candidates for superinstructions
+    void incPairCount(uint8_t first, uint8_t second)
+    {
+        CODEGEN_ASSERT(first < getOpLimit() && second < getOpLimit());
+        ++pairCounts[first * getOpLimit() + second];
+    }
+
+    unsigned getPairCount(uint8_t first, uint8_t second) const
+    {
+        CODEGEN_ASSERT(first < getOpLimit() && second < getOpLimit());
+        return pairCounts[first * getOpLimit() + second];
+    }
+
     static FunctionBytecodeSummary fromProto(Proto* proto, unsigned nestingLimit);
 
 private:
@@ -75,6 +89,7 @@ private:
     int line;
     unsigned nestingLimit;
     std::vector<std::vector<unsigned>> counts;
+    std::vector<unsigned> pairCounts;
 };
 
 std::vector<FunctionBytecodeSummary> summarizeBytecode(lua_State* L, int idx, unsigned nestingLimit);
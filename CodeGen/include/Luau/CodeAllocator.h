@@ -27,10 +27,19 @@ struct CodeAllocator
     bool allocate(
         const uint8_t* data, size_t dataSize, const uint8_t* code, size_t codeSize, uint8_t*& result, size_t& resultSize, uint8_t*& resultCodeStart);
 
+    // Releases the allocation returned by 'allocate' when its code can no longer be executed
+    // Block memory is returned to the system once all allocations placed in it are released
+    void deallocate(uint8_t* result);
+
+    // Finds the start of the block that holds the allocation returned by 'allocate'
+    // 'liveAllocations' is set to the number of allocations from that block that haven't been released
+    uint8_t* findBlock(uint8_t* result, size_t& liveAllocations) const;
+
     // Provided to unwind info callbacks
     void* context = nullptr;
 
     // Called when new block is created to create and setup the unwinding information for all the code in the block
+    // Unwind information is registered once per block, so registration and lookup costs don't grow with the number of functions
     // 'startOffset' reserves space for data at the beginning of the page
     void* (*createBlockUnwindInfo)(void* context, uint8_t* block, size_t blockSize, size_t& startOffset) = nullptr;
 
@@ -42,18 +51,31 @@ private:
     // But to simplify block space checks, we limit the max size of all that data
     static const size_t kMaxReservedDataSize = 256;
 
+    struct Block
+    {
+        uint8_t* memory = nullptr;
+        void* unwindInfo = nullptr;
+
+        // Number of allocations in the block that haven't been released
+        size_t liveAllocations = 0;
+    };
+
     bool allocateNewBlock(size_t& unwindInfoSize);
+    void freeBlock(size_t index);
+
+    // Returns the index of the block that contains 'pos' or the number of blocks if there is none
+    size_t findBlockIndex(uint8_t* pos) const;
 
     uint8_t* allocatePages(size_t size) const;
     void freePages(uint8_t* mem, size_t size) const;
 
     // Current block we use for allocations
+    uint8_t* currentBlock = nullptr;
     uint8_t* blockPos = nullptr;
     uint8_t* blockEnd = nullptr;
 
-    // All allocated blocks
-    std::vector<uint8_t*> blocks;
-    std::vector<void*> unwindInfos;
+    // All allocated blocks sorted by address, so that the block of an allocation is found with a binary search
+    std::vector<Block> blocks;
 
     size_t blockSize = 0;
     size_t maxTotalSize = 0;
@@ -2,6 +2,7 @@
 #pragma once
 
 #include <algorithm>
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -21,6 +22,12 @@ enum CodeGenFlags
     CodeGen_OnlyNativeModules = 1 << 0,
     // Run native codegen for functions that the compiler considers not profitable
     CodeGen_ColdFunctions = 1 << 1,
+    // Start functions in the interpreter and compile each one once it's called or loops often enough; only supported by 'compile'
+    CodeGen_Tiered = 1 << 2,
+    // Count function entries and bytecode block executions in native code, see 'getFunctionProfiles'; ignored by 'compileToCache'
+    CodeGen_Profile = 1 << 3,
+    // Coverage instructions in native code only record the first hit, to be used with 'lua_setcoveragefirsthit'
+    CodeGen_CoverageFirstHit = 1 << 4,
 };
 
 // These enum values can be reported through telemetry.
@@ -38,6 +45,7 @@ enum class CodeGenCompilationResult
     CodeGenAssemblerFinalizationFailure = 7,  // Failure during assembler finalization
     CodeGenLoweringFailure = 8,               // Lowering failed
     AllocationFailed = 9,                     // Native codegen failed due to an allocation error
+    CodeGenCacheMismatch = 10,                // Native code cache was produced for different bytecode, build or hardware
 };
 
 struct CompilationStats
@@ -51,6 +59,23 @@ struct CompilationStats
     uint32_t functionsCompiled = 0;
 };
 
+struct BlockProfile
+{
+    int pc = 0;
+    int line = 0;
+
+    uint64_t executions = 0;
+};
+
+struct FunctionProfile
+{
+    std::string name;
+    int line = 0;
+
+    uint64_t entries = 0;
+    std::vector<BlockProfile> blocks;
+};
+
 using AllocationCallback = void(void* context, void* oldPointer, size_t oldSize, void* newPointer, size_t newSize);
 
 bool isSupported();
@@ -61,6 +86,28 @@ void create(lua_State* L);
 // Builds target function and all inner functions
 CodeGenCompilationResult compile(lua_State* L, int idx, unsigned int flags = 0, CompilationStats* stats = nullptr);
 
+// Builds target function and all inner functions with IR translation and lowering performed by a task passed to 'executeTask'
+// 'executeTask' is allowed to call the 'task' function on any thread and return without waiting for 'task' to complete
+// Generated code is not used until 'installAsyncCompilations' is called on the thread that owns the VM
+CodeGenCompilationResult compileAsync(
+    lua_State* L, int idx, std::function<void(std::function<void()> task)> executeTask, unsigned int flags = 0);
+
+// Places native code of finished asynchronous compilations into executable memory and enables it for the compiled functions
+// When 'wait' is set, waits for all pending compilations to finish; returns the number of modules that were installed
+size_t installAsyncCompilations(lua_State* L, bool wait = false);
+
+// Builds target function and all inner functions like 'compile' and serializes the generated code into 'cache'
+// Cache can only be loaded by the same build of the host running on the same hardware, and should be keyed by the host version
+CodeGenCompilationResult compileToCache(lua_State* L, int idx, std::string& cache, unsigned int flags = 0, CompilationStats* stats = nullptr);
+
+// Loads native code for target function and all inner functions from a cache produced by 'compileToCache' for the same bytecode
+// This skips IR translation and lowering; if CodeGenCacheMismatch is returned, 'compile' can be used instead
+CodeGenCompilationResult loadFromCache(lua_State* L, int idx, const char* cache, size_t cacheSize);
+
+// Reads execution counters of target function and all inner functions that are running native code compiled with CodeGen_Profile
+// Functions are identified by their name and the line they are defined at; blocks are identified by their bytecode position and line
+std::vector<FunctionProfile> getFunctionProfiles(lua_State* L, int idx);
+
 using AnnotatorFn = void (*)(void* context, std::string& result, int fid, int instpos);
 
 // Output "#" before IR blocks and instructions
@@ -143,6 +190,32 @@ struct BlockLinearizationStats
     }
 };
 
+// time spent in each code generation phase, recorded when lowering stats are requested
+struct PhaseTimeStats
+{
+    double irBuildSeconds = 0.0;
+    double optimizeSeconds = 0.0;
+    double loweringSeconds = 0.0;
+    double finalizeSeconds = 0.0;
+
+    PhaseTimeStats& operator+=(const PhaseTimeStats& that)
+    {
+        this->irBuildSeconds += that.irBuildSeconds;
+        this->optimizeSeconds += that.optimizeSeconds;
+        this->loweringSeconds += that.loweringSeconds;
+        this->finalizeSeconds += that.finalizeSeconds;
+
+        return *this;
+    }
+
+    PhaseTimeStats operator+(const PhaseTimeStats& other) const
+    {
+        PhaseTimeStats result(*this);
+        result += other;
+        return result;
+    }
+};
+
 enum FunctionStatsFlags
 {
     // Enable stats collection per function
@@ -177,6 +250,7 @@ struct LoweringStats
     int loweringErrors = 0;
 
     BlockLinearizationStats blockLinearizationStats;
+    PhaseTimeStats phaseTimeStats;
 
     unsigned functionStatsFlags = 0;
     std::vector<FunctionStats> functions;
@@ -201,6 +275,7 @@ struct LoweringStats
         this->regAllocErrors += that.regAllocErrors;
         this->loweringErrors += that.loweringErrors;
         this->blockLinearizationStats += that.blockLinearizationStats;
+        this->phaseTimeStats += that.phaseTimeStats;
         if (this->functionStatsFlags & FunctionStats_Enable)
             this->functions.insert(this->functions.end(), that.functions.begin(), that.functions.end());
         return *this;
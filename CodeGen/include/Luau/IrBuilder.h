@@ -4,6 +4,7 @@
 #include "Luau/Bytecode.h"
 #include "Luau/Common.h"
 #include "Luau/DenseHash.h"
+#include "Luau/FlatHash.h"
 #include "Luau/IrData.h"
 
 #include <vector>
@@ -68,6 +69,12 @@ struct IrBuilder
 
     bool interruptRequested = false;
 
+    // Function entry and bytecode blocks increment execution counters for profiling
+    bool countExecutions = false;
+
+    // Coverage instructions are replaced with a reached marker instead of counting hits
+    bool coverageFirstHit = false;
+
     bool activeFastcallFallback = false;
     IrOp fastcallFallbackReturn;
     int fastcallSkipTarget = -1;
@@ -123,7 +130,7 @@ struct IrBuilder
         }
     };
 
-    DenseHashMap<ConstantKey, uint32_t, ConstantKeyHash> constantMap;
+    FlatHashMap<ConstantKey, uint32_t, ConstantKeyHash> constantMap;
 };
 
 } // namespace CodeGen
@@ -180,6 +180,7 @@ enum class IrCmd : uint8_t
 
     // Add/Sub/Mul/Div/Idiv two vectors
     // A, B: TValue
+    // Result is a vector without a tag, which is added by TAG_VECTOR before the value is stored
     ADD_VEC,
     SUB_VEC,
     MUL_VEC,
@@ -264,6 +265,11 @@ enum class IrCmd : uint8_t
     // A: pointer (string)
     STRING_LEN,
 
+    // Read u8 (zero-extended to int) from string data at specified offset
+    // A: pointer (string)
+    // B: int (offset)
+    STRING_READU8,
+
     // Allocate new table
     // A: unsigned int (array element count)
     // B: unsigned int (node element count)
@@ -306,6 +312,10 @@ enum class IrCmd : uint8_t
     // A: double
     NUM_TO_VECTOR,
 
+    // Adds the tag to the vector, when it is stored as a TValue
+    // A: TValue (vector)
+    TAG_VECTOR,
+
     // Adjust stack top (L->top) to point at 'B' TValues *after* the specified register
     // This is used to return multiple values
     // A: Rn
@@ -454,12 +464,23 @@ enum class IrCmd : uint8_t
     // When undef is specified instead of a block, execution is aborted on check failure
     CHECK_BUFFER_LEN,
 
+    // Guard against a single byte access at specified offset being outside of the string
+    // A: pointer (string)
+    // B: int (offset)
+    // C: block/vmexit/undef
+    // When undef is specified instead of a block, execution is aborted on check failure
+    CHECK_STRING_LEN,
+
     // Special operations
 
     // Check interrupt handler
     // A: unsigned int (pcpos)
     INTERRUPT,
 
+    // Increment an execution counter of a function compiled for profiling
+    // A: unsigned int (counter index)
+    INCREMENT_COUNTER,
+
     // Check and run GC assist if necessary
     CHECK_GC,
 
@@ -507,6 +528,7 @@ enum class IrCmd : uint8_t
     // A: Rn (function, followed by arguments)
     // B: int (argument count or -1 to use all arguments up to stack top)
     // C: int (result count or -1 to preserve all results and adjust stack top)
+    // D: int (1 if this is a tail call that may reuse the current frame, see LOP_TAILCALL) or none
     // Note: return values are placed starting from Rn specified in 'A'
     CALL,
 
@@ -538,6 +560,7 @@ enum class IrCmd : uint8_t
 
     // Increment coverage data (saturating 24 bit add)
     // A: unsigned int (bytecode instruction index)
+    // B: int (when 1, the instruction is replaced with NOP that marks it as reached instead)
     COVERAGE,
 
     // Operations that have a translation, but use a full instruction fallback
@@ -638,10 +661,11 @@ enum class IrCmd : uint8_t
     // A: int
     BYTESWAP_UINT,
 
-    // Calls native libm function with 1 or 2 arguments
+    // Calls native libm function with 1, 2 or 3 arguments
     // A: builtin function ID
     // B: double
     // C: double/int (optional, 2nd argument)
+    // D: double (optional, 3rd argument)
     INVOKE_LIBM,
 
     // Returns the string name of a type based on tag, alternative for type(x)
@@ -991,6 +1015,9 @@ struct IrFunction
     Proto* proto = nullptr;
     bool variadic = false;
 
+    // Bytecode positions of execution counters when the function is compiled for profiling; first counter is for function entry
+    std::vector<uint32_t> counterPcs;
+
     CfgInfo cfg;
 
     IrBlock& blockOp(IrOp op)
@@ -129,6 +129,7 @@ inline bool isNonTerminatingJump(IrCmd cmd)
     case IrCmd::CHECK_NODE_NO_NEXT:
     case IrCmd::CHECK_NODE_VALUE:
     case IrCmd::CHECK_BUFFER_LEN:
+    case IrCmd::CHECK_STRING_LEN:
         return true;
     default:
         break;
@@ -178,6 +179,7 @@ inline bool hasResult(IrCmd cmd)
     case IrCmd::TABLE_LEN:
     case IrCmd::TABLE_SETNUM:
     case IrCmd::STRING_LEN:
+    case IrCmd::STRING_READU8:
     case IrCmd::NEW_TABLE:
     case IrCmd::DUP_TABLE:
     case IrCmd::TRY_NUM_TO_INDEX:
@@ -187,6 +189,7 @@ inline bool hasResult(IrCmd cmd)
     case IrCmd::NUM_TO_INT:
     case IrCmd::NUM_TO_UINT:
     case IrCmd::NUM_TO_VECTOR:
+    case IrCmd::TAG_VECTOR:
     case IrCmd::SUBSTITUTE:
     case IrCmd::INVOKE_FASTCALL:
     case IrCmd::BITAND_UINT:
@@ -236,6 +239,62 @@ inline bool isPseudo(IrCmd cmd)
     return cmd == IrCmd::NOP || cmd == IrCmd::SUBSTITUTE;
 }
 
+// Stores which only update the value part of the VM register and keep its tag
+inline bool isTagPreservingStore(IrCmd cmd)
+{
+    switch (cmd)
+    {
+    case IrCmd::STORE_POINTER:
+    case IrCmd::STORE_DOUBLE:
+    case IrCmd::STORE_INT:
+    case IrCmd::STORE_VECTOR:
+    case IrCmd::STORE_EXTRA:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Visitor for visitVmRegDefsUses that only cares about VM registers which might be written to
+// Derived type receives each of them in 'defReg(int reg)'
+template<typename Derived>
+struct VmRegDefVisitor
+{
+    void def(IrOp op, int offset = 0)
+    {
+        static_cast<Derived*>(this)->defReg(vmRegOp(op) + offset);
+    }
+
+    void use(IrOp op, int offset = 0) {}
+
+    void maybeDef(IrOp op)
+    {
+        if (op.kind == IrOpKind::VmReg)
+            static_cast<Derived*>(this)->defReg(vmRegOp(op));
+    }
+
+    void maybeUse(IrOp op) {}
+
+    void useVarargs(uint8_t varargStart) {}
+
+    void defRange(int start, int count)
+    {
+        // Variadic sequence can extend to any register after the start
+        int end = count == -1 ? 256 : start + count;
+
+        for (int i = start; i < end; i++)
+            static_cast<Derived*>(this)->defReg(i);
+    }
+
+    void useRange(int start, int count) {}
+
+    void capture(int reg) {}
+};
+
+// Returns the VM register which tag is checked by the instruction at 'index', as long as the tag is loaded in the same block without changes in
+// between; returns -1 otherwise
+int getCheckedVmReg(IrFunction& function, const IrBlock& block, uint32_t index);
+
 IrValueKind getCmdValueKind(IrCmd cmd);
 
 bool isGCO(uint8_t tag);
@@ -283,6 +342,7 @@ void killUnusedBlocks(IrFunction& function);
 // Get blocks in order that tries to maximize fallthrough between them during lowering
 // We want to mostly preserve build order with fallbacks outlined
 // But we also use hints from optimization passes that chain blocks together where there's only one out-in edge between them
+// Blocks with a single predecessor are placed right after it when it would otherwise have to jump to them
 std::vector<uint32_t> getSortedBlockOrder(IrFunction& function);
 
 // Returns first non-dead block that comes after block at index 'i' in the sorted blocks array
@@ -80,6 +80,7 @@ static void visitVmRegDefsUses(T& visitor, IrFunction& function, const IrInst& i
         visitor.use(inst.b);
         break;
     case IrCmd::INTERRUPT:
+    case IrCmd::INCREMENT_COUNTER:
         break;
     case IrCmd::BARRIER_OBJ:
     case IrCmd::BARRIER_TABLE_FORWARD:
@@ -212,6 +212,12 @@ static void applyBuiltinCall(int bfid, BytecodeTypes& types)
         types.result = LBC_TYPE_NUMBER;
         types.a = LBC_TYPE_NUMBER;
         break;
+    case LBF_MATH_NOISE:
+        types.result = LBC_TYPE_NUMBER;
+        types.a = LBC_TYPE_NUMBER;
+        types.b = LBC_TYPE_NUMBER; // We can mark optional arguments
+        types.c = LBC_TYPE_NUMBER;
+        break;
     case LBF_RAWGET:
         types.result = LBC_TYPE_ANY;
         types.a = LBC_TYPE_TABLE;
@@ -317,6 +323,18 @@ static void applyBuiltinCall(int bfid, BytecodeTypes& types)
         types.b = LBC_TYPE_NUMBER;
         types.c = LBC_TYPE_NUMBER;
         break;
+    case LBF_BUFFER_FIND:
+        types.result = LBC_TYPE_ANY;
+        types.a = LBC_TYPE_BUFFER;
+        types.b = LBC_TYPE_NUMBER;
+        types.c = LBC_TYPE_STRING;
+        break;
+    case LBF_BUFFER_EQUAL:
+        types.result = LBC_TYPE_BOOLEAN;
+        types.a = LBC_TYPE_BUFFER;
+        types.b = LBC_TYPE_NUMBER;
+        types.c = LBC_TYPE_BUFFER;
+        break;
     case LBF_TABLE_INSERT:
         types.result = LBC_TYPE_NIL;
         types.a = LBC_TYPE_TABLE;
@@ -474,6 +492,18 @@ void analyzeBytecodeTypes(IrFunction& function)
                 bcType.result = regTags[ra];
                 break;
             }
+            case LOP_MOVE2:
+            {
+                int ra = LUAU_INSN_A(*pc);
+                int rb = LUAU_INSN_B(*pc);
+                int rc = pc[1] & 0xff;
+                int rd = (pc[1] >> 8) & 0xff;
+                bcType.a = regTags[rb];
+                regTags[ra] = regTags[rb];
+                regTags[rc] = regTags[rd];
+                bcType.result = regTags[ra];
+                break;
+            }
             case LOP_GETTABLE:
             {
                 int rb = LUAU_INSN_B(*pc);
@@ -836,6 +866,7 @@ void analyzeBytecodeTypes(IrFunction& function)
             case LOP_GETGLOBAL:
             case LOP_SETGLOBAL:
             case LOP_CALL:
+            case LOP_TAILCALL:
             case LOP_RETURN:
             case LOP_JUMP:
             case LOP_JUMPBACK:
@@ -24,6 +24,8 @@ FunctionBytecodeSummary::FunctionBytecodeSummary(std::string source, std::string
     {
         counts.push_back(std::vector<unsigned>(getOpLimit(), 0));
     }
+
+    pairCounts.resize(getOpLimit() * getOpLimit(), 0);
 }
 
 FunctionBytecodeSummary FunctionBytecodeSummary::fromProto(Proto* proto, unsigned nestingLimit)
@@ -37,11 +39,18 @@ FunctionBytecodeSummary FunctionBytecodeSummary::fromProto(Proto* proto, unsigne
 
     FunctionBytecodeSummary summary(source, name, line, nestingLimit);
 
+    int prevOp = -1;
+
     for (int i = 0; i < proto->sizecode;)
     {
         Instruction insn = proto->code[i];
         uint8_t op = LUAU_INSN_OP(insn);
         summary.incCount(0, op);
+
+        if (prevOp >= 0)
+            summary.incPairCount(uint8_t(prevOp), op);
+
+        prevOp = op;
         i += Luau::getOpLength(LuauOpcode(op));
     }
 
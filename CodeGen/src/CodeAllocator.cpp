@@ -3,6 +3,8 @@
 
 #include "Luau/CodeGenCommon.h"
 
+#include <algorithm>
+
 #include <string.h>
 
 #if defined(_WIN32)
@@ -124,14 +126,13 @@ CodeAllocator::CodeAllocator(size_t blockSize, size_t maxTotalSize, AllocationCa
 
 CodeAllocator::~CodeAllocator()
 {
-    if (destroyBlockUnwindInfo)
+    for (const Block& block : blocks)
     {
-        for (void* unwindInfo : unwindInfos)
-            destroyBlockUnwindInfo(context, unwindInfo);
-    }
+        if (destroyBlockUnwindInfo && block.unwindInfo)
+            destroyBlockUnwindInfo(context, block.unwindInfo);
 
-    for (uint8_t* block : blocks)
-        freePages(block, blockSize);
+        freePages(block.memory, blockSize);
+    }
 }
 
 bool CodeAllocator::allocate(
@@ -149,7 +150,7 @@ bool CodeAllocator::allocate(
     size_t startOffset = 0;
 
     // We might need a new block
-    if (totalSize > size_t(blockEnd - blockPos))
+    if (!blockPos || totalSize > size_t(blockEnd - blockPos))
     {
         if (!allocateNewBlock(startOffset))
             return false;
@@ -176,6 +177,8 @@ bool CodeAllocator::allocate(
     resultSize = totalSize;
     resultCodeStart = blockPos + codeOffset;
 
+    blocks[findBlockIndex(currentBlock)].liveAllocations++;
+
     // Ensure that future allocations from the block start from a page boundary.
     // This is important since we use W^X, and writing to the previous page would require briefly removing
     // executable bit from it, which may result in access violations if that code is being executed concurrently.
@@ -194,6 +197,50 @@ bool CodeAllocator::allocate(
     return true;
 }
 
+void CodeAllocator::deallocate(uint8_t* result)
+{
+    size_t index = findBlockIndex(result);
+
+    if (index == blocks.size())
+    {
+        CODEGEN_ASSERT(!"allocation doesn't belong to any block");
+        return;
+    }
+
+    Block& block = blocks[index];
+    CODEGEN_ASSERT(block.liveAllocations > 0);
+
+    if (--block.liveAllocations == 0)
+        freeBlock(index);
+}
+
+uint8_t* CodeAllocator::findBlock(uint8_t* result, size_t& liveAllocations) const
+{
+    size_t index = findBlockIndex(result);
+
+    if (index == blocks.size())
+    {
+        CODEGEN_ASSERT(!"allocation doesn't belong to any block");
+        return nullptr;
+    }
+
+    liveAllocations = blocks[index].liveAllocations;
+    return blocks[index].memory;
+}
+
+size_t CodeAllocator::findBlockIndex(uint8_t* pos) const
+{
+    // Blocks are sorted by their address, the one holding 'pos' is the last block that starts at or before it
+    auto it = std::upper_bound(blocks.begin(), blocks.end(), pos, [](uint8_t* memory, const Block& entry) {
+        return memory < entry.memory;
+    });
+
+    if (it == blocks.begin() || pos >= (it - 1)->memory + blockSize)
+        return blocks.size();
+
+    return size_t(it - 1 - blocks.begin());
+}
+
 bool CodeAllocator::allocateNewBlock(size_t& unwindInfoSize)
 {
     // Stop allocating once we reach a global limit
@@ -207,8 +254,13 @@ bool CodeAllocator::allocateNewBlock(size_t& unwindInfoSize)
 
     blockPos = block;
     blockEnd = block + blockSize;
+    currentBlock = block;
 
-    blocks.push_back(block);
+    auto it = std::upper_bound(blocks.begin(), blocks.end(), block, [](uint8_t* memory, const Block& entry) {
+        return memory < entry.memory;
+    });
+
+    Block& newBlock = *blocks.insert(it, {block});
 
     if (createBlockUnwindInfo)
     {
@@ -222,12 +274,32 @@ bool CodeAllocator::allocateNewBlock(size_t& unwindInfoSize)
         if (!unwindInfo)
             return false;
 
-        unwindInfos.push_back(unwindInfo);
+        newBlock.unwindInfo = unwindInfo;
     }
 
     return true;
 }
 
+void CodeAllocator::freeBlock(size_t index)
+{
+    Block block = blocks[index];
+
+    if (destroyBlockUnwindInfo && block.unwindInfo)
+        destroyBlockUnwindInfo(context, block.unwindInfo);
+
+    freePages(block.memory, blockSize);
+
+    blocks.erase(blocks.begin() + index);
+
+    // Pages of the current block that are already executable can't be written to, so allocations will continue in a new block
+    if (block.memory == currentBlock)
+    {
+        blockPos = nullptr;
+        blockEnd = nullptr;
+        currentBlock = nullptr;
+    }
+}
+
 uint8_t* CodeAllocator::allocatePages(size_t size) const
 {
     const size_t pageAlignedSize = alignToPageSize(size);
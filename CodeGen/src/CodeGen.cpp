@@ -3,9 +3,11 @@
 
 #include "CodeGenLower.h"
 
+#include "Luau/BytecodeUtils.h"
 #include "Luau/Common.h"
 #include "Luau/CodeAllocator.h"
 #include "Luau/CodeBlockUnwind.h"
+#include "Luau/Hash.h"
 #include "Luau/IrBuilder.h"
 
 #include "Luau/UnwindBuilder.h"
@@ -23,8 +25,14 @@
 #include "lapi.h"
 #include "lmem.h"
 
+#include <algorithm>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <unordered_set>
+
+#include <string.h>
 
 #if defined(__x86_64__) || defined(_M_X64)
 #ifdef _MSC_VER
@@ -57,6 +65,12 @@ LUAU_FASTINTVARIABLE(CodegenHeuristicsBlockLimit, 32'768) // 32 K
 // Current value is based on some member variables being limited to 16 bits
 LUAU_FASTINTVARIABLE(CodegenHeuristicsBlockInstructionLimit, 65'536) // 64 K
 
+// Number of calls and loop iterations after which a function is compiled when using CodeGen_Tiered
+LUAU_FASTINTVARIABLE(CodegenTieredThreshold, 1000)
+
+// Number of calls that fail the entry guard of a function specialized for observed argument types before it's recompiled generically
+LUAU_FASTINTVARIABLE(CodegenSpeculationMissLimit, 100)
+
 LUAU_FASTFLAGVARIABLE(DisableNativeCodegenIfBreakpointIsSet, false)
 
 namespace Luau
@@ -74,13 +88,28 @@ struct NativeProto
     Proto* p;
     void* execdata;
     uintptr_t exectarget;
+
+    // Bytecode positions of execution counters placed in execdata
+    std::vector<uint32_t> counterPcs;
+};
+
+// Generated module before it's placed in executable memory
+struct NativeModule
+{
+    std::vector<NativeProto> results;
+    std::vector<uint8_t> data;
+    std::vector<uint8_t> code;
 };
 
 static NativeProto createNativeProto(Proto* proto, const IrBuilder& ir)
 {
     int sizecode = proto->sizecode;
 
-    uint32_t* instOffsets = new uint32_t[sizecode];
+    // Execution counters start at zero
+    size_t counterSize = ir.function.counterPcs.size() * sizeof(uint64_t);
+    size_t execdataSize = counterSize ? getExecDataCounterOffset(sizecode) + counterSize : sizecode * sizeof(uint32_t);
+
+    uint32_t* instOffsets = new uint32_t[execdataSize / sizeof(uint32_t)]();
     uint32_t instTarget = ir.function.entryLocation;
 
     for (int i = 0; i < sizecode; i++)
@@ -94,7 +123,7 @@ static NativeProto createNativeProto(Proto* proto, const IrBuilder& ir)
     instOffsets[0] = 0;
 
     // entry target will be relocated when assembly is finalized
-    return {proto, instOffsets, instTarget};
+    return {proto, instOffsets, instTarget, ir.function.counterPcs};
 }
 
 static void destroyExecData(void* execdata)
@@ -117,10 +146,12 @@ static void logPerfFunction(Proto* p, uintptr_t addr, unsigned size)
 }
 
 template<typename AssemblyBuilder>
-static std::optional<NativeProto> createNativeFunction(
-    AssemblyBuilder& build, ModuleHelpers& helpers, Proto* proto, uint32_t& totalIrInstCount, CodeGenCompilationResult& result)
+static std::optional<NativeProto> createNativeFunction(AssemblyBuilder& build, ModuleHelpers& helpers, Proto* proto, unsigned int flags,
+    uint32_t& totalIrInstCount, CodeGenCompilationResult& result)
 {
     IrBuilder ir;
+    ir.countExecutions = (flags & CodeGen_Profile) != 0;
+    ir.coverageFirstHit = (flags & CodeGen_CoverageFirstHit) != 0;
     ir.buildFunctionIr(proto);
 
     unsigned instCount = unsigned(ir.function.instructions.size());
@@ -143,31 +174,305 @@ static NativeState* getNativeState(lua_State* L)
     return static_cast<NativeState*>(L->global->ecb.context);
 }
 
+// Removes the function from the allocation that holds its code; the memory is released together with the last function
+static void releaseNativeCode(NativeState* data, Proto* proto)
+{
+    auto it = data->protoAllocations.find(proto);
+
+    if (it == data->protoAllocations.end())
+        return;
+
+    std::list<NativeAllocation>::iterator allocation = it->second.allocation;
+    allocation->protos[it->second.index] = nullptr;
+
+    data->protoAllocations.erase(it);
+    data->counterPcs.erase(proto);
+    data->disabledExecTargets.erase(proto);
+
+    if (--allocation->liveProtos == 0)
+    {
+        data->codeAllocator.deallocate(allocation->data);
+        data->allocations.erase(allocation);
+    }
+}
+
+static void gatherRunningNativeProtos(lua_State* th, std::unordered_set<Proto*>& running)
+{
+    for (CallInfo* ci = th->ci; ci > th->base_ci; ci--)
+    {
+        if (isLua(ci) && (ci->flags & LUA_CALLINFO_NATIVE) != 0)
+            running.insert(clvalue(ci->func)->l.p);
+    }
+}
+
+// Functions that have call frames executing native code on any thread, including suspended coroutines
+static std::unordered_set<Proto*> getRunningNativeProtos(lua_State* L)
+{
+    std::unordered_set<Proto*> running;
+
+    // Main thread is not allocated in GC pages
+    gatherRunningNativeProtos(L->global->mainthread, running);
+
+    luaM_visitgco(L, &running, [](void* context, lua_Page* page, GCObject* gco) {
+        if (gco->gch.tt == LUA_TTHREAD)
+            gatherRunningNativeProtos(gco2th(gco), *static_cast<std::unordered_set<Proto*>*>(context));
+
+        return false;
+    });
+
+    return running;
+}
+
+// Returns functions of the module to bytecode, which releases its code
+static void evictNativeModule(NativeState* data, NativeAllocation& allocation)
+{
+    // Allocation is destroyed together with its last function
+    std::vector<Proto*> protos = allocation.protos;
+
+    for (Proto* p : protos)
+    {
+        if (!p)
+            continue;
+
+        releaseNativeCode(data, p);
+
+        destroyExecData(p->execdata);
+        p->execdata = nullptr;
+        p->exectarget = 0;
+        p->codeentry = p->code;
+    }
+}
+
+// Executable pages can't be reused, so memory is only reclaimed when every allocation in a block is released
+// Modules of the oldest block that doesn't hold any running functions or other code are evicted together
+static bool evictNativeCodeBlock(NativeState* data, const std::unordered_set<Proto*>& running)
+{
+    std::unordered_map<uint8_t*, size_t> evictable;
+
+    for (NativeAllocation& allocation : data->allocations)
+    {
+        bool isRunning = std::any_of(allocation.protos.begin(), allocation.protos.end(), [&running](Proto* p) {
+            return p && running.count(p) != 0;
+        });
+
+        size_t liveAllocations = 0;
+        uint8_t* block = data->codeAllocator.findBlock(allocation.data, liveAllocations);
+
+        // Blocks with running functions are excluded entirely
+        if (isRunning)
+            evictable[block] = ~size_t(0);
+        else if (evictable[block] != ~size_t(0))
+            evictable[block]++;
+    }
+
+    for (NativeAllocation& allocation : data->allocations)
+    {
+        size_t liveAllocations = 0;
+        uint8_t* block = data->codeAllocator.findBlock(allocation.data, liveAllocations);
+
+        if (evictable[block] != liveAllocations)
+            continue;
+
+        for (auto it = data->allocations.begin(); it != data->allocations.end();)
+        {
+            NativeAllocation& candidate = *it++;
+
+            size_t candidateLiveAllocations = 0;
+            if (data->codeAllocator.findBlock(candidate.data, candidateLiveAllocations) == block)
+                evictNativeModule(data, candidate);
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+// When executable memory limit is reached, code of the least recently installed modules is evicted to release a block
+static bool allocateNativeCode(lua_State* L, NativeState* data, const uint8_t* moduleData, size_t dataSize, const uint8_t* moduleCode, size_t codeSize,
+    uint8_t*& nativeData, uint8_t*& codeStart)
+{
+    size_t sizeNativeData = 0;
+
+    if (data->codeAllocator.allocate(moduleData, dataSize, moduleCode, codeSize, nativeData, sizeNativeData, codeStart))
+        return true;
+
+    if (!evictNativeCodeBlock(data, getRunningNativeProtos(L)))
+        return false;
+
+    return data->codeAllocator.allocate(moduleData, dataSize, moduleCode, codeSize, nativeData, sizeNativeData, codeStart);
+}
+
+// Function bytecode for a compilation running on another thread; it's copied because breakpoints can modify it in the meantime
+struct ProtoSnapshot
+{
+    Proto* original = nullptr;
+    Proto copy;
+    std::vector<Instruction> code;
+};
+
+struct AsyncCompilation
+{
+    // Registry reference that keeps the functions alive until the compilation is installed
+    int ref = LUA_NOREF;
+
+    std::vector<ProtoSnapshot> snapshots;
+
+    NativeModule module;
+    CodeGenCompilationResult result = CodeGenCompilationResult::Success;
+
+    std::mutex mutex;
+    std::condition_variable finished;
+    bool started = false;
+    bool cancelled = false;
+    bool done = false;
+};
+
+static bool isAsyncCompilationDone(AsyncCompilation& compilation, bool wait)
+{
+    std::unique_lock<std::mutex> lock(compilation.mutex);
+
+    if (wait)
+        compilation.finished.wait(lock, [&compilation] {
+            return compilation.done;
+        });
+
+    return compilation.done;
+}
+
+static void cancelAsyncCompilation(AsyncCompilation& compilation)
+{
+    std::unique_lock<std::mutex> lock(compilation.mutex);
+
+    compilation.cancelled = true;
+
+    // Compilation that has started reads function bytecode and has to finish before it's freed
+    compilation.finished.wait(lock, [&compilation] {
+        return compilation.done || !compilation.started;
+    });
+}
+
 static void onCloseState(lua_State* L)
 {
-    delete getNativeState(L);
+    NativeState* data = getNativeState(L);
+
+    for (const std::shared_ptr<AsyncCompilation>& compilation : data->asyncCompilations)
+    {
+        cancelAsyncCompilation(*compilation);
+
+        for (NativeProto result : compilation->module.results)
+            destroyExecData(result.execdata);
+    }
+
+    delete data;
     L->global->ecb = lua_ExecutionCallbacks();
 }
 
 static void onDestroyFunction(lua_State* L, Proto* proto)
 {
+    if (proto->hotcount != 0)
+    {
+        getNativeState(L)->argumentTypes.erase(proto);
+        getNativeState(L)->tieredProfiling.erase(proto);
+    }
+
+    getNativeState(L)->speculativeProtos.erase(proto);
+
+    releaseNativeCode(getNativeState(L), proto);
+
     destroyExecData(proto->execdata);
     proto->execdata = nullptr;
     proto->exectarget = 0;
     proto->codeentry = proto->code;
 }
 
+static uint8_t getBytecodeType(const TValue* value)
+{
+    switch (ttype(value))
+    {
+    case LUA_TBOOLEAN:
+        return LBC_TYPE_BOOLEAN;
+    case LUA_TNUMBER:
+        return LBC_TYPE_NUMBER;
+    case LUA_TVECTOR:
+        return LBC_TYPE_VECTOR;
+    case LUA_TSTRING:
+        return LBC_TYPE_STRING;
+    case LUA_TTABLE:
+        return LBC_TYPE_TABLE;
+    case LUA_TFUNCTION:
+        return LBC_TYPE_FUNCTION;
+    case LUA_TUSERDATA:
+        return LBC_TYPE_USERDATA;
+    case LUA_TTHREAD:
+        return LBC_TYPE_THREAD;
+    case LUA_TBUFFER:
+        return LBC_TYPE_BUFFER;
+    default:
+        // nil is usually a missing optional argument so it doesn't say anything about the type
+        return LBC_TYPE_ANY;
+    }
+}
+
+// Argument types are recorded from the active call frame of a profiled function on entry and when it becomes hot
+static void recordArgumentTypes(lua_State* L, Proto* proto)
+{
+    if (proto->numparams == 0 || !isLua(L->ci) || clvalue(L->ci->func)->l.p != proto)
+        return;
+
+    std::vector<uint8_t>& types = getNativeState(L)->argumentTypes[proto];
+
+    if (types.empty())
+    {
+        for (int i = 0; i < proto->numparams; ++i)
+            types.push_back(getBytecodeType(L->base + i));
+    }
+    else
+    {
+        // Arguments that had different types in different calls are left generic
+        for (int i = 0; i < proto->numparams; ++i)
+            if (types[i] != getBytecodeType(L->base + i))
+                types[i] = LBC_TYPE_ANY;
+    }
+}
+
+static void onHot(lua_State* L, Proto* proto);
+static void onSpeculationMiss(lua_State* L, Proto* proto);
+
 static int onEnter(lua_State* L, Proto* proto)
 {
     NativeState* data = getNativeState(L);
 
+    // Functions profiled for tiered compilation use the native entry to count calls until they become hot
+    if (!proto->execdata)
+    {
+        CODEGEN_ASSERT(proto->hotcount != 0);
+
+        recordArgumentTypes(L, proto);
+
+        if (--proto->hotcount == 0)
+            onHot(L, proto);
+
+        if (!proto->execdata)
+        {
+            L->ci->flags &= ~LUA_CALLINFO_NATIVE;
+            return 1;
+        }
+    }
+
     CODEGEN_ASSERT(proto->execdata);
     CODEGEN_ASSERT(L->ci->savedpc >= proto->code && L->ci->savedpc < proto->code + proto->sizecode);
 
     uintptr_t target = proto->exectarget + static_cast<uint32_t*>(proto->execdata)[L->ci->savedpc - proto->code];
 
     // Returns 1 to finish the function in the VM
-    return GateFn(data->context.gateEntry)(L, proto, target, &data->context);
+    int result = GateFn(data->context.gateEntry)(L, proto, target, &data->context);
+
+    // Specialized functions exit at the first instruction when the arguments don't match the entry guard
+    if (result == 1 && !data->speculativeProtos.empty() && isLua(L->ci) && clvalue(L->ci->func)->l.p == proto && L->ci->savedpc == proto->code)
+        onSpeculationMiss(L, proto);
+
+    return result;
 }
 
 void onDisable(lua_State* L, Proto* proto)
@@ -180,6 +485,7 @@ void onDisable(lua_State* L, Proto* proto)
     proto->codeentry = proto->code;
 
     // prevent native code from entering proto with breakpoints
+    getNativeState(L)->disabledExecTargets[proto] = proto->exectarget;
     proto->exectarget = 0;
 
     // walk all thread call stacks and clear the LUA_CALLINFO_NATIVE flag from any
@@ -209,6 +515,22 @@ void onDisable(lua_State* L, Proto* proto)
     });
 }
 
+void onEnable(lua_State* L, Proto* proto)
+{
+    NativeState* data = getNativeState(L);
+
+    auto it = data->disabledExecTargets.find(proto);
+
+    if (it == data->disabledExecTargets.end())
+        return;
+
+    // new calls enter native code again; frames that are already running continue in the interpreter until they return
+    proto->exectarget = it->second;
+    proto->codeentry = &kCodeEntryInsn;
+
+    data->disabledExecTargets.erase(it);
+}
+
 #if defined(__aarch64__)
 unsigned int getCpuFeaturesA64()
 {
@@ -303,6 +625,8 @@ void create(lua_State* L, AllocationCallback* allocationCallback, void* allocati
     ecb->destroy = onDestroyFunction;
     ecb->enter = onEnter;
     ecb->disable = FFlag::DisableNativeCodegenIfBreakpointIsSet ? onDisable : nullptr;
+    ecb->enable = FFlag::DisableNativeCodegenIfBreakpointIsSet ? onEnable : nullptr;
+    ecb->hot = onHot;
 }
 
 void create(lua_State* L)
@@ -310,40 +634,210 @@ void create(lua_State* L)
     create(L, nullptr, nullptr);
 }
 
-CodeGenCompilationResult compile(lua_State* L, int idx, unsigned int flags, CompilationStats* stats)
+static void installNativeProtos(NativeState* data, const std::vector<NativeProto>& results, uint8_t* nativeData, uint8_t* codeStart, size_t codeSize)
 {
-    CODEGEN_ASSERT(lua_isLfunction(L, idx));
-    const TValue* func = luaA_toobject(L, idx);
+    if (gPerfLogFn && results.size() > 0)
+    {
+        gPerfLogFn(gPerfLogContext, uintptr_t(codeStart), uint32_t(results[0].exectarget), "<luau helpers>");
 
-    Proto* root = clvalue(func)->l.p;
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            uint32_t begin = uint32_t(results[i].exectarget);
+            uint32_t end = i + 1 < results.size() ? uint32_t(results[i + 1].exectarget) : uint32_t(codeSize);
+            CODEGEN_ASSERT(begin < end);
 
-    if ((flags & CodeGen_OnlyNativeModules) != 0 && (root->flags & LPF_NATIVE_MODULE) == 0)
-        return CodeGenCompilationResult::NotNativeModule;
+            logPerfFunction(results[i].p, uintptr_t(codeStart) + begin, end - begin);
+        }
+    }
 
-    // If initialization has failed, do not compile any functions
-    NativeState* data = getNativeState(L);
-    if (!data)
-        return CodeGenCompilationResult::CodeGenNotInitialized;
+    NativeAllocation& allocation = data->allocations.emplace_back();
+    allocation.data = nativeData;
+    allocation.liveProtos = results.size();
 
-    std::vector<Proto*> protos;
-    gatherFunctions(protos, root, flags);
+    for (const NativeProto& result : results)
+    {
+        CODEGEN_ASSERT(data->protoAllocations.count(result.p) == 0);
 
-    // Skip protos that have been compiled during previous invocations of CodeGen::compile
-    protos.erase(std::remove_if(protos.begin(), protos.end(),
-                     [](Proto* p) {
-                         return p == nullptr || p->execdata != nullptr;
-                     }),
-        protos.end());
+        data->protoAllocations[result.p] = {std::prev(data->allocations.end()), allocation.protos.size()};
+        allocation.protos.push_back(result.p);
 
-    if (protos.empty())
-        return CodeGenCompilationResult::NothingToCompile;
+        // the memory is now managed by VM and will be freed via onDestroyFunction
+        result.p->execdata = result.execdata;
+        result.p->exectarget = uintptr_t(codeStart) + result.exectarget;
+        result.p->codeentry = &kCodeEntryInsn;
 
-    if (stats != nullptr)
-        stats->functionsTotal = uint32_t(protos.size());
+        if (!result.counterPcs.empty())
+            data->counterPcs[result.p] = result.counterPcs;
+
+        if (result.p->hotcount != 0)
+        {
+            data->argumentTypes.erase(result.p);
+            data->tieredProfiling.erase(result.p);
+            result.p->hotcount = 0;
+        }
+    }
+}
+
+// Native code cache layout, all values use host byte order since the cache is only valid for the host that produced it:
+// header: magic, CodeCacheHeader
+// data: dataSize bytes of module data followed by codeSize bytes of module code
+// functions: protoCount entries of (bytecodeid, sizecode, exectarget) followed by sizecode instruction offsets
+static const char kCodeCacheMagic[8] = {'L', 'U', 'A', 'U', 'N', 'A', 'T', 'V'};
+
+// Must be incremented whenever the generated code or the NativeContext/VM structures it references change
+static const uint32_t kCodeCacheVersion = 1;
+
+struct CodeCacheHeader
+{
+    uint32_t version;
+    uint32_t target;
+    uint32_t features;
+    uint32_t contextSize;
+    uint64_t bytecodeHash;
+    uint32_t dataSize;
+    uint32_t codeSize;
+    uint32_t protoCount;
+};
+
+static uint32_t getCodeCacheTarget()
+{
+#if defined(__aarch64__)
+    return 1;
+#else
+    return 2;
+#endif
+}
 
+static uint32_t getCodeCacheFeatures()
+{
 #if defined(__aarch64__)
     static unsigned int cpuFeatures = getCpuFeaturesA64();
-    A64::AssemblyBuilderA64 build(/* logText= */ false, cpuFeatures);
+    return cpuFeatures;
+#else
+    return 0;
+#endif
+}
+
+template<typename T>
+static void hashValue(Fnv1aHash& hash, const T& value)
+{
+    hash.addBytes(&value, sizeof(value));
+}
+
+// Hash everything in the bytecode that the generated code depends on; strings are hashed by contents and objects only by type
+static uint64_t getBytecodeHash(Proto* root)
+{
+    std::vector<Proto*> protos;
+    gatherFunctions(protos, root, CodeGen_ColdFunctions);
+
+    Fnv1aHash hash;
+
+    hashValue(hash, protos.size());
+
+    for (Proto* p : protos)
+    {
+        if (!p)
+            continue;
+
+        hashValue(hash, p->bytecodeid);
+        hashValue(hash, p->nups);
+        hashValue(hash, p->numparams);
+        hashValue(hash, p->is_vararg);
+        hashValue(hash, p->maxstacksize);
+        hashValue(hash, p->flags);
+        hashValue(hash, p->sizep);
+
+        hashValue(hash, p->sizecode);
+        hash.addBytes(p->code, p->sizecode * sizeof(Instruction));
+
+        hashValue(hash, p->sizek);
+
+        // imports are resolved on load and depend on the environment, but generated code checks resolved values at runtime
+        std::vector<bool> imports(p->sizek);
+
+        for (int i = 0; i < p->sizecode;)
+        {
+            LuauOpcode op = LuauOpcode(LUAU_INSN_OP(p->code[i]));
+
+            if (op == LOP_GETIMPORT)
+                imports[LUAU_INSN_D(p->code[i])] = true;
+
+            i += getOpLength(op);
+        }
+
+        for (int i = 0; i < p->sizek; ++i)
+        {
+            const TValue* k = &p->k[i];
+
+            if (imports[i])
+                continue;
+
+            hashValue(hash, k->tt);
+
+            if (ttisstring(k))
+                hash.addBytes(svalue(k), tsvalue(k)->len);
+            else if (ttisnumber(k))
+                hashValue(hash, nvalue(k));
+            else if (ttisboolean(k))
+                hashValue(hash, bvalue(k));
+            else if (ttisvector(k))
+                hash.addBytes(vvalue(k), sizeof(float) * LUA_VECTOR_SIZE);
+        }
+
+        if (p->typeinfo)
+            hash.addBytes(p->typeinfo, p->numparams + 2);
+    }
+
+    return hash.value;
+}
+
+static void writeCacheBytes(std::string& cache, const void* data, size_t size)
+{
+    cache.append(static_cast<const char*>(data), size);
+}
+
+static bool readCacheBytes(const char*& pos, const char* end, void* data, size_t size)
+{
+    if (size_t(end - pos) < size)
+        return false;
+
+    memcpy(data, pos, size);
+    pos += size;
+    return true;
+}
+
+static void serializeNativeProtos(std::string& cache, Proto* root, const std::vector<NativeProto>& results, const std::vector<uint8_t>& data,
+    const uint8_t* code, size_t codeSize)
+{
+    CodeCacheHeader header = {};
+    header.version = kCodeCacheVersion;
+    header.target = getCodeCacheTarget();
+    header.features = getCodeCacheFeatures();
+    header.contextSize = uint32_t(sizeof(NativeContext));
+    header.bytecodeHash = getBytecodeHash(root);
+    header.dataSize = uint32_t(data.size());
+    header.codeSize = uint32_t(codeSize);
+    header.protoCount = uint32_t(results.size());
+
+    cache.clear();
+    writeCacheBytes(cache, kCodeCacheMagic, sizeof(kCodeCacheMagic));
+    writeCacheBytes(cache, &header, sizeof(header));
+    writeCacheBytes(cache, data.data(), data.size());
+    writeCacheBytes(cache, code, codeSize);
+
+    for (const NativeProto& result : results)
+    {
+        uint32_t info[3] = {uint32_t(result.p->bytecodeid), uint32_t(result.p->sizecode), uint32_t(result.exectarget)};
+        writeCacheBytes(cache, info, sizeof(info));
+        writeCacheBytes(cache, result.execdata, result.p->sizecode * sizeof(uint32_t));
+    }
+}
+
+// Translates and lowers the functions into a module; only reads function bytecode, so it can run on any thread
+static CodeGenCompilationResult assembleModule(const std::vector<Proto*>& protos, NativeModule& module, unsigned int flags)
+{
+#if defined(__aarch64__)
+    A64::AssemblyBuilderA64 build(/* logText= */ false, getCodeCacheFeatures());
 #else
     X64::AssemblyBuilderX64 build(/* logText= */ false);
 #endif
@@ -355,8 +849,7 @@ CodeGenCompilationResult compile(lua_State* L, int idx, unsigned int flags, Comp
     X64::assembleHelpers(build, helpers);
 #endif
 
-    std::vector<NativeProto> results;
-    results.reserve(protos.size());
+    module.results.reserve(protos.size());
 
     uint32_t totalIrInstCount = 0;
 
@@ -368,8 +861,8 @@ CodeGenCompilationResult compile(lua_State* L, int idx, unsigned int flags, Comp
         // If multiple compilations fail, we only use the failure from the first unsuccessful compilation.
         CodeGenCompilationResult temp = CodeGenCompilationResult::Success;
 
-        if (std::optional<NativeProto> np = createNativeFunction(build, helpers, p, totalIrInstCount, temp))
-            results.push_back(*np);
+        if (std::optional<NativeProto> np = createNativeFunction(build, helpers, p, flags, totalIrInstCount, temp))
+            module.results.push_back(*np);
         // second compilation failure onwards, this condition fails and codeGenCompilationResult is not assigned.
         else if (codeGenCompilationResult == CodeGenCompilationResult::Success)
             codeGenCompilationResult = temp;
@@ -378,71 +871,501 @@ CodeGenCompilationResult compile(lua_State* L, int idx, unsigned int flags, Comp
     // Very large modules might result in overflowing a jump offset; in this case we currently abandon the entire module
     if (!build.finalize())
     {
-        for (NativeProto result : results)
+        for (NativeProto result : module.results)
             destroyExecData(result.execdata);
 
+        module.results.clear();
+
         return CodeGenCompilationResult::CodeGenAssemblerFinalizationFailure;
     }
 
     // If no functions were assembled, we don't need to allocate/copy executable pages for helpers
-    if (results.empty())
+    if (module.results.empty())
     {
         LUAU_ASSERT(codeGenCompilationResult != CodeGenCompilationResult::Success);
         return codeGenCompilationResult;
     }
 
+    const uint8_t* code = reinterpret_cast<const uint8_t*>(build.code.data());
+
+    module.data = build.data;
+    module.code.assign(code, code + build.code.size() * sizeof(build.code[0]));
+
+    return codeGenCompilationResult;
+}
+
+static CodeGenCompilationResult installModule(
+    lua_State* L, NativeState* data, Proto* root, NativeModule& module, CompilationStats* stats, std::string* cache)
+{
     uint8_t* nativeData = nullptr;
-    size_t sizeNativeData = 0;
     uint8_t* codeStart = nullptr;
-    if (!data->codeAllocator.allocate(build.data.data(), int(build.data.size()), reinterpret_cast<const uint8_t*>(build.code.data()),
-            int(build.code.size() * sizeof(build.code[0])), nativeData, sizeNativeData, codeStart))
+    if (!allocateNativeCode(L, data, module.data.data(), module.data.size(), module.code.data(), module.code.size(), nativeData, codeStart))
     {
-        for (NativeProto result : results)
+        for (NativeProto result : module.results)
             destroyExecData(result.execdata);
 
         return CodeGenCompilationResult::AllocationFailed;
     }
 
-    if (gPerfLogFn && results.size() > 0)
-    {
-        gPerfLogFn(gPerfLogContext, uintptr_t(codeStart), uint32_t(results[0].exectarget), "<luau helpers>");
+    // Generated code only references the helpers through NativeContext and its data through relative addressing, so it can be stored as is
+    if (cache)
+        serializeNativeProtos(*cache, root, module.results, module.data, module.code.data(), module.code.size());
 
-        for (size_t i = 0; i < results.size(); ++i)
+    installNativeProtos(data, module.results, nativeData, codeStart, module.code.size());
+
+    if (stats != nullptr)
+    {
+        for (const NativeProto& result : module.results)
         {
-            uint32_t begin = uint32_t(results[i].exectarget);
-            uint32_t end = i + 1 < results.size() ? uint32_t(results[i + 1].exectarget) : uint32_t(build.code.size() * sizeof(build.code[0]));
-            CODEGEN_ASSERT(begin < end);
+            stats->bytecodeSizeBytes += result.p->sizecode * sizeof(Instruction);
 
-            logPerfFunction(results[i].p, uintptr_t(codeStart) + begin, end - begin);
+            // Account for the native -> bytecode instruction offsets mapping:
+            stats->nativeMetadataSizeBytes += result.p->sizecode * sizeof(uint32_t);
         }
+
+        stats->functionsCompiled += uint32_t(module.results.size());
+        stats->nativeCodeSizeBytes += module.code.size();
+        stats->nativeDataSizeBytes += module.data.size();
     }
 
-    for (const NativeProto& result : results)
+    return CodeGenCompilationResult::Success;
+}
+
+static CodeGenCompilationResult gatherCompilableFunctions(lua_State* L, int idx, unsigned int flags, std::vector<Proto*>& protos)
+{
+    CODEGEN_ASSERT(lua_isLfunction(L, idx));
+    const TValue* func = luaA_toobject(L, idx);
+
+    Proto* root = clvalue(func)->l.p;
+
+    if ((flags & CodeGen_OnlyNativeModules) != 0 && (root->flags & LPF_NATIVE_MODULE) == 0)
+        return CodeGenCompilationResult::NotNativeModule;
+
+    // If initialization has failed, do not compile any functions
+    if (!getNativeState(L))
+        return CodeGenCompilationResult::CodeGenNotInitialized;
+
+    gatherFunctions(protos, root, flags);
+
+    // Skip protos that have been compiled during previous invocations of CodeGen::compile
+    protos.erase(std::remove_if(protos.begin(), protos.end(),
+                     [](Proto* p) {
+                         return p == nullptr || p->execdata != nullptr;
+                     }),
+        protos.end());
+
+    if (protos.empty())
+        return CodeGenCompilationResult::NothingToCompile;
+
+    return CodeGenCompilationResult::Success;
+}
+
+static void onHot(lua_State* L, Proto* proto)
+{
+    NativeState* data = getNativeState(L);
+
+    recordArgumentTypes(L, proto);
+
+    // Observed argument types are used as parameter annotations for arguments that don't have them, so that the code is specialized
+    // for these types with an entry guard that executes the function in the VM when the speculation is wrong
+    Proto speculative = *proto;
+    std::vector<uint8_t> typeinfo;
+
+    auto it = data->argumentTypes.find(proto);
+
+    if (it != data->argumentTypes.end())
     {
-        // the memory is now managed by VM and will be freed via onDestroyFunction
-        result.p->execdata = result.execdata;
-        result.p->exectarget = uintptr_t(codeStart) + result.exectarget;
-        result.p->codeentry = &kCodeEntryInsn;
+        if (proto->typeinfo)
+            typeinfo.assign(proto->typeinfo, proto->typeinfo + proto->numparams + 2);
+        else
+            typeinfo = {LBC_TYPE_FUNCTION, proto->numparams};
+
+        typeinfo.resize(proto->numparams + 2, LBC_TYPE_ANY);
+
+        for (int i = 0; i < proto->numparams; ++i)
+            if (typeinfo[2 + i] == LBC_TYPE_ANY)
+                typeinfo[2 + i] = it->second[i];
+
+        speculative.typeinfo = typeinfo.data();
+
+        data->argumentTypes.erase(it);
     }
 
+    proto->hotcount = 0;
+
+    unsigned int flags = data->tieredProfiling.erase(proto) ? CodeGen_Profile : 0;
+
+    NativeModule module;
+    assembleModule({&speculative}, module, flags);
+
+    for (NativeProto& result : module.results)
+        result.p = proto;
+
+    // If the function can't be compiled, it stays in the VM and isn't profiled any further
+    if (module.results.empty() || installModule(L, getNativeState(L), proto, module, nullptr, nullptr) != CodeGenCompilationResult::Success)
+    {
+        proto->codeentry = proto->code;
+        return;
+    }
+
+    bool specialized = speculative.typeinfo && (!proto->typeinfo || memcmp(speculative.typeinfo, proto->typeinfo, proto->numparams + 2) != 0);
+
+    if (specialized)
+        data->speculativeProtos[proto] = {0, flags};
+}
+
+// Functions that keep being called with arguments they weren't specialized for are recompiled with only their annotated types
+static void onSpeculationMiss(lua_State* L, Proto* proto)
+{
+    NativeState* data = getNativeState(L);
+
+    auto it = data->speculativeProtos.find(proto);
+
+    if (it == data->speculativeProtos.end() || ++it->second.misses < uint32_t(std::max(FInt::CodegenSpeculationMissLimit.value, 1)))
+        return;
+
+    // Code can't be released while it's executed by another call frame, so the function gets another round of calls
+    if (getRunningNativeProtos(L).count(proto))
+    {
+        it->second.misses = 0;
+        return;
+    }
+
+    unsigned int flags = it->second.flags;
+    data->speculativeProtos.erase(it);
+
+    releaseNativeCode(data, proto);
+
+    destroyExecData(proto->execdata);
+    proto->execdata = nullptr;
+    proto->exectarget = 0;
+    proto->codeentry = proto->code;
+
+    NativeModule module;
+    assembleModule({proto}, module, flags);
+
+    // If the function can't be compiled again, it stays in the VM
+    if (!module.results.empty())
+        installModule(L, data, proto, module, nullptr, nullptr);
+}
+
+static CodeGenCompilationResult compileImpl(lua_State* L, int idx, unsigned int flags, CompilationStats* stats, std::string* cache)
+{
+    std::vector<Proto*> protos;
+    CodeGenCompilationResult gatherResult = gatherCompilableFunctions(L, idx, flags, protos);
+
+    if (gatherResult != CodeGenCompilationResult::Success)
+        return gatherResult;
+
     if (stats != nullptr)
+        stats->functionsTotal = uint32_t(protos.size());
+
+    // Tiered functions start in the VM and are compiled one by one when they become hot, native entry is used to count calls
+    if ((flags & CodeGen_Tiered) != 0 && !cache)
     {
-        for (const NativeProto& result : results)
+        for (Proto* p : protos)
         {
-            stats->bytecodeSizeBytes += result.p->sizecode * sizeof(Instruction);
+            if (p->hotcount == 0)
+                p->hotcount = std::max(FInt::CodegenTieredThreshold.value, 1);
 
-            // Account for the native -> bytecode instruction offsets mapping:
-            stats->nativeMetadataSizeBytes += result.p->sizecode * sizeof(uint32_t);
+            if ((flags & CodeGen_Profile) != 0)
+                getNativeState(L)->tieredProfiling.insert(p);
+
+            p->codeentry = &kCodeEntryInsn;
         }
 
-        stats->functionsCompiled += uint32_t(results.size());
-        stats->nativeCodeSizeBytes += build.code.size();
-        stats->nativeDataSizeBytes += build.data.size();
+        return CodeGenCompilationResult::Success;
     }
 
+    // Counters are referenced through execdata, which is not stored in the cache
+    if (cache)
+        flags &= ~CodeGen_Profile;
+
+    NativeModule module;
+    CodeGenCompilationResult codeGenCompilationResult = assembleModule(protos, module, flags);
+
+    if (module.results.empty())
+        return codeGenCompilationResult;
+
+    CodeGenCompilationResult installResult = installModule(L, getNativeState(L), clvalue(luaA_toobject(L, idx))->l.p, module, stats, cache);
+
+    if (installResult != CodeGenCompilationResult::Success)
+        return installResult;
+
     return codeGenCompilationResult;
 }
 
+CodeGenCompilationResult compile(lua_State* L, int idx, unsigned int flags, CompilationStats* stats)
+{
+    return compileImpl(L, idx, flags, stats, nullptr);
+}
+
+static bool installAsyncCompilation(lua_State* L, NativeState* data, AsyncCompilation& compilation)
+{
+    std::vector<NativeProto>& results = compilation.module.results;
+
+    // Generated functions refer to snapshots which follow the same order
+    size_t snapshot = 0;
+    size_t count = 0;
+
+    for (NativeProto result : results)
+    {
+        while (&compilation.snapshots[snapshot].copy != result.p)
+            snapshot++;
+
+        Proto* p = compilation.snapshots[snapshot].original;
+        const std::vector<Instruction>& code = compilation.snapshots[snapshot].code;
+
+        // Skip functions that were compiled in the meantime or had their bytecode changed by breakpoints
+        if (p->execdata != nullptr || memcmp(p->code, code.data(), code.size() * sizeof(Instruction)) != 0)
+        {
+            destroyExecData(result.execdata);
+            continue;
+        }
+
+        result.p = p;
+        results[count++] = result;
+    }
+
+    results.resize(count);
+
+    if (results.empty())
+        return false;
+
+    return installModule(L, data, nullptr, compilation.module, nullptr, nullptr) == CodeGenCompilationResult::Success;
+}
+
+CodeGenCompilationResult compileAsync(lua_State* L, int idx, std::function<void(std::function<void()> task)> executeTask, unsigned int flags)
+{
+    std::vector<Proto*> protos;
+    CodeGenCompilationResult gatherResult = gatherCompilableFunctions(L, idx, flags, protos);
+
+    if (gatherResult != CodeGenCompilationResult::Success)
+        return gatherResult;
+
+    std::shared_ptr<AsyncCompilation> compilation = std::make_shared<AsyncCompilation>();
+    compilation->ref = lua_ref(L, idx);
+    compilation->snapshots.resize(protos.size());
+
+    for (size_t i = 0; i < protos.size(); ++i)
+    {
+        ProtoSnapshot& snapshot = compilation->snapshots[i];
+
+        snapshot.original = protos[i];
+        snapshot.copy = *protos[i];
+        snapshot.code.assign(protos[i]->code, protos[i]->code + protos[i]->sizecode);
+        snapshot.copy.code = snapshot.code.data();
+    }
+
+    getNativeState(L)->asyncCompilations.push_back(compilation);
+
+    auto task = [compilation, flags]() {
+        {
+            std::unique_lock<std::mutex> lock(compilation->mutex);
+
+            // VM was closed before the task was started
+            if (compilation->cancelled)
+            {
+                compilation->done = true;
+                return;
+            }
+
+            compilation->started = true;
+        }
+
+        std::vector<Proto*> protos;
+        protos.reserve(compilation->snapshots.size());
+
+        for (ProtoSnapshot& snapshot : compilation->snapshots)
+            protos.push_back(&snapshot.copy);
+
+        CodeGenCompilationResult result = assembleModule(protos, compilation->module, flags);
+
+        std::unique_lock<std::mutex> lock(compilation->mutex);
+        compilation->result = result;
+        compilation->done = true;
+        compilation->finished.notify_all();
+    };
+
+    if (executeTask)
+        executeTask(task);
+    else
+        task();
+
+    return CodeGenCompilationResult::Success;
+}
+
+size_t installAsyncCompilations(lua_State* L, bool wait)
+{
+    NativeState* data = getNativeState(L);
+    if (!data)
+        return 0;
+
+    std::vector<std::shared_ptr<AsyncCompilation>>& pending = data->asyncCompilations;
+
+    size_t installed = 0;
+
+    for (size_t i = 0; i < pending.size();)
+    {
+        std::shared_ptr<AsyncCompilation> compilation = pending[i];
+
+        if (!isAsyncCompilationDone(*compilation, wait))
+        {
+            i++;
+            continue;
+        }
+
+        pending.erase(pending.begin() + i);
+
+        if (installAsyncCompilation(L, data, *compilation))
+            installed++;
+
+        lua_unref(L, compilation->ref);
+    }
+
+    return installed;
+}
+
+CodeGenCompilationResult compileToCache(lua_State* L, int idx, std::string& cache, unsigned int flags, CompilationStats* stats)
+{
+    cache.clear();
+
+    return compileImpl(L, idx, flags, stats, &cache);
+}
+
+CodeGenCompilationResult loadFromCache(lua_State* L, int idx, const char* cache, size_t cacheSize)
+{
+    CODEGEN_ASSERT(lua_isLfunction(L, idx));
+    const TValue* func = luaA_toobject(L, idx);
+
+    Proto* root = clvalue(func)->l.p;
+
+    NativeState* data = getNativeState(L);
+    if (!data)
+        return CodeGenCompilationResult::CodeGenNotInitialized;
+
+    const char* pos = cache;
+    const char* end = cache + cacheSize;
+
+    char magic[sizeof(kCodeCacheMagic)];
+    CodeCacheHeader header;
+
+    if (!readCacheBytes(pos, end, magic, sizeof(magic)) || memcmp(magic, kCodeCacheMagic, sizeof(magic)) != 0)
+        return CodeGenCompilationResult::CodeGenCacheMismatch;
+
+    if (!readCacheBytes(pos, end, &header, sizeof(header)))
+        return CodeGenCompilationResult::CodeGenCacheMismatch;
+
+    if (header.version != kCodeCacheVersion || header.target != getCodeCacheTarget() || header.features != getCodeCacheFeatures() ||
+        header.contextSize != sizeof(NativeContext) || header.bytecodeHash != getBytecodeHash(root))
+        return CodeGenCompilationResult::CodeGenCacheMismatch;
+
+    if (size_t(end - pos) < size_t(header.dataSize) + header.codeSize)
+        return CodeGenCompilationResult::CodeGenCacheMismatch;
+
+    const uint8_t* moduleData = reinterpret_cast<const uint8_t*>(pos);
+    const uint8_t* moduleCode = moduleData + header.dataSize;
+    pos += size_t(header.dataSize) + header.codeSize;
+
+    std::vector<Proto*> protos;
+    gatherFunctions(protos, root, CodeGen_ColdFunctions);
+
+    std::vector<NativeProto> results;
+    results.reserve(header.protoCount);
+
+    for (uint32_t i = 0; i < header.protoCount; ++i)
+    {
+        uint32_t info[3];
+        if (!readCacheBytes(pos, end, info, sizeof(info)))
+            break;
+
+        Proto* p = info[0] < protos.size() ? protos[info[0]] : nullptr;
+
+        if (!p || uint32_t(p->sizecode) != info[1] || info[2] >= header.codeSize || size_t(end - pos) < info[1] * sizeof(uint32_t))
+            break;
+
+        uint32_t* instOffsets = new uint32_t[p->sizecode];
+        readCacheBytes(pos, end, instOffsets, p->sizecode * sizeof(uint32_t));
+
+        results.push_back({p, instOffsets, info[2]});
+    }
+
+    if (results.size() != header.protoCount)
+    {
+        for (NativeProto result : results)
+            destroyExecData(result.execdata);
+
+        return CodeGenCompilationResult::CodeGenCacheMismatch;
+    }
+
+    // Skip functions that already have native code from an earlier compilation
+    results.erase(std::remove_if(results.begin(), results.end(),
+                      [](const NativeProto& result) {
+                          if (result.p->execdata == nullptr)
+                              return false;
+
+                          destroyExecData(result.execdata);
+                          return true;
+                      }),
+        results.end());
+
+    if (results.empty())
+        return CodeGenCompilationResult::NothingToCompile;
+
+    uint8_t* nativeData = nullptr;
+    uint8_t* codeStart = nullptr;
+    if (!allocateNativeCode(L, data, moduleData, header.dataSize, moduleCode, header.codeSize, nativeData, codeStart))
+    {
+        for (NativeProto result : results)
+            destroyExecData(result.execdata);
+
+        return CodeGenCompilationResult::AllocationFailed;
+    }
+
+    installNativeProtos(data, results, nativeData, codeStart, header.codeSize);
+
+    return CodeGenCompilationResult::Success;
+}
+
+std::vector<FunctionProfile> getFunctionProfiles(lua_State* L, int idx)
+{
+    CODEGEN_ASSERT(lua_isLfunction(L, idx));
+    const TValue* func = luaA_toobject(L, idx);
+
+    std::vector<FunctionProfile> profiles;
+
+    NativeState* data = getNativeState(L);
+    if (!data)
+        return profiles;
+
+    std::vector<Proto*> protos;
+    gatherFunctions(protos, clvalue(func)->l.p, CodeGen_ColdFunctions);
+
+    for (Proto* p : protos)
+    {
+        auto it = p ? data->counterPcs.find(p) : data->counterPcs.end();
+
+        if (it == data->counterPcs.end())
+            continue;
+
+        const uint64_t* counters =
+            reinterpret_cast<const uint64_t*>(static_cast<const char*>(p->execdata) + getExecDataCounterOffset(p->sizecode));
+        const std::vector<uint32_t>& pcs = it->second;
+
+        FunctionProfile& profile = profiles.emplace_back();
+        profile.name = p->debugname ? getstr(p->debugname) : "";
+        profile.line = p->linedefined;
+
+        // First counter is the function entry
+        profile.entries = counters[0];
+
+        for (size_t i = 1; i < pcs.size(); ++i)
+            profile.blocks.push_back({int(pcs[i]), luaG_getline(p, pcs[i]), counters[i]});
+    }
+
+    return profiles;
+}
+
 void setPerfLog(void* context, PerfLogFn logFn)
 {
     gPerfLogContext = context;
@@ -92,8 +92,16 @@ static std::string getAssemblyImpl(AssemblyBuilder& build, const TValue* func, A
 
     for (Proto* p : protos)
     {
+        double irBuildStartTime = stats ? lua_clock() : 0.0;
+
         IrBuilder ir;
+        ir.countExecutions = (options.flags & CodeGen_Profile) != 0;
+        ir.coverageFirstHit = (options.flags & CodeGen_CoverageFirstHit) != 0;
         ir.buildFunctionIr(p);
+
+        if (stats)
+            stats->phaseTimeStats.irBuildSeconds += lua_clock() - irBuildStartTime;
+
         unsigned asmSize = build.getCodeSize();
         unsigned asmCount = build.getInstructionCount();
 
@@ -140,9 +148,14 @@ static std::string getAssemblyImpl(AssemblyBuilder& build, const TValue* func, A
             build.logAppend("\n");
     }
 
+    double finalizeStartTime = stats ? lua_clock() : 0.0;
+
     if (!build.finalize())
         return std::string();
 
+    if (stats)
+        stats->phaseTimeStats.finalizeSeconds += lua_clock() - finalizeStartTime;
+
     if (options.outputBinary)
         return std::string(reinterpret_cast<const char*>(build.code.data()), reinterpret_cast<const char*>(build.code.data() + build.code.size())) +
                std::string(build.data.begin(), build.data.end());
@@ -8,7 +8,11 @@
 #include "Luau/IrDump.h"
 #include "Luau/IrUtils.h"
 #include "Luau/OptimizeConstProp.h"
+#include "Luau/OptimizeDeadStore.h"
+#include "Luau/OptimizeFinalA64.h"
 #include "Luau/OptimizeFinalX64.h"
+#include "Luau/OptimizeLoops.h"
+#include "Luau/OptimizeRedundantChecks.h"
 
 #include "EmitCommon.h"
 #include "IrLoweringA64.h"
@@ -41,6 +45,10 @@ inline void gatherFunctions(std::vector<Proto*>& results, Proto* proto, unsigned
     if (results[proto->bytecodeid])
         return;
 
+    // Functions that weren't decoded yet by a lazy load don't have any code
+    if (proto->lazychunk)
+        return;
+
     // Only compile cold functions if requested
     if ((proto->flags & LPF_NATIVE_COLD) == 0 || (flags & CodeGen_ColdFunctions) != 0)
         results[proto->bytecodeid] = proto;
@@ -240,6 +248,8 @@ inline bool lowerIr(X64::AssemblyBuilderX64& build, IrBuilder& ir, const std::ve
 inline bool lowerIr(A64::AssemblyBuilderA64& build, IrBuilder& ir, const std::vector<uint32_t>& sortedBlocks, ModuleHelpers& helpers, Proto* proto,
     AssemblyOptions options, LoweringStats* stats)
 {
+    optimizeConstantOperandsA64(ir.function);
+
     A64::IrLoweringA64 lowering(build, helpers, ir.function, stats);
 
     return lowerImpl(build, lowering, ir.function, sortedBlocks, proto->bytecodeid, options);
@@ -281,12 +291,18 @@ inline bool lowerFunction(IrBuilder& ir, AssemblyBuilder& build, ModuleHelpers&
         return false;
     }
 
+    double optimizeStartTime = stats ? lua_clock() : 0.0;
+
     computeCfgInfo(ir.function);
 
     if (!FFlag::DebugCodegenNoOpt)
     {
         bool useValueNumbering = !FFlag::DebugCodegenSkipNumbering;
 
+        // Block-local propagation can't remove checks repeated on each loop iteration, so those are handled first
+        if (!FFlag::DebugCodegenOptSize)
+            hoistLoopInvariantChecks(ir);
+
         constPropInBlockChains(ir, useValueNumbering);
 
         if (!FFlag::DebugCodegenOptSize)
@@ -309,6 +325,11 @@ inline bool lowerFunction(IrBuilder& ir, AssemblyBuilder& build, ModuleHelpers&
                 stats->blockLinearizationStats.constPropInstructionCount += constPropInstructionCount;
             }
         }
+
+        // Tag checks repeated after control flow joins are outside of block chains handled by constant propagation
+        removeRedundantTagChecks(ir);
+
+        killDeadStoresInBlocks(ir.function);
     }
 
     std::vector<uint32_t> sortedBlocks = getSortedBlockOrder(ir.function);
@@ -316,6 +337,8 @@ inline bool lowerFunction(IrBuilder& ir, AssemblyBuilder& build, ModuleHelpers&
     // In order to allocate registers during lowering, we need to know where instruction results are last used
     updateLastUseLocations(ir.function, sortedBlocks);
 
+    double loweringStartTime = 0.0;
+
     if (stats)
     {
         for (const IrBlock& block : ir.function.blocks)
@@ -323,10 +346,16 @@ inline bool lowerFunction(IrBuilder& ir, AssemblyBuilder& build, ModuleHelpers&
             if (block.kind != IrBlockKind::Dead)
                 ++stats->blocksPostOpt;
         }
+
+        loweringStartTime = lua_clock();
+        stats->phaseTimeStats.optimizeSeconds += loweringStartTime - optimizeStartTime;
     }
 
     bool result = lowerIr(build, ir, sortedBlocks, helpers, proto, options, stats);
 
+    if (stats)
+        stats->phaseTimeStats.loweringSeconds += lua_clock() - loweringStartTime;
+
     if (!result)
         codeGenCompilationResult = CodeGenCompilationResult::CodeGenLoweringFailure;
 
@@ -60,74 +60,6 @@ namespace Luau
 namespace CodeGen
 {
 
-bool forgLoopTableIter(lua_State* L, Table* h, int index, TValue* ra)
-{
-    int sizearray = h->sizearray;
-
-    // first we advance index through the array portion
-    while (unsigned(index) < unsigned(sizearray))
-    {
-        TValue* e = &h->array[index];
-
-        if (!ttisnil(e))
-        {
-            setpvalue(ra + 2, reinterpret_cast<void*>(uintptr_t(index + 1)), LU_TAG_ITERATOR);
-            setnvalue(ra + 3, double(index + 1));
-            setobj2s(L, ra + 4, e);
-
-            return true;
-        }
-
-        index++;
-    }
-
-    int sizenode = 1 << h->lsizenode;
-
-    // then we advance index through the hash portion
-    while (unsigned(index - h->sizearray) < unsigned(sizenode))
-    {
-        LuaNode* n = &h->node[index - sizearray];
-
-        if (!ttisnil(gval(n)))
-        {
-            setpvalue(ra + 2, reinterpret_cast<void*>(uintptr_t(index + 1)), LU_TAG_ITERATOR);
-            getnodekey(L, ra + 3, n);
-            setobj(L, ra + 4, gval(n));
-
-            return true;
-        }
-
-        index++;
-    }
-
-    return false;
-}
-
-bool forgLoopNodeIter(lua_State* L, Table* h, int index, TValue* ra)
-{
-    int sizearray = h->sizearray;
-    int sizenode = 1 << h->lsizenode;
-
-    // then we advance index through the hash portion
-    while (unsigned(index - sizearray) < unsigned(sizenode))
-    {
-        LuaNode* n = &h->node[index - sizearray];
-
-        if (!ttisnil(gval(n)))
-        {
-            setpvalue(ra + 2, reinterpret_cast<void*>(uintptr_t(index + 1)), LU_TAG_ITERATOR);
-            getnodekey(L, ra + 3, n);
-            setobj(L, ra + 4, gval(n));
-
-            return true;
-        }
-
-        index++;
-    }
-
-    return false;
-}
-
 bool forgLoopNonTableFallback(lua_State* L, int insnA, int aux)
 {
     TValue* base = L->base;
@@ -176,6 +108,10 @@ Closure* callProlog(lua_State* L, TValue* ra, StkId argtop, int nresults)
 
     Closure* ccl = clvalue(ra);
 
+    // fast C functions with a matching signature skip the call frame setup
+    if (ccl->isC && ccl->c.fast && luaV_fastcall(L, ccl->c.fast, ra, argtop, nresults))
+        return NULL;
+
     CallInfo* ci = incr_ci(L);
     ci->func = ra;
     ci->base = ra + 1;
@@ -195,6 +131,51 @@ Closure* callProlog(lua_State* L, TValue* ra, StkId argtop, int nresults)
     return ccl;
 }
 
+// reuses the current frame for a call in tail position, see LOP_TAILCALL; returns NULL if the call needs a frame of its own
+static Closure* callTailReuseFrame(lua_State* L, StkId ra, StkId argtop)
+{
+    // only Lua functions can take over the frame; the first frame of the interpreter entry has to stay to return from luau_execute
+    if (!ttisfunction(ra) || clvalue(ra)->isC || (L->ci->flags & LUA_CALLINFO_RETURN))
+        return NULL;
+
+    Closure* ccl = clvalue(ra);
+
+    CallInfo* ci = L->ci;
+    StkId func = ci->func;
+
+    // the compiler closes upvalues before returning so this is normally a no-op
+    luaF_close(L, L->base);
+
+    // move function and arguments over the current frame; the frame keeps nresults of the original call
+    int n = cast_int(argtop - ra);
+    for (int i = 0; i < n; ++i)
+        setobj2s(L, func + i, ra + i);
+
+    ci->base = func + 1;
+    ci->top = func + n + ccl->stacksize; // note: technically UB since we haven't reallocated the stack yet
+    ci->savedpc = NULL;
+    ci->flags = 0;
+
+    L->base = ci->base;
+    L->top = func + n;
+
+    // note: this reallocs stack, but we don't need to VM_PROTECT this
+    // this is because we're going to modify base/savedpc manually anyhow
+    luaD_checkstack(L, ccl->stacksize);
+
+    return ccl;
+}
+
+Closure* callTailProlog(lua_State* L, TValue* ra, StkId argtop, int nresults)
+{
+    LUAU_ASSERT(nresults == LUA_MULTRET);
+
+    if (Closure* ccl = callTailReuseFrame(L, ra, argtop))
+        return ccl;
+
+    return callProlog(L, ra, argtop, nresults);
+}
+
 void callEpilogC(lua_State* L, int nresults, int n)
 {
     // ci is our callinfo, cip is our parent
@@ -220,6 +201,28 @@ void callEpilogC(lua_State* L, int nresults, int n)
 }
 
 // Extracted as-is from lvmexecute.cpp with the exception of control flow (reentry) and removed interrupts/savedpc
+// starts executing a Lua function in the frame that was prepared for it
+static Closure* callFallbackEnter(lua_State* L, Closure* ccl)
+{
+    CallInfo* ci = L->ci;
+    Proto* p = ccl->l.p;
+
+    // fill unused parameters with nil
+    StkId argi = L->top;
+    StkId argend = L->base + p->numparams;
+    while (argi < argend)
+        setnilvalue(argi++); // complete missing arguments
+    L->top = p->is_vararg ? argi : ci->top;
+
+    // keep executing new function
+    ci->savedpc = p->code;
+
+    if (LUAU_LIKELY(p->execdata != NULL))
+        ci->flags = LUA_CALLINFO_NATIVE;
+
+    return ccl;
+}
+
 Closure* callFallback(lua_State* L, StkId ra, StkId argtop, int nresults)
 {
     // slow-path: not a function call
@@ -231,6 +234,10 @@ Closure* callFallback(lua_State* L, StkId ra, StkId argtop, int nresults)
 
     Closure* ccl = clvalue(ra);
 
+    // fast C functions with a matching signature skip the call frame setup
+    if (ccl->isC && ccl->c.fast && luaV_fastcall(L, ccl->c.fast, ra, argtop, nresults))
+        return NULL;
+
     CallInfo* ci = incr_ci(L);
     ci->func = ra;
     ci->base = ra + 1;
@@ -251,22 +258,7 @@ Closure* callFallback(lua_State* L, StkId ra, StkId argtop, int nresults)
 
     if (!ccl->isC)
     {
-        Proto* p = ccl->l.p;
-
-        // fill unused parameters with nil
-        StkId argi = L->top;
-        StkId argend = L->base + p->numparams;
-        while (argi < argend)
-            setnilvalue(argi++); // complete missing arguments
-        L->top = p->is_vararg ? argi : ci->top;
-
-        // keep executing new function
-        ci->savedpc = p->code;
-
-        if (LUAU_LIKELY(p->execdata != NULL))
-            ci->flags = LUA_CALLINFO_NATIVE;
-
-        return ccl;
+        return callFallbackEnter(L, ccl);
     }
     else
     {
@@ -303,6 +295,20 @@ Closure* callFallback(lua_State* L, StkId ra, StkId argtop, int nresults)
     }
 }
 
+Closure* callTailFallback(lua_State* L, StkId ra, StkId argtop, int nresults)
+{
+    LUAU_ASSERT(nresults == LUA_MULTRET);
+
+    if (Closure* ccl = callTailReuseFrame(L, ra, argtop))
+    {
+        LUAU_ASSERT(L->ci->top <= L->stack_last);
+
+        return callFallbackEnter(L, ccl);
+    }
+
+    return callFallback(L, ra, argtop, nresults);
+}
+
 const Instruction* executeGETGLOBAL(lua_State* L, const Instruction* pc, StkId base, TValue* k)
 {
     [[maybe_unused]] Closure* cl = clvalue(L->ci->func);
@@ -394,6 +400,17 @@ const Instruction* executeGETTABLEKS(lua_State* L, const Instruction* pc, StkId
     }
     else
     {
+        // fast-path: inline field of user data
+        int field = ttisuserdata(rb) ? luaV_findudatafield(L, uvalue(rb), tsvalue(kv), LUAU_INSN_C(insn)) : -1;
+
+        if (field >= 0)
+        {
+            luaV_getudatafield(L, uvalue(rb), field, ra);
+            // save field index to accelerate future lookups; patches currently executing instruction since pc-2 rolls back two pc++
+            VM_PATCH_C(pc - 2, field);
+            return pc;
+        }
+
         // fast-path: user data with C __index TM
         const TValue* fn = 0;
         if (ttisuserdata(rb) && (fn = fasttm(L, uvalue(rb)->metatable, TM_INDEX)) && ttisfunction(fn) && clvalue(fn)->isC)
@@ -503,6 +520,17 @@ const Instruction* executeSETTABLEKS(lua_State* L, const Instruction* pc, StkId
     }
     else
     {
+        // fast-path: inline field of user data
+        int field = ttisuserdata(rb) ? luaV_findudatafield(L, uvalue(rb), tsvalue(kv), LUAU_INSN_C(insn)) : -1;
+
+        if (field >= 0)
+        {
+            VM_PROTECT(luaV_setudatafield(L, uvalue(rb), field, ra));
+            // save field index to accelerate future lookups; patches currently executing instruction since pc-2 rolls back two pc++
+            VM_PATCH_C(pc - 2, field);
+            return pc;
+        }
+
         // fast-path: user data with C __newindex TM
         const TValue* fn = 0;
         if (ttisuserdata(rb) && (fn = fasttm(L, uvalue(rb)->metatable, TM_NEWINDEX)) && ttisfunction(fn) && clvalue(fn)->isC)
@@ -543,19 +571,37 @@ const Instruction* executeNAMECALL(lua_State* L, const Instruction* pc, StkId ba
 
     if (ttistable(rb))
     {
-        // note: lvmexecute.cpp version of NAMECALL has two fast paths, but both fast paths are inlined into IR
-        // as such, if we get here we can just use the generic path which makes the fallback path a little faster
-
-        // slow-path: handles full table lookup
-        setobj2s(L, ra + 1, rb);
-        L->cachedslot = LUAU_INSN_C(insn);
-        VM_PROTECT(luaV_gettable(L, rb, kv, ra));
-        // save cachedslot to accelerate future lookups; patches currently executing instruction since pc-2 rolls back two pc++
-        VM_PATCH_C(pc - 2, L->cachedslot);
-        // recompute ra since stack might have been reallocated
-        ra = VM_REG(LUAU_INSN_A(insn));
-        if (ttisnil(ra))
-            luaG_methoderror(L, ra + 1, tsvalue(kv));
+        // note: lvmexecute.cpp version of NAMECALL has three fast paths, but the first two fast paths are inlined into IR
+        // as such, if we get here we only need to check the fast path for methods that are not in the expected slot of __index table
+        Table* h = hvalue(rb);
+        LuaNode* n = &h->node[tsvalue(kv)->hash & (sizenode(h) - 1)];
+
+        const TValue* mt = 0;
+        LuaNode* mtn = 0;
+
+        // fast-path: key is absent from the base, table has an __index table, and it has the result in another slot
+        if (gnext(n) == 0 && !(ttisstring(gkey(n)) && tsvalue(gkey(n)) == tsvalue(kv) && !ttisnil(gval(n))) &&
+            (mt = fasttm(L, h->metatable, TM_INDEX)) && ttistable(mt) && (mtn = luaH_getstrnode(hvalue(mt), tsvalue(kv))) && !ttisnil(gval(mtn)))
+        {
+            // note: order of copies allows rb to alias ra+1 or ra
+            setobj2s(L, ra + 1, rb);
+            setobj2s(L, ra, gval(mtn));
+            // save slot to accelerate future lookups; patches currently executing instruction since pc-2 rolls back two pc++
+            VM_PATCH_C(pc - 2, int(mtn - hvalue(mt)->node));
+        }
+        else
+        {
+            // slow-path: handles full table lookup
+            setobj2s(L, ra + 1, rb);
+            L->cachedslot = LUAU_INSN_C(insn);
+            VM_PROTECT(luaV_gettable(L, rb, kv, ra));
+            // save cachedslot to accelerate future lookups; patches currently executing instruction since pc-2 rolls back two pc++
+            VM_PATCH_C(pc - 2, L->cachedslot);
+            // recompute ra since stack might have been reallocated
+            ra = VM_REG(LUAU_INSN_A(insn));
+            if (ttisnil(ra))
+                luaG_methoderror(L, ra + 1, tsvalue(kv));
+        }
     }
     else
     {
@@ -584,6 +630,15 @@ const Instruction* executeNAMECALL(lua_State* L, const Instruction* pc, StkId ba
                 setobj2s(L, ra + 1, rb);
                 setobj2s(L, ra, gval(n));
             }
+            // fast-path: metatable with __index that has method in another slot, which is common for polymorphic call sites
+            else if ((n = luaH_getstrnode(h, tsvalue(kv))) && !ttisnil(gval(n)))
+            {
+                // note: order of copies allows rb to alias ra+1 or ra
+                setobj2s(L, ra + 1, rb);
+                setobj2s(L, ra, gval(n));
+                // save slot to accelerate future lookups; patches currently executing instruction since pc-2 rolls back two pc++
+                VM_PATCH_C(pc - 2, int(n - h->node));
+            }
             else
             {
                 // slow-path: handles slot mismatch
@@ -611,7 +666,7 @@ const Instruction* executeNAMECALL(lua_State* L, const Instruction* pc, StkId ba
     }
 
     // intentional fallthrough to CALL
-    LUAU_ASSERT(LUAU_INSN_OP(*pc) == LOP_CALL);
+    LUAU_ASSERT(LUAU_INSN_OP(*pc) == LOP_CALL || LUAU_INSN_OP(*pc) == LOP_TAILCALL);
     return pc;
 }
 
@@ -739,6 +794,20 @@ void executeGETVARARGSConst(lua_State* L, StkId base, int rai, int b)
         setnilvalue(ra + j);
 }
 
+double mathNoise(double x, double y, double z)
+{
+    return luai_perlin(float(x), float(y), float(z));
+}
+
+Closure* newLclosure(lua_State* L, int nelems, Table* e, Proto* p)
+{
+    // lazily loaded functions are decoded on first closure creation
+    if (LUAU_UNLIKELY(p->lazychunk != nullptr))
+        luaV_loadproto(L, p);
+
+    return luaF_newLclosure(L, nelems, e, p);
+}
+
 const Instruction* executeDUPCLOSURE(lua_State* L, const Instruction* pc, StkId base, TValue* k)
 {
     [[maybe_unused]] Closure* cl = clvalue(L->ci->func);
@@ -750,6 +819,10 @@ const Instruction* executeDUPCLOSURE(lua_State* L, const Instruction* pc, StkId
 
     VM_PROTECT_PC(); // luaF_newLclosure may fail due to OOM
 
+    // lazily loaded functions are decoded on first closure creation
+    if (LUAU_UNLIKELY(kcl->l.p->lazychunk != nullptr))
+        luaV_loadproto(L, kcl->l.p);
+
     // clone closure if the environment is not shared
     // note: we save closure to stack early in case the code below wants to capture it by value
     Closure* ncl = (kcl->env == cl->env) ? kcl : luaF_newLclosure(L, kcl->nupvalues, cl->env, kcl->l.p);
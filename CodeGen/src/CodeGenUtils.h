@@ -8,18 +8,22 @@ namespace Luau
 namespace CodeGen
 {
 
-bool forgLoopTableIter(lua_State* L, Table* h, int index, TValue* ra);
-bool forgLoopNodeIter(lua_State* L, Table* h, int index, TValue* ra);
 bool forgLoopNonTableFallback(lua_State* L, int insnA, int aux);
 
 void forgPrepXnextFallback(lua_State* L, TValue* ra, int pc);
 
 Closure* callProlog(lua_State* L, TValue* ra, StkId argtop, int nresults);
+Closure* callTailProlog(lua_State* L, TValue* ra, StkId argtop, int nresults);
 void callEpilogC(lua_State* L, int nresults, int n);
 
 #define CALL_FALLBACK_YIELD 1
 
 Closure* callFallback(lua_State* L, StkId ra, StkId argtop, int nresults);
+Closure* callTailFallback(lua_State* L, StkId ra, StkId argtop, int nresults);
+
+double mathNoise(double x, double y, double z);
+
+Closure* newLclosure(lua_State* L, int nelems, Table* e, Proto* p);
 
 const Instruction* executeGETGLOBAL(lua_State* L, const Instruction* pc, StkId base, TValue* k);
 const Instruction* executeSETGLOBAL(lua_State* L, const Instruction* pc, StkId base, TValue* k);
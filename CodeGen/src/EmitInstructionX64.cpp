@@ -16,7 +16,7 @@ namespace CodeGen
 namespace X64
 {
 
-void emitInstCall(AssemblyBuilderX64& build, ModuleHelpers& helpers, int ra, int nparams, int nresults)
+void emitInstCall(AssemblyBuilderX64& build, ModuleHelpers& helpers, int ra, int nparams, int nresults, bool tail)
 {
     // TODO: This should use IrCallWrapperX64
     RegisterX64 rArg1 = (build.abi == ABIX64::Windows) ? rcx : rdi;
@@ -33,11 +33,22 @@ void emitInstCall(AssemblyBuilderX64& build, ModuleHelpers& helpers, int ra, int
         build.lea(rArg3, luauRegAddress(ra + 1 + nparams));
 
     build.mov(dwordReg(rArg4), nresults);
-    build.call(qword[rNativeContext + offsetof(NativeContext, callProlog)]);
+
+    // tail calls may take over the current frame, in which case the code below enters the callee in it
+    if (tail)
+        build.call(qword[rNativeContext + offsetof(NativeContext, callTailProlog)]);
+    else
+        build.call(qword[rNativeContext + offsetof(NativeContext, callProlog)]);
     RegisterX64 ccl = rax; // Returned from callProlog
 
     emitUpdateBase(build);
 
+    // NULL implies that the call was completed by a fast C function
+    Label fastCallDone;
+
+    build.test(ccl, ccl);
+    build.jcc(ConditionX64::Zero, fastCallDone);
+
     Label cFuncCall;
 
     build.test(byte[ccl + offsetof(Closure, isC)], 1);
@@ -131,6 +142,7 @@ void emitInstCall(AssemblyBuilderX64& build, ModuleHelpers& helpers, int ra, int
             build.call(qword[rNativeContext + offsetof(NativeContext, callEpilogC)]);
 
             emitUpdateBase(build);
+            build.setLabel(fastCallDone);
             return;
         }
 
@@ -170,6 +182,8 @@ void emitInstCall(AssemblyBuilderX64& build, ModuleHelpers& helpers, int ra, int
         build.mov(rax, qword[cip + offsetof(CallInfo, top)]);
         build.mov(qword[rState + offsetof(lua_State, top)], rax);
     }
+
+    build.setLabel(fastCallDone);
 }
 
 void emitInstReturn(AssemblyBuilderX64& build, ModuleHelpers& helpers, int ra, int actualResults, bool functionVariadic)
@@ -361,17 +375,11 @@ void emitInstForGLoop(AssemblyBuilderX64& build, int ra, int aux, Label& loopRep
     // ipairs-style traversal is handled in IR
     CODEGEN_ASSERT(aux >= 0);
 
-    // TODO: This should use IrCallWrapperX64
-    RegisterX64 rArg1 = (build.abi == ABIX64::Windows) ? rcx : rdi;
-    RegisterX64 rArg2 = (build.abi == ABIX64::Windows) ? rdx : rsi;
-    RegisterX64 rArg3 = (build.abi == ABIX64::Windows) ? r8 : rdx;
-    RegisterX64 rArg4 = (build.abi == ABIX64::Windows) ? r9 : rcx;
-
     // This is a fast-path for builtin table iteration, tag check for 'ra' has to be performed before emitting this instruction
 
-    // Registers are chosen in this way to simplify fallback code for the node part
-    RegisterX64 table = rArg2;
-    RegisterX64 index = rArg3;
+    // Only registers that are volatile in both ABIs are used; rcx is reserved for the shift by lsizenode
+    RegisterX64 table = rdx;
+    RegisterX64 index = r8;
     RegisterX64 elemPtr = rax;
 
     build.mov(table, luauRegValue(ra + 1));
@@ -423,13 +431,57 @@ void emitInstForGLoop(AssemblyBuilderX64& build, int ra, int aux, Label& loopRep
 
     build.setLabel(skipArray);
 
-    // Call helper to assign next node value or to signal loop exit
-    build.mov(rArg1, rState);
-    // rArg2 and rArg3 are already set
-    build.lea(rArg4, luauRegAddress(ra));
-    build.call(qword[rNativeContext + offsetof(NativeContext, forgLoopNodeIter)]);
-    build.test(al, al);
-    build.jcc(ConditionX64::NotZero, loopRepeat);
+    // Then we advance through the hash portion, keeping both the combined index and the node index
+    RegisterX64 nodeIndex = r10;
+    RegisterX64 sizenode = r11;
+    Label nodeLoopExit, skipNodeNil;
+
+    build.mov(dwordReg(nodeIndex), dwordReg(index));
+    build.sub(dwordReg(nodeIndex), dword[table + offsetof(Table, sizearray)]);
+
+    // Custom bit shift value can only be placed in cl
+    build.mov(byteReg(rcx), byte[table + offsetof(Table, lsizenode)]);
+    build.mov(dwordReg(sizenode), 1);
+    build.shl(dwordReg(sizenode), byteReg(rcx));
+
+    // &node[nodeIndex]
+    build.mov(dwordReg(elemPtr), dwordReg(nodeIndex));
+    build.shl(elemPtr, kLuaNodeSizeLog2);
+    build.add(elemPtr, qword[table + offsetof(Table, node)]);
+
+    // while (unsigned(nodeIndex) < unsigned(sizenode))
+    Label nodeLoop = build.setLabel();
+    build.cmp(dwordReg(nodeIndex), dwordReg(sizenode));
+    build.jcc(ConditionX64::NotBelow, nodeLoopExit);
+
+    build.inc(index);
+    build.inc(nodeIndex);
+
+    build.cmp(dword[elemPtr + offsetof(LuaNode, val) + offsetof(TValue, tt)], LUA_TNIL);
+    build.jcc(ConditionX64::Equal, skipNodeNil);
+
+    // setpvalue(ra + 2, reinterpret_cast<void*>(uintptr_t(index + 1)), LU_TAG_ITERATOR);
+    build.mov(luauRegValue(ra + 2), index);
+
+    // getnodekey(L, ra + 3, n); key tag shares a dword with 'next' and has to be extracted
+    build.vmovups(xmm0, xmmword[elemPtr + offsetof(LuaNode, key)]);
+    build.vmovups(luauReg(ra + 3), xmm0);
+    build.mov(ecx, dword[elemPtr + offsetof(LuaNode, key) + kOffsetOfTKeyTagNext]);
+    build.and_(ecx, kTKeyTagMask);
+    build.mov(luauRegTag(ra + 3), ecx);
+
+    // setobj(L, ra + 4, gval(n));
+    setLuauReg(build, xmm2, ra + 4, xmmword[elemPtr + offsetof(LuaNode, val)]);
+
+    build.jmp(loopRepeat);
+
+    build.setLabel(skipNodeNil);
+
+    // Index already incremented, advance to next node
+    build.add(elemPtr, sizeof(LuaNode));
+    build.jmp(nodeLoop);
+
+    build.setLabel(nodeLoopExit);
 }
 
 } // namespace X64
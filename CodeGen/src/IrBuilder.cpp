@@ -115,7 +115,7 @@ void IrBuilder::buildFunctionIr(Proto* proto)
 
     // Reserve entry block
     bool generateTypeChecks = hasTypedParameters(proto);
-    IrOp entry = generateTypeChecks ? block(IrBlockKind::Internal) : IrOp{};
+    IrOp entry = generateTypeChecks || countExecutions ? block(IrBlockKind::Internal) : IrOp{};
 
     // Rebuild original control flow blocks
     rebuildBytecodeBasicBlocks(proto);
@@ -125,10 +125,20 @@ void IrBuilder::buildFunctionIr(Proto* proto)
 
     function.bcMapping.resize(proto->sizecode, {~0u, ~0u});
 
-    if (generateTypeChecks)
+    if (generateTypeChecks || countExecutions)
     {
         beginBlock(entry);
-        buildArgumentTypeChecks(*this, proto);
+
+        // Entry counter is separate from the first block counter, since the first block can be a loop header
+        if (countExecutions)
+        {
+            inst(IrCmd::INCREMENT_COUNTER, constUint(uint32_t(function.counterPcs.size())));
+            function.counterPcs.push_back(0);
+        }
+
+        if (generateTypeChecks)
+            buildArgumentTypeChecks(*this, proto);
+
         inst(IrCmd::JUMP, blockAtInst(0));
     }
     else
@@ -151,8 +161,16 @@ void IrBuilder::buildFunctionIr(Proto* proto)
 
         // Begin new block at this instruction if it was in the bytecode or requested during translation
         if (instIndexToBlock[i] != kNoAssociatedBlockIndex)
+        {
             beginBlock(blockAtInst(i));
 
+            if (countExecutions)
+            {
+                inst(IrCmd::INCREMENT_COUNTER, constUint(uint32_t(function.counterPcs.size())));
+                function.counterPcs.push_back(uint32_t(i));
+            }
+        }
+
         // Numeric for loops require additional processing to maintain loop stack
         // Notably, this must be performed even when the block is dead so that we maintain the pairing FORNPREP-FORNLOOP
         if (op == LOP_FORNPREP)
@@ -255,6 +273,9 @@ void IrBuilder::translateInst(LuauOpcode op, const Instruction* pc, int i)
     case LOP_MOVE:
         translateInstMove(*this, pc);
         break;
+    case LOP_MOVE2:
+        translateInstMove2(*this, pc);
+        break;
     case LOP_GETGLOBAL:
         translateInstGetGlobal(*this, pc, i);
         break;
@@ -276,6 +297,13 @@ void IrBuilder::translateInst(LuauOpcode op, const Instruction* pc, int i)
             activeFastcallFallback = false;
         }
         break;
+    case LOP_TAILCALL:
+        inst(IrCmd::INTERRUPT, constUint(i));
+        inst(IrCmd::SET_SAVEDPC, constUint(i + 1));
+
+        // when the frame is reused, the callee returns directly to our caller and the RETURN that follows is never reached
+        inst(IrCmd::CALL, vmReg(LUAU_INSN_A(*pc)), constInt(LUAU_INSN_B(*pc) - 1), constInt(LUA_MULTRET), constInt(1));
+        break;
     case LOP_RETURN:
         inst(IrCmd::INTERRUPT, constUint(i));
 
@@ -487,7 +515,7 @@ void IrBuilder::translateInst(LuauOpcode op, const Instruction* pc, int i)
         translateInstOrX(*this, pc, i, vmConst(LUAU_INSN_C(*pc)));
         break;
     case LOP_COVERAGE:
-        inst(IrCmd::COVERAGE, constUint(i));
+        inst(IrCmd::COVERAGE, constUint(i), constInt(coverageFirstHit ? 1 : 0));
         break;
     case LOP_GETIMPORT:
         translateInstGetImport(*this, pc, i);
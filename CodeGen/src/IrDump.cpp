@@ -189,6 +189,8 @@ const char* getCmdName(IrCmd cmd)
         return "TABLE_SETNUM";
     case IrCmd::STRING_LEN:
         return "STRING_LEN";
+    case IrCmd::STRING_READU8:
+        return "STRING_READU8";
     case IrCmd::NEW_TABLE:
         return "NEW_TABLE";
     case IrCmd::DUP_TABLE:
@@ -207,6 +209,8 @@ const char* getCmdName(IrCmd cmd)
         return "NUM_TO_UINT";
     case IrCmd::NUM_TO_VECTOR:
         return "NUM_TO_VECTOR";
+    case IrCmd::TAG_VECTOR:
+        return "TAG_VECTOR";
     case IrCmd::ADJUST_STACK_TO_REG:
         return "ADJUST_STACK_TO_REG";
     case IrCmd::ADJUST_STACK_TO_TOP:
@@ -253,8 +257,12 @@ const char* getCmdName(IrCmd cmd)
         return "CHECK_NODE_VALUE";
     case IrCmd::CHECK_BUFFER_LEN:
         return "CHECK_BUFFER_LEN";
+    case IrCmd::CHECK_STRING_LEN:
+        return "CHECK_STRING_LEN";
     case IrCmd::INTERRUPT:
         return "INTERRUPT";
+    case IrCmd::INCREMENT_COUNTER:
+        return "INCREMENT_COUNTER";
     case IrCmd::CHECK_GC:
         return "CHECK_GC";
     case IrCmd::BARRIER_OBJ:
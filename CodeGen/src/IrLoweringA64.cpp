@@ -677,10 +677,6 @@ void IrLoweringA64::lowerInst(IrInst& inst, uint32_t index, const IrBlock& next)
         if (FFlag::LuauCodeGenVectorA64)
         {
             build.fadd(inst.regA64, regOp(inst.a), regOp(inst.b));
-
-            RegisterA64 tempw = regs.allocTemp(KindA64::w);
-            build.mov(tempw, LUA_TVECTOR);
-            build.ins_4s(inst.regA64, tempw, 3);
         }
         else
         {
@@ -704,10 +700,6 @@ void IrLoweringA64::lowerInst(IrInst& inst, uint32_t index, const IrBlock& next)
         if (FFlag::LuauCodeGenVectorA64)
         {
             build.fsub(inst.regA64, regOp(inst.a), regOp(inst.b));
-
-            RegisterA64 tempw = regs.allocTemp(KindA64::w);
-            build.mov(tempw, LUA_TVECTOR);
-            build.ins_4s(inst.regA64, tempw, 3);
         }
         else
         {
@@ -731,10 +723,6 @@ void IrLoweringA64::lowerInst(IrInst& inst, uint32_t index, const IrBlock& next)
         if (FFlag::LuauCodeGenVectorA64)
         {
             build.fmul(inst.regA64, regOp(inst.a), regOp(inst.b));
-
-            RegisterA64 tempw = regs.allocTemp(KindA64::w);
-            build.mov(tempw, LUA_TVECTOR);
-            build.ins_4s(inst.regA64, tempw, 3);
         }
         else
         {
@@ -758,10 +746,6 @@ void IrLoweringA64::lowerInst(IrInst& inst, uint32_t index, const IrBlock& next)
         if (FFlag::LuauCodeGenVectorA64)
         {
             build.fdiv(inst.regA64, regOp(inst.a), regOp(inst.b));
-
-            RegisterA64 tempw = regs.allocTemp(KindA64::w);
-            build.mov(tempw, LUA_TVECTOR);
-            build.ins_4s(inst.regA64, tempw, 3);
         }
         else
         {
@@ -785,10 +769,6 @@ void IrLoweringA64::lowerInst(IrInst& inst, uint32_t index, const IrBlock& next)
         if (FFlag::LuauCodeGenVectorA64)
         {
             build.fneg(inst.regA64, regOp(inst.a));
-
-            RegisterA64 tempw = regs.allocTemp(KindA64::w);
-            build.mov(tempw, LUA_TVECTOR);
-            build.ins_4s(inst.regA64, tempw, 3);
         }
         else
         {
@@ -1033,6 +1013,38 @@ void IrLoweringA64::lowerInst(IrInst& inst, uint32_t index, const IrBlock& next)
         build.ldr(inst.regA64, mem(regOp(inst.a), offsetof(TString, len)));
         break;
     }
+    case IrCmd::STRING_READU8:
+    {
+        inst.regA64 = regs.allocReuse(KindA64::w, index, {inst.b});
+
+        if (inst.b.kind == IrOpKind::Inst)
+        {
+            RegisterA64 temp = regs.allocTemp(KindA64::x);
+            build.add(temp, regOp(inst.a), regOp(inst.b)); // implicit uxtw
+            build.ldrb(inst.regA64, mem(temp, offsetof(TString, data)));
+        }
+        else if (inst.b.kind == IrOpKind::Constant)
+        {
+            // offset is checked against the string length, so it can only be negative in dead code
+            size_t offset = size_t(unsigned(intOp(inst.b))) + offsetof(TString, data);
+
+            if (offset <= 255)
+            {
+                build.ldrb(inst.regA64, mem(regOp(inst.a), int(offset)));
+            }
+            else
+            {
+                RegisterA64 temp = regs.allocTemp(KindA64::x);
+                emitAddOffset(build, temp, regOp(inst.a), offset);
+                build.ldrb(inst.regA64, temp);
+            }
+        }
+        else
+        {
+            CODEGEN_ASSERT(!"Unsupported instruction form");
+        }
+        break;
+    }
     case IrCmd::TABLE_SETNUM:
     {
         // note: we need to call regOp before spill so that we don't do redundant reloads
@@ -1162,10 +1174,20 @@ void IrLoweringA64::lowerInst(IrInst& inst, uint32_t index, const IrBlock& next)
 
         RegisterA64 tempd = tempDouble(inst.a);
         RegisterA64 temps = castReg(KindA64::s, tempd);
-        RegisterA64 tempw = regs.allocTemp(KindA64::w);
 
         build.fcvt(temps, tempd);
         build.dup_4s(inst.regA64, castReg(KindA64::q, temps), 0);
+        break;
+    }
+    case IrCmd::TAG_VECTOR:
+    {
+        inst.regA64 = regs.allocReuse(KindA64::q, index, {inst.a});
+
+        RegisterA64 reg = regOp(inst.a);
+        RegisterA64 tempw = regs.allocTemp(KindA64::w);
+
+        if (inst.regA64 != reg)
+            build.mov(inst.regA64, reg);
 
         build.mov(tempw, LUA_TVECTOR);
         build.ins_4s(inst.regA64, tempw, 3);
@@ -1570,6 +1592,38 @@ void IrLoweringA64::lowerInst(IrInst& inst, uint32_t index, const IrBlock& next)
         finalizeTargetLabel(inst.b, fresh);
         break;
     }
+    case IrCmd::CHECK_STRING_LEN:
+    {
+        Label fresh; // used when guard aborts execution or jumps to a VM exit
+        Label& target = getTargetLabel(inst.c, fresh);
+
+        RegisterA64 temp = regs.allocTemp(KindA64::w);
+        build.ldr(temp, mem(regOp(inst.a), offsetof(TString, len)));
+
+        // fails if offset >= len; negative offsets fail as well since the comparison is unsigned
+        if (inst.b.kind == IrOpKind::Inst)
+        {
+            build.cmp(temp, regOp(inst.b));
+        }
+        else if (inst.b.kind == IrOpKind::Constant && unsigned(intOp(inst.b)) <= AssemblyBuilderA64::kMaxImmediate)
+        {
+            build.cmp(temp, uint16_t(intOp(inst.b)));
+        }
+        else if (inst.b.kind == IrOpKind::Constant)
+        {
+            RegisterA64 temp2 = regs.allocTemp(KindA64::w);
+            build.mov(temp2, intOp(inst.b));
+            build.cmp(temp, temp2);
+        }
+        else
+        {
+            CODEGEN_ASSERT(!"Unsupported instruction form");
+        }
+
+        build.b(ConditionA64::UnsignedLessEqual, target);
+        finalizeTargetLabel(inst.c, fresh);
+        break;
+    }
     case IrCmd::CHECK_BUFFER_LEN:
     {
         int accessSize = intOp(inst.c);
@@ -1645,6 +1699,19 @@ void IrLoweringA64::lowerInst(IrInst& inst, uint32_t index, const IrBlock& next)
         interruptHandlers.push_back({self, uintOp(inst.a), next});
         break;
     }
+    case IrCmd::INCREMENT_COUNTER:
+    {
+        RegisterA64 temp1 = regs.allocTemp(KindA64::x);
+        RegisterA64 temp2 = regs.allocTemp(KindA64::x);
+
+        build.ldr(temp1, mem(rClosure, offsetof(Closure, l.p)));
+        build.ldr(temp1, mem(temp1, offsetof(Proto, execdata)));
+        emitAddOffset(build, temp1, temp1, getExecDataCounterOffset(function.proto->sizecode) + uintOp(inst.a) * sizeof(uint64_t));
+        build.ldr(temp2, temp1);
+        build.add(temp2, temp2, uint16_t(1));
+        build.str(temp2, temp1);
+        break;
+    }
     case IrCmd::CHECK_GC:
     {
         RegisterA64 temp1 = regs.allocTemp(KindA64::x);
@@ -1792,7 +1859,12 @@ void IrLoweringA64::lowerInst(IrInst& inst, uint32_t index, const IrBlock& next)
         build.mov(x0, rState);
         build.add(x1, rBase, uint16_t(vmRegOp(inst.a) * sizeof(TValue)));
         build.mov(w3, intOp(inst.c));
-        build.ldr(x4, mem(rNativeContext, offsetof(NativeContext, callFallback)));
+
+        // tail calls may take over the current frame, in which case continueCall enters the callee in it
+        if (inst.d.kind != IrOpKind::None && intOp(inst.d) != 0)
+            build.ldr(x4, mem(rNativeContext, offsetof(NativeContext, callTailFallback)));
+        else
+            build.ldr(x4, mem(rNativeContext, offsetof(NativeContext, callFallback)));
         build.blr(x4);
 
         emitUpdateBase(build);
@@ -1869,26 +1941,96 @@ void IrLoweringA64::lowerInst(IrInst& inst, uint32_t index, const IrBlock& next)
         }
         break;
     case IrCmd::FORGLOOP:
+    {
         // register layout: ra + 1 = table, ra + 2 = internal index, ra + 3 .. ra + aux = iteration variables
         regs.spill(build, index);
+        int ra = vmRegOp(inst.a);
         // clear extra variables since we might have more than two
         if (intOp(inst.b) > 2)
         {
             CODEGEN_ASSERT(LUA_TNIL == 0);
             for (int i = 2; i < intOp(inst.b); ++i)
-                build.str(wzr, mem(rBase, (vmRegOp(inst.a) + 3 + i) * sizeof(TValue) + offsetof(TValue, tt)));
-        }
-        // we use full iter fallback for now; in the future it could be worthwhile to accelerate array iteration here
-        build.mov(x0, rState);
-        build.ldr(x1, mem(rBase, (vmRegOp(inst.a) + 1) * sizeof(TValue) + offsetof(TValue, value.gc)));
-        build.ldr(w2, mem(rBase, (vmRegOp(inst.a) + 2) * sizeof(TValue) + offsetof(TValue, value.p)));
-        build.add(x3, rBase, uint16_t(vmRegOp(inst.a) * sizeof(TValue)));
-        build.ldr(x4, mem(rNativeContext, offsetof(NativeContext, forgLoopTableIter)));
-        build.blr(x4);
-        // note: no emitUpdateBase necessary because forgLoopTableIter does not reallocate stack
-        build.cbnz(w0, labelOp(inst.c));
+                build.str(wzr, mem(rBase, (ra + 3 + i) * sizeof(TValue) + offsetof(TValue, tt)));
+        }
+
+        // all registers are free after the spill; x0 = table, w1 = index, x2 = element pointer
+        Label arrayLoop, skipArray, skipArrayNil, nodeLoop, nodeLoopExit, skipNodeNil;
+
+        build.ldr(x0, mem(rBase, (ra + 1) * sizeof(TValue) + offsetof(TValue, value.gc)));
+        build.ldr(w1, mem(rBase, (ra + 2) * sizeof(TValue) + offsetof(TValue, value.p)));
+
+        // first we advance index through the array portion
+        build.ldr(x2, mem(x0, offsetof(Table, array)));
+        build.add(x2, x2, w1, kTValueSizeLog2); // implicit uxtw
+        build.ldr(w4, mem(x0, offsetof(Table, sizearray)));
+
+        build.setLabel(arrayLoop);
+        build.cmp(w1, w4);
+        build.b(ConditionA64::CarrySet, skipArray); // CarrySet == UnsignedGreaterEqual
+
+        // if element is nil, we increment the index; if it's not, we still need 'index + 1'
+        build.add(w1, w1, 1);
+        build.ldr(w3, mem(x2, offsetof(TValue, tt)));
+        build.cbz(w3, skipArrayNil);
+
+        // setpvalue(ra + 2, reinterpret_cast<void*>(uintptr_t(index + 1)), LU_TAG_ITERATOR); upper 32 bits of x1 are zero
+        build.str(x1, mem(rBase, (ra + 2) * sizeof(TValue) + offsetof(TValue, value.p)));
+
+        // setnvalue(ra + 3, double(index + 1));
+        build.scvtf(d0, w1);
+        build.str(d0, mem(rBase, (ra + 3) * sizeof(TValue) + offsetof(TValue, value.n)));
+        build.mov(w3, LUA_TNUMBER);
+        build.str(w3, mem(rBase, (ra + 3) * sizeof(TValue) + offsetof(TValue, tt)));
+
+        // setobj2s(L, ra + 4, e);
+        build.ldr(q0, mem(x2, 0));
+        build.str(q0, mem(rBase, (ra + 4) * sizeof(TValue)));
+        build.b(labelOp(inst.c));
+
+        build.setLabel(skipArrayNil);
+        build.add(x2, x2, uint16_t(sizeof(TValue)));
+        build.b(arrayLoop);
+
+        // then we advance through the hash portion; w5 = node index, w6 = node count
+        build.setLabel(skipArray);
+        build.sub(w5, w1, w4);
+        build.ldrb(w3, mem(x0, offsetof(Table, lsizenode)));
+        build.mov(w6, 1);
+        build.lsl(w6, w6, w3);
+        build.ldr(x2, mem(x0, offsetof(Table, node)));
+        build.add(x2, x2, w5, kLuaNodeSizeLog2); // implicit uxtw
+
+        build.setLabel(nodeLoop);
+        build.cmp(w5, w6);
+        build.b(ConditionA64::CarrySet, nodeLoopExit); // CarrySet == UnsignedGreaterEqual
+
+        build.add(w1, w1, 1);
+        build.add(w5, w5, 1);
+        build.ldr(w3, mem(x2, offsetof(LuaNode, val) + offsetof(TValue, tt)));
+        build.cbz(w3, skipNodeNil);
+
+        build.str(x1, mem(rBase, (ra + 2) * sizeof(TValue) + offsetof(TValue, value.p)));
+
+        // getnodekey(L, ra + 3, n); key tag shares a word with 'next' and has to be extracted
+        build.ldr(q0, mem(x2, offsetof(LuaNode, key)));
+        build.str(q0, mem(rBase, (ra + 3) * sizeof(TValue)));
+        build.ldr(w3, mem(x2, offsetof(LuaNode, key) + kOffsetOfTKeyTagNext));
+        build.ubfx(w3, w3, 0, kTKeyTagBits);
+        build.str(w3, mem(rBase, (ra + 3) * sizeof(TValue) + offsetof(TValue, tt)));
+
+        // setobj(L, ra + 4, gval(n));
+        build.ldr(q0, mem(x2, offsetof(LuaNode, val)));
+        build.str(q0, mem(rBase, (ra + 4) * sizeof(TValue)));
+        build.b(labelOp(inst.c));
+
+        build.setLabel(skipNodeNil);
+        build.add(x2, x2, uint16_t(sizeof(LuaNode)));
+        build.b(nodeLoop);
+
+        build.setLabel(nodeLoopExit);
         jumpOrFallthrough(blockOp(inst.d), next);
         break;
+    }
     case IrCmd::FORGLOOP_FALLBACK:
         regs.spill(build, index);
         build.mov(x0, rState);
@@ -1912,6 +2054,18 @@ void IrLoweringA64::lowerInst(IrInst& inst, uint32_t index, const IrBlock& next)
         break;
     case IrCmd::COVERAGE:
     {
+        if (intOp(inst.b) == 1)
+        {
+            RegisterA64 temp1 = regs.allocTemp(KindA64::x);
+            RegisterA64 temp2 = regs.allocTemp(KindA64::w);
+
+            // *pc = NOP with E=1, same as the interpreter does on the first hit
+            build.mov(temp1, uintOp(inst.a) * sizeof(Instruction));
+            build.mov(temp2, LOP_NOP | (1 << 8));
+            build.str(temp2, mem(rCode, temp1));
+            break;
+        }
+
         RegisterA64 temp1 = regs.allocTemp(KindA64::x);
         RegisterA64 temp2 = regs.allocTemp(KindA64::w);
         RegisterA64 temp3 = regs.allocTemp(KindA64::w);
@@ -2180,7 +2334,58 @@ void IrLoweringA64::lowerInst(IrInst& inst, uint32_t index, const IrBlock& next)
     }
     case IrCmd::INVOKE_LIBM:
     {
-        if (inst.c.kind != IrOpKind::None)
+        if (inst.d.kind != IrOpKind::None)
+        {
+            RegisterA64 temp1 = tempDouble(inst.b);
+            RegisterA64 temp2 = tempDouble(inst.c);
+            RegisterA64 temp3 = tempDouble(inst.d);
+            regs.spill(build, index, {temp1, temp2, temp3});
+
+            // arguments are placed into d0-d2 as a parallel move; a cycle is broken by passing one value through the temporary stack slot
+            RegisterA64 src[3] = {temp1, temp2, temp3};
+            RegisterA64 dst[3] = {d0, d1, d2};
+            bool pending[3] = {src[0] != d0, src[1] != d1, src[2] != d2};
+            int stashed = -1;
+
+            for (;;)
+            {
+                int next = -1;
+                int any = -1;
+
+                for (int i = 0; i < 3 && next < 0; i++)
+                {
+                    if (!pending[i])
+                        continue;
+
+                    bool blocked = false;
+
+                    for (int j = 0; j < 3; j++)
+                        if (j != i && j != stashed && pending[j] && src[j] == dst[i])
+                            blocked = true;
+
+                    any = i;
+                    next = blocked ? -1 : i;
+                }
+
+                if (any < 0)
+                    break;
+
+                if (next < 0)
+                {
+                    build.str(src[any], sTemporary);
+                    stashed = any;
+                    continue;
+                }
+
+                if (next == stashed)
+                    build.ldr(dst[next], sTemporary);
+                else
+                    build.fmov(dst[next], src[next]);
+
+                pending[next] = false;
+            }
+        }
+        else if (inst.c.kind != IrOpKind::None)
         {
             bool isInt = (inst.c.kind == IrOpKind::Constant) ? constOp(inst.c).kind == IrConstKind::Int
                                                              : getCmdValueKind(function.instOp(inst.c).cmd) == IrValueKind::Int;
@@ -381,12 +381,29 @@ void IrLoweringX64::lowerInst(IrInst& inst, uint32_t index, const IrBlock& next)
     case IrCmd::SUB_INT:
         inst.regX64 = regs.allocRegOrReuse(SizeX64::dword, index, {inst.a});
 
-        if (inst.regX64 == regOp(inst.a) && intOp(inst.b) == 1)
-            build.dec(inst.regX64);
-        else if (inst.regX64 == regOp(inst.a))
-            build.sub(inst.regX64, intOp(inst.b));
+        if (inst.a.kind == IrOpKind::Inst && inst.b.kind == IrOpKind::Constant)
+        {
+            if (inst.regX64 == regOp(inst.a) && intOp(inst.b) == 1)
+                build.dec(inst.regX64);
+            else if (inst.regX64 == regOp(inst.a))
+                build.sub(inst.regX64, intOp(inst.b));
+            else
+                build.lea(inst.regX64, addr[regOp(inst.a) - intOp(inst.b)]);
+        }
+        else if (inst.b.kind == IrOpKind::Inst)
+        {
+            // result register can't be shared with B, since it's not in the reuse list
+            if (inst.a.kind == IrOpKind::Constant)
+                build.mov(inst.regX64, intOp(inst.a));
+            else if (inst.regX64 != regOp(inst.a))
+                build.mov(inst.regX64, regOp(inst.a));
+
+            build.sub(inst.regX64, regOp(inst.b));
+        }
         else
-            build.lea(inst.regX64, addr[regOp(inst.a) - intOp(inst.b)]);
+        {
+            CODEGEN_ASSERT(!"Unsupported instruction form");
+        }
         break;
     case IrCmd::ADD_NUM:
         inst.regX64 = regs.allocRegOrReuse(SizeX64::xmmword, index, {inst.a, inst.b});
@@ -601,75 +618,62 @@ void IrLoweringX64::lowerInst(IrInst& inst, uint32_t index, const IrBlock& next)
     {
         inst.regX64 = regs.allocRegOrReuse(SizeX64::xmmword, index, {inst.a, inst.b});
 
-        ScopedRegX64 tmp1{regs, SizeX64::xmmword};
-        ScopedRegX64 tmp2{regs, SizeX64::xmmword};
+        ScopedRegX64 tmp1{regs};
+        ScopedRegX64 tmp2{regs};
+
+        RegisterX64 tmpa = vecOp(inst.a, tmp1);
+        RegisterX64 tmpb = inst.a == inst.b ? tmpa : vecOp(inst.b, tmp2);
 
-        // Fourth component is the tag number which is interpreted as a denormal and has to be filtered out
-        build.vandps(tmp1.reg, regOp(inst.a), vectorAndMaskOp());
-        build.vandps(tmp2.reg, regOp(inst.b), vectorAndMaskOp());
-        build.vaddps(inst.regX64, tmp1.reg, tmp2.reg);
-        build.vorps(inst.regX64, inst.regX64, vectorOrMaskOp());
+        build.vaddps(inst.regX64, tmpa, tmpb);
         break;
     }
     case IrCmd::SUB_VEC:
     {
         inst.regX64 = regs.allocRegOrReuse(SizeX64::xmmword, index, {inst.a, inst.b});
 
-        ScopedRegX64 tmp1{regs, SizeX64::xmmword};
-        ScopedRegX64 tmp2{regs, SizeX64::xmmword};
+        ScopedRegX64 tmp1{regs};
+        ScopedRegX64 tmp2{regs};
 
-        // Fourth component is the tag number which is interpreted as a denormal and has to be filtered out
-        build.vandps(tmp1.reg, regOp(inst.a), vectorAndMaskOp());
-        build.vandps(tmp2.reg, regOp(inst.b), vectorAndMaskOp());
-        build.vsubps(inst.regX64, tmp1.reg, tmp2.reg);
-        build.vorps(inst.regX64, inst.regX64, vectorOrMaskOp());
+        RegisterX64 tmpa = vecOp(inst.a, tmp1);
+        RegisterX64 tmpb = inst.a == inst.b ? tmpa : vecOp(inst.b, tmp2);
+
+        build.vsubps(inst.regX64, tmpa, tmpb);
         break;
     }
     case IrCmd::MUL_VEC:
     {
         inst.regX64 = regs.allocRegOrReuse(SizeX64::xmmword, index, {inst.a, inst.b});
 
-        ScopedRegX64 tmp1{regs, SizeX64::xmmword};
-        ScopedRegX64 tmp2{regs, SizeX64::xmmword};
+        ScopedRegX64 tmp1{regs};
+        ScopedRegX64 tmp2{regs};
+
+        RegisterX64 tmpa = vecOp(inst.a, tmp1);
+        RegisterX64 tmpb = inst.a == inst.b ? tmpa : vecOp(inst.b, tmp2);
 
-        // Fourth component is the tag number which is interpreted as a denormal and has to be filtered out
-        build.vandps(tmp1.reg, regOp(inst.a), vectorAndMaskOp());
-        build.vandps(tmp2.reg, regOp(inst.b), vectorAndMaskOp());
-        build.vmulps(inst.regX64, tmp1.reg, tmp2.reg);
-        build.vorps(inst.regX64, inst.regX64, vectorOrMaskOp());
+        build.vmulps(inst.regX64, tmpa, tmpb);
         break;
     }
     case IrCmd::DIV_VEC:
     {
         inst.regX64 = regs.allocRegOrReuse(SizeX64::xmmword, index, {inst.a, inst.b});
 
-        ScopedRegX64 tmp1{regs, SizeX64::xmmword};
-        ScopedRegX64 tmp2{regs, SizeX64::xmmword};
+        ScopedRegX64 tmp1{regs};
+        ScopedRegX64 tmp2{regs};
+
+        RegisterX64 tmpa = vecOp(inst.a, tmp1);
+        RegisterX64 tmpb = inst.a == inst.b ? tmpa : vecOp(inst.b, tmp2);
 
-        // Fourth component is the tag number which is interpreted as a denormal and has to be filtered out
-        build.vandps(tmp1.reg, regOp(inst.a), vectorAndMaskOp());
-        build.vandps(tmp2.reg, regOp(inst.b), vectorAndMaskOp());
-        build.vdivps(inst.regX64, tmp1.reg, tmp2.reg);
-        build.vpinsrd(inst.regX64, inst.regX64, build.i32(LUA_TVECTOR), 3);
+        build.vdivps(inst.regX64, tmpa, tmpb);
         break;
     }
     case IrCmd::UNM_VEC:
     {
         inst.regX64 = regs.allocRegOrReuse(SizeX64::xmmword, index, {inst.a});
 
-        RegisterX64 src = regOp(inst.a);
+        ScopedRegX64 tmp{regs};
+        RegisterX64 src = vecOp(inst.a, tmp);
 
-        if (inst.regX64 == src)
-        {
-            build.vxorpd(inst.regX64, inst.regX64, build.f32x4(-0.0, -0.0, -0.0, -0.0));
-        }
-        else
-        {
-            build.vmovsd(inst.regX64, src, src);
-            build.vxorpd(inst.regX64, inst.regX64, build.f32x4(-0.0, -0.0, -0.0, -0.0));
-        }
-
-        build.vpinsrd(inst.regX64, inst.regX64, build.i32(LUA_TVECTOR), 3);
+        build.vxorpd(inst.regX64, src, build.f32x4(-0.0, -0.0, -0.0, -0.0));
         break;
     }
     case IrCmd::NOT_ANY:
@@ -872,6 +876,18 @@ void IrLoweringX64::lowerInst(IrInst& inst, uint32_t index, const IrBlock& next)
         build.mov(inst.regX64, dword[ptr + offsetof(TString, len)]);
         break;
     }
+    case IrCmd::STRING_READU8:
+    {
+        inst.regX64 = regs.allocRegOrReuse(SizeX64::dword, index, {inst.a, inst.b});
+
+        if (inst.b.kind == IrOpKind::Inst)
+            build.movzx(inst.regX64, byte[regOp(inst.a) + qwordReg(regOp(inst.b)) + offsetof(TString, data)]);
+        else if (inst.b.kind == IrOpKind::Constant)
+            build.movzx(inst.regX64, byte[regOp(inst.a) + intOp(inst.b) + offsetof(TString, data)]);
+        else
+            CODEGEN_ASSERT(!"Unsupported instruction form");
+        break;
+    }
     case IrCmd::NEW_TABLE:
     {
         IrCallWrapperX64 callWrap(regs, build, index);
@@ -974,15 +990,19 @@ void IrLoweringX64::lowerInst(IrInst& inst, uint32_t index, const IrBlock& next)
             static_assert(sizeof(asU32) == sizeof(value), "Expecting float to be 32-bit");
             memcpy(&asU32, &value, sizeof(value));
 
-            build.vmovaps(inst.regX64, build.u32x4(asU32, asU32, asU32, LUA_TVECTOR));
+            build.vmovaps(inst.regX64, build.u32x4(asU32, asU32, asU32, 0));
         }
         else
         {
             build.vcvtsd2ss(inst.regX64, inst.regX64, memRegDoubleOp(inst.a));
             build.vpshufps(inst.regX64, inst.regX64, inst.regX64, 0b00'00'00'00);
-            build.vpinsrd(inst.regX64, inst.regX64, build.i32(LUA_TVECTOR), 3);
         }
         break;
+    case IrCmd::TAG_VECTOR:
+        inst.regX64 = regs.allocRegOrReuse(SizeX64::xmmword, index, {inst.a});
+
+        build.vpinsrd(inst.regX64, regOp(inst.a), build.i32(LUA_TVECTOR), 3);
+        break;
     case IrCmd::ADJUST_STACK_TO_REG:
     {
         ScopedRegX64 tmp{regs, SizeX64::qword};
@@ -1307,6 +1327,19 @@ void IrLoweringX64::lowerInst(IrInst& inst, uint32_t index, const IrBlock& next)
         jumpOrAbortOnUndef(ConditionX64::Equal, inst.b, next);
         break;
     }
+    case IrCmd::CHECK_STRING_LEN:
+    {
+        // fails if offset >= len; negative offsets fail as well since the comparison is unsigned
+        if (inst.b.kind == IrOpKind::Inst)
+            build.cmp(dword[regOp(inst.a) + offsetof(TString, len)], regOp(inst.b));
+        else if (inst.b.kind == IrOpKind::Constant)
+            build.cmp(dword[regOp(inst.a) + offsetof(TString, len)], intOp(inst.b));
+        else
+            CODEGEN_ASSERT(!"Unsupported instruction form");
+
+        jumpOrAbortOnUndef(ConditionX64::BelowEqual, inst.c, next);
+        break;
+    }
     case IrCmd::CHECK_BUFFER_LEN:
     {
         int accessSize = intOp(inst.c);
@@ -1387,6 +1420,16 @@ void IrLoweringX64::lowerInst(IrInst& inst, uint32_t index, const IrBlock& next)
         interruptHandlers.push_back({self, pcpos, next});
         break;
     }
+    case IrCmd::INCREMENT_COUNTER:
+    {
+        ScopedRegX64 tmp{regs, SizeX64::qword};
+
+        build.mov(tmp.reg, sClosure);
+        build.mov(tmp.reg, qword[tmp.reg + offsetof(Closure, l.p)]);
+        build.mov(tmp.reg, qword[tmp.reg + offsetof(Proto, execdata)]);
+        build.add(qword[tmp.reg + int(getExecDataCounterOffset(function.proto->sizecode) + uintOp(inst.a) * sizeof(uint64_t))], 1);
+        break;
+    }
     case IrCmd::CHECK_GC:
         callStepGc(regs, build);
         break;
@@ -1471,7 +1514,7 @@ void IrLoweringX64::lowerInst(IrInst& inst, uint32_t index, const IrBlock& next)
     case IrCmd::CALL:
         regs.assertAllFree();
         regs.assertNoSpills();
-        emitInstCall(build, helpers, vmRegOp(inst.a), intOp(inst.b), intOp(inst.c));
+        emitInstCall(build, helpers, vmRegOp(inst.a), intOp(inst.b), intOp(inst.c), inst.d.kind != IrOpKind::None && intOp(inst.d) != 0);
         break;
     case IrCmd::RETURN:
         regs.assertAllFree();
@@ -1510,6 +1553,16 @@ void IrLoweringX64::lowerInst(IrInst& inst, uint32_t index, const IrBlock& next)
     }
     case IrCmd::COVERAGE:
     {
+        if (intOp(inst.b) == 1)
+        {
+            ScopedRegX64 tmp{regs, SizeX64::qword};
+
+            // *pc = NOP with E=1, same as the interpreter does on the first hit
+            build.mov(tmp.reg, sCode);
+            build.mov(dword[tmp.reg + uintOp(inst.a) * sizeof(Instruction)], LOP_NOP | (1 << 8));
+            break;
+        }
+
         ScopedRegX64 tmp1{regs, SizeX64::qword};
         ScopedRegX64 tmp2{regs, SizeX64::dword};
         ScopedRegX64 tmp3{regs, SizeX64::dword};
@@ -1867,6 +1920,9 @@ void IrLoweringX64::lowerInst(IrInst& inst, uint32_t index, const IrBlock& next)
                 callWrap.addArgument(SizeX64::xmmword, memRegDoubleOp(inst.c), inst.c);
         }
 
+        if (inst.d.kind != IrOpKind::None)
+            callWrap.addArgument(SizeX64::xmmword, memRegDoubleOp(inst.d), inst.d);
+
         callWrap.call(qword[rNativeContext + getNativeContextOffset(uintOp(inst.a))]);
         inst.regX64 = regs.takeReg(xmm0, index);
         break;
@@ -2259,12 +2315,29 @@ OperandX64 IrLoweringX64::vectorAndMaskOp()
     return vectorAndMask;
 }
 
-OperandX64 IrLoweringX64::vectorOrMaskOp()
+RegisterX64 IrLoweringX64::vecOp(IrOp op, ScopedRegX64& tmp)
 {
-    if (vectorOrMask.base == noreg)
-        vectorOrMask = build.u32x4(0, 0, 0, LUA_TVECTOR);
+    IrInst& source = function.instOp(op);
+
+    // Results of vector math operations do not have a tag and can be used as is
+    // Other vectors (loaded from memory or tagged for a store) have the tag number in the fourth component
+    // It is interpreted as a denormal which makes arithmetic slow on some CPUs, so that component is masked out
+    switch (source.cmd)
+    {
+    case IrCmd::ADD_VEC:
+    case IrCmd::SUB_VEC:
+    case IrCmd::MUL_VEC:
+    case IrCmd::DIV_VEC:
+    case IrCmd::UNM_VEC:
+    case IrCmd::NUM_TO_VECTOR:
+        return regOp(op);
+    default:
+        break;
+    }
 
-    return vectorOrMask;
+    tmp.alloc(SizeX64::xmmword);
+    build.vandps(tmp.reg, regOp(op), vectorAndMaskOp());
+    return tmp.reg;
 }
 
 } // namespace X64
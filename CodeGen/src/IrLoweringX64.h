@@ -61,8 +61,9 @@ struct IrLoweringX64
     IrBlock& blockOp(IrOp op) const;
     Label& labelOp(IrOp op) const;
 
+    RegisterX64 vecOp(IrOp op, ScopedRegX64& tmp);
+
     OperandX64 vectorAndMaskOp();
-    OperandX64 vectorOrMaskOp();
 
     struct InterruptHandler
     {
@@ -92,7 +93,6 @@ struct IrLoweringX64
     DenseHashMap<uint32_t, uint32_t> exitHandlerMap;
 
     OperandX64 vectorAndMask = noreg;
-    OperandX64 vectorOrMask = noreg;
 };
 
 } // namespace X64
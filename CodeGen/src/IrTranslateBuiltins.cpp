@@ -251,6 +251,37 @@ static BuiltinImplResult translateBuiltinMathClamp(IrBuilder& build, int nparams
     return {BuiltinImplType::UsesFallback, 1};
 }
 
+static BuiltinImplResult translateBuiltinMathNoise(IrBuilder& build, int nparams, int ra, int arg, IrOp args, int nresults, int pcpos)
+{
+    if (nparams < 1 || nresults > 1)
+        return {BuiltinImplType::None, -1};
+
+    // nil coordinates are handled by the VM
+    builtinCheckDouble(build, build.vmReg(arg), pcpos);
+
+    if (nparams >= 2)
+        builtinCheckDouble(build, args, pcpos);
+
+    if (nparams >= 3)
+    {
+        CODEGEN_ASSERT(args.kind == IrOpKind::VmReg);
+        builtinCheckDouble(build, build.vmReg(vmRegOp(args) + 1), pcpos);
+    }
+
+    IrOp vx = builtinLoadDouble(build, build.vmReg(arg));
+    IrOp vy = nparams >= 2 ? builtinLoadDouble(build, args) : build.constDouble(0.0);
+    IrOp vz = nparams >= 3 ? builtinLoadDouble(build, build.vmReg(vmRegOp(args) + 1)) : build.constDouble(0.0);
+
+    IrOp res = build.inst(IrCmd::INVOKE_LIBM, build.constUint(LBF_MATH_NOISE), vx, vy, vz);
+
+    build.inst(IrCmd::STORE_DOUBLE, build.vmReg(ra), res);
+
+    if (ra != arg)
+        build.inst(IrCmd::STORE_TAG, build.vmReg(ra), build.constTag(LUA_TNUMBER));
+
+    return {BuiltinImplType::Full, 1};
+}
+
 static BuiltinImplResult translateBuiltinMathUnary(IrBuilder& build, IrCmd cmd, int nparams, int ra, int arg, int nresults, int pcpos)
 {
     if (nparams < 1 || nresults > 1)
@@ -728,6 +759,37 @@ static BuiltinImplResult translateBuiltinStringLen(IrBuilder& build, int nparams
     return {BuiltinImplType::Full, 1};
 }
 
+static BuiltinImplResult translateBuiltinStringByte(IrBuilder& build, int nparams, int ra, int arg, IrOp args, int nresults, int pcpos)
+{
+    // Only the single byte form is handled, a range of bytes produces a variable number of results
+    if (nparams < 1 || nparams > 2 || nresults > 1)
+        return {BuiltinImplType::None, -1};
+
+    build.loadAndCheckTag(build.vmReg(arg), LUA_TSTRING, build.vmExit(pcpos));
+
+    IrOp offset = build.constInt(0);
+
+    if (nparams == 2)
+    {
+        builtinCheckDouble(build, args, pcpos);
+
+        IrOp index = build.inst(IrCmd::NUM_TO_INT, builtinLoadDouble(build, args));
+        offset = build.inst(IrCmd::SUB_INT, index, build.constInt(1));
+    }
+
+    IrOp ts = build.inst(IrCmd::LOAD_POINTER, build.vmReg(arg));
+
+    // Negative and out of range positions are handled by the VM
+    build.inst(IrCmd::CHECK_STRING_LEN, ts, offset, build.vmExit(pcpos));
+
+    IrOp value = build.inst(IrCmd::STRING_READU8, ts, offset);
+
+    build.inst(IrCmd::STORE_DOUBLE, build.vmReg(ra), build.inst(IrCmd::INT_TO_NUM, value));
+    build.inst(IrCmd::STORE_TAG, build.vmReg(ra), build.constTag(LUA_TNUMBER));
+
+    return {BuiltinImplType::Full, 1};
+}
+
 static void translateBufferArgsAndCheckBounds(IrBuilder& build, int nparams, int arg, IrOp args, int size, int pcpos, IrOp& buf, IrOp& intIndex)
 {
     build.loadAndCheckTag(build.vmReg(arg), LUA_TBUFFER, build.vmExit(pcpos));
@@ -807,6 +869,8 @@ BuiltinImplResult translateBuiltin(IrBuilder& build, int bfid, int ra, int arg,
         return translateBuiltinMathUnary(build, IrCmd::ABS_NUM, nparams, ra, arg, nresults, pcpos);
     case LBF_MATH_ROUND:
         return translateBuiltinMathUnary(build, IrCmd::ROUND_NUM, nparams, ra, arg, nresults, pcpos);
+    case LBF_MATH_NOISE:
+        return translateBuiltinMathNoise(build, nparams, ra, arg, args, nresults, pcpos);
     case LBF_MATH_EXP:
     case LBF_MATH_ASIN:
     case LBF_MATH_SIN:
@@ -869,6 +933,8 @@ BuiltinImplResult translateBuiltin(IrBuilder& build, int bfid, int ra, int arg,
         return translateBuiltinTableInsert(build, nparams, ra, arg, args, nresults, pcpos);
     case LBF_STRING_LEN:
         return translateBuiltinStringLen(build, nparams, ra, arg, args, nresults, pcpos);
+    case LBF_STRING_BYTE:
+        return translateBuiltinStringByte(build, nparams, ra, arg, args, nresults, pcpos);
     case LBF_BIT32_BYTESWAP:
         return translateBuiltinBit32Unary(build, IrCmd::BYTESWAP_UINT, nparams, ra, arg, args, nresults, pcpos);
     case LBF_BUFFER_READI8:
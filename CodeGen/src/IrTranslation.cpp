@@ -10,6 +10,7 @@
 
 #include "lobject.h"
 #include "lstate.h"
+#include "ltable.h"
 #include "ltm.h"
 
 LUAU_FASTFLAGVARIABLE(LuauCodegenLuData, false)
@@ -139,6 +140,20 @@ void translateInstMove(IrBuilder& build, const Instruction* pc)
     build.inst(IrCmd::STORE_TVALUE, build.vmReg(ra), load);
 }
 
+void translateInstMove2(IrBuilder& build, const Instruction* pc)
+{
+    int ra = LUAU_INSN_A(*pc);
+    int rb = LUAU_INSN_B(*pc);
+    int rc = pc[1] & 0xff;
+    int rd = (pc[1] >> 8) & 0xff;
+
+    IrOp load1 = build.inst(IrCmd::LOAD_TVALUE, build.vmReg(rb));
+    build.inst(IrCmd::STORE_TVALUE, build.vmReg(ra), load1);
+
+    IrOp load2 = build.inst(IrCmd::LOAD_TVALUE, build.vmReg(rd));
+    build.inst(IrCmd::STORE_TVALUE, build.vmReg(rc), load2);
+}
+
 void translateInstJump(IrBuilder& build, const Instruction* pc, int pcpos)
 {
     build.inst(IrCmd::JUMP, build.blockAtInst(pcpos + 1 + LUAU_INSN_D(*pc)));
@@ -383,7 +398,7 @@ static void translateInstBinaryNumeric(IrBuilder& build, int ra, int rb, int rc,
                 break;
             }
 
-            build.inst(IrCmd::STORE_TVALUE, build.vmReg(ra), result);
+            build.inst(IrCmd::STORE_TVALUE, build.vmReg(ra), build.inst(IrCmd::TAG_VECTOR, result));
             return;
         }
         else if (bcTypes.a == LBC_TYPE_NUMBER && bcTypes.b == LBC_TYPE_VECTOR && (tm == TM_MUL || tm == TM_DIV))
@@ -409,7 +424,7 @@ static void translateInstBinaryNumeric(IrBuilder& build, int ra, int rb, int rc,
                 break;
             }
 
-            build.inst(IrCmd::STORE_TVALUE, build.vmReg(ra), result);
+            build.inst(IrCmd::STORE_TVALUE, build.vmReg(ra), build.inst(IrCmd::TAG_VECTOR, result));
             return;
         }
         else if (bcTypes.a == LBC_TYPE_VECTOR && bcTypes.b == LBC_TYPE_NUMBER && (tm == TM_MUL || tm == TM_DIV))
@@ -435,7 +450,7 @@ static void translateInstBinaryNumeric(IrBuilder& build, int ra, int rb, int rc,
                 break;
             }
 
-            build.inst(IrCmd::STORE_TVALUE, build.vmReg(ra), result);
+            build.inst(IrCmd::STORE_TVALUE, build.vmReg(ra), build.inst(IrCmd::TAG_VECTOR, result));
             return;
         }
     }
@@ -596,7 +611,7 @@ void translateInstMinus(IrBuilder& build, const Instruction* pc, int pcpos)
 
         IrOp vb = build.inst(IrCmd::LOAD_TVALUE, build.vmReg(rb));
         IrOp va = build.inst(IrCmd::UNM_VEC, vb);
-        build.inst(IrCmd::STORE_TVALUE, build.vmReg(ra), va);
+        build.inst(IrCmd::STORE_TVALUE, build.vmReg(ra), build.inst(IrCmd::TAG_VECTOR, va));
         return;
     }
 
@@ -662,14 +677,23 @@ void translateInstNewTable(IrBuilder& build, const Instruction* pc, int pcpos)
     int ra = LUAU_INSN_A(*pc);
     int b = LUAU_INSN_B(*pc);
     uint32_t aux = pc[1];
+    uint32_t nhash = b == 0 ? 0 : 1 << (b - 1);
+
+    // sizes recorded by the interpreter with lua_settablefeedback take precedence when they are larger
+    if (const TableSite* site = build.function.proto ? luaH_gettablesite(build.function.proto, pcpos) : nullptr)
+    {
+        aux = uint32_t(site->sizearray) > aux ? uint32_t(site->sizearray) : aux;
+        nhash = uint32_t(site->sizenode) > nhash ? uint32_t(site->sizenode) : nhash;
+    }
 
     build.inst(IrCmd::SET_SAVEDPC, build.constUint(pcpos + 1));
 
-    IrOp va = build.inst(IrCmd::NEW_TABLE, build.constUint(aux), build.constUint(b == 0 ? 0 : 1 << (b - 1)));
+    // GC step is performed before the allocation so that the new table stays white while the following instructions fill it in
+    build.inst(IrCmd::CHECK_GC);
+
+    IrOp va = build.inst(IrCmd::NEW_TABLE, build.constUint(aux), build.constUint(nhash));
     build.inst(IrCmd::STORE_POINTER, build.vmReg(ra), va);
     build.inst(IrCmd::STORE_TAG, build.vmReg(ra), build.constTag(LUA_TTABLE));
-
-    build.inst(IrCmd::CHECK_GC);
 }
 
 void translateInstDupTable(IrBuilder& build, const Instruction* pc, int pcpos)
@@ -679,12 +703,13 @@ void translateInstDupTable(IrBuilder& build, const Instruction* pc, int pcpos)
 
     build.inst(IrCmd::SET_SAVEDPC, build.constUint(pcpos + 1));
 
+    // see translateInstNewTable
+    build.inst(IrCmd::CHECK_GC);
+
     IrOp table = build.inst(IrCmd::LOAD_POINTER, build.vmConst(k));
     IrOp va = build.inst(IrCmd::DUP_TABLE, table);
     build.inst(IrCmd::STORE_POINTER, build.vmReg(ra), va);
     build.inst(IrCmd::STORE_TAG, build.vmReg(ra), build.constTag(LUA_TTABLE));
-
-    build.inst(IrCmd::CHECK_GC);
 }
 
 void translateInstGetUpval(IrBuilder& build, const Instruction* pc, int pcpos)
@@ -692,6 +717,15 @@ void translateInstGetUpval(IrBuilder& build, const Instruction* pc, int pcpos)
     int ra = LUAU_INSN_A(*pc);
     int up = LUAU_INSN_B(*pc);
 
+    // When upvalues are captured by value, closure holds the value itself and there is no UpVal object to follow
+    if (build.function.proto && (build.function.proto->flags & LPF_UPVALS_BY_VALUE) != 0)
+    {
+        IrOp src = build.inst(IrCmd::GET_CLOSURE_UPVAL_ADDR, build.undef(), build.vmUpvalue(up));
+        IrOp load = build.inst(IrCmd::LOAD_TVALUE, src);
+        build.inst(IrCmd::STORE_TVALUE, build.vmReg(ra), load);
+        return;
+    }
+
     build.inst(IrCmd::GET_UPVALUE, build.vmReg(ra), build.vmUpvalue(up));
 }
 
@@ -23,6 +23,7 @@ void translateInstLoadN(IrBuilder& build, const Instruction* pc);
 void translateInstLoadK(IrBuilder& build, const Instruction* pc);
 void translateInstLoadKX(IrBuilder& build, const Instruction* pc);
 void translateInstMove(IrBuilder& build, const Instruction* pc);
+void translateInstMove2(IrBuilder& build, const Instruction* pc);
 void translateInstJump(IrBuilder& build, const Instruction* pc, int pcpos);
 void translateInstJumpBack(IrBuilder& build, const Instruction* pc, int pcpos);
 void translateInstJumpIf(IrBuilder& build, const Instruction* pc, int pcpos, bool not_);
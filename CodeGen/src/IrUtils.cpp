@@ -2,6 +2,7 @@
 #include "Luau/IrUtils.h"
 
 #include "Luau/IrBuilder.h"
+#include "Luau/IrVisitUseDef.h"
 
 #include "BitUtils.h"
 #include "NativeState.h"
@@ -92,6 +93,7 @@ IrValueKind getCmdValueKind(IrCmd cmd)
     case IrCmd::TABLE_SETNUM:
         return IrValueKind::Pointer;
     case IrCmd::STRING_LEN:
+    case IrCmd::STRING_READU8:
         return IrValueKind::Int;
     case IrCmd::NEW_TABLE:
     case IrCmd::DUP_TABLE:
@@ -107,6 +109,7 @@ IrValueKind getCmdValueKind(IrCmd cmd)
     case IrCmd::NUM_TO_UINT:
         return IrValueKind::Int;
     case IrCmd::NUM_TO_VECTOR:
+    case IrCmd::TAG_VECTOR:
         return IrValueKind::Tvalue;
     case IrCmd::ADJUST_STACK_TO_REG:
     case IrCmd::ADJUST_STACK_TO_TOP:
@@ -134,7 +137,9 @@ IrValueKind getCmdValueKind(IrCmd cmd)
     case IrCmd::CHECK_NODE_NO_NEXT:
     case IrCmd::CHECK_NODE_VALUE:
     case IrCmd::CHECK_BUFFER_LEN:
+    case IrCmd::CHECK_STRING_LEN:
     case IrCmd::INTERRUPT:
+    case IrCmd::INCREMENT_COUNTER:
     case IrCmd::CHECK_GC:
     case IrCmd::BARRIER_OBJ:
     case IrCmd::BARRIER_TABLE_BACK:
@@ -832,6 +837,42 @@ void foldConstants(IrBuilder& build, IrFunction& function, IrBlock& block, uint3
     }
 }
 
+// Checks if the register is written to by the visited instructions
+struct VmRegDefCheck : VmRegDefVisitor<VmRegDefCheck>
+{
+    int reg = -1;
+    bool found = false;
+
+    void defReg(int r)
+    {
+        found |= r == reg;
+    }
+};
+
+int getCheckedVmReg(IrFunction& function, const IrBlock& block, uint32_t index)
+{
+    const IrInst& inst = function.instructions[index];
+
+    if (inst.a.kind == IrOpKind::VmReg)
+        return vmRegOp(inst.a);
+
+    if (inst.a.kind != IrOpKind::Inst || inst.a.index < block.start || inst.a.index >= index)
+        return -1;
+
+    const IrInst& source = function.instOp(inst.a);
+
+    if (source.cmd != IrCmd::LOAD_TAG || source.a.kind != IrOpKind::VmReg)
+        return -1;
+
+    VmRegDefCheck check;
+    check.reg = vmRegOp(source.a);
+
+    for (uint32_t i = inst.a.index + 1; i < index && !check.found; i++)
+        visitVmRegDefsUses(check, function, function.instructions[i]);
+
+    return check.found ? -1 : check.reg;
+}
+
 uint32_t getNativeContextOffset(int bfid)
 {
     switch (bfid)
@@ -870,6 +911,8 @@ uint32_t getNativeContextOffset(int bfid)
         return offsetof(NativeContext, libm_log2);
     case LBF_MATH_LDEXP:
         return offsetof(NativeContext, libm_ldexp);
+    case LBF_MATH_NOISE:
+        return offsetof(NativeContext, libm_noise);
     default:
         CODEGEN_ASSERT(!"Unsupported bfid");
     }
@@ -889,6 +932,126 @@ void killUnusedBlocks(IrFunction& function)
     }
 }
 
+// Returns the target of a block terminator that lowering can reach by falling through
+static IrOp getFallthroughTarget(const IrInst& termInst)
+{
+    for (IrOp op : {termInst.f, termInst.e, termInst.d, termInst.c, termInst.b, termInst.a})
+    {
+        if (op.kind == IrOpKind::Block)
+            return op;
+    }
+
+    return {};
+}
+
+static bool isReferencedByBlock(IrFunction& function, const IrBlock& block, uint32_t targetIdx)
+{
+    for (uint32_t index = block.start; index <= block.finish; index++)
+    {
+        const IrInst& inst = function.instructions[index];
+
+        for (IrOp op : {inst.a, inst.b, inst.c, inst.d, inst.e, inst.f})
+        {
+            if (op.kind == IrOpKind::Block && op.index == targetIdx)
+                return true;
+        }
+    }
+
+    return false;
+}
+
+// Moves blocks that have a single predecessor right after it when that predecessor can fall through into them
+// This removes a jump from the hot path and places related code together
+static void straightenBlockOrder(IrFunction& function, std::vector<uint32_t>& sortedBlocks)
+{
+    const uint32_t kNone = ~0u;
+
+    // Blocks are linked in a list to make each move constant time
+    std::vector<uint32_t> prev(function.blocks.size(), kNone);
+    std::vector<uint32_t> next(function.blocks.size(), kNone);
+    std::vector<uint8_t> visited(function.blocks.size(), false);
+
+    uint32_t first = kNone;
+    uint32_t last = kNone;
+
+    for (uint32_t blockIdx : sortedBlocks)
+    {
+        if (function.blocks[blockIdx].kind == IrBlockKind::Dead)
+            continue;
+
+        if (first == kNone)
+            first = blockIdx;
+
+        prev[blockIdx] = last;
+
+        if (last != kNone)
+            next[last] = blockIdx;
+
+        last = blockIdx;
+    }
+
+    for (uint32_t curr = first; curr != kNone; curr = next[curr])
+    {
+        visited[curr] = true;
+
+        IrBlock& block = function.blocks[curr];
+
+        // Fallback blocks are kept outlined and chains created by optimizations have a fixed order
+        if (block.kind == IrBlockKind::Fallback || block.expectedNextBlock != kNone)
+            continue;
+
+        IrOp targetOp = getFallthroughTarget(function.instructions[block.finish]);
+
+        if (targetOp.kind != IrOpKind::Block || targetOp.index == next[curr])
+            continue;
+
+        uint32_t targetIdx = targetOp.index;
+        IrBlock& target = function.blocks[targetIdx];
+
+        // Target can only be moved forward, so that instructions it depends on are still lowered before it
+        if (visited[targetIdx] || target.kind == IrBlockKind::Fallback || target.useCount != 1 || target.expectedNextBlock != kNone)
+            continue;
+
+        // When the next block has a single predecessor, register spills might be carried over to it and the blocks can't be separated
+        uint32_t currNext = next[curr];
+        uint32_t targetNext = next[targetIdx];
+
+        if (currNext != kNone && function.blocks[currNext].useCount == 1 && isReferencedByBlock(function, block, currNext))
+            continue;
+
+        if (targetNext != kNone && function.blocks[targetNext].useCount == 1 && isReferencedByBlock(function, target, targetNext))
+            continue;
+
+        // Unlink the target from its current location and insert it after the current block
+        next[prev[targetIdx]] = targetNext;
+
+        if (targetNext != kNone)
+            prev[targetNext] = prev[targetIdx];
+
+        prev[targetIdx] = curr;
+        next[targetIdx] = currNext;
+
+        if (currNext != kNone)
+            prev[currNext] = targetIdx;
+
+        next[curr] = targetIdx;
+    }
+
+    size_t pos = 0;
+
+    for (uint32_t curr = first; curr != kNone; curr = next[curr])
+        sortedBlocks[pos++] = curr;
+
+    // Dead blocks are placed at the end
+    for (uint32_t i = 0; i < function.blocks.size(); i++)
+    {
+        if (function.blocks[i].kind == IrBlockKind::Dead)
+            sortedBlocks[pos++] = i;
+    }
+
+    CODEGEN_ASSERT(pos == sortedBlocks.size());
+}
+
 std::vector<uint32_t> getSortedBlockOrder(IrFunction& function)
 {
     std::vector<uint32_t> sortedBlocks;
@@ -912,6 +1075,8 @@ std::vector<uint32_t> getSortedBlockOrder(IrFunction& function)
         return a.chainkey < b.chainkey;
     });
 
+    straightenBlockOrder(function, sortedBlocks);
+
     return sortedBlocks;
 }
 
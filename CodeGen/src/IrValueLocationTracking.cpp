@@ -102,6 +102,7 @@ void IrValueLocationTracking::beforeInstLowering(IrInst& inst)
     case IrCmd::SET_TABLE:
     case IrCmd::SET_UPVALUE:
     case IrCmd::INTERRUPT:
+    case IrCmd::INCREMENT_COUNTER:
     case IrCmd::BARRIER_OBJ:
     case IrCmd::BARRIER_TABLE_FORWARD:
     case IrCmd::CLOSE_UPVALS:
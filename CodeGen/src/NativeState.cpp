@@ -62,7 +62,7 @@ void initFunctions(NativeState& data)
 
     data.context.luaF_close = luaF_close;
     data.context.luaF_findupval = luaF_findupval;
-    data.context.luaF_newLclosure = luaF_newLclosure;
+    data.context.luaF_newLclosure = newLclosure;
 
     data.context.luaT_gettm = luaT_gettm;
     data.context.luaT_objtypenamestr = luaT_objtypenamestr;
@@ -77,6 +77,7 @@ void initFunctions(NativeState& data)
     data.context.libm_round = round;
     data.context.libm_frexp = frexp;
     data.context.libm_modf = modf;
+    data.context.libm_noise = mathNoise;
 
     data.context.libm_asin = asin;
     data.context.libm_sin = sin;
@@ -89,14 +90,14 @@ void initFunctions(NativeState& data)
     data.context.libm_tan = tan;
     data.context.libm_tanh = tanh;
 
-    data.context.forgLoopTableIter = forgLoopTableIter;
-    data.context.forgLoopNodeIter = forgLoopNodeIter;
     data.context.forgLoopNonTableFallback = forgLoopNonTableFallback;
     data.context.forgPrepXnextFallback = forgPrepXnextFallback;
     data.context.callProlog = callProlog;
+    data.context.callTailProlog = callTailProlog;
     data.context.callEpilogC = callEpilogC;
 
     data.context.callFallback = callFallback;
+    data.context.callTailFallback = callTailFallback;
 
     data.context.executeGETGLOBAL = executeGETGLOBAL;
     data.context.executeSETGLOBAL = executeSETGLOBAL;
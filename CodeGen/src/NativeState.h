@@ -5,7 +5,11 @@
 #include "Luau/CodeAllocator.h"
 #include "Luau/Label.h"
 
+#include <list>
 #include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include <stdint.h>
 
@@ -22,6 +26,7 @@ namespace CodeGen
 {
 
 class UnwindBuilder;
+struct AsyncCompilation;
 
 struct NativeContext
 {
@@ -78,16 +83,17 @@ struct NativeContext
     double (*libm_round)(double) = nullptr;
     double (*libm_frexp)(double, int*) = nullptr;
     double (*libm_modf)(double, double*) = nullptr;
+    double (*libm_noise)(double, double, double) = nullptr; // math.noise kernel, called the same way as libm functions
 
     // Helper functions
-    bool (*forgLoopTableIter)(lua_State* L, Table* h, int index, TValue* ra) = nullptr;
-    bool (*forgLoopNodeIter)(lua_State* L, Table* h, int index, TValue* ra) = nullptr;
     bool (*forgLoopNonTableFallback)(lua_State* L, int insnA, int aux) = nullptr;
     void (*forgPrepXnextFallback)(lua_State* L, TValue* ra, int pc) = nullptr;
     Closure* (*callProlog)(lua_State* L, TValue* ra, StkId argtop, int nresults) = nullptr;
+    Closure* (*callTailProlog)(lua_State* L, TValue* ra, StkId argtop, int nresults) = nullptr;
     void (*callEpilogC)(lua_State* L, int nresults, int n) = nullptr;
 
     Closure* (*callFallback)(lua_State* L, StkId ra, StkId argtop, int nresults) = nullptr;
+    Closure* (*callTailFallback)(lua_State* L, StkId ra, StkId argtop, int nresults) = nullptr;
 
     // Opcode fallbacks, implemented in C
     const Instruction* (*executeGETGLOBAL)(lua_State* L, const Instruction* pc, StkId base, TValue* k) = nullptr;
@@ -108,6 +114,35 @@ struct NativeContext
 
 using GateFn = int (*)(lua_State*, Proto*, uintptr_t, NativeContext*);
 
+// Execution counters of functions compiled with CodeGen_Profile are placed in execdata after the instruction offsets
+inline size_t getExecDataCounterOffset(int sizecode)
+{
+    // Counters are 64-bit
+    return size_t((sizecode + 1) & ~1) * sizeof(uint32_t);
+}
+
+// Executable memory that holds the code of a compiled module, shared by all of its functions
+struct NativeAllocation
+{
+    uint8_t* data = nullptr;
+
+    // Functions that use the code; destroyed and evicted functions are replaced with null
+    std::vector<Proto*> protos;
+    size_t liveProtos = 0;
+};
+
+struct NativeProtoAllocation
+{
+    std::list<NativeAllocation>::iterator allocation;
+    size_t index = 0;
+};
+
+struct SpeculativeProto
+{
+    uint32_t misses = 0;
+    unsigned int flags = 0;
+};
+
 struct NativeState
 {
     NativeState();
@@ -121,6 +156,29 @@ struct NativeState
     size_t gateDataSize = 0;
 
     NativeContext context;
+
+    // Compilations started by compileAsync that haven't been installed yet
+    std::vector<std::shared_ptr<AsyncCompilation>> asyncCompilations;
+
+    // Argument types observed when functions profiled by CodeGen_Tiered are called, one LBC_TYPE_* entry per parameter
+    std::unordered_map<Proto*, std::vector<uint8_t>> argumentTypes;
+
+    // Functions compiled by CodeGen_Tiered with code specialized for observed argument types, with the number of calls that failed the
+    // entry guard and the flags to recompile them with
+    std::unordered_map<Proto*, SpeculativeProto> speculativeProtos;
+
+    // Functions profiled by CodeGen_Tiered that will be compiled with CodeGen_Profile once they become hot
+    std::unordered_set<Proto*> tieredProfiling;
+
+    // Bytecode positions of execution counters of functions compiled with CodeGen_Profile
+    std::unordered_map<Proto*, std::vector<uint32_t>> counterPcs;
+
+    // Native entry points of functions switched to bytecode because of breakpoints, restored when the breakpoints are removed
+    std::unordered_map<Proto*, uintptr_t> disabledExecTargets;
+
+    // Allocations of installed modules from the oldest to the newest; oldest ones are evicted first when executable memory runs out
+    std::list<NativeAllocation> allocations;
+    std::unordered_map<Proto*, NativeProtoAllocation> protoAllocations;
 };
 
 void initFunctions(NativeState& data);
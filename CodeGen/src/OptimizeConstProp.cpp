@@ -7,9 +7,11 @@
 #include "Luau/IrUtils.h"
 
 #include "lua.h"
+#include "lobject.h"
 
 #include <limits.h>
 
+#include <algorithm>
 #include <array>
 #include <utility>
 #include <vector>
@@ -182,6 +184,7 @@ struct ConstPropState
     {
         valueMap.clear();
         tryNumToIndexCache.clear();
+        slotLoadSplitStores.clear();
     }
 
     // If table memory has changed, we can't reuse previously computed and validated table slot lookups
@@ -190,6 +193,7 @@ struct ConstPropState
     {
         getSlotNodeCache.clear();
         checkSlotMatchCache.clear();
+        slotStoreCache.clear();
 
         getArrAddrCache.clear();
         checkArraySizeCache.clear();
@@ -237,6 +241,99 @@ struct ConstPropState
         reg.knownTableArraySize = -1;
     }
 
+    // Slot address was validated to have the specified key by an earlier check
+    bool isCheckedSlot(IrOp slot)
+    {
+        for (uint32_t prevIdx : checkSlotMatchCache)
+        {
+            if (function.instructions[prevIdx].a == slot)
+                return true;
+        }
+
+        return false;
+    }
+
+    // Nodes with different keys cannot overlap, which makes stores to them independent
+    bool isDistinctSlot(IrOp a, IrOp b)
+    {
+        if (a == b || !isCheckedSlot(a) || !isCheckedSlot(b))
+            return false;
+
+        IrOp keyA = function.instOp(a).c;
+        IrOp keyB = function.instOp(b).c;
+
+        if (keyA == keyB)
+            return false;
+
+        // Compiler doesn't emit duplicate constants, but we don't want to rely on that if constant values are available
+        if (function.proto)
+        {
+            TValue* ka = &function.proto->k[vmConstOp(keyA)];
+            TValue* kb = &function.proto->k[vmConstOp(keyB)];
+
+            return ttisstring(ka) && ttisstring(kb) && gcvalue(ka) != gcvalue(kb);
+        }
+
+        return true;
+    }
+
+    // Store into memory can overwrite values of any table slot that is not known to be a different node
+    void recordSlotStore(uint32_t storeIdx, IrOp address, IrOp offset)
+    {
+        bool isSlotValue = function.instOp(address).cmd == IrCmd::GET_SLOT_NODE_ADDR && isZeroOffset(offset) && isCheckedSlot(address);
+
+        for (size_t i = 0; i < slotStoreCache.size();)
+        {
+            if (isSlotValue && isDistinctSlot(function.instructions[slotStoreCache[i]].a, address))
+            {
+                i++;
+            }
+            else
+            {
+                slotStoreCache[i] = slotStoreCache.back();
+                slotStoreCache.pop_back();
+            }
+        }
+
+        if (isSlotValue && int(slotStoreCache.size()) < FInt::LuauCodeGenReuseSlotLimit)
+            slotStoreCache.push_back(storeIdx);
+    }
+
+    bool isZeroOffset(IrOp offset)
+    {
+        return offset.kind == IrOpKind::None || function.asIntOp(offset) == 0;
+    }
+
+    IrInst* tryGetSlotStore(IrOp slot)
+    {
+        for (uint32_t prevIdx : slotStoreCache)
+        {
+            IrInst& prev = function.instructions[prevIdx];
+
+            if (prev.a == slot)
+                return &prev;
+        }
+
+        return nullptr;
+    }
+
+    // Returns the tag of the value that was stored into the table slot
+    uint8_t tryGetSlotTag(IrOp slot)
+    {
+        if (IrInst* store = tryGetSlotStore(slot))
+        {
+            if (store->cmd == IrCmd::STORE_SPLIT_TVALUE)
+                return function.tagOp(store->b);
+
+            if (IrInst* arg = function.asInstOp(store->b); arg && arg->cmd == IrCmd::TAG_VECTOR)
+                return LUA_TVECTOR;
+
+            return tryGetTag(store->b);
+        }
+
+        return 0xff;
+    }
+
     void createRegLink(uint32_t instIdx, IrOp regOp)
     {
         CODEGEN_ASSERT(!instLink.contains(instIdx));
@@ -413,6 +510,7 @@ struct ConstPropState
         checkedGc = false;
 
         instLink.clear();
+        newTables.clear();
 
         invalidateValuePropagation();
         invalidateHeapTableData();
@@ -433,14 +531,21 @@ struct ConstPropState
 
     DenseHashMap<uint32_t, RegisterLink> instLink{~0u};
 
+    // Tables created after the last instruction that could run a GC step; they are still white and writes into them don't need barriers
+    std::vector<uint32_t> newTables;
+
     DenseHashMap<IrInst, uint32_t, IrInstHash, IrInstEq> valueMap;
 
+    // Loads from table slots that were stored as a separate tag and value
+    DenseHashMap<uint32_t, uint32_t> slotLoadSplitStores{~0u};
+
     // Some instruction re-uses can't be stored in valueMap because of extra requirements
     std::vector<uint32_t> tryNumToIndexCache; // Fallback block argument might be different
 
     // Heap changes might affect table state
     std::vector<uint32_t> getSlotNodeCache;    // Additionally, pcpos argument might be different
     std::vector<uint32_t> checkSlotMatchCache; // Additionally, fallback block argument might be different
+    std::vector<uint32_t> slotStoreCache;      // Stores of values into checked table slots
 
     std::vector<uint32_t> getArrAddrCache;
     std::vector<uint32_t> checkArraySizeCache; // Additionally, fallback block argument might be different
@@ -528,6 +633,9 @@ static void handleBuiltinEffects(ConstPropState& state, LuauBuiltinFunction bfid
     case LBF_BUFFER_WRITEF32:
     case LBF_BUFFER_READF64:
     case LBF_BUFFER_WRITEF64:
+    case LBF_BUFFER_FIND:
+    case LBF_BUFFER_EQUAL:
+    case LBF_MATH_NOISE:
         break;
     case LBF_TABLE_INSERT:
         state.invalidateHeap();
@@ -545,8 +653,153 @@ static void handleBuiltinEffects(ConstPropState& state, LuauBuiltinFunction bfid
     state.invalidateRegistersFrom(firstReturnReg);
 }
 
+// Finds an integer with the same value modulo 2^32 as a double operand that is known to be an integer in the 32 bit range
+// Sums and differences of two such values are exact and NUM_TO_UINT conversion of them is modular, so they can be computed on integers
+static IrOp getUintSource(IrBuilder& build, IrFunction& function, IrOp op)
+{
+    if (op.kind == IrOpKind::Constant)
+    {
+        double value = function.doubleOp(op);
+
+        if (value == double(int64_t(value)) && value > -4294967296.0 && value < 4294967296.0)
+            return build.constInt(int(unsigned(int64_t(value))));
+    }
+    else if (IrInst* src = function.asInstOp(op); src && (src->cmd == IrCmd::UINT_TO_NUM || src->cmd == IrCmd::INT_TO_NUM))
+    {
+        return src->a;
+    }
+
+    return {};
+}
+
+// Instructions that don't call into the VM in a way that could perform a GC step (CHECK_GC is handled separately)
+static bool canRunGcStep(IrCmd cmd)
+{
+    switch (cmd)
+    {
+    case IrCmd::NOP:
+    case IrCmd::LOAD_TAG:
+    case IrCmd::LOAD_POINTER:
+    case IrCmd::LOAD_DOUBLE:
+    case IrCmd::LOAD_INT:
+    case IrCmd::LOAD_FLOAT:
+    case IrCmd::LOAD_TVALUE:
+    case IrCmd::LOAD_ENV:
+    case IrCmd::GET_ARR_ADDR:
+    case IrCmd::GET_SLOT_NODE_ADDR:
+    case IrCmd::GET_HASH_NODE_ADDR:
+    case IrCmd::GET_CLOSURE_UPVAL_ADDR:
+    case IrCmd::STORE_TAG:
+    case IrCmd::STORE_EXTRA:
+    case IrCmd::STORE_POINTER:
+    case IrCmd::STORE_DOUBLE:
+    case IrCmd::STORE_INT:
+    case IrCmd::STORE_VECTOR:
+    case IrCmd::STORE_TVALUE:
+    case IrCmd::STORE_SPLIT_TVALUE:
+    case IrCmd::ADD_INT:
+    case IrCmd::SUB_INT:
+    case IrCmd::ADD_NUM:
+    case IrCmd::SUB_NUM:
+    case IrCmd::MUL_NUM:
+    case IrCmd::DIV_NUM:
+    case IrCmd::IDIV_NUM:
+    case IrCmd::MOD_NUM:
+    case IrCmd::MIN_NUM:
+    case IrCmd::MAX_NUM:
+    case IrCmd::UNM_NUM:
+    case IrCmd::FLOOR_NUM:
+    case IrCmd::CEIL_NUM:
+    case IrCmd::ROUND_NUM:
+    case IrCmd::SQRT_NUM:
+    case IrCmd::ABS_NUM:
+    case IrCmd::ADD_VEC:
+    case IrCmd::SUB_VEC:
+    case IrCmd::MUL_VEC:
+    case IrCmd::DIV_VEC:
+    case IrCmd::UNM_VEC:
+    case IrCmd::NOT_ANY:
+    case IrCmd::JUMP:
+    case IrCmd::JUMP_IF_TRUTHY:
+    case IrCmd::JUMP_IF_FALSY:
+    case IrCmd::JUMP_EQ_TAG:
+    case IrCmd::JUMP_CMP_INT:
+    case IrCmd::JUMP_EQ_POINTER:
+    case IrCmd::JUMP_CMP_NUM:
+    case IrCmd::JUMP_FORN_LOOP_COND:
+    case IrCmd::JUMP_SLOT_MATCH:
+    case IrCmd::TABLE_LEN:
+    case IrCmd::STRING_LEN:
+    case IrCmd::STRING_READU8:
+    case IrCmd::NEW_TABLE:
+    case IrCmd::DUP_TABLE:
+    case IrCmd::TABLE_SETNUM:
+    case IrCmd::TRY_NUM_TO_INDEX:
+    case IrCmd::INT_TO_NUM:
+    case IrCmd::UINT_TO_NUM:
+    case IrCmd::NUM_TO_INT:
+    case IrCmd::NUM_TO_UINT:
+    case IrCmd::NUM_TO_VECTOR:
+    case IrCmd::TAG_VECTOR:
+    case IrCmd::CHECK_TAG:
+    case IrCmd::CHECK_TRUTHY:
+    case IrCmd::CHECK_READONLY:
+    case IrCmd::CHECK_NO_METATABLE:
+    case IrCmd::CHECK_SAFE_ENV:
+    case IrCmd::CHECK_ARRAY_SIZE:
+    case IrCmd::CHECK_SLOT_MATCH:
+    case IrCmd::CHECK_NODE_NO_NEXT:
+    case IrCmd::CHECK_NODE_VALUE:
+    case IrCmd::CHECK_BUFFER_LEN:
+    case IrCmd::CHECK_STRING_LEN:
+    case IrCmd::CHECK_GC:
+    case IrCmd::BARRIER_OBJ:
+    case IrCmd::BARRIER_TABLE_BACK:
+    case IrCmd::BARRIER_TABLE_FORWARD:
+    case IrCmd::SET_SAVEDPC:
+    case IrCmd::BITAND_UINT:
+    case IrCmd::BITXOR_UINT:
+    case IrCmd::BITOR_UINT:
+    case IrCmd::BITNOT_UINT:
+    case IrCmd::BITLSHIFT_UINT:
+    case IrCmd::BITRSHIFT_UINT:
+    case IrCmd::BITARSHIFT_UINT:
+    case IrCmd::BITLROTATE_UINT:
+    case IrCmd::BITRROTATE_UINT:
+    case IrCmd::BITCOUNTLZ_UINT:
+    case IrCmd::BITCOUNTRZ_UINT:
+    case IrCmd::BYTESWAP_UINT:
+    case IrCmd::INVOKE_LIBM:
+    case IrCmd::GET_TYPE:
+    case IrCmd::BUFFER_READI8:
+    case IrCmd::BUFFER_READU8:
+    case IrCmd::BUFFER_WRITEI8:
+    case IrCmd::BUFFER_READI16:
+    case IrCmd::BUFFER_READU16:
+    case IrCmd::BUFFER_WRITEI16:
+    case IrCmd::BUFFER_READI32:
+    case IrCmd::BUFFER_WRITEI32:
+    case IrCmd::BUFFER_READF32:
+    case IrCmd::BUFFER_WRITEF32:
+    case IrCmd::BUFFER_READF64:
+    case IrCmd::BUFFER_WRITEF64:
+        return false;
+    default:
+        return true;
+    }
+}
+
+static bool isNewTable(ConstPropState& state, IrOp op)
+{
+    return op.kind == IrOpKind::Inst && std::find(state.newTables.begin(), state.newTables.end(), op.index) != state.newTables.end();
+}
+
 static void constPropInInst(ConstPropState& state, IrBuilder& build, IrFunction& function, IrBlock& block, IrInst& inst, uint32_t index)
 {
+    // Any object could be marked black by a GC step
+    if (canRunGcStep(inst.cmd))
+        state.newTables.clear();
+
     switch (inst.cmd)
     {
     case IrCmd::LOAD_TAG:
@@ -587,7 +840,20 @@ static void constPropInInst(ConstPropState& state, IrBuilder& build, IrFunction&
         break;
     case IrCmd::LOAD_TVALUE:
         if (inst.a.kind == IrOpKind::VmReg)
+        {
             state.substituteOrRecordVmRegLoad(inst);
+        }
+        else if (inst.a.kind == IrOpKind::Inst && state.useValueNumbering && state.isZeroOffset(inst.b))
+        {
+            // Value stored into a table slot can be used directly instead of reading it back
+            if (IrInst* store = state.tryGetSlotStore(inst.a))
+            {
+                if (store->cmd == IrCmd::STORE_TVALUE && store->b.kind == IrOpKind::Inst)
+                    substitute(function, inst, store->b);
+                else if (store->cmd == IrCmd::STORE_SPLIT_TVALUE)
+                    state.slotLoadSplitStores[index] = function.getInstIndex(*store);
+            }
+        }
         break;
     case IrCmd::STORE_TAG:
         if (inst.a.kind == IrOpKind::VmReg)
@@ -648,6 +914,12 @@ static void constPropInInst(ConstPropState& state, IrBuilder& build, IrFunction&
                         info->knownTableArraySize = function.uintOp(instOp->a);
                     }
                 }
+                else if (instOp && instOp->cmd == IrCmd::DUP_TABLE)
+                {
+                    // Table copy is never readonly, but it inherits the metatable of the template
+                    if (RegisterInfo* info = state.tryGetRegisterInfo(inst.a))
+                        info->knownNotReadonly = true;
+                }
             }
         }
         break;
@@ -715,12 +987,20 @@ static void constPropInInst(ConstPropState& state, IrBuilder& build, IrFunction&
             {
                 if (IrInst* arg = function.asInstOp(inst.b))
                 {
-                    if (arg->cmd == IrCmd::ADD_VEC || arg->cmd == IrCmd::SUB_VEC || arg->cmd == IrCmd::MUL_VEC || arg->cmd == IrCmd::DIV_VEC ||
-                        arg->cmd == IrCmd::UNM_VEC)
+                    if (arg->cmd == IrCmd::TAG_VECTOR)
                         tag = LUA_TVECTOR;
                 }
             }
 
+            // Tag of a table slot load might be known from the split store into that slot
+            const IrInst* splitStore = nullptr;
+
+            if (uint32_t* storeIdx = inst.b.kind == IrOpKind::Inst ? state.slotLoadSplitStores.find(inst.b.index) : nullptr; storeIdx && tag == 0xff)
+            {
+                splitStore = &function.instructions[*storeIdx];
+                tag = function.tagOp(splitStore->b);
+            }
+
             IrOp value = state.tryGetValue(inst.b);
 
             if (inst.a.kind == IrOpKind::VmReg)
@@ -747,6 +1027,20 @@ static void constPropInInst(ConstPropState& state, IrBuilder& build, IrFunction&
                 }
             }
 
+            // Value stored into the table slot can be used directly, and propagated to future loads of the same register
+            if (splitStore && value.kind == IrOpKind::None)
+            {
+                value = splitStore->c;
+
+                if (value.kind == IrOpKind::Constant && inst.a.kind == IrOpKind::VmReg)
+                    state.saveValue(inst.a, value);
+                else if (value.kind == IrOpKind::Inst && inst.a.kind == IrOpKind::VmReg && !function.cfg.captured.regs.test(vmRegOp(inst.a)))
+                {
+                    activeLoadCmd = tag == LUA_TBOOLEAN ? IrCmd::LOAD_INT : tag == LUA_TNUMBER ? IrCmd::LOAD_DOUBLE : IrCmd::LOAD_POINTER;
+                    activeLoadValue = value.index;
+                }
+            }
+
             // If we have constant tag and value, replace TValue store with tag/value pair store
             if (tag != 0xff && value.kind != IrOpKind::None && (tag == LUA_TBOOLEAN || tag == LUA_TNUMBER || isGCO(tag)))
             {
@@ -760,6 +1054,9 @@ static void constPropInInst(ConstPropState& state, IrBuilder& build, IrFunction&
             {
                 state.forwardVmRegStoreToLoad(inst, IrCmd::LOAD_TVALUE);
             }
+
+            if (inst.a.kind == IrOpKind::Inst)
+                state.recordSlotStore(index, inst.a, inst.cmd == IrCmd::STORE_TVALUE ? inst.c : inst.d);
         }
         break;
     case IrCmd::STORE_SPLIT_TVALUE:
@@ -772,6 +1069,10 @@ static void constPropInInst(ConstPropState& state, IrBuilder& build, IrFunction&
             if (inst.c.kind == IrOpKind::Constant)
                 state.saveValue(inst.a, inst.c);
         }
+        else if (inst.a.kind == IrOpKind::Inst)
+        {
+            state.recordSlotStore(index, inst.a, inst.d);
+        }
         break;
     case IrCmd::JUMP_IF_TRUTHY:
         if (uint8_t tag = state.tryGetTag(inst.a); tag != 0xff)
@@ -1018,6 +1319,7 @@ static void constPropInInst(ConstPropState& state, IrBuilder& build, IrFunction&
             state.checkBufferLenCache.push_back(index);
         break;
     }
+    case IrCmd::CHECK_STRING_LEN:
     case IrCmd::BUFFER_READI8:
     case IrCmd::BUFFER_READU8:
     case IrCmd::BUFFER_WRITEI8:
@@ -1040,6 +1342,7 @@ static void constPropInInst(ConstPropState& state, IrBuilder& build, IrFunction&
         else
         {
             state.checkedGc = true;
+            state.newTables.clear();
 
             if (DFFlag::LuauCodeGenCheckGcEffectFix)
             {
@@ -1050,6 +1353,13 @@ static void constPropInInst(ConstPropState& state, IrBuilder& build, IrFunction&
         break;
     case IrCmd::BARRIER_OBJ:
     case IrCmd::BARRIER_TABLE_FORWARD:
+        // Barrier is only required when the object is black, which new objects can't be until the GC has a chance to run
+        if (isNewTable(state, inst.a))
+        {
+            kill(function, inst);
+            break;
+        }
+
         if (inst.b.kind == IrOpKind::VmReg)
         {
             if (uint8_t tag = state.tryGetTag(inst.b); tag != 0xff)
@@ -1137,8 +1447,12 @@ static void constPropInInst(ConstPropState& state, IrBuilder& build, IrFunction&
         state.invalidateTableArraySize();
         break;
     case IrCmd::STRING_LEN:
+    case IrCmd::STRING_READU8:
+        break;
     case IrCmd::NEW_TABLE:
     case IrCmd::DUP_TABLE:
+        if (int(state.newTables.size()) < FInt::LuauCodeGenReuseSlotLimit)
+            state.newTables.push_back(index);
         break;
     case IrCmd::TRY_NUM_TO_INDEX:
         for (uint32_t prevIdx : state.tryNumToIndexCache)
@@ -1168,10 +1482,24 @@ static void constPropInInst(ConstPropState& state, IrBuilder& build, IrFunction&
             state.substituteOrRecord(inst, index);
         break;
     case IrCmd::NUM_TO_UINT:
-        if (IrInst* src = function.asInstOp(inst.a); src && src->cmd == IrCmd::UINT_TO_NUM)
+        if (IrInst* src = function.asInstOp(inst.a); src && (src->cmd == IrCmd::UINT_TO_NUM || src->cmd == IrCmd::INT_TO_NUM))
+        {
             substitute(function, inst, src->a);
+        }
+        else if (src && (src->cmd == IrCmd::ADD_NUM || src->cmd == IrCmd::SUB_NUM))
+        {
+            IrOp lhs = getUintSource(build, function, src->a);
+            IrOp rhs = getUintSource(build, function, src->b);
+
+            if (lhs.kind != IrOpKind::None && rhs.kind != IrOpKind::None && (lhs.kind == IrOpKind::Inst || rhs.kind == IrOpKind::Inst))
+                replace(function, block, index, {src->cmd == IrCmd::ADD_NUM ? IrCmd::ADD_INT : IrCmd::SUB_INT, lhs, rhs});
+            else
+                state.substituteOrRecord(inst, index);
+        }
         else
+        {
             state.substituteOrRecord(inst, index);
+        }
         break;
     case IrCmd::CHECK_ARRAY_SIZE:
     {
@@ -1241,8 +1569,18 @@ static void constPropInInst(ConstPropState& state, IrBuilder& build, IrFunction&
 
             if (prev.a == inst.a && prev.b == inst.b)
             {
-                // Only a check for 'nil' value is left
-                replace(function, block, index, {IrCmd::CHECK_NODE_VALUE, inst.a, inst.c});
+                // Only a check for 'nil' value is left, unless the value stored there is known
+                if (uint8_t tag = state.tryGetSlotTag(inst.a); tag != 0xff && tag != LUA_TNIL)
+                {
+                    if (FFlag::DebugLuauAbortingChecks)
+                        replace(function, block, index, {IrCmd::CHECK_NODE_VALUE, inst.a, build.undef()});
+                    else
+                        kill(function, inst);
+                }
+                else
+                {
+                    replace(function, block, index, {IrCmd::CHECK_NODE_VALUE, inst.a, inst.c});
+                }
                 return; // Break out from both the loop and the switch
             }
         }
@@ -1250,9 +1588,21 @@ static void constPropInInst(ConstPropState& state, IrBuilder& build, IrFunction&
         if (int(state.checkSlotMatchCache.size()) < FInt::LuauCodeGenReuseSlotLimit)
             state.checkSlotMatchCache.push_back(index);
         break;
-    case IrCmd::CHECK_NODE_NO_NEXT:
     case IrCmd::CHECK_NODE_VALUE:
+        // Slot value is known not to be 'nil' if we have stored a different value there
+        if (uint8_t tag = state.tryGetSlotTag(inst.a); tag != 0xff && tag != LUA_TNIL)
+        {
+            if (FFlag::DebugLuauAbortingChecks)
+                replace(function, inst.b, build.undef());
+            else
+                kill(function, inst);
+        }
+        break;
     case IrCmd::BARRIER_TABLE_BACK:
+        if (isNewTable(state, inst.a))
+            kill(function, inst);
+        break;
+    case IrCmd::CHECK_NODE_NO_NEXT:
     case IrCmd::RETURN:
     case IrCmd::COVERAGE:
     case IrCmd::SET_SAVEDPC:  // TODO: we may be able to remove some updates to PC
@@ -1278,12 +1628,25 @@ static void constPropInInst(ConstPropState& state, IrBuilder& build, IrFunction&
     case IrCmd::GET_TYPE:
     case IrCmd::GET_TYPEOF:
     case IrCmd::FINDUPVAL:
+    case IrCmd::NUM_TO_VECTOR:
+    case IrCmd::TAG_VECTOR:
+    case IrCmd::INCREMENT_COUNTER:
+        break;
+
     case IrCmd::ADD_VEC:
     case IrCmd::SUB_VEC:
     case IrCmd::MUL_VEC:
     case IrCmd::DIV_VEC:
+        // Vector math doesn't need the tag, so the result of a previous operation can be used directly
+        if (IrInst* a = function.asInstOp(inst.a); a && a->cmd == IrCmd::TAG_VECTOR)
+            replace(function, inst.a, a->a);
+
+        if (IrInst* b = function.asInstOp(inst.b); b && b->cmd == IrCmd::TAG_VECTOR)
+            replace(function, inst.b, b->a);
+        break;
     case IrCmd::UNM_VEC:
-    case IrCmd::NUM_TO_VECTOR:
+        if (IrInst* a = function.asInstOp(inst.a); a && a->cmd == IrCmd::TAG_VECTOR)
+            replace(function, inst.a, a->a);
         break;
 
     case IrCmd::DO_ARITH:
@@ -0,0 +1,286 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#include "Luau/OptimizeDeadStore.h"
+
+#include "Luau/IrUtils.h"
+
+#include "lobject.h"
+
+#include <vector>
+
+namespace Luau
+{
+namespace CodeGen
+{
+
+// A store into a VM register that hasn't been observed before it was overwritten can be skipped
+// Such stores are common for numeric temporaries, which values are already propagated to their users by constant propagation
+struct PendingStore
+{
+    uint8_t reg = 0;
+
+    // Parts of the TValue written by the store
+    bool tag = false;
+    uint8_t valueSize = 0;
+
+    // Parts of the TValue written by later stores
+    bool tagOverwritten = false;
+    bool valueOverwritten = false;
+
+    uint32_t instIdx = 0;
+};
+
+// Table data pointers can't point into the VM stack
+static bool isTableDataPointer(IrFunction& function, IrOp op)
+{
+    if (op.kind != IrOpKind::Inst)
+        return false;
+
+    IrCmd cmd = function.instOp(op).cmd;
+    return cmd == IrCmd::GET_ARR_ADDR || cmd == IrCmd::GET_SLOT_NODE_ADDR || cmd == IrCmd::GET_HASH_NODE_ADDR;
+}
+
+// Instructions that do not read VM registers, can't exit and can't run VM or GC code
+static bool isPureComputation(IrCmd cmd)
+{
+    switch (cmd)
+    {
+    case IrCmd::NOP:
+    case IrCmd::SUBSTITUTE:
+    case IrCmd::INCREMENT_COUNTER:
+    case IrCmd::LOAD_ENV:
+    case IrCmd::GET_ARR_ADDR:
+    case IrCmd::GET_SLOT_NODE_ADDR:
+    case IrCmd::GET_HASH_NODE_ADDR:
+    case IrCmd::GET_CLOSURE_UPVAL_ADDR:
+    case IrCmd::ADD_INT:
+    case IrCmd::SUB_INT:
+    case IrCmd::ADD_NUM:
+    case IrCmd::SUB_NUM:
+    case IrCmd::MUL_NUM:
+    case IrCmd::DIV_NUM:
+    case IrCmd::IDIV_NUM:
+    case IrCmd::MOD_NUM:
+    case IrCmd::MIN_NUM:
+    case IrCmd::MAX_NUM:
+    case IrCmd::UNM_NUM:
+    case IrCmd::FLOOR_NUM:
+    case IrCmd::CEIL_NUM:
+    case IrCmd::ROUND_NUM:
+    case IrCmd::SQRT_NUM:
+    case IrCmd::ABS_NUM:
+    case IrCmd::ADD_VEC:
+    case IrCmd::SUB_VEC:
+    case IrCmd::MUL_VEC:
+    case IrCmd::DIV_VEC:
+    case IrCmd::UNM_VEC:
+    case IrCmd::NOT_ANY:
+    case IrCmd::TABLE_LEN:
+    case IrCmd::STRING_LEN:
+    case IrCmd::STRING_READU8:
+    case IrCmd::INT_TO_NUM:
+    case IrCmd::UINT_TO_NUM:
+    case IrCmd::NUM_TO_INT:
+    case IrCmd::NUM_TO_UINT:
+    case IrCmd::NUM_TO_VECTOR:
+    case IrCmd::TAG_VECTOR:
+    case IrCmd::BITAND_UINT:
+    case IrCmd::BITXOR_UINT:
+    case IrCmd::BITOR_UINT:
+    case IrCmd::BITNOT_UINT:
+    case IrCmd::BITLSHIFT_UINT:
+    case IrCmd::BITRSHIFT_UINT:
+    case IrCmd::BITARSHIFT_UINT:
+    case IrCmd::BITLROTATE_UINT:
+    case IrCmd::BITRROTATE_UINT:
+    case IrCmd::BITCOUNTLZ_UINT:
+    case IrCmd::BITCOUNTRZ_UINT:
+    case IrCmd::BYTESWAP_UINT:
+    case IrCmd::INVOKE_LIBM:
+    case IrCmd::GET_TYPE:
+    case IrCmd::BUFFER_READI8:
+    case IrCmd::BUFFER_READU8:
+    case IrCmd::BUFFER_WRITEI8:
+    case IrCmd::BUFFER_READI16:
+    case IrCmd::BUFFER_READU16:
+    case IrCmd::BUFFER_WRITEI16:
+    case IrCmd::BUFFER_READI32:
+    case IrCmd::BUFFER_WRITEI32:
+    case IrCmd::BUFFER_READF32:
+    case IrCmd::BUFFER_WRITEF32:
+    case IrCmd::BUFFER_READF64:
+    case IrCmd::BUFFER_WRITEF64:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Removing the last use of an instruction removes the instruction, which is only possible when it has no side effects
+static bool canRemoveUse(IrFunction& function, IrOp op)
+{
+    if (op.kind != IrOpKind::Inst)
+        return true;
+
+    const IrInst& inst = function.instOp(op);
+
+    if (inst.useCount > 1)
+        return true;
+
+    bool isLoad = inst.cmd == IrCmd::LOAD_TAG || inst.cmd == IrCmd::LOAD_POINTER || inst.cmd == IrCmd::LOAD_DOUBLE || inst.cmd == IrCmd::LOAD_INT ||
+                  inst.cmd == IrCmd::LOAD_FLOAT || inst.cmd == IrCmd::LOAD_TVALUE;
+
+    if (!isLoad && !isPureComputation(inst.cmd))
+        return false;
+
+    return canRemoveUse(function, inst.a) && canRemoveUse(function, inst.b) && canRemoveUse(function, inst.c) && canRemoveUse(function, inst.d) &&
+           canRemoveUse(function, inst.e) && canRemoveUse(function, inst.f);
+}
+
+static bool canKillStore(IrFunction& function, const IrInst& inst)
+{
+    return canRemoveUse(function, inst.b) && canRemoveUse(function, inst.c) && canRemoveUse(function, inst.d);
+}
+
+struct DeadStoreState
+{
+    explicit DeadStoreState(IrFunction& function)
+        : function(function)
+    {
+    }
+
+    // Register value can be read by the following instructions
+    void observe(uint8_t reg)
+    {
+        for (size_t i = 0; i < pending.size();)
+        {
+            if (pending[i].reg == reg)
+            {
+                pending[i] = pending.back();
+                pending.pop_back();
+            }
+            else
+            {
+                i++;
+            }
+        }
+    }
+
+    // Any register can be read by VM, GC or the fallback code
+    void observeAll()
+    {
+        pending.clear();
+    }
+
+    void store(uint8_t reg, bool tag, uint8_t valueSize, uint32_t instIdx)
+    {
+        // Previous stores that are completely overwritten by the later ones were never seen
+        for (size_t i = 0; i < pending.size();)
+        {
+            PendingStore& prev = pending[i];
+
+            if (prev.reg == reg)
+            {
+                prev.tagOverwritten |= tag;
+                prev.valueOverwritten |= valueSize != 0 && valueSize >= prev.valueSize;
+            }
+
+            bool dead = (!prev.tag || prev.tagOverwritten) && (prev.valueSize == 0 || prev.valueOverwritten);
+
+            if (prev.reg == reg && dead && canKillStore(function, function.instructions[prev.instIdx]))
+            {
+                kill(function, function.instructions[prev.instIdx]);
+
+                pending[i] = pending.back();
+                pending.pop_back();
+            }
+            else
+            {
+                i++;
+            }
+        }
+
+        pending.push_back({reg, tag, valueSize, false, false, instIdx});
+    }
+
+    IrFunction& function;
+
+    std::vector<PendingStore> pending;
+};
+
+static void killDeadStoresInInst(DeadStoreState& state, IrFunction& function, IrInst& inst, uint32_t index)
+{
+    switch (inst.cmd)
+    {
+    case IrCmd::LOAD_TAG:
+    case IrCmd::LOAD_POINTER:
+    case IrCmd::LOAD_DOUBLE:
+    case IrCmd::LOAD_INT:
+    case IrCmd::LOAD_FLOAT:
+    case IrCmd::LOAD_TVALUE:
+        if (inst.a.kind == IrOpKind::VmReg)
+            state.observe(vmRegOp(inst.a));
+        else if (inst.a.kind != IrOpKind::VmConst && !isTableDataPointer(function, inst.a))
+            state.observeAll();
+        break;
+    case IrCmd::STORE_TAG:
+    case IrCmd::STORE_POINTER:
+    case IrCmd::STORE_DOUBLE:
+    case IrCmd::STORE_INT:
+    case IrCmd::STORE_VECTOR:
+    case IrCmd::STORE_TVALUE:
+    case IrCmd::STORE_SPLIT_TVALUE:
+        if (inst.a.kind == IrOpKind::VmReg)
+        {
+            uint8_t reg = vmRegOp(inst.a);
+
+            if (inst.cmd == IrCmd::STORE_TAG)
+                state.store(reg, /* tag */ true, 0, index);
+            else if (inst.cmd == IrCmd::STORE_POINTER || inst.cmd == IrCmd::STORE_DOUBLE)
+                state.store(reg, /* tag */ false, 8, index);
+            else if (inst.cmd == IrCmd::STORE_INT)
+                state.store(reg, /* tag */ false, 4, index);
+            else if (inst.cmd == IrCmd::STORE_VECTOR)
+                state.store(reg, /* tag */ false, 12, index);
+            else if (inst.cmd == IrCmd::STORE_TVALUE && inst.c.kind == IrOpKind::None)
+                state.store(reg, /* tag */ true, sizeof(TValue), index);
+            else if (inst.cmd == IrCmd::STORE_SPLIT_TVALUE && inst.d.kind == IrOpKind::None)
+                state.store(reg, /* tag */ true, function.tagOp(inst.b) == LUA_TBOOLEAN ? 4 : 8, index);
+            else
+                state.observeAll();
+        }
+        else if (!isTableDataPointer(function, inst.a))
+        {
+            state.observeAll();
+        }
+        break;
+    default:
+        if (!isPureComputation(inst.cmd))
+            state.observeAll();
+        break;
+    }
+}
+
+void killDeadStoresInBlocks(IrFunction& function)
+{
+    DeadStoreState state{function};
+
+    for (IrBlock& block : function.blocks)
+    {
+        if (block.kind == IrBlockKind::Dead)
+            continue;
+
+        // Values of all registers are visible at block exit
+        state.observeAll();
+
+        for (uint32_t index = block.start; index <= block.finish; index++)
+        {
+            CODEGEN_ASSERT(index < function.instructions.size());
+            IrInst& inst = function.instructions[index];
+
+            killDeadStoresInInst(state, function, inst, index);
+        }
+    }
+}
+
+} // namespace CodeGen
+} // namespace Luau
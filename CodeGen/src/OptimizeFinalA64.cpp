@@ -0,0 +1,97 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#include "Luau/OptimizeFinalA64.h"
+
+#include "Luau/IrUtils.h"
+
+#include <utility>
+
+namespace Luau
+{
+namespace CodeGen
+{
+
+// Condition that gives the same result when operands of the comparison are swapped; unordered operands compare the same way
+static IrCondition getSwappedCondition(IrCondition cond)
+{
+    switch (cond)
+    {
+    case IrCondition::Equal:
+    case IrCondition::NotEqual:
+        return cond;
+    case IrCondition::Less:
+        return IrCondition::Greater;
+    case IrCondition::NotLess:
+        return IrCondition::NotGreater;
+    case IrCondition::LessEqual:
+        return IrCondition::GreaterEqual;
+    case IrCondition::NotLessEqual:
+        return IrCondition::NotGreaterEqual;
+    case IrCondition::Greater:
+        return IrCondition::Less;
+    case IrCondition::NotGreater:
+        return IrCondition::NotLess;
+    case IrCondition::GreaterEqual:
+        return IrCondition::LessEqual;
+    case IrCondition::NotGreaterEqual:
+        return IrCondition::NotLessEqual;
+    default:
+        CODEGEN_ASSERT(!"Unexpected condition code");
+        return cond;
+    }
+}
+
+// a64 assembly doesn't allow immediate floating-point operands, so constants are materialized in a register before use
+// To improve final a64 lowering, we rewrite instructions with constant operands into forms that don't need the constant at all
+// Comparisons with zero use 'fcmp #0.0' when the constant is on the right, and 'x * 2' is computed as 'x + x'
+static void optimizeConstantOperandsA64(IrFunction& function, IrBlock& block)
+{
+    CODEGEN_ASSERT(block.kind != IrBlockKind::Dead);
+
+    for (uint32_t index = block.start; index <= block.finish; index++)
+    {
+        CODEGEN_ASSERT(index < function.instructions.size());
+        IrInst& inst = function.instructions[index];
+
+        switch (inst.cmd)
+        {
+        case IrCmd::JUMP_CMP_NUM:
+        {
+            if (inst.a.kind == IrOpKind::Constant && inst.b.kind == IrOpKind::Inst)
+            {
+                std::swap(inst.a, inst.b);
+                inst.c = IrOp{IrOpKind::Condition, uint32_t(getSwappedCondition(conditionOp(inst.c)))};
+            }
+            break;
+        }
+        case IrCmd::MUL_NUM:
+        {
+            if (inst.a.kind == IrOpKind::Constant && inst.b.kind == IrOpKind::Inst)
+                std::swap(inst.a, inst.b);
+
+            // doubling is exact, so both forms produce the same result for all inputs
+            if (inst.a.kind == IrOpKind::Inst && inst.b.kind == IrOpKind::Constant && function.doubleOp(inst.b) == 2.0)
+            {
+                inst.cmd = IrCmd::ADD_NUM;
+                replace(function, inst.b, inst.a);
+            }
+            break;
+        }
+        default:
+            break;
+        }
+    }
+}
+
+void optimizeConstantOperandsA64(IrFunction& function)
+{
+    for (IrBlock& block : function.blocks)
+    {
+        if (block.kind == IrBlockKind::Dead)
+            continue;
+
+        optimizeConstantOperandsA64(function, block);
+    }
+}
+
+} // namespace CodeGen
+} // namespace Luau
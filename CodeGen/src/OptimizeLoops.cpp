@@ -0,0 +1,239 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#include "Luau/OptimizeLoops.h"
+
+#include "Luau/IrAnalysis.h"
+#include "Luau/IrBuilder.h"
+#include "Luau/IrUtils.h"
+#include "Luau/IrVisitUseDef.h"
+
+#include <array>
+#include <bitset>
+#include <vector>
+
+LUAU_FASTFLAG(DebugLuauAbortingChecks)
+
+namespace Luau
+{
+namespace CodeGen
+{
+
+// Collects VM registers which tag can be changed by the instructions of the loop
+struct LoopTagDefs : VmRegDefVisitor<LoopTagDefs>
+{
+    std::bitset<256> regs;
+
+    void defReg(int reg)
+    {
+        regs.set(reg, true);
+    }
+};
+
+static bool dominates(const CfgInfo& info, uint32_t a, uint32_t b)
+{
+    const BlockOrdering& ordA = info.domOrdering[a];
+    const BlockOrdering& ordB = info.domOrdering[b];
+
+    if (!ordA.visited || !ordB.visited)
+        return false;
+
+    return ordA.preOrder <= ordB.preOrder && ordA.postOrder >= ordB.postOrder;
+}
+
+static IrOp* findBlockOp(IrInst& inst, uint32_t blockIdx)
+{
+    for (IrOp* op : {&inst.a, &inst.b, &inst.c, &inst.d, &inst.e, &inst.f})
+    {
+        if (op->kind == IrOpKind::Block && op->index == blockIdx)
+            return op;
+    }
+
+    return nullptr;
+}
+
+static bool tryHoistLoopInvariantChecks(IrBuilder& build, uint32_t headerIdx)
+{
+    IrFunction& function = build.function;
+    CfgInfo& info = function.cfg;
+
+    if (function.blocks[headerIdx].kind != IrBlockKind::Bytecode || !info.domOrdering[headerIdx].visited)
+        return false;
+
+    // Loop header has to be entered from a single block outside the loop, other predecessors are back edges
+    uint32_t preheaderIdx = ~0u;
+    std::vector<uint32_t> latches;
+
+    for (uint32_t predIdx : predecessors(info, headerIdx))
+    {
+        if (dominates(info, headerIdx, predIdx))
+            latches.push_back(predIdx);
+        else if (preheaderIdx == ~0u)
+            preheaderIdx = predIdx;
+        else
+            return false;
+    }
+
+    if (latches.empty() || preheaderIdx == ~0u)
+        return false;
+
+    // Entry edge has to come from the terminator so that it can be redirected to the guard block
+    if (!findBlockOp(function.instructions[function.blocks[preheaderIdx].finish], headerIdx))
+        return false;
+
+    // When the guard fails, interpreter resumes execution from the start of the loop header
+    uint32_t headerPc = ~0u;
+
+    for (size_t pc = 0; pc < build.instIndexToBlock.size(); pc++)
+    {
+        if (build.instIndexToBlock[pc] == headerIdx)
+        {
+            headerPc = uint32_t(pc);
+            break;
+        }
+    }
+
+    if (headerPc == ~0u)
+        return false;
+
+    // Collect the blocks of the natural loop by walking back from the latches to the header
+    std::vector<uint8_t> inLoop(function.blocks.size(), false);
+    std::vector<uint32_t> loopBlocks;
+    std::vector<uint32_t> worklist = latches;
+
+    inLoop[headerIdx] = true;
+    loopBlocks.push_back(headerIdx);
+
+    while (!worklist.empty())
+    {
+        uint32_t blockIdx = worklist.back();
+        worklist.pop_back();
+
+        if (inLoop[blockIdx])
+            continue;
+
+        // Irreducible control flow is not optimized
+        if (!dominates(info, headerIdx, blockIdx))
+            return false;
+
+        inLoop[blockIdx] = true;
+        loopBlocks.push_back(blockIdx);
+
+        for (uint32_t predIdx : predecessors(info, blockIdx))
+        {
+            if (!inLoop[predIdx])
+                worklist.push_back(predIdx);
+        }
+    }
+
+    LoopTagDefs defs;
+
+    for (uint32_t blockIdx : loopBlocks)
+    {
+        const IrBlock& block = function.blocks[blockIdx];
+
+        for (uint32_t index = block.start; index <= block.finish; index++)
+        {
+            const IrInst& inst = function.instructions[index];
+
+            if (!isTagPreservingStore(inst.cmd))
+                visitVmRegDefsUses(defs, function, inst);
+        }
+    }
+
+    // Tag check of a register that keeps its tag through the loop can be performed once before the loop is entered
+    // Only checks performed on every iteration are hoisted, to avoid failing the guard because of a path loop doesn't take
+    std::array<uint8_t, 256> guardTags;
+    guardTags.fill(0xff);
+
+    std::vector<uint32_t> checks;
+
+    for (uint32_t blockIdx : loopBlocks)
+    {
+        bool onEveryIteration = true;
+
+        for (uint32_t latchIdx : latches)
+            onEveryIteration &= dominates(info, blockIdx, latchIdx);
+
+        if (!onEveryIteration)
+            continue;
+
+        const IrBlock& block = function.blocks[blockIdx];
+
+        for (uint32_t index = block.start; index <= block.finish; index++)
+        {
+            const IrInst& inst = function.instructions[index];
+
+            if (inst.cmd != IrCmd::CHECK_TAG || inst.c.kind == IrOpKind::Undef)
+                continue;
+
+            int reg = getCheckedVmReg(function, block, index);
+
+            if (reg < 0 || defs.regs.test(reg) || info.captured.regs.test(reg))
+                continue;
+
+            uint8_t tag = function.tagOp(inst.b);
+
+            if (guardTags[reg] != 0xff && guardTags[reg] != tag)
+                continue;
+
+            guardTags[reg] = tag;
+            checks.push_back(index);
+        }
+    }
+
+    if (checks.empty())
+        return false;
+
+    IrOp guard = build.block(IrBlockKind::Internal);
+    build.beginBlock(guard);
+
+    for (size_t reg = 0; reg < guardTags.size(); reg++)
+    {
+        if (guardTags[reg] == 0xff)
+            continue;
+
+        IrOp load = build.inst(IrCmd::LOAD_TAG, build.vmReg(uint8_t(reg)));
+        build.inst(IrCmd::CHECK_TAG, load, build.constTag(guardTags[reg]), build.vmExit(headerPc));
+        addUse(function, load);
+    }
+
+    IrOp header{IrOpKind::Block, headerIdx};
+    build.inst(IrCmd::JUMP, header);
+    addUse(function, header);
+
+    // Instruction storage might have been reallocated, so the entry edge is located again
+    replace(function, *findBlockOp(function.instructions[function.blocks[preheaderIdx].finish], headerIdx), guard);
+
+    for (uint32_t index : checks)
+    {
+        IrInst& inst = function.instructions[index];
+
+        // Check might have been removed together with a fallback block that became unreachable
+        if (inst.cmd != IrCmd::CHECK_TAG)
+            continue;
+
+        if (FFlag::DebugLuauAbortingChecks)
+            replace(function, inst.c, build.undef());
+        else
+            kill(function, inst);
+    }
+
+    return true;
+}
+
+void hoistLoopInvariantChecks(IrBuilder& build)
+{
+    IrFunction& function = build.function;
+
+    // Loop headers are bytecode blocks, so guard blocks created by this pass are not visited
+    size_t originalBlockCount = function.blocks.size();
+
+    for (uint32_t headerIdx = 0; headerIdx < originalBlockCount; headerIdx++)
+    {
+        // Each guard changes the edges of the graph
+        if (tryHoistLoopInvariantChecks(build, headerIdx))
+            computeCfgInfo(function);
+    }
+}
+
+} // namespace CodeGen
+} // namespace Luau
@@ -0,0 +1,195 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#include "Luau/OptimizeRedundantChecks.h"
+
+#include "Luau/IrAnalysis.h"
+#include "Luau/IrBuilder.h"
+#include "Luau/IrUtils.h"
+#include "Luau/IrVisitUseDef.h"
+
+#include <array>
+#include <vector>
+
+LUAU_FASTFLAG(DebugLuauAbortingChecks)
+
+namespace Luau
+{
+namespace CodeGen
+{
+
+constexpr uint8_t kUnknownTag = 0xff;
+
+// Tags of VM registers that are known at a point in the function
+struct KnownTags : VmRegDefVisitor<KnownTags>
+{
+    std::array<uint8_t, 256> tags;
+
+    KnownTags()
+    {
+        tags.fill(kUnknownTag);
+    }
+
+    void defReg(int reg)
+    {
+        tags[reg] = kUnknownTag;
+    }
+
+    // Only the tags known on both paths remain known where the paths join
+    bool meet(const KnownTags& other)
+    {
+        bool changed = false;
+
+        for (size_t i = 0; i < tags.size(); i++)
+        {
+            if (tags[i] != kUnknownTag && tags[i] != other.tags[i])
+            {
+                tags[i] = kUnknownTag;
+                changed = true;
+            }
+        }
+
+        return changed;
+    }
+};
+
+static void applyInst(IrFunction& function, const IrBlock& block, uint32_t index, KnownTags& known)
+{
+    const IrInst& inst = function.instructions[index];
+    const RegisterSet& captured = function.cfg.captured;
+
+    switch (inst.cmd)
+    {
+    case IrCmd::CHECK_TAG:
+        if (int reg = getCheckedVmReg(function, block, index); reg >= 0 && !captured.regs.test(reg))
+            known.tags[reg] = function.tagOp(inst.b);
+        break;
+    case IrCmd::STORE_TAG:
+    case IrCmd::STORE_SPLIT_TVALUE:
+        if (inst.a.kind == IrOpKind::VmReg)
+        {
+            int reg = vmRegOp(inst.a);
+            known.tags[reg] = inst.b.kind == IrOpKind::Constant && !captured.regs.test(reg) ? function.tagOp(inst.b) : kUnknownTag;
+        }
+        break;
+    default:
+        if (!isTagPreservingStore(inst.cmd))
+            visitVmRegDefsUses(known, function, inst);
+        break;
+    }
+}
+
+static bool hasBlockOperand(const IrInst& inst)
+{
+    for (IrOp op : {inst.a, inst.b, inst.c, inst.d, inst.e, inst.f})
+    {
+        if (op.kind == IrOpKind::Block)
+            return true;
+    }
+
+    return false;
+}
+
+// Tag check is redundant when the same check has been performed on all paths leading to it and the register wasn't modified since
+// Unlike constant propagation, which works on chains of blocks, this tracks register tags through the whole control flow graph
+// Only facts about VM registers are propagated between blocks, so no IR values become live across blocks
+void removeRedundantTagChecks(IrBuilder& build)
+{
+    IrFunction& function = build.function;
+
+    std::vector<KnownTags> entryTags(function.blocks.size());
+    std::vector<uint8_t> reached(function.blocks.size(), false);
+    std::vector<uint8_t> inWorklist(function.blocks.size(), false);
+    std::vector<uint32_t> worklist;
+
+    reached[function.entryBlock] = true;
+    inWorklist[function.entryBlock] = true;
+    worklist.push_back(function.entryBlock);
+
+    auto addEdge = [&](uint32_t target, const KnownTags& known) {
+        if (!reached[target])
+        {
+            reached[target] = true;
+            entryTags[target] = known;
+        }
+        else if (!entryTags[target].meet(known))
+        {
+            return;
+        }
+
+        if (!inWorklist[target])
+        {
+            inWorklist[target] = true;
+            worklist.push_back(target);
+        }
+    };
+
+    while (!worklist.empty())
+    {
+        uint32_t blockIdx = worklist.back();
+        worklist.pop_back();
+        inWorklist[blockIdx] = false;
+
+        const IrBlock& block = function.blocks[blockIdx];
+
+        if (block.kind == IrBlockKind::Dead)
+            continue;
+
+        KnownTags known = entryTags[blockIdx];
+
+        for (uint32_t index = block.start; index <= block.finish; index++)
+        {
+            const IrInst& inst = function.instructions[index];
+
+            if (!hasBlockOperand(inst))
+            {
+                applyInst(function, block, index, known);
+                continue;
+            }
+
+            // Jumps can be taken before or after the effects of the instruction, so only tags known at both points are passed on
+            KnownTags edge = known;
+            applyInst(function, block, index, known);
+            edge.meet(known);
+
+            for (IrOp op : {inst.a, inst.b, inst.c, inst.d, inst.e, inst.f})
+            {
+                if (op.kind == IrOpKind::Block)
+                    addEdge(op.index, edge);
+            }
+        }
+    }
+
+    for (uint32_t blockIdx = 0; blockIdx < function.blocks.size(); blockIdx++)
+    {
+        // Removal of checks can remove the last use of a fallback block
+        if (!reached[blockIdx] || function.blocks[blockIdx].kind == IrBlockKind::Dead)
+            continue;
+
+        const IrBlock& block = function.blocks[blockIdx];
+        KnownTags& known = entryTags[blockIdx];
+
+        for (uint32_t index = block.start; index <= block.finish; index++)
+        {
+            IrInst& inst = function.instructions[index];
+
+            if (inst.cmd == IrCmd::CHECK_TAG && inst.c.kind != IrOpKind::Undef)
+            {
+                int reg = getCheckedVmReg(function, block, index);
+
+                if (reg >= 0 && known.tags[reg] == function.tagOp(inst.b))
+                {
+                    if (FFlag::DebugLuauAbortingChecks)
+                        replace(function, inst.c, build.undef());
+                    else
+                        kill(function, inst);
+
+                    continue;
+                }
+            }
+
+            applyInst(function, block, index, known);
+        }
+    }
+}
+
+} // namespace CodeGen
+} // namespace Luau
@@ -51,6 +51,7 @@
 enum LuauOpcode
 {
     // NOP: noop
+    // E: non-zero for coverage instructions that were reached while coverage only records the first hit, see lua_setcoveragefirsthit
     LOP_NOP,
 
     // BREAK: debugger break
@@ -161,7 +162,7 @@ enum LuauOpcode
     // B: source register
     // C: predicted slot index (based on hash)
     // AUX: constant table index
-    // Note that this instruction must be followed directly by CALL; it prepares the arguments
+    // Note that this instruction must be followed directly by CALL or TAILCALL; it prepares the arguments
     // This instruction is roughly equivalent to GETTABLEKS + MOVE pair, but we need a special instruction to support custom __namecall metamethod
     LOP_NAMECALL,
 
@@ -341,6 +342,7 @@ enum LuauOpcode
     // COVERAGE: update coverage information stored in the instruction
     // E: hit count for the instruction (0..2^23-1)
     // The hit count is incremented by VM every time the instruction is executed, and saturates at 2^23-1
+    // When coverage only records the first hit, the instruction is replaced with NOP with E=1 once executed
     LOP_COVERAGE,
 
     // CAPTURE: capture a local or an upvalue as an upvalue into a newly created closure; only valid after NEWCLOSURE
@@ -406,6 +408,21 @@ enum LuauOpcode
     // C: constant table index (0..255)
     LOP_IDIVK,
 
+    // MOVE2: copy two values between registers, equivalent to MOVE A B followed by MOVE AUX.A AUX.B (requires bytecode v6)
+    // this is a superinstruction that bytecode builder forms from two consecutive MOVE instructions on the same line
+    // A: target register 1
+    // B: source register 1
+    // AUX: target register 2 in the low 8 bits, source register 2 in the next 8 bits
+    LOP_MOVE2,
+
+    // TAILCALL: call specified function and return all of its results, reusing the current call frame when possible (requires bytecode v6)
+    // A: register where the function object lives, followed by arguments
+    // B: argument count + 1, or 0 to preserve all arguments up to top (MULTRET)
+    // C: always 0 (MULTRET)
+    // Note that this instruction must be followed directly by RETURN A 0; if the frame can't be reused (C functions, calls from the first frame of an
+    // interpreter entry, single-step execution), TAILCALL behaves exactly like CALL and the RETURN that follows completes the return
+    LOP_TAILCALL,
+
     // Enum entry for number of opcodes, not a valid opcode by itself!
     LOP__COUNT
 };
@@ -430,10 +447,13 @@ enum LuauBytecodeTag
 {
     // Bytecode version; runtime supports [MIN, MAX], compiler emits TARGET by default but may emit a higher version when flags are enabled
     LBC_VERSION_MIN = 3,
-    LBC_VERSION_MAX = 5,
+    LBC_VERSION_MAX = 6,
     LBC_VERSION_TARGET = 5,
     // Type encoding version
     LBC_TYPE_VERSION = 1,
+    // Compressed bytecode marker, followed by the size of uncompressed bytecode (varint) and an LZ4 block with the bytecode
+    // Since bytecode versions are limited to 7 bits, this can never be confused with a version
+    LBC_COMPRESSED = 255,
     // Types of constant table entries
     LBC_CONSTANT_NIL = 0,
     LBC_CONSTANT_BOOLEAN,
@@ -584,6 +604,18 @@ enum LuauBuiltinFunction
     LBF_BUFFER_WRITEF32,
     LBF_BUFFER_READF64,
     LBF_BUFFER_WRITEF64,
+    LBF_BUFFER_FIND,
+    LBF_BUFFER_EQUAL,
+
+    // math.noise
+    LBF_MATH_NOISE,
+};
+
+// Builtin function ids reserved for pure functions provided by the host, see CompileOptions::userBuiltins and lua_setuserbuiltin
+enum LuauUserBuiltinFunction
+{
+    LBF_USER_FIRST = 224,
+    LBF_USER_LAST = 255,
 };
 
 // Capture type, used in LOP_CAPTURE
@@ -601,4 +633,6 @@ enum LuauProtoFlag
     LPF_NATIVE_MODULE = 1 << 0,
     // used to tag individual protos as not profitable to compile natively
     LPF_NATIVE_COLD = 1 << 1,
+    // used to tag protos whose upvalues are always captured by value, so closure upvalues never refer to UpVal objects
+    LPF_UPVALS_BY_VALUE = 1 << 2,
 };
@@ -0,0 +1,640 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#pragma once
+
+#include "Luau/Common.h"
+#include "Luau/DenseHash.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <new>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define LUAU_FLATHASH_SSE2 1
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace Luau
+{
+
+// Internal implementation of FlatHashMap
+namespace detail
+{
+
+// Every slot has a control byte: kCtrlEmpty for unused slots, or 7 bits taken from the key's hash for used ones.
+// Slots are probed a group at a time, and the control bytes of a group are compared against the secondary hash all at
+// once, so the keys themselves are only compared for likely matches.
+constexpr uint8_t kCtrlEmpty = 0x80;
+
+#if LUAU_FLATHASH_SSE2
+struct FlatHashGroup
+{
+    static constexpr size_t kWidth = 16;
+
+    __m128i ctrl;
+
+    explicit FlatHashGroup(const uint8_t* pos)
+        : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pos)))
+    {
+    }
+
+    // One bit per slot whose control byte equals h2; slot index is the bit index
+    uint32_t match(uint8_t h2) const
+    {
+        return uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(char(h2)), ctrl)));
+    }
+
+    uint32_t matchEmpty() const
+    {
+        // kCtrlEmpty is the only control byte with the high bit set
+        return uint32_t(_mm_movemask_epi8(ctrl));
+    }
+
+    static size_t slotOf(uint32_t bit)
+    {
+        return bit;
+    }
+};
+#else
+struct FlatHashGroup
+{
+    static constexpr size_t kWidth = 8;
+    static constexpr uint64_t kLsbs = 0x0101010101010101ull;
+    static constexpr uint64_t kMsbs = 0x8080808080808080ull;
+
+    uint64_t ctrl = 0;
+
+    explicit FlatHashGroup(const uint8_t* pos)
+    {
+        for (size_t i = 0; i < kWidth; ++i)
+            ctrl |= uint64_t(pos[i]) << (i * 8);
+    }
+
+    // One high bit per slot whose control byte may equal h2; this can report false positives, which key comparison filters out
+    uint64_t match(uint8_t h2) const
+    {
+        uint64_t x = ctrl ^ (kLsbs * h2);
+        return (x - kLsbs) & ~x & kMsbs;
+    }
+
+    uint64_t matchEmpty() const
+    {
+        return ctrl & kMsbs;
+    }
+
+    static size_t slotOf(uint32_t bit)
+    {
+        return bit / 8;
+    }
+};
+#endif
+
+inline uint32_t flatHashLowestBit(uint64_t mask)
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return uint32_t(index);
+#elif defined(_MSC_VER)
+    unsigned long index;
+    if (_BitScanForward(&index, uint32_t(mask)))
+        return uint32_t(index);
+    _BitScanForward(&index, uint32_t(mask >> 32));
+    return uint32_t(index) + 32;
+#else
+    return uint32_t(__builtin_ctzll(mask));
+#endif
+}
+
+template<typename Key, typename Value, typename Hash, typename Eq>
+class FlatHashTable
+{
+public:
+    using Item = std::pair<Key, Value>;
+    using MutableItem = std::pair<const Key, Value>;
+
+    class const_iterator;
+    class iterator;
+
+    explicit FlatHashTable(const Key& empty_key, size_t buckets = 0)
+        : empty_key(empty_key)
+    {
+        // validate that equality operator is at least somewhat functional
+        LUAU_ASSERT(eq(empty_key, empty_key));
+        // buckets has to be power-of-two or zero
+        LUAU_ASSERT((buckets & (buckets - 1)) == 0);
+
+        if (buckets)
+            allocate(buckets < FlatHashGroup::kWidth ? FlatHashGroup::kWidth : buckets);
+    }
+
+    ~FlatHashTable()
+    {
+        destroy();
+    }
+
+    FlatHashTable(const FlatHashTable& other)
+        : empty_key(other.empty_key)
+    {
+        if (other.capacity)
+        {
+            allocate(other.capacity);
+
+            for (size_t i = 0; i < capacity; ++i)
+            {
+                if (other.ctrl[i] != kCtrlEmpty)
+                {
+                    new (&data[i]) Item(other.data[i]);
+                    ctrl[i] = other.ctrl[i];
+                    count++;
+                }
+            }
+        }
+    }
+
+    FlatHashTable(FlatHashTable&& other)
+        : ctrl(other.ctrl)
+        , data(other.data)
+        , capacity(other.capacity)
+        , count(other.count)
+        , empty_key(other.empty_key)
+    {
+        other.ctrl = nullptr;
+        other.data = nullptr;
+        other.capacity = 0;
+        other.count = 0;
+    }
+
+    FlatHashTable& operator=(FlatHashTable&& other)
+    {
+        if (this != &other)
+        {
+            destroy();
+
+            ctrl = other.ctrl;
+            data = other.data;
+            capacity = other.capacity;
+            count = other.count;
+            empty_key = other.empty_key;
+
+            other.ctrl = nullptr;
+            other.data = nullptr;
+            other.capacity = 0;
+            other.count = 0;
+        }
+
+        return *this;
+    }
+
+    FlatHashTable& operator=(const FlatHashTable& other)
+    {
+        if (this != &other)
+        {
+            FlatHashTable copy(other);
+            *this = std::move(copy);
+        }
+
+        return *this;
+    }
+
+    void clear()
+    {
+        if (count == 0)
+            return;
+
+        if (capacity > 32)
+        {
+            destroy();
+        }
+        else
+        {
+            destroyItems();
+            memset(ctrl, kCtrlEmpty, capacity);
+        }
+
+        count = 0;
+    }
+
+    Item* insert_unsafe(const Key& key)
+    {
+        // It is invalid to insert empty_key into the table; DenseHashMap rejects it and this table keeps the same contract
+        LUAU_ASSERT(!eq(key, empty_key));
+
+        size_t hash = hasher(key);
+        uint8_t h2 = secondaryHash(hash);
+
+        if (Item* item = findWithHash(key, hash, h2))
+            return item;
+
+        return insertNew(key, hash, h2);
+    }
+
+    const Item* find(const Key& key) const
+    {
+        if (count == 0)
+            return nullptr;
+        if (eq(key, empty_key))
+            return nullptr;
+
+        size_t hash = hasher(key);
+        return const_cast<FlatHashTable*>(this)->findWithHash(key, hash, secondaryHash(hash));
+    }
+
+    void rehash()
+    {
+        size_t newsize = capacity == 0 ? FlatHashGroup::kWidth : capacity * 2;
+
+        FlatHashTable newtable(empty_key, newsize);
+
+        for (size_t i = 0; i < capacity; ++i)
+        {
+            if (ctrl[i] != kCtrlEmpty)
+            {
+                size_t hash = hasher(data[i].first);
+                Item* item = newtable.insertNew(data[i].first, hash, secondaryHash(hash));
+                item->second = std::move(data[i].second);
+            }
+        }
+
+        LUAU_ASSERT(count == newtable.count);
+
+        *this = std::move(newtable);
+    }
+
+    void rehash_if_full(const Key& key)
+    {
+        if (count >= capacity * 7 / 8 && !find(key))
+            rehash();
+    }
+
+    const_iterator begin() const
+    {
+        return const_iterator(this, skipEmpty(0));
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator(this, capacity);
+    }
+
+    iterator begin()
+    {
+        return iterator(this, skipEmpty(0));
+    }
+
+    iterator end()
+    {
+        return iterator(this, capacity);
+    }
+
+    size_t size() const
+    {
+        return count;
+    }
+
+    class const_iterator
+    {
+    public:
+        using value_type = Item;
+        using reference = Item&;
+        using pointer = Item*;
+        using difference_type = ptrdiff_t;
+        using iterator_category = std::forward_iterator_tag;
+
+        const_iterator()
+            : set(nullptr)
+            , index(0)
+        {
+        }
+
+        const_iterator(const FlatHashTable* set, size_t index)
+            : set(set)
+            , index(index)
+        {
+        }
+
+        const Item& operator*() const
+        {
+            return set->data[index];
+        }
+
+        const Item* operator->() const
+        {
+            return &set->data[index];
+        }
+
+        bool operator==(const const_iterator& other) const
+        {
+            return set == other.set && index == other.index;
+        }
+
+        bool operator!=(const const_iterator& other) const
+        {
+            return set != other.set || index != other.index;
+        }
+
+        const_iterator& operator++()
+        {
+            index = set->skipEmpty(index + 1);
+            return *this;
+        }
+
+        const_iterator operator++(int)
+        {
+            const_iterator res = *this;
+            ++*this;
+            return res;
+        }
+
+    private:
+        const FlatHashTable* set;
+        size_t index;
+    };
+
+    class iterator
+    {
+    public:
+        using value_type = MutableItem;
+        using reference = MutableItem&;
+        using pointer = MutableItem*;
+        using difference_type = ptrdiff_t;
+        using iterator_category = std::forward_iterator_tag;
+
+        iterator()
+            : set(nullptr)
+            , index(0)
+        {
+        }
+
+        iterator(FlatHashTable* set, size_t index)
+            : set(set)
+            , index(index)
+        {
+        }
+
+        MutableItem& operator*() const
+        {
+            return *reinterpret_cast<MutableItem*>(&set->data[index]);
+        }
+
+        MutableItem* operator->() const
+        {
+            return reinterpret_cast<MutableItem*>(&set->data[index]);
+        }
+
+        bool operator==(const iterator& other) const
+        {
+            return set == other.set && index == other.index;
+        }
+
+        bool operator!=(const iterator& other) const
+        {
+            return set != other.set || index != other.index;
+        }
+
+        iterator& operator++()
+        {
+            index = set->skipEmpty(index + 1);
+            return *this;
+        }
+
+        iterator operator++(int)
+        {
+            iterator res = *this;
+            ++*this;
+            return res;
+        }
+
+    private:
+        FlatHashTable* set;
+        size_t index;
+    };
+
+private:
+    // Inserts a key that is known to be absent
+    Item* insertNew(const Key& key, size_t hash, uint8_t h2)
+    {
+        size_t groupmod = capacity / FlatHashGroup::kWidth - 1;
+        size_t group = hash & groupmod;
+
+        for (size_t probe = 0; probe <= groupmod; ++probe)
+        {
+            size_t base = group * FlatHashGroup::kWidth;
+
+            if (auto empty = FlatHashGroup(ctrl + base).matchEmpty())
+            {
+                size_t index = base + FlatHashGroup::slotOf(flatHashLowestBit(empty));
+
+                new (&data[index]) Item(key, Value());
+                ctrl[index] = h2;
+                count++;
+                return &data[index];
+            }
+
+            // Group is full, triangular probing visits every group once for power-of-two group counts
+            group = (group + probe + 1) & groupmod;
+        }
+
+        // Hash table is full - this should not happen
+        LUAU_ASSERT(false);
+        return nullptr;
+    }
+
+    static uint8_t secondaryHash(size_t hash)
+    {
+        // Group selection uses the low bits of the hash like DenseHashTable does, so the control byte is taken from the
+        // top bits of a multiplicative mix that depend on the whole hash value
+        uint64_t mixed = uint64_t(hash) * 0x9e3779b97f4a7c15ull;
+        return uint8_t(mixed >> 57);
+    }
+
+    Item* findWithHash(const Key& key, size_t hash, uint8_t h2)
+    {
+        if (capacity == 0)
+            return nullptr;
+
+        size_t groupmod = capacity / FlatHashGroup::kWidth - 1;
+        size_t group = hash & groupmod;
+
+        for (size_t probe = 0; probe <= groupmod; ++probe)
+        {
+            size_t base = group * FlatHashGroup::kWidth;
+            FlatHashGroup g(ctrl + base);
+
+            for (auto candidates = g.match(h2); candidates; candidates &= candidates - 1)
+            {
+                size_t index = base + FlatHashGroup::slotOf(flatHashLowestBit(candidates));
+
+                if (ctrl[index] == h2 && eq(data[index].first, key))
+                    return &data[index];
+            }
+
+            // Slots are never erased, so an empty slot in the group means the key was never inserted past it
+            if (g.matchEmpty())
+                return nullptr;
+
+            group = (group + probe + 1) & groupmod;
+        }
+
+        return nullptr;
+    }
+
+    size_t skipEmpty(size_t index) const
+    {
+        while (index < capacity && ctrl[index] == kCtrlEmpty)
+            index++;
+
+        return index;
+    }
+
+    void allocate(size_t buckets)
+    {
+        LUAU_ASSERT(buckets % FlatHashGroup::kWidth == 0);
+
+        ctrl = static_cast<uint8_t*>(::operator new(buckets));
+        memset(ctrl, kCtrlEmpty, buckets);
+
+        data = static_cast<Item*>(::operator new(sizeof(Item) * buckets));
+        capacity = buckets;
+    }
+
+    void destroyItems()
+    {
+        for (size_t i = 0; i < capacity; ++i)
+        {
+            if (ctrl[i] != kCtrlEmpty)
+                data[i].~Item();
+        }
+    }
+
+    void destroy()
+    {
+        if (!ctrl)
+            return;
+
+        destroyItems();
+
+        ::operator delete(ctrl);
+        ::operator delete(data);
+        ctrl = nullptr;
+        data = nullptr;
+
+        capacity = 0;
+        count = 0;
+    }
+
+    uint8_t* ctrl = nullptr;
+    Item* data = nullptr;
+    size_t capacity = 0;
+    size_t count = 0;
+    Key empty_key;
+    Hash hasher;
+    Eq eq;
+};
+
+} // namespace detail
+
+// A drop-in replacement for DenseHashMap for lookup-heavy maps. Instead of comparing keys slot by slot, it keeps a control
+// byte per slot and tests a whole group of them at once (with SSE2 where available), which keeps misses and collisions cheap.
+// Like DenseHashMap, it does not support erasing, and empty_key may not be inserted.
+template<typename Key, typename Value, typename Hash = detail::DenseHashDefault<Key>, typename Eq = std::equal_to<Key>>
+class FlatHashMap
+{
+    typedef detail::FlatHashTable<Key, Value, Hash, Eq> Impl;
+    Impl impl;
+
+public:
+    typedef typename Impl::const_iterator const_iterator;
+    typedef typename Impl::iterator iterator;
+
+    explicit FlatHashMap(const Key& empty_key, size_t buckets = 0)
+        : impl(empty_key, buckets)
+    {
+    }
+
+    void clear()
+    {
+        impl.clear();
+    }
+
+    // Note: this reference is invalidated by any insert operation (i.e. operator[])
+    Value& operator[](const Key& key)
+    {
+        impl.rehash_if_full(key);
+        return impl.insert_unsafe(key)->second;
+    }
+
+    // Note: this pointer is invalidated by any insert operation (i.e. operator[])
+    const Value* find(const Key& key) const
+    {
+        const std::pair<Key, Value>* result = impl.find(key);
+
+        return result ? &result->second : nullptr;
+    }
+
+    // Note: this pointer is invalidated by any insert operation (i.e. operator[])
+    Value* find(const Key& key)
+    {
+        const std::pair<Key, Value>* result = impl.find(key);
+
+        return result ? const_cast<Value*>(&result->second) : nullptr;
+    }
+
+    bool contains(const Key& key) const
+    {
+        return impl.find(key) != nullptr;
+    }
+
+    std::pair<Value&, bool> try_insert(const Key& key, const Value& value)
+    {
+        impl.rehash_if_full(key);
+
+        size_t before = impl.size();
+        std::pair<Key, Value>* slot = impl.insert_unsafe(key);
+
+        // Value is fresh if container count has increased
+        bool fresh = impl.size() > before;
+
+        if (fresh)
+            slot->second = value;
+
+        return std::make_pair(std::ref(slot->second), fresh);
+    }
+
+    size_t size() const
+    {
+        return impl.size();
+    }
+
+    bool empty() const
+    {
+        return impl.size() == 0;
+    }
+
+    const_iterator begin() const
+    {
+        return impl.begin();
+    }
+
+    const_iterator end() const
+    {
+        return impl.end();
+    }
+
+    iterator begin()
+    {
+        return impl.begin();
+    }
+
+    iterator end()
+    {
+        return impl.end();
+    }
+};
+
+} // namespace Luau
@@ -0,0 +1,27 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace Luau
+{
+
+// 64-bit FNV-1a; results are stored in persistent caches, so the function must stay stable across versions
+struct Fnv1aHash
+{
+    uint64_t value = 14695981039346656037ull;
+
+    void addBytes(const void* data, size_t size)
+    {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+
+        for (size_t i = 0; i < size; i++)
+        {
+            value ^= bytes[i];
+            value *= 1099511628211ull;
+        }
+    }
+};
+
+} // namespace Luau
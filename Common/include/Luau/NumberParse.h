@@ -0,0 +1,80 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#pragma once
+
+#include <stdint.h>
+
+namespace Luau
+{
+
+// Parses a decimal number ([+-]digits[.digits][(e|E)[+-]digits]) at the start of the string when the result can be computed exactly.
+// This is the case when the significand fits in 53 bits and the power of ten is at most 10^22; both are then exact doubles and a single
+// multiplication or division is correctly rounded (W. D. Clinger, How to Read Floating Point Numbers Accurately, 1990).
+// Returns the end of the number, or nullptr for all other inputs, including valid numbers that need more precision; callers should fall
+// back to strtod in that case.
+inline const char* parseDecimalFast(const char* s, double& result)
+{
+    static const double kPow10[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+    };
+
+    const char* p = s;
+
+    bool negative = *p == '-';
+    if (*p == '-' || *p == '+')
+        p++;
+
+    // up to 19 decimal digits always fit into 64 bits
+    uint64_t significand = 0;
+    int digits = 0;
+    int exponent = 0;
+
+    for (; unsigned(*p - '0') < 10; p++, digits++)
+        significand = significand * 10 + (*p - '0');
+
+    if (*p == '.')
+    {
+        p++;
+
+        for (; unsigned(*p - '0') < 10; p++, digits++, exponent--)
+            significand = significand * 10 + (*p - '0');
+    }
+
+    if (digits == 0 || digits > 19)
+        return nullptr;
+
+    if (*p == 'e' || *p == 'E')
+    {
+        p++;
+
+        bool negexp = *p == '-';
+        if (*p == '-' || *p == '+')
+            p++;
+
+        if (unsigned(*p - '0') >= 10)
+            return nullptr;
+
+        int expvalue = 0;
+
+        // large exponents are outside of the fast path anyway, so we only need to avoid overflow
+        for (; unsigned(*p - '0') < 10; p++)
+            if (expvalue < 10000)
+                expvalue = expvalue * 10 + (*p - '0');
+
+        exponent += negexp ? -expvalue : expvalue;
+    }
+
+    if (significand > (1ull << 53) || exponent < -22 || exponent > 22)
+        return nullptr;
+
+    double value = double(significand);
+
+    if (exponent < 0)
+        value /= kPow10[-exponent];
+    else
+        value *= kPow10[exponent];
+
+    result = negative ? -value : value;
+    return p;
+}
+
+} // namespace Luau
@@ -75,6 +75,15 @@ public:
     void foldJumps();
     void expandJumps();
 
+    // removes stores into registers that are overwritten before being read; debug locals of the function must be recorded before this
+    void removeDeadStores();
+
+    // replaces common instruction sequences with superinstructions; has to run after jumps are expanded
+    void fuseInstructions();
+
+    // turns calls that are directly followed by a return of all their results into tail calls
+    void formTailCalls();
+
     void setFunctionTypeInfo(std::string value);
 
     void setDebugFunctionName(StringRef name);
@@ -136,9 +145,15 @@ public:
 
     static std::string getError(const std::string& message);
 
+    // compresses bytecode blob using LZ4 block format; luau_load accepts both compressed and uncompressed blobs
+    static std::string compress(const std::string& bytecode);
+
     static uint8_t getVersion();
     static uint8_t getTypeEncodingVersion();
 
+    // returns the mnemonic used in bytecode dumps, or nullptr for unknown opcodes
+    static const char* getOpcodeName(uint8_t op);
+
 private:
     struct Constant
     {
@@ -4,15 +4,34 @@
 #include "Luau/ParseOptions.h"
 #include "Luau/Location.h"
 #include "Luau/StringUtils.h"
+#include "Luau/Bytecode.h"
 #include "Luau/Common.h"
+#include "Luau/DenseHash.h"
 
 namespace Luau
 {
 class AstNameTable;
+struct AstLocal;
 struct ParseResult;
 class BytecodeBuilder;
 class BytecodeEncoder;
 
+// Note: this structure is duplicated in luacode.h, don't forget to change these in sync!
+struct CompileConstant
+{
+    // 0 - unknown, 1 - nil, 2 - boolean, 3 - number, 4 - string
+    int type = 0;
+    int valueBoolean = 0;
+    double valueNumber = 0.0;
+
+    // string data has to remain valid until the compilation is finished
+    const char* valueString = nullptr;
+    size_t stringLength = 0;
+};
+
+// fills 'constant' with the value of field 'member' of the module returned by require(path), when it's known
+using RequireConstantCallback = void (*)(void* context, const char* path, const char* member, CompileConstant* constant);
+
 // Note: this structure is duplicated in luacode.h, don't forget to change these in sync!
 struct CompileOptions
 {
@@ -40,6 +59,19 @@ struct CompileOptions
 
     // null-terminated array of globals that are mutable; disables the import optimization for fields accessed through these
     const char* const* mutableGlobals = nullptr;
+
+    // zero-terminated array of lines where functions that are hot in an execution profile are defined (see Proto::linedefined)
+    // when set, hot functions get higher inlining and loop unrolling thresholds, and other functions don't inline calls or unroll loops
+    const int* hotFunctions = nullptr;
+
+    // whole-program compilation: fields read from a local initialized with require("path") are constant folded using the callback
+    // this assumes that the fields of the module result are not modified at runtime
+    RequireConstantCallback requireConstantCb = nullptr;
+    void* requireConstantContext = nullptr;
+
+    // null-terminated array of global functions ("name" or "library.name") that are compiled as fast calls to host builtins
+    // the function at index i gets builtin id LBF_USER_FIRST + i, and the host registers its implementation with lua_setuserbuiltin
+    const char* const* userBuiltins = nullptr;
 };
 
 class CompileError : public std::exception
@@ -60,8 +92,13 @@ private:
     std::string message;
 };
 
+// types of function arguments inferred by the type checker (see getInferredArgumentTypes in Luau.Analysis)
+// they are used as function type info for arguments without annotations; CodeGen still checks argument types on entry
+using InferredTypes = DenseHashMap<const AstLocal*, LuauBytecodeType>;
+
 // compiles bytecode into bytecode builder using either a pre-parsed AST or parsing it from source; throws on errors
-void compileOrThrow(BytecodeBuilder& bytecode, const ParseResult& parseResult, const AstNameTable& names, const CompileOptions& options = {});
+void compileOrThrow(BytecodeBuilder& bytecode, const ParseResult& parseResult, const AstNameTable& names, const CompileOptions& options = {},
+    const InferredTypes* inferredTypes = nullptr);
 void compileOrThrow(BytecodeBuilder& bytecode, const std::string& source, const CompileOptions& options = {}, const ParseOptions& parseOptions = {});
 
 // compiles bytecode into a bytecode blob, that either contains the valid bytecode or an encoded error that luau_load can decode
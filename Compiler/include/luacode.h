@@ -8,6 +8,23 @@
 #define LUACODE_API extern
 #endif
 
+typedef struct lua_CompileConstant lua_CompileConstant;
+
+struct lua_CompileConstant
+{
+    // 0 - unknown, 1 - nil, 2 - boolean, 3 - number, 4 - string
+    int type;
+    int valueBoolean;
+    double valueNumber;
+
+    // string data has to remain valid until the compilation is finished
+    const char* valueString;
+    size_t stringLength;
+};
+
+// fills 'constant' with the value of field 'member' of the module returned by require(path), when it's known
+typedef void (*lua_RequireConstantCallback)(void* context, const char* path, const char* member, lua_CompileConstant* constant);
+
 typedef struct lua_CompileOptions lua_CompileOptions;
 
 struct lua_CompileOptions
@@ -36,6 +53,19 @@ struct lua_CompileOptions
 
     // null-terminated array of globals that are mutable; disables the import optimization for fields accessed through these
     const char* const* mutableGlobals;
+
+    // zero-terminated array of lines where functions that are hot in an execution profile are defined (see Proto::linedefined)
+    // when set, hot functions get higher inlining and loop unrolling thresholds, and other functions don't inline calls or unroll loops
+    const int* hotFunctions;
+
+    // whole-program compilation: fields read from a local initialized with require("path") are constant folded using the callback
+    // this assumes that the fields of the module result are not modified at runtime
+    lua_RequireConstantCallback requireConstantCb;
+    void* requireConstantContext;
+
+    // null-terminated array of global functions ("name" or "library.name") that are compiled as fast calls to host builtins
+    // the function at index i gets builtin id LBF_USER_FIRST + i, and the host registers its implementation with lua_setuserbuiltin
+    const char* const* userBuiltins;
 };
 
 // compile source to bytecode; when source compilation fails, the resulting bytecode contains the encoded error. use free() to destroy
@@ -4,6 +4,8 @@
 #include "Luau/Bytecode.h"
 #include "Luau/Compiler.h"
 
+#include <string.h>
+
 namespace Luau
 {
 namespace Compile
@@ -38,8 +40,29 @@ Builtin getBuiltin(AstExpr* node, const DenseHashMap<AstName, Global>& globals,
     }
 }
 
+static bool isUserBuiltin(const Builtin& builtin, const char* name)
+{
+    const char* dot = strchr(name, '.');
+
+    if (!dot)
+        return builtin.isGlobal(name);
+
+    size_t length = dot - name;
+
+    return builtin.object.value && strncmp(builtin.object.value, name, length) == 0 && builtin.object.value[length] == 0 &&
+           builtin.method == dot + 1;
+}
+
 static int getBuiltinFunctionId(const Builtin& builtin, const CompileOptions& options)
 {
+    // host builtins take precedence so that the host can replace library functions with its own implementations
+    if (options.userBuiltins)
+    {
+        for (int i = 0; options.userBuiltins[i] && LBF_USER_FIRST + i <= LBF_USER_LAST; ++i)
+            if (isUserBuiltin(builtin, options.userBuiltins[i]))
+                return LBF_USER_FIRST + i;
+    }
+
     if (builtin.isGlobal("assert"))
         return LBF_ASSERT;
 
@@ -134,6 +157,8 @@ static int getBuiltinFunctionId(const Builtin& builtin, const CompileOptions& op
             return LBF_MATH_SIGN;
         if (builtin.method == "round")
             return LBF_MATH_ROUND;
+        if (builtin.method == "noise")
+            return LBF_MATH_NOISE;
     }
 
     if (builtin.object == "bit32")
@@ -218,6 +243,10 @@ static int getBuiltinFunctionId(const Builtin& builtin, const CompileOptions& op
             return LBF_BUFFER_READF64;
         if (builtin.method == "writef64")
             return LBF_BUFFER_WRITEF64;
+        if (builtin.method == "find")
+            return LBF_BUFFER_FIND;
+        if (builtin.method == "equal")
+            return LBF_BUFFER_EQUAL;
     }
 
     if (options.vectorCtor)
@@ -283,6 +312,10 @@ void analyzeBuiltins(DenseHashMap<AstExprCall*, int>& result, const DenseHashMap
 
 BuiltinInfo getBuiltinInfo(int bfid)
 {
+    // signatures of host builtins are only known at runtime
+    if (bfid >= LBF_USER_FIRST)
+        return {-1, -1};
+
     switch (LuauBuiltinFunction(bfid))
     {
     case LBF_NONE:
@@ -454,6 +487,15 @@ BuiltinInfo getBuiltinInfo(int bfid)
     case LBF_BUFFER_WRITEF32:
     case LBF_BUFFER_WRITEF64:
         return {3, 0, BuiltinInfo::Flag_NoneSafe};
+
+    case LBF_BUFFER_FIND:
+        return {3, 1, BuiltinInfo::Flag_NoneSafe};
+
+    case LBF_BUFFER_EQUAL:
+        return {5, 1, BuiltinInfo::Flag_NoneSafe};
+
+    case LBF_MATH_NOISE:
+        return {-1, 1}; // 1, 2 or 3 parameters
     };
 
     LUAU_UNREACHABLE();
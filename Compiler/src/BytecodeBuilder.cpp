@@ -7,6 +7,9 @@
 #include <algorithm>
 #include <string.h>
 
+LUAU_FASTFLAGVARIABLE(LuauCompileSuperinstructions, false)
+LUAU_FASTFLAGVARIABLE(LuauCompileTailCalls, false)
+
 namespace Luau
 {
 
@@ -133,6 +136,52 @@ static int getJumpTarget(uint32_t insn, uint32_t pc)
         return -1;
 }
 
+// Instructions that only write register A, without reading any registers and without running any user code
+static bool isRegisterLoad(uint32_t insn)
+{
+    switch (LUAU_INSN_OP(insn))
+    {
+    case LOP_LOADNIL:
+    case LOP_LOADN:
+    case LOP_LOADK:
+    case LOP_LOADKX:
+    case LOP_GETUPVAL:
+    case LOP_NEWTABLE:
+    case LOP_DUPTABLE:
+    case LOP_DUPCLOSURE:
+        return true;
+
+    case LOP_LOADB:
+        return LUAU_INSN_C(insn) == 0;
+
+    case LOP_MOVE:
+        return LUAU_INSN_A(insn) != LUAU_INSN_B(insn);
+
+    default:
+        return false;
+    }
+}
+
+// Store that can be removed without changing the behavior: values of dead stores are never observed
+static bool isRemovableStore(uint32_t insn)
+{
+    switch (LUAU_INSN_OP(insn))
+    {
+    case LOP_LOADNIL:
+    case LOP_LOADN:
+    case LOP_LOADK:
+    case LOP_LOADKX:
+    case LOP_MOVE:
+        return true;
+
+    case LOP_LOADB:
+        return LUAU_INSN_C(insn) == 0;
+
+    default:
+        return false;
+    }
+}
+
 bool BytecodeBuilder::StringRef::operator==(const StringRef& other) const
 {
     return (data && other.data) ? (length == other.length && memcmp(data, other.data, length) == 0) : (data == other.data);
@@ -937,6 +986,129 @@ uint32_t BytecodeBuilder::getStringHash(StringRef key)
     return h;
 }
 
+void BytecodeBuilder::removeDeadStores()
+{
+    // long jumps are expanded into trampolines that aren't tracked in the jump list
+    if (hasLongJumps)
+        return;
+
+    std::vector<uint8_t> removed(insns.size(), 0);
+    bool changed = false;
+
+    for (size_t i = 0; i < insns.size();)
+    {
+        uint32_t insn = insns[i];
+        int oplen = getOpLength(LuauOpcode(LUAU_INSN_OP(insn)));
+        size_t next = i + oplen;
+
+        // self-moves and register stores that are immediately overwritten by the next instruction have no effect
+        // instructions are only removed when the next one is on the same line, so that every line keeps its instructions for breakpoints
+        if (isRemovableStore(insn) && next < insns.size() && lines[i] == lines[next])
+        {
+            uint32_t nextInsn = insns[next];
+
+            bool selfMove = LUAU_INSN_OP(insn) == LOP_MOVE && LUAU_INSN_A(insn) == LUAU_INSN_B(insn);
+            bool overwritten = isRegisterLoad(nextInsn) && LUAU_INSN_A(nextInsn) == LUAU_INSN_A(insn) &&
+                               (LUAU_INSN_OP(nextInsn) != LOP_MOVE || LUAU_INSN_B(nextInsn) != LUAU_INSN_A(insn));
+
+            if (selfMove || overwritten)
+            {
+                for (size_t j = i; j < next; ++j)
+                    removed[j] = true;
+
+                changed = true;
+            }
+        }
+
+        i = next;
+    }
+
+    if (!changed)
+        return;
+
+    // remap[oldpc] = newpc; removed instructions map to the instruction that follows them, which makes jumps to them fall through
+    std::vector<uint32_t> remap(insns.size() + 1);
+    uint32_t newpc = 0;
+
+    for (size_t i = 0; i < insns.size(); ++i)
+    {
+        remap[i] = newpc;
+        newpc += !removed[i];
+    }
+
+    remap[insns.size()] = newpc;
+
+    // jumps with a D offset are tracked in the jump list; skip offsets of LOADB and FASTCALL are only stored in the instructions
+    for (size_t i = 0; i < insns.size();)
+    {
+        uint32_t& insn = insns[i];
+        LuauOpcode op = LuauOpcode(LUAU_INSN_OP(insn));
+
+        if (!removed[i] && (isSkipC(op) || isFastCall(op)))
+        {
+            int target = getJumpTarget(insn, uint32_t(i));
+
+            if (target >= 0)
+            {
+                int newoffset = int(remap[target]) - int(remap[i]) - (isFastCall(op) ? 2 : 1);
+                LUAU_ASSERT(newoffset >= 0 && newoffset <= 255);
+
+                insn &= 0xffffff;
+                insn |= uint32_t(newoffset) << 24;
+            }
+        }
+
+        i += getOpLength(op);
+    }
+
+    for (Jump& jump : jumps)
+    {
+        LUAU_ASSERT(!removed[jump.source]);
+
+        jump.source = remap[jump.source];
+        jump.target = remap[jump.target];
+    }
+
+    size_t write = 0;
+
+    for (size_t i = 0; i < insns.size(); ++i)
+    {
+        if (removed[i])
+            continue;
+
+        insns[write] = insns[i];
+        lines[write] = lines[i];
+        write++;
+    }
+
+    insns.resize(write);
+    lines.resize(write);
+
+    for (Jump& jump : jumps)
+    {
+        uint32_t& insn = insns[jump.source];
+
+        // foldJumps can replace jumps to RETURN with a copy of RETURN
+        if (!isJumpD(LuauOpcode(LUAU_INSN_OP(insn))))
+            continue;
+
+        int offset = int(jump.target) - int(jump.source) - 1;
+        LUAU_ASSERT(int16_t(offset) == offset);
+
+        insn &= 0xffff;
+        insn |= uint16_t(offset) << 16;
+    }
+
+    for (DebugLocal& local : debugLocals)
+    {
+        local.startpc = remap[local.startpc];
+        local.endpc = remap[local.endpc];
+    }
+
+    for (std::pair<uint32_t, uint32_t>& remark : debugRemarks)
+        remark.first = remap[remark.first];
+}
+
 void BytecodeBuilder::foldJumps()
 {
     // if our function has long jumps, some processing below can make jump instructions not-jumps (e.g. JUMP->RETURN)
@@ -981,6 +1153,86 @@ void BytecodeBuilder::foldJumps()
     }
 }
 
+void BytecodeBuilder::fuseInstructions()
+{
+    // instructions that are jumped to have to start at an instruction boundary, so they can't be the second half of a superinstruction
+    std::vector<uint8_t> insntargets(insns.size() + 1, 0);
+
+    for (size_t i = 0; i < insns.size();)
+    {
+        uint32_t insn = insns[i];
+        LuauOpcode op = LuauOpcode(LUAU_INSN_OP(insn));
+
+        int target = getJumpTarget(insn, uint32_t(i));
+
+        if (target >= 0)
+        {
+            LUAU_ASSERT(size_t(target) <= insns.size());
+            insntargets[target] = true;
+        }
+
+        i += getOpLength(op);
+    }
+
+    for (size_t i = 0; i < insns.size();)
+    {
+        uint32_t insn = insns[i];
+        LuauOpcode op = LuauOpcode(LUAU_INSN_OP(insn));
+
+        // instructions on the same line keep the line info of the fused instruction accurate for both halves
+        if (op == LOP_MOVE && i + 1 < insns.size() && LUAU_INSN_OP(insns[i + 1]) == LOP_MOVE && !insntargets[i + 1] && lines[i] == lines[i + 1])
+        {
+            uint32_t next = insns[i + 1];
+
+            insns[i] = (insn & ~0xffu) | LOP_MOVE2;
+            insns[i + 1] = LUAU_INSN_A(next) | (LUAU_INSN_B(next) << 8);
+
+            i += 2;
+            continue;
+        }
+
+        i += getOpLength(op);
+    }
+}
+
+void BytecodeBuilder::formTailCalls()
+{
+    // calls that serve as a fallback for FASTCALL have to stay as CALL since the builtin dispatch reads their operands
+    std::vector<uint8_t> fastcalltargets(insns.size(), 0);
+
+    for (size_t i = 0; i < insns.size();)
+    {
+        uint32_t insn = insns[i];
+        LuauOpcode op = LuauOpcode(LUAU_INSN_OP(insn));
+
+        if (isFastCall(op))
+        {
+            size_t call = i + LUAU_INSN_C(insn) + 1;
+            LUAU_ASSERT(call < insns.size() && LUAU_INSN_OP(insns[call]) == LOP_CALL);
+            fastcalltargets[call] = true;
+        }
+
+        i += getOpLength(op);
+    }
+
+    for (size_t i = 0; i < insns.size();)
+    {
+        uint32_t insn = insns[i];
+        LuauOpcode op = LuauOpcode(LUAU_INSN_OP(insn));
+
+        // CALL A B 0 followed by RETURN A 0 returns everything the callee returns; other paths that jump to the RETURN are unaffected
+        if (op == LOP_CALL && LUAU_INSN_C(insn) == 0 && !fastcalltargets[i] && i + 1 < insns.size())
+        {
+            uint32_t next = insns[i + 1];
+
+            if (LUAU_INSN_OP(next) == LOP_RETURN && LUAU_INSN_A(next) == LUAU_INSN_A(insn) && LUAU_INSN_B(next) == 0)
+                insns[i] = (insn & ~0xffu) | LOP_TAILCALL;
+        }
+
+        i += getOpLength(op);
+    }
+}
+
 void BytecodeBuilder::expandJumps()
 {
     if (!hasLongJumps)
@@ -1119,12 +1371,285 @@ std::string BytecodeBuilder::getError(const std::string& message)
     return result;
 }
 
+std::string BytecodeBuilder::compress(const std::string& bytecode)
+{
+    // LZ4 block format: a sequence of [token, literal length, literals, match offset, match length]
+    // token has 4 bits of literal length and 4 bits of match length minus 4; lengths of 15 and above are continued by 255-terminated bytes
+    // for compatibility with LZ4 decoders, the last 5 bytes are always literals and the last match starts at least 12 bytes before the end
+    const size_t kMinMatch = 4;
+    const size_t kLastLiterals = 5;
+    const size_t kMatchLimit = 12;
+    const size_t kMaxOffset = 65535;
+    const int kHashBits = 12;
+
+    const unsigned char* data = reinterpret_cast<const unsigned char*>(bytecode.data());
+    size_t size = bytecode.size();
+
+    std::string result;
+    result.reserve(size / 2 + 16);
+
+    writeByte(result, LBC_COMPRESSED);
+    writeVarInt(result, unsigned(size));
+
+    auto writeLength = [&](size_t length) {
+        for (; length >= 255; length -= 255)
+            writeByte(result, 255);
+
+        writeByte(result, uint8_t(length));
+    };
+
+    auto writeSequence = [&](size_t literalStart, size_t literalEnd, size_t offset, size_t matchLength) {
+        size_t literalLength = literalEnd - literalStart;
+
+        uint8_t token = uint8_t((literalLength < 15 ? literalLength : 15) << 4);
+
+        if (matchLength)
+            token |= matchLength - kMinMatch < 15 ? uint8_t(matchLength - kMinMatch) : 15;
+
+        writeByte(result, token);
+
+        if (literalLength >= 15)
+            writeLength(literalLength - 15);
+
+        result.append(reinterpret_cast<const char*>(data + literalStart), literalLength);
+
+        if (matchLength)
+        {
+            writeByte(result, uint8_t(offset & 0xff));
+            writeByte(result, uint8_t(offset >> 8));
+
+            if (matchLength - kMinMatch >= 15)
+                writeLength(matchLength - kMinMatch - 15);
+        }
+    };
+
+    // positions of the last occurrence of each 4-byte sequence hash, offset by 1 so that 0 means no entry
+    std::vector<uint32_t> table(1 << kHashBits, 0);
+
+    size_t literalStart = 0;
+    size_t pos = 0;
+
+    while (size >= kMatchLimit && pos + kMatchLimit <= size)
+    {
+        uint32_t sequence;
+        memcpy(&sequence, data + pos, sizeof(sequence));
+
+        uint32_t hash = (sequence * 2654435761u) >> (32 - kHashBits);
+        size_t candidate = table[hash];
+        table[hash] = uint32_t(pos + 1);
+
+        if (candidate == 0 || pos - (candidate - 1) > kMaxOffset || memcmp(data + candidate - 1, data + pos, kMinMatch) != 0)
+        {
+            pos++;
+            continue;
+        }
+
+        size_t matchStart = candidate - 1;
+        size_t matchLength = kMinMatch;
+
+        while (pos + matchLength < size - kLastLiterals && data[matchStart + matchLength] == data[pos + matchLength])
+            matchLength++;
+
+        writeSequence(literalStart, pos, pos - matchStart, matchLength);
+
+        pos += matchLength;
+        literalStart = pos;
+    }
+
+    // the final sequence only has literals
+    writeSequence(literalStart, size, 0, 0);
+
+    return result;
+}
+
 uint8_t BytecodeBuilder::getVersion()
 {
     // This function usually returns LBC_VERSION_TARGET but may sometimes return a higher number (within LBC_VERSION_MIN/MAX) under fast flags
+    if (FFlag::LuauCompileSuperinstructions || FFlag::LuauCompileTailCalls)
+        return 6;
+
     return LBC_VERSION_TARGET;
 }
 
+const char* BytecodeBuilder::getOpcodeName(uint8_t op)
+{
+    switch (LuauOpcode(op))
+    {
+    case LOP_NOP:
+        return "NOP";
+    case LOP_BREAK:
+        return "BREAK";
+    case LOP_LOADNIL:
+        return "LOADNIL";
+    case LOP_LOADB:
+        return "LOADB";
+    case LOP_LOADN:
+        return "LOADN";
+    case LOP_LOADK:
+        return "LOADK";
+    case LOP_MOVE:
+        return "MOVE";
+    case LOP_GETGLOBAL:
+        return "GETGLOBAL";
+    case LOP_SETGLOBAL:
+        return "SETGLOBAL";
+    case LOP_GETUPVAL:
+        return "GETUPVAL";
+    case LOP_SETUPVAL:
+        return "SETUPVAL";
+    case LOP_CLOSEUPVALS:
+        return "CLOSEUPVALS";
+    case LOP_GETIMPORT:
+        return "GETIMPORT";
+    case LOP_GETTABLE:
+        return "GETTABLE";
+    case LOP_SETTABLE:
+        return "SETTABLE";
+    case LOP_GETTABLEKS:
+        return "GETTABLEKS";
+    case LOP_SETTABLEKS:
+        return "SETTABLEKS";
+    case LOP_GETTABLEN:
+        return "GETTABLEN";
+    case LOP_SETTABLEN:
+        return "SETTABLEN";
+    case LOP_NEWCLOSURE:
+        return "NEWCLOSURE";
+    case LOP_NAMECALL:
+        return "NAMECALL";
+    case LOP_CALL:
+        return "CALL";
+    case LOP_RETURN:
+        return "RETURN";
+    case LOP_JUMP:
+        return "JUMP";
+    case LOP_JUMPBACK:
+        return "JUMPBACK";
+    case LOP_JUMPIF:
+        return "JUMPIF";
+    case LOP_JUMPIFNOT:
+        return "JUMPIFNOT";
+    case LOP_JUMPIFEQ:
+        return "JUMPIFEQ";
+    case LOP_JUMPIFLE:
+        return "JUMPIFLE";
+    case LOP_JUMPIFLT:
+        return "JUMPIFLT";
+    case LOP_JUMPIFNOTEQ:
+        return "JUMPIFNOTEQ";
+    case LOP_JUMPIFNOTLE:
+        return "JUMPIFNOTLE";
+    case LOP_JUMPIFNOTLT:
+        return "JUMPIFNOTLT";
+    case LOP_ADD:
+        return "ADD";
+    case LOP_SUB:
+        return "SUB";
+    case LOP_MUL:
+        return "MUL";
+    case LOP_DIV:
+        return "DIV";
+    case LOP_MOD:
+        return "MOD";
+    case LOP_POW:
+        return "POW";
+    case LOP_ADDK:
+        return "ADDK";
+    case LOP_SUBK:
+        return "SUBK";
+    case LOP_MULK:
+        return "MULK";
+    case LOP_DIVK:
+        return "DIVK";
+    case LOP_MODK:
+        return "MODK";
+    case LOP_POWK:
+        return "POWK";
+    case LOP_AND:
+        return "AND";
+    case LOP_OR:
+        return "OR";
+    case LOP_ANDK:
+        return "ANDK";
+    case LOP_ORK:
+        return "ORK";
+    case LOP_CONCAT:
+        return "CONCAT";
+    case LOP_NOT:
+        return "NOT";
+    case LOP_MINUS:
+        return "MINUS";
+    case LOP_LENGTH:
+        return "LENGTH";
+    case LOP_NEWTABLE:
+        return "NEWTABLE";
+    case LOP_DUPTABLE:
+        return "DUPTABLE";
+    case LOP_SETLIST:
+        return "SETLIST";
+    case LOP_FORNPREP:
+        return "FORNPREP";
+    case LOP_FORNLOOP:
+        return "FORNLOOP";
+    case LOP_FORGLOOP:
+        return "FORGLOOP";
+    case LOP_FORGPREP_INEXT:
+        return "FORGPREP_INEXT";
+    case LOP_DEP_FORGLOOP_INEXT:
+        return "DEP_FORGLOOP_INEXT";
+    case LOP_FORGPREP_NEXT:
+        return "FORGPREP_NEXT";
+    case LOP_NATIVECALL:
+        return "NATIVECALL";
+    case LOP_GETVARARGS:
+        return "GETVARARGS";
+    case LOP_DUPCLOSURE:
+        return "DUPCLOSURE";
+    case LOP_PREPVARARGS:
+        return "PREPVARARGS";
+    case LOP_LOADKX:
+        return "LOADKX";
+    case LOP_JUMPX:
+        return "JUMPX";
+    case LOP_FASTCALL:
+        return "FASTCALL";
+    case LOP_COVERAGE:
+        return "COVERAGE";
+    case LOP_CAPTURE:
+        return "CAPTURE";
+    case LOP_SUBRK:
+        return "SUBRK";
+    case LOP_DIVRK:
+        return "DIVRK";
+    case LOP_FASTCALL1:
+        return "FASTCALL1";
+    case LOP_FASTCALL2:
+        return "FASTCALL2";
+    case LOP_FASTCALL2K:
+        return "FASTCALL2K";
+    case LOP_FORGPREP:
+        return "FORGPREP";
+    case LOP_JUMPXEQKNIL:
+        return "JUMPXEQKNIL";
+    case LOP_JUMPXEQKB:
+        return "JUMPXEQKB";
+    case LOP_JUMPXEQKN:
+        return "JUMPXEQKN";
+    case LOP_JUMPXEQKS:
+        return "JUMPXEQKS";
+    case LOP_IDIV:
+        return "IDIV";
+    case LOP_IDIVK:
+        return "IDIVK";
+    case LOP_MOVE2:
+        return "MOVE2";
+    case LOP_TAILCALL:
+        return "TAILCALL";
+    default:
+        return nullptr;
+    }
+}
+
 uint8_t BytecodeBuilder::getTypeEncodingVersion()
 {
     return LBC_TYPE_VERSION;
@@ -1198,6 +1723,14 @@ void BytecodeBuilder::validateInstructions() const
             VREG(LUAU_INSN_B(insn));
             break;
 
+        case LOP_MOVE2:
+            VREG(LUAU_INSN_A(insn));
+            VREG(LUAU_INSN_B(insn));
+            VREG(insns[i + 1] & 0xff);
+            VREG((insns[i + 1] >> 8) & 0xff);
+            LUAU_ASSERT((insns[i + 1] >> 16) == 0);
+            break;
+
         case LOP_GETGLOBAL:
         case LOP_SETGLOBAL:
             VREG(LUAU_INSN_A(insn));
@@ -1267,7 +1800,7 @@ void BytecodeBuilder::validateInstructions() const
             VREG(LUAU_INSN_A(insn));
             VREG(LUAU_INSN_B(insn));
             VCONST(insns[i + 1], String);
-            LUAU_ASSERT(LUAU_INSN_OP(insns[i + 2]) == LOP_CALL);
+            LUAU_ASSERT(LUAU_INSN_OP(insns[i + 2]) == LOP_CALL || LUAU_INSN_OP(insns[i + 2]) == LOP_TAILCALL);
             break;
 
         case LOP_CALL:
@@ -1280,6 +1813,17 @@ void BytecodeBuilder::validateInstructions() const
         }
         break;
 
+        case LOP_TAILCALL:
+        {
+            int nparams = LUAU_INSN_B(insn) - 1;
+            VREG(LUAU_INSN_A(insn));
+            VREGRANGE(LUAU_INSN_A(insn) + 1, nparams); // 1..nparams
+            LUAU_ASSERT(LUAU_INSN_C(insn) == 0);
+            LUAU_ASSERT(i + 1 < insns.size() && LUAU_INSN_OP(insns[i + 1]) == LOP_RETURN);
+            LUAU_ASSERT(LUAU_INSN_A(insns[i + 1]) == LUAU_INSN_A(insn) && LUAU_INSN_B(insns[i + 1]) == 0);
+        }
+        break;
+
         case LOP_RETURN:
         {
             int nresults = LUAU_INSN_B(insn) - 1;
@@ -1589,7 +2133,7 @@ void BytecodeBuilder::validateVariadic() const
             LUAU_ASSERT(!insntargets[i]);
         }
 
-        if (op == LOP_CALL)
+        if (op == LOP_CALL || op == LOP_TAILCALL)
         {
             // note: calls may end one variadic sequence and start a new one
 
@@ -1791,6 +2335,11 @@ void BytecodeBuilder::dumpInstruction(const uint32_t* code, std::string& result,
         formatAppend(result, "MOVE R%d R%d\n", LUAU_INSN_A(insn), LUAU_INSN_B(insn));
         break;
 
+    case LOP_MOVE2:
+        formatAppend(result, "MOVE2 R%d R%d R%d R%d\n", LUAU_INSN_A(insn), LUAU_INSN_B(insn), *code & 0xff, (*code >> 8) & 0xff);
+        code++;
+        break;
+
     case LOP_GETGLOBAL:
         formatAppend(result, "GETGLOBAL R%d K%d [", LUAU_INSN_A(insn), *code);
         dumpConstant(result, *code);
@@ -1869,6 +2418,10 @@ void BytecodeBuilder::dumpInstruction(const uint32_t* code, std::string& result,
         formatAppend(result, "CALL R%d %d %d\n", LUAU_INSN_A(insn), LUAU_INSN_B(insn) - 1, LUAU_INSN_C(insn) - 1);
         break;
 
+    case LOP_TAILCALL:
+        formatAppend(result, "TAILCALL R%d %d\n", LUAU_INSN_A(insn), LUAU_INSN_B(insn) - 1);
+        break;
+
     case LOP_RETURN:
         formatAppend(result, "RETURN R%d %d\n", LUAU_INSN_A(insn), LUAU_INSN_B(insn) - 1);
         break;
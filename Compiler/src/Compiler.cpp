@@ -1,6 +1,7 @@
 // This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
 #include "Luau/Compiler.h"
 
+#include "Luau/AstFingerprint.h"
 #include "Luau/Parser.h"
 #include "Luau/BytecodeBuilder.h"
 #include "Luau/Common.h"
@@ -16,6 +17,7 @@
 #include <algorithm>
 #include <bitset>
 #include <memory>
+#include <unordered_map>
 
 #include <math.h>
 
@@ -26,6 +28,15 @@ LUAU_FASTINTVARIABLE(LuauCompileInlineThreshold, 25)
 LUAU_FASTINTVARIABLE(LuauCompileInlineThresholdMaxBoost, 300)
 LUAU_FASTINTVARIABLE(LuauCompileInlineDepth, 5)
 
+LUAU_FASTINTVARIABLE(LuauCompileProfileHotThresholdScale, 300)
+
+LUAU_FASTFLAG(LuauCompileSuperinstructions)
+LUAU_FASTFLAG(LuauCompileTailCalls)
+LUAU_FASTFLAGVARIABLE(LuauCompileDedupFunctions, false)
+LUAU_FASTFLAGVARIABLE(LuauCompileDeadStores, false)
+LUAU_FASTFLAGVARIABLE(LuauCompileLoopClosures, false)
+LUAU_FASTFLAGVARIABLE(LuauCompileSelectVararg, false)
+
 namespace Luau
 {
 
@@ -36,6 +47,9 @@ static const uint32_t kMaxUpvalueCount = 200;
 static const uint32_t kMaxLocalCount = 200;
 static const uint32_t kMaxInstructionCount = 1'000'000'000;
 
+// closures hoisted out of a loop keep their registers for the entire loop, so we limit the extra register pressure
+static const size_t kMaxLoopClosures = 4;
+
 static const uint8_t kInvalidReg = 255;
 
 CompileError::CompileError(const Location& location, const std::string& message)
@@ -101,6 +115,8 @@ struct Compiler
         , tableShapes(nullptr)
         , builtins(nullptr)
         , typeMap(nullptr)
+        , requireMembers(nullptr)
+        , duplicateFunctions(nullptr)
     {
         // preallocate some buffers that are very likely to grow anyway; this works around std::vector's inefficient growth policy for small arrays
         localStack.reserve(16);
@@ -197,6 +213,8 @@ struct Compiler
 
         RegScope rs(this);
 
+        setProfileHotness(func);
+
         bool self = func->self != 0;
         uint32_t fid = bytecode.beginFunction(uint8_t(self + func->args.size), func->vararg);
 
@@ -254,6 +272,17 @@ struct Compiler
 
         popLocals(0);
 
+        // note: this runs after all debug locals of the function are recorded, since instruction removal needs to update their ranges
+        if (options.optimizationLevel >= 1 && FFlag::LuauCompileDeadStores)
+            bytecode.removeDeadStores();
+
+        if (options.optimizationLevel >= 1 && FFlag::LuauCompileSuperinstructions)
+            bytecode.fuseInstructions();
+
+        // tail calls remove the caller from stack traces, so they are only formed when full debug information isn't requested
+        if (options.optimizationLevel >= 1 && options.debugLevel <= 1 && FFlag::LuauCompileTailCalls)
+            bytecode.formTailCalls();
+
         if (bytecode.getInstructionCount() > kMaxInstructionCount)
             CompileError::raise(func->location, "Exceeded function instruction limit; split the function into parts to compile");
 
@@ -261,6 +290,18 @@ struct Compiler
         if (func->functionDepth == 0 && !hasLoops)
             protoflags |= LPF_NATIVE_COLD;
 
+        // upvalues that are never assigned to are captured by value (see compileExprFunction), so reads don't need to check for UpVal references
+        bool upvalsByValue = !upvals.empty();
+
+        for (AstLocal* uv : upvals)
+        {
+            Variable* ul = variables.find(uv);
+            upvalsByValue &= !ul || !ul->written;
+        }
+
+        if (upvalsByValue)
+            protoflags |= LPF_UPVALS_BY_VALUE;
+
         bytecode.endFunction(uint8_t(stackSize), uint8_t(upvals.size()), protoflags);
 
         Function& f = functions[func];
@@ -379,7 +420,7 @@ struct Compiler
 
     void compileExprSelectVararg(AstExprCall* expr, uint8_t target, uint8_t targetCount, bool targetTop, bool multRet, uint8_t regs)
     {
-        LUAU_ASSERT(targetCount == 1);
+        LUAU_ASSERT(targetCount >= 1 || multRet);
         LUAU_ASSERT(!expr->self);
         LUAU_ASSERT(expr->args.size == 2 && expr->args.data[1]->is<AstExprVarargs>());
 
@@ -494,6 +535,29 @@ struct Compiler
         }
     }
 
+    void setProfileHotness(AstExprFunction* func)
+    {
+        profileHotness = ProfileHotness::Unknown;
+
+        if (!options.hotFunctions)
+            return;
+
+        // functions are identified by the line they are defined on, same as Proto::linedefined
+        int line = func->location.begin.line + 1;
+
+        profileHotness = ProfileHotness::Cold;
+
+        for (const int* ptr = options.hotFunctions; *ptr; ++ptr)
+            if (*ptr == line)
+                profileHotness = ProfileHotness::Hot;
+    }
+
+    // thresholds of code growing optimizations are increased in hot functions
+    int getProfileThreshold(int threshold)
+    {
+        return profileHotness == ProfileHotness::Hot ? threshold * FInt::LuauCompileProfileHotThresholdScale / 100 : threshold;
+    }
+
     bool tryCompileInlinedCall(AstExprCall* expr, AstExprFunction* func, uint8_t target, uint8_t targetCount, bool multRet, int thresholdBase,
         int thresholdMaxBoost, int depthLimit)
     {
@@ -661,7 +725,7 @@ struct Compiler
         inlineFrames.push_back({func, oldLocals, target, targetCount});
 
         // fold constant values updated above into expressions in the function body
-        foldConstants(constants, variables, locstants, builtinsFold, builtinsFoldMathK, func->body);
+        foldConstants(constants, variables, locstants, builtinsFold, builtinsFoldMathK, &requireMembers, func->body);
 
         bool usedFallthrough = false;
 
@@ -706,7 +770,7 @@ struct Compiler
                 var->type = Constant::Type_Unknown;
         }
 
-        foldConstants(constants, variables, locstants, builtinsFold, builtinsFoldMathK, func->body);
+        foldConstants(constants, variables, locstants, builtinsFold, builtinsFoldMathK, &requireMembers, func->body);
     }
 
     void compileExprCall(AstExprCall* expr, uint8_t target, uint8_t targetCount, bool targetTop = false, bool multRet = false)
@@ -721,11 +785,17 @@ struct Compiler
             AstExprFunction* func = getFunctionExpr(expr->func);
             Function* fi = func ? functions.find(func) : nullptr;
 
-            if (fi && fi->canInline &&
-                tryCompileInlinedCall(expr, func, target, targetCount, multRet, FInt::LuauCompileInlineThreshold,
+            // profile shows that the call site doesn't execute often enough to benefit from the larger code
+            bool cold = profileHotness == ProfileHotness::Cold;
+
+            if (fi && fi->canInline && !cold &&
+                tryCompileInlinedCall(expr, func, target, targetCount, multRet, getProfileThreshold(FInt::LuauCompileInlineThreshold),
                     FInt::LuauCompileInlineThresholdMaxBoost, FInt::LuauCompileInlineDepth))
                 return;
 
+            if (fi && fi->canInline && cold)
+                bytecode.addDebugRemark("inlining skipped: cold function");
+
             // add a debug remark for cases when we didn't even call tryCompileInlinedCall
             if (func && !(fi && fi->canInline))
             {
@@ -767,8 +837,8 @@ struct Compiler
         if (bfid == LBF_SELECT_VARARG)
         {
             // Optimization: compile select(_, ...) as FASTCALL1; the builtin will read variadic arguments directly
-            // note: for now we restrict this to single-return expressions since our runtime code doesn't deal with general cases
-            if (multRet == false && targetCount == 1)
+            // note: runtimes that only handle single-return expressions will execute the fallback code for other cases
+            if (FFlag::LuauCompileSelectVararg ? (multRet || targetCount >= 1) : (multRet == false && targetCount == 1))
                 return compileExprSelectVararg(expr, target, targetCount, targetTop, multRet, regs);
             else
                 bfid = -1;
@@ -921,8 +991,77 @@ struct Compiler
         return true;
     }
 
+    // closure can be created once before the loop if its upvalues can't change between iterations
+    bool canHoistClosure(AstExprFunction* func, AstStat* loop)
+    {
+        if (shouldShareClosure(func))
+            return false;
+
+        // closure might have already been hoisted out of an outer loop
+        for (const LoopClosure& lc : loopClosures)
+        {
+            if (lc.func == func)
+                return false;
+        }
+
+        const Function* f = functions.find(func);
+        if (!f)
+            return false;
+
+        for (AstLocal* uv : f->upvals)
+        {
+            // note: locals that are never assigned to don't have to be tracked
+            Variable* ul = variables.find(uv);
+
+            if (ul && ul->written)
+                return false;
+
+            // locals declared inside the loop get a new value on each iteration
+            if (loop->location.encloses(uv->location))
+                return false;
+        }
+
+        return true;
+    }
+
+    // Optimization: closures that capture values which don't change during the loop don't need to be allocated on every iteration
+    // this breaks assumptions about function identity the same way shared closures do, so we disable this when setfenv is used
+    void compileLoopClosures(AstStat* loop, std::initializer_list<AstNode*> nodes)
+    {
+        if (options.optimizationLevel < 2 || setfenvUsed || !FFlag::LuauCompileLoopClosures)
+            return;
+
+        LoopClosureVisitor visitor(this, loop);
+
+        for (AstNode* node : nodes)
+        {
+            if (node)
+                node->visit(&visitor);
+        }
+
+        for (AstExprFunction* func : visitor.closures)
+        {
+            uint8_t reg = allocReg(func, 1);
+
+            setDebugLine(func);
+            compileExprFunction(func, reg);
+
+            loopClosures.push_back({func, reg});
+        }
+    }
+
     void compileExprFunction(AstExprFunction* expr, uint8_t target)
     {
+        // closure might have been created before the loop it's defined in
+        for (const LoopClosure& lc : loopClosures)
+        {
+            if (lc.func == expr)
+            {
+                bytecode.emitABC(LOP_MOVE, target, lc.reg, 0);
+                return;
+            }
+        }
+
         RegScope rs(this);
 
         const Function* f = functions.find(expr);
@@ -1773,6 +1912,11 @@ struct Compiler
                 indexSize = 0;
         }
 
+        // Optimization: if more fields are assigned after construction, allocate space for them upfront
+        // this avoids rehashing the table and keeps the key layout identical for all tables built by this expression
+        if (const TableShape* shape = tableShapes.find(expr))
+            hashSize += shape->hashSize;
+
         int encodedHashSize = encodeHashSize(hashSize);
 
         RegScope rs(this);
@@ -2623,6 +2767,11 @@ struct Compiler
         if (isConstantFalse(stat->condition))
             return;
 
+        RegScope rs(this);
+
+        size_t oldLoopClosures = loopClosures.size();
+        compileLoopClosures(stat, {stat->condition, stat->body});
+
         size_t oldJumps = loopJumps.size();
         size_t oldLocals = localStack.size();
 
@@ -2655,10 +2804,16 @@ struct Compiler
         loopJumps.resize(oldJumps);
 
         loops.pop_back();
+        loopClosures.resize(oldLoopClosures);
     }
 
     void compileStatRepeat(AstStatRepeat* stat)
     {
+        RegScope rs(this);
+
+        size_t oldLoopClosures = loopClosures.size();
+        compileLoopClosures(stat, {stat->body, stat->condition});
+
         size_t oldJumps = loopJumps.size();
         size_t oldLocals = localStack.size();
 
@@ -2671,8 +2826,6 @@ struct Compiler
         // this is necessary because condition can access locals declared inside the repeat..until body
         AstStatBlock* body = stat->body;
 
-        RegScope rs(this);
-
         bool continueValidated = false;
 
         for (size_t i = 0; i < body->body.size; ++i)
@@ -2738,6 +2891,7 @@ struct Compiler
         loopJumps.resize(oldJumps);
 
         loops.pop_back();
+        loopClosures.resize(oldLoopClosures);
     }
 
     void compileInlineReturn(AstStatReturn* stat, bool fallthrough)
@@ -2917,7 +3071,7 @@ struct Compiler
             locstants[var].type = Constant::Type_Number;
             locstants[var].valueNumber = from + iv * step;
 
-            foldConstants(constants, variables, locstants, builtinsFold, builtinsFoldMathK, stat);
+            foldConstants(constants, variables, locstants, builtinsFold, builtinsFoldMathK, &requireMembers, stat);
 
             size_t iterJumps = loopJumps.size();
 
@@ -2945,17 +3099,28 @@ struct Compiler
         // clean up fold state in case we need to recompile - normally we compile the loop body once, but due to inlining we may need to do it again
         locstants[var].type = Constant::Type_Unknown;
 
-        foldConstants(constants, variables, locstants, builtinsFold, builtinsFoldMathK, stat);
+        foldConstants(constants, variables, locstants, builtinsFold, builtinsFoldMathK, &requireMembers, stat);
     }
 
     void compileStatFor(AstStatFor* stat)
     {
         RegScope rs(this);
 
+        size_t oldLoopClosures = loopClosures.size();
+        compileLoopClosures(stat, {stat->body});
+
         // Optimization: small loops can be unrolled when it is profitable
         if (options.optimizationLevel >= 2 && isConstant(stat->to) && isConstant(stat->from) && (!stat->step || isConstant(stat->step)))
-            if (tryCompileUnrolledFor(stat, FInt::LuauCompileLoopUnrollThreshold, FInt::LuauCompileLoopUnrollThresholdMaxBoost))
+        {
+            if (profileHotness == ProfileHotness::Cold)
+                bytecode.addDebugRemark("loop unroll skipped: cold function");
+            else if (tryCompileUnrolledFor(
+                         stat, getProfileThreshold(FInt::LuauCompileLoopUnrollThreshold), FInt::LuauCompileLoopUnrollThresholdMaxBoost))
+            {
+                loopClosures.resize(oldLoopClosures);
                 return;
+            }
+        }
 
         size_t oldLocals = localStack.size();
         size_t oldJumps = loopJumps.size();
@@ -3016,12 +3181,16 @@ struct Compiler
         loopJumps.resize(oldJumps);
 
         loops.pop_back();
+        loopClosures.resize(oldLoopClosures);
     }
 
     void compileStatForIn(AstStatForIn* stat)
     {
         RegScope rs(this);
 
+        size_t oldLoopClosures = loopClosures.size();
+        compileLoopClosures(stat, {stat->body});
+
         size_t oldLocals = localStack.size();
         size_t oldJumps = loopJumps.size();
 
@@ -3730,6 +3899,10 @@ struct Compiler
         std::vector<AstExprFunction*>& functions;
         bool hasTypes = false;
 
+        // when set, functions that are structurally identical to an earlier one reuse its proto instead of being compiled again
+        bool dedup = false;
+        std::unordered_map<AstFingerprint, AstExprFunction*, AstFingerprintHash> fingerprints;
+
         FunctionVisitor(Compiler* self, std::vector<AstExprFunction*>& functions)
             : self(self)
             , functions(functions)
@@ -3738,8 +3911,50 @@ struct Compiler
             functions.reserve(16);
         }
 
+        struct NestedFunctionVisitor : AstVisitor
+        {
+            bool found = false;
+
+            bool visit(AstExprFunction* node) override
+            {
+                found = true;
+                return false;
+            }
+        };
+
+        bool canDedup(AstExprFunction* node)
+        {
+            if (!dedup)
+                return false;
+
+            // inlining compiles the body of the copy, and closures nested in it need their own protos
+            if (self->options.optimizationLevel >= 2)
+            {
+                NestedFunctionVisitor nestedVisitor;
+                node->body->visit(&nestedVisitor);
+
+                if (nestedVisitor.found)
+                    return false;
+            }
+
+            return true;
+        }
+
         bool visit(AstExprFunction* node) override
         {
+            if (canDedup(node))
+            {
+                auto [it, inserted] = fingerprints.try_emplace(getFingerprint(node), node);
+
+                // the original function can't contain its copy, so it's already in the list; nested functions of the copy are skipped as well
+                if (!inserted)
+                {
+                    self->duplicateFunctions[node] = it->second;
+                    functions.push_back(node);
+                    return false;
+                }
+            }
+
             node->body->visit(this);
 
             for (AstLocal* arg : node->args)
@@ -3823,6 +4038,27 @@ struct Compiler
         std::vector<AstLocal*> upvals;
     };
 
+    struct LoopClosureVisitor : AstVisitor
+    {
+        LoopClosureVisitor(Compiler* self, AstStat* loop)
+            : self(self)
+            , loop(loop)
+        {
+        }
+
+        bool visit(AstExprFunction* node) override
+        {
+            if (closures.size() < kMaxLoopClosures && self->canHoistClosure(node, loop))
+                closures.push_back(node);
+
+            return false;
+        }
+
+        Compiler* self;
+        AstStat* loop;
+        std::vector<AstExprFunction*> closures;
+    };
+
     struct ReturnVisitor : AstVisitor
     {
         Compiler* self;
@@ -3873,6 +4109,13 @@ struct Compiler
         unsigned int oldTop;
     };
 
+    enum class ProfileHotness
+    {
+        Unknown,
+        Hot,
+        Cold,
+    };
+
     struct Function
     {
         uint32_t id;
@@ -3938,6 +4181,12 @@ struct Compiler
         uint8_t data;
     };
 
+    struct LoopClosure
+    {
+        AstExprFunction* func;
+        uint8_t reg;
+    };
+
     BytecodeBuilder& bytecode;
 
     CompileOptions options;
@@ -3954,8 +4203,11 @@ struct Compiler
 
     const DenseHashMap<AstExprCall*, int>* builtinsFold = nullptr;
     bool builtinsFoldMathK = false;
+    DenseHashMap<AstExprIndexName*, Constant> requireMembers;
+    DenseHashMap<AstExprFunction*, AstExprFunction*> duplicateFunctions;
 
     // compileFunction state, gets reset for every function
+    ProfileHotness profileHotness = ProfileHotness::Unknown;
     unsigned int regTop = 0;
     unsigned int stackSize = 0;
     bool hasLoops = false;
@@ -3969,10 +4221,12 @@ struct Compiler
     std::vector<Loop> loops;
     std::vector<InlineFrame> inlineFrames;
     std::vector<Capture> captures;
+    std::vector<LoopClosure> loopClosures;
     std::vector<std::unique_ptr<char[]>> interpStrings;
 };
 
-void compileOrThrow(BytecodeBuilder& bytecode, const ParseResult& parseResult, const AstNameTable& names, const CompileOptions& inputOptions)
+void compileOrThrow(BytecodeBuilder& bytecode, const ParseResult& parseResult, const AstNameTable& names, const CompileOptions& inputOptions,
+    const InferredTypes* inferredTypes)
 {
     LUAU_TIMETRACE_SCOPE("compileOrThrow", "Compiler");
 
@@ -4025,8 +4279,14 @@ void compileOrThrow(BytecodeBuilder& bytecode, const ParseResult& parseResult, c
         // this pass tracks which calls are builtins and can be compiled more efficiently
         analyzeBuiltins(compiler.builtins, compiler.globals, compiler.variables, options, root);
 
+        // whole-program compilation provides constant fields of required modules; global 'require' has to refer to the builtin function
+        if (AstName require = names.get("require");
+            options.requireConstantCb && require.value && getGlobalState(compiler.globals, require) == Global::Default)
+            analyzeRequireConstants(compiler.requireMembers, compiler.variables, require, options, root);
+
         // this pass analyzes constantness of expressions
-        foldConstants(compiler.constants, compiler.variables, compiler.locstants, compiler.builtinsFold, compiler.builtinsFoldMathK, root);
+        foldConstants(compiler.constants, compiler.variables, compiler.locstants, compiler.builtinsFold, compiler.builtinsFoldMathK, &compiler.requireMembers,
+            root);
 
         // this pass analyzes table assignments to estimate table shapes for initially empty tables
         predictTableShapes(compiler.tableShapes, root);
@@ -4036,14 +4296,31 @@ void compileOrThrow(BytecodeBuilder& bytecode, const ParseResult& parseResult, c
     // for example, function foo() return function() end end will result in two vector entries, [0] = anonymous and [1] = foo
     std::vector<AstExprFunction*> functions;
     Compiler::FunctionVisitor functionVisitor(&compiler, functions);
+
+    // shared protos keep the debug information of the first function, so this is only done when the output has none
+    // type information inferred by the type checker depends on the context of each function so it disables this as well
+    functionVisitor.dedup = FFlag::LuauCompileDedupFunctions && options.debugLevel == 0 && options.coverageLevel == 0 && !options.hotFunctions &&
+                            !inferredTypes;
+
     root->visit(&functionVisitor);
 
-    // computes type information for all functions based on type annotations
-    if (functionVisitor.hasTypes)
-        buildTypeMap(compiler.typeMap, root, options.vectorType);
+    // computes type information for all functions based on type annotations and types inferred by the type checker
+    if (functionVisitor.hasTypes || (inferredTypes && inferredTypes->size() != 0))
+        buildTypeMap(compiler.typeMap, root, options.vectorType, inferredTypes);
 
     for (AstExprFunction* expr : functions)
-        compiler.compileFunction(expr, 0);
+    {
+        if (AstExprFunction** original = compiler.duplicateFunctions.find(expr))
+        {
+            // note: copy is required since the insertion may rehash the map
+            Compiler::Function f = *compiler.functions.find(*original);
+            compiler.functions[expr] = f;
+        }
+        else
+        {
+            compiler.compileFunction(expr, 0);
+        }
+    }
 
     AstExprFunction main(root->location, /*generics= */ AstArray<AstGenericType>(), /*genericPacks= */ AstArray<AstGenericTypePack>(),
         /* self= */ nullptr, AstArray<AstLocal*>(), /* vararg= */ true, /* varargLocation= */ Luau::Location(), root, /* functionDepth= */ 0,
@@ -4059,7 +4336,7 @@ void compileOrThrow(BytecodeBuilder& bytecode, const ParseResult& parseResult, c
 
 void compileOrThrow(BytecodeBuilder& bytecode, const std::string& source, const CompileOptions& options, const ParseOptions& parseOptions)
 {
-    Allocator allocator;
+    Allocator allocator(source.size());
     AstNameTable names(allocator);
     ParseResult result = Parser::parse(source.c_str(), source.size(), names, allocator, parseOptions);
 
@@ -4073,7 +4350,7 @@ std::string compile(const std::string& source, const CompileOptions& options, co
 {
     LUAU_TIMETRACE_SCOPE("compile", "Compiler");
 
-    Allocator allocator;
+    Allocator allocator(source.size());
     AstNameTable names(allocator);
     ParseResult result = Parser::parse(source.c_str(), source.size(), names, allocator, parseOptions);
 
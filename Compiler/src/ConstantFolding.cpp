@@ -3,8 +3,11 @@
 
 #include "BuiltinFolding.h"
 
+#include "Luau/Compiler.h"
+
 #include <vector>
 #include <math.h>
+#include <string.h>
 
 namespace Luau
 {
@@ -210,18 +213,21 @@ struct ConstantVisitor : AstVisitor
 
     const DenseHashMap<AstExprCall*, int>* builtins;
     bool foldMathK = false;
+    const DenseHashMap<AstExprIndexName*, Constant>* requireMembers;
 
     bool wasEmpty = false;
 
     std::vector<Constant> builtinArgs;
 
     ConstantVisitor(DenseHashMap<AstExpr*, Constant>& constants, DenseHashMap<AstLocal*, Variable>& variables,
-        DenseHashMap<AstLocal*, Constant>& locals, const DenseHashMap<AstExprCall*, int>* builtins, bool foldMathK)
+        DenseHashMap<AstLocal*, Constant>& locals, const DenseHashMap<AstExprCall*, int>* builtins, bool foldMathK,
+        const DenseHashMap<AstExprIndexName*, Constant>* requireMembers)
         : constants(constants)
         , variables(variables)
         , locals(locals)
         , builtins(builtins)
         , foldMathK(foldMathK)
+        , requireMembers(requireMembers)
     {
         // since we do a single pass over the tree, if the initial state was empty we don't need to clear out old entries
         wasEmpty = constants.empty() && locals.empty();
@@ -318,6 +324,9 @@ struct ConstantVisitor : AstVisitor
                     result = foldBuiltinMath(expr->index);
                 }
             }
+
+            if (const Constant* member = requireMembers ? requireMembers->find(expr) : nullptr)
+                result = *member;
         }
         else if (AstExprIndexExpr* expr = node->as<AstExprIndexExpr>())
         {
@@ -459,9 +468,98 @@ struct ConstantVisitor : AstVisitor
 };
 
 void foldConstants(DenseHashMap<AstExpr*, Constant>& constants, DenseHashMap<AstLocal*, Variable>& variables,
-    DenseHashMap<AstLocal*, Constant>& locals, const DenseHashMap<AstExprCall*, int>* builtins, bool foldMathK, AstNode* root)
+    DenseHashMap<AstLocal*, Constant>& locals, const DenseHashMap<AstExprCall*, int>* builtins, bool foldMathK,
+    const DenseHashMap<AstExprIndexName*, Constant>* requireMembers, AstNode* root)
 {
-    ConstantVisitor visitor{constants, variables, locals, builtins, foldMathK};
+    ConstantVisitor visitor{constants, variables, locals, builtins, foldMathK, requireMembers};
+    root->visit(&visitor);
+}
+
+struct RequireConstantVisitor : AstVisitor
+{
+    DenseHashMap<AstExprIndexName*, Constant>& result;
+    const DenseHashMap<AstLocal*, Variable>& variables;
+    const CompileOptions& options;
+
+    AstName require;
+
+    RequireConstantVisitor(DenseHashMap<AstExprIndexName*, Constant>& result, const DenseHashMap<AstLocal*, Variable>& variables,
+        const CompileOptions& options, AstName require)
+        : result(result)
+        , variables(variables)
+        , options(options)
+        , require(require)
+    {
+    }
+
+    // module path of a local that holds the result of require("path") for its entire lifetime
+    const AstExprConstantString* getRequirePath(AstLocal* local)
+    {
+        const Variable* v = variables.find(local);
+
+        if (!v || v->written || !v->init)
+            return nullptr;
+
+        AstExprCall* call = v->init->as<AstExprCall>();
+
+        if (!call || call->self || call->args.size != 1)
+            return nullptr;
+
+        AstExprGlobal* func = call->func->as<AstExprGlobal>();
+
+        if (!func || func->name != require)
+            return nullptr;
+
+        return call->args.data[0]->as<AstExprConstantString>();
+    }
+
+    bool visit(AstExprIndexName* node) override
+    {
+        AstExprLocal* expr = node->expr->as<AstExprLocal>();
+        const AstExprConstantString* path = expr ? getRequirePath(expr->local) : nullptr;
+
+        // paths and member names can contain embedded zeroes that the callback can't observe
+        if (!path || strlen(path->value.data) != path->value.size)
+            return true;
+
+        CompileConstant value;
+        options.requireConstantCb(options.requireConstantContext, path->value.data, node->index.value, &value);
+
+        Constant constant;
+
+        switch (value.type)
+        {
+        case 1:
+            constant.type = Constant::Type_Nil;
+            break;
+        case 2:
+            constant.type = Constant::Type_Boolean;
+            constant.valueBoolean = value.valueBoolean != 0;
+            break;
+        case 3:
+            constant.type = Constant::Type_Number;
+            constant.valueNumber = value.valueNumber;
+            break;
+        case 4:
+            constant.type = Constant::Type_String;
+            constant.valueString = value.valueString;
+            constant.stringLength = unsigned(value.stringLength);
+            break;
+        }
+
+        if (constant.type != Constant::Type_Unknown)
+            result[node] = constant;
+
+        return true;
+    }
+};
+
+void analyzeRequireConstants(DenseHashMap<AstExprIndexName*, Constant>& result, const DenseHashMap<AstLocal*, Variable>& variables, AstName require,
+    const CompileOptions& options, AstNode* root)
+{
+    LUAU_ASSERT(options.requireConstantCb);
+
+    RequireConstantVisitor visitor{result, variables, options, require};
     root->visit(&visitor);
 }
 
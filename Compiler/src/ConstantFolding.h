@@ -3,6 +3,11 @@
 
 #include "ValueTracking.h"
 
+namespace Luau
+{
+struct CompileOptions;
+}
+
 namespace Luau
 {
 namespace Compile
@@ -45,7 +50,12 @@ struct Constant
 };
 
 void foldConstants(DenseHashMap<AstExpr*, Constant>& constants, DenseHashMap<AstLocal*, Variable>& variables,
-    DenseHashMap<AstLocal*, Constant>& locals, const DenseHashMap<AstExprCall*, int>* builtins, bool foldMathK, AstNode* root);
+    DenseHashMap<AstLocal*, Constant>& locals, const DenseHashMap<AstExprCall*, int>* builtins, bool foldMathK,
+    const DenseHashMap<AstExprIndexName*, Constant>* requireMembers, AstNode* root);
+
+// finds reads of fields of required modules that have a known constant value
+void analyzeRequireConstants(DenseHashMap<AstExprIndexName*, Constant>& result, const DenseHashMap<AstLocal*, Variable>& variables, AstName require,
+    const CompileOptions& options, AstNode* root);
 
 } // namespace Compile
 } // namespace Luau
@@ -1,6 +1,8 @@
 // This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
 #include "TableShape.h"
 
+#include <string.h>
+
 namespace Luau
 {
 namespace Compile
@@ -24,6 +26,31 @@ static AstExprTable* getTableHint(AstExpr* expr)
     return nullptr;
 }
 
+// table literal that only has record fields (t = { a = 1, b = 2 }) can be extended by field assignments after construction
+static bool isRecordTable(AstExprTable* table)
+{
+    for (const AstExprTable::Item& item : table->items)
+        if (item.kind != AstExprTable::Item::Record)
+            return false;
+
+    return true;
+}
+
+static bool hasRecordField(AstExprTable* table, AstName index)
+{
+    size_t length = strlen(index.value);
+
+    for (const AstExprTable::Item& item : table->items)
+    {
+        AstExprConstantString* key = item.key->as<AstExprConstantString>();
+
+        if (key && key->value.size == length && memcmp(key->value.data, index.value, length) == 0)
+            return true;
+    }
+
+    return false;
+}
+
 struct ShapeVisitor : AstVisitor
 {
     struct Hasher
@@ -57,7 +84,7 @@ struct ShapeVisitor : AstVisitor
             {
                 std::pair<AstExprTable*, AstName> field = {*table, index};
 
-                if (!fields.contains(field))
+                if (!fields.contains(field) && !hasRecordField(*table, index))
                 {
                     fields.insert(field);
                     shapes[*table].hashSize += 1;
@@ -73,7 +100,7 @@ struct ShapeVisitor : AstVisitor
             return;
 
         AstExprTable** table = tables.find(lv->local);
-        if (!table)
+        if (!table || (*table)->items.size != 0)
             return;
 
         if (AstExprConstantNumber* number = index->as<AstExprConstantNumber>())
@@ -111,7 +138,7 @@ struct ShapeVisitor : AstVisitor
     {
         // track local -> table association so that we can update table size prediction in assignField
         if (node->vars.size == 1 && node->values.size == 1)
-            if (AstExprTable* table = getTableHint(node->values.data[0]); table && table->items.size == 0)
+            if (AstExprTable* table = getTableHint(node->values.data[0]); table && isRecordTable(table))
                 tables[node->vars.data[0]] = table;
 
         return true;
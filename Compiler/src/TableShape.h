@@ -12,7 +12,7 @@ namespace Compile
 struct TableShape
 {
     unsigned int arraySize = 0;
-    unsigned int hashSize = 0;
+    unsigned int hashSize = 0; // for non-empty table literals, the number of fields that are assigned after construction
 };
 
 void predictTableShapes(DenseHashMap<AstExprTable*, TableShape>& shapes, AstNode* root);
@@ -110,7 +110,8 @@ static LuauBytecodeType getType(AstType* ty, const AstArray<AstGenericType>& gen
     return LBC_TYPE_ANY;
 }
 
-static std::string getFunctionType(const AstExprFunction* func, const DenseHashMap<AstName, AstStatTypeAlias*>& typeAliases, const char* vectorType)
+static std::string getFunctionType(const AstExprFunction* func, const DenseHashMap<AstName, AstStatTypeAlias*>& typeAliases, const char* vectorType,
+    const DenseHashMap<const AstLocal*, LuauBytecodeType>* inferredTypes)
 {
     bool self = func->self != 0;
 
@@ -126,8 +127,12 @@ static std::string getFunctionType(const AstExprFunction* func, const DenseHashM
     bool haveNonAnyParam = false;
     for (AstLocal* arg : func->args)
     {
-        LuauBytecodeType ty =
-            arg->annotation ? getType(arg->annotation, func->generics, typeAliases, /* resolveAliases= */ true, vectorType) : LBC_TYPE_ANY;
+        LuauBytecodeType ty = LBC_TYPE_ANY;
+
+        if (arg->annotation)
+            ty = getType(arg->annotation, func->generics, typeAliases, /* resolveAliases= */ true, vectorType);
+        else if (const LuauBytecodeType* inferred = inferredTypes ? inferredTypes->find(arg) : nullptr)
+            ty = *inferred;
 
         if (ty != LBC_TYPE_ANY)
             haveNonAnyParam = true;
@@ -146,13 +151,16 @@ struct TypeMapVisitor : AstVisitor
 {
     DenseHashMap<AstExprFunction*, std::string>& typeMap;
     const char* vectorType;
+    const DenseHashMap<const AstLocal*, LuauBytecodeType>* inferredTypes;
 
     DenseHashMap<AstName, AstStatTypeAlias*> typeAliases;
     std::vector<std::pair<AstName, AstStatTypeAlias*>> typeAliasStack;
 
-    TypeMapVisitor(DenseHashMap<AstExprFunction*, std::string>& typeMap, const char* vectorType)
+    TypeMapVisitor(DenseHashMap<AstExprFunction*, std::string>& typeMap, const char* vectorType,
+        const DenseHashMap<const AstLocal*, LuauBytecodeType>* inferredTypes)
         : typeMap(typeMap)
         , vectorType(vectorType)
+        , inferredTypes(inferredTypes)
         , typeAliases(AstName())
     {
     }
@@ -213,7 +221,7 @@ struct TypeMapVisitor : AstVisitor
 
     bool visit(AstExprFunction* node) override
     {
-        std::string type = getFunctionType(node, typeAliases, vectorType);
+        std::string type = getFunctionType(node, typeAliases, vectorType, inferredTypes);
 
         if (!type.empty())
             typeMap[node] = std::move(type);
@@ -222,9 +230,10 @@ struct TypeMapVisitor : AstVisitor
     }
 };
 
-void buildTypeMap(DenseHashMap<AstExprFunction*, std::string>& typeMap, AstNode* root, const char* vectorType)
+void buildTypeMap(DenseHashMap<AstExprFunction*, std::string>& typeMap, AstNode* root, const char* vectorType,
+    const DenseHashMap<const AstLocal*, LuauBytecodeType>* inferredTypes)
 {
-    TypeMapVisitor visitor(typeMap, vectorType);
+    TypeMapVisitor visitor(typeMap, vectorType, inferredTypes);
     root->visit(&visitor);
 }
 
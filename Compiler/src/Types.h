@@ -2,6 +2,7 @@
 #pragma once
 
 #include "Luau/Ast.h"
+#include "Luau/Bytecode.h"
 #include "Luau/DenseHash.h"
 
 #include <string>
@@ -9,6 +10,8 @@
 namespace Luau
 {
 
-void buildTypeMap(DenseHashMap<AstExprFunction*, std::string>& typeMap, AstNode* root, const char* vectorType);
+// inferredTypes, when set, provides types of arguments that don't have annotations
+void buildTypeMap(DenseHashMap<AstExprFunction*, std::string>& typeMap, AstNode* root, const char* vectorType,
+    const DenseHashMap<const AstLocal*, LuauBytecodeType>* inferredTypes = nullptr);
 
 } // namespace Luau
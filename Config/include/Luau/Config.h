@@ -7,8 +7,11 @@
 #include <optional>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include <stdint.h>
+
 namespace Luau
 {
 
@@ -50,6 +53,52 @@ struct NullConfigResolver : ConfigResolver
     virtual const Config& getConfig(const ModuleName& name) const override;
 };
 
+// Configuration files are accessed through the host, so that the cache below works with any file system
+struct ConfigFileSource
+{
+    virtual ~ConfigFileSource() {}
+
+    virtual std::optional<std::string> getParentDirectory(const std::string& directory) const = 0;
+
+    // Returns the contents of the configuration file in the directory, if there is one
+    virtual std::optional<std::string> readConfigFile(const std::string& directory) const = 0;
+
+    // Returns a value that changes when the configuration file in the directory is created, modified or removed
+    virtual uint64_t getConfigFileVersion(const std::string& directory) const = 0;
+};
+
+// Configuration of a directory combines the configuration files of the directory and all of its parents
+// The cache memoizes it for every directory, so configuration files are read and parsed once no matter how many modules share them
+class ConfigCache
+{
+public:
+    ConfigCache(const ConfigFileSource& source, Config defaultConfig = {});
+
+    const Config& getConfig(const std::string& directory);
+
+    // Drops directories where the configuration file of the directory or one of its parents has changed; configuration references returned
+    // earlier for these directories become invalid
+    // Returns the number of dropped directories
+    size_t invalidateChanged();
+
+    // Returns pairs of directory and error message for configuration files that failed to parse, ordered by directory
+    std::vector<std::pair<std::string, std::string>> getErrors() const;
+
+private:
+    struct Entry
+    {
+        Config config;
+        std::optional<std::string> parent;
+        std::optional<std::string> error;
+        uint64_t version = 0;
+    };
+
+    const ConfigFileSource& source;
+    Config defaultConfig;
+
+    std::unordered_map<std::string, Entry> entries;
+};
+
 std::optional<std::string> parseModeString(Mode& mode, const std::string& modeString, bool compat = false);
 std::optional<std::string> parseLintRuleString(
     LintOptions& enabledLints, LintOptions& fatalLints, const std::string& warningName, const std::string& value, bool compat = false);
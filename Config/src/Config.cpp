@@ -313,4 +313,74 @@ const Config& NullConfigResolver::getConfig(const ModuleName& name) const
     return defaultConfig;
 }
 
+ConfigCache::ConfigCache(const ConfigFileSource& source, Config defaultConfig)
+    : source(source)
+    , defaultConfig(std::move(defaultConfig))
+{
+}
+
+const Config& ConfigCache::getConfig(const std::string& directory)
+{
+    if (auto it = entries.find(directory); it != entries.end())
+        return it->second.config;
+
+    Entry entry;
+    entry.parent = source.getParentDirectory(directory);
+    entry.config = entry.parent ? getConfig(*entry.parent) : defaultConfig;
+
+    // version is taken before reading, so that changes made while the file is read are picked up by the next invalidation
+    entry.version = source.getConfigFileVersion(directory);
+
+    if (std::optional<std::string> contents = source.readConfigFile(directory))
+        entry.error = parseConfig(*contents, entry.config);
+
+    return (entries[directory] = std::move(entry)).config;
+}
+
+size_t ConfigCache::invalidateChanged()
+{
+    std::unordered_map<std::string, bool> stale;
+
+    for (const auto& [directory, entry] : entries)
+        stale[directory] = source.getConfigFileVersion(directory) != entry.version;
+
+    // configuration of a directory includes all of its parents, which are always cached before it
+    std::vector<std::string> dropped;
+
+    for (const auto& [directory, entry] : entries)
+    {
+        for (const std::string* current = &directory;;)
+        {
+            if (stale[*current])
+            {
+                dropped.push_back(directory);
+                break;
+            }
+
+            const std::optional<std::string>& parent = entries.at(*current).parent;
+            if (!parent)
+                break;
+
+            current = &*parent;
+        }
+    }
+
+    for (const std::string& directory : dropped)
+        entries.erase(directory);
+
+    return dropped.size();
+}
+
+std::vector<std::pair<std::string, std::string>> ConfigCache::getErrors() const
+{
+    std::vector<std::pair<std::string, std::string>> result;
+
+    for (const auto& [directory, entry] : entries)
+        if (entry.error)
+            result.emplace_back(directory, *entry.error);
+
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
 } // namespace Luau
@@ -7,6 +7,9 @@ if(NOT ${CMAKE_VERSION} VERSION_LESS "3.19")
         Common/include/Luau/BytecodeUtils.h
         Common/include/Luau/DenseHash.h
         Common/include/Luau/ExperimentalFlags.h
+        Common/include/Luau/FlatHash.h
+        Common/include/Luau/Hash.h
+        Common/include/Luau/NumberParse.h
         Common/include/Luau/VecDeque.h
     )
 endif()
@@ -14,6 +17,7 @@ endif()
 # Luau.Ast Sources
 target_sources(Luau.Ast PRIVATE
     Ast/include/Luau/Ast.h
+    Ast/include/Luau/AstFingerprint.h
     Ast/include/Luau/Confusables.h
     Ast/include/Luau/Lexer.h
     Ast/include/Luau/Location.h
@@ -24,6 +28,7 @@ target_sources(Luau.Ast PRIVATE
     Ast/include/Luau/TimeTrace.h
 
     Ast/src/Ast.cpp
+    Ast/src/AstFingerprint.cpp
     Ast/src/Confusables.cpp
     Ast/src/Lexer.cpp
     Ast/src/Location.cpp
@@ -88,7 +93,11 @@ target_sources(Luau.CodeGen PRIVATE
     CodeGen/include/Luau/Label.h
     CodeGen/include/Luau/OperandX64.h
     CodeGen/include/Luau/OptimizeConstProp.h
+    CodeGen/include/Luau/OptimizeDeadStore.h
+    CodeGen/include/Luau/OptimizeFinalA64.h
     CodeGen/include/Luau/OptimizeFinalX64.h
+    CodeGen/include/Luau/OptimizeLoops.h
+    CodeGen/include/Luau/OptimizeRedundantChecks.h
     CodeGen/include/Luau/RegisterA64.h
     CodeGen/include/Luau/RegisterX64.h
     CodeGen/include/Luau/UnwindBuilder.h
@@ -125,7 +134,11 @@ target_sources(Luau.CodeGen PRIVATE
     CodeGen/src/lcodegen.cpp
     CodeGen/src/NativeState.cpp
     CodeGen/src/OptimizeConstProp.cpp
+    CodeGen/src/OptimizeDeadStore.cpp
+    CodeGen/src/OptimizeFinalA64.cpp
     CodeGen/src/OptimizeFinalX64.cpp
+    CodeGen/src/OptimizeLoops.cpp
+    CodeGen/src/OptimizeRedundantChecks.cpp
     CodeGen/src/UnwindBuilderDwarf2.cpp
     CodeGen/src/UnwindBuilderWin.cpp
     CodeGen/src/BytecodeAnalysis.cpp
@@ -159,6 +172,7 @@ target_sources(Luau.Analysis PRIVATE
     Analysis/include/Luau/AstQuery.h
     Analysis/include/Luau/Autocomplete.h
     Analysis/include/Luau/BuiltinDefinitions.h
+    Analysis/include/Luau/BytecodeTypes.h
     Analysis/include/Luau/Cancellation.h
     Analysis/include/Luau/Clone.h
     Analysis/include/Luau/Constraint.h
@@ -182,6 +196,7 @@ target_sources(Luau.Analysis PRIVATE
     Analysis/include/Luau/LValue.h
     Analysis/include/Luau/Metamethods.h
     Analysis/include/Luau/Module.h
+    Analysis/include/Luau/ModuleInterfaceCache.h
     Analysis/include/Luau/ModuleResolver.h
     Analysis/include/Luau/NonStrictTypeChecker.h
     Analysis/include/Luau/Normalize.h
@@ -194,6 +209,7 @@ target_sources(Luau.Analysis PRIVATE
     Analysis/include/Luau/Scope.h
     Analysis/include/Luau/Set.h
     Analysis/include/Luau/Simplify.h
+    Analysis/include/Luau/SolverProfile.h
     Analysis/include/Luau/Substitution.h
     Analysis/include/Luau/Subtyping.h
     Analysis/include/Luau/Symbol.h
@@ -229,6 +245,7 @@ target_sources(Luau.Analysis PRIVATE
     Analysis/src/AstQuery.cpp
     Analysis/src/Autocomplete.cpp
     Analysis/src/BuiltinDefinitions.cpp
+    Analysis/src/BytecodeTypes.cpp
     Analysis/src/Clone.cpp
     Analysis/src/Constraint.cpp
     Analysis/src/ConstraintGenerator.cpp
@@ -247,6 +264,7 @@ target_sources(Luau.Analysis PRIVATE
     Analysis/src/Linter.cpp
     Analysis/src/LValue.cpp
     Analysis/src/Module.cpp
+    Analysis/src/ModuleInterfaceCache.cpp
     Analysis/src/NonStrictTypeChecker.cpp
     Analysis/src/Normalize.cpp
     Analysis/src/OverloadResolution.cpp
@@ -255,6 +273,7 @@ target_sources(Luau.Analysis PRIVATE
     Analysis/src/RequireTracer.cpp
     Analysis/src/Scope.cpp
     Analysis/src/Simplify.cpp
+    Analysis/src/SolverProfile.cpp
     Analysis/src/Substitution.cpp
     Analysis/src/Subtyping.cpp
     Analysis/src/Symbol.cpp
@@ -299,13 +318,16 @@ target_sources(Luau.VM PRIVATE
     VM/src/lfunc.cpp
     VM/src/lgc.cpp
     VM/src/lgcdebug.cpp
+    VM/src/limage.cpp
     VM/src/linit.cpp
+    VM/src/ljsonlib.cpp
     VM/src/lmathlib.cpp
     VM/src/lmem.cpp
     VM/src/lnumprint.cpp
     VM/src/lobject.cpp
     VM/src/loslib.cpp
     VM/src/lperf.cpp
+    VM/src/lshared.cpp
     VM/src/lstate.cpp
     VM/src/lstring.cpp
     VM/src/lstrlib.cpp
@@ -330,6 +352,7 @@ target_sources(Luau.VM PRIVATE
     VM/src/lmem.h
     VM/src/lnumutils.h
     VM/src/lobject.h
+    VM/src/lshared.h
     VM/src/lstate.h
     VM/src/lstring.h
     VM/src/ltable.h
@@ -346,12 +369,22 @@ target_sources(isocline PRIVATE
 if(TARGET Luau.Repl.CLI)
     # Luau.Repl.CLI Sources
     target_sources(Luau.Repl.CLI PRIVATE
+        CLI/BytecodeCache.h
+        CLI/BytecodeCache.cpp
         CLI/Coverage.h
         CLI/Coverage.cpp
+        CLI/EventLoop.h
+        CLI/EventLoop.cpp
         CLI/FileUtils.h
         CLI/FileUtils.cpp
         CLI/Flags.h
         CLI/Flags.cpp
+        CLI/GcStats.h
+        CLI/GcStats.cpp
+        CLI/OpcodeStats.h
+        CLI/OpcodeStats.cpp
+        CLI/PageSource.h
+        CLI/PageSource.cpp
         CLI/Profiler.h
         CLI/Profiler.cpp
         CLI/Repl.cpp
@@ -390,6 +423,7 @@ if(TARGET Luau.UnitTest)
         tests/AstVisitor.test.cpp
         tests/Autocomplete.test.cpp
         tests/BuiltinDefinitions.test.cpp
+        tests/BytecodeTypes.test.cpp
         tests/ClassFixture.cpp
         tests/ClassFixture.h
         tests/CodeAllocator.test.cpp
@@ -418,6 +452,7 @@ if(TARGET Luau.UnitTest)
         tests/Linter.test.cpp
         tests/LValue.test.cpp
         tests/Module.test.cpp
+        tests/ModuleInterfaceCache.test.cpp
         tests/NonstrictMode.test.cpp
         tests/NonStrictTypeChecker.test.cpp
         tests/Normalize.test.cpp
@@ -486,15 +521,55 @@ if(TARGET Luau.Conformance)
         tests/main.cpp)
 endif()
 
+if(TARGET Luau.ApiBench)
+    # Luau.ApiBench Sources
+    target_sources(Luau.ApiBench PRIVATE
+        bench/ApiBench.cpp)
+endif()
+
+if(TARGET Luau.CompileBench)
+    # Luau.CompileBench Sources
+    target_sources(Luau.CompileBench PRIVATE
+        CLI/FileUtils.h
+        CLI/FileUtils.cpp
+        bench/CompileBench.cpp)
+endif()
+
+if(TARGET Luau.MemoryBench)
+    # Luau.MemoryBench Sources
+    target_sources(Luau.MemoryBench PRIVATE
+        bench/MemoryBench.cpp)
+endif()
+
+if(TARGET Luau.LoadBench)
+    # Luau.LoadBench Sources
+    target_sources(Luau.LoadBench PRIVATE
+        CLI/FileUtils.h
+        CLI/FileUtils.cpp
+        bench/LoadBench.cpp)
+endif()
+
 if(TARGET Luau.CLI.Test)
     # Luau.CLI.Test Sources
     target_sources(Luau.CLI.Test PRIVATE
+        CLI/BytecodeCache.h
+        CLI/BytecodeCache.cpp
         CLI/Coverage.h
         CLI/Coverage.cpp
+        CLI/EventLoop.h
+        CLI/EventLoop.cpp
+        CLI/Executor.h
+        CLI/Executor.cpp
         CLI/FileUtils.h
         CLI/FileUtils.cpp
         CLI/Flags.h
         CLI/Flags.cpp
+        CLI/GcStats.h
+        CLI/GcStats.cpp
+        CLI/OpcodeStats.h
+        CLI/OpcodeStats.cpp
+        CLI/PageSource.h
+        CLI/PageSource.cpp
         CLI/Profiler.h
         CLI/Profiler.cpp
         CLI/Repl.cpp
@@ -502,6 +577,9 @@ if(TARGET Luau.CLI.Test)
 
         tests/RegisterCallbacks.h
         tests/RegisterCallbacks.cpp
+        tests/BytecodeCache.test.cpp
+        tests/EventLoop.test.cpp
+        tests/Executor.test.cpp
         tests/Repl.test.cpp
         tests/RequireByString.test.cpp
         tests/main.cpp)
@@ -525,6 +603,8 @@ endif()
 if(TARGET Luau.Compile.CLI)
     # Luau.Compile.CLI Sources
     target_sources(Luau.Compile.CLI PRIVATE
+        CLI/BytecodeCache.h
+        CLI/BytecodeCache.cpp
         CLI/FileUtils.h
         CLI/FileUtils.cpp
         CLI/Flags.h
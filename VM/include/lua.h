@@ -48,6 +48,44 @@ typedef struct lua_State lua_State;
 typedef int (*lua_CFunction)(lua_State* L);
 typedef int (*lua_Continuation)(lua_State* L, int status);
 
+/*
+** fast C functions receive unboxed arguments when a call matches their signature
+*/
+#define LUA_FASTMAXVALUES 8
+
+// number of fast C functions that can be called through builtin ids, see lua_setuserbuiltin
+#define LUA_USERBUILTINS 32
+
+enum lua_FastType
+{
+    LUA_FASTNUMBER,
+    LUA_FASTBOOLEAN,
+    LUA_FASTVECTOR,
+    LUA_FASTUSERDATA, // userdata with the tag from `tags', passed as a pointer to its data; not supported for results
+};
+
+typedef union lua_FastValue
+{
+    double n;
+    int b;
+    float v[LUA_VECTOR_SIZE];
+    void* p;
+} lua_FastValue;
+
+// returning 0 makes the call fall back to the regular C function, which can then report errors
+typedef int (*lua_FastCFunction)(const lua_FastValue* args, lua_FastValue* results);
+
+typedef struct lua_FastCall
+{
+    lua_FastCFunction f;
+
+    int nargs;
+    int nresults;
+    uint8_t args[LUA_FASTMAXVALUES];    // lua_FastType of each argument
+    uint8_t results[LUA_FASTMAXVALUES]; // lua_FastType of each result
+    uint8_t tags[LUA_FASTMAXVALUES];    // userdata tag of each LUA_FASTUSERDATA argument
+} lua_FastCall;
+
 /*
 ** prototype for memory-allocation functions
 */
@@ -114,6 +152,10 @@ LUA_API lua_State* lua_newthread(lua_State* L);
 LUA_API lua_State* lua_mainthread(lua_State* L);
 LUA_API void lua_resetthread(lua_State* L);
 LUA_API int lua_isthreadreset(lua_State* L);
+LUA_API lua_State* lua_acquirethread(lua_State* L);
+LUA_API int lua_releasethread(lua_State* L, lua_State* co);
+LUA_API void lua_setthreadpool(lua_State* L, int maxthreads, int maxstacksize);
+LUA_API int lua_threadpoolstats(lua_State* L, size_t* hits, size_t* misses);
 
 /*
 ** basic stack manipulation
@@ -127,9 +169,22 @@ LUA_API void lua_insert(lua_State* L, int idx);
 LUA_API void lua_replace(lua_State* L, int idx);
 LUA_API int lua_checkstack(lua_State* L, int sz);
 LUA_API void lua_rawcheckstack(lua_State* L, int sz); // allows for unlimited stack frames
+LUA_API void lua_setstackpolicy(lua_State* L, int reserve, int growth);
 
 LUA_API void lua_xmove(lua_State* from, lua_State* to, int n);
 LUA_API void lua_xpush(lua_State* from, lua_State* to, int idx);
+LUA_API int lua_xclone(lua_State* from, int idx, lua_State* to);
+
+/*
+** shared heaps
+*/
+typedef struct lua_SharedHeap lua_SharedHeap;
+
+LUA_API lua_SharedHeap* lua_newsharedheap(lua_State* L, int idx);
+LUA_API void lua_attachsharedheap(lua_State* L, lua_SharedHeap* heap);
+LUA_API void lua_pushsharedheap(lua_State* L);
+LUA_API size_t lua_sharedheapsize(lua_SharedHeap* heap);
+LUA_API void lua_releasesharedheap(lua_SharedHeap* heap);
 
 /*
 ** access functions (stack -> C)
@@ -184,6 +239,7 @@ LUA_API void lua_pushstring(lua_State* L, const char* s);
 LUA_API const char* lua_pushvfstring(lua_State* L, const char* fmt, va_list argp);
 LUA_API LUA_PRINTF_ATTR(2, 3) const char* lua_pushfstringL(lua_State* L, const char* fmt, ...);
 LUA_API void lua_pushcclosurek(lua_State* L, lua_CFunction fn, const char* debugname, int nup, lua_Continuation cont);
+LUA_API void lua_pushfastcfunction(lua_State* L, lua_CFunction fn, const char* debugname, const lua_FastCall* fast);
 LUA_API void lua_pushboolean(lua_State* L, int b);
 LUA_API int lua_pushthread(lua_State* L);
 
@@ -192,6 +248,8 @@ LUA_API void* lua_newuserdatatagged(lua_State* L, size_t sz, int tag);
 LUA_API void* lua_newuserdatadtor(lua_State* L, size_t sz, void (*dtor)(void*));
 
 LUA_API void* lua_newbuffer(lua_State* L, size_t sz);
+// creates a buffer over host memory without copying it; release is called when the buffer is collected
+LUA_API void lua_newexternalbuffer(lua_State* L, void* data, size_t sz, void (*release)(void* ud, void* data), void* ud);
 
 /*
 ** get functions (Lua -> stack)
@@ -201,6 +259,8 @@ LUA_API int lua_getfield(lua_State* L, int idx, const char* k);
 LUA_API int lua_rawgetfield(lua_State* L, int idx, const char* k);
 LUA_API int lua_rawget(lua_State* L, int idx);
 LUA_API int lua_rawgeti(lua_State* L, int idx, int n);
+LUA_API void lua_rawgetfields(lua_State* L, int idx, int keysidx, int count);
+LUA_API int lua_rawgetnumberfields(lua_State* L, int idx, int keysidx, double* values, int count);
 LUA_API void lua_createtable(lua_State* L, int narr, int nrec);
 
 LUA_API void lua_setreadonly(lua_State* L, int idx, int enabled);
@@ -218,6 +278,10 @@ LUA_API void lua_setfield(lua_State* L, int idx, const char* k);
 LUA_API void lua_rawsetfield(lua_State* L, int idx, const char* k);
 LUA_API void lua_rawset(lua_State* L, int idx);
 LUA_API void lua_rawseti(lua_State* L, int idx, int n);
+LUA_API void lua_rawsetnumbers(lua_State* L, int idx, int n, const double* values, int count);
+LUA_API void lua_rawsetstrings(lua_State* L, int idx, int n, const char* const* values, const size_t* lens, int count);
+LUA_API void lua_rawsetvalues(lua_State* L, int idx, int n, int count);
+LUA_API void lua_rawsetpairs(lua_State* L, int idx, int count);
 LUA_API int lua_setmetatable(lua_State* L, int objindex);
 LUA_API int lua_setfenv(lua_State* L, int idx);
 
@@ -225,6 +289,25 @@ LUA_API int lua_setfenv(lua_State* L, int idx);
 ** `load' and `call' functions (load and run Luau bytecode)
 */
 LUA_API int luau_load(lua_State* L, const char* chunkname, const char* data, size_t size, int env);
+// same as luau_load, but functions other than the main one are decoded when the first closure of each function is created
+LUA_API int luau_loadlazy(lua_State* L, const char* chunkname, const char* data, size_t size, int env);
+// same as luau_loadlazy, but the bytecode is referenced instead of copied, so that one immutable blob can back any number of states
+// data has to stay unchanged until release is called, which happens once the state no longer needs it, including when the load fails
+LUA_API int luau_loadshared(lua_State* L, const char* chunkname, const char* data, size_t size, int env, void (*release)(void* ud, void* data), void* ud);
+// same as luau_load, but functions identical to the ones of the Lua function at index old reuse their loaded prototypes, including native code;
+// functions match when their code, constants, nested functions, chunk name, environment and debug information other than the starting line match
+// line information of the reused functions is moved to their new lines; changed functions are loaded and need to be compiled as usual
+LUA_API int luau_reload(lua_State* L, const char* chunkname, const char* data, size_t size, int env, int old);
+// when enabled, functions that luau_loadlazy and luau_loadshared decode afterwards keep line and local variable information encoded in the
+// bytecode; line numbers are decoded when requested and local variable names are decoded for a few functions at a time
+// bytecode stays referenced while any function keeps its information encoded, so this saves memory when it's shared by luau_loadshared
+LUA_API void lua_setlazydebuginfo(lua_State* L, int enabled);
+// heap images copy everything reachable from a value, so that a state can be set up by loading an image instead of running initialization code
+// names maps objects to strings (lua_saveimage) and strings to objects (lua_loadimage); named objects are referenced instead of copied, which is
+// required for C functions, userdata and threads; lua_saveimage pushes the image as a buffer, lua_loadimage pushes the copy or an error message
+// images only hold Luau bytecode; they can be loaded by any state of the same build and should be treated as trusted input, like bytecode
+LUA_API void lua_saveimage(lua_State* L, int idx, int names);
+LUA_API int lua_loadimage(lua_State* L, const char* data, size_t size, int names);
 LUA_API void lua_call(lua_State* L, int nargs, int nresults);
 LUA_API int lua_pcall(lua_State* L, int nargs, int nresults, int errfunc);
 
@@ -290,6 +373,53 @@ enum lua_GCOp
     LUA_GCSETGOAL,
     LUA_GCSETSTEPMUL,
     LUA_GCSETSTEPSIZE,
+
+    /*
+    ** switch the collector to generational or incremental mode; both return 1 if generational mode was previously enabled
+    **
+    ** in generational mode, objects that survive a collection become old, and most cycles are minor collections that only mark
+    ** and sweep young objects; this reduces the GC work for applications with a large long-lived heap.
+    ** a major collection that traverses the entire heap runs when the heap grows by more than M% (specified as data argument of
+    ** LUA_GCGEN; when 0, the default M=100% is used) compared to the heap size after the last major collection.
+    */
+    LUA_GCGEN,
+    LUA_GCINC,
+
+    /*
+    ** perform an explicit GC step, with the step duration limited by the time budget specified in microseconds
+    **
+    ** GC work is performed in small increments until the deadline is reached or the cycle finishes; note that the atomic phase can't
+    ** be split and may exceed the budget. the step always performs some work, even if the budget is 0.
+    ** returns the estimated amount of work left in the current cycle in KB (based on the previous cycle), or 0 if the cycle has finished
+    */
+    LUA_GCSTEPTIME,
+
+    /*
+    ** enable adaptive pacing with the target duration of GC steps specified in microseconds, or disable it when 0; returns the previous target
+    **
+    ** at the end of each cycle, the step size is set to the amount of work that fits into the target duration based on the measured cost of
+    ** GC work, and the goal is raised above the value set with LUA_GCSETGOAL when allocations are frequent enough for the collector to take
+    ** more than ~10% of execution time; once allocations slow down, the goal returns to the configured value.
+    ** goal and step size are restored when adaptive pacing is disabled
+    */
+    LUA_GCADAPTIVE,
+
+    /*
+    ** evacuate sparse pages: once the sweep leaves a page of collectable objects below the occupancy specified in percent, new objects
+    ** aren't placed into it until the next sweep, so that it can be released when its remaining objects die. this trades up to a cycle
+    ** worth of allocations in new pages for returning memory after a load spike; 0 disables the policy (default), returns the previous threshold
+    */
+    LUA_GCSPARSEPAGE,
+
+    /*
+    ** run a full GC cycle and make all objects that survive it permanent; returns the size of the permanent heap in KB
+    **
+    ** permanent objects are never collected, and the collector doesn't write into their pages anymore: mark and sweep skip them,
+    ** keeping the state they need in a side table instead. this preserves copy-on-write sharing of the heap with processes forked
+    ** after the call, as long as the permanent objects aren't modified. objects they refer to are still marked by every full cycle.
+    ** pages that contain threads or open upvalues stay in the regular heap. can be called again to make newer objects permanent
+    */
+    LUA_GCFREEZE,
 };
 
 LUA_API int lua_gc(lua_State* L, int what, int data);
@@ -302,6 +432,11 @@ LUA_API int lua_gc(lua_State* L, int what, int data);
 LUA_API void lua_setmemcat(lua_State* L, int category);
 LUA_API size_t lua_totalbytes(lua_State* L, int category);
 
+// Allocations that take a memory category over its hard limit fail with a memory error, and going over the soft limit invokes memcatlimit callback
+// The first call also enables tracking of bytes that each category had reachable at the end of the last mark phase, see lua_memcatlivebytes
+LUA_API void lua_setmemcatlimit(lua_State* L, int category, size_t softlimit, size_t hardlimit);
+LUA_API size_t lua_memcatlivebytes(lua_State* L, int category);
+
 /*
 ** miscellaneous functions
 */
@@ -317,6 +452,10 @@ LUA_API uintptr_t lua_encodepointer(lua_State* L, uintptr_t p);
 
 LUA_API double lua_clock();
 
+// When enabled, each NEWTABLE instruction observes the sizes that the previous table it created has grown to and creates further tables with at
+// least these sizes, avoiding repeated rehashing in functions that build tables; functions compiled to native code later use the recorded sizes
+LUA_API void lua_settablefeedback(lua_State* L, int enabled);
+
 LUA_API void lua_setuserdatatag(lua_State* L, int idx, int tag);
 
 typedef void (*lua_Destructor)(lua_State* L, void* userdata);
@@ -324,12 +463,52 @@ typedef void (*lua_Destructor)(lua_State* L, void* userdata);
 LUA_API void lua_setuserdatadtor(lua_State* L, int tag, lua_Destructor dtor);
 LUA_API lua_Destructor lua_getuserdatadtor(lua_State* L, int tag);
 
+// Batched destructor receives the first `size' bytes of up to LUAI_UDATABATCH dead userdata objects with the tag at a time, after the sweep step
+// that freed them or once the batch is full; records are only valid during the call and the same restrictions apply as for lua_Destructor
+// when set, it replaces the destructor of the tag; size is limited to 256 bytes, records of smaller userdata are padded with zeroes
+typedef void (*lua_BatchDestructor)(lua_State* L, int tag, const void* records, int count);
+
+LUA_API void lua_setuserdatabatchdtor(lua_State* L, int tag, size_t size, lua_BatchDestructor dtor);
+
+// fields stored inline in userdata memory; reads and writes don't go through __index/__newindex
+enum lua_UserdataFieldType
+{
+    LUA_UDFIELD_NUMBER,  // double
+    LUA_UDFIELD_FLOAT,   // float, read and written as a number
+    LUA_UDFIELD_INTEGER, // int, read as a number and written with truncation
+    LUA_UDFIELD_BOOLEAN, // unsigned char, 0 or 1
+    LUA_UDFIELD_VECTOR,  // float[LUA_VECTOR_SIZE]
+};
+
+typedef struct lua_UserdataField
+{
+    const char* name;
+    int type;      // lua_UserdataFieldType
+    size_t offset; // byte offset from the start of userdata memory
+    int readonly;
+} lua_UserdataField;
+
+LUA_API void lua_setuserdatafields(lua_State* L, int tag, const lua_UserdataField* fields, int count);
+
 LUA_API void lua_setlightuserdataname(lua_State* L, int tag, const char* name);
 LUA_API const char* lua_getlightuserdataname(lua_State* L, int tag);
 
+LUA_API void lua_setuserbuiltin(lua_State* L, int id, const lua_FastCall* fast);
+
 LUA_API void lua_clonefunction(lua_State* L, int idx);
 
 LUA_API void lua_cleartable(lua_State* L, int idx);
+LUA_API void lua_reservetable(lua_State* L, int idx, int narray, int nrec);
+
+// key handles refer to strings that are interned once and never collected, so that hot binding paths don't hash the key on every access
+typedef struct lua_KeyHandleData* lua_KeyHandle;
+
+LUA_API lua_KeyHandle lua_newkeyhandle(lua_State* L, const char* k, size_t len);
+LUA_API void lua_pushstringh(lua_State* L, lua_KeyHandle k);
+LUA_API int lua_getfieldh(lua_State* L, int idx, lua_KeyHandle k);
+LUA_API int lua_rawgetfieldh(lua_State* L, int idx, lua_KeyHandle k);
+LUA_API void lua_setfieldh(lua_State* L, int idx, lua_KeyHandle k);
+LUA_API void lua_rawsetfieldh(lua_State* L, int idx, lua_KeyHandle k);
 
 LUA_API lua_Alloc lua_getallocf(lua_State* L, void** ud);
 
@@ -339,10 +518,14 @@ LUA_API lua_Alloc lua_getallocf(lua_State* L, void** ud);
 #define LUA_NOREF -1
 #define LUA_REFNIL 0
 
+// references are stored in the registry, so they can also be read with lua_rawgeti(L, LUA_REGISTRYINDEX, ref), unless reference slots are enabled
 LUA_API int lua_ref(lua_State* L, int idx);
 LUA_API void lua_unref(lua_State* L, int ref);
-
-#define lua_getref(L, ref) lua_rawgeti(L, LUA_REGISTRYINDEX, (ref))
+LUA_API int lua_getref(lua_State* L, int ref);
+// when enabled, references are kept in a dedicated slot array instead of the registry: lua_ref and lua_unref are O(1) and the registry doesn't grow
+// with the number of references; it has to be set before the first lua_ref, and code that reads references through the registry has to switch
+// to lua_getref, since lua_rawgeti on LUA_REGISTRYINDEX doesn't see them
+LUA_API void lua_setrefslots(lua_State* L, int enabled);
 
 /*
 ** ===============================================================
@@ -408,6 +591,56 @@ LUA_API int lua_breakpoint(lua_State* L, int funcindex, int line, int enabled);
 typedef void (*lua_Coverage)(void* context, const char* function, int linedefined, int depth, const int* hits, size_t size);
 
 LUA_API void lua_getcoverage(lua_State* L, int funcindex, void* context, lua_Coverage callback);
+// When enabled, coverage instructions only record whether they were reached and are replaced with NOP on the first hit, so that covered code
+// doesn't pay for coverage anymore; lua_getcoverage reports 1 for lines reached this way
+LUA_API void lua_setcoveragefirsthit(lua_State* L, int enabled);
+
+// Opcode counters make the interpreter count executed instructions per opcode and per function; native code isn't used while they are enabled
+#define LUA_OPCODECOUNT 256
+
+typedef void (*lua_OpcodeCounts)(void* context, const char* function, int linedefined, int depth, uint64_t count);
+
+LUA_API void lua_setopcodecounters(lua_State* L, int enabled);
+LUA_API uint64_t lua_getopcodecount(lua_State* L, int op);
+LUA_API void lua_getopcodecounts(lua_State* L, int funcindex, void* context, lua_OpcodeCounts callback);
+
+// Sampling profiler records call stacks into a ring buffer allocated by lua_startprofiler, overwriting the oldest samples when it's full
+// lua_profilersample doesn't allocate or resolve names, so it's safe to call from interrupt callbacks; it returns the number of buffer entries in use
+// lua_getprofilersamples passes the samples to the callback, oldest first, removes them and returns the number of samples that were overwritten
+// Frames can be resolved with lua_getprofilerframe until the callback returns; the callback must not record new samples
+#define LUA_PROFILERMAXDEPTH 128
+
+typedef struct lua_ProfilerFrame
+{
+    const void* function; // function prototype of Lua frames, closure of C frames
+    int pc;               // index of the current instruction of Lua frames, -1 for C frames
+    int native;           // 1 if the frame was running native code
+} lua_ProfilerFrame;
+
+typedef void (*lua_ProfilerSamples)(void* context, int tag, unsigned weight, const lua_ProfilerFrame* frames, int depth);
+
+LUA_API void lua_startprofiler(lua_State* L, int capacity);
+LUA_API void lua_stopprofiler(lua_State* L);
+LUA_API int lua_profilersample(lua_State* L, int tag, unsigned weight);
+LUA_API size_t lua_getprofilersamples(lua_State* L, void* context, lua_ProfilerSamples callback);
+LUA_API int lua_getprofilerframe(lua_State* L, const lua_ProfilerFrame* frame, lua_Debug* ar);
+
+// Captures up to size frames of the call stack starting at level, innermost first, and returns the number of frames captured
+// Like lua_profilersample, it doesn't allocate or resolve names; frames can be resolved with lua_getprofilerframe while their functions are alive
+LUA_API int lua_capturestack(lua_State* L, int level, lua_ProfilerFrame* frames, int size);
+
+// Heap profiler samples an allocation each time `rate' bytes of objects were allocated and keeps the sample with its call stack while the object is alive
+// Up to `capacity' objects are tracked at a time; further samples are dropped until tracked objects are freed
+// lua_getheapprofile passes the samples of live objects to the callback and returns the number of samples that were dropped since the profiler was started
+// A sample's weight is the number of bytes allocated since the previous sample; frames can be resolved with lua_getprofilerframe
+// The callback must not allocate objects or run the collector
+#define LUA_HEAPPROFILERMAXDEPTH 32
+
+typedef void (*lua_HeapSamples)(void* context, int type, int memcat, size_t size, size_t weight, const lua_ProfilerFrame* frames, int depth);
+
+LUA_API void lua_startheapprofiler(lua_State* L, size_t rate, int capacity);
+LUA_API void lua_stopheapprofiler(lua_State* L);
+LUA_API size_t lua_getheapprofile(lua_State* L, void* context, lua_HeapSamples callback);
 
 // Warning: this function is not thread-safe since it stores the result in a shared global array! Only use for debugging.
 LUA_API const char* lua_debugtrace(lua_State* L);
@@ -449,11 +682,47 @@ struct lua_Callbacks
     void (*debugstep)(lua_State* L, lua_Debug* ar);      // gets called after each instruction in single step mode
     void (*debuginterrupt)(lua_State* L, lua_Debug* ar); // gets called when thread execution is interrupted by break in another thread
     void (*debugprotectederror)(lua_State* L);           // gets called when protected call results in an error
+
+    void (*releasepages)(lua_State* L, void* pages); // gets called after a sweep step with GCO pages it emptied; pages must be freed with lua_freepages
+
+    void (*memcatlimit)(lua_State* L, int category, size_t size); // gets called before an allocation takes category over its soft limit; must not allocate
+
+    void (*gcstep)(lua_State* L, int gcstate, double time, int assist); // gets called after each incremental GC step with the state it started in and its duration; must not allocate
 };
 typedef struct lua_Callbacks lua_Callbacks;
 
 LUA_API lua_Callbacks* lua_callbacks(lua_State* L);
 
+// Requested interrupts keep safepoints as a single branch until a request is made: lua_requestinterrupt installs an interrupt callback that
+// removes itself and calls the handler once at the next safepoint; interrupt must not be set otherwise while the handler is used
+// like setting interrupt, lua_requestinterrupt is safe to call from an arbitrary thread
+LUA_API void lua_setinterrupthandler(lua_State* L, void (*handler)(lua_State* L, int gc));
+LUA_API void lua_requestinterrupt(lua_State* L);
+
+// Execution budget of a thread is measured in ticks of a host timer; lua_tick charges a tick to the thread that reaches the next safepoint,
+// and a thread that runs out of budget raises an error at every following tick until the budget is set again; budget of 0 is unlimited
+// ticks are delivered like requested interrupts, so lua_tick is safe to call from an arbitrary thread; coroutines spend the budget of the thread that resumes them
+LUA_API void lua_setbudget(lua_State* L, int ticks);
+LUA_API int lua_getbudget(lua_State* L); // remaining ticks; negative once the budget is exceeded
+LUA_API void lua_tick(lua_State* L);
+
+// frees the page list passed to releasepages callback; doesn't access VM state so it can be called on any thread that can use the allocator
+LUA_API void lua_freepages(lua_Alloc f, void* ud, void* pages);
+
+// Page source supplies the memory of standard size allocator pages in place of frealloc, e.g. from large regions backed by huge pages
+// every page is returned to the source it came from, so a source must outlive the state and the pages passed to releasepages;
+// freepage is called on the thread that calls lua_freepages, and passing NULL to lua_setpagesource switches new pages back to frealloc
+struct lua_PageSource
+{
+    void* context;
+
+    void* (*allocpage)(void* context, size_t size); // returns NULL when out of memory
+    void (*freepage)(void* context, void* page, size_t size);
+};
+typedef struct lua_PageSource lua_PageSource;
+
+LUA_API void lua_setpagesource(lua_State* L, const lua_PageSource* source);
+
 /******************************************************************************
  * Copyright (c) 2019-2023 Roblox Corporation
  * Copyright (C) 1994-2008 Lua.org, PUC-Rio.  All rights reserved.
@@ -116,6 +116,21 @@
 #define LUA_MEMORY_CATEGORIES 256
 #endif
 
+// largest hash part that is stored inline with the table header for tables created with a small hash part (must be power of 2)
+#ifndef LUAI_MAXINLINENODES
+#define LUAI_MAXINLINENODES 4
+#endif
+
+// initial capacity of the slot array used by lua_ref; it doubles when all slots are in use
+#ifndef LUAI_MINREFS
+#define LUAI_MINREFS 16
+#endif
+
+// number of dead userdata records that are collected before a batched destructor is called, see lua_setuserdatabatchdtor
+#ifndef LUAI_UDATABATCH
+#define LUAI_UDATABATCH 256
+#endif
+
 // minimum size for the string table (must be power of 2)
 #ifndef LUA_MINSTRTABSIZE
 #define LUA_MINSTRTABSIZE 32
@@ -127,6 +127,9 @@ LUALIB_API int luaopen_bit32(lua_State* L);
 #define LUA_BUFFERLIBNAME "buffer"
 LUALIB_API int luaopen_buffer(lua_State* L);
 
+#define LUA_JSONLIBNAME "json"
+LUALIB_API int luaopen_json(lua_State* L);
+
 #define LUA_UTF8LIBNAME "utf8"
 LUALIB_API int luaopen_utf8(lua_State* L);
 
@@ -142,3 +145,7 @@ LUALIB_API void luaL_openlibs(lua_State* L);
 // sandbox libraries and globals
 LUALIB_API void luaL_sandbox(lua_State* L);
 LUALIB_API void luaL_sandboxthread(lua_State* L);
+
+// pushes a table that names global functions and tables, as well as functions in global tables, for lua_saveimage (load = 0) or
+// lua_loadimage (load = 1); it's meant to be called right after luaL_openlibs, so that images reference builtin libraries instead of copying them
+LUALIB_API void luaL_imagenames(lua_State* L, int load);
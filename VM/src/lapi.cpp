@@ -2,6 +2,7 @@
 // This code is based on Lua 5.x implementation licensed under MIT License; see lua_LICENSE.txt for details
 #include "lapi.h"
 
+#include "ldebug.h"
 #include "lstate.h"
 #include "lstring.h"
 #include "ltable.h"
@@ -12,6 +13,7 @@
 #include "lvm.h"
 #include "lnumutils.h"
 #include "lbuffer.h"
+#include "lmem.h"
 
 #include <string.h>
 
@@ -58,11 +60,19 @@ const char* luau_ident = "$Luau: Copyright (C) 2019-2023 Roblox Corporation $\n"
         L->top = p; \
     }
 
-#define updateatom(L, ts) \
-    { \
-        if (ts->atom == ATOM_UNDEF) \
-            ts->atom = L->global->cb.useratom ? L->global->cb.useratom(ts->data, ts->len) : -1; \
-    }
+// atoms of shared strings are not cached since the strings are read by other states concurrently
+static int getatom(lua_State* L, TString* ts)
+{
+    if (ts->atom != ATOM_UNDEF)
+        return ts->atom;
+
+    int16_t atom = L->global->cb.useratom ? L->global->cb.useratom(ts->data, ts->len) : -1;
+
+    if (!isshared(obj2gco(ts)))
+        ts->atom = atom;
+
+    return atom;
+}
 
 static Table* getcurrenv(lua_State* L)
 {
@@ -151,6 +161,19 @@ void lua_rawcheckstack(lua_State* L, int size)
     expandstacklimit(L, L->top + size);
 }
 
+void lua_setstackpolicy(lua_State* L, int reserve, int growth)
+{
+    api_check(L, reserve >= 0);
+    api_check(L, growth >= 2);
+    L->stackreserve = reserve;
+    L->stackgrowth = growth;
+    // reserved space is allocated up front so that recursion doesn't need to grow the stack
+    if (L->stacksize - EXTRA_STACK < reserve)
+        luaD_reallocstack(L, reserve);
+    if (L->size_ci < stackcisize(reserve))
+        luaD_reallocCI(L, stackcisize(reserve));
+}
+
 void lua_xmove(lua_State* from, lua_State* to, int n)
 {
     if (from == to)
@@ -177,6 +200,130 @@ void lua_xpush(lua_State* from, lua_State* to, int idx)
     api_incr_top(to);
 }
 
+static int clonevalue(lua_State* L, const TValue* o, int visited, int depth);
+
+static int clonetable(lua_State* L, Table* h, int visited, int depth)
+{
+    if (depth >= LUAI_MAXCCALLS)
+        return 0;
+
+    // tables that have been cloned already are reused to preserve shared references and cycles
+    Table* vt = hvalue(index2addr(L, visited));
+    TValue key;
+    setpvalue(&key, h, 0);
+
+    const TValue* existing = luaH_get(vt, &key);
+    if (!ttisnil(existing))
+    {
+        setobj2s(L, L->top, existing);
+        api_incr_top(L);
+        return 1;
+    }
+
+    lua_rawcheckstack(L, 3);
+
+    Table* t = luaH_new(L, h->sizearray, h->node == &luaH_dummynode ? 0 : sizenode(h));
+    sethvalue(L, L->top, t);
+    api_incr_top(L);
+
+    TValue* slot = luaH_set(L, vt, &key);
+    sethvalue(L, slot, t);
+    luaC_barriert(L, vt, L->top - 1);
+
+    for (int i = 0; i < h->sizearray; i++)
+    {
+        if (ttisnil(&h->array[i]))
+            continue;
+
+        if (!clonevalue(L, &h->array[i], visited, depth + 1))
+            return 0;
+
+        setobj2t(L, &t->array[i], L->top - 1);
+        luaC_barriert(L, t, L->top - 1);
+        L->top--;
+    }
+
+    for (int i = 0; i < sizenode(h); i++)
+    {
+        LuaNode* n = gnode(h, i);
+
+        if (ttisnil(gval(n)))
+            continue;
+
+        TValue k;
+        getnodekey(L, &k, n);
+
+        if (!clonevalue(L, &k, visited, depth + 1) || !clonevalue(L, gval(n), visited, depth + 1))
+            return 0;
+
+        TValue* v = luaH_set(L, t, L->top - 2);
+        setobj2t(L, v, L->top - 1);
+        luaC_barriert(L, t, L->top - 1);
+        L->top -= 2;
+    }
+
+    t->readonly = h->readonly & TABLE_FROZEN;
+    return 1;
+}
+
+// pushes a copy of a value that may belong to another VM, returns 0 if the value can't be copied
+static int clonevalue(lua_State* L, const TValue* o, int visited, int depth)
+{
+    switch (ttype(o))
+    {
+    case LUA_TNIL:
+    case LUA_TBOOLEAN:
+    case LUA_TLIGHTUSERDATA:
+    case LUA_TNUMBER:
+    case LUA_TVECTOR:
+        setobj2s(L, L->top, o);
+        api_incr_top(L);
+        return 1;
+    case LUA_TSTRING:
+        setsvalue(L, L->top, luaS_newlstr(L, svalue(o), tsvalue(o)->len));
+        api_incr_top(L);
+        return 1;
+    case LUA_TBUFFER:
+    {
+        Buffer* b = bufvalue(o);
+        Buffer* nb = luaB_newbuffer(L, bufferlen(b));
+        memcpy(nb->data, bufferdata(b), bufferlen(b));
+        setbufvalue(L, L->top, nb);
+        api_incr_top(L);
+        return 1;
+    }
+    case LUA_TTABLE:
+        return clonetable(L, hvalue(o), visited, depth);
+    default:
+        return 0;
+    }
+}
+
+int lua_xclone(lua_State* from, int idx, lua_State* to)
+{
+    // the source value is copied first since the two states may share a stack
+    TValue o;
+    setobj(from, &o, index2addr(from, idx));
+
+    luaC_checkGC(to);
+    luaC_threadbarrier(to);
+    lua_rawcheckstack(to, 2);
+
+    // clones of visited tables are indexed by the source table address
+    sethvalue(to, to->top, luaH_new(to, 0, 0));
+    api_incr_top(to);
+    int visited = lua_gettop(to);
+
+    if (!clonevalue(to, &o, visited, 0))
+    {
+        lua_settop(to, visited - 1);
+        return 0;
+    }
+
+    lua_remove(to, visited);
+    return 1;
+}
+
 lua_State* lua_newthread(lua_State* L)
 {
     luaC_checkGC(L);
@@ -190,6 +337,29 @@ lua_State* lua_newthread(lua_State* L)
     return L1;
 }
 
+lua_State* lua_acquirethread(lua_State* L)
+{
+    global_State* g = L->global;
+    if (g->threadpoolsize == 0)
+    {
+        g->threadpoolmisses++;
+        return lua_newthread(L);
+    }
+
+    luaC_checkGC(L);
+    luaC_threadbarrier(L);
+    lua_State* L1 = g->threadpool[--g->threadpoolsize];
+    L1->pooled = false;
+    L1->gt = L->gt;
+    luaC_objbarrier(L, L1, L->gt);
+    L1->activememcat = L->activememcat;
+    L1->singlestep = L->singlestep;
+    setthvalue(L, L->top, L1);
+    api_incr_top(L);
+    g->threadpoolhits++;
+    return L1;
+}
+
 lua_State* lua_mainthread(lua_State* L)
 {
     return L->global->mainthread;
@@ -447,10 +617,7 @@ const char* lua_tostringatom(lua_State* L, int idx, int* atom)
         return NULL;
     TString* s = tsvalue(o);
     if (atom)
-    {
-        updateatom(L, s);
-        *atom = s->atom;
-    }
+        *atom = getatom(L, s);
     return getstr(s);
 }
 
@@ -460,10 +627,7 @@ const char* lua_namecallatom(lua_State* L, int* atom)
     if (!s)
         return NULL;
     if (atom)
-    {
-        updateatom(L, s);
-        *atom = s->atom;
-    }
+        *atom = getatom(L, s);
     return getstr(s);
 }
 
@@ -485,7 +649,7 @@ int lua_objlen(lua_State* L, int idx)
     case LUA_TUSERDATA:
         return uvalue(o)->len;
     case LUA_TBUFFER:
-        return bufvalue(o)->len;
+        return bufferlen(bufvalue(o));
     case LUA_TTABLE:
         return luaH_getn(hvalue(o));
     default:
@@ -560,9 +724,9 @@ void* lua_tobuffer(lua_State* L, int idx, size_t* len)
     Buffer* b = bufvalue(o);
 
     if (len)
-        *len = b->len;
+        *len = bufferlen(b);
 
-    return b->data;
+    return bufferdata(b);
 }
 
 const void* lua_topointer(lua_State* L, int idx)
@@ -673,6 +837,14 @@ void lua_pushcclosurek(lua_State* L, lua_CFunction fn, const char* debugname, in
     api_incr_top(L);
 }
 
+void lua_pushfastcfunction(lua_State* L, lua_CFunction fn, const char* debugname, const lua_FastCall* fast)
+{
+    api_check(L, fast->nargs >= 0 && fast->nargs <= LUA_FASTMAXVALUES);
+    api_check(L, fast->nresults >= 0 && fast->nresults <= LUA_FASTMAXVALUES);
+    lua_pushcclosurek(L, fn, debugname, 0, NULL);
+    clvalue(L->top - 1)->c.fast = fast;
+}
+
 void lua_pushboolean(lua_State* L, int b)
 {
     setbvalue(L->top, (b != 0)); // ensure that true is 1
@@ -750,6 +922,58 @@ int lua_rawgeti(lua_State* L, int idx, int n)
     return ttype(L->top - 1);
 }
 
+// keys are read from the array at keysidx; keeping that array alive (e.g. with lua_ref) keeps the keys interned, so they don't need to
+// be created again for every lookup
+static const TValue* rawgetfield(Table* t, Table* keys, int i)
+{
+    const TValue* key = luaH_getnum(keys, i + 1);
+    return ttisstring(key) ? luaH_getstr(t, tsvalue(key)) : luaH_get(t, key);
+}
+
+void lua_rawgetfields(lua_State* L, int idx, int keysidx, int count)
+{
+    luaC_threadbarrier(L);
+    StkId t = index2addr(L, idx);
+    api_check(L, ttistable(t));
+    StkId k = index2addr(L, keysidx);
+    api_check(L, ttistable(k));
+    api_check(L, count >= 0 && count <= L->ci->top - L->top);
+
+    Table* h = hvalue(t);
+    Table* keys = hvalue(k);
+
+    for (int i = 0; i < count; ++i)
+        setobj2s(L, L->top + i, rawgetfield(h, keys, i));
+
+    L->top += count;
+}
+
+int lua_rawgetnumberfields(lua_State* L, int idx, int keysidx, double* values, int count)
+{
+    StkId t = index2addr(L, idx);
+    api_check(L, ttistable(t));
+    StkId k = index2addr(L, keysidx);
+    api_check(L, ttistable(k));
+
+    Table* h = hvalue(t);
+    Table* keys = hvalue(k);
+    int found = 0;
+
+    // fields that don't hold a number leave the value untouched, so the buffer can be filled with defaults beforehand
+    for (int i = 0; i < count; ++i)
+    {
+        const TValue* v = rawgetfield(h, keys, i);
+
+        if (ttisnumber(v))
+        {
+            values[i] = nvalue(v);
+            found++;
+        }
+    }
+
+    return found;
+}
+
 void lua_createtable(lua_State* L, int narray, int nrec)
 {
     luaC_checkGC(L);
@@ -764,7 +988,8 @@ void lua_setreadonly(lua_State* L, int objindex, int enabled)
     api_check(L, ttistable(o));
     Table* t = hvalue(o);
     api_check(L, t != hvalue(registry(L)));
-    t->readonly = bool(enabled);
+    api_check(L, !isshared(obj2gco(t)));
+    t->readonly = enabled ? (t->readonly | TABLE_FROZEN) : (t->readonly & ~TABLE_FROZEN);
 }
 
 int lua_getreadonly(lua_State* L, int objindex)
@@ -772,7 +997,7 @@ int lua_getreadonly(lua_State* L, int objindex)
     const TValue* o = index2addr(L, objindex);
     api_check(L, ttistable(o));
     Table* t = hvalue(o);
-    int res = t->readonly;
+    int res = t->readonly & TABLE_FROZEN;
     return res;
 }
 
@@ -781,7 +1006,9 @@ void lua_setsafeenv(lua_State* L, int objindex, int enabled)
     const TValue* o = index2addr(L, objindex);
     api_check(L, ttistable(o));
     Table* t = hvalue(o);
+    api_check(L, !isshared(obj2gco(t)));
     t->safeenv = bool(enabled);
+    t->readonly &= ~TABLE_EXPOSEDENV;
 }
 
 int lua_getmetatable(lua_State* L, int objindex)
@@ -859,7 +1086,7 @@ void lua_rawsetfield(lua_State* L, int idx, const char* k)
     StkId t = index2addr(L, idx);
     api_check(L, ttistable(t));
     if (hvalue(t)->readonly)
-        luaG_readonlyerror(L);
+        luaH_prepwrite(L, hvalue(t));
     setobj2t(L, luaH_setstr(L, hvalue(t), luaS_new(L, k)), L->top - 1);
     luaC_barriert(L, hvalue(t), L->top - 1);
     L->top--;
@@ -871,7 +1098,7 @@ void lua_rawset(lua_State* L, int idx)
     StkId t = index2addr(L, idx);
     api_check(L, ttistable(t));
     if (hvalue(t)->readonly)
-        luaG_readonlyerror(L);
+        luaH_prepwrite(L, hvalue(t));
     setobj2t(L, luaH_set(L, hvalue(t), L->top - 2), L->top - 1);
     luaC_barriert(L, hvalue(t), L->top - 1);
     L->top -= 2;
@@ -883,12 +1110,122 @@ void lua_rawseti(lua_State* L, int idx, int n)
     StkId o = index2addr(L, idx);
     api_check(L, ttistable(o));
     if (hvalue(o)->readonly)
-        luaG_readonlyerror(L);
+        luaH_prepwrite(L, hvalue(o));
     setobj2t(L, luaH_setnum(L, hvalue(o), n), L->top - 1);
     luaC_barriert(L, hvalue(o), L->top - 1);
     L->top--;
 }
 
+// returns the slots for keys n..n+count-1 when they can be stored in the array part; the array is only extended when the range starts
+// inside of it or right after it, so that a sparse range doesn't allocate a large array
+static TValue* rawsetarray(lua_State* L, Table* t, int n, int count)
+{
+    api_check(L, n >= 1 && count >= 0 && count <= INT_MAX - n);
+
+    if (n - 1 > t->sizearray)
+        return NULL;
+
+    if (n - 1 + count > t->sizearray)
+        luaH_resizearray(L, t, n - 1 + count);
+
+    return &t->array[n - 1];
+}
+
+void lua_rawsetnumbers(lua_State* L, int idx, int n, const double* values, int count)
+{
+    StkId o = index2addr(L, idx);
+    api_check(L, ttistable(o));
+    Table* t = hvalue(o);
+    if (t->readonly)
+        luaH_prepwrite(L, t);
+
+    // numbers are not collectable, so no barrier is needed
+    if (TValue* array = rawsetarray(L, t, n, count))
+    {
+        for (int i = 0; i < count; ++i)
+            setnvalue(&array[i], values[i]);
+    }
+    else
+    {
+        for (int i = 0; i < count; ++i)
+            setnvalue(luaH_setnum(L, t, n + i), values[i]);
+    }
+}
+
+void lua_rawsetstrings(lua_State* L, int idx, int n, const char* const* values, const size_t* lens, int count)
+{
+    StkId o = index2addr(L, idx);
+    api_check(L, ttistable(o));
+    Table* t = hvalue(o);
+    if (t->readonly)
+        luaH_prepwrite(L, t);
+
+    // strings are stored as soon as they are created and no collection step can run in between, so a single barrier at the end is enough
+    if (TValue* array = rawsetarray(L, t, n, count))
+    {
+        for (int i = 0; i < count; ++i)
+            setsvalue(L, &array[i], luaS_newlstr(L, values[i], lens ? lens[i] : strlen(values[i])));
+    }
+    else
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            TString* ts = luaS_newlstr(L, values[i], lens ? lens[i] : strlen(values[i]));
+            setsvalue(L, luaH_setnum(L, t, n + i), ts);
+        }
+    }
+
+    luaC_barrierfast(L, t);
+}
+
+void lua_rawsetvalues(lua_State* L, int idx, int n, int count)
+{
+    api_checknelems(L, count);
+    StkId o = index2addr(L, idx);
+    api_check(L, ttistable(o));
+    Table* t = hvalue(o);
+    if (t->readonly)
+        luaH_prepwrite(L, t);
+
+    StkId first = L->top - count;
+
+    if (TValue* array = rawsetarray(L, t, n, count))
+    {
+        for (int i = 0; i < count; ++i)
+            setobj2t(L, &array[i], first + i);
+    }
+    else
+    {
+        for (int i = 0; i < count; ++i)
+            setobj2t(L, luaH_setnum(L, t, n + i), first + i);
+    }
+
+    luaC_barrierfast(L, t);
+    L->top = first;
+}
+
+void lua_rawsetpairs(lua_State* L, int idx, int count)
+{
+    api_check(L, count >= 0 && count <= INT_MAX / 2);
+    api_checknelems(L, count * 2);
+    StkId o = index2addr(L, idx);
+    api_check(L, ttistable(o));
+    Table* t = hvalue(o);
+    if (t->readonly)
+        luaH_prepwrite(L, t);
+
+    StkId first = L->top - count * 2;
+
+    // the hash part is sized for the new keys up front, so that inserting them doesn't rehash repeatedly
+    luaH_reserve(L, t, t->sizearray, count);
+
+    for (int i = 0; i < count; ++i)
+        setobj2t(L, luaH_set(L, t, first + i * 2), first + i * 2 + 1);
+
+    luaC_barrierfast(L, t);
+    L->top = first;
+}
+
 int lua_setmetatable(lua_State* L, int objindex)
 {
     api_checknelems(L, 1);
@@ -904,8 +1241,14 @@ int lua_setmetatable(lua_State* L, int objindex)
     {
     case LUA_TTABLE:
     {
-        if (hvalue(obj)->readonly)
+        if (hvalue(obj)->readonly & TABLE_FROZEN)
             luaG_readonlyerror(L);
+        // the metatable of an environment can provide globals through __index
+        if (hvalue(obj)->readonly & TABLE_EXPOSEDENV)
+            luaH_resetsafeenv(hvalue(obj));
+        // tables in the weak list have to be traversed again since the weak mode may change
+        if (isweak(obj2gco(hvalue(obj))))
+            luaC_barrierfast(L, hvalue(obj));
         hvalue(obj)->metatable = mt;
         if (mt)
             luaC_objbarrier(L, hvalue(obj), mt);
@@ -1092,8 +1435,11 @@ int lua_gc(lua_State* L, int what, int data)
         break;
     }
     case LUA_GCSTEP:
+    case LUA_GCSTEPTIME:
     {
-        size_t amount = (cast_to(size_t, data) << 10);
+        bool timed = what == LUA_GCSTEPTIME;
+        size_t amount = timed ? 0 : (cast_to(size_t, data) << 10);
+        double deadline = timed ? lua_clock() + data * 1e-6 : 0.0;
         ptrdiff_t oldcredit = g->gcstate == GCSpause ? 0 : g->GCthreshold - g->totalbytes;
 
         // temporarily adjust the threshold so that we can perform GC work
@@ -1121,6 +1467,15 @@ int lua_gc(lua_State* L, int what, int data)
                 res = 1; // signal it
                 break;
             }
+
+            // timed steps ignore the amount of work and keep going until the deadline
+            if (timed)
+            {
+                if (lua_clock() >= deadline)
+                    break;
+
+                g->GCthreshold = g->totalbytes;
+            }
         }
 
 #ifdef LUAI_GCMETRICS
@@ -1154,12 +1509,17 @@ int lua_gc(lua_State* L, int what, int data)
             ptrdiff_t newthreshold = g->totalbytes + actualwork + oldcredit;
             g->GCthreshold = newthreshold < 0 ? 0 : newthreshold;
         }
+
+        // timed steps report the estimated amount of work left in the cycle in KB (rounded up), 0 when the cycle has finished
+        if (timed)
+            res = int((luaC_remainingwork(g) + 1023) >> 10);
         break;
     }
     case LUA_GCSETGOAL:
     {
         res = g->gcgoal;
         g->gcgoal = data;
+        g->gcadaptivegoal = data;
         break;
     }
     case LUA_GCSETSTEPMUL:
@@ -1175,6 +1535,48 @@ int lua_gc(lua_State* L, int what, int data)
         g->gcstepsize = data << 10;
         break;
     }
+    case LUA_GCGEN:
+    {
+        res = g->gcgen;
+        g->gcgenmajormul = data > 0 ? data : LUAI_GCGENMAJORMUL;
+        luaC_setgenerational(L, true);
+        break;
+    }
+    case LUA_GCINC:
+    {
+        res = g->gcgen;
+        luaC_setgenerational(L, false);
+        break;
+    }
+    case LUA_GCADAPTIVE:
+    {
+        res = g->gcadaptivepause;
+
+        if (data > 0 && !g->gcadaptivepause)
+        {
+            g->gcadaptivegoal = g->gcgoal;
+            g->gcadaptivestepsize = g->gcstepsize;
+        }
+        else if (data <= 0 && g->gcadaptivepause)
+        {
+            g->gcgoal = g->gcadaptivegoal;
+            g->gcstepsize = g->gcadaptivestepsize;
+        }
+
+        g->gcadaptivepause = data > 0 ? data : 0;
+        break;
+    }
+    case LUA_GCSPARSEPAGE:
+    {
+        res = g->gcsparsepage;
+        g->gcsparsepage = data > 0 ? (data < 100 ? data : 100) : 0;
+        break;
+    }
+    case LUA_GCFREEZE:
+    {
+        res = cast_int(luaC_freeze(L) >> 10);
+        break;
+    }
     default:
         res = -1; // invalid option
     }
@@ -1306,7 +1708,16 @@ void* lua_newbuffer(lua_State* L, size_t sz)
     return b->data;
 }
 
-static const char* aux_upvalue(StkId fi, int n, TValue** val)
+void lua_newexternalbuffer(lua_State* L, void* data, size_t sz, void (*release)(void* ud, void* data), void* ud)
+{
+    luaC_checkGC(L);
+    luaC_threadbarrier(L);
+    Buffer* b = luaB_newexternalbuffer(L, data, sz, release, ud);
+    setbufvalue(L, L->top, b);
+    api_incr_top(L);
+}
+
+static const char* aux_upvalue(lua_State* L, StkId fi, int n, TValue** val)
 {
     Closure* f;
     if (!ttisfunction(fi))
@@ -1324,6 +1735,7 @@ static const char* aux_upvalue(StkId fi, int n, TValue** val)
         Proto* p = f->l.p;
         if (!(1 <= n && n <= p->nups)) // not a valid upvalue
             return NULL;
+        luaV_loaddebuginfo(L, p, /* keep= */ false);
         TValue* r = &f->l.uprefs[n - 1];
         *val = ttisupval(r) ? upvalue(r)->v : r;
         if (!(1 <= n && n <= p->sizeupvalues)) // don't have a name for this upvalue
@@ -1336,7 +1748,7 @@ const char* lua_getupvalue(lua_State* L, int funcindex, int n)
 {
     luaC_threadbarrier(L);
     TValue* val;
-    const char* name = aux_upvalue(index2addr(L, funcindex), n, &val);
+    const char* name = aux_upvalue(L, index2addr(L, funcindex), n, &val);
     if (name)
     {
         setobj2s(L, L->top, val);
@@ -1350,7 +1762,7 @@ const char* lua_setupvalue(lua_State* L, int funcindex, int n)
     api_checknelems(L, 1);
     StkId fi = index2addr(L, funcindex);
     TValue* val;
-    const char* name = aux_upvalue(fi, n, &val);
+    const char* name = aux_upvalue(L, fi, n, &val);
     if (name)
     {
         L->top--;
@@ -1366,13 +1778,18 @@ uintptr_t lua_encodepointer(lua_State* L, uintptr_t p)
     return uintptr_t((g->ptrenckey[0] * p + g->ptrenckey[2]) ^ (g->ptrenckey[1] * p + g->ptrenckey[3]));
 }
 
+void lua_settablefeedback(lua_State* L, int enabled)
+{
+    L->global->tablefeedback = bool(enabled);
+}
+
 int lua_ref(lua_State* L, int idx)
 {
     api_check(L, idx != LUA_REGISTRYINDEX); // idx is a stack index for value
     int ref = LUA_REFNIL;
     global_State* g = L->global;
     StkId p = index2addr(L, idx);
-    if (!ttisnil(p))
+    if (!ttisnil(p) && !g->refslots)
     {
         Table* reg = hvalue(registry(L));
 
@@ -1392,6 +1809,28 @@ int lua_ref(lua_State* L, int idx)
         setobj2t(L, slot, p);
         luaC_barriert(L, reg, p);
     }
+    else if (!ttisnil(p))
+    {
+        if (g->reffree != 0)
+        { // reuse existing slot
+            ref = g->reffree;
+            g->reffree = int(nvalue(&g->refs[ref]));
+        }
+        else
+        { // no free elements
+            if (g->refsused >= g->sizerefs)
+            {
+                int newsize = g->sizerefs ? g->sizerefs * 2 : LUAI_MINREFS;
+                luaM_reallocarray(L, g->refs, g->sizerefs, newsize, TValue, 0);
+                g->sizerefs = newsize;
+            }
+
+            ref = g->refsused++; // create new reference
+        }
+
+        setobj(L, &g->refs[ref], p);
+        luaC_refbarrier(L, p);
+    }
     return ref;
 }
 
@@ -1401,10 +1840,49 @@ void lua_unref(lua_State* L, int ref)
         return;
 
     global_State* g = L->global;
-    Table* reg = hvalue(registry(L));
-    TValue* slot = luaH_setnum(L, reg, ref);
-    setnvalue(slot, g->registryfree); // NB: no barrier needed because value isn't collectable
-    g->registryfree = ref;
+
+    if (!g->refslots)
+    {
+        Table* reg = hvalue(registry(L));
+        TValue* slot = luaH_setnum(L, reg, ref);
+        setnvalue(slot, g->registryfree); // NB: no barrier needed because value isn't collectable
+        g->registryfree = ref;
+        return;
+    }
+
+    api_check(L, ref < g->refsused);
+    setnvalue(&g->refs[ref], g->reffree); // NB: no barrier needed because value isn't collectable
+    g->reffree = ref;
+}
+
+int lua_getref(lua_State* L, int ref)
+{
+    global_State* g = L->global;
+
+    if (!g->refslots)
+        return lua_rawgeti(L, LUA_REGISTRYINDEX, ref);
+
+    luaC_threadbarrier(L);
+    if (ref > LUA_REFNIL && ref < g->refsused)
+    {
+        setobj2s(L, L->top, &g->refs[ref]);
+    }
+    else
+    {
+        setnilvalue(L->top);
+    }
+    api_incr_top(L);
+    return ttype(L->top - 1);
+}
+
+void lua_setrefslots(lua_State* L, int enabled)
+{
+    global_State* g = L->global;
+
+    // references that were already created can't be moved
+    api_check(L, g->refsused == 1 && g->registryfree == 0 && luaH_getn(hvalue(registry(L))) == 0);
+
+    g->refslots = bool(enabled);
 }
 
 void lua_setuserdatatag(lua_State* L, int idx, int tag)
@@ -1421,12 +1899,84 @@ void lua_setuserdatadtor(lua_State* L, int tag, lua_Destructor dtor)
     L->global->udatagc[tag] = dtor;
 }
 
+void lua_setuserdatabatchdtor(lua_State* L, int tag, size_t size, lua_BatchDestructor dtor)
+{
+    api_check(L, unsigned(tag) < LUA_UTAG_LIMIT);
+    api_check(L, size <= 256);
+
+    global_State* g = L->global;
+
+    if (!g->udatabatch)
+    {
+        if (!dtor)
+            return;
+
+        g->udatabatch = luaM_newarray(L, LUA_UTAG_LIMIT, UdataBatch*, 0);
+        memset(g->udatabatch, 0, LUA_UTAG_LIMIT * sizeof(UdataBatch*));
+    }
+
+    if (UdataBatch* batch = g->udatabatch[tag])
+    {
+        // records collected for the previous destructor are delivered to it
+        luaU_flushbatches(L);
+
+        luaM_free_(L, batch, sizeudatabatch(batch->size), 0);
+        g->udatabatch[tag] = NULL;
+    }
+
+    if (dtor)
+    {
+        UdataBatch* batch = (UdataBatch*)luaM_new_(L, sizeudatabatch(size), 0);
+        batch->dtor = dtor;
+        batch->size = int(size);
+        batch->count = 0;
+
+        g->udatabatch[tag] = batch;
+    }
+}
+
 lua_Destructor lua_getuserdatadtor(lua_State* L, int tag)
 {
     api_check(L, unsigned(tag) < LUA_UTAG_LIMIT);
     return L->global->udatagc[tag];
 }
 
+void lua_setuserdatafields(lua_State* L, int tag, const lua_UserdataField* fields, int count)
+{
+    api_check(L, unsigned(tag) < LUA_UTAG_LIMIT);
+    api_check(L, count >= 0);
+    global_State* g = L->global;
+
+    UdataField* layout = count ? luaM_newarray(L, count, UdataField, 0) : NULL;
+
+    for (int i = 0; i < count; i++)
+    {
+        api_check(L, unsigned(fields[i].type) <= LUA_UDFIELD_VECTOR);
+        api_check(L, fields[i].offset <= UINT32_MAX);
+
+        TString* name = luaS_new(L, fields[i].name);
+        if (!isfixed(obj2gco(name)))
+            luaS_fix(name); // field names are referenced by the global state
+
+        layout[i].name = name;
+        layout[i].type = uint8_t(fields[i].type);
+        layout[i].readonly = fields[i].readonly != 0;
+        layout[i].offset = uint32_t(fields[i].offset);
+    }
+
+    luaM_freearray(L, g->udatafields[tag], g->udatafieldcount[tag], UdataField, 0);
+    g->udatafields[tag] = layout;
+    g->udatafieldcount[tag] = count;
+}
+
+void lua_setuserbuiltin(lua_State* L, int id, const lua_FastCall* fast)
+{
+    api_check(L, unsigned(id) < LUA_USERBUILTINS);
+    api_check(L, !fast || (fast->nargs >= 0 && fast->nargs <= LUA_FASTMAXVALUES));
+    api_check(L, !fast || (fast->nresults >= 0 && fast->nresults <= LUA_FASTMAXVALUES));
+    L->global->userbuiltins[id] = fast;
+}
+
 void lua_setlightuserdataname(lua_State* L, int tag, const char* name)
 {
     api_check(L, unsigned(tag) < LUA_LUTAG_LIMIT);
@@ -1465,15 +2015,172 @@ void lua_cleartable(lua_State* L, int idx)
     api_check(L, ttistable(t));
     Table* tt = hvalue(t);
     if (tt->readonly)
-        luaG_readonlyerror(L);
+        luaH_prepwrite(L, tt);
     luaH_clear(tt);
 }
 
+void lua_reservetable(lua_State* L, int idx, int narray, int nrec)
+{
+    StkId t = index2addr(L, idx);
+    api_check(L, ttistable(t));
+    api_check(L, narray >= 0 && nrec >= 0);
+    Table* tt = hvalue(t);
+    if (tt->readonly)
+        luaH_prepwrite(L, tt);
+    luaH_reserve(L, tt, narray, nrec);
+}
+
+lua_KeyHandle lua_newkeyhandle(lua_State* L, const char* k, size_t len)
+{
+    TString* ts = luaS_newlstr(L, k, len);
+    if (!isfixed(obj2gco(ts)))
+        luaS_fix(ts); // handles are held by the host and can't be traversed by the collector
+    return reinterpret_cast<lua_KeyHandle>(ts);
+}
+
+void lua_pushstringh(lua_State* L, lua_KeyHandle k)
+{
+    luaC_threadbarrier(L);
+    setsvalue(L, L->top, reinterpret_cast<TString*>(k));
+    api_incr_top(L);
+}
+
+int lua_getfieldh(lua_State* L, int idx, lua_KeyHandle k)
+{
+    luaC_threadbarrier(L);
+    StkId t = index2addr(L, idx);
+    api_checkvalidindex(L, t);
+    TValue key;
+    setsvalue(L, &key, reinterpret_cast<TString*>(k));
+    luaV_gettable(L, t, &key, L->top);
+    api_incr_top(L);
+    return ttype(L->top - 1);
+}
+
+int lua_rawgetfieldh(lua_State* L, int idx, lua_KeyHandle k)
+{
+    luaC_threadbarrier(L);
+    StkId t = index2addr(L, idx);
+    api_check(L, ttistable(t));
+    setobj2s(L, L->top, luaH_getstr(hvalue(t), reinterpret_cast<TString*>(k)));
+    api_incr_top(L);
+    return ttype(L->top - 1);
+}
+
+void lua_setfieldh(lua_State* L, int idx, lua_KeyHandle k)
+{
+    api_checknelems(L, 1);
+    StkId t = index2addr(L, idx);
+    api_checkvalidindex(L, t);
+    TValue key;
+    setsvalue(L, &key, reinterpret_cast<TString*>(k));
+    luaV_settable(L, t, &key, L->top - 1);
+    L->top--;
+}
+
+void lua_rawsetfieldh(lua_State* L, int idx, lua_KeyHandle k)
+{
+    api_checknelems(L, 1);
+    StkId t = index2addr(L, idx);
+    api_check(L, ttistable(t));
+    if (hvalue(t)->readonly)
+        luaH_prepwrite(L, hvalue(t));
+    setobj2t(L, luaH_setstr(L, hvalue(t), reinterpret_cast<TString*>(k)), L->top - 1);
+    luaC_barriert(L, hvalue(t), L->top - 1);
+    L->top--;
+}
+
 lua_Callbacks* lua_callbacks(lua_State* L)
 {
     return &L->global->cb;
 }
 
+static void requestedinterrupt(lua_State* L, int gc)
+{
+    global_State* g = L->global;
+
+    // errors can't be raised from collector safepoints, so ticks wait for the next safepoint of running code
+    if (gc >= 0 && g->pendingticks)
+        return;
+
+    // callback is removed before the handler runs, so that a request made by the handler or during it isn't lost
+    g->cb.interrupt = NULL;
+
+    if (int ticks = g->pendingticks)
+    {
+        g->pendingticks = 0;
+
+        if (L->budget > 0 && (L->budget -= ticks) <= 0)
+            L->budget = -1;
+
+        if (L->budget < 0)
+            luaG_runerror(L, "execution budget exceeded");
+    }
+
+    if (g->interruptrequested)
+    {
+        g->interruptrequested = false;
+
+        if (g->interrupthandler && gc < 0)
+        {
+            // safepoints can be reached with the whole frame in use; like debug hooks, the handler gets LUA_MINSTACK free slots
+            ptrdiff_t citop = savestack(L, L->ci->top);
+            luaD_checkstack(L, LUA_MINSTACK);
+            L->ci->top = L->top + LUA_MINSTACK;
+
+            g->interrupthandler(L, gc);
+
+            L->ci->top = restorestack(L, citop);
+        }
+        else if (g->interrupthandler)
+        {
+            // collector safepoints can't move the stack since the running code might hold pointers into it
+            g->interrupthandler(L, gc);
+        }
+    }
+}
+
+void lua_setinterrupthandler(lua_State* L, void (*handler)(lua_State* L, int gc))
+{
+    L->global->interrupthandler = handler;
+}
+
+void lua_requestinterrupt(lua_State* L)
+{
+    global_State* g = L->global;
+    g->interruptrequested = true;
+    g->cb.interrupt = requestedinterrupt;
+}
+
+void lua_setbudget(lua_State* L, int ticks)
+{
+    api_check(L, ticks >= 0);
+    L->budget = ticks;
+}
+
+int lua_getbudget(lua_State* L)
+{
+    return L->budget;
+}
+
+void lua_tick(lua_State* L)
+{
+    global_State* g = L->global;
+    g->pendingticks++;
+    g->cb.interrupt = requestedinterrupt;
+}
+
+void lua_freepages(lua_Alloc f, void* ud, void* pages)
+{
+    luaM_freepages(f, ud, (lua_Page*)pages);
+}
+
+void lua_setpagesource(lua_State* L, const lua_PageSource* source)
+{
+    api_check(L, !source || (source->allocpage && source->freepage));
+    L->global->pagesource = source;
+}
+
 void lua_setmemcat(lua_State* L, int category)
 {
     api_check(L, unsigned(category) < LUA_MEMORY_CATEGORIES);
@@ -1486,6 +2193,30 @@ size_t lua_totalbytes(lua_State* L, int category)
     return category < 0 ? L->global->totalbytes : L->global->memcatbytes[category];
 }
 
+void lua_setmemcatlimit(lua_State* L, int category, size_t softlimit, size_t hardlimit)
+{
+    api_check(L, unsigned(category) < LUA_MEMORY_CATEGORIES);
+    api_check(L, category != 0 || (softlimit == 0 && hardlimit == 0));
+
+    global_State* g = L->global;
+
+    if (!g->memcatstats)
+    {
+        MemcatStats* stats = luaM_newarray(L, 1, MemcatStats, 0);
+        memset(stats, 0, sizeof(MemcatStats));
+        g->memcatstats = stats;
+    }
+
+    g->memcatstats->softlimit[category] = softlimit;
+    g->memcatstats->hardlimit[category] = hardlimit;
+}
+
+size_t lua_memcatlivebytes(lua_State* L, int category)
+{
+    api_check(L, unsigned(category) < LUA_MEMORY_CATEGORIES);
+    return L->global->memcatstats ? L->global->memcatstats->live[category] : 0;
+}
+
 lua_Alloc lua_getallocf(lua_State* L, void** ud)
 {
     lua_Alloc f = L->global->frealloc;
@@ -5,6 +5,7 @@
 #include "lstate.h"
 #include "lapi.h"
 #include "ldo.h"
+#include "ltable.h"
 #include "ludata.h"
 
 #include <ctype.h>
@@ -128,7 +129,8 @@ static int luaB_getfenv(lua_State* L)
         lua_pushvalue(L, LUA_GLOBALSINDEX); // return the thread's global env.
     else
         lua_getfenv(L, -1);
-    lua_setsafeenv(L, -1, false);
+    // the environment stays safe until the script modifies it
+    luaH_exposeenv(hvalue(luaA_toobject(L, -1)));
     return 1;
 }
 
@@ -13,12 +13,41 @@ Buffer* luaB_newbuffer(lua_State* L, size_t s)
 
     Buffer* b = luaM_newgco(L, Buffer, sizebuffer(s), L->activememcat);
     luaC_init(L, b, LUA_TBUFFER);
+    b->external = 0;
     b->len = unsigned(s);
     memset(b->data, 0, b->len);
     return b;
 }
 
+// external buffers have a zero `len' so that inline accesses by fastcalls and native code always fail their bounds checks
+// and fall back to the library functions, which access the memory through the view stored in the buffer data
+Buffer* luaB_newexternalbuffer(lua_State* L, void* data, size_t s, void (*release)(void*, void*), void* ud)
+{
+    if (s > MAX_BUFFER_SIZE)
+        luaM_toobig(L);
+
+    Buffer* b = luaM_newgco(L, Buffer, sizebuffer(sizeof(BufferView)), L->activememcat);
+    luaC_init(L, b, LUA_TBUFFER);
+    b->external = 1;
+    b->len = 0;
+
+    BufferView* view = bufferview(b);
+    view->data = data;
+    view->len = s;
+    view->release = release;
+    view->ud = ud;
+    return b;
+}
+
 void luaB_freebuffer(lua_State* L, Buffer* b, lua_Page* page)
 {
-    luaM_freegco(L, b, sizebuffer(b->len), b->memcat, page);
+    if (b->external)
+    {
+        BufferView* view = bufferview(b);
+
+        if (view->release)
+            view->release(view->ud, view->data);
+    }
+
+    luaM_freegco(L, b, sizebufferobj(b), b->memcat, page);
 }
@@ -9,5 +9,23 @@
 // GCObject size has to be at least 16 bytes, so a minimum of 8 bytes is always reserved
 #define sizebuffer(len) (offsetof(Buffer, data) + ((len) < 8 ? 8 : (len)))
 
+// host memory referenced by an external buffer, stored in place of the buffer data
+struct BufferView
+{
+    void* data;
+    size_t len;
+
+    void (*release)(void* ud, void* data);
+    void* ud;
+};
+
+#define bufferview(b) check_exp((b)->external, (BufferView*)(b)->data)
+
+#define sizebufferobj(b) sizebuffer((b)->external ? sizeof(BufferView) : (b)->len)
+
+#define bufferdata(b) ((b)->external ? bufferview(b)->data : (void*)(b)->data)
+#define bufferlen(b) ((b)->external ? bufferview(b)->len : size_t((b)->len))
+
 LUAI_FUNC Buffer* luaB_newbuffer(lua_State* L, size_t s);
+LUAI_FUNC Buffer* luaB_newexternalbuffer(lua_State* L, void* data, size_t s, void (*release)(void*, void*), void* ud);
 LUAI_FUNC void luaB_freebuffer(lua_State* L, Buffer* u, struct lua_Page* page);
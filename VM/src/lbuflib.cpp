@@ -2,7 +2,12 @@
 #include "lualib.h"
 
 #include "lcommon.h"
+#include "lapi.h"
 #include "lbuffer.h"
+#include "lnumutils.h"
+#include "lstate.h"
+#include "lstring.h"
+#include "ltable.h"
 
 #if defined(LUAU_BIG_ENDIAN)
 #include <endian.h>
@@ -157,6 +162,111 @@ static int buffer_writefp(lua_State* L)
     return 0;
 }
 
+template<typename T>
+inline T buffer_tointeger(double v)
+{
+    // same conversion as luaL_checkunsigned
+    unsigned res;
+    luai_num2unsigned(res, v);
+    return T(res);
+}
+
+template<typename T>
+inline T buffer_tofp(double v)
+{
+    return T(v);
+}
+
+template<typename T, typename StorageType>
+static int buffer_readarray(lua_State* L)
+{
+    size_t len = 0;
+    void* buf = luaL_checkbuffer(L, 1, &len);
+    int offset = luaL_checkinteger(L, 2);
+    int count = luaL_checkinteger(L, 3);
+
+    luaL_argcheck(L, count >= 0, 3, "count");
+
+    if (isoutofbounds(offset, len, uint64_t(unsigned(count)) * sizeof(T)))
+        luaL_error(L, "buffer access out of bounds");
+
+    lua_createtable(L, count, 0);
+    Table* t = hvalue(L->top - 1);
+
+    // elements are written directly into the array part; numbers don't need a barrier
+    const char* data = (char*)buf + offset;
+
+    for (int i = 0; i < count; i++)
+    {
+        static_assert(sizeof(T) == sizeof(StorageType), "type size must match to reinterpret data");
+        StorageType tmp;
+        memcpy(&tmp, data + i * sizeof(T), sizeof(tmp));
+
+#if defined(LUAU_BIG_ENDIAN)
+        tmp = buffer_swapbe(tmp);
+#endif
+
+        T val;
+        memcpy(&val, &tmp, sizeof(tmp));
+        setnvalue(&t->array[i], double(val));
+    }
+
+    return 1;
+}
+
+template<typename T, typename StorageType, T (*convert)(double)>
+static int buffer_writearray(lua_State* L)
+{
+    size_t len = 0;
+    void* buf = luaL_checkbuffer(L, 1, &len);
+    int offset = luaL_checkinteger(L, 2);
+    luaL_checktype(L, 3, LUA_TTABLE);
+    int count = luaL_optinteger(L, 4, lua_objlen(L, 3));
+
+    luaL_argcheck(L, count >= 0, 4, "count");
+
+    if (isoutofbounds(offset, len, uint64_t(unsigned(count)) * sizeof(T)))
+        luaL_error(L, "buffer access out of bounds");
+
+    Table* t = hvalue(luaA_toobject(L, 3));
+    char* data = (char*)buf + offset;
+
+    for (int i = 0; i < count; i++)
+    {
+        double value;
+
+        // fast-path: numbers in the array part are read directly
+        if (i < t->sizearray && ttisnumber(&t->array[i]))
+        {
+            value = nvalue(&t->array[i]);
+        }
+        else
+        {
+            lua_rawgeti(L, 3, i + 1);
+
+            int isnum = 0;
+            value = lua_tonumberx(L, -1, &isnum);
+            if (!isnum)
+                luaL_error(L, "invalid value (%s) at index %d in table", luaL_typename(L, -1), i + 1);
+
+            lua_pop(L, 1);
+        }
+
+        static_assert(sizeof(T) == sizeof(StorageType), "type size must match to reinterpret data");
+        T val = convert(value);
+        StorageType tmp;
+        memcpy(&tmp, &val, sizeof(tmp));
+
+#if defined(LUAU_BIG_ENDIAN)
+        tmp = buffer_swapbe(tmp);
+#endif
+
+        memcpy(data + i * sizeof(T), &tmp, sizeof(tmp));
+    }
+
+    return 0;
+}
+
 static int buffer_readstring(lua_State* L)
 {
     size_t len = 0;
@@ -247,6 +357,49 @@ static int buffer_fill(lua_State* L)
     return 0;
 }
 
+static int buffer_find(lua_State* L)
+{
+    size_t len = 0;
+    void* buf = luaL_checkbuffer(L, 1, &len);
+    int offset = luaL_checkinteger(L, 2);
+    size_t size = 0;
+    const char* val = luaL_checklstring(L, 3, &size);
+
+    if (isoutofbounds(offset, len, 0))
+        luaL_error(L, "buffer access out of bounds");
+
+    if (const char* res = luaS_memfind((char*)buf + offset, len - offset, val, size))
+        lua_pushnumber(L, double(res - (char*)buf));
+    else
+        lua_pushnil(L);
+    return 1;
+}
+
+static int buffer_equal(lua_State* L)
+{
+    size_t alen = 0;
+    void* abuf = luaL_checkbuffer(L, 1, &alen);
+    int aoffset = luaL_checkinteger(L, 2);
+
+    size_t blen = 0;
+    void* bbuf = luaL_checkbuffer(L, 3, &blen);
+    int boffset = luaL_checkinteger(L, 4);
+
+    int size = luaL_checkinteger(L, 5);
+
+    if (size < 0)
+        luaL_error(L, "buffer access out of bounds");
+
+    if (isoutofbounds(aoffset, alen, unsigned(size)))
+        luaL_error(L, "buffer access out of bounds");
+
+    if (isoutofbounds(boffset, blen, unsigned(size)))
+        luaL_error(L, "buffer access out of bounds");
+
+    lua_pushboolean(L, memcmp((char*)abuf + aoffset, (char*)bbuf + boffset, size) == 0);
+    return 1;
+}
+
 static const luaL_Reg bufferlib[] = {
     {"create", buffer_create},
     {"fromstring", buffer_fromstring},
@@ -272,6 +425,12 @@ static const luaL_Reg bufferlib[] = {
     {"len", buffer_len},
     {"copy", buffer_copy},
     {"fill", buffer_fill},
+    {"readi32array", buffer_readarray<int32_t, uint32_t>},
+    {"readf32array", buffer_readarray<float, uint32_t>},
+    {"writei32array", buffer_writearray<int32_t, uint32_t, buffer_tointeger<int32_t>>},
+    {"writef32array", buffer_writearray<float, uint32_t, buffer_tofp<float>>},
+    {"find", buffer_find},
+    {"equal", buffer_equal},
     {NULL, NULL},
 };
 
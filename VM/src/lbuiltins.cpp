@@ -9,6 +9,8 @@
 #include "lnumutils.h"
 #include "ldo.h"
 #include "lbuffer.h"
+#include "lbytecode.h"
+#include "lvm.h"
 
 #include <math.h>
 #include <string.h>
@@ -904,6 +906,13 @@ static int luauF_sub(lua_State* L, StkId res, TValue* arg0, int nresults, StkId
         int i = int(nvalue(args));
         int j = int(nvalue(args + 1));
 
+        // the whole string doesn't need to be looked up again
+        if (i == 1 && unsigned(j) == ts->len)
+        {
+            setsvalue(L, res, ts);
+            return 1;
+        }
+
         if (luaC_needsGC(L))
             return -1; // we can't call luaC_checkGC so fall back to C implementation
 
@@ -1128,7 +1137,7 @@ static int luauF_countrz(lua_State* L, StkId res, TValue* arg0, int nresults, St
 
 static int luauF_select(lua_State* L, StkId res, TValue* arg0, int nresults, StkId args, int nparams)
 {
-    if (nparams == 1 && nresults == 1)
+    if (nparams == 1)
     {
         int n = cast_int(L->base - L->ci->func) - clvalue(L->ci->func)->l.p->numparams - 1;
 
@@ -1137,16 +1146,53 @@ static int luauF_select(lua_State* L, StkId res, TValue* arg0, int nresults, Stk
             int i = int(nvalue(arg0));
 
             // i >= 1 && i <= n
-            if (unsigned(i - 1) < unsigned(n))
+            if (nresults == 1 && unsigned(i - 1) < unsigned(n))
             {
                 setobj2s(L, res, L->base - n + (i - 1));
                 return 1;
             }
-            // note: for now we don't handle negative case (wrap around) and defer to fallback
+
+            // negative indices count from the end, -n being the first argument
+            if (i < 0 && i >= -n)
+                i += n + 1;
+
+            // the remaining arguments are read in place from the variadic part of the frame, res is always above it
+            if (i >= 1 && double(int(nvalue(arg0))) == nvalue(arg0))
+            {
+                int count = i <= n ? n - i + 1 : 0;
+
+                if (nresults == LUA_MULTRET)
+                {
+                    if (cast_int(L->stack_last - res) < count)
+                        return -1;
+
+                    for (int k = 0; k < count; ++k)
+                        setobj2s(L, res + k, L->base - n + (i - 1) + k);
+                    expandstacklimit(L, res + count);
+                    return count;
+                }
+
+                for (int k = 0; k < nresults; ++k)
+                {
+                    if (k < count)
+                    {
+                        setobj2s(L, res + k, L->base - n + (i - 1) + k);
+                    }
+                    else
+                    {
+                        setnilvalue(res + k);
+                    }
+                }
+                return nresults;
+            }
+
+            // note: zero and out of range negative indices are errors and defer to fallback
         }
         else if (ttisstring(arg0) && *svalue(arg0) == '#')
         {
             setnvalue(res, double(n));
+            for (int k = 1; k < nresults; ++k)
+                setnilvalue(res + k);
             return 1;
         }
     }
@@ -1437,11 +1483,114 @@ static int luauF_writefp(lua_State* L, StkId res, TValue* arg0, int nresults, St
     return -1;
 }
 
+static int luauF_bufferfind(lua_State* L, StkId res, TValue* arg0, int nresults, StkId args, int nparams)
+{
+    if (nparams >= 3 && nresults <= 1 && ttisbuffer(arg0) && !bufvalue(arg0)->external && ttisnumber(args) && ttisstring(args + 1))
+    {
+        Buffer* b = bufvalue(arg0);
+        TString* ts = tsvalue(args + 1);
+
+        int offset;
+        luai_num2int(offset, nvalue(args));
+        if (unsigned(offset) > b->len)
+            return -1;
+
+        const char* pos = luaS_memfind(b->data + unsigned(offset), b->len - unsigned(offset), getstr(ts), ts->len);
+
+        if (pos)
+        {
+            setnvalue(res, double(pos - b->data));
+        }
+        else
+        {
+            setnilvalue(res);
+        }
+        return 1;
+    }
+
+    return -1;
+}
+
+static int luauF_bufferequal(lua_State* L, StkId res, TValue* arg0, int nresults, StkId args, int nparams)
+{
+    if (nparams >= 5 && nresults <= 1 && ttisbuffer(arg0) && ttisnumber(args) && ttisbuffer(args + 1) && ttisnumber(args + 2) &&
+        ttisnumber(args + 3))
+    {
+        Buffer* a = bufvalue(arg0);
+        Buffer* b = bufvalue(args + 1);
+
+        int aoffset, boffset, size;
+        luai_num2int(aoffset, nvalue(args));
+        luai_num2int(boffset, nvalue(args + 2));
+        luai_num2int(size, nvalue(args + 3));
+
+        if (size < 0 || uint64_t(unsigned(aoffset)) + unsigned(size) > a->len || uint64_t(unsigned(boffset)) + unsigned(size) > b->len)
+            return -1;
+
+        setbvalue(res, memcmp(a->data + unsigned(aoffset), b->data + unsigned(boffset), size) == 0);
+        return 1;
+    }
+
+    return -1;
+}
+
+static int luauF_noise(lua_State* L, StkId res, TValue* arg0, int nresults, StkId args, int nparams)
+{
+    if (nparams >= 1 && nresults <= 1 && ttisnumber(arg0))
+    {
+        double y = 0.0, z = 0.0;
+
+        if (nparams >= 2)
+        {
+            if (ttisnumber(args))
+                y = nvalue(args);
+            else if (!ttisnil(args))
+                return -1;
+        }
+
+        if (nparams >= 3)
+        {
+            if (ttisnumber(args + 1))
+                z = nvalue(args + 1);
+            else if (!ttisnil(args + 1))
+                return -1;
+        }
+
+        setnvalue(res, luai_perlin(float(nvalue(arg0)), float(y), float(z)));
+        return 1;
+    }
+
+    return -1;
+}
+
 static int luauF_missing(lua_State* L, StkId res, TValue* arg0, int nresults, StkId args, int nparams)
 {
     return -1;
 }
 
+template<int id>
+static int luauF_user(lua_State* L, StkId res, TValue* arg0, int nresults, StkId args, int nparams)
+{
+    const lua_FastCall* fast = L->global->userbuiltins[id];
+
+    if (!fast || nparams != fast->nargs)
+        return -1;
+
+    // results of MULTRET calls are placed past the frame top
+    if (nresults == LUA_MULTRET && L->stack_last - res < fast->nresults)
+        return -1;
+
+    lua_FastValue values[LUA_FASTMAXVALUES];
+    lua_FastValue results[LUA_FASTMAXVALUES];
+
+    if (!luaV_fastargs(fast, arg0, args, values) || !fast->f(values, results))
+        return -1;
+
+    int count = (nresults == LUA_MULTRET) ? fast->nresults : nresults;
+    luaV_fastresults(fast, results, res, count);
+    return count;
+}
+
 #ifdef LUAU_TARGET_SSE41
 template<int Rounding>
 LUAU_TARGET_SSE41 inline double roundsd_sse41(double v)
@@ -1619,10 +1768,15 @@ const luau_FastFunction luauF_table[256] = {
     luauF_writefp<float>,
     luauF_readfp<double>,
     luauF_writefp<double>,
+    luauF_bufferfind,
+    luauF_bufferequal,
+
+    luauF_noise,
 
 // When adding builtins, add them above this line; what follows is 64 "dummy" entries with luauF_missing fallback.
 // This is important so that older versions of the runtime that don't support newer builtins automatically fall back via luauF_missing.
 // Given the builtin addition velocity this should always provide a larger compatibility window than bytecode versions suggest.
+// The remaining entries up to LBF_USER_FIRST are "dummy" entries as well, and they need to be removed when adding builtins.
 #define MISSING8 luauF_missing, luauF_missing, luauF_missing, luauF_missing, luauF_missing, luauF_missing, luauF_missing, luauF_missing
 
     MISSING8,
@@ -1634,5 +1788,31 @@ const luau_FastFunction luauF_table[256] = {
     MISSING8,
     MISSING8,
 
+    MISSING8,
+    MISSING8,
+    MISSING8,
+    MISSING8,
+    MISSING8,
+    MISSING8,
+    MISSING8,
+    MISSING8,
+    MISSING8,
+    luauF_missing, luauF_missing, luauF_missing, luauF_missing, luauF_missing, luauF_missing, luauF_missing,
+
 #undef MISSING8
+
+// Builtin ids from LBF_USER_FIRST to LBF_USER_LAST call fast C functions registered with lua_setuserbuiltin
+#define USER8(id) \
+    luauF_user<id>, luauF_user<id + 1>, luauF_user<id + 2>, luauF_user<id + 3>, luauF_user<id + 4>, luauF_user<id + 5>, luauF_user<id + 6>, \
+        luauF_user<id + 7>
+
+    USER8(0),
+    USER8(8),
+    USER8(16),
+    USER8(24),
+
+#undef USER8
 };
+
+static_assert(LBF_MATH_NOISE + 1 + 17 * 8 + 7 == LBF_USER_FIRST, "dummy entries need to be adjusted to keep user builtins at LBF_USER_FIRST");
+static_assert(LBF_USER_LAST - LBF_USER_FIRST + 1 == LUA_USERBUILTINS, "user builtin ids need to match the runtime limit");
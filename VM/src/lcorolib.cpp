@@ -2,6 +2,7 @@
 // This code is based on Lua 5.x implementation licensed under MIT License; see lua_LICENSE.txt for details
 #include "lualib.h"
 
+#include "lgc.h"
 #include "lstate.h"
 #include "lvm.h"
 
@@ -18,10 +19,25 @@ static int costatus(lua_State* L)
     return 1;
 }
 
-static int auxresume(lua_State* L, lua_State* co, int narg)
+// moves n values between the stacks of two threads; this is lua_xmove without the API checks, as the coroutine switch path is hot
+static void auxmove(lua_State* from, lua_State* to, int n)
+{
+    luaC_threadbarrier(to);
+
+    StkId ttop = to->top;
+    StkId ftop = from->top - n;
+    for (int i = 0; i < n; i++)
+        setobj2s(to, ttop + i, ftop + i);
+
+    from->top = ftop;
+    to->top = ttop + n;
+}
+
+// when withstatus is set, successful resumes push 'true' before the yielded values and count it in the result
+static int auxresume(lua_State* L, lua_State* co, int narg, bool withstatus)
 {
     // error handling for edge cases
-    if (co->status != LUA_YIELD)
+    if (LUAU_UNLIKELY(co->status != LUA_YIELD))
     {
         int status = lua_costatus(L, co);
         if (status != LUA_COSUS)
@@ -35,23 +51,30 @@ static int auxresume(lua_State* L, lua_State* co, int narg)
     {
         if (!lua_checkstack(co, narg))
             luaL_error(L, "too many arguments to resume");
-        lua_xmove(L, co, narg);
+        auxmove(L, co, narg);
     }
 
     co->singlestep = L->singlestep;
 
     int status = lua_resume(co, L, narg);
-    if (status == 0 || status == LUA_YIELD)
+    if (LUAU_LIKELY(status == 0 || status == LUA_YIELD))
     {
         int nres = cast_int(co->top - co->base);
-        if (nres)
+
+        // +1 accounts for true/false status in resumefinish
+        if (nres + 1 > LUA_MINSTACK && !lua_checkstack(L, nres + 1))
+            luaL_error(L, "too many results to resume");
+
+        if (withstatus)
         {
-            // +1 accounts for true/false status in resumefinish
-            if (nres + 1 > LUA_MINSTACK && !lua_checkstack(L, nres + 1))
-                luaL_error(L, "too many results to resume");
-            lua_xmove(co, L, nres); // move yielded values
+            setbvalue(L->top, 1);
+            L->top++;
         }
-        return nres;
+
+        if (nres)
+            auxmove(co, L, nres); // move yielded values
+
+        return nres + withstatus;
     }
     else if (status == LUA_BREAK)
     {
@@ -59,7 +82,7 @@ static int auxresume(lua_State* L, lua_State* co, int narg)
     }
     else
     {
-        lua_xmove(co, L, 1); // move error message
+        auxmove(co, L, 1); // move error message
         return CO_STATUS_ERROR;
     }
 }
@@ -112,11 +135,15 @@ static int coresumey(lua_State* L)
     lua_State* co = lua_tothread(L, 1);
     luaL_argexpected(L, co, 1, "thread");
     int narg = cast_int(L->top - L->base) - 1;
-    int r = auxresume(L, co, narg);
+    int r = auxresume(L, co, narg, /* withstatus= */ true);
 
     if (r == CO_STATUS_BREAK)
         return interruptThread(L, co);
 
+    // successful resumes already have the status pushed in front of the results
+    if (r >= 0)
+        return r;
+
     return coresumefinish(L, r);
 }
 
@@ -151,9 +178,10 @@ static int auxwrapfinish(lua_State* L, int r)
 
 static int auxwrapy(lua_State* L)
 {
-    lua_State* co = lua_tothread(L, lua_upvalueindex(1));
+    // the wrapped thread is always the first upvalue, so we can skip the pseudo-index lookup
+    lua_State* co = thvalue(&clvalue(L->ci->func)->c.upvals[0]);
     int narg = cast_int(L->top - L->base);
-    int r = auxresume(L, co, narg);
+    int r = auxresume(L, co, narg, /* withstatus= */ false);
 
     if (r == CO_STATUS_BREAK)
         return interruptThread(L, co);
@@ -8,6 +8,9 @@
 #include "lgc.h"
 #include "ldo.h"
 #include "lbytecode.h"
+#include "lvm.h"
+
+#include "Luau/BytecodeUtils.h"
 
 #include <string.h>
 #include <stdio.h>
@@ -72,6 +75,8 @@ const char* lua_getlocal(lua_State* L, int level, int n)
         return NULL;
 
     Proto* fp = getluaproto(ci);
+    if (fp)
+        luaV_loaddebuginfo(L, fp, /* keep= */ false);
     const LocVar* var = fp ? luaF_getlocal(fp, n, currentpc(L, ci)) : NULL;
     if (var)
     {
@@ -93,6 +98,8 @@ const char* lua_setlocal(lua_State* L, int level, int n)
         return NULL;
 
     Proto* fp = getluaproto(ci);
+    if (fp)
+        luaV_loaddebuginfo(L, fp, /* keep= */ false);
     const LocVar* var = fp ? luaF_getlocal(fp, n, currentpc(L, ci)) : NULL;
     if (var)
         setobj2s(L, ci->base + var->reg, L->top - 1);
@@ -331,9 +338,26 @@ void luaG_pusherror(lua_State* L, const char* error)
     pusherror(L, error);
 }
 
+static bool hasbreakpoints(Proto* p)
+{
+    if (!p->debuginsn)
+        return false;
+
+    // breakpoints replace the opcode of an instruction, original opcodes are kept in debuginsn
+    // note: other opcodes may differ as well, since reached coverage instructions turn into NOP when only the first hit is recorded
+    for (int i = 0; i < p->sizecode; ++i)
+    {
+        if (LUAU_INSN_OP(p->code[i]) == LOP_BREAK && p->debuginsn[i] != LOP_BREAK)
+            return true;
+    }
+
+    return false;
+}
+
 void luaG_breakpoint(lua_State* L, Proto* p, int line, bool enable)
 {
     void (*ondisable)(lua_State*, Proto*) = L->global->ecb.disable;
+    void (*onenable)(lua_State*, Proto*) = L->global->ecb.enable;
 
     // since native code doesn't support breakpoints, we would need to update all call frames with LUAU_CALLINFO_NATIVE that refer to p
     if (p->lineinfo && (ondisable || !p->execdata))
@@ -362,11 +386,17 @@ void luaG_breakpoint(lua_State* L, Proto* p, int line, bool enable)
             p->code[i] |= op;
             LUAU_ASSERT(LUAU_INSN_OP(p->code[i]) == op);
 
-            // currently we don't restore native code when breakpoint is disabled.
-            // this will be addressed in the future.
+            // threaded interpreter dispatches through handler addresses, so the patched opcode has to be reflected there as well
+            if (p->threadedcode)
+                p->threadedcode[i] = L->global->threadeddispatch[op];
+
             if (enable && p->execdata && ondisable)
                 ondisable(L, p);
 
+            // native code is restored once the function has no breakpoints left; running frames remain in the interpreter
+            if (!enable && p->execdata && onenable && !hasbreakpoints(p))
+                onenable(L, p);
+
             // note: this is important!
             // we only patch the *first* instruction in each proto that's attributed to a given line
             // this can be changed, but if requires making patching a bit more nuanced so that we don't patch AUX words
@@ -395,8 +425,9 @@ int luaG_getline(Proto* p, int pc)
 {
     LUAU_ASSERT(pc >= 0 && pc < p->sizecode);
 
+    // debug information that is left encoded is read from the bytecode without decoding it, since that needs no allocation
     if (!p->lineinfo)
-        return 0;
+        return p->debugchunk ? luaV_getdebugline(p, pc) : 0;
 
     return p->abslineinfo[pc >> p->linegaplog2] + p->lineinfo[pc];
 }
@@ -471,12 +502,26 @@ static int getnextline(Proto* p, int line)
     return closest;
 }
 
+// Breakpoints and coverage apply to all nested functions, including the ones that a lazy load hasn't decoded yet
+// both look up lines of every instruction, so debug information that was left encoded is decoded for good
+static void loadprotos(lua_State* L, Proto* p)
+{
+    if (p->lazychunk)
+        luaV_loadproto(L, p);
+
+    luaV_loaddebuginfo(L, p, /* keep= */ true);
+
+    for (int i = 0; i < p->sizep; ++i)
+        loadprotos(L, p->p[i]);
+}
+
 int lua_breakpoint(lua_State* L, int funcindex, int line, int enabled)
 {
     const TValue* func = luaA_toobject(L, funcindex);
     api_check(L, ttisfunction(func) && !clvalue(func)->isC);
 
     Proto* p = clvalue(func)->l.p;
+    loadprotos(L, p);
 
     // set the breakpoint to the next closest line with valid instructions
     int target = getnextline(p, line);
@@ -491,10 +536,12 @@ static void getcoverage(Proto* p, int depth, int* buffer, size_t size, void* con
 {
     memset(buffer, -1, size * sizeof(int));
 
-    for (int i = 0; i < p->sizecode; ++i)
+    for (int i = 0; i < p->sizecode; i += Luau::getOpLength(LuauOpcode(p->debuginsn ? p->debuginsn[i] : LUAU_INSN_OP(p->code[i]))))
     {
         Instruction insn = p->code[i];
-        if (LUAU_INSN_OP(insn) != LOP_COVERAGE)
+
+        // NOP with a non-zero E is a coverage instruction that was reached while only the first hit was recorded
+        if (LUAU_INSN_OP(insn) != LOP_COVERAGE && (LUAU_INSN_OP(insn) != LOP_NOP || LUAU_INSN_E(insn) == 0))
             continue;
 
         int line = luaG_getline(p, i);
@@ -519,6 +566,7 @@ void lua_getcoverage(lua_State* L, int funcindex, void* context, lua_Coverage ca
     api_check(L, ttisfunction(func) && !clvalue(func)->isC);
 
     Proto* p = clvalue(func)->l.p;
+    loadprotos(L, p);
 
     size_t size = getmaxline(p) + 1;
     if (size == 0)
@@ -531,6 +579,350 @@ void lua_getcoverage(lua_State* L, int funcindex, void* context, lua_Coverage ca
     luaM_freearray(L, buffer, size, int, 0);
 }
 
+void lua_setcoveragefirsthit(lua_State* L, int enabled)
+{
+    L->global->coveragefirsthit = bool(enabled);
+}
+
+void lua_setopcodecounters(lua_State* L, int enabled)
+{
+    global_State* g = L->global;
+
+    if (enabled && !g->opcodecounts)
+    {
+        g->opcodecounts = luaM_newarray(L, LUA_OPCODECOUNT, uint64_t, 0);
+        memset(g->opcodecounts, 0, LUA_OPCODECOUNT * sizeof(uint64_t));
+    }
+    else if (!enabled && g->opcodecounts)
+    {
+        luaM_freearray(L, g->opcodecounts, LUA_OPCODECOUNT, uint64_t, 0);
+        g->opcodecounts = NULL;
+    }
+}
+
+uint64_t lua_getopcodecount(lua_State* L, int op)
+{
+    api_check(L, unsigned(op) < LUA_OPCODECOUNT);
+    return L->global->opcodecounts ? L->global->opcodecounts[op] : 0;
+}
+
+static void getopcodecounts(Proto* p, int depth, void* context, lua_OpcodeCounts callback)
+{
+    const char* debugname = p->debugname ? getstr(p->debugname) : NULL;
+
+    callback(context, debugname, p->linedefined, depth, p->execcount);
+
+    for (int i = 0; i < p->sizep; ++i)
+        getopcodecounts(p->p[i], depth + 1, context, callback);
+}
+
+void lua_getopcodecounts(lua_State* L, int funcindex, void* context, lua_OpcodeCounts callback)
+{
+    const TValue* func = luaA_toobject(L, funcindex);
+    api_check(L, ttisfunction(func) && !clvalue(func)->isC);
+
+    getopcodecounts(clvalue(func)->l.p, 0, context, callback);
+}
+
+void lua_startprofiler(lua_State* L, int capacity)
+{
+    api_check(L, capacity > 1);
+    lua_stopprofiler(L);
+
+    global_State* g = L->global;
+    g->profentries = luaM_newarray(L, capacity, ProfilerEntry, 0);
+    g->profsize = capacity;
+}
+
+void lua_stopprofiler(lua_State* L)
+{
+    global_State* g = L->global;
+    luaM_freearray(L, g->profentries, g->profsize, ProfilerEntry, 0);
+    g->profentries = NULL;
+    g->profsize = 0;
+    g->profhead = 0;
+    g->proftail = 0;
+    g->profdropped = 0;
+}
+
+static lua_ProfilerFrame getframe(CallInfo* ci)
+{
+    lua_ProfilerFrame frame;
+    Closure* cl = clvalue(ci->func);
+
+    if (cl->isC)
+    {
+        frame.function = obj2gco(cl);
+        frame.pc = -1;
+        frame.native = 0;
+    }
+    else
+    {
+        int pc = pcRel(ci->savedpc, cl->l.p);
+
+        frame.function = obj2gco(cl->l.p);
+        frame.pc = pc < 0 ? 0 : pc;
+        frame.native = (ci->flags & LUA_CALLINFO_NATIVE) != 0;
+    }
+
+    return frame;
+}
+
+int lua_profilersample(lua_State* L, int tag, unsigned weight)
+{
+    global_State* g = L->global;
+
+    if (!g->profentries)
+        return 0;
+
+    int depth = int(L->ci - L->base_ci);
+    depth = depth < LUA_PROFILERMAXDEPTH ? depth : LUA_PROFILERMAXDEPTH;
+    depth = depth < g->profsize - 1 ? depth : g->profsize - 1;
+
+    // the oldest samples are dropped as a whole so that the buffer always starts with a sample header
+    while (g->profhead + depth + 1 - g->proftail > uint64_t(g->profsize))
+    {
+        ProfilerEntry* oldest = &g->profentries[g->proftail % g->profsize];
+        g->proftail += oldest->pc + 1;
+        g->profdropped++;
+    }
+
+    ProfilerEntry* header = &g->profentries[g->profhead++ % g->profsize];
+    header->function = NULL;
+    header->pc = depth;
+    header->tag = tag;
+    header->weight = weight;
+    header->native = 0;
+
+    CallInfo* ci = L->ci;
+
+    for (int i = 0; i < depth; i++, ci--)
+    {
+        ProfilerEntry* e = &g->profentries[g->profhead++ % g->profsize];
+        lua_ProfilerFrame frame = getframe(ci);
+
+        e->function = (GCObject*)frame.function;
+        e->pc = frame.pc;
+        e->native = uint8_t(frame.native);
+    }
+
+    return int(g->profhead - g->proftail);
+}
+
+int lua_capturestack(lua_State* L, int level, lua_ProfilerFrame* frames, int size)
+{
+    int depth = int(L->ci - L->base_ci) - level;
+
+    if (level < 0 || depth <= 0)
+        return 0;
+
+    depth = depth < size ? depth : size;
+
+    CallInfo* ci = L->ci - level;
+
+    for (int i = 0; i < depth; i++, ci--)
+        frames[i] = getframe(ci);
+
+    return depth;
+}
+
+void lua_startheapprofiler(lua_State* L, size_t rate, int capacity)
+{
+    api_check(L, rate > 0 && capacity > 0);
+    lua_stopheapprofiler(L);
+
+    global_State* g = L->global;
+
+    int indexsize = 1;
+    while (indexsize < capacity * 2)
+        indexsize *= 2;
+
+    g->heapsamples = luaM_newarray(L, capacity, HeapSample, 0);
+    g->heapsamplesize = capacity;
+    g->heapsampleindex = luaM_newarray(L, indexsize, int, 0);
+    g->heapsampleindexsize = indexsize;
+    memset(g->heapsampleindex, 0, indexsize * sizeof(int));
+
+    g->heapsamplerate = rate;
+}
+
+void lua_stopheapprofiler(lua_State* L)
+{
+    global_State* g = L->global;
+    luaM_freearray(L, g->heapsamples, g->heapsamplesize, HeapSample, 0);
+    luaM_freearray(L, g->heapsampleindex, g->heapsampleindexsize, int, 0);
+    g->heapsamples = NULL;
+    g->heapsamplecount = 0;
+    g->heapsamplesize = 0;
+    g->heapsampleindex = NULL;
+    g->heapsampleindexsize = 0;
+    g->heapsamplerate = 0;
+    g->heapsamplebytes = 0;
+    g->heapsampledropped = 0;
+}
+
+size_t lua_getheapprofile(lua_State* L, void* context, lua_HeapSamples callback)
+{
+    global_State* g = L->global;
+
+    for (int i = 0; i < g->heapsamplecount; i++)
+    {
+        HeapSample* s = &g->heapsamples[i];
+        callback(context, s->object->gch.tt, s->memcat, s->size, s->weight, s->frames, s->depth);
+    }
+
+    return g->heapsampledropped;
+}
+
+static int heapsamplehome(global_State* g, GCObject* o)
+{
+    return int(((uintptr_t(o) >> 4) ^ (uintptr_t(o) >> 9)) & (g->heapsampleindexsize - 1));
+}
+
+// returns the slot of `heapsampleindex' that refers to the sample of o, or the empty slot where it would be inserted
+static int heapsampleslot(global_State* g, GCObject* o)
+{
+    int mask = g->heapsampleindexsize - 1;
+    int slot = heapsamplehome(g, o);
+
+    while (g->heapsampleindex[slot] && g->heapsamples[g->heapsampleindex[slot] - 1].object != o)
+        slot = (slot + 1) & mask;
+
+    return slot;
+}
+
+void luaG_heapsample(lua_State* L, GCObject* o, size_t size, uint8_t memcat)
+{
+    global_State* g = L->global;
+
+    g->heapsamplebytes += size;
+
+    if (g->heapsamplebytes < g->heapsamplerate)
+        return;
+
+    if (g->heapsamplecount == g->heapsamplesize)
+    {
+        // the bytes stay accounted so that the next sample that fits carries them
+        g->heapsampledropped++;
+        return;
+    }
+
+    int pos = g->heapsamplecount++;
+
+    HeapSample* s = &g->heapsamples[pos];
+    s->object = o;
+    s->size = size;
+    s->weight = g->heapsamplebytes;
+    s->memcat = memcat;
+    s->depth = lua_capturestack(L, 0, s->frames, LUA_HEAPPROFILERMAXDEPTH);
+
+    g->heapsamplebytes = 0;
+
+    int slot = heapsampleslot(g, o);
+    LUAU_ASSERT(g->heapsampleindex[slot] == 0);
+    g->heapsampleindex[slot] = pos + 1;
+}
+
+void luaG_heapunsample(global_State* g, GCObject* o)
+{
+    int mask = g->heapsampleindexsize - 1;
+    int slot = heapsampleslot(g, o);
+
+    if (g->heapsampleindex[slot] == 0)
+        return;
+
+    int pos = g->heapsampleindex[slot] - 1;
+
+    // linear probing without tombstones: entries that were displaced past the removed slot are shifted back into it
+    for (int next = (slot + 1) & mask; g->heapsampleindex[next]; next = (next + 1) & mask)
+    {
+        int home = heapsamplehome(g, g->heapsamples[g->heapsampleindex[next] - 1].object);
+
+        // the entry can move into the hole unless its home lies cyclically in (slot, next]
+        bool stays = slot <= next ? (slot < home && home <= next) : (slot < home || home <= next);
+
+        if (!stays)
+        {
+            g->heapsampleindex[slot] = g->heapsampleindex[next];
+            slot = next;
+        }
+    }
+
+    g->heapsampleindex[slot] = 0;
+
+    // keep samples dense by moving the last sample into the freed position
+    int last = --g->heapsamplecount;
+
+    if (pos != last)
+    {
+        g->heapsamples[pos] = g->heapsamples[last];
+        g->heapsampleindex[heapsampleslot(g, g->heapsamples[pos].object)] = pos + 1;
+    }
+}
+
+size_t lua_getprofilersamples(lua_State* L, void* context, lua_ProfilerSamples callback)
+{
+    global_State* g = L->global;
+    lua_ProfilerFrame frames[LUA_PROFILERMAXDEPTH];
+
+    while (g->proftail < g->profhead)
+    {
+        ProfilerEntry* header = &g->profentries[g->proftail % g->profsize];
+        LUAU_ASSERT(header->function == NULL);
+
+        int depth = header->pc;
+
+        for (int i = 0; i < depth; i++)
+        {
+            ProfilerEntry* e = &g->profentries[(g->proftail + 1 + i) % g->profsize];
+            frames[i].function = e->function;
+            frames[i].pc = e->pc;
+            frames[i].native = e->native;
+        }
+
+        // the sample is removed after the callback so that the functions of its frames stay alive if the callback runs the collector
+        callback(context, header->tag, header->weight, frames, depth);
+
+        g->proftail += depth + 1;
+    }
+
+    size_t dropped = g->profdropped;
+    g->profdropped = 0;
+    return dropped;
+}
+
+int lua_getprofilerframe(lua_State* L, const lua_ProfilerFrame* frame, lua_Debug* ar)
+{
+    GCObject* o = (GCObject*)frame->function;
+
+    if (!o)
+        return 0;
+
+    if (o->gch.tt == LUA_TPROTO)
+    {
+        Proto* p = gco2p(o);
+        ar->source = getstr(p->source);
+        ar->what = "Lua";
+        ar->short_src = luaO_chunkid(ar->ssbuf, sizeof(ar->ssbuf), getstr(p->source), p->source->len);
+        ar->linedefined = p->linedefined;
+        ar->currentline = luaG_getline(p, frame->pc);
+        ar->name = p->debugname ? getstr(p->debugname) : NULL;
+    }
+    else
+    {
+        Closure* cl = gco2cl(o);
+        LUAU_ASSERT(cl->isC);
+        ar->source = "=[C]";
+        ar->what = "C";
+        ar->short_src = "[C]";
+        ar->linedefined = -1;
+        ar->currentline = -1;
+        ar->name = cl->c.debugname;
+    }
+
+    return 1;
+}
+
 static size_t append(char* buf, size_t bufsize, size_t offset, const char* data)
 {
     size_t size = strlen(data);
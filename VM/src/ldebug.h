@@ -31,3 +31,6 @@ LUAI_FUNC bool luaG_onbreak(lua_State* L);
 LUAI_FUNC int luaG_getline(Proto* p, int pc);
 
 LUAI_FUNC int luaG_isnative(lua_State* L, int level);
+
+LUAI_FUNC void luaG_heapsample(lua_State* L, GCObject* o, size_t size, uint8_t memcat);
+LUAI_FUNC void luaG_heapunsample(global_State* g, GCObject* o);
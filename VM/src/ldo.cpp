@@ -24,22 +24,30 @@
 */
 
 #if LUA_USE_LONGJMP
-struct lua_jmpbuf
-{
-    lua_jmpbuf* volatile prev;
-    volatile int status;
-    jmp_buf buf;
-};
-
+// use compiler builtins where they are known to work: they only save the frame and stack pointers since the compiler spills the
+// remaining registers around the call, which makes entering a protected call a few instructions instead of a library call
+#if defined(__GNUC__) && defined(__x86_64__) && (defined(__linux__) || defined(__APPLE__))
+typedef void* luau_jmp_buf[5];
+#define LUAU_SETJMP(buf) __builtin_setjmp(buf)
+#define LUAU_LONGJMP(buf, code) __builtin_longjmp(buf, 1)
 // use POSIX versions of setjmp/longjmp if possible: they don't save/restore signal mask and are therefore faster
-#if defined(__linux__) || defined(__APPLE__)
+#elif defined(__linux__) || defined(__APPLE__)
+typedef jmp_buf luau_jmp_buf;
 #define LUAU_SETJMP(buf) _setjmp(buf)
 #define LUAU_LONGJMP(buf, code) _longjmp(buf, code)
 #else
+typedef jmp_buf luau_jmp_buf;
 #define LUAU_SETJMP(buf) setjmp(buf)
 #define LUAU_LONGJMP(buf, code) longjmp(buf, code)
 #endif
 
+struct lua_jmpbuf
+{
+    lua_jmpbuf* volatile prev;
+    volatile int status;
+    luau_jmp_buf buf;
+};
+
 int luaD_rawrunprotected(lua_State* L, Pfunc f, void* ud)
 {
     lua_jmpbuf jb;
@@ -189,8 +197,8 @@ void luaD_reallocCI(lua_State* L, int newsize)
 
 void luaD_growstack(lua_State* L, int n)
 {
-    if (n <= L->stacksize) // double size is enough?
-        luaD_reallocstack(L, 2 * L->stacksize);
+    if (n <= (L->stackgrowth - 1) * L->stacksize) // geometric growth is enough?
+        luaD_reallocstack(L, L->stackgrowth * L->stacksize);
     else
         luaD_reallocstack(L, L->stacksize + n);
 }
@@ -456,6 +464,12 @@ int lua_resume(lua_State* L, lua_State* from, int nargs)
 
     luaC_threadbarrier(L);
 
+    // coroutine spends the execution budget of the thread that resumes it
+    bool borrowbudget = from && from->budget != 0;
+    int budget = L->budget;
+    if (borrowbudget)
+        L->budget = from->budget;
+
     status = luaD_rawrunprotected(L, resume, L->top - nargs);
 
     CallInfo* ch = NULL;
@@ -467,6 +481,13 @@ int lua_resume(lua_State* L, lua_State* from, int nargs)
 
     resume_finish(L, status);
     --L->nCcalls;
+
+    if (borrowbudget)
+    {
+        from->budget = L->budget;
+        L->budget = budget;
+    }
+
     return L->status;
 }
 
@@ -485,6 +506,12 @@ int lua_resumeerror(lua_State* L, lua_State* from)
 
     luaC_threadbarrier(L);
 
+    // coroutine spends the execution budget of the thread that resumes it
+    bool borrowbudget = from && from->budget != 0;
+    int budget = L->budget;
+    if (borrowbudget)
+        L->budget = from->budget;
+
     status = LUA_ERRRUN;
 
     CallInfo* ch = NULL;
@@ -496,6 +523,13 @@ int lua_resumeerror(lua_State* L, lua_State* from)
 
     resume_finish(L, status);
     --L->nCcalls;
+
+    if (borrowbudget)
+    {
+        from->budget = L->budget;
+        L->budget = budget;
+    }
+
     return L->status;
 }
 
@@ -32,11 +32,19 @@ Proto* luaF_newproto(lua_State* L)
     f->source = NULL;
     f->debugname = NULL;
     f->debuginsn = NULL;
+    f->threadedcode = NULL;
     f->codeentry = NULL;
     f->execdata = NULL;
     f->exectarget = 0;
+    f->hotcount = 0;
+    f->execcount = 0;
     f->typeinfo = NULL;
+    f->tablesites = NULL;
+    f->sizetablesites = 0;
     f->userdata = NULL;
+    f->lazychunk = NULL;
+    f->debugchunk = NULL;
+    f->lazyoffset = 0;
 
     return f;
 }
@@ -68,6 +76,7 @@ Closure* luaF_newCclosure(lua_State* L, int nelems, Table* e)
     c->c.f = NULL;
     c->c.cont = NULL;
     c->c.debugname = NULL;
+    c->c.fast = NULL;
     return c;
 }
 
@@ -156,13 +165,27 @@ void luaF_freeproto(lua_State* L, Proto* f, lua_Page* page)
     luaM_freearray(L, f->upvalues, f->sizeupvalues, TString*, f->memcat);
     if (f->debuginsn)
         luaM_freearray(L, f->debuginsn, f->sizecode, uint8_t, f->memcat);
+    if (f->threadedcode)
+        luaM_freearray(L, f->threadedcode, f->sizecode, const void*, f->memcat);
 
-    if (f->execdata)
+    if (f->execdata || f->hotcount)
         L->global->ecb.destroy(L, f);
 
     if (f->typeinfo)
         luaM_freearray(L, f->typeinfo, f->numparams + 2, uint8_t, f->memcat);
 
+    if (f->tablesites)
+        luaM_freearray(L, f->tablesites, f->sizetablesites, TableSite, f->memcat);
+
+    // debug information decoded on demand might still be cached
+    if (f->debugchunk)
+    {
+        global_State* g = L->global;
+        for (int i = 0; i < LUA_DEBUGCACHE; i++)
+            if (g->debugcache[i] == f)
+                g->debugcache[i] = NULL;
+    }
+
     luaM_freegco(L, f, sizeof(Proto), f->memcat, page);
 }
 
@@ -12,10 +12,11 @@
 #include "ludata.h"
 #include "lbuffer.h"
 
+#include <stdlib.h>
 #include <string.h>
 
 /*
- * Luau uses an incremental non-generational non-moving mark&sweep garbage collector.
+ * Luau uses an incremental non-moving mark&sweep garbage collector, with an optional generational mode (see below).
  *
  * The collector runs in three stages: mark, atomic and sweep. Mark and sweep are incremental and try to do a limited amount
  * of work every GC step; atomic is ran once per the GC cycle and is indivisible. In either case, the work happens during GC
@@ -115,6 +116,40 @@
  * as black (doing so would violate the GC invariant), and they are kept in a special global list (global_State::uvhead) which is traversed
  * during atomic phase. This is needed because an open upvalue might point to a stack location in a dead thread that never marked the stack
  * slot - upvalues like this are identified since they don't have `markedopen` bit set during thread traversal and closed in `clearupvals`.
+ *
+ * Generational mode (enabled via LUA_GCGEN) is built on top of the same state machine using "sticky" marks. Instead of repainting
+ * all surviving objects with the new white, sweep leaves them black (or gray), which makes them old; objects allocated afterwards
+ * are white, which makes them young. Since the tri-color invariant is now maintained at all times (see keepinvariant), the existing
+ * barriers turn into a remembered set: a write of a young object into an old one either marks the young object (forward barrier),
+ * or turns the old object gray (backward barrier), and the objects end up on `gray`/`grayagain` lists that are preserved until the
+ * next collection starts. A minor collection then marks from the roots without resetting these lists, never traversing old black
+ * objects, and only sweeps the pages that received allocations since the last sweep (see lua_Page::young in lmem.cpp) as old
+ * objects can't die in a minor collection.
+ *
+ * Weak tables are black after the cycle like other survivors; a write of a young object into an old weak table goes through the
+ * backward barrier, so the next minor collection only traverses and clears weak tables that were modified since the last cycle.
+ * Open upvalues of old threads that were not traversed are kept open based on OLDBIT.
+ *
+ * Weak tables are painted black once traversed and linked into the `weak` list (marked with WEAKBIT). A write into such a table turns it
+ * gray without moving it to `grayagain`, since its `gclist` is taken by the weak list; the atomic phase only traverses again the gray
+ * ones, so the time it takes doesn't depend on the size of weak tables that weren't modified during the mark phase.
+ *
+ * Once the heap at the end of a minor collection exceeds the size at the end of the last major collection by gcgenmajormul%, the sweep
+ * is restarted to repaint all survivors with the new white, and the following cycle is a regular full (major) collection, the sweep
+ * of which makes everything old again.
+ *
+ * Permanent objects (see LUA_GCFREEZE) live in pages that are neither swept nor written by the collector, which keeps them shared with
+ * processes forked after they were made permanent. They have both white bits and the black bit set: marking treats them as white and
+ * skips them in reallymarkobject, and barriers treat them as black and handle them without turning them gray. Instead, every cycle that
+ * marks old objects scans the permanent pages incrementally and marks what they refer to, and permanent objects modified during the
+ * mark are recorded in a side bitmap (PermanentHeap::rescan) to be traversed again by atomic. Permanent weak tables are recorded in
+ * another bitmap in place of the weak list; permanent objects themselves are never cleared from weak tables.
+ *
+ * Heap snapshots (luaC_startheapsnapshot) can also piggyback on incremental marking instead of walking the heap in one go: during
+ * the next full mark, every object is reported once its references are traversed, and objects that are traversed again (because
+ * they were caught by a barrier or are gray again) are reported again with their current references. Forward barriers report the
+ * modified black object as well. As a result, the last report of each object reflects its references at the end of the atomic phase,
+ * except for writes of objects that are already marked into upvalues or userdata metatables, as these don't trigger barriers.
  */
 
 #define GC_SWEEPPAGESTEPCOST 16
@@ -126,14 +161,14 @@
             interrupt(L, state); \
     }
 
-#define maskmarks cast_byte(~(bitmask(BLACKBIT) | WHITEBITS))
+#define maskmarks cast_byte(~(bitmask(BLACKBIT) | WHITEBITS | bitmask(OLDBIT) | bitmask(WEAKBIT)))
 
 #define makewhite(g, x) ((x)->gch.marked = cast_byte(((x)->gch.marked & maskmarks) | luaC_white(g)))
 
 #define white2gray(x) reset2bits((x)->gch.marked, WHITE0BIT, WHITE1BIT)
 #define black2gray(x) resetbit((x)->gch.marked, BLACKBIT)
 
-#define stringmark(s) reset2bits((s)->marked, WHITE0BIT, WHITE1BIT)
+#define stringmark(s) (ispermanent(obj2gco(s)) ? (void)0 : (void)reset2bits((s)->marked, WHITE0BIT, WHITE1BIT))
 
 #define markvalue(g, o) \
     { \
@@ -232,14 +267,65 @@ static void removeentry(LuaNode* n)
         setttype(gkey(n), LUA_TDEADKEY); // dead key; remove it
 }
 
+// report the object to the heap snapshot once its references have been traversed
+static void snapshotobj(global_State* g, GCObject* o)
+{
+    if (LUAU_UNLIKELY(g->gcsnapshot.active))
+        luaC_snapshotobj(g, o);
+}
+
+// size of the object and the memory it owns, attributed to its memory category when the object is marked
+static size_t markedsize(GCObject* o)
+{
+    switch (o->gch.tt)
+    {
+    case LUA_TSTRING:
+        return sizestring(gco2ts(o)->len);
+    case LUA_TUSERDATA:
+        return sizeudata(gco2u(o)->len);
+    case LUA_TUPVAL:
+        return sizeof(UpVal);
+    case LUA_TFUNCTION:
+        return gco2cl(o)->isC ? sizeCclosure(gco2cl(o)->nupvalues) : sizeLclosure(gco2cl(o)->nupvalues);
+    case LUA_TTABLE:
+        return luaH_memsize(gco2h(o));
+    case LUA_TTHREAD:
+    {
+        lua_State* th = gco2th(o);
+        return sizeof(lua_State) + sizeof(TValue) * th->stacksize + sizeof(CallInfo) * th->size_ci;
+    }
+    case LUA_TBUFFER:
+        return sizebufferobj(gco2buf(o));
+    case LUA_TPROTO:
+    {
+        Proto* p = gco2p(o);
+        return sizeof(Proto) + sizeof(Instruction) * p->sizecode + sizeof(Proto*) * p->sizep + sizeof(TValue) * p->sizek + p->sizelineinfo +
+               sizeof(LocVar) * p->sizelocvars + sizeof(TString*) * p->sizeupvalues;
+    }
+    default:
+        LUAU_ASSERT(0);
+        return 0;
+    }
+}
+
 static void reallymarkobject(global_State* g, GCObject* o)
 {
     LUAU_ASSERT(iswhite(o) && !isdead(g, o));
+
+    // permanent objects look white, but their references are marked by the scan of permanent pages instead
+    if (ispermanent(o))
+        return;
+
     white2gray(o);
+
+    if (LUAU_UNLIKELY(g->memcatstats != NULL))
+        g->memcatstats->marked[o->gch.memcat] += markedsize(o);
+
     switch (o->gch.tt)
     {
     case LUA_TSTRING:
     {
+        snapshotobj(g, o);
         return;
     }
     case LUA_TUSERDATA:
@@ -248,6 +334,7 @@ static void reallymarkobject(global_State* g, GCObject* o)
         gray2black(o); // udata are never gray
         if (mt)
             markobject(g, mt);
+        snapshotobj(g, o);
         return;
     }
     case LUA_TUPVAL:
@@ -256,6 +343,7 @@ static void reallymarkobject(global_State* g, GCObject* o)
         markvalue(g, uv->v);
         if (!upisopen(uv)) // closed?
             gray2black(o); // open upvalues are never black
+        snapshotobj(g, o);
         return;
     }
     case LUA_TFUNCTION:
@@ -279,6 +367,7 @@ static void reallymarkobject(global_State* g, GCObject* o)
     case LUA_TBUFFER:
     {
         gray2black(o); // buffers are never gray
+        snapshotobj(g, o);
         return;
     }
     case LUA_TPROTO:
@@ -315,10 +404,12 @@ static int traversetable(global_State* g, Table* h)
     {
         weakkey = (strchr(modev, 'k') != NULL);
         weakvalue = (strchr(modev, 'v') != NULL);
-        if (weakkey || weakvalue)
-        {                         // is really weak?
+        // is really weak? permanent tables are recorded in PermanentHeap::weak by the caller instead
+        if ((weakkey || weakvalue) && !ispermanent(obj2gco(h)))
+        {
             h->gclist = g->weak;  // must be cleared after GC, ...
             g->weak = obj2gco(h); // ... so put in the appropriate list
+            l_setbit(h->marked, WEAKBIT);
         }
     }
 
@@ -360,6 +451,10 @@ static void traverseproto(global_State* g, Proto* f)
         stringmark(f->source);
     if (f->debugname)
         stringmark(f->debugname);
+    if (f->lazychunk)
+        markobject(g, f->lazychunk);
+    if (f->debugchunk)
+        markobject(g, f->debugchunk);
     for (i = 0; i < f->sizek; i++) // mark literals
         markvalue(g, &f->k[i]);
     for (i = 0; i < f->sizeupvalues; i++)
@@ -436,12 +531,15 @@ static void shrinkstack(lua_State* L)
     int s_used = cast_int(lim - L->stack);      // part of stack in use
     if (L->size_ci > LUAI_MAXCALLS)             // handling overflow?
         return;                                 // do not touch the stacks
-    if (3 * ci_used < L->size_ci && 2 * BASIC_CI_SIZE < L->size_ci)
-        luaD_reallocCI(L, L->size_ci / 2); // still big enough...
-    condhardstacktests(luaD_reallocCI(L, ci_used + 1));
-    if (3 * s_used < L->stacksize && 2 * (BASIC_STACK_SIZE + EXTRA_STACK) < L->stacksize)
-        luaD_reallocstack(L, L->stacksize / 2); // still big enough...
-    condhardstacktests(luaD_reallocstack(L, s_used));
+    // threads with a stack reserve are not shrunk below it, so that deep recursion doesn't regrow the stack after every collection
+    int ci_reserve = stackcisize(L->stackreserve);
+    int s_reserve = L->stackreserve + EXTRA_STACK;
+    if (3 * ci_used < L->size_ci && 2 * BASIC_CI_SIZE < L->size_ci && ci_reserve < L->size_ci)
+        luaD_reallocCI(L, L->size_ci / 2 > ci_reserve ? L->size_ci / 2 : ci_reserve); // still big enough...
+    condhardstacktests(luaD_reallocCI(L, ci_used + 1 > ci_reserve ? ci_used + 1 : ci_reserve));
+    if (3 * s_used < L->stacksize && 2 * (BASIC_STACK_SIZE + EXTRA_STACK) < L->stacksize && s_reserve < L->stacksize)
+        luaD_reallocstack(L, L->stacksize / 2 > s_reserve ? L->stacksize / 2 : s_reserve); // still big enough...
+    condhardstacktests(luaD_reallocstack(L, s_used > s_reserve ? s_used : s_reserve));
 }
 
 /*
@@ -459,8 +557,8 @@ static size_t propagatemark(global_State* g)
     {
         Table* h = gco2h(o);
         g->gray = h->gclist;
-        if (traversetable(g, h)) // table is weak?
-            black2gray(o);       // keep it gray
+        traversetable(g, h);
+        snapshotobj(g, o);
         return sizeof(Table) + sizeof(TValue) * h->sizearray + sizeof(LuaNode) * sizenode(h);
     }
     case LUA_TFUNCTION:
@@ -468,6 +566,7 @@ static size_t propagatemark(global_State* g)
         Closure* cl = gco2cl(o);
         g->gray = cl->gclist;
         traverseclosure(g, cl);
+        snapshotobj(g, o);
         return cl->isC ? sizeCclosure(cl->nupvalues) : sizeLclosure(cl->nupvalues);
     }
     case LUA_TTHREAD:
@@ -478,6 +577,7 @@ static size_t propagatemark(global_State* g)
         bool active = th->isactive || th == th->global->mainthread;
 
         traversestack(g, th);
+        snapshotobj(g, o);
 
         // active threads will need to be rescanned later to mark new stack writes so we mark them gray again
         if (active)
@@ -494,7 +594,8 @@ static size_t propagatemark(global_State* g)
             clearstack(th);
 
         // we could shrink stack at any time but we opt to do it during initial mark to do that just once per cycle
-        if (g->gcstate == GCSpropagate)
+        // pooled threads keep their stacks so that they can be reused without growing them again
+        if (g->gcstate == GCSpropagate && !th->pooled)
             shrinkstack(th);
 
         return sizeof(lua_State) + sizeof(TValue) * th->stacksize + sizeof(CallInfo) * th->size_ci;
@@ -504,6 +605,7 @@ static size_t propagatemark(global_State* g)
         Proto* p = gco2p(o);
         g->gray = p->gclist;
         traverseproto(g, p);
+        snapshotobj(g, o);
         return sizeof(Proto) + sizeof(Instruction) * p->sizecode + sizeof(Proto*) * p->sizep + sizeof(TValue) * p->sizek + p->sizelineinfo +
                sizeof(LocVar) * p->sizelocvars + sizeof(TString*) * p->sizeupvalues;
     }
@@ -537,7 +639,7 @@ static int isobjcleared(GCObject* o)
         return 0;
     }
 
-    return iswhite(o);
+    return iswhite(o) && !ispermanent(o);
 }
 
 #define iscleared(o) (iscollectable(o) && isobjcleared(gcvalue(o)))
@@ -545,59 +647,261 @@ static int isobjcleared(GCObject* o)
 /*
 ** clear collected entries from weaktables
 */
-static size_t cleartable(lua_State* L, GCObject* l)
+// moves weak tables that were written to since they were traversed to the gray list; the rest stay in the weak list as they are
+static size_t remarkweak(global_State* g)
 {
     size_t work = 0;
+    GCObject* l = g->weak;
+    g->weak = NULL;
+
     while (l)
     {
         Table* h = gco2h(l);
-        work += sizeof(Table) + sizeof(TValue) * h->sizearray + sizeof(LuaNode) * sizenode(h);
+        GCObject* next = h->gclist;
+        LUAU_ASSERT(isweak(l));
 
-        int i = h->sizearray;
-        while (i--)
+        if (isgray(l))
         {
-            TValue* o = &h->array[i];
-            if (iscleared(o))   // value was collected?
-                setnilvalue(o); // remove value
+            resetbit(h->marked, WEAKBIT); // traversal puts it back into the weak list
+            h->gclist = g->gray;
+            g->gray = l;
         }
-        i = sizenode(h);
-        int activevalues = 0;
-        while (i--)
+        else
         {
-            LuaNode* n = gnode(h, i);
+            h->gclist = g->weak;
+            g->weak = l;
+        }
+
+        work += sizeof(Table);
+        l = next;
+    }
 
-            // non-empty entry?
-            if (!ttisnil(gval(n)))
+    return work;
+}
+
+// removes entries with collected keys or values from a weak table
+static size_t cleartableentries(lua_State* L, Table* h)
+{
+    size_t work = sizeof(Table) + sizeof(TValue) * h->sizearray + sizeof(LuaNode) * sizenode(h);
+
+    int i = h->sizearray;
+    while (i--)
+    {
+        TValue* o = &h->array[i];
+        if (iscleared(o))   // value was collected?
+            setnilvalue(o); // remove value
+    }
+    i = sizenode(h);
+    int activevalues = 0;
+    while (i--)
+    {
+        LuaNode* n = gnode(h, i);
+
+        // non-empty entry?
+        if (!ttisnil(gval(n)))
+        {
+            // can we clear key or value?
+            if (iscleared(gkey(n)) || iscleared(gval(n)))
             {
-                // can we clear key or value?
-                if (iscleared(gkey(n)) || iscleared(gval(n)))
-                {
-                    setnilvalue(gval(n)); // remove value ...
-                    removeentry(n);       // remove entry from table
-                }
-                else
-                {
-                    activevalues++;
-                }
+                setnilvalue(gval(n)); // remove value ...
+                removeentry(n);       // remove entry from table
+            }
+            else
+            {
+                activevalues++;
             }
         }
+    }
 
-        if (const char* modev = gettablemode(L->global, h))
+    if (const char* modev = gettablemode(L->global, h))
+    {
+        // are we allowed to shrink this weak table? hash part that is shared with other tables can't be resized
+        if (strchr(modev, 's') && !(h->readonly & TABLE_SHAREDNODE))
         {
-            // are we allowed to shrink this weak table?
-            if (strchr(modev, 's'))
-            {
-                // shrink at 37.5% occupancy
-                if (activevalues < sizenode(h) * 3 / 8)
-                    luaH_resizehash(L, h, activevalues);
-            }
+            // shrink at 37.5% occupancy
+            if (activevalues < sizenode(h) * 3 / 8)
+                luaH_resizehash(L, h, activevalues);
         }
+    }
+
+    return work;
+}
+
+static size_t cleartable(lua_State* L, GCObject* l)
+{
+    size_t work = 0;
+    while (l)
+    {
+        Table* h = gco2h(l);
+
+        LUAU_ASSERT(isweak(l));
+        resetbit(h->marked, WEAKBIT);
+
+        work += cleartableentries(L, h);
 
         l = h->gclist;
     }
     return work;
 }
 
+#define setpermanentbit(bits, bit) ((bits)[(bit) / 32] |= 1u << ((bit) % 32))
+
+#define permanentscanpending(g) ((g)->permheap && (g)->permheap->scanpage < (g)->permheap->pagecount)
+
+// bit of a permanent object in the bitmaps of the permanent heap
+static int findpermanent(PermanentHeap* ph, GCObject* o)
+{
+    char* pos = (char*)o;
+
+    int lo = 0;
+    int hi = ph->pagecount - 1;
+
+    while (lo < hi)
+    {
+        int mid = (lo + hi + 1) / 2;
+
+        if (ph->pages[mid].start <= pos)
+            lo = mid;
+        else
+            hi = mid - 1;
+    }
+
+    PermanentPage& page = ph->pages[lo];
+    LUAU_ASSERT(pos >= page.start && pos < page.end && (pos - page.start) % page.blockSize == 0);
+
+    return page.bitbase + int(pos - page.start) / page.blockSize;
+}
+
+// marks references of a permanent object without writing into the object
+static size_t traversepermanent(global_State* g, GCObject* o, int bit)
+{
+    switch (o->gch.tt)
+    {
+    case LUA_TSTRING:
+    case LUA_TBUFFER:
+        break;
+    case LUA_TUSERDATA:
+        if (Table* mt = gco2u(o)->metatable)
+            markobject(g, mt);
+        break;
+    case LUA_TUPVAL:
+        LUAU_ASSERT(!upisopen(gco2uv(o)));
+        markvalue(g, gco2uv(o)->v);
+        break;
+    case LUA_TFUNCTION:
+        traverseclosure(g, gco2cl(o));
+        break;
+    case LUA_TTABLE:
+        if (traversetable(g, gco2h(o)))
+            setpermanentbit(g->permheap->weak, bit);
+        break;
+    case LUA_TPROTO:
+        traverseproto(g, gco2p(o));
+        break;
+    default:
+        LUAU_ASSERT(!"Unexpected permanent object");
+    }
+
+    snapshotobj(g, o);
+    return markedsize(o);
+}
+
+// traverses the next page of the permanent heap; each cycle that marks old objects goes through all permanent objects
+static size_t scanpermanentpage(global_State* g)
+{
+    PermanentHeap* ph = g->permheap;
+    PermanentPage& page = ph->pages[ph->scanpage++];
+
+    int bit = page.bitbase;
+
+    for (char* pos = page.start; pos != page.end; pos += page.blockSize, bit++)
+    {
+        GCObject* o = (GCObject*)pos;
+
+        // skip memory blocks that were already freed when the page became permanent
+        if (o->gch.tt == LUA_TNIL)
+            continue;
+
+        size_t size = traversepermanent(g, o, bit);
+
+        if (LUAU_UNLIKELY(g->memcatstats != NULL))
+            g->memcatstats->marked[o->gch.memcat] += size;
+    }
+
+    return page.end - page.start;
+}
+
+// calls the visitor for every permanent object that has a bit set in the bitmap, resetting the bits
+static size_t visitpermanentbits(lua_State* L, uint32_t* bits, size_t (*visitor)(lua_State* L, GCObject* o, int bit))
+{
+    PermanentHeap* ph = L->global->permheap;
+
+    size_t work = 0;
+
+    for (int i = 0; i < ph->pagecount; i++)
+    {
+        PermanentPage& page = ph->pages[i];
+        int blocks = int(page.end - page.start) / page.blockSize;
+
+        for (int w = 0; w < (blocks + 31) / 32; w++)
+        {
+            uint32_t& word = bits[page.bitbase / 32 + w];
+
+            for (int b = 0; word; b++)
+            {
+                if (word & (1u << b))
+                {
+                    word &= ~(1u << b);
+                    work += visitor(L, (GCObject*)(page.start + (w * 32 + b) * page.blockSize), page.bitbase + w * 32 + b);
+                }
+            }
+        }
+    }
+
+    return work;
+}
+
+static size_t rescanpermanentobj(lua_State* L, GCObject* o, int bit)
+{
+    return traversepermanent(L->global, o, bit);
+}
+
+// traverses permanent objects that were modified during the mark, as they can't be turned gray
+static size_t rescanpermanent(lua_State* L)
+{
+    PermanentHeap* ph = L->global->permheap;
+
+    if (!ph || !ph->rescanpending)
+        return 0;
+
+    ph->rescanpending = false;
+
+    return visitpermanentbits(L, ph->rescan, rescanpermanentobj);
+}
+
+static size_t clearpermanentobj(lua_State* L, GCObject* o, int bit)
+{
+    return cleartableentries(L, gco2h(o));
+}
+
+// removes collected objects from permanent weak tables traversed by this cycle
+static size_t clearpermanent(lua_State* L)
+{
+    PermanentHeap* ph = L->global->permheap;
+
+    if (!ph)
+        return 0;
+
+    return visitpermanentbits(L, ph->weak, clearpermanentobj);
+}
+
+static void freepermanentheap(lua_State* L, PermanentHeap* ph)
+{
+    luaM_freearray(L, ph->pages, ph->pagecount, PermanentPage, 0);
+    luaM_freearray(L, ph->rescan, ph->words, uint32_t, 0);
+    luaM_freearray(L, ph->weak, ph->words, uint32_t, 0);
+}
+
 static void freeobj(lua_State* L, GCObject* o, lua_Page* page)
 {
     switch (o->gch.tt)
@@ -664,10 +968,20 @@ void luaC_freeall(lua_State* L)
 
     LUAU_ASSERT(L == g->mainthread);
 
+    if (PermanentHeap* ph = g->permheap)
+    {
+        freepermanentheap(L, ph);
+        luaM_freearray(L, ph, 1, PermanentHeap, 0);
+        g->permheap = NULL;
+    }
+
+    luaM_thawgcopages(L);
     luaM_visitgco(L, L, deletegco);
 
     for (int i = 0; i < g->strt.size; i++) // free all string lists
         LUAU_ASSERT(g->strt.hash[i] == NULL);
+    for (int i = 0; i < g->strt.oldsize; i++)
+        LUAU_ASSERT(g->strt.oldhash[i] == NULL);
 
     LUAU_ASSERT(L->global->strt.nuse == 0);
 }
@@ -680,18 +994,83 @@ static void markmt(global_State* g)
             markobject(g, g->mt[i]);
 }
 
+static void markthreadpool(global_State* g)
+{
+    for (int i = 0; i < g->threadpoolsize; i++)
+        markobject(g, g->threadpool[i]);
+}
+
+static void markrefs(global_State* g)
+{
+    for (int i = 1; i < g->refsused; i++)
+        markvalue(g, &g->refs[i]);
+}
+
+static void markprofiler(global_State* g)
+{
+    for (uint64_t pos = g->proftail; pos < g->profhead; pos++)
+    {
+        ProfilerEntry* e = &g->profentries[pos % g->profsize];
+        if (e->function && iswhite(e->function))
+            reallymarkobject(g, e->function);
+    }
+
+    // functions that allocated live sampled objects stay alive so that the samples can be resolved
+    for (int i = 0; i < g->heapsamplecount; i++)
+    {
+        HeapSample* s = &g->heapsamples[i];
+
+        for (int f = 0; f < s->depth; f++)
+        {
+            GCObject* o = (GCObject*)s->frames[f].function;
+            if (iswhite(o))
+                reallymarkobject(g, o);
+        }
+    }
+}
+
 // mark root set
 static void markroot(lua_State* L)
 {
     global_State* g = L->global;
-    g->gray = NULL;
-    g->grayagain = NULL;
+
+    // if the last sweep kept the marks, old objects are not traversed again and gray lists accumulated by barriers act as remembered set
+    g->gcgenminor = g->gcgensticky;
+
+    if (!g->gcgenminor)
+    {
+        g->gray = NULL;
+        g->grayagain = NULL;
+    }
+
     g->weak = NULL;
+
+    // old objects keep their marks in minor collections, so the bytes they were marked with last time are kept as well
+    if (g->memcatstats && !g->gcgenminor)
+        memset(g->memcatstats->marked, 0, sizeof(g->memcatstats->marked));
+
+    // pending heap snapshot starts with a cycle that traverses every live object
+    if (g->gcsnapshot.pending && !g->gcgenminor)
+    {
+        g->gcsnapshot.pending = false;
+        g->gcsnapshot.active = true;
+    }
+
+    // permanent objects are old, so their pages are only scanned by the cycles that mark old objects
+    if (PermanentHeap* ph = g->permheap)
+    {
+        ph->scanpage = g->gcgenminor ? ph->pagecount : 0;
+        memset(ph->weak, 0, ph->words * sizeof(uint32_t));
+    }
+
     markobject(g, g->mainthread);
     // make global table be traversed before main stack
     markobject(g, g->mainthread->gt);
     markvalue(g, registry(L));
+    markrefs(g);
     markmt(g);
+    markthreadpool(g);
+    markprofiler(g);
     g->gcstate = GCSpropagate;
 }
 
@@ -727,7 +1106,7 @@ static size_t clearupvals(lua_State* L)
         LUAU_ASSERT(upisopen(uv));
         LUAU_ASSERT(uv->u.open.next->u.open.prev == uv && uv->u.open.prev->u.open.next == uv);
         LUAU_ASSERT(!isblack(obj2gco(uv))); // open upvalues are never black
-        LUAU_ASSERT(iswhite(obj2gco(uv)) || !iscollectable(uv->v) || !iswhite(gcvalue(uv->v)));
+        LUAU_ASSERT(iswhite(obj2gco(uv)) || !iscollectable(uv->v) || !iswhite(gcvalue(uv->v)) || ispermanent(gcvalue(uv->v)));
 
         if (uv->markedopen)
         {
@@ -736,6 +1115,12 @@ static size_t clearupvals(lua_State* L)
             uv->markedopen = 0; // for next cycle
             uv = uv->u.open.next;
         }
+        else if (g->gcgenminor && isold(obj2gco(uv)))
+        {
+            // upvalue belongs to an old thread that wasn't traversed by minor collection; old threads can't die until the next major one
+            LUAU_ASSERT(isgray(obj2gco(uv)));
+            uv = uv->u.open.next;
+        }
         else
         {
             // upvalue is either dead, or alive but the thread is dead; unlink and close
@@ -748,6 +1133,65 @@ static size_t clearupvals(lua_State* L)
     return work;
 }
 
+static size_t markpatterncache(global_State* g)
+{
+    size_t work = 0;
+
+    for (int i = 0; i < LUA_PATTERNCACHE; i++)
+    {
+        PatternCacheEntry& e = g->patterncache[i];
+
+        if (!e.pattern)
+            continue;
+
+        // the pattern will be collected by this cycle so it can't be used as a cache key anymore
+        if (iswhite(obj2gco(e.pattern)) && !isfixed(obj2gco(e.pattern)) && !ispermanent(obj2gco(e.pattern)))
+        {
+            e = PatternCacheEntry();
+            continue;
+        }
+
+        markobject(g, e.code);
+        work += sizeof(PatternCacheEntry);
+    }
+
+    return work;
+}
+
+static bool iscollected(GCObject* o)
+{
+    return iswhite(o) && !isfixed(o) && !ispermanent(o);
+}
+
+static size_t clearindexcache(global_State* g)
+{
+    size_t work = 0;
+
+    for (int i = 0; i < LUA_INDEXCACHE; i++)
+    {
+        IndexCacheEntry& e = g->indexcache[i];
+
+        if (e.depth < 0)
+            continue;
+
+        // memory of collected objects can be reused for new ones, which would make the pointer comparisons succeed
+        bool collected = iscollected(obj2gco(e.key));
+
+        for (int j = 0; j <= e.depth; j++)
+            collected = collected || iscollected(obj2gco(e.tables[j]));
+
+        if (collected)
+        {
+            e = IndexCacheEntry();
+            continue;
+        }
+
+        work += sizeof(IndexCacheEntry);
+    }
+
+    return work;
+}
+
 static size_t atomic(lua_State* L)
 {
     global_State* g = L->global;
@@ -761,6 +1205,8 @@ static size_t atomic(lua_State* L)
 
     // remark occasional upvalues of (maybe) dead threads
     work += remarkupvals(g);
+    // traverse permanent objects caught by write barrier
+    work += rescanpermanent(L);
     // traverse objects caught by write barrier and by 'remarkupvals'
     work += propagateall(g);
 
@@ -768,12 +1214,13 @@ static size_t atomic(lua_State* L)
     g->gcmetrics.currcycle.atomictimeupval += recordGcDeltaTime(currts);
 #endif
 
-    // remark weak tables
-    g->gray = g->weak;
-    g->weak = NULL;
+    // remark weak tables that were modified after they were traversed
+    work += remarkweak(g);
     LUAU_ASSERT(!iswhite(obj2gco(g->mainthread)));
-    markobject(g, L); // mark running thread
-    markmt(g);        // mark basic metatables (again)
+    markobject(g, L);  // mark running thread
+    markmt(g);         // mark basic metatables (again)
+    markthreadpool(g); // mark threads released to the pool during the cycle
+    markprofiler(g);   // mark functions of samples recorded during the cycle
     work += propagateall(g);
 
 #ifdef LUAI_GCMETRICS
@@ -789,8 +1236,15 @@ static size_t atomic(lua_State* L)
     g->gcmetrics.currcycle.atomictimegray += recordGcDeltaTime(currts);
 #endif
 
+    // keep compiled patterns of reachable pattern strings
+    work += markpatterncache(g);
+
+    // drop lookup chains that reference objects collected by this cycle
+    work += clearindexcache(g);
+
     // remove collected objects from weak tables
     work += cleartable(L, g->weak);
+    work += clearpermanent(L);
     g->weak = NULL;
 
 #ifdef LUAI_GCMETRICS
@@ -804,6 +1258,25 @@ static size_t atomic(lua_State* L)
     g->gcmetrics.currcycle.atomictimeupval += recordGcDeltaTime(currts);
 #endif
 
+    if (g->memcatstats)
+        memcpy(g->memcatstats->live, g->memcatstats->marked, sizeof(g->memcatstats->live));
+
+    // all live objects have been reported
+    if (g->gcsnapshot.active)
+    {
+        GCHeapSnapshot snapshot = g->gcsnapshot;
+        g->gcsnapshot = GCHeapSnapshot();
+
+        if (snapshot.done)
+            snapshot.done(snapshot.context);
+    }
+
+    // in generational mode, survivors keep their marks and become old
+    g->gcgensticky = g->gcgen;
+
+    // pages that were starved during the last cycle are reevaluated by the sweep
+    luaM_restoresparsepages(L);
+
     // flip current white
     g->currentwhite = cast_byte(otherwhite(g));
     g->sweepgcopage = g->allgcopages;
@@ -812,6 +1285,19 @@ static size_t atomic(lua_State* L)
     return work;
 }
 
+// restart the sweep from the first page, repainting all alive objects with current white; nothing alive is going to be freed
+static void resetsweep(global_State* g)
+{
+    g->sweepgcopage = g->allgcopages;
+    g->gcgensticky = false;
+    g->gcgenminor = false;
+    // reset other collector lists
+    g->gray = NULL;
+    g->grayagain = NULL;
+    g->weak = NULL;
+    g->gcstate = GCSsweep;
+}
+
 // a version of generic luaM_visitpage specialized for the main sweep stage
 static int sweepgcopage(lua_State* L, lua_Page* page)
 {
@@ -830,20 +1316,37 @@ static int sweepgcopage(lua_State* L, lua_Page* page)
 
     int newwhite = luaC_white(g);
 
+    bool sticky = g->gcgensticky;
+    bool young = false;
+
+    const uint32_t* map = luaM_getpageblockmap(page);
+
     for (char* pos = start; pos != end; pos += blockSize)
     {
         GCObject* gco = (GCObject*)pos;
 
-        // skip memory blocks that are already freed
-        if (gco->gch.tt == LUA_TNIL)
+        // skip memory blocks that are already freed; the block map avoids touching their memory
+        if (map ? !luaM_isblockused(map, page, pos) : gco->gch.tt == LUA_TNIL)
             continue;
 
         // is the object alive?
         if ((gco->gch.marked ^ WHITEBITS) & deadmask)
         {
             LUAU_ASSERT(!isdead(g, gco));
-            // make it white (for next cycle)
-            gco->gch.marked = cast_byte((gco->gch.marked & maskmarks) | newwhite);
+
+            if (sticky)
+            {
+                // marked objects become old; white objects were allocated after the mark and stay young
+                if (!iswhite(gco))
+                    l_setbit(gco->gch.marked, OLDBIT);
+                else if (!isfixed(gco))
+                    young = true;
+            }
+            else
+            {
+                // make it white (for next cycle)
+                gco->gch.marked = cast_byte((gco->gch.marked & maskmarks) | newwhite);
+            }
         }
         else
         {
@@ -856,6 +1359,9 @@ static int sweepgcopage(lua_State* L, lua_Page* page)
         }
     }
 
+    // pages with only old objects don't need to be swept by minor collections
+    luaM_setgcopageyoung(page, !sticky || young);
+
     return int(end - start) / blockSize;
 }
 
@@ -867,18 +1373,28 @@ static size_t gcstep(lua_State* L, size_t limit)
     {
     case GCSpause:
     {
+        // minor collections don't traverse old objects, so a pending heap snapshot needs the marks to be reset first
+        if (g->gcsnapshot.pending && g->gcgensticky)
+        {
+            resetsweep(g);
+            break;
+        }
+
         markroot(L); // start a new collection
         LUAU_ASSERT(g->gcstate == GCSpropagate);
         break;
     }
     case GCSpropagate:
     {
-        while (g->gray && cost < limit)
+        while ((g->gray || permanentscanpending(g)) && cost < limit)
         {
-            cost += propagatemark(g);
+            if (g->gray)
+                cost += propagatemark(g);
+            else
+                cost += scanpermanentpage(g);
         }
 
-        if (!g->gray)
+        if (!g->gray && !permanentscanpending(g))
         {
 #ifdef LUAI_GCMETRICS
             g->gcmetrics.currcycle.propagatework = g->gcmetrics.currcycle.explicitwork + g->gcmetrics.currcycle.assistwork;
@@ -927,22 +1443,63 @@ static size_t gcstep(lua_State* L, size_t limit)
     }
     case GCSsweep:
     {
+        // minor collection can only free young objects
+        bool skipold = g->gcgenminor && g->gcgensticky;
+
+        // pages emptied by the sweep are handed off to the host after the step
+        g->releasegcodeferred = g->cb.releasepages != NULL;
+
         while (g->sweepgcopage && cost < limit)
         {
             lua_Page* next = luaM_getnextgcopage(g->sweepgcopage); // page sweep might destroy the page
 
+            if (skipold && !luaM_isgcopageyoung(g->sweepgcopage))
+            {
+                g->sweepgcopage = next;
+                cost += GC_SWEEPPAGESTEPCOST;
+                continue;
+            }
+
             int steps = sweepgcopage(L, g->sweepgcopage);
 
             g->sweepgcopage = next;
             cost += steps * GC_SWEEPPAGESTEPCOST;
         }
 
+        g->releasegcodeferred = false;
+
+        if (lua_Page* pages = g->releasegcopages)
+        {
+            g->releasegcopages = NULL;
+            g->cb.releasepages(L, pages);
+        }
+
+        luaU_flushbatches(L);
+
         // nothing more to sweep?
         if (g->sweepgcopage == NULL)
         {
             // don't forget to visit main thread, it's the only object not allocated in GCO pages
             LUAU_ASSERT(!isdead(g, obj2gco(g->mainthread)));
-            makewhite(g, obj2gco(g->mainthread)); // make it white (for next cycle)
+
+            if (g->gcgensticky)
+            {
+                // if old objects have accumulated enough garbage, repaint everything white for the next cycle to be a major collection
+                if (g->gcgenminor && g->totalbytes > g->gcgenmajorbase / 100 * (100 + g->gcgenmajormul))
+                {
+                    resetsweep(g);
+                    break;
+                }
+
+                if (!g->gcgenminor)
+                    g->gcgenmajorbase = g->totalbytes;
+
+                // main thread remains gray in `grayagain' list to be traversed by the next minor collection
+            }
+            else
+            {
+                makewhite(g, obj2gco(g->mainthread)); // make it white (for next cycle)
+            }
 
             shrinkbuffers(L);
 
@@ -1010,6 +1567,52 @@ static size_t getheaptrigger(global_State* g, size_t heapgoal)
     return heaptrigger < int64_t(g->totalbytes) ? g->totalbytes : (heaptrigger > int64_t(heapgoal) ? heapgoal : size_t(heaptrigger));
 }
 
+// picks the step size that fits into the target pause and raises the goal when the allocation rate makes the collector too expensive
+static void adaptpacing(global_State* g)
+{
+    GCStats& stats = g->gcstats;
+
+    if (stats.cyclework > 0 && stats.cycletime > 0)
+    {
+        double cost = stats.cycletime / double(stats.cyclework);
+        stats.workcost = stats.workcost > 0 ? (stats.workcost + cost) * 0.5 : cost;
+    }
+
+    if (stats.workcost > 0)
+    {
+        // each step performs gcstepsize * gcstepmul / 100 bytes of work
+        double stepwork = g->gcadaptivepause * 1e-6 / stats.workcost;
+        double stepsize = stepwork * 100 / g->gcstepmul;
+
+        double minstepsize = LUAI_GCSTEPSIZE << 10;
+        double maxstepsize = LUAI_GCADAPTIVEMAXSTEPSIZE << 10;
+        g->gcstepsize = int(stepsize < minstepsize ? minstepsize : (stepsize > maxstepsize ? maxstepsize : stepsize));
+    }
+
+    // the allocation rate is measured between the end of the last cycle and the atomic phase of this one
+    const double durationthreshold = 1e-3;
+    double allocationduration = stats.atomicstarttimestamp - stats.endtimestamp;
+    double allocationrate = allocationduration < durationthreshold ? 0.0 : (stats.atomicstarttotalsizebytes - stats.endtotalsizebytes) / allocationduration;
+
+    if (allocationrate > 0 && g->totalbytes > 0)
+    {
+        // a cycle starts after the heap grows by (goal - 100)% of the live size, so the share of execution time taken by the collector is
+        // cycletime * allocationrate / ((goal - 100)% * live size)
+        double growth = stats.cycletime * allocationrate * 100.0 / (LUAI_GCADAPTIVEFRACTION / 100.0 * double(g->totalbytes));
+        double goal = 100 + growth;
+
+        g->gcgoal = int(goal < g->gcadaptivegoal ? g->gcadaptivegoal : (goal > LUAI_GCADAPTIVEMAXGOAL ? LUAI_GCADAPTIVEMAXGOAL : goal));
+    }
+
+    stats.cycletime = 0;
+
+#ifdef LUAI_GCMETRICS
+    g->gcmetrics.currcycle.adaptiveallocationrate = allocationrate;
+    g->gcmetrics.currcycle.adaptivegoal = g->gcgoal;
+    g->gcmetrics.currcycle.adaptivestepsize = g->gcstepsize;
+#endif
+}
+
 size_t luaC_step(lua_State* L, bool assist)
 {
     global_State* g = L->global;
@@ -1033,8 +1636,18 @@ size_t luaC_step(lua_State* L, bool assist)
 
     int lastgcstate = g->gcstate;
 
+    bool timed = g->gcadaptivepause || g->cb.gcstep;
+    double steptimestamp = timed ? lua_clock() : 0.0;
+
     size_t work = gcstep(L, lim);
 
+    g->gcstats.cyclework += work;
+
+    double steptime = timed ? lua_clock() - steptimestamp : 0.0;
+
+    if (g->gcadaptivepause)
+        g->gcstats.cycletime += steptime;
+
 #ifdef LUAI_GCMETRICS
     recordGcStateStep(g, lastgcstate, lua_clock() - lasttimestamp, assist, work);
 #endif
@@ -1044,6 +1657,9 @@ size_t luaC_step(lua_State* L, bool assist)
     // at the end of the last cycle
     if (g->gcstate == GCSpause)
     {
+        if (g->gcadaptivepause)
+            adaptpacing(g);
+
         // at the end of a collection cycle, set goal based on gcgoal setting
         size_t heapgoal = (g->totalbytes / 100) * g->gcgoal;
         size_t heaptrigger = getheaptrigger(g, heapgoal);
@@ -1054,6 +1670,9 @@ size_t luaC_step(lua_State* L, bool assist)
         g->gcstats.endtimestamp = lua_clock();
         g->gcstats.endtotalsizebytes = g->totalbytes;
 
+        g->gcstats.lastcyclework = g->gcstats.cyclework;
+        g->gcstats.cyclework = 0;
+
 #ifdef LUAI_GCMETRICS
         finishGcCycleMetrics(g);
 #endif
@@ -1067,6 +1686,9 @@ size_t luaC_step(lua_State* L, bool assist)
             g->GCthreshold -= debt;
     }
 
+    if (g->cb.gcstep)
+        g->cb.gcstep(L, lastgcstate, steptime, assist);
+
     GC_INTERRUPT(lastgcstate);
 
     return actualstepsize;
@@ -1084,12 +1706,7 @@ void luaC_fullgc(lua_State* L)
     if (keepinvariant(g))
     {
         // reset sweep marks to sweep all elements (returning them to white)
-        g->sweepgcopage = g->allgcopages;
-        // reset other collector lists
-        g->gray = NULL;
-        g->grayagain = NULL;
-        g->weak = NULL;
-        g->gcstate = GCSsweep;
+        resetsweep(g);
     }
     LUAU_ASSERT(g->gcstate == GCSpause || g->gcstate == GCSsweep);
     // finish any pending sweep phase
@@ -1113,10 +1730,15 @@ void luaC_fullgc(lua_State* L)
 
     // run a full collection cycle
     markroot(L);
+    size_t work = 0;
     while (g->gcstate != GCSpause)
     {
-        gcstep(L, SIZE_MAX);
+        work += gcstep(L, SIZE_MAX);
     }
+
+    g->gcstats.lastcyclework = work;
+    g->gcstats.cyclework = 0;
+    g->gcstats.cycletime = 0;
     // reclaim as much buffer memory as possible (shrinkbuffers() called during sweep is incremental)
     shrinkbuffersfull(L);
 
@@ -1140,16 +1762,67 @@ void luaC_fullgc(lua_State* L)
 #endif
 }
 
+size_t luaC_remainingwork(global_State* g)
+{
+    if (g->gcstate == GCSpause)
+        return 0;
+
+    // assume that the current cycle is going to take as much work as the previous one; it's at least one more step otherwise
+    size_t work = g->gcstats.cyclework;
+
+    return g->gcstats.lastcyclework > work ? g->gcstats.lastcyclework - work : 1;
+}
+
+// permanent objects can't be turned gray, so the ones that are modified while the invariant is kept are traversed again by atomic
+// outside of the mark, new references are going to be found by the scan of permanent pages at the start of the next full cycle
+static void barrierpermanent(global_State* g, GCObject* o)
+{
+    if (!keepinvariant(g))
+        return;
+
+    PermanentHeap* ph = g->permheap;
+
+    setpermanentbit(ph->rescan, findpermanent(ph, o));
+    ph->rescanpending = true;
+}
+
 void luaC_barrierf(lua_State* L, GCObject* o, GCObject* v)
 {
     global_State* g = L->global;
     LUAU_ASSERT(isblack(o) && iswhite(v) && !isdead(g, v) && !isdead(g, o));
-    LUAU_ASSERT(g->gcstate != GCSpause);
+
+    // permanent objects never need to be marked
+    if (ispermanent(v))
+        return;
+
+    if (ispermanent(o))
+    {
+        if (keepinvariant(g))
+        {
+            reallymarkobject(g, v);
+            snapshotobj(g, o);
+        }
+        return;
+    }
+
+    LUAU_ASSERT(g->gcstate != GCSpause || g->gcgensticky);
     // must keep invariant?
     if (keepinvariant(g))
+    {
         reallymarkobject(g, v); // restore invariant
-    else                        // don't mind
-        makewhite(g, o);        // mark as white just to avoid other barriers
+        snapshotobj(g, o);      // object has already been reported with the old reference
+    }
+    else                 // don't mind
+        makewhite(g, o); // mark as white just to avoid other barriers
+}
+
+void luaC_barrierref(lua_State* L, GCObject* v)
+{
+    global_State* g = L->global;
+    LUAU_ASSERT(iswhite(v) && !isdead(g, v));
+    // reference slots are roots that are only scanned at the start of the cycle, so values stored later have to be marked right away
+    if (keepinvariant(g))
+        reallymarkobject(g, v);
 }
 
 void luaC_barriertable(lua_State* L, Table* t, GCObject* v)
@@ -1157,17 +1830,32 @@ void luaC_barriertable(lua_State* L, Table* t, GCObject* v)
     global_State* g = L->global;
     GCObject* o = obj2gco(t);
 
+    if (ispermanent(v))
+        return;
+
+    if (ispermanent(o))
+    {
+        barrierpermanent(g, o);
+        return;
+    }
+
     // in the second propagation stage, table assignment barrier works as a forward barrier
     if (g->gcstate == GCSpropagateagain)
     {
         LUAU_ASSERT(isblack(o) && iswhite(v) && !isdead(g, v) && !isdead(g, o));
         reallymarkobject(g, v);
+        snapshotobj(g, o);
         return;
     }
 
     LUAU_ASSERT(isblack(o) && !isdead(g, o));
-    LUAU_ASSERT(g->gcstate != GCSpause);
+    LUAU_ASSERT(g->gcstate != GCSpause || g->gcgensticky);
     black2gray(o); // make table gray (again)
+
+    // weak tables are already linked into the weak list, and the atomic phase traverses gray ones from it
+    if (isweak(o))
+        return;
+
     t->gclist = g->grayagain;
     g->grayagain = o;
 }
@@ -1176,9 +1864,21 @@ void luaC_barrierback(lua_State* L, GCObject* o, GCObject** gclist)
 {
     global_State* g = L->global;
     LUAU_ASSERT(isblack(o) && !isdead(g, o));
-    LUAU_ASSERT(g->gcstate != GCSpause);
+
+    if (ispermanent(o))
+    {
+        barrierpermanent(g, o);
+        return;
+    }
+
+    LUAU_ASSERT(g->gcstate != GCSpause || g->gcgensticky);
 
     black2gray(o); // make object gray (again)
+
+    // weak tables are already linked into the weak list, and the atomic phase traverses gray ones from it
+    if (isweak(o))
+        return;
+
     *gclist = g->grayagain;
     g->grayagain = o;
 }
@@ -1205,6 +1905,175 @@ void luaC_upvalclosed(lua_State* L, UpVal* uv)
     }
 }
 
+void luaC_setgenerational(lua_State* L, bool enabled)
+{
+    global_State* g = L->global;
+
+    g->gcgen = enabled;
+
+    // when leaving generational mode, old objects need to be made white again so that the next cycle can traverse them
+    // this is done by restarting the sweep, which isn't going to free anything that is still alive
+    if (!enabled && g->gcgensticky && (g->gcstate == GCSpause || g->gcstate == GCSsweep))
+        resetsweep(g);
+}
+
+// threads and open upvalues are modified by the collector itself, so pages that contain them stay in the regular heap
+static bool checkfreezegco(void* context, lua_Page* page, GCObject* gco)
+{
+    if (gco->gch.tt == LUA_TTHREAD || (gco->gch.tt == LUA_TUPVAL && upisopen(gco2uv(gco))))
+        *(bool*)context = false;
+
+    return false;
+}
+
+static bool canfreezepage(lua_Page* page)
+{
+    bool result = true;
+    luaM_visitpage(page, &result, checkfreezegco);
+    return result;
+}
+
+static bool freezegco(void* context, lua_Page* page, GCObject* gco)
+{
+    gco->gch.marked = cast_byte((gco->gch.marked & maskmarks) | PERMANENTMARKS);
+    return false;
+}
+
+// every page starts at a new bitmap word, which lets atomic visit the bits of each page separately
+static int getpermanentbits(lua_Page* page)
+{
+    char* start;
+    char* end;
+    int busyBlocks;
+    int blockSize;
+    luaM_getpagewalkinfo(page, &start, &end, &busyBlocks, &blockSize);
+
+    return (int(end - start) / blockSize + 31) & ~31;
+}
+
+static int comparepermanentpages(const void* lhs, const void* rhs)
+{
+    char* l = ((const PermanentPage*)lhs)->start;
+    char* r = ((const PermanentPage*)rhs)->start;
+
+    return l < r ? -1 : l > r ? 1 : 0;
+}
+
+size_t luaC_freeze(lua_State* L)
+{
+    global_State* g = L->global;
+
+    // only the objects that survive a full collection become permanent
+    luaC_fullgc(L);
+
+    int pagecount = 0;
+    int bits = 0;
+
+    for (lua_Page* page = g->permgcopages; page; page = luaM_getnextgcopage(page))
+    {
+        pagecount++;
+        bits += getpermanentbits(page);
+    }
+
+    for (lua_Page* page = g->allgcopages; page; page = luaM_getnextgcopage(page))
+    {
+        if (canfreezepage(page))
+        {
+            pagecount++;
+            bits += getpermanentbits(page);
+        }
+    }
+
+    if (!g->permheap)
+    {
+        PermanentHeap* ph = luaM_newarray(L, 1, PermanentHeap, 0);
+        memset(ph, 0, sizeof(PermanentHeap));
+        g->permheap = ph;
+    }
+
+    // the index is allocated before any page is frozen so that an allocation failure leaves the heap unchanged
+    PermanentPage* pages = luaM_newarray(L, pagecount, PermanentPage, 0);
+    uint32_t* rescan = luaM_newarray(L, bits / 32, uint32_t, 0);
+    uint32_t* weak = luaM_newarray(L, bits / 32, uint32_t, 0);
+
+    for (lua_Page* page = g->allgcopages; page;)
+    {
+        lua_Page* next = luaM_getnextgcopage(page);
+
+        if (canfreezepage(page))
+        {
+            luaM_visitpage(page, NULL, freezegco);
+            luaM_freezegcopage(L, page);
+        }
+
+        page = next;
+    }
+
+    PermanentHeap* ph = g->permheap;
+    freepermanentheap(L, ph);
+
+    ph->pages = pages;
+    ph->pagecount = pagecount;
+    ph->rescan = rescan;
+    ph->weak = weak;
+    ph->words = bits / 32;
+    ph->bytes = 0;
+
+    int index = 0;
+
+    for (lua_Page* page = g->permgcopages; page; page = luaM_getnextgcopage(page))
+    {
+        char* start;
+        char* end;
+        int busyBlocks;
+        int blockSize;
+        luaM_getpagewalkinfo(page, &start, &end, &busyBlocks, &blockSize);
+
+        PermanentPage& pp = pages[index++];
+        pp.start = start;
+        pp.end = end;
+        pp.blockSize = blockSize;
+
+        ph->bytes += end - start;
+    }
+
+    LUAU_ASSERT(index == pagecount);
+
+    qsort(pages, pagecount, sizeof(PermanentPage), comparepermanentpages);
+
+    bits = 0;
+
+    for (int i = 0; i < pagecount; i++)
+    {
+        pages[i].bitbase = bits;
+        bits += (int(pages[i].end - pages[i].start) / pages[i].blockSize + 31) & ~31;
+    }
+
+    memset(rescan, 0, ph->words * sizeof(uint32_t));
+    memset(weak, 0, ph->words * sizeof(uint32_t));
+
+    ph->scanpage = pagecount;
+    ph->rescanpending = false;
+
+    return ph->bytes;
+}
+
+void luaC_startheapsnapshot(lua_State* L, void* context,
+    void (*node)(void* context, void* ptr, uint8_t tt, uint8_t memcat, size_t size, const char* name),
+    void (*edge)(void* context, void* from, void* to, const char* name), void (*done)(void* context))
+{
+    global_State* g = L->global;
+
+    // only one snapshot can be in progress
+    LUAU_ASSERT(!g->gcsnapshot.pending && !g->gcsnapshot.active);
+
+    g->gcsnapshot.context = context;
+    g->gcsnapshot.node = node;
+    g->gcsnapshot.edge = edge;
+    g->gcsnapshot.done = done;
+    g->gcsnapshot.pending = true;
+}
+
 // measure the allocation rate in bytes/sec
 // returns -1 if allocation rate cannot be measured
 int64_t luaC_allocationrate(lua_State* L)
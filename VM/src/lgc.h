@@ -13,6 +13,12 @@
 #define LUAI_GCSTEPMUL 200 // GC runs 'twice the speed' of memory allocation
 #define LUAI_GCSTEPSIZE 1  // GC runs every KB of memory allocation
 
+#define LUAI_GCGENMAJORMUL 100 // in generational mode, run a major collection when heap grows 100% since the last one
+
+#define LUAI_GCADAPTIVEFRACTION 10    // adaptive pacing raises the goal to keep the collector at ~10% of execution time
+#define LUAI_GCADAPTIVEMAXGOAL 1000   // adaptive pacing never lets the heap grow more than 10x compared to live heap size
+#define LUAI_GCADAPTIVEMAXSTEPSIZE 1024 // adaptive pacing runs GC at least every MB of memory allocation
+
 /*
 ** Possible states of the Garbage Collector
 */
@@ -28,8 +34,10 @@
 ** phase may break the invariant, as objects turned white may point to
 ** still-black objects. The invariant is restored when sweep ends and
 ** all objects are white again.
+** In generational mode, sweep may keep the marks instead (see gcgensticky) in which case the invariant is kept at all times.
 */
-#define keepinvariant(g) ((g)->gcstate == GCSpropagate || (g)->gcstate == GCSpropagateagain || (g)->gcstate == GCSatomic)
+#define keepinvariant(g) \
+    ((g)->gcstate == GCSpropagate || (g)->gcstate == GCSpropagateagain || (g)->gcstate == GCSatomic || (g)->gcgensticky)
 
 /*
 ** some useful bit tricks
@@ -52,18 +60,35 @@
 ** bit 1 - object is white (type 1)
 ** bit 2 - object is black
 ** bit 3 - object is fixed (should not be collected)
+** bit 4 - object is old (survived a sweep that kept the marks in generational mode)
+** bit 5 - object belongs to a shared heap (see lua_newsharedheap) and is never modified
+** bit 6 - table is linked into the list of weak tables of the current cycle
+** bit 7 - table has inline storage for its hash part after the header (see luaH_new)
+**
+** Permanent objects (see LUA_GCFREEZE) have both white bits and the black bit set, which no other object has; this makes them
+** look white to marking and black to write barriers, so that both take the slow path that handles them without writing the header.
 */
 
 #define WHITE0BIT 0
 #define WHITE1BIT 1
 #define BLACKBIT 2
 #define FIXEDBIT 3
+#define OLDBIT 4
+#define SHAREDBIT 5
+#define WEAKBIT 6
+#define INLINEBIT 7
 #define WHITEBITS bit2mask(WHITE0BIT, WHITE1BIT)
 
 #define iswhite(x) test2bits((x)->gch.marked, WHITE0BIT, WHITE1BIT)
 #define isblack(x) testbit((x)->gch.marked, BLACKBIT)
 #define isgray(x) (!testbits((x)->gch.marked, WHITEBITS | bitmask(BLACKBIT)))
 #define isfixed(x) testbit((x)->gch.marked, FIXEDBIT)
+#define isold(x) testbit((x)->gch.marked, OLDBIT)
+#define isshared(x) testbit((x)->gch.marked, SHAREDBIT)
+#define isweak(x) testbit((x)->gch.marked, WEAKBIT)
+
+#define PERMANENTMARKS (WHITEBITS | bitmask(BLACKBIT))
+#define ispermanent(x) (((x)->gch.marked & PERMANENTMARKS) == PERMANENTMARKS)
 
 #define otherwhite(g) (g->currentwhite ^ WHITEBITS)
 #define isdead(g, v) (((v)->gch.marked & (WHITEBITS | bitmask(FIXEDBIT))) == (otherwhite(g) & WHITEBITS))
@@ -113,6 +138,12 @@
             luaC_barrierf(L, obj2gco(p), obj2gco(o)); \
     }
 
+#define luaC_refbarrier(L, v) \
+    { \
+        if (iscollectable(v) && iswhite(gcvalue(v))) \
+            luaC_barrierref(L, gcvalue(v)); \
+    }
+
 #define luaC_threadbarrier(L) \
     { \
         if (isblack(obj2gco(L))) \
@@ -129,15 +160,24 @@
 LUAI_FUNC void luaC_freeall(lua_State* L);
 LUAI_FUNC size_t luaC_step(lua_State* L, bool assist);
 LUAI_FUNC void luaC_fullgc(lua_State* L);
+LUAI_FUNC size_t luaC_remainingwork(global_State* g);
+LUAI_FUNC void luaC_setgenerational(lua_State* L, bool enabled);
+LUAI_FUNC size_t luaC_freeze(lua_State* L);
 LUAI_FUNC void luaC_initobj(lua_State* L, GCObject* o, uint8_t tt);
 LUAI_FUNC void luaC_upvalclosed(lua_State* L, UpVal* uv);
 LUAI_FUNC void luaC_barrierf(lua_State* L, GCObject* o, GCObject* v);
 LUAI_FUNC void luaC_barriertable(lua_State* L, Table* t, GCObject* v);
 LUAI_FUNC void luaC_barrierback(lua_State* L, GCObject* o, GCObject** gclist);
+LUAI_FUNC void luaC_barrierref(lua_State* L, GCObject* v);
 LUAI_FUNC void luaC_validate(lua_State* L);
 LUAI_FUNC void luaC_dump(lua_State* L, void* file, const char* (*categoryName)(lua_State* L, uint8_t memcat));
+LUAI_FUNC void luaC_dumpbinary(lua_State* L, void* file, const char* (*categoryName)(lua_State* L, uint8_t memcat));
 LUAI_FUNC void luaC_enumheap(lua_State* L, void* context,
     void (*node)(void* context, void* ptr, uint8_t tt, uint8_t memcat, size_t size, const char* name),
     void (*edge)(void* context, void* from, void* to, const char* name));
+LUAI_FUNC void luaC_startheapsnapshot(lua_State* L, void* context,
+    void (*node)(void* context, void* ptr, uint8_t tt, uint8_t memcat, size_t size, const char* name),
+    void (*edge)(void* context, void* from, void* to, const char* name), void (*done)(void* context));
+LUAI_FUNC void luaC_snapshotobj(global_State* g, GCObject* o);
 LUAI_FUNC int64_t luaC_allocationrate(lua_State* L);
 LUAI_FUNC const char* luaC_statename(int state);
@@ -20,8 +20,8 @@ static void validateobjref(global_State* g, GCObject* f, GCObject* t)
 
     if (keepinvariant(g))
     {
-        // basic incremental invariant: black can't point to white
-        LUAU_ASSERT(!(isblack(f) && iswhite(t)));
+        // basic incremental invariant: black can't point to white; permanent objects look both black and white, see LUA_GCFREEZE
+        LUAU_ASSERT(!(isblack(f) && iswhite(t)) || ispermanent(f) || ispermanent(t));
     }
 }
 
@@ -43,8 +43,16 @@ static void validatetable(global_State* g, Table* h)
     if (h->metatable)
         validateobjref(g, obj2gco(h), obj2gco(h->metatable));
 
+    // weak tables in the weak list are black but can point to white objects until they are cleared
+    bool weak = isweak(obj2gco(h));
+
     for (int i = 0; i < h->sizearray; ++i)
-        validateref(g, obj2gco(h), &h->array[i]);
+    {
+        if (weak)
+            checkliveness(g, &h->array[i]);
+        else
+            validateref(g, obj2gco(h), &h->array[i]);
+    }
 
     for (int i = 0; i < sizenode; ++i)
     {
@@ -59,8 +67,16 @@ static void validatetable(global_State* g, Table* h)
             k.tt = gkey(n)->tt;
             k.value = gkey(n)->value;
 
-            validateref(g, obj2gco(h), &k);
-            validateref(g, obj2gco(h), gval(n));
+            if (weak)
+            {
+                checkliveness(g, &k);
+                checkliveness(g, gval(n));
+            }
+            else
+            {
+                validateref(g, obj2gco(h), &k);
+                validateref(g, obj2gco(h), gval(n));
+            }
         }
     }
 }
@@ -120,6 +136,12 @@ static void validateproto(global_State* g, Proto* f)
     if (f->debugname)
         validateobjref(g, obj2gco(f), obj2gco(f->debugname));
 
+    if (f->lazychunk)
+        validateobjref(g, obj2gco(f), obj2gco(f->lazychunk));
+
+    if (f->debugchunk)
+        validateobjref(g, obj2gco(f), obj2gco(f->debugchunk));
+
     for (int i = 0; i < f->sizek; ++i)
         validateref(g, obj2gco(f), &f->k[i]);
 
@@ -222,6 +244,27 @@ static bool validategco(void* context, lua_Page* page, GCObject* gco)
     return false;
 }
 
+// the block map of a page must track exactly the blocks that hold objects
+static void validateblockmap(lua_Page* page)
+{
+    const uint32_t* map = luaM_getpageblockmap(page);
+    if (!map)
+        return;
+
+    char* start;
+    char* end;
+    int busyBlocks;
+    int blockSize;
+    luaM_getpagewalkinfo(page, &start, &end, &busyBlocks, &blockSize);
+
+    for (char* pos = start; pos != end; pos += blockSize)
+    {
+        GCObject* gco = (GCObject*)pos;
+
+        LUAU_ASSERT(!luaM_isblockused(map, page, pos) == (gco->gch.tt == LUA_TNIL));
+    }
+}
+
 void luaC_validate(lua_State* L)
 {
     global_State* g = L->global;
@@ -229,11 +272,19 @@ void luaC_validate(lua_State* L)
     LUAU_ASSERT(!isdead(g, obj2gco(g->mainthread)));
     checkliveness(g, &g->registry);
 
+    for (int i = 1; i < g->refsused; i++)
+        checkliveness(g, &g->refs[i]);
+
     for (int i = 0; i < LUA_T_COUNT; ++i)
         if (g->mt[i])
             LUAU_ASSERT(!isdead(g, obj2gco(g->mt[i])));
 
-    validategraylist(g, g->weak);
+    for (GCObject* o = g->weak; o; o = gco2h(o)->gclist)
+    {
+        LUAU_ASSERT(o->gch.tt == LUA_TTABLE);
+        LUAU_ASSERT(isweak(o));
+    }
+
     validategraylist(g, g->gray);
     validategraylist(g, g->grayagain);
 
@@ -241,6 +292,9 @@ void luaC_validate(lua_State* L)
 
     luaM_visitgco(L, L, validategco);
 
+    for (lua_Page* page = g->allgcopages; page; page = luaM_getnextgcopage(page))
+        validateblockmap(page);
+
     for (UpVal* uv = g->uvhead.u.open.next; uv != &g->uvhead; uv = uv->u.open.next)
     {
         LUAU_ASSERT(uv->tt == LUA_TUPVAL);
@@ -292,7 +346,7 @@ static void dumpstring(FILE* f, TString* ts)
 
 static void dumptable(FILE* f, Table* h)
 {
-    size_t size = sizeof(Table) + (h->node == &luaH_dummynode ? 0 : sizenode(h) * sizeof(LuaNode)) + h->sizearray * sizeof(TValue);
+    size_t size = luaH_memsize(h);
 
     fprintf(f, "{\"type\":\"table\",\"cat\":%d,\"size\":%d", h->memcat, int(size));
 
@@ -479,7 +533,7 @@ static void dumpthread(FILE* f, lua_State* th)
 
 static void dumpbuffer(FILE* f, Buffer* b)
 {
-    fprintf(f, "{\"type\":\"buffer\",\"cat\":%d,\"size\":%d}", b->memcat, int(sizebuffer(b->len)));
+    fprintf(f, "{\"type\":\"buffer\",\"cat\":%d,\"size\":%d}", b->memcat, int(sizebufferobj(b)));
 }
 
 static void dumpproto(FILE* f, Proto* p)
@@ -595,6 +649,15 @@ void luaC_dump(lua_State* L, void* file, const char* (*categoryName)(lua_State*
     fprintf(f, ",\"registry\":");
     dumpref(f, gcvalue(&g->registry));
 
+    for (int i = 1; i < g->refsused; i++)
+    {
+        if (iscollectable(&g->refs[i]))
+        {
+            fprintf(f, ",\"ref%d\":", i);
+            dumpref(f, gcvalue(&g->refs[i]));
+        }
+    }
+
     fprintf(f, "},\"stats\":{\n");
 
     fprintf(f, "\"size\":%d,\n", int(g->totalbytes));
@@ -615,6 +678,501 @@ void luaC_dump(lua_State* L, void* file, const char* (*categoryName)(lua_State*
     fprintf(f, "}}\n");
 }
 
+/*
+ * Binary heap snapshot (luaC_dumpbinary) contains the same information as luaC_dump in a compact form that's cheap to write and parse.
+ *
+ * The file starts with "LUAUHEAP" magic followed by a version byte, and is followed by a sequence of records that each start with a tag:
+ * - 'O': object; address (u64), type (HeapType), memory category (u8), size (varint), followed by fields (HeapField, value) terminated by 0
+ * - 'R': root; name (string), address (u64)
+ * - 'C': memory category; category (u8), size (varint), name (string, empty if unnamed)
+ * - 'T': total heap size (varint)
+ * - 'E': end of snapshot
+ *
+ * Integers are encoded as LEB128, strings are encoded as length (varint) followed by bytes, and reference lists are encoded as count (varint)
+ * followed by addresses (u64); null references have address 0. tools/heapsnapshot.py can load both snapshot formats.
+ */
+enum HeapType
+{
+    HeapType_String,
+    HeapType_Table,
+    HeapType_Function,
+    HeapType_Userdata,
+    HeapType_Thread,
+    HeapType_Buffer,
+    HeapType_Proto,
+    HeapType_Upvalue,
+};
+
+enum HeapField
+{
+    HeapField_End,
+    HeapField_Data,       // string
+    HeapField_Pairs,      // references, key/value pairs
+    HeapField_Array,      // references
+    HeapField_Metatable,  // reference
+    HeapField_Env,        // reference
+    HeapField_Name,       // string
+    HeapField_Upvalues,   // references
+    HeapField_Proto,      // reference
+    HeapField_Tag,        // varint
+    HeapField_Source,     // string
+    HeapField_Line,       // varint
+    HeapField_Stack,      // references
+    HeapField_StackNames, // count (varint) followed by optional strings; each string is prefixed with a byte that is 0 for missing names
+    HeapField_Constants,  // references
+    HeapField_Protos,     // references
+    HeapField_Open,       // u8
+    HeapField_Object,     // reference
+};
+
+struct BinaryDumpWriter
+{
+    FILE* f;
+    size_t pos = 0;
+    uint8_t buffer[8192];
+
+    void flush()
+    {
+        fwrite(buffer, 1, pos, f);
+        pos = 0;
+    }
+
+    void reserve(size_t size)
+    {
+        if (pos + size > sizeof(buffer))
+            flush();
+    }
+
+    void writeByte(uint8_t value)
+    {
+        reserve(1);
+        buffer[pos++] = value;
+    }
+
+    void writeVarInt(uint64_t value)
+    {
+        reserve(10);
+
+        do
+        {
+            buffer[pos++] = uint8_t((value & 127) | ((value > 127) << 7));
+            value >>= 7;
+        } while (value);
+    }
+
+    void writeRef(const void* ptr)
+    {
+        uint64_t value = uint64_t(uintptr_t(ptr));
+
+        reserve(8);
+
+        for (int i = 0; i < 8; ++i)
+            buffer[pos++] = uint8_t(value >> (i * 8));
+    }
+
+    void writeString(const char* data, size_t len)
+    {
+        writeVarInt(len);
+
+        if (len > sizeof(buffer))
+        {
+            flush();
+            fwrite(data, 1, len, f);
+        }
+        else
+        {
+            reserve(len);
+            memcpy(buffer + pos, data, len);
+            pos += len;
+        }
+    }
+
+    void writeString(const char* str)
+    {
+        writeString(str, strlen(str));
+    }
+};
+
+static void bindumprefs(BinaryDumpWriter& w, TValue* data, size_t size)
+{
+    size_t count = 0;
+
+    for (size_t i = 0; i < size; ++i)
+        if (iscollectable(&data[i]))
+            count++;
+
+    w.writeVarInt(count);
+
+    for (size_t i = 0; i < size; ++i)
+        if (iscollectable(&data[i]))
+            w.writeRef(gcvalue(&data[i]));
+}
+
+static void bindumpheader(BinaryDumpWriter& w, GCObject* o, HeapType type, uint8_t memcat, size_t size)
+{
+    w.writeByte('O');
+    w.writeRef(o);
+    w.writeByte(uint8_t(type));
+    w.writeByte(memcat);
+    w.writeVarInt(size);
+}
+
+static void bindumpstring(BinaryDumpWriter& w, TString* ts)
+{
+    bindumpheader(w, obj2gco(ts), HeapType_String, ts->memcat, sizestring(ts->len));
+
+    w.writeByte(HeapField_Data);
+    w.writeString(ts->data, ts->len);
+}
+
+static void bindumptable(BinaryDumpWriter& w, Table* h)
+{
+    size_t size = luaH_memsize(h);
+
+    bindumpheader(w, obj2gco(h), HeapType_Table, h->memcat, size);
+
+    if (h->node != &luaH_dummynode)
+    {
+        size_t count = 0;
+
+        for (int i = 0; i < sizenode(h); ++i)
+        {
+            const LuaNode& n = h->node[i];
+
+            if (!ttisnil(&n.val) && (iscollectable(&n.key) || iscollectable(&n.val)))
+                count++;
+        }
+
+        w.writeByte(HeapField_Pairs);
+        w.writeVarInt(count * 2);
+
+        for (int i = 0; i < sizenode(h); ++i)
+        {
+            const LuaNode& n = h->node[i];
+
+            if (!ttisnil(&n.val) && (iscollectable(&n.key) || iscollectable(&n.val)))
+            {
+                w.writeRef(iscollectable(&n.key) ? gcvalue(&n.key) : NULL);
+                w.writeRef(iscollectable(&n.val) ? gcvalue(&n.val) : NULL);
+            }
+        }
+    }
+    if (h->sizearray)
+    {
+        w.writeByte(HeapField_Array);
+        bindumprefs(w, h->array, h->sizearray);
+    }
+    if (h->metatable)
+    {
+        w.writeByte(HeapField_Metatable);
+        w.writeRef(h->metatable);
+    }
+}
+
+static void bindumpclosure(BinaryDumpWriter& w, Closure* cl)
+{
+    bindumpheader(w, obj2gco(cl), HeapType_Function, cl->memcat, cl->isC ? sizeCclosure(cl->nupvalues) : sizeLclosure(cl->nupvalues));
+
+    w.writeByte(HeapField_Env);
+    w.writeRef(cl->env);
+
+    if (cl->isC)
+    {
+        if (cl->c.debugname)
+        {
+            w.writeByte(HeapField_Name);
+            w.writeString(cl->c.debugname);
+        }
+
+        if (cl->nupvalues)
+        {
+            w.writeByte(HeapField_Upvalues);
+            bindumprefs(w, cl->c.upvals, cl->nupvalues);
+        }
+    }
+    else
+    {
+        if (cl->l.p->debugname)
+        {
+            w.writeByte(HeapField_Name);
+            w.writeString(getstr(cl->l.p->debugname), cl->l.p->debugname->len);
+        }
+
+        w.writeByte(HeapField_Proto);
+        w.writeRef(cl->l.p);
+
+        if (cl->nupvalues)
+        {
+            w.writeByte(HeapField_Upvalues);
+            bindumprefs(w, cl->l.uprefs, cl->nupvalues);
+        }
+    }
+}
+
+static void bindumpudata(BinaryDumpWriter& w, Udata* u)
+{
+    bindumpheader(w, obj2gco(u), HeapType_Userdata, u->memcat, sizeudata(u->len));
+
+    w.writeByte(HeapField_Tag);
+    w.writeVarInt(u->tag);
+
+    if (u->metatable)
+    {
+        w.writeByte(HeapField_Metatable);
+        w.writeRef(u->metatable);
+    }
+}
+
+static void bindumpthread(BinaryDumpWriter& w, lua_State* th)
+{
+    size_t size = sizeof(lua_State) + sizeof(TValue) * th->stacksize + sizeof(CallInfo) * th->size_ci;
+
+    bindumpheader(w, obj2gco(th), HeapType_Thread, th->memcat, size);
+
+    w.writeByte(HeapField_Env);
+    w.writeRef(th->gt);
+
+    Closure* tcl = 0;
+    for (CallInfo* ci = th->base_ci; ci <= th->ci; ++ci)
+    {
+        if (ttisfunction(ci->func))
+        {
+            tcl = clvalue(ci->func);
+            break;
+        }
+    }
+
+    if (tcl && !tcl->isC && tcl->l.p->source)
+    {
+        Proto* p = tcl->l.p;
+
+        w.writeByte(HeapField_Source);
+        w.writeString(p->source->data, p->source->len);
+        w.writeByte(HeapField_Line);
+        w.writeVarInt(p->linedefined);
+    }
+
+    if (th->top > th->stack)
+    {
+        w.writeByte(HeapField_Stack);
+        bindumprefs(w, th->stack, th->top - th->stack);
+
+        size_t count = 0;
+
+        for (StkId v = th->stack; v < th->top; ++v)
+            if (iscollectable(v))
+                count++;
+
+        w.writeByte(HeapField_StackNames);
+        w.writeVarInt(count);
+
+        CallInfo* ci = th->base_ci;
+        char frame[256];
+
+        for (StkId v = th->stack; v < th->top; ++v)
+        {
+            if (!iscollectable(v))
+                continue;
+
+            while (ci < th->ci && v >= (ci + 1)->func)
+                ci++;
+
+            if (v == ci->func)
+            {
+                Closure* cl = ci_func(ci);
+
+                if (cl->isC)
+                {
+                    snprintf(frame, sizeof(frame), "frame:%s", cl->c.debugname ? cl->c.debugname : "[C]");
+                }
+                else
+                {
+                    Proto* p = cl->l.p;
+                    snprintf(frame, sizeof(frame), "frame:%.*s:%d:%s", p->source ? int(p->source->len) : 0, p->source ? p->source->data : "",
+                        p->linedefined, p->debugname ? getstr(p->debugname) : "");
+                }
+
+                w.writeByte(1);
+                w.writeString(frame);
+            }
+            else if (isLua(ci))
+            {
+                Proto* p = ci_func(ci)->l.p;
+                int pc = pcRel(ci->savedpc, p);
+                const LocVar* var = luaF_findlocal(p, int(v - ci->base), pc);
+
+                if (var && var->varname)
+                {
+                    w.writeByte(1);
+                    w.writeString(getstr(var->varname), var->varname->len);
+                }
+                else
+                    w.writeByte(0);
+            }
+            else
+                w.writeByte(0);
+        }
+    }
+}
+
+static void bindumpbuffer(BinaryDumpWriter& w, Buffer* b)
+{
+    bindumpheader(w, obj2gco(b), HeapType_Buffer, b->memcat, sizebufferobj(b));
+}
+
+static void bindumpproto(BinaryDumpWriter& w, Proto* p)
+{
+    size_t size = sizeof(Proto) + sizeof(Instruction) * p->sizecode + sizeof(Proto*) * p->sizep + sizeof(TValue) * p->sizek + p->sizelineinfo +
+                  sizeof(LocVar) * p->sizelocvars + sizeof(TString*) * p->sizeupvalues;
+
+    bindumpheader(w, obj2gco(p), HeapType_Proto, p->memcat, size);
+
+    if (p->source)
+    {
+        w.writeByte(HeapField_Source);
+        w.writeString(p->source->data, p->source->len);
+        w.writeByte(HeapField_Line);
+        w.writeVarInt(p->abslineinfo ? p->abslineinfo[0] : 0);
+    }
+
+    if (p->sizek)
+    {
+        w.writeByte(HeapField_Constants);
+        bindumprefs(w, p->k, p->sizek);
+    }
+
+    if (p->sizep)
+    {
+        w.writeByte(HeapField_Protos);
+        w.writeVarInt(p->sizep);
+
+        for (int i = 0; i < p->sizep; ++i)
+            w.writeRef(p->p[i]);
+    }
+}
+
+static void bindumpupval(BinaryDumpWriter& w, UpVal* uv)
+{
+    bindumpheader(w, obj2gco(uv), HeapType_Upvalue, uv->memcat, sizeof(UpVal));
+
+    w.writeByte(HeapField_Open);
+    w.writeByte(upisopen(uv));
+
+    if (iscollectable(uv->v))
+    {
+        w.writeByte(HeapField_Object);
+        w.writeRef(gcvalue(uv->v));
+    }
+}
+
+static void bindumpobj(BinaryDumpWriter& w, GCObject* o)
+{
+    switch (o->gch.tt)
+    {
+    case LUA_TSTRING:
+        bindumpstring(w, gco2ts(o));
+        break;
+
+    case LUA_TTABLE:
+        bindumptable(w, gco2h(o));
+        break;
+
+    case LUA_TFUNCTION:
+        bindumpclosure(w, gco2cl(o));
+        break;
+
+    case LUA_TUSERDATA:
+        bindumpudata(w, gco2u(o));
+        break;
+
+    case LUA_TTHREAD:
+        bindumpthread(w, gco2th(o));
+        break;
+
+    case LUA_TBUFFER:
+        bindumpbuffer(w, gco2buf(o));
+        break;
+
+    case LUA_TPROTO:
+        bindumpproto(w, gco2p(o));
+        break;
+
+    case LUA_TUPVAL:
+        bindumpupval(w, gco2uv(o));
+        break;
+
+    default:
+        LUAU_ASSERT(0);
+    }
+
+    w.writeByte(HeapField_End);
+}
+
+static bool bindumpgco(void* context, lua_Page* page, GCObject* gco)
+{
+    BinaryDumpWriter* w = (BinaryDumpWriter*)context;
+
+    bindumpobj(*w, gco);
+
+    return false;
+}
+
+void luaC_dumpbinary(lua_State* L, void* file, const char* (*categoryName)(lua_State* L, uint8_t memcat))
+{
+    global_State* g = L->global;
+
+    BinaryDumpWriter w;
+    w.f = static_cast<FILE*>(file);
+
+    const char magic[] = "LUAUHEAP";
+    for (size_t i = 0; i < sizeof(magic) - 1; ++i)
+        w.writeByte(magic[i]);
+
+    w.writeByte(1); // version
+
+    bindumpobj(w, obj2gco(g->mainthread));
+
+    luaM_visitgco(L, &w, bindumpgco);
+
+    w.writeByte('R');
+    w.writeString("mainthread");
+    w.writeRef(g->mainthread);
+
+    w.writeByte('R');
+    w.writeString("registry");
+    w.writeRef(gcvalue(&g->registry));
+
+    for (int i = 1; i < g->refsused; i++)
+    {
+        if (iscollectable(&g->refs[i]))
+        {
+            char name[32];
+            snprintf(name, sizeof(name), "ref%d", i);
+
+            w.writeByte('R');
+            w.writeString(name);
+            w.writeRef(gcvalue(&g->refs[i]));
+        }
+    }
+
+    w.writeByte('T');
+    w.writeVarInt(g->totalbytes);
+
+    for (int i = 0; i < LUA_MEMORY_CATEGORIES; i++)
+    {
+        if (size_t bytes = g->memcatbytes[i])
+        {
+            w.writeByte('C');
+            w.writeByte(uint8_t(i));
+            w.writeVarInt(bytes);
+            w.writeString(categoryName ? categoryName(L, uint8_t(i)) : "");
+        }
+    }
+
+    w.writeByte('E');
+    w.flush();
+}
+
 struct EnumContext
 {
     lua_State* L;
@@ -655,7 +1213,7 @@ static void enumstring(EnumContext* ctx, TString* ts)
 
 static void enumtable(EnumContext* ctx, Table* h)
 {
-    size_t size = sizeof(Table) + (h->node == &luaH_dummynode ? 0 : sizenode(h) * sizeof(LuaNode)) + h->sizearray * sizeof(TValue);
+    size_t size = luaH_memsize(h);
 
     // Provide a name for a special registry table
     enumnode(ctx, obj2gco(h), size, h == hvalue(registry(ctx->L)) ? "registry" : NULL);
@@ -812,11 +1370,16 @@ static void enumthread(EnumContext* ctx, lua_State* th)
 
     if (th->top > th->stack)
         enumedges(ctx, obj2gco(th), th->stack, th->top - th->stack, "stack");
+
+    // values pinned by lua_ref aren't owned by any object, so they are reported as referenced by the main thread
+    global_State* g = ctx->L->global;
+    if (th == g->mainthread && g->refsused > 1)
+        enumedges(ctx, obj2gco(th), g->refs + 1, g->refsused - 1, "ref");
 }
 
 static void enumbuffer(EnumContext* ctx, Buffer* b)
 {
-    enumnode(ctx, obj2gco(b), sizebuffer(b->len), NULL);
+    enumnode(ctx, obj2gco(b), sizebufferobj(b), NULL);
 }
 
 static void enumproto(EnumContext* ctx, Proto* p)
@@ -831,6 +1394,12 @@ static void enumproto(EnumContext* ctx, Proto* p)
 
     for (int i = 0; i < p->sizep; ++i)
         enumedge(ctx, obj2gco(p), obj2gco(p->p[i]), "protos");
+
+    if (p->lazychunk)
+        enumedge(ctx, obj2gco(p), obj2gco(p->lazychunk), "lazychunk");
+
+    if (p->debugchunk)
+        enumedge(ctx, obj2gco(p), obj2gco(p->debugchunk), "debugchunk");
 }
 
 static void enumupval(EnumContext* ctx, UpVal* uv)
@@ -895,3 +1464,14 @@ void luaC_enumheap(lua_State* L, void* context, void (*node)(void* context, void
 
     luaM_visitgco(L, &ctx, enumgco);
 }
+
+void luaC_snapshotobj(global_State* g, GCObject* o)
+{
+    EnumContext ctx;
+    ctx.L = g->mainthread;
+    ctx.context = g->gcsnapshot.context;
+    ctx.node = g->gcsnapshot.node;
+    ctx.edge = g->gcsnapshot.edge;
+
+    enumobj(&ctx, o);
+}
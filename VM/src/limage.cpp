@@ -0,0 +1,1036 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#include "lua.h"
+
+#include "lapi.h"
+#include "lbuffer.h"
+#include "ldebug.h"
+#include "ldo.h"
+#include "lfunc.h"
+#include "lgc.h"
+#include "lmem.h"
+#include "lnumutils.h"
+#include "lstate.h"
+#include "lstring.h"
+#include "ltable.h"
+#include "lvm.h"
+
+#include "Luau/Bytecode.h"
+
+#include <limits.h>
+#include <string.h>
+
+/*
+** Heap images store a graph of objects without pointers, so that it can be loaded into any state created by the same build:
+**   header, object count, one creation record per object, one fill record per object, root value
+** Creation records only hold data that doesn't reference other objects, so every object exists before references to it are filled in.
+** Closures are numbered after all other objects since creating one requires its proto and environment to exist.
+** Objects that have a name in the names table are stored by name and are looked up in the loading state instead of being copied.
+*/
+
+#define IMAGE_MAGIC "LIMG"
+#define IMAGE_VERSION 1
+
+enum ImageKind
+{
+    IMAGE_NAME,
+    IMAGE_STRING,
+    IMAGE_BUFFER,
+    IMAGE_TABLE,
+    IMAGE_UPVAL,
+    IMAGE_PROTO,
+    IMAGE_CLOSURE,
+};
+
+struct ImageWriter
+{
+    lua_State* L;
+    Table* names; // object -> name
+
+    // object address -> object number; closures have negative numbers since they are numbered after all other objects
+    Table* index;
+    Table* objects; // discovered objects, except for closures; named objects use tag 1
+    Table* closures;
+    int objectcount;
+    int closurecount;
+
+    StkId out; // stack slot that holds the output buffer
+    size_t size;
+};
+
+static const TString* imagename(ImageWriter& w, GCObject* o)
+{
+    if (!w.names || o->gch.tt == LUA_TPROTO || o->gch.tt == LUA_TUPVAL)
+        return NULL;
+
+    TValue key;
+    key.value.gc = o;
+    key.tt = o->gch.tt;
+
+    const TValue* name = luaH_get(w.names, &key);
+    return ttisstring(name) ? tsvalue(name) : NULL;
+}
+
+static void imagevisitobj(ImageWriter& w, GCObject* o)
+{
+    lua_State* L = w.L;
+
+    TValue key;
+    setpvalue(&key, o, 0);
+
+    if (!ttisnil(luaH_get(w.index, &key)))
+        return;
+
+    bool named = imagename(w, o) != NULL;
+
+    if (!named)
+    {
+        if (o->gch.tt == LUA_TUSERDATA || o->gch.tt == LUA_TTHREAD)
+            luaG_runerror(L, "can't save %s without a name to an image", luaT_typenames[o->gch.tt]);
+
+        if (o->gch.tt == LUA_TFUNCTION && gco2cl(o)->isC)
+            luaG_runerror(L, "can't save C function '%s' without a name to an image", gco2cl(o)->c.debugname ? gco2cl(o)->c.debugname : "?");
+    }
+
+    TValue* slot = luaH_set(L, w.index, &key);
+
+    if (!named && o->gch.tt == LUA_TFUNCTION)
+    {
+        setnvalue(slot, -(++w.closurecount));
+        setpvalue(luaH_setnum(L, w.closures, w.closurecount), o, 0);
+    }
+    else
+    {
+        setnvalue(slot, ++w.objectcount);
+        setpvalue(luaH_setnum(L, w.objects, w.objectcount), o, named);
+    }
+}
+
+static void imagevisit(ImageWriter& w, const TValue* v)
+{
+    if (ttislightuserdata(v))
+        luaG_runerror(w.L, "can't save lightuserdata to an image");
+
+    if (iscollectable(v))
+        imagevisitobj(w, gcvalue(v));
+}
+
+static void imagetraverse(ImageWriter& w, GCObject* o)
+{
+    lua_State* L = w.L;
+
+    switch (o->gch.tt)
+    {
+    case LUA_TTABLE:
+    {
+        Table* h = gco2h(o);
+
+        if (h->metatable)
+            imagevisitobj(w, obj2gco(h->metatable));
+
+        for (int i = 0; i < h->sizearray; ++i)
+            imagevisit(w, &h->array[i]);
+
+        for (int i = 0; i < sizenode(h); ++i)
+        {
+            LuaNode* n = gnode(h, i);
+
+            if (!ttisnil(gval(n)))
+            {
+                TValue key;
+                getnodekey(L, &key, n);
+
+                imagevisit(w, &key);
+                imagevisit(w, gval(n));
+            }
+        }
+        break;
+    }
+    case LUA_TFUNCTION:
+    {
+        Closure* cl = gco2cl(o);
+
+        imagevisitobj(w, obj2gco(cl->l.p));
+        imagevisitobj(w, obj2gco(cl->env));
+
+        for (int i = 0; i < cl->nupvalues; ++i)
+            imagevisit(w, &cl->l.uprefs[i]);
+        break;
+    }
+    case LUA_TUPVAL:
+        imagevisit(w, gco2uv(o)->v);
+        break;
+    case LUA_TPROTO:
+    {
+        Proto* p = gco2p(o);
+
+        // images hold complete functions, so the parts that are still encoded in the bytecode are decoded for good
+        if (p->lazychunk)
+            luaV_loadproto(L, p);
+
+        if (p->debugchunk)
+            luaV_loaddebuginfo(L, p, /* keep= */ true);
+
+        for (int i = 0; i < p->sizek; ++i)
+            imagevisit(w, &p->k[i]);
+
+        for (int i = 0; i < p->sizep; ++i)
+            imagevisitobj(w, obj2gco(p->p[i]));
+
+        if (p->source)
+            imagevisitobj(w, obj2gco(p->source));
+
+        if (p->debugname)
+            imagevisitobj(w, obj2gco(p->debugname));
+
+        for (int i = 0; i < p->sizelocvars; ++i)
+            if (p->locvars[i].varname)
+                imagevisitobj(w, obj2gco(p->locvars[i].varname));
+
+        for (int i = 0; i < p->sizeupvalues; ++i)
+            if (p->upvalues[i])
+                imagevisitobj(w, obj2gco(p->upvalues[i]));
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+static char* imagereserve(ImageWriter& w, size_t n)
+{
+    Buffer* b = bufvalue(w.out);
+
+    if (w.size + n > b->len)
+    {
+        size_t capacity = size_t(b->len) * 2 > w.size + n ? size_t(b->len) * 2 : w.size + n;
+
+        if (capacity > MAX_BUFFER_SIZE)
+            luaG_runerror(w.L, "image is too large");
+
+        Buffer* nb = luaB_newbuffer(w.L, capacity);
+        memcpy(nb->data, b->data, w.size);
+        setbufvalue(w.L, w.out, nb);
+        b = nb;
+    }
+
+    char* result = b->data + w.size;
+    w.size += n;
+    return result;
+}
+
+static void writebytes(ImageWriter& w, const void* data, size_t size)
+{
+    memcpy(imagereserve(w, size), data, size);
+}
+
+static void writebyte(ImageWriter& w, uint8_t value)
+{
+    *imagereserve(w, 1) = char(value);
+}
+
+static void writevarint(ImageWriter& w, size_t value)
+{
+    do
+    {
+        writebyte(w, uint8_t((value & 127) | ((value > 127) << 7)));
+        value >>= 7;
+    } while (value);
+}
+
+static void writelstring(ImageWriter& w, const char* data, size_t size)
+{
+    writevarint(w, size);
+    writebytes(w, data, size);
+}
+
+static int imagenumber(ImageWriter& w, GCObject* o)
+{
+    TValue key;
+    setpvalue(&key, o, 0);
+
+    double n = nvalue(luaH_get(w.index, &key));
+    return n > 0 ? int(n) - 1 : w.objectcount + int(-n) - 1;
+}
+
+// references that may be NULL are written as 0, others are offset by 1
+static void writeref(ImageWriter& w, GCObject* o)
+{
+    writevarint(w, o ? imagenumber(w, o) + 1 : 0);
+}
+
+static void writevalue(ImageWriter& w, const TValue* v)
+{
+    writebyte(w, uint8_t(ttype(v)));
+
+    switch (ttype(v))
+    {
+    case LUA_TNIL:
+        break;
+    case LUA_TBOOLEAN:
+        writebyte(w, uint8_t(bvalue(v) != 0));
+        break;
+    case LUA_TNUMBER:
+    {
+        double n = nvalue(v);
+        writebytes(w, &n, sizeof(double));
+        break;
+    }
+    case LUA_TVECTOR:
+        writebytes(w, vvalue(v), sizeof(float) * LUA_VECTOR_SIZE);
+        break;
+    default:
+        LUAU_ASSERT(iscollectable(v));
+        writevarint(w, imagenumber(w, gcvalue(v)));
+        break;
+    }
+}
+
+static int tablehashcount(Table* h)
+{
+    int count = 0;
+    for (int i = 0; i < sizenode(h); ++i)
+        count += !ttisnil(gval(gnode(h, i)));
+
+    return count;
+}
+
+static void writecreation(ImageWriter& w, GCObject* o, bool named)
+{
+    if (named)
+    {
+        const TString* name = imagename(w, o);
+
+        writebyte(w, IMAGE_NAME);
+        writelstring(w, getstr(name), name->len);
+        return;
+    }
+
+    switch (o->gch.tt)
+    {
+    case LUA_TSTRING:
+        writebyte(w, IMAGE_STRING);
+        writelstring(w, getstr(gco2ts(o)), gco2ts(o)->len);
+        break;
+    case LUA_TBUFFER:
+        writebyte(w, IMAGE_BUFFER);
+        writelstring(w, (const char*)bufferdata(gco2buf(o)), bufferlen(gco2buf(o)));
+        break;
+    case LUA_TTABLE:
+    {
+        Table* h = gco2h(o);
+
+        writebyte(w, IMAGE_TABLE);
+        writevarint(w, h->sizearray);
+        writevarint(w, tablehashcount(h));
+        break;
+    }
+    case LUA_TUPVAL:
+        writebyte(w, IMAGE_UPVAL);
+        break;
+    case LUA_TPROTO:
+    {
+        Proto* p = gco2p(o);
+
+        writebyte(w, IMAGE_PROTO);
+        writebyte(w, p->nups);
+        writebyte(w, p->numparams);
+        writebyte(w, p->is_vararg);
+        writebyte(w, p->maxstacksize);
+        writebyte(w, p->flags);
+
+        writebyte(w, p->typeinfo != NULL);
+        if (p->typeinfo)
+            writebytes(w, p->typeinfo, p->numparams + 2);
+
+        // breakpoints are stored in the code, the original opcodes are kept in debuginsn
+        writevarint(w, p->sizecode);
+        for (int i = 0; i < p->sizecode; ++i)
+        {
+            Instruction insn = p->code[i];
+
+            if (p->debuginsn && LUAU_INSN_OP(insn) == LOP_BREAK)
+                insn = (insn & ~0xff) | p->debuginsn[i];
+
+            writebytes(w, &insn, sizeof(insn));
+        }
+
+        writevarint(w, p->sizek);
+        writevarint(w, p->sizep);
+        writevarint(w, p->linedefined);
+        writevarint(w, p->bytecodeid);
+
+        writebyte(w, p->lineinfo != NULL);
+        if (p->lineinfo)
+        {
+            writebyte(w, uint8_t(p->linegaplog2));
+            writelstring(w, (const char*)p->lineinfo, p->sizelineinfo);
+        }
+
+        writevarint(w, p->sizelocvars);
+        for (int i = 0; i < p->sizelocvars; ++i)
+        {
+            writevarint(w, p->locvars[i].startpc);
+            writevarint(w, p->locvars[i].endpc);
+            writebyte(w, p->locvars[i].reg);
+        }
+
+        writevarint(w, p->sizeupvalues);
+        break;
+    }
+    case LUA_TFUNCTION:
+    {
+        Closure* cl = gco2cl(o);
+
+        writebyte(w, IMAGE_CLOSURE);
+        writebyte(w, cl->nupvalues);
+        writebyte(w, cl->preload);
+        writeref(w, obj2gco(cl->l.p));
+        writeref(w, obj2gco(cl->env));
+        break;
+    }
+    default:
+        LUAU_ASSERT(!"Unexpected object type");
+    }
+}
+
+static void writefill(ImageWriter& w, GCObject* o, bool named)
+{
+    if (named)
+    {
+        writebyte(w, IMAGE_NAME);
+        return;
+    }
+
+    lua_State* L = w.L;
+
+    switch (o->gch.tt)
+    {
+    case LUA_TSTRING:
+        writebyte(w, IMAGE_STRING);
+        break;
+    case LUA_TBUFFER:
+        writebyte(w, IMAGE_BUFFER);
+        break;
+    case LUA_TTABLE:
+    {
+        Table* h = gco2h(o);
+
+        writebyte(w, IMAGE_TABLE);
+        writeref(w, h->metatable ? obj2gco(h->metatable) : NULL);
+
+        for (int i = 0; i < h->sizearray; ++i)
+            writevalue(w, &h->array[i]);
+
+        writevarint(w, tablehashcount(h));
+
+        for (int i = 0; i < sizenode(h); ++i)
+        {
+            LuaNode* n = gnode(h, i);
+
+            if (!ttisnil(gval(n)))
+            {
+                TValue key;
+                getnodekey(L, &key, n);
+
+                writevalue(w, &key);
+                writevalue(w, gval(n));
+            }
+        }
+
+        // storage sharing doesn't carry over to the copy, and an exposed environment is only kept safe until its first write, so it's saved as unsafe
+        writebyte(w, h->readonly & TABLE_FROZEN);
+        writebyte(w, h->safeenv && (h->readonly & TABLE_EXPOSEDENV) == 0);
+        break;
+    }
+    case LUA_TUPVAL:
+        writebyte(w, IMAGE_UPVAL);
+        writevalue(w, gco2uv(o)->v);
+        break;
+    case LUA_TPROTO:
+    {
+        Proto* p = gco2p(o);
+
+        writebyte(w, IMAGE_PROTO);
+
+        for (int i = 0; i < p->sizek; ++i)
+            writevalue(w, &p->k[i]);
+
+        for (int i = 0; i < p->sizep; ++i)
+            writeref(w, obj2gco(p->p[i]));
+
+        writeref(w, p->source ? obj2gco(p->source) : NULL);
+        writeref(w, p->debugname ? obj2gco(p->debugname) : NULL);
+
+        for (int i = 0; i < p->sizelocvars; ++i)
+            writeref(w, p->locvars[i].varname ? obj2gco(p->locvars[i].varname) : NULL);
+
+        for (int i = 0; i < p->sizeupvalues; ++i)
+            writeref(w, p->upvalues[i] ? obj2gco(p->upvalues[i]) : NULL);
+        break;
+    }
+    case LUA_TFUNCTION:
+    {
+        Closure* cl = gco2cl(o);
+
+        writebyte(w, IMAGE_CLOSURE);
+
+        for (int i = 0; i < cl->nupvalues; ++i)
+            writevalue(w, &cl->l.uprefs[i]);
+        break;
+    }
+    default:
+        LUAU_ASSERT(!"Unexpected object type");
+    }
+}
+
+void lua_saveimage(lua_State* L, int idx, int names)
+{
+    luaC_checkGC(L);
+    luaC_threadbarrier(L);
+
+    // pseudo-indices resolve to a temporary slot, so the value is copied before other indices are resolved
+    const TValue* o = luaA_toobject(L, idx);
+    api_check(L, o);
+    TValue root = *o;
+
+    Table* namest = NULL;
+    if (names != 0)
+    {
+        const TValue* n = luaA_toobject(L, names);
+        api_check(L, n && ttistable(n));
+        namest = hvalue(n);
+    }
+
+    luaD_checkstack(L, 4);
+
+    // work tables and output are kept on the stack so that they are collected when an error is raised
+    StkId base = L->top;
+    ImageWriter w = {L, namest};
+
+    w.index = luaH_new(L, 0, 0);
+    sethvalue(L, L->top, w.index);
+    incr_top(L);
+    w.objects = luaH_new(L, 0, 0);
+    sethvalue(L, L->top, w.objects);
+    incr_top(L);
+    w.closures = luaH_new(L, 0, 0);
+    sethvalue(L, L->top, w.closures);
+    incr_top(L);
+
+    w.out = L->top;
+    setbufvalue(L, w.out, luaB_newbuffer(L, 256));
+    incr_top(L);
+
+    // nothing is collected while the image is written since no collector steps are taken, so objects are only referenced by address
+    imagevisit(w, &root);
+
+    for (int i = 1, j = 1; i <= w.objectcount || j <= w.closurecount;)
+    {
+        if (i <= w.objectcount)
+        {
+            const TValue* o = luaH_getnum(w.objects, i++);
+
+            if (lightuserdatatag(o) == 0)
+                imagetraverse(w, (GCObject*)pvalue(o));
+        }
+        else
+        {
+            const TValue* o = luaH_getnum(w.closures, j++);
+
+            imagetraverse(w, (GCObject*)pvalue(o));
+        }
+    }
+
+    writebytes(w, IMAGE_MAGIC, 4);
+    writebyte(w, IMAGE_VERSION);
+    writebyte(w, LUA_VECTOR_SIZE);
+    writevarint(w, w.objectcount + w.closurecount);
+
+    for (int i = 1; i <= w.objectcount; ++i)
+    {
+        const TValue* o = luaH_getnum(w.objects, i);
+        writecreation(w, (GCObject*)pvalue(o), lightuserdatatag(o) != 0);
+    }
+
+    for (int i = 1; i <= w.closurecount; ++i)
+        writecreation(w, (GCObject*)pvalue(luaH_getnum(w.closures, i)), false);
+
+    for (int i = 1; i <= w.objectcount; ++i)
+    {
+        const TValue* o = luaH_getnum(w.objects, i);
+        writefill(w, (GCObject*)pvalue(o), lightuserdatatag(o) != 0);
+    }
+
+    for (int i = 1; i <= w.closurecount; ++i)
+        writefill(w, (GCObject*)pvalue(luaH_getnum(w.closures, i)), false);
+
+    writevalue(w, &root);
+
+    Buffer* result = luaB_newbuffer(L, w.size);
+    memcpy(result->data, bufvalue(w.out)->data, w.size);
+
+    setbufvalue(L, base, result);
+    L->top = base + 1;
+}
+
+struct ImageReader
+{
+    lua_State* L;
+    Table* names;  // name -> object
+    Table* objects; // object number -> object
+
+    const char* data;
+    size_t size;
+    size_t offset;
+    bool failed;
+};
+
+static const char* readbytes(ImageReader& r, size_t size)
+{
+    if (r.failed || size > r.size - r.offset)
+    {
+        r.failed = true;
+        return NULL;
+    }
+
+    const char* result = r.data + r.offset;
+    r.offset += size;
+    return result;
+}
+
+static uint8_t readbyte(ImageReader& r)
+{
+    const char* data = readbytes(r, 1);
+    return data ? uint8_t(*data) : 0;
+}
+
+static size_t readvarint(ImageReader& r)
+{
+    size_t result = 0;
+    unsigned shift = 0;
+
+    uint8_t byte;
+
+    do
+    {
+        byte = readbyte(r);
+        result |= size_t(byte & 127) << shift;
+        shift += 7;
+    } while ((byte & 128) && shift < 64);
+
+    return result;
+}
+
+// sizes of arrays are checked against the remaining data, since each element takes at least one byte
+static int readcount(ImageReader& r)
+{
+    size_t count = readvarint(r);
+
+    if (count > r.size - r.offset || count > INT_MAX)
+    {
+        r.failed = true;
+        return 0;
+    }
+
+    return int(count);
+}
+
+static GCObject* readref(ImageReader& r, int type, bool optional)
+{
+    size_t ref = readvarint(r);
+
+    if (optional && ref == 0)
+        return NULL;
+
+    size_t index = optional ? ref - 1 : ref;
+
+    if (r.failed || index >= size_t(r.objects->sizearray) || ttype(&r.objects->array[index]) != type)
+    {
+        r.failed = true;
+        return NULL;
+    }
+
+    return gcvalue(&r.objects->array[index]);
+}
+
+static bool readvalue(ImageReader& r, TValue* v)
+{
+    uint8_t type = readbyte(r);
+
+    switch (type)
+    {
+    case LUA_TNIL:
+        setnilvalue(v);
+        break;
+    case LUA_TBOOLEAN:
+        setbvalue(v, readbyte(r) != 0);
+        break;
+    case LUA_TNUMBER:
+    {
+        double value = 0;
+        if (const char* data = readbytes(r, sizeof(double)))
+            memcpy(&value, data, sizeof(double));
+
+        setnvalue(v, value);
+        break;
+    }
+    case LUA_TVECTOR:
+    {
+        float value[4] = {};
+        if (const char* data = readbytes(r, sizeof(float) * LUA_VECTOR_SIZE))
+            memcpy(value, data, sizeof(float) * LUA_VECTOR_SIZE);
+
+        setvvalue(v, value[0], value[1], value[2], value[3]);
+        break;
+    }
+    default:
+        if (GCObject* o = readref(r, type, false))
+        {
+            v->value.gc = o;
+            v->tt = type;
+        }
+        else
+        {
+            setnilvalue(v);
+        }
+        break;
+    }
+
+    return !r.failed;
+}
+
+static bool readproto(ImageReader& r, Proto* p)
+{
+    lua_State* L = r.L;
+
+    p->nups = readbyte(r);
+    p->numparams = readbyte(r);
+    p->is_vararg = readbyte(r);
+    p->maxstacksize = readbyte(r);
+    p->flags = readbyte(r);
+
+    if (readbyte(r))
+    {
+        const char* types = readbytes(r, p->numparams + 2);
+        if (!types)
+            return false;
+
+        p->typeinfo = luaM_newarray(L, p->numparams + 2, uint8_t, p->memcat);
+        memcpy(p->typeinfo, types, p->numparams + 2);
+    }
+
+    int sizecode = readcount(r);
+    const char* code = readbytes(r, sizecode * sizeof(Instruction));
+    if (!code)
+        return false;
+
+    p->code = luaM_newarray(L, sizecode, Instruction, p->memcat);
+    p->sizecode = sizecode;
+    memcpy(p->code, code, sizecode * sizeof(Instruction));
+    p->codeentry = p->code;
+
+    int sizek = readcount(r);
+    p->k = luaM_newarray(L, sizek, TValue, p->memcat);
+    p->sizek = sizek;
+    for (int i = 0; i < sizek; ++i)
+        setnilvalue(&p->k[i]);
+
+    int sizep = readcount(r);
+    p->p = luaM_newarray(L, sizep, Proto*, p->memcat);
+    p->sizep = sizep;
+    for (int i = 0; i < sizep; ++i)
+        p->p[i] = NULL;
+
+    p->linedefined = int(readvarint(r));
+    p->bytecodeid = int(readvarint(r));
+
+    if (readbyte(r))
+    {
+        p->linegaplog2 = readbyte(r);
+
+        int sizelineinfo = readcount(r);
+        int absoffset = (p->sizecode + 3) & ~3;
+        int intervals = p->sizecode ? ((p->sizecode - 1) >> p->linegaplog2) + 1 : 0;
+
+        const char* lineinfo = readbytes(r, sizelineinfo);
+        if (!lineinfo || p->linegaplog2 >= 32 || sizelineinfo != absoffset + intervals * int(sizeof(int)))
+            return false;
+
+        p->lineinfo = luaM_newarray(L, sizelineinfo, uint8_t, p->memcat);
+        p->sizelineinfo = sizelineinfo;
+        memcpy(p->lineinfo, lineinfo, sizelineinfo);
+        p->abslineinfo = (int*)(p->lineinfo + absoffset);
+    }
+
+    int sizelocvars = readcount(r);
+    p->locvars = luaM_newarray(L, sizelocvars, LocVar, p->memcat);
+    p->sizelocvars = sizelocvars;
+    for (int i = 0; i < sizelocvars; ++i)
+    {
+        p->locvars[i].varname = NULL;
+        p->locvars[i].startpc = int(readvarint(r));
+        p->locvars[i].endpc = int(readvarint(r));
+        p->locvars[i].reg = readbyte(r);
+    }
+
+    int sizeupvalues = readcount(r);
+    p->upvalues = luaM_newarray(L, sizeupvalues, TString*, p->memcat);
+    p->sizeupvalues = sizeupvalues;
+    for (int i = 0; i < sizeupvalues; ++i)
+        p->upvalues[i] = NULL;
+
+    return !r.failed;
+}
+
+static bool readcreation(ImageReader& r, TValue* slot)
+{
+    lua_State* L = r.L;
+
+    switch (readbyte(r))
+    {
+    case IMAGE_NAME:
+    {
+        size_t len = readvarint(r);
+        const char* data = readbytes(r, len);
+        if (!data)
+            return false;
+
+        TString* name = luaS_newlstr(L, data, len);
+        const TValue* o = r.names ? luaH_getstr(r.names, name) : luaO_nilobject;
+
+        if (!iscollectable(o))
+        {
+            luaO_pushfstring(L, "image refers to unknown object '%s'", getstr(name));
+            return false;
+        }
+
+        setobj(L, slot, o);
+        break;
+    }
+    case IMAGE_STRING:
+    {
+        size_t len = readvarint(r);
+        const char* data = readbytes(r, len);
+        if (!data)
+            return false;
+
+        setsvalue(L, slot, luaS_newlstr(L, data, len));
+        break;
+    }
+    case IMAGE_BUFFER:
+    {
+        size_t len = readvarint(r);
+        const char* data = readbytes(r, len);
+        if (!data || len > MAX_BUFFER_SIZE)
+            return false;
+
+        Buffer* b = luaB_newbuffer(L, len);
+        memcpy(b->data, data, len);
+        setbufvalue(L, slot, b);
+        break;
+    }
+    case IMAGE_TABLE:
+    {
+        int sizearray = readcount(r);
+        int hashcount = readcount(r);
+        if (r.failed)
+            return false;
+
+        sethvalue(L, slot, luaH_new(L, sizearray, hashcount));
+        break;
+    }
+    case IMAGE_UPVAL:
+    {
+        UpVal* uv = luaM_newgco(L, UpVal, sizeof(UpVal), L->activememcat);
+        luaC_init(L, uv, LUA_TUPVAL);
+        uv->markedopen = 0;
+        uv->v = &uv->u.value;
+        setnilvalue(uv->v);
+
+        setupvalue(L, slot, uv);
+        break;
+    }
+    case IMAGE_PROTO:
+    {
+        Proto* p = luaF_newproto(L);
+        setptvalue(L, slot, p);
+
+        if (!readproto(r, p))
+            return false;
+        break;
+    }
+    case IMAGE_CLOSURE:
+    {
+        int nupvalues = readbyte(r);
+        uint8_t preload = readbyte(r);
+
+        Proto* p = (Proto*)readref(r, LUA_TPROTO, true);
+        Table* env = (Table*)readref(r, LUA_TTABLE, true);
+        if (!p || !env)
+            return false;
+
+        Closure* cl = luaF_newLclosure(L, nupvalues, env, p);
+        cl->preload = preload;
+        setclvalue(L, slot, cl);
+        break;
+    }
+    default:
+        return false;
+    }
+
+    return !r.failed;
+}
+
+static bool readfill(ImageReader& r, TValue* slot)
+{
+    lua_State* L = r.L;
+
+    uint8_t kind = readbyte(r);
+
+    if (kind == IMAGE_NAME || kind == IMAGE_STRING || kind == IMAGE_BUFFER)
+        return !r.failed;
+
+    if (kind == IMAGE_TABLE && ttistable(slot))
+    {
+        Table* h = hvalue(slot);
+
+        h->metatable = (Table*)readref(r, LUA_TTABLE, true);
+
+        for (int i = 0; i < h->sizearray; ++i)
+            if (!readvalue(r, &h->array[i]))
+                return false;
+
+        int hashcount = readcount(r);
+
+        for (int i = 0; i < hashcount; ++i)
+        {
+            TValue key, value;
+            if (!readvalue(r, &key) || !readvalue(r, &value))
+                return false;
+
+            if (ttisnil(&key) || (ttisnumber(&key) && luai_numisnan(nvalue(&key))))
+                return false;
+
+            setobj2t(L, luaH_set(L, h, &key), &value);
+        }
+
+        uint8_t readonly = readbyte(r);
+
+        // loaded tables own their storage, so the image can't ask for any other bit
+        if (readonly & ~TABLE_FROZEN)
+            return false;
+
+        h->readonly = readonly;
+        h->safeenv = readbyte(r);
+
+        // fields were set without going through the metamethod cache
+        invalidateTMcache(L, h);
+    }
+    else if (kind == IMAGE_UPVAL && ttisupval(slot))
+    {
+        if (!readvalue(r, upvalue(slot)->v))
+            return false;
+    }
+    else if (kind == IMAGE_PROTO && ttype(slot) == LUA_TPROTO)
+    {
+        Proto* p = gco2p(gcvalue(slot));
+
+        for (int i = 0; i < p->sizek; ++i)
+            if (!readvalue(r, &p->k[i]))
+                return false;
+
+        for (int i = 0; i < p->sizep; ++i)
+            if (!(p->p[i] = (Proto*)readref(r, LUA_TPROTO, true)))
+                return false;
+
+        p->source = (TString*)readref(r, LUA_TSTRING, true);
+        p->debugname = (TString*)readref(r, LUA_TSTRING, true);
+
+        for (int i = 0; i < p->sizelocvars; ++i)
+            p->locvars[i].varname = (TString*)readref(r, LUA_TSTRING, true);
+
+        for (int i = 0; i < p->sizeupvalues; ++i)
+            p->upvalues[i] = (TString*)readref(r, LUA_TSTRING, true);
+    }
+    else if (kind == IMAGE_CLOSURE && ttisfunction(slot))
+    {
+        Closure* cl = clvalue(slot);
+
+        for (int i = 0; i < cl->nupvalues; ++i)
+            if (!readvalue(r, &cl->l.uprefs[i]))
+                return false;
+    }
+    else
+    {
+        return false;
+    }
+
+    return !r.failed;
+}
+
+static bool readimage(ImageReader& r, StkId base)
+{
+    const char* header = readbytes(r, 4);
+    uint8_t version = readbyte(r);
+    uint8_t vectorsize = readbyte(r);
+
+    if (!header || memcmp(header, IMAGE_MAGIC, 4) != 0 || version != IMAGE_VERSION || vectorsize != LUA_VECTOR_SIZE)
+    {
+        luaO_pushfstring(r.L, "image has an unsupported format");
+        return false;
+    }
+
+    int count = readcount(r);
+    r.objects = luaH_new(r.L, count, 0);
+    sethvalue(r.L, base, r.objects);
+
+    for (int i = 0; i < count; ++i)
+        if (!readcreation(r, &r.objects->array[i]))
+            return false;
+
+    for (int i = 0; i < count; ++i)
+        if (!readfill(r, &r.objects->array[i]))
+            return false;
+
+    return readvalue(r, base + 1) && r.offset == r.size;
+}
+
+int lua_loadimage(lua_State* L, const char* data, size_t size, int names)
+{
+    luaC_checkGC(L);
+    luaC_threadbarrier(L);
+
+    Table* namest = NULL;
+    if (names != 0)
+    {
+        const TValue* n = luaA_toobject(L, names);
+        api_check(L, n && ttistable(n));
+        namest = hvalue(n);
+    }
+
+    luaD_checkstack(L, 3);
+
+    // objects are anchored by a table on the stack; no collector steps are taken until the image is loaded
+    StkId base = L->top;
+    setnilvalue(L->top);
+    incr_top(L);
+    setnilvalue(L->top);
+    incr_top(L);
+
+    ImageReader r = {L, namest, NULL, data, size, 0, false};
+
+    if (!readimage(r, base))
+    {
+        // errors that don't have a specific message are reported after the fact
+        if (L->top == base + 2)
+            luaO_pushfstring(L, "image is malformed");
+
+        setobj2s(L, base, L->top - 1);
+        L->top = base + 1;
+        return 1;
+    }
+
+    setobj2s(L, base, base + 1);
+    L->top = base + 1;
+    return 0;
+}
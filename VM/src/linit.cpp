@@ -15,6 +15,7 @@ static const luaL_Reg lualibs[] = {
     {LUA_UTF8LIBNAME, luaopen_utf8},
     {LUA_BITLIBNAME, luaopen_bit32},
     {LUA_BUFFERLIBNAME, luaopen_buffer},
+    {LUA_JSONLIBNAME, luaopen_json},
     {NULL, NULL},
 };
 
@@ -75,6 +76,59 @@ void luaL_sandboxthread(lua_State* L)
     lua_setsafeenv(L, LUA_GLOBALSINDEX, true);
 }
 
+static void addimagename(lua_State* L, int names, int load, int value, const char* name)
+{
+    value = lua_absindex(L, value);
+
+    if (load)
+    {
+        lua_pushstring(L, name);
+        lua_pushvalue(L, value);
+    }
+    else
+    {
+        lua_pushvalue(L, value);
+        lua_pushstring(L, name);
+    }
+
+    lua_rawset(L, names);
+}
+
+void luaL_imagenames(lua_State* L, int load)
+{
+    lua_newtable(L);
+    int names = lua_gettop(L);
+
+    lua_pushnil(L);
+    while (lua_next(L, LUA_GLOBALSINDEX) != 0)
+    {
+        // the global table itself is left to be copied, since that's usually the image root
+        if (lua_type(L, -2) == LUA_TSTRING && (lua_isfunction(L, -1) || lua_istable(L, -1)) && !lua_rawequal(L, -1, LUA_GLOBALSINDEX))
+        {
+            const char* lib = lua_tostring(L, -2);
+            addimagename(L, names, load, -1, lib);
+
+            if (lua_istable(L, -1))
+            {
+                lua_pushnil(L);
+                while (lua_next(L, -2) != 0)
+                {
+                    if (lua_type(L, -2) == LUA_TSTRING && lua_isfunction(L, -1))
+                    {
+                        lua_pushfstring(L, "%s.%s", lib, lua_tostring(L, -2));
+                        addimagename(L, names, load, -2, lua_tostring(L, -1));
+                        lua_pop(L, 1);
+                    }
+
+                    lua_pop(L, 1);
+                }
+            }
+        }
+
+        lua_pop(L, 1);
+    }
+}
+
 static void* l_alloc(void* ud, void* ptr, size_t osize, size_t nsize)
 {
     (void)ud;
@@ -0,0 +1,748 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#include "lualib.h"
+
+#include "lcommon.h"
+#include "lapi.h"
+#include "lnumutils.h"
+#include "lstate.h"
+#include "lstring.h"
+#include "ltable.h"
+
+#include "Luau/NumberParse.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// limits nesting for both encoding and decoding; this also stops the encoder on cyclic tables
+#define JSON_MAXDEPTH LUAI_MAXCCALLS
+
+// decoded values are accumulated on the stack in batches before being stored, which lets small tables be allocated with the exact size
+#define JSON_BATCH 16
+
+static_assert(JSON_MAXDEPTH * (JSON_BATCH * 2 + 3) < LUAI_MAXCSTACK, "decoder stack usage for nested tables exceeds the stack limit");
+
+inline bool json_isspecial(char ch)
+{
+    return (unsigned char)ch < 0x20 || ch == '"' || ch == '\\';
+}
+
+// skip over string characters that don't require escaping, 8 bytes at a time
+static const char* json_skipplain(const char* s, const char* end)
+{
+    const uint64_t ones = 0x0101010101010101ull;
+    const uint64_t highs = 0x8080808080808080ull;
+
+    while (end - s >= 8)
+    {
+        uint64_t w;
+        memcpy(&w, s, 8);
+
+        uint64_t quote = w ^ (ones * '"');
+        uint64_t slash = w ^ (ones * '\\');
+
+        // high bit is set if any byte is below 0x20, or if any byte is zero after xor (matches '"' or '\\')
+        uint64_t special = ((w - ones * 0x20) & ~w) | ((quote - ones) & ~quote) | ((slash - ones) & ~slash);
+
+        if (special & highs)
+            break;
+
+        s += 8;
+    }
+
+    while (s < end && !json_isspecial(*s))
+        s++;
+
+    return s;
+}
+
+static void json_encodestring(luaL_Strbuf* b, const char* s, size_t len)
+{
+    static const char hex[] = "0123456789abcdef";
+
+    const char* end = s + len;
+
+    luaL_addchar(b, '"');
+
+    while (s < end)
+    {
+        const char* run = json_skipplain(s, end);
+        luaL_addlstring(b, s, run - s);
+
+        if (run == end)
+            break;
+
+        switch (*run)
+        {
+        case '"':
+            luaL_addlstring(b, "\\\"", 2);
+            break;
+        case '\\':
+            luaL_addlstring(b, "\\\\", 2);
+            break;
+        case '\b':
+            luaL_addlstring(b, "\\b", 2);
+            break;
+        case '\f':
+            luaL_addlstring(b, "\\f", 2);
+            break;
+        case '\n':
+            luaL_addlstring(b, "\\n", 2);
+            break;
+        case '\r':
+            luaL_addlstring(b, "\\r", 2);
+            break;
+        case '\t':
+            luaL_addlstring(b, "\\t", 2);
+            break;
+        default:
+        {
+            unsigned char ch = *run;
+            char esc[6] = {'\\', 'u', '0', '0', hex[ch >> 4], hex[ch & 15]};
+            luaL_addlstring(b, esc, sizeof(esc));
+        }
+        }
+
+        s = run + 1;
+    }
+
+    luaL_addchar(b, '"');
+}
+
+static void json_encodenumber(luaL_Strbuf* b, double n)
+{
+    if (!isfinite(n))
+        luaL_error(b->L, "cannot encode non-finite number");
+
+    char s[LUAI_MAXNUM2STR];
+    char* e = luai_num2str(s, n);
+
+    // scientific notation may be printed with a trailing dot ('1.e+22'), which isn't valid JSON
+    char* exp = (char*)memchr(s, 'e', e - s);
+
+    if (exp && exp[-1] == '.')
+    {
+        memmove(exp - 1, exp, e - exp);
+        e--;
+    }
+
+    luaL_addlstring(b, s, e - s);
+}
+
+static void json_encodevalue(luaL_Strbuf* b, const TValue* v, int depth);
+
+static void json_encodetable(luaL_Strbuf* b, Table* t, int depth)
+{
+    lua_State* L = b->L;
+
+    if (depth >= JSON_MAXDEPTH)
+        luaL_error(L, "cannot encode table: nesting is too deep");
+
+    // tables are encoded as arrays when all keys form a 1..n sequence, and as objects when all keys are strings
+    int count = 0;
+    bool stringkeys = true;
+
+    for (int i = 0; i < t->sizearray; i++)
+    {
+        if (!ttisnil(&t->array[i]))
+        {
+            count++;
+            stringkeys = false;
+        }
+    }
+
+    for (int i = 0; i < sizenode(t); i++)
+    {
+        LuaNode* n = gnode(t, i);
+
+        if (!ttisnil(gval(n)))
+        {
+            count++;
+            stringkeys &= gkey(n)->tt == LUA_TSTRING;
+        }
+    }
+
+    if (count == 0)
+    {
+        luaL_addlstring(b, "[]", 2);
+        return;
+    }
+
+    if (stringkeys)
+    {
+        luaL_addchar(b, '{');
+
+        bool first = true;
+
+        for (int i = 0; i < sizenode(t); i++)
+        {
+            LuaNode* n = gnode(t, i);
+
+            if (ttisnil(gval(n)))
+                continue;
+
+            if (!first)
+                luaL_addchar(b, ',');
+
+            TString* key = gco2ts(gkey(n)->value.gc);
+            json_encodestring(b, getstr(key), key->len);
+            luaL_addchar(b, ':');
+            json_encodevalue(b, gval(n), depth + 1);
+
+            first = false;
+        }
+
+        luaL_addchar(b, '}');
+        return;
+    }
+
+    int size = luaH_getn(t);
+
+    for (int i = 1; i <= size; i++)
+    {
+        if (ttisnil(luaH_getnum(t, i)))
+            luaL_error(L, "cannot encode table: array has holes");
+    }
+
+    if (size != count)
+        luaL_error(L, "cannot encode table: keys must be all strings or form an array");
+
+    luaL_addchar(b, '[');
+
+    for (int i = 1; i <= size; i++)
+    {
+        if (i > 1)
+            luaL_addchar(b, ',');
+
+        json_encodevalue(b, luaH_getnum(t, i), depth + 1);
+    }
+
+    luaL_addchar(b, ']');
+}
+
+static void json_encodevalue(luaL_Strbuf* b, const TValue* v, int depth)
+{
+    switch (ttype(v))
+    {
+    case LUA_TNIL:
+        luaL_addlstring(b, "null", 4);
+        break;
+    case LUA_TBOOLEAN:
+        if (bvalue(v))
+            luaL_addlstring(b, "true", 4);
+        else
+            luaL_addlstring(b, "false", 5);
+        break;
+    case LUA_TNUMBER:
+        json_encodenumber(b, nvalue(v));
+        break;
+    case LUA_TSTRING:
+        json_encodestring(b, svalue(v), tsvalue(v)->len);
+        break;
+    case LUA_TTABLE:
+        json_encodetable(b, hvalue(v), depth);
+        break;
+    default:
+        luaL_error(b->L, "cannot encode %s", lua_typename(b->L, ttype(v)));
+    }
+}
+
+static int json_encode(lua_State* L)
+{
+    luaL_checkany(L, 1);
+
+    // encoding doesn't run any code and doesn't perform GC steps, so tables can be traversed directly
+    // the value is copied since string buffer storage is placed on the stack as the result grows
+    TValue v = *luaA_toobject(L, 1);
+
+    luaL_Strbuf b;
+    luaL_buffinit(L, &b);
+    json_encodevalue(&b, &v, 0);
+    luaL_pushresult(&b);
+    return 1;
+}
+
+struct JsonDecoder
+{
+    lua_State* L;
+
+    const char* begin;
+    const char* p;
+    const char* end;
+};
+
+static l_noret json_error(JsonDecoder& d, const char* msg)
+{
+    luaL_error(d.L, "cannot decode JSON at position %d: %s", int(d.p - d.begin) + 1, msg);
+}
+
+static void json_skipspace(JsonDecoder& d)
+{
+    while (d.p < d.end && (*d.p == ' ' || *d.p == '\t' || *d.p == '\n' || *d.p == '\r'))
+        d.p++;
+}
+
+static void json_expectliteral(JsonDecoder& d, const char* literal, size_t len)
+{
+    if (size_t(d.end - d.p) < len || memcmp(d.p, literal, len) != 0)
+        json_error(d, "unexpected character");
+
+    d.p += len;
+}
+
+inline bool json_isdigit(JsonDecoder& d)
+{
+    return d.p < d.end && unsigned(*d.p - '0') < 10;
+}
+
+static void json_decodenumber(JsonDecoder& d)
+{
+    const char* start = d.p;
+
+    if (*d.p == '-')
+        d.p++;
+
+    if (!json_isdigit(d))
+        json_error(d, "invalid number");
+
+    if (*d.p == '0')
+        d.p++;
+    else
+        while (json_isdigit(d))
+            d.p++;
+
+    if (d.p < d.end && *d.p == '.')
+    {
+        d.p++;
+
+        if (!json_isdigit(d))
+            json_error(d, "invalid number");
+
+        while (json_isdigit(d))
+            d.p++;
+    }
+
+    if (d.p < d.end && (*d.p == 'e' || *d.p == 'E'))
+    {
+        d.p++;
+
+        if (d.p < d.end && (*d.p == '+' || *d.p == '-'))
+            d.p++;
+
+        if (!json_isdigit(d))
+            json_error(d, "invalid number");
+
+        while (json_isdigit(d))
+            d.p++;
+    }
+
+    // most numbers can be converted exactly without going through strtod
+    double value = 0;
+
+    // the input is a Lua string, so it's zero-terminated and both parsers stop at the same character as the grammar above
+    if (Luau::parseDecimalFast(start, value) != d.p)
+        value = strtod(start, NULL);
+
+    lua_pushnumber(d.L, value);
+}
+
+static unsigned json_decodehex4(JsonDecoder& d)
+{
+    if (d.end - d.p < 4)
+        json_error(d, "invalid unicode escape");
+
+    unsigned cp = 0;
+
+    for (int i = 0; i < 4; i++)
+    {
+        char ch = d.p[i];
+        unsigned digit;
+
+        if (ch >= '0' && ch <= '9')
+            digit = ch - '0';
+        else if (ch >= 'a' && ch <= 'f')
+            digit = ch - 'a' + 10;
+        else if (ch >= 'A' && ch <= 'F')
+            digit = ch - 'A' + 10;
+        else
+            json_error(d, "invalid unicode escape");
+
+        cp = cp * 16 + digit;
+    }
+
+    d.p += 4;
+    return cp;
+}
+
+static void json_addutf8(luaL_Strbuf* b, unsigned cp)
+{
+    char buf[4];
+    int len;
+
+    if (cp < 0x80)
+    {
+        buf[0] = char(cp);
+        len = 1;
+    }
+    else if (cp < 0x800)
+    {
+        buf[0] = char(0xc0 | (cp >> 6));
+        buf[1] = char(0x80 | (cp & 0x3f));
+        len = 2;
+    }
+    else if (cp < 0x10000)
+    {
+        buf[0] = char(0xe0 | (cp >> 12));
+        buf[1] = char(0x80 | ((cp >> 6) & 0x3f));
+        buf[2] = char(0x80 | (cp & 0x3f));
+        len = 3;
+    }
+    else
+    {
+        buf[0] = char(0xf0 | (cp >> 18));
+        buf[1] = char(0x80 | ((cp >> 12) & 0x3f));
+        buf[2] = char(0x80 | ((cp >> 6) & 0x3f));
+        buf[3] = char(0x80 | (cp & 0x3f));
+        len = 4;
+    }
+
+    luaL_addlstring(b, buf, len);
+}
+
+static void json_decodeescape(JsonDecoder& d, luaL_Strbuf* b)
+{
+    if (d.p == d.end)
+        json_error(d, "unterminated string");
+
+    switch (*d.p++)
+    {
+    case '"':
+        luaL_addchar(b, '"');
+        break;
+    case '\\':
+        luaL_addchar(b, '\\');
+        break;
+    case '/':
+        luaL_addchar(b, '/');
+        break;
+    case 'b':
+        luaL_addchar(b, '\b');
+        break;
+    case 'f':
+        luaL_addchar(b, '\f');
+        break;
+    case 'n':
+        luaL_addchar(b, '\n');
+        break;
+    case 'r':
+        luaL_addchar(b, '\r');
+        break;
+    case 't':
+        luaL_addchar(b, '\t');
+        break;
+    case 'u':
+    {
+        unsigned cp = json_decodehex4(d);
+
+        // code points outside of the basic multilingual plane are escaped as surrogate pairs
+        if (cp >= 0xd800 && cp <= 0xdbff)
+        {
+            if (d.end - d.p < 2 || d.p[0] != '\\' || d.p[1] != 'u')
+                json_error(d, "invalid unicode escape");
+
+            d.p += 2;
+
+            unsigned low = json_decodehex4(d);
+
+            if (low < 0xdc00 || low > 0xdfff)
+                json_error(d, "invalid unicode escape");
+
+            cp = 0x10000 + ((cp - 0xd800) << 10) + (low - 0xdc00);
+        }
+        else if (cp >= 0xdc00 && cp <= 0xdfff)
+        {
+            json_error(d, "invalid unicode escape");
+        }
+
+        json_addutf8(b, cp);
+        break;
+    }
+    default:
+        d.p--;
+        json_error(d, "invalid escape sequence");
+    }
+}
+
+static void json_decodestring(JsonDecoder& d)
+{
+    LUAU_ASSERT(*d.p == '"');
+    d.p++;
+
+    const char* start = d.p;
+    const char* run = json_skipplain(d.p, d.end);
+
+    // most strings don't have escapes and can be created directly from the input
+    if (run < d.end && *run == '"')
+    {
+        lua_pushlstring(d.L, start, run - start);
+        d.p = run + 1;
+        return;
+    }
+
+    luaL_Strbuf b;
+    luaL_buffinit(d.L, &b);
+    luaL_addlstring(&b, start, run - start);
+    d.p = run;
+
+    for (;;)
+    {
+        if (d.p == d.end)
+            json_error(d, "unterminated string");
+
+        char ch = *d.p;
+
+        if (ch == '"')
+        {
+            d.p++;
+            break;
+        }
+        else if (ch == '\\')
+        {
+            d.p++;
+            json_decodeescape(d, &b);
+        }
+        else if ((unsigned char)ch < 0x20)
+        {
+            json_error(d, "control character in string");
+        }
+        else
+        {
+            run = json_skipplain(d.p, d.end);
+            luaL_addlstring(&b, d.p, run - d.p);
+            d.p = run;
+        }
+    }
+
+    luaL_pushresult(&b);
+}
+
+static void json_decodevalue(JsonDecoder& d, int depth);
+
+// reads the separator after an array element or an object member; returns true if the closing character was reached
+static bool json_nextitem(JsonDecoder& d, char close)
+{
+    json_skipspace(d);
+
+    if (d.p < d.end && *d.p == ',')
+    {
+        d.p++;
+        return false;
+    }
+
+    if (d.p < d.end && *d.p == close)
+    {
+        d.p++;
+        return true;
+    }
+
+    json_error(d, close == ']' ? "expected ',' or ']'" : "expected ',' or '}'");
+}
+
+static void json_decodearray(JsonDecoder& d, int depth)
+{
+    lua_State* L = d.L;
+
+    if (depth >= JSON_MAXDEPTH)
+        json_error(d, "nesting is too deep");
+
+    luaL_checkstack(L, JSON_BATCH + 1, "nesting is too deep");
+
+    d.p++;
+    json_skipspace(d);
+
+    if (d.p < d.end && *d.p == ']')
+    {
+        d.p++;
+        lua_createtable(L, 0, 0);
+        return;
+    }
+
+    bool hastable = false;
+    int pending = 0;
+    int stored = 0;
+
+    for (;;)
+    {
+        json_decodevalue(d, depth + 1);
+        pending++;
+
+        bool last = json_nextitem(d, ']');
+
+        if (last || pending == JSON_BATCH)
+        {
+            if (!hastable)
+            {
+                lua_createtable(L, pending, 0);
+                lua_insert(L, -(pending + 1));
+                hastable = true;
+            }
+
+            for (int i = pending; i >= 1; i--)
+                lua_rawseti(L, -(i + 1), stored + i);
+
+            stored += pending;
+            pending = 0;
+
+            if (last)
+                break;
+        }
+    }
+}
+
+static void json_decodeobject(JsonDecoder& d, int depth)
+{
+    lua_State* L = d.L;
+
+    if (depth >= JSON_MAXDEPTH)
+        json_error(d, "nesting is too deep");
+
+    // pending members and the table, with room to copy one member when storing it
+    luaL_checkstack(L, JSON_BATCH * 2 + 3, "nesting is too deep");
+
+    d.p++;
+    json_skipspace(d);
+
+    if (d.p < d.end && *d.p == '}')
+    {
+        d.p++;
+        lua_createtable(L, 0, 0);
+        return;
+    }
+
+    bool hastable = false;
+    int pending = 0;
+
+    for (;;)
+    {
+        json_skipspace(d);
+
+        if (d.p == d.end || *d.p != '"')
+            json_error(d, "expected string key");
+
+        json_decodestring(d);
+        json_skipspace(d);
+
+        if (d.p == d.end || *d.p != ':')
+            json_error(d, "expected ':'");
+
+        d.p++;
+
+        json_decodevalue(d, depth + 1);
+        pending++;
+
+        bool last = json_nextitem(d, '}');
+
+        if (last || pending == JSON_BATCH)
+        {
+            if (!hastable)
+            {
+                lua_createtable(L, 0, pending);
+                lua_insert(L, -(pending * 2 + 1));
+                hastable = true;
+            }
+
+            // members are stored in order so that the last of the duplicate keys wins
+            int t = lua_gettop(L) - pending * 2;
+
+            for (int i = 0; i < pending; i++)
+            {
+                lua_pushvalue(L, t + i * 2 + 1);
+                lua_pushvalue(L, t + i * 2 + 2);
+                lua_rawset(L, t);
+            }
+
+            lua_settop(L, t);
+            pending = 0;
+
+            if (last)
+                break;
+        }
+    }
+}
+
+static void json_decodevalue(JsonDecoder& d, int depth)
+{
+    json_skipspace(d);
+
+    if (d.p == d.end)
+        json_error(d, "unexpected end of input");
+
+    switch (*d.p)
+    {
+    case '{':
+        json_decodeobject(d, depth);
+        break;
+    case '[':
+        json_decodearray(d, depth);
+        break;
+    case '"':
+        json_decodestring(d);
+        break;
+    case 't':
+        json_expectliteral(d, "true", 4);
+        lua_pushboolean(d.L, true);
+        break;
+    case 'f':
+        json_expectliteral(d, "false", 5);
+        lua_pushboolean(d.L, false);
+        break;
+    case 'n':
+        json_expectliteral(d, "null", 4);
+        lua_pushnil(d.L);
+        break;
+    case '-':
+    case '0':
+    case '1':
+    case '2':
+    case '3':
+    case '4':
+    case '5':
+    case '6':
+    case '7':
+    case '8':
+    case '9':
+        json_decodenumber(d);
+        break;
+    default:
+        json_error(d, "unexpected character");
+    }
+}
+
+static int json_decode(lua_State* L)
+{
+    size_t len = 0;
+    const char* s = luaL_checklstring(L, 1, &len);
+
+    JsonDecoder d = {L, s, s, s + len};
+
+    json_decodevalue(d, 0);
+    json_skipspace(d);
+
+    if (d.p != d.end)
+        json_error(d, "unexpected character after value");
+
+    return 1;
+}
+
+static const luaL_Reg jsonlib[] = {
+    {"encode", json_encode},
+    {"decode", json_decode},
+    {NULL, NULL},
+};
+
+int luaopen_json(lua_State* L)
+{
+    luaL_register(L, LUA_JSONLIBNAME, jsonlib);
+
+    return 1;
+}
@@ -3,8 +3,19 @@
 #include "lualib.h"
 
 #include "lstate.h"
+#include "lnumutils.h"
+
+#if defined(LUAU_BIG_ENDIAN)
+#include <endian.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64)
+#include <emmintrin.h>
+#define LUAU_MATH_SSE2
+#endif
 
 #include <math.h>
+#include <string.h>
 #include <time.h>
 
 #undef PI
@@ -304,7 +315,7 @@ inline float perlin_grad(int hash, float x, float y, float z)
     return g[0] * x + g[1] * y + g[2] * z;
 }
 
-static float perlin(float x, float y, float z)
+float luai_perlin(float x, float y, float z)
 {
     float xflr = floorf(x);
     float yflr = floorf(y);
@@ -351,12 +362,260 @@ static int math_noise(lua_State* L)
     luaL_argexpected(L, ny || lua_isnoneornil(L, 2), 2, "number");
     luaL_argexpected(L, nz || lua_isnoneornil(L, 3), 3, "number");
 
-    double r = perlin((float)x, (float)y, (float)z);
+    double r = luai_perlin((float)x, (float)y, (float)z);
 
     lua_pushnumber(L, r);
     return 1;
 }
 
+// batch functions operate on ranges of float32 values stored in buffers; the same limits as in buffer library apply to offsets
+#define isoutofbounds(offset, len, accessize) (uint64_t(unsigned(offset)) + (accessize) > uint64_t(len))
+
+// values of a row are converted in chunks so that the temporary storage stays on the stack
+#define BATCH_CHUNK 256
+
+static float batch_read(const char* p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+#if defined(LUAU_BIG_ENDIAN)
+    v = htole32(v);
+#endif
+    float r;
+    memcpy(&r, &v, sizeof(r));
+    return r;
+}
+
+static void batch_write(char* p, float f)
+{
+    uint32_t v;
+    memcpy(&v, &f, sizeof(v));
+#if defined(LUAU_BIG_ENDIAN)
+    v = htole32(v);
+#endif
+    memcpy(p, &v, sizeof(v));
+}
+
+static char* batch_checkrange(lua_State* L, int arg, int offset, uint64_t count)
+{
+    size_t len = 0;
+    char* buf = (char*)luaL_checkbuffer(L, arg, &len);
+
+    if (isoutofbounds(offset, len, count * sizeof(float)))
+        luaL_error(L, "buffer access out of bounds");
+
+    return buf + offset;
+}
+
+#ifdef LUAU_MATH_SSE2
+inline __m128 perlin_fade4(__m128 t)
+{
+    __m128 t3 = _mm_mul_ps(_mm_mul_ps(t, t), t);
+    __m128 tp = _mm_add_ps(_mm_mul_ps(t, _mm_sub_ps(_mm_mul_ps(t, _mm_set1_ps(6)), _mm_set1_ps(15))), _mm_set1_ps(10));
+    return _mm_mul_ps(t3, tp);
+}
+
+inline __m128 perlin_lerp4(__m128 t, __m128 a, __m128 b)
+{
+    return _mm_add_ps(a, _mm_mul_ps(t, _mm_sub_ps(b, a)));
+}
+
+inline __m128 perlin_grad4(const float (&g)[3][4], __m128 x, __m128 y, __m128 z)
+{
+    __m128 gx = _mm_mul_ps(_mm_load_ps(g[0]), x);
+    __m128 gy = _mm_mul_ps(_mm_load_ps(g[1]), y);
+    __m128 gz = _mm_mul_ps(_mm_load_ps(g[2]), z);
+    return _mm_add_ps(_mm_add_ps(gx, gy), gz);
+}
+
+// computes noise for 4 points that share y and z coordinates, using the same operation order as the scalar version for identical results
+// returns false when x coordinates can't be floored exactly with integer conversion, in which case the scalar version has to be used
+static bool perlin4(float* out, const float* xs, int yi, int zi, float yf, float zf, float v, float w)
+{
+    __m128 x = _mm_loadu_ps(xs);
+
+    // values that are 2^23 or larger in magnitude are already integers; NaN fails the comparison as well
+    __m128 absx = _mm_andnot_ps(_mm_set1_ps(-0.0f), x);
+    if (_mm_movemask_ps(_mm_cmpnlt_ps(absx, _mm_set1_ps(8388608.0f))))
+        return false;
+
+    __m128i xt = _mm_cvttps_epi32(x);
+    __m128 xtf = _mm_cvtepi32_ps(xt);
+    __m128 xflr = _mm_sub_ps(xtf, _mm_and_ps(_mm_cmpgt_ps(xtf, x), _mm_set1_ps(1)));
+
+    __m128 xf = _mm_sub_ps(x, xflr);
+    __m128 xf1 = _mm_sub_ps(xf, _mm_set1_ps(1));
+    __m128 u = perlin_fade4(xf);
+
+    alignas(16) int xi[4];
+    _mm_store_si128((__m128i*)xi, _mm_cvttps_epi32(xflr));
+
+    // SSE2 has no gathers, so permutation lookups and gradient selection are done per lane
+    alignas(16) float g[8][3][4];
+
+    const unsigned char* p = kPerlinHash;
+
+    for (int lane = 0; lane < 4; lane++)
+    {
+        int xl = xi[lane] & 255;
+
+        int a = (p[xl] + yi) & 255;
+        int aa = (p[a] + zi) & 255;
+        int ab = (p[a + 1] + zi) & 255;
+
+        int b = (p[xl + 1] + yi) & 255;
+        int ba = (p[b] + zi) & 255;
+        int bb = (p[b + 1] + zi) & 255;
+
+        int h[8] = {p[aa], p[ba], p[ab], p[bb], p[aa + 1], p[ba + 1], p[ab + 1], p[bb + 1]};
+
+        for (int c = 0; c < 8; c++)
+            for (int k = 0; k < 3; k++)
+                g[c][k][lane] = kPerlinGrad[h[c] & 15][k];
+    }
+
+    __m128 y0 = _mm_set1_ps(yf), y1 = _mm_set1_ps(yf - 1);
+    __m128 z0 = _mm_set1_ps(zf), z1 = _mm_set1_ps(zf - 1);
+    __m128 vv = _mm_set1_ps(v), ww = _mm_set1_ps(w);
+
+    __m128 la = perlin_lerp4(u, perlin_grad4(g[0], xf, y0, z0), perlin_grad4(g[1], xf1, y0, z0));
+    __m128 lb = perlin_lerp4(u, perlin_grad4(g[2], xf, y1, z0), perlin_grad4(g[3], xf1, y1, z0));
+    __m128 la1 = perlin_lerp4(u, perlin_grad4(g[4], xf, y0, z1), perlin_grad4(g[5], xf1, y0, z1));
+    __m128 lb1 = perlin_lerp4(u, perlin_grad4(g[6], xf, y1, z1), perlin_grad4(g[7], xf1, y1, z1));
+
+    _mm_storeu_ps(out, perlin_lerp4(ww, perlin_lerp4(vv, la, lb), perlin_lerp4(vv, la1, lb1)));
+    return true;
+}
+#endif
+
+// computes noise for a row of points that share y and z coordinates
+static void perlinrow(float* out, const float* xs, int count, float y, float z)
+{
+    int i = 0;
+
+#ifdef LUAU_MATH_SSE2
+    float yflr = floorf(y);
+    float zflr = floorf(z);
+
+    int yi = int(yflr) & 255;
+    int zi = int(zflr) & 255;
+
+    float yf = y - yflr;
+    float zf = z - zflr;
+
+    float v = perlin_fade(yf);
+    float w = perlin_fade(zf);
+
+    for (; i + 4 <= count; i += 4)
+    {
+        if (!perlin4(out + i, xs + i, yi, zi, yf, zf, v, w))
+        {
+            for (int j = i; j < i + 4; j++)
+                out[j] = luai_perlin(xs[j], y, z);
+        }
+    }
+#endif
+
+    for (; i < count; i++)
+        out[i] = luai_perlin(xs[i], y, z);
+}
+
+static int math_noisegrid(lua_State* L)
+{
+    int offset = luaL_checkinteger(L, 2);
+    int sx = luaL_checkinteger(L, 3);
+    int sy = luaL_checkinteger(L, 4);
+    int sz = luaL_checkinteger(L, 5);
+    double x = luaL_checknumber(L, 6);
+    double y = luaL_checknumber(L, 7);
+    double z = luaL_checknumber(L, 8);
+    double step = luaL_optnumber(L, 9, 1.0);
+
+    luaL_argcheck(L, sx >= 0, 3, "size must be non-negative");
+    luaL_argcheck(L, sy >= 0, 4, "size must be non-negative");
+    luaL_argcheck(L, sz >= 0, 5, "size must be non-negative");
+
+    char* data = batch_checkrange(L, 1, offset, uint64_t(sx) * uint64_t(sy) * uint64_t(sz));
+
+    float xs[BATCH_CHUNK];
+    float row[BATCH_CHUNK];
+
+    // coordinates are computed in double precision to match math.noise calls with the same arguments
+    for (int k = 0; k < sz; k++)
+    {
+        for (int j = 0; j < sy; j++)
+        {
+            float fy = float(y + j * step);
+            float fz = float(z + k * step);
+
+            for (int i0 = 0; i0 < sx; i0 += BATCH_CHUNK)
+            {
+                int n = sx - i0 < BATCH_CHUNK ? sx - i0 : BATCH_CHUNK;
+
+                for (int i = 0; i < n; i++)
+                    xs[i] = float(x + (i0 + i) * step);
+
+                perlinrow(row, xs, n, fy, fz);
+
+                char* out = data + ((size_t(k) * sy + j) * sx + i0) * sizeof(float);
+
+                for (int i = 0; i < n; i++)
+                    batch_write(out + i * sizeof(float), row[i]);
+            }
+        }
+    }
+
+    return 0;
+}
+
+static int math_sqrtbuffer(lua_State* L)
+{
+    int offset = luaL_checkinteger(L, 2);
+    int count = luaL_checkinteger(L, 3);
+
+    luaL_argcheck(L, count >= 0, 3, "count must be non-negative");
+
+    char* data = batch_checkrange(L, 1, offset, unsigned(count));
+
+    int i = 0;
+
+#ifdef LUAU_MATH_SSE2
+    // sqrtps is correctly rounded, so the results match scalar computations
+    for (; i + 4 <= count; i += 4)
+    {
+        float* p = (float*)(data + i * sizeof(float));
+        _mm_storeu_ps(p, _mm_sqrt_ps(_mm_loadu_ps(p)));
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        char* p = data + i * sizeof(float);
+        batch_write(p, sqrtf(batch_read(p)));
+    }
+
+    return 0;
+}
+
+static int math_sinbuffer(lua_State* L)
+{
+    int offset = luaL_checkinteger(L, 2);
+    int count = luaL_checkinteger(L, 3);
+
+    luaL_argcheck(L, count >= 0, 3, "count must be non-negative");
+
+    char* data = batch_checkrange(L, 1, offset, unsigned(count));
+
+    // there is no vector sine instruction; computing in double precision keeps results identical to math.sin
+    for (int i = 0; i < count; i++)
+    {
+        char* p = data + i * sizeof(float);
+        batch_write(p, float(sin(double(batch_read(p)))));
+    }
+
+    return 0;
+}
+
 static int math_clamp(lua_State* L)
 {
     double v = luaL_checknumber(L, 1);
@@ -418,6 +677,9 @@ static const luaL_Reg mathlib[] = {
     {"clamp", math_clamp},
     {"sign", math_sign},
     {"round", math_round},
+    {"noisegrid", math_noisegrid},
+    {"sqrtbuffer", math_sqrtbuffer},
+    {"sinbuffer", math_sinbuffer},
     {NULL, NULL},
 };
 
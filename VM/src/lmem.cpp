@@ -67,15 +67,38 @@
  * size up to reduce the chance that we'll allocate pages that have very few allocated blocks. The size
  * class strategy is determined by SizeClassConfig constructor.
  *
+ * Pages of the standard size can be supplied by the host via lua_setpagesource instead of frealloc, for example to
+ * carve them out of large aligned regions backed by huge pages; each page remembers its source so that switching
+ * the source returns older pages to frealloc. Large single-object GCO pages always come from frealloc.
+ *
  * Note that when the last block in a page is freed, we immediately free the page with frealloc - the
  * memory manager doesn't currently attempt to keep unused memory around. This can result in excessive
- * allocation traffic and can be mitigated by adding a page cache in the future.
+ * allocation traffic and can be mitigated by adding a page cache in the future. GCO pages emptied by the
+ * sweep can be handed off to the host via lua_Callbacks::releasepages instead; since these pages are no
+ * longer reachable from allgcopages/freegcopages, they can be returned to frealloc on a helper thread.
  *
  * For both GCO and non-GCO pages, the per-page block allocation combines bump pointer style allocation
  * (lua_Page::freeNext) and per-page free list (lua_Page::freeList). We use the bump allocator to allocate
  * the contents of the page, and the free list for further reuse; this allows shorter page setup times
  * which results in less variance between allocation cost, as well as tighter sweep bounds for newly
- * allocated pages.
+ * allocated pages. When the sweep returns a block to a full GCO page, that page is queued behind the page
+ * that's currently bump allocating, so that allocation bursts carve consecutive blocks out of one page
+ * before falling back to blocks scattered across partially used pages.
+ *
+ * Objects are never moved, so a few long-lived objects can keep a nearly empty GCO page alive indefinitely
+ * when new objects keep being allocated into its free blocks. When LUA_GCSPARSEPAGE is set, pages that fall
+ * below the occupancy threshold after being carved completely are moved to a separate list
+ * (global_State::sparsegcopages) that doesn't receive new objects until the next sweep starts. This evacuates
+ * sparse pages by starvation, letting them be released once their remaining objects die; pages that are still
+ * sparse but didn't lose any objects during a cycle go back to the free list to bound the memory overhead.
+ *
+ * GCO pages of small objects reserve a block map at the end of the page, with one bit per 16 bytes of the page that
+ * is set when an allocated block starts there (8 bytes on 32-bit platforms). Since GCO blocks are never smaller, each block gets its own bit;
+ * page walks (including the sweep) test the map instead of the headers of free blocks, so that free blocks of sparse
+ * pages aren't pulled into the cache. The mark bits themselves stay in GCheader since GCO blocks can't locate their page.
+ *
+ * Pages of permanent objects (see LUA_GCFREEZE) are moved from `allgcopages' to a separate list (global_State::permgcopages)
+ * and removed from the free lists, so that the sweep never visits them and new objects are never placed into their free blocks.
  */
 
 #ifndef __has_feature
@@ -124,6 +147,9 @@ const size_t kSizeClasses = LUA_SIZECLASSES;
 const size_t kMaxSmallSize = 512;
 const size_t kPageSize = 16 * 1024 - 24; // slightly under 16KB since that results in less fragmentation due to heap metadata
 
+// GCO pages of small objects keep a block map at the end of the page; see luaM_getpageblockmap
+const size_t kBlockMapSize = (kPageSize / luaM_blockmapgranularity + 31) / 32 * sizeof(uint32_t);
+
 const size_t kBlockHeader = sizeof(double) > sizeof(void*) ? sizeof(double) : sizeof(void*); // suitable for aligning double & void* on all platforms
 const size_t kGCOLinkOffset = (sizeof(GCheader) + sizeof(void*) - 1) & ~(sizeof(void*) - 1); // GCO pages contain freelist links after the GC header
 
@@ -175,6 +201,11 @@ const SizeClassConfig kSizeClassConfig;
 #define metadata(block) (*(void**)(block))
 #define freegcolink(block) (*(void**)((char*)block + kGCOLinkOffset))
 
+// block map of a GCO page of small objects; GCO blocks are never smaller than the map granularity so each block gets its own bit
+#define blockmap(page) ((uint32_t*)((char*)(page) + kPageSize - kBlockMapSize))
+
+static_assert(kGCOLinkOffset + sizeof(void*) >= luaM_blockmapgranularity, "GCO blocks must map to separate bits");
+
 struct lua_Page
 {
     // list of pages with free blocks
@@ -192,6 +223,11 @@ struct lua_Page
     int freeNext;   // next free block offset in this page, in bytes; when negative, freeList is used instead
     int busyBlocks; // number of blocks allocated out of this page
 
+    bool young;  // page may contain objects that were allocated after the last sweep that kept the marks (see lgc.cpp)
+    bool sparse; // page is in `sparsegcopages' instead of `freegcopages', see LUA_GCSPARSEPAGE
+
+    const lua_PageSource* source; // page source that the page is returned to; NULL for pages allocated with frealloc
+
     union
     {
         char data[1];
@@ -205,13 +241,13 @@ l_noret luaM_toobig(lua_State* L)
     luaG_runerror(L, "memory allocation error: block too big");
 }
 
-static lua_Page* newpage(lua_State* L, lua_Page** gcopageset, int pageSize, int blockSize, int blockCount)
+static lua_Page* newpage(lua_State* L, lua_Page** gcopageset, int pageSize, int blockSize, int blockCount, const lua_PageSource* source)
 {
     global_State* g = L->global;
 
     LUAU_ASSERT(pageSize - int(offsetof(lua_Page, data)) >= blockSize * blockCount);
 
-    lua_Page* page = (lua_Page*)(*g->frealloc)(g->ud, NULL, 0, pageSize);
+    lua_Page* page = source ? (lua_Page*)source->allocpage(source->context, pageSize) : (lua_Page*)(*g->frealloc)(g->ud, NULL, 0, pageSize);
     if (!page)
         luaD_throw(L, LUA_ERRMEM);
 
@@ -234,6 +270,11 @@ static lua_Page* newpage(lua_State* L, lua_Page** gcopageset, int pageSize, int
     page->freeNext = (blockCount - 1) * blockSize;
     page->busyBlocks = 0;
 
+    page->young = true;
+    page->sparse = false;
+
+    page->source = source;
+
     if (gcopageset)
     {
         page->gcolistnext = *gcopageset;
@@ -245,12 +286,23 @@ static lua_Page* newpage(lua_State* L, lua_Page** gcopageset, int pageSize, int
     return page;
 }
 
+// number of blocks in a GCO page; pages of small objects reserve space for the block map
+static int getgcopageblocks(lua_Page* page)
+{
+    size_t mapSize = size_t(page->blockSize) <= kMaxSmallSize ? kBlockMapSize : 0;
+
+    return int((page->pageSize - offsetof(lua_Page, data) - mapSize) / page->blockSize);
+}
+
 static lua_Page* newclasspage(lua_State* L, lua_Page** freepageset, lua_Page** gcopageset, uint8_t sizeClass, bool storeMetadata)
 {
     int blockSize = kSizeClassConfig.sizeOfClass[sizeClass] + (storeMetadata ? kBlockHeader : 0);
-    int blockCount = (kPageSize - offsetof(lua_Page, data)) / blockSize;
+    int blockCount = (kPageSize - offsetof(lua_Page, data) - (gcopageset ? kBlockMapSize : 0)) / blockSize;
 
-    lua_Page* page = newpage(L, gcopageset, kPageSize, blockSize, blockCount);
+    lua_Page* page = newpage(L, gcopageset, kPageSize, blockSize, blockCount, L->global->pagesource);
+
+    if (gcopageset)
+        memset(blockmap(page), 0, kBlockMapSize);
 
     // prepend a page to page freelist (which is empty because we only ever allocate a new page when it is!)
     LUAU_ASSERT(!freepageset[sizeClass]);
@@ -276,12 +328,14 @@ static void freepage(lua_State* L, lua_Page** gcopageset, lua_Page* page)
     }
 
     // so long
-    (*g->frealloc)(g->ud, page, page->pageSize, 0);
+    if (const lua_PageSource* source = page->source)
+        source->freepage(source->context, page, page->pageSize);
+    else
+        (*g->frealloc)(g->ud, page, page->pageSize, 0);
 }
 
-static void freeclasspage(lua_State* L, lua_Page** freepageset, lua_Page** gcopageset, lua_Page* page, uint8_t sizeClass)
+static void unlinkpage(lua_Page** freepageset, lua_Page* page, int sizeClass)
 {
-    // remove page from freelist
     if (page->next)
         page->next->prev = page->prev;
 
@@ -290,9 +344,41 @@ static void freeclasspage(lua_State* L, lua_Page** freepageset, lua_Page** gcopa
     else if (freepageset[sizeClass] == page)
         freepageset[sizeClass] = page->next;
 
+    page->prev = NULL;
+    page->next = NULL;
+}
+
+static void freeclasspage(lua_State* L, lua_Page** freepageset, lua_Page** gcopageset, lua_Page* page, uint8_t sizeClass)
+{
+    // remove page from freelist
+    unlinkpage(freepageset, page, sizeClass);
+
     freepage(L, gcopageset, page);
 }
 
+// same as freeclasspage, but instead of freeing the page it's moved to a release list which can be freed later with luaM_freepages
+static void releaseclasspage(lua_State* L, lua_Page** freepageset, lua_Page** gcopageset, lua_Page* page, uint8_t sizeClass)
+{
+    global_State* g = L->global;
+
+    // remove page from freelist
+    unlinkpage(freepageset, page, sizeClass);
+
+    // remove page from alllist
+    if (page->gcolistnext)
+        page->gcolistnext->gcolistprev = page->gcolistprev;
+
+    if (page->gcolistprev)
+        page->gcolistprev->gcolistnext = page->gcolistnext;
+    else if (*gcopageset == page)
+        *gcopageset = page->gcolistnext;
+
+    // the page isn't reachable from the allocator anymore, so the free list link can be reused for the release list
+    page->prev = NULL;
+    page->next = g->releasegcopages;
+    g->releasegcopages = page;
+}
+
 static void* newblock(lua_State* L, int sizeClass)
 {
     global_State* g = L->global;
@@ -374,6 +460,11 @@ static void* newgcoblock(lua_State* L, int sizeClass)
         page->busyBlocks++;
     }
 
+    size_t bit = luaM_blockmapbit(page, block);
+    blockmap(page)[bit / 32] |= 1u << (bit % 32);
+
+    page->young = true;
+
     // if we allocate the last block out of a page, we need to remove it from free list
     if (!page->freeList && page->freeNext < 0)
     {
@@ -438,29 +529,88 @@ static void freegcoblock(lua_State* L, int sizeClass, void* block, lua_Page* pag
         LUAU_ASSERT(!page->prev);
         LUAU_ASSERT(!page->next);
 
-        page->next = g->freegcopages[sizeClass];
-        if (page->next)
-            page->next->prev = page;
-        g->freegcopages[sizeClass] = page;
+        lua_Page* head = g->freegcopages[sizeClass];
+
+        // if the first page still has untouched space, keep bump allocating from it and reuse the block after it's exhausted
+        if (head && head->freeNext >= 0)
+        {
+            page->prev = head;
+            page->next = head->next;
+            if (page->next)
+                page->next->prev = page;
+            head->next = page;
+        }
+        else
+        {
+            page->next = head;
+            if (page->next)
+                page->next->prev = page;
+            g->freegcopages[sizeClass] = page;
+        }
     }
 
     // when separate block metadata is not used, free list link is stored inside the block data itself
     freegcolink(block) = page->freeList;
     page->freeList = block;
 
+    size_t bit = luaM_blockmapbit(page, block);
+    blockmap(page)[bit / 32] &= ~(1u << (bit % 32));
+
     ASAN_POISON_MEMORY_REGION((char*)block + sizeof(GCheader), page->blockSize - sizeof(GCheader));
 
     page->busyBlocks--;
 
+    lua_Page** freepageset = page->sparse ? g->sparsegcopages : g->freegcopages;
+
     // if it's the last block in the page, we don't need the page
     if (page->busyBlocks == 0)
-        freeclasspage(L, g->freegcopages, &g->allgcopages, page, sizeClass);
+    {
+        if (g->releasegcodeferred)
+            releaseclasspage(L, freepageset, &g->allgcopages, page, sizeClass);
+        else
+            freeclasspage(L, freepageset, &g->allgcopages, page, sizeClass);
+    }
+    else if (g->gcsparsepage && !page->sparse && page->freeNext < 0)
+    {
+        int blockCount = getgcopageblocks(page);
+
+        // pages that were carved completely and fell below the occupancy threshold stop receiving new objects so that they can drain
+        if (page->busyBlocks * 100 < blockCount * g->gcsparsepage)
+        {
+            unlinkpage(g->freegcopages, page, sizeClass);
+
+            page->next = g->sparsegcopages[sizeClass];
+            if (page->next)
+                page->next->prev = page;
+            g->sparsegcopages[sizeClass] = page;
+
+            page->sparse = true;
+        }
+    }
+}
+
+// enforces the limits of a memory category before it grows by `size` bytes; category 0 is used by the VM itself and can't be limited
+static void checkmemcatlimit(lua_State* L, uint8_t memcat, size_t size)
+{
+    global_State* g = L->global;
+    MemcatStats* stats = g->memcatstats;
+
+    size_t bytes = g->memcatbytes[memcat];
+
+    if (stats->hardlimit[memcat] && bytes + size > stats->hardlimit[memcat])
+        luaD_throw(L, LUA_ERRMEM);
+
+    if (stats->softlimit[memcat] && bytes <= stats->softlimit[memcat] && bytes + size > stats->softlimit[memcat] && g->cb.memcatlimit)
+        g->cb.memcatlimit(L, memcat, bytes + size);
 }
 
 void* luaM_new_(lua_State* L, size_t nsize, uint8_t memcat)
 {
     global_State* g = L->global;
 
+    if (LUAU_UNLIKELY(g->memcatstats != NULL) && memcat != 0)
+        checkmemcatlimit(L, memcat, nsize);
+
     int nclass = sizeclass(nsize);
 
     void* block = nclass >= 0 ? newblock(L, nclass) : (*g->frealloc)(g->ud, NULL, 0, nsize);
@@ -480,6 +630,9 @@ GCObject* luaM_newgco_(lua_State* L, size_t nsize, uint8_t memcat)
 
     global_State* g = L->global;
 
+    if (LUAU_UNLIKELY(g->memcatstats != NULL) && memcat != 0)
+        checkmemcatlimit(L, memcat, nsize);
+
     int nclass = sizeclass(nsize);
 
     void* block = NULL;
@@ -490,7 +643,7 @@ GCObject* luaM_newgco_(lua_State* L, size_t nsize, uint8_t memcat)
     }
     else
     {
-        lua_Page* page = newpage(L, &g->allgcopages, offsetof(lua_Page, data) + int(nsize), int(nsize), 1);
+        lua_Page* page = newpage(L, &g->allgcopages, offsetof(lua_Page, data) + int(nsize), int(nsize), 1, NULL);
 
         block = &page->data;
         ASAN_UNPOISON_MEMORY_REGION(block, page->blockSize);
@@ -505,6 +658,9 @@ GCObject* luaM_newgco_(lua_State* L, size_t nsize, uint8_t memcat)
     g->totalbytes += nsize;
     g->memcatbytes[memcat] += nsize;
 
+    if (LUAU_UNLIKELY(g->heapsamplerate != 0))
+        luaG_heapsample(L, (GCObject*)block, nsize, memcat);
+
     return (GCObject*)block;
 }
 
@@ -529,6 +685,11 @@ void luaM_freegco_(lua_State* L, GCObject* block, size_t osize, uint8_t memcat,
     global_State* g = L->global;
     LUAU_ASSERT((osize == 0) == (block == NULL));
 
+    if (LUAU_UNLIKELY(g->heapsamplecount != 0))
+        luaG_heapunsample(g, block);
+
+    g->gcofrees++;
+
     int oclass = sizeclass(osize);
 
     if (oclass >= 0)
@@ -555,6 +716,9 @@ void* luaM_realloc_(lua_State* L, void* block, size_t osize, size_t nsize, uint8
     global_State* g = L->global;
     LUAU_ASSERT((osize == 0) == (block == NULL));
 
+    if (LUAU_UNLIKELY(g->memcatstats != NULL) && memcat != 0 && nsize > osize)
+        checkmemcatlimit(L, memcat, nsize - osize);
+
     int nclass = sizeclass(nsize);
     int oclass = sizeclass(osize);
     void* result;
@@ -589,7 +753,7 @@ void* luaM_realloc_(lua_State* L, void* block, size_t osize, size_t nsize, uint8
 
 void luaM_getpagewalkinfo(lua_Page* page, char** start, char** end, int* busyBlocks, int* blockSize)
 {
-    int blockCount = (page->pageSize - offsetof(lua_Page, data)) / page->blockSize;
+    int blockCount = getgcopageblocks(page);
 
     LUAU_ASSERT(page->freeNext >= -page->blockSize && page->freeNext <= (blockCount - 1) * page->blockSize);
 
@@ -601,11 +765,124 @@ void luaM_getpagewalkinfo(lua_Page* page, char** start, char** end, int* busyBlo
     *blockSize = page->blockSize;
 }
 
+const uint32_t* luaM_getpageblockmap(lua_Page* page)
+{
+    return size_t(page->blockSize) <= kMaxSmallSize ? blockmap(page) : NULL;
+}
+
+void luaM_freepages(lua_Alloc f, void* ud, lua_Page* pages)
+{
+    while (pages)
+    {
+        lua_Page* next = pages->next;
+
+        // so long
+        if (const lua_PageSource* source = pages->source)
+            source->freepage(source->context, pages, pages->pageSize);
+        else
+            f(ud, pages, pages->pageSize, 0);
+
+        pages = next;
+    }
+}
+
+void luaM_restoresparsepages(lua_State* L)
+{
+    global_State* g = L->global;
+
+    for (int i = 0; i < LUA_SIZECLASSES; ++i)
+    {
+        lua_Page* sparse = g->sparsegcopages[i];
+
+        if (!sparse)
+            continue;
+
+        for (lua_Page* page = sparse; page; page = page->next)
+            page->sparse = false;
+
+        // sparse pages go behind the other pages with free blocks
+        lua_Page* tail = g->freegcopages[i];
+
+        if (tail)
+        {
+            while (tail->next)
+                tail = tail->next;
+
+            tail->next = sparse;
+            sparse->prev = tail;
+        }
+        else
+        {
+            g->freegcopages[i] = sparse;
+        }
+
+        g->sparsegcopages[i] = NULL;
+    }
+}
+
 lua_Page* luaM_getnextgcopage(lua_Page* page)
 {
     return page->gcolistnext;
 }
 
+bool luaM_isgcopageyoung(lua_Page* page)
+{
+    return page->young;
+}
+
+void luaM_setgcopageyoung(lua_Page* page, bool young)
+{
+    page->young = young;
+}
+
+void luaM_freezegcopage(lua_State* L, lua_Page* page)
+{
+    global_State* g = L->global;
+
+    // pages of large objects are never in the free lists
+    int sizeClass = sizeclass(page->blockSize);
+
+    if (sizeClass >= 0)
+        unlinkpage(page->sparse ? g->sparsegcopages : g->freegcopages, page, sizeClass);
+
+    page->sparse = false;
+
+    // remove page from alllist
+    if (page->gcolistnext)
+        page->gcolistnext->gcolistprev = page->gcolistprev;
+
+    if (page->gcolistprev)
+        page->gcolistprev->gcolistnext = page->gcolistnext;
+    else if (g->allgcopages == page)
+        g->allgcopages = page->gcolistnext;
+
+    page->gcolistprev = NULL;
+    page->gcolistnext = g->permgcopages;
+    if (page->gcolistnext)
+        page->gcolistnext->gcolistprev = page;
+    g->permgcopages = page;
+}
+
+// returns permanent pages to `allgcopages' so that their objects can be freed; only used when the state is closed
+void luaM_thawgcopages(lua_State* L)
+{
+    global_State* g = L->global;
+
+    lua_Page* tail = g->permgcopages;
+
+    if (!tail)
+        return;
+
+    while (tail->gcolistnext)
+        tail = tail->gcolistnext;
+
+    tail->gcolistnext = g->allgcopages;
+    if (g->allgcopages)
+        g->allgcopages->gcolistprev = tail;
+    g->allgcopages = g->permgcopages;
+    g->permgcopages = NULL;
+}
+
 void luaM_visitpage(lua_Page* page, void* context, bool (*visitor)(void* context, lua_Page* page, GCObject* gco))
 {
     char* start;
@@ -614,12 +891,14 @@ void luaM_visitpage(lua_Page* page, void* context, bool (*visitor)(void* context
     int blockSize;
     luaM_getpagewalkinfo(page, &start, &end, &busyBlocks, &blockSize);
 
+    const uint32_t* map = luaM_getpageblockmap(page);
+
     for (char* pos = start; pos != end; pos += blockSize)
     {
         GCObject* gco = (GCObject*)pos;
 
         // skip memory blocks that are already freed
-        if (gco->gch.tt == LUA_TNIL)
+        if (map ? !luaM_isblockused(map, page, pos) : gco->gch.tt == LUA_TNIL)
             continue;
 
         // when true is returned it means that the element was deleted
@@ -646,4 +925,7 @@ void luaM_visitgco(lua_State* L, void* context, bool (*visitor)(void* context, l
 
         curr = next;
     }
+
+    for (lua_Page* curr = g->permgcopages; curr; curr = curr->gcolistnext)
+        luaM_visitpage(curr, context, visitor);
 }
@@ -25,8 +25,24 @@ LUAI_FUNC void* luaM_realloc_(lua_State* L, void* block, size_t osize, size_t ns
 
 LUAI_FUNC l_noret luaM_toobig(lua_State* L);
 
+// block maps of GCO pages have a bit per this many bytes of the page, set for the bytes that start an allocated block
+#define luaM_blockmapgranularity (2 * sizeof(void*))
+#define luaM_blockmapbit(page, block) (size_t((char*)(block) - (char*)(page)) / luaM_blockmapgranularity)
+#define luaM_isblockused(map, page, block) ((map)[luaM_blockmapbit(page, block) / 32] & (1u << (luaM_blockmapbit(page, block) % 32)))
+
 LUAI_FUNC void luaM_getpagewalkinfo(lua_Page* page, char** start, char** end, int* busyBlocks, int* blockSize);
+// returns the map of allocated blocks for a GCO page of small objects, or NULL for pages of large objects that hold a single block
+LUAI_FUNC const uint32_t* luaM_getpageblockmap(lua_Page* page);
+LUAI_FUNC void luaM_freepages(lua_Alloc f, void* ud, lua_Page* pages);
+
+LUAI_FUNC void luaM_restoresparsepages(lua_State* L);
+
 LUAI_FUNC lua_Page* luaM_getnextgcopage(lua_Page* page);
+LUAI_FUNC bool luaM_isgcopageyoung(lua_Page* page);
+LUAI_FUNC void luaM_setgcopageyoung(lua_Page* page, bool young);
+
+LUAI_FUNC void luaM_freezegcopage(lua_State* L, lua_Page* page);
+LUAI_FUNC void luaM_thawgcopages(lua_State* L);
 
 LUAI_FUNC void luaM_visitpage(lua_Page* page, void* context, bool (*visitor)(void* context, lua_Page* page, GCObject* gco));
 LUAI_FUNC void luaM_visitgco(lua_State* L, void* context, bool (*visitor)(void* context, lua_Page* page, GCObject* gco));
@@ -66,4 +66,7 @@ LUAU_FASTMATH_END
 
 LUAI_FUNC char* luai_num2str(char* buf, double n);
 
+// 3D Perlin noise, shared between math.noise and its fastcall and native code implementations
+LUAI_FUNC float luai_perlin(float x, float y, float z);
+
 #define luai_str2num(s, p) strtod((s), (p))
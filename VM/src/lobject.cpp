@@ -8,6 +8,8 @@
 #include "ldo.h"
 #include "lnumutils.h"
 
+#include "Luau/NumberParse.h"
+
 #include <ctype.h>
 #include <string.h>
 #include <stdio.h>
@@ -80,6 +82,11 @@ int luaO_rawequalKey(const TKey* t1, const TValue* t2)
 
 int luaO_str2d(const char* s, double* result)
 {
+    // most numbers are short decimal literals that can be converted exactly without going through strtod
+    const char* fastend = Luau::parseDecimalFast(s, *result);
+    if (fastend && *fastend == '\0')
+        return 1;
+
     char* endptr;
     *result = luai_str2num(s, &endptr);
     if (endptr == s)
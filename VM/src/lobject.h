@@ -278,6 +278,8 @@ typedef struct Buffer
 {
     CommonHeader;
 
+    uint8_t external; // data references host memory, see luaB_newexternalbuffer
+
     unsigned int len;
 
     union
@@ -290,6 +292,19 @@ typedef struct Buffer
 /*
 ** Function Prototypes
 */
+
+// feedback for a NEWTABLE instruction, see lua_settablefeedback
+typedef struct TableSite
+{
+    int pc;        // position of the NEWTABLE instruction
+    int sizearray; // sizes that the last observed table created at this site has grown to
+    int sizenode;
+
+    // the last table created at this site; it's not a GC reference, so it's only observed if no GC object was freed since (see global_State::gcofrees)
+    struct Table* last;
+    size_t lastfrees;
+} TableSite;
+
 // clang-format off
 typedef struct Proto
 {
@@ -320,11 +335,17 @@ typedef struct Proto
 
     TString* debugname;
     uint8_t* debuginsn; // a copy of code[] array with just opcodes
+    const void** threadedcode; // handler address for each instruction, built when the function first runs in the threaded interpreter
 
     uint8_t* typeinfo;
 
+    TableSite* tablesites; // sorted by pc, one for each NEWTABLE instruction; allocated when the function first creates a table with feedback enabled
+
     void* userdata;
 
+    struct Table* lazychunk; // objects of the chunk the function body is decoded from, set until the body is decoded; see luau_loadlazy
+    struct Table* debugchunk; // chunk that holds encoded debug information, set until it is decoded for good; see lua_setlazydebuginfo
+
     GCObject* gclist;
 
 
@@ -333,10 +354,19 @@ typedef struct Proto
     int sizelocvars;
     int sizeupvalues;
     int sizek;
+    int sizetablesites;
     int sizelineinfo;
     int linegaplog2;
     int linedefined;
     int bytecodeid;
+    int lazyoffset; // offset of the function body (or of debug information once debugchunk is set) in the chunk bytecode
+
+    // when non-zero, function is profiled by the execution engine: entries through codeentry and loop iterations count down and
+    // 'hot' execution callback is called when the counter reaches zero
+    int hotcount;
+
+    // number of instructions executed while opcode counters were enabled, see lua_setopcodecounters
+    uint64_t execcount;
 } Proto;
 // clang-format on
 
@@ -400,6 +430,7 @@ typedef struct Closure
             lua_CFunction f;
             lua_Continuation cont;
             const char* debugname;
+            const lua_FastCall* fast; // unboxed entry point, see lua_pushfastcfunction
             TValue upvals[1];
         } c;
 
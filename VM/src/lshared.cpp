@@ -0,0 +1,353 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#include "lshared.h"
+
+#include "lapi.h"
+#include "lgc.h"
+#include "lstate.h"
+#include "lstring.h"
+#include "ltable.h"
+#include "ltm.h"
+
+#include <new>
+
+#include <string.h>
+
+#define LUA_SHAREDCHUNKSIZE (64 * 1024)
+
+// shared objects are never white, so they are never marked, swept or pointed to by write barriers
+#define sharedmarks cast_byte(bitmask(BLACKBIT) | bitmask(FIXEDBIT) | bitmask(OLDBIT) | bitmask(SHAREDBIT))
+
+static void* allocshared(lua_SharedHeap* heap, size_t size)
+{
+    size = (size + sizeof(L_Umaxalign) - 1) & ~(sizeof(L_Umaxalign) - 1);
+
+    if (size > heap->chunkleft)
+    {
+        size_t headersize = (sizeof(SharedChunk) + sizeof(L_Umaxalign) - 1) & ~(sizeof(L_Umaxalign) - 1);
+        size_t chunksize = headersize + (size > LUA_SHAREDCHUNKSIZE ? size : LUA_SHAREDCHUNKSIZE);
+
+        SharedChunk* chunk = (SharedChunk*)(*heap->frealloc)(heap->ud, NULL, 0, chunksize);
+        if (!chunk)
+            return NULL;
+
+        chunk->next = heap->chunks;
+        chunk->size = chunksize;
+        heap->chunks = chunk;
+        heap->chunkpos = (char*)chunk + headersize;
+        heap->chunkleft = chunksize - headersize;
+        heap->totalbytes += chunksize;
+    }
+
+    void* result = heap->chunkpos;
+    heap->chunkpos += size;
+    heap->chunkleft -= size;
+    return result;
+}
+
+static void freeshared(lua_SharedHeap* heap)
+{
+    lua_Alloc frealloc = heap->frealloc;
+    void* ud = heap->ud;
+
+    for (SharedChunk* chunk = heap->chunks; chunk;)
+    {
+        SharedChunk* next = chunk->next;
+        (*frealloc)(ud, chunk, chunk->size, 0);
+        chunk = next;
+    }
+
+    if (heap->strings)
+        (*frealloc)(ud, heap->strings, heap->stringssize * sizeof(TString*), 0);
+
+    heap->~lua_SharedHeap();
+    (*frealloc)(ud, heap, sizeof(lua_SharedHeap), 0);
+}
+
+TString* luaSH_findstr(lua_SharedHeap* heap, const char* str, size_t l, unsigned int h)
+{
+    for (TString* el = heap->strings[lmod(h, heap->stringssize)]; el != NULL; el = el->next)
+    {
+        if (el->len == l && memcmp(str, getstr(el), l) == 0)
+            return el;
+    }
+
+    return NULL;
+}
+
+void luaSH_release(lua_SharedHeap* heap)
+{
+    if (--heap->refs == 0)
+        freeshared(heap);
+}
+
+struct SharedBuilder
+{
+    lua_SharedHeap* heap;
+    int visited; // stack index of the table that maps source objects to their shared copies
+
+    TString* strings; // list of copied strings, chained through `next' until the string hash is built
+    int stringcount;
+};
+
+static void* getvisited(lua_State* L, SharedBuilder& b, void* source)
+{
+    lua_pushlightuserdata(L, source);
+    lua_rawget(L, b.visited);
+    void* result = lua_tolightuserdata(L, -1);
+    lua_pop(L, 1);
+    return result;
+}
+
+static void setvisited(lua_State* L, SharedBuilder& b, void* source, void* copy)
+{
+    lua_pushlightuserdata(L, source);
+    lua_pushlightuserdata(L, copy);
+    lua_rawset(L, b.visited);
+}
+
+static TString* sharestring(lua_State* L, SharedBuilder& b, TString* ts)
+{
+    if (TString* copy = (TString*)getvisited(L, b, ts))
+        return copy;
+
+    TString* copy = (TString*)allocshared(b.heap, sizestring(ts->len));
+    if (!copy)
+        return NULL;
+
+    copy->tt = LUA_TSTRING;
+    copy->marked = sharedmarks;
+    copy->memcat = 0;
+    copy->atom = ATOM_UNDEF;
+    copy->hash = ts->hash;
+    copy->len = ts->len;
+    memcpy(copy->data, ts->data, ts->len + 1);
+
+    copy->next = b.strings;
+    b.strings = copy;
+    b.stringcount++;
+
+    setvisited(L, b, ts, copy);
+    return copy;
+}
+
+static Table* sharetable(lua_State* L, SharedBuilder& b, Table* h, int depth);
+
+// copies a value that doesn't reference objects with identity-based hashes, so that hash chains of copied nodes stay valid
+static bool sharevalue(lua_State* L, SharedBuilder& b, const TValue* o, TValue* result, int depth)
+{
+    switch (ttype(o))
+    {
+    case LUA_TNIL:
+    case LUA_TBOOLEAN:
+    case LUA_TLIGHTUSERDATA:
+    case LUA_TNUMBER:
+    case LUA_TVECTOR:
+        *result = *o;
+        return true;
+    case LUA_TSTRING:
+        if (TString* ts = sharestring(L, b, tsvalue(o)))
+        {
+            *result = *o;
+            result->value.gc = obj2gco(ts);
+            return true;
+        }
+        return false;
+    case LUA_TTABLE:
+        if (Table* t = sharetable(L, b, hvalue(o), depth))
+        {
+            *result = *o;
+            result->value.gc = obj2gco(t);
+            return true;
+        }
+        return false;
+    default:
+        // functions, userdata and threads can't be shared, and buffers are mutable
+        return false;
+    }
+}
+
+static Table* sharetable(lua_State* L, SharedBuilder& b, Table* h, int depth)
+{
+    // only frozen tables without metatables can be shared
+    if (depth >= LUAI_MAXCCALLS || !(h->readonly & TABLE_FROZEN) || h->metatable)
+        return NULL;
+
+    if (Table* copy = (Table*)getvisited(L, b, h))
+        return copy;
+
+    Table* t = (Table*)allocshared(b.heap, sizeof(Table));
+    if (!t)
+        return NULL;
+
+    // trailing nils are dropped from the array part so that luaH_getn never needs to update the cached boundary
+    int sizearray = h->sizearray;
+    while (sizearray > 0 && ttisnil(&h->array[sizearray - 1]))
+        sizearray--;
+
+    t->tt = LUA_TTABLE;
+    t->marked = sharedmarks;
+    t->memcat = 0;
+    t->tmcache = 0;
+    t->readonly = TABLE_FROZEN;
+    t->safeenv = 0;
+    t->lsizenode = h->lsizenode;
+    t->nodemask8 = h->nodemask8;
+    t->sizearray = sizearray;
+    t->lastfree = h->node == &luaH_dummynode ? 0 : sizenode(h);
+    t->metatable = NULL;
+    t->array = NULL;
+    t->node = (LuaNode*)&luaH_dummynode;
+    t->gclist = NULL;
+
+    // metamethod absence is cached up front since the table can't be written to by the states that read it
+    for (int e = 0; e <= TM_EQ; e++)
+        if (ttisnil(luaH_getstr(h, L->global->tmname[e])))
+            t->tmcache |= cast_byte(1u << e);
+
+    setvisited(L, b, h, t);
+
+    if (sizearray)
+    {
+        t->array = (TValue*)allocshared(b.heap, sizearray * sizeof(TValue));
+        if (!t->array)
+            return NULL;
+
+        for (int i = 0; i < sizearray; i++)
+            if (!sharevalue(L, b, &h->array[i], &t->array[i], depth + 1))
+                return NULL;
+    }
+
+    if (h->node != &luaH_dummynode)
+    {
+        t->node = (LuaNode*)allocshared(b.heap, sizenode(h) * sizeof(LuaNode));
+        if (!t->node)
+            return NULL;
+
+        // node layout is copied as is; keys keep their hashes since strings are hashed by contents and other keys by value
+        memcpy(t->node, h->node, sizenode(h) * sizeof(LuaNode));
+
+        for (int i = 0; i < sizenode(h); i++)
+        {
+            LuaNode* n = &t->node[i];
+
+            if (ttisnil(gval(n)))
+            {
+                // keys of removed entries may reference dead objects
+                n->key.tt = LUA_TNIL;
+                n->key.value.gc = NULL;
+                continue;
+            }
+
+            TValue key;
+            getnodekey(L, &key, n);
+
+            if (iscollectable(&key) && !ttisstring(&key))
+                return NULL;
+
+            if (!sharevalue(L, b, &key, &key, depth + 1) || !sharevalue(L, b, gval(&h->node[i]), gval(n), depth + 1))
+                return NULL;
+
+            n->key.value = key.value;
+        }
+    }
+
+    return t;
+}
+
+lua_SharedHeap* lua_newsharedheap(lua_State* L, int idx)
+{
+    api_check(L, lua_istable(L, idx));
+    Table* root = hvalue(luaA_toobject(L, idx));
+
+    void* mem = (*L->global->frealloc)(L->global->ud, NULL, 0, sizeof(lua_SharedHeap));
+    if (!mem)
+        return NULL;
+
+    lua_SharedHeap* heap = new (mem) lua_SharedHeap();
+    heap->frealloc = L->global->frealloc;
+    heap->ud = L->global->ud;
+    heap->refs = 1;
+    heap->chunks = NULL;
+    heap->chunkpos = NULL;
+    heap->chunkleft = 0;
+    heap->totalbytes = 0;
+    heap->strings = NULL;
+    heap->stringssize = 0;
+    heap->root = NULL;
+
+    lua_rawcheckstack(L, 3);
+    lua_newtable(L);
+
+    SharedBuilder b = {heap, lua_gettop(L), NULL, 0};
+    heap->root = sharetable(L, b, root, 0);
+
+    lua_pop(L, 1);
+
+    int stringssize = 1;
+    while (stringssize < b.stringcount)
+        stringssize *= 2;
+
+    heap->strings = heap->root ? (TString**)(*heap->frealloc)(heap->ud, NULL, 0, stringssize * sizeof(TString*)) : NULL;
+
+    if (!heap->strings)
+    {
+        freeshared(heap);
+        return NULL;
+    }
+
+    heap->stringssize = stringssize;
+    heap->totalbytes += stringssize * sizeof(TString*);
+
+    for (int i = 0; i < stringssize; i++)
+        heap->strings[i] = NULL;
+
+    for (TString* ts = b.strings; ts;)
+    {
+        TString* next = ts->next;
+        int bucket = lmod(ts->hash, stringssize);
+        ts->next = heap->strings[bucket];
+        heap->strings[bucket] = ts;
+        ts = next;
+    }
+
+    return heap;
+}
+
+void lua_attachsharedheap(lua_State* L, lua_SharedHeap* heap)
+{
+    global_State* g = L->global;
+    api_check(L, !g->sharedheap);
+
+    // strings that were interned before the heap was attached have to be replaced with their shared copies; only the
+    // strings created with the state are allowed to exist at this point, and the ones not referenced below stay unused
+    for (int i = 0; i < TM_N; i++)
+        if (TString* ts = luaSH_findstr(heap, getstr(g->tmname[i]), g->tmname[i]->len, g->tmname[i]->hash))
+            g->tmname[i] = ts;
+
+    for (int i = 0; i < LUA_T_COUNT; i++)
+        if (TString* ts = luaSH_findstr(heap, getstr(g->ttname[i]), g->ttname[i]->len, g->ttname[i]->hash))
+            g->ttname[i] = ts;
+
+    heap->refs++;
+    g->sharedheap = heap;
+}
+
+void lua_pushsharedheap(lua_State* L)
+{
+    lua_SharedHeap* heap = L->global->sharedheap;
+    api_check(L, heap);
+
+    TValue root;
+    sethvalue(L, &root, heap->root);
+    luaA_pushobject(L, &root);
+}
+
+size_t lua_sharedheapsize(lua_SharedHeap* heap)
+{
+    return heap->totalbytes;
+}
+
+void lua_releasesharedheap(lua_SharedHeap* heap)
+{
+    luaSH_release(heap);
+}
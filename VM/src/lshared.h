@@ -0,0 +1,36 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#pragma once
+
+#include "lobject.h"
+
+#include <atomic>
+
+// chunk of memory that holds objects of a shared heap
+struct SharedChunk
+{
+    SharedChunk* next;
+    size_t size;
+};
+
+// immutable graph of tables and strings that is owned by no state and can be read by any number of states concurrently
+// objects of the shared heap are permanently black and fixed, so collectors never traverse or free them
+struct lua_SharedHeap
+{
+    lua_Alloc frealloc;
+    void* ud;
+
+    std::atomic<int> refs; // creator reference and one reference per attached state
+
+    SharedChunk* chunks;
+    char* chunkpos;
+    size_t chunkleft;
+    size_t totalbytes;
+
+    TString** strings; // interned strings of the heap, looked up before the string table of attached states
+    int stringssize;
+
+    Table* root;
+};
+
+LUAI_FUNC TString* luaSH_findstr(lua_SharedHeap* heap, const char* str, size_t l, unsigned int h);
+LUAI_FUNC void luaSH_release(lua_SharedHeap* heap);
@@ -5,10 +5,12 @@
 #include "ltable.h"
 #include "lstring.h"
 #include "lfunc.h"
+#include "ludata.h"
 #include "lmem.h"
 #include "lgc.h"
 #include "ldo.h"
 #include "ldebug.h"
+#include "lshared.h"
 
 /*
 ** Main thread combines a thread state and the global state
@@ -71,12 +73,16 @@ static void preinit_state(lua_State* L, global_State* g)
     L->gt = NULL;
     L->openupval = NULL;
     L->size_ci = 0;
+    L->stackreserve = 0;
+    L->stackgrowth = 2;
     L->nCcalls = L->baseCcalls = 0;
     L->status = 0;
     L->base_ci = L->ci = NULL;
     L->namecall = NULL;
     L->cachedslot = 0;
+    L->budget = 0;
     L->singlestep = false;
+    L->pooled = false;
     L->isactive = false;
     L->activememcat = 0;
     L->userdata = NULL;
@@ -86,16 +92,37 @@ static void close_state(lua_State* L)
 {
     global_State* g = L->global;
     luaF_close(L, L->stack); // close all upvalues for this thread
+    luaM_freearray(L, g->threadpool, g->threadpoolmax, lua_State*, 0);
+    luaM_freearray(L, g->refs, g->sizerefs, TValue, 0);
+    if (g->opcodecounts)
+        luaM_freearray(L, g->opcodecounts, LUA_OPCODECOUNT, uint64_t, 0);
+    luaM_freearray(L, g->profentries, g->profsize, ProfilerEntry, 0);
+    lua_stopheapprofiler(L);
+    if (g->memcatstats)
+        luaM_freearray(L, g->memcatstats, 1, MemcatStats, 0);
+    for (int i = 0; i < LUA_UTAG_LIMIT; i++)
+        luaM_freearray(L, g->udatafields[i], g->udatafieldcount[i], UdataField, 0);
     luaC_freeall(L);         // collect all objects
+    if (g->udatabatch)
+    {
+        luaU_flushbatches(L);
+        for (int i = 0; i < LUA_UTAG_LIMIT; i++)
+            if (g->udatabatch[i])
+                luaM_free_(L, g->udatabatch[i], sizeudatabatch(g->udatabatch[i]->size), 0);
+        luaM_freearray(L, g->udatabatch, LUA_UTAG_LIMIT, UdataBatch*, 0);
+    }
     LUAU_ASSERT(g->strt.nuse == 0);
     luaM_freearray(L, L->global->strt.hash, L->global->strt.size, TString*, 0);
+    luaM_freearray(L, L->global->strt.oldhash, L->global->strt.oldsize, TString*, 0);
     freestack(L, L);
     for (int i = 0; i < LUA_SIZECLASSES; i++)
     {
         LUAU_ASSERT(g->freepages[i] == NULL);
         LUAU_ASSERT(g->freegcopages[i] == NULL);
+        LUAU_ASSERT(g->sparsegcopages[i] == NULL);
     }
     LUAU_ASSERT(g->allgcopages == NULL);
+    LUAU_ASSERT(g->permgcopages == NULL);
     LUAU_ASSERT(g->totalbytes == sizeof(LG));
     LUAU_ASSERT(g->memcatbytes[0] == sizeof(LG));
     for (int i = 1; i < LUA_MEMORY_CATEGORIES; i++)
@@ -104,6 +131,9 @@ static void close_state(lua_State* L)
     if (L->global->ecb.close)
         L->global->ecb.close(L);
 
+    if (g->sharedheap)
+        luaSH_release(g->sharedheap);
+
     (*g->frealloc)(g->ud, L, sizeof(LG), 0);
 }
 
@@ -129,7 +159,8 @@ void luaE_freethread(lua_State* L, lua_State* L1, lua_Page* page)
     luaM_freegco(L, L1, sizeof(lua_State), L1->memcat, page);
 }
 
-void lua_resetthread(lua_State* L)
+// resets the thread state; stack and call info arrays that have grown are kept up to `maxstack' slots
+static void resetthread(lua_State* L, int maxstack)
 {
     // close upvalues before clearing anything
     luaF_close(L, L->stack);
@@ -140,20 +171,76 @@ void lua_resetthread(lua_State* L)
     ci->top = ci->base + LUA_MINSTACK;
     setnilvalue(ci->func);
     L->ci = ci;
-    if (L->size_ci != BASIC_CI_SIZE)
-        luaD_reallocCI(L, BASIC_CI_SIZE);
+    // call info array is retained in proportion to the stack
+    int maxci = stackcisize(maxstack);
+    if (L->size_ci < BASIC_CI_SIZE || L->size_ci > maxci)
+        luaD_reallocCI(L, L->size_ci < BASIC_CI_SIZE ? BASIC_CI_SIZE : maxci);
     // clear thread state
     L->status = LUA_OK;
     L->base = L->ci->base;
     L->top = L->ci->base;
     L->nCcalls = L->baseCcalls = 0;
     // clear thread stack
-    if (L->stacksize != BASIC_STACK_SIZE + EXTRA_STACK)
-        luaD_reallocstack(L, BASIC_STACK_SIZE);
+    int stacksize = L->stacksize - EXTRA_STACK;
+    if (stacksize < BASIC_STACK_SIZE || stacksize > maxstack)
+        luaD_reallocstack(L, stacksize < BASIC_STACK_SIZE ? BASIC_STACK_SIZE : maxstack);
     for (int i = 0; i < L->stacksize; i++)
         setnilvalue(L->stack + i);
 }
 
+void lua_resetthread(lua_State* L)
+{
+    resetthread(L, BASIC_STACK_SIZE);
+}
+
+int lua_releasethread(lua_State* L, lua_State* co)
+{
+    global_State* g = L->global;
+    api_check(L, co->global == g);
+    api_check(L, co != g->mainthread && co != L && !co->isactive && !co->pooled);
+
+    if (g->threadpoolsize == g->threadpoolmax)
+        return 0;
+
+    resetthread(co, g->threadpoolstack);
+    co->stackreserve = 0;
+    co->stackgrowth = 2;
+    co->budget = 0;
+    co->pooled = true;
+    g->threadpool[g->threadpoolsize++] = co;
+    return 1;
+}
+
+void lua_setthreadpool(lua_State* L, int maxthreads, int maxstacksize)
+{
+    global_State* g = L->global;
+    api_check(L, maxthreads >= 0);
+
+    // threads that no longer fit are left to the garbage collector
+    for (int i = maxthreads; i < g->threadpoolsize; i++)
+        g->threadpool[i]->pooled = false;
+
+    if (g->threadpoolsize > maxthreads)
+        g->threadpoolsize = maxthreads;
+
+    luaM_reallocarray(L, g->threadpool, g->threadpoolmax, maxthreads, lua_State*, 0);
+    g->threadpoolmax = maxthreads;
+    g->threadpoolstack = maxstacksize < BASIC_STACK_SIZE ? BASIC_STACK_SIZE : maxstacksize;
+
+    for (int i = 0; i < g->threadpoolsize; i++)
+        resetthread(g->threadpool[i], g->threadpoolstack);
+}
+
+int lua_threadpoolstats(lua_State* L, size_t* hits, size_t* misses)
+{
+    global_State* g = L->global;
+    if (hits)
+        *hits = g->threadpoolhits;
+    if (misses)
+        *misses = g->threadpoolmisses;
+    return g->threadpoolsize;
+}
+
 int lua_isthreadreset(lua_State* L)
 {
     return L->ci == L->base_ci && L->base == L->top && L->status == LUA_OK;
@@ -176,10 +263,47 @@ lua_State* lua_newstate(lua_Alloc f, void* ud)
     g->frealloc = f;
     g->ud = ud;
     g->mainthread = L;
+    g->threadpool = NULL;
+    g->threadpoolsize = 0;
+    g->threadpoolmax = 0;
+    g->threadpoolstack = BASIC_STACK_SIZE;
+    g->threadpoolhits = 0;
+    g->threadpoolmisses = 0;
+    g->sharedheap = NULL;
+    g->opcodecounts = NULL;
+    g->threadeddispatch = NULL;
+    g->coveragefirsthit = false;
+    g->tablefeedback = false;
+    g->gcofrees = 0;
+    g->interrupthandler = NULL;
+    g->interruptrequested = false;
+    g->pendingticks = 0;
+    g->lazydebuginfo = false;
+    for (i = 0; i < LUA_DEBUGCACHE; i++)
+        g->debugcache[i] = NULL;
+    g->debugcachepos = 0;
+    g->profentries = NULL;
+    g->profsize = 0;
+    g->profhead = 0;
+    g->proftail = 0;
+    g->profdropped = 0;
+    g->heapsamples = NULL;
+    g->heapsamplecount = 0;
+    g->heapsamplesize = 0;
+    g->heapsampleindex = NULL;
+    g->heapsampleindexsize = 0;
+    g->heapsamplerate = 0;
+    g->heapsamplebytes = 0;
+    g->heapsampledropped = 0;
     g->uvhead.u.open.prev = &g->uvhead;
     g->uvhead.u.open.next = &g->uvhead;
     g->GCthreshold = 0; // mark it as unfinished state
     g->registryfree = 0;
+    g->refslots = false;
+    g->refs = NULL;
+    g->sizerefs = 0;
+    g->refsused = 1;
+    g->reffree = 0;
     g->errorjmp = NULL;
     g->rngstate = 0;
     g->ptrenckey[0] = 1;
@@ -189,6 +313,9 @@ lua_State* lua_newstate(lua_Alloc f, void* ud)
     g->strt.size = 0;
     g->strt.nuse = 0;
     g->strt.hash = NULL;
+    g->strt.oldhash = NULL;
+    g->strt.oldsize = 0;
+    g->strt.rehashpos = 0;
     setnilvalue(&g->pseudotemp);
     setnilvalue(registry(L));
     g->gcstate = GCSpause;
@@ -199,29 +326,62 @@ lua_State* lua_newstate(lua_Alloc f, void* ud)
     g->gcgoal = LUAI_GCGOAL;
     g->gcstepmul = LUAI_GCSTEPMUL;
     g->gcstepsize = LUAI_GCSTEPSIZE << 10;
+    g->gcgen = false;
+    g->gcgenminor = false;
+    g->gcgensticky = false;
+    g->gcgenmajormul = LUAI_GCGENMAJORMUL;
+    g->gcgenmajorbase = 0;
+    g->gcadaptivepause = 0;
+    g->gcadaptivegoal = LUAI_GCGOAL;
+    g->gcadaptivestepsize = LUAI_GCSTEPSIZE << 10;
+    g->gcsparsepage = 0;
     for (i = 0; i < LUA_SIZECLASSES; i++)
     {
         g->freepages[i] = NULL;
         g->freegcopages[i] = NULL;
+        g->sparsegcopages[i] = NULL;
     }
     g->allgcopages = NULL;
     g->sweepgcopage = NULL;
+    g->releasegcopages = NULL;
+    g->permgcopages = NULL;
+    g->permheap = NULL;
+    g->releasegcodeferred = false;
+    g->pagesource = NULL;
+    g->udatabatch = NULL;
+    g->udatabatchpending = false;
     for (i = 0; i < LUA_T_COUNT; i++)
         g->mt[i] = NULL;
     for (i = 0; i < LUA_UTAG_LIMIT; i++)
         g->udatagc[i] = NULL;
     for (i = 0; i < LUA_LUTAG_LIMIT; i++)
         g->lightuserdataname[i] = NULL;
+    for (i = 0; i < LUA_UTAG_LIMIT; i++)
+    {
+        g->udatafields[i] = NULL;
+        g->udatafieldcount[i] = 0;
+    }
+    for (i = 0; i < LUA_USERBUILTINS; i++)
+        g->userbuiltins[i] = NULL;
     for (i = 0; i < LUA_MEMORY_CATEGORIES; i++)
         g->memcatbytes[i] = 0;
 
     g->memcatbytes[0] = sizeof(LG);
+    g->memcatstats = NULL;
 
     g->cb = lua_Callbacks();
 
     g->ecb = lua_ExecutionCallbacks();
 
     g->gcstats = GCStats();
+    g->gcsnapshot = GCHeapSnapshot();
+
+    for (i = 0; i < LUA_PATTERNCACHE; i++)
+        g->patterncache[i] = PatternCacheEntry();
+
+    for (i = 0; i < LUA_INDEXCACHE; i++)
+        g->indexcache[i] = IndexCacheEntry();
+    g->indexcacheepoch = 0;
 
 #ifdef LUAI_GCMETRICS
     g->gcmetrics = GCMetrics();
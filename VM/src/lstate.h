@@ -15,6 +15,9 @@
 
 #define BASIC_STACK_SIZE (2 * LUA_MINSTACK)
 
+// size of call info array that is kept along with a stack of `n' slots
+#define stackcisize(n) (BASIC_CI_SIZE * (n) / BASIC_STACK_SIZE < LUAI_MAXCALLS ? BASIC_CI_SIZE * (n) / BASIC_STACK_SIZE : LUAI_MAXCALLS)
+
 // clang-format off
 typedef struct stringtable
 {
@@ -22,6 +25,10 @@ typedef struct stringtable
     TString** hash;
     uint32_t nuse; // number of elements
     int size;
+
+    TString** oldhash; // bucket array that is being migrated to `hash' when the table grows
+    int oldsize;
+    int rehashpos; // buckets of `oldhash' before this position have been migrated
 } stringtable;
 // clang-format on
 
@@ -87,9 +94,64 @@ struct GCStats
     size_t endtotalsizebytes = 0;
     size_t heapgoalsizebytes = 0;
 
+    // data for estimating the amount of work left in the current cycle
+    size_t cyclework = 0;
+    size_t lastcyclework = 0;
+
     double starttimestamp = 0;
     double atomicstarttimestamp = 0;
     double endtimestamp = 0;
+
+    // data for adaptive pacing
+    double cycletime = 0; // time spent in GC steps during the current cycle
+    double workcost = 0;  // smoothed time per byte of GC work
+};
+
+// incremental heap snapshot that reports objects as they are traversed by the collector, see luaC_startheapsnapshot
+struct GCHeapSnapshot
+{
+    void* context = nullptr;
+    void (*node)(void* context, void* ptr, uint8_t tt, uint8_t memcat, size_t size, const char* name) = nullptr;
+    void (*edge)(void* context, void* from, void* to, const char* name) = nullptr;
+    void (*done)(void* context) = nullptr;
+
+    bool pending = false; // snapshot will start with the next cycle that traverses the entire heap
+    bool active = false;  // current cycle is reporting traversed objects
+};
+
+// number of compiled patterns cached by the string library, must be a power of two
+#define LUA_PATTERNCACHE 64
+
+// number of functions that keep debug information decoded on demand at a time, see lua_setlazydebuginfo
+#define LUA_DEBUGCACHE 8
+
+// number of string key lookups through chains of __index tables cached by the VM, must be a power of two
+#define LUA_INDEXCACHE 64
+
+// maximum number of __index steps that a cached lookup can take after the first __index table
+#define LUA_INDEXCACHEDEPTH 4
+
+// lookup of a string key through a chain of __index tables, see luaV_gettable
+// entries don't keep objects alive; they are removed during the atomic phase once the key or one of the tables become unreachable
+// the metatables of the chain and their __index fields are validated on every use, while insertions of new keys into the tables of the chain
+// are detected through `indexcacheepoch', which is bumped when a key is inserted into a table with cached metamethod absence
+struct IndexCacheEntry
+{
+    TString* key = nullptr;
+    uint32_t epoch = 0;
+    int depth = -1; // number of __index steps taken after the first table, or -1 for unused entries
+    int slot = -1;  // node with the key in the last table of the chain, or -1 if the key isn't present in the chain
+    Table* tables[LUA_INDEXCACHEDEPTH + 1];     // tables of the chain, starting with the first __index table
+    Table* metatables[LUA_INDEXCACHEDEPTH + 1]; // metatable of each table in the chain
+    int tmslots[LUA_INDEXCACHEDEPTH];           // node with __index in each metatable that is followed
+};
+
+// compiled pattern cached by the string library, see lstrlib.cpp
+// the entry doesn't keep the pattern alive; it is removed during the atomic phase once the pattern becomes unreachable
+struct PatternCacheEntry
+{
+    TString* pattern = nullptr;
+    Buffer* code = nullptr;
 };
 
 #ifdef LUAI_GCMETRICS
@@ -132,6 +194,11 @@ struct GCCycleMetrics
     size_t propagateagainwork = 0;
 
     size_t endtotalsizebytes = 0;
+
+    // decisions of adaptive pacing made at the end of the cycle
+    double adaptiveallocationrate = 0.0;
+    int adaptivegoal = 0;
+    int adaptivestepsize = 0;
 };
 
 struct GCMetrics
@@ -152,9 +219,98 @@ struct lua_ExecutionCallbacks
 {
     void* context;
     void (*close)(lua_State* L);                 // called when global VM state is closed
-    void (*destroy)(lua_State* L, Proto* proto); // called when function is destroyed
+    void (*destroy)(lua_State* L, Proto* proto); // called when function is destroyed (when execdata is present or function is profiled)
     int (*enter)(lua_State* L, Proto* proto);    // called when function is about to start/resume (when execdata is present), return 0 to exit VM
     void (*disable)(lua_State* L, Proto* proto); // called when function has to be switched from native to bytecode in the debugger
+    void (*enable)(lua_State* L, Proto* proto);  // called when the last breakpoint of a function disabled in the debugger is removed
+    void (*hot)(lua_State* L, Proto* proto);     // called when the profiling counter of the function reaches zero, see Proto::hotcount
+};
+
+/*
+** field of a userdata layout, see lua_setuserdatafields
+*/
+struct UdataField
+{
+    TString* name; // fixed string, compared by pointer
+    uint8_t type;
+    uint8_t readonly;
+    uint32_t offset;
+};
+
+/*
+** dead userdata records waiting for a batched destructor, see lua_setuserdatabatchdtor
+*/
+struct UdataBatch
+{
+    lua_BatchDestructor dtor;
+    int size;  // bytes recorded for each userdata
+    int count; // number of pending records
+
+    union
+    {
+        char records[1]; // LUAI_UDATABATCH records of `size' bytes
+        double align1;
+        void* align2;
+    };
+};
+
+/*
+** limits and reachability statistics of memory categories, see lua_setmemcatlimit
+*/
+struct MemcatStats
+{
+    size_t softlimit[LUA_MEMORY_CATEGORIES]; // 0 if the category has no soft limit
+    size_t hardlimit[LUA_MEMORY_CATEGORIES]; // 0 if the category has no hard limit
+    size_t marked[LUA_MEMORY_CATEGORIES];    // bytes of objects marked during the current cycle
+    size_t live[LUA_MEMORY_CATEGORIES];      // bytes of objects that were reachable at the end of the last mark phase
+};
+
+/*
+** GC state of permanent objects, kept outside of their pages so that the collector never writes into them, see LUA_GCFREEZE
+*/
+struct PermanentPage
+{
+    char* start; // first block of the page; permanent pages don't receive new objects, so the blocks never change
+    char* end;   // end of the last block
+    int blockSize;
+    int bitbase; // bit of the first block in the bitmaps of PermanentHeap, a multiple of 32
+};
+
+struct PermanentHeap
+{
+    PermanentPage* pages; // sorted by address
+    int pagecount;
+    uint32_t* rescan;     // objects modified during the mark, traversed again by the atomic phase
+    uint32_t* weak;       // weak tables traversed by the current cycle, cleared by the atomic phase
+    int words;            // size of each bitmap in 32-bit words
+    int scanpage;         // next page traversed by the mark phase; `pagecount' when there is nothing left to scan
+    bool rescanpending;   // at least one bit is set in `rescan'
+    size_t bytes;         // total size of permanent pages
+};
+
+/*
+** entry of the sampling profiler buffer; each sample is a header entry followed by its frames, innermost first
+*/
+struct ProfilerEntry
+{
+    GCObject* function; // prototype of Lua frames, closure of C frames; NULL for sample headers
+    int pc;             // index of the current instruction of Lua frames; number of frames that follow a sample header
+    int tag;            // tag of sample headers
+    unsigned weight;    // weight of sample headers
+    uint8_t native;     // frame was running native code
+};
+
+/*
+** object sampled by the heap profiler, with the call stack that allocated it, innermost first
+*/
+struct HeapSample
+{
+    GCObject* object;
+    size_t size;    // size of the object itself, excluding memory it owns
+    size_t weight;  // bytes allocated since the previous sample
+    uint8_t memcat; // memory category of the allocation
+    int depth;
+    lua_ProfilerFrame frames[LUA_HEAPPROFILERMAXDEPTH];
 };
 
 /*
@@ -185,15 +341,72 @@ typedef struct global_State
     int gcstepmul;                            // see LUAI_GCSTEPMUL
     int gcstepsize;                          // see LUAI_GCSTEPSIZE
 
+    bool gcgen;           // generational mode is enabled, see LUA_GCGEN
+    bool gcgenminor;      // current cycle is a minor collection that doesn't traverse old objects
+    bool gcgensticky;     // survivors of the current sweep keep their marks and become old
+    int gcgenmajormul;    // see LUAI_GCGENMAJORMUL
+    size_t gcgenmajorbase; // heap size at the end of the last major collection
+
+    int gcadaptivepause;    // target duration of GC steps in microseconds, 0 if adaptive pacing is disabled; see LUA_GCADAPTIVE
+    int gcadaptivegoal;     // goal set by the application; adaptive pacing only raises the goal above it
+    int gcadaptivestepsize; // step size to restore when adaptive pacing is disabled
+
+    int gcsparsepage; // occupancy percentage below which GCO pages are moved to `sparsegcopages'; 0 when disabled
+
     struct lua_Page* freepages[LUA_SIZECLASSES]; // free page linked list for each size class for non-collectable objects
     struct lua_Page* freegcopages[LUA_SIZECLASSES]; // free page linked list for each size class for collectable objects
+    struct lua_Page* sparsegcopages[LUA_SIZECLASSES]; // sparse pages with free blocks that don't receive new objects until the next sweep
     struct lua_Page* allgcopages; // page linked list with all pages for all classes
     struct lua_Page* sweepgcopage; // position of the sweep in `allgcopages'
+    struct lua_Page* releasegcopages; // pages emptied by the current sweep step, see lua_Callbacks::releasepages
+    struct lua_Page* permgcopages;    // pages of permanent objects that are neither swept nor written by the collector, see LUA_GCFREEZE
+    struct PermanentHeap* permheap;   // allocated by the first LUA_GCFREEZE
+    bool releasegcodeferred;          // emptied pages are moved to `releasegcopages' instead of being freed
+    const lua_PageSource* pagesource; // source of new standard size pages, see lua_setpagesource; NULL to use `frealloc'
 
     size_t memcatbytes[LUA_MEMORY_CATEGORIES]; // total amount of memory used by each memory category
+    struct MemcatStats* memcatstats;           // allocated by the first lua_setmemcatlimit call
 
 
     struct lua_State* mainthread;
+    struct lua_State** threadpool; // reset threads kept for reuse by lua_acquirethread, see lua_setthreadpool
+    int threadpoolsize;            // number of threads currently in `threadpool'
+    int threadpoolmax;             // capacity of `threadpool'
+    int threadpoolstack;           // largest stack size retained by pooled threads
+    size_t threadpoolhits;         // lua_acquirethread calls that reused a pooled thread
+    size_t threadpoolmisses;       // lua_acquirethread calls that had to create a new thread
+    struct lua_SharedHeap* sharedheap; // immutable heap readable by other states, see lua_attachsharedheap
+
+    uint64_t* opcodecounts; // executed instructions for each opcode when counting is enabled; execution goes through the single-step interpreter
+    const void* const* threadeddispatch; // handler table of the threaded interpreter, set once it builds Proto::threadedcode for the first time
+
+    bool coveragefirsthit; // coverage instructions are replaced with NOP on the first hit, see lua_setcoveragefirsthit
+    bool tablefeedback;    // NEWTABLE records the sizes that tables created at each site reach, see lua_settablefeedback
+
+    size_t gcofrees; // number of GC objects freed so far; memory of an object can't be reused for a different one while it stays the same
+
+    void (*interrupthandler)(lua_State* L, int gc); // called once for each lua_requestinterrupt, see lua_setinterrupthandler
+    bool interruptrequested;                        // lua_requestinterrupt was called since the handler was last called
+    int pendingticks;                               // ticks that weren't charged to a thread yet, see lua_tick
+
+    bool lazydebuginfo;                       // lazily loaded functions keep debug information encoded, see lua_setlazydebuginfo
+    struct Proto* debugcache[LUA_DEBUGCACHE]; // functions with debug information decoded on demand; entries are released in order
+    int debugcachepos;                        // entry of `debugcache' that is released next
+
+    struct ProfilerEntry* profentries; // ring buffer of the sampling profiler, see lua_startprofiler
+    int profsize;                      // capacity of `profentries'
+    uint64_t profhead;                 // position where the next entry is written; positions wrap around `profsize'
+    uint64_t proftail;                 // position of the oldest sample that hasn't been overwritten or read
+    size_t profdropped;                // samples overwritten before they were read
+
+    struct HeapSample* heapsamples; // samples of live objects of the heap profiler, see lua_startheapprofiler
+    int heapsamplecount;            // number of samples in `heapsamples'
+    int heapsamplesize;             // capacity of `heapsamples'
+    int* heapsampleindex;           // open addressing table of 1 + sample position keyed by object address; 0 marks empty slots
+    int heapsampleindexsize;        // size of `heapsampleindex', a power of two
+    size_t heapsamplerate;          // bytes between samples; 0 when the heap profiler is off
+    size_t heapsamplebytes;         // bytes allocated since the last sample
+    size_t heapsampledropped;       // samples dropped because `heapsamples' was full
     UpVal uvhead;                                    // head of double-linked list of all open upvalues
     struct Table* mt[LUA_T_COUNT];                   // metatables for basic types
     TString* ttname[LUA_T_COUNT];       // names for basic types
@@ -204,6 +417,12 @@ typedef struct global_State
     TValue registry; // registry table, used by lua_ref and LUA_REGISTRYINDEX
     int registryfree; // next free slot in registry
 
+    bool refslots; // lua_ref uses `refs' instead of the registry, see lua_setrefslots
+    TValue* refs;  // values pinned by lua_ref; free slots hold the index of the next free slot, slot 0 stands for LUA_REFNIL
+    int sizerefs;  // capacity of `refs'
+    int refsused;  // slots below this index have been handed out at least once
+    int reffree;   // first free slot, or 0 if all slots below `refsused' are in use
+
     struct lua_jmpbuf* errorjmp; // jump buffer data for longjmp-style error handling
 
     uint64_t rngstate; // PCG random number generator state
@@ -217,7 +436,21 @@ typedef struct global_State
 
     TString* lightuserdataname[LUA_LUTAG_LIMIT]; // names for tagged lightuserdata
 
+    struct UdataField* udatafields[LUA_UTAG_LIMIT]; // for each userdata tag, fields stored inline in userdata memory
+    int udatafieldcount[LUA_UTAG_LIMIT];
+
+    struct UdataBatch** udatabatch; // for each userdata tag, dead userdata records for a batched destructor; allocated on first use
+    bool udatabatchpending;         // at least one batch has pending records
+
+    const lua_FastCall* userbuiltins[LUA_USERBUILTINS]; // fast C functions called by builtin ids reserved for the host
+
     GCStats gcstats;
+    GCHeapSnapshot gcsnapshot;
+
+    PatternCacheEntry patterncache[LUA_PATTERNCACHE];
+
+    IndexCacheEntry indexcache[LUA_INDEXCACHE];
+    uint32_t indexcacheepoch; // bumped when a key is inserted into a table with cached metamethod absence, see invalidateTMcache
 
 #ifdef LUAI_GCMETRICS
     GCMetrics gcmetrics;
@@ -238,6 +471,7 @@ struct lua_State
 
     bool isactive;   // thread is currently executing, stack may be mutated without barriers
     bool singlestep; // call debugstep hook after each instruction
+    bool pooled;     // thread is stored in the thread pool and keeps its stack size
 
 
     StkId top;                                        // first free slot in the stack
@@ -255,12 +489,17 @@ struct lua_State
     int stacksize;
     int size_ci;                              // size of array `base_ci'
 
+    int stackreserve; // stack size that is allocated up front and kept when the stack is shrunk, see lua_setstackpolicy
+    int stackgrowth;  // factor by which the stack grows when it runs out of space
+
 
     unsigned short nCcalls;     // number of nested C calls
     unsigned short baseCcalls; // nested C calls when resuming coroutine
 
     int cachedslot;    // when table operations or INDEX/NEWINDEX is invoked from Luau, what is the expected slot for lookup?
 
+    int budget; // remaining execution budget in ticks; 0 if unlimited, negative once exceeded, see lua_setbudget
+
 
     Table* gt;           // table of globals
     UpVal* openupval;    // list of open upvalues in this stack
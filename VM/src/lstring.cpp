@@ -4,35 +4,83 @@
 
 #include "lgc.h"
 #include "lmem.h"
+#include "lshared.h"
 
 #include <string.h>
 
+// read 8 bytes using an unaligned load
+static uint64_t loadword(const char* str)
+{
+    uint64_t result;
+    memcpy(&result, str, 8);
+    return result;
+}
+
+// hash 32b blocks with four independent multiply-rotate lanes (xxHash64 round); long strings are dominated by the
+// latency of the hash state update, so processing lanes in parallel is several times faster than a single ARX chain
+static unsigned int hashlong(const char* str, size_t len, unsigned int seed, size_t* rest)
+{
+    const uint64_t p1 = 0x9e3779b185ebca87ull;
+    const uint64_t p2 = 0xc2b2ae3d27d4eb4full;
+    const uint64_t p3 = 0x165667b19e3779f9ull;
+
+#define rol64(x, s) ((x << s) | (x >> (64 - s)))
+#define hashround(acc, w) (acc += (w) * p2, acc = rol64(acc, 31), acc *= p1)
+
+    uint64_t s0 = seed + p1 + p2;
+    uint64_t s1 = seed + p2;
+    uint64_t s2 = seed;
+    uint64_t s3 = seed - p1;
+
+    while (len >= 32)
+    {
+        hashround(s0, loadword(str));
+        hashround(s1, loadword(str + 8));
+        hashround(s2, loadword(str + 16));
+        hashround(s3, loadword(str + 24));
+        str += 32;
+        len -= 32;
+    }
+
+    uint64_t h = rol64(s0, 1) + rol64(s1, 7) + rol64(s2, 12) + rol64(s3, 18);
+
+    while (len >= 8)
+    {
+        uint64_t w = 0;
+        hashround(w, loadword(str));
+        h ^= w;
+        h = rol64(h, 27) * p1 + p3;
+        str += 8;
+        len -= 8;
+    }
+
+    // final avalanche so that all input bits affect the low bits used for bucket selection
+    h ^= h >> 33;
+    h *= p2;
+    h ^= h >> 29;
+    h *= p3;
+    h ^= h >> 32;
+
+#undef hashround
+#undef rol64
+
+    *rest = len;
+    return unsigned(h);
+}
+
 unsigned int luaS_hash(const char* str, size_t len)
 {
     // Note that this hashing algorithm is replicated in BytecodeBuilder.cpp, BytecodeBuilder::getStringHash
-    unsigned int a = 0, b = 0;
     unsigned int h = unsigned(len);
 
-    // hash prefix in 12b chunks (using aligned reads) with ARX based hash (LuaJIT v2.1, lookup3)
+    // hash prefix in 8b words; the remaining tail of up to 7 bytes shares the byte-wise hash with short strings
     // note that we stop at length<32 to maintain compatibility with Lua 5.1
-    while (len >= 32)
+    if (len >= 32)
     {
-#define rol(x, s) ((x >> s) | (x << (32 - s)))
-#define mix(u, v, w) a ^= h, a -= rol(h, u), b ^= a, b -= rol(a, v), h ^= b, h -= rol(b, w)
-
-        // should compile into fast unaligned reads
-        uint32_t block[3];
-        memcpy(block, str, 12);
-
-        a += block[0];
-        b += block[1];
-        h += block[2];
-        mix(14, 11, 25);
-        str += 12;
-        len -= 12;
-
-#undef mix
-#undef rol
+        size_t rest;
+        h = hashlong(str, len, h, &rest);
+        str += len - rest;
+        len = rest;
     }
 
     // original Lua 5.1 hash for compatibility (exact match when len<32)
@@ -42,16 +90,15 @@ unsigned int luaS_hash(const char* str, size_t len)
     return h;
 }
 
-void luaS_resize(lua_State* L, int newsize)
+// when the table grows, buckets are migrated incrementally; every insertion migrates this many buckets, which completes
+// the migration long before the table needs to grow again
+#define LUA_STRTABREHASHSTEP 4
+
+static void rehashbuckets(TString** hash, int size, TString** newhash, int newsize, int first, int last)
 {
-    TString** newhash = luaM_newarray(L, newsize, TString*, 0);
-    stringtable* tb = &L->global->strt;
-    for (int i = 0; i < newsize; i++)
-        newhash[i] = NULL;
-    // rehash
-    for (int i = 0; i < tb->size; i++)
+    for (int i = first; i < last; i++)
     {
-        TString* p = tb->hash[i];
+        TString* p = hash[i];
         while (p)
         {                            // for each node in the list
             TString* next = p->next; // save next
@@ -62,12 +109,93 @@ void luaS_resize(lua_State* L, int newsize)
             newhash[h1] = p;
             p = next;
         }
+        hash[i] = NULL;
     }
+}
+
+static void rehashstep(lua_State* L, stringtable* tb, int count)
+{
+    LUAU_ASSERT(tb->oldhash);
+
+    int last = tb->oldsize - tb->rehashpos > count ? tb->rehashpos + count : tb->oldsize;
+    rehashbuckets(tb->oldhash, tb->oldsize, tb->hash, tb->size, tb->rehashpos, last);
+    tb->rehashpos = last;
+
+    if (tb->rehashpos == tb->oldsize)
+    {
+        luaM_freearray(L, tb->oldhash, tb->oldsize, TString*, 0);
+        tb->oldhash = NULL;
+        tb->oldsize = 0;
+        tb->rehashpos = 0;
+    }
+}
+
+// strings stay in the bucket of the old array until it's migrated, so that each string is always found in one place
+static TString** getbucket(stringtable* tb, unsigned int h)
+{
+    if (tb->oldhash)
+    {
+        int bucket = lmod(h, tb->oldsize);
+        if (bucket >= tb->rehashpos)
+            return &tb->oldhash[bucket];
+    }
+
+    return &tb->hash[lmod(h, tb->size)];
+}
+
+static TString** allocbuckets(lua_State* L, int size)
+{
+    TString** hash = luaM_newarray(L, size, TString*, 0);
+    for (int i = 0; i < size; i++)
+        hash[i] = NULL;
+    return hash;
+}
+
+void luaS_resize(lua_State* L, int newsize)
+{
+    stringtable* tb = &L->global->strt;
+
+    // finish the pending migration first so that all strings are in `hash'
+    if (tb->oldhash)
+        rehashstep(L, tb, tb->oldsize);
+
+    TString** newhash = allocbuckets(L, newsize);
+    rehashbuckets(tb->hash, tb->size, newhash, newsize, 0, tb->size);
     luaM_freearray(L, tb->hash, tb->size, TString*, 0);
     tb->size = newsize;
     tb->hash = newhash;
 }
 
+static void growtable(lua_State* L, stringtable* tb)
+{
+    if (tb->oldhash)
+        rehashstep(L, tb, tb->oldsize);
+
+    // table is only updated once the allocation succeeds, so that it stays consistent when it fails
+    TString** newhash = allocbuckets(L, tb->size * 2);
+
+    // existing strings are migrated by the following insertions, which avoids a pause proportional to the table size
+    tb->oldhash = tb->hash;
+    tb->oldsize = tb->size;
+    tb->rehashpos = 0;
+    tb->hash = newhash;
+    tb->size = tb->size * 2;
+}
+
+static void insertstr(lua_State* L, stringtable* tb, TString* ts)
+{
+    TString** bucket = getbucket(tb, ts->hash);
+    ts->next = *bucket; // chain new entry
+    *bucket = ts;
+
+    if (tb->oldhash)
+        rehashstep(L, tb, LUA_STRTABREHASHSTEP);
+
+    tb->nuse++;
+    if (tb->nuse > cast_to(uint32_t, tb->size) && tb->size <= INT_MAX / 2)
+        growtable(L, tb); // too crowded
+}
+
 static TString* newlstr(lua_State* L, const char* str, size_t l, unsigned int h)
 {
     if (l > MAXSSIZE)
@@ -82,14 +210,7 @@ static TString* newlstr(lua_State* L, const char* str, size_t l, unsigned int h)
     memcpy(ts->data, str, l);
     ts->data[l] = '\0'; // ending 0
 
-    stringtable* tb = &L->global->strt;
-    h = lmod(h, tb->size);
-    ts->next = tb->hash[h]; // chain new entry
-    tb->hash[h] = ts;
-
-    tb->nuse++;
-    if (tb->nuse > cast_to(uint32_t, tb->size) && tb->size <= INT_MAX / 2)
-        luaS_resize(L, tb->size * 2); // too crowded
+    insertstr(L, &L->global->strt, ts);
 
     return ts;
 }
@@ -114,10 +235,15 @@ TString* luaS_buffinish(lua_State* L, TString* ts)
 {
     unsigned int h = luaS_hash(ts->data, ts->len);
     stringtable* tb = &L->global->strt;
-    int bucket = lmod(h, tb->size);
+
+    if (L->global->sharedheap)
+    {
+        if (TString* el = luaSH_findstr(L->global->sharedheap, ts->data, ts->len, h))
+            return el;
+    }
 
     // search if we already have this string in the hash table
-    for (TString* el = tb->hash[bucket]; el != NULL; el = el->next)
+    for (TString* el = *getbucket(tb, h); el != NULL; el = el->next)
     {
         if (el->len == ts->len && memcmp(el->data, ts->data, ts->len) == 0)
         {
@@ -134,12 +260,7 @@ TString* luaS_buffinish(lua_State* L, TString* ts)
     ts->hash = h;
     ts->data[ts->len] = '\0'; // ending 0
     ts->atom = ATOM_UNDEF;
-    ts->next = tb->hash[bucket]; // chain new entry
-    tb->hash[bucket] = ts;
-
-    tb->nuse++;
-    if (tb->nuse > cast_to(uint32_t, tb->size) && tb->size <= INT_MAX / 2)
-        luaS_resize(L, tb->size * 2); // too crowded
+    insertstr(L, tb, ts);
 
     return ts;
 }
@@ -147,7 +268,15 @@ TString* luaS_buffinish(lua_State* L, TString* ts)
 TString* luaS_newlstr(lua_State* L, const char* str, size_t l)
 {
     unsigned int h = luaS_hash(str, l);
-    for (TString* el = L->global->strt.hash[lmod(h, L->global->strt.size)]; el != NULL; el = el->next)
+
+    // strings of the shared heap take precedence so that equal strings are always represented by the same object
+    if (L->global->sharedheap)
+    {
+        if (TString* el = luaSH_findstr(L->global->sharedheap, str, l, h))
+            return el;
+    }
+
+    for (TString* el = *getbucket(&L->global->strt, h); el != NULL; el = el->next)
     {
         if (el->len == l && (memcmp(str, getstr(el), l) == 0))
         {
@@ -164,7 +293,7 @@ static bool unlinkstr(lua_State* L, TString* ts)
 {
     global_State* g = L->global;
 
-    TString** p = &g->strt.hash[lmod(ts->hash, g->strt.size)];
+    TString** p = getbucket(&g->strt, ts->hash);
 
     while (TString* curr = *p)
     {
@@ -191,3 +320,33 @@ void luaS_free(lua_State* L, TString* ts, lua_Page* page)
 
     luaM_freegco(L, ts, sizestring(ts->len), ts->memcat, page);
 }
+
+const char* luaS_memfind(const char* s1, size_t l1, const char* s2, size_t l2)
+{
+    if (l2 == 0)
+        return s1; // empty strings are everywhere
+    else if (l2 > l1)
+        return NULL; // avoids a negative `l1'
+    else if (l2 == 1)
+        return (const char*)memchr(s1, *s2, l1); // single characters don't need a verification pass
+    else
+    {
+        // `memchr' is vectorized by all C runtimes we care about, so we use it to skip over the haystack in large
+        // strides and reject most false candidates by the last character before falling back to a full comparison
+        const char* end = s1 + (l1 - l2) + 1; // `s2' cannot be found after that
+        char last = s2[l2 - 1];
+
+        while (s1 < end)
+        {
+            const char* init = (const char*)memchr(s1, *s2, end - s1);
+            if (!init)
+                break;
+
+            if (init[l2 - 1] == last && memcmp(init + 1, s2 + 1, l2 - 2) == 0)
+                return init;
+
+            s1 = init + 1;
+        }
+        return NULL; // not found
+    }
+}
@@ -27,3 +27,5 @@ LUAI_FUNC void luaS_free(lua_State* L, TString* ts, struct lua_Page* page);
 
 LUAI_FUNC TString* luaS_bufstart(lua_State* L, size_t size);
 LUAI_FUNC TString* luaS_buffinish(lua_State* L, TString* ts);
+
+LUAI_FUNC const char* luaS_memfind(const char* s1, size_t l1, const char* s2, size_t l2);
@@ -2,6 +2,9 @@
 // This code is based on Lua 5.x implementation licensed under MIT License; see lua_LICENSE.txt for details
 #include "lualib.h"
 
+#include "lapi.h"
+#include "lgc.h"
+#include "lnumutils.h"
 #include "lstring.h"
 
 #include <ctype.h>
@@ -39,7 +42,9 @@ static int str_sub(lua_State* L)
         start = 1;
     if (end > (int)l)
         end = (int)l;
-    if (start <= end)
+    if (start == 1 && end == (int)l)
+        lua_pushvalue(L, 1); // the whole string doesn't need to be looked up again
+    else if (start <= end)
         lua_pushlstring(L, s + start - 1, end - start + 1);
     else
         lua_pushliteral(L, "");
@@ -176,12 +181,18 @@ static int str_char(lua_State* L)
 #define CAP_UNFINISHED (-1)
 #define CAP_POSITION (-2)
 
+// patterns up to this length are compiled and cached, see getpatterncode
+#define LUA_MAXPATTERNCODE 255
+
 typedef struct MatchState
 {
     int matchdepth;       // control for recursive depth (to avoid C stack overflow)
     const char* src_init; // init of source string
     const char* src_end;  // end ('\0') of source string
     const char* p_end;    // end ('\0') of pattern
+    const char* p_code;   // start of the compiled pattern string (before the anchor)
+    const uint8_t* code;  // compiled pattern or NULL
+    size_t codelen;       // length of the compiled pattern string
     lua_State* L;
     int level; // total number of captures (finished or unfinished)
     struct
@@ -214,14 +225,15 @@ static int capture_to_close(MatchState* ms)
     luaL_error(ms->L, "invalid pattern capture");
 }
 
-static const char* classend(MatchState* ms, const char* p)
+// returns the end of a single character class starting at p, or NULL if the class is malformed
+static const char* findclassend(const char* p, const char* p_end)
 {
     switch (*p++)
     {
     case L_ESC:
     {
-        if (p == ms->p_end)
-            luaL_error(ms->L, "malformed pattern (ends with '%%')");
+        if (p == p_end)
+            return NULL;
         return p + 1;
     }
     case '[':
@@ -230,9 +242,9 @@ static const char* classend(MatchState* ms, const char* p)
             p++;
         do
         { // look for a `]'
-            if (p == ms->p_end)
-                luaL_error(ms->L, "malformed pattern (missing ']')");
-            if (*(p++) == L_ESC && p < ms->p_end)
+            if (p == p_end)
+                return NULL;
+            if (*(p++) == L_ESC && p < p_end)
                 p++; // skip escapes (e.g. `%]')
         } while (*p != ']');
         return p + 1;
@@ -244,6 +256,19 @@ static const char* classend(MatchState* ms, const char* p)
     }
 }
 
+static const char* classend(MatchState* ms, const char* p)
+{
+    const char* ep = findclassend(p, ms->p_end);
+    if (!ep)
+    {
+        if (*p == L_ESC)
+            luaL_error(ms->L, "malformed pattern (ends with '%%')");
+        else
+            luaL_error(ms->L, "malformed pattern (missing ']')");
+    }
+    return ep;
+}
+
 static int match_class(int c, int cl)
 {
     int res;
@@ -316,25 +341,45 @@ static int matchbracketclass(int c, const char* p, const char* ec)
     return !sig;
 }
 
-static int singlematch(MatchState* ms, const char* s, const char* p, const char* ep)
+static int singlematchchar(int c, const char* p, const char* ep)
+{
+    switch (*p)
+    {
+    case '.':
+        return 1; // matches any char
+    case L_ESC:
+        return match_class(c, uchar(*(p + 1)));
+    case '[':
+        return matchbracketclass(c, p, ep - 1);
+    default:
+        return (uchar(*p) == c);
+    }
+}
+
+static int singlematch(MatchState* ms, const char* s, const char* p, const char* ep, const uint8_t* set)
 {
     if (s >= ms->src_end)
         return 0;
+    else if (set)
+        return (set[uchar(*s) >> 3] >> (uchar(*s) & 7)) & 1;
     else
-    {
-        int c = uchar(*s);
-        switch (*p)
-        {
-        case '.':
-            return 1; // matches any char
-        case L_ESC:
-            return match_class(c, uchar(*(p + 1)));
-        case '[':
-            return matchbracketclass(c, p, ep - 1);
-        default:
-            return (uchar(*p) == c);
-        }
-    }
+        return singlematchchar(uchar(*s), p, ep);
+}
+
+// returns the compiled character set of a single character class starting at p and the end of the class
+static const uint8_t* compiledclass(MatchState* ms, const char* p, const char** ep)
+{
+    if (!ms->code)
+        return NULL;
+
+    size_t offset = p - ms->p_code;
+    uint8_t end = ms->code[offset];
+
+    if (end == 0)
+        return NULL;
+
+    *ep = ms->p_code + end;
+    return ms->code + 2 * ms->codelen + 32 * ms->code[ms->codelen + offset];
 }
 
 static const char* matchbalance(MatchState* ms, const char* s, const char* p)
@@ -362,10 +407,10 @@ static const char* matchbalance(MatchState* ms, const char* s, const char* p)
     return NULL; // string ends out of balance
 }
 
-static const char* max_expand(MatchState* ms, const char* s, const char* p, const char* ep)
+static const char* max_expand(MatchState* ms, const char* s, const char* p, const char* ep, const uint8_t* set)
 {
     ptrdiff_t i = 0; // counts maximum expand for item
-    while (singlematch(ms, s + i, p, ep))
+    while (singlematch(ms, s + i, p, ep, set))
         i++;
     // keeps trying to match with the maximum repetitions
     while (i >= 0)
@@ -378,14 +423,14 @@ static const char* max_expand(MatchState* ms, const char* s, const char* p, cons
     return NULL;
 }
 
-static const char* min_expand(MatchState* ms, const char* s, const char* p, const char* ep)
+static const char* min_expand(MatchState* ms, const char* s, const char* p, const char* ep, const uint8_t* set)
 {
     for (;;)
     {
         const char* res = match(ms, s, ep + 1);
         if (res != NULL)
             return res;
-        else if (singlematch(ms, s, p, ep))
+        else if (singlematch(ms, s, p, ep, set))
             s++; // try with one more repetition
         else
             return NULL;
@@ -528,10 +573,13 @@ init: // using goto's to optimize tail recursion
         }
         default:
         dflt:
-        {                                     // pattern class plus optional suffix
-            const char* ep = classend(ms, p); // points to optional suffix
+        { // pattern class plus optional suffix
+            const char* ep;
+            const uint8_t* set = compiledclass(ms, p, &ep);
+            if (!set)
+                ep = classend(ms, p); // points to optional suffix
             // does not match at least once?
-            if (!singlematch(ms, s, p, ep))
+            if (!singlematch(ms, s, p, ep, set))
             {
                 if (*ep == '*' || *ep == '?' || *ep == '-')
                 { // accept empty?
@@ -561,10 +609,10 @@ init: // using goto's to optimize tail recursion
                     s++;  // 1 match already done
                           // go through
                 case '*': // 0 or more repetitions
-                    s = max_expand(ms, s, p, ep);
+                    s = max_expand(ms, s, p, ep, set);
                     break;
                 case '-': // 0 or more repetitions (minimum)
-                    s = min_expand(ms, s, p, ep);
+                    s = min_expand(ms, s, p, ep, set);
                     break;
                 default: // no suffix
                     s++;
@@ -580,32 +628,6 @@ init: // using goto's to optimize tail recursion
     return s;
 }
 
-static const char* lmemfind(const char* s1, size_t l1, const char* s2, size_t l2)
-{
-    if (l2 == 0)
-        return s1; // empty strings are everywhere
-    else if (l2 > l1)
-        return NULL; // avoids a negative `l1'
-    else
-    {
-        const char* init; // to search for a `*s2' inside `s1'
-        l2--;             // 1st char will be checked by `memchr'
-        l1 = l1 - l2;     // `s2' cannot be found after that
-        while (l1 > 0 && (init = (const char*)memchr(s1, *s2, l1)) != NULL)
-        {
-            init++; // 1st char is already checked
-            if (memcmp(init, s2 + 1, l2) == 0)
-                return init - 1;
-            else
-            { // correct `l1' and `s1' to try again
-                l1 -= init - s1;
-                s1 = init;
-            }
-        }
-        return NULL; // not found
-    }
-}
-
 static void push_onecapture(MatchState* ms, int i, const char* s, const char* e)
 {
     if (i >= ms->level)
@@ -657,6 +679,136 @@ static void prepstate(MatchState* ms, lua_State* L, const char* s, size_t ls, co
     ms->src_init = s;
     ms->src_end = s + ls;
     ms->p_end = p + lp;
+    ms->p_code = NULL;
+    ms->code = NULL;
+    ms->codelen = 0;
+}
+
+// records the class ends of all single character classes reachable from p in the same order as `match' visits them
+static int compileitems(const char* p_init, const char* p, const char* p_end, uint8_t* ends)
+{
+    int count = 0;
+
+    while (p < p_end)
+    {
+        if (*p == '(')
+        {
+            p += (*(p + 1) == ')') ? 2 : 1;
+            continue;
+        }
+        else if (*p == ')')
+        {
+            p++;
+            continue;
+        }
+        else if (*p == '$' && p + 1 == p_end)
+            break;
+        else if (*p == L_ESC && *(p + 1) == 'b')
+        {
+            if (p + 2 >= p_end - 1)
+                break; // malformed pattern is reported by `match'
+            p += 4;
+            continue;
+        }
+        else if (*p == L_ESC && *(p + 1) == 'f')
+        {
+            p += 2;
+            const char* ep = (*p == '[') ? findclassend(p, p_end) : NULL;
+            if (!ep)
+                break; // malformed pattern is reported by `match'
+            p = ep;
+            continue;
+        }
+        else if (*p == L_ESC && isdigit(uchar(*(p + 1))))
+        {
+            p += 2;
+            continue;
+        }
+
+        // single character class plus optional suffix
+        const char* ep = findclassend(p, p_end);
+        if (!ep)
+            break; // malformed pattern is reported by `match'
+
+        if (ends[p - p_init] == 0)
+        {
+            ends[p - p_init] = uint8_t(ep - p_init);
+            count++;
+        }
+
+        p = (*ep == '*' || *ep == '?' || *ep == '-' || *ep == '+') ? ep + 1 : ep;
+    }
+
+    return count;
+}
+
+// the compiled pattern stores, for every pattern offset that starts a single character class, the offset of the class
+// end (0 if the offset doesn't start a class), the index of the class character set and the 256-bit sets themselves
+// compiled patterns are cached by pattern string, and the code buffer is pushed on the stack to keep it alive
+static const uint8_t* getpatterncode(lua_State* L, int idx)
+{
+    TString* ts = tsvalue(luaA_toobject(L, idx));
+    size_t lp = ts->len;
+
+    if (lp > LUA_MAXPATTERNCODE)
+        return NULL;
+
+    global_State* g = L->global;
+    PatternCacheEntry& e = g->patterncache[ts->hash & (LUA_PATTERNCACHE - 1)];
+
+    if (e.pattern == ts)
+    {
+        TValue v;
+        setbufvalue(L, &v, e.code);
+        luaA_pushobject(L, &v);
+        return (const uint8_t*)e.code->data;
+    }
+
+    const char* p = getstr(ts);
+    const char* p_end = p + lp;
+
+    uint8_t ends[LUA_MAXPATTERNCODE] = {};
+    int count = compileitems(p, p, p_end, ends);
+
+    // find/match/gsub skip the anchor while gmatch matches it literally
+    if (*p == '^')
+        count += compileitems(p, p + 1, p_end, ends);
+
+    uint8_t* code = (uint8_t*)lua_newbuffer(L, 2 * lp + 32 * count);
+    int index = 0;
+
+    for (size_t i = 0; i < lp; i++)
+    {
+        if (ends[i] == 0)
+            continue;
+
+        code[i] = ends[i];
+        code[lp + i] = uint8_t(index);
+
+        uint8_t* set = code + 2 * lp + 32 * index;
+
+        for (int c = 0; c < 256; c++)
+            if (singlematchchar(c, p + i, p + ends[i]))
+                set[c >> 3] |= uint8_t(1 << (c & 7));
+
+        index++;
+    }
+
+    LUAU_ASSERT(index == count);
+
+    e.pattern = ts;
+    e.code = bufvalue(luaA_toobject(L, -1));
+    return code;
+}
+
+static void prepcode(MatchState* ms, lua_State* L, int idx)
+{
+    if (const uint8_t* code = getpatterncode(L, idx))
+    {
+        ms->p_code = svalue(luaA_toobject(L, idx));
+        ms->code = code;
+        ms->codelen = ms->p_end - ms->p_code;
+    }
 }
 
 static void reprepstate(MatchState* ms)
@@ -682,7 +834,7 @@ static int str_find_aux(lua_State* L, int find)
     if (find && (lua_toboolean(L, 4) || nospecials(p, lp)))
     {
         // do a plain search
-        const char* s2 = lmemfind(s + init - 1, ls - init + 1, p, lp);
+        const char* s2 = luaS_memfind(s + init - 1, ls - init + 1, p, lp);
         if (s2)
         {
             lua_pushinteger(L, (int)(s2 - s + 1));
@@ -701,6 +853,7 @@ static int str_find_aux(lua_State* L, int find)
             lp--; // skip anchor character
         }
         prepstate(&ms, L, s, ls, p, lp);
+        prepcode(&ms, L, 2);
         do
         {
             const char* res;
@@ -740,6 +893,7 @@ static int gmatch_aux(lua_State* L)
     const char* p = lua_tolstring(L, lua_upvalueindex(2), &lp);
     const char* src;
     prepstate(&ms, L, s, ls, p, lp);
+    prepcode(&ms, L, lua_upvalueindex(2));
     for (src = s + (size_t)lua_tointeger(L, lua_upvalueindex(3)); src <= ms.src_end; src++)
     {
         const char* e;
@@ -845,13 +999,14 @@ static int str_gsub(lua_State* L)
     MatchState ms;
     luaL_Strbuf b;
     luaL_argexpected(L, tr == LUA_TNUMBER || tr == LUA_TSTRING || tr == LUA_TFUNCTION || tr == LUA_TTABLE, 3, "string/function/table");
-    luaL_buffinit(L, &b);
     if (anchor)
     {
         p++;
         lp--; // skip anchor character
     }
     prepstate(&ms, L, src, srcl, p, lp);
+    prepcode(&ms, L, 2);
+    luaL_buffinit(L, &b);
     while (n < max_s)
     {
         const char* e;
@@ -968,28 +1123,59 @@ static void addInt64Format(char form[MAX_FORMAT], char formatIndicator, size_t f
     form[formatItemSize + 3] = 0;
 }
 
-static int str_format(lua_State* L)
+// formats an integer without flags, width or precision ('%d', '%u', '%x' or '%X') right to left; returns the start of the output
+static char* formatplaininteger(char* end, unsigned long long v, char formatIndicator)
+{
+    if (formatIndicator == 'x' || formatIndicator == 'X')
+    {
+        const char* digits = formatIndicator == 'x' ? "0123456789abcdef" : "0123456789ABCDEF";
+
+        do
+        {
+            *--end = digits[v & 15];
+            v >>= 4;
+        } while (v);
+    }
+    else
+    {
+        do
+        {
+            *--end = char('0' + v % 10);
+            v /= 10;
+        } while (v);
+    }
+
+    return end;
+}
+
+// formats the arguments following the format string at index `arg' into the buffer
+static void addformat(lua_State* L, luaL_Strbuf* b, int arg)
 {
     int top = lua_gettop(L);
-    int arg = 1;
     size_t sfl;
     const char* strfrmt = luaL_checklstring(L, arg, &sfl);
     const char* strfrmt_end = strfrmt + sfl;
-    luaL_Strbuf b;
-    luaL_buffinit(L, &b);
     while (strfrmt < strfrmt_end)
     {
         if (*strfrmt != L_ESC)
-            luaL_addchar(&b, *strfrmt++);
+        {
+            // copy the text up to the next format item at once
+            const char* next = (const char*)memchr(strfrmt, L_ESC, strfrmt_end - strfrmt);
+            if (!next)
+                next = strfrmt_end;
+
+            luaL_addlstring(b, strfrmt, next - strfrmt);
+            strfrmt = next;
+        }
         else if (*++strfrmt == L_ESC)
-            luaL_addchar(&b, *strfrmt++); // %%
+            luaL_addchar(b, *strfrmt++); // %%
         else if (*strfrmt == '*')
         {
             strfrmt++;
             if (++arg > top)
                 luaL_error(L, "missing argument #%d", arg);
 
-            luaL_addvalueany(&b, arg);
+            luaL_addvalueany(b, arg);
         }
         else
         {                          // format item
@@ -1010,8 +1196,23 @@ static int str_format(lua_State* L)
             case 'd':
             case 'i':
             {
+                long long v = (long long)luaL_checknumber(L, arg);
+
+                // items without flags, width or precision don't need snprintf
+                if (form[2] == '\0')
+                {
+                    char* end = buff + sizeof(buff);
+                    char* s = formatplaininteger(end, v < 0 ? 0 - (unsigned long long)v : (unsigned long long)v, formatIndicator);
+
+                    if (v < 0)
+                        *--s = '-';
+
+                    luaL_addlstring(b, s, end - s);
+                    continue; // skip the 'luaL_addlstring' at the end
+                }
+
                 addInt64Format(form, formatIndicator, formatItemSize);
-                snprintf(buff, sizeof(buff), form, (long long)luaL_checknumber(L, arg));
+                snprintf(buff, sizeof(buff), form, v);
                 break;
             }
             case 'o':
@@ -1020,8 +1221,18 @@ static int str_format(lua_State* L)
             case 'X':
             {
                 double argValue = luaL_checknumber(L, arg);
-                addInt64Format(form, formatIndicator, formatItemSize);
                 unsigned long long v = (argValue < 0) ? (unsigned long long)(long long)argValue : (unsigned long long)argValue;
+
+                if (form[2] == '\0' && formatIndicator != 'o')
+                {
+                    char* end = buff + sizeof(buff);
+                    char* s = formatplaininteger(end, v, formatIndicator);
+
+                    luaL_addlstring(b, s, end - s);
+                    continue; // skip the 'luaL_addlstring' at the end
+                }
+
+                addInt64Format(form, formatIndicator, formatItemSize);
                 snprintf(buff, sizeof(buff), form, v);
                 break;
             }
@@ -1036,7 +1247,7 @@ static int str_format(lua_State* L)
             }
             case 'q':
             {
-                addquoted(L, &b, arg);
+                addquoted(L, b, arg);
                 continue; // skip the 'luaL_addlstring' at the end
             }
             case 's':
@@ -1046,7 +1257,7 @@ static int str_format(lua_State* L)
                 // no precision and string is too long to be formatted, or no format necessary to begin with
                 if (form[2] == '\0' || (!strchr(form, '.') && l >= 100))
                 {
-                    luaL_addlstring(&b, s, l);
+                    luaL_addlstring(b, s, l);
                     continue; // skip the `luaL_addlstring' at the end
                 }
                 else
@@ -1065,9 +1276,16 @@ static int str_format(lua_State* L)
                 luaL_error(L, "invalid option '%%%c' to 'format'", *(strfrmt - 1));
             }
             }
-            luaL_addlstring(&b, buff, strlen(buff));
+            luaL_addlstring(b, buff, strlen(buff));
         }
     }
+}
+
+static int str_format(lua_State* L)
+{
+    luaL_Strbuf b;
+    luaL_buffinit(L, &b);
+    addformat(L, &b, 1);
     luaL_pushresult(&b);
     return 1;
 }
@@ -1087,31 +1305,30 @@ static int str_split(lua_State* L)
     lua_createtable(L, 0, 0);
 
     if (needleLen == 0)
-        begin++;
+    {
+        // every character is a separate span
+        for (const char* iter = begin + 1; iter <= end; iter++)
+        {
+            lua_pushinteger(L, ++numMatches);
+            lua_pushlstring(L, spanStart, iter - spanStart);
+            lua_settable(L, -3);
 
-    // Don't iterate the last needleLen - 1 bytes of the string - they are
-    // impossible to be splits and would let us memcmp past the end of the
-    // buffer.
-    for (const char* iter = begin; iter <= end - needleLen; iter++)
+            spanStart = iter;
+        }
+    }
+    else
     {
-        // Use of memcmp here instead of strncmp is so that we allow embedded
-        // nulls to be used in either of the haystack or the needle strings.
-        // Most Lua string APIs allow embedded nulls, and this should be no
-        // exception.
-        if (memcmp(iter, needle, needleLen) == 0)
+        // luaS_memfind handles embedded nulls in either of the haystack or the needle strings, like most Lua string APIs;
+        // matches don't overlap so every search resumes right after the previous separator
+        while (const char* iter = luaS_memfind(spanStart, end - spanStart, needle, needleLen))
         {
             lua_pushinteger(L, ++numMatches);
             lua_pushlstring(L, spanStart, iter - spanStart);
             lua_settable(L, -3);
 
             spanStart = iter + needleLen;
-            if (needleLen > 0)
-                iter += needleLen - 1;
         }
-    }
 
-    if (needleLen > 0)
-    {
         lua_pushinteger(L, ++numMatches);
         lua_pushlstring(L, spanStart, end - spanStart);
         lua_settable(L, -3);
@@ -1558,7 +1775,8 @@ static int str_unpack(lua_State* L)
     Header h;
     const char* fmt = luaL_checkstring(L, 1);
     size_t ld;
-    const char* data = luaL_checklstring(L, 2, &ld);
+    // buffers can be unpacked directly, without creating an intermediate string
+    const char* data = lua_isbuffer(L, 2) ? (const char*)lua_tobuffer(L, 2, &ld) : luaL_checklstring(L, 2, &ld);
     int pos = posrelat(luaL_optinteger(L, 3, 1), ld) - 1;
     if (pos < 0)
         pos = 0;
@@ -1617,8 +1835,10 @@ static int str_unpack(lua_State* L)
         }
         case Kzstr:
         {
-            size_t len = strlen(data + pos);
-            luaL_argcheck(L, pos + len < ld, 2, "unfinished string for format 'z'");
+            // buffer data is not zero-terminated
+            const char* end = (const char*)memchr(data + pos, '\0', ld - pos);
+            luaL_argcheck(L, end != NULL, 2, "unfinished string for format 'z'");
+            size_t len = end - (data + pos);
             lua_pushlstring(L, data + pos, len);
             pos += (int)len + 1; // skip string plus final '\0'
             break;
@@ -1637,6 +1857,264 @@ static int str_unpack(lua_State* L)
 
 // }======================================================
 
+/*
+** {======================================================
+** STRING BUILDER
+** =======================================================
+*/
+
+// builder data is stored in userdata; the storage is a mutable string that is kept alive by the table of builders in the first upvalue
+struct StrBuilder
+{
+    TString* storage; // NULL until something is appended
+    size_t len;
+    bool finished; // storage has been converted into the result of tostring and can only be read from now on
+};
+
+#define BUILDER_MINSIZE 64
+
+static StrBuilder* checkbuilder(lua_State* L, int idx)
+{
+    const TValue* o = luaA_toobject(L, idx);
+    const TValue* mt = luaA_toobject(L, lua_upvalueindex(2));
+
+    if (!o || !ttisuserdata(o) || uvalue(o)->metatable != hvalue(mt))
+        luaL_typeerror(L, idx, "StringBuilder");
+
+    return (StrBuilder*)uvalue(o)->data;
+}
+
+// makes room for `size' more bytes, growing the storage geometrically; returns the write position
+static char* builderreserve(lua_State* L, StrBuilder* sb, size_t size)
+{
+    if (sb->storage && !sb->finished && sb->storage->len - sb->len >= size)
+        return sb->storage->data + sb->len;
+
+    if (size > MAXSSIZE - sb->len)
+        luaL_error(L, "string builder is too large");
+
+    size_t capacity = sb->storage && !sb->finished ? sb->storage->len : 0;
+    size_t newsize = capacity < BUILDER_MINSIZE ? BUILDER_MINSIZE : capacity;
+
+    while (newsize < sb->len + size)
+        newsize *= 2;
+
+    if (newsize > MAXSSIZE)
+        newsize = MAXSSIZE;
+
+    luaC_checkGC(L);
+
+    TString* storage = luaS_bufstart(L, newsize);
+
+    if (sb->len)
+        memcpy(storage->data, sb->storage->data, sb->len);
+
+    // the previous storage becomes garbage unless it's the result of an earlier tostring
+    lua_pushvalue(L, lua_upvalueindex(1));
+    lua_pushvalue(L, 1);
+    setsvalue(L, L->top, storage);
+    incr_top(L);
+    lua_rawset(L, -3);
+    lua_pop(L, 1);
+
+    sb->storage = storage;
+    sb->finished = false;
+
+    return storage->data + sb->len;
+}
+
+static void builderappend(lua_State* L, StrBuilder* sb, const char* s, size_t l)
+{
+    if (l == 0)
+        return;
+
+    char* p = builderreserve(L, sb, l);
+    memcpy(p, s, l);
+    sb->len += l;
+}
+
+static int builder_append(lua_State* L)
+{
+    StrBuilder* sb = checkbuilder(L, 1);
+    int n = lua_gettop(L);
+
+    for (int i = 2; i <= n; i++)
+    {
+        // numbers are formatted in place instead of being converted to temporary strings
+        if (lua_type(L, i) == LUA_TNUMBER)
+        {
+            char buf[LUAI_MAXNUM2STR];
+            char* end = luai_num2str(buf, lua_tonumber(L, i));
+            builderappend(L, sb, buf, end - buf);
+            continue;
+        }
+
+        size_t l;
+        const char* s = lua_tolstring(L, i, &l);
+        if (!s)
+            luaL_typeerror(L, i, "string");
+
+        builderappend(L, sb, s, l);
+    }
+
+    lua_settop(L, 1);
+    return 1;
+}
+
+static int builder_appendf(lua_State* L)
+{
+    StrBuilder* sb = checkbuilder(L, 1);
+
+    // short items are formatted on the C stack; only long results go through a temporary string storage
+    luaL_Strbuf b;
+    luaL_buffinit(L, &b);
+    addformat(L, &b, 2);
+
+    const char* base = b.storage ? b.storage->data : b.buffer;
+    builderappend(L, sb, base, b.p - base);
+
+    lua_settop(L, 1);
+    return 1;
+}
+
+static int builder_tostring(lua_State* L)
+{
+    StrBuilder* sb = checkbuilder(L, 1);
+
+    if (sb->len == 0)
+    {
+        lua_pushliteral(L, "");
+    }
+    else if (sb->finished)
+    {
+        setsvalue(L, L->top, sb->storage);
+        incr_top(L);
+    }
+    else if (sb->len == sb->storage->len)
+    {
+        luaC_checkGC(L);
+
+        // storage is filled completely, so it can become the result without a copy; it might turn out to be equal to an existing string
+        TString* ts = luaS_buffinish(L, sb->storage);
+        sb->finished = ts == sb->storage;
+
+        setsvalue(L, L->top, ts);
+        incr_top(L);
+    }
+    else
+    {
+        lua_pushlstring(L, sb->storage->data, sb->len);
+    }
+
+    return 1;
+}
+
+static int builder_len(lua_State* L)
+{
+    StrBuilder* sb = checkbuilder(L, 1);
+    lua_pushinteger(L, int(sb->len));
+    return 1;
+}
+
+static int builder_clear(lua_State* L)
+{
+    StrBuilder* sb = checkbuilder(L, 1);
+
+    // finished storage is shared with the strings returned by tostring, so the next append has to start a new one
+    if (sb->finished)
+    {
+        sb->storage = NULL;
+        sb->finished = false;
+    }
+
+    sb->len = 0;
+
+    lua_settop(L, 1);
+    return 1;
+}
+
+static int str_builder(lua_State* L)
+{
+    int size = luaL_optinteger(L, 1, 0);
+    luaL_argcheck(L, size >= 0 && size <= MAXSSIZE, 1, "invalid size");
+
+    StrBuilder* sb = (StrBuilder*)lua_newuserdata(L, sizeof(StrBuilder));
+    sb->storage = NULL;
+    sb->len = 0;
+    sb->finished = false;
+
+    lua_pushvalue(L, lua_upvalueindex(2));
+    lua_setmetatable(L, -2);
+
+    // capacity can be reserved up front; a builder that is filled exactly to it produces the result of tostring without a copy
+    if (size > 0)
+    {
+        lua_replace(L, 1);
+        lua_settop(L, 1);
+        builderreserve(L, sb, size);
+    }
+
+    return 1;
+}
+
+static void createbuilder(lua_State* L)
+{
+    static const luaL_Reg methods[] = {
+        {"append", builder_append},
+        {"appendf", builder_appendf},
+        {"tostring", builder_tostring},
+        {"len", builder_len},
+        {"clear", builder_clear},
+    };
+
+    // table of builders to their storage; weak keys let the builders be collected together with their storage
+    lua_createtable(L, 0, 0);
+    lua_createtable(L, 0, 1);
+    lua_pushliteral(L, "k");
+    lua_setfield(L, -2, "__mode");
+    lua_setmetatable(L, -2);
+
+    // metatable of builders
+    lua_createtable(L, 0, 5);
+
+    lua_createtable(L, 0, int(sizeof(methods) / sizeof(methods[0])));
+
+    for (const luaL_Reg& method : methods)
+    {
+        lua_pushvalue(L, -3);
+        lua_pushvalue(L, -3);
+        lua_pushcclosure(L, method.func, method.name, 2);
+        lua_setfield(L, -2, method.name);
+    }
+
+    lua_setreadonly(L, -1, true);
+    lua_setfield(L, -2, "__index");
+
+    lua_pushvalue(L, -2);
+    lua_pushvalue(L, -2);
+    lua_pushcclosure(L, builder_tostring, "__tostring", 2);
+    lua_setfield(L, -2, "__tostring");
+
+    lua_pushvalue(L, -2);
+    lua_pushvalue(L, -2);
+    lua_pushcclosure(L, builder_len, "__len", 2);
+    lua_setfield(L, -2, "__len");
+
+    lua_pushliteral(L, "StringBuilder");
+    lua_setfield(L, -2, "__type");
+
+    lua_pushliteral(L, "The metatable is locked");
+    lua_setfield(L, -2, "__metatable");
+
+    lua_setreadonly(L, -1, true);
+
+    // string.builder gets both the builder table and the metatable as upvalues
+    lua_pushcclosure(L, str_builder, "builder", 2);
+    lua_setfield(L, -2, "builder");
+}
+
+// }======================================================
+
 static const luaL_Reg strlib[] = {
     {"byte", str_byte},
     {"char", str_char},
@@ -1676,6 +2154,7 @@ static void createmetatable(lua_State* L)
 int luaopen_string(lua_State* L)
 {
     luaL_register(L, LUA_STRLIBNAME, strlib);
+    createbuilder(L);
     createmetatable(L);
 
     return 1;
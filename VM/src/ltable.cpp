@@ -21,6 +21,10 @@
  * invariant where the boundary must be in the array part - this enforces a consistent iteration order through the
  * prefix of the table when using pairs(), and allows to implement algorithms that access elements in 1..#t range
  * more efficiently.
+ *
+ * Tables that are created with a small hash part allocate it together with the table header, so that small tables
+ * that are built using a constructor only need one allocation. If the hash part outgrows that inline storage, it
+ * moves to a separate allocation, and the inline storage is reused if the hash part shrinks back to fit in it.
  */
 
 #include "ltable.h"
@@ -31,6 +35,8 @@
 #include "lmem.h"
 #include "lnumutils.h"
 
+#include "Luau/BytecodeUtils.h"
+
 #include <string.h>
 
 // max size of both array and hash part is 2^MAXBITS
@@ -52,6 +58,41 @@ const LuaNode luaH_dummynode = {
 
 #define dummynode (&luaH_dummynode)
 
+static_assert(LUAI_MAXINLINENODES > 0 && (LUAI_MAXINLINENODES & (LUAI_MAXINLINENODES - 1)) == 0, "inline hash part must be a power of 2");
+
+#define inlinenodes(t) cast_to(LuaNode*, (t) + 1)
+#define hasinlinenodes(t) testbit((t)->marked, INLINEBIT)
+#define usesinlinenodes(t) (hasinlinenodes(t) && (t)->node == inlinenodes(t))
+
+static int inlinesize(const Table* t)
+{
+    if (!hasinlinenodes(t))
+        return 0;
+
+    // when the hash part is stored elsewhere, the unused inline storage keeps its own capacity
+    return usesinlinenodes(t) ? sizenode(t) : *cast_to(const int*, inlinenodes(t));
+}
+
+// array and hash parts shared by luaH_cloneshared are prefixed with a reference count; the last table that releases them frees them
+struct TableShare
+{
+    int refs;
+    uint8_t memcat;
+
+    union
+    {
+        char data[1];
+        double align1;
+        void* align2;
+    };
+};
+
+#define sharesize(bytes) (offsetof(TableShare, data) + (bytes))
+#define getshare(p) cast_to(TableShare*, cast_to(char*, p) - offsetof(TableShare, data))
+
+// tables with fewer slots are copied by luaH_cloneshared since the copy is cheaper than a slow path write that unshares them
+#define LUAI_SHARECLONEMIN 64
+
 // hash is always reduced mod 2^k
 #define hashpow2(t, n) (gnode(t, lmod((n), sizenode(t))))
 
@@ -330,28 +371,45 @@ static void setarrayvector(lua_State* L, Table* t, int size)
 
 static void setnodevector(lua_State* L, Table* t, int size)
 {
+    int inlinesz = inlinesize(t);
+    LuaNode* node;
     int lsize;
     if (size == 0)
-    {                                           // no elements to hash part?
-        t->node = cast_to(LuaNode*, dummynode); // use common `dummynode'
+    {                                          // no elements to hash part?
+        node = cast_to(LuaNode*, dummynode); // use common `dummynode'
         lsize = 0;
     }
     else
     {
-        int i;
         lsize = ceillog2(size);
         if (lsize > MAXBITS)
             luaG_runerror(L, "table overflow");
         size = twoto(lsize);
-        t->node = luaM_newarray(L, size, LuaNode, t->memcat);
-        for (i = 0; i < size; i++)
+
+        if (size <= inlinesz)
+        {
+            // inline storage is always used at full capacity so that its size can be recovered from the hash part
+            lsize = ceillog2(inlinesz);
+            size = inlinesz;
+            node = inlinenodes(t);
+        }
+        else
+        {
+            node = luaM_newarray(L, size, LuaNode, t->memcat);
+        }
+
+        for (int i = 0; i < size; i++)
         {
-            LuaNode* n = gnode(t, i);
+            LuaNode* n = &node[i];
             gnext(n) = 0;
             setnilvalue(gkey(n));
             setnilvalue(gval(n));
         }
     }
+    // inline storage that is no longer used remembers its capacity
+    if (usesinlinenodes(t) && node != t->node)
+        *cast_to(int*, inlinenodes(t)) = inlinesz;
+    t->node = node;
     t->lsizenode = cast_byte(lsize);
     t->nodemask8 = cast_byte((1 << lsize) - 1);
     t->lastfree = size; // all positions are free
@@ -380,6 +438,13 @@ static void resize(lua_State* L, Table* t, int nasize, int nhsize)
     int oldasize = t->sizearray;
     int oldhsize = t->lsizenode;
     LuaNode* nold = t->node; // save old hash ...
+    // inline storage may be reused by the new hash part, so the old elements are moved out of it first
+    LuaNode inlinecopy[LUAI_MAXINLINENODES];
+    if (usesinlinenodes(t))
+    {
+        memcpy(inlinecopy, nold, twoto(oldhsize) * sizeof(LuaNode));
+        nold = inlinecopy;
+    }
     if (nasize > oldasize)   // array part must grow?
         setarrayvector(L, t, nasize);
     // create new hash part with appropriate size
@@ -420,7 +485,7 @@ static void resize(lua_State* L, Table* t, int nasize, int nhsize)
     LUAU_ASSERT(nnew == t->node);
     LUAU_ASSERT(anew == t->array);
 
-    if (nold != dummynode)
+    if (nold != dummynode && nold != inlinecopy)
         luaM_freearray(L, nold, twoto(oldhsize), LuaNode, t->memcat); // free old array
 }
 
@@ -446,6 +511,27 @@ void luaH_resizehash(lua_State* L, Table* t, int nhsize)
     resize(L, t, t->sizearray, nhsize);
 }
 
+void luaH_reserve(lua_State* L, Table* t, int nasize, int nhsize)
+{
+    int oldnhsize = (t->node == dummynode) ? 0 : sizenode(t);
+
+    // parts are never shrunk, so that reserving space doesn't need to count the keys of the table
+    if (nasize <= t->sizearray && nhsize <= oldnhsize)
+        return;
+
+    int asize = nasize > t->sizearray ? adjustasize(t, nasize, NULL) : t->sizearray;
+    resize(L, t, asize, nhsize > oldnhsize ? nhsize : oldnhsize);
+}
+
+static void growarray(lua_State* L, Table* t, const TValue* ek)
+{
+    // the array part is doubled like rehash would do for a dense array, but without counting the keys
+    int nasize = t->sizearray > MAXSIZE / 2 ? MAXSIZE : t->sizearray * 2;
+    int nhsize = (t->node == dummynode) ? 0 : sizenode(t);
+
+    resize(L, t, adjustasize(t, nasize, ek), nhsize);
+}
+
 static void rehash(lua_State* L, Table* t, const TValue* ek)
 {
     int nums[MAXBITS + 1]; // nums[i] = number of keys between 2^(i-1) and 2^i
@@ -491,10 +577,25 @@ static void rehash(lua_State* L, Table* t, const TValue* ek)
 ** }=============================================================
 */
 
-Table* luaH_new(lua_State* L, int narray, int nhash)
+static Table* newtable(lua_State* L, int nhash)
 {
-    Table* t = luaM_newgco(L, Table, sizeof(Table), L->activememcat);
+    int inlinesz = (nhash > 0 && nhash <= LUAI_MAXINLINENODES) ? twoto(ceillog2(nhash)) : 0;
+
+    Table* t = luaM_newgco(L, Table, sizeof(Table) + inlinesz * sizeof(LuaNode), L->activememcat);
     luaC_init(L, t, LUA_TTABLE);
+
+    if (inlinesz)
+    {
+        l_setbit(t->marked, INLINEBIT);
+        *cast_to(int*, inlinenodes(t)) = inlinesz;
+    }
+
+    return t;
+}
+
+Table* luaH_new(lua_State* L, int narray, int nhash)
+{
+    Table* t = newtable(L, nhash);
     t->metatable = NULL;
     t->tmcache = cast_byte(~0);
     t->array = NULL;
@@ -512,13 +613,138 @@ Table* luaH_new(lua_State* L, int narray, int nhash)
     return t;
 }
 
+static TableSite* gettablesite(lua_State* L, Proto* p, int pc)
+{
+    if (!p->tablesites)
+    {
+        int count = 0;
+
+        // breakpoints replace opcodes in code[], but debuginsn keeps the originals
+        for (int i = 0; i < p->sizecode; i += Luau::getOpLength(LuauOpcode(p->debuginsn ? p->debuginsn[i] : LUAU_INSN_OP(p->code[i]))))
+            count += (p->debuginsn ? p->debuginsn[i] : LUAU_INSN_OP(p->code[i])) == LOP_NEWTABLE;
+
+        TableSite* sites = luaM_newarray(L, count, TableSite, p->memcat);
+        int index = 0;
+
+        for (int i = 0; i < p->sizecode; i += Luau::getOpLength(LuauOpcode(p->debuginsn ? p->debuginsn[i] : LUAU_INSN_OP(p->code[i]))))
+        {
+            if ((p->debuginsn ? p->debuginsn[i] : LUAU_INSN_OP(p->code[i])) == LOP_NEWTABLE)
+            {
+                TableSite& site = sites[index++];
+                site.pc = i;
+                site.sizearray = 0;
+                site.sizenode = 0;
+                site.last = NULL;
+                site.lastfrees = 0;
+            }
+        }
+
+        p->tablesites = sites;
+        p->sizetablesites = count;
+    }
+
+    TableSite* site = const_cast<TableSite*>(luaH_gettablesite(p, pc));
+    LUAU_ASSERT(site);
+    return site;
+}
+
+// creates a table for the NEWTABLE instruction at `pc' using the sizes that the previous table created there has reached, see lua_settablefeedback
+Table* luaH_newatsite(lua_State* L, Proto* p, int pc, int narray, int nhash)
+{
+    global_State* g = L->global;
+    TableSite* site = gettablesite(L, p, pc);
+
+    // the previous table is still at the same address if nothing was freed since it was created, but it might not be reachable anymore
+    if (site->last && site->lastfrees == g->gcofrees)
+    {
+        site->sizearray = site->last->sizearray;
+        site->sizenode = site->last->node == dummynode ? 0 : sizenode(site->last);
+    }
+
+    Table* t = luaH_new(L, narray > site->sizearray ? narray : site->sizearray, nhash > site->sizenode ? nhash : site->sizenode);
+
+    site->last = t;
+    site->lastfrees = g->gcofrees;
+    return t;
+}
+
+const TableSite* luaH_gettablesite(const Proto* p, int pc)
+{
+    int lo = 0;
+    int hi = p->sizetablesites;
+
+    while (lo < hi)
+    {
+        int mid = (lo + hi) / 2;
+
+        if (p->tablesites[mid].pc < pc)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo < p->sizetablesites && p->tablesites[lo].pc == pc ? &p->tablesites[lo] : NULL;
+}
+
+static void* newshare(lua_State* L, void* data, size_t bytes, uint8_t memcat)
+{
+    TableShare* share = cast_to(TableShare*, luaM_new_(L, sharesize(bytes), memcat));
+    share->refs = 1;
+    share->memcat = memcat;
+    memcpy(share->data, data, bytes);
+
+    luaM_free_(L, data, bytes, memcat);
+    return share->data;
+}
+
+static void releaseshare(lua_State* L, void* data, size_t bytes)
+{
+    TableShare* share = getshare(data);
+
+    if (--share->refs == 0)
+        luaM_free_(L, share, sharesize(bytes), share->memcat);
+}
+
+static void* unshare(lua_State* L, void* data, size_t bytes, uint8_t memcat)
+{
+    void* copy = luaM_new_(L, bytes, memcat);
+    memcpy(copy, data, bytes);
+
+    releaseshare(L, data, bytes);
+    return copy;
+}
+
 void luaH_free(lua_State* L, Table* t, lua_Page* page)
 {
-    if (t->node != dummynode)
-        luaM_freearray(L, t->node, sizenode(t), LuaNode, t->memcat);
+    int inlinesz = inlinesize(t);
+
+    if (t->node != dummynode && !usesinlinenodes(t))
+    {
+        if (t->readonly & TABLE_SHAREDNODE)
+            releaseshare(L, t->node, sizenode(t) * sizeof(LuaNode));
+        else
+            luaM_freearray(L, t->node, sizenode(t), LuaNode, t->memcat);
+    }
+
     if (t->array)
-        luaM_freearray(L, t->array, t->sizearray, TValue, t->memcat);
-    luaM_freegco(L, t, sizeof(Table), t->memcat, page);
+    {
+        if (t->readonly & TABLE_SHAREDARRAY)
+            releaseshare(L, t->array, t->sizearray * sizeof(TValue));
+        else
+            luaM_freearray(L, t->array, t->sizearray, TValue, t->memcat);
+    }
+
+    luaM_freegco(L, t, sizeof(Table) + inlinesz * sizeof(LuaNode), t->memcat, page);
+}
+
+size_t luaH_memsize(const Table* t)
+{
+    size_t size = sizeof(Table) + inlinesize(t) * sizeof(LuaNode) + t->sizearray * sizeof(TValue);
+
+    if (t->node != dummynode && !usesinlinenodes(t))
+        size += sizenode(t) * sizeof(LuaNode);
+
+    return size;
 }
 
 static LuaNode* getfreepos(Table* t)
@@ -546,7 +772,11 @@ static TValue* newkey(lua_State* L, Table* t, const TValue* key)
     // enforce boundary invariant
     if (ttisnumber(key) && nvalue(key) == t->sizearray + 1)
     {
-        rehash(L, t, key); // grow table
+        // appending after a filled array part is the common case of building an array, so it skips key counting
+        if (t->sizearray > 0 && !ttisnil(&t->array[t->sizearray - 1]))
+            growarray(L, t, key);
+        else
+            rehash(L, t, key); // grow table
 
         // after rehash, numeric keys might be located in the new array part, but won't be found in the node part
         return arrayornewkey(L, t, key);
@@ -641,6 +871,21 @@ const TValue* luaH_getstr(Table* t, TString* key)
     return luaO_nilobject;
 }
 
+// same as luaH_getstr, but returns the node that contains the key, or NULL if the key is missing
+LuaNode* luaH_getstrnode(Table* t, TString* key)
+{
+    LuaNode* n = hashstr(t, key);
+    for (;;)
+    { // check whether `key' is somewhere in the chain
+        if (ttisstring(gkey(n)) && tsvalue(gkey(n)) == key)
+            return n; // that's it
+        if (gnext(n) == 0)
+            break;
+        n += gnext(n);
+    }
+    return NULL;
+}
+
 /*
 ** main search function
 */
@@ -680,7 +925,7 @@ const TValue* luaH_get(Table* t, const TValue* key)
 TValue* luaH_set(lua_State* L, Table* t, const TValue* key)
 {
     const TValue* p = luaH_get(t, key);
-    invalidateTMcache(t);
+    invalidateTMcache(L, t);
     if (p != luaO_nilobject)
         return cast_to(TValue*, p);
     else
@@ -718,7 +963,7 @@ TValue* luaH_setnum(lua_State* L, Table* t, int key)
 TValue* luaH_setstr(lua_State* L, Table* t, TString* key)
 {
     const TValue* p = luaH_getstr(t, key);
-    invalidateTMcache(t);
+    invalidateTMcache(L, t);
     if (p != luaO_nilobject)
         return cast_to(TValue*, p);
     else
@@ -795,8 +1040,7 @@ int luaH_getn(Table* t)
 
 Table* luaH_clone(lua_State* L, Table* tt)
 {
-    Table* t = luaM_newgco(L, Table, sizeof(Table), L->activememcat);
-    luaC_init(L, t, LUA_TTABLE);
+    Table* t = newtable(L, tt->node == dummynode ? 0 : sizenode(tt));
     t->metatable = tt->metatable;
     t->tmcache = tt->tmcache;
     t->array = NULL;
@@ -820,7 +1064,7 @@ Table* luaH_clone(lua_State* L, Table* tt)
     if (tt->node != dummynode)
     {
         int size = 1 << tt->lsizenode;
-        t->node = luaM_newarray(L, size, LuaNode, t->memcat);
+        t->node = size == inlinesize(t) ? inlinenodes(t) : luaM_newarray(L, size, LuaNode, t->memcat);
         t->lsizenode = tt->lsizenode;
         t->nodemask8 = tt->nodemask8;
         memcpy(t->node, tt->node, size * sizeof(LuaNode));
@@ -830,28 +1074,118 @@ Table* luaH_clone(lua_State* L, Table* tt)
     return t;
 }
 
-void luaH_clear(Table* tt)
+Table* luaH_cloneshared(lua_State* L, Table* tt)
 {
-    // clear array part
-    for (int i = 0; i < tt->sizearray; ++i)
+    // tables from shared heaps are immutable and their storage isn't owned by this state, so it can't be moved to a reference counted block
+    if (isshared(obj2gco(tt)))
+        return luaH_clone(L, tt);
+
+    bool sharenode = tt->node != dummynode && !usesinlinenodes(tt);
+
+    if (tt->sizearray + (sharenode ? sizenode(tt) : 0) < LUAI_SHARECLONEMIN)
+        return luaH_clone(L, tt);
+
+    // each part is moved to shared storage separately so that running out of memory leaves the table in a consistent state
+    if (tt->sizearray && !(tt->readonly & TABLE_SHAREDARRAY))
+    {
+        tt->array = cast_to(TValue*, newshare(L, tt->array, tt->sizearray * sizeof(TValue), tt->memcat));
+        tt->readonly |= TABLE_SHAREDARRAY;
+    }
+
+    if (sharenode && !(tt->readonly & TABLE_SHAREDNODE))
     {
-        setnilvalue(&tt->array[i]);
+        tt->node = cast_to(LuaNode*, newshare(L, tt->node, sizenode(tt) * sizeof(LuaNode), tt->memcat));
+        tt->readonly |= TABLE_SHAREDNODE;
     }
 
+    Table* t = newtable(L, usesinlinenodes(tt) ? sizenode(tt) : 0);
+    t->metatable = tt->metatable;
+    t->tmcache = tt->tmcache;
+    t->readonly = tt->readonly & TABLE_SHARED;
+    t->safeenv = 0;
+    t->lsizenode = tt->lsizenode;
+    t->nodemask8 = tt->nodemask8;
+    t->sizearray = tt->sizearray;
+    t->lastfree = tt->lastfree; // also copies the array boundary
+    t->array = NULL;
+    t->node = cast_to(LuaNode*, dummynode);
+
+    if (tt->sizearray)
+    {
+        getshare(tt->array)->refs++;
+        t->array = tt->array;
+    }
+
+    if (sharenode)
+    {
+        getshare(tt->node)->refs++;
+        t->node = tt->node;
+    }
+    else if (usesinlinenodes(tt))
+    {
+        t->node = inlinenodes(t);
+        memcpy(t->node, tt->node, sizenode(tt) * sizeof(LuaNode));
+    }
+
+    return t;
+}
+
+void luaH_unshare(lua_State* L, Table* t)
+{
+    if (t->readonly & TABLE_SHAREDARRAY)
+    {
+        t->array = cast_to(TValue*, unshare(L, t->array, t->sizearray * sizeof(TValue), t->memcat));
+        t->readonly &= ~TABLE_SHAREDARRAY;
+    }
+
+    if (t->readonly & TABLE_SHAREDNODE)
+    {
+        t->node = cast_to(LuaNode*, unshare(L, t->node, sizenode(t) * sizeof(LuaNode), t->memcat));
+        t->readonly &= ~TABLE_SHAREDNODE;
+    }
+}
+
+void luaH_prepwrite(lua_State* L, Table* t)
+{
+    if (t->readonly & TABLE_FROZEN)
+        luaG_readonlyerror(L);
+
+    if (t->readonly & TABLE_EXPOSEDENV)
+        luaH_resetsafeenv(t);
+
+    luaH_unshare(L, t);
+}
+
+// Scripts that can reach their environment table could replace the globals that imports and builtin calls were resolved to
+// Instead of turning safeenv off right away, the table is routed to luaH_prepwrite by all fast paths so that only an actual write does it
+void luaH_exposeenv(Table* t)
+{
+    if (t->safeenv)
+        t->readonly |= TABLE_EXPOSEDENV;
+}
+
+void luaH_resetsafeenv(Table* t)
+{
+    t->safeenv = 0;
+    t->readonly &= ~TABLE_EXPOSEDENV;
+}
+
+void luaH_clear(Table* tt)
+{
+    static_assert(LUA_TNIL == 0, "clearing relies on zeroed memory being a nil value");
+
+    // clear array part
+    if (tt->sizearray)
+        memset(tt->array, 0, tt->sizearray * sizeof(TValue));
+
     maybesetaboundary(tt, 0);
 
-    // clear hash part
+    // clear hash part; zeroed nodes have nil keys, nil values and no chain links
     if (tt->node != dummynode)
     {
         int size = sizenode(tt);
         tt->lastfree = size;
-        for (int i = 0; i < size; ++i)
-        {
-            LuaNode* n = gnode(tt, i);
-            setnilvalue(gkey(n));
-            setnilvalue(gval(n));
-            gnext(n) = 0;
-        }
+        memset(tt->node, 0, size * sizeof(LuaNode));
     }
 
     // back to empty -> no tag methods present
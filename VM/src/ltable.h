@@ -12,24 +12,42 @@
 #define gval2slot(t, v) int(cast_to(LuaNode*, static_cast<const TValue*>(v)) - t->node)
 
 // reset cache of absent metamethods, cache is updated in luaT_gettm
-#define invalidateTMcache(t) t->tmcache = 0
+// tables with cached metamethod absence can be a part of cached __index chain lookups, so new keys in them invalidate the index cache
+#define invalidateTMcache(L, t) ((t)->tmcache ? (void)((t)->tmcache = 0, (L)->global->indexcacheepoch++) : (void)0)
+
+// bits of Table::readonly; fast paths only check for a non-zero value and leave both cases to luaH_prepwrite
+#define TABLE_FROZEN 1      // writes raise an error
+#define TABLE_SHAREDARRAY 2 // array part is shared with other tables until the first write, see luaH_cloneshared
+#define TABLE_SHAREDNODE 4  // hash part is shared with other tables until the first write
+#define TABLE_SHARED (TABLE_SHAREDARRAY | TABLE_SHAREDNODE)
+#define TABLE_EXPOSEDENV 8  // safe environment that was returned to a script by getfenv; the first write makes it unsafe, see luaH_exposeenv
 
 LUAI_FUNC const TValue* luaH_getnum(Table* t, int key);
 LUAI_FUNC TValue* luaH_setnum(lua_State* L, Table* t, int key);
 LUAI_FUNC const TValue* luaH_getstr(Table* t, TString* key);
+LUAI_FUNC LuaNode* luaH_getstrnode(Table* t, TString* key);
 LUAI_FUNC TValue* luaH_setstr(lua_State* L, Table* t, TString* key);
 LUAI_FUNC const TValue* luaH_get(Table* t, const TValue* key);
 LUAI_FUNC TValue* luaH_set(lua_State* L, Table* t, const TValue* key);
 LUAI_FUNC TValue* luaH_newkey(lua_State* L, Table* t, const TValue* key);
 LUAI_FUNC Table* luaH_new(lua_State* L, int narray, int lnhash);
+LUAI_FUNC Table* luaH_newatsite(lua_State* L, Proto* p, int pc, int narray, int nhash);
+LUAI_FUNC const TableSite* luaH_gettablesite(const Proto* p, int pc);
 LUAI_FUNC void luaH_resizearray(lua_State* L, Table* t, int nasize);
 LUAI_FUNC void luaH_resizehash(lua_State* L, Table* t, int nhsize);
+LUAI_FUNC void luaH_reserve(lua_State* L, Table* t, int nasize, int nhsize);
 LUAI_FUNC void luaH_free(lua_State* L, Table* t, struct lua_Page* page);
+LUAI_FUNC size_t luaH_memsize(const Table* t);
 LUAI_FUNC int luaH_next(lua_State* L, Table* t, StkId key);
 LUAI_FUNC int luaH_getn(Table* t);
 LUAI_FUNC Table* luaH_clone(lua_State* L, Table* tt);
+LUAI_FUNC Table* luaH_cloneshared(lua_State* L, Table* tt);
+LUAI_FUNC void luaH_unshare(lua_State* L, Table* t);
+LUAI_FUNC void luaH_prepwrite(lua_State* L, Table* t);
+LUAI_FUNC void luaH_exposeenv(Table* t);
+LUAI_FUNC void luaH_resetsafeenv(Table* t);
 LUAI_FUNC void luaH_clear(Table* tt);
 
-#define luaH_setslot(L, t, slot, key) (invalidateTMcache(t), (slot == luaO_nilobject ? luaH_newkey(L, t, key) : cast_to(TValue*, slot)))
+#define luaH_setslot(L, t, slot, key) (invalidateTMcache(L, t), (slot == luaO_nilobject ? luaH_newkey(L, t, key) : cast_to(TValue*, slot)))
 
 extern const LuaNode luaH_dummynode;
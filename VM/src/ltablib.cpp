@@ -10,6 +10,13 @@
 #include "ldebug.h"
 #include "lvm.h"
 
+#include <string.h>
+
+#if (defined(__x86_64__) || defined(_M_X64)) && LUA_VECTOR_SIZE == 3
+#include <emmintrin.h>
+#define LUAU_TABLE_SSE2
+#endif
+
 static int foreachi(lua_State* L)
 {
     luaL_checktype(L, 1, LUA_TTABLE);
@@ -79,7 +86,7 @@ static void moveelements(lua_State* L, int srct, int dstt, int f, int e, int t)
     Table* dst = hvalue(L->base + (dstt - 1));
 
     if (dst->readonly)
-        luaG_readonlyerror(L);
+        luaH_prepwrite(L, dst);
 
     int n = e - f + 1; // number of elements to move
 
@@ -88,27 +95,9 @@ static void moveelements(lua_State* L, int srct, int dstt, int f, int e, int t)
         cast_to(unsigned int, f - 1 + n) <= cast_to(unsigned int, src->sizearray) &&
         cast_to(unsigned int, t - 1 + n) <= cast_to(unsigned int, dst->sizearray))
     {
-        TValue* srcarray = src->array;
-        TValue* dstarray = dst->array;
-
-        if (t > e || t <= f || (dstt != srct && dst != src))
-        {
-            for (int i = 0; i < n; ++i)
-            {
-                TValue* s = &srcarray[f + i - 1];
-                TValue* d = &dstarray[t + i - 1];
-                setobj2t(L, d, s);
-            }
-        }
-        else
-        {
-            for (int i = n - 1; i >= 0; i--)
-            {
-                TValue* s = &srcarray[(f + i) - 1];
-                TValue* d = &dstarray[(t + i) - 1];
-                setobj2t(L, d, s);
-            }
-        }
+        // array parts hold plain TValues, so the entire range can be copied at once; memmove handles overlapping ranges
+        // of the same table in either direction
+        memmove(&dst->array[t - 1], &src->array[f - 1], n * sizeof(TValue));
 
         luaC_barrierfast(L, dst);
     }
@@ -204,7 +193,7 @@ static int tmove(lua_State* L)
         Table* dst = hvalue(L->base + (tt - 1));
 
         if (dst->readonly) // also checked in moveelements, but this blocks resizes of r/o tables
-            luaG_readonlyerror(L);
+            luaH_prepwrite(L, dst);
 
         if (t > 0 && (t - 1) <= dst->sizearray && (t - 1 + n) > dst->sizearray)
         { // grow the destination table array
@@ -235,6 +224,34 @@ static int tconcat(lua_State* L)
     i = luaL_optinteger(L, 3, 1);
     last = luaL_opt(L, luaL_checkinteger, 4, lua_objlen(L, 1));
     luaL_buffinit(L, &b);
+
+    // fast-path: when the range is in the array part and only has strings, the result is allocated once
+    Table* t = hvalue(L->base);
+    if (1 <= i && i <= last && last <= t->sizearray)
+    {
+        size_t size = lsep * (last - i);
+        int j = i;
+        for (; j <= last && ttisstring(&t->array[j - 1]); j++)
+            size += tsvalue(&t->array[j - 1])->len;
+
+        if (j > last)
+        {
+            luaL_prepbuffsize(&b, size);
+
+            for (; i < last; i++)
+            {
+                TString* ts = tsvalue(&t->array[i - 1]);
+                luaL_addlstring(&b, getstr(ts), ts->len);
+                luaL_addlstring(&b, sep, lsep);
+            }
+
+            TString* ts = tsvalue(&t->array[last - 1]);
+            luaL_addlstring(&b, getstr(ts), ts->len);
+            luaL_pushresult(&b);
+            return 1;
+        }
+    }
+
     for (; i < last; i++)
     {
         addfield(L, &b, i);
@@ -298,6 +315,23 @@ static int tunpack(lua_State* L)
 
 typedef int (*SortPredicate)(lua_State* L, const TValue* l, const TValue* r);
 
+// predicates for arrays where all elements have the same type; they compare exactly like luaV_lessthan but can be inlined
+struct SortNumbers
+{
+    int operator()(lua_State* L, const TValue* l, const TValue* r) const
+    {
+        return nvalue(l) < nvalue(r);
+    }
+};
+
+struct SortStrings
+{
+    int operator()(lua_State* L, const TValue* l, const TValue* r) const
+    {
+        return luaV_strcmp(tsvalue(l), tsvalue(r)) < 0;
+    }
+};
+
 static int sort_func(lua_State* L, const TValue* l, const TValue* r)
 {
     LUAU_ASSERT(L->top == L->base + 2); // table, function
@@ -325,7 +359,8 @@ inline void sort_swap(lua_State* L, Table* t, int i, int j)
     setobj2t(L, &arr[j], &temp);
 }
 
-inline int sort_less(lua_State* L, Table* t, int i, int j, SortPredicate pred)
+template<typename Pred>
+inline int sort_less(lua_State* L, Table* t, int i, int j, Pred pred)
 {
     TValue* arr = t->array;
     int n = t->sizearray;
@@ -337,10 +372,15 @@ inline int sort_less(lua_State* L, Table* t, int i, int j, SortPredicate pred)
     if (t->sizearray != n)
         luaL_error(L, "table modified during sorting");
 
+    // predicate call may also clone the table, which shares the array that is being sorted
+    if (t->readonly & TABLE_SHARED)
+        luaH_unshare(L, t);
+
     return res;
 }
 
-static void sort_siftheap(lua_State* L, Table* t, int l, int u, SortPredicate pred, int root)
+template<typename Pred>
+static void sort_siftheap(lua_State* L, Table* t, int l, int u, Pred pred, int root)
 {
     LUAU_ASSERT(l <= u);
     int count = u - l + 1;
@@ -366,7 +406,8 @@ static void sort_siftheap(lua_State* L, Table* t, int l, int u, SortPredicate pr
         sort_swap(L, t, l + root, l + lastleft);
 }
 
-static void sort_heap(lua_State* L, Table* t, int l, int u, SortPredicate pred)
+template<typename Pred>
+static void sort_heap(lua_State* L, Table* t, int l, int u, Pred pred)
 {
     LUAU_ASSERT(l <= u);
     int count = u - l + 1;
@@ -381,7 +422,8 @@ static void sort_heap(lua_State* L, Table* t, int l, int u, SortPredicate pred)
     }
 }
 
-static void sort_rec(lua_State* L, Table* t, int l, int u, int limit, SortPredicate pred)
+template<typename Pred>
+static void sort_rec(lua_State* L, Table* t, int l, int u, int limit, Pred pred)
 {
     // sort range [l..u] (inclusive, 0-based)
     while (l < u)
@@ -457,7 +499,7 @@ static int tsort(lua_State* L)
     Table* t = hvalue(L->base);
     int n = luaH_getn(t);
     if (t->readonly)
-        luaG_readonlyerror(L);
+        luaH_prepwrite(L, t);
 
     SortPredicate pred = luaV_lessthan;
     if (!lua_isnoneornil(L, 2)) // is there a 2nd argument?
@@ -467,6 +509,28 @@ static int tsort(lua_State* L)
     }
     lua_settop(L, 2); // make sure there are two arguments
 
+    if (n > 0 && pred == luaV_lessthan && n <= t->sizearray)
+    {
+        // comparisons of numbers and strings don't call metamethods, so homogeneous arrays can use a specialized predicate
+        int tt = ttype(&t->array[0]);
+
+        if (tt == LUA_TNUMBER || tt == LUA_TSTRING)
+        {
+            int i = 1;
+            while (i < n && ttype(&t->array[i]) == tt)
+                i++;
+
+            if (i == n)
+            {
+                if (tt == LUA_TNUMBER)
+                    sort_rec(L, t, 0, n - 1, n, SortNumbers());
+                else
+                    sort_rec(L, t, 0, n - 1, n, SortStrings());
+                return 0;
+            }
+        }
+    }
+
     if (n > 0)
         sort_rec(L, t, 0, n - 1, n, pred);
     return 0;
@@ -499,6 +563,97 @@ static int tcreate(lua_State* L)
     return 1;
 }
 
+// returns the 32-bit lanes of a TValue that have to match for a raw comparison with v to succeed, or 0 if raw comparison isn't enough
+static int findlanes(lua_State* L, const TValue* v)
+{
+    const int value = sizeof(void*) == 8 ? 0x3 : 0x1;
+    const int tag = 0x8;
+
+    switch (ttype(v))
+    {
+    case LUA_TNUMBER:
+        // bitwise equality matches numeric equality except for zeroes and NaNs
+        return nvalue(v) == 0 || nvalue(v) != nvalue(v) ? 0 : 0x3 | tag;
+    case LUA_TBOOLEAN:
+        return 0x1 | tag;
+    case LUA_TLIGHTUSERDATA:
+        return value | (FFlag::LuauTaggedLuData ? 0x4 : 0) | tag;
+    case LUA_TSTRING:
+    case LUA_TFUNCTION:
+    case LUA_TTHREAD:
+    case LUA_TBUFFER:
+        return value | tag;
+    case LUA_TTABLE:
+        // without __eq on the value's metatable, equality never consults the element
+        return fasttm(L, hvalue(v)->metatable, TM_EQ) ? 0 : value | tag;
+    case LUA_TUSERDATA:
+        return fasttm(L, uvalue(v)->metatable, TM_EQ) ? 0 : value | tag;
+    default:
+        return 0;
+    }
+}
+
+static bool findmatch(const TValue* e, const TValue* v, int lanes)
+{
+    const int* ew = reinterpret_cast<const int*>(e);
+    const int* vw = reinterpret_cast<const int*>(v);
+
+    return (!(lanes & 0x1) || ew[0] == vw[0]) && (!(lanes & 0x2) || ew[1] == vw[1]) && (!(lanes & 0x4) || ew[2] == vw[2]) && e->tt == v->tt;
+}
+
+// scans the array part starting at 0-based index i; returns the 1-based index of the match, 0 if a nil is reached first
+// and -1 if the array part ends before either
+static int findarray(const Table* t, int i, const TValue* v, int lanes)
+{
+    static_assert(offsetof(TValue, value) == 0 && sizeof(Value) == 8, "findmatch assumes value occupies the first two lanes");
+
+    const TValue* array = t->array;
+    int n = t->sizearray;
+
+#ifdef LUAU_TABLE_SSE2
+    static_assert(sizeof(TValue) == 16 && offsetof(TValue, tt) == 12, "vectorized scan assumes a 16-byte TValue");
+
+    __m128i needle = _mm_loadu_si128(reinterpret_cast<const __m128i*>(v));
+    __m128i zero = _mm_setzero_si128();
+
+    for (; i + 4 <= n; i += 4)
+    {
+        int stop = 0;
+
+        for (int k = 0; k < 4; ++k)
+        {
+            __m128i e = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&array[i + k]));
+            int eq = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(e, needle)));
+            int nil = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(e, zero))) & 0x8;
+
+            stop |= (((eq & lanes) == lanes) | (nil != 0)) << k;
+        }
+
+        if (stop)
+        {
+            int k = 0;
+            while (!(stop & (1 << k)))
+                k++;
+
+            return ttisnil(&array[i + k]) ? 0 : i + k + 1;
+        }
+    }
+#endif
+
+    for (; i < n; ++i)
+    {
+        const TValue* e = &array[i];
+
+        if (ttisnil(e))
+            return 0;
+
+        if (findmatch(e, v, lanes))
+            return i + 1;
+    }
+
+    return -1;
+}
+
 static int tfind(lua_State* L)
 {
     luaL_checktype(L, 1, LUA_TTABLE);
@@ -510,6 +665,23 @@ static int tfind(lua_State* L)
     Table* t = hvalue(L->base);
     StkId v = L->base + 1;
 
+    // most searches are for values that compare by identity; scan the array part without going through equalobj
+    if (int lanes = findlanes(L, v); lanes && init <= t->sizearray)
+    {
+        int pos = findarray(t, init - 1, v, lanes);
+
+        if (pos >= 0)
+        {
+            if (pos)
+                lua_pushinteger(L, pos);
+            else
+                lua_pushnil(L);
+            return 1;
+        }
+
+        init = t->sizearray + 1;
+    }
+
     for (int i = init;; ++i)
     {
         const TValue* e = luaH_getnum(t, i);
@@ -533,12 +705,24 @@ static int tclear(lua_State* L)
 
     Table* tt = hvalue(L->base);
     if (tt->readonly)
-        luaG_readonlyerror(L);
+        luaH_prepwrite(L, tt);
 
     luaH_clear(tt);
     return 0;
 }
 
+static int treserve(lua_State* L)
+{
+    luaL_checktype(L, 1, LUA_TTABLE);
+    int narray = luaL_checkinteger(L, 2);
+    int nhash = luaL_optinteger(L, 3, 0);
+    luaL_argcheck(L, narray >= 0, 2, "size out of range");
+    luaL_argcheck(L, nhash >= 0, 3, "size out of range");
+
+    lua_reservetable(L, 1, narray, nhash);
+    return 0;
+}
+
 static int tfreeze(lua_State* L)
 {
     luaL_checktype(L, 1, LUA_TTABLE);
@@ -564,7 +748,7 @@ static int tclone(lua_State* L)
     luaL_checktype(L, 1, LUA_TTABLE);
     luaL_argcheck(L, !luaL_getmetafield(L, 1, "__metatable"), 1, "table has a protected metatable");
 
-    Table* tt = luaH_clone(L, hvalue(L->base));
+    Table* tt = luaH_cloneshared(L, hvalue(L->base));
 
     TValue v;
     sethvalue(L, &v, tt);
@@ -588,6 +772,7 @@ static const luaL_Reg tab_funcs[] = {
     {"create", tcreate},
     {"find", tfind},
     {"clear", tclear},
+    {"reserve", treserve},
     {"freeze", tfreeze},
     {"isfrozen", tisfrozen},
     {"clone", tclone},
@@ -20,15 +20,40 @@ Udata* luaU_newudata(lua_State* L, size_t s, int tag)
     return u;
 }
 
+static void flushbatch(lua_State* L, int tag, UdataBatch* batch)
+{
+    int count = batch->count;
+    batch->count = 0;
+
+    batch->dtor(L, tag, batch->records, count);
+}
+
 void luaU_freeudata(lua_State* L, Udata* u, lua_Page* page)
 {
     if (u->tag < LUA_UTAG_LIMIT)
     {
-        lua_Destructor dtor = L->global->udatagc[u->tag];
-        // TODO: access to L here is highly unsafe since this is called during internal GC traversal
-        // certain operations such as lua_getthreaddata are okay, but by and large this risks crashes on improper use
-        if (dtor)
+        UdataBatch* batch = L->global->udatabatch ? L->global->udatabatch[u->tag] : NULL;
+
+        if (batch)
+        {
+            if (batch->count == LUAI_UDATABATCH)
+                flushbatch(L, u->tag, batch);
+
+            char* record = batch->records + size_t(batch->count) * batch->size;
+            int size = u->len < batch->size ? u->len : batch->size;
+
+            memcpy(record, u->data, size);
+            memset(record + size, 0, batch->size - size);
+
+            batch->count++;
+            L->global->udatabatchpending = true;
+        }
+        else if (lua_Destructor dtor = L->global->udatagc[u->tag])
+        {
+            // TODO: access to L here is highly unsafe since this is called during internal GC traversal
+            // certain operations such as lua_getthreaddata are okay, but by and large this risks crashes on improper use
             dtor(L, u->data);
+        }
     }
     else if (u->tag == UTAG_IDTOR)
     {
@@ -41,3 +66,21 @@ void luaU_freeudata(lua_State* L, Udata* u, lua_Page* page)
 
     luaM_freegco(L, u, sizeudata(u->len), u->memcat, page);
 }
+
+void luaU_flushbatches(lua_State* L)
+{
+    global_State* g = L->global;
+
+    if (!g->udatabatchpending)
+        return;
+
+    g->udatabatchpending = false;
+
+    for (int tag = 0; tag < LUA_UTAG_LIMIT; tag++)
+    {
+        UdataBatch* batch = g->udatabatch[tag];
+
+        if (batch && batch->count)
+            flushbatch(L, tag, batch);
+    }
+}
@@ -12,5 +12,8 @@
 
 #define sizeudata(len) (offsetof(Udata, data) + len)
 
+#define sizeudatabatch(size) (offsetof(UdataBatch, records) + size_t(size) * LUAI_UDATABATCH)
+
 LUAI_FUNC Udata* luaU_newudata(lua_State* L, size_t s, int tag);
 LUAI_FUNC void luaU_freeudata(lua_State* L, Udata* u, struct lua_Page* page);
+LUAI_FUNC void luaU_flushbatches(lua_State* L);
@@ -4,6 +4,8 @@
 
 #include "lcommon.h"
 
+#include <string.h>
+
 #define MAXUNICODE 0x10FFFF
 
 #define iscont(p) ((*(p)&0xC0) == 0x80)
@@ -70,6 +72,25 @@ static int utflen(lua_State* L)
     luaL_argcheck(L, --posj < (int)len, 3, "final position out of string");
     while (posi <= posj)
     {
+        // ASCII characters are counted 8 bytes at a time
+        if ((unsigned char)s[posi] < 0x80)
+        {
+            while (posj - posi >= 7)
+            {
+                uint64_t w;
+                memcpy(&w, s + posi, 8);
+
+                if (w & 0x8080808080808080ull)
+                    break;
+
+                posi += 8;
+                n += 8;
+            }
+
+            if (posi > posj)
+                break;
+        }
+
         const char* s1 = utf8_decode(s + posi, NULL);
         if (s1 == NULL)
         {                                 // conversion error?
@@ -20,13 +20,22 @@ LUAI_FUNC void luaV_dolen(lua_State* L, StkId ra, const TValue* rb);
 LUAI_FUNC const TValue* luaV_tonumber(const TValue* obj, TValue* n);
 LUAI_FUNC const float* luaV_tovector(const TValue* obj);
 LUAI_FUNC int luaV_tostring(lua_State* L, StkId obj);
+LUAI_FUNC int luaV_findudatafield(lua_State* L, Udata* u, TString* name, int hint);
+LUAI_FUNC void luaV_getudatafield(lua_State* L, Udata* u, int index, StkId val);
+LUAI_FUNC void luaV_setudatafield(lua_State* L, Udata* u, int index, const TValue* val);
 LUAI_FUNC void luaV_gettable(lua_State* L, const TValue* t, TValue* key, StkId val);
 LUAI_FUNC void luaV_settable(lua_State* L, const TValue* t, TValue* key, StkId val);
 LUAI_FUNC void luaV_concat(lua_State* L, int total, int last);
 LUAI_FUNC void luaV_getimport(lua_State* L, Table* env, TValue* k, StkId res, uint32_t id, bool propagatenil);
+LUAI_FUNC void luaV_loadproto(lua_State* L, Proto* p);
+LUAI_FUNC int luaV_getdebugline(Proto* p, int pc);
+LUAI_FUNC void luaV_loaddebuginfo(lua_State* L, Proto* p, bool keep);
 LUAI_FUNC void luaV_prepareFORN(lua_State* L, StkId plimit, StkId pstep, StkId pinit);
 LUAI_FUNC void luaV_callTM(lua_State* L, int nparams, int res);
 LUAI_FUNC void luaV_tryfuncTM(lua_State* L, StkId func);
+LUAI_FUNC bool luaV_fastargs(const lua_FastCall* fast, const TValue* arg0, const TValue* args, lua_FastValue* values);
+LUAI_FUNC void luaV_fastresults(const lua_FastCall* fast, const lua_FastValue* values, StkId res, int count);
+LUAI_FUNC bool luaV_fastcall(lua_State* L, const lua_FastCall* fast, StkId ra, StkId argtop, int nresults);
 
 LUAI_FUNC void luau_execute(lua_State* L);
 LUAI_FUNC int luau_precall(lua_State* L, struct lua_TValue* func, int nresults);
@@ -102,7 +102,7 @@
         VM_DISPATCH_OP(LOP_CAPTURE), VM_DISPATCH_OP(LOP_SUBRK), VM_DISPATCH_OP(LOP_DIVRK), VM_DISPATCH_OP(LOP_FASTCALL1), \
         VM_DISPATCH_OP(LOP_FASTCALL2), VM_DISPATCH_OP(LOP_FASTCALL2K), VM_DISPATCH_OP(LOP_FORGPREP), VM_DISPATCH_OP(LOP_JUMPXEQKNIL), \
         VM_DISPATCH_OP(LOP_JUMPXEQKB), VM_DISPATCH_OP(LOP_JUMPXEQKN), VM_DISPATCH_OP(LOP_JUMPXEQKS), VM_DISPATCH_OP(LOP_IDIV), \
-        VM_DISPATCH_OP(LOP_IDIVK),
+        VM_DISPATCH_OP(LOP_IDIVK), VM_DISPATCH_OP(LOP_MOVE2), VM_DISPATCH_OP(LOP_TAILCALL),
 
 #if defined(__GNUC__) || defined(__clang__)
 #define VM_USE_CGOTO 1
@@ -115,25 +115,67 @@
  * statements or computed goto.
  * VM_CASE(op) Generates either a case statement or a label
  * VM_NEXT() fetch a byte and dispatch or jump to the beginning of the switch statement
+ * VM_ENTER() same as VM_NEXT() but safe to use when pc is a function entry, which may be outside of the code array
  * VM_CONTINUE() Use an opcode override to dispatch with computed goto or
  * switch statement to skip a LOP_BREAK instruction.
+ *
+ * The threaded interpreter replaces opcode decoding in VM_NEXT with a load from Proto::threadedcode, which holds handler addresses at the
+ * same index as the instructions they execute; threadedbias maps pc to its entry with a single scaled add.
  */
 #if VM_USE_CGOTO
 #define VM_CASE(op) CASE_##op:
-#define VM_NEXT() goto*(SingleStep ? &&dispatch : kDispatchTable[LUAU_INSN_OP(*pc)])
+#define VM_NEXT() goto*(SingleStep ? &&dispatch : Threaded ? VM_THREADED_SLOT(pc) : kDispatchTable[LUAU_INSN_OP(*pc)])
+#define VM_ENTER() goto*(SingleStep ? &&dispatch : kDispatchTable[LUAU_INSN_OP(*pc)])
 #define VM_CONTINUE(op) goto* kDispatchTable[uint8_t(op)]
+// handler addresses are larger than instructions by this factor: 2 on 64-bit targets and 1 on 32-bit targets
+#define VM_THREADED_SCALE (sizeof(void*) / sizeof(Instruction))
+#define VM_THREADED_SLOT(pc) (*(const void**)(uintptr_t(pc) * VM_THREADED_SCALE + threadedbias))
+#define VM_THREADED_PATCH(pc, op) \
+    if (Threaded) \
+    VM_THREADED_SLOT(pc) = kDispatchTable[uint8_t(op)]
+#define VM_THREADED_ENTER(p) \
+    if (Threaded) \
+    { \
+        if (LUAU_UNLIKELY(!(p)->threadedcode)) \
+            luau_buildthreaded(L, p, kDispatchTable); \
+        threadedbias = uintptr_t((p)->threadedcode) - uintptr_t((p)->code) * VM_THREADED_SCALE; \
+    }
 #else
 #define VM_CASE(op) case op:
 #define VM_NEXT() goto dispatch
+#define VM_ENTER() goto dispatch
 #define VM_CONTINUE(op) \
     dispatchOp = uint8_t(op); \
     goto dispatchContinue
+#define VM_THREADED_PATCH(pc, op) \
+    { \
+    }
+#define VM_THREADED_ENTER(p) \
+    { \
+    }
 #endif
 
 // Does VM support native execution via ExecutionCallbacks? We mostly assume it does but keep the define to make it easy to quantify the cost.
 #define VM_HAS_NATIVE 1
 
+// Counts loop iterations of functions that are profiled by the native code generator, see Proto::hotcount
+#if VM_HAS_NATIVE
+#define VM_PROFILE_LOOP() \
+    { \
+        Proto* p = cl->l.p; \
+        if (LUAU_UNLIKELY(p->hotcount != 0) && --p->hotcount == 0) \
+        { \
+            VM_PROTECT(L->global->ecb.hot(L, p)); \
+        } \
+    }
+#else
+#define VM_PROFILE_LOOP() \
+    { \
+    }
+#endif
+
 LUAU_FASTFLAGVARIABLE(LuauTaggedLuData, false)
+LUAU_FASTFLAGVARIABLE(LuauThreadedDispatch, false)
 
 LUAU_NOINLINE void luau_callhook(lua_State* L, lua_Hook hook, void* userdata)
 {
@@ -193,7 +235,23 @@ inline bool luau_skipstep(uint8_t op)
     return op == LOP_PREPVARARGS || op == LOP_BREAK;
 }
 
-template<bool SingleStep>
+#if VM_USE_CGOTO
+static_assert(sizeof(void*) % sizeof(Instruction) == 0, "threaded code entries must be addressed by scaling the instruction address");
+
+// note: operands of multi-word instructions get an entry as well; it's never dispatched to so its value doesn't matter
+LUAU_NOINLINE static void luau_buildthreaded(lua_State* L, Proto* p, const void* const* dispatch)
+{
+    const void** code = luaM_newarray(L, p->sizecode, const void*, p->memcat);
+
+    for (int i = 0; i < p->sizecode; ++i)
+        code[i] = dispatch[LUAU_INSN_OP(p->code[i])];
+
+    L->global->threadeddispatch = dispatch;
+    p->threadedcode = code;
+}
+#endif
+
+template<bool SingleStep, bool Threaded>
 static void luau_execute(lua_State* L)
 {
 #if VM_USE_CGOTO
@@ -206,6 +264,7 @@ static void luau_execute(lua_State* L)
     StkId base;
     TValue* k;
     const Instruction* pc;
+    uintptr_t threadedbias = 0;
 
     LUAU_ASSERT(isLua(L->ci));
     LUAU_ASSERT(L->isactive);
@@ -231,6 +290,8 @@ reentry:
     base = L->base;
     k = cl->l.p->k;
 
+    VM_THREADED_ENTER(cl->l.p);
+
     VM_NEXT(); // starts the interpreter "loop"
 
     {
@@ -243,6 +304,12 @@ reentry:
         // ... and singlestep logic :)
         if (SingleStep)
         {
+            if (uint64_t* opcodecounts = L->global->opcodecounts)
+            {
+                opcodecounts[LUAU_INSN_OP(*pc)]++;
+                cl->l.p->execcount++;
+            }
+
             if (L->global->cb.debugstep && !luau_skipstep(LUAU_INSN_OP(*pc)))
             {
                 VM_PROTECT(luau_callhook(L, L->global->cb.debugstep, NULL));
@@ -267,7 +334,7 @@ reentry:
             VM_CASE(LOP_NOP)
             {
                 Instruction insn = *pc++;
-                LUAU_ASSERT(insn == 0);
+                LUAU_ASSERT(LUAU_INSN_E(insn) == 0 || LUAU_INSN_E(insn) == 1); // E=1 marks a reached coverage instruction
                 VM_NEXT();
             }
 
@@ -321,6 +388,21 @@ reentry:
                 VM_NEXT();
             }
 
+            VM_CASE(LOP_MOVE2)
+            {
+                Instruction insn = *pc++;
+                uint32_t aux = *pc++;
+                StkId ra = VM_REG(LUAU_INSN_A(insn));
+                StkId rb = VM_REG(LUAU_INSN_B(insn));
+                StkId rc = VM_REG(aux & 0xff);
+                StkId rd = VM_REG((aux >> 8) & 0xff);
+
+                // second move observes the result of the first one
+                setobj2s(L, ra, rb);
+                setobj2s(L, rc, rd);
+                VM_NEXT();
+            }
+
             VM_CASE(LOP_GETGLOBAL)
             {
                 Instruction insn = *pc++;
@@ -489,6 +571,17 @@ reentry:
                 }
                 else
                 {
+                    // fast-path: inline field of user data
+                    int field = ttisuserdata(rb) ? luaV_findudatafield(L, uvalue(rb), tsvalue(kv), LUAU_INSN_C(insn)) : -1;
+
+                    if (field >= 0)
+                    {
+                        luaV_getudatafield(L, uvalue(rb), field, ra);
+                        // save field index to accelerate future lookups; patches currently executing instruction since pc-2 rolls back two pc++
+                        VM_PATCH_C(pc - 2, field);
+                        VM_NEXT();
+                    }
+
                     // fast-path: user data with C __index TM
                     const TValue* fn = 0;
                     if (ttisuserdata(rb) && (fn = fasttm(L, uvalue(rb)->metatable, TM_INDEX)) && ttisfunction(fn) && clvalue(fn)->isC)
@@ -604,6 +697,17 @@ reentry:
                 }
                 else
                 {
+                    // fast-path: inline field of user data
+                    int field = ttisuserdata(rb) ? luaV_findudatafield(L, uvalue(rb), tsvalue(kv), LUAU_INSN_C(insn)) : -1;
+
+                    if (field >= 0)
+                    {
+                        VM_PROTECT(luaV_setudatafield(L, uvalue(rb), field, ra));
+                        // save field index to accelerate future lookups; patches currently executing instruction since pc-2 rolls back two pc++
+                        VM_PATCH_C(pc - 2, field);
+                        VM_NEXT();
+                    }
+
                     // fast-path: user data with C __newindex TM
                     const TValue* fn = 0;
                     if (ttisuserdata(rb) && (fn = fasttm(L, uvalue(rb)->metatable, TM_NEWINDEX)) && ttisfunction(fn) && clvalue(fn)->isC)
@@ -760,6 +864,10 @@ reentry:
 
                 VM_PROTECT_PC(); // luaF_newLclosure may fail due to OOM
 
+                // lazily loaded functions are decoded on first closure creation
+                if (LUAU_UNLIKELY(pv->lazychunk != NULL))
+                    luaV_loadproto(L, pv);
+
                 // note: we save closure to stack early in case the code below wants to capture it by value
                 Closure* ncl = luaF_newLclosure(L, pv->nups, cl->env, pv);
                 setclvalue(L, ra, ncl);
@@ -776,6 +884,7 @@ reentry:
                         break;
 
                     case LCT_REF:
+                        LUAU_ASSERT((pv->flags & LPF_UPVALS_BY_VALUE) == 0);
                         setupvalue(L, &ncl->l.uprefs[ui], luaF_findupval(L, VM_REG(LUAU_INSN_B(uinsn))));
                         break;
 
@@ -828,6 +937,16 @@ reentry:
                         setobj2s(L, ra + 1, rb);
                         setobj2s(L, ra, gval(mtn));
                     }
+                    // fast-path: key is absent from the base, table has an __index table, and it has the result in another slot
+                    // this happens when the call site is polymorphic, and objects with different __index tables keep replacing the slot
+                    else if (mt && ttistable(mt) && (mtn = luaH_getstrnode(hvalue(mt), tsvalue(kv))) && !ttisnil(gval(mtn)))
+                    {
+                        // note: order of copies allows rb to alias ra+1 or ra
+                        setobj2s(L, ra + 1, rb);
+                        setobj2s(L, ra, gval(mtn));
+                        // save slot to accelerate future lookups; patches currently executing instruction since pc-2 rolls back two pc++
+                        VM_PATCH_C(pc - 2, int(mtn - hvalue(mt)->node));
+                    }
                     else
                     {
                         // slow-path: handles full table lookup
@@ -869,6 +988,15 @@ reentry:
                             setobj2s(L, ra + 1, rb);
                             setobj2s(L, ra, gval(n));
                         }
+                        // fast-path: metatable with __index that has method in another slot, which is common for polymorphic call sites
+                        else if ((n = luaH_getstrnode(h, tsvalue(kv))) && !ttisnil(gval(n)))
+                        {
+                            // note: order of copies allows rb to alias ra+1 or ra
+                            setobj2s(L, ra + 1, rb);
+                            setobj2s(L, ra, gval(n));
+                            // save slot to accelerate future lookups; patches currently executing instruction since pc-2 rolls back two pc++
+                            VM_PATCH_C(pc - 2, int(n - h->node));
+                        }
                         else
                         {
                             // slow-path: handles slot mismatch
@@ -895,6 +1023,10 @@ reentry:
                     }
                 }
 
+                // method calls in tail position continue through TAILCALL, which falls back to CALL by itself
+                if (LUAU_INSN_OP(*pc) == LOP_TAILCALL)
+                    VM_CONTINUE(LOP_TAILCALL);
+
                 // intentional fallthrough to CALL
                 LUAU_ASSERT(LUAU_INSN_OP(*pc) == LOP_CALL);
             }
@@ -921,8 +1053,16 @@ reentry:
                 }
 
                 Closure* ccl = clvalue(ra);
+
+                // fast C functions with a matching signature skip the call frame setup
+                if (ccl->isC && ccl->c.fast && luaV_fastcall(L, ccl->c.fast, ra, argtop, nresults))
+                    VM_NEXT();
+
                 L->ci->savedpc = pc;
 
+                if (!ccl->isC)
+                    VM_THREADED_ENTER(ccl->l.p);
+
                 CallInfo* ci = incr_ci(L);
                 ci->func = ra;
                 ci->base = ra + 1;
@@ -960,7 +1100,7 @@ reentry:
                     cl = ccl;
                     base = L->base;
                     k = p->k;
-                    VM_NEXT();
+                    VM_ENTER();
                 }
                 else
                 {
@@ -997,6 +1137,75 @@ reentry:
                 }
             }
 
+            VM_CASE(LOP_TAILCALL)
+            {
+                Instruction insn = *pc;
+                StkId ra = VM_REG(LUAU_INSN_A(insn));
+
+                LUAU_ASSERT(LUAU_INSN_C(insn) == 0);
+                LUAU_ASSERT(LUAU_INSN_OP(pc[1]) == LOP_RETURN);
+
+                // only Lua functions can take over the frame; the first frame of the interpreter entry has to stay to return from luau_execute
+                // when single-stepping, the debugger observes regular frames
+                if (!ttisfunction(ra) || clvalue(ra)->isC || (L->ci->flags & LUA_CALLINFO_RETURN) || SingleStep)
+                    VM_CONTINUE(LOP_CALL);
+
+                VM_INTERRUPT();
+                pc++;
+
+                ra = VM_REG(LUAU_INSN_A(insn)); // interrupt may have reallocated the stack
+
+                int nparams = LUAU_INSN_B(insn) - 1;
+                StkId argtop = (nparams == LUA_MULTRET) ? L->top : ra + 1 + nparams;
+
+                Closure* ccl = clvalue(ra);
+                Proto* p = ccl->l.p;
+
+                CallInfo* ci = L->ci;
+                StkId func = ci->func;
+
+                VM_PROTECT_PC(); // luau_buildthreaded may fail
+                VM_THREADED_ENTER(p);
+
+                // the compiler closes upvalues before returning so this is normally a no-op
+                luaF_close(L, base);
+
+                // move function and arguments over the current frame; for variadic functions this discards the variadic part as well
+                int n = cast_int(argtop - ra);
+                for (int i = 0; i < n; ++i)
+                    setobj2s(L, func + i, ra + i);
+
+                // the frame keeps nresults of the original call since the callee returns directly to our caller
+                ci->base = func + 1;
+                ci->top = func + n + ccl->stacksize; // note: technically UB since we haven't reallocated the stack yet
+                ci->savedpc = NULL;
+                ci->flags = 0;
+
+                L->base = ci->base;
+                L->top = func + n;
+
+                // note: this reallocs stack, but we don't need to VM_PROTECT this
+                // this is because we're going to modify base/savedpc manually anyhow
+                luaD_checkstack(L, ccl->stacksize);
+
+                LUAU_ASSERT(ci->top <= L->stack_last);
+
+                // fill unused parameters with nil
+                StkId argi = L->top;
+                StkId argend = L->base + p->numparams;
+                while (argi < argend)
+                    setnilvalue(argi++); // complete missing arguments
+                L->top = p->is_vararg ? argi : ci->top;
+
+                // reentry
+                // codeentry may point to NATIVECALL instruction when proto is compiled to native code
+                pc = p->codeentry;
+                cl = ccl;
+                base = L->base;
+                k = p->k;
+                VM_ENTER();
+            }
+
             VM_CASE(LOP_RETURN)
             {
                 VM_INTERRUPT();
@@ -1050,6 +1259,9 @@ reentry:
                 }
 #endif
 
+                // the caller is normally prepared already, unless it started in a different interpreter
+                VM_THREADED_ENTER(nextproto);
+
                 // reentry
                 pc = cip->savedpc;
                 cl = nextcl;
@@ -2151,7 +2363,11 @@ reentry:
 
                 VM_PROTECT_PC(); // luaH_new may fail due to OOM
 
-                sethvalue(L, ra, luaH_new(L, aux, b == 0 ? 0 : (1 << (b - 1))));
+                int nhash = b == 0 ? 0 : (1 << (b - 1));
+                Table* h = LUAU_UNLIKELY(L->global->tablefeedback) ? luaH_newatsite(L, cl->l.p, int(pc - 2 - cl->l.p->code), aux, nhash)
+                                                                   : luaH_new(L, aux, nhash);
+
+                sethvalue(L, ra, h);
                 VM_PROTECT(luaC_checkGC(L));
                 VM_NEXT();
             }
@@ -2233,6 +2449,7 @@ reentry:
             VM_CASE(LOP_FORNLOOP)
             {
                 VM_INTERRUPT();
+                VM_PROFILE_LOOP();
                 Instruction insn = *pc++;
                 StkId ra = VM_REG(LUAU_INSN_A(insn));
                 LUAU_ASSERT(ttisnumber(ra + 0) && ttisnumber(ra + 1) && ttisnumber(ra + 2));
@@ -2318,6 +2535,7 @@ reentry:
             VM_CASE(LOP_FORGLOOP)
             {
                 VM_INTERRUPT();
+                VM_PROFILE_LOOP();
                 Instruction insn = *pc++;
                 StkId ra = VM_REG(LUAU_INSN_A(insn));
                 uint32_t aux = *pc;
@@ -2470,7 +2688,7 @@ reentry:
             VM_CASE(LOP_NATIVECALL)
             {
                 Proto* p = cl->l.p;
-                LUAU_ASSERT(p->execdata);
+                LUAU_ASSERT(p->execdata || p->hotcount);
 
                 CallInfo* ci = L->ci;
                 ci->flags = LUA_CALLINFO_NATIVE;
@@ -2526,6 +2744,10 @@ reentry:
 
                 VM_PROTECT_PC(); // luaF_newLclosure may fail due to OOM
 
+                // lazily loaded functions are decoded on first closure creation
+                if (LUAU_UNLIKELY(kcl->l.p->lazychunk != NULL))
+                    luaV_loadproto(L, kcl->l.p);
+
                 // clone closure if the environment is not shared
                 // note: we save closure to stack early in case the code below wants to capture it by value
                 Closure* ncl = (kcl->env == cl->env) ? kcl : luaF_newLclosure(L, kcl->nupvalues, cl->env, kcl->l.p);
@@ -2606,6 +2828,7 @@ reentry:
             VM_CASE(LOP_JUMPBACK)
             {
                 VM_INTERRUPT();
+                VM_PROFILE_LOOP();
                 Instruction insn = *pc++;
 
                 pc += LUAU_INSN_D(insn);
@@ -2686,6 +2909,15 @@ reentry:
             VM_CASE(LOP_COVERAGE)
             {
                 Instruction insn = *pc++;
+
+                // the opcode is BREAK instead when a breakpoint is set on the instruction; it keeps counting in that case
+                if (L->global->coveragefirsthit && LUAU_INSN_OP(insn) == LOP_COVERAGE)
+                {
+                    *const_cast<Instruction*>(pc - 1) = LOP_NOP | (1 << 8);
+                    VM_THREADED_PATCH(pc - 1, LOP_NOP);
+                    VM_NEXT();
+                }
+
                 int hits = LUAU_INSN_E(insn);
 
                 // update hits with saturated add and patch the instruction in place
@@ -2989,10 +3221,16 @@ exit:;
 
 void luau_execute(lua_State* L)
 {
-    if (L->singlestep)
-        luau_execute<true>(L);
+    // opcode counters are maintained by the single-step interpreter so that regular execution doesn't pay for them
+    if (L->singlestep || L->global->opcodecounts)
+        luau_execute<true, false>(L);
+#if VM_USE_CGOTO
+    // threaded interpreter trades a pointer per instruction of each executed function for cheaper dispatch
+    else if (FFlag::LuauThreadedDispatch)
+        luau_execute<false, true>(L);
+#endif
     else
-        luau_execute<false>(L);
+        luau_execute<false, false>(L);
 }
 
 int luau_precall(lua_State* L, StkId func, int nresults)
@@ -10,6 +10,7 @@
 #include "lmem.h"
 #include "lbytecode.h"
 #include "lapi.h"
+#include "lbuffer.h"
 
 #include <string.h>
 
@@ -102,7 +103,39 @@ static unsigned int readVarInt(const char* data, size_t size, size_t& offset)
     return result;
 }
 
-static TString* readString(TempBuffer<TString*>& strings, const char* data, size_t size, size_t& offset)
+// Chunk table of lazily loaded functions starts with the bytecode buffer, environment and versions, followed by the string and proto tables
+enum
+{
+    LAZY_BYTECODE,
+    LAZY_ENV,
+    LAZY_VERSION,
+    LAZY_STRINGCOUNT,
+    LAZY_STRINGS,
+};
+
+// Lazily loaded functions find strings and protos in the chunk table, with the same indexing as the buffers used by the loader
+struct ChunkStrings
+{
+    const TValue* objects;
+
+    TString* operator[](size_t index)
+    {
+        return tsvalue(&objects[index]);
+    }
+};
+
+struct ChunkProtos
+{
+    const TValue* objects;
+
+    Proto* operator[](size_t index)
+    {
+        return gco2p(gcvalue(&objects[index]));
+    }
+};
+
+template<typename Strings>
+static TString* readString(Strings& strings, const char* data, size_t size, size_t& offset)
 {
     unsigned int id = readVarInt(data, size, offset);
 
@@ -153,12 +186,834 @@ static void resolveImportSafe(lua_State* L, Table* env, TValue* k, uint32_t id)
     }
 }
 
-int luau_load(lua_State* L, const char* chunkname, const char* data, size_t size, int env)
+// Lazily loaded functions are decoded while the VM is running, so imports are resolved with raw lookups that can't run any code
+// Imports that can't be resolved this way are left nil, and GETIMPORT performs a full lookup at runtime instead
+static void resolveImportRaw(lua_State* L, Table* env, TValue* k, uint32_t id, TValue* res)
+{
+    setnilvalue(res);
+
+    if (!env->safeenv)
+        return;
+
+    int count = id >> 30;
+    LUAU_ASSERT(count > 0);
+
+    int ids[3] = {int(id >> 20) & 1023, int(id >> 10) & 1023, int(id) & 1023};
+
+    const TValue* value = luaH_getstr(env, tsvalue(&k[ids[0]]));
+
+    for (int i = 1; i < count; ++i)
+    {
+        if (!ttistable(value))
+            return;
+
+        value = luaH_getstr(hvalue(value), tsvalue(&k[ids[i]]));
+    }
+
+    setobj2n(L, res, value);
+}
+
+// Decodes LZ4 block format produced by BytecodeBuilder::compress; returns false if the block is malformed
+static bool decompress(char* out, size_t outsize, const char* data, size_t size)
+{
+    const uint8_t* ip = reinterpret_cast<const uint8_t*>(data);
+    const uint8_t* iend = ip + size;
+    size_t op = 0;
+
+    while (ip < iend)
+    {
+        uint8_t token = *ip++;
+
+        size_t literals = token >> 4;
+
+        if (literals == 15)
+        {
+            uint8_t b;
+
+            do
+            {
+                if (ip >= iend)
+                    return false;
+
+                b = *ip++;
+                literals += b;
+            } while (b == 255);
+        }
+
+        if (size_t(iend - ip) < literals || outsize - op < literals)
+            return false;
+
+        memcpy(out + op, ip, literals);
+        ip += literals;
+        op += literals;
+
+        // last sequence doesn't have a match
+        if (ip == iend)
+            break;
+
+        if (iend - ip < 2)
+            return false;
+
+        size_t offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+
+        if (offset == 0 || offset > op)
+            return false;
+
+        size_t match = (token & 15) + 4;
+
+        if ((token & 15) == 15)
+        {
+            uint8_t b;
+
+            do
+            {
+                if (ip >= iend)
+                    return false;
+
+                b = *ip++;
+                match += b;
+            } while (b == 255);
+        }
+
+        if (outsize - op < match)
+            return false;
+
+        // matches can overlap the output they produce, so this has to copy byte by byte
+        for (size_t i = 0; i < match; ++i, ++op)
+            out[op] = out[op - offset];
+    }
+
+    return op == outsize;
+}
+
+template<typename Strings, typename Protos>
+static void loadfunction(lua_State* L, Proto* p, const char* data, size_t size, size_t& offset, uint8_t version, uint8_t typesversion, Table* envt,
+    Strings& strings, Protos& protos, bool lazy)
+{
+    if (version >= 4)
+    {
+        p->flags = read<uint8_t>(data, size, offset);
+
+        uint32_t typesize = readVarInt(data, size, offset);
+
+        if (typesize && typesversion == LBC_TYPE_VERSION)
+        {
+            uint8_t* types = (uint8_t*)data + offset;
+
+            LUAU_ASSERT(typesize == unsigned(2 + p->numparams));
+            LUAU_ASSERT(types[0] == LBC_TYPE_FUNCTION);
+            LUAU_ASSERT(types[1] == p->numparams);
+
+            p->typeinfo = luaM_newarray(L, typesize, uint8_t, p->memcat);
+            memcpy(p->typeinfo, types, typesize);
+        }
+
+        offset += typesize;
+    }
+
+    p->sizecode = readVarInt(data, size, offset);
+    p->code = luaM_newarray(L, p->sizecode, Instruction, p->memcat);
+    for (int j = 0; j < p->sizecode; ++j)
+        p->code[j] = read<uint32_t>(data, size, offset);
+
+    p->codeentry = p->code;
+
+    p->sizek = readVarInt(data, size, offset);
+    p->k = luaM_newarray(L, p->sizek, TValue, p->memcat);
+
+#ifdef HARDMEMTESTS
+    // this is redundant during normal runs, but resolveImportSafe can trigger GC checks under HARDMEMTESTS
+    // because p->k isn't fully formed at this point, we pre-fill it with nil to make subsequent setup safe
+    for (int j = 0; j < p->sizek; ++j)
+    {
+        setnilvalue(&p->k[j]);
+    }
+#endif
+
+    for (int j = 0; j < p->sizek; ++j)
+    {
+        switch (read<uint8_t>(data, size, offset))
+        {
+        case LBC_CONSTANT_NIL:
+            setnilvalue(&p->k[j]);
+            break;
+
+        case LBC_CONSTANT_BOOLEAN:
+        {
+            uint8_t v = read<uint8_t>(data, size, offset);
+            setbvalue(&p->k[j], v);
+            break;
+        }
+
+        case LBC_CONSTANT_NUMBER:
+        {
+            double v = read<double>(data, size, offset);
+            setnvalue(&p->k[j], v);
+            break;
+        }
+
+        case LBC_CONSTANT_VECTOR:
+        {
+            float x = read<float>(data, size, offset);
+            float y = read<float>(data, size, offset);
+            float z = read<float>(data, size, offset);
+            float w = read<float>(data, size, offset);
+            (void)w;
+            setvvalue(&p->k[j], x, y, z, w);
+            break;
+        }
+
+        case LBC_CONSTANT_STRING:
+        {
+            TString* v = readString(strings, data, size, offset);
+            setsvalue(L, &p->k[j], v);
+            break;
+        }
+
+        case LBC_CONSTANT_IMPORT:
+        {
+            uint32_t iid = read<uint32_t>(data, size, offset);
+
+            if (lazy)
+            {
+                resolveImportRaw(L, envt, p->k, iid, &p->k[j]);
+            }
+            else
+            {
+                resolveImportSafe(L, envt, p->k, iid);
+                setobj(L, &p->k[j], L->top - 1);
+                L->top--;
+            }
+            break;
+        }
+
+        case LBC_CONSTANT_TABLE:
+        {
+            int keys = readVarInt(data, size, offset);
+            Table* h = luaH_new(L, 0, keys);
+            for (int i = 0; i < keys; ++i)
+            {
+                int key = readVarInt(data, size, offset);
+                TValue* val = luaH_set(L, h, &p->k[key]);
+                setnvalue(val, 0.0);
+            }
+            sethvalue(L, &p->k[j], h);
+            break;
+        }
+
+        case LBC_CONSTANT_CLOSURE:
+        {
+            uint32_t fid = readVarInt(data, size, offset);
+            Closure* cl = luaF_newLclosure(L, protos[fid]->nups, envt, protos[fid]);
+            cl->preload = (cl->nupvalues > 0);
+            setclvalue(L, &p->k[j], cl);
+            break;
+        }
+
+        default:
+            LUAU_ASSERT(!"Unexpected constant kind");
+        }
+    }
+
+    p->sizep = readVarInt(data, size, offset);
+    p->p = luaM_newarray(L, p->sizep, Proto*, p->memcat);
+    for (int j = 0; j < p->sizep; ++j)
+    {
+        uint32_t fid = readVarInt(data, size, offset);
+        p->p[j] = protos[fid];
+    }
+
+    p->linedefined = readVarInt(data, size, offset);
+    p->debugname = readString(strings, data, size, offset);
+}
+
+// Decodes line and local variable information that follows the function body; sizecode is passed separately so that the information can
+// be decoded into a temporary proto
+template<typename Strings>
+static void loaddebuginfo(lua_State* L, Proto* p, int sizecode, const char* data, size_t size, size_t& offset, Strings& strings)
+{
+    uint8_t lineinfo = read<uint8_t>(data, size, offset);
+
+    if (lineinfo)
+    {
+        p->linegaplog2 = read<uint8_t>(data, size, offset);
+
+        int intervals = ((sizecode - 1) >> p->linegaplog2) + 1;
+        int absoffset = (sizecode + 3) & ~3;
+
+        p->sizelineinfo = absoffset + intervals * sizeof(int);
+        p->lineinfo = luaM_newarray(L, p->sizelineinfo, uint8_t, p->memcat);
+        p->abslineinfo = (int*)(p->lineinfo + absoffset);
+
+        uint8_t lastoffset = 0;
+        for (int j = 0; j < sizecode; ++j)
+        {
+            lastoffset += read<uint8_t>(data, size, offset);
+            p->lineinfo[j] = lastoffset;
+        }
+
+        int lastline = 0;
+        for (int j = 0; j < intervals; ++j)
+        {
+            lastline += read<int32_t>(data, size, offset);
+            p->abslineinfo[j] = lastline;
+        }
+    }
+
+    uint8_t debuginfo = read<uint8_t>(data, size, offset);
+
+    if (debuginfo)
+    {
+        p->sizelocvars = readVarInt(data, size, offset);
+        p->locvars = luaM_newarray(L, p->sizelocvars, LocVar, p->memcat);
+
+        for (int j = 0; j < p->sizelocvars; ++j)
+        {
+            p->locvars[j].varname = readString(strings, data, size, offset);
+            p->locvars[j].startpc = readVarInt(data, size, offset);
+            p->locvars[j].endpc = readVarInt(data, size, offset);
+            p->locvars[j].reg = read<uint8_t>(data, size, offset);
+        }
+
+        p->sizeupvalues = readVarInt(data, size, offset);
+        p->upvalues = luaM_newarray(L, p->sizeupvalues, TString*, p->memcat);
+
+        for (int j = 0; j < p->sizeupvalues; ++j)
+        {
+            p->upvalues[j] = readString(strings, data, size, offset);
+        }
+    }
+}
+
+// Advances past the function body, only decoding the fields that are used before the body is loaded
+static void skipfunction(Proto* p, TempBuffer<TString*>& strings, const char* data, size_t size, size_t& offset, uint8_t version)
+{
+    if (version >= 4)
+    {
+        p->flags = read<uint8_t>(data, size, offset);
+
+        uint32_t typesize = readVarInt(data, size, offset);
+        offset += typesize;
+    }
+
+    int sizecode = readVarInt(data, size, offset);
+    offset += sizecode * sizeof(uint32_t);
+
+    int sizek = readVarInt(data, size, offset);
+
+    for (int j = 0; j < sizek; ++j)
+    {
+        switch (read<uint8_t>(data, size, offset))
+        {
+        case LBC_CONSTANT_NIL:
+            break;
+
+        case LBC_CONSTANT_BOOLEAN:
+            offset += sizeof(uint8_t);
+            break;
+
+        case LBC_CONSTANT_NUMBER:
+            offset += sizeof(double);
+            break;
+
+        case LBC_CONSTANT_VECTOR:
+            offset += sizeof(float) * 4;
+            break;
+
+        case LBC_CONSTANT_STRING:
+        case LBC_CONSTANT_CLOSURE:
+            readVarInt(data, size, offset);
+            break;
+
+        case LBC_CONSTANT_IMPORT:
+            offset += sizeof(uint32_t);
+            break;
+
+        case LBC_CONSTANT_TABLE:
+        {
+            int keys = readVarInt(data, size, offset);
+            for (int i = 0; i < keys; ++i)
+                readVarInt(data, size, offset);
+            break;
+        }
+
+        default:
+            LUAU_ASSERT(!"Unexpected constant kind");
+        }
+    }
+
+    int sizep = readVarInt(data, size, offset);
+    for (int j = 0; j < sizep; ++j)
+        readVarInt(data, size, offset);
+
+    p->linedefined = readVarInt(data, size, offset);
+    p->debugname = readString(strings, data, size, offset);
+
+    uint8_t lineinfo = read<uint8_t>(data, size, offset);
+
+    if (lineinfo)
+    {
+        int linegaplog2 = read<uint8_t>(data, size, offset);
+        int intervals = ((sizecode - 1) >> linegaplog2) + 1;
+
+        offset += sizecode + intervals * sizeof(int32_t);
+    }
+
+    uint8_t debuginfo = read<uint8_t>(data, size, offset);
+
+    if (debuginfo)
+    {
+        int sizelocvars = readVarInt(data, size, offset);
+
+        for (int j = 0; j < sizelocvars; ++j)
+        {
+            readVarInt(data, size, offset);
+            readVarInt(data, size, offset);
+            readVarInt(data, size, offset);
+            offset += sizeof(uint8_t);
+        }
+
+        int sizeupvalues = readVarInt(data, size, offset);
+        for (int j = 0; j < sizeupvalues; ++j)
+            readVarInt(data, size, offset);
+    }
+}
+
+void luaV_loadproto(lua_State* L, Proto* p)
+{
+    Table* chunk = p->lazychunk;
+    LUAU_ASSERT(chunk && chunk->sizearray >= LAZY_STRINGS);
+
+    Buffer* bytecode = bufvalue(&chunk->array[LAZY_BYTECODE]);
+    Table* envt = hvalue(&chunk->array[LAZY_ENV]);
+    int version = int(nvalue(&chunk->array[LAZY_VERSION]));
+    int stringCount = int(nvalue(&chunk->array[LAZY_STRINGCOUNT]));
+
+    ChunkStrings strings = {&chunk->array[LAZY_STRINGS]};
+    ChunkProtos protos = {&chunk->array[LAZY_STRINGS + stringCount]};
+
+    // body is decoded into a temporary proto first, so that a memory error halfway through doesn't leave a reachable proto half-built
+    Proto* np = luaF_newproto(L);
+    np->memcat = p->memcat;
+    np->numparams = p->numparams;
+
+    const char* data = (const char*)bufferdata(bytecode);
+    size_t size = bufferlen(bytecode);
+
+    size_t offset = p->lazyoffset;
+    loadfunction(L, np, data, size, offset, uint8_t(version & 0xff), uint8_t(version >> 8), envt, strings, protos, /* lazy= */ true);
+
+    // debug information is left encoded when requested, unless the function doesn't have any; see lua_setlazydebuginfo
+    // each of the two flags is followed by the information it guards, so the second flag is only adjacent when the first one is 0
+    bool lazydebuginfo = L->global->lazydebuginfo && (data[offset] != 0 || data[offset + 1] != 0);
+    size_t debugoffset = offset;
+
+    if (!lazydebuginfo)
+        loaddebuginfo(L, np, np->sizecode, data, size, offset, strings);
+
+    p->flags = np->flags;
+    p->typeinfo = np->typeinfo;
+    p->code = np->code;
+    p->codeentry = np->codeentry;
+    p->sizecode = np->sizecode;
+    p->k = np->k;
+    p->sizek = np->sizek;
+    p->p = np->p;
+    p->sizep = np->sizep;
+    p->linedefined = np->linedefined;
+    p->debugname = np->debugname;
+    p->linegaplog2 = np->linegaplog2;
+    p->lineinfo = np->lineinfo;
+    p->abslineinfo = np->abslineinfo;
+    p->sizelineinfo = np->sizelineinfo;
+    p->locvars = np->locvars;
+    p->sizelocvars = np->sizelocvars;
+    p->upvalues = np->upvalues;
+    p->sizeupvalues = np->sizeupvalues;
+
+    // temporary proto doesn't own any data now and is left to the collector
+    np->typeinfo = NULL;
+    np->code = NULL;
+    np->sizecode = 0;
+    np->k = NULL;
+    np->sizek = 0;
+    np->p = NULL;
+    np->sizep = 0;
+    np->lineinfo = NULL;
+    np->sizelineinfo = 0;
+    np->locvars = NULL;
+    np->sizelocvars = 0;
+    np->upvalues = NULL;
+    np->sizeupvalues = 0;
+
+    if (lazydebuginfo)
+    {
+        p->debugchunk = chunk;
+        p->lazyoffset = int(debugoffset);
+    }
+
+    p->lazychunk = NULL;
+
+    // proto could have been traversed by the collector before its body was decoded, so it has to be traversed again
+    luaC_barrierfast(L, p);
+}
+
+int luaV_getdebugline(Proto* p, int pc)
+{
+    Table* chunk = p->debugchunk;
+    LUAU_ASSERT(chunk && pc >= 0 && pc < p->sizecode);
+
+    Buffer* bytecode = bufvalue(&chunk->array[LAZY_BYTECODE]);
+    const char* data = (const char*)bufferdata(bytecode);
+    size_t size = bufferlen(bytecode);
+
+    size_t offset = p->lazyoffset;
+
+    if (!read<uint8_t>(data, size, offset))
+        return 0;
+
+    int linegaplog2 = read<uint8_t>(data, size, offset);
+
+    // line offsets and absolute lines are both delta-encoded, so the prefix up to pc is summed in place without decoding the arrays
+    uint8_t lineoffset = 0;
+    for (int j = 0; j <= pc; ++j)
+        lineoffset += uint8_t(data[offset + j]);
+
+    offset += p->sizecode;
+
+    int line = 0;
+    for (int j = 0; j <= (pc >> linegaplog2); ++j)
+        line += read<int32_t>(data, size, offset);
+
+    return line + lineoffset;
+}
+
+static void freedebuginfo(lua_State* L, Proto* p)
+{
+    if (p->lineinfo)
+        luaM_freearray(L, p->lineinfo, p->sizelineinfo, uint8_t, p->memcat);
+    luaM_freearray(L, p->locvars, p->sizelocvars, struct LocVar, p->memcat);
+    luaM_freearray(L, p->upvalues, p->sizeupvalues, TString*, p->memcat);
+
+    p->lineinfo = NULL;
+    p->abslineinfo = NULL;
+    p->sizelineinfo = 0;
+    p->locvars = NULL;
+    p->sizelocvars = 0;
+    p->upvalues = NULL;
+    p->sizeupvalues = 0;
+}
+
+void luaV_loaddebuginfo(lua_State* L, Proto* p, bool keep)
+{
+    Table* chunk = p->debugchunk;
+    if (!chunk)
+        return;
+
+    global_State* g = L->global;
+
+    int slot = -1;
+    for (int i = 0; i < LUA_DEBUGCACHE; ++i)
+        if (g->debugcache[i] == p)
+            slot = i;
+
+    if (slot < 0)
+    {
+        Buffer* bytecode = bufvalue(&chunk->array[LAZY_BYTECODE]);
+        ChunkStrings strings = {&chunk->array[LAZY_STRINGS]};
+
+        // information is decoded into a temporary proto first, so that a memory error halfway through doesn't leave arrays half-built
+        Proto* np = luaF_newproto(L);
+        np->memcat = p->memcat;
+
+        size_t offset = p->lazyoffset;
+        loaddebuginfo(L, np, p->sizecode, (const char*)bufferdata(bytecode), bufferlen(bytecode), offset, strings);
+
+        p->linegaplog2 = np->linegaplog2;
+        p->lineinfo = np->lineinfo;
+        p->abslineinfo = np->abslineinfo;
+        p->sizelineinfo = np->sizelineinfo;
+        p->locvars = np->locvars;
+        p->sizelocvars = np->sizelocvars;
+        p->upvalues = np->upvalues;
+        p->sizeupvalues = np->sizeupvalues;
+
+        // temporary proto doesn't own any data now and is left to the collector
+        np->lineinfo = NULL;
+        np->sizelineinfo = 0;
+        np->locvars = NULL;
+        np->sizelocvars = 0;
+        np->upvalues = NULL;
+        np->sizeupvalues = 0;
+    }
+
+    if (keep)
+    {
+        if (slot >= 0)
+            g->debugcache[slot] = NULL;
+
+        p->debugchunk = NULL;
+    }
+    else if (slot < 0)
+    {
+        // the oldest entry gives its decoded information back; it stays encoded in the chunk and can be decoded again
+        if (Proto* old = g->debugcache[g->debugcachepos])
+            freedebuginfo(L, old);
+
+        g->debugcache[g->debugcachepos] = p;
+        g->debugcachepos = (g->debugcachepos + 1) % LUA_DEBUGCACHE;
+    }
+
+    // proto could have been traversed by the collector before the names were decoded
+    luaC_barrierfast(L, p);
+}
+
+static unsigned int hashproto(Proto* p)
+{
+    unsigned int h = unsigned(p->sizecode) ^ (unsigned(p->sizek) << 8) ^ (unsigned(p->sizep) << 16) ^ p->numparams;
+
+    for (int i = 0; i < p->sizecode; ++i)
+        h = (h ^ p->code[i]) * 16777619;
+
+    return h;
+}
+
+// Functions that have a body, debug information and no breakpoints can be compared with functions loaded from new bytecode
+static bool isreusable(Proto* p)
+{
+    return p->lazychunk == NULL && p->debugchunk == NULL && p->debuginsn == NULL;
+}
+
+static void collectprotos(lua_State* L, Table* candidates, Proto* p)
+{
+    if (!isreusable(p))
+        return;
+
+    TValue key;
+    setnvalue(&key, double(hashproto(p)));
+
+    // only one function is kept for each hash, since a function can only be reused once
+    if (ttisnil(luaH_get(candidates, &key)))
+        setptvalue(L, luaH_set(L, candidates, &key), p);
+
+    for (int i = 0; i < p->sizep; ++i)
+        collectprotos(L, candidates, p->p[i]);
+}
+
+// Functions in the constant table are either closures of nested functions or values of imports
+static bool isnestedclosure(Proto* p, const TValue* o)
+{
+    if (!ttisfunction(o) || clvalue(o)->isC)
+        return false;
+
+    for (int i = 0; i < p->sizep; ++i)
+        if (p->p[i] == clvalue(o)->l.p)
+            return true;
+
+    return false;
+}
+
+static bool sameconstant(lua_State* L, Proto* p, const TValue* a, Proto* old, const TValue* b)
+{
+    if (ttype(a) != ttype(b))
+        return false;
+
+    switch (ttype(a))
+    {
+    case LUA_TNUMBER:
+        // -0 and 0 compare equal, but they are different constants
+        return memcmp(&nvalue(a), &nvalue(b), sizeof(double)) == 0;
+
+    case LUA_TTABLE:
+    {
+        // table templates are created with the same size for the same keys, so it's enough to check that the keys of one are in the other
+        Table* ta = hvalue(a);
+        Table* tb = hvalue(b);
+
+        if (ta->sizearray != tb->sizearray || sizenode(ta) != sizenode(tb))
+            return false;
+
+        for (int i = 0; i < ta->sizearray; ++i)
+            if (ttisnil(&ta->array[i]) != ttisnil(&tb->array[i]))
+                return false;
+
+        int count = 0;
+
+        for (int i = 0; i < sizenode(ta); ++i)
+        {
+            LuaNode* n = gnode(ta, i);
+
+            if (ttisnil(gval(n)))
+                continue;
+
+            TValue key;
+            getnodekey(L, &key, n);
+
+            if (ttisnil(luaH_get(tb, &key)))
+                return false;
+
+            count++;
+        }
+
+        for (int i = 0; i < sizenode(tb); ++i)
+            count -= !ttisnil(gval(gnode(tb, i)));
+
+        return count == 0;
+    }
+
+    case LUA_TFUNCTION:
+        if (clvalue(a) == clvalue(b))
+            return true;
+
+        // nested functions of the new bytecode have already been replaced with the functions they reuse
+        return isnestedclosure(p, a) && isnestedclosure(old, b) && clvalue(a)->l.p == clvalue(b)->l.p;
+
+    default:
+        return luaO_rawequalObj(a, b);
+    }
+}
+
+// Line information is compared relative to the line the function is defined on, so that functions moved by edits above them are reused
+static bool sameproto(lua_State* L, Proto* p, Proto* old)
+{
+    if (p->source != old->source || p->debugname != old->debugname)
+        return false;
+
+    if (p->nups != old->nups || p->numparams != old->numparams || p->is_vararg != old->is_vararg || p->maxstacksize != old->maxstacksize ||
+        p->flags != old->flags)
+        return false;
+
+    if (p->sizecode != old->sizecode || p->sizek != old->sizek || p->sizep != old->sizep || p->sizelocvars != old->sizelocvars ||
+        p->sizeupvalues != old->sizeupvalues || p->sizelineinfo != old->sizelineinfo || p->linegaplog2 != old->linegaplog2)
+        return false;
+
+    if ((p->typeinfo == NULL) != (old->typeinfo == NULL) || (p->typeinfo && memcmp(p->typeinfo, old->typeinfo, 2 + p->numparams) != 0))
+        return false;
+
+    if (memcmp(p->code, old->code, p->sizecode * sizeof(Instruction)) != 0)
+        return false;
+
+    for (int i = 0; i < p->sizek; ++i)
+        if (!sameconstant(L, p, &p->k[i], old, &old->k[i]))
+            return false;
+
+    for (int i = 0; i < p->sizep; ++i)
+        if (p->p[i] != old->p[i])
+            return false;
+
+    for (int i = 0; i < p->sizelocvars; ++i)
+    {
+        LocVar* a = &p->locvars[i];
+        LocVar* b = &old->locvars[i];
+
+        if (a->varname != b->varname || a->startpc != b->startpc || a->endpc != b->endpc || a->reg != b->reg)
+            return false;
+    }
+
+    for (int i = 0; i < p->sizeupvalues; ++i)
+        if (p->upvalues[i] != old->upvalues[i])
+            return false;
+
+    if (p->lineinfo)
+    {
+        if (memcmp(p->lineinfo, old->lineinfo, p->sizecode) != 0)
+            return false;
+
+        int intervals = ((p->sizecode - 1) >> p->linegaplog2) + 1;
+
+        for (int i = 0; i < intervals; ++i)
+            if (p->abslineinfo[i] - p->linedefined != old->abslineinfo[i] - old->linedefined)
+                return false;
+    }
+
+    return true;
+}
+
+// Replaces functions of the new bytecode with identical functions that are already loaded, which keeps their native code
+static Proto* reuseprotos(lua_State* L, TempBuffer<Proto*>& protos, Proto* main, Proto* oldmain)
+{
+    Table* candidates = luaH_new(L, 0, 0);
+    collectprotos(L, candidates, oldmain);
+
+    // nested functions are stored before the functions that create them, so they are replaced first
+    for (size_t i = 0; i < protos.count; ++i)
+    {
+        Proto* p = protos[i];
+
+        for (int j = 0; j < p->sizek; ++j)
+        {
+            if (isnestedclosure(p, &p->k[j]))
+            {
+                Closure* cl = clvalue(&p->k[j]);
+                cl->l.p = protos[cl->l.p->bytecodeid];
+                luaC_objbarrier(L, cl, cl->l.p);
+            }
+        }
+
+        for (int j = 0; j < p->sizep; ++j)
+        {
+            p->p[j] = protos[p->p[j]->bytecodeid];
+            luaC_objbarrier(L, p, p->p[j]);
+        }
+
+        TValue key;
+        setnvalue(&key, double(hashproto(p)));
+
+        const TValue* candidate = luaH_get(candidates, &key);
+
+        if (ttisnil(candidate))
+            continue;
+
+        Proto* old = gco2p(gcvalue(candidate));
+
+        if (!sameproto(L, p, old))
+            continue;
+
+        setnilvalue(luaH_set(L, candidates, &key));
+
+        // reused function now describes the new source
+        if (old->lineinfo && old->linedefined != p->linedefined)
+        {
+            int intervals = ((old->sizecode - 1) >> old->linegaplog2) + 1;
+
+            for (int j = 0; j < intervals; ++j)
+                old->abslineinfo[j] += p->linedefined - old->linedefined;
+        }
+
+        old->linedefined = p->linedefined;
+
+        protos[i] = old;
+    }
+
+    return protos[main->bytecodeid];
+}
+
+// When release is set, lazily loaded functions reference the bytecode instead of copying it
+// When reuse is set, functions identical to functions of that closure are reused instead of the ones that are loaded
+static int loadchunk(lua_State* L, const char* chunkname, const char* data, size_t size, int env, bool lazy, void (*release)(void*, void*), void* ud,
+    Closure* reuse)
 {
     size_t offset = 0;
 
     uint8_t version = read<uint8_t>(data, size, offset);
 
+    if (version == LBC_COMPRESSED)
+    {
+        size_t rawsize = readVarInt(data, size, offset);
+        TempBuffer<char> raw(L, rawsize);
+
+        // compressed blobs can't be nested, since they would be decoded recursively
+        if (rawsize == 0 || !decompress(raw.data, rawsize, data + offset, size - offset) || uint8_t(raw.data[0]) == LBC_COMPRESSED)
+        {
+            char chunkbuf[LUA_IDSIZE];
+            const char* chunkid = luaO_chunkid(chunkbuf, sizeof(chunkbuf), chunkname, strlen(chunkname));
+            lua_pushfstring(L, "%s: malformed compressed bytecode", chunkid);
+            return 1;
+        }
+
+        return loadchunk(L, chunkname, raw.data, rawsize, env, lazy, NULL, NULL, reuse);
+    }
 
     // 0 means the rest of the bytecode is the error message
     if (version == 0)
@@ -213,6 +1068,34 @@ int luau_load(lua_State* L, const char* chunkname, const char* data, size_t size
     unsigned int protoCount = readVarInt(data, size, offset);
     TempBuffer<Proto*> protos(L, protoCount);
 
+    // lazily loaded functions keep the bytecode of the proto table and the objects they refer to alive through the chunk table
+    Table* chunk = NULL;
+    size_t chunkoffset = release ? 0 : offset;
+
+    if (lazy)
+    {
+        chunk = luaH_new(L, LAZY_STRINGS + stringCount + protoCount, 0);
+
+        if (release)
+        {
+            // shared bytecode is released by the host once the buffer is collected
+            setbufvalue(L, &chunk->array[LAZY_BYTECODE], luaB_newexternalbuffer(L, (void*)data, size, release, ud));
+        }
+        else
+        {
+            Buffer* bytecode = luaB_newbuffer(L, size - chunkoffset);
+            memcpy(bytecode->data, data + chunkoffset, size - chunkoffset);
+            setbufvalue(L, &chunk->array[LAZY_BYTECODE], bytecode);
+        }
+
+        sethvalue(L, &chunk->array[LAZY_ENV], envt);
+        setnvalue(&chunk->array[LAZY_VERSION], double(version | (typesversion << 8)));
+        setnvalue(&chunk->array[LAZY_STRINGCOUNT], double(stringCount));
+
+        for (unsigned int i = 0; i < stringCount; ++i)
+            setsvalue(L, &chunk->array[LAZY_STRINGS + i], strings[i]);
+    }
+
     for (unsigned int i = 0; i < protoCount; ++i)
     {
         Proto* p = luaF_newproto(L);
@@ -224,200 +1107,87 @@ int luau_load(lua_State* L, const char* chunkname, const char* data, size_t size
         p->nups = read<uint8_t>(data, size, offset);
         p->is_vararg = read<uint8_t>(data, size, offset);
 
-        if (version >= 4)
-        {
-            p->flags = read<uint8_t>(data, size, offset);
-
-            uint32_t typesize = readVarInt(data, size, offset);
-
-            if (typesize && typesversion == LBC_TYPE_VERSION)
-            {
-                uint8_t* types = (uint8_t*)data + offset;
-
-                LUAU_ASSERT(typesize == unsigned(2 + p->numparams));
-                LUAU_ASSERT(types[0] == LBC_TYPE_FUNCTION);
-                LUAU_ASSERT(types[1] == p->numparams);
-
-                p->typeinfo = luaM_newarray(L, typesize, uint8_t, p->memcat);
-                memcpy(p->typeinfo, types, typesize);
-            }
-
-            offset += typesize;
-        }
-
-        p->sizecode = readVarInt(data, size, offset);
-        p->code = luaM_newarray(L, p->sizecode, Instruction, p->memcat);
-        for (int j = 0; j < p->sizecode; ++j)
-            p->code[j] = read<uint32_t>(data, size, offset);
-
-        p->codeentry = p->code;
-
-        p->sizek = readVarInt(data, size, offset);
-        p->k = luaM_newarray(L, p->sizek, TValue, p->memcat);
-
-#ifdef HARDMEMTESTS
-        // this is redundant during normal runs, but resolveImportSafe can trigger GC checks under HARDMEMTESTS
-        // because p->k isn't fully formed at this point, we pre-fill it with nil to make subsequent setup safe
-        for (int j = 0; j < p->sizek; ++j)
-        {
-            setnilvalue(&p->k[j]);
-        }
-#endif
-
-        for (int j = 0; j < p->sizek; ++j)
+        if (chunk)
         {
-            switch (read<uint8_t>(data, size, offset))
-            {
-            case LBC_CONSTANT_NIL:
-                setnilvalue(&p->k[j]);
-                break;
-
-            case LBC_CONSTANT_BOOLEAN:
-            {
-                uint8_t v = read<uint8_t>(data, size, offset);
-                setbvalue(&p->k[j], v);
-                break;
-            }
-
-            case LBC_CONSTANT_NUMBER:
-            {
-                double v = read<double>(data, size, offset);
-                setnvalue(&p->k[j], v);
-                break;
-            }
-
-            case LBC_CONSTANT_VECTOR:
-            {
-                float x = read<float>(data, size, offset);
-                float y = read<float>(data, size, offset);
-                float z = read<float>(data, size, offset);
-                float w = read<float>(data, size, offset);
-                (void)w;
-                setvvalue(&p->k[j], x, y, z, w);
-                break;
-            }
+            p->lazychunk = chunk;
+            p->lazyoffset = int(offset - chunkoffset);
 
-            case LBC_CONSTANT_STRING:
-            {
-                TString* v = readString(strings, data, size, offset);
-                setsvalue(L, &p->k[j], v);
-                break;
-            }
-
-            case LBC_CONSTANT_IMPORT:
-            {
-                uint32_t iid = read<uint32_t>(data, size, offset);
-                resolveImportSafe(L, envt, p->k, iid);
-                setobj(L, &p->k[j], L->top - 1);
-                L->top--;
-                break;
-            }
-
-            case LBC_CONSTANT_TABLE:
-            {
-                int keys = readVarInt(data, size, offset);
-                Table* h = luaH_new(L, 0, keys);
-                for (int i = 0; i < keys; ++i)
-                {
-                    int key = readVarInt(data, size, offset);
-                    TValue* val = luaH_set(L, h, &p->k[key]);
-                    setnvalue(val, 0.0);
-                }
-                sethvalue(L, &p->k[j], h);
-                break;
-            }
-
-            case LBC_CONSTANT_CLOSURE:
-            {
-                uint32_t fid = readVarInt(data, size, offset);
-                Closure* cl = luaF_newLclosure(L, protos[fid]->nups, envt, protos[fid]);
-                cl->preload = (cl->nupvalues > 0);
-                setclvalue(L, &p->k[j], cl);
-                break;
-            }
+            setptvalue(L, &chunk->array[LAZY_STRINGS + stringCount + i], p);
 
-            default:
-                LUAU_ASSERT(!"Unexpected constant kind");
-            }
+            skipfunction(p, strings, data, size, offset, version);
         }
-
-        p->sizep = readVarInt(data, size, offset);
-        p->p = luaM_newarray(L, p->sizep, Proto*, p->memcat);
-        for (int j = 0; j < p->sizep; ++j)
+        else
         {
-            uint32_t fid = readVarInt(data, size, offset);
-            p->p[j] = protos[fid];
+            loadfunction(L, p, data, size, offset, version, typesversion, envt, strings, protos, /* lazy= */ false);
+            loaddebuginfo(L, p, p->sizecode, data, size, offset, strings);
         }
 
-        p->linedefined = readVarInt(data, size, offset);
-        p->debugname = readString(strings, data, size, offset);
-
-        uint8_t lineinfo = read<uint8_t>(data, size, offset);
+        protos[i] = p;
+    }
 
-        if (lineinfo)
-        {
-            p->linegaplog2 = read<uint8_t>(data, size, offset);
+    // "main" proto is pushed to Lua stack
+    uint32_t mainid = readVarInt(data, size, offset);
+    Proto* main = protos[mainid];
 
-            int intervals = ((p->sizecode - 1) >> p->linegaplog2) + 1;
-            int absoffset = (p->sizecode + 3) & ~3;
+    // main function is always called right away
+    if (main->lazychunk)
+        luaV_loadproto(L, main);
 
-            p->sizelineinfo = absoffset + intervals * sizeof(int);
-            p->lineinfo = luaM_newarray(L, p->sizelineinfo, uint8_t, p->memcat);
-            p->abslineinfo = (int*)(p->lineinfo + absoffset);
+    // imports of the reused functions were resolved in the environment of the old closure
+    if (reuse && reuse->env == envt)
+        main = reuseprotos(L, protos, main, reuse->l.p);
 
-            uint8_t lastoffset = 0;
-            for (int j = 0; j < p->sizecode; ++j)
-            {
-                lastoffset += read<uint8_t>(data, size, offset);
-                p->lineinfo[j] = lastoffset;
-            }
+    luaC_threadbarrier(L);
 
-            int lastline = 0;
-            for (int j = 0; j < intervals; ++j)
-            {
-                lastline += read<int32_t>(data, size, offset);
-                p->abslineinfo[j] = lastline;
-            }
-        }
+    Closure* cl = luaF_newLclosure(L, 0, envt, main);
+    setclvalue(L, L->top, cl);
+    incr_top(L);
 
-        uint8_t debuginfo = read<uint8_t>(data, size, offset);
+    L->global->GCthreshold = GCthreshold;
 
-        if (debuginfo)
-        {
-            p->sizelocvars = readVarInt(data, size, offset);
-            p->locvars = luaM_newarray(L, p->sizelocvars, LocVar, p->memcat);
+    return 0;
+}
 
-            for (int j = 0; j < p->sizelocvars; ++j)
-            {
-                p->locvars[j].varname = readString(strings, data, size, offset);
-                p->locvars[j].startpc = readVarInt(data, size, offset);
-                p->locvars[j].endpc = readVarInt(data, size, offset);
-                p->locvars[j].reg = read<uint8_t>(data, size, offset);
-            }
+int luau_load(lua_State* L, const char* chunkname, const char* data, size_t size, int env)
+{
+    return loadchunk(L, chunkname, data, size, env, /* lazy= */ false, NULL, NULL, NULL);
+}
 
-            p->sizeupvalues = readVarInt(data, size, offset);
-            p->upvalues = luaM_newarray(L, p->sizeupvalues, TString*, p->memcat);
+int luau_loadlazy(lua_State* L, const char* chunkname, const char* data, size_t size, int env)
+{
+    return loadchunk(L, chunkname, data, size, env, /* lazy= */ true, NULL, NULL, NULL);
+}
 
-            for (int j = 0; j < p->sizeupvalues; ++j)
-            {
-                p->upvalues[j] = readString(strings, data, size, offset);
-            }
-        }
+int luau_loadshared(lua_State* L, const char* chunkname, const char* data, size_t size, int env, void (*release)(void*, void*), void* ud)
+{
+    LUAU_ASSERT(release);
 
-        protos[i] = p;
+    // compressed bytecode is decoded into a temporary buffer, so the blob itself is never referenced
+    if (size != 0 && uint8_t(data[0]) == LBC_COMPRESSED)
+    {
+        int result = loadchunk(L, chunkname, data, size, env, /* lazy= */ true, NULL, NULL, NULL);
+        release(ud, (void*)data);
+        return result;
     }
 
-    // "main" proto is pushed to Lua stack
-    uint32_t mainid = readVarInt(data, size, offset);
-    Proto* main = protos[mainid];
+    int result = loadchunk(L, chunkname, data, size, env, /* lazy= */ true, release, ud, NULL);
 
-    luaC_threadbarrier(L);
+    // when the load fails, the chunk table that references the blob isn't created
+    if (result != 0)
+        release(ud, (void*)data);
 
-    Closure* cl = luaF_newLclosure(L, 0, envt, main);
-    setclvalue(L, L->top, cl);
-    incr_top(L);
+    return result;
+}
 
-    L->global->GCthreshold = GCthreshold;
+int luau_reload(lua_State* L, const char* chunkname, const char* data, size_t size, int env, int old)
+{
+    const TValue* o = luaA_toobject(L, old);
+    api_check(L, ttisfunction(o) && !clvalue(o)->isC);
 
-    return 0;
+    return loadchunk(L, chunkname, data, size, env, /* lazy= */ false, NULL, NULL, clvalue(o));
+}
+
+void lua_setlazydebuginfo(lua_State* L, int enabled)
+{
+    L->global->lazydebuginfo = bool(enabled);
 }
@@ -8,6 +8,7 @@
 #include "lgc.h"
 #include "ldo.h"
 #include "lnumutils.h"
+#include "ltm.h"
 
 #include <string.h>
 
@@ -93,12 +94,272 @@ static void callTM(lua_State* L, const TValue* f, const TValue* p1, const TValue
     luaD_call(L, L->top - 4, 0);
 }
 
+static size_t udatafieldsize(int type)
+{
+    switch (type)
+    {
+    case LUA_UDFIELD_NUMBER:
+        return sizeof(double);
+    case LUA_UDFIELD_FLOAT:
+        return sizeof(float);
+    case LUA_UDFIELD_INTEGER:
+        return sizeof(int);
+    case LUA_UDFIELD_BOOLEAN:
+        return sizeof(unsigned char);
+    case LUA_UDFIELD_VECTOR:
+        return sizeof(float) * LUA_VECTOR_SIZE;
+    default:
+        LUAU_ASSERT(!"Unknown userdata field type");
+        return 0;
+    }
+}
+
+// returns the index of the inline field `name' of userdata u, or -1 if the field doesn't exist or doesn't fit into userdata memory
+// hint is the index that the field had on a previous lookup
+int luaV_findudatafield(lua_State* L, Udata* u, TString* name, int hint)
+{
+    if (u->tag >= LUA_UTAG_LIMIT)
+        return -1;
+
+    const UdataField* fields = L->global->udatafields[u->tag];
+    int count = L->global->udatafieldcount[u->tag];
+
+    int index = -1;
+
+    if (unsigned(hint) < unsigned(count) && fields[hint].name == name)
+    {
+        index = hint;
+    }
+    else
+    {
+        for (int i = 0; i < count; i++)
+        {
+            if (fields[i].name == name)
+            {
+                index = i;
+                break;
+            }
+        }
+    }
+
+    if (index < 0 || fields[index].offset + udatafieldsize(fields[index].type) > size_t(u->len))
+        return -1;
+
+    return index;
+}
+
+void luaV_getudatafield(lua_State* L, Udata* u, int index, StkId val)
+{
+    const UdataField* field = &L->global->udatafields[u->tag][index];
+    const char* data = u->data + field->offset;
+
+    switch (field->type)
+    {
+    case LUA_UDFIELD_NUMBER:
+    {
+        double v;
+        memcpy(&v, data, sizeof(v));
+        setnvalue(val, v);
+        break;
+    }
+    case LUA_UDFIELD_FLOAT:
+    {
+        float v;
+        memcpy(&v, data, sizeof(v));
+        setnvalue(val, v);
+        break;
+    }
+    case LUA_UDFIELD_INTEGER:
+    {
+        int v;
+        memcpy(&v, data, sizeof(v));
+        setnvalue(val, v);
+        break;
+    }
+    case LUA_UDFIELD_BOOLEAN:
+        setbvalue(val, *data != 0);
+        break;
+    case LUA_UDFIELD_VECTOR:
+        memcpy(val->value.v, data, sizeof(float) * LUA_VECTOR_SIZE);
+        val->tt = LUA_TVECTOR;
+        break;
+    default:
+        LUAU_ASSERT(!"Unknown userdata field type");
+    }
+}
+
+void luaV_setudatafield(lua_State* L, Udata* u, int index, const TValue* val)
+{
+    const UdataField* field = &L->global->udatafields[u->tag][index];
+    char* data = u->data + field->offset;
+
+    if (field->readonly)
+        luaG_runerror(L, "attempt to modify read-only field '%s'", getstr(field->name));
+
+    switch (field->type)
+    {
+    case LUA_UDFIELD_NUMBER:
+        if (ttisnumber(val))
+        {
+            double v = nvalue(val);
+            memcpy(data, &v, sizeof(v));
+            return;
+        }
+        break;
+    case LUA_UDFIELD_FLOAT:
+        if (ttisnumber(val))
+        {
+            float v = float(nvalue(val));
+            memcpy(data, &v, sizeof(v));
+            return;
+        }
+        break;
+    case LUA_UDFIELD_INTEGER:
+        if (ttisnumber(val))
+        {
+            int v;
+            luai_num2int(v, nvalue(val));
+            memcpy(data, &v, sizeof(v));
+            return;
+        }
+        break;
+    case LUA_UDFIELD_BOOLEAN:
+        if (ttisboolean(val))
+        {
+            *data = bvalue(val) != 0;
+            return;
+        }
+        break;
+    case LUA_UDFIELD_VECTOR:
+        if (ttisvector(val))
+        {
+            memcpy(data, vvalue(val), sizeof(float) * LUA_VECTOR_SIZE);
+            return;
+        }
+        break;
+    default:
+        LUAU_ASSERT(!"Unknown userdata field type");
+    }
+
+    luaG_runerror(L, "invalid value (%s) for field '%s'", luaT_objtypename(L, val), getstr(field->name));
+}
+
+static IndexCacheEntry& getindexcacheentry(global_State* g, Table* h, TString* key)
+{
+    unsigned int hash = unsigned(uintptr_t(h) >> 4) ^ key->hash;
+    return g->indexcache[hash & (LUA_INDEXCACHE - 1)];
+}
+
+// returns the result of a cached lookup or NULL if the chain has changed since
+static const TValue* readindexcache(global_State* g, const IndexCacheEntry& e)
+{
+    for (int i = 0; i < e.depth; i++)
+    {
+        Table* mt = e.tables[i]->metatable;
+
+        if (mt != e.metatables[i] || e.tmslots[i] >= sizenode(mt))
+            return NULL;
+
+        const LuaNode* n = gnode(mt, e.tmslots[i]);
+
+        if (!ttisstring(gkey(n)) || tsvalue(gkey(n)) != g->tmname[TM_INDEX] || !ttistable(gval(n)) || hvalue(gval(n)) != e.tables[i + 1])
+            return NULL;
+    }
+
+    Table* t = e.tables[e.depth];
+
+    if (e.slot < 0)
+    {
+        // the key stays absent from the chain as long as the last table doesn't get an __index metamethod
+        return t->metatable == e.metatables[e.depth] && fastnotm(t->metatable, TM_INDEX) ? luaO_nilobject : NULL;
+    }
+
+    if (e.slot >= sizenode(t))
+        return NULL;
+
+    const LuaNode* n = gnode(t, e.slot);
+
+    return ttisstring(gkey(n)) && tsvalue(gkey(n)) == e.key && !ttisnil(gval(n)) ? gval(n) : NULL;
+}
+
+// the epoch is only bumped by new keys in tables with cached metamethod absence, so every table of a cached chain needs to have some
+static bool trackindexcachetable(lua_State* L, Table* t)
+{
+    for (int e = TM_INDEX; t->tmcache == 0 && e <= TM_EQ; e++)
+        luaT_gettm(t, TMS(e), L->global->tmname[e]);
+
+    return t->tmcache != 0;
+}
+
+// looks up a string key through the chain of __index tables that starts with `h'; returns NULL when the chain has to be walked by the caller
+static const TValue* getindexchain(lua_State* L, Table* h, TString* key)
+{
+    global_State* g = L->global;
+    IndexCacheEntry& e = getindexcacheentry(g, h, key);
+
+    if (e.depth >= 0 && e.tables[0] == h && e.key == key && e.epoch == g->indexcacheepoch)
+    {
+        if (const TValue* res = readindexcache(g, e))
+            return res;
+    }
+
+    IndexCacheEntry entry;
+    entry.key = key;
+    entry.depth = 0;
+
+    Table* t = h;
+    const TValue* res = NULL;
+
+    for (;;)
+    {
+        entry.tables[entry.depth] = t;
+        entry.metatables[entry.depth] = t->metatable;
+
+        res = luaH_getstr(t, key);
+
+        if (!ttisnil(res))
+        {
+            entry.slot = gval2slot(t, res);
+            break;
+        }
+
+        const TValue* tm = fasttm(L, t->metatable, TM_INDEX);
+
+        if (!tm)
+        {
+            res = luaO_nilobject;
+            break;
+        }
+
+        // __index functions and long chains are handled by the caller
+        if (!ttistable(tm) || entry.depth == LUA_INDEXCACHEDEPTH)
+            return NULL;
+
+        entry.tmslots[entry.depth] = gval2slot(t->metatable, tm);
+        entry.depth++;
+        t = hvalue(tm);
+    }
+
+    // tables that the key was looked up in can't get it without invalidating the entry; the last one only matters if it doesn't have the key
+    int tracked = entry.slot < 0 ? entry.depth + 1 : entry.depth;
+
+    for (int i = 0; i < tracked; i++)
+        if (!trackindexcachetable(L, entry.tables[i]))
+            return res;
+
+    entry.epoch = g->indexcacheepoch;
+    e = entry;
+
+    return res;
+}
+
 void luaV_gettable(lua_State* L, const TValue* t, TValue* key, StkId val)
 {
     int loop;
     for (loop = 0; loop < MAXTAGLOOP; loop++)
     {
         const TValue* tm;
+        int field;
         if (ttistable(t))
         { // `t' is a table?
             Table* h = hvalue(t);
@@ -114,8 +375,25 @@ void luaV_gettable(lua_State* L, const TValue* t, TValue* key, StkId val)
                 setobj2s(L, val, res);
                 return;
             }
+
+            // string keys that go through a chain of __index tables are cached
+            if (loop == 0 && ttistable(tm) && ttisstring(key))
+            {
+                if (const TValue* chainres = getindexchain(L, hvalue(tm), tsvalue(key)))
+                {
+                    setobj2s(L, val, chainres);
+                    return;
+                }
+            }
+
             // t isn't a table, so see if it has an INDEX meta-method to look up the key with
         }
+        else if (ttisuserdata(t) && ttisstring(key) && (field = luaV_findudatafield(L, uvalue(t), tsvalue(key), -1)) >= 0)
+        {
+            // inline fields take precedence over the metamethod
+            luaV_getudatafield(L, uvalue(t), field, val);
+            return;
+        }
         else if (ttisnil(tm = luaT_gettmbyobj(L, t, TM_INDEX)))
             luaG_indexerror(L, t, key);
         if (ttisfunction(tm))
@@ -135,6 +413,7 @@ void luaV_settable(lua_State* L, const TValue* t, TValue* key, StkId val)
     for (loop = 0; loop < MAXTAGLOOP; loop++)
     {
         const TValue* tm;
+        int field;
         if (ttistable(t))
         { // `t' is a table?
             Table* h = hvalue(t);
@@ -144,8 +423,12 @@ void luaV_settable(lua_State* L, const TValue* t, TValue* key, StkId val)
             // should we assign the key? (if key is valid or __newindex is not set)
             if (!ttisnil(oldval) || (tm = fasttm(L, h->metatable, TM_NEWINDEX)) == NULL)
             {
+                // making shared storage private moves the slot that was found
                 if (h->readonly)
-                    luaG_readonlyerror(L);
+                {
+                    luaH_prepwrite(L, h);
+                    oldval = luaH_get(h, key);
+                }
 
                 // luaH_set would work but would repeat the lookup so we use luaH_setslot that can reuse oldval if it's safe
                 TValue* newval = luaH_setslot(L, h, oldval, key);
@@ -159,6 +442,11 @@ void luaV_settable(lua_State* L, const TValue* t, TValue* key, StkId val)
 
             // fallthrough to metamethod
         }
+        else if (ttisuserdata(t) && ttisstring(key) && (field = luaV_findudatafield(L, uvalue(t), tsvalue(key), -1)) >= 0)
+        {
+            luaV_setudatafield(L, uvalue(t), field, val);
+            return;
+        }
         else if (ttisnil(tm = luaT_gettmbyobj(L, t, TM_NEWINDEX)))
             luaG_indexerror(L, t, key);
 
@@ -323,6 +611,10 @@ void luaV_concat(lua_State* L, int total, int last)
         }
         else if (tsvalue(top - 1)->len == 0) // second op is empty?
             (void)tostring(L, top - 2);      // result is first op (as string)
+        else if (ttisstring(top - 2) && tsvalue(top - 2)->len == 0) // first op is empty?
+        {
+            setobj2s(L, top - 2, top - 1); // result is second op
+        }
         else
         {
             // at least two string values; get as many as possible
@@ -617,3 +909,95 @@ LUAU_NOINLINE void luaV_tryfuncTM(lua_State* L, StkId func)
     L->top++;              // stack space pre-allocated by the caller
     setobj2s(L, func, tm); // tag method is the new function to be called
 }
+
+// converts the arguments of a fast C function call to unboxed values; arguments past the first one start at args
+bool luaV_fastargs(const lua_FastCall* fast, const TValue* arg0, const TValue* args, lua_FastValue* values)
+{
+    for (int i = 0; i < fast->nargs; i++)
+    {
+        const TValue* arg = (i == 0) ? arg0 : args + (i - 1);
+
+        switch (fast->args[i])
+        {
+        case LUA_FASTNUMBER:
+            if (!ttisnumber(arg))
+                return false;
+            values[i].n = nvalue(arg);
+            break;
+        case LUA_FASTBOOLEAN:
+            if (!ttisboolean(arg))
+                return false;
+            values[i].b = bvalue(arg);
+            break;
+        case LUA_FASTVECTOR:
+            if (!ttisvector(arg))
+                return false;
+            memcpy(values[i].v, vvalue(arg), sizeof(values[i].v));
+            break;
+        case LUA_FASTUSERDATA:
+            if (!ttisuserdata(arg) || uvalue(arg)->tag != fast->tags[i])
+                return false;
+            values[i].p = uvalue(arg)->data;
+            break;
+        default:
+            LUAU_ASSERT(!"Unknown fast call type");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// stores count results of a fast C function call starting at res; missing results are set to nil
+void luaV_fastresults(const lua_FastCall* fast, const lua_FastValue* values, StkId res, int count)
+{
+    for (int i = 0; i < count; i++, res++)
+    {
+        if (i >= fast->nresults)
+        {
+            setnilvalue(res);
+            continue;
+        }
+
+        switch (fast->results[i])
+        {
+        case LUA_FASTNUMBER:
+            setnvalue(res, values[i].n);
+            break;
+        case LUA_FASTBOOLEAN:
+            setbvalue(res, values[i].b != 0);
+            break;
+        case LUA_FASTVECTOR:
+            memcpy(res->value.v, values[i].v, sizeof(values[i].v));
+            res->tt = LUA_TVECTOR;
+            break;
+        default:
+            LUAU_ASSERT(!"Unsupported fast call result type");
+            setnilvalue(res);
+        }
+    }
+}
+
+// calls the unboxed entry point of a C function if the arguments match its signature; on success the results are placed at ra
+// returns false without side effects when the regular entry point has to be called instead
+bool luaV_fastcall(lua_State* L, const lua_FastCall* fast, StkId ra, StkId argtop, int nresults)
+{
+    if (argtop - ra - 1 != fast->nargs)
+        return false;
+
+    // results of MULTRET calls are placed past the frame top
+    if (nresults == LUA_MULTRET && L->stack_last - ra < fast->nresults)
+        return false;
+
+    lua_FastValue args[LUA_FASTMAXVALUES];
+    lua_FastValue results[LUA_FASTMAXVALUES];
+
+    if (!luaV_fastargs(fast, ra + 1, ra + 2, args) || !fast->f(args, results))
+        return false;
+
+    int count = (nresults == LUA_MULTRET) ? fast->nresults : nresults;
+    luaV_fastresults(fast, results, ra, count);
+
+    L->top = (nresults == LUA_MULTRET) ? ra + count : L->ci->top;
+    return true;
+}
@@ -0,0 +1,472 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#include "lua.h"
+#include "lualib.h"
+
+#include "Luau/CodeGen.h"
+#include "Luau/Compiler.h"
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Benchmarks of the embedding API: each benchmark repeats an operation through the C API or a host call round trip and reports
+// the time per operation. Every benchmark is calibrated to run for a fixed time per sample, and the mean of the samples is
+// reported together with its 95% confidence interval, so that results of two builds can be compared without guesswork.
+//
+// Usage: Luau.ApiBench [--filter=substring] [--samples=N] [--codegen]
+
+struct BenchOptions
+{
+    std::string filter;
+    int samples = 20;
+    double sampleTime = 0.01;
+    bool codegen = false;
+};
+
+static BenchOptions options;
+
+using StateRef = std::unique_ptr<lua_State, void (*)(lua_State*)>;
+
+struct Benchmark
+{
+    const char* name;
+
+    // called once per sample on a fresh state to prepare everything the operation needs
+    std::function<void(lua_State* L)> setup;
+
+    // performs the operation `count' times
+    std::function<void(lua_State* L, int count)> run;
+};
+
+// two-sided 95% quantiles of Student's t distribution for 1..30 degrees of freedom
+static const double kStudentT95[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228, 2.201, 2.179, 2.160, 2.145, 2.131,
+    2.120, 2.110, 2.101, 2.093, 2.086, 2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+
+static double studentT95(int dof)
+{
+    if (dof < 1)
+        return 0.0;
+
+    return dof <= 30 ? kStudentT95[dof - 1] : 1.96;
+}
+
+static void loadScript(lua_State* L, const char* source)
+{
+    Luau::CompileOptions copts;
+    copts.optimizationLevel = 2;
+
+    std::string bytecode = Luau::compile(source, copts);
+
+    if (luau_load(L, "=bench", bytecode.data(), bytecode.size(), 0) != 0)
+    {
+        fprintf(stderr, "failed to load benchmark script: %s\n", lua_tostring(L, -1));
+        exit(1);
+    }
+
+    if (options.codegen && Luau::CodeGen::isSupported())
+        Luau::CodeGen::compile(L, -1);
+
+    if (lua_pcall(L, 0, 0, 0) != 0)
+    {
+        fprintf(stderr, "failed to run benchmark script: %s\n", lua_tostring(L, -1));
+        exit(1);
+    }
+}
+
+static lua_State* newState()
+{
+    lua_State* L = luaL_newstate();
+    luaL_openlibs(L);
+
+    if (options.codegen && Luau::CodeGen::isSupported())
+        Luau::CodeGen::create(L);
+
+    return L;
+}
+
+static double measure(const Benchmark& bench, int count)
+{
+    StateRef state(newState(), lua_close);
+    lua_State* L = state.get();
+
+    bench.setup(L);
+
+    double start = lua_clock();
+    bench.run(L, count);
+    return lua_clock() - start;
+}
+
+static void runBenchmark(const Benchmark& bench)
+{
+    // find an operation count that takes at least the sample time; this also warms up caches and the allocator
+    int count = 1;
+
+    while (count < (1 << 30))
+    {
+        double time = measure(bench, count);
+
+        if (time >= options.sampleTime)
+            break;
+
+        double scale = time > 0 ? options.sampleTime / time : 100.0;
+        count = int(std::min(double(count) * std::min(std::max(scale * 1.2, 2.0), 100.0), double(1 << 30)));
+    }
+
+    std::vector<double> samples;
+
+    for (int i = 0; i < options.samples; i++)
+        samples.push_back(measure(bench, count) / count * 1e9);
+
+    double sum = 0;
+    for (double s : samples)
+        sum += s;
+
+    double mean = sum / samples.size();
+
+    double var = 0;
+    for (double s : samples)
+        var += (s - mean) * (s - mean);
+
+    double stddev = samples.size() > 1 ? sqrt(var / (samples.size() - 1)) : 0.0;
+    double ci = studentT95(int(samples.size()) - 1) * stddev / sqrt(double(samples.size()));
+
+    std::sort(samples.begin(), samples.end());
+
+    printf("%-28s %12.2f ns/op  +-%6.2f%%  (min %.2f, median %.2f, %d ops/sample)\n", bench.name, mean, mean > 0 ? ci / mean * 100 : 0.0,
+        samples.front(), samples[samples.size() / 2], count);
+}
+
+static int hostAdd(lua_State* L)
+{
+    lua_pushnumber(L, luaL_checknumber(L, 1) + luaL_checknumber(L, 2));
+    return 1;
+}
+
+static int hostNop(lua_State* L)
+{
+    return 0;
+}
+
+static int hostYield(lua_State* L)
+{
+    return lua_yield(L, 0);
+}
+
+static int hostContinuation(lua_State* L, int status)
+{
+    return 0;
+}
+
+struct Vec3
+{
+    double x, y, z;
+};
+
+static const int kVec3Tag = 1;
+
+static int vec3New(lua_State* L)
+{
+    Vec3* v = static_cast<Vec3*>(lua_newuserdatatagged(L, sizeof(Vec3), kVec3Tag));
+    v->x = luaL_optnumber(L, 1, 0);
+    v->y = luaL_optnumber(L, 2, 0);
+    v->z = luaL_optnumber(L, 3, 0);
+
+    luaL_getmetatable(L, "Vec3");
+    lua_setmetatable(L, -2);
+    return 1;
+}
+
+static Vec3* vec3Check(lua_State* L, int idx)
+{
+    Vec3* v = static_cast<Vec3*>(lua_touserdatatagged(L, idx, kVec3Tag));
+    if (!v)
+        luaL_typeerror(L, idx, "Vec3");
+    return v;
+}
+
+static int vec3Index(lua_State* L)
+{
+    Vec3* v = vec3Check(L, 1);
+    const char* key = luaL_checkstring(L, 2);
+
+    if (key[0] == 'x' && key[1] == 0)
+        lua_pushnumber(L, v->x);
+    else if (key[0] == 'y' && key[1] == 0)
+        lua_pushnumber(L, v->y);
+    else if (key[0] == 'z' && key[1] == 0)
+        lua_pushnumber(L, v->z);
+    else
+        luaL_error(L, "%s is not a valid member of Vec3", key);
+
+    return 1;
+}
+
+static int vec3Namecall(lua_State* L)
+{
+    Vec3* v = vec3Check(L, 1);
+
+    int atom = 0;
+    const char* method = lua_namecallatom(L, &atom);
+
+    if (method && strcmp(method, "Dot") == 0)
+    {
+        Vec3* o = vec3Check(L, 2);
+        lua_pushnumber(L, v->x * o->x + v->y * o->y + v->z * o->z);
+        return 1;
+    }
+
+    luaL_error(L, "%s is not a valid method of Vec3", method ? method : "?");
+}
+
+static void openVec3(lua_State* L)
+{
+    luaL_newmetatable(L, "Vec3");
+    lua_pushcfunction(L, vec3Index, "__index");
+    lua_setfield(L, -2, "__index");
+    lua_pushcfunction(L, vec3Namecall, "__namecall");
+    lua_setfield(L, -2, "__namecall");
+    lua_pop(L, 1);
+
+    lua_pushcfunction(L, vec3New, "Vec3");
+    lua_setglobal(L, "Vec3");
+}
+
+static void callScript(lua_State* L, const char* entry, int count)
+{
+    lua_getglobal(L, entry);
+    lua_pushinteger(L, count);
+
+    if (lua_pcall(L, 1, 0, 0) != 0)
+    {
+        fprintf(stderr, "benchmark failed: %s\n", lua_tostring(L, -1));
+        exit(1);
+    }
+}
+
+static const char* kScripts = R"(
+function add(a, b)
+    return a + b
+end
+
+function callhost(n)
+    local add = hostAdd
+    for i = 1, n do
+        add(i, 1)
+    end
+end
+
+function callnop(n)
+    local nop = hostNop
+    for i = 1, n do
+        nop()
+    end
+end
+
+function yielder()
+    while true do
+        hostYield()
+    end
+end
+
+function binding(n)
+    local a = Vec3(1, 2, 3)
+    local s = 0
+    for i = 1, n do
+        local b = Vec3(i, 1, 0)
+        s += a:Dot(b) + b.x
+    end
+    return s
+end
+)";
+
+static void setupScripts(lua_State* L)
+{
+    lua_pushcfunction(L, hostAdd, "hostAdd");
+    lua_setglobal(L, "hostAdd");
+    lua_pushcfunction(L, hostNop, "hostNop");
+    lua_setglobal(L, "hostNop");
+    lua_pushcclosurek(L, hostYield, "hostYield", 0, hostContinuation);
+    lua_setglobal(L, "hostYield");
+
+    openVec3(L);
+    loadScript(L, kScripts);
+}
+
+static std::vector<Benchmark> getBenchmarks()
+{
+    return {
+        // micro benchmarks of single API calls
+        {"pushnumber", [](lua_State* L) {},
+            [](lua_State* L, int count) {
+                for (int i = 0; i < count; i++)
+                {
+                    lua_pushnumber(L, i);
+                    lua_pop(L, 1);
+                }
+            }},
+        {"pushstring", [](lua_State* L) {},
+            [](lua_State* L, int count) {
+                for (int i = 0; i < count; i++)
+                {
+                    lua_pushstring(L, "benchmark");
+                    lua_pop(L, 1);
+                }
+            }},
+        {"pushcclosurek", [](lua_State* L) {},
+            [](lua_State* L, int count) {
+                for (int i = 0; i < count; i++)
+                {
+                    lua_pushnumber(L, i);
+                    lua_pushcclosurek(L, hostAdd, "hostAdd", 1, hostContinuation);
+                    lua_pop(L, 1);
+                }
+            }},
+        {"getfield",
+            [](lua_State* L) {
+                lua_createtable(L, 0, 4);
+                lua_pushnumber(L, 1);
+                lua_setfield(L, -2, "field");
+            },
+            [](lua_State* L, int count) {
+                for (int i = 0; i < count; i++)
+                {
+                    lua_getfield(L, -1, "field");
+                    lua_pop(L, 1);
+                }
+            }},
+        {"setfield", [](lua_State* L) { lua_createtable(L, 0, 4); },
+            [](lua_State* L, int count) {
+                for (int i = 0; i < count; i++)
+                {
+                    lua_pushnumber(L, i);
+                    lua_setfield(L, -2, "field");
+                }
+            }},
+        {"rawgeti",
+            [](lua_State* L) {
+                lua_createtable(L, 16, 0);
+                for (int i = 1; i <= 16; i++)
+                {
+                    lua_pushnumber(L, i);
+                    lua_rawseti(L, -2, i);
+                }
+            },
+            [](lua_State* L, int count) {
+                for (int i = 0; i < count; i++)
+                {
+                    lua_rawgeti(L, -1, (i & 15) + 1);
+                    lua_pop(L, 1);
+                }
+            }},
+        {"newuserdata", [](lua_State* L) {},
+            [](lua_State* L, int count) {
+                for (int i = 0; i < count; i++)
+                {
+                    lua_newuserdata(L, 32);
+                    lua_pop(L, 1);
+                }
+            }},
+        {"newuserdatatagged+mt", [](lua_State* L) { openVec3(L); },
+            [](lua_State* L, int count) {
+                for (int i = 0; i < count; i++)
+                {
+                    lua_newuserdatatagged(L, sizeof(Vec3), kVec3Tag);
+                    luaL_getmetatable(L, "Vec3");
+                    lua_setmetatable(L, -2);
+                    lua_pop(L, 1);
+                }
+            }},
+        {"ref+unref", [](lua_State* L) { lua_createtable(L, 0, 0); },
+            [](lua_State* L, int count) {
+                for (int i = 0; i < count; i++)
+                    lua_unref(L, lua_ref(L, -1));
+            }},
+
+        // host to script calls
+        {"pcall lua", setupScripts,
+            [](lua_State* L, int count) {
+                for (int i = 0; i < count; i++)
+                {
+                    lua_getglobal(L, "add");
+                    lua_pushnumber(L, i);
+                    lua_pushnumber(L, 1);
+                    lua_pcall(L, 2, 1, 0);
+                    lua_pop(L, 1);
+                }
+            }},
+        {"pcall c", [](lua_State* L) {},
+            [](lua_State* L, int count) {
+                for (int i = 0; i < count; i++)
+                {
+                    lua_pushcfunction(L, hostAdd, "hostAdd");
+                    lua_pushnumber(L, i);
+                    lua_pushnumber(L, 1);
+                    lua_pcall(L, 2, 1, 0);
+                    lua_pop(L, 1);
+                }
+            }},
+        {"resume+yield",
+            [](lua_State* L) {
+                setupScripts(L);
+                lua_State* co = lua_newthread(L);
+                lua_getglobal(co, "yielder");
+            },
+            [](lua_State* L, int count) {
+                lua_State* co = lua_tothread(L, -1);
+                for (int i = 0; i < count; i++)
+                    lua_resume(co, L, 0);
+            }},
+
+        // script to host calls
+        {"script calls host", setupScripts,
+            [](lua_State* L, int count) {
+                callScript(L, "callhost", count);
+            }},
+        {"script calls host nop", setupScripts,
+            [](lua_State* L, int count) {
+                callScript(L, "callnop", count);
+            }},
+
+        // macro benchmark of a typical userdata binding: construction, property access and method calls
+        {"userdata binding", setupScripts,
+            [](lua_State* L, int count) {
+                callScript(L, "binding", count);
+            }},
+    };
+}
+
+int main(int argc, char** argv)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--filter=", 9) == 0)
+            options.filter = argv[i] + 9;
+        else if (strncmp(argv[i], "--samples=", 10) == 0)
+            options.samples = std::max(atoi(argv[i] + 10), 2);
+        else if (strcmp(argv[i], "--codegen") == 0)
+            options.codegen = true;
+        else
+        {
+            fprintf(stderr, "Usage: %s [--filter=substring] [--samples=N] [--codegen]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    for (const Benchmark& bench : getBenchmarks())
+    {
+        if (!options.filter.empty() && !strstr(bench.name, options.filter.c_str()))
+            continue;
+
+        runBenchmark(bench);
+        fflush(stdout);
+    }
+
+    return 0;
+}
@@ -0,0 +1,356 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#include "lua.h"
+#include "lualib.h"
+
+#include "Luau/CodeGen.h"
+#include "Luau/Compiler.h"
+#include "Luau/BytecodeBuilder.h"
+#include "Luau/Parser.h"
+#include "Luau/Transpiler.h"
+
+#include "FileUtils.h"
+
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Measures how fast source is turned into bytecode and native code: a corpus of scripts is parsed, compiled at every
+// optimization level and natively compiled, and the time and number of allocations of each phase are reported.
+// Parsed scripts are also transpiled back to source, which is what code formatters built on the Luau parser do.
+// Code generation phases are taken from LoweringStats, which are only recorded when generating assembly, so the total time
+// of CodeGen::compile is reported separately.
+//
+// Usage: Luau.CompileBench [--runs=N] [file or directory list]
+
+struct AllocationCounter
+{
+    size_t count = 0;
+    size_t bytes = 0;
+};
+
+static AllocationCounter gAllocations;
+
+void* operator new(size_t size)
+{
+    gAllocations.count++;
+    gAllocations.bytes += size;
+
+    if (void* result = malloc(size ? size : 1))
+        return result;
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void* ptr, size_t size) noexcept
+{
+    free(ptr);
+}
+
+using StateRef = std::unique_ptr<lua_State, void (*)(lua_State*)>;
+
+struct SourceFile
+{
+    std::string name;
+    std::string source;
+};
+
+struct PhaseResult
+{
+    double seconds = 1e100; // best time over all runs
+    bool counted = false;   // whether allocations of the phase can be told apart from the rest
+    AllocationCounter allocations;
+};
+
+static int runs = 5;
+static size_t corpusSize = 0;
+
+static void add(AllocationCounter& total, const AllocationCounter& start)
+{
+    total.count += gAllocations.count - start.count;
+    total.bytes += gAllocations.bytes - start.bytes;
+}
+
+static void record(PhaseResult& result, double seconds)
+{
+    result.seconds = std::min(result.seconds, seconds);
+}
+
+static void record(PhaseResult& result, double seconds, const AllocationCounter& allocations)
+{
+    result.seconds = std::min(result.seconds, seconds);
+    result.counted = true;
+    result.allocations = allocations;
+}
+
+static void report(const char* level, const char* phase, const PhaseResult& result)
+{
+    printf("%-4s %-16s %10.3f ms %10.2f MB/s", level, phase, result.seconds * 1e3,
+        result.seconds > 0 ? double(corpusSize) / result.seconds / (1024 * 1024) : 0.0);
+
+    if (result.counted)
+        printf(" %10zu allocs %10zu KB", result.allocations.count, result.allocations.bytes / 1024);
+
+    printf("\n");
+}
+
+static Luau::ParseResult parse(const SourceFile& file, Luau::Allocator& allocator, Luau::AstNameTable& names)
+{
+    Luau::ParseOptions options;
+
+    return Luau::Parser::parse(file.source.c_str(), file.source.size(), names, allocator, options);
+}
+
+static void benchParse(const std::vector<SourceFile>& files)
+{
+    PhaseResult result;
+
+    for (int run = 0; run < runs; run++)
+    {
+        AllocationCounter allocations;
+        double time = 0;
+
+        for (const SourceFile& file : files)
+        {
+            Luau::Allocator allocator;
+            Luau::AstNameTable names(allocator);
+
+            AllocationCounter start = gAllocations;
+            double ts = lua_clock();
+
+            parse(file, allocator, names);
+
+            time += lua_clock() - ts;
+            add(allocations, start);
+        }
+
+        record(result, time, allocations);
+    }
+
+    report("", "parse", result);
+}
+
+static void benchTranspile(const std::vector<SourceFile>& files, bool withTypes, const char* phase)
+{
+    PhaseResult result;
+
+    for (int run = 0; run < runs; run++)
+    {
+        AllocationCounter allocations;
+        double time = 0;
+
+        for (const SourceFile& file : files)
+        {
+            Luau::Allocator allocator;
+            Luau::AstNameTable names(allocator);
+            Luau::ParseResult parseResult = parse(file, allocator, names);
+
+            if (!parseResult.errors.empty())
+                continue;
+
+            AllocationCounter start = gAllocations;
+            double ts = lua_clock();
+
+            std::string code = withTypes ? Luau::transpileWithTypes(*parseResult.root) : Luau::transpile(*parseResult.root);
+
+            time += lua_clock() - ts;
+            add(allocations, start);
+        }
+
+        record(result, time, allocations);
+    }
+
+    report("", phase, result);
+}
+
+static std::vector<std::string> benchCompile(const std::vector<SourceFile>& files, int level, const char* name)
+{
+    Luau::CompileOptions options;
+    options.optimizationLevel = level;
+
+    PhaseResult result;
+    std::vector<std::string> bytecode(files.size());
+
+    for (int run = 0; run < runs; run++)
+    {
+        AllocationCounter allocations;
+        double time = 0;
+
+        for (size_t i = 0; i < files.size(); i++)
+        {
+            Luau::Allocator allocator;
+            Luau::AstNameTable names(allocator);
+            Luau::ParseResult parseResult = parse(files[i], allocator, names);
+
+            if (!parseResult.errors.empty())
+                continue;
+
+            Luau::BytecodeBuilder bcb;
+
+            AllocationCounter start = gAllocations;
+            double ts = lua_clock();
+
+            try
+            {
+                Luau::compileOrThrow(bcb, parseResult, names, options);
+            }
+            catch (Luau::CompileError&)
+            {
+                continue;
+            }
+
+            time += lua_clock() - ts;
+            add(allocations, start);
+
+            bytecode[i] = bcb.getBytecode();
+        }
+
+        record(result, time, allocations);
+    }
+
+    report(name, "compile", result);
+
+    return bytecode;
+}
+
+static void benchCodegen(const std::vector<SourceFile>& files, const std::vector<std::string>& bytecode, const char* name)
+{
+    PhaseResult irBuild, optimize, linearize, lowering, finalize, assembly, native;
+
+    for (int run = 0; run < runs; run++)
+    {
+        StateRef globalState(luaL_newstate(), lua_close);
+        lua_State* L = globalState.get();
+
+        Luau::CodeGen::create(L);
+
+        Luau::CodeGen::LoweringStats stats;
+        Luau::CodeGen::AssemblyOptions options;
+        options.outputBinary = true;
+
+        AllocationCounter assemblyAllocations, nativeAllocations;
+        double assemblyTime = 0, nativeTime = 0;
+
+        for (size_t i = 0; i < files.size(); i++)
+        {
+            if (bytecode[i].empty() || luau_load(L, files[i].name.c_str(), bytecode[i].data(), bytecode[i].size(), 0) != 0)
+            {
+                lua_settop(L, 0);
+                continue;
+            }
+
+            AllocationCounter start = gAllocations;
+            double ts = lua_clock();
+
+            Luau::CodeGen::getAssembly(L, -1, options, &stats);
+
+            assemblyTime += lua_clock() - ts;
+            add(assemblyAllocations, start);
+
+            start = gAllocations;
+            ts = lua_clock();
+
+            Luau::CodeGen::compile(L, -1);
+
+            nativeTime += lua_clock() - ts;
+            add(nativeAllocations, start);
+
+            lua_settop(L, 0);
+        }
+
+        const Luau::CodeGen::PhaseTimeStats& phases = stats.phaseTimeStats;
+
+        record(irBuild, phases.irBuildSeconds);
+        record(optimize, phases.optimizeSeconds);
+        record(linearize, stats.blockLinearizationStats.timeSeconds);
+        record(lowering, phases.loweringSeconds);
+        record(finalize, phases.finalizeSeconds);
+        record(assembly, assemblyTime, assemblyAllocations);
+        record(native, nativeTime, nativeAllocations);
+    }
+
+    report(name, "ir build", irBuild);
+    report(name, "optimize", optimize);
+    report(name, "  linearize", linearize);
+    report(name, "lowering", lowering);
+    report(name, "finalize", finalize);
+    report(name, "assembly total", assembly);
+    report(name, "native compile", native);
+}
+
+int main(int argc, char** argv)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--runs=", 7) == 0)
+            runs = std::max(atoi(argv[i] + 7), 1);
+        else if (argv[i][0] == '-')
+        {
+            fprintf(stderr, "Usage: %s [--runs=N] [file or directory list]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    std::vector<std::string> paths = getSourceFiles(argc, argv);
+
+    if (paths.empty())
+    {
+        traverseDirectory(LUAU_BENCH_SOURCE_DIR, [&](const std::string& name) {
+            if (name.size() > 4 && (name.compare(name.size() - 4, 4, ".lua") == 0 || name.compare(name.size() - 5, 5, ".luau") == 0))
+                paths.push_back(name);
+        });
+    }
+
+    std::sort(paths.begin(), paths.end());
+
+    std::vector<SourceFile> files;
+
+    for (const std::string& path : paths)
+    {
+        if (std::optional<std::string> source = readFile(path))
+        {
+            corpusSize += source->size();
+            files.push_back({path, std::move(*source)});
+        }
+        else
+        {
+            fprintf(stderr, "Error opening %s\n", path.c_str());
+            return 1;
+        }
+    }
+
+    printf("Corpus: %zu files, %zu KB, best of %d runs\n\n", files.size(), corpusSize / 1024, runs);
+
+    benchParse(files);
+    benchTranspile(files, /* withTypes */ false, "transpile");
+    benchTranspile(files, /* withTypes */ true, "transpile types");
+
+    bool codegen = Luau::CodeGen::isSupported();
+
+    if (!codegen)
+        printf("Native code generation is not supported in current configuration\n");
+
+    const char* levels[] = {"-O0", "-O1", "-O2"};
+
+    for (int level = 0; level <= 2; level++)
+    {
+        printf("\n");
+
+        std::vector<std::string> bytecode = benchCompile(files, level, levels[level]);
+
+        if (codegen)
+            benchCodegen(files, bytecode, levels[level]);
+    }
+
+    return 0;
+}
@@ -0,0 +1,346 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#include "lua.h"
+#include "lualib.h"
+
+#include "Luau/CodeGen.h"
+#include "Luau/Compiler.h"
+
+#include "lstring.h"
+
+#include "FileUtils.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Measures how long it takes to load bytecode: large synthetic blobs and the compiled corpus of benchmark scripts are loaded
+// into fresh states, and the time of luau_load is split into phases.
+// The loader isn't instrumented, so phases are measured separately and derived by difference:
+// - string interning interns the string table of the blob into a fresh state;
+// - import resolution is the difference between loading into a sandboxed environment, where imports are resolved, and an
+//   unsandboxed one, where they are left nil;
+// - proto construction is the remaining time of the unsandboxed load.
+// Lazy loading and native compilation of the loaded chunk are reported for reference.
+//
+// Usage: Luau.LoadBench [--runs=N] [file or directory list]
+
+using StateRef = std::unique_ptr<lua_State, void (*)(lua_State*)>;
+
+struct Blob
+{
+    std::string name;
+    std::vector<std::string> bytecode;
+    size_t size = 0;
+};
+
+struct LoadResult
+{
+    double interning = 1e100;
+    double loadUnsafe = 1e100;
+    double loadSafe = 1e100;
+    double loadLazy = 1e100;
+    double native = 1e100;
+};
+
+static int runs = 5;
+
+static unsigned int readVarInt(const std::string& data, size_t& offset)
+{
+    unsigned int result = 0;
+    unsigned int shift = 0;
+
+    uint8_t byte;
+
+    do
+    {
+        byte = uint8_t(data[offset++]);
+        result |= (byte & 127) << shift;
+        shift += 7;
+    } while (byte & 128);
+
+    return result;
+}
+
+// returns offsets and sizes of the strings in the string table that luau_load interns
+static std::vector<std::pair<size_t, size_t>> getStringTable(const std::string& bytecode)
+{
+    size_t offset = 0;
+    uint8_t version = uint8_t(bytecode[offset++]);
+
+    if (version >= 4)
+        offset++; // types version
+
+    unsigned int count = readVarInt(bytecode, offset);
+
+    std::vector<std::pair<size_t, size_t>> result;
+
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        unsigned int length = readVarInt(bytecode, offset);
+
+        result.push_back({offset, length});
+        offset += length;
+    }
+
+    return result;
+}
+
+static lua_State* newState(bool sandbox)
+{
+    lua_State* L = luaL_newstate();
+    luaL_openlibs(L);
+
+    if (sandbox)
+        luaL_sandbox(L);
+
+    return L;
+}
+
+static double measureInterning(const Blob& blob)
+{
+    StateRef globalState(newState(false), lua_close);
+    lua_State* L = globalState.get();
+
+    std::vector<std::vector<std::pair<size_t, size_t>>> tables;
+
+    for (const std::string& bytecode : blob.bytecode)
+        tables.push_back(getStringTable(bytecode));
+
+    // interned strings aren't referenced by anything, so the collector is stopped the same way the loader pauses it
+    lua_gc(L, LUA_GCSTOP, 0);
+
+    double start = lua_clock();
+
+    for (size_t i = 0; i < blob.bytecode.size(); ++i)
+    {
+        for (auto [offset, length] : tables[i])
+            luaS_newlstr(L, blob.bytecode[i].data() + offset, length);
+    }
+
+    return lua_clock() - start;
+}
+
+static double measureLoad(const Blob& blob, bool sandbox, bool lazy, double* native)
+{
+    StateRef globalState(newState(sandbox), lua_close);
+    lua_State* L = globalState.get();
+
+    if (native)
+        Luau::CodeGen::create(L);
+
+    double time = 0;
+
+    for (const std::string& bytecode : blob.bytecode)
+    {
+        double start = lua_clock();
+
+        int result = lazy ? luau_loadlazy(L, "=bench", bytecode.data(), bytecode.size(), 0)
+                          : luau_load(L, "=bench", bytecode.data(), bytecode.size(), 0);
+
+        time += lua_clock() - start;
+
+        if (result != 0)
+        {
+            fprintf(stderr, "Error loading %s: %s\n", blob.name.c_str(), lua_tostring(L, -1));
+            exit(1);
+        }
+
+        if (native)
+        {
+            start = lua_clock();
+            Luau::CodeGen::compile(L, -1);
+            *native += lua_clock() - start;
+        }
+
+        lua_pop(L, 1);
+    }
+
+    return time;
+}
+
+// share of the total is omitted when total is 0
+static void report(const char* phase, double seconds, double total, size_t size)
+{
+    printf("    %-20s %10.3f ms", phase, seconds * 1e3);
+
+    if (total > 0)
+        printf(" %6.1f%%", seconds / total * 100);
+    else
+        printf("        ");
+
+    printf(" %10.2f MB/s\n", seconds > 0 ? double(size) / seconds / (1024 * 1024) : 0.0);
+}
+
+static void runBlob(const Blob& blob)
+{
+    LoadResult result;
+
+    bool codegen = Luau::CodeGen::isSupported();
+
+    for (int run = 0; run < runs; run++)
+    {
+        double native = 0;
+
+        result.interning = std::min(result.interning, measureInterning(blob));
+        result.loadUnsafe = std::min(result.loadUnsafe, measureLoad(blob, /* sandbox= */ false, /* lazy= */ false, nullptr));
+        result.loadSafe = std::min(result.loadSafe, measureLoad(blob, /* sandbox= */ true, /* lazy= */ false, codegen ? &native : nullptr));
+        result.loadLazy = std::min(result.loadLazy, measureLoad(blob, /* sandbox= */ true, /* lazy= */ true, nullptr));
+        result.native = std::min(result.native, native);
+    }
+
+    // phases are measured in separate runs, so noise can make the derived ones slightly negative
+    double imports = std::max(result.loadSafe - result.loadUnsafe, 0.0);
+    double protos = std::max(result.loadUnsafe - result.interning, 0.0);
+
+    printf("%s: %zu chunks, %zu KB of bytecode\n", blob.name.c_str(), blob.bytecode.size(), blob.size / 1024);
+
+    report("luau_load", result.loadSafe, result.loadSafe, blob.size);
+    report("  string interning", result.interning, result.loadSafe, blob.size);
+    report("  proto construction", protos, result.loadSafe, blob.size);
+    report("  import resolution", imports, result.loadSafe, blob.size);
+    report("luau_loadlazy", result.loadLazy, result.loadSafe, blob.size);
+
+    if (codegen)
+        report("native compile", result.native, 0, blob.size);
+
+    printf("\n");
+}
+
+static std::string compileSource(const std::string& source)
+{
+    Luau::CompileOptions options;
+    options.optimizationLevel = 1;
+    options.debugLevel = 1;
+
+    return Luau::compile(source, options);
+}
+
+// many small functions, as found in large UI and gameplay modules
+static std::string generateFunctions(int count)
+{
+    std::string result = "local M = {}\n";
+
+    for (int i = 0; i < count; ++i)
+    {
+        std::string id = std::to_string(i);
+
+        result += "function M.handler" + id + "(self, value)\n";
+        result += "    local state = self.state" + id + "\n";
+        result += "    if value > " + id + " then state.count = state.count + 1 end\n";
+        result += "    return math.max(state.count, value) + " + id + ".5\n";
+        result += "end\n";
+    }
+
+    return result + "return M\n";
+}
+
+// unique string constants, as found in localization and data modules
+static std::string generateStrings(int count)
+{
+    std::string result = "local M = {}\n";
+
+    for (int i = 0; i < count; i += 100)
+    {
+        result += "M[" + std::to_string(i / 100) + "] = function() return {\n";
+
+        for (int j = i; j < i + 100 && j < count; ++j)
+            result += "    key" + std::to_string(j) + " = \"localized string number " + std::to_string(j) + "\",\n";
+
+        result += "} end\n";
+    }
+
+    return result + "return M\n";
+}
+
+// global and library accesses that are resolved at load time
+static std::string generateImports(int count)
+{
+    std::string result = "local M = {}\n";
+
+    const char* imports[] = {"math.floor", "math.abs", "string.format", "string.sub", "table.insert", "Vector3.new", "game.Workspace.Part", "print"};
+
+    for (int i = 0; i < count; ++i)
+    {
+        result += "function M.f" + std::to_string(i) + "(a, b)\n";
+
+        for (const char* import : imports)
+            result += "    a = " + std::string(import) + "(a, b)\n";
+
+        result += "    return a\nend\n";
+    }
+
+    return result + "return M\n";
+}
+
+static Blob makeBlob(const char* name, const std::vector<std::string>& sources)
+{
+    Blob blob;
+    blob.name = name;
+
+    for (const std::string& source : sources)
+    {
+        std::string bytecode = compileSource(source);
+
+        // sources that fail to compile produce an error message instead of bytecode
+        if (bytecode.empty() || bytecode[0] == 0)
+            continue;
+
+        blob.size += bytecode.size();
+        blob.bytecode.push_back(std::move(bytecode));
+    }
+
+    return blob;
+}
+
+int main(int argc, char** argv)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--runs=", 7) == 0)
+            runs = std::max(atoi(argv[i] + 7), 1);
+        else if (argv[i][0] == '-')
+        {
+            fprintf(stderr, "Usage: %s [--runs=N] [file or directory list]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    std::vector<std::string> paths = getSourceFiles(argc, argv);
+
+    if (paths.empty())
+    {
+        traverseDirectory(LUAU_BENCH_SOURCE_DIR, [&](const std::string& name) {
+            if (name.size() > 4 && (name.compare(name.size() - 4, 4, ".lua") == 0 || name.compare(name.size() - 5, 5, ".luau") == 0))
+                paths.push_back(name);
+        });
+    }
+
+    std::sort(paths.begin(), paths.end());
+
+    std::vector<std::string> sources;
+
+    for (const std::string& path : paths)
+    {
+        if (std::optional<std::string> source = readFile(path))
+            sources.push_back(std::move(*source));
+        else
+        {
+            fprintf(stderr, "Error opening %s\n", path.c_str());
+            return 1;
+        }
+    }
+
+    printf("Best of %d runs\n\n", runs);
+
+    runBlob(makeBlob("synthetic functions", {generateFunctions(20000)}));
+    runBlob(makeBlob("synthetic strings", {generateStrings(100000)}));
+    runBlob(makeBlob("synthetic imports", {generateImports(5000)}));
+    runBlob(makeBlob("corpus", sources));
+
+    return 0;
+}
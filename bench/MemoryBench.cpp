@@ -0,0 +1,276 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#include "lua.h"
+#include "lualib.h"
+
+#include "Luau/Compiler.h"
+
+#include "lmem.h"
+#include "lstate.h"
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Measures memory used by typical data shapes: each shape builds a number of objects that are kept alive, and the growth of
+// lua_totalbytes is reported per object. Pages of collectable objects are walked afterwards to report how well the blocks
+// of each page class are utilized, both right after construction and after every other object is freed, which is where
+// fragmentation shows up. Memory of non-collectable allocations (such as table arrays and hash parts) is included in
+// bytes per object, but only the pages of collectable objects can be walked.
+//
+// Usage: Luau.MemoryBench [--filter=substring] [--count=N] [--pages]
+
+struct BenchOptions
+{
+    std::string filter;
+    int count = 100000;
+    bool pages = false;
+};
+
+static BenchOptions options;
+
+using StateRef = std::unique_ptr<lua_State, void (*)(lua_State*)>;
+
+struct Shape
+{
+    const char* name;
+
+    // Luau function body that receives the object index `i' and returns a new object
+    const char* constructor;
+
+    // amount of objects built relative to --count, for shapes where each object is large
+    int divisor;
+};
+
+// page sizes are only known to the allocator, so it remembers the size of every live allocation
+struct AllocationTracker
+{
+    std::unordered_map<void*, size_t> sizes;
+};
+
+static void* trackingAlloc(void* ud, void* ptr, size_t osize, size_t nsize)
+{
+    AllocationTracker* tracker = static_cast<AllocationTracker*>(ud);
+
+    if (ptr)
+        tracker->sizes.erase(ptr);
+
+    if (nsize == 0)
+    {
+        free(ptr);
+        return nullptr;
+    }
+
+    void* result = realloc(ptr, nsize);
+
+    if (result)
+        tracker->sizes[result] = nsize;
+
+    return result;
+}
+
+struct PageClassStats
+{
+    size_t pages = 0;
+    size_t pageBytes = 0;
+    size_t busyBlocks = 0;
+    size_t busyBytes = 0;
+};
+
+// page class stats keyed by block size
+using PageStats = std::map<int, PageClassStats>;
+
+static PageStats getPageStats(lua_State* L, const AllocationTracker& tracker)
+{
+    PageStats result;
+
+    for (lua_Page* page = L->global->allgcopages; page; page = luaM_getnextgcopage(page))
+    {
+        char* start;
+        char* end;
+        int busyBlocks;
+        int blockSize;
+        luaM_getpagewalkinfo(page, &start, &end, &busyBlocks, &blockSize);
+
+        auto it = tracker.sizes.find(page);
+
+        PageClassStats& stats = result[blockSize];
+        stats.pages++;
+        stats.pageBytes += it != tracker.sizes.end() ? it->second : 0;
+        stats.busyBlocks += busyBlocks;
+        stats.busyBytes += size_t(busyBlocks) * blockSize;
+    }
+
+    return result;
+}
+
+static PageClassStats getTotal(const PageStats& stats)
+{
+    PageClassStats total;
+
+    for (const auto& [blockSize, s] : stats)
+    {
+        total.pages += s.pages;
+        total.pageBytes += s.pageBytes;
+        total.busyBlocks += s.busyBlocks;
+        total.busyBytes += s.busyBytes;
+    }
+
+    return total;
+}
+
+static double utilization(const PageClassStats& stats)
+{
+    return stats.pageBytes > 0 ? double(stats.busyBytes) / double(stats.pageBytes) * 100 : 0.0;
+}
+
+static int newUserdata(lua_State* L)
+{
+    int size = luaL_checkinteger(L, 1);
+
+    void* data = lua_newuserdata(L, size);
+    memset(data, 0, size);
+
+    return 1;
+}
+
+static int newUserdataTagged(lua_State* L)
+{
+    int size = luaL_checkinteger(L, 1);
+
+    void* data = lua_newuserdatatagged(L, size, 1);
+    memset(data, 0, size);
+
+    return 1;
+}
+
+static void runScript(lua_State* L, const std::string& source)
+{
+    Luau::CompileOptions copts;
+    copts.optimizationLevel = 1;
+
+    std::string bytecode = Luau::compile(source, copts);
+
+    if (luau_load(L, "=bench", bytecode.data(), bytecode.size(), 0) != 0 || lua_pcall(L, 0, 0, 0) != 0)
+    {
+        fprintf(stderr, "failed to run benchmark script: %s\n", lua_tostring(L, -1));
+        exit(1);
+    }
+}
+
+static void printPages(const char* label, const PageStats& before, const PageStats& after)
+{
+    for (const auto& [blockSize, s] : after)
+    {
+        auto it = before.find(blockSize);
+
+        // only report page classes that hold the objects of the shape
+        if (it != before.end() && it->second.busyBlocks >= s.busyBlocks)
+            continue;
+
+        printf("    %-12s block %5d: %6zu pages %10zu blocks %10zu KB used %10zu KB total %6.1f%% utilized\n", label, blockSize, s.pages,
+            s.busyBlocks, s.busyBytes / 1024, s.pageBytes / 1024, utilization(s));
+    }
+}
+
+static void runShape(const Shape& shape)
+{
+    AllocationTracker tracker;
+
+    StateRef globalState(lua_newstate(trackingAlloc, &tracker), lua_close);
+    lua_State* L = globalState.get();
+
+    luaL_openlibs(L);
+
+    lua_pushcfunction(L, newUserdata, "newuserdata");
+    lua_setglobal(L, "newuserdata");
+    lua_pushcfunction(L, newUserdataTagged, "newuserdatatagged");
+    lua_setglobal(L, "newuserdatatagged");
+
+    int count = std::max(options.count / shape.divisor, 2);
+
+    // the array that keeps objects alive is created upfront, so that its size doesn't count towards the objects
+    runScript(L, "objects = table.create(" + std::to_string(count) + ", false)\n"
+                 "function construct(i)\n" +
+                     shape.constructor + "\nend\n");
+
+    lua_gc(L, LUA_GCCOLLECT, 0);
+
+    size_t bytesBefore = lua_totalbytes(L, -1);
+    PageStats pagesBefore = getPageStats(L, tracker);
+
+    runScript(L, "for i = 1, " + std::to_string(count) + " do objects[i] = construct(i) end");
+
+    lua_gc(L, LUA_GCCOLLECT, 0);
+
+    size_t bytesAfter = lua_totalbytes(L, -1);
+    PageStats pagesFull = getPageStats(L, tracker);
+
+    runScript(L, "for i = 1, " + std::to_string(count) + ", 2 do objects[i] = false end");
+
+    lua_gc(L, LUA_GCCOLLECT, 0);
+
+    PageStats pagesHalf = getPageStats(L, tracker);
+
+    printf("%-24s %8d objects %10.1f bytes/object %6.1f%% utilized %6.1f%% after freeing half\n", shape.name, count,
+        double(bytesAfter - bytesBefore) / count, utilization(getTotal(pagesFull)), utilization(getTotal(pagesHalf)));
+
+    if (options.pages)
+    {
+        printPages("built", pagesBefore, pagesFull);
+        printPages("half freed", pagesBefore, pagesHalf);
+    }
+}
+
+static const Shape kShapes[] = {
+    {"empty table", "return {}", 1},
+    {"record (3 fields)", "return {x = i, y = i, z = i}", 1},
+    {"record (8 fields)", "return {a = i, b = i, c = i, d = i, e = i, f = i, g = i, h = i}", 1},
+    {"array (4 items)", "return {i, i, i, i}", 1},
+    {"array (1000 items)", "local t = table.create(1000, i) return t", 1000},
+    {"string map (16 keys)", "local t = {} for j = 1, 16 do t['key' .. j] = j end return t", 16},
+    {"short string", "return 'str' .. i", 1},
+    {"long string (100 chars)", "return string.rep('x', 92) .. string.format('%08d', i)", 1},
+    {"closure (1 upvalue)", "return function() return i end", 1},
+    {"closure (2 upvalues)", "local a, b = i, i return function() return a + b end", 1},
+    {"closure (8 upvalues)", "local a, b, c, d, e, f, g, h = i, i, i, i, i, i, i, i return function() return a + b + c + d + e + f + g + h end", 1},
+    {"userdata (16 bytes)", "return newuserdata(16)", 1},
+    {"userdata tagged (16 bytes)", "return newuserdatatagged(16)", 1},
+    {"buffer (16 bytes)", "return buffer.create(16)", 1},
+    {"coroutine", "return coroutine.create(construct)", 10},
+};
+
+int main(int argc, char** argv)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--filter=", 9) == 0)
+            options.filter = argv[i] + 9;
+        else if (strncmp(argv[i], "--count=", 8) == 0)
+            options.count = std::max(atoi(argv[i] + 8), 2);
+        else if (strcmp(argv[i], "--pages") == 0)
+            options.pages = true;
+        else
+        {
+            fprintf(stderr, "Usage: %s [--filter=substring] [--count=N] [--pages]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    for (const Shape& shape : kShapes)
+    {
+        if (!options.filter.empty() && !strstr(shape.name, options.filter.c_str()))
+            continue;
+
+        runShape(shape);
+        fflush(stdout);
+    }
+
+    return 0;
+}
@@ -38,6 +38,7 @@ argumentParser.add_argument('--run-test', action='store', default=None, help='Re
 argumentParser.add_argument('--extra-loops', action='store',type=int,default=0, help='Amount of times to loop over one test (one test already performs multiple runs)')
 argumentParser.add_argument('--filename', action='store',type=str,default='bench', help='File name for graph and results file')
 argumentParser.add_argument('--callgrind', dest='callgrind',action='store_const',const=1,default=0,help='Use callgrind to run benchmarks')
+argumentParser.add_argument('--perf', dest='perf',action='store_const',const=1,default=0,help='Collect hardware performance counters with Linux perf while running benchmarks')
 argumentParser.add_argument('--show-commands', dest='show_commands',action='store_const',const=1,default=0,help='Show the command line used to launch the VM and tests')
 
 if matplotlib != None:
@@ -57,6 +58,9 @@ argumentParser.add_argument('--no-print-final-summary', action='store_false', de
 # Assume 2.5 IPC on a 4 GHz CPU; this is obviously incorrect but it allows us to display simulated instruction counts using regular time units
 CALLGRIND_INSN_PER_SEC = 2.5 * 4e9
 
+# Hardware events collected with --perf; counters cover the entire VM process, including startup, compilation and all runs of the benchmark
+PERF_EVENTS = ["cycles", "instructions", "branch-misses", "L1-dcache-load-misses", "LLC-load-misses"]
+
 def arrayRange(count):
     result = []
 
@@ -116,6 +120,31 @@ def checkValgrindExecutable():
     
     return True
 
+def checkPerfExecutable():
+    """Return true if perf can be successfully spawned"""
+    try:
+        subprocess.check_call("perf --version", shell=True, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL)
+    except:
+        print(f"{colored(Color.YELLOW, 'WARNING')}: Unable to spawn 'perf'.  Please ensure perf is installed when using '--perf'.")
+        return False
+
+    return True
+
+def getPerfCounters(lines):
+    counters = {}
+
+    # perf stat -x prints 'value,unit,event,...' for each event; value is '<not supported>' or '<not counted>' when the event isn't available
+    for l in lines:
+        fields = l.strip().split(",")
+
+        if len(fields) >= 3 and not l.startswith("#"):
+            try:
+                counters[fields[2].split(":")[0]] = float(fields[0])
+            except ValueError:
+                pass
+
+    return counters
+
 def getVmOutput(cmd):
     if os.name == "nt":
         try:
@@ -146,6 +175,16 @@ def getVmOutput(cmd):
         os.unlink(output_path)
         return getCallgrindOutput(output, lines)
     else:
+        global lastPerfCounters
+
+        if arguments.perf:
+            output_path = os.path.join(scriptdir, "perf.out")
+            try:
+                os.unlink(output_path)  # Remove stale output
+            except:
+                pass
+            cmd = "perf stat -x , -o perf.out -e " + ",".join(PERF_EVENTS) + " -- " + cmd
+
         conditionallyShowCommand(cmd)
         with subprocess.Popen(cmd, shell=True, stdout=subprocess.PIPE, stderr=subprocess.PIPE, text=True, cwd=scriptdir) as p:
             # Try to lock to a single processor
@@ -158,7 +197,17 @@ def getVmOutput(cmd):
             except:
                 pass
 
-            return p.communicate()[0]
+            output = p.communicate()[0]
+
+        if arguments.perf:
+            try:
+                with open(output_path, "r") as file:
+                    lastPerfCounters = getPerfCounters(file.readlines())
+                os.unlink(output_path)
+            except:
+                lastPerfCounters = {}
+
+        return output
 
 def getShortVmName(name):
     # Hope that the path to executable doesn't contain spaces
@@ -204,6 +253,10 @@ class TestResult:
     unbiasedEst = 0
     sampleConfidenceInterval = 0
 
+    # Sums of hardware counters over all processes that produced the values
+    counters = None
+    counterRuns = 0
+
 def extractResult(filename, vm, output):
     elements = output.split("|><|")
 
@@ -235,6 +288,18 @@ def mergeResult(lhs, rhs):
 
     lhs.count = len(lhs.values)
 
+    if rhs.counters != None:
+        addCounters(lhs, rhs.counters, rhs.counterRuns)
+
+def addCounters(result, counters, runs):
+    if result.counters == None:
+        result.counters = {}
+
+    for name, value in counters.items():
+        result.counters[name] = result.counters.get(name, 0) + value
+
+    result.counterRuns += runs
+
 def mergeResults(lhs, rhs):
     for a, b in zip(lhs, rhs):
         mergeResult(a, b)
@@ -300,6 +365,9 @@ vmTotalAverage = []
 vmTotalImprovement = []
 vmTotalResults = []
 
+# Hardware counters of the last VM process launched with --perf
+lastPerfCounters = {}
+
 # Data for Telegraf report
 mainTotalMin = 0
 mainTotalAverage = 0
@@ -350,8 +418,38 @@ def extractResults(filename, vm, output, allowFailure):
     for el in splitOutput:
         results.append(extractResult(filename, vm, el))
 
+    # Counters are measured for the whole process, so all benchmarks of one file share them
+    if arguments.perf and lastPerfCounters:
+        for result in results:
+            addCounters(result, lastPerfCounters, 1)
+
     return results
 
+def addCountersToTable(result):
+    if result.counters == None or result.counterRuns == 0:
+        return
+
+    def average(name):
+        return result.counters.get(name, 0) / result.counterRuns
+
+    cycles = average("cycles")
+    instructions = average("instructions")
+
+    # misses are reported per thousand instructions to make tests of different length comparable
+    def perKiloInstruction(name):
+        return '{:8.3f}'.format(average(name) / instructions * 1000) if name in result.counters and instructions > 0 else "---"
+
+    perfPrinter.add_row({
+        'Test': result.name,
+        'Driver': result.shortVm,
+        'Cycles': '{:10.1f}M'.format(cycles / 1e6) if "cycles" in result.counters else "---",
+        'Instructions': '{:10.1f}M'.format(instructions / 1e6) if "instructions" in result.counters else "---",
+        'IPC': '{:6.3f}'.format(instructions / cycles) if cycles > 0 and instructions > 0 else "---",
+        'BranchMPKI': perKiloInstruction("branch-misses"),
+        'L1D MPKI': perKiloInstruction("L1-dcache-load-misses"),
+        'LLC MPKI': perKiloInstruction("LLC-load-misses"),
+    })
+
 def analyzeResult(subdir, main, comparisons):
     # Aggregate statistics
     global mainTotalMin, mainTotalAverage, mainTotalMax
@@ -383,6 +481,8 @@ def analyzeResult(subdir, main, comparisons):
     if influxReporter != None:
         influxReporter.report_result(subdir, main.name, main.filename, "SUCCESS", main.min, main.avg, main.max, main.sampleConfidenceInterval, main.shortVm, main.vm)
 
+    addCountersToTable(main)
+
     print(colored(Color.GREEN, 'SUCCESS') + ': {:<40}'.format(main.name) + ": " + '{:8.3f}'.format(main.avg) + "ms +/- " +
         '{:6.3f}'.format(main.sampleConfidenceInterval / main.avg * 100) + "% on " + main.shortVm)
 
@@ -487,6 +587,8 @@ def analyzeResult(subdir, main, comparisons):
         if influxReporter != None:
             influxReporter.report_result(subdir, main.name, main.filename, "SUCCESS", compare.min, compare.avg, compare.max, compare.sampleConfidenceInterval, compare.shortVm, compare.vm)
 
+        addCountersToTable(compare)
+
         if arguments.speedup:
             oldValue = plotValueLists[0].pop()
             newValue = compare.avg
@@ -754,7 +856,7 @@ def writeResultsToFile():
         print("Failed to write results to a file")
 
 def run(args, argsubcb):
-    global arguments, resultPrinter, influxReporter, argumentSubstituionCallback, allResults
+    global arguments, resultPrinter, perfPrinter, influxReporter, argumentSubstituionCallback, allResults
     arguments = args
     argumentSubstituionCallback = argsubcb
 
@@ -762,6 +864,17 @@ def run(args, argsubcb):
         print(f"{colored(Color.RED, 'ERROR')}: --callgrind is not supported on Windows.  Please consider using this option on another OS, or Linux using WSL.")
         sys.exit(1)
 
+    if arguments.perf and not sys.platform.startswith("linux"):
+        print(f"{colored(Color.RED, 'ERROR')}: --perf is only supported on Linux.")
+        sys.exit(1)
+
+    if arguments.perf and arguments.callgrind:
+        print(f"{colored(Color.RED, 'ERROR')}: --perf and --callgrind can't be used together.")
+        sys.exit(1)
+
+    if arguments.perf and not checkPerfExecutable():
+        sys.exit(1)
+
     if arguments.report_metrics or arguments.print_influx_debugging:
         import influxbench
         influxReporter = influxbench.InfluxReporter(arguments)
@@ -870,6 +983,17 @@ def run(args, argsubcb):
             {'label': 'Driver', 'align': Alignment.LEFT}
         ])
 
+    perfPrinter = TablePrinter([
+        {'label': 'Test', 'align': Alignment.LEFT},
+        {'label': 'Driver', 'align': Alignment.LEFT},
+        {'label': 'Cycles', 'align': Alignment.RIGHT},
+        {'label': 'Instructions', 'align': Alignment.RIGHT},
+        {'label': 'IPC', 'align': Alignment.RIGHT},
+        {'label': 'BranchMPKI', 'align': Alignment.RIGHT},
+        {'label': 'L1D MPKI', 'align': Alignment.RIGHT},
+        {'label': 'LLC MPKI', 'align': Alignment.RIGHT}
+    ])
+
     if arguments.results != None:
         for resultSet in allResults:
             # finalize results
@@ -910,6 +1034,12 @@ def run(args, argsubcb):
         resultPrinter.print(summary=False)
         print(colored(Color.YELLOW, '---'))
 
+        if arguments.perf:
+            print()
+            print(colored(Color.YELLOW, '==============================================HARDWARE COUNTERS============================================'))
+            perfPrinter.print(summary=False)
+            print(colored(Color.YELLOW, '---'))
+
     if len(vmTotalMin) != 0 and arguments.vmNext != None:
         index = 0
 
@@ -0,0 +1,399 @@
+#!/usr/bin/python3
+# This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+import argparse
+import math
+import os
+import re
+import subprocess
+import tempfile
+
+from color import colored, Color
+from tabulate import TablePrinter, Alignment
+
+try:
+    import scipy
+    from scipy import stats
+except ModuleNotFoundError:
+    print("Warning: scipy package is not installed, confidence values will not be available")
+    stats = None
+
+scriptdir = os.path.dirname(os.path.realpath(__file__))
+defaultAnalyze = 'luau-analyze.exe' if os.name == "nt" else './luau-analyze'
+
+argumentParser = argparse.ArgumentParser(description='Benchmark type checking and linting of Luau modules with an option to compare different builds of luau-analyze')
+
+argumentParser.add_argument('--analyze', dest='analyze', default=defaultAnalyze, help='luau-analyze executable to test (' + defaultAnalyze + ' by default)')
+argumentParser.add_argument('--compare', dest='analyzeNext', type=str, nargs='*', help='List of luau-analyze executables to compare against')
+argumentParser.add_argument('--folder', dest='folders', type=str, nargs='*', help='Folders with representative modules (tests and other by default)')
+argumentParser.add_argument('--run-test', action='store', default=None, help='Regex test filter')
+argumentParser.add_argument('--runs', action='store', type=int, default=5, help='Amount of times each module is checked')
+argumentParser.add_argument('--flags', action='store', type=str, default=None, help='Value of --fflags= passed to every executable')
+argumentParser.add_argument('--show-commands', dest='show_commands', action='store_const', const=1, default=0, help='Show the command line used to launch luau-analyze')
+
+# Pathological modules are generated instead of being stored in the repository; the generators are deterministic so that
+# results stay comparable between runs and machines
+
+def generateLargeTable():
+    lines = ["--!strict", "local data = {"]
+
+    for i in range(3000):
+        lines.append(f'    {{ id = {i}, name = "item{i}", weight = {i * 0.5}, tags = {{ "t{i % 7}", "t{i % 11}" }}, enabled = {"true" if i % 2 == 0 else "false"} }},')
+
+    lines.append("}")
+    lines.append("local lookup = {")
+
+    for i in range(2000):
+        lines.append(f'    key{i} = {{ x = {i}, y = {i * 2}, label = "k{i}" }},')
+
+    lines.append("}")
+    lines.append("local total = 0")
+    lines.append("for _, item in data do total += item.weight end")
+    lines.append("return { data = data, lookup = lookup, total = total }")
+
+    return "\n".join(lines) + "\n"
+
+def generateDeepUnions():
+    lines = ["--!strict"]
+
+    lines.append("type Kind = " + " | ".join(f'"kind{i}"' for i in range(200)))
+
+    for i in range(60):
+        lines.append(f"type Node{i} = {{ kind: \"node{i}\", value{i}: number, next: Node? }}")
+
+    lines.append("type Node = " + " | ".join(f"Node{i}" for i in range(60)))
+    lines.append("")
+    lines.append("local function classify(k: Kind): number")
+
+    for i in range(200):
+        lines.append(f'    {"if" if i == 0 else "elseif"} k == "kind{i}" then return {i}')
+
+    lines.append("    end")
+    lines.append("    return -1")
+    lines.append("end")
+    lines.append("")
+    lines.append("local function visit(n: Node): number")
+
+    for i in range(60):
+        lines.append(f'    {"if" if i == 0 else "elseif"} n.kind == "node{i}" then return n.value{i}')
+
+    lines.append("    end")
+    lines.append("    return 0")
+    lines.append("end")
+    lines.append("")
+    lines.append("local function combine(a: Node | Kind | number | string | boolean, b: Node | Kind | nil)")
+    lines.append("    if type(a) == \"number\" then return a end")
+    lines.append("    if type(a) == \"string\" then return #a end")
+    lines.append("    if type(a) == \"table\" then return visit(a) end")
+    lines.append("    return if b then 1 else 0")
+    lines.append("end")
+    lines.append("return { classify = classify, visit = visit, combine = combine }")
+
+    return "\n".join(lines) + "\n"
+
+def generateHeavyGenerics():
+    lines = ["--!strict"]
+
+    lines.append("type Pair<A, B> = { first: A, second: B }")
+    lines.append("type Result<T, E> = { ok: true, value: T } | { ok: false, error: E }")
+    lines.append("")
+    lines.append("local function map<T, U>(list: {T}, f: (T) -> U): {U}")
+    lines.append("    local result = {}")
+    lines.append("    for i, v in list do result[i] = f(v) end")
+    lines.append("    return result")
+    lines.append("end")
+    lines.append("")
+    lines.append("local function filter<T>(list: {T}, f: (T) -> boolean): {T}")
+    lines.append("    local result = {}")
+    lines.append("    for _, v in list do if f(v) then table.insert(result, v) end end")
+    lines.append("    return result")
+    lines.append("end")
+    lines.append("")
+    lines.append("local function reduce<T, A>(list: {T}, f: (A, T) -> A, init: A): A")
+    lines.append("    local acc = init")
+    lines.append("    for _, v in list do acc = f(acc, v) end")
+    lines.append("    return acc")
+    lines.append("end")
+    lines.append("")
+    lines.append("local function pair<A, B>(a: A, b: B): Pair<A, B>")
+    lines.append("    return { first = a, second = b }")
+    lines.append("end")
+    lines.append("")
+    lines.append("local function wrap<T, E>(v: T): Result<T, E>")
+    lines.append("    return { ok = true, value = v }")
+    lines.append("end")
+    lines.append("")
+
+    for i in range(150):
+        lines.append(f"local function stage{i}<T>(list: {{T}}, key: (T) -> number)")
+        lines.append(f"    local pairs{i} = map(list, function(v) return pair(key(v), pair(v, \"s{i}\")) end)")
+        lines.append(f"    local kept{i} = filter(pairs{i}, function(p) return p.first > {i} end)")
+        lines.append(f"    local sum{i} = reduce(kept{i}, function(acc: number, p) return acc + p.first end, 0)")
+        lines.append(f"    return wrap(pair(sum{i}, kept{i}))")
+        lines.append("end")
+
+    lines.append("")
+    lines.append("local numbers = { 1, 2, 3, 4, 5 }")
+
+    for i in range(150):
+        lines.append(f"local r{i} = stage{i}(numbers, function(n) return n * {i} end)")
+
+    lines.append("return nil")
+
+    return "\n".join(lines) + "\n"
+
+def generateClassDefinitions():
+    lines = ["--!strict"]
+
+    for i in range(250):
+        base = f"Class{i - 1}" if i > 0 and i % 5 != 0 else None
+
+        lines.append(f"export type Class{i} = {{")
+
+        if base:
+            lines.append(f"    parent: Class{i - 1},")
+
+        lines.append(f"    name: string,")
+        lines.append(f"    value{i}: number,")
+        lines.append(f"    items: {{ string }},")
+        lines.append(f"    getName: (self: Class{i}) -> string,")
+        lines.append(f"    setValue: (self: Class{i}, value: number) -> (),")
+        lines.append(f"    describe: (self: Class{i}, prefix: string?) -> string,")
+        lines.append("}")
+        lines.append(f"local Class{i} = {{}}")
+        lines.append(f"Class{i}.__index = Class{i}")
+        lines.append(f"function Class{i}.new(name: string): Class{i}")
+        lines.append(f"    local self = setmetatable({{}}, Class{i}) :: any")
+        lines.append(f"    self.name = name")
+        lines.append(f"    self.value{i} = {i}")
+        lines.append(f"    self.items = {{}}")
+
+        if base:
+            lines.append(f"    self.parent = Class{i - 1}.new(name)")
+
+        lines.append(f"    return self")
+        lines.append("end")
+        lines.append(f"function Class{i}.getName(self: Class{i}): string")
+        lines.append(f"    return self.name")
+        lines.append("end")
+        lines.append(f"function Class{i}.setValue(self: Class{i}, value: number)")
+        lines.append(f"    self.value{i} = value")
+        lines.append("end")
+        lines.append(f"function Class{i}.describe(self: Class{i}, prefix: string?): string")
+        lines.append(f"    return (prefix or \"\") .. self:getName() .. tostring(self.value{i})")
+        lines.append("end")
+        lines.append("")
+
+    lines.append("return {")
+
+    for i in range(250):
+        lines.append(f"    Class{i} = Class{i},")
+
+    lines.append("}")
+
+    return "\n".join(lines) + "\n"
+
+generators = {
+    'large-table': generateLargeTable,
+    'deep-unions': generateDeepUnions,
+    'heavy-generics': generateHeavyGenerics,
+    'class-definitions': generateClassDefinitions,
+}
+
+class TestResult:
+    def __init__(self, analyze, name):
+        self.analyze = analyze
+        self.shortAnalyze = os.path.basename(analyze)
+        self.name = name
+        self.failed = False
+        self.samples = { 'parse': [], 'check': [], 'lint': [] }
+        self.lines = 0
+        self.peakmem = 0
+
+    def add(self, values):
+        for phase in self.samples:
+            self.samples[phase].append(values[phase] * 1000)
+
+        self.lines = int(values['lines'])
+        self.peakmem = max(self.peakmem, int(values['peakmem']))
+
+    def avg(self, phase):
+        return sum(self.samples[phase]) / len(self.samples[phase])
+
+    def total(self):
+        return [self.samples['parse'][i] + self.samples['check'][i] + self.samples['lint'][i] for i in range(len(self.samples['check']))]
+
+def getConfidenceInterval(values):
+    count = len(values)
+    avg = sum(values) / count
+
+    if count < 2 or stats == None:
+        return avg, 0.0, 0.0
+
+    unbiasedEst = sum((v - avg) ** 2 for v in values) / (count - 1)
+    sampleConfidenceInterval = stats.t.ppf(0.975, count - 1) * math.sqrt(unbiasedEst) / math.sqrt(count)
+
+    return avg, unbiasedEst, sampleConfidenceInterval
+
+def runAnalyze(analyze, path):
+    cmd = [analyze, '--stats', '-j1']
+
+    if arguments.flags:
+        cmd.append('--fflags=' + arguments.flags)
+
+    cmd.append(path)
+
+    if arguments.show_commands:
+        print(f'{colored(Color.BLUE, "EXECUTING")}: {" ".join(cmd)}')
+
+    try:
+        output = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.DEVNULL, cwd=scriptdir).stdout.decode()
+    except KeyboardInterrupt:
+        exit(1)
+    except OSError:
+        return None
+
+    values = {}
+
+    for match in re.finditer(r'^Stats: (\w+) ([0-9.]+)$', output, re.MULTILINE):
+        values[match.group(1)] = float(match.group(2))
+
+    # files with type errors still produce stats, but an internal compiler error or a crash doesn't
+    if 'check' not in values:
+        return None
+
+    return values
+
+def runTest(analyze, name, path):
+    result = TestResult(analyze, name)
+
+    # first run warms up the file cache and isn't recorded
+    if runAnalyze(analyze, path) == None:
+        result.failed = True
+        return result
+
+    for i in range(arguments.runs):
+        values = runAnalyze(analyze, path)
+
+        if values == None:
+            result.failed = True
+            return result
+
+        result.add(values)
+
+    return result
+
+def collectTests(tempdir):
+    tests = []
+
+    folders = arguments.folders if arguments.folders else [os.path.join(scriptdir, 'tests'), os.path.join(scriptdir, 'other')]
+
+    for folder in folders:
+        for root, dirs, files in os.walk(folder):
+            dirs.sort()
+
+            for file in sorted(files):
+                if file.endswith('.lua') or file.endswith('.luau'):
+                    path = os.path.join(root, file)
+                    tests.append((os.path.relpath(path, folder), path))
+
+    for name, generator in generators.items():
+        path = os.path.join(tempdir, name + '.luau')
+
+        with open(path, 'w') as f:
+            f.write(generator())
+
+        tests.append((name, path))
+
+    if arguments.run_test:
+        tests = [test for test in tests if re.search(arguments.run_test, test[0])]
+
+    return tests
+
+def formatTime(values):
+    avg, _, ci = getConfidenceInterval(values)
+    return '{:8.3f}ms'.format(avg), '{:6.2f}%'.format(ci / avg * 100 if avg > 0 else 0)
+
+def main():
+    analyzers = [arguments.analyze] + (arguments.analyzeNext if arguments.analyzeNext else [])
+
+    resultPrinter = TablePrinter([
+        {'label': 'Test', 'align': Alignment.LEFT},
+        {'label': 'Driver', 'align': Alignment.LEFT},
+        {'label': 'Lines', 'align': Alignment.RIGHT},
+        {'label': 'Parse', 'align': Alignment.RIGHT},
+        {'label': 'Check', 'align': Alignment.RIGHT},
+        {'label': 'StdDev%', 'align': Alignment.RIGHT},
+        {'label': 'Lint', 'align': Alignment.RIGHT},
+        {'label': 'PeakMem', 'align': Alignment.RIGHT},
+        {'label': 'Speedup', 'align': Alignment.RIGHT},
+        {'label': 'Significance', 'align': Alignment.LEFT},
+    ])
+
+    totals = { analyze: 0.0 for analyze in analyzers }
+
+    with tempfile.TemporaryDirectory() as tempdir:
+        tests = collectTests(tempdir)
+
+        for name, path in tests:
+            results = [runTest(analyze, name, path) for analyze in analyzers]
+            main = results[0]
+
+            for result in results:
+                if result.failed:
+                    print(colored(Color.RED, 'FAILED') + ": '" + name + "' on '" + result.analyze + "'")
+                    resultPrinter.add_row({ 'Test': name, 'Driver': result.shortAnalyze, 'Lines': '', 'Parse': '', 'Check': 'FAILED', 'StdDev%': '', 'Lint': '', 'PeakMem': '', 'Speedup': '', 'Significance': '' })
+                    continue
+
+                checkAvg, checkCi = formatTime(result.samples['check'])
+                total = result.total()
+                totals[result.analyze] += sum(total) / len(total)
+
+                speedup = ''
+                significance = ''
+
+                if result is not main and not main.failed:
+                    mainAvg, mainEst, _ = getConfidenceInterval(main.total())
+                    resultAvg, resultEst, _ = getConfidenceInterval(total)
+
+                    speedup = '{:8.3f}%'.format((mainAvg / resultAvg - 1) * 100 if resultAvg > 0 else 0)
+
+                    if stats != None and len(total) > 1:
+                        pooledStdDev = math.sqrt((mainEst + resultEst) / 2)
+
+                        if pooledStdDev > 0:
+                            tStat = abs(mainAvg - resultAvg) / (pooledStdDev * math.sqrt(2 / len(total)))
+                            degreesOfFreedom = 2 * len(total) - 2
+                            pValue = 2 * (1 - stats.t.cdf(tStat, df=degreesOfFreedom))
+
+                            if pValue >= 0.05:
+                                significance = 'likely same'
+                            elif resultAvg < mainAvg:
+                                significance = colored(Color.GREEN, 'likely better')
+                            else:
+                                significance = colored(Color.RED, 'likely worse')
+                        else:
+                            significance = 'same'
+
+                print(colored(Color.GREEN, 'SUCCESS') + ': {:<40}'.format(name) + ': check ' + checkAvg + ' +/- ' + checkCi + ' on ' + result.shortAnalyze)
+
+                resultPrinter.add_row({
+                    'Test': name,
+                    'Driver': result.shortAnalyze,
+                    'Lines': str(result.lines),
+                    'Parse': formatTime(result.samples['parse'])[0],
+                    'Check': checkAvg,
+                    'StdDev%': checkCi,
+                    'Lint': formatTime(result.samples['lint'])[0],
+                    'PeakMem': '{:8.1f}MB'.format(result.peakmem / (1024 * 1024)),
+                    'Speedup': speedup,
+                    'Significance': significance,
+                })
+
+    for analyze in analyzers:
+        resultPrinter.add_row({ 'Test': 'Total (all phases)', 'Driver': os.path.basename(analyze), 'Lines': '', 'Parse': '', 'Check': '{:8.3f}ms'.format(totals[analyze]), 'StdDev%': '', 'Lint': '', 'PeakMem': '', 'Speedup': '', 'Significance': '' })
+
+    resultPrinter.print(summary=False)
+
+if __name__ == "__main__":
+    arguments = argumentParser.parse_args()
+    main()
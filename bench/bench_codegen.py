@@ -0,0 +1,202 @@
+#!/usr/bin/python3
+# This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+import argparse
+import json
+import math
+import os
+import re
+import subprocess
+
+from color import colored, Color
+from tabulate import TablePrinter, Alignment
+
+try:
+    import scipy
+    from scipy import stats
+except ModuleNotFoundError:
+    print("Warning: scipy package is not installed, confidence values will not be available")
+    stats = None
+
+scriptdir = os.path.dirname(os.path.realpath(__file__))
+defaultVm = 'luau.exe' if os.name == "nt" else './luau'
+
+argumentParser = argparse.ArgumentParser(description='Benchmark Luau scripts in interpreter and native code generation modes and compare the results')
+
+argumentParser.add_argument('--vm', dest='vm', default=defaultVm, help='Luau executable to test (' + defaultVm + ' by default)')
+argumentParser.add_argument('--folder', dest='folders', type=str, nargs='*', help='Folders with tests (tests and micro_tests by default)')
+argumentParser.add_argument('--run-test', action='store', default=None, help='Regex test filter')
+argumentParser.add_argument('--extra-loops', action='store', type=int, default=0, help='Amount of times to loop over one test (one test already performs multiple runs)')
+argumentParser.add_argument('--filename', action='store', type=str, default='codegen', help='File name for results file')
+argumentParser.add_argument('--show-commands', dest='show_commands', action='store_const', const=1, default=0, help='Show the command line used to launch the VM and tests')
+
+def getVmOutput(args):
+    cmd = [os.path.abspath(arguments.vm)] + args
+
+    if arguments.show_commands:
+        print(f'{colored(Color.BLUE, "EXECUTING")}: {" ".join(cmd)}')
+
+    try:
+        return subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.DEVNULL, cwd=scriptdir, text=True).stdout
+    except KeyboardInterrupt:
+        exit(1)
+    except OSError:
+        return ""
+
+# Returns the time samples of each benchmark reported by bench_support.lua, keyed by benchmark name
+def extractTimes(output):
+    results = {}
+
+    for el in output.split("||_||")[:-1]:
+        elements = el.split("|><|")[1:]
+
+        if len(elements) >= 2:
+            results.setdefault(elements[0], []).extend(float(v) for v in elements[1:])
+
+    return results
+
+def extractCodegenStats(output):
+    match = re.search(r'^Codegen: (\d+)/(\d+) functions, (\d+) bytes bytecode => (\d+) bytes native code, (\d+) bytes data, (\d+) bytes metadata, ([0-9.]+) seconds$', output, re.MULTILINE)
+
+    if not match:
+        return None
+
+    return {
+        'functionsCompiled': int(match.group(1)),
+        'functionsTotal': int(match.group(2)),
+        'bytecodeSize': int(match.group(3)),
+        'nativeCodeSize': int(match.group(4)),
+        'nativeDataSize': int(match.group(5)),
+        'nativeMetadataSize': int(match.group(6)),
+        'compileTime': float(match.group(7)) * 1000,
+    }
+
+def getConfidenceInterval(values):
+    count = len(values)
+    avg = sum(values) / count
+
+    if count < 2:
+        return avg, 0.0, 0.0
+
+    unbiasedEst = sum((v - avg) ** 2 for v in values) / (count - 1)
+    tValue = stats.t.ppf(0.975, count - 1) if stats != None else 1.96
+
+    return avg, unbiasedEst, tValue * math.sqrt(unbiasedEst) / math.sqrt(count)
+
+def getSignificance(interpreter, native):
+    if stats == None or len(interpreter) < 2 or len(native) < 2:
+        return ''
+
+    result = stats.ttest_ind(interpreter, native, equal_var=False)
+
+    if result.pvalue >= 0.05:
+        return 'likely same'
+    elif sum(native) / len(native) < sum(interpreter) / len(interpreter):
+        return colored(Color.GREEN, 'likely better')
+    else:
+        return colored(Color.RED, 'likely worse')
+
+def collectTests():
+    tests = []
+
+    folders = arguments.folders if arguments.folders else [os.path.join(scriptdir, 'tests'), os.path.join(scriptdir, 'micro_tests')]
+
+    for folder in folders:
+        for root, dirs, files in os.walk(folder):
+            dirs.sort()
+
+            for file in sorted(files):
+                if file.endswith('.lua') or file.endswith('.luau'):
+                    tests.append(os.path.relpath(os.path.join(root, file), scriptdir))
+
+    if arguments.run_test:
+        tests = [test for test in tests if re.search(arguments.run_test, test)]
+
+    return tests
+
+def runTest(filepath):
+    interpreterTimes = {}
+    nativeTimes = {}
+    codegenStats = None
+
+    for i in range(1 + arguments.extra_loops):
+        for name, values in extractTimes(getVmOutput([filepath])).items():
+            interpreterTimes.setdefault(name, []).extend(values)
+
+        output = getVmOutput(['--codegen-stats', filepath])
+
+        for name, values in extractTimes(output).items():
+            nativeTimes.setdefault(name, []).extend(values)
+
+        codegenStats = codegenStats or extractCodegenStats(output)
+
+    return interpreterTimes, nativeTimes, codegenStats
+
+def main():
+    resultPrinter = TablePrinter([
+        {'label': 'Test', 'align': Alignment.LEFT},
+        {'label': 'Interpreter', 'align': Alignment.RIGHT},
+        {'label': 'Native', 'align': Alignment.RIGHT},
+        {'label': 'StdDev%', 'align': Alignment.RIGHT},
+        {'label': 'Speedup', 'align': Alignment.RIGHT},
+        {'label': 'Significance', 'align': Alignment.LEFT},
+        {'label': 'Code', 'align': Alignment.RIGHT},
+        {'label': 'Compile', 'align': Alignment.RIGHT},
+    ])
+
+    results = []
+
+    for filepath in collectTests():
+        interpreterTimes, nativeTimes, codegenStats = runTest(filepath)
+
+        if not interpreterTimes or not nativeTimes or codegenStats == None:
+            print(colored(Color.RED, 'FAILED') + ": '" + filepath + "'")
+            resultPrinter.add_row({ 'Test': filepath, 'Interpreter': '', 'Native': 'FAILED', 'StdDev%': '', 'Speedup': '', 'Significance': '', 'Code': '', 'Compile': '' })
+            continue
+
+        for name, interpreter in interpreterTimes.items():
+            native = nativeTimes.get(name)
+
+            if not native:
+                continue
+
+            interpreterAvg = sum(interpreter) / len(interpreter)
+            nativeAvg, _, nativeCi = getConfidenceInterval(native)
+            speedup = (interpreterAvg / nativeAvg - 1) * 100 if nativeAvg > 0 else 0.0
+
+            print(colored(Color.GREEN, 'SUCCESS') + ': {:<40}'.format(name) + ': ' + '{:8.3f}'.format(interpreterAvg) + 'ms => ' +
+                '{:8.3f}'.format(nativeAvg) + 'ms ({:+.1f}%)'.format(speedup))
+
+            resultPrinter.add_row({
+                'Test': name,
+                'Interpreter': '{:8.3f}ms'.format(interpreterAvg),
+                'Native': '{:8.3f}ms'.format(nativeAvg),
+                'StdDev%': '{:8.3f}%'.format(nativeCi / nativeAvg * 100 if nativeAvg > 0 else 0),
+                'Speedup': colored(Color.RED if speedup < 0 else Color.GREEN if speedup > 0 else Color.YELLOW, '{:8.3f}%'.format(speedup)),
+                'Significance': getSignificance(interpreter, native),
+                'Code': '{:6.1f}KB'.format(codegenStats['nativeCodeSize'] / 1024),
+                'Compile': '{:8.3f}ms'.format(codegenStats['compileTime']),
+            })
+
+            # code size and compile time are measured for the whole file, so tests from the same file share them
+            result = {
+                'file': filepath,
+                'name': name,
+                'interpreter': interpreter,
+                'native': native,
+                'speedup': speedup,
+            }
+            result.update(codegenStats)
+
+            results.append(result)
+
+    resultPrinter.print(summary=False)
+
+    try:
+        with open(arguments.filename + ".json", "w") as resultsFile:
+            resultsFile.write(json.dumps(results, indent=4))
+    except OSError:
+        print("Failed to write results to a file")
+
+if __name__ == "__main__":
+    arguments = argumentParser.parse_args()
+    main()
@@ -0,0 +1,212 @@
+#!/usr/bin/python3
+# This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+import argparse
+import math
+import os
+import re
+import subprocess
+
+from color import colored, Color
+from tabulate import TablePrinter, Alignment
+
+try:
+    import scipy
+    from scipy import stats
+except ModuleNotFoundError:
+    print("Warning: scipy package is not installed, confidence values will not be available")
+    stats = None
+
+scriptdir = os.path.dirname(os.path.realpath(__file__))
+defaultVm = 'luau.exe' if os.name == "nt" else './luau'
+
+argumentParser = argparse.ArgumentParser(description='Benchmark garbage collector pauses of Luau scripts with an option to compare different VMs')
+
+argumentParser.add_argument('--vm', dest='vm', default=defaultVm, help='Luau executable to test (' + defaultVm + ' by default)')
+argumentParser.add_argument('--compare', dest='vmNext', type=str, nargs='*', help='List of Luau executables to compare against')
+argumentParser.add_argument('--folder', dest='folder', default=os.path.join(scriptdir, 'gc'), help='Folder with tests (gc by default)')
+argumentParser.add_argument('--run-test', action='store', default=None, help='Regex test filter')
+argumentParser.add_argument('--runs', action='store', type=int, default=3, help='Amount of times each test is executed')
+argumentParser.add_argument('--show-commands', dest='show_commands', action='store_const', const=1, default=0, help='Show the command line used to launch the VM and tests')
+
+# Every step of the incremental collector pauses the script; the VM reports their distribution with --gcstats, so the
+# percentiles below are computed over all steps of one run and then averaged between runs
+
+class TestResult:
+    def __init__(self, vm, name):
+        self.vm = vm
+        self.shortVm = os.path.basename(vm)
+        self.name = name
+        self.failed = False
+        self.runs = []
+
+    def values(self, key):
+        return [run[key] for run in self.runs]
+
+    def avg(self, key):
+        values = self.values(key)
+        return sum(values) / len(values)
+
+    def max(self, key):
+        return max(self.values(key))
+
+def getConfidenceInterval(values):
+    count = len(values)
+    avg = sum(values) / count
+
+    if count < 2:
+        return avg, 0.0, 0.0
+
+    unbiasedEst = sum((v - avg) ** 2 for v in values) / (count - 1)
+    tValue = stats.t.ppf(0.975, count - 1) if stats != None else 1.96
+
+    return avg, unbiasedEst, tValue * math.sqrt(unbiasedEst) / math.sqrt(count)
+
+def runVm(vm, path):
+    cmd = [os.path.abspath(vm), '--gcstats', os.path.relpath(path, scriptdir)]
+
+    if arguments.show_commands:
+        print(f'{colored(Color.BLUE, "EXECUTING")}: {" ".join(cmd)}')
+
+    # scripts find bench_support.lua relative to the working folder, which is where the VM writes the stats as well
+    statsPath = os.path.join(scriptdir, 'gcstats.out')
+
+    try:
+        os.unlink(statsPath)
+    except OSError:
+        pass
+
+    try:
+        subprocess.run(cmd, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL, cwd=scriptdir, check=True)
+    except KeyboardInterrupt:
+        exit(1)
+    except (OSError, subprocess.CalledProcessError):
+        return None
+
+    values = {}
+
+    try:
+        with open(statsPath) as f:
+            for line in f:
+                match = re.match(r'^(\w+) ([0-9.]+)$', line.strip())
+
+                if match:
+                    values[match.group(1)] = float(match.group(2))
+    except OSError:
+        return None
+    finally:
+        try:
+            os.unlink(statsPath)
+        except OSError:
+            pass
+
+    return values if values.get('steps', 0) > 0 else None
+
+def runTest(vm, name, path):
+    result = TestResult(vm, name)
+
+    for i in range(arguments.runs):
+        values = runVm(vm, path)
+
+        if values == None:
+            result.failed = True
+            return result
+
+        result.runs.append(values)
+
+    return result
+
+def collectTests():
+    tests = []
+
+    for root, dirs, files in os.walk(arguments.folder):
+        dirs.sort()
+
+        for file in sorted(files):
+            if file.endswith('.lua') or file.endswith('.luau'):
+                path = os.path.join(root, file)
+                tests.append((os.path.relpath(path, arguments.folder), path))
+
+    if arguments.run_test:
+        tests = [test for test in tests if re.search(arguments.run_test, test[0])]
+
+    return tests
+
+def formatMs(value):
+    return '{:8.3f}ms'.format(value)
+
+def formatUs(value):
+    return '{:8.1f}us'.format(value * 1000)
+
+def compareSignificance(main, compare, key):
+    if stats == None or len(main.runs) < 2:
+        return ''
+
+    mainAvg, mainEst, _ = getConfidenceInterval(main.values(key))
+    compareAvg, compareEst, _ = getConfidenceInterval(compare.values(key))
+
+    pooledStdDev = math.sqrt((mainEst + compareEst) / 2)
+
+    if pooledStdDev == 0:
+        return 'same'
+
+    tStat = abs(mainAvg - compareAvg) / (pooledStdDev * math.sqrt(2 / len(main.runs)))
+    pValue = 2 * (1 - stats.t.cdf(tStat, df=2 * len(main.runs) - 2))
+
+    if pValue >= 0.05:
+        return 'likely same'
+    elif compareAvg < mainAvg:
+        return colored(Color.GREEN, 'likely better')
+    else:
+        return colored(Color.RED, 'likely worse')
+
+def main():
+    vms = [arguments.vm] + (arguments.vmNext if arguments.vmNext else [])
+
+    resultPrinter = TablePrinter([
+        {'label': 'Test', 'align': Alignment.LEFT},
+        {'label': 'Driver', 'align': Alignment.LEFT},
+        {'label': 'Steps', 'align': Alignment.RIGHT},
+        {'label': 'P50', 'align': Alignment.RIGHT},
+        {'label': 'P99', 'align': Alignment.RIGHT},
+        {'label': 'Max', 'align': Alignment.RIGHT},
+        {'label': 'Atomic', 'align': Alignment.RIGHT},
+        {'label': 'Assist', 'align': Alignment.RIGHT},
+        {'label': 'Alloc/s', 'align': Alignment.RIGHT},
+        {'label': 'PeakHeap', 'align': Alignment.RIGHT},
+        {'label': 'P99 Significance', 'align': Alignment.LEFT},
+    ])
+
+    for name, path in collectTests():
+        results = [runTest(vm, name, path) for vm in vms]
+        main = results[0]
+
+        for result in results:
+            if result.failed:
+                print(colored(Color.RED, 'FAILED') + ": '" + name + "' on '" + result.vm + "'")
+                resultPrinter.add_row({ 'Test': name, 'Driver': result.shortVm, 'Steps': '', 'P50': '', 'P99': 'FAILED', 'Max': '', 'Atomic': '', 'Assist': '', 'Alloc/s': '', 'PeakHeap': '', 'P99 Significance': '' })
+                continue
+
+            p99, _, p99ci = getConfidenceInterval(result.values('pausep99'))
+
+            print(colored(Color.GREEN, 'SUCCESS') + ': {:<40}'.format(name) + ': p99 pause ' + formatUs(p99) + ' +/- ' +
+                '{:6.2f}'.format(p99ci / p99 * 100 if p99 > 0 else 0) + '%, max ' + formatUs(result.max('pausemax')) + ' on ' + result.shortVm)
+
+            resultPrinter.add_row({
+                'Test': name,
+                'Driver': result.shortVm,
+                'Steps': '{:d}'.format(int(result.avg('steps'))),
+                'P50': formatUs(result.avg('pausep50')),
+                'P99': formatUs(p99),
+                'Max': formatUs(result.max('pausemax')),
+                'Atomic': formatUs(result.max('atomicmax')),
+                'Assist': formatMs(result.avg('assisttime')),
+                'Alloc/s': '{:8.1f}MB'.format(result.avg('allocrate') / (1024 * 1024)),
+                'PeakHeap': '{:8.1f}MB'.format(result.max('heappeak') / (1024 * 1024)),
+                'P99 Significance': compareSignificance(main, result, 'pausep99') if result is not main and not main.failed else '',
+            })
+
+    resultPrinter.print(summary=False)
+
+if __name__ == "__main__":
+    arguments = argumentParser.parse_args()
+    main()
@@ -0,0 +1,199 @@
+#!/usr/bin/python3
+# This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+
+# Keeps a history of bench.py result files and checks new results against baselines computed from that history.
+#
+# Typical use after every merge:
+#   python bench.py --vm ./luau --filename current
+#   python bench_history.py check current.json --history history && python bench_history.py store current.json --history history
+
+import argparse
+import json
+import math
+import os
+import re
+import shutil
+import sys
+import time
+
+from color import colored, Color
+from tabulate import TablePrinter, Alignment
+
+try:
+    import scipy
+    from scipy import stats
+except ModuleNotFoundError:
+    print("Warning: scipy package is not installed, significance will be estimated with a normal approximation")
+    stats = None
+
+argumentParser = argparse.ArgumentParser(description='Store bench.py results and detect regressions against historical baselines')
+subparsers = argumentParser.add_subparsers(dest='command', required=True)
+
+storeParser = subparsers.add_parser('store', help='Add a result file to the history')
+storeParser.add_argument('results', help='Result file written by bench.py')
+storeParser.add_argument('--history', required=True, help='Folder with stored result files')
+storeParser.add_argument('--label', default=None, help='Label of the results, such as a commit hash (file name by default)')
+
+checkParser = subparsers.add_parser('check', help='Compare a result file with the baseline from the history')
+checkParser.add_argument('results', help='Result file written by bench.py')
+checkParser.add_argument('--history', required=True, help='Folder with stored result files')
+checkParser.add_argument('--window', type=int, default=5, help='Amount of most recent history entries that form the baseline')
+checkParser.add_argument('--threshold', type=float, default=2.0, help='Smallest slowdown in percent that is reported as a regression')
+checkParser.add_argument('--confidence', type=float, default=0.95, help='Confidence level of the significance test')
+checkParser.add_argument('--vm', default=None, help='Regex matching the VM whose results are checked (first VM of each test by default)')
+
+# Returns samples of each test keyed by test name, using the layout of bench.py result files: a list of tests, each holding a
+# list of [filename, vm, shortVm, name, values, count] entries, one for every VM that ran the test
+def loadResults(path, vmFilter):
+    with open(path) as resultsFile:
+        resultArray = json.load(resultsFile)
+
+    results = {}
+
+    for test in resultArray:
+        for entry in test:
+            filename, vm, shortVm, name, values, count = entry
+
+            if vmFilter != None and not re.search(vmFilter, vm):
+                continue
+
+            if values:
+                results[name] = values
+
+            if vmFilter == None:
+                break
+
+    return results
+
+def getHistory(folder):
+    if not os.path.isdir(folder):
+        return []
+
+    return sorted(os.path.join(folder, file) for file in os.listdir(folder) if file.endswith('.json'))
+
+def store():
+    os.makedirs(arguments.history, exist_ok=True)
+
+    label = arguments.label if arguments.label else os.path.splitext(os.path.basename(arguments.results))[0]
+    label = re.sub(r'[^\w.-]', '_', label)
+
+    # timestamp prefix keeps history files in the order they were stored
+    target = os.path.join(arguments.history, time.strftime('%Y%m%d-%H%M%S') + '-' + label + '.json')
+    shutil.copyfile(arguments.results, target)
+
+    print(f"Stored {arguments.results} as {target}")
+
+def getStatistics(values):
+    count = len(values)
+    avg = sum(values) / count
+    var = sum((v - avg) ** 2 for v in values) / (count - 1) if count > 1 else 0.0
+
+    return avg, var, count
+
+# Welch's t-test; returns probability that the difference of means is due to chance
+def getPValue(baseline, current):
+    baseAvg, baseVar, baseCount = getStatistics(baseline)
+    currAvg, currVar, currCount = getStatistics(current)
+
+    if baseCount < 2 or currCount < 2:
+        return 1.0
+
+    stdErr = math.sqrt(baseVar / baseCount + currVar / currCount)
+
+    if stdErr == 0:
+        return 0.0 if baseAvg != currAvg else 1.0
+
+    tStat = abs(currAvg - baseAvg) / stdErr
+
+    if stats != None:
+        dof = (baseVar / baseCount + currVar / currCount) ** 2 / ((baseVar / baseCount) ** 2 / (baseCount - 1) + (currVar / currCount) ** 2 / (currCount - 1))
+        return 2 * (1 - stats.t.cdf(tStat, df=dof))
+
+    return math.erfc(tStat / math.sqrt(2))
+
+def getConfidenceInterval(values):
+    avg, var, count = getStatistics(values)
+
+    if count < 2:
+        return 0.0
+
+    tValue = stats.t.ppf(1 - (1 - arguments.confidence) / 2, count - 1) if stats != None else 1.96
+
+    return tValue * math.sqrt(var / count)
+
+def check():
+    history = getHistory(arguments.history)[-arguments.window:]
+
+    if not history:
+        print(f"{colored(Color.YELLOW, 'WARNING')}: history in '{arguments.history}' is empty, nothing to compare with")
+        return 0
+
+    # samples of all runs in the window are pooled, so the baseline isn't skewed by a single noisy run
+    baseline = {}
+
+    for path in history:
+        for name, values in loadResults(path, arguments.vm).items():
+            baseline.setdefault(name, []).extend(values)
+
+    current = loadResults(arguments.results, arguments.vm)
+
+    resultPrinter = TablePrinter([
+        {'label': 'Test', 'align': Alignment.LEFT},
+        {'label': 'Baseline', 'align': Alignment.RIGHT},
+        {'label': 'Conf.Int.', 'align': Alignment.RIGHT},
+        {'label': 'Current', 'align': Alignment.RIGHT},
+        {'label': 'Change', 'align': Alignment.RIGHT},
+        {'label': 'P(T<=t)', 'align': Alignment.RIGHT},
+        {'label': 'Verdict', 'align': Alignment.LEFT},
+    ])
+
+    regressions = 0
+
+    for name, values in current.items():
+        if name not in baseline:
+            resultPrinter.add_row({ 'Test': name, 'Baseline': '', 'Conf.Int.': '', 'Current': '{:8.3f}ms'.format(sum(values) / len(values)), 'Change': '', 'P(T<=t)': '', 'Verdict': 'new' })
+            continue
+
+        baseAvg = sum(baseline[name]) / len(baseline[name])
+        currAvg = sum(values) / len(values)
+        change = (currAvg / baseAvg - 1) * 100 if baseAvg > 0 else 0.0
+        pValue = getPValue(baseline[name], values)
+
+        significant = pValue < 1 - arguments.confidence
+
+        if significant and change >= arguments.threshold:
+            verdict = colored(Color.RED, 'REGRESSION')
+            regressions += 1
+        elif significant and change <= -arguments.threshold:
+            verdict = colored(Color.GREEN, 'improvement')
+        else:
+            verdict = 'same'
+
+        resultPrinter.add_row({
+            'Test': name,
+            'Baseline': '{:8.3f}ms'.format(baseAvg),
+            'Conf.Int.': '{:6.2f}%'.format(getConfidenceInterval(baseline[name]) / baseAvg * 100 if baseAvg > 0 else 0),
+            'Current': '{:8.3f}ms'.format(currAvg),
+            'Change': '{:+7.2f}%'.format(change),
+            'P(T<=t)': '{:.4f}'.format(pValue),
+            'Verdict': verdict,
+        })
+
+    for name in baseline:
+        if name not in current:
+            resultPrinter.add_row({ 'Test': name, 'Baseline': '{:8.3f}ms'.format(sum(baseline[name]) / len(baseline[name])), 'Conf.Int.': '', 'Current': '', 'Change': '', 'P(T<=t)': '', 'Verdict': colored(Color.YELLOW, 'missing') })
+
+    resultPrinter.print(summary=False)
+
+    print()
+    print(f"Compared with {len(history)} stored result files; {regressions} regression(s) found")
+
+    return 1 if regressions > 0 else 0
+
+if __name__ == "__main__":
+    arguments = argumentParser.parse_args()
+
+    if arguments.command == 'store':
+        store()
+    else:
+        sys.exit(check())
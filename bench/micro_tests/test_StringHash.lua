@@ -0,0 +1,18 @@
+local function prequire(name) local success, result = pcall(require, name); return if success then result else nil end
+local bench = script and require(script.Parent.bench_support) or prequire("bench_support") or require("../bench_support")
+
+local source = string.rep("{\"key\": \"value\", \"array\": [1, 2, 3]}", 256)
+
+function test(len)
+    local sub = string.sub
+
+    for i=1,1e7/len do
+        -- each call hashes the substring to find the interned copy
+        local _ = sub(source, 1, len)
+    end
+end
+
+bench.runCode(function() test(16) end, "string hash: 16 bytes")
+bench.runCode(function() test(64) end, "string hash: 64 bytes")
+bench.runCode(function() test(1024) end, "string hash: 1KB")
+bench.runCode(function() test(8192) end, "string hash: 8KB")
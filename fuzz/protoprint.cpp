@@ -108,6 +108,7 @@ static const std::string kNames[] = {
     "next",
     "nil",
     "noise",
+    "noisegrid",
     "number",
     "offset",
     "os",
@@ -138,6 +139,7 @@ static const std::string kNames[] = {
     "rep",
     "replace",
     "require",
+    "reserve",
     "resume",
     "reverse",
     "round",
@@ -149,10 +151,12 @@ static const std::string kNames[] = {
     "setmetatable",
     "sign",
     "sin",
+    "sinbuffer",
     "sinh",
     "sort",
     "split",
     "sqrt",
+    "sqrtbuffer",
     "status",
     "string",
     "sub",
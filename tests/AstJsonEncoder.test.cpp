@@ -510,4 +510,38 @@ TEST_CASE_FIXTURE(JsonEncoderFixture, "encode_AstTypePackExplicit")
     CHECK(toJson(root->body.data[1]) == expected);
 }
 
+TEST_CASE_FIXTURE(JsonEncoderFixture, "encode_streaming")
+{
+    std::string src = "--!strict\n";
+    for (int i = 0; i < 2000; ++i)
+        src += "local a" + std::to_string(i) + ": number = " + std::to_string(i) + " -- comment\n";
+
+    ParseOptions opts;
+    opts.captureComments = true;
+    ParseResult result = Parser::parse(src.data(), src.size(), names, allocator, opts);
+    REQUIRE(result.errors.empty());
+
+    std::string expected = toJson(result.root, result.commentLocations);
+
+    std::string streamed;
+    int chunks = 0;
+
+    toJson(result.root, result.commentLocations, [&](std::string_view chunk) {
+        CHECK(!chunk.empty());
+        streamed.append(chunk);
+        chunks++;
+    });
+
+    CHECK(streamed == expected);
+    CHECK(chunks > 1);
+
+    // small documents are passed in one piece
+    std::string single;
+    toJson(result.root->body.data[0], [&](std::string_view chunk) {
+        single.append(chunk);
+    });
+
+    CHECK(single == toJson(result.root->body.data[0]));
+}
+
 TEST_SUITE_END();
@@ -323,7 +323,7 @@ TEST_CASE_FIXTURE(ACBuiltinsFixture, "get_member_completions")
 
     auto ac = autocomplete('1');
 
-    CHECK_EQ(17, ac.entryMap.size());
+    CHECK_EQ(18, ac.entryMap.size());
     CHECK(ac.entryMap.count("find"));
     CHECK(ac.entryMap.count("pack"));
     CHECK(!ac.entryMap.count("math"));
@@ -429,7 +429,7 @@ TEST_CASE_FIXTURE(ACBuiltinsFixture, "get_string_completions")
 
     auto ac = autocomplete('1');
 
-    CHECK_EQ(17, ac.entryMap.size());
+    CHECK_EQ(18, ac.entryMap.size());
     CHECK_EQ(ac.context, AutocompleteContext::Property);
 }
 
@@ -4150,4 +4150,104 @@ foo(@1)
     CHECK_EQ(EXPECTED_INSERT, *ac.entryMap[kGeneratedAnonymousFunctionEntryName].insertText);
 }
 
+TEST_CASE_FIXTURE(ACFixture, "fragment_autocomplete_checks_the_edited_statement")
+{
+    check(R"(
+local t = { alpha = 1 }
+local function f()
+end
+    )");
+
+    FrontendOptions opts;
+    opts.forAutocomplete = true;
+    frontend.check("MainModule", opts);
+
+    std::string edited = R"(
+local t = { alpha = 1 }
+local function f()
+    local u = { beta = t.alpha }
+    u.
+end
+    )";
+
+    FragmentAutocompleteResult result = autocompleteFragment(frontend, "MainModule", edited, Position{4, 6}, nullCallback);
+
+    CHECK(result.incrementalModule);
+    CHECK(result.acResults.context == AutocompleteContext::Property);
+    CHECK(result.acResults.entryMap.count("beta"));
+}
+
+TEST_CASE_FIXTURE(ACFixture, "fragment_autocomplete_uses_bindings_of_the_previous_check")
+{
+    check(R"(
+local abc = 1
+local def = "two"
+
+local ghi = true
+    )");
+
+    FrontendOptions opts;
+    opts.forAutocomplete = true;
+    frontend.check("MainModule", opts);
+
+    std::string edited = R"(
+-- an edit above shifts the lines
+local abc = 1
+local def = "two"
+def:
+local ghi = true
+    )";
+
+    FragmentAutocompleteResult result = autocompleteFragment(frontend, "MainModule", edited, Position{4, 4}, nullCallback);
+
+    CHECK(result.acResults.context == AutocompleteContext::Property);
+    CHECK(result.acResults.entryMap.count("upper"));
+
+    edited = R"(
+-- an edit above shifts the lines
+local abc = 1
+local def = "two"
+local jkl = a
+local ghi = true
+    )";
+
+    result = autocompleteFragment(frontend, "MainModule", edited, Position{4, 13}, nullCallback);
+
+    CHECK(result.acResults.entryMap.count("abc"));
+    CHECK(result.acResults.entryMap.count("def"));
+    CHECK(!result.acResults.entryMap.count("ghi"));
+}
+
+TEST_CASE_FIXTURE(ACFixture, "fragment_autocomplete_does_not_modify_the_previous_module")
+{
+    check(R"(
+local t = {}
+    )");
+
+    FrontendOptions opts;
+    opts.forAutocomplete = true;
+    frontend.check("MainModule", opts);
+
+    std::string edited = R"(
+local t = {}
+t.x = 1
+    )";
+
+    FragmentAutocompleteResult result = autocompleteFragment(frontend, "MainModule", edited, Position{2, 7}, nullCallback);
+    CHECK(result.incrementalModule);
+
+    ModulePtr module = frontend.moduleResolverForAutocomplete.getModule("MainModule");
+    REQUIRE(module);
+
+    for (const auto& [symbol, binding] : module->getModuleScope()->bindings)
+    {
+        if (symbol.local && symbol.local->name == "t")
+        {
+            const TableType* ttv = get<TableType>(follow(binding.typeId));
+            REQUIRE(ttv);
+            CHECK(ttv->props.empty());
+        }
+    }
+}
+
 TEST_SUITE_END();
@@ -0,0 +1,145 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#include "BytecodeCache.h"
+#include "FileUtils.h"
+
+#include "Luau/Common.h"
+#include "Luau/Compiler.h"
+
+#include "ScopedFlags.h"
+
+#include "doctest.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+LUAU_FASTINT(LuauCompileInlineThreshold)
+
+static std::string getTempDirectory()
+{
+#ifdef _WIN32
+    const char* temp = getenv("TEMP");
+    return temp ? temp : ".";
+#else
+    return "/tmp";
+#endif
+}
+
+TEST_SUITE_BEGIN("BytecodeCacheTests");
+
+TEST_CASE("KeyDependsOnSourceAndOptions")
+{
+    Luau::CompileOptions options;
+    std::string key = getBytecodeCacheKey("return 1", options);
+
+    CHECK(key == getBytecodeCacheKey("return 1", options));
+    CHECK(key != getBytecodeCacheKey("return 2", options));
+
+    Luau::CompileOptions optimized;
+    optimized.optimizationLevel = 2;
+    CHECK(key != getBytecodeCacheKey("return 1", optimized));
+
+    Luau::CompileOptions vector;
+    vector.vectorCtor = "vector";
+    CHECK(key != getBytecodeCacheKey("return 1", vector));
+
+    const char* mutableGlobals[] = {"Game", nullptr};
+    Luau::CompileOptions globals;
+    globals.mutableGlobals = mutableGlobals;
+    CHECK(key != getBytecodeCacheKey("return 1", globals));
+}
+
+TEST_CASE("KeyDependsOnFlags")
+{
+    Luau::CompileOptions options;
+    std::string key = getBytecodeCacheKey("return 1", options);
+
+    {
+        ScopedFastInt inlineThreshold{FInt::LuauCompileInlineThreshold, FInt::LuauCompileInlineThreshold + 1};
+        CHECK(key != getBytecodeCacheKey("return 1", options));
+    }
+
+    CHECK(key == getBytecodeCacheKey("return 1", options));
+}
+
+TEST_CASE("CompiledBytecodeIsStored")
+{
+    std::string directory = getTempDirectory();
+    std::string source = "local function f(a) return a * 2 end return f(21) -- BytecodeCacheTests";
+
+    Luau::CompileOptions options;
+    std::string key = getBytecodeCacheKey(source, options);
+    remove(joinPaths(directory, key).c_str());
+
+    std::string bytecode = compileCached(directory, source, options);
+    CHECK(bytecode == Luau::compile(source, options));
+
+    std::optional<std::string> cached = readCachedBytecode(directory, key);
+    REQUIRE(cached);
+    CHECK(*cached == bytecode);
+
+    // cache hits return the stored blob
+    writeCachedBytecode(directory, key, "\x05stored");
+    CHECK(compileCached(directory, source, options) == "\x05stored");
+
+    remove(joinPaths(directory, key).c_str());
+}
+
+TEST_CASE("ErrorsAreNotStored")
+{
+    std::string directory = getTempDirectory();
+    std::string source = "local = -- BytecodeCacheTests";
+
+    Luau::CompileOptions options;
+    std::string key = getBytecodeCacheKey(source, options);
+
+    std::string bytecode = compileCached(directory, source, options);
+    REQUIRE(!bytecode.empty());
+    CHECK(bytecode[0] == 0);
+
+    CHECK(!readCachedBytecode(directory, key));
+}
+
+TEST_CASE("BundleRoundTrip")
+{
+    std::string path = joinPaths(getTempDirectory(), "BytecodeCacheTests.bundle");
+
+    std::string bytecode = Luau::compile("return 1");
+    BytecodeBundle bundle = {{"lib/b.luau", bytecode}, {"/a.luau", std::string("\0\1\2", 3)}, {"lib/c.luau", bytecode}, {"", ""}};
+    REQUIRE(writeBytecodeBundle(path, bundle));
+
+    std::optional<BytecodeBundleFile> result = BytecodeBundleFile::open(path);
+    REQUIRE(result);
+    REQUIRE(result->size() == 4);
+
+    // index is sorted by path
+    CHECK(result->getPath(0) == "");
+    CHECK(result->getPath(1) == "/a.luau");
+    CHECK(result->getPath(2) == "lib/b.luau");
+    CHECK(result->getPath(3) == "lib/c.luau");
+
+    CHECK(result->find("/a.luau") == std::string_view("\0\1\2", 3));
+    CHECK(result->find("lib/b.luau") == bytecode);
+    CHECK(result->find("lib/c.luau") == bytecode);
+    CHECK(result->find("") == "");
+    CHECK(!result->find("lib/d.luau"));
+
+    // identical blobs are stored once
+    CHECK(result->getBytecode(2).data() == result->getBytecode(3).data());
+
+    result.reset();
+
+    // truncated bundles are rejected
+    std::optional<std::string> data = readFile(path);
+    REQUIRE(data);
+
+    FILE* file = fopen(path.c_str(), "wb");
+    REQUIRE(file);
+    fwrite(data->data(), 1, data->size() - 1, file);
+    fclose(file);
+
+    CHECK(!BytecodeBundleFile::open(path));
+
+    remove(path.c_str());
+}
+
+TEST_SUITE_END();
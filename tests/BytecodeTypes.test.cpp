@@ -0,0 +1,75 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#include "Luau/BytecodeTypes.h"
+
+#include "Luau/BytecodeBuilder.h"
+#include "Luau/Compiler.h"
+
+#include "Fixture.h"
+
+#include "doctest.h"
+
+using namespace Luau;
+
+struct BytecodeTypesFixture : BuiltinsFixture
+{
+    std::string compileTypeTable(const std::string& source)
+    {
+        CheckResult result = check(source);
+        LUAU_REQUIRE_NO_ERRORS(result);
+
+        SourceModule* sourceModule = getMainSourceModule();
+        ModulePtr module = getMainModule();
+
+        InferredTypes inferredTypes = getInferredArgumentTypes(*module, "Vector3");
+
+        ParseResult parseResult{sourceModule->root, 0, sourceModule->hotcomments, {}, sourceModule->commentLocations};
+
+        BytecodeBuilder bcb;
+        CompileOptions options;
+        options.vectorType = "Vector3";
+        compileOrThrow(bcb, parseResult, *sourceModule->names, options, &inferredTypes);
+
+        return bcb.dumpTypeInfo();
+    }
+};
+
+TEST_SUITE_BEGIN("BytecodeTypes");
+
+TEST_CASE_FIXTURE(BytecodeTypesFixture, "InferredArgumentTypes")
+{
+    CHECK_EQ("\n" + compileTypeTable(R"(
+--!strict
+local function scale(a, b: number)
+    return math.floor(a) + b
+end
+
+local function field(t: { x: string }, fallback)
+    return t.x .. fallback
+end
+
+local function any(a, b)
+    return a, b
+end
+
+return scale(1, 2), field({ x = "a" }, "b"), any(1, 2)
+)"),
+        R"(
+0: function(number, number)
+1: function(table, string)
+)");
+}
+
+TEST_CASE_FIXTURE(BytecodeTypesFixture, "AnnotationsTakePrecedence")
+{
+    CHECK_EQ("\n" + compileTypeTable(R"(
+--!strict
+local function f(a: any, b)
+    return (b :: number) + 1
+end
+
+return f(1, 2)
+)"),
+        "\n");
+}
+
+TEST_SUITE_END();
@@ -119,6 +119,104 @@ TEST_CASE("CodeAllocationFailure")
     REQUIRE(!allocator.allocate(nullptr, 0, code.data(), code.size(), nativeData, sizeNativeData, nativeEntry));
 }
 
+TEST_CASE("CodeAllocationRelease")
+{
+    struct AllocationData
+    {
+        size_t bytesAllocated = 0;
+        size_t bytesFreed = 0;
+    };
+
+    AllocationData allocationData{};
+
+    const auto allocationCallback = [](void* context, void* oldPointer, size_t oldSize, void* newPointer, size_t newSize) {
+        AllocationData& allocationData = *static_cast<AllocationData*>(context);
+        if (oldPointer != nullptr)
+            allocationData.bytesFreed += oldSize;
+
+        if (newPointer != nullptr)
+            allocationData.bytesAllocated += newSize;
+    };
+
+    size_t blockSize = 3000;
+    size_t maxTotalSize = 7000;
+    CodeAllocator allocator(blockSize, maxTotalSize, allocationCallback, &allocationData);
+
+    uint8_t* nativeData1;
+    uint8_t* nativeData2;
+    uint8_t* nativeData3;
+    size_t sizeNativeData;
+    uint8_t* nativeEntry;
+
+    std::vector<uint8_t> code;
+    code.resize(2000);
+
+    // each allocation exhausts a block
+    REQUIRE(allocator.allocate(nullptr, 0, code.data(), code.size(), nativeData1, sizeNativeData, nativeEntry));
+    REQUIRE(allocator.allocate(nullptr, 0, code.data(), code.size(), nativeData2, sizeNativeData, nativeEntry));
+    REQUIRE(!allocator.allocate(nullptr, 0, code.data(), code.size(), nativeData3, sizeNativeData, nativeEntry));
+    CHECK(allocationData.bytesFreed == 0);
+
+    // releasing the last allocation of a block frees the block, which makes space for a new one
+    allocator.deallocate(nativeData1);
+    CHECK(allocationData.bytesFreed == allocationData.bytesAllocated / 2);
+
+    REQUIRE(allocator.allocate(nullptr, 0, code.data(), code.size(), nativeData3, sizeNativeData, nativeEntry));
+
+    // current block is released as well
+    allocator.deallocate(nativeData3);
+    allocator.deallocate(nativeData2);
+    CHECK(allocationData.bytesFreed == allocationData.bytesAllocated);
+
+    REQUIRE(allocator.allocate(nullptr, 0, code.data(), code.size(), nativeData1, sizeNativeData, nativeEntry));
+}
+
+TEST_CASE("CodeAllocationFindBlock")
+{
+    size_t blockSize = 3000;
+    size_t maxTotalSize = 12000;
+    CodeAllocator allocator(blockSize, maxTotalSize);
+
+    uint8_t* nativeData[4];
+    size_t sizeNativeData;
+    uint8_t* nativeEntry;
+
+    std::vector<uint8_t> code;
+    code.resize(2000);
+
+    // each allocation exhausts a block
+    for (uint8_t*& data : nativeData)
+        REQUIRE(allocator.allocate(nullptr, 0, code.data(), code.size(), data, sizeNativeData, nativeEntry));
+
+    size_t liveAllocations = 0;
+
+    for (uint8_t* data : nativeData)
+    {
+        uint8_t* block = allocator.findBlock(data, liveAllocations);
+        CHECK(block <= data);
+        CHECK(data < block + blockSize);
+        CHECK(liveAllocations == 1);
+    }
+
+    // blocks are found after others are released in any order
+    allocator.deallocate(nativeData[2]);
+    allocator.deallocate(nativeData[0]);
+
+    CHECK(allocator.findBlock(nativeData[1], liveAllocations) <= nativeData[1]);
+    CHECK(allocator.findBlock(nativeData[3], liveAllocations) <= nativeData[3]);
+
+    REQUIRE(allocator.allocate(nullptr, 0, code.data(), code.size(), nativeData[0], sizeNativeData, nativeEntry));
+    CHECK(allocator.findBlock(nativeData[0], liveAllocations) <= nativeData[0]);
+
+    allocator.deallocate(nativeData[3]);
+    allocator.deallocate(nativeData[1]);
+    allocator.deallocate(nativeData[0]);
+
+    // all blocks are released
+    for (uint8_t*& data : nativeData)
+        REQUIRE(allocator.allocate(nullptr, 0, code.data(), code.size(), data, sizeNativeData, nativeEntry));
+}
+
 TEST_CASE("CodeAllocationWithUnwindCallbacks")
 {
     struct Info
@@ -21,6 +21,12 @@ LUAU_FASTINT(LuauCompileInlineThresholdMaxBoost)
 LUAU_FASTINT(LuauCompileLoopUnrollThreshold)
 LUAU_FASTINT(LuauCompileLoopUnrollThresholdMaxBoost)
 LUAU_FASTINT(LuauRecursionLimit)
+LUAU_FASTFLAG(LuauCompileSuperinstructions)
+LUAU_FASTFLAG(LuauCompileTailCalls)
+LUAU_FASTFLAG(LuauCompileDedupFunctions)
+LUAU_FASTFLAG(LuauCompileDeadStores)
+LUAU_FASTFLAG(LuauCompileLoopClosures)
+LUAU_FASTFLAG(LuauCompileSelectVararg)
 
 using namespace Luau;
 
@@ -871,6 +877,49 @@ RETURN R0 1
 )");
 }
 
+TEST_CASE("TableSizePredictionRecord")
+{
+    // fields assigned after construction are preallocated, which requires giving up on the template
+    CHECK_EQ("\n" + compileFunction0(R"(
+local t = {a = 1, b = 2}
+t.b = 3
+t.c = 4
+t.d = 5
+return t
+)"),
+        R"(
+NEWTABLE R0 4 0
+LOADN R1 1
+SETTABLEKS R1 R0 K0 ['a']
+LOADN R1 2
+SETTABLEKS R1 R0 K1 ['b']
+LOADN R1 3
+SETTABLEKS R1 R0 K1 ['b']
+LOADN R1 4
+SETTABLEKS R1 R0 K2 ['c']
+LOADN R1 5
+SETTABLEKS R1 R0 K3 ['d']
+RETURN R0 1
+)");
+
+    // tables with list items are not extended
+    CHECK_EQ("\n" + compileFunction0(R"(
+local t = {1, b = 2}
+t.c = 3
+return t
+)"),
+        R"(
+NEWTABLE R0 1 1
+LOADN R1 1
+SETLIST R0 R1 1 [1]
+LOADN R2 2
+SETTABLEKS R2 R0 K0 ['b']
+LOADN R1 3
+SETTABLEKS R1 R0 K1 ['c']
+RETURN R0 1
+)");
+}
+
 TEST_CASE("TableSizePredictionLoop")
 {
     CHECK_EQ("\n" + compileFunction0(R"(
@@ -2261,37 +2310,39 @@ end
         R"(
 ORK R6 R3 K0 [0]
 ORK R7 R4 K1 [1]
-JUMPIF R5 L0
-GETIMPORT R10 5 [math.noise]
+JUMPIF R5 L1
 DIV R13 R0 R7
-MULK R14 R6 K6 [17]
+MULK R14 R6 K3 [17]
 ADD R12 R13 R14
-GETIMPORT R13 8 [masterSeed]
+GETIMPORT R13 5 [masterSeed]
 ADD R11 R12 R13
 DIV R13 R1 R7
-GETIMPORT R14 8 [masterSeed]
+GETIMPORT R14 5 [masterSeed]
 SUB R12 R13 R14
 DIV R14 R2 R7
 MUL R15 R6 R6
 SUB R13 R14 R15
+FASTCALL 80 L0
+GETIMPORT R10 8 [math.noise]
 CALL R10 3 1
-MULK R9 R10 K2 [0.5]
+L0: MULK R9 R10 K2 [0.5]
 ADDK R8 R9 K2 [0.5]
 RETURN R8 1
-L0: GETIMPORT R8 5 [math.noise]
-DIV R11 R0 R7
-MULK R12 R6 K6 [17]
+L1: DIV R11 R0 R7
+MULK R12 R6 K3 [17]
 ADD R10 R11 R12
-GETIMPORT R11 8 [masterSeed]
+GETIMPORT R11 5 [masterSeed]
 ADD R9 R10 R11
 DIV R11 R1 R7
-GETIMPORT R12 8 [masterSeed]
+GETIMPORT R12 5 [masterSeed]
 SUB R10 R11 R12
 DIV R12 R2 R7
 MUL R13 R6 R6
 SUB R11 R12 R13
+FASTCALL 80 L2
+GETIMPORT R8 8 [math.noise]
 CALL R8 3 -1
-RETURN R8 -1
+L2: RETURN R8 -1
 )");
 }
 
@@ -3084,6 +3135,55 @@ local 8: reg 3, start pc 35 line 21, end pc 35 line 21
 )");
 }
 
+TEST_CASE("DeadStoreRemoval")
+{
+    ScopedFastFlag luauCompileDeadStores{FFlag::LuauCompileDeadStores, true};
+
+    const char* source = R"(
+local function foo(n)
+    local a a = 1
+    local b
+    b = n
+    for i=1,n do
+        local c c = i
+        print(c)
+    end
+    return a, b
+end
+)";
+
+    Luau::BytecodeBuilder bcb;
+    bcb.setDumpFlags(Luau::BytecodeBuilder::Dump_Code | Luau::BytecodeBuilder::Dump_Lines | Luau::BytecodeBuilder::Dump_Locals);
+    bcb.setDumpSource(source);
+
+    Luau::CompileOptions options;
+    options.debugLevel = 2;
+
+    Luau::compileOrThrow(bcb, source, options);
+
+    // stores on a different line from the overwriting instruction are kept; loop jumps and local ranges are adjusted
+    CHECK_EQ("\n" + bcb.dumpFunction(0), R"(
+local 0: reg 6, start pc 7 line 7, end pc 11 line 8
+local 1: reg 5, start pc 7 line 7, end pc 11 line 8
+local 2: reg 0, start pc 0 line 3, end pc 13 line 10
+local 3: reg 1, start pc 0 line 3, end pc 13 line 10
+local 4: reg 2, start pc 2 line 5, end pc 13 line 10
+3: LOADN R1 1
+4: LOADNIL R2
+5: MOVE R2 R0
+6: LOADN R5 1
+6: MOVE R3 R0
+6: LOADN R4 1
+6: FORNPREP R3 L1
+7: L0: MOVE R6 R5
+8: GETIMPORT R7 1 [print]
+8: MOVE R8 R6
+8: CALL R7 1 0
+6: FORNLOOP R3 L0
+10: L1: RETURN R1 2
+)");
+}
+
 TEST_CASE("DebugRemarks")
 {
     Luau::BytecodeBuilder bcb;
@@ -3148,6 +3248,106 @@ return foo(a) + foo(assert(b))
 )");
 }
 
+TEST_CASE("ProfileGuidedRemarks")
+{
+    const char* source = R"(
+local function foo(t, x)
+    return t[x] + t[x + 1] + t[x + 2] + t[x + 3] + t[x + 4] + t[x + 5] + t[x + 6] + t[x + 7] + t[x + 8] + t[x + 9]
+end
+
+local function hot(t)
+    local s = foo(t, 1)
+    for i = 1, 30 do
+        s += t[i]
+    end
+    return s
+end
+
+local function cold(t)
+    local s = foo(t, 1)
+    for i = 1, 30 do
+        s += t[i]
+    end
+    return s
+end
+
+return hot, cold
+)";
+
+    auto getRemarks = [&](const int* hotFunctions) {
+        Luau::BytecodeBuilder bcb;
+        bcb.setDumpFlags(Luau::BytecodeBuilder::Dump_Source | Luau::BytecodeBuilder::Dump_Remarks);
+        bcb.setDumpSource(source);
+
+        Luau::CompileOptions options;
+        options.optimizationLevel = 2;
+        options.hotFunctions = hotFunctions;
+
+        Luau::compileOrThrow(bcb, source, options);
+
+        return bcb.dumpSourceRemarks();
+    };
+
+    CHECK_EQ(getRemarks(nullptr), R"(
+local function foo(t, x)
+    return t[x] + t[x + 1] + t[x + 2] + t[x + 3] + t[x + 4] + t[x + 5] + t[x + 6] + t[x + 7] + t[x + 8] + t[x + 9]
+end
+
+local function hot(t)
+    -- remark: inlining succeeded (cost 19, profit 1.63x, depth 0)
+    local s = foo(t, 1)
+    -- remark: loop unroll failed: too many iterations (30)
+    for i = 1, 30 do
+        s += t[i]
+    end
+    return s
+end
+
+local function cold(t)
+    -- remark: inlining succeeded (cost 19, profit 1.63x, depth 0)
+    local s = foo(t, 1)
+    -- remark: loop unroll failed: too many iterations (30)
+    for i = 1, 30 do
+        s += t[i]
+    end
+    return s
+end
+
+return hot, cold
+)");
+
+    // hot function gets a higher loop unroll threshold, other functions don't grow the code
+    const int hotFunctions[] = {6, 0};
+
+    CHECK_EQ(getRemarks(hotFunctions), R"(
+local function foo(t, x)
+    return t[x] + t[x + 1] + t[x + 2] + t[x + 3] + t[x + 4] + t[x + 5] + t[x + 6] + t[x + 7] + t[x + 8] + t[x + 9]
+end
+
+local function hot(t)
+    -- remark: inlining succeeded (cost 19, profit 1.63x, depth 0)
+    local s = foo(t, 1)
+    -- remark: loop unroll succeeded (iterations 30, cost 60, profit 1.50x)
+    for i = 1, 30 do
+        s += t[i]
+    end
+    return s
+end
+
+local function cold(t)
+    -- remark: inlining skipped: cold function
+    local s = foo(t, 1)
+    -- remark: loop unroll skipped: cold function
+    for i = 1, 30 do
+        s += t[i]
+    end
+    return s
+end
+
+return hot, cold
+)");
+}
+
 TEST_CASE("AssignmentConflict")
 {
     // assignments are left to right
@@ -3369,6 +3569,30 @@ RETURN R0 -1
 )");
 }
 
+TEST_CASE("FastcallSelectMultiple")
+{
+    ScopedFastFlag luauCompileSelectVararg{FFlag::LuauCompileSelectVararg, true};
+
+    // multiple returns are read by the builtin directly as well
+    CHECK_EQ("\n" + compileFunction0("return select('#', ...)"), R"(
+LOADK R1 K0 ['#']
+FASTCALL1 57 R1 L0
+GETIMPORT R0 2 [select]
+GETVARARGS R2 -1
+CALL R0 -1 -1
+L0: RETURN R0 -1
+)");
+
+    CHECK_EQ("\n" + compileFunction0("local a, b = select(2, ...) return a, b"), R"(
+LOADN R1 2
+FASTCALL1 57 R1 L0
+GETIMPORT R0 1 [select]
+GETVARARGS R2 -1
+CALL R0 -1 2
+L0: RETURN R0 2
+)");
+}
+
 TEST_CASE("LotsOfParameters")
 {
     const char* source = R"(
@@ -4364,6 +4588,135 @@ L5: RETURN R0 0
 )");
 }
 
+TEST_CASE("LoopClosureHoisting")
+{
+    ScopedFastFlag luauCompileLoopClosures{FFlag::LuauCompileLoopClosures, true};
+
+    // closures that only capture values which don't change in the loop are created once before the loop
+    CHECK_EQ("\n" + compileFunction(R"(
+local function foo(t, k)
+    for i = 1, #t do
+        t[i] = function() return k end
+    end
+end
+)",
+                        1, 2),
+        R"(
+NEWCLOSURE R2 P0
+CAPTURE VAL R1
+LOADN R5 1
+LENGTH R3 R0
+LOADN R4 1
+FORNPREP R3 L1
+L0: MOVE R6 R2
+SETTABLE R6 R0 R5
+FORNLOOP R3 L0
+L1: RETURN R0 0
+)");
+
+    // ... as long as the values aren't mutated
+    CHECK_EQ("\n" + compileFunction(R"(
+local function foo(t, k)
+    for i = 1, #t do
+        t[i] = function() return k end
+        k = i
+    end
+end
+)",
+                        1, 2),
+        R"(
+LOADN R4 1
+LENGTH R2 R0
+LOADN R3 1
+FORNPREP R2 L1
+L0: NEWCLOSURE R5 P0
+CAPTURE REF R1
+SETTABLE R5 R0 R4
+MOVE R1 R4
+FORNLOOP R2 L0
+L1: CLOSEUPVALS R1
+RETURN R0 0
+)");
+
+    // ... and aren't declared inside the loop
+    CHECK_EQ("\n" + compileFunction(R"(
+local function foo(t, k)
+    for i = 1, #t do
+        local v = t[i]
+        t[i] = function() return k + v end
+    end
+end
+)",
+                        1, 2),
+        R"(
+LOADN R4 1
+LENGTH R2 R0
+LOADN R3 1
+FORNPREP R2 L1
+L0: GETTABLE R5 R0 R4
+NEWCLOSURE R6 P0
+CAPTURE VAL R1
+CAPTURE VAL R5
+SETTABLE R6 R0 R4
+FORNLOOP R2 L0
+L1: RETURN R0 0
+)");
+
+    // closure from an inner loop is hoisted out of the outer loop when possible
+    CHECK_EQ("\n" + compileFunction(R"(
+local function foo(t, k)
+    while #t > 0 do
+        for i = 1, #t do
+            t[i] = function() return k end
+        end
+    end
+end
+)",
+                        1, 2),
+        R"(
+NEWCLOSURE R2 P0
+CAPTURE VAL R1
+L0: LENGTH R3 R0
+LOADN R4 0
+JUMPIFNOTLT R4 R3 L3
+LOADN R5 1
+LENGTH R3 R0
+LOADN R4 1
+FORNPREP R3 L2
+L1: MOVE R6 R2
+SETTABLE R6 R0 R5
+FORNLOOP R3 L1
+L2: JUMPBACK L0
+L3: RETURN R0 0
+)");
+}
+
+TEST_CASE("LoopClosureHoistingDisabled")
+{
+    ScopedFastFlag luauCompileLoopClosures{FFlag::LuauCompileLoopClosures, false};
+
+    // without the flag, each iteration creates a new closure so that closures from different iterations are distinct
+    CHECK_EQ("\n" + compileFunction(R"(
+local function foo(t, k)
+    for i = 1, #t do
+        t[i] = function() return k end
+    end
+end
+)",
+                        1, 2),
+        R"(
+LOADN R4 1
+LENGTH R2 R0
+LOADN R3 1
+FORNPREP R2 L1
+L0: NEWCLOSURE R5 P0
+CAPTURE VAL R1
+SETTABLE R5 R0 R4
+FORNLOOP R2 L0
+L1: RETURN R0 0
+)");
+}
+
 TEST_CASE("MutableGlobals")
 {
     const char* source = R"(
@@ -4482,6 +4835,45 @@ L0: RETURN R0 -1
 )");
 }
 
+TEST_CASE("UserBuiltinFastCall")
+{
+    const char* source = R"(
+local x = ...
+return clamp(x, 0, 1), Engine.lerp(x, 2), math.abs(x), Engine.other(x)
+)";
+
+    const char* userBuiltins[] = {"clamp", "Engine.lerp", "math.abs", NULL};
+
+    Luau::BytecodeBuilder bcb;
+    bcb.setDumpFlags(Luau::BytecodeBuilder::Dump_Code);
+    Luau::CompileOptions options;
+    options.userBuiltins = userBuiltins;
+    Luau::compileOrThrow(bcb, source, options);
+
+    CHECK_EQ("\n" + bcb.dumpFunction(0), R"(
+GETVARARGS R0 1
+MOVE R2 R0
+LOADN R3 0
+LOADN R4 1
+FASTCALL 224 L0
+GETIMPORT R1 1 [clamp]
+CALL R1 3 1
+L0: FASTCALL2K 225 R0 K2 L1 [2]
+MOVE R3 R0
+LOADK R4 K2 [2]
+GETIMPORT R2 5 [Engine.lerp]
+CALL R2 2 1
+L1: FASTCALL1 226 R0 L2
+MOVE R4 R0
+GETIMPORT R3 8 [math.abs]
+CALL R3 1 1
+L2: GETIMPORT R4 10 [Engine.other]
+MOVE R5 R0
+CALL R4 1 -1
+RETURN R1 -1
+)");
+}
+
 TEST_CASE("VectorLiterals")
 {
     CHECK_EQ("\n" + compileFunction("return Vector3.new(1, 2, 3)", 0, 2, /*enableVectors*/ true), R"(
@@ -7606,6 +7998,85 @@ RETURN R0 1
 )");
 }
 
+TEST_CASE("RequireConstantFold")
+{
+    auto compileWithModules = [](const char* source) {
+        Luau::BytecodeBuilder bcb;
+        bcb.setDumpFlags(Luau::BytecodeBuilder::Dump_Code);
+
+        Luau::CompileOptions options;
+        options.requireConstantCb = [](void* context, const char* path, const char* member, Luau::CompileConstant* constant) {
+            if (strcmp(path, "./config") != 0)
+                return;
+
+            if (strcmp(member, "Speed") == 0)
+            {
+                constant->type = 3;
+                constant->valueNumber = 16;
+            }
+            else if (strcmp(member, "Name") == 0)
+            {
+                constant->type = 4;
+                constant->valueString = "player";
+                constant->stringLength = 6;
+            }
+        };
+
+        Luau::compileOrThrow(bcb, source, options);
+
+        return bcb.dumpFunction(0);
+    };
+
+    // known fields of the required module are folded
+    CHECK_EQ("\n" + compileWithModules(R"(
+local config = require("./config")
+
+function test(x)
+    return x * config.Speed, config.Name, config.Other
+end
+)"),
+        R"(
+MULK R1 R0 K0 [16]
+LOADK R2 K1 ['player']
+GETUPVAL R4 0
+GETTABLEKS R3 R4 K2 ['Other']
+RETURN R1 3
+)");
+
+    // the local has to keep the module for its entire lifetime
+    CHECK_EQ("\n" + compileWithModules(R"(
+local config = require("./config")
+config = {}
+
+function test(x)
+    return x * config.Speed
+end
+)"),
+        R"(
+GETUPVAL R3 0
+GETTABLEKS R2 R3 K0 ['Speed']
+MUL R1 R0 R2
+RETURN R1 1
+)");
+
+    // and the global has to refer to the builtin require
+    CHECK_EQ("\n" + compileWithModules(R"(
+local config = require("./config")
+
+function test(x)
+    return x * config.Speed
+end
+
+require = nil
+)"),
+        R"(
+GETUPVAL R3 0
+GETTABLEKS R2 R3 K0 ['Speed']
+MUL R1 R0 R2
+RETURN R1 1
+)");
+}
+
 TEST_CASE("NoBuiltinFoldFenv")
 {
     // builtin folding is disabled when getfenv/setfenv is used in the module
@@ -7868,4 +8339,240 @@ RETURN R1 7
 )");
 }
 
+TEST_CASE("SuperinstructionMove2")
+{
+    ScopedFastFlag luauCompileSuperinstructions{FFlag::LuauCompileSuperinstructions, true};
+
+    // consecutive moves are fused into one instruction
+    CHECK_EQ("\n" + compileFunction(R"(
+local function swap(a, b)
+    a, b = b, a
+    return a, b
+end
+)",
+                        0),
+        R"(
+MOVE2 R2 R1 R1 R0
+MOVE R0 R2
+RETURN R0 2
+)");
+
+    // moves on different lines are kept separate to preserve line info
+    CHECK_EQ("\n" + compileFunction(R"(
+local function lines(a, b)
+    local x, y = a, b
+    x = b
+    y = a
+    return x, y
+end
+)",
+                        0),
+        R"(
+MOVE2 R2 R0 R3 R1
+MOVE R2 R1
+MOVE R3 R0
+RETURN R2 2
+)");
+
+    // jump targets can't be in the middle of a superinstruction
+    CHECK_EQ("\n" + compileFunction(R"(
+local function target(a, b, c)
+    local x, y
+    if c then x = b end
+    x, y = a, b
+    return x, y
+end
+)",
+                        0),
+        R"(
+LOADNIL R3
+LOADNIL R4
+JUMPIFNOT R2 L0
+MOVE R3 R1
+L0: MOVE2 R3 R0 R4 R1
+RETURN R3 2
+)");
+
+    // superinstructions are only formed with optimizations enabled
+    CHECK_EQ("\n" + compileFunction(R"(
+local function swap(a, b)
+    a, b = b, a
+    return a, b
+end
+)",
+                        0, 0),
+        R"(
+MOVE R2 R1
+MOVE R1 R0
+MOVE R0 R2
+RETURN R0 2
+)");
+}
+
+TEST_CASE("TailCalls")
+{
+    ScopedFastFlag luauCompileTailCalls{FFlag::LuauCompileTailCalls, true};
+
+    // calls that are directly returned reuse the caller frame
+    CHECK_EQ("\n" + compileFunction(R"(
+local function countdown(n)
+    if n == 0 then return "done" end
+    return countdown(n - 1)
+end
+)",
+                        0),
+        R"(
+JUMPXEQKN R0 K0 L0 NOT [0]
+LOADK R1 K1 ['done']
+RETURN R1 1
+L0: GETUPVAL R1 0
+SUBK R2 R0 K2 [1]
+TAILCALL R1 1
+RETURN R1 -1
+)");
+
+    // method calls in tail position are supported as well
+    CHECK_EQ("\n" + compileFunction(R"(
+local function step(obj, x)
+    return obj:step(x)
+end
+)",
+                        0),
+        R"(
+MOVE R4 R1
+NAMECALL R2 R0 K0 ['step']
+TAILCALL R2 2
+RETURN R2 -1
+)");
+
+    // calls with adjusted results are not in tail position
+    CHECK_EQ("\n" + compileFunction(R"(
+local function adjust(g, x)
+    if x then
+        return (g(x))
+    end
+    return g(x), 1
+end
+)",
+                        0),
+        R"(
+JUMPIFNOT R1 L0
+MOVE R2 R0
+MOVE R3 R1
+CALL R2 1 1
+RETURN R2 1
+L0: MOVE R2 R0
+MOVE R3 R1
+CALL R2 1 1
+LOADN R3 1
+RETURN R2 2
+)");
+
+    // fastcall fallbacks are left alone since the builtin path jumps to the return
+    CHECK_EQ("\n" + compileFunction(R"(
+local function abs(x)
+    return math.abs(x)
+end
+)",
+                        0),
+        R"(
+FASTCALL1 2 R0 L0
+MOVE R2 R0
+GETIMPORT R1 2 [math.abs]
+CALL R1 1 -1
+L0: RETURN R1 -1
+)");
+
+    // tail calls are only formed with optimizations enabled
+    CHECK_EQ("\n" + compileFunction(R"(
+local function call(g, x)
+    return g(x, 1)
+end
+)",
+                        0, 0),
+        R"(
+MOVE R2 R0
+MOVE R3 R1
+LOADK R4 K0 [1]
+CALL R2 2 -1
+RETURN R2 -1
+)");
+
+    // full debug info keeps every frame in the call stack
+    const char* source = R"(
+local function call(g, x)
+    return g(x, 1)
+end
+)";
+
+    Luau::BytecodeBuilder bcb;
+    bcb.setDumpFlags(Luau::BytecodeBuilder::Dump_Code);
+
+    Luau::CompileOptions options;
+    options.debugLevel = 2;
+
+    Luau::compileOrThrow(bcb, source, options);
+
+    CHECK_EQ("\n" + bcb.dumpFunction(0), R"(
+MOVE R2 R0
+MOVE R3 R1
+LOADN R4 1
+CALL R2 2 -1
+RETURN R2 -1
+)");
+}
+
+TEST_CASE("DedupFunctions")
+{
+    ScopedFastFlag luauCompileDedupFunctions{FFlag::LuauCompileDedupFunctions, true};
+
+    const char* source = R"(
+local a = function(x) return x + 1 end
+local b = function(y) return y + 1 end
+local c = function(x) return x + 2 end
+local d = function() return a end
+local e = function() return b end
+return a, b, c, d, e
+)";
+
+    Luau::BytecodeBuilder bcb;
+    bcb.setDumpFlags(Luau::BytecodeBuilder::Dump_Code);
+    Luau::CompileOptions options;
+    options.debugLevel = 0;
+    Luau::compileOrThrow(bcb, source, options);
+
+    // 'b' shares the proto of 'a'; 'd' and 'e' capture different locals so they can't be shared
+    CHECK_EQ("\n" + bcb.dumpFunction(4), R"(
+DUPCLOSURE R0 K0 []
+DUPCLOSURE R1 K0 []
+DUPCLOSURE R2 K1 []
+DUPCLOSURE R3 K2 []
+CAPTURE VAL R0
+DUPCLOSURE R4 K3 []
+CAPTURE VAL R1
+RETURN R0 5
+)");
+}
+
+TEST_CASE("DedupFunctionsRequiresNoDebugInfo")
+{
+    ScopedFastFlag luauCompileDedupFunctions{FFlag::LuauCompileDedupFunctions, true};
+
+    const char* source = R"(
+local a = function(x) return x + 1 end
+local b = function(x) return x + 1 end
+return a, b
+)";
+
+    Luau::BytecodeBuilder bcb;
+    bcb.setDumpFlags(Luau::BytecodeBuilder::Dump_Code);
+    Luau::compileOrThrow(bcb, source);
+
+    CHECK_EQ("\n" + bcb.dumpFunction(2), R"(
+DUPCLOSURE R0 K0 []
+DUPCLOSURE R1 K1 []
+RETURN R0 2
+)");
+}
+
 TEST_SUITE_END();
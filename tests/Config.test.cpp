@@ -153,4 +153,116 @@ TEST_CASE("lint_rules_compat")
     CHECK(config.fatalLint.isEnabled(LintWarning::Code_ImportUnused));
 }
 
+struct TestConfigFileSource : ConfigFileSource
+{
+    std::unordered_map<std::string, std::string> files;
+    std::unordered_map<std::string, uint64_t> versions;
+    mutable int reads = 0;
+
+    std::optional<std::string> getParentDirectory(const std::string& directory) const override
+    {
+        size_t slash = directory.find_last_of('/');
+        if (slash == std::string::npos)
+            return std::nullopt;
+
+        return directory.substr(0, slash);
+    }
+
+    std::optional<std::string> readConfigFile(const std::string& directory) const override
+    {
+        reads++;
+
+        if (auto it = files.find(directory); it != files.end())
+            return it->second;
+
+        return std::nullopt;
+    }
+
+    uint64_t getConfigFileVersion(const std::string& directory) const override
+    {
+        if (auto it = versions.find(directory); it != versions.end())
+            return it->second;
+
+        return 0;
+    }
+};
+
+TEST_CASE("config_cache_inherits_parent_configuration")
+{
+    TestConfigFileSource source;
+    source.files["root"] = R"({"languageMode":"strict", "globals": ["a"]})";
+    source.files["root/sub"] = R"({"languageMode":"nonstrict"})";
+
+    ConfigCache cache(source);
+
+    const Config& sub = cache.getConfig("root/sub/dir");
+    CHECK_EQ(int(Mode::Nonstrict), int(sub.mode));
+    REQUIRE(sub.globals.size() == 1);
+    CHECK(sub.globals[0] == "a");
+
+    CHECK_EQ(int(Mode::Strict), int(cache.getConfig("root/other").mode));
+    CHECK_EQ(int(Mode::Strict), int(cache.getConfig("root").mode));
+
+    // every directory is read exactly once
+    CHECK(source.reads == 4);
+    cache.getConfig("root/sub/dir");
+    cache.getConfig("root/sub");
+    CHECK(source.reads == 4);
+}
+
+TEST_CASE("config_cache_invalidates_changed_directories")
+{
+    TestConfigFileSource source;
+    source.files["root"] = R"({"languageMode":"strict"})";
+
+    ConfigCache cache(source);
+
+    CHECK_EQ(int(Mode::Strict), int(cache.getConfig("root/a/b").mode));
+    CHECK_EQ(int(Mode::Strict), int(cache.getConfig("root/c").mode));
+
+    CHECK(cache.invalidateChanged() == 0);
+
+    // creating a file in a directory drops the directory and everything under it
+    source.files["root/a"] = R"({"languageMode":"nocheck"})";
+    source.versions["root/a"] = 1;
+
+    CHECK(cache.invalidateChanged() == 2);
+    CHECK_EQ(int(Mode::NoCheck), int(cache.getConfig("root/a/b").mode));
+
+    int reads = source.reads;
+    CHECK_EQ(int(Mode::Strict), int(cache.getConfig("root/c").mode));
+    CHECK(source.reads == reads);
+
+    // changes in the root drop all directories
+    source.files["root"] = R"({"languageMode":"nonstrict"})";
+    source.versions["root"] = 1;
+
+    CHECK(cache.invalidateChanged() == 4);
+    CHECK_EQ(int(Mode::Nonstrict), int(cache.getConfig("root/c").mode));
+}
+
+TEST_CASE("config_cache_reports_errors")
+{
+    TestConfigFileSource source;
+    source.files["root/b"] = R"({"languageMode":"invalid"})";
+    source.files["root/a"] = R"({"lint": 1})";
+
+    ConfigCache cache(source);
+    cache.getConfig("root/b/x");
+    cache.getConfig("root/a");
+    cache.getConfig("root/c");
+
+    std::vector<std::pair<std::string, std::string>> errors = cache.getErrors();
+    REQUIRE(errors.size() == 2);
+    CHECK(errors[0].first == "root/a");
+    CHECK(errors[1].first == "root/b");
+
+    source.files.erase("root/b");
+    source.versions["root/b"] = 1;
+
+    cache.invalidateChanged();
+    cache.getConfig("root/b/x");
+    CHECK(cache.getErrors().size() == 1);
+}
+
 TEST_SUITE_END();
@@ -19,6 +19,7 @@
 
 #include <fstream>
 #include <string>
+#include <thread>
 #include <vector>
 #include <math.h>
 
@@ -28,8 +29,17 @@ extern int optimizationLevel;
 
 LUAU_FASTFLAG(LuauTaggedLuData)
 LUAU_FASTFLAG(LuauSciNumberSkipTrailDot)
+LUAU_FASTFLAG(DisableNativeCodegenIfBreakpointIsSet)
+LUAU_FASTFLAG(LuauCompileSuperinstructions)
+LUAU_FASTFLAG(LuauCompileTailCalls)
+LUAU_FASTFLAG(LuauCompileSelectVararg)
+LUAU_FASTFLAG(LuauThreadedDispatch)
 LUAU_DYNAMIC_FASTFLAG(LuauInterruptablePatternMatch)
 LUAU_FASTINT(CodegenHeuristicsInstructionLimit)
+LUAU_FASTINT(CodegenTieredThreshold)
+LUAU_FASTINT(CodegenSpeculationMissLimit)
+LUAU_FASTINT(LuauCodeGenBlockSize)
+LUAU_FASTINT(LuauCodeGenMaxTotalSize)
 LUAU_DYNAMIC_FASTFLAG(LuauCodeGenFixBufferLenCheckA64)
 
 static lua_CompileOptions defaultOptions()
@@ -360,9 +370,334 @@ TEST_CASE("Basic")
     runConformance("basic.lua");
 }
 
+TEST_CASE("Superinstructions")
+{
+    ScopedFastFlag luauCompileSuperinstructions{FFlag::LuauCompileSuperinstructions, true};
+
+    runConformance("basic.lua");
+    runConformance("calls.lua");
+    runConformance("vararg.lua");
+}
+
+TEST_CASE("TailCalls")
+{
+    ScopedFastFlag luauCompileTailCalls{FFlag::LuauCompileTailCalls, true};
+
+    runConformance("tailcall.lua");
+    runConformance("calls.lua");
+    runConformance("vararg.lua");
+    runConformance("coroutine.lua");
+}
+
+TEST_CASE("SelectVararg")
+{
+    ScopedFastFlag luauCompileSelectVararg{FFlag::LuauCompileSelectVararg, true};
+
+    runConformance("vararg.lua");
+}
+
+TEST_CASE("ThreadedDispatch")
+{
+    ScopedFastFlag luauThreadedDispatch{FFlag::LuauThreadedDispatch, true};
+
+    runConformance("basic.lua");
+    runConformance("calls.lua");
+    runConformance("closure.lua");
+    runConformance("coroutine.lua");
+    runConformance("vararg.lua");
+    runConformance("errors.lua");
+}
+
+TEST_CASE("CompressedBytecode")
+{
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
+
+    luaL_openlibs(L);
+
+    std::string source = "local t = {}\n";
+
+    for (int i = 0; i < 50; ++i)
+        source += "t[#t + 1] = string.format('%d: %s', " + std::to_string(i) + ", string.rep('ab', " + std::to_string(i) + "))\n";
+
+    source += "return #t, t[50]\n";
+
+    std::string bytecode = Luau::compile(source);
+    std::string compressed = Luau::BytecodeBuilder::compress(bytecode);
+
+    CHECK(compressed.size() < bytecode.size() / 2);
+
+    REQUIRE(luau_load(L, "=Compressed", compressed.data(), compressed.size(), 0) == 0);
+    REQUIRE(lua_pcall(L, 0, 2, 0) == LUA_OK);
+
+    CHECK(lua_tointeger(L, -2) == 50);
+    std::string expected = "49: ";
+    for (int i = 0; i < 49; ++i)
+        expected += "ab";
+
+    CHECK(std::string(lua_tostring(L, -1)) == expected);
+    lua_pop(L, 2);
+
+    // truncated and nested blobs are rejected
+    CHECK(luau_load(L, "=Truncated", compressed.data(), compressed.size() - 1, 0) == 1);
+    CHECK(std::string(lua_tostring(L, -1)) == "Truncated: malformed compressed bytecode");
+    lua_pop(L, 1);
+
+    std::string nested = Luau::BytecodeBuilder::compress(compressed);
+
+    CHECK(luau_load(L, "=Nested", nested.data(), nested.size(), 0) == 1);
+    CHECK(std::string(lua_tostring(L, -1)) == "Nested: malformed compressed bytecode");
+    lua_pop(L, 1);
+
+    // short inputs are stored as literals
+    std::string small = Luau::compile("return 42");
+    std::string smallCompressed = Luau::BytecodeBuilder::compress(small);
+
+    REQUIRE(luau_load(L, "=Small", smallCompressed.data(), smallCompressed.size(), 0) == 0);
+    REQUIRE(lua_pcall(L, 0, 1, 0) == LUA_OK);
+    CHECK(lua_tointeger(L, -1) == 42);
+    lua_pop(L, 1);
+}
+
+TEST_CASE("LazyLoading")
+{
+    std::string source = "local unused = {}\n";
+
+    for (int i = 0; i < 100; ++i)
+    {
+        std::string n = std::to_string(i);
+        source += "function unused.f" + n + "(a, b)\n  local t = {x = a, y = b, z = " + n + "}\n  for i = 1, a do t.x += math.max(i, b) * " + n +
+                  " end\n  return t.x + t.y * t.z - string.len(tostring(b))\nend\n";
+    }
+
+    source += R"(
+local function counter(base)
+    local n = base
+    return function() n += 1 return n end
+end
+
+local function named(a)
+    local c = counter(a)
+    c()
+    return math.max(c(), 0)
+end
+
+return named(40), debug.info(named, "ln")
+)";
+
+    std::string bytecode = Luau::compile(source, {1, 1});
+
+    auto loadedSize = [&](int (*load)(lua_State*, const char*, const char*, size_t, int)) {
+        StateRef globalState(luaL_newstate(), lua_close);
+        lua_State* L = globalState.get();
+
+        luaL_openlibs(L);
+        luaL_sandbox(L);
+
+        lua_gc(L, LUA_GCCOLLECT, 0);
+        int before = lua_gc(L, LUA_GCCOUNT, 0) * 1024 + lua_gc(L, LUA_GCCOUNTB, 0);
+
+        REQUIRE(load(L, "=LazyLoading", bytecode.data(), bytecode.size(), 0) == 0);
+
+        lua_gc(L, LUA_GCCOLLECT, 0);
+        int after = lua_gc(L, LUA_GCCOUNT, 0) * 1024 + lua_gc(L, LUA_GCCOUNTB, 0);
+
+        REQUIRE(lua_pcall(L, 0, 3, 0) == LUA_OK);
+
+        CHECK(lua_tointeger(L, -3) == 42);
+        CHECK(lua_tointeger(L, -2) == 508);
+        CHECK(std::string(lua_tostring(L, -1)) == "named");
+
+        lua_gc(L, LUA_GCCOLLECT, 0);
+        return after - before;
+    };
+
+    int eager = loadedSize(luau_load);
+    int lazy = loadedSize(luau_loadlazy);
+
+    // unused functions only keep their bytecode and an empty proto
+    CHECK(lazy < eager);
+}
+
+TEST_CASE("LazyDebugInfo")
+{
+    // more functions than the decode cache holds, so that names of earlier functions are released and decoded again
+    std::string source = "local M = {}\n";
+    std::vector<int> lines;
+
+    for (int i = 0; i < 20; ++i)
+    {
+        std::string n = std::to_string(i);
+        source += "function M.f" + n + "(value" + n + ")\n  local local" + n + " = value" + n + " * 2\n";
+
+        for (int j = 0; j < 10; ++j)
+            source += "  local t" + std::to_string(j) + " = {x = local" + n + " + " + std::to_string(j) + "}\n";
+
+        source += "  return inspect(local" + n + ")\nend\n";
+        lines.push_back(14 * i + 14);
+    }
+
+    source += "function M.fail(t)\n  return t.x.y\nend\n";
+    source += "return M\n";
+
+    std::string bytecode = Luau::compile(source, {1, 2});
+
+    auto run = [&](bool lazydebuginfo) {
+        StateRef globalState(luaL_newstate(), lua_close);
+        lua_State* L = globalState.get();
+
+        luaL_openlibs(L);
+
+        // returns names of the first two locals of the caller and the line it's at
+        lua_pushcfunction(
+            L,
+            [](lua_State* L) {
+                lua_Debug ar = {};
+                lua_getinfo(L, 1, "l", &ar);
+
+                const char* param = lua_getlocal(L, 1, 1);
+                const char* local = lua_getlocal(L, 1, 2);
+                lua_pop(L, (param ? 1 : 0) + (local ? 1 : 0));
+
+                lua_pushstring(L, param ? param : "");
+                lua_pushstring(L, local ? local : "");
+                lua_pushinteger(L, ar.currentline);
+                return 3;
+            },
+            "inspect"
+        );
+        lua_setglobal(L, "inspect");
+
+        lua_setlazydebuginfo(L, lazydebuginfo);
+
+        // shared bytecode isn't copied, so keeping debug information encoded doesn't cost any memory
+        REQUIRE(luau_loadshared(L, "=LazyDebugInfo", bytecode.data(), bytecode.size(), 0, [](void*, void*) {}, nullptr) == 0);
+        REQUIRE(lua_pcall(L, 0, 1, 0) == LUA_OK);
+
+        lua_gc(L, LUA_GCCOLLECT, 0);
+        int size = lua_gc(L, LUA_GCCOUNT, 0) * 1024 + lua_gc(L, LUA_GCCOUNTB, 0);
+
+        // functions are inspected twice, so that the second pass decodes information that was released by the first one
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            for (int i = 0; i < 20; ++i)
+            {
+                std::string n = std::to_string(i);
+
+                lua_getfield(L, -1, ("f" + n).c_str());
+                lua_pushinteger(L, i);
+                REQUIRE(lua_pcall(L, 1, 3, 0) == LUA_OK);
+
+                CHECK(std::string(lua_tostring(L, -3)) == "value" + n);
+                CHECK(std::string(lua_tostring(L, -2)) == "local" + n);
+                CHECK(lua_tointeger(L, -1) == lines[i]);
+                lua_pop(L, 3);
+            }
+        }
+
+        lua_getfield(L, -1, "fail");
+        lua_newtable(L);
+        REQUIRE(lua_pcall(L, 1, 0, 0) == LUA_ERRRUN);
+        CHECK(std::string(lua_tostring(L, -1)).find("LazyDebugInfo:283:") != std::string::npos);
+        lua_pop(L, 1);
+
+        // breakpoints decode debug information for good
+        lua_getfield(L, -1, "f0");
+        CHECK(lua_breakpoint(L, -1, 3, true) == 3);
+        lua_pop(L, 1);
+
+        return size;
+    };
+
+    int eager = run(false);
+    int lazy = run(true);
+
+    // line and local variable information isn't kept decoded
+    CHECK(lazy < eager);
+}
+
+TEST_CASE("SharedBytecode")
+{
+    std::string bytecode = Luau::compile(R"(
+local function fib(n) if n < 2 then return n end return fib(n - 1) + fib(n - 2) end
+local function outer() return function() return "inner" end end
+return fib(10), outer
+)");
+
+    int releases = 0;
+    auto release = [](void* ud, void* data) {
+        ++*static_cast<int*>(ud);
+    };
+
+    {
+        StateRef first(luaL_newstate(), lua_close);
+        StateRef second(luaL_newstate(), lua_close);
+
+        for (lua_State* L : {first.get(), second.get()})
+        {
+            luaL_openlibs(L);
+
+            REQUIRE(luau_loadshared(L, "=SharedBytecode", bytecode.data(), bytecode.size(), 0, release, &releases) == 0);
+            REQUIRE(lua_pcall(L, 0, 2, 0) == LUA_OK);
+            CHECK(lua_tointeger(L, -2) == 55);
+
+            lua_gc(L, LUA_GCCOLLECT, 0);
+        }
+
+        // both states keep a function with a nested function that wasn't decoded yet
+        CHECK(releases == 0);
+
+        // once every function is decoded, the state doesn't need the blob anymore
+        lua_State* L = first.get();
+        REQUIRE(lua_pcall(L, 0, 1, 0) == LUA_OK);
+        REQUIRE(lua_pcall(L, 0, 1, 0) == LUA_OK);
+        CHECK(std::string(lua_tostring(L, -1)) == "inner");
+
+        lua_gc(L, LUA_GCCOLLECT, 0);
+        CHECK(releases == 1);
+    }
+
+    CHECK(releases == 2);
+
+    // blob is released right away when the load fails
+    StateRef globalState(luaL_newstate(), lua_close);
+    std::string error = Luau::compile("local =");
+
+    CHECK(luau_loadshared(globalState.get(), "=SharedBytecode", error.data(), error.size(), 0, release, &releases) == 1);
+    CHECK(releases == 3);
+}
+
 TEST_CASE("Buffers")
 {
-    runConformance("buffers.lua");
+    static int released = 0;
+    released = 0;
+
+    runConformance("buffers.lua", [](lua_State* L) {
+        lua_pushcfunction(
+            L,
+            [](lua_State* L) {
+                int size = luaL_checkinteger(L, 1);
+                void* data = calloc(1, size ? size : 1);
+
+                lua_newexternalbuffer(
+                    L,
+                    data,
+                    size,
+                    [](void* ud, void* data) {
+                        free(data);
+                        released++;
+                    },
+                    nullptr
+                );
+                return 1;
+            },
+            "externalbuffer"
+        );
+        lua_setglobal(L, "externalbuffer");
+    });
+
+    // all external buffers are released by the time the state is closed
+    CHECK(released == 4);
 }
 
 TEST_CASE("Math")
@@ -474,1669 +809,4762 @@ TEST_CASE("GC")
     runConformance("gc.lua");
 }
 
-TEST_CASE("Bitwise")
+TEST_CASE("GCGenerational")
 {
-    runConformance("bitwise.lua");
-}
+    auto setup = [](lua_State* L) {
+        CHECK(lua_gc(L, LUA_GCGEN, 0) == 0);
+    };
 
-TEST_CASE("UTF8")
-{
-    runConformance("utf8.lua");
+    runConformance("gc.lua", setup);
+    runConformance("closure.lua", setup);
+    runConformance("coroutine.lua", setup);
 }
 
-TEST_CASE("Coroutine")
+TEST_CASE("GCGenerationalValidate")
 {
-    runConformance("coroutine.lua");
-}
+    extern void luaC_validate(lua_State * L); // internal function, declared in lgc.h - not exposed via lua.h
 
-static int cxxthrow(lua_State* L)
-{
-#if LUA_USE_LONGJMP
-    luaL_error(L, "oops");
-#else
-    throw std::runtime_error("oops");
-#endif
-}
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
 
-TEST_CASE("PCall")
-{
-    runConformance(
-        "pcall.lua",
-        [](lua_State* L) {
-            lua_pushcfunction(L, cxxthrow, "cxxthrow");
-            lua_setglobal(L, "cxxthrow");
+    luaL_openlibs(L);
 
-            lua_pushcfunction(
-                L,
-                [](lua_State* L) -> int {
-                    lua_State* co = lua_tothread(L, 1);
-                    lua_xmove(L, co, 1);
-                    lua_resumeerror(co, L);
-                    return 0;
-                },
-                "resumeerror");
-            lua_setglobal(L, "resumeerror");
-        },
-        nullptr, lua_newstate(limitedRealloc, nullptr));
-}
+    CHECK(lua_gc(L, LUA_GCGEN, 0) == 0);
+    CHECK(lua_gc(L, LUA_GCGEN, 50) == 1);
 
-TEST_CASE("Pack")
-{
-    runConformance("tpack.lua");
-}
+    // validate heap invariants at every GC step boundary; this covers all barriers in minor collections
+    lua_callbacks(L)->interrupt = [](lua_State* L, int gc) {
+        if (gc >= 0)
+            luaC_validate(L);
+    };
 
-TEST_CASE("Vector")
-{
-    runConformance(
-        "vector.lua",
-        [](lua_State* L) {
-            setupVectorHelpers(L);
-        },
-        nullptr, nullptr, nullptr);
+    std::string source = R"(
+        local old = {}
+        for i = 1, 500 do old[i] = { i } end
+
+        local weak = setmetatable({}, { __mode = "k" })
+        local co = coroutine.wrap(function()
+            local up = { 0 }
+            local function f() up[1] += 1 return up[1] end
+            while true do coroutine.yield(f()) end
+        end)
+
+        local last = 0
+        for i = 1, 20000 do
+            local t = { i }
+            old[i % 500 + 1][2] = t
+            weak[t] = i
+            if i % 100 == 0 then
+                local v = co()
+                assert(v == last + 1)
+                last = v
+            end
+        end
+
+        for i = 1, 500 do
+            local t = old[i][2]
+            assert(t[1] % 500 + 1 == i and weak[t] == t[1])
+        end
+
+        for k, v in weak do
+            assert(k[1] == v)
+        end
+
+        return "OK"
+    )";
+
+    size_t bytecodeSize = 0;
+    char* bytecode = luau_compile(source.data(), source.size(), nullptr, &bytecodeSize);
+    int result = luau_load(L, "=GCGenerationalValidate", bytecode, bytecodeSize, 0);
+    free(bytecode);
+
+    REQUIRE(result == 0);
+    REQUIRE(lua_resume(L, nullptr, 0) == LUA_OK);
+    CHECK(strcmp(lua_tostring(L, -1), "OK") == 0);
+    lua_pop(L, 1);
+
+    // explicit steps run minor collections, full collection is always major
+    for (int i = 0; i < 100; ++i)
+        lua_gc(L, LUA_GCSTEP, 8);
+
+    lua_gc(L, LUA_GCCOLLECT, 0);
+
+    CHECK(lua_gc(L, LUA_GCINC, 0) == 1);
+
+    for (int i = 0; i < 100; ++i)
+        lua_gc(L, LUA_GCSTEP, 8);
+
+    lua_gc(L, LUA_GCCOLLECT, 0);
+    luaC_validate(L);
 }
 
-static void populateRTTI(lua_State* L, Luau::TypeId type)
+TEST_CASE("GCReleasePages")
 {
-    if (auto p = Luau::get<Luau::PrimitiveType>(type))
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
+
+    // pages are only freed after the state is done with them, like a helper thread would do
+    static std::vector<void*> pending;
+    pending.clear();
+
+    lua_callbacks(L)->releasepages = [](lua_State* L, void* pages) {
+        pending.push_back(pages);
+    };
+
+    lua_createtable(L, 0, 0);
+
+    for (int i = 0; i < 10000; ++i)
     {
-        switch (p->type)
-        {
-        case Luau::PrimitiveType::Boolean:
-            lua_pushstring(L, "boolean");
-            break;
+        lua_createtable(L, 0, 0);
+        lua_rawseti(L, -2, i + 1);
+    }
 
-        case Luau::PrimitiveType::NilType:
-            lua_pushstring(L, "nil");
-            break;
+    lua_pop(L, 1);
 
-        case Luau::PrimitiveType::Number:
-            lua_pushstring(L, "number");
-            break;
+    size_t before = lua_gc(L, LUA_GCCOUNTB, 0) + lua_gc(L, LUA_GCCOUNT, 0) * 1024;
+    lua_gc(L, LUA_GCCOLLECT, 0);
+    size_t after = lua_gc(L, LUA_GCCOUNTB, 0) + lua_gc(L, LUA_GCCOUNT, 0) * 1024;
 
-        case Luau::PrimitiveType::String:
-            lua_pushstring(L, "string");
-            break;
+    CHECK(after < before);
+    CHECK(!pending.empty());
 
-        case Luau::PrimitiveType::Thread:
-            lua_pushstring(L, "thread");
-            break;
+    void* ud = nullptr;
+    lua_Alloc f = lua_getallocf(L, &ud);
 
-        case Luau::PrimitiveType::Buffer:
-            lua_pushstring(L, "buffer");
-            break;
+    for (void* pages : pending)
+        lua_freepages(f, ud, pages);
 
-        default:
-            LUAU_ASSERT(!"Unknown primitive type");
-        }
-    }
-    else if (auto t = Luau::get<Luau::TableType>(type))
-    {
-        lua_newtable(L);
+    pending.clear();
 
-        for (const auto& [name, prop] : t->props)
-        {
-            populateRTTI(L, prop.type());
-            lua_setfield(L, -2, name.c_str());
-        }
-    }
-    else if (Luau::get<Luau::FunctionType>(type))
-    {
-        lua_pushstring(L, "function");
-    }
-    else if (Luau::get<Luau::AnyType>(type))
-    {
-        lua_pushstring(L, "any");
-    }
-    else if (auto i = Luau::get<Luau::IntersectionType>(type))
+    runConformance("gc.lua", [](lua_State* L) {
+        lua_callbacks(L)->releasepages = [](lua_State* L, void* pages) {
+            void* ud = nullptr;
+            lua_Alloc f = lua_getallocf(L, &ud);
+            lua_freepages(f, ud, pages);
+        };
+    });
+}
+
+TEST_CASE("ApiPageSource")
+{
+    struct Counts
     {
-        for (const auto& part : i->parts)
-            LUAU_ASSERT(Luau::get<Luau::FunctionType>(part));
+        int allocated = 0;
+        int freed = 0;
+    } counts;
+
+    lua_PageSource source = {};
+    source.context = &counts;
+    source.allocpage = [](void* context, size_t size) -> void* {
+        static_cast<Counts*>(context)->allocated++;
+        return malloc(size);
+    };
+    source.freepage = [](void* context, void* page, size_t size) {
+        static_cast<Counts*>(context)->freed++;
+        free(page);
+    };
 
-        lua_pushstring(L, "function");
-    }
-    else
     {
-        LUAU_ASSERT(!"Unknown type");
-    }
-}
+        StateRef globalState(luaL_newstate(), lua_close);
+        lua_State* L = globalState.get();
 
-TEST_CASE("Types")
-{
-    runConformance("types.lua", [](lua_State* L) {
-        Luau::NullModuleResolver moduleResolver;
-        Luau::NullFileResolver fileResolver;
-        Luau::NullConfigResolver configResolver;
-        Luau::Frontend frontend{&fileResolver, &configResolver};
-        Luau::registerBuiltinGlobals(frontend, frontend.globals);
-        Luau::freeze(frontend.globals.globalTypes);
+        lua_setpagesource(L, &source);
 
-        lua_newtable(L);
+        static std::vector<void*> pending;
+        pending.clear();
 
-        for (const auto& [name, binding] : frontend.globals.globalScope->bindings)
+        lua_callbacks(L)->releasepages = [](lua_State* L, void* pages) {
+            pending.push_back(pages);
+        };
+
+        lua_createtable(L, 0, 0);
+
+        for (int i = 0; i < 10000; ++i)
         {
-            populateRTTI(L, binding.typeId);
-            lua_setfield(L, -2, toString(name).c_str());
+            lua_createtable(L, 0, 0);
+            lua_rawseti(L, -2, i + 1);
         }
 
-        lua_setglobal(L, "RTTI");
-    });
-}
-
-TEST_CASE("DateTime")
-{
-    runConformance("datetime.lua");
-}
+        CHECK(counts.allocated > 0);
 
-TEST_CASE("Debug")
-{
-    runConformance("debug.lua");
-}
+        lua_pop(L, 1);
+        lua_gc(L, LUA_GCCOLLECT, 0);
 
-TEST_CASE("Debugger")
-{
-    static int breakhits = 0;
-    static lua_State* interruptedthread = nullptr;
-    static bool singlestep = false;
-    static int stephits = 0;
+        // pages that were allocated before the source was set go back to frealloc
+        void* ud = nullptr;
+        lua_Alloc f = lua_getallocf(L, &ud);
 
-    SUBCASE("")
-    {
-        singlestep = false;
-    }
-    SUBCASE("SingleStep")
-    {
-        singlestep = true;
-    }
+        for (void* pages : pending)
+            lua_freepages(f, ud, pages);
 
-    breakhits = 0;
-    interruptedthread = nullptr;
-    stephits = 0;
+        pending.clear();
 
-    lua_CompileOptions copts = defaultOptions();
-    copts.debugLevel = 2;
+        CHECK(counts.freed > 0);
 
-    runConformance(
-        "debugger.lua",
-        [](lua_State* L) {
-            lua_Callbacks* cb = lua_callbacks(L);
+        lua_setpagesource(L, nullptr);
 
-            lua_singlestep(L, singlestep);
+        int allocated = counts.allocated;
 
-            // this will only be called in single-step mode
-            cb->debugstep = [](lua_State* L, lua_Debug* ar) {
-                stephits++;
-            };
+        for (int i = 0; i < 1000; ++i)
+        {
+            lua_createtable(L, 0, 0);
+            lua_pop(L, 1);
+        }
 
-            // for breakpoints to work we should make sure debugbreak is installed
-            cb->debugbreak = [](lua_State* L, lua_Debug* ar) {
-                breakhits++;
+        CHECK(counts.allocated == allocated);
+    }
 
-                // make sure we can trace the stack for every breakpoint we hit
-                lua_debugtrace(L);
+    CHECK(counts.freed == counts.allocated);
+}
 
-                // for every breakpoint, we break on the first invocation and continue on second
-                // this allows us to easily step off breakpoints
-                // (real implementaiton may require singlestepping)
-                if (breakhits % 2 == 1)
-                    lua_break(L);
-            };
+TEST_CASE("GCSparsePages")
+{
+    // counts live pages to observe which pages new objects are placed into
+    static int livePages = 0;
 
-            // for resuming off a breakpoint inside a coroutine we need to resume the interrupted coroutine
-            cb->debuginterrupt = [](lua_State* L, lua_Debug* ar) {
-                CHECK(interruptedthread == nullptr);
-                CHECK(ar->userdata); // userdata contains the interrupted thread
+    lua_PageSource source = {};
+    source.allocpage = [](void* context, size_t size) -> void* {
+        livePages++;
+        return malloc(size);
+    };
+    source.freepage = [](void* context, void* page, size_t size) {
+        livePages--;
+        free(page);
+    };
 
-                interruptedthread = static_cast<lua_State*>(ar->userdata);
-            };
+    struct Pages
+    {
+        int sparse;
+        int refilled;
+        int released;
+    };
 
-            // add breakpoint() function
-            lua_pushcclosurek(
-                L,
-                [](lua_State* L) -> int {
-                    int line = luaL_checkinteger(L, 1);
-                    bool enabled = luaL_optboolean(L, 2, true);
+    auto run = [&](int threshold) {
+        StateRef globalState(luaL_newstate(), lua_close);
+        lua_State* L = globalState.get();
 
-                    lua_Debug ar = {};
-                    lua_getinfo(L, lua_stackdepth(L) - 1, "f", &ar);
+        lua_setpagesource(L, &source);
+        lua_gc(L, LUA_GCSPARSEPAGE, threshold);
 
-                    lua_breakpoint(L, -1, line, enabled);
-                    return 0;
-                },
-                "breakpoint", 0, nullptr);
-            lua_setglobal(L, "breakpoint");
-        },
-        [](lua_State* L) {
-            CHECK(breakhits % 2 == 1);
+        // keep every 64th table alive to leave sparse pages behind
+        lua_createtable(L, 0, 0);
+        lua_createtable(L, 0, 0);
 
-            lua_checkstack(L, LUA_MINSTACK);
+        for (int i = 0; i < 20000; ++i)
+        {
+            lua_createtable(L, 0, 0);
 
-            if (breakhits == 1)
+            if (i % 64 == 0)
             {
-                // test lua_getargument
-                int a = lua_getargument(L, 0, 1);
-                REQUIRE(a);
-                CHECK(lua_tointeger(L, -1) == 50);
-                lua_pop(L, 1);
+                lua_pushvalue(L, -1);
+                lua_rawseti(L, -4, i / 64 + 1);
+            }
 
-                int v = lua_getargument(L, 0, 2);
-                REQUIRE(v);
-                CHECK(lua_tointeger(L, -1) == 42);
-                lua_pop(L, 1);
+            lua_rawseti(L, -2, i + 1);
+        }
 
-                // test lua_getlocal
-                const char* l = lua_getlocal(L, 0, 1);
-                REQUIRE(l);
-                CHECK(strcmp(l, "b") == 0);
-                CHECK(lua_tointeger(L, -1) == 50);
-                lua_pop(L, 1);
+        lua_pop(L, 1);
+        lua_gc(L, LUA_GCCOLLECT, 0);
 
-                // test lua_getupvalue
-                lua_Debug ar = {};
-                lua_getinfo(L, 0, "f", &ar);
+        Pages pages = {};
+        pages.sparse = livePages;
 
-                const char* u = lua_getupvalue(L, -1, 1);
-                REQUIRE(u);
-                CHECK(strcmp(u, "a") == 0);
-                CHECK(lua_tointeger(L, -1) == 5);
-                lua_pop(L, 2);
-            }
-            else if (breakhits == 3)
-            {
-                // validate assignment via lua_getlocal
-                const char* l = lua_getlocal(L, 0, 1);
-                REQUIRE(l);
-                CHECK(strcmp(l, "a") == 0);
-                CHECK(lua_tointeger(L, -1) == 6);
-                lua_pop(L, 1);
-            }
-            else if (breakhits == 5)
-            {
-                // validate assignment via lua_getlocal
-                const char* l = lua_getlocal(L, 1, 1);
-                REQUIRE(l);
-                CHECK(strcmp(l, "a") == 0);
-                CHECK(lua_tointeger(L, -1) == 7);
-                lua_pop(L, 1);
-            }
-            else if (breakhits == 7)
-            {
-                // validate assignment via lua_getlocal
-                const char* l = lua_getlocal(L, 1, 1);
-                REQUIRE(l);
-                CHECK(strcmp(l, "a") == 0);
-                CHECK(lua_tointeger(L, -1) == 8);
-                lua_pop(L, 1);
-            }
-            else if (breakhits == 9)
-            {
-                // validate assignment via lua_getlocal
-                const char* l = lua_getlocal(L, 1, 1);
-                REQUIRE(l);
-                CHECK(strcmp(l, "a") == 0);
-                CHECK(lua_tointeger(L, -1) == 9);
-                lua_pop(L, 1);
-            }
-            else if (breakhits == 13)
-            {
-                // validate assignment via lua_getlocal
-                const char* l = lua_getlocal(L, 0, 1);
-                REQUIRE(l);
-                CHECK(strcmp(l, "a") == 0);
-                CHECK(lua_isnil(L, -1));
-                lua_pop(L, 1);
-            }
+        // sparse pages are only starved until the next cycle
+        lua_gc(L, LUA_GCSTOP, 0);
 
-            if (interruptedthread)
-            {
-                lua_resume(interruptedthread, nullptr, 0);
-                interruptedthread = nullptr;
-            }
-        },
-        nullptr, &copts, /* skipCodegen */ true); // Native code doesn't support debugging yet
+        lua_createtable(L, 0, 0);
 
-    CHECK(breakhits == 14); // 2 hits per breakpoint
+        for (int i = 0; i < 10000; ++i)
+        {
+            lua_createtable(L, 0, 0);
+            lua_rawseti(L, -2, i + 1);
+        }
 
-    if (singlestep)
-        CHECK(stephits > 100); // note; this will depend on number of instructions which can vary, so we just make sure the callback gets hit often
-}
+        pages.refilled = livePages;
 
-TEST_CASE("NDebugGetUpValue")
-{
-    lua_CompileOptions copts = defaultOptions();
-    copts.debugLevel = 0;
-    // Don't optimize away any upvalues
-    copts.optimizationLevel = 0;
+        // once the remaining old tables die, pages that only held them are released
+        lua_remove(L, -2);
+        lua_gc(L, LUA_GCRESTART, 0);
+        lua_gc(L, LUA_GCCOLLECT, 0);
 
-    runConformance(
-        "ndebug_upvalues.lua", nullptr,
-        [](lua_State* L) {
-            lua_checkstack(L, LUA_MINSTACK);
+        pages.released = livePages;
+        return pages;
+    };
 
-            // push the second frame's closure to the stack
-            lua_Debug ar = {};
-            REQUIRE(lua_getinfo(L, 1, "f", &ar));
+    Pages dense = run(0);
+    CHECK(dense.refilled - dense.sparse < 5);
 
-            // get the first upvalue
-            const char* u = lua_getupvalue(L, -1, 1);
-            REQUIRE(u);
-            // upvalue name is unknown without debug info
-            CHECK(strcmp(u, "") == 0);
-            CHECK(lua_tointeger(L, -1) == 5);
-            lua_pop(L, 2);
-        },
-        nullptr, &copts, /* skipCodegen */ false);
+    Pages sparse = run(50);
+    CHECK(sparse.refilled - sparse.sparse >= 20);
+    CHECK(sparse.refilled - sparse.released >= 40);
+
+    CHECK(livePages == 0);
 }
 
-TEST_CASE("SameHash")
+TEST_CASE("TableFeedback")
 {
-    extern unsigned int luaS_hash(const char* str, size_t len); // internal function, declared in lstring.h - not exposed via lua.h
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
 
-    // To keep VM and compiler separate, we duplicate the hash function definition
-    // This test validates that the hash function in question returns the same results on basic inputs
-    // If this is violated, some code may regress in performance due to hash slot misprediction in inline caches
-    CHECK(luaS_hash("", 0) == Luau::BytecodeBuilder::getStringHash({"", 0}));
-    CHECK(luaS_hash("lua", 3) == Luau::BytecodeBuilder::getStringHash({"lua", 3}));
-    CHECK(luaS_hash("luau", 4) == Luau::BytecodeBuilder::getStringHash({"luau", 4}));
-    CHECK(luaS_hash("luaubytecode", 12) == Luau::BytecodeBuilder::getStringHash({"luaubytecode", 12}));
-    CHECK(luaS_hash("luaubytecodehash", 16) == Luau::BytecodeBuilder::getStringHash({"luaubytecodehash", 16}));
+    if (luau_codegen_supported())
+        luau_codegen_create(L);
 
-    // Also hash should work on unaligned source data even when hashing long strings
-    char buf[128] = {};
-    CHECK(luaS_hash(buf + 1, 120) == luaS_hash(buf + 2, 120));
-}
+    luaL_openlibs(L);
 
-TEST_CASE("Reference")
-{
-    static int dtorhits = 0;
+    lua_pushcfunction(
+        L,
+        [](lua_State* L) -> int
+        {
+            lua_pushnumber(L, double(lua_totalbytes(L, -1)));
+            return 1;
+        },
+        "bytes"
+    );
+    lua_setglobal(L, "bytes");
 
-    dtorhits = 0;
+    // native code only keeps running with a safe environment
+    luaL_sandbox(L);
 
-    StateRef globalState(luaL_newstate(), lua_close);
-    lua_State* L = globalState.get();
+    // tables are observed through their address, which stays valid only while nothing is freed
+    lua_gc(L, LUA_GCSTOP, 0);
 
-    // note, we push two userdata objects but only pin one of them (the first one)
-    lua_newuserdatadtor(L, 0, [](void*) {
-        dtorhits++;
-    });
-    lua_newuserdatadtor(L, 0, [](void*) {
-        dtorhits++;
-    });
+    const char* source = R"(
+        return function(n)
+            local before = bytes()
+            local t = {}
+            local after = bytes()
+            for i = 1, n do t[i] = i end
+            for i = 1, n do t[tostring(i)] = i end
+            return after - before
+        end
+    )";
 
-    lua_gc(L, LUA_GCCOLLECT, 0);
-    CHECK(dtorhits == 0);
+    size_t bytecodeSize = 0;
+    char* bytecode = luau_compile(source, strlen(source), nullptr, &bytecodeSize);
+    REQUIRE(luau_load(L, "=TableFeedback", bytecode, bytecodeSize, 0) == 0);
+    free(bytecode);
 
-    int ref = lua_ref(L, -2);
-    lua_pop(L, 2);
+    REQUIRE(lua_pcall(L, 0, 1, 0) == LUA_OK);
 
-    lua_gc(L, LUA_GCCOLLECT, 0);
-    CHECK(dtorhits == 1);
+    auto build = [&]() {
+        lua_pushvalue(L, -1);
+        lua_pushinteger(L, 100);
+        REQUIRE(lua_pcall(L, 1, 1, 0) == LUA_OK);
+        double bytes = lua_tonumber(L, -1);
+        lua_pop(L, 1);
+        return bytes;
+    };
 
-    lua_getref(L, ref);
-    CHECK(lua_isuserdata(L, -1));
-    lua_pop(L, 1);
+    double empty = build();
+    CHECK(build() == empty);
 
-    lua_gc(L, LUA_GCCOLLECT, 0);
-    CHECK(dtorhits == 1);
+    // the first table created with feedback enabled is observed by the next one
+    lua_settablefeedback(L, 1);
 
-    lua_unref(L, ref);
+    build();
 
-    lua_gc(L, LUA_GCCOLLECT, 0);
-    CHECK(dtorhits == 2);
-}
+    double presized = build();
+    CHECK(presized > empty + 100 * sizeof(double));
+    CHECK(build() == presized);
 
-TEST_CASE("NewUserdataOverflow")
-{
-    StateRef globalState(luaL_newstate(), lua_close);
-    lua_State* L = globalState.get();
+    // native code keeps using the recorded sizes
+    lua_settablefeedback(L, 0);
 
-    lua_pushcfunction(
-        L,
-        [](lua_State* L1) {
-            // The following userdata request might cause an overflow.
-            lua_newuserdatadtor(L1, SIZE_MAX, [](void* d) {});
-            // The overflow might segfault in the following call.
-            lua_getmetatable(L1, -1);
-            return 0;
-        },
-        nullptr);
+    CHECK(build() == empty);
 
-    CHECK(lua_pcall(L, 0, 0, 0) == LUA_ERRRUN);
-    CHECK(strcmp(lua_tostring(L, -1), "memory allocation error: block too big") == 0);
+    if (luau_codegen_supported())
+    {
+        REQUIRE(Luau::CodeGen::compile(L, -1, Luau::CodeGen::CodeGen_ColdFunctions) == Luau::CodeGen::CodeGenCompilationResult::Success);
+
+        CHECK(build() == presized);
+    }
 }
 
-TEST_CASE("SandboxWithoutLibs")
+TEST_CASE("GCBlockMap")
 {
+    extern void luaC_validate(lua_State * L); // internal function, declared in lgc.h - not exposed via lua.h
+
     StateRef globalState(luaL_newstate(), lua_close);
     lua_State* L = globalState.get();
 
-    luaopen_base(L); // Load only base library
-    luaL_sandbox(L);
+    // leave a sparse heap behind: only every 10th table survives
+    lua_createtable(L, 1000, 0);
 
-    CHECK(lua_getreadonly(L, LUA_GLOBALSINDEX));
+    for (int i = 1; i <= 10000; ++i)
+    {
+        lua_createtable(L, 0, 0);
+
+        if (i % 10 == 0)
+            lua_rawseti(L, -2, i / 10);
+        else
+            lua_pop(L, 1);
+    }
+
+    // sweep the heap incrementally, making sure that page walks see exactly the live objects at every step
+    for (int i = 0; i < 2; ++i)
+    {
+        while (lua_gc(L, LUA_GCSTEP, 1) == 0)
+            luaC_validate(L);
+    }
+
+    // allocations reuse the free blocks of sparse pages
+    for (int i = 1; i <= 1000; ++i)
+    {
+        lua_createtable(L, 0, 0);
+        lua_rawseti(L, -2, i);
+        luaC_validate(L);
+    }
+
+    lua_gc(L, LUA_GCCOLLECT, 0);
+    luaC_validate(L);
+
+    CHECK(lua_objlen(L, -1) == 1000);
 }
 
-TEST_CASE("ApiTables")
+TEST_CASE("GCFreeze")
 {
+    extern void luaC_validate(lua_State * L); // internal function, declared in lgc.h - not exposed via lua.h
+
     StateRef globalState(luaL_newstate(), lua_close);
     lua_State* L = globalState.get();
 
-    lua_newtable(L);
-    lua_pushnumber(L, 123.0);
-    lua_setfield(L, -2, "key");
-    lua_pushnumber(L, 456.0);
-    lua_rawsetfield(L, -2, "key2");
-    lua_pushstring(L, "test");
-    lua_rawseti(L, -2, 5);
+    luaL_openlibs(L);
 
-    // lua_gettable
-    lua_pushstring(L, "key");
-    CHECK(lua_gettable(L, -2) == LUA_TNUMBER);
-    CHECK(lua_tonumber(L, -1) == 123.0);
-    lua_pop(L, 1);
+    lua_pushcfunction(L, lua_collectgarbage, "collectgarbage");
+    lua_setglobal(L, "collectgarbage");
 
-    // lua_getfield
-    CHECK(lua_getfield(L, -1, "key") == LUA_TNUMBER);
-    CHECK(lua_tonumber(L, -1) == 123.0);
-    lua_pop(L, 1);
+    auto run = [&](const char* source) {
+        size_t bytecodeSize = 0;
+        char* bytecode = luau_compile(source, strlen(source), nullptr, &bytecodeSize);
+        int result = luau_load(L, "=GCFreeze", bytecode, bytecodeSize, 0);
+        free(bytecode);
 
-    // lua_rawgetfield
-    CHECK(lua_rawgetfield(L, -1, "key2") == LUA_TNUMBER);
-    CHECK(lua_tonumber(L, -1) == 456.0);
-    lua_pop(L, 1);
+        REQUIRE(result == 0);
+        int status = lua_pcall(L, 0, 1, 0);
+        CHECK(std::string(lua_tostring(L, -1)) == "OK");
+        REQUIRE(status == LUA_OK);
+        lua_pop(L, 1);
+    };
 
-    // lua_rawget
-    lua_pushstring(L, "key");
-    CHECK(lua_rawget(L, -2) == LUA_TNUMBER);
-    CHECK(lua_tonumber(L, -1) == 123.0);
-    lua_pop(L, 1);
+    run(R"(
+        frozen = {}
+        for i = 1, 1000 do frozen[i] = { i, tostring(i) } end
 
-    // lua_rawgeti
-    CHECK(lua_rawgeti(L, -1, 5) == LUA_TSTRING);
-    CHECK(strcmp(lua_tostring(L, -1), "test") == 0);
-    lua_pop(L, 1);
+        cache = setmetatable({}, { __mode = "k" })
 
-    // lua_cleartable
-    lua_cleartable(L, -1);
-    lua_pushnil(L);
-    CHECK(lua_next(L, -2) == 0);
+        local count = 0
+        function counter() count += 1 return count end
+
+        return "OK"
+    )");
+
+    // the first bytes of a table are its type and GC marks
+    auto headers = [&]() {
+        std::string result;
+        lua_getglobal(L, "frozen");
+        for (int i = 1; i <= 1000; ++i)
+        {
+            lua_rawgeti(L, -1, i);
+            result.append((const char*)lua_topointer(L, -1), 2);
+            lua_pop(L, 1);
+        }
+        lua_pop(L, 1);
+        return result;
+    };
+
+    // regular collections repaint all survivors
+    std::string before = headers();
+    lua_gc(L, LUA_GCCOLLECT, 0);
+    CHECK(headers() != before);
+
+    CHECK(lua_gc(L, LUA_GCFREEZE, 0) > 0);
+
+    before = headers();
+
+    // validate heap invariants at every GC step boundary, as permanent objects receive new references in all GC states
+    lua_callbacks(L)->interrupt = [](lua_State* L, int gc) {
+        if (gc >= 0)
+            luaC_validate(L);
+    };
+
+    const char* mutate = R"(
+        for i = 1, 20000 do
+            local t = { i }
+            if i % 20 == 0 then frozen[i / 20][3] = t else cache[t] = i end
+            if i % 1000 == 0 then counter() end
+        end
+
+        local kept = {}
+        cache[kept] = 0
+        collectgarbage()
+        collectgarbage()
+
+        for i = 1, 1000 do
+            assert(frozen[i][1] == i and frozen[i][2] == tostring(i) and frozen[i][3][1] == i * 20)
+        end
+
+        local size = 0
+        for k, v in cache do
+            assert(k == kept)
+            size += 1
+        end
+        assert(size == 1)
+
+        cache[kept] = nil
+        return "OK"
+    )";
+
+    run(mutate);
+    lua_gc(L, LUA_GCCOLLECT, 0);
+
+    CHECK(headers() == before);
+
+    CHECK(lua_gc(L, LUA_GCGEN, 0) == 0);
+
+    for (int i = 0; i < 100; ++i)
+        lua_gc(L, LUA_GCSTEP, 8);
 
+    run(mutate);
+    lua_gc(L, LUA_GCCOLLECT, 0);
+
+    CHECK(headers() == before);
+
+    // newer objects can be made permanent later
+    CHECK(lua_gc(L, LUA_GCFREEZE, 0) > 0);
+
+    run(mutate);
+    CHECK(headers() == before);
+
+    lua_getglobal(L, "counter");
+    lua_call(L, 0, 1);
+    CHECK(lua_tointeger(L, -1) == 61);
     lua_pop(L, 1);
+
+    luaC_validate(L);
+
+    // libraries and the global table stay permanent while the conformance tests run
+    auto setup = [](lua_State* L) {
+        CHECK(lua_gc(L, LUA_GCFREEZE, 0) > 0);
+    };
+
+    runConformance("gc.lua", setup);
+    runConformance("closure.lua", setup);
 }
 
-TEST_CASE("ApiIter")
+TEST_CASE("GCStepTime")
 {
     StateRef globalState(luaL_newstate(), lua_close);
     lua_State* L = globalState.get();
 
-    lua_newtable(L);
-    lua_pushnumber(L, 123.0);
-    lua_setfield(L, -2, "key");
-    lua_pushnumber(L, 456.0);
-    lua_rawsetfield(L, -2, "key2");
-    lua_pushstring(L, "test");
-    lua_rawseti(L, -2, 1);
+    lua_createtable(L, 0, 0);
 
-    // Lua-compatible iteration interface: lua_next
-    double sum1 = 0;
-    lua_pushnil(L);
-    while (lua_next(L, -2))
+    for (int i = 0; i < 20000; ++i)
     {
-        sum1 += lua_tonumber(L, -2); // key
-        sum1 += lua_tonumber(L, -1); // value
-        lua_pop(L, 1);               // pop value, key is used by lua_next
+        lua_createtable(L, 1, 0);
+        lua_rawseti(L, -2, i + 1);
     }
-    CHECK(sum1 == 580);
 
-    // Luau iteration interface: lua_rawiter (faster and preferable to lua_next)
-    double sum2 = 0;
-    for (int index = 0; index = lua_rawiter(L, -1, index), index >= 0;)
+    lua_gc(L, LUA_GCCOLLECT, 0);
+
+    // a zero budget still performs a single step and the estimate is based on the full collection above
+    int remaining = lua_gc(L, LUA_GCSTEPTIME, 0);
+    CHECK(remaining > 0);
+
+    int steps = 1;
+
+    while (remaining != 0 && steps < 100000)
     {
-        sum2 += lua_tonumber(L, -2); // key
-        sum2 += lua_tonumber(L, -1); // value
-        lua_pop(L, 2);               // pop both key and value
+        int next = lua_gc(L, LUA_GCSTEPTIME, 0);
+        CHECK(next <= remaining);
+
+        remaining = next;
+        steps++;
     }
-    CHECK(sum2 == 580);
 
-    // pop table
+    CHECK(remaining == 0);
+    CHECK(steps > 1);
+
+    // a large budget finishes the cycle in a single call
+    CHECK(lua_gc(L, LUA_GCSTEPTIME, 10000000) == 0);
+
     lua_pop(L, 1);
 }
 
-TEST_CASE("ApiCalls")
+TEST_CASE("GCAdaptive")
 {
-    StateRef globalState = runConformance("apicalls.lua", nullptr, nullptr, lua_newstate(limitedRealloc, nullptr));
-    lua_State* L = globalState.get();
+    auto setup = [](lua_State* L) {
+        CHECK(lua_gc(L, LUA_GCADAPTIVE, 100) == 0);
+    };
 
-    // lua_call
-    {
-        lua_getfield(L, LUA_GLOBALSINDEX, "add");
-        lua_pushnumber(L, 40);
-        lua_pushnumber(L, 2);
-        lua_call(L, 2, 1);
-        CHECK(lua_isnumber(L, -1));
-        CHECK(lua_tonumber(L, -1) == 42);
-        lua_pop(L, 1);
-    }
+    runConformance("closure.lua", setup);
+    runConformance("coroutine.lua", setup);
 
-    // lua_pcall
-    {
-        lua_getfield(L, LUA_GLOBALSINDEX, "add");
-        lua_pushnumber(L, 40);
-        lua_pushnumber(L, 2);
-        lua_pcall(L, 2, 1, 0);
-        CHECK(lua_isnumber(L, -1));
-        CHECK(lua_tonumber(L, -1) == 42);
-        lua_pop(L, 1);
-    }
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
 
-    // lua_equal with a sleeping thread wake up
-    {
-        lua_State* L2 = lua_newthread(L);
+    luaL_openlibs(L);
 
-        lua_getfield(L2, LUA_GLOBALSINDEX, "create_with_tm");
-        lua_pushnumber(L2, 42);
-        lua_pcall(L2, 1, 1, 0);
+    CHECK(lua_gc(L, LUA_GCSETGOAL, 150) == 200);
+    CHECK(lua_gc(L, LUA_GCADAPTIVE, 500) == 0);
 
-        lua_getfield(L2, LUA_GLOBALSINDEX, "create_with_tm");
-        lua_pushnumber(L2, 42);
-        lua_pcall(L2, 1, 1, 0);
+    const char* source = R"(
+local live = {}
+for i = 1, 20000 do live[i] = { i } end
 
-        // Reset GC
-        lua_gc(L2, LUA_GCCOLLECT, 0);
+for i = 1, 200000 do
+    local garbage = { i, tostring(i) }
+end
+)";
 
-        // Try to mark 'L2' as sleeping
-        // Can't control GC precisely, even in tests
-        lua_gc(L2, LUA_GCSTEP, 8);
+    size_t bytecodeSize = 0;
+    char* bytecode = luau_compile(source, strlen(source), nullptr, &bytecodeSize);
+    REQUIRE(luau_load(L, "=GCAdaptive", bytecode, bytecodeSize, 0) == 0);
+    free(bytecode);
 
-        CHECK(lua_equal(L2, -1, -2) == 1);
-        lua_pop(L2, 2);
-    }
+    lua_call(L, 0, 0);
 
-    // lua_clonefunction + fenv
-    {
-        lua_getfield(L, LUA_GLOBALSINDEX, "getpi");
-        lua_call(L, 0, 1);
-        CHECK(lua_tonumber(L, -1) == 3.1415926);
-        lua_pop(L, 1);
+    // step size is adjusted to the measured cost of GC work and the goal never drops below the configured one
+    int stepsize = lua_gc(L, LUA_GCSETSTEPSIZE, 1);
+    CHECK(stepsize >= 1);
+    CHECK(stepsize <= 1024);
+    CHECK(lua_gc(L, LUA_GCSETSTEPSIZE, stepsize) == 1);
 
-        lua_getfield(L, LUA_GLOBALSINDEX, "getpi");
+    int goal = lua_gc(L, LUA_GCSETGOAL, 150);
+    CHECK(goal >= 150);
+    CHECK(goal <= 1000);
 
-        // clone & override env
-        lua_clonefunction(L, -1);
-        lua_newtable(L);
-        lua_pushnumber(L, 42);
-        lua_setfield(L, -2, "pi");
-        lua_setfenv(L, -2);
+    // disabling adaptive pacing restores the configured goal and step size
+    lua_gc(L, LUA_GCSETGOAL, 250);
+    CHECK(lua_gc(L, LUA_GCADAPTIVE, 0) == 500);
+    CHECK(lua_gc(L, LUA_GCSETGOAL, 200) == 250);
+    CHECK(lua_gc(L, LUA_GCSETSTEPSIZE, 1) == 1);
+}
 
-        lua_call(L, 0, 1);
-        CHECK(lua_tonumber(L, -1) == 42);
-        lua_pop(L, 1);
+TEST_CASE("Bitwise")
+{
+    runConformance("bitwise.lua");
+}
 
-        // this one calls original function again
-        lua_call(L, 0, 1);
-        CHECK(lua_tonumber(L, -1) == 3.1415926);
-        lua_pop(L, 1);
-    }
+TEST_CASE("UTF8")
+{
+    runConformance("utf8.lua");
+}
 
-    // lua_clonefunction + upvalues
-    {
-        lua_getfield(L, LUA_GLOBALSINDEX, "incuv");
-        lua_call(L, 0, 1);
-        CHECK(lua_tonumber(L, -1) == 1);
-        lua_pop(L, 1);
+TEST_CASE("Json")
+{
+    runConformance("json.lua");
+}
 
-        lua_getfield(L, LUA_GLOBALSINDEX, "incuv");
-        // two clones
-        lua_clonefunction(L, -1);
-        lua_clonefunction(L, -2);
+TEST_CASE("Coroutine")
+{
+    runConformance("coroutine.lua");
+}
 
-        lua_call(L, 0, 1);
-        CHECK(lua_tonumber(L, -1) == 2);
-        lua_pop(L, 1);
+static int cxxthrow(lua_State* L)
+{
+#if LUA_USE_LONGJMP
+    luaL_error(L, "oops");
+#else
+    throw std::runtime_error("oops");
+#endif
+}
 
-        lua_call(L, 0, 1);
-        CHECK(lua_tonumber(L, -1) == 3);
-        lua_pop(L, 1);
+TEST_CASE("PCall")
+{
+    runConformance(
+        "pcall.lua",
+        [](lua_State* L) {
+            lua_pushcfunction(L, cxxthrow, "cxxthrow");
+            lua_setglobal(L, "cxxthrow");
 
-        // this one calls original function again
-        lua_call(L, 0, 1);
-        CHECK(lua_tonumber(L, -1) == 4);
-        lua_pop(L, 1);
-    }
+            lua_pushcfunction(
+                L,
+                [](lua_State* L) -> int {
+                    lua_State* co = lua_tothread(L, 1);
+                    lua_xmove(L, co, 1);
+                    lua_resumeerror(co, L);
+                    return 0;
+                },
+                "resumeerror");
+            lua_setglobal(L, "resumeerror");
+        },
+        nullptr, lua_newstate(limitedRealloc, nullptr));
+}
 
-    // lua_pcall on OOM
-    {
-        lua_getfield(L, LUA_GLOBALSINDEX, "largealloc");
-        int res = lua_pcall(L, 0, 0, 0);
-        CHECK(res == LUA_ERRMEM);
-    }
+TEST_CASE("Pack")
+{
+    runConformance("tpack.lua");
+}
 
-    // lua_pcall on OOM with an error handler
-    {
-        lua_getfield(L, LUA_GLOBALSINDEX, "oops");
-        lua_getfield(L, LUA_GLOBALSINDEX, "largealloc");
-        int res = lua_pcall(L, 0, 1, -2);
-        CHECK(res == LUA_ERRMEM);
-        CHECK((lua_isstring(L, -1) && strcmp(lua_tostring(L, -1), "oops") == 0));
-        lua_pop(L, 1);
-    }
+TEST_CASE("Vector")
+{
+    runConformance(
+        "vector.lua",
+        [](lua_State* L) {
+            setupVectorHelpers(L);
+        },
+        nullptr, nullptr, nullptr);
+}
 
-    // lua_pcall on OOM with an error handler that errors
-    {
-        lua_getfield(L, LUA_GLOBALSINDEX, "error");
-        lua_getfield(L, LUA_GLOBALSINDEX, "largealloc");
-        int res = lua_pcall(L, 0, 1, -2);
-        CHECK(res == LUA_ERRERR);
-        CHECK((lua_isstring(L, -1) && strcmp(lua_tostring(L, -1), "error in error handling") == 0));
-        lua_pop(L, 1);
-    }
+static int fastCallHits = 0;
+static int slowCallHits = 0;
 
-    // lua_pcall on OOM with an error handler that OOMs
-    {
-        lua_getfield(L, LUA_GLOBALSINDEX, "largealloc");
-        lua_getfield(L, LUA_GLOBALSINDEX, "largealloc");
-        int res = lua_pcall(L, 0, 1, -2);
-        CHECK(res == LUA_ERRMEM);
-        CHECK((lua_isstring(L, -1) && strcmp(lua_tostring(L, -1), "not enough memory") == 0));
-        lua_pop(L, 1);
-    }
+static int fastadd(const lua_FastValue* args, lua_FastValue* results)
+{
+    fastCallHits++;
+    results[0].n = args[0].n + args[1].n;
+    return 1;
+}
 
-    // lua_pcall on error with an error handler that OOMs
-    {
-        lua_getfield(L, LUA_GLOBALSINDEX, "largealloc");
-        lua_getfield(L, LUA_GLOBALSINDEX, "error");
-        int res = lua_pcall(L, 0, 1, -2);
-        CHECK(res == LUA_ERRERR);
-        CHECK((lua_isstring(L, -1) && strcmp(lua_tostring(L, -1), "error in error handling") == 0));
-        lua_pop(L, 1);
-    }
+static int slowadd(lua_State* L)
+{
+    slowCallHits++;
+    luaL_checkany(L, 2);
+    if (lua_gettop(L) != 2)
+        luaL_error(L, "expected 2 arguments");
+    lua_pushnumber(L, luaL_checknumber(L, 1) + luaL_checknumber(L, 2));
+    return 1;
 }
 
-TEST_CASE("ApiAtoms")
+static int fastsplit(const lua_FastValue* args, lua_FastValue* results)
 {
-    StateRef globalState(luaL_newstate(), lua_close);
-    lua_State* L = globalState.get();
+    fastCallHits++;
+    results[0].n = args[0].n * 2;
+    results[1].b = args[0].n > 0;
+    return 1;
+}
 
-    lua_callbacks(L)->useratom = [](const char* s, size_t l) -> int16_t {
-        if (strcmp(s, "string") == 0)
-            return 0;
-        if (strcmp(s, "important") == 0)
-            return 1;
+static int slowsplit(lua_State* L)
+{
+    slowCallHits++;
+    double n = luaL_checknumber(L, 1);
+    lua_pushnumber(L, n * 2);
+    lua_pushboolean(L, n > 0);
+    return 2;
+}
 
-        return -1;
-    };
+static int fastlen(const lua_FastValue* args, lua_FastValue* results)
+{
+    fastCallHits++;
+    const float* v = args[0].v;
+    results[0].n = sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+    return 1;
+}
 
-    lua_pushstring(L, "string");
-    lua_pushstring(L, "import");
-    lua_pushstring(L, "ant");
-    lua_concat(L, 2);
-    lua_pushstring(L, "unimportant");
+static int slowlen(lua_State* L)
+{
+    slowCallHits++;
+    const float* v = luaL_checkvector(L, 1);
+    lua_pushnumber(L, sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]));
+    return 1;
+}
 
-    int a1, a2, a3;
-    const char* s1 = lua_tostringatom(L, -3, &a1);
-    const char* s2 = lua_tostringatom(L, -2, &a2);
-    const char* s3 = lua_tostringatom(L, -1, &a3);
+static int fastscale(const lua_FastValue* args, lua_FastValue* results)
+{
+    fastCallHits++;
+    for (int i = 0; i < LUA_VECTOR_SIZE; i++)
+        results[0].v[i] = args[0].v[i] * float(args[1].n);
+    return 1;
+}
 
-    CHECK(strcmp(s1, "string") == 0);
-    CHECK(a1 == 0);
+static int slowscale(lua_State* L)
+{
+    slowCallHits++;
+    const float* v = luaL_checkvector(L, 1);
+    float s = float(luaL_checknumber(L, 2));
+#if LUA_VECTOR_SIZE == 4
+    lua_pushvector(L, v[0] * s, v[1] * s, v[2] * s, v[3] * s);
+#else
+    lua_pushvector(L, v[0] * s, v[1] * s, v[2] * s);
+#endif
+    return 1;
+}
 
-    CHECK(strcmp(s2, "important") == 0);
-    CHECK(a2 == 1);
+static int newud(lua_State* L)
+{
+    int* data = (int*)lua_newuserdatatagged(L, sizeof(int), 7);
+    *data = luaL_checkinteger(L, 1);
+    return 1;
+}
 
-    CHECK(strcmp(s3, "unimportant") == 0);
-    CHECK(a3 == -1);
+static int fastudvalue(const lua_FastValue* args, lua_FastValue* results)
+{
+    fastCallHits++;
+    results[0].n = *(int*)args[0].p;
+    return 1;
 }
 
-static bool endsWith(const std::string& str, const std::string& suffix)
+static int slowudvalue(lua_State* L)
 {
-    if (suffix.length() > str.length())
-        return false;
+    slowCallHits++;
+    int* data = (int*)lua_touserdatatagged(L, 1, 7);
+    if (!data)
+        luaL_typeerror(L, 1, "tagged userdata");
+    lua_pushinteger(L, *data);
+    return 1;
+}
 
-    return suffix == std::string_view(str.c_str() + str.length() - suffix.length(), suffix.length());
+static int fastchecked(const lua_FastValue* args, lua_FastValue* results)
+{
+    if (args[0].n < 0)
+        return 0;
+
+    fastCallHits++;
+    results[0].n = sqrt(args[0].n);
+    return 1;
 }
 
-TEST_CASE("ApiType")
+static int slowchecked(lua_State* L)
 {
-    StateRef globalState(luaL_newstate(), lua_close);
-    lua_State* L = globalState.get();
+    slowCallHits++;
+    double n = luaL_checknumber(L, 1);
+    if (n < 0)
+        luaL_error(L, "negative argument");
+    lua_pushnumber(L, sqrt(n));
+    return 1;
+}
 
-    lua_pushnumber(L, 2);
-    CHECK(strcmp(luaL_typename(L, -1), "number") == 0);
-    CHECK(strcmp(luaL_typename(L, 1), "number") == 0);
-    CHECK(lua_type(L, -1) == LUA_TNUMBER);
-    CHECK(lua_type(L, 1) == LUA_TNUMBER);
+TEST_CASE("FastCFunctions")
+{
+    fastCallHits = 0;
+    slowCallHits = 0;
 
-    CHECK(strcmp(luaL_typename(L, 2), "no value") == 0);
-    CHECK(lua_type(L, 2) == LUA_TNONE);
-    CHECK(strcmp(lua_typename(L, lua_type(L, 2)), "no value") == 0);
+    runConformance(
+        "fastcall.lua",
+        [](lua_State* L) {
+            setupVectorHelpers(L);
 
-    lua_newuserdata(L, 0);
-    CHECK(strcmp(luaL_typename(L, -1), "userdata") == 0);
-    CHECK(lua_type(L, -1) == LUA_TUSERDATA);
+            static const lua_FastCall addSig = {fastadd, 2, 1, {LUA_FASTNUMBER, LUA_FASTNUMBER}, {LUA_FASTNUMBER}};
+            static const lua_FastCall splitSig = {fastsplit, 1, 2, {LUA_FASTNUMBER}, {LUA_FASTNUMBER, LUA_FASTBOOLEAN}};
+            static const lua_FastCall lenSig = {fastlen, 1, 1, {LUA_FASTVECTOR}, {LUA_FASTNUMBER}};
+            static const lua_FastCall scaleSig = {fastscale, 2, 1, {LUA_FASTVECTOR, LUA_FASTNUMBER}, {LUA_FASTVECTOR}};
+            static const lua_FastCall udvalueSig = {fastudvalue, 1, 1, {LUA_FASTUSERDATA}, {LUA_FASTNUMBER}, {7}};
+            static const lua_FastCall checkedSig = {fastchecked, 1, 1, {LUA_FASTNUMBER}, {LUA_FASTNUMBER}};
+
+            lua_pushfastcfunction(L, slowadd, "add", &addSig);
+            lua_setglobal(L, "add");
+            lua_pushfastcfunction(L, slowsplit, "split", &splitSig);
+            lua_setglobal(L, "split");
+            lua_pushfastcfunction(L, slowlen, "len", &lenSig);
+            lua_setglobal(L, "len");
+            lua_pushfastcfunction(L, slowscale, "scale", &scaleSig);
+            lua_setglobal(L, "scale");
+            lua_pushfastcfunction(L, slowudvalue, "udvalue", &udvalueSig);
+            lua_setglobal(L, "udvalue");
+            lua_pushfastcfunction(L, slowchecked, "checked", &checkedSig);
+            lua_setglobal(L, "checked");
+
+            lua_pushcfunction(L, newud, "newud");
+            lua_setglobal(L, "newud");
+        },
+        nullptr, nullptr, nullptr);
 
-    lua_newtable(L);
-    lua_pushstring(L, "hello");
-    lua_setfield(L, -2, "__type");
-    lua_setmetatable(L, -2);
+    // 100 additions in the loop and 9 matching calls after it
+    CHECK(fastCallHits == 109);
+    // mismatched arguments, declined calls and calls that don't go through the call instruction
+    CHECK(slowCallHits == 6);
+}
 
-    CHECK(strcmp(luaL_typename(L, -1), "hello") == 0);
-    CHECK(lua_type(L, -1) == LUA_TUSERDATA);
+static int fastclamp(const lua_FastValue* args, lua_FastValue* results)
+{
+    fastCallHits++;
+    results[0].n = args[0].n < args[1].n ? args[1].n : args[0].n > args[2].n ? args[2].n : args[0].n;
+    return 1;
 }
 
-TEST_CASE("ApiBuffer")
+static int slowclamp(lua_State* L)
 {
-    StateRef globalState(luaL_newstate(), lua_close);
-    lua_State* L = globalState.get();
+    slowCallHits++;
+    double v = luaL_checknumber(L, 1);
+    double lo = luaL_checknumber(L, 2);
+    double hi = luaL_checknumber(L, 3);
+    lua_pushnumber(L, v < lo ? lo : v > hi ? hi : v);
+    return 1;
+}
 
-    lua_newbuffer(L, 1000);
+static int fastlerp(const lua_FastValue* args, lua_FastValue* results)
+{
+    fastCallHits++;
+    results[0].n = args[0].n + (args[1].n - args[0].n) * args[2].n;
+    return 1;
+}
 
-    REQUIRE(lua_type(L, -1) == LUA_TBUFFER);
+static int slowlerp(lua_State* L)
+{
+    slowCallHits++;
+    float t = float(luaL_checknumber(L, 3));
+    const float* a = luaL_checkvector(L, 1);
+    const float* b = luaL_checkvector(L, 2);
+#if LUA_VECTOR_SIZE == 4
+    lua_pushvector(L, a[0] + (b[0] - a[0]) * t, a[1] + (b[1] - a[1]) * t, a[2] + (b[2] - a[2]) * t, a[3] + (b[3] - a[3]) * t);
+#else
+    lua_pushvector(L, a[0] + (b[0] - a[0]) * t, a[1] + (b[1] - a[1]) * t, a[2] + (b[2] - a[2]) * t);
+#endif
+    return 1;
+}
 
-    CHECK(lua_isbuffer(L, -1));
-    CHECK(lua_objlen(L, -1) == 1000);
+static int fastminmax(const lua_FastValue* args, lua_FastValue* results)
+{
+    fastCallHits++;
+    results[0].n = args[0].n < args[1].n ? args[0].n : args[1].n;
+    results[1].n = args[0].n < args[1].n ? args[1].n : args[0].n;
+    return 1;
+}
 
-    CHECK(strcmp(lua_typename(L, LUA_TBUFFER), "buffer") == 0);
+static int slowunregistered(lua_State* L)
+{
+    slowCallHits++;
+    lua_settop(L, 1);
+    return 1;
+}
 
-    CHECK(strcmp(luaL_typename(L, -1), "buffer") == 0);
+TEST_CASE("UserBuiltins")
+{
+    fastCallHits = 0;
+    slowCallHits = 0;
 
-    void* p1 = lua_tobuffer(L, -1, nullptr);
+    const char* userBuiltins[] = {"clamp", "Engine.lerp", "Engine.minmax", "unregistered", NULL};
 
-    size_t len = 0;
-    void* p2 = lua_tobuffer(L, -1, &len);
-    CHECK(len == 1000);
-    CHECK(p1 == p2);
+    lua_CompileOptions copts = defaultOptions();
+    copts.userBuiltins = userBuiltins;
 
-    void* p3 = luaL_checkbuffer(L, -1, nullptr);
-    CHECK(p1 == p3);
+    runConformance(
+        "userbuiltins.lua",
+        [](lua_State* L) {
+            setupVectorHelpers(L);
 
-    len = 0;
-    void* p4 = luaL_checkbuffer(L, -1, &len);
-    CHECK(len == 1000);
-    CHECK(p1 == p4);
+            static const lua_FastCall clampSig = {fastclamp, 3, 1, {LUA_FASTNUMBER, LUA_FASTNUMBER, LUA_FASTNUMBER}, {LUA_FASTNUMBER}};
+            static const lua_FastCall lerpSig = {fastlerp, 3, 1, {LUA_FASTNUMBER, LUA_FASTNUMBER, LUA_FASTNUMBER}, {LUA_FASTNUMBER}};
+            static const lua_FastCall minmaxSig = {fastminmax, 2, 2, {LUA_FASTNUMBER, LUA_FASTNUMBER}, {LUA_FASTNUMBER, LUA_FASTNUMBER}};
 
-    memset(p1, 0xab, 1000);
+            lua_setuserbuiltin(L, 0, &clampSig);
+            lua_setuserbuiltin(L, 1, &lerpSig);
+            lua_setuserbuiltin(L, 2, &minmaxSig);
 
-    CHECK(lua_topointer(L, -1) != nullptr);
+            lua_pushcfunction(L, slowclamp, "clamp");
+            lua_setglobal(L, "clamp");
 
-    lua_newbuffer(L, 0);
+            lua_newtable(L);
+            lua_pushcfunction(L, slowlerp, "lerp");
+            lua_setfield(L, -2, "lerp");
+            lua_pushcfunction(L, slowunregistered, "minmax");
+            lua_setfield(L, -2, "minmax");
+            lua_setglobal(L, "Engine");
 
-    lua_pushvalue(L, -2);
+            lua_pushcfunction(L, slowunregistered, "unregistered");
+            lua_setglobal(L, "unregistered");
+        },
+        nullptr, nullptr, &copts);
 
-    CHECK(lua_equal(L, -3, -1));
-    CHECK(!lua_equal(L, -2, -1));
-
-    lua_pop(L, 1);
+    // 100 clamps in the loop, one number lerp and three minmax calls
+    CHECK(fastCallHits == 104);
+    // vector lerp, mismatched clamp arguments and the builtin without an implementation
+    CHECK(slowCallHits == 4);
 }
 
-TEST_CASE("AllocApi")
+struct FieldEntity
 {
-    int ud = 0;
-    StateRef globalState(lua_newstate(limitedRealloc, &ud), lua_close);
-    lua_State* L = globalState.get();
+    double health;
+    float speed;
+    int level;
+    float pos[LUA_VECTOR_SIZE];
+    int id;
+    unsigned char alive;
+};
 
-    void* udCheck = nullptr;
-    bool allocfIsSet = lua_getallocf(L, &udCheck) == limitedRealloc;
-    CHECK(allocfIsSet);
-    CHECK(udCheck == &ud);
+static const int kFieldEntityTag = 12;
+
+static int fieldentityindex(lua_State* L)
+{
+    lua_pushfstring(L, "index:%s", luaL_tolstring(L, 2, nullptr));
+    return 1;
 }
 
-#if !LUA_USE_LONGJMP
-TEST_CASE("ExceptionObject")
+static void pushfieldentity(lua_State* L, size_t size)
 {
-    struct ExceptionResult
+    FieldEntity* e = (FieldEntity*)lua_newuserdatatagged(L, size, kFieldEntityTag);
+    memset(e, 0, size);
+    e->health = 100;
+
+    if (size == sizeof(FieldEntity))
     {
-        bool exceptionGenerated;
-        std::string description;
-    };
+        e->id = 7;
+        e->alive = 1;
+    }
 
-    auto captureException = [](lua_State* L, const char* functionToRun) {
-        try
-        {
-            lua_State* threadState = lua_newthread(L);
-            lua_getfield(threadState, LUA_GLOBALSINDEX, functionToRun);
-            CHECK(lua_isLfunction(threadState, -1));
-            lua_call(threadState, 0, 0);
-        }
-        catch (std::exception& e)
-        {
-            CHECK(e.what() != nullptr);
-            return ExceptionResult{true, e.what()};
-        }
-        return ExceptionResult{false, ""};
-    };
+    luaL_getmetatable(L, "FieldEntity");
+    lua_setmetatable(L, -2);
+}
 
-    StateRef globalState = runConformance("exceptions.lua", nullptr, nullptr, lua_newstate(limitedRealloc, nullptr));
-    lua_State* L = globalState.get();
+TEST_CASE("UserdataFields")
+{
+    runConformance("udatafields.lua", [](lua_State* L) {
+        setupVectorHelpers(L);
 
-    {
-        ExceptionResult result = captureException(L, "infinite_recursion_error");
-        CHECK(result.exceptionGenerated);
-    }
+        static const lua_UserdataField fields[] = {
+            {"health", LUA_UDFIELD_NUMBER, offsetof(FieldEntity, health)},
+            {"speed", LUA_UDFIELD_FLOAT, offsetof(FieldEntity, speed)},
+            {"level", LUA_UDFIELD_INTEGER, offsetof(FieldEntity, level)},
+            {"pos", LUA_UDFIELD_VECTOR, offsetof(FieldEntity, pos)},
+            {"id", LUA_UDFIELD_INTEGER, offsetof(FieldEntity, id), 1},
+            {"alive", LUA_UDFIELD_BOOLEAN, offsetof(FieldEntity, alive)},
+        };
 
-    {
-        ExceptionResult result = captureException(L, "empty_function");
-        CHECK_FALSE(result.exceptionGenerated);
-    }
+        lua_setuserdatafields(L, kFieldEntityTag, fields, int(std::size(fields)));
+
+        luaL_newmetatable(L, "FieldEntity");
+        lua_pushcfunction(L, fieldentityindex, "__index");
+        lua_setfield(L, -2, "__index");
+        lua_pop(L, 1);
+
+        lua_pushcfunction(
+            L,
+            [](lua_State* L) {
+                pushfieldentity(L, sizeof(FieldEntity));
+                return 1;
+            },
+            "newentity");
+        lua_setglobal(L, "newentity");
+
+        lua_pushcfunction(
+            L,
+            [](lua_State* L) {
+                pushfieldentity(L, sizeof(double));
+                return 1;
+            },
+            "newsmall");
+        lua_setglobal(L, "newsmall");
+    });
+}
 
+static void populateRTTI(lua_State* L, Luau::TypeId type)
+{
+    if (auto p = Luau::get<Luau::PrimitiveType>(type))
     {
-        ExceptionResult result = captureException(L, "pass_number_to_error");
-        CHECK(result.exceptionGenerated);
-        CHECK(endsWith(result.description, "42"));
+        switch (p->type)
+        {
+        case Luau::PrimitiveType::Boolean:
+            lua_pushstring(L, "boolean");
+            break;
+
+        case Luau::PrimitiveType::NilType:
+            lua_pushstring(L, "nil");
+            break;
+
+        case Luau::PrimitiveType::Number:
+            lua_pushstring(L, "number");
+            break;
+
+        case Luau::PrimitiveType::String:
+            lua_pushstring(L, "string");
+            break;
+
+        case Luau::PrimitiveType::Thread:
+            lua_pushstring(L, "thread");
+            break;
+
+        case Luau::PrimitiveType::Buffer:
+            lua_pushstring(L, "buffer");
+            break;
+
+        default:
+            LUAU_ASSERT(!"Unknown primitive type");
+        }
     }
+    else if (auto t = Luau::get<Luau::TableType>(type))
+    {
+        lua_newtable(L);
 
+        for (const auto& [name, prop] : t->props)
+        {
+            populateRTTI(L, prop.type());
+            lua_setfield(L, -2, name.c_str());
+        }
+    }
+    else if (Luau::get<Luau::FunctionType>(type))
     {
-        ExceptionResult result = captureException(L, "pass_string_to_error");
-        CHECK(result.exceptionGenerated);
-        CHECK(endsWith(result.description, "string argument"));
+        lua_pushstring(L, "function");
     }
-
+    else if (Luau::get<Luau::AnyType>(type))
     {
-        ExceptionResult result = captureException(L, "pass_table_to_error");
-        CHECK(result.exceptionGenerated);
+        lua_pushstring(L, "any");
     }
+    else if (auto i = Luau::get<Luau::IntersectionType>(type))
+    {
+        for (const auto& part : i->parts)
+            LUAU_ASSERT(Luau::get<Luau::FunctionType>(part));
 
+        lua_pushstring(L, "function");
+    }
+    else
     {
-        ExceptionResult result = captureException(L, "large_allocation_error");
-        CHECK(result.exceptionGenerated);
+        LUAU_ASSERT(!"Unknown type");
     }
 }
-#endif
 
-TEST_CASE("IfElseExpression")
+TEST_CASE("Types")
 {
-    runConformance("ifelseexpr.lua");
+    runConformance("types.lua", [](lua_State* L) {
+        Luau::NullModuleResolver moduleResolver;
+        Luau::NullFileResolver fileResolver;
+        Luau::NullConfigResolver configResolver;
+        Luau::Frontend frontend{&fileResolver, &configResolver};
+        Luau::registerBuiltinGlobals(frontend, frontend.globals);
+        Luau::freeze(frontend.globals.globalTypes);
+
+        lua_newtable(L);
+
+        for (const auto& [name, binding] : frontend.globals.globalScope->bindings)
+        {
+            populateRTTI(L, binding.typeId);
+            lua_setfield(L, -2, toString(name).c_str());
+        }
+
+        lua_setglobal(L, "RTTI");
+    });
 }
 
-// Optionally returns debug info for the first Luau stack frame that is encountered on the callstack.
-static std::optional<lua_Debug> getFirstLuauFrameDebugInfo(lua_State* L)
+TEST_CASE("DateTime")
 {
-    static std::string_view kLua = "Lua";
-    lua_Debug ar;
-    for (int i = 0; lua_getinfo(L, i, "sl", &ar); i++)
-    {
-        if (kLua == ar.what)
-            return ar;
-    }
-    return std::nullopt;
+    runConformance("datetime.lua");
 }
 
-TEST_CASE("TagMethodError")
+TEST_CASE("Debug")
 {
-    static std::vector<int> expectedHits;
-
-    // Loop over two modes:
-    //   when doLuaBreak is false the test only verifies that callbacks occur on the expected lines in the Luau source
-    //   when doLuaBreak is true the test additionally calls lua_break to ensure breaking the debugger doesn't cause the VM to crash
-    for (bool doLuaBreak : {false, true})
-    {
-        expectedHits = {22, 32};
-
-        static int index;
-        static bool luaBreak;
-        index = 0;
-        luaBreak = doLuaBreak;
-
-        // 'yieldCallback' doesn't do anything, but providing the callback to runConformance
-        // ensures that the call to lua_break doesn't cause an error to be generated because
-        // runConformance doesn't expect the VM to be in the state LUA_BREAK.
-        auto yieldCallback = [](lua_State* L) {};
-
-        runConformance(
-            "tmerror.lua",
-            [](lua_State* L) {
-                auto* cb = lua_callbacks(L);
+    runConformance("debug.lua");
+}
 
-                cb->debugprotectederror = [](lua_State* L) {
-                    std::optional<lua_Debug> ar = getFirstLuauFrameDebugInfo(L);
+TEST_CASE("Debugger")
+{
+    static int breakhits = 0;
+    static lua_State* interruptedthread = nullptr;
+    static bool singlestep = false;
+    static int stephits = 0;
+    bool threaded = false;
 
-                    CHECK(lua_isyieldable(L));
-                    REQUIRE(ar.has_value());
-                    REQUIRE(index < int(std::size(expectedHits)));
-                    CHECK(ar->currentline == expectedHits[index++]);
+    SUBCASE("")
+    {
+        singlestep = false;
+    }
+    SUBCASE("SingleStep")
+    {
+        singlestep = true;
+    }
+    SUBCASE("ThreadedDispatch")
+    {
+        singlestep = false;
+        threaded = true;
+    }
 
-                    if (luaBreak)
-                    {
-                        // Cause luau execution to break when 'error' is called via 'pcall'
-                        // This call to lua_break is a regression test for an issue where debugprotectederror
-                        // was called on a thread that couldn't be yielded even though lua_isyieldable was true.
-                        lua_break(L);
-                    }
-                };
-            },
-            yieldCallback);
+    ScopedFastFlag luauThreadedDispatch{FFlag::LuauThreadedDispatch, threaded};
 
-        // Make sure the number of break points hit was the expected number
-        CHECK(index == std::size(expectedHits));
-    }
-}
+    breakhits = 0;
+    interruptedthread = nullptr;
+    stephits = 0;
 
-TEST_CASE("Coverage")
-{
     lua_CompileOptions copts = defaultOptions();
-    copts.optimizationLevel = 1; // disable inlining to get fixed expected hit results
-    copts.coverageLevel = 2;
+    copts.debugLevel = 2;
 
     runConformance(
-        "coverage.lua",
+        "debugger.lua",
         [](lua_State* L) {
-            lua_pushcfunction(
-                L,
-                [](lua_State* L) -> int {
-                    luaL_argexpected(L, lua_isLfunction(L, 1), 1, "function");
+            lua_Callbacks* cb = lua_callbacks(L);
 
-                    lua_newtable(L);
-                    lua_getcoverage(L, 1, L, [](void* context, const char* function, int linedefined, int depth, const int* hits, size_t size) {
-                        lua_State* L = static_cast<lua_State*>(context);
+            lua_singlestep(L, singlestep);
 
-                        lua_newtable(L);
+            // this will only be called in single-step mode
+            cb->debugstep = [](lua_State* L, lua_Debug* ar) {
+                stephits++;
+            };
 
-                        lua_pushstring(L, function);
-                        lua_setfield(L, -2, "name");
+            // for breakpoints to work we should make sure debugbreak is installed
+            cb->debugbreak = [](lua_State* L, lua_Debug* ar) {
+                breakhits++;
 
-                        lua_pushinteger(L, linedefined);
-                        lua_setfield(L, -2, "linedefined");
+                // make sure we can trace the stack for every breakpoint we hit
+                lua_debugtrace(L);
 
-                        lua_pushinteger(L, depth);
-                        lua_setfield(L, -2, "depth");
+                // for every breakpoint, we break on the first invocation and continue on second
+                // this allows us to easily step off breakpoints
+                // (real implementaiton may require singlestepping)
+                if (breakhits % 2 == 1)
+                    lua_break(L);
+            };
 
-                        for (size_t i = 0; i < size; ++i)
-                            if (hits[i] != -1)
-                            {
-                                lua_pushinteger(L, hits[i]);
-                                lua_rawseti(L, -2, int(i));
-                            }
+            // for resuming off a breakpoint inside a coroutine we need to resume the interrupted coroutine
+            cb->debuginterrupt = [](lua_State* L, lua_Debug* ar) {
+                CHECK(interruptedthread == nullptr);
+                CHECK(ar->userdata); // userdata contains the interrupted thread
 
-                        lua_rawseti(L, -2, lua_objlen(L, -2) + 1);
-                    });
+                interruptedthread = static_cast<lua_State*>(ar->userdata);
+            };
 
-                    return 1;
+            // add breakpoint() function
+            lua_pushcclosurek(
+                L,
+                [](lua_State* L) -> int {
+                    int line = luaL_checkinteger(L, 1);
+                    bool enabled = luaL_optboolean(L, 2, true);
+
+                    lua_Debug ar = {};
+                    lua_getinfo(L, lua_stackdepth(L) - 1, "f", &ar);
+
+                    lua_breakpoint(L, -1, line, enabled);
+                    return 0;
                 },
-                "getcoverage");
-            lua_setglobal(L, "getcoverage");
+                "breakpoint", 0, nullptr);
+            lua_setglobal(L, "breakpoint");
         },
-        nullptr, nullptr, &copts);
+        [](lua_State* L) {
+            CHECK(breakhits % 2 == 1);
+
+            lua_checkstack(L, LUA_MINSTACK);
+
+            if (breakhits == 1)
+            {
+                // test lua_getargument
+                int a = lua_getargument(L, 0, 1);
+                REQUIRE(a);
+                CHECK(lua_tointeger(L, -1) == 50);
+                lua_pop(L, 1);
+
+                int v = lua_getargument(L, 0, 2);
+                REQUIRE(v);
+                CHECK(lua_tointeger(L, -1) == 42);
+                lua_pop(L, 1);
+
+                // test lua_getlocal
+                const char* l = lua_getlocal(L, 0, 1);
+                REQUIRE(l);
+                CHECK(strcmp(l, "b") == 0);
+                CHECK(lua_tointeger(L, -1) == 50);
+                lua_pop(L, 1);
+
+                // test lua_getupvalue
+                lua_Debug ar = {};
+                lua_getinfo(L, 0, "f", &ar);
+
+                const char* u = lua_getupvalue(L, -1, 1);
+                REQUIRE(u);
+                CHECK(strcmp(u, "a") == 0);
+                CHECK(lua_tointeger(L, -1) == 5);
+                lua_pop(L, 2);
+            }
+            else if (breakhits == 3)
+            {
+                // validate assignment via lua_getlocal
+                const char* l = lua_getlocal(L, 0, 1);
+                REQUIRE(l);
+                CHECK(strcmp(l, "a") == 0);
+                CHECK(lua_tointeger(L, -1) == 6);
+                lua_pop(L, 1);
+            }
+            else if (breakhits == 5)
+            {
+                // validate assignment via lua_getlocal
+                const char* l = lua_getlocal(L, 1, 1);
+                REQUIRE(l);
+                CHECK(strcmp(l, "a") == 0);
+                CHECK(lua_tointeger(L, -1) == 7);
+                lua_pop(L, 1);
+            }
+            else if (breakhits == 7)
+            {
+                // validate assignment via lua_getlocal
+                const char* l = lua_getlocal(L, 1, 1);
+                REQUIRE(l);
+                CHECK(strcmp(l, "a") == 0);
+                CHECK(lua_tointeger(L, -1) == 8);
+                lua_pop(L, 1);
+            }
+            else if (breakhits == 9)
+            {
+                // validate assignment via lua_getlocal
+                const char* l = lua_getlocal(L, 1, 1);
+                REQUIRE(l);
+                CHECK(strcmp(l, "a") == 0);
+                CHECK(lua_tointeger(L, -1) == 9);
+                lua_pop(L, 1);
+            }
+            else if (breakhits == 13)
+            {
+                // validate assignment via lua_getlocal
+                const char* l = lua_getlocal(L, 0, 1);
+                REQUIRE(l);
+                CHECK(strcmp(l, "a") == 0);
+                CHECK(lua_isnil(L, -1));
+                lua_pop(L, 1);
+            }
+
+            if (interruptedthread)
+            {
+                lua_resume(interruptedthread, nullptr, 0);
+                interruptedthread = nullptr;
+            }
+        },
+        nullptr, &copts, /* skipCodegen */ true); // Native code doesn't support debugging yet
+
+    CHECK(breakhits == 14); // 2 hits per breakpoint
+
+    if (singlestep)
+        CHECK(stephits > 100); // note; this will depend on number of instructions which can vary, so we just make sure the callback gets hit often
 }
 
-TEST_CASE("StringConversion")
+TEST_CASE("NDebugGetUpValue")
 {
-    ScopedFastFlag luauSciNumberSkipTrailDot{FFlag::LuauSciNumberSkipTrailDot, true};
+    lua_CompileOptions copts = defaultOptions();
+    copts.debugLevel = 0;
+    // Don't optimize away any upvalues
+    copts.optimizationLevel = 0;
 
-    runConformance("strconv.lua");
+    runConformance(
+        "ndebug_upvalues.lua", nullptr,
+        [](lua_State* L) {
+            lua_checkstack(L, LUA_MINSTACK);
+
+            // push the second frame's closure to the stack
+            lua_Debug ar = {};
+            REQUIRE(lua_getinfo(L, 1, "f", &ar));
+
+            // get the first upvalue
+            const char* u = lua_getupvalue(L, -1, 1);
+            REQUIRE(u);
+            // upvalue name is unknown without debug info
+            CHECK(strcmp(u, "") == 0);
+            CHECK(lua_tointeger(L, -1) == 5);
+            lua_pop(L, 2);
+        },
+        nullptr, &copts, /* skipCodegen */ false);
+}
+
+TEST_CASE("SameHash")
+{
+    extern unsigned int luaS_hash(const char* str, size_t len); // internal function, declared in lstring.h - not exposed via lua.h
+
+    // To keep VM and compiler separate, we duplicate the hash function definition
+    // This test validates that the hash function in question returns the same results on basic inputs
+    // If this is violated, some code may regress in performance due to hash slot misprediction in inline caches
+    CHECK(luaS_hash("", 0) == Luau::BytecodeBuilder::getStringHash({"", 0}));
+    CHECK(luaS_hash("lua", 3) == Luau::BytecodeBuilder::getStringHash({"lua", 3}));
+    CHECK(luaS_hash("luau", 4) == Luau::BytecodeBuilder::getStringHash({"luau", 4}));
+    CHECK(luaS_hash("luaubytecode", 12) == Luau::BytecodeBuilder::getStringHash({"luaubytecode", 12}));
+    CHECK(luaS_hash("luaubytecodehash", 16) == Luau::BytecodeBuilder::getStringHash({"luaubytecodehash", 16}));
+
+    // Also hash should work on unaligned source data even when hashing long strings
+    char buf[128] = {};
+    CHECK(luaS_hash(buf + 1, 120) == luaS_hash(buf + 2, 120));
+
+    // Long strings that differ in a single byte, including the word-wise hashed prefix, should not collide
+    char long1[100] = {};
+    char long2[100] = {};
+    for (int i = 0; i < 100; ++i)
+    {
+        long2[i] = 1;
+        CHECK(luaS_hash(long1, 100) != luaS_hash(long2, 100));
+        long2[i] = 0;
+    }
+}
+
+TEST_CASE("Reference")
+{
+    static int dtorhits = 0;
+
+    dtorhits = 0;
+
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
+
+    // note, we push two userdata objects but only pin one of them (the first one)
+    lua_newuserdatadtor(L, 0, [](void*) {
+        dtorhits++;
+    });
+    lua_newuserdatadtor(L, 0, [](void*) {
+        dtorhits++;
+    });
+
+    lua_gc(L, LUA_GCCOLLECT, 0);
+    CHECK(dtorhits == 0);
+
+    int ref = lua_ref(L, -2);
+    lua_pop(L, 2);
+
+    lua_gc(L, LUA_GCCOLLECT, 0);
+    CHECK(dtorhits == 1);
+
+    lua_getref(L, ref);
+    CHECK(lua_isuserdata(L, -1));
+    lua_pop(L, 1);
+
+    lua_gc(L, LUA_GCCOLLECT, 0);
+    CHECK(dtorhits == 1);
+
+    lua_unref(L, ref);
+
+    lua_gc(L, LUA_GCCOLLECT, 0);
+    CHECK(dtorhits == 2);
+}
+
+TEST_CASE("ReferenceSlots")
+{
+    // by default, references are stored in the registry
+    {
+        StateRef globalState(luaL_newstate(), lua_close);
+        lua_State* L = globalState.get();
+
+        lua_pushnumber(L, 42);
+        int ref = lua_ref(L, -1);
+        lua_pop(L, 1);
+
+        CHECK(lua_rawgeti(L, LUA_REGISTRYINDEX, ref) == LUA_TNUMBER);
+        CHECK(lua_getref(L, ref) == LUA_TNUMBER);
+        CHECK(lua_tonumber(L, -1) == 42);
+        lua_pop(L, 2);
+
+        lua_unref(L, ref);
+
+        lua_pushboolean(L, true);
+        CHECK(lua_ref(L, -1) == ref);
+        lua_pop(L, 1);
+    }
+
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
+
+    lua_setrefslots(L, 1);
+
+    lua_pushnil(L);
+    CHECK(lua_ref(L, -1) == LUA_REFNIL);
+    lua_pop(L, 1);
+
+    CHECK(lua_getref(L, LUA_REFNIL) == LUA_TNIL);
+    CHECK(lua_getref(L, LUA_NOREF) == LUA_TNIL);
+    lua_pop(L, 2);
+
+    // references are kept outside of the registry and released slots are reused
+    lua_pushnumber(L, 42);
+    int ref = lua_ref(L, -1);
+    lua_pop(L, 1);
+
+    CHECK(lua_rawgeti(L, LUA_REGISTRYINDEX, ref) == LUA_TNIL);
+    lua_pop(L, 1);
+
+    lua_unref(L, ref);
+
+    lua_pushboolean(L, true);
+    CHECK(lua_ref(L, -1) == ref);
+    CHECK(lua_getref(L, ref) == LUA_TBOOLEAN);
+    lua_pop(L, 2);
+
+    // values referenced while the collector is running have to survive the cycle
+    std::vector<int> refs;
+
+    for (int i = 0; i < 10000; i++)
+    {
+        lua_createtable(L, 1, 0);
+        lua_pushinteger(L, i);
+        lua_rawseti(L, -2, 1);
+
+        refs.push_back(lua_ref(L, -1));
+        lua_pop(L, 1);
+
+        if (refs.size() > 100)
+        {
+            lua_unref(L, refs[refs.size() - 101]);
+            refs[refs.size() - 101] = LUA_NOREF;
+        }
+
+        lua_gc(L, LUA_GCSTEP, 0);
+    }
+
+    lua_gc(L, LUA_GCCOLLECT, 0);
+
+    for (int i = 9900; i < 10000; i++)
+    {
+        REQUIRE(lua_getref(L, refs[i]) == LUA_TTABLE);
+        lua_rawgeti(L, -1, 1);
+        CHECK(lua_tointeger(L, -1) == i);
+        lua_pop(L, 2);
+    }
+}
+
+TEST_CASE("NewUserdataOverflow")
+{
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
+
+    lua_pushcfunction(
+        L,
+        [](lua_State* L1) {
+            // The following userdata request might cause an overflow.
+            lua_newuserdatadtor(L1, SIZE_MAX, [](void* d) {});
+            // The overflow might segfault in the following call.
+            lua_getmetatable(L1, -1);
+            return 0;
+        },
+        nullptr);
+
+    CHECK(lua_pcall(L, 0, 0, 0) == LUA_ERRRUN);
+    CHECK(strcmp(lua_tostring(L, -1), "memory allocation error: block too big") == 0);
+}
+
+TEST_CASE("SandboxWithoutLibs")
+{
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
+
+    luaopen_base(L); // Load only base library
+    luaL_sandbox(L);
+
+    CHECK(lua_getreadonly(L, LUA_GLOBALSINDEX));
+}
+
+TEST_CASE("ApiTables")
+{
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
+
+    lua_newtable(L);
+    lua_pushnumber(L, 123.0);
+    lua_setfield(L, -2, "key");
+    lua_pushnumber(L, 456.0);
+    lua_rawsetfield(L, -2, "key2");
+    lua_pushstring(L, "test");
+    lua_rawseti(L, -2, 5);
+
+    // lua_gettable
+    lua_pushstring(L, "key");
+    CHECK(lua_gettable(L, -2) == LUA_TNUMBER);
+    CHECK(lua_tonumber(L, -1) == 123.0);
+    lua_pop(L, 1);
+
+    // lua_getfield
+    CHECK(lua_getfield(L, -1, "key") == LUA_TNUMBER);
+    CHECK(lua_tonumber(L, -1) == 123.0);
+    lua_pop(L, 1);
+
+    // lua_rawgetfield
+    CHECK(lua_rawgetfield(L, -1, "key2") == LUA_TNUMBER);
+    CHECK(lua_tonumber(L, -1) == 456.0);
+    lua_pop(L, 1);
+
+    // lua_rawget
+    lua_pushstring(L, "key");
+    CHECK(lua_rawget(L, -2) == LUA_TNUMBER);
+    CHECK(lua_tonumber(L, -1) == 123.0);
+    lua_pop(L, 1);
+
+    // lua_rawgeti
+    CHECK(lua_rawgeti(L, -1, 5) == LUA_TSTRING);
+    CHECK(strcmp(lua_tostring(L, -1), "test") == 0);
+    lua_pop(L, 1);
+
+    // lua_cleartable
+    lua_cleartable(L, -1);
+    lua_pushnil(L);
+    CHECK(lua_next(L, -2) == 0);
+
+    // lua_reservetable
+    lua_reservetable(L, -1, 100, 16);
+
+    int before = lua_gc(L, LUA_GCCOUNT, 0) * 1024 + lua_gc(L, LUA_GCCOUNTB, 0);
+
+    for (int i = 1; i <= 100; ++i)
+    {
+        lua_pushinteger(L, i);
+        lua_rawseti(L, -2, i);
+    }
+
+    for (int i = 1; i <= 16; ++i)
+    {
+        lua_pushinteger(L, i);
+        lua_rawseti(L, -2, 1000 + i);
+    }
+
+    // reserved parts are filled without reallocation
+    CHECK(lua_gc(L, LUA_GCCOUNT, 0) * 1024 + lua_gc(L, LUA_GCCOUNTB, 0) == before);
+    CHECK(lua_objlen(L, -1) == 100);
+
+    lua_pop(L, 1);
+
+    // bulk setters
+    lua_createtable(L, 0, 0);
+
+    const double numbers[] = {1.5, 2.5, 3.5};
+    lua_rawsetnumbers(L, -1, 1, numbers, 3);
+
+    const char* strings[] = {"a", "bc", "d\0e"};
+    const size_t lens[] = {1, 2, 3};
+    lua_rawsetstrings(L, -1, 4, strings, lens, 3);
+    lua_rawsetstrings(L, -1, 7, strings, NULL, 2);
+
+    lua_pushboolean(L, true);
+    lua_newtable(L);
+    lua_pushnil(L);
+    lua_rawsetvalues(L, -4, 9, 3);
+
+    CHECK(lua_gettop(L) == 1);
+    CHECK(lua_objlen(L, -1) == 10);
+
+    CHECK(lua_rawgeti(L, -1, 3) == LUA_TNUMBER);
+    CHECK(lua_tonumber(L, -1) == 3.5);
+    lua_pop(L, 1);
+
+    size_t len = 0;
+    CHECK(lua_rawgeti(L, -1, 6) == LUA_TSTRING);
+    CHECK(memcmp(lua_tolstring(L, -1, &len), "d\0e", 3) == 0);
+    CHECK(len == 3);
+    lua_pop(L, 1);
+
+    CHECK(lua_rawgeti(L, -1, 8) == LUA_TSTRING);
+    CHECK(strcmp(lua_tostring(L, -1), "bc") == 0);
+    lua_pop(L, 1);
+
+    CHECK(lua_rawgeti(L, -1, 9) == LUA_TBOOLEAN);
+    CHECK(lua_rawgeti(L, -2, 10) == LUA_TTABLE);
+    CHECK(lua_rawgeti(L, -3, 11) == LUA_TNIL);
+    lua_pop(L, 3);
+
+    // ranges that don't continue the array part are stored in the hash part
+    lua_rawsetnumbers(L, -1, 1000, numbers, 3);
+    CHECK(lua_rawgeti(L, -1, 1002) == LUA_TNUMBER);
+    CHECK(lua_tonumber(L, -1) == 3.5);
+    lua_pop(L, 1);
+    CHECK(lua_objlen(L, -1) == 10);
+
+    lua_pushstring(L, "x");
+    lua_pushnumber(L, 1);
+    lua_pushstring(L, "y");
+    lua_pushstring(L, "z");
+    lua_pushnumber(L, 2);
+    lua_pushnil(L);
+    lua_rawsetpairs(L, -7, 3);
+
+    CHECK(lua_gettop(L) == 1);
+    CHECK(lua_rawgetfield(L, -1, "x") == LUA_TNUMBER);
+    CHECK(lua_rawgetfield(L, -2, "y") == LUA_TSTRING);
+    CHECK(lua_rawgeti(L, -3, 2) == LUA_TNIL);
+    lua_pop(L, 3);
+
+    lua_pop(L, 1);
+
+    // batch getters
+    lua_newtable(L);
+    lua_pushnumber(L, 1.0);
+    lua_rawsetfield(L, -2, "x");
+    lua_pushnumber(L, 2.0);
+    lua_rawsetfield(L, -2, "y");
+    lua_pushstring(L, "z");
+    lua_rawsetfield(L, -2, "name");
+    lua_pushboolean(L, true);
+    lua_rawseti(L, -2, 1);
+
+    const char* keynames[] = {"x", "y", "name", "missing"};
+    lua_newtable(L);
+    lua_rawsetstrings(L, -1, 1, keynames, NULL, 4);
+    lua_pushnumber(L, 1);
+    lua_rawseti(L, -2, 5);
+
+    lua_rawgetfields(L, -2, -1, 5);
+    CHECK(lua_gettop(L) == 7);
+    CHECK(lua_tonumber(L, -5) == 1.0);
+    CHECK(lua_tonumber(L, -4) == 2.0);
+    CHECK(strcmp(lua_tostring(L, -3), "z") == 0);
+    CHECK(lua_isnil(L, -2));
+    CHECK(lua_toboolean(L, -1));
+    lua_pop(L, 5);
+
+    double fields[] = {-1.0, -1.0, -1.0, -1.0};
+    CHECK(lua_rawgetnumberfields(L, -2, -1, fields, 4) == 2);
+    CHECK(fields[0] == 1.0);
+    CHECK(fields[1] == 2.0);
+    CHECK(fields[2] == -1.0);
+    CHECK(fields[3] == -1.0);
+
+    lua_pop(L, 2);
+}
+
+TEST_CASE("ApiKeyHandles")
+{
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
+
+    lua_KeyHandle key = lua_newkeyhandle(L, "key", 3);
+    lua_KeyHandle other = lua_newkeyhandle(L, "other", 5);
+
+    // handles are interned like any other string
+    CHECK(lua_newkeyhandle(L, "key", 3) == key);
+
+    lua_newtable(L);
+    lua_pushnumber(L, 1.0);
+    lua_setfieldh(L, -2, key);
+    lua_pushnumber(L, 2.0);
+    lua_rawsetfieldh(L, -2, other);
+
+    CHECK(lua_getfield(L, -1, "key") == LUA_TNUMBER);
+    CHECK(lua_tonumber(L, -1) == 1.0);
+    lua_pop(L, 1);
+
+    CHECK(lua_getfieldh(L, -1, other) == LUA_TNUMBER);
+    CHECK(lua_tonumber(L, -1) == 2.0);
+    lua_pop(L, 1);
+
+    CHECK(lua_rawgetfieldh(L, -1, key) == LUA_TNUMBER);
+    CHECK(lua_tonumber(L, -1) == 1.0);
+    lua_pop(L, 1);
+
+    lua_pushstringh(L, key);
+    lua_pushstring(L, "key");
+    CHECK(lua_tostring(L, -1) == lua_tostring(L, -2));
+    lua_pop(L, 3);
+
+    // handles survive full collections while no other reference exists
+    lua_gc(L, LUA_GCCOLLECT, 0);
+
+    lua_pushstringh(L, other);
+    CHECK(strcmp(lua_tostring(L, -1), "other") == 0);
+    lua_pop(L, 1);
+}
+
+TEST_CASE("ApiIter")
+{
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
+
+    lua_newtable(L);
+    lua_pushnumber(L, 123.0);
+    lua_setfield(L, -2, "key");
+    lua_pushnumber(L, 456.0);
+    lua_rawsetfield(L, -2, "key2");
+    lua_pushstring(L, "test");
+    lua_rawseti(L, -2, 1);
+
+    // Lua-compatible iteration interface: lua_next
+    double sum1 = 0;
+    lua_pushnil(L);
+    while (lua_next(L, -2))
+    {
+        sum1 += lua_tonumber(L, -2); // key
+        sum1 += lua_tonumber(L, -1); // value
+        lua_pop(L, 1);               // pop value, key is used by lua_next
+    }
+    CHECK(sum1 == 580);
+
+    // Luau iteration interface: lua_rawiter (faster and preferable to lua_next)
+    double sum2 = 0;
+    for (int index = 0; index = lua_rawiter(L, -1, index), index >= 0;)
+    {
+        sum2 += lua_tonumber(L, -2); // key
+        sum2 += lua_tonumber(L, -1); // value
+        lua_pop(L, 2);               // pop both key and value
+    }
+    CHECK(sum2 == 580);
+
+    // pop table
+    lua_pop(L, 1);
+}
+
+TEST_CASE("ApiCalls")
+{
+    StateRef globalState = runConformance("apicalls.lua", nullptr, nullptr, lua_newstate(limitedRealloc, nullptr));
+    lua_State* L = globalState.get();
+
+    // lua_call
+    {
+        lua_getfield(L, LUA_GLOBALSINDEX, "add");
+        lua_pushnumber(L, 40);
+        lua_pushnumber(L, 2);
+        lua_call(L, 2, 1);
+        CHECK(lua_isnumber(L, -1));
+        CHECK(lua_tonumber(L, -1) == 42);
+        lua_pop(L, 1);
+    }
+
+    // lua_pcall
+    {
+        lua_getfield(L, LUA_GLOBALSINDEX, "add");
+        lua_pushnumber(L, 40);
+        lua_pushnumber(L, 2);
+        lua_pcall(L, 2, 1, 0);
+        CHECK(lua_isnumber(L, -1));
+        CHECK(lua_tonumber(L, -1) == 42);
+        lua_pop(L, 1);
+    }
+
+    // lua_equal with a sleeping thread wake up
+    {
+        lua_State* L2 = lua_newthread(L);
+
+        lua_getfield(L2, LUA_GLOBALSINDEX, "create_with_tm");
+        lua_pushnumber(L2, 42);
+        lua_pcall(L2, 1, 1, 0);
+
+        lua_getfield(L2, LUA_GLOBALSINDEX, "create_with_tm");
+        lua_pushnumber(L2, 42);
+        lua_pcall(L2, 1, 1, 0);
+
+        // Reset GC
+        lua_gc(L2, LUA_GCCOLLECT, 0);
+
+        // Try to mark 'L2' as sleeping
+        // Can't control GC precisely, even in tests
+        lua_gc(L2, LUA_GCSTEP, 8);
+
+        CHECK(lua_equal(L2, -1, -2) == 1);
+        lua_pop(L2, 2);
+    }
+
+    // lua_clonefunction + fenv
+    {
+        lua_getfield(L, LUA_GLOBALSINDEX, "getpi");
+        lua_call(L, 0, 1);
+        CHECK(lua_tonumber(L, -1) == 3.1415926);
+        lua_pop(L, 1);
+
+        lua_getfield(L, LUA_GLOBALSINDEX, "getpi");
+
+        // clone & override env
+        lua_clonefunction(L, -1);
+        lua_newtable(L);
+        lua_pushnumber(L, 42);
+        lua_setfield(L, -2, "pi");
+        lua_setfenv(L, -2);
+
+        lua_call(L, 0, 1);
+        CHECK(lua_tonumber(L, -1) == 42);
+        lua_pop(L, 1);
+
+        // this one calls original function again
+        lua_call(L, 0, 1);
+        CHECK(lua_tonumber(L, -1) == 3.1415926);
+        lua_pop(L, 1);
+    }
+
+    // lua_clonefunction + upvalues
+    {
+        lua_getfield(L, LUA_GLOBALSINDEX, "incuv");
+        lua_call(L, 0, 1);
+        CHECK(lua_tonumber(L, -1) == 1);
+        lua_pop(L, 1);
+
+        lua_getfield(L, LUA_GLOBALSINDEX, "incuv");
+        // two clones
+        lua_clonefunction(L, -1);
+        lua_clonefunction(L, -2);
+
+        lua_call(L, 0, 1);
+        CHECK(lua_tonumber(L, -1) == 2);
+        lua_pop(L, 1);
+
+        lua_call(L, 0, 1);
+        CHECK(lua_tonumber(L, -1) == 3);
+        lua_pop(L, 1);
+
+        // this one calls original function again
+        lua_call(L, 0, 1);
+        CHECK(lua_tonumber(L, -1) == 4);
+        lua_pop(L, 1);
+    }
+
+    // lua_pcall on OOM
+    {
+        lua_getfield(L, LUA_GLOBALSINDEX, "largealloc");
+        int res = lua_pcall(L, 0, 0, 0);
+        CHECK(res == LUA_ERRMEM);
+    }
+
+    // lua_pcall on OOM with an error handler
+    {
+        lua_getfield(L, LUA_GLOBALSINDEX, "oops");
+        lua_getfield(L, LUA_GLOBALSINDEX, "largealloc");
+        int res = lua_pcall(L, 0, 1, -2);
+        CHECK(res == LUA_ERRMEM);
+        CHECK((lua_isstring(L, -1) && strcmp(lua_tostring(L, -1), "oops") == 0));
+        lua_pop(L, 1);
+    }
+
+    // lua_pcall on OOM with an error handler that errors
+    {
+        lua_getfield(L, LUA_GLOBALSINDEX, "error");
+        lua_getfield(L, LUA_GLOBALSINDEX, "largealloc");
+        int res = lua_pcall(L, 0, 1, -2);
+        CHECK(res == LUA_ERRERR);
+        CHECK((lua_isstring(L, -1) && strcmp(lua_tostring(L, -1), "error in error handling") == 0));
+        lua_pop(L, 1);
+    }
+
+    // lua_pcall on OOM with an error handler that OOMs
+    {
+        lua_getfield(L, LUA_GLOBALSINDEX, "largealloc");
+        lua_getfield(L, LUA_GLOBALSINDEX, "largealloc");
+        int res = lua_pcall(L, 0, 1, -2);
+        CHECK(res == LUA_ERRMEM);
+        CHECK((lua_isstring(L, -1) && strcmp(lua_tostring(L, -1), "not enough memory") == 0));
+        lua_pop(L, 1);
+    }
+
+    // lua_pcall on error with an error handler that OOMs
+    {
+        lua_getfield(L, LUA_GLOBALSINDEX, "largealloc");
+        lua_getfield(L, LUA_GLOBALSINDEX, "error");
+        int res = lua_pcall(L, 0, 1, -2);
+        CHECK(res == LUA_ERRERR);
+        CHECK((lua_isstring(L, -1) && strcmp(lua_tostring(L, -1), "error in error handling") == 0));
+        lua_pop(L, 1);
+    }
+}
+
+TEST_CASE("ApiThreadPool")
+{
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
+
+    luaL_openlibs(L);
+
+    // the pool is disabled by default
+    lua_State* T = lua_acquirethread(L);
+    CHECK(lua_releasethread(L, T) == 0);
+    lua_pop(L, 1);
+
+    lua_setthreadpool(L, 2, 1000);
+
+    T = lua_acquirethread(L);
+    CHECK(lua_checkstack(T, 500));
+    lua_pushnumber(T, 42);
+    CHECK(lua_releasethread(L, T) == 1);
+    CHECK(lua_isthreadreset(T));
+    CHECK(lua_gettop(T) == 0);
+    lua_pop(L, 1);
+
+    // pooled threads are kept alive by the pool
+    lua_gc(L, LUA_GCCOLLECT, 0);
+
+    size_t hits = 0, misses = 0;
+    CHECK(lua_threadpoolstats(L, &hits, &misses) == 1);
+    CHECK(hits == 0);
+    CHECK(misses == 2);
+
+    lua_State* T2 = lua_acquirethread(L);
+    CHECK(T2 == T);
+
+    lua_getglobal(T2, "tostring");
+    lua_pushnumber(T2, 42);
+    lua_call(T2, 1, 1);
+    CHECK(strcmp(lua_tostring(T2, -1), "42") == 0);
+    lua_pop(L, 1);
+
+    CHECK(lua_threadpoolstats(L, &hits, &misses) == 0);
+    CHECK(hits == 1);
+    CHECK(misses == 2);
+}
+
+TEST_CASE("ApiStackPolicy")
+{
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
+
+    lua_State* T = lua_newthread(L);
+    int before = lua_gc(L, LUA_GCCOUNTB, 0) + lua_gc(L, LUA_GCCOUNT, 0) * 1024;
+
+    // reserved stack is allocated immediately
+    lua_setstackpolicy(T, 10000, 4);
+    int reserved = lua_gc(L, LUA_GCCOUNTB, 0) + lua_gc(L, LUA_GCCOUNT, 0) * 1024;
+    CHECK(reserved - before >= 100'000);
+
+    // and it isn't released when the collector shrinks the stack of an idle thread
+    lua_gc(L, LUA_GCCOLLECT, 0);
+    int collected = lua_gc(L, LUA_GCCOUNTB, 0) + lua_gc(L, LUA_GCCOUNT, 0) * 1024;
+    CHECK(collected - before >= 100'000);
+
+    CHECK(lua_checkstack(T, 5000));
+    lua_pop(L, 1);
+}
+
+TEST_CASE("ApiOpcodeCounters")
+{
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
+
+    const char* source = R"(
+local function sum(n)
+    local s = 0
+    for i = 1, n do
+        s += i
+    end
+    return s
+end
+
+return sum(100)
+)";
+
+    size_t bytecodeSize = 0;
+    char* bytecode = luau_compile(source, strlen(source), nullptr, &bytecodeSize);
+    REQUIRE(luau_load(L, "=ApiOpcodeCounters", bytecode, bytecodeSize, 0) == 0);
+    free(bytecode);
+
+    CHECK(lua_getopcodecount(L, LOP_ADD) == 0);
+
+    lua_setopcodecounters(L, 1);
+
+    lua_pushvalue(L, -1);
+    lua_call(L, 0, 1);
+    CHECK(lua_tonumber(L, -1) == 5050);
+    lua_pop(L, 1);
+
+    CHECK(lua_getopcodecount(L, LOP_ADD) == 100);
+    CHECK(lua_getopcodecount(L, LOP_FORNLOOP) == 100);
+    CHECK(lua_getopcodecount(L, LOP_CALL) == 1);
+
+    std::vector<std::pair<std::string, uint64_t>> functions;
+
+    lua_getopcodecounts(L, -1, &functions, [](void* context, const char* function, int linedefined, int depth, uint64_t count) {
+        static_cast<std::vector<std::pair<std::string, uint64_t>>*>(context)->push_back({function ? function : "", count});
+    });
+
+    REQUIRE(functions.size() == 2);
+    CHECK(functions[0].first == "");
+    CHECK(functions[1].first == "sum");
+    CHECK(functions[1].second > 200);
+
+    uint64_t total = 0;
+    for (int op = 0; op < LUA_OPCODECOUNT; op++)
+        total += lua_getopcodecount(L, op);
+
+    CHECK(total == functions[0].second + functions[1].second);
+
+    // counters are discarded when disabled
+    lua_setopcodecounters(L, 0);
+    CHECK(lua_getopcodecount(L, LOP_ADD) == 0);
+}
+
+TEST_CASE("ApiMemcatLimits")
+{
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
+
+    luaL_openlibs(L);
+
+    static int softLimitCalls = 0;
+    softLimitCalls = 0;
+
+    lua_callbacks(L)->memcatlimit = [](lua_State* L, int category, size_t size) {
+        CHECK(category == 1);
+        CHECK(size > 64 * 1024);
+        softLimitCalls++;
+    };
+
+    lua_setmemcatlimit(L, 1, 64 * 1024, 256 * 1024);
+
+    const char* source = R"(
+local t = {}
+for i = 1, 100000 do
+    t[i] = tostring(i) .. "x"
+end
+keep = t
+)";
+
+    size_t bytecodeSize = 0;
+    char* bytecode = luau_compile(source, strlen(source), nullptr, &bytecodeSize);
+    REQUIRE(luau_load(L, "=ApiMemcatLimits", bytecode, bytecodeSize, 0) == 0);
+    free(bytecode);
+
+    // objects created while the category is active are charged to it and allocations stop at the hard limit
+    lua_setmemcat(L, 1);
+    lua_pushvalue(L, -1);
+    CHECK(lua_pcall(L, 0, 0, 0) == LUA_ERRMEM);
+    lua_pop(L, 1);
+    lua_setmemcat(L, 0);
+
+    CHECK(softLimitCalls == 1);
+    CHECK(lua_totalbytes(L, 1) <= 256 * 1024);
+    CHECK(lua_totalbytes(L, 1) > 64 * 1024);
+
+    lua_gc(L, LUA_GCCOLLECT, 0);
+    CHECK(lua_memcatlivebytes(L, 1) == 0);
+
+    // without the limit, the table is created and stays reachable
+    lua_setmemcatlimit(L, 1, 0, 0);
+
+    lua_setmemcat(L, 1);
+    lua_pushvalue(L, -1);
+    REQUIRE(lua_pcall(L, 0, 0, 0) == LUA_OK);
+    lua_setmemcat(L, 0);
+
+    lua_gc(L, LUA_GCCOLLECT, 0);
+
+    size_t live = lua_memcatlivebytes(L, 1);
+    CHECK(live > 1024 * 1024);
+    CHECK(live <= lua_totalbytes(L, 1));
+    CHECK(lua_memcatlivebytes(L, 2) == 0);
+
+    lua_pushnil(L);
+    lua_setglobal(L, "keep");
+
+    lua_gc(L, LUA_GCCOLLECT, 0);
+    CHECK(lua_memcatlivebytes(L, 1) == 0);
+    CHECK(lua_totalbytes(L, 1) == 0);
+}
+
+TEST_CASE("ApiGcStepCallback")
+{
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
+
+    luaL_openlibs(L);
+
+    static int steps = 0;
+    static int assists = 0;
+    static int cycles = 0;
+    static double total = 0.0;
+    steps = 0;
+    assists = 0;
+    cycles = 0;
+    total = 0.0;
+
+    lua_callbacks(L)->gcstep = [](lua_State* L, int gcstate, double time, int assist) {
+        CHECK(time >= 0.0);
+        steps++;
+        assists += assist;
+        cycles += gcstate == 0;
+        total += time;
+    };
+
+    const char* source = R"(
+for i = 1, 100000 do
+    local t = {i, tostring(i)}
+end
+)";
+
+    size_t bytecodeSize = 0;
+    char* bytecode = luau_compile(source, strlen(source), nullptr, &bytecodeSize);
+    REQUIRE(luau_load(L, "=ApiGcStepCallback", bytecode, bytecodeSize, 0) == 0);
+    free(bytecode);
+
+    REQUIRE(lua_pcall(L, 0, 0, 0) == LUA_OK);
+
+    // allocations drive the collector, so every step is an assist and several cycles complete
+    CHECK(steps > 0);
+    CHECK(assists == steps);
+    CHECK(cycles > 1);
+    CHECK(total > 0.0);
+
+    // explicit steps are reported as well
+    int lastSteps = steps;
+    lua_gc(L, LUA_GCSTEP, 0);
+    CHECK(steps > lastSteps);
+    CHECK(assists < steps);
+}
+
+TEST_CASE("ApiProfiler")
+{
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
+
+    const char* source = R"(
+local function inner(n)
+    local s = 0
+    for i = 1, n do
+        s += i
+    end
+    return s
+end
+
+local function outer(n)
+    return inner(n)
+end
+
+return outer(100)
+)";
+
+    size_t bytecodeSize = 0;
+    char* bytecode = luau_compile(source, strlen(source), nullptr, &bytecodeSize);
+    REQUIRE(luau_load(L, "=ApiProfiler", bytecode, bytecodeSize, 0) == 0);
+    free(bytecode);
+
+    // samples are not recorded until the profiler is started
+    CHECK(lua_profilersample(L, 0, 1) == 0);
+
+    lua_callbacks(L)->interrupt = [](lua_State* L, int gc) {
+        if (gc < 0)
+            lua_profilersample(L, 7, 2);
+    };
+
+    lua_startprofiler(L, 4096);
+
+    lua_pushvalue(L, -1);
+    lua_call(L, 0, 1);
+    CHECK(lua_tonumber(L, -1) == 5050);
+    lua_pop(L, 1);
+
+    struct Samples
+    {
+        lua_State* L;
+        std::vector<std::string> stacks;
+        bool valid = true;
+    } samples = {L};
+
+    auto collect = [](void* context, int tag, unsigned weight, const lua_ProfilerFrame* frames, int depth) {
+        Samples& samples = *static_cast<Samples*>(context);
+        std::string stack;
+
+        samples.valid &= tag == 7 && weight == 2;
+
+        for (int i = 0; i < depth; i++)
+        {
+            lua_Debug ar;
+            REQUIRE(lua_getprofilerframe(samples.L, &frames[i], &ar));
+
+            samples.valid &= strcmp(ar.short_src, "ApiProfiler") == 0;
+
+            if (i != 0)
+                stack += ';';
+            stack += ar.name ? ar.name : "";
+            stack += ':';
+            stack += std::to_string(ar.currentline);
+        }
+
+        samples.stacks.push_back(stack);
+    };
+
+    // functions of recorded frames are kept alive until their samples are read
+    lua_settop(L, 0);
+    lua_gc(L, LUA_GCCOLLECT, 0);
+
+    CHECK(lua_getprofilersamples(L, &samples, collect) == 0);
+    CHECK(samples.valid);
+
+    // loop iterations of 'inner' are sampled at the back edge of the loop
+    REQUIRE(samples.stacks.size() >= 100);
+    CHECK(std::count(samples.stacks.begin(), samples.stacks.end(), "inner:4;outer:11;:14") >= 99);
+
+    // samples are removed once they are read
+    samples.stacks.clear();
+    CHECK(lua_getprofilersamples(L, &samples, collect) == 0);
+    CHECK(samples.stacks.empty());
+
+    // when the buffer is full, the oldest samples are overwritten; samples taken as functions return are the only ones that fit
+    bytecode = luau_compile(source, strlen(source), nullptr, &bytecodeSize);
+    REQUIRE(luau_load(L, "=ApiProfiler", bytecode, bytecodeSize, 0) == 0);
+    free(bytecode);
+
+    lua_startprofiler(L, 10);
+
+    lua_call(L, 0, 1);
+    lua_pop(L, 1);
+
+    CHECK(lua_getprofilersamples(L, &samples, collect) >= 98);
+    CHECK(samples.valid);
+    REQUIRE(samples.stacks.size() == 3);
+    CHECK(samples.stacks[0] == "inner:7;outer:11;:14");
+    CHECK(samples.stacks[1] == "outer:11;:14");
+    CHECK(samples.stacks[2] == ":14");
+
+    lua_stopprofiler(L);
+    CHECK(lua_profilersample(L, 0, 1) == 0);
+}
+
+TEST_CASE("ApiCaptureStack")
+{
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
+
+    luaL_openlibs(L);
+
+    // returns the captured frames, starting with its caller, resolved as name:line
+    lua_pushcfunction(
+        L,
+        [](lua_State* L) {
+            int size = luaL_checkinteger(L, 1);
+
+            lua_ProfilerFrame frames[8];
+            int depth = lua_capturestack(L, 1, frames, size);
+
+            std::string stack;
+
+            for (int i = 0; i < depth; i++)
+            {
+                lua_Debug ar;
+                REQUIRE(lua_getprofilerframe(L, &frames[i], &ar));
+
+                if (i != 0)
+                    stack += ';';
+                stack += ar.name ? ar.name : "";
+                stack += ':';
+                stack += std::to_string(ar.currentline);
+            }
+
+            lua_pushstring(L, stack.c_str());
+            return 1;
+        },
+        "capture"
+    );
+    lua_setglobal(L, "capture");
+
+    const char* source = R"(
+local function inner(size)
+    return capture(size)
+end
+
+local function outer(size)
+    local result = inner(size)
+    return result
+end
+
+return outer(8), outer(2), pcall(outer, 8)
+)";
+
+    size_t bytecodeSize = 0;
+    char* bytecode = luau_compile(source, strlen(source), nullptr, &bytecodeSize);
+    REQUIRE(luau_load(L, "=ApiCaptureStack", bytecode, bytecodeSize, 0) == 0);
+    free(bytecode);
+
+    REQUIRE(lua_pcall(L, 0, 4, 0) == LUA_OK);
+
+    CHECK(std::string(lua_tostring(L, 1)) == "inner:3;outer:7;:11");
+    CHECK(std::string(lua_tostring(L, 2)) == "inner:3;outer:7");
+    CHECK(std::string(lua_tostring(L, 4)) == "inner:3;outer:7;pcall:-1;:11");
+
+    // levels past the top of the stack have no frames
+    lua_ProfilerFrame frames[4];
+    CHECK(lua_capturestack(L, 0, frames, 4) == 0);
+    CHECK(lua_capturestack(L, 10, frames, 4) == 0);
+}
+
+TEST_CASE("ApiHeapProfiler")
+{
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
+
+    const char* source = R"(
+local function make()
+    return {}
+end
+
+local keep = {}
+for i = 1, 10 do
+    keep[i] = make()
+end
+return keep
+)";
+
+    size_t bytecodeSize = 0;
+    char* bytecode = luau_compile(source, strlen(source), nullptr, &bytecodeSize);
+    REQUIRE(luau_load(L, "=ApiHeapProfiler", bytecode, bytecodeSize, 0) == 0);
+    free(bytecode);
+
+    struct Samples
+    {
+        lua_State* L;
+        int tables = 0;
+        size_t weight = 0;
+    } samples = {L};
+
+    // counts live tables allocated by 'make'
+    auto collect = [](void* context, int type, int memcat, size_t size, size_t weight, const lua_ProfilerFrame* frames, int depth) {
+        Samples& samples = *static_cast<Samples*>(context);
+
+        samples.weight += weight;
+
+        lua_Debug ar;
+        if (type == LUA_TTABLE && depth > 0 && lua_getprofilerframe(samples.L, &frames[0], &ar) && ar.name && strcmp(ar.name, "make") == 0)
+        {
+            CHECK(ar.currentline == 3);
+            CHECK(size > 0);
+            samples.tables++;
+        }
+    };
+
+    // every allocation is sampled
+    lua_startheapprofiler(L, 1, 1024);
+
+    REQUIRE(lua_pcall(L, 0, 1, 0) == LUA_OK);
+
+    CHECK(lua_getheapprofile(L, &samples, collect) == 0);
+    CHECK(samples.tables == 10);
+    CHECK(samples.weight > 0);
+
+    // samples are removed when their objects are freed
+    lua_settop(L, 0);
+    lua_gc(L, LUA_GCCOLLECT, 0);
+
+    samples.tables = 0;
+    lua_getheapprofile(L, &samples, collect);
+    CHECK(samples.tables == 0);
+
+    // samples that don't fit are dropped
+    lua_startheapprofiler(L, 1, 2);
+
+    lua_createtable(L, 0, 0);
+    lua_createtable(L, 0, 0);
+    lua_createtable(L, 0, 0);
+
+    CHECK(lua_getheapprofile(L, &samples, collect) == 1);
+
+    lua_stopheapprofiler(L);
+}
+
+TEST_CASE("ApiHeapImage")
+{
+    auto run = [](lua_State* L, const char* source) {
+        size_t bytecodeSize = 0;
+        char* bytecode = luau_compile(source, strlen(source), nullptr, &bytecodeSize);
+        REQUIRE(luau_loadlazy(L, "=image", bytecode, bytecodeSize, 0) == 0);
+        free(bytecode);
+
+        int status = lua_pcall(L, 0, 0, 0);
+        INFO((status == LUA_OK ? std::string() : std::string(lua_tostring(L, -1))));
+        REQUIRE(status == LUA_OK);
+    };
+
+    StateRef templateState(luaL_newstate(), lua_close);
+    lua_State* T = templateState.get();
+
+    luaL_openlibs(T);
+    luaL_imagenames(T, 0);
+
+    lua_pushvector(T, 1.0f, 2.0f, 3.0f);
+    lua_setglobal(T, "vec");
+
+    run(T, R"(
+counter = 0
+local shared = 0
+function bump() shared += 1; counter += 1; return shared end
+function peek() return shared end
+proxy = setmetatable({}, {__index = function(t, k) return k .. "!" end})
+cycle = {}
+cycle.self = cycle
+list = {1, 2, 3, "four", vec, true}
+data = buffer.fromstring("abc")
+frozen = table.freeze({x = 1})
+original = table.create(100, 1)
+cloned = table.clone(original)
+fmt = string.format
+function greet(name) return fmt("hello %s", name):upper() end
+function where() return (function() return debug.info(1, "l") end)() end
+bump()
+)");
+
+    lua_saveimage(T, LUA_GLOBALSINDEX, -1);
+
+    size_t size = 0;
+    const char* data = (const char*)lua_tobuffer(T, -1, &size);
+    std::string image(data, size);
+    lua_pop(T, 2);
+
+    // the template state isn't affected by saving
+    run(T, "assert(bump() == 2 and where() == 16)");
+
+    StateRef workerState(luaL_newstate(), lua_close);
+    lua_State* W = workerState.get();
+
+    luaL_openlibs(W);
+    luaL_imagenames(W, 1);
+
+    REQUIRE(lua_loadimage(W, image.data(), image.size(), -1) == 0);
+    lua_replace(W, LUA_GLOBALSINDEX);
+    lua_pop(W, 1);
+
+    run(W, R"(
+assert(counter == 1)
+assert(bump() == 2 and peek() == 2 and counter == 2)
+assert(getfenv(bump) == getfenv(1))
+assert(proxy.foo == "foo!")
+assert(cycle.self == cycle)
+assert(#list == 6 and list[4] == "four" and list[5].x == 1 and list[5].z == 3 and list[6] == true)
+assert(buffer.tostring(data) == "abc")
+assert(table.isfrozen(frozen) and frozen.x == 1)
+cloned[1] = 2
+assert(#cloned == 100 and cloned[1] == 2 and cloned[100] == 1 and original[1] == 1)
+assert(fmt == string.format)
+assert(greet("image") == "HELLO IMAGE")
+assert(where() == 16)
+)");
+
+    // objects are loaded separately each time
+    StateRef otherState(luaL_newstate(), lua_close);
+    lua_State* O = otherState.get();
+
+    luaL_openlibs(O);
+    CHECK(lua_loadimage(O, image.data(), image.size(), 0) == 1);
+    CHECK(strstr(lua_tostring(O, -1), "unknown object") != nullptr);
+    lua_pop(O, 1);
+
+    luaL_imagenames(O, 1);
+    CHECK(lua_loadimage(O, image.data(), image.size() - 1, -1) == 1);
+    CHECK(strcmp(lua_tostring(O, -1), "image is malformed") == 0);
+    lua_pop(O, 1);
+
+    CHECK(lua_loadimage(O, "LIMG", 4, -1) == 1);
+    CHECK(strcmp(lua_tostring(O, -1), "image has an unsupported format") == 0);
+    lua_pop(O, 2);
+
+    // values that can't be copied are an error unless they are named
+    lua_pushcfunction(
+        O,
+        [](lua_State* L) {
+            lua_saveimage(L, 1, 0);
+            return 1;
+        },
+        "saveimage"
+    );
+    lua_newtable(O);
+    lua_newthread(O);
+    lua_rawseti(O, -2, 1);
+    CHECK(lua_pcall(O, 1, 1, 0) == LUA_ERRRUN);
+    CHECK(strstr(lua_tostring(O, -1), "can't save thread") != nullptr);
+    lua_pop(O, 1);
+}
+
+TEST_CASE("ApiXClone")
+{
+    StateRef sourceState(luaL_newstate(), lua_close);
+    StateRef targetState(luaL_newstate(), lua_close);
+    lua_State* L = sourceState.get();
+    lua_State* T = targetState.get();
+
+    // { 1, 2, "three", inner = { buf = buffer }, alias = inner, vec = vector, self = <table> }
+    lua_createtable(L, 3, 4);
+    lua_pushnumber(L, 1);
+    lua_rawseti(L, -2, 1);
+    lua_pushnumber(L, 2);
+    lua_rawseti(L, -2, 2);
+    lua_pushstring(L, "three");
+    lua_rawseti(L, -2, 3);
+    lua_newtable(L);
+    memcpy(lua_newbuffer(L, 4), "data", 4);
+    lua_setfield(L, -2, "buf");
+    lua_pushvalue(L, -1);
+    lua_setfield(L, -3, "inner");
+    lua_setfield(L, -2, "alias");
+#if LUA_VECTOR_SIZE == 4
+    lua_pushvector(L, 1, 2, 3, 4);
+#else
+    lua_pushvector(L, 1, 2, 3);
+#endif
+    lua_setfield(L, -2, "vec");
+    lua_pushvalue(L, -1);
+    lua_setfield(L, -2, "self");
+
+    CHECK(lua_xclone(L, -1, T) == 1);
+    CHECK(lua_gettop(T) == 1);
+    REQUIRE(lua_istable(T, 1));
+
+    lua_rawgeti(T, 1, 2);
+    CHECK(lua_tonumber(T, -1) == 2);
+    lua_rawgeti(T, 1, 3);
+    CHECK(strcmp(lua_tostring(T, -1), "three") == 0);
+    lua_pop(T, 2);
+
+    // cycles and shared references are preserved
+    lua_getfield(T, 1, "self");
+    CHECK(lua_rawequal(T, -1, 1));
+    lua_getfield(T, 1, "inner");
+    lua_getfield(T, 1, "alias");
+    CHECK(lua_rawequal(T, -1, -2));
+    lua_pop(T, 3);
+
+    lua_getfield(T, 1, "inner");
+    lua_getfield(T, -1, "buf");
+    size_t len = 0;
+    const char* data = (const char*)lua_tobuffer(T, -1, &len);
+    REQUIRE(data);
+    CHECK(std::string(data, len) == "data");
+    lua_pop(T, 2);
+
+    lua_getfield(T, 1, "vec");
+    const float* v = lua_tovector(T, -1);
+    REQUIRE(v);
+    CHECK(v[2] == 3);
+    lua_pop(T, 2);
+
+    // functions can't be cloned and leave the target stack unchanged
+    lua_pushcfunction(L, lua_vector, "fn");
+    lua_setfield(L, -2, "fn");
+    CHECK(lua_xclone(L, -1, T) == 0);
+    CHECK(lua_gettop(T) == 0);
+}
+
+TEST_CASE("ApiSharedHeap")
+{
+    lua_SharedHeap* heap = nullptr;
+
+    {
+        StateRef sourceState(luaL_newstate(), lua_close);
+        lua_State* L = sourceState.get();
+        luaL_openlibs(L);
+
+        std::string source = R"(
+            local items = table.freeze({ table.freeze({ name = "sword", damage = 10 }), table.freeze({ name = "bow", damage = 7 }) })
+            local data = { items = items, first = items[1], count = 2, tags = table.freeze({ "a", "b", nil, nil }) }
+            data.self = data
+
+            -- large enough for table.clone to share storage of regular tables
+            local names = {}
+            for i = 1, 100 do
+                names["key" .. i] = i
+            end
+            data.list = table.freeze(table.create(100, 1))
+            data.names = table.freeze(names)
+            return table.freeze(data)
+        )";
+
+        size_t bytecodeSize = 0;
+        char* bytecode = luau_compile(source.data(), source.size(), nullptr, &bytecodeSize);
+        REQUIRE(luau_load(L, "=shared", bytecode, bytecodeSize, 0) == 0);
+        free(bytecode);
+        REQUIRE(lua_pcall(L, 0, 1, 0) == LUA_OK);
+
+        heap = lua_newsharedheap(L, -1);
+        REQUIRE(heap);
+        CHECK(lua_sharedheapsize(heap) > 0);
+
+        // tables that aren't frozen can't be shared
+        lua_newtable(L);
+        CHECK(lua_newsharedheap(L, -1) == nullptr);
+    }
+
+    // heap outlives the state that created it and can be attached to any number of new states
+    for (int i = 0; i < 2; i++)
+    {
+        StateRef globalState(luaL_newstate(), lua_close);
+        lua_State* L = globalState.get();
+
+        lua_attachsharedheap(L, heap);
+        luaL_openlibs(L);
+
+        lua_pushsharedheap(L);
+        lua_setglobal(L, "data");
+
+        std::string source = R"(
+            assert(data.self == data)
+            assert(data.first == data.items[1])
+            assert(data.items[2].name == "bow" and data.items[2].damage == 7)
+            assert(#data.items == 2 and #data.tags == 2)
+            assert(table.isfrozen(data))
+            assert(not pcall(function() data.count = 3 end))
+
+            local total = 0
+            for _, item in data.items do
+                total += item.damage
+            end
+            assert(total == 17)
+
+            local lookup = {}
+            for k, v in data do
+                lookup[k] = v
+            end
+            assert(lookup.count == 2)
+            assert(lookup[string.sub("xnamex", 2, 5)] == nil)
+            assert(data.items[1][string.sub("xnamex", 2, 5)] == "sword")
+
+            -- cloning a shared table copies its storage instead of taking it over
+            local list = table.clone(data.list)
+            list[1] = 2
+            assert(#list == 100 and list[1] == 2 and data.list[1] == 1)
+
+            local names = table.clone(data.names)
+            names.key1 = 0
+            assert(names.key1 == 0 and names.key100 == 100 and data.names.key1 == 1)
+            assert(table.isfrozen(data.list) and table.isfrozen(data.names))
+
+            return data.items[1].name
+        )";
+
+        size_t bytecodeSize = 0;
+        char* bytecode = luau_compile(source.data(), source.size(), nullptr, &bytecodeSize);
+        REQUIRE(luau_load(L, "=reader", bytecode, bytecodeSize, 0) == 0);
+        free(bytecode);
+
+        int status = lua_pcall(L, 0, 1, 0);
+        INFO(std::string(lua_tostring(L, -1) ? lua_tostring(L, -1) : ""));
+        REQUIRE(status == LUA_OK);
+        CHECK(strcmp(lua_tostring(L, -1), "sword") == 0);
+
+        lua_gc(L, LUA_GCCOLLECT, 0);
+    }
+
+    lua_releasesharedheap(heap);
+}
+
+TEST_CASE("ApiAtoms")
+{
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
+
+    lua_callbacks(L)->useratom = [](const char* s, size_t l) -> int16_t {
+        if (strcmp(s, "string") == 0)
+            return 0;
+        if (strcmp(s, "important") == 0)
+            return 1;
+
+        return -1;
+    };
+
+    lua_pushstring(L, "string");
+    lua_pushstring(L, "import");
+    lua_pushstring(L, "ant");
+    lua_concat(L, 2);
+    lua_pushstring(L, "unimportant");
+
+    int a1, a2, a3;
+    const char* s1 = lua_tostringatom(L, -3, &a1);
+    const char* s2 = lua_tostringatom(L, -2, &a2);
+    const char* s3 = lua_tostringatom(L, -1, &a3);
+
+    CHECK(strcmp(s1, "string") == 0);
+    CHECK(a1 == 0);
+
+    CHECK(strcmp(s2, "important") == 0);
+    CHECK(a2 == 1);
+
+    CHECK(strcmp(s3, "unimportant") == 0);
+    CHECK(a3 == -1);
+}
+
+static bool endsWith(const std::string& str, const std::string& suffix)
+{
+    if (suffix.length() > str.length())
+        return false;
+
+    return suffix == std::string_view(str.c_str() + str.length() - suffix.length(), suffix.length());
+}
+
+TEST_CASE("ApiType")
+{
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
+
+    lua_pushnumber(L, 2);
+    CHECK(strcmp(luaL_typename(L, -1), "number") == 0);
+    CHECK(strcmp(luaL_typename(L, 1), "number") == 0);
+    CHECK(lua_type(L, -1) == LUA_TNUMBER);
+    CHECK(lua_type(L, 1) == LUA_TNUMBER);
+
+    CHECK(strcmp(luaL_typename(L, 2), "no value") == 0);
+    CHECK(lua_type(L, 2) == LUA_TNONE);
+    CHECK(strcmp(lua_typename(L, lua_type(L, 2)), "no value") == 0);
+
+    lua_newuserdata(L, 0);
+    CHECK(strcmp(luaL_typename(L, -1), "userdata") == 0);
+    CHECK(lua_type(L, -1) == LUA_TUSERDATA);
+
+    lua_newtable(L);
+    lua_pushstring(L, "hello");
+    lua_setfield(L, -2, "__type");
+    lua_setmetatable(L, -2);
+
+    CHECK(strcmp(luaL_typename(L, -1), "hello") == 0);
+    CHECK(lua_type(L, -1) == LUA_TUSERDATA);
+}
+
+TEST_CASE("ApiBuffer")
+{
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
+
+    lua_newbuffer(L, 1000);
+
+    REQUIRE(lua_type(L, -1) == LUA_TBUFFER);
+
+    CHECK(lua_isbuffer(L, -1));
+    CHECK(lua_objlen(L, -1) == 1000);
+
+    CHECK(strcmp(lua_typename(L, LUA_TBUFFER), "buffer") == 0);
+
+    CHECK(strcmp(luaL_typename(L, -1), "buffer") == 0);
+
+    void* p1 = lua_tobuffer(L, -1, nullptr);
+
+    size_t len = 0;
+    void* p2 = lua_tobuffer(L, -1, &len);
+    CHECK(len == 1000);
+    CHECK(p1 == p2);
+
+    void* p3 = luaL_checkbuffer(L, -1, nullptr);
+    CHECK(p1 == p3);
+
+    len = 0;
+    void* p4 = luaL_checkbuffer(L, -1, &len);
+    CHECK(len == 1000);
+    CHECK(p1 == p4);
+
+    memset(p1, 0xab, 1000);
+
+    CHECK(lua_topointer(L, -1) != nullptr);
+
+    lua_newbuffer(L, 0);
+
+    lua_pushvalue(L, -2);
+
+    CHECK(lua_equal(L, -3, -1));
+    CHECK(!lua_equal(L, -2, -1));
+
+    lua_pop(L, 1);
+}
+
+TEST_CASE("AllocApi")
+{
+    int ud = 0;
+    StateRef globalState(lua_newstate(limitedRealloc, &ud), lua_close);
+    lua_State* L = globalState.get();
+
+    void* udCheck = nullptr;
+    bool allocfIsSet = lua_getallocf(L, &udCheck) == limitedRealloc;
+    CHECK(allocfIsSet);
+    CHECK(udCheck == &ud);
+}
+
+TEST_CASE("StringTableGrowthOutOfMemory")
+{
+    // fails the allocation of the bucket array when the string table grows from 512 to 1024 buckets
+    bool failBuckets = false;
+
+    auto alloc = [](void* ud, void* ptr, size_t osize, size_t nsize) -> void* {
+        if (nsize == 0)
+        {
+            free(ptr);
+            return nullptr;
+        }
+
+        if (*static_cast<bool*>(ud) && nsize == 1024 * sizeof(void*))
+            return nullptr;
+
+        return realloc(ptr, nsize);
+    };
+
+    StateRef globalState(lua_newstate(alloc, &failBuckets), lua_close);
+    lua_State* L = globalState.get();
+
+    // strings are kept alive in a table that doesn't need to grow
+    lua_createtable(L, 2000, 0);
+
+    auto fill = [](lua_State* L) {
+        for (int i = 1; i <= 2000; ++i)
+        {
+            lua_pushfstring(L, "string%d", i);
+            lua_rawseti(L, 1, i);
+        }
+
+        return 0;
+    };
+
+    failBuckets = true;
+
+    lua_pushcfunction(L, fill, "fill");
+    lua_pushvalue(L, 1);
+    CHECK(lua_pcall(L, 1, 0, 0) == LUA_ERRMEM);
+
+    failBuckets = false;
+
+    lua_pushcfunction(L, fill, "fill");
+    lua_pushvalue(L, 1);
+    REQUIRE(lua_pcall(L, 1, 0, 0) == LUA_OK);
+
+    lua_gc(L, LUA_GCCOLLECT, 0);
+
+    // every string is still found when the same contents are interned again
+    for (int i = 1; i <= 2000; ++i)
+    {
+        lua_rawgeti(L, 1, i);
+        lua_pushfstring(L, "string%d", i);
+        CHECK(lua_rawequal(L, -2, -1));
+        lua_pop(L, 2);
+    }
+}
+
+#if !LUA_USE_LONGJMP
+TEST_CASE("ExceptionObject")
+{
+    struct ExceptionResult
+    {
+        bool exceptionGenerated;
+        std::string description;
+    };
+
+    auto captureException = [](lua_State* L, const char* functionToRun) {
+        try
+        {
+            lua_State* threadState = lua_newthread(L);
+            lua_getfield(threadState, LUA_GLOBALSINDEX, functionToRun);
+            CHECK(lua_isLfunction(threadState, -1));
+            lua_call(threadState, 0, 0);
+        }
+        catch (std::exception& e)
+        {
+            CHECK(e.what() != nullptr);
+            return ExceptionResult{true, e.what()};
+        }
+        return ExceptionResult{false, ""};
+    };
+
+    StateRef globalState = runConformance("exceptions.lua", nullptr, nullptr, lua_newstate(limitedRealloc, nullptr));
+    lua_State* L = globalState.get();
+
+    {
+        ExceptionResult result = captureException(L, "infinite_recursion_error");
+        CHECK(result.exceptionGenerated);
+    }
+
+    {
+        ExceptionResult result = captureException(L, "empty_function");
+        CHECK_FALSE(result.exceptionGenerated);
+    }
+
+    {
+        ExceptionResult result = captureException(L, "pass_number_to_error");
+        CHECK(result.exceptionGenerated);
+        CHECK(endsWith(result.description, "42"));
+    }
+
+    {
+        ExceptionResult result = captureException(L, "pass_string_to_error");
+        CHECK(result.exceptionGenerated);
+        CHECK(endsWith(result.description, "string argument"));
+    }
+
+    {
+        ExceptionResult result = captureException(L, "pass_table_to_error");
+        CHECK(result.exceptionGenerated);
+    }
+
+    {
+        ExceptionResult result = captureException(L, "large_allocation_error");
+        CHECK(result.exceptionGenerated);
+    }
+}
+#endif
+
+TEST_CASE("IfElseExpression")
+{
+    runConformance("ifelseexpr.lua");
+}
+
+// Optionally returns debug info for the first Luau stack frame that is encountered on the callstack.
+static std::optional<lua_Debug> getFirstLuauFrameDebugInfo(lua_State* L)
+{
+    static std::string_view kLua = "Lua";
+    lua_Debug ar;
+    for (int i = 0; lua_getinfo(L, i, "sl", &ar); i++)
+    {
+        if (kLua == ar.what)
+            return ar;
+    }
+    return std::nullopt;
+}
+
+TEST_CASE("TagMethodError")
+{
+    static std::vector<int> expectedHits;
+
+    // Loop over two modes:
+    //   when doLuaBreak is false the test only verifies that callbacks occur on the expected lines in the Luau source
+    //   when doLuaBreak is true the test additionally calls lua_break to ensure breaking the debugger doesn't cause the VM to crash
+    for (bool doLuaBreak : {false, true})
+    {
+        expectedHits = {22, 32};
+
+        static int index;
+        static bool luaBreak;
+        index = 0;
+        luaBreak = doLuaBreak;
+
+        // 'yieldCallback' doesn't do anything, but providing the callback to runConformance
+        // ensures that the call to lua_break doesn't cause an error to be generated because
+        // runConformance doesn't expect the VM to be in the state LUA_BREAK.
+        auto yieldCallback = [](lua_State* L) {};
+
+        runConformance(
+            "tmerror.lua",
+            [](lua_State* L) {
+                auto* cb = lua_callbacks(L);
+
+                cb->debugprotectederror = [](lua_State* L) {
+                    std::optional<lua_Debug> ar = getFirstLuauFrameDebugInfo(L);
+
+                    CHECK(lua_isyieldable(L));
+                    REQUIRE(ar.has_value());
+                    REQUIRE(index < int(std::size(expectedHits)));
+                    CHECK(ar->currentline == expectedHits[index++]);
+
+                    if (luaBreak)
+                    {
+                        // Cause luau execution to break when 'error' is called via 'pcall'
+                        // This call to lua_break is a regression test for an issue where debugprotectederror
+                        // was called on a thread that couldn't be yielded even though lua_isyieldable was true.
+                        lua_break(L);
+                    }
+                };
+            },
+            yieldCallback);
+
+        // Make sure the number of break points hit was the expected number
+        CHECK(index == std::size(expectedHits));
+    }
+}
+
+TEST_CASE("Coverage")
+{
+    lua_CompileOptions copts = defaultOptions();
+    copts.optimizationLevel = 1; // disable inlining to get fixed expected hit results
+    copts.coverageLevel = 2;
+
+    runConformance(
+        "coverage.lua",
+        [](lua_State* L) {
+            lua_pushcfunction(
+                L,
+                [](lua_State* L) -> int {
+                    luaL_argexpected(L, lua_isLfunction(L, 1), 1, "function");
+
+                    lua_newtable(L);
+                    lua_getcoverage(L, 1, L, [](void* context, const char* function, int linedefined, int depth, const int* hits, size_t size) {
+                        lua_State* L = static_cast<lua_State*>(context);
+
+                        lua_newtable(L);
+
+                        lua_pushstring(L, function);
+                        lua_setfield(L, -2, "name");
+
+                        lua_pushinteger(L, linedefined);
+                        lua_setfield(L, -2, "linedefined");
+
+                        lua_pushinteger(L, depth);
+                        lua_setfield(L, -2, "depth");
+
+                        for (size_t i = 0; i < size; ++i)
+                            if (hits[i] != -1)
+                            {
+                                lua_pushinteger(L, hits[i]);
+                                lua_rawseti(L, -2, int(i));
+                            }
+
+                        lua_rawseti(L, -2, lua_objlen(L, -2) + 1);
+                    });
+
+                    return 1;
+                },
+                "getcoverage");
+            lua_setglobal(L, "getcoverage");
+        },
+        nullptr, nullptr, &copts);
+}
+
+TEST_CASE("CoverageFirstHit")
+{
+    bool threaded = false;
+
+    SUBCASE("")
+    {
+        threaded = false;
+    }
+    SUBCASE("ThreadedDispatch")
+    {
+        threaded = true;
+    }
+
+    ScopedFastFlag luauThreadedDispatch{FFlag::LuauThreadedDispatch, threaded};
+
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
+
+    if (codegen && luau_codegen_supported())
+        luau_codegen_create(L);
+
+    lua_setcoveragefirsthit(L, 1);
+
+    const char* source = R"(
+local s = 0
+for i = 1, 10 do
+    s += i
+end
+if s < 0 then
+    s = 0
+end
+return s
+)";
+
+    lua_CompileOptions copts = defaultOptions();
+    copts.coverageLevel = 1;
+
+    size_t bytecodeSize = 0;
+    char* bytecode = luau_compile(source, strlen(source), &copts, &bytecodeSize);
+    REQUIRE(luau_load(L, "=coverage", bytecode, bytecodeSize, 0) == 0);
+    free(bytecode);
+
+    if (codegen && luau_codegen_supported())
+        Luau::CodeGen::compile(L, -1, Luau::CodeGen::CodeGen_ColdFunctions | Luau::CodeGen::CodeGen_CoverageFirstHit);
+
+    // keep the function for lua_getcoverage
+    lua_pushvalue(L, -1);
+    REQUIRE(lua_pcall(L, 0, 1, 0) == 0);
+    CHECK(lua_tonumber(L, -1) == 55);
+    lua_pop(L, 1);
+
+    std::vector<int> lines;
+
+    lua_getcoverage(L, -1, &lines, [](void* context, const char* function, int linedefined, int depth, const int* hits, size_t size) {
+        static_cast<std::vector<int>*>(context)->assign(hits, hits + size);
+    });
+
+    // lines inside the loop run 10 times but only the first hit is recorded
+    REQUIRE(lines.size() == 10);
+    CHECK(lines[2] == 1);
+    CHECK(lines[3] == 1);
+    CHECK(lines[4] == 1);
+    CHECK(lines[6] == 1);
+    CHECK(lines[7] == 0);
+    CHECK(lines[9] == 1);
+}
+
+TEST_CASE("StringConversion")
+{
+    ScopedFastFlag luauSciNumberSkipTrailDot{FFlag::LuauSciNumberSkipTrailDot, true};
+
+    runConformance("strconv.lua");
+}
+
+TEST_CASE("GCDump")
+{
+    // internal function, declared in lgc.h - not exposed via lua.h
+    extern void luaC_dump(lua_State * L, void* file, const char* (*categoryName)(lua_State * L, uint8_t memcat));
+    extern void luaC_dumpbinary(lua_State * L, void* file, const char* (*categoryName)(lua_State * L, uint8_t memcat));
+    extern void luaC_enumheap(lua_State * L, void* context,
+        void (*node)(void* context, void* ptr, uint8_t tt, uint8_t memcat, size_t size, const char* name),
+        void (*edge)(void* context, void* from, void* to, const char* name));
+
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
+
+    // push various objects on stack to cover different paths
+    lua_createtable(L, 1, 2);
+    lua_pushstring(L, "value");
+    lua_setfield(L, -2, "key");
+
+    lua_pushstring(L, "u42");
+    lua_setfield(L, -2, "__type");
+
+    lua_pushinteger(L, 42);
+    lua_rawseti(L, -2, 1000);
+
+    lua_pushinteger(L, 42);
+    lua_rawseti(L, -2, 1);
+
+    lua_pushvalue(L, -1);
+    lua_setmetatable(L, -2);
+
+    lua_newuserdata(L, 42);
+    lua_pushvalue(L, -2);
+    lua_setmetatable(L, -2);
+
+    lua_pushinteger(L, 1);
+    lua_pushcclosure(L, lua_silence, "test", 1);
+
+    lua_newbuffer(L, 100);
+
+    lua_State* CL = lua_newthread(L);
+
+    lua_pushstring(CL, "local x x = {} local function f() x[1] = math.abs(42) end function foo() coroutine.yield() end foo() return f");
+    lua_loadstring(CL);
+    lua_resume(CL, nullptr, 0);
+
+#ifdef _WIN32
+    const char* path = "NUL";
+#else
+    const char* path = "/dev/null";
+#endif
+
+    FILE* f = fopen(path, "w");
+    REQUIRE(f);
+
+    luaC_dump(L, f, nullptr);
+
+    fclose(f);
+
+    FILE* bf = tmpfile();
+    REQUIRE(bf);
+
+    luaC_dumpbinary(L, bf, [](lua_State* L, uint8_t memcat) { return "category"; });
+
+    long size = ftell(bf);
+    CHECK(size > 9);
+
+    char header[9] = {};
+    char end = 0;
+
+    rewind(bf);
+    CHECK(fread(header, 1, 9, bf) == 9);
+    CHECK(memcmp(header, "LUAUHEAP\x01", 9) == 0);
+
+    fseek(bf, -1, SEEK_END);
+    CHECK(fread(&end, 1, 1, bf) == 1);
+    CHECK(end == 'E');
+
+    fclose(bf);
+
+    struct Node
+    {
+        void* ptr;
+        uint8_t tag;
+        uint8_t memcat;
+        size_t size;
+        std::string name;
+    };
+
+    struct EnumContext
+    {
+        EnumContext()
+            : nodes{nullptr}
+            , edges{nullptr}
+        {
+        }
+
+        Luau::DenseHashMap<void*, Node> nodes;
+        Luau::DenseHashMap<void*, void*> edges;
+    } ctx;
+
+    luaC_enumheap(
+        L, &ctx,
+        [](void* ctx, void* gco, uint8_t tt, uint8_t memcat, size_t size, const char* name) {
+            EnumContext& context = *(EnumContext*)ctx;
+
+            if (tt == LUA_TUSERDATA)
+                CHECK(strcmp(name, "u42") == 0);
+
+            context.nodes[gco] = {gco, tt, memcat, size, name ? name : ""};
+        },
+        [](void* ctx, void* s, void* t, const char*) {
+            EnumContext& context = *(EnumContext*)ctx;
+            context.edges[s] = t;
+        });
+
+    CHECK(!ctx.nodes.empty());
+    CHECK(!ctx.edges.empty());
+}
+
+TEST_CASE("GCHeapSnapshot")
+{
+    // internal function, declared in lgc.h - not exposed via lua.h
+    extern void luaC_startheapsnapshot(lua_State * L, void* context,
+        void (*node)(void* context, void* ptr, uint8_t tt, uint8_t memcat, size_t size, const char* name),
+        void (*edge)(void* context, void* from, void* to, const char* name), void (*done)(void* context));
+
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
+
+    luaL_openlibs(L);
+
+    struct SnapshotContext
+    {
+        SnapshotContext()
+            : nodes{nullptr}
+        {
+        }
+
+        // the last report of an object replaces its references
+        Luau::DenseHashMap<void*, std::vector<void*>> nodes;
+        void* registry = nullptr;
+        int done = 0;
+    } ctx;
+
+    auto node = [](void* ctx, void* gco, uint8_t tt, uint8_t memcat, size_t size, const char* name) {
+        SnapshotContext& context = *(SnapshotContext*)ctx;
+
+        context.nodes[gco].clear();
+
+        if (name && strcmp(name, "registry") == 0)
+            context.registry = gco;
+    };
+
+    auto edge = [](void* ctx, void* s, void* t, const char*) {
+        SnapshotContext& context = *(SnapshotContext*)ctx;
+        context.nodes[s].push_back(t);
+    };
+
+    auto done = [](void* ctx) {
+        SnapshotContext& context = *(SnapshotContext*)ctx;
+        context.done++;
+    };
+
+    // snapshot runs during the next collection cycle which is interleaved with mutator work
+    luaC_startheapsnapshot(L, &ctx, node, edge, done);
+
+    std::string source = R"(
+        local root = {}
+        _G.root = root
+        for i = 1, 50000 do
+            root[i % 100 + 1] = { i }
+        end
+        return "OK"
+    )";
+
+    size_t bytecodeSize = 0;
+    char* bytecode = luau_compile(source.data(), source.size(), nullptr, &bytecodeSize);
+    int result = luau_load(L, "=GCHeapSnapshot", bytecode, bytecodeSize, 0);
+    free(bytecode);
+
+    REQUIRE(result == 0);
+    REQUIRE(lua_resume(L, nullptr, 0) == LUA_OK);
+    lua_pop(L, 1);
+
+    // make sure the cycle that takes the snapshot has finished
+    lua_gc(L, LUA_GCCOLLECT, 0);
+
+    CHECK(ctx.done == 1);
+    CHECK(ctx.registry != nullptr);
+
+    // every reference of a live table must point to a reported object
+    lua_getglobal(L, "root");
+    const std::vector<void*>* refs = ctx.nodes.find((void*)lua_topointer(L, -1));
+    lua_pop(L, 1);
+
+    REQUIRE(refs);
+    CHECK(refs->size() >= 100);
+
+    for (void* ref : *refs)
+        CHECK(ctx.nodes.contains(ref));
+
+    // snapshot taken by a full collection in generational mode
+    ctx.nodes.clear();
+    ctx.done = 0;
+
+    lua_gc(L, LUA_GCGEN, 0);
+    lua_gc(L, LUA_GCCOLLECT, 0);
+
+    for (int i = 0; i < 100; ++i)
+        lua_gc(L, LUA_GCSTEP, 8);
+
+    luaC_startheapsnapshot(L, &ctx, node, edge, done);
+
+    lua_gc(L, LUA_GCCOLLECT, 0);
+
+    CHECK(ctx.done == 1);
+    CHECK(ctx.nodes.size() > 100);
+
+    // incremental snapshot in generational mode needs to wait for a major collection
+    ctx.nodes.clear();
+    ctx.done = 0;
+
+    luaC_startheapsnapshot(L, &ctx, node, edge, done);
+
+    for (int i = 0; i < 100000 && ctx.done == 0; ++i)
+        lua_gc(L, LUA_GCSTEP, 1);
+
+    CHECK(ctx.done == 1);
+    CHECK(ctx.nodes.size() > 100);
+}
+
+TEST_CASE("Interrupt")
+{
+    lua_CompileOptions copts = defaultOptions();
+    copts.optimizationLevel = 1; // disable loop unrolling to get fixed expected hit results
+
+    static int index;
+
+    StateRef globalState = runConformance("interrupt.lua", nullptr, nullptr, nullptr, &copts);
+
+    lua_State* L = globalState.get();
+
+    // note: for simplicity here we setup the interrupt callback when the test starts
+    // however, this carries a noticeable performance cost. in a real application,
+    // it's advised to set interrupt callback on a timer from a different thread,
+    // and set it back to nullptr once the interrupt triggered.
+
+    // define the interrupt to check the expected hits
+    static const int expectedhits[] = {11, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 8, 20, 15, 15, 15, 15, 18, 25, 23, 26};
+
+    lua_callbacks(L)->interrupt = [](lua_State* L, int gc) {
+        if (gc >= 0)
+            return;
+
+        CHECK(index < int(std::size(expectedhits)));
+
+        lua_Debug ar = {};
+        lua_getinfo(L, 0, "l", &ar);
+
+        CHECK(ar.currentline == expectedhits[index]);
+
+        index++;
+
+        // check that we can yield inside an interrupt
+        if (index == 4)
+            lua_yield(L, 0);
+    };
+
+    {
+        lua_State* T = lua_newthread(L);
+
+        lua_getglobal(T, "test");
+
+        index = 0;
+        int status = lua_resume(T, nullptr, 0);
+        CHECK(status == LUA_YIELD);
+        CHECK(index == 4);
+
+        status = lua_resume(T, nullptr, 0);
+        CHECK(status == LUA_OK);
+        CHECK(index == int(std::size(expectedhits)));
+
+        lua_pop(L, 1);
+    }
+
+    // redefine the interrupt to break after 10 iterations of a loop that would otherwise be infinite
+    // the test exposes a few global functions that we will call; the interrupt will force a yield
+    lua_callbacks(L)->interrupt = [](lua_State* L, int gc) {
+        if (gc >= 0)
+            return;
+
+        CHECK(index < 11);
+        if (++index == 11)
+            lua_yield(L, 0);
+    };
+
+    for (int test = 1; test <= 10; ++test)
+    {
+        lua_State* T = lua_newthread(L);
+
+        std::string name = "infloop" + std::to_string(test);
+        lua_getglobal(T, name.c_str());
+
+        index = 0;
+        int status = lua_resume(T, nullptr, 0);
+        CHECK(status == LUA_YIELD);
+        CHECK(index == 11);
+
+        // abandon the thread
+        lua_pop(L, 1);
+    }
+
+    lua_callbacks(L)->interrupt = [](lua_State* L, int gc) {
+        if (gc >= 0)
+            return;
+
+        index++;
+
+        if (index == 1'000)
+        {
+            index = 0;
+            luaL_error(L, "timeout");
+        }
+    };
+
+    ScopedFastFlag luauInterruptablePatternMatch{DFFlag::LuauInterruptablePatternMatch, true};
+
+    for (int test = 1; test <= 5; ++test)
+    {
+        lua_State* T = lua_newthread(L);
+
+        std::string name = "strhang" + std::to_string(test);
+        lua_getglobal(T, name.c_str());
+
+        index = 0;
+        int status = lua_resume(T, nullptr, 0);
+        CHECK(status == LUA_ERRRUN);
+
+        lua_pop(L, 1);
+    }
+
+    {
+        lua_State* T = lua_newthread(L);
+
+        lua_getglobal(T, "strhangpcall");
+
+        index = 0;
+        int status = lua_resume(T, nullptr, 0);
+        CHECK(status == LUA_OK);
+
+        lua_pop(L, 1);
+    }
+}
+
+TEST_CASE("InterruptRequest")
+{
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
+
+    if (codegen && luau_codegen_supported())
+        luau_codegen_create(L);
+
+    static int handled;
+    handled = 0;
+
+    // request is made from the script every 100 iterations, and the handler stops the script after the third one
+    lua_pushcfunction(
+        L,
+        [](lua_State* L) {
+            lua_requestinterrupt(L);
+            return 0;
+        },
+        "request"
+    );
+    lua_setglobal(L, "request");
+
+    lua_setinterrupthandler(L, [](lua_State* L, int gc) {
+        if (gc >= 0)
+            return;
+
+        if (++handled == 3)
+            luaL_error(L, "timeout");
+    });
+
+    const char* source = R"(
+local i = 0
+while true do
+    i += 1
+    if i % 100 == 0 then
+        request()
+    end
+end
+)";
+
+    size_t bytecodeSize = 0;
+    char* bytecode = luau_compile(source, strlen(source), nullptr, &bytecodeSize);
+    REQUIRE(luau_load(L, "=InterruptRequest", bytecode, bytecodeSize, 0) == 0);
+    free(bytecode);
+
+    if (codegen && luau_codegen_supported())
+        luau_codegen_compile(L, -1);
+
+    lua_pushvalue(L, -1);
+    CHECK(lua_pcall(L, 0, 0, 0) == LUA_ERRRUN);
+    CHECK(handled == 3);
+    lua_pop(L, 1);
+
+    // the callback removes itself, so safepoints don't call anything until the next request
+    CHECK(!lua_callbacks(L)->interrupt);
+
+    // requests are safe to make from another thread
+    lua_setinterrupthandler(L, [](lua_State* L, int gc) {
+        if (gc < 0)
+            luaL_error(L, "timeout");
+    });
+
+    source = "while true do end";
+
+    bytecode = luau_compile(source, strlen(source), nullptr, &bytecodeSize);
+    REQUIRE(luau_load(L, "=InterruptRequest", bytecode, bytecodeSize, 0) == 0);
+    free(bytecode);
+
+    if (codegen && luau_codegen_supported())
+        luau_codegen_compile(L, -1);
+
+    std::thread watchdog([L] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        lua_requestinterrupt(L);
+    });
+
+    CHECK(lua_pcall(L, 0, 0, 0) == LUA_ERRRUN);
+    watchdog.join();
+}
+
+TEST_CASE("ExecutionBudget")
+{
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
+
+    if (codegen && luau_codegen_supported())
+        luau_codegen_create(L);
+
+    luaL_openlibs(L);
+
+    // script ticks the timer itself every 100 iterations, so that the amount of work done within the budget is deterministic
+    lua_pushcfunction(
+        L,
+        [](lua_State* L) {
+            lua_tick(L);
+            return 0;
+        },
+        "tick"
+    );
+    lua_setglobal(L, "tick");
+
+    const char* source = R"(
+local function spin(limit)
+    local i = 0
+    while i < limit do
+        i += 1
+        if i % 100 == 0 then
+            tick()
+        end
+    end
+    return i
+end
+
+local short = spin(250)
+local ok, err = coroutine.resume(coroutine.create(spin), math.huge)
+return short, ok, err
+)";
+
+    size_t bytecodeSize = 0;
+    char* bytecode = luau_compile(source, strlen(source), nullptr, &bytecodeSize);
+    REQUIRE(luau_load(L, "=ExecutionBudget", bytecode, bytecodeSize, 0) == 0);
+    free(bytecode);
+
+    if (codegen && luau_codegen_supported())
+        luau_codegen_compile(L, -1);
+
+    // the first call spends 2 ticks and the coroutine runs out of the remaining 3
+    lua_setbudget(L, 5);
+    CHECK(lua_getbudget(L) == 5);
+
+    REQUIRE(lua_pcall(L, 0, 3, 0) == LUA_OK);
+    CHECK(lua_tointeger(L, -3) == 250);
+    CHECK(!lua_toboolean(L, -2));
+    CHECK(std::string(lua_tostring(L, -1)).find("execution budget exceeded") != std::string::npos);
+    lua_pop(L, 3);
+
+    // budget of the coroutine was borrowed from the caller
+    CHECK(lua_getbudget(L) < 0);
+
+    source = "while true do end";
+
+    bytecode = luau_compile(source, strlen(source), nullptr, &bytecodeSize);
+    REQUIRE(luau_load(L, "=ExecutionBudget", bytecode, bytecodeSize, 0) == 0);
+    free(bytecode);
+
+    if (codegen && luau_codegen_supported())
+        luau_codegen_compile(L, -1);
+
+    // an exceeded budget raises an error at every tick until it's set again
+    lua_tick(L);
+
+    lua_pushvalue(L, -1);
+    CHECK(lua_pcall(L, 0, 0, 0) == LUA_ERRRUN);
+    lua_pop(L, 1);
+
+    // ticks are safe to deliver from another thread
+    lua_setbudget(L, 3);
+
+    std::thread timer([L] {
+        for (int i = 0; i < 3; i++)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            lua_tick(L);
+        }
+    });
+
+    CHECK(lua_pcall(L, 0, 0, 0) == LUA_ERRRUN);
+    CHECK(lua_getbudget(L) < 0);
+    timer.join();
+
+    lua_setbudget(L, 0);
+}
+
+TEST_CASE("UserdataApi")
+{
+    static int dtorhits = 0;
+
+    dtorhits = 0;
+
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
+
+    // setup dtor for tag 42 (created later)
+    auto dtor = [](lua_State* l, void* data) {
+        dtorhits += *(int*)data;
+    };
+    bool dtorIsNull = lua_getuserdatadtor(L, 42) == nullptr;
+    CHECK(dtorIsNull);
+    lua_setuserdatadtor(L, 42, dtor);
+    bool dtorIsSet = lua_getuserdatadtor(L, 42) == dtor;
+    CHECK(dtorIsSet);
+
+    // light user data
+    int lud;
+    lua_pushlightuserdata(L, &lud);
+
+    CHECK(lua_tolightuserdata(L, -1) == &lud);
+    CHECK(lua_touserdata(L, -1) == &lud);
+    CHECK(lua_topointer(L, -1) == &lud);
+
+    // regular user data
+    int* ud1 = (int*)lua_newuserdata(L, 4);
+    *ud1 = 42;
+
+    CHECK(lua_tolightuserdata(L, -1) == nullptr);
+    CHECK(lua_touserdata(L, -1) == ud1);
+    CHECK(lua_topointer(L, -1) == ud1);
+
+    // tagged user data
+    int* ud2 = (int*)lua_newuserdatatagged(L, 4, 42);
+    *ud2 = -4;
+
+    CHECK(lua_touserdatatagged(L, -1, 42) == ud2);
+    CHECK(lua_touserdatatagged(L, -1, 41) == nullptr);
+    CHECK(lua_userdatatag(L, -1) == 42);
+
+    lua_setuserdatatag(L, -1, 43);
+    CHECK(lua_userdatatag(L, -1) == 43);
+    lua_setuserdatatag(L, -1, 42);
+
+    // user data with inline dtor
+    void* ud3 = lua_newuserdatadtor(L, 4, [](void* data) {
+        dtorhits += *(int*)data;
+    });
+
+    void* ud4 = lua_newuserdatadtor(L, 1, [](void* data) {
+        dtorhits += *(char*)data;
+    });
+
+    *(int*)ud3 = 43;
+    *(char*)ud4 = 3;
+
+    // user data with named metatable
+    luaL_newmetatable(L, "udata1");
+    luaL_newmetatable(L, "udata2");
+
+    void* ud5 = lua_newuserdata(L, 0);
+    lua_getfield(L, LUA_REGISTRYINDEX, "udata1");
+    lua_setmetatable(L, -2);
+
+    void* ud6 = lua_newuserdata(L, 0);
+    lua_getfield(L, LUA_REGISTRYINDEX, "udata2");
+    lua_setmetatable(L, -2);
+
+    CHECK(luaL_checkudata(L, -2, "udata1") == ud5);
+    CHECK(luaL_checkudata(L, -1, "udata2") == ud6);
+
+    globalState.reset();
+
+    CHECK(dtorhits == 42);
+}
+
+TEST_CASE("UserdataBatchDestructor")
+{
+    static int batches = 0;
+    static int records = 0;
+    static int sum = 0;
+
+    batches = records = sum = 0;
+
+    {
+        StateRef globalState(luaL_newstate(), lua_close);
+        lua_State* L = globalState.get();
+
+        lua_setuserdatabatchdtor(L, 42, sizeof(int), [](lua_State* L, int tag, const void* data, int count) {
+            CHECK(tag == 42);
+            CHECK(count <= LUAI_UDATABATCH);
+
+            batches++;
+            records += count;
+
+            for (int i = 0; i < count; ++i)
+                sum += ((const int*)data)[i];
+        });
+
+        for (int i = 0; i < 1000; ++i)
+        {
+            *(int*)lua_newuserdatatagged(L, 4, 42) = 1;
+            lua_pop(L, 1);
+        }
+
+        // userdata smaller than the record size is padded with zeroes
+        *(char*)lua_newuserdatatagged(L, 1, 42) = 1;
+        lua_pop(L, 1);
+
+        lua_gc(L, LUA_GCCOLLECT, 0);
+
+        CHECK(records == 1001);
+        CHECK(sum == 1001);
+        CHECK(batches < 100);
+
+        // userdata that are alive when the state is closed are delivered too
+        *(int*)lua_newuserdatatagged(L, 4, 42) = 5;
+    }
+
+    CHECK(records == 1002);
+    CHECK(sum == 1006);
+}
+
+TEST_CASE("LightuserdataApi")
+{
+    ScopedFastFlag luauTaggedLuData{FFlag::LuauTaggedLuData, true};
+
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
+
+    void* value = (void*)0x12345678;
+
+    lua_pushlightuserdatatagged(L, value, 1);
+    CHECK(lua_lightuserdatatag(L, -1) == 1);
+    CHECK(lua_tolightuserdatatagged(L, -1, 0) == nullptr);
+    CHECK(lua_tolightuserdatatagged(L, -1, 1) == value);
+
+    lua_setlightuserdataname(L, 1, "id");
+    CHECK(!lua_getlightuserdataname(L, 0));
+    CHECK(strcmp(lua_getlightuserdataname(L, 1), "id") == 0);
+    CHECK(strcmp(luaL_typename(L, -1), "id") == 0);
+    lua_pop(L, 1);
+
+    lua_pushlightuserdatatagged(L, value, 0);
+    lua_pushlightuserdatatagged(L, value, 1);
+    CHECK(lua_rawequal(L, -1, -2) == 0);
+    lua_pop(L, 2);
+
+    // Check lightuserdata table key uniqueness
+    lua_newtable(L);
+
+    lua_pushlightuserdatatagged(L, value, 2);
+    lua_pushinteger(L, 20);
+    lua_settable(L, -3);
+    lua_pushlightuserdatatagged(L, value, 3);
+    lua_pushinteger(L, 30);
+    lua_settable(L, -3);
+
+    lua_pushlightuserdatatagged(L, value, 2);
+    lua_gettable(L, -2);
+    lua_pushinteger(L, 20);
+    CHECK(lua_rawequal(L, -1, -2) == 1);
+    lua_pop(L, 2);
+
+    lua_pushlightuserdatatagged(L, value, 3);
+    lua_gettable(L, -2);
+    lua_pushinteger(L, 30);
+    CHECK(lua_rawequal(L, -1, -2) == 1);
+    lua_pop(L, 2);
+
+    lua_pop(L, 1);
+
+    globalState.reset();
+}
+
+TEST_CASE("Iter")
+{
+    runConformance("iter.lua");
+}
+
+const int kInt64Tag = 1;
+static int gInt64MT = -1;
+
+static int64_t getInt64(lua_State* L, int idx)
+{
+    if (void* p = lua_touserdatatagged(L, idx, kInt64Tag))
+        return *static_cast<int64_t*>(p);
+
+    if (lua_isnumber(L, idx))
+        return lua_tointeger(L, idx);
+
+    luaL_typeerror(L, 1, "int64");
+}
+
+static void pushInt64(lua_State* L, int64_t value)
+{
+    void* p = lua_newuserdatatagged(L, sizeof(int64_t), kInt64Tag);
+
+    lua_getref(L, gInt64MT);
+    lua_setmetatable(L, -2);
+
+    *static_cast<int64_t*>(p) = value;
+}
+
+TEST_CASE("Userdata")
+{
+    runConformance("userdata.lua", [](lua_State* L) {
+        // create metatable with all the metamethods
+        lua_newtable(L);
+        gInt64MT = lua_ref(L, -1);
+
+        // __index
+        lua_pushcfunction(
+            L,
+            [](lua_State* L) {
+                void* p = lua_touserdatatagged(L, 1, kInt64Tag);
+                if (!p)
+                    luaL_typeerror(L, 1, "int64");
+
+                const char* name = luaL_checkstring(L, 2);
+
+                if (strcmp(name, "value") == 0)
+                {
+                    lua_pushnumber(L, double(*static_cast<int64_t*>(p)));
+                    return 1;
+                }
+
+                luaL_error(L, "unknown field %s", name);
+            },
+            nullptr);
+        lua_setfield(L, -2, "__index");
+
+        // __newindex
+        lua_pushcfunction(
+            L,
+            [](lua_State* L) {
+                void* p = lua_touserdatatagged(L, 1, kInt64Tag);
+                if (!p)
+                    luaL_typeerror(L, 1, "int64");
+
+                const char* name = luaL_checkstring(L, 2);
+
+                if (strcmp(name, "value") == 0)
+                {
+                    double value = luaL_checknumber(L, 3);
+                    *static_cast<int64_t*>(p) = int64_t(value);
+                    return 0;
+                }
+
+                luaL_error(L, "unknown field %s", name);
+            },
+            nullptr);
+        lua_setfield(L, -2, "__newindex");
+
+        // __eq
+        lua_pushcfunction(
+            L,
+            [](lua_State* L) {
+                lua_pushboolean(L, getInt64(L, 1) == getInt64(L, 2));
+                return 1;
+            },
+            nullptr);
+        lua_setfield(L, -2, "__eq");
+
+        // __lt
+        lua_pushcfunction(
+            L,
+            [](lua_State* L) {
+                lua_pushboolean(L, getInt64(L, 1) < getInt64(L, 2));
+                return 1;
+            },
+            nullptr);
+        lua_setfield(L, -2, "__lt");
+
+        // __le
+        lua_pushcfunction(
+            L,
+            [](lua_State* L) {
+                lua_pushboolean(L, getInt64(L, 1) <= getInt64(L, 2));
+                return 1;
+            },
+            nullptr);
+        lua_setfield(L, -2, "__le");
+
+        // __add
+        lua_pushcfunction(
+            L,
+            [](lua_State* L) {
+                pushInt64(L, getInt64(L, 1) + getInt64(L, 2));
+                return 1;
+            },
+            nullptr);
+        lua_setfield(L, -2, "__add");
+
+        // __sub
+        lua_pushcfunction(
+            L,
+            [](lua_State* L) {
+                pushInt64(L, getInt64(L, 1) - getInt64(L, 2));
+                return 1;
+            },
+            nullptr);
+        lua_setfield(L, -2, "__sub");
+
+        // __mul
+        lua_pushcfunction(
+            L,
+            [](lua_State* L) {
+                pushInt64(L, getInt64(L, 1) * getInt64(L, 2));
+                return 1;
+            },
+            nullptr);
+        lua_setfield(L, -2, "__mul");
+
+        // __div
+        lua_pushcfunction(
+            L,
+            [](lua_State* L) {
+                // ideally we'd guard against 0 but it's a test so eh
+                pushInt64(L, getInt64(L, 1) / getInt64(L, 2));
+                return 1;
+            },
+            nullptr);
+        lua_setfield(L, -2, "__div");
+
+        // __idiv
+        lua_pushcfunction(
+            L,
+            [](lua_State* L) {
+                // for testing we use different semantics here compared to __div: __idiv rounds to negative inf, __div truncates (rounds to zero)
+                // additionally, division loses precision here outside of 2^53 range
+                // we do not necessarily recommend this behavior in production code!
+                pushInt64(L, int64_t(floor(double(getInt64(L, 1)) / double(getInt64(L, 2)))));
+                return 1;
+            },
+            nullptr);
+        lua_setfield(L, -2, "__idiv");
+
+        // __mod
+        lua_pushcfunction(
+            L,
+            [](lua_State* L) {
+                // ideally we'd guard against 0 and INT64_MIN but it's a test so eh
+                pushInt64(L, getInt64(L, 1) % getInt64(L, 2));
+                return 1;
+            },
+            nullptr);
+        lua_setfield(L, -2, "__mod");
+
+        // __pow
+        lua_pushcfunction(
+            L,
+            [](lua_State* L) {
+                pushInt64(L, int64_t(pow(double(getInt64(L, 1)), double(getInt64(L, 2)))));
+                return 1;
+            },
+            nullptr);
+        lua_setfield(L, -2, "__pow");
+
+        // __unm
+        lua_pushcfunction(
+            L,
+            [](lua_State* L) {
+                pushInt64(L, -getInt64(L, 1));
+                return 1;
+            },
+            nullptr);
+        lua_setfield(L, -2, "__unm");
+
+        // __tostring
+        lua_pushcfunction(
+            L,
+            [](lua_State* L) {
+                int64_t value = getInt64(L, 1);
+                std::string str = std::to_string(value);
+                lua_pushlstring(L, str.c_str(), str.length());
+                return 1;
+            },
+            nullptr);
+        lua_setfield(L, -2, "__tostring");
+
+        // ctor
+        lua_pushcfunction(
+            L,
+            [](lua_State* L) {
+                double v = luaL_checknumber(L, 1);
+                pushInt64(L, int64_t(v));
+                return 1;
+            },
+            "int64");
+        lua_setglobal(L, "int64");
+    });
+}
+
+TEST_CASE("SafeEnv")
+{
+    runConformance("safeenv.lua");
+}
+
+TEST_CASE("SafeEnvGetfenv")
+{
+    runConformance("safeenv_getfenv.lua");
+}
+
+TEST_CASE("Native")
+{
+    ScopedFastFlag luauCodeGenFixBufferLenCheckA64{DFFlag::LuauCodeGenFixBufferLenCheckA64, true};
+
+    // This tests requires code to run natively, otherwise all 'is_native' checks will fail
+    if (!codegen || !luau_codegen_supported())
+        return;
+
+    runConformance("native.lua", [](lua_State* L) {
+        setupNativeHelpers(L);
+    });
+}
+
+TEST_CASE("NativeTypeAnnotations")
+{
+    // This tests requires code to run natively, otherwise all 'is_native' checks will fail
+    if (!codegen || !luau_codegen_supported())
+        return;
+
+    runConformance("native_types.lua", [](lua_State* L) {
+        setupNativeHelpers(L);
+        setupVectorHelpers(L);
+    });
 }
 
-TEST_CASE("GCDump")
+TEST_CASE("HugeFunction")
 {
-    // internal function, declared in lgc.h - not exposed via lua.h
-    extern void luaC_dump(lua_State * L, void* file, const char* (*categoryName)(lua_State * L, uint8_t memcat));
-    extern void luaC_enumheap(lua_State * L, void* context,
-        void (*node)(void* context, void* ptr, uint8_t tt, uint8_t memcat, size_t size, const char* name),
-        void (*edge)(void* context, void* from, void* to, const char* name));
+    std::string source;
 
-    StateRef globalState(luaL_newstate(), lua_close);
-    lua_State* L = globalState.get();
+    // add non-executed block that requires JUMPKX and generates a lot of constants that take available short (15-bit) constant space
+    source += "if ... then\n";
+    source += "local _ = {\n";
 
-    // push various objects on stack to cover different paths
-    lua_createtable(L, 1, 2);
-    lua_pushstring(L, "value");
-    lua_setfield(L, -2, "key");
+    for (int i = 0; i < 40000; ++i)
+    {
+        source += "0.";
+        source += std::to_string(i);
+        source += ",";
+    }
 
-    lua_pushstring(L, "u42");
-    lua_setfield(L, -2, "__type");
+    source += "}\n";
+    source += "end\n";
 
-    lua_pushinteger(L, 42);
-    lua_rawseti(L, -2, 1000);
+    // use failed fast-calls with imports and constants to exercise all of the more complex fallback sequences
+    source += "return bit32.lshift('84', -1)";
 
-    lua_pushinteger(L, 42);
-    lua_rawseti(L, -2, 1);
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
 
-    lua_pushvalue(L, -1);
-    lua_setmetatable(L, -2);
+    if (codegen && luau_codegen_supported())
+        luau_codegen_create(L);
 
-    lua_newuserdata(L, 42);
-    lua_pushvalue(L, -2);
-    lua_setmetatable(L, -2);
+    luaL_openlibs(L);
+    luaL_sandbox(L);
+    luaL_sandboxthread(L);
 
-    lua_pushinteger(L, 1);
-    lua_pushcclosure(L, lua_silence, "test", 1);
+    size_t bytecodeSize = 0;
+    char* bytecode = luau_compile(source.data(), source.size(), nullptr, &bytecodeSize);
+    int result = luau_load(L, "=HugeFunction", bytecode, bytecodeSize, 0);
+    free(bytecode);
 
-    lua_newbuffer(L, 100);
+    REQUIRE(result == 0);
 
-    lua_State* CL = lua_newthread(L);
+    if (codegen && luau_codegen_supported())
+        Luau::CodeGen::compile(L, -1, Luau::CodeGen::CodeGen_ColdFunctions);
 
-    lua_pushstring(CL, "local x x = {} local function f() x[1] = math.abs(42) end function foo() coroutine.yield() end foo() return f");
-    lua_loadstring(CL);
-    lua_resume(CL, nullptr, 0);
+    int status = lua_resume(L, nullptr, 0);
+    REQUIRE(status == 0);
 
-#ifdef _WIN32
-    const char* path = "NUL";
-#else
-    const char* path = "/dev/null";
-#endif
+    CHECK(lua_tonumber(L, -1) == 42);
+}
 
-    FILE* f = fopen(path, "w");
-    REQUIRE(f);
+TEST_CASE("IrInstructionLimit")
+{
+    if (!codegen || !luau_codegen_supported())
+        return;
 
-    luaC_dump(L, f, nullptr);
+    ScopedFastInt codegenHeuristicsInstructionLimit{FInt::CodegenHeuristicsInstructionLimit, 50'000};
 
-    fclose(f);
+    std::string source;
 
-    struct Node
+    // Generate a hundred fat functions
+    for (int fn = 0; fn < 100; fn++)
     {
-        void* ptr;
-        uint8_t tag;
-        uint8_t memcat;
-        size_t size;
-        std::string name;
-    };
+        source += "local function fn" + std::to_string(fn) + "(...)\n";
+        source += "if ... then\n";
+        source += "local p1, p2 = ...\n";
+        source += "local _ = {\n";
 
-    struct EnumContext
-    {
-        EnumContext()
-            : nodes{nullptr}
-            , edges{nullptr}
+        for (int i = 0; i < 100; ++i)
         {
+            source += "p1*0." + std::to_string(i) + ",";
+            source += "p2+0." + std::to_string(i) + ",";
         }
 
-        Luau::DenseHashMap<void*, Node> nodes;
-        Luau::DenseHashMap<void*, void*> edges;
-    } ctx;
+        source += "}\n";
+        source += "return _\n";
+        source += "end\n";
+        source += "end\n";
+    }
 
-    luaC_enumheap(
-        L, &ctx,
-        [](void* ctx, void* gco, uint8_t tt, uint8_t memcat, size_t size, const char* name) {
-            EnumContext& context = *(EnumContext*)ctx;
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
 
-            if (tt == LUA_TUSERDATA)
-                CHECK(strcmp(name, "u42") == 0);
+    luau_codegen_create(L);
 
-            context.nodes[gco] = {gco, tt, memcat, size, name ? name : ""};
-        },
-        [](void* ctx, void* s, void* t, const char*) {
-            EnumContext& context = *(EnumContext*)ctx;
-            context.edges[s] = t;
-        });
+    luaL_openlibs(L);
+    luaL_sandbox(L);
+    luaL_sandboxthread(L);
 
-    CHECK(!ctx.nodes.empty());
-    CHECK(!ctx.edges.empty());
+    size_t bytecodeSize = 0;
+    char* bytecode = luau_compile(source.data(), source.size(), nullptr, &bytecodeSize);
+    int result = luau_load(L, "=HugeFunction", bytecode, bytecodeSize, 0);
+    free(bytecode);
+
+    REQUIRE(result == 0);
+
+    Luau::CodeGen::CompilationStats nativeStats = {};
+    Luau::CodeGen::CodeGenCompilationResult nativeResult = Luau::CodeGen::compile(L, -1, Luau::CodeGen::CodeGen_ColdFunctions, &nativeStats);
+
+    // Limit is not hit immediately, so with some functions compiled it should be a success
+    CHECK(nativeResult == Luau::CodeGen::CodeGenCompilationResult::CodeGenOverflowInstructionLimit);
+
+    // We should be able to compile at least one of our functions
+    CHECK(nativeStats.functionsCompiled > 0);
+
+    // But because of the limit, not all of them (101 because there's an extra global function)
+    CHECK(nativeStats.functionsCompiled < 101);
 }
 
-TEST_CASE("Interrupt")
+TEST_CASE("NativeCodeCache")
 {
-    lua_CompileOptions copts = defaultOptions();
-    copts.optimizationLevel = 1; // disable loop unrolling to get fixed expected hit results
+    if (!codegen || !luau_codegen_supported())
+        return;
 
-    static int index;
+    const char* source = R"(
+local function sum(t)
+    local r = 0
+    for i, v in t do r += v * 2 end
+    return r, is_native()
+end
 
-    StateRef globalState = runConformance("interrupt.lua", nullptr, nullptr, nullptr, &copts);
+local t = {}
+for i = 1, 100 do t[i] = i end
 
-    lua_State* L = globalState.get();
+local r, native = sum(t)
+return `{r} {native} {is_native()}`
+)";
 
-    // note: for simplicity here we setup the interrupt callback when the test starts
-    // however, this carries a noticeable performance cost. in a real application,
-    // it's advised to set interrupt callback on a timer from a different thread,
-    // and set it back to nullptr once the interrupt triggered.
+    size_t bytecodeSize = 0;
+    char* bytecode = luau_compile(source, strlen(source), nullptr, &bytecodeSize);
+    std::string bytecodeCopy(bytecode, bytecodeSize);
+    free(bytecode);
 
-    // define the interrupt to check the expected hits
-    static const int expectedhits[] = {11, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 8, 20, 15, 15, 15, 15, 18, 25, 23, 26};
+    auto run = [&](const std::string& bytecode, std::string* cacheOut, const std::string* cacheIn) -> std::string {
+        StateRef globalState(luaL_newstate(), lua_close);
+        lua_State* L = globalState.get();
 
-    lua_callbacks(L)->interrupt = [](lua_State* L, int gc) {
-        if (gc >= 0)
-            return;
+        luau_codegen_create(L);
 
-        CHECK(index < int(std::size(expectedhits)));
+        luaL_openlibs(L);
+        setupNativeHelpers(L);
+        luaL_sandbox(L);
+        luaL_sandboxthread(L);
 
-        lua_Debug ar = {};
-        lua_getinfo(L, 0, "l", &ar);
+        REQUIRE(luau_load(L, "=NativeCodeCache", bytecode.data(), bytecode.size(), 0) == 0);
 
-        CHECK(ar.currentline == expectedhits[index]);
+        if (cacheOut)
+            CHECK(Luau::CodeGen::compileToCache(L, -1, *cacheOut, Luau::CodeGen::CodeGen_ColdFunctions) ==
+                  Luau::CodeGen::CodeGenCompilationResult::Success);
 
-        index++;
+        if (cacheIn)
+            CHECK(Luau::CodeGen::loadFromCache(L, -1, cacheIn->data(), cacheIn->size()) == Luau::CodeGen::CodeGenCompilationResult::Success);
 
-        // check that we can yield inside an interrupt
-        if (index == 4)
-            lua_yield(L, 0);
+        REQUIRE(lua_pcall(L, 0, 1, 0) == 0);
+        return lua_tostring(L, -1);
     };
 
+    std::string cache;
+    CHECK(run(bytecodeCopy, &cache, nullptr) == "10100 true true");
+    CHECK(!cache.empty());
+
+    // Loading the cache runs the same native code without compiling it
+    CHECK(run(bytecodeCopy, nullptr, &cache) == "10100 true true");
+
+    // Cache doesn't apply to different bytecode or truncated data
     {
-        lua_State* T = lua_newthread(L);
+        StateRef globalState(luaL_newstate(), lua_close);
+        lua_State* L = globalState.get();
 
-        lua_getglobal(T, "test");
+        luau_codegen_create(L);
 
-        index = 0;
-        int status = lua_resume(T, nullptr, 0);
-        CHECK(status == LUA_YIELD);
-        CHECK(index == 4);
+        size_t otherSize = 0;
+        char* other = luau_compile("return 1", 8, nullptr, &otherSize);
+        REQUIRE(luau_load(L, "=NativeCodeCache", other, otherSize, 0) == 0);
+        free(other);
 
-        status = lua_resume(T, nullptr, 0);
-        CHECK(status == LUA_OK);
-        CHECK(index == int(std::size(expectedhits)));
+        CHECK(Luau::CodeGen::loadFromCache(L, -1, cache.data(), cache.size()) == Luau::CodeGen::CodeGenCompilationResult::CodeGenCacheMismatch);
 
-        lua_pop(L, 1);
+        REQUIRE(luau_load(L, "=NativeCodeCache", bytecodeCopy.data(), bytecodeCopy.size(), 0) == 0);
+        CHECK(Luau::CodeGen::loadFromCache(L, -1, cache.data(), cache.size() / 2) == Luau::CodeGen::CodeGenCompilationResult::CodeGenCacheMismatch);
+        CHECK(Luau::CodeGen::loadFromCache(L, -1, cache.data(), cache.size()) == Luau::CodeGen::CodeGenCompilationResult::Success);
+        CHECK(Luau::CodeGen::loadFromCache(L, -1, cache.data(), cache.size()) == Luau::CodeGen::CodeGenCompilationResult::NothingToCompile);
     }
+}
 
-    // redefine the interrupt to break after 10 iterations of a loop that would otherwise be infinite
-    // the test exposes a few global functions that we will call; the interrupt will force a yield
-    lua_callbacks(L)->interrupt = [](lua_State* L, int gc) {
-        if (gc >= 0)
-            return;
-
-        CHECK(index < 11);
-        if (++index == 11)
-            lua_yield(L, 0);
-    };
+TEST_CASE("NativeAsyncCompile")
+{
+    if (!codegen || !luau_codegen_supported())
+        return;
 
-    for (int test = 1; test <= 10; ++test)
-    {
-        lua_State* T = lua_newthread(L);
+    const char* source = R"(
+local function check()
+    return is_native()
+end
 
-        std::string name = "infloop" + std::to_string(test);
-        lua_getglobal(T, name.c_str());
+return check
+)";
 
-        index = 0;
-        int status = lua_resume(T, nullptr, 0);
-        CHECK(status == LUA_YIELD);
-        CHECK(index == 11);
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
 
-        // abandon the thread
-        lua_pop(L, 1);
-    }
+    luau_codegen_create(L);
 
-    lua_callbacks(L)->interrupt = [](lua_State* L, int gc) {
-        if (gc >= 0)
-            return;
+    luaL_openlibs(L);
+    setupNativeHelpers(L);
+    luaL_sandbox(L);
+    luaL_sandboxthread(L);
 
-        index++;
+    size_t bytecodeSize = 0;
+    char* bytecode = luau_compile(source, strlen(source), nullptr, &bytecodeSize);
+    int result = luau_load(L, "=NativeAsyncCompile", bytecode, bytecodeSize, 0);
+    free(bytecode);
 
-        if (index == 1'000)
-        {
-            index = 0;
-            luaL_error(L, "timeout");
-        }
-    };
+    REQUIRE(result == 0);
 
-    ScopedFastFlag luauInterruptablePatternMatch{DFFlag::LuauInterruptablePatternMatch, true};
+    std::vector<std::function<void()>> tasks;
 
-    for (int test = 1; test <= 5; ++test)
-    {
-        lua_State* T = lua_newthread(L);
+    CHECK(Luau::CodeGen::compileAsync(
+              L, -1,
+              [&](std::function<void()> task) {
+                  tasks.push_back(std::move(task));
+              },
+              Luau::CodeGen::CodeGen_ColdFunctions) == Luau::CodeGen::CodeGenCompilationResult::Success);
 
-        std::string name = "strhang" + std::to_string(test);
-        lua_getglobal(T, name.c_str());
+    REQUIRE(tasks.size() == 1);
 
-        index = 0;
-        int status = lua_resume(T, nullptr, 0);
-        CHECK(status == LUA_ERRRUN);
+    REQUIRE(lua_pcall(L, 0, 1, 0) == 0);
 
+    auto callCheck = [&]() {
+        lua_pushvalue(L, -1);
+        REQUIRE(lua_pcall(L, 0, 1, 0) == 0);
+        bool native = lua_toboolean(L, -1);
         lua_pop(L, 1);
-    }
+        return native;
+    };
 
-    {
-        lua_State* T = lua_newthread(L);
+    // Nothing is installed until the task finishes
+    CHECK(Luau::CodeGen::installAsyncCompilations(L) == 0);
+    CHECK(!callCheck());
+
+    tasks[0]();
+
+    CHECK(!callCheck());
+    CHECK(Luau::CodeGen::installAsyncCompilations(L) == 1);
+    CHECK(callCheck());
+
+    // Functions that already have native code are not compiled again
+    CHECK(Luau::CodeGen::compileAsync(L, -1, {}, Luau::CodeGen::CodeGen_ColdFunctions) == Luau::CodeGen::CodeGenCompilationResult::NothingToCompile);
+    CHECK(Luau::CodeGen::installAsyncCompilations(L, /* wait= */ true) == 0);
+
+    // Task that runs after the VM is closed doesn't access the functions
+    tasks.clear();
 
-        lua_getglobal(T, "strhangpcall");
+    bytecode = luau_compile(source, strlen(source), nullptr, &bytecodeSize);
+    REQUIRE(luau_load(L, "=NativeAsyncCompile", bytecode, bytecodeSize, 0) == 0);
+    free(bytecode);
 
-        index = 0;
-        int status = lua_resume(T, nullptr, 0);
-        CHECK(status == LUA_OK);
+    CHECK(Luau::CodeGen::compileAsync(
+              L, -1,
+              [&](std::function<void()> task) {
+                  tasks.push_back(std::move(task));
+              },
+              Luau::CodeGen::CodeGen_ColdFunctions) == Luau::CodeGen::CodeGenCompilationResult::Success);
 
-        lua_pop(L, 1);
-    }
+    globalState.reset();
+
+    REQUIRE(tasks.size() == 1);
+    tasks[0]();
 }
 
-TEST_CASE("UserdataApi")
+TEST_CASE("NativeTiered")
 {
-    static int dtorhits = 0;
+    if (!codegen || !luau_codegen_supported())
+        return;
 
-    dtorhits = 0;
+    ScopedFastInt codegenTieredThreshold{FInt::CodegenTieredThreshold, 10};
 
-    StateRef globalState(luaL_newstate(), lua_close);
-    lua_State* L = globalState.get();
+    const char* source = R"(
+local function called()
+    return is_native()
+end
 
-    // setup dtor for tag 42 (created later)
-    auto dtor = [](lua_State* l, void* data) {
-        dtorhits += *(int*)data;
-    };
-    bool dtorIsNull = lua_getuserdatadtor(L, 42) == nullptr;
-    CHECK(dtorIsNull);
-    lua_setuserdatadtor(L, 42, dtor);
-    bool dtorIsSet = lua_getuserdatadtor(L, 42) == dtor;
-    CHECK(dtorIsSet);
+local function looping(n)
+    local r = 0
+    for i = 1, n do r += i end
+    return is_native()
+end
 
-    // light user data
-    int lud;
-    lua_pushlightuserdata(L, &lud);
+local result = {}
 
-    CHECK(lua_tolightuserdata(L, -1) == &lud);
-    CHECK(lua_touserdata(L, -1) == &lud);
-    CHECK(lua_topointer(L, -1) == &lud);
+for i = 1, 12 do
+    table.insert(result, if called() then "y" else "n")
+end
 
-    // regular user data
-    int* ud1 = (int*)lua_newuserdata(L, 4);
-    *ud1 = 42;
+table.insert(result, " ")
+table.insert(result, if looping(100) then "y" else "n")
+table.insert(result, if looping(1) then "y" else "n")
 
-    CHECK(lua_tolightuserdata(L, -1) == nullptr);
-    CHECK(lua_touserdata(L, -1) == ud1);
-    CHECK(lua_topointer(L, -1) == ud1);
+table.insert(result, " ")
+table.insert(result, if is_native() then "y" else "n")
 
-    // tagged user data
-    int* ud2 = (int*)lua_newuserdatatagged(L, 4, 42);
-    *ud2 = -4;
+return table.concat(result)
+)";
 
-    CHECK(lua_touserdatatagged(L, -1, 42) == ud2);
-    CHECK(lua_touserdatatagged(L, -1, 41) == nullptr);
-    CHECK(lua_userdatatag(L, -1) == 42);
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
 
-    lua_setuserdatatag(L, -1, 43);
-    CHECK(lua_userdatatag(L, -1) == 43);
-    lua_setuserdatatag(L, -1, 42);
+    luau_codegen_create(L);
 
-    // user data with inline dtor
-    void* ud3 = lua_newuserdatadtor(L, 4, [](void* data) {
-        dtorhits += *(int*)data;
-    });
+    luaL_openlibs(L);
+    setupNativeHelpers(L);
+    luaL_sandbox(L);
+    luaL_sandboxthread(L);
 
-    void* ud4 = lua_newuserdatadtor(L, 1, [](void* data) {
-        dtorhits += *(char*)data;
-    });
+    size_t bytecodeSize = 0;
+    char* bytecode = luau_compile(source, strlen(source), nullptr, &bytecodeSize);
+    int result = luau_load(L, "=NativeTiered", bytecode, bytecodeSize, 0);
+    free(bytecode);
 
-    *(int*)ud3 = 43;
-    *(char*)ud4 = 3;
+    REQUIRE(result == 0);
 
-    // user data with named metatable
-    luaL_newmetatable(L, "udata1");
-    luaL_newmetatable(L, "udata2");
+    Luau::CodeGen::CompilationStats nativeStats = {};
+    CHECK(Luau::CodeGen::compile(L, -1, Luau::CodeGen::CodeGen_ColdFunctions | Luau::CodeGen::CodeGen_Tiered, &nativeStats) ==
+          Luau::CodeGen::CodeGenCompilationResult::Success);
+    CHECK(nativeStats.functionsTotal == 3);
+    CHECK(nativeStats.functionsCompiled == 0);
 
-    void* ud5 = lua_newuserdata(L, 0);
-    lua_getfield(L, LUA_REGISTRYINDEX, "udata1");
-    lua_setmetatable(L, -2);
+    REQUIRE(lua_pcall(L, 0, 1, 0) == 0);
 
-    void* ud6 = lua_newuserdata(L, 0);
-    lua_getfield(L, LUA_REGISTRYINDEX, "udata2");
-    lua_setmetatable(L, -2);
+    // Functions are compiled on the 10th call or loop iteration; a call compiles before entering, a loop continues in the VM
+    // Main function runs its loop 12 times and becomes hot, but stays in the VM until it's called again
+    CHECK(std::string(lua_tostring(L, -1)) == "nnnnnnnnnyyy ny n");
+}
 
-    CHECK(luaL_checkudata(L, -2, "udata1") == ud5);
-    CHECK(luaL_checkudata(L, -1, "udata2") == ud6);
+TEST_CASE("NativeTieredArgumentTypes")
+{
+    if (!codegen || !luau_codegen_supported())
+        return;
 
-    globalState.reset();
+    ScopedFastInt codegenTieredThreshold{FInt::CodegenTieredThreshold, 10};
 
-    CHECK(dtorhits == 42);
-}
+    const char* source = R"(
+local function add(a, b)
+    return a + b, is_native()
+end
 
-TEST_CASE("LightuserdataApi")
-{
-    ScopedFastFlag luauTaggedLuData{FFlag::LuauTaggedLuData, true};
+local function concat(a, b)
+    return a .. b, is_native()
+end
 
-    StateRef globalState(luaL_newstate(), lua_close);
-    lua_State* L = globalState.get();
+for i = 1, 10 do
+    assert(add(i, 1) == i + 1)
+    assert(concat(i, "") == tostring(i))
+    assert(concat("", i) == tostring(i))
+end
 
-    void* value = (void*)0x12345678;
+local r, native = add(1, 2)
+assert(r == 3 and native)
 
-    lua_pushlightuserdatatagged(L, value, 1);
-    CHECK(lua_lightuserdatatag(L, -1) == 1);
-    CHECK(lua_tolightuserdatatagged(L, -1, 0) == nullptr);
-    CHECK(lua_tolightuserdatatagged(L, -1, 1) == value);
+-- function is specialized for observed number arguments, so other types run in the VM
+r, native = add("1", "2")
+assert(r == 3 and not native)
 
-    lua_setlightuserdataname(L, 1, "id");
-    CHECK(!lua_getlightuserdataname(L, 0));
-    CHECK(strcmp(lua_getlightuserdataname(L, 1), "id") == 0);
-    CHECK(strcmp(luaL_typename(L, -1), "id") == 0);
-    lua_pop(L, 1);
+-- arguments that had different types are not specialized
+r, native = concat({} and "a", 1)
+assert(r == "a1" and native)
 
-    lua_pushlightuserdatatagged(L, value, 0);
-    lua_pushlightuserdatatagged(L, value, 1);
-    CHECK(lua_rawequal(L, -1, -2) == 0);
-    lua_pop(L, 2);
+return "OK"
+)";
 
-    // Check lightuserdata table key uniqueness
-    lua_newtable(L);
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
 
-    lua_pushlightuserdatatagged(L, value, 2);
-    lua_pushinteger(L, 20);
-    lua_settable(L, -3);
-    lua_pushlightuserdatatagged(L, value, 3);
-    lua_pushinteger(L, 30);
-    lua_settable(L, -3);
+    luau_codegen_create(L);
 
-    lua_pushlightuserdatatagged(L, value, 2);
-    lua_gettable(L, -2);
-    lua_pushinteger(L, 20);
-    CHECK(lua_rawequal(L, -1, -2) == 1);
-    lua_pop(L, 2);
+    luaL_openlibs(L);
+    setupNativeHelpers(L);
+    luaL_sandbox(L);
+    luaL_sandboxthread(L);
 
-    lua_pushlightuserdatatagged(L, value, 3);
-    lua_gettable(L, -2);
-    lua_pushinteger(L, 30);
-    CHECK(lua_rawequal(L, -1, -2) == 1);
-    lua_pop(L, 2);
+    size_t bytecodeSize = 0;
+    char* bytecode = luau_compile(source, strlen(source), nullptr, &bytecodeSize);
+    int result = luau_load(L, "=NativeTieredArgumentTypes", bytecode, bytecodeSize, 0);
+    free(bytecode);
 
-    lua_pop(L, 1);
+    REQUIRE(result == 0);
 
-    globalState.reset();
+    CHECK(Luau::CodeGen::compile(L, -1, Luau::CodeGen::CodeGen_ColdFunctions | Luau::CodeGen::CodeGen_Tiered) ==
+          Luau::CodeGen::CodeGenCompilationResult::Success);
+
+    REQUIRE(lua_pcall(L, 0, 1, 0) == 0);
+    CHECK(std::string(lua_tostring(L, -1)) == "OK");
 }
 
-TEST_CASE("Iter")
+TEST_CASE("NativeTieredSpeculationMiss")
 {
-    runConformance("iter.lua");
-}
+    if (!codegen || !luau_codegen_supported())
+        return;
 
-const int kInt64Tag = 1;
-static int gInt64MT = -1;
+    ScopedFastInt codegenTieredThreshold{FInt::CodegenTieredThreshold, 10};
+    ScopedFastInt codegenSpeculationMissLimit{FInt::CodegenSpeculationMissLimit, 5};
 
-static int64_t getInt64(lua_State* L, int idx)
-{
-    if (void* p = lua_touserdatatagged(L, idx, kInt64Tag))
-        return *static_cast<int64_t*>(p);
+    const char* source = R"(
+local function add(a, b)
+    return a + b, is_native()
+end
 
-    if (lua_isnumber(L, idx))
-        return lua_tointeger(L, idx);
+for i = 1, 10 do
+    assert(add(i, 1) == i + 1)
+end
 
-    luaL_typeerror(L, 1, "int64");
-}
+local result = {}
 
-static void pushInt64(lua_State* L, int64_t value)
-{
-    void* p = lua_newuserdatatagged(L, sizeof(int64_t), kInt64Tag);
+for i = 1, 7 do
+    local r, native = add(tostring(i), "1")
+    assert(r == i + 1)
+    table.insert(result, if native then "y" else "n")
+end
 
-    lua_getref(L, gInt64MT);
-    lua_setmetatable(L, -2);
+-- generic code still handles the types the function was specialized for
+local r, native = add(1, 2)
+assert(r == 3 and native)
 
-    *static_cast<int64_t*>(p) = value;
-}
+return table.concat(result)
+)";
 
-TEST_CASE("Userdata")
-{
-    runConformance("userdata.lua", [](lua_State* L) {
-        // create metatable with all the metamethods
-        lua_newtable(L);
-        gInt64MT = lua_ref(L, -1);
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
 
-        // __index
-        lua_pushcfunction(
-            L,
-            [](lua_State* L) {
-                void* p = lua_touserdatatagged(L, 1, kInt64Tag);
-                if (!p)
-                    luaL_typeerror(L, 1, "int64");
+    luau_codegen_create(L);
 
-                const char* name = luaL_checkstring(L, 2);
+    luaL_openlibs(L);
+    setupNativeHelpers(L);
+    luaL_sandbox(L);
+    luaL_sandboxthread(L);
 
-                if (strcmp(name, "value") == 0)
-                {
-                    lua_pushnumber(L, double(*static_cast<int64_t*>(p)));
-                    return 1;
-                }
+    size_t bytecodeSize = 0;
+    char* bytecode = luau_compile(source, strlen(source), nullptr, &bytecodeSize);
+    int result = luau_load(L, "=NativeTieredSpeculationMiss", bytecode, bytecodeSize, 0);
+    free(bytecode);
 
-                luaL_error(L, "unknown field %s", name);
-            },
-            nullptr);
-        lua_setfield(L, -2, "__index");
+    REQUIRE(result == 0);
 
-        // __newindex
-        lua_pushcfunction(
-            L,
-            [](lua_State* L) {
-                void* p = lua_touserdatatagged(L, 1, kInt64Tag);
-                if (!p)
-                    luaL_typeerror(L, 1, "int64");
+    CHECK(Luau::CodeGen::compile(L, -1, Luau::CodeGen::CodeGen_ColdFunctions | Luau::CodeGen::CodeGen_Tiered) ==
+          Luau::CodeGen::CodeGenCompilationResult::Success);
 
-                const char* name = luaL_checkstring(L, 2);
+    REQUIRE(lua_pcall(L, 0, 1, 0) == 0);
 
-                if (strcmp(name, "value") == 0)
-                {
-                    double value = luaL_checknumber(L, 3);
-                    *static_cast<int64_t*>(p) = int64_t(value);
-                    return 0;
-                }
+    // Fifth call that fails the entry guard recompiles the function without specialization, but still finishes in the VM
+    CHECK(std::string(lua_tostring(L, -1)) == "nnnnnyy");
+}
 
-                luaL_error(L, "unknown field %s", name);
-            },
-            nullptr);
-        lua_setfield(L, -2, "__newindex");
+TEST_CASE("ReloadReusesUnchangedFunctions")
+{
+    const char* source1 = R"(
+local M = {}
 
-        // __eq
-        lua_pushcfunction(
-            L,
-            [](lua_State* L) {
-                lua_pushboolean(L, getInt64(L, 1) == getInt64(L, 2));
-                return 1;
-            },
-            nullptr);
-        lua_setfield(L, -2, "__eq");
+function M.add(a, b)
+    return a + b, is_native()
+end
 
-        // __lt
-        lua_pushcfunction(
-            L,
-            [](lua_State* L) {
-                lua_pushboolean(L, getInt64(L, 1) < getInt64(L, 2));
-                return 1;
-            },
-            nullptr);
-        lua_setfield(L, -2, "__lt");
+function M.mul(a, b)
+    return a * b, is_native()
+end
 
-        // __le
-        lua_pushcfunction(
-            L,
-            [](lua_State* L) {
-                lua_pushboolean(L, getInt64(L, 1) <= getInt64(L, 2));
-                return 1;
-            },
-            nullptr);
-        lua_setfield(L, -2, "__le");
+function M.line()
+    return debug.info(1, "l")
+end
+
+return M
+)";
+
+    // an added line moves the unchanged functions down and mul is changed
+    const char* source2 = R"(
+local M = {}
+-- comment
+
+function M.add(a, b)
+    return a + b, is_native()
+end
 
-        // __add
-        lua_pushcfunction(
-            L,
-            [](lua_State* L) {
-                pushInt64(L, getInt64(L, 1) + getInt64(L, 2));
-                return 1;
-            },
-            nullptr);
-        lua_setfield(L, -2, "__add");
+function M.mul(a, b)
+    return a * b * 1, is_native()
+end
 
-        // __sub
-        lua_pushcfunction(
-            L,
-            [](lua_State* L) {
-                pushInt64(L, getInt64(L, 1) - getInt64(L, 2));
-                return 1;
-            },
-            nullptr);
-        lua_setfield(L, -2, "__sub");
+function M.line()
+    return debug.info(1, "l")
+end
 
-        // __mul
-        lua_pushcfunction(
-            L,
-            [](lua_State* L) {
-                pushInt64(L, getInt64(L, 1) * getInt64(L, 2));
-                return 1;
-            },
-            nullptr);
-        lua_setfield(L, -2, "__mul");
+return M
+)";
 
-        // __div
-        lua_pushcfunction(
-            L,
-            [](lua_State* L) {
-                // ideally we'd guard against 0 but it's a test so eh
-                pushInt64(L, getInt64(L, 1) / getInt64(L, 2));
-                return 1;
-            },
-            nullptr);
-        lua_setfield(L, -2, "__div");
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
 
-        // __idiv
-        lua_pushcfunction(
-            L,
-            [](lua_State* L) {
-                // for testing we use different semantics here compared to __div: __idiv rounds to negative inf, __div truncates (rounds to zero)
-                // additionally, division loses precision here outside of 2^53 range
-                // we do not necessarily recommend this behavior in production code!
-                pushInt64(L, int64_t(floor(double(getInt64(L, 1)) / double(getInt64(L, 2)))));
-                return 1;
-            },
-            nullptr);
-        lua_setfield(L, -2, "__idiv");
+    bool native = codegen && luau_codegen_supported();
 
-        // __mod
-        lua_pushcfunction(
-            L,
-            [](lua_State* L) {
-                // ideally we'd guard against 0 and INT64_MIN but it's a test so eh
-                pushInt64(L, getInt64(L, 1) % getInt64(L, 2));
-                return 1;
-            },
-            nullptr);
-        lua_setfield(L, -2, "__mod");
+    if (native)
+        luau_codegen_create(L);
 
-        // __pow
-        lua_pushcfunction(
-            L,
-            [](lua_State* L) {
-                pushInt64(L, int64_t(pow(double(getInt64(L, 1)), double(getInt64(L, 2)))));
-                return 1;
-            },
-            nullptr);
-        lua_setfield(L, -2, "__pow");
+    luaL_openlibs(L);
+    setupNativeHelpers(L);
+    luaL_sandbox(L);
+    luaL_sandboxthread(L);
 
-        // __unm
-        lua_pushcfunction(
-            L,
-            [](lua_State* L) {
-                pushInt64(L, -getInt64(L, 1));
-                return 1;
-            },
-            nullptr);
-        lua_setfield(L, -2, "__unm");
+    size_t bytecodeSize = 0;
+    char* bytecode = luau_compile(source1, strlen(source1), nullptr, &bytecodeSize);
+    REQUIRE(luau_load(L, "=Reload", bytecode, bytecodeSize, 0) == 0);
+    free(bytecode);
 
-        // __tostring
-        lua_pushcfunction(
-            L,
-            [](lua_State* L) {
-                int64_t value = getInt64(L, 1);
-                std::string str = std::to_string(value);
-                lua_pushlstring(L, str.c_str(), str.length());
-                return 1;
-            },
-            nullptr);
-        lua_setfield(L, -2, "__tostring");
+    if (native)
+        luau_codegen_compile(L, -1);
 
-        // ctor
-        lua_pushcfunction(
-            L,
-            [](lua_State* L) {
-                double v = luaL_checknumber(L, 1);
-                pushInt64(L, int64_t(v));
-                return 1;
-            },
-            "int64");
-        lua_setglobal(L, "int64");
-    });
-}
+    bytecode = luau_compile(source2, strlen(source2), nullptr, &bytecodeSize);
+    REQUIRE(luau_reload(L, "=Reload", bytecode, bytecodeSize, 0, -1) == 0);
+    free(bytecode);
 
-TEST_CASE("SafeEnv")
-{
-    runConformance("safeenv.lua");
-}
+    REQUIRE(lua_pcall(L, 0, 1, 0) == 0);
 
-TEST_CASE("Native")
-{
-    ScopedFastFlag luauCodeGenFixBufferLenCheckA64{DFFlag::LuauCodeGenFixBufferLenCheckA64, true};
+    auto call = [&](const char* name) {
+        lua_getfield(L, -1, name);
+        lua_pushnumber(L, 2);
+        lua_pushnumber(L, 3);
+        REQUIRE(lua_pcall(L, 2, 2, 0) == 0);
 
-    // This tests requires code to run natively, otherwise all 'is_native' checks will fail
-    if (!codegen || !luau_codegen_supported())
-        return;
+        std::pair<int, bool> result = {int(lua_tonumber(L, -2)), lua_toboolean(L, -1) != 0};
+        lua_pop(L, 2);
+        return result;
+    };
 
-    runConformance("native.lua", [](lua_State* L) {
-        setupNativeHelpers(L);
-    });
+    // unchanged function keeps its native code, changed one has to be compiled again
+    CHECK(call("add") == std::make_pair(5, native));
+    CHECK(call("mul") == std::make_pair(6, false));
+
+    // line information of the reused function describes the new source
+    lua_getfield(L, -1, "line");
+    REQUIRE(lua_pcall(L, 0, 1, 0) == 0);
+    CHECK(lua_tointeger(L, -1) == 14);
 }
 
-TEST_CASE("NativeTypeAnnotations")
+TEST_CASE("NativeCodeEviction")
 {
-    // This tests requires code to run natively, otherwise all 'is_native' checks will fail
     if (!codegen || !luau_codegen_supported())
         return;
 
-    runConformance("native_types.lua", [](lua_State* L) {
-        setupNativeHelpers(L);
-        setupVectorHelpers(L);
-    });
-}
+    // Small executable memory limit only fits a few dozen modules
+    ScopedFastInt luauCodeGenBlockSize{FInt::LuauCodeGenBlockSize, 64 * 1024};
+    ScopedFastInt luauCodeGenMaxTotalSize{FInt::LuauCodeGenMaxTotalSize, 128 * 1024};
 
-TEST_CASE("HugeFunction")
-{
-    std::string source;
+    const char* source = R"(
+return function(x)
+    return x * 2, is_native()
+end
+)";
 
-    // add non-executed block that requires JUMPKX and generates a lot of constants that take available short (15-bit) constant space
-    source += "if ... then\n";
-    source += "local _ = {\n";
+    StateRef globalState(luaL_newstate(), lua_close);
+    lua_State* L = globalState.get();
 
-    for (int i = 0; i < 40000; ++i)
+    luau_codegen_create(L);
+
+    luaL_openlibs(L);
+    setupNativeHelpers(L);
+    luaL_sandbox(L);
+    luaL_sandboxthread(L);
+
+    size_t bytecodeSize = 0;
+    char* bytecode = luau_compile(source, strlen(source), nullptr, &bytecodeSize);
+
+    auto call = [L](int index) {
+        lua_rawgeti(L, -1, index);
+        lua_pushnumber(L, 21);
+        lua_call(L, 1, 2);
+
+        CHECK(lua_tonumber(L, -2) == 42);
+        bool native = lua_toboolean(L, -1);
+
+        lua_pop(L, 2);
+        return native;
+    };
+
+    // Functions that are destroyed release their native code
+    for (int i = 0; i < 100; i++)
     {
-        source += "0.";
-        source += std::to_string(i);
-        source += ",";
+        REQUIRE(luau_load(L, "=NativeCodeEviction", bytecode, bytecodeSize, 0) == 0);
+        CHECK(Luau::CodeGen::compile(L, -1, Luau::CodeGen::CodeGen_ColdFunctions) == Luau::CodeGen::CodeGenCompilationResult::Success);
+        lua_pop(L, 1);
+
+        lua_gc(L, LUA_GCCOLLECT, 0);
     }
 
-    source += "}\n";
-    source += "end\n";
+    // Functions that are kept alive are evicted back to bytecode from the oldest one
+    lua_newtable(L);
 
-    // use failed fast-calls with imports and constants to exercise all of the more complex fallback sequences
-    source += "return bit32.lshift('84', -1)";
+    for (int i = 1; i <= 100; i++)
+    {
+        REQUIRE(luau_load(L, "=NativeCodeEviction", bytecode, bytecodeSize, 0) == 0);
+        CHECK(Luau::CodeGen::compile(L, -1, Luau::CodeGen::CodeGen_ColdFunctions) == Luau::CodeGen::CodeGenCompilationResult::Success);
+
+        REQUIRE(lua_pcall(L, 0, 1, 0) == 0);
+        lua_rawseti(L, -2, i);
+    }
+
+    free(bytecode);
+
+    CHECK(!call(1));
+    CHECK(call(100));
+}
+
+TEST_CASE("NativeProfile")
+{
+    if (!codegen || !luau_codegen_supported())
+        return;
+
+    const char* source = R"(
+local function add(a, b)
+    return a + b
+end
+
+local function loop(n)
+    local r = 0
+    for i = 1, n do
+        r = add(r, i)
+    end
+    return r
+end
+
+return loop(10)
+)";
 
     StateRef globalState(luaL_newstate(), lua_close);
     lua_State* L = globalState.get();
 
-    if (codegen && luau_codegen_supported())
-        luau_codegen_create(L);
+    luau_codegen_create(L);
 
     luaL_openlibs(L);
     luaL_sandbox(L);
     luaL_sandboxthread(L);
 
     size_t bytecodeSize = 0;
-    char* bytecode = luau_compile(source.data(), source.size(), nullptr, &bytecodeSize);
-    int result = luau_load(L, "=HugeFunction", bytecode, bytecodeSize, 0);
+    char* bytecode = luau_compile(source, strlen(source), nullptr, &bytecodeSize);
+    int result = luau_load(L, "=NativeProfile", bytecode, bytecodeSize, 0);
     free(bytecode);
 
     REQUIRE(result == 0);
 
-    if (codegen && luau_codegen_supported())
-        Luau::CodeGen::compile(L, -1, Luau::CodeGen::CodeGen_ColdFunctions);
+    CHECK(Luau::CodeGen::compile(L, -1, Luau::CodeGen::CodeGen_ColdFunctions | Luau::CodeGen::CodeGen_Profile) ==
+          Luau::CodeGen::CodeGenCompilationResult::Success);
 
-    int status = lua_resume(L, nullptr, 0);
-    REQUIRE(status == 0);
+    lua_pushvalue(L, -1);
+    REQUIRE(lua_pcall(L, 0, 1, 0) == 0);
+    CHECK(lua_tointeger(L, -1) == 55);
+    lua_pop(L, 1);
 
-    CHECK(lua_tonumber(L, -1) == 42);
+    std::vector<Luau::CodeGen::FunctionProfile> profiles = Luau::CodeGen::getFunctionProfiles(L, -1);
+    REQUIRE(profiles.size() == 3);
+
+    CHECK(profiles[0].name == "add");
+    CHECK(profiles[0].line == 2);
+    CHECK(profiles[0].entries == 10);
+
+    CHECK(profiles[1].name == "loop");
+    CHECK(profiles[1].line == 6);
+    CHECK(profiles[1].entries == 1);
+
+    // Loop body is executed on each iteration
+    auto body = std::find_if(profiles[1].blocks.begin(), profiles[1].blocks.end(), [](const Luau::CodeGen::BlockProfile& block) {
+        return block.line == 9;
+    });
+    REQUIRE(body != profiles[1].blocks.end());
+    CHECK(body->executions == 10);
+
+    CHECK(profiles[2].name == "");
+    CHECK(profiles[2].entries == 1);
 }
 
-TEST_CASE("IrInstructionLimit")
+TEST_CASE("NativeBreakpointRestore")
 {
     if (!codegen || !luau_codegen_supported())
         return;
 
-    ScopedFastInt codegenHeuristicsInstructionLimit{FInt::CodegenHeuristicsInstructionLimit, 50'000};
-
-    std::string source;
-
-    // Generate a hundred fat functions
-    for (int fn = 0; fn < 100; fn++)
-    {
-        source += "local function fn" + std::to_string(fn) + "(...)\n";
-        source += "if ... then\n";
-        source += "local p1, p2 = ...\n";
-        source += "local _ = {\n";
+    ScopedFastFlag disableNativeCodegenIfBreakpointIsSet{FFlag::DisableNativeCodegenIfBreakpointIsSet, true};
 
-        for (int i = 0; i < 100; ++i)
-        {
-            source += "p1*0." + std::to_string(i) + ",";
-            source += "p2+0." + std::to_string(i) + ",";
-        }
+    const char* source = R"(
+local function f()
+    return is_native()
+end
 
-        source += "}\n";
-        source += "return _\n";
-        source += "end\n";
-        source += "end\n";
-    }
+return f
+)";
 
     StateRef globalState(luaL_newstate(), lua_close);
     lua_State* L = globalState.get();
@@ -2144,27 +5572,50 @@ TEST_CASE("IrInstructionLimit")
     luau_codegen_create(L);
 
     luaL_openlibs(L);
+
+    lua_pushcfunction(
+        L,
+        [](lua_State* L) -> int {
+            extern int luaG_isnative(lua_State * L, int level);
+
+            lua_pushboolean(L, luaG_isnative(L, 1));
+            return 1;
+        },
+        "is_native");
+    lua_setglobal(L, "is_native");
+
     luaL_sandbox(L);
     luaL_sandboxthread(L);
 
     size_t bytecodeSize = 0;
-    char* bytecode = luau_compile(source.data(), source.size(), nullptr, &bytecodeSize);
-    int result = luau_load(L, "=HugeFunction", bytecode, bytecodeSize, 0);
+    char* bytecode = luau_compile(source, strlen(source), nullptr, &bytecodeSize);
+    int result = luau_load(L, "=NativeBreakpointRestore", bytecode, bytecodeSize, 0);
     free(bytecode);
 
     REQUIRE(result == 0);
 
-    Luau::CodeGen::CompilationStats nativeStats = {};
-    Luau::CodeGen::CodeGenCompilationResult nativeResult = Luau::CodeGen::compile(L, -1, Luau::CodeGen::CodeGen_ColdFunctions, &nativeStats);
+    CHECK(Luau::CodeGen::compile(L, -1, Luau::CodeGen::CodeGen_ColdFunctions) == Luau::CodeGen::CodeGenCompilationResult::Success);
 
-    // Limit is not hit immediately, so with some functions compiled it should be a success
-    CHECK(nativeResult == Luau::CodeGen::CodeGenCompilationResult::CodeGenOverflowInstructionLimit);
+    REQUIRE(lua_pcall(L, 0, 1, 0) == 0);
+    REQUIRE(lua_isfunction(L, -1));
 
-    // We should be able to compile at least one of our functions
-    CHECK(nativeStats.functionsCompiled > 0);
+    auto callNative = [L]() {
+        lua_pushvalue(L, -1);
+        REQUIRE(lua_pcall(L, 0, 1, 0) == 0);
+        bool native = lua_toboolean(L, -1);
+        lua_pop(L, 1);
+        return native;
+    };
 
-    // But because of the limit, not all of them (101 because there's an extra global function)
-    CHECK(nativeStats.functionsCompiled < 101);
+    CHECK(callNative());
+
+    // function runs in the interpreter while it has a breakpoint
+    lua_breakpoint(L, -1, 3, true);
+    CHECK(!callNative());
+
+    // and returns to native code after the breakpoint is removed
+    lua_breakpoint(L, -1, 3, false);
+    CHECK(callNative());
 }
 
 TEST_CASE("BytecodeDistributionPerFunctionTest")
@@ -2194,26 +5645,29 @@ end
     CHECK_EQ(summaries[0].getLine(), 6);
     CHECK_EQ(summaries[0].getCounts(0),
         std::vector<unsigned>({0, 0, 0, 0, 1, 0, 1, 0, 0, 1, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0,
-            1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0}));
+            1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}));
 
     CHECK_EQ(summaries[1].getName(), "first");
     CHECK_EQ(summaries[1].getLine(), 2);
     CHECK_EQ(summaries[1].getCounts(0),
         std::vector<unsigned>({0, 0, 1, 0, 2, 0, 3, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-            0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}));
+            0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}));
 
 
     CHECK_EQ(summaries[2].getName(), "second");
     CHECK_EQ(summaries[2].getLine(), 15);
     CHECK_EQ(summaries[2].getCounts(0),
         std::vector<unsigned>({0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-            0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}));
+            0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}));
+
+    CHECK_EQ(summaries[2].getPairCount(LOP_GETTABLEN, LOP_RETURN), 1);
+    CHECK_EQ(summaries[2].getPairCount(LOP_RETURN, LOP_GETTABLEN), 0);
 
     CHECK_EQ(summaries[3].getName(), "");
     CHECK_EQ(summaries[3].getLine(), 1);
     CHECK_EQ(summaries[3].getCounts(0),
         std::vector<unsigned>({0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
-            0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}));
+            0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0}));
 }
 
 TEST_SUITE_END();
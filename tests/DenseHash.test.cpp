@@ -1,8 +1,12 @@
 // This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
 #include "Luau/DenseHash.h"
+#include "Luau/FlatHash.h"
 
 #include "doctest.h"
 
+#include <string>
+#include <vector>
+
 /** So... why are we picking a very specific number to fill the DenseHash(Map|Set)?
  *
  * That's because that's the count that happens to trigger a specific bug.
@@ -76,4 +80,76 @@ TEST_CASE("merging_another_map_and_resolve_conflicts_that_also_just_so_happens_t
     }
 }
 
+TEST_CASE("flat_hash_map_finds_every_inserted_key")
+{
+    Luau::FlatHashMap<int, int> m{-1};
+    for (int i = 0; i < 10000; ++i)
+        m[i * 7] = i;
+
+    REQUIRE(m.size() == 10000);
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        int* a = m.find(i * 7);
+        REQUIRE(a);
+        CHECK(i == *a);
+
+        CHECK(!m.contains(i * 7 + 1));
+    }
+
+    CHECK(!m.find(-1));
+
+    size_t visited = 0;
+    for (auto [k, v] : m)
+    {
+        CHECK(k == v * 7);
+        visited++;
+    }
+
+    CHECK(visited == m.size());
+}
+
+TEST_CASE("flat_hash_map_overwriting_while_iterating_shouldnt_rehash")
+{
+    Luau::FlatHashMap<int, int> m{-1};
+    for (int i = 0; i < 14; ++i)
+        m[i] = i;
+
+    for (auto [k, a] : m)
+        m[k] = a + 1;
+
+    for (int i = 0; i < 14; ++i)
+    {
+        int* a = m.find(i);
+        REQUIRE(a);
+        CHECK(i + 1 == *a);
+    }
+}
+
+TEST_CASE("flat_hash_map_owns_non_trivial_values")
+{
+    std::vector<int> keys;
+    for (int i = 0; i < 100; ++i)
+        keys.push_back(i);
+
+    Luau::FlatHashMap<const int*, std::string> m{nullptr};
+    for (const int& k : keys)
+        m[&k] = std::to_string(k);
+
+    CHECK(!m.try_insert(&keys[3], "x").second);
+    CHECK("3" == *m.find(&keys[3]));
+
+    Luau::FlatHashMap<const int*, std::string> copy = m;
+    m.clear();
+
+    CHECK(m.empty());
+    CHECK(!m.find(&keys[3]));
+    REQUIRE(copy.size() == 100);
+    CHECK("42" == *copy.find(&keys[42]));
+
+    m = std::move(copy);
+    CHECK(m.size() == 100);
+    CHECK("99" == *m.find(&keys[99]));
+}
+
 TEST_SUITE_END();
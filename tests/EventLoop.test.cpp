@@ -0,0 +1,173 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#include "lua.h"
+#include "lualib.h"
+#include "luacode.h"
+
+#include "EventLoop.h"
+
+#include "doctest.h"
+
+#include <memory>
+#include <string>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static std::string getTempPath(const char* name)
+{
+#ifdef _WIN32
+    const char* temp = getenv("TEMP");
+    return std::string(temp ? temp : ".") + "/" + name;
+#else
+    return std::string("/tmp/") + name;
+#endif
+}
+
+struct EventLoopFixture
+{
+    EventLoop loop{2};
+    std::unique_ptr<lua_State, void (*)(lua_State*)> state{luaL_newstate(), lua_close};
+
+    EventLoopFixture()
+    {
+        lua_State* L = state.get();
+
+        luaL_openlibs(L);
+        loop.open(L);
+    }
+
+    // runs the source as the first task of the loop and returns its status; the thread is left on the stack of the main state
+    int run(const char* source, const std::string& path = std::string())
+    {
+        lua_State* L = state.get();
+        lua_State* T = lua_newthread(L);
+
+        lua_pushlstring(T, path.data(), path.size());
+        lua_setglobal(T, "path");
+
+        size_t bytecodeSize = 0;
+        char* bytecode = luau_compile(source, strlen(source), nullptr, &bytecodeSize);
+        int result = luau_load(T, "=test", bytecode, bytecodeSize, 0);
+        free(bytecode);
+
+        REQUIRE(result == 0);
+
+        return loop.run(T, 0);
+    }
+
+    std::string result(int index = 1)
+    {
+        lua_State* T = lua_tothread(state.get(), -1);
+        const char* str = lua_tostring(T, index);
+        return str ? str : "";
+    }
+};
+
+TEST_SUITE_BEGIN("EventLoopTests");
+
+TEST_CASE_FIXTURE(EventLoopFixture, "files_are_written_and_read_back")
+{
+    std::string path = getTempPath("luau-eventloop-test.txt");
+
+    int status = run(R"(
+        assert(io.writefile(path, "hello "))
+        local data = io.readfile(path)
+        assert(type(data) == "buffer")
+
+        local b = buffer.create(5)
+        buffer.writestring(b, 0, "world")
+        assert(io.writefile(path, b))
+
+        return buffer.tostring(data) .. buffer.tostring(io.readfile(path))
+    )",
+        path);
+
+    remove(path.c_str());
+
+    CHECK(status == LUA_OK);
+    CHECK(result() == "hello world");
+}
+
+TEST_CASE_FIXTURE(EventLoopFixture, "missing_files_return_an_error")
+{
+    int status = run(R"(
+        local data, err = io.readfile(path)
+        assert(data == nil)
+        return err
+    )",
+        getTempPath("luau-eventloop-missing/file.txt"));
+
+    CHECK(status == LUA_OK);
+    CHECK(result().find("cannot open") == 0);
+}
+
+TEST_CASE_FIXTURE(EventLoopFixture, "tasks_wake_up_in_deadline_order")
+{
+    int status = run(R"(
+        local order = {}
+
+        for _, delay in {0.03, 0.01, 0.02} do
+            io.spawn(function(d)
+                io.sleep(d)
+                table.insert(order, d)
+            end, delay)
+        end
+
+        -- the first task finishes last and sees the order of all other tasks
+        io.sleep(0.05)
+        return table.concat(order, " ")
+    )");
+
+    CHECK(status == LUA_OK);
+    CHECK(result() == "0.01 0.02 0.03");
+}
+
+TEST_CASE_FIXTURE(EventLoopFixture, "loop_runs_until_spawned_tasks_finish")
+{
+    int status = run(R"(
+        counter = 0
+
+        for i = 1, 10 do
+            io.spawn(function()
+                io.sleep(0)
+                coroutine.yield()
+                counter += 1
+            end)
+        end
+    )");
+
+    CHECK(status == LUA_OK);
+
+    lua_getglobal(state.get(), "counter");
+    CHECK(lua_tonumber(state.get(), -1) == 10);
+}
+
+TEST_CASE_FIXTURE(EventLoopFixture, "nested_coroutines_cannot_wait")
+{
+    int status = run(R"(
+        local ok, err = coroutine.resume(coroutine.create(function()
+            io.sleep(0)
+        end))
+        assert(not ok)
+        return err
+    )");
+
+    CHECK(status == LUA_OK);
+    CHECK(result().find("io.sleep can only be called from the main script or from tasks created with io.spawn") != std::string::npos);
+}
+
+TEST_CASE_FIXTURE(EventLoopFixture, "spawned_task_errors_are_counted")
+{
+    int status = run(R"(
+        io.spawn(function()
+            io.sleep(0)
+            error("boom")
+        end)
+    )");
+
+    CHECK(status == LUA_OK);
+    CHECK(loop.getFailedTaskCount() == 1);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,213 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#include "lua.h"
+#include "lualib.h"
+#include "luacode.h"
+
+#include "Executor.h"
+
+#include "doctest.h"
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <stdlib.h>
+#include <string.h>
+
+static std::atomic<int> hostCounter{0};
+
+static int hostcount(lua_State* L)
+{
+    hostCounter++;
+    return 0;
+}
+
+static void loadCode(lua_State* L, unsigned vm, const char* source)
+{
+    luaL_openlibs(L);
+
+    lua_pushcfunction(L, hostcount, "hostcount");
+    lua_setglobal(L, "hostcount");
+
+    size_t bytecodeSize = 0;
+    char* bytecode = luau_compile(source, strlen(source), nullptr, &bytecodeSize);
+    int result = luau_load(L, "=test", bytecode, bytecodeSize, 0);
+    free(bytecode);
+
+    REQUIRE(result == 0);
+    lua_call(L, 0, 0);
+}
+
+static const char* executorSource = R"(
+function square(x)
+    return x * x
+end
+
+function echo(...)
+    return ...
+end
+
+function sum(n)
+    local s = 0
+    for i = 1, n do
+        s += i
+        executor.yield()
+    end
+    return s
+end
+
+function fail()
+    error("boom", 0)
+end
+
+function fanout(n)
+    for i = 1, n do
+        executor.spawn("count")
+    end
+end
+
+function count()
+    hostcount()
+end
+
+function info()
+    return executor.vm(), executor.count()
+end
+)";
+
+TEST_SUITE_BEGIN("ExecutorTests");
+
+TEST_CASE("tasks_run_on_all_vms")
+{
+    Executor executor(4, [](lua_State* L, unsigned vm) {
+        loadCode(L, vm, executorSource);
+    });
+
+    CHECK(executor.getVmCount() == 4);
+
+    std::atomic<int> total{0};
+
+    for (int i = 1; i <= 100; i++)
+    {
+        executor.spawn(i, "square", {{ExecutorValue::Number, double(i)}}, [&](bool ok, const ExecutorMessage& result) {
+            CHECK(ok);
+            REQUIRE(result.size() == 1);
+            total += int(result[0].number);
+        });
+    }
+
+    executor.wait();
+
+    CHECK(total == 338350);
+}
+
+TEST_CASE("messages_keep_values")
+{
+    Executor executor(2, [](lua_State* L, unsigned vm) {
+        loadCode(L, vm, executorSource);
+    });
+
+    ExecutorMessage message = {
+        {ExecutorValue::Nil},
+        {ExecutorValue::Boolean, 1},
+        {ExecutorValue::Number, 1.5},
+        {ExecutorValue::String, 0, std::string("a\0b", 3)},
+        {ExecutorValue::Buffer, 0, "data"},
+    };
+
+    std::mutex mtx;
+    ExecutorMessage received;
+    bool succeeded = false;
+
+    executor.spawn(0, "echo", message, [&](bool ok, const ExecutorMessage& result) {
+        std::unique_lock guard(mtx);
+        succeeded = ok;
+        received = result;
+    });
+
+    executor.wait();
+
+    std::unique_lock guard(mtx);
+    CHECK(succeeded);
+    REQUIRE(received.size() == message.size());
+
+    for (size_t i = 0; i < message.size(); i++)
+    {
+        CHECK(received[i].type == message[i].type);
+        CHECK(received[i].number == message[i].number);
+        CHECK(received[i].data == message[i].data);
+    }
+}
+
+TEST_CASE("yielded_tasks_are_resumed")
+{
+    Executor executor(1, [](lua_State* L, unsigned vm) {
+        loadCode(L, vm, executorSource);
+    });
+
+    std::atomic<int> total{0};
+
+    for (int i = 0; i < 10; i++)
+    {
+        executor.spawn(0, "sum", {{ExecutorValue::Number, 100}}, [&](bool ok, const ExecutorMessage& result) {
+            CHECK(ok);
+            REQUIRE(result.size() == 1);
+            total += int(result[0].number);
+        });
+    }
+
+    executor.wait();
+
+    CHECK(total == 50500);
+}
+
+TEST_CASE("task_errors_are_reported")
+{
+    Executor executor(1, [](lua_State* L, unsigned vm) {
+        loadCode(L, vm, executorSource);
+    });
+
+    std::mutex mtx;
+    std::vector<std::string> errors;
+
+    auto onComplete = [&](bool ok, const ExecutorMessage& result) {
+        CHECK(!ok);
+        REQUIRE(result.size() == 1);
+        std::unique_lock guard(mtx);
+        errors.push_back(result[0].data);
+    };
+
+    executor.spawn(0, "fail", {}, onComplete);
+    executor.spawn(0, "info", {}, [](bool ok, const ExecutorMessage& result) {
+        CHECK(ok);
+        REQUIRE(result.size() == 2);
+        CHECK(result[0].number == 0);
+        CHECK(result[1].number == 1);
+    });
+    executor.spawn(0, "missing", {}, onComplete);
+
+    executor.wait();
+
+    std::unique_lock guard(mtx);
+    REQUIRE(errors.size() == 2);
+    CHECK(errors[0] == "boom");
+    CHECK(errors[1].find("attempt to call a nil value") != std::string::npos);
+}
+
+TEST_CASE("wait_includes_tasks_spawned_by_scripts")
+{
+    hostCounter = 0;
+
+    Executor executor(3, [](lua_State* L, unsigned vm) {
+        loadCode(L, vm, executorSource);
+    });
+
+    executor.spawn(0, "fanout", {{ExecutorValue::Number, 50}});
+    executor.spawn(1, "fanout", {{ExecutorValue::Number, 50}});
+    executor.wait();
+
+    CHECK(hostCounter == 100);
+}
+
+TEST_SUITE_END();
@@ -9,6 +9,9 @@
 #include "doctest.h"
 
 #include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
 
 using namespace Luau;
 
@@ -873,6 +876,84 @@ local _ = 0x10000000000000000
     CHECK_EQ(1, lintResult.warnings.size());
 }
 
+TEST_CASE_FIXTURE(FrontendFixture, "lint_only_runs_skip_type_checking")
+{
+    fileResolver.source["Module/A"] = R"(
+        local t = {}
+
+        for i=#t,1 do
+        end
+
+        local x: number = "hello"
+    )";
+
+    configResolver.defaultConfig.enabledLint.warningMask = 0;
+    configResolver.defaultConfig.enabledLint.enableWarning(LintWarning::Code_ForRange);
+
+    frontend.options.runLintChecks = true;
+    frontend.options.lintOnly = true;
+
+    CheckResult result = frontend.check("Module/A");
+
+    LUAU_REQUIRE_NO_ERRORS(result);
+    CHECK_EQ(1, result.lintResult.warnings.size());
+    CHECK_EQ(0, frontend.stats.filesStrict + frontend.stats.filesNonstrict);
+
+    // lints that use type information need the module to be type checked, but type errors are still not reported
+    configResolver.defaultConfig.enabledLint.enableWarning(LintWarning::Code_TableOperations);
+    frontend.markDirty("Module/A");
+
+    result = frontend.check("Module/A");
+
+    LUAU_REQUIRE_NO_ERRORS(result);
+    CHECK_EQ(1, result.lintResult.warnings.size());
+    CHECK_EQ(1, frontend.stats.filesStrict + frontend.stats.filesNonstrict);
+}
+
+TEST_CASE_FIXTURE(FrontendFixture, "lint_only_modules_do_not_wait_for_dependencies")
+{
+    fileResolver.source["Module/A"] = "local B = require(script.Parent.B) for i=5,1 do end return {}";
+    fileResolver.source["Module/B"] = "local C = require(script.Parent.C) return {}";
+    fileResolver.source["Module/C"] = "for i=10,1 do end return {}";
+
+    configResolver.defaultConfig.enabledLint.warningMask = 0;
+    configResolver.defaultConfig.enabledLint.enableWarning(LintWarning::Code_ForRange);
+
+    frontend.options.runLintChecks = true;
+    frontend.options.lintOnly = true;
+
+    std::vector<size_t> progressDone;
+
+    auto executeTask = [](std::function<void()> task) {
+        task();
+    };
+
+    auto progress = [&](size_t done, size_t total) {
+        progressDone.push_back(done);
+    };
+
+    frontend.queueModuleCheck({"Module/A", "Module/B", "Module/C"});
+    frontend.checkQueuedModules(std::nullopt, executeTask, progress);
+
+    // with an immediate executor, all modules complete before the first progress report instead of one dependency level at a time
+    REQUIRE(progressDone.size() == 1);
+    CHECK(progressDone[0] == 3);
+
+    CHECK(frontend.getCheckResult("Module/A", false)->lintResult.warnings.size() == 1);
+    CHECK(frontend.getCheckResult("Module/C", false)->lintResult.warnings.size() == 1);
+
+    // lints that use type information need the dependencies to be checked first
+    configResolver.defaultConfig.enabledLint.enableWarning(LintWarning::Code_TableOperations);
+    frontend.markDirty("Module/C");
+
+    progressDone.clear();
+
+    frontend.queueModuleCheck({"Module/A", "Module/B", "Module/C"});
+    frontend.checkQueuedModules(std::nullopt, executeTask, progress);
+
+    CHECK(progressDone.size() == 3);
+}
+
 TEST_CASE_FIXTURE(FrontendFixture, "discard_type_graphs")
 {
     Frontend fe{&fileResolver, &configResolver, {false}};
@@ -1027,6 +1108,49 @@ TEST_CASE_FIXTURE(FrontendFixture, "stats_are_not_reset_between_checks")
     CHECK_EQ(4, stats2.files);
 }
 
+TEST_CASE_FIXTURE(FrontendFixture, "module_stats_are_recorded")
+{
+    fileResolver.source["Module/A"] = R"(
+        --!strict
+        local B = require(script.Parent.B)
+        local foo = B.foo + 1
+    )";
+
+    fileResolver.source["Module/B"] = R"(
+        --!strict
+        return {foo = 1}
+    )";
+
+    frontend.check("Module/A");
+    CHECK(frontend.stats.modules.empty());
+
+    frontend.options.recordModuleStats = true;
+    frontend.markDirty("Module/B");
+
+    CheckResult result = frontend.check("Module/A");
+    LUAU_REQUIRE_NO_ERRORS(result);
+
+    // dependencies complete first
+    REQUIRE(frontend.stats.modules.size() == 2);
+    CHECK(frontend.stats.modules[0].name == "Module/B");
+    CHECK(frontend.stats.modules[1].name == "Module/A");
+
+    for (const Frontend::ModuleStats& stats : frontend.stats.modules)
+    {
+        CHECK(stats.timeCheck > 0);
+        CHECK(stats.timeTypeCheck > 0);
+        CHECK(stats.timeCheck >= stats.timeConstraintGeneration + stats.timeSolve + stats.timeTypeCheck);
+        CHECK(stats.types > 0);
+        CHECK(stats.arenaBytes >= stats.types * sizeof(Type));
+
+        if (FFlag::DebugLuauDeferredConstraintResolution)
+        {
+            CHECK(stats.timeConstraintGeneration > 0);
+            CHECK(stats.timeSolve > 0);
+        }
+    }
+}
+
 TEST_CASE_FIXTURE(FrontendFixture, "clearStats")
 {
     fileResolver.source["Module/A"] = R"(
@@ -1146,6 +1270,35 @@ TEST_CASE("check_without_builtin_next")
     frontend.check("Module/B");
 }
 
+TEST_CASE("check_source_backed_by_a_view")
+{
+    struct ViewFileResolver : TestFileResolver
+    {
+        std::optional<SourceCode> readSource(const ModuleName& name) override
+        {
+            auto it = source.find(name);
+            if (it == source.end())
+                return std::nullopt;
+
+            // the resolver keeps ownership of the text; the source code only references it
+            return SourceCode{std::string(), SourceCode::Module, std::make_shared<const std::string_view>(it->second)};
+        }
+    };
+
+    ViewFileResolver fileResolver;
+    TestConfigResolver configResolver;
+    Frontend frontend(&fileResolver, &configResolver);
+
+    fileResolver.source["Module/A"] = "--!strict\nlocal x: string = 1";
+
+    CheckResult result = frontend.check("Module/A");
+    CHECK(result.errors.size() == 1);
+
+    SourceModule* sourceModule = frontend.getSourceModule("Module/A");
+    REQUIRE(sourceModule);
+    CHECK(sourceModule->root->body.size == 1);
+}
+
 TEST_CASE_FIXTURE(BuiltinsFixture, "reexport_cyclic_type")
 {
     fileResolver.source["Module/A"] = R"(
@@ -1273,4 +1426,426 @@ TEST_CASE_FIXTURE(FrontendFixture, "markdirty_early_return")
     }
 }
 
+TEST_CASE_FIXTURE(FrontendFixture, "queued_modules_on_critical_path_are_checked_first")
+{
+    fileResolver.source["game/Gui/Modules/X"] = "return 1";
+    fileResolver.source["game/Gui/Modules/A"] = "return 2";
+    fileResolver.source["game/Gui/Modules/B"] = "return require(script.Parent.A)";
+    fileResolver.source["game/Gui/Modules/C"] = "return require(script.Parent.B)";
+
+    std::vector<ModuleName> checkOrder;
+
+    frontend.prepareModuleScope = [&checkOrder](const ModuleName& name, const ScopePtr& scope, bool forAutocomplete) {
+        checkOrder.push_back(name);
+    };
+
+    // tasks are held until both modules without dependencies are ready, the first task has to pick the one with dependents
+    std::vector<std::function<void()>> pending;
+    bool started = false;
+
+    // sources are parsed ahead so that only typechecking tasks go through the executor below
+    frontend.parse("game/Gui/Modules/X");
+    frontend.parse("game/Gui/Modules/C");
+
+    frontend.queueModuleCheck("game/Gui/Modules/X");
+    frontend.queueModuleCheck("game/Gui/Modules/C");
+
+    frontend.checkQueuedModules(std::nullopt, [&](std::function<void()> task) {
+        pending.push_back(std::move(task));
+
+        if (started || pending.size() == 2)
+        {
+            started = true;
+
+            for (size_t i = 0; i < pending.size(); i++)
+                pending[i]();
+
+            pending.clear();
+        }
+    });
+
+    REQUIRE(checkOrder.size() == 4);
+    CHECK(checkOrder[0] == "game/Gui/Modules/A");
+    CHECK(checkOrder[1] == "game/Gui/Modules/X");
+}
+
+TEST_CASE_FIXTURE(FrontendFixture, "queued_module_sources_are_parsed_on_the_task_executor")
+{
+    fileResolver.source["game/Gui/Modules/A"] = "return {value = 1}";
+    fileResolver.source["game/Gui/Modules/B"] = "return require(script.Parent.A)";
+    fileResolver.source["game/Gui/Modules/C"] = "local x: number = require(script.Parent.B).value";
+    fileResolver.source["game/Gui/Modules/D"] = "local y: number = require(script.Parent.A).value";
+
+    std::mutex mtx;
+    std::vector<std::thread> threads;
+    size_t taskCount = 0;
+
+    frontend.queueModuleCheck("game/Gui/Modules/C");
+    frontend.queueModuleCheck("game/Gui/Modules/D");
+
+    std::vector<ModuleName> checked = frontend.checkQueuedModules(std::nullopt, [&](std::function<void()> task) {
+        std::unique_lock guard(mtx);
+
+        taskCount++;
+        threads.emplace_back(std::move(task));
+    });
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    // every module is parsed and checked by a separate task
+    CHECK(checked.size() == 4);
+    CHECK(taskCount == 8);
+    CHECK(frontend.stats.files == 4);
+
+    std::optional<CheckResult> result = frontend.getCheckResult("game/Gui/Modules/C", true);
+    REQUIRE(result);
+    LUAU_REQUIRE_NO_ERRORS(*result);
+}
+
+TEST_CASE_FIXTURE(FrontendFixture, "queued_module_results_are_streamed")
+{
+    fileResolver.source["game/Gui/Modules/A"] = "--!strict\nlocal a: string = 1 return {value = 1}";
+    fileResolver.source["game/Gui/Modules/B"] = "--!strict\nlocal b: string = require(script.Parent.A).value";
+    fileResolver.source["game/Gui/Modules/C"] = "--!strict\nlocal c: number = require(script.Parent.A).value";
+
+    // A is already checked, so its result is delivered before anything else is checked
+    frontend.check("game/Gui/Modules/A");
+
+    std::vector<std::pair<ModuleName, size_t>> streamed;
+
+    frontend.queueModuleCheck("game/Gui/Modules/A");
+    frontend.queueModuleCheck("game/Gui/Modules/B");
+    frontend.queueModuleCheck("game/Gui/Modules/C");
+
+    frontend.checkQueuedModules(std::nullopt, {}, {}, [&](const ModuleName& name, CheckResult result) {
+        streamed.emplace_back(name, result.errors.size());
+    });
+
+    REQUIRE(streamed.size() == 3);
+    CHECK(streamed[0] == std::make_pair(ModuleName("game/Gui/Modules/A"), size_t(1)));
+
+    // each result only holds the errors of its own module
+    std::sort(streamed.begin() + 1, streamed.end());
+    CHECK(streamed[1] == std::make_pair(ModuleName("game/Gui/Modules/B"), size_t(1)));
+    CHECK(streamed[2] == std::make_pair(ModuleName("game/Gui/Modules/C"), size_t(0)));
+}
+
+TEST_CASE_FIXTURE(FrontendFixture, "streamed_results_can_be_released")
+{
+    fileResolver.source["game/Gui/Modules/A"] = "--!strict\nlocal a: string = 1 return {value = 1}";
+    fileResolver.source["game/Gui/Modules/B"] = "--!strict\nlocal b: number = require(script.Parent.A).value";
+
+    FrontendOptions options = frontend.options;
+    options.retainFullTypeGraphs = true;
+    options.releaseStreamedResults = true;
+
+    size_t streamedErrors = 0;
+
+    frontend.queueModuleCheck("game/Gui/Modules/A");
+    frontend.queueModuleCheck("game/Gui/Modules/B");
+
+    frontend.checkQueuedModules(options, {}, {}, [&](const ModuleName& name, CheckResult result) {
+        streamedErrors += result.errors.size();
+    });
+
+    CHECK(streamedErrors == 1);
+
+    // released modules only keep their public interface, which is still used by dependents
+    ModulePtr a = frontend.moduleResolver.getModule("game/Gui/Modules/A");
+    REQUIRE(a);
+    CHECK(a->errors.empty());
+    CHECK(a->astTypes.empty());
+
+    std::optional<CheckResult> result = frontend.getCheckResult("game/Gui/Modules/B", false);
+    REQUIRE(result);
+    LUAU_REQUIRE_NO_ERRORS(*result);
+}
+
+TEST_CASE_FIXTURE(FrontendFixture, "snapshots_can_be_queried_while_modules_are_checked")
+{
+    fileResolver.source["game/Gui/Modules/A"] = "--!strict\nlocal a: string = 1 return {value = 1}";
+    fileResolver.source["game/Gui/Modules/B"] = "--!strict\nreturn require(script.Parent.A).value";
+    fileResolver.source["game/Gui/Modules/C"] = "--!strict\nreturn 1";
+
+    FrontendOptions options = frontend.options;
+    options.publishSnapshots = true;
+
+    CHECK(frontend.getSnapshot() == nullptr);
+
+    frontend.check("game/Gui/Modules/B", options);
+    frontend.check("game/Gui/Modules/C", options);
+
+    std::shared_ptr<const FrontendSnapshot> first = frontend.getSnapshot();
+    REQUIRE(first);
+    CHECK(first->version == 2);
+
+    std::optional<CheckResult> result = first->getCheckResult("game/Gui/Modules/B", true);
+    REQUIRE(result);
+    CHECK(result->errors.size() == 1);
+
+    // readers keep querying the snapshot while the next version is checked
+    std::atomic<bool> done = false;
+    std::atomic<size_t> queries = 0;
+    std::atomic<size_t> mismatches = 0;
+    std::vector<std::thread> readers;
+
+    for (int i = 0; i < 4; i++)
+    {
+        readers.emplace_back([&] {
+            do
+            {
+                std::optional<CheckResult> result = first->getCheckResult("game/Gui/Modules/B", true);
+                const SourceModule* sourceModule = first->getSourceModule("game/Gui/Modules/A");
+
+                if (!result || result->errors.size() != 1 || !sourceModule || !sourceModule->root)
+                    mismatches++;
+
+                queries++;
+            } while (!done);
+        });
+    }
+
+    fileResolver.source["game/Gui/Modules/A"] = "--!strict\nreturn {value = 1}";
+    frontend.markDirty("game/Gui/Modules/A");
+    frontend.check("game/Gui/Modules/B", options);
+
+    done = true;
+
+    for (std::thread& thread : readers)
+        thread.join();
+
+    CHECK(queries >= 4);
+    CHECK(mismatches == 0);
+
+    std::shared_ptr<const FrontendSnapshot> second = frontend.getSnapshot();
+    REQUIRE(second);
+    CHECK(second->version == 3);
+
+    result = second->getCheckResult("game/Gui/Modules/B", true);
+    REQUIRE(result);
+    LUAU_REQUIRE_NO_ERRORS(*result);
+
+    // the older snapshot is unaffected, and modules that didn't change share their entries
+    CHECK(first->getCheckResult("game/Gui/Modules/B", true)->errors.size() == 1);
+    CHECK(first->modules.at("game/Gui/Modules/A") != second->modules.at("game/Gui/Modules/A"));
+    CHECK(first->modules.at("game/Gui/Modules/C") == second->modules.at("game/Gui/Modules/C"));
+
+    // changes that weren't checked yet make the results unavailable, like in getCheckResult
+    frontend.markDirty("game/Gui/Modules/C");
+    std::shared_ptr<const FrontendSnapshot> third = frontend.publishSnapshot();
+    CHECK(third->version == 4);
+    CHECK(!third->getCheckResult("game/Gui/Modules/C", false));
+    CHECK(second->getCheckResult("game/Gui/Modules/C", false));
+}
+
+TEST_CASE_FIXTURE(FrontendFixture, "cancelled_check_keeps_completed_dependencies")
+{
+    fileResolver.source["game/Gui/Modules/A"] = "--!strict\nreturn {value = 1}";
+    fileResolver.source["game/Gui/Modules/B"] = "--!strict\nlocal b: number = require(script.Parent.A).value\nreturn b";
+    fileResolver.source["game/Gui/Modules/C"] = "--!strict\nreturn require(script.Parent.B) + 1";
+
+    FrontendOptions options = frontend.options;
+    options.cancellationToken = std::make_shared<FrontendCancellationToken>();
+
+    std::vector<ModuleName> checkOrder;
+
+    std::shared_ptr<FrontendCancellationToken> token = options.cancellationToken;
+
+    // the check is cancelled when B starts
+    frontend.prepareModuleScope = [&](const ModuleName& name, const ScopePtr& scope, bool forAutocomplete) {
+        checkOrder.push_back(name);
+
+        if (name == "game/Gui/Modules/B")
+            token->cancel();
+    };
+
+    CheckResult result = frontend.check("game/Gui/Modules/C", options);
+    LUAU_REQUIRE_NO_ERRORS(result);
+
+    // C doesn't start after the cancellation, and B is checked again
+    CHECK(checkOrder == std::vector<ModuleName>{"game/Gui/Modules/A", "game/Gui/Modules/B"});
+    CHECK(!frontend.isDirty("game/Gui/Modules/A"));
+    CHECK(frontend.isDirty("game/Gui/Modules/B"));
+    CHECK(frontend.isDirty("game/Gui/Modules/C"));
+
+    checkOrder.clear();
+    options.cancellationToken = std::make_shared<FrontendCancellationToken>();
+
+    result = frontend.check("game/Gui/Modules/C", options);
+    LUAU_REQUIRE_NO_ERRORS(result);
+
+    CHECK(checkOrder == std::vector<ModuleName>{"game/Gui/Modules/B", "game/Gui/Modules/C"});
+    CHECK(!frontend.isDirty("game/Gui/Modules/C"));
+}
+
+TEST_CASE_FIXTURE(FrontendFixture, "cancelled_queued_check_keeps_completed_modules")
+{
+    fileResolver.source["game/Gui/Modules/A"] = "--!strict\nreturn {value = 1}";
+    fileResolver.source["game/Gui/Modules/B"] = "--!strict\nreturn {value = 2}";
+    fileResolver.source["game/Gui/Modules/C"] = "--!strict\nreturn require(script.Parent.A).value + require(script.Parent.B).value";
+
+    FrontendOptions options = frontend.options;
+    options.cancellationToken = std::make_shared<FrontendCancellationToken>();
+
+    size_t checked = 0;
+    std::shared_ptr<FrontendCancellationToken> token = options.cancellationToken;
+
+    // the check is cancelled after the first module has been checked
+    frontend.prepareModuleScope = [&](const ModuleName& name, const ScopePtr& scope, bool forAutocomplete) {
+        if (++checked == 2)
+            token->cancel();
+    };
+
+    frontend.queueModuleCheck("game/Gui/Modules/C");
+
+    std::vector<ModuleName> result = frontend.checkQueuedModules(options, [](std::function<void()> task) {
+        task();
+    });
+
+    CHECK(result.empty());
+    CHECK(checked == 2);
+    CHECK(frontend.isDirty("game/Gui/Modules/A") != frontend.isDirty("game/Gui/Modules/B"));
+    CHECK(frontend.isDirty("game/Gui/Modules/C"));
+
+    // only the modules that didn't complete are checked again
+    checked = 0;
+    options.cancellationToken = std::make_shared<FrontendCancellationToken>();
+
+    frontend.queueModuleCheck("game/Gui/Modules/C");
+    result = frontend.checkQueuedModules(options, [](std::function<void()> task) {
+        task();
+    });
+
+    CHECK(result.size() == 2);
+    CHECK(checked == 2);
+    CHECK(!frontend.isDirty("game/Gui/Modules/C"));
+}
+
+TEST_CASE_FIXTURE(FrontendFixture, "dependents_are_not_checked_when_interface_is_unchanged")
+{
+    if (FFlag::DebugLuauDeferredConstraintResolution)
+        return;
+
+    frontend.options.retainFullTypeGraphs = false;
+
+    fileResolver.source["game/Gui/Modules/A"] = "return {value = 1}";
+    fileResolver.source["game/Gui/Modules/B"] = "return require(script.Parent.A).value + 1";
+    fileResolver.source["game/Gui/Modules/C"] = "local x: number = require(script.Parent.B)";
+
+    LUAU_REQUIRE_NO_ERRORS(frontend.check("game/Gui/Modules/C"));
+
+    ModulePtr a = frontend.moduleResolver.getModule("game/Gui/Modules/A");
+    ModulePtr b = frontend.moduleResolver.getModule("game/Gui/Modules/B");
+    ModulePtr c = frontend.moduleResolver.getModule("game/Gui/Modules/C");
+
+    // implementation change keeps the type of the module the same
+    fileResolver.source["game/Gui/Modules/A"] = "return {value = 2}";
+    frontend.markDirty("game/Gui/Modules/A");
+
+    CHECK(frontend.isDirty("game/Gui/Modules/C"));
+    LUAU_REQUIRE_NO_ERRORS(frontend.check("game/Gui/Modules/C"));
+    CHECK(!frontend.isDirty("game/Gui/Modules/C"));
+
+    CHECK(frontend.moduleResolver.getModule("game/Gui/Modules/A") != a);
+    CHECK(frontend.moduleResolver.getModule("game/Gui/Modules/B") == b);
+    CHECK(frontend.moduleResolver.getModule("game/Gui/Modules/C") == c);
+
+    // interface change causes B to be checked again, but the type of B stays the same
+    fileResolver.source["game/Gui/Modules/A"] = "return {value = 'two'}";
+    frontend.markDirty("game/Gui/Modules/A");
+
+    CheckResult result = frontend.check("game/Gui/Modules/C");
+    LUAU_REQUIRE_ERROR_COUNT(1, result);
+    CHECK(result.errors[0].moduleName == "game/Gui/Modules/B");
+
+    CHECK(frontend.moduleResolver.getModule("game/Gui/Modules/B") != b);
+    CHECK(frontend.moduleResolver.getModule("game/Gui/Modules/C") == c);
+}
+
+TEST_CASE_FIXTURE(FrontendFixture, "dependency_type_graphs_are_compacted")
+{
+    frontend.options.retainFullTypeGraphs = true;
+    frontend.options.compactDependencyTypeGraphs = true;
+
+    fileResolver.source["game/Gui/Modules/A"] = "local value = 1 return {value = value}";
+    fileResolver.source["game/Gui/Modules/B"] = "local x: number = require(script.Parent.A).value";
+
+    LUAU_REQUIRE_NO_ERRORS(frontend.check("game/Gui/Modules/B"));
+
+    ModulePtr a = frontend.moduleResolver.getModule("game/Gui/Modules/A");
+    ModulePtr b = frontend.moduleResolver.getModule("game/Gui/Modules/B");
+
+    CHECK(a->astTypes.empty());
+    CHECK(a->internalTypes.types.empty());
+    CHECK(!b->astTypes.empty());
+
+    // requesting the dependency checks it again without checking its dependents
+    LUAU_REQUIRE_NO_ERRORS(frontend.check("game/Gui/Modules/A"));
+
+    CHECK(frontend.moduleResolver.getModule("game/Gui/Modules/A") != a);
+    CHECK(!frontend.moduleResolver.getModule("game/Gui/Modules/A")->astTypes.empty());
+    CHECK(frontend.moduleResolver.getModule("game/Gui/Modules/B") == b);
+    CHECK(!frontend.isDirty("game/Gui/Modules/B"));
+
+    // full type graphs are retained until the module is checked again as a dependency
+    LUAU_REQUIRE_NO_ERRORS(frontend.check("game/Gui/Modules/A"));
+    CHECK(!frontend.moduleResolver.getModule("game/Gui/Modules/A")->astTypes.empty());
+}
+
+TEST_CASE_FIXTURE(FrontendFixture, "solver_profile_is_recorded")
+{
+    if (!FFlag::DebugLuauDeferredConstraintResolution)
+        return;
+
+    frontend.options.profileSolver = true;
+
+    fileResolver.source["game/Gui/Modules/A"] = "return {value = 1}";
+    fileResolver.source["game/Gui/Modules/B"] = "local x: number = require(script.Parent.A).value";
+
+    LUAU_REQUIRE_NO_ERRORS(frontend.check("game/Gui/Modules/B"));
+
+    ModulePtr a = frontend.moduleResolver.getModule("game/Gui/Modules/A");
+    ModulePtr b = frontend.moduleResolver.getModule("game/Gui/Modules/B");
+
+    REQUIRE(!b->solverProfile.hotConstraints.empty());
+    CHECK(b->solverProfile.hotConstraints.size() <= SolverProfile::kHotConstraintLimit);
+    CHECK(b->solverProfile.hotConstraints.front().entry.time >= b->solverProfile.hotConstraints.back().entry.time);
+    CHECK(b->solverProfile.constraintKinds.count("FunctionCallConstraint"));
+
+    // frontend stats hold the sum of all checked modules
+    size_t attempts = 0;
+
+    for (const ModulePtr& module : {a, b})
+    {
+        for (const auto& [kind, entry] : module->solverProfile.constraintKinds)
+            attempts += entry.attempts;
+    }
+
+    size_t totalAttempts = 0;
+
+    for (const auto& [kind, entry] : frontend.stats.solverProfile.constraintKinds)
+        totalAttempts += entry.attempts;
+
+    CHECK(totalAttempts == attempts);
+}
+
+TEST_CASE_FIXTURE(FrontendFixture, "imported_type_bindings_are_shared_with_the_required_module")
+{
+    fileResolver.source["game/Gui/Modules/A"] = "export type T = {value: number} return {}";
+    fileResolver.source["game/Gui/Modules/B"] = R"(
+        local A = require(script.Parent.A)
+        local x: A.T = {value = 1}
+    )";
+
+    LUAU_REQUIRE_NO_ERRORS(frontend.check("game/Gui/Modules/B"));
+
+    ModulePtr a = frontend.moduleResolver.getModule("game/Gui/Modules/A");
+    ModulePtr b = frontend.moduleResolver.getModule("game/Gui/Modules/B");
+
+    auto it = b->getModuleScope()->importedTypeBindings.find("A");
+    REQUIRE(it != b->getModuleScope()->importedTypeBindings.end());
+    CHECK(it->second.get() == &a->exportedTypeBindings);
+}
+
 TEST_SUITE_END();
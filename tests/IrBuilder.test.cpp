@@ -4,7 +4,10 @@
 #include "Luau/IrDump.h"
 #include "Luau/IrUtils.h"
 #include "Luau/OptimizeConstProp.h"
+#include "Luau/OptimizeDeadStore.h"
+#include "Luau/OptimizeFinalA64.h"
 #include "Luau/OptimizeFinalX64.h"
+#include "Luau/OptimizeRedundantChecks.h"
 #include "ScopedFlags.h"
 
 #include "doctest.h"
@@ -318,6 +321,69 @@ bb_2:
 )");
 }
 
+TEST_CASE_FIXTURE(IrBuilderFixture, "FinalA64OptJumpCmpNumConstant")
+{
+    IrOp block = build.block(IrBlockKind::Internal);
+    IrOp trueBlock = build.block(IrBlockKind::Internal);
+    IrOp falseBlock = build.block(IrBlockKind::Internal);
+
+    build.beginBlock(block);
+    IrOp opA = build.inst(IrCmd::LOAD_DOUBLE, build.vmReg(1));
+    build.inst(IrCmd::JUMP_CMP_NUM, build.constDouble(0.0), opA, build.cond(IrCondition::NotLessEqual), trueBlock, falseBlock);
+
+    build.beginBlock(trueBlock);
+    build.inst(IrCmd::RETURN, build.constUint(0));
+
+    build.beginBlock(falseBlock);
+    build.inst(IrCmd::RETURN, build.constUint(0));
+
+    updateUseCounts(build.function);
+    optimizeConstantOperandsA64(build.function);
+
+    // Constant is moved to the second argument with a matching condition
+    CHECK("\n" + toString(build.function, IncludeUseInfo::No) == R"(
+bb_0:
+   %0 = LOAD_DOUBLE R1
+   JUMP_CMP_NUM %0, 0, not_ge, bb_1, bb_2
+
+bb_1:
+   RETURN 0u
+
+bb_2:
+   RETURN 0u
+
+)");
+}
+
+TEST_CASE_FIXTURE(IrBuilderFixture, "FinalA64OptMulNumTwo")
+{
+    IrOp block = build.block(IrBlockKind::Internal);
+
+    build.beginBlock(block);
+    IrOp opA = build.inst(IrCmd::LOAD_DOUBLE, build.vmReg(1));
+    IrOp opB = build.inst(IrCmd::MUL_NUM, build.constDouble(2.0), opA);
+    IrOp opC = build.inst(IrCmd::MUL_NUM, opA, build.constDouble(3.0));
+    build.inst(IrCmd::STORE_DOUBLE, build.vmReg(2), opB);
+    build.inst(IrCmd::STORE_DOUBLE, build.vmReg(3), opC);
+    build.inst(IrCmd::RETURN, build.constUint(0));
+
+    updateUseCounts(build.function);
+    optimizeConstantOperandsA64(build.function);
+
+    // Multiplication by two becomes an addition, other constants are left in place
+    CHECK("\n" + toString(build.function, IncludeUseInfo::No) == R"(
+bb_0:
+   %0 = LOAD_DOUBLE R1
+   %1 = ADD_NUM %0, %0
+   %2 = MUL_NUM %0, 3
+   STORE_DOUBLE R2, %1
+   STORE_DOUBLE R3, %2
+   RETURN 0u
+
+)");
+    CHECK(build.function.instructions[opA.index].useCount == 3);
+}
+
 TEST_SUITE_END();
 
 TEST_SUITE_BEGIN("ConstantFolding");
@@ -1063,6 +1129,47 @@ bb_0:
 )");
 }
 
+TEST_CASE_FIXTURE(IrBuilderFixture, "SkipBarriersOnNewTables")
+{
+    IrOp block = build.block(IrBlockKind::Internal);
+
+    build.beginBlock(block);
+
+    IrOp table1 = build.inst(IrCmd::NEW_TABLE, build.constUint(0), build.constUint(0));
+    build.inst(IrCmd::STORE_POINTER, build.vmReg(0), table1);
+    build.inst(IrCmd::STORE_TAG, build.vmReg(0), build.constTag(ttable));
+    build.inst(IrCmd::BARRIER_TABLE_FORWARD, build.inst(IrCmd::LOAD_POINTER, build.vmReg(0)), build.vmReg(1), build.undef());
+    IrOp table2 = build.inst(IrCmd::DUP_TABLE, build.vmConst(0));
+    build.inst(IrCmd::BARRIER_TABLE_BACK, table2);
+
+    // GC step can mark new tables black
+    build.inst(IrCmd::CHECK_GC);
+    build.inst(IrCmd::BARRIER_TABLE_FORWARD, table1, build.vmReg(1), build.undef());
+
+    IrOp table3 = build.inst(IrCmd::NEW_TABLE, build.constUint(0), build.constUint(0));
+    build.inst(IrCmd::BARRIER_TABLE_FORWARD, table3, build.vmReg(1), build.undef());
+    build.inst(IrCmd::CALL, build.vmReg(2), build.constInt(0), build.constInt(0));
+    build.inst(IrCmd::BARRIER_TABLE_FORWARD, table3, build.vmReg(1), build.undef());
+    build.inst(IrCmd::RETURN, build.constUint(0));
+
+    updateUseCounts(build.function);
+    constPropInBlockChains(build, true);
+
+    CHECK("\n" + toString(build.function, IncludeUseInfo::No) == R"(
+bb_0:
+   %0 = NEW_TABLE 0u, 0u
+   STORE_POINTER R0, %0
+   STORE_TAG R0, ttable
+   CHECK_GC
+   BARRIER_TABLE_FORWARD %0, R1, undef
+   %9 = NEW_TABLE 0u, 0u
+   CALL R2, 0i, 0i
+   BARRIER_TABLE_FORWARD %9, R1, undef
+   RETURN 0u
+
+)");
+}
+
 TEST_CASE_FIXTURE(IrBuilderFixture, "ConcatInvalidation")
 {
     IrOp block = build.block(IrBlockKind::Internal);
@@ -2058,6 +2165,84 @@ bb_fallback_1:
 )");
 }
 
+TEST_CASE_FIXTURE(IrBuilderFixture, "HashSlotStoreToLoadForwarding")
+{
+    IrOp block = build.block(IrBlockKind::Internal);
+    IrOp fallback = build.block(IrBlockKind::Fallback);
+
+    build.beginBlock(block);
+
+    // This roughly corresponds to 'local t = {a = 1, b = v}; return t.a, t.b'
+    IrOp tmp = build.inst(IrCmd::DUP_TABLE, build.vmConst(0));
+    build.inst(IrCmd::STORE_POINTER, build.vmReg(0), tmp);
+    build.inst(IrCmd::STORE_TAG, build.vmReg(0), build.constTag(ttable));
+    IrOp table = build.inst(IrCmd::LOAD_POINTER, build.vmReg(0));
+
+    IrOp slotA = build.inst(IrCmd::GET_SLOT_NODE_ADDR, table, build.constUint(3), build.vmConst(1));
+    build.inst(IrCmd::CHECK_SLOT_MATCH, slotA, build.vmConst(1), fallback);
+    build.inst(IrCmd::CHECK_READONLY, table, fallback); // Known for a fresh table
+    build.inst(IrCmd::STORE_SPLIT_TVALUE, slotA, build.constTag(tnumber), build.constDouble(1), build.constInt(0));
+
+    build.inst(IrCmd::CHECK_TAG, build.inst(IrCmd::LOAD_TAG, build.vmReg(5)), build.constTag(tstring), fallback);
+    IrOp slotB = build.inst(IrCmd::GET_SLOT_NODE_ADDR, table, build.constUint(6), build.vmConst(2));
+    build.inst(IrCmd::CHECK_SLOT_MATCH, slotB, build.vmConst(2), fallback);
+    build.inst(IrCmd::STORE_TVALUE, slotB, build.inst(IrCmd::LOAD_TVALUE, build.vmReg(5)), build.constInt(0)); // Different key doesn't overwrite 'a'
+
+    IrOp slotA2 = build.inst(IrCmd::GET_SLOT_NODE_ADDR, table, build.constUint(9), build.vmConst(1));
+    build.inst(IrCmd::CHECK_SLOT_MATCH, slotA2, build.vmConst(1), fallback); // Value is known not to be nil
+    build.inst(IrCmd::STORE_TVALUE, build.vmReg(1), build.inst(IrCmd::LOAD_TVALUE, slotA2, build.constInt(0)));
+
+    IrOp slotB2 = build.inst(IrCmd::GET_SLOT_NODE_ADDR, table, build.constUint(12), build.vmConst(2));
+    build.inst(IrCmd::CHECK_SLOT_MATCH, slotB2, build.vmConst(2), fallback);
+    build.inst(IrCmd::STORE_TVALUE, build.vmReg(2), build.inst(IrCmd::LOAD_TVALUE, slotB2, build.constInt(0)));
+
+    // Store through a pointer that is not a checked slot might overwrite anything
+    IrOp other = build.inst(IrCmd::LOAD_POINTER, build.vmReg(6));
+    IrOp element = build.inst(IrCmd::GET_ARR_ADDR, other, build.constInt(0));
+    build.inst(IrCmd::STORE_SPLIT_TVALUE, element, build.constTag(tnumber), build.constDouble(2), build.constInt(0));
+
+    IrOp slotA3 = build.inst(IrCmd::GET_SLOT_NODE_ADDR, table, build.constUint(15), build.vmConst(1));
+    build.inst(IrCmd::CHECK_SLOT_MATCH, slotA3, build.vmConst(1), fallback);
+    build.inst(IrCmd::STORE_TVALUE, build.vmReg(3), build.inst(IrCmd::LOAD_TVALUE, slotA3, build.constInt(0)));
+
+    build.inst(IrCmd::RETURN, build.vmReg(1), build.constUint(3));
+
+    build.beginBlock(fallback);
+    build.inst(IrCmd::RETURN, build.vmReg(0), build.constUint(1));
+
+    updateUseCounts(build.function);
+    constPropInBlockChains(build, true);
+
+    CHECK("\n" + toString(build.function, IncludeUseInfo::No) == R"(
+bb_0:
+   %0 = DUP_TABLE K0
+   STORE_POINTER R0, %0
+   STORE_TAG R0, ttable
+   %4 = GET_SLOT_NODE_ADDR %0, 3u, K1
+   CHECK_SLOT_MATCH %4, K1, bb_fallback_1
+   STORE_SPLIT_TVALUE %4, tnumber, 1, 0i
+   %8 = LOAD_TAG R5
+   CHECK_TAG %8, tstring, bb_fallback_1
+   %10 = GET_SLOT_NODE_ADDR %0, 6u, K2
+   CHECK_SLOT_MATCH %10, K2, bb_fallback_1
+   %12 = LOAD_TVALUE R5
+   STORE_TVALUE %10, %12, 0i
+   STORE_SPLIT_TVALUE R1, tnumber, 1
+   STORE_TVALUE R2, %12
+   %22 = LOAD_POINTER R6
+   %23 = GET_ARR_ADDR %22, 0i
+   STORE_SPLIT_TVALUE %23, tnumber, 2, 0i
+   CHECK_NODE_VALUE %4, bb_fallback_1
+   %27 = LOAD_TVALUE %4, 0i
+   STORE_TVALUE R3, %27
+   RETURN R1, 3u
+
+bb_fallback_1:
+   RETURN R0, 1u
+
+)");
+}
+
 TEST_CASE_FIXTURE(IrBuilderFixture, "DuplicateHashSlotChecksInvalidation")
 {
     ScopedFastFlag luauCodeGenCheckGcEffectFix{DFFlag::LuauCodeGenCheckGcEffectFix, true};
@@ -2877,6 +3062,35 @@ TEST_CASE_FIXTURE(IrBuilderFixture, "DominanceVerification4")
     CHECK(ctx.idf == std::vector<uint32_t>{6, 8});
 }
 
+TEST_CASE_FIXTURE(IrBuilderFixture, "SortedBlockOrderStraightening")
+{
+    IrOp entry = build.block(IrBlockKind::Internal);
+    IrOp body = build.block(IrBlockKind::Internal);
+    IrOp exit = build.block(IrBlockKind::Internal);
+    IrOp guard = build.block(IrBlockKind::Internal);
+
+    build.beginBlock(entry);
+    IrOp limit = build.inst(IrCmd::LOAD_DOUBLE, build.vmReg(0));
+    build.inst(IrCmd::JUMP_CMP_NUM, limit, build.constDouble(1.0), build.cond(IrCondition::NotGreaterEqual), exit, guard);
+
+    build.beginBlock(body);
+    IrOp index = build.inst(IrCmd::LOAD_DOUBLE, build.vmReg(1));
+    build.inst(IrCmd::STORE_DOUBLE, build.vmReg(1), build.inst(IrCmd::ADD_NUM, index, build.constDouble(1.0)));
+    build.inst(IrCmd::JUMP_CMP_NUM, index, limit, build.cond(IrCondition::Less), body, exit);
+
+    build.beginBlock(exit);
+    build.inst(IrCmd::RETURN, build.vmReg(0), build.constInt(1));
+
+    build.beginBlock(guard);
+    build.inst(IrCmd::CHECK_TAG, build.inst(IrCmd::LOAD_TAG, build.vmReg(1)), build.constTag(tnumber), build.vmExit(0));
+    build.inst(IrCmd::JUMP, body);
+
+    updateUseCounts(build.function);
+
+    // Block with a single predecessor is placed right after it, so that both blocks fall through into their successors
+    CHECK(getSortedBlockOrder(build.function) == std::vector<uint32_t>{entry.index, guard.index, body.index, exit.index});
+}
+
 TEST_SUITE_END();
 
 TEST_SUITE_BEGIN("ValueNumbering");
@@ -2938,7 +3152,6 @@ bb_0:
    %0 = DUP_TABLE R0
    STORE_POINTER R0, %0
    CHECK_NO_METATABLE %0, bb_fallback_1
-   CHECK_READONLY %0, bb_fallback_1
    RETURN 0u
 
 bb_fallback_1:
@@ -3256,6 +3469,189 @@ bb_1:
 
 TEST_SUITE_END();
 
+TEST_SUITE_BEGIN("DeadStoreRemoval");
+
+TEST_CASE_FIXTURE(IrBuilderFixture, "OverwrittenStores")
+{
+    IrOp block = build.block(IrBlockKind::Internal);
+
+    build.beginBlock(block);
+
+    IrOp a = build.inst(IrCmd::LOAD_DOUBLE, build.vmReg(0));
+    IrOp b = build.inst(IrCmd::ADD_NUM, a, build.constDouble(1.0));
+
+    // Value and tag are replaced before anything can read them
+    build.inst(IrCmd::STORE_DOUBLE, build.vmReg(1), b);
+    build.inst(IrCmd::STORE_TAG, build.vmReg(1), build.constTag(tnumber));
+    build.inst(IrCmd::STORE_TVALUE, build.vmReg(1), build.inst(IrCmd::LOAD_TVALUE, build.vmReg(2)));
+
+    // Only value part is replaced, tag store has to stay
+    build.inst(IrCmd::STORE_DOUBLE, build.vmReg(3), b);
+    build.inst(IrCmd::STORE_TAG, build.vmReg(3), build.constTag(tnumber));
+    build.inst(IrCmd::STORE_DOUBLE, build.vmReg(3), build.inst(IrCmd::MUL_NUM, b, b));
+
+    // Separate tag and value stores do not cover the whole TValue
+    build.inst(IrCmd::STORE_TVALUE, build.vmReg(4), build.inst(IrCmd::LOAD_TVALUE, build.vmReg(2)));
+    build.inst(IrCmd::STORE_TAG, build.vmReg(4), build.constTag(tnumber));
+    build.inst(IrCmd::STORE_DOUBLE, build.vmReg(4), b);
+
+    build.inst(IrCmd::RETURN, build.vmReg(1), build.constInt(4));
+
+    updateUseCounts(build.function);
+    killDeadStoresInBlocks(build.function);
+
+    CHECK("\n" + toString(build.function, IncludeUseInfo::No) == R"(
+bb_0:
+   %0 = LOAD_DOUBLE R0
+   %1 = ADD_NUM %0, 1
+   %4 = LOAD_TVALUE R2
+   STORE_TVALUE R1, %4
+   STORE_TAG R3, tnumber
+   %8 = MUL_NUM %1, %1
+   STORE_DOUBLE R3, %8
+   %10 = LOAD_TVALUE R2
+   STORE_TVALUE R4, %10
+   STORE_TAG R4, tnumber
+   STORE_DOUBLE R4, %1
+   RETURN R1, 4i
+
+)");
+}
+
+TEST_CASE_FIXTURE(IrBuilderFixture, "ObservedStores")
+{
+    IrOp block = build.block(IrBlockKind::Internal);
+    IrOp fallback = build.block(IrBlockKind::Fallback);
+
+    build.beginBlock(block);
+
+    // Store is read back before it's overwritten
+    build.inst(IrCmd::STORE_DOUBLE, build.vmReg(1), build.constDouble(1.0));
+    build.inst(IrCmd::STORE_DOUBLE, build.vmReg(2), build.inst(IrCmd::LOAD_DOUBLE, build.vmReg(1)));
+    build.inst(IrCmd::STORE_DOUBLE, build.vmReg(1), build.constDouble(2.0));
+
+    // Checks can exit to the fallback code that reads any register
+    build.inst(IrCmd::STORE_DOUBLE, build.vmReg(3), build.constDouble(1.0));
+    build.inst(IrCmd::CHECK_TAG, build.inst(IrCmd::LOAD_TAG, build.vmReg(0)), build.constTag(tnumber), fallback);
+    build.inst(IrCmd::STORE_DOUBLE, build.vmReg(3), build.constDouble(2.0));
+
+    // Instructions with side effects have to remain even if their result store is dead
+    build.inst(IrCmd::STORE_INT, build.vmReg(4), build.inst(IrCmd::CMP_ANY, build.vmReg(0), build.vmReg(1), build.cond(IrCondition::Less)));
+    build.inst(IrCmd::STORE_INT, build.vmReg(4), build.constInt(1));
+
+    build.inst(IrCmd::RETURN, build.vmReg(1), build.constInt(4));
+
+    build.beginBlock(fallback);
+    build.inst(IrCmd::RETURN, build.vmReg(0), build.constInt(1));
+
+    updateUseCounts(build.function);
+    killDeadStoresInBlocks(build.function);
+
+    CHECK("\n" + toString(build.function, IncludeUseInfo::No) == R"(
+bb_0:
+   STORE_DOUBLE R1, 1
+   %1 = LOAD_DOUBLE R1
+   STORE_DOUBLE R2, %1
+   STORE_DOUBLE R1, 2
+   STORE_DOUBLE R3, 1
+   %5 = LOAD_TAG R0
+   CHECK_TAG %5, tnumber, bb_fallback_1
+   STORE_DOUBLE R3, 2
+   %8 = CMP_ANY R0, R1, lt
+   STORE_INT R4, %8
+   STORE_INT R4, 1i
+   RETURN R1, 4i
+
+bb_fallback_1:
+   RETURN R0, 1i
+
+)");
+}
+
+TEST_SUITE_END();
+
+TEST_SUITE_BEGIN("RedundantChecks");
+
+TEST_CASE_FIXTURE(IrBuilderFixture, "TagChecksKnownOnAllIncomingPaths")
+{
+    IrOp entry = build.block(IrBlockKind::Internal);
+    IrOp left = build.block(IrBlockKind::Internal);
+    IrOp right = build.block(IrBlockKind::Internal);
+    IrOp join = build.block(IrBlockKind::Internal);
+    IrOp exit = build.block(IrBlockKind::Internal);
+
+    build.beginBlock(entry);
+    build.inst(IrCmd::CHECK_TAG, build.inst(IrCmd::LOAD_TAG, build.vmReg(0)), build.constTag(ttable), exit);
+    build.inst(IrCmd::JUMP_EQ_TAG, build.inst(IrCmd::LOAD_TAG, build.vmReg(1)), build.constTag(tnil), left, right);
+
+    build.beginBlock(left);
+    build.inst(IrCmd::STORE_TAG, build.vmReg(2), build.constTag(tnumber));
+    build.inst(IrCmd::CHECK_TAG, build.inst(IrCmd::LOAD_TAG, build.vmReg(3)), build.constTag(tnumber), exit);
+    build.inst(IrCmd::JUMP, join);
+
+    build.beginBlock(right);
+    build.inst(IrCmd::STORE_TAG, build.vmReg(2), build.constTag(tnumber));
+    build.inst(IrCmd::JUMP, join);
+
+    build.beginBlock(join);
+    build.inst(IrCmd::CHECK_TAG, build.inst(IrCmd::LOAD_TAG, build.vmReg(0)), build.constTag(ttable), exit); // Known on both paths
+    build.inst(IrCmd::CHECK_TAG, build.inst(IrCmd::LOAD_TAG, build.vmReg(2)), build.constTag(tnumber), exit); // Stored on both paths
+    build.inst(IrCmd::CHECK_TAG, build.inst(IrCmd::LOAD_TAG, build.vmReg(3)), build.constTag(tnumber), exit); // Only known on one path
+    build.inst(IrCmd::RETURN, build.vmReg(0), build.constInt(1));
+
+    build.beginBlock(exit);
+    build.inst(IrCmd::RETURN, build.vmReg(0), build.constInt(0));
+
+    updateUseCounts(build.function);
+    computeCfgInfo(build.function);
+    removeRedundantTagChecks(build);
+    computeCfgInfo(build.function);
+
+    CHECK("\n" + toString(build.function, IncludeUseInfo::No) == R"(
+bb_0:
+; successors: bb_4, bb_1, bb_2
+; in regs: R0, R1, R3
+; out regs: R0, R3
+   %0 = LOAD_TAG R0
+   CHECK_TAG %0, ttable, bb_4
+   %2 = LOAD_TAG R1
+   JUMP_EQ_TAG %2, tnil, bb_1, bb_2
+
+bb_1:
+; predecessors: bb_0
+; successors: bb_4, bb_3
+; in regs: R0, R3
+; out regs: R0, R3
+   STORE_TAG R2, tnumber
+   %5 = LOAD_TAG R3
+   CHECK_TAG %5, tnumber, bb_4
+   JUMP bb_3
+
+bb_2:
+; predecessors: bb_0
+; successors: bb_3
+; in regs: R0, R3
+; out regs: R0, R3
+   STORE_TAG R2, tnumber
+   JUMP bb_3
+
+bb_3:
+; predecessors: bb_1, bb_2
+; successors: bb_4
+; in regs: R0, R3
+   %14 = LOAD_TAG R3
+   CHECK_TAG %14, tnumber, bb_4
+   RETURN R0, 1i
+
+bb_4:
+; predecessors: bb_0, bb_1, bb_3
+   RETURN R0, 0i
+
+)");
+}
+
+TEST_SUITE_END();
+
 TEST_SUITE_BEGIN("Dump");
 
 TEST_CASE_FIXTURE(IrBuilderFixture, "ToDot")
@@ -82,7 +82,8 @@ bb_bytecode_1:
   %6 = NUM_TO_VECTOR 1
   %7 = LOAD_TVALUE R0
   %8 = DIV_VEC %6, %7
-  STORE_TVALUE R1, %8
+  %9 = TAG_VECTOR %8
+  STORE_TVALUE R1, %9
   INTERRUPT 1u
   RETURN R1, 1i
 )");
@@ -106,7 +107,6 @@ bb_2:
   JUMP bb_bytecode_1
 bb_bytecode_1:
   %6 = LOAD_FLOAT R0, 0i
-  STORE_DOUBLE R3, %6
   STORE_TAG R3, tnumber
   %11 = LOAD_FLOAT R0, 4i
   STORE_DOUBLE R4, %11
@@ -145,7 +145,8 @@ bb_bytecode_1:
   %10 = LOAD_TVALUE R0
   %11 = LOAD_TVALUE R1
   %12 = ADD_VEC %10, %11
-  STORE_TVALUE R2, %12
+  %13 = TAG_VECTOR %12
+  STORE_TVALUE R2, %13
   INTERRUPT 1u
   RETURN R2, 1i
 )");
@@ -170,7 +171,8 @@ bb_2:
 bb_bytecode_1:
   %6 = LOAD_TVALUE R0
   %7 = UNM_VEC %6
-  STORE_TVALUE R1, %7
+  %8 = TAG_VECTOR %7
+  STORE_TVALUE R1, %8
   INTERRUPT 1u
   RETURN R1, 1i
 )");
@@ -199,13 +201,16 @@ bb_bytecode_1:
   %14 = LOAD_TVALUE R0
   %15 = LOAD_TVALUE R1
   %16 = MUL_VEC %14, %15
-  STORE_TVALUE R5, %16
-  %22 = LOAD_TVALUE R2
-  %23 = LOAD_TVALUE R3
-  %24 = DIV_VEC %22, %23
-  STORE_TVALUE R6, %24
-  %32 = SUB_VEC %16, %24
-  STORE_TVALUE R4, %32
+  %17 = TAG_VECTOR %16
+  STORE_TVALUE R5, %17
+  %23 = LOAD_TVALUE R2
+  %24 = LOAD_TVALUE R3
+  %25 = DIV_VEC %23, %24
+  %26 = TAG_VECTOR %25
+  STORE_TVALUE R6, %26
+  %34 = SUB_VEC %16, %25
+  %35 = TAG_VECTOR %34
+  STORE_TVALUE R4, %35
   INTERRUPT 3u
   RETURN R4, 1i
 )");
@@ -234,27 +239,30 @@ bb_bytecode_1:
   %12 = LOAD_TVALUE R0
   %13 = NUM_TO_VECTOR 2
   %14 = MUL_VEC %12, %13
-  STORE_TVALUE R7, %14
-  %18 = LOAD_TVALUE R1
-  %19 = NUM_TO_VECTOR 4
-  %20 = DIV_VEC %18, %19
-  STORE_TVALUE R8, %20
-  %28 = ADD_VEC %14, %20
-  STORE_TVALUE R6, %28
+  %19 = LOAD_TVALUE R1
+  %20 = NUM_TO_VECTOR 4
+  %21 = DIV_VEC %19, %20
+  %22 = TAG_VECTOR %21
+  STORE_TVALUE R8, %22
+  %30 = ADD_VEC %14, %21
   STORE_DOUBLE R8, 0.5
   STORE_TAG R8, tnumber
-  %37 = NUM_TO_VECTOR 0.5
-  %38 = LOAD_TVALUE R2
-  %39 = MUL_VEC %37, %38
-  STORE_TVALUE R7, %39
-  %47 = ADD_VEC %28, %39
-  STORE_TVALUE R5, %47
-  %51 = NUM_TO_VECTOR 40
-  %52 = LOAD_TVALUE R3
-  %53 = DIV_VEC %51, %52
-  STORE_TVALUE R6, %53
-  %61 = ADD_VEC %47, %53
-  STORE_TVALUE R4, %61
+  %40 = NUM_TO_VECTOR 0.5
+  %41 = LOAD_TVALUE R2
+  %42 = MUL_VEC %40, %41
+  %43 = TAG_VECTOR %42
+  STORE_TVALUE R7, %43
+  %51 = ADD_VEC %30, %42
+  %52 = TAG_VECTOR %51
+  STORE_TVALUE R5, %52
+  %56 = NUM_TO_VECTOR 40
+  %57 = LOAD_TVALUE R3
+  %58 = DIV_VEC %56, %57
+  %59 = TAG_VECTOR %58
+  STORE_TVALUE R6, %59
+  %67 = ADD_VEC %51, %58
+  %68 = TAG_VECTOR %67
+  STORE_TVALUE R4, %68
   INTERRUPT 8u
   RETURN R4, 1i
 )");
@@ -283,18 +291,15 @@ bb_2:
 bb_bytecode_1:
   CHECK_SAFE_ENV exit(1)
   %16 = FLOOR_NUM R0
-  STORE_DOUBLE R9, %16
   STORE_TAG R9, tnumber
   %23 = CEIL_NUM R1
   STORE_DOUBLE R10, %23
   STORE_TAG R10, tnumber
   %32 = ADD_NUM %16, %23
-  STORE_DOUBLE R8, %32
   STORE_TAG R8, tnumber
   %39 = ROUND_NUM R2
   STORE_DOUBLE R9, %39
   %48 = ADD_NUM %32, %39
-  STORE_DOUBLE R7, %48
   STORE_TAG R7, tnumber
   %55 = SQRT_NUM R3
   STORE_DOUBLE R8, %55
@@ -311,4 +316,242 @@ bb_bytecode_1:
 )");
 }
 
+TEST_CASE("MathNoiseLowering")
+{
+    CHECK_EQ("\n" + getCodegenAssembly(R"(
+local function foo(a: number, b: number, c: number)
+    return math.noise(a) + math.noise(a, b) + math.noise(a, b, c)
+end
+)"),
+        R"(
+; function foo($arg0, $arg1, $arg2) line 2
+bb_0:
+  CHECK_TAG R0, tnumber, exit(entry)
+  CHECK_TAG R1, tnumber, exit(entry)
+  CHECK_TAG R2, tnumber, exit(entry)
+  JUMP bb_2
+bb_2:
+  JUMP bb_bytecode_1
+bb_bytecode_1:
+  CHECK_SAFE_ENV exit(1)
+  %11 = LOAD_DOUBLE R0
+  %12 = INVOKE_LIBM 80u, %11, 0, 0
+  STORE_TAG R5, tnumber
+  %21 = LOAD_DOUBLE R1
+  %22 = INVOKE_LIBM 80u, %11, %21, 0
+  %31 = ADD_NUM %12, %22
+  STORE_DOUBLE R4, %31
+  STORE_TAG R4, tnumber
+  STORE_SPLIT_TVALUE R6, tnumber, %11
+  STORE_SPLIT_TVALUE R7, tnumber, %21
+  %38 = LOAD_TVALUE R2
+  STORE_TVALUE R8, %38
+  %49 = LOAD_DOUBLE R8
+  %50 = INVOKE_LIBM 80u, %11, %21, %49
+  STORE_DOUBLE R5, %50
+  %59 = ADD_NUM %31, %50
+  STORE_DOUBLE R3, %59
+  STORE_TAG R3, tnumber
+  INTERRUPT 21u
+  RETURN R3, 1i
+)");
+}
+
+TEST_CASE("LoopInvariantTagChecks")
+{
+    CHECK_EQ("\n" + getCodegenAssembly(R"(
+local function sum(t: {number}, n: number)
+    local s = 0
+    for i = 1, n do
+        s += t[i]
+    end
+    return s
+end
+)"),
+        R"(
+; function sum($arg0, $arg1) line 2
+bb_0:
+  CHECK_TAG R0, ttable, exit(entry)
+  CHECK_TAG R1, tnumber, exit(entry)
+  JUMP bb_4
+bb_4:
+  JUMP bb_bytecode_1
+bb_bytecode_1:
+  STORE_DOUBLE R2, 0
+  STORE_TAG R2, tnumber
+  STORE_DOUBLE R5, 1
+  STORE_TAG R5, tnumber
+  %10 = LOAD_TVALUE R1
+  STORE_TVALUE R3, %10
+  STORE_DOUBLE R4, 1
+  STORE_TAG R4, tnumber
+  %18 = LOAD_DOUBLE R3
+  JUMP_CMP_NUM 1, %18, not_le, bb_bytecode_3, bb_9
+bb_9:
+  JUMP bb_bytecode_2
+bb_bytecode_2:
+  INTERRUPT 5u
+  %26 = LOAD_POINTER R0
+  %27 = LOAD_DOUBLE R5
+  %28 = TRY_NUM_TO_INDEX %27, bb_fallback_5
+  %29 = SUB_INT %28, 1i
+  CHECK_ARRAY_SIZE %26, %29, bb_fallback_5
+  CHECK_NO_METATABLE %26, bb_fallback_5
+  %32 = GET_ARR_ADDR %26, %29
+  %33 = LOAD_TVALUE %32
+  STORE_TVALUE R6, %33
+  JUMP bb_6
+bb_6:
+  CHECK_TAG R2, tnumber, bb_fallback_7
+  CHECK_TAG R6, tnumber, bb_fallback_7
+  %43 = LOAD_DOUBLE R2
+  %45 = ADD_NUM %43, R6
+  STORE_DOUBLE R2, %45
+  JUMP bb_8
+bb_8:
+  %51 = LOAD_DOUBLE R3
+  %52 = LOAD_DOUBLE R5
+  %53 = ADD_NUM %52, 1
+  STORE_DOUBLE R5, %53
+  JUMP_CMP_NUM %53, %51, le, bb_bytecode_2, bb_bytecode_3
+bb_bytecode_3:
+  INTERRUPT 8u
+  RETURN R2, 1i
+)");
+}
+
+TEST_CASE("ImmutableUpvalueLoad")
+{
+    CHECK_EQ("\n" + getCodegenAssembly(R"(
+local function offset(k: number)
+    return function(x: number)
+        return x + k
+    end
+end
+)"),
+        R"(
+; function($arg0) line 3
+bb_0:
+  CHECK_TAG R0, tnumber, exit(entry)
+  JUMP bb_2
+bb_2:
+  JUMP bb_bytecode_1
+bb_bytecode_1:
+  %4 = GET_CLOSURE_UPVAL_ADDR undef, U0
+  %5 = LOAD_TVALUE %4
+  STORE_TVALUE R2, %5
+  CHECK_TAG R2, tnumber, bb_fallback_3
+  %11 = LOAD_DOUBLE R0
+  %13 = ADD_NUM %11, R2
+  STORE_DOUBLE R1, %13
+  STORE_TAG R1, tnumber
+  JUMP bb_4
+bb_4:
+  INTERRUPT 2u
+  RETURN R1, 1i
+; function offset($arg0) line 2
+bb_0:
+  CHECK_TAG R0, tnumber, exit(entry)
+  JUMP bb_2
+bb_2:
+  JUMP bb_bytecode_1
+bb_bytecode_1:
+  SET_SAVEDPC 1u
+  %5 = LOAD_ENV
+  %6 = NEWCLOSURE 1u, %5, 0u
+  STORE_POINTER R1, %6
+  STORE_TAG R1, tfunction
+  %9 = LOAD_TVALUE R0
+  %10 = GET_CLOSURE_UPVAL_ADDR %6, U0
+  STORE_TVALUE %10, %9
+  CHECK_GC
+  CAPTURE R0, 0u
+  INTERRUPT 2u
+  RETURN R1, 1i
+)");
+}
+
+TEST_CASE("StringByteLowering")
+{
+    CHECK_EQ("\n" + getCodegenAssembly(R"(
+local function foo(s: string, i: number)
+    return string.byte(s, i) + string.byte(s)
+end
+)"),
+        R"(
+; function foo($arg0, $arg1) line 2
+bb_0:
+  CHECK_TAG R0, tstring, exit(entry)
+  CHECK_TAG R1, tnumber, exit(entry)
+  JUMP bb_2
+bb_2:
+  JUMP bb_bytecode_1
+bb_bytecode_1:
+  CHECK_SAFE_ENV exit(2)
+  %11 = LOAD_DOUBLE R1
+  %12 = NUM_TO_INT %11
+  %13 = SUB_INT %12, 1i
+  %14 = LOAD_POINTER R0
+  CHECK_STRING_LEN %14, %13, exit(2)
+  %16 = STRING_READU8 %14, %13
+  %17 = INT_TO_NUM %16
+  STORE_DOUBLE R3, %17
+  STORE_TAG R3, tnumber
+  CHECK_STRING_LEN %14, 0i, exit(8)
+  %25 = STRING_READU8 %14, 0i
+  %26 = INT_TO_NUM %25
+  STORE_DOUBLE R4, %26
+  STORE_TAG R4, tnumber
+  %35 = ADD_NUM %17, %26
+  STORE_DOUBLE R2, %35
+  STORE_TAG R2, tnumber
+  INTERRUPT 13u
+  RETURN R2, 1i
+)");
+}
+
+TEST_CASE("Bit32IntegerArith")
+{
+    CHECK_EQ("\n" + getCodegenAssembly(R"(
+local function foo(a: number, b: number)
+    return bit32.bxor(bit32.bnot(a) - 5, bit32.bnot(b) + 1)
+end
+)"),
+        R"(
+; function foo($arg0, $arg1) line 2
+bb_0:
+  CHECK_TAG R0, tnumber, exit(entry)
+  CHECK_TAG R1, tnumber, exit(entry)
+  JUMP bb_2
+bb_2:
+  JUMP bb_bytecode_1
+bb_bytecode_1:
+  CHECK_SAFE_ENV exit(1)
+  %9 = LOAD_DOUBLE R0
+  %10 = NUM_TO_UINT %9
+  %11 = BITNOT_UINT %10
+  %12 = UINT_TO_NUM %11
+  STORE_TAG R4, tnumber
+  %18 = SUB_NUM %12, 5
+  STORE_DOUBLE R3, %18
+  STORE_TAG R3, tnumber
+  %24 = LOAD_DOUBLE R1
+  %25 = NUM_TO_UINT %24
+  %26 = BITNOT_UINT %25
+  %27 = UINT_TO_NUM %26
+  STORE_DOUBLE R5, %27
+  STORE_TAG R5, tnumber
+  %33 = ADD_NUM %27, 1
+  STORE_DOUBLE R4, %33
+  %43 = SUB_INT %11, 5i
+  %44 = ADD_INT %26, 1i
+  %45 = BITXOR_UINT %43, %44
+  %46 = UINT_TO_NUM %45
+  STORE_DOUBLE R2, %46
+  STORE_TAG R2, tnumber
+  INTERRUPT 17u
+  RETURN R2, 1i
+)");
+}
+
 TEST_SUITE_END();
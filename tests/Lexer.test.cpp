@@ -242,4 +242,73 @@ TEST_CASE("string_interpolation_with_unicode_escape")
     CHECK_EQ(lexer.next().type, Lexeme::Eof);
 }
 
+TEST_CASE("long_runs_keep_exact_locations")
+{
+    const std::string testInput = "local                    averyveryverylongidentifiername_0123456789 = \"a string that is longer than sixteen \\\"chars\\\"\"\n"
+                                  "\n\n    \t  \n          --[[ a long comment\n that spans several lines ] ]=] with text ]] return  -- trailing comment that is "
+                                  "long enough\n"
+                                  "`interpolated string longer than a block {x}`";
+    Luau::Allocator alloc;
+    AstNameTable table(alloc);
+    Lexer lexer(testInput.c_str(), testInput.size(), table);
+
+    CHECK_EQ(lexer.next().type, Lexeme::ReservedLocal);
+
+    Lexeme name = lexer.next();
+    CHECK_EQ(name.type, Lexeme::Name);
+    CHECK_EQ(std::string(name.name), "averyveryverylongidentifiername_0123456789");
+    CHECK_EQ(name.location, Luau::Location(Luau::Position(0, 25), Luau::Position(0, 67)));
+
+    CHECK_EQ(lexer.next().type, '=');
+
+    Lexeme string = lexer.next();
+    CHECK_EQ(string.type, Lexeme::QuotedString);
+    CHECK_EQ(string.location, Luau::Location(Luau::Position(0, 70), Luau::Position(0, 118)));
+
+    Lexeme comment = lexer.next();
+    CHECK_EQ(comment.type, Lexeme::BlockComment);
+    CHECK_EQ(comment.location, Luau::Location(Luau::Position(4, 10), Luau::Position(5, 44)));
+
+    Lexeme ret = lexer.next();
+    CHECK_EQ(ret.type, Lexeme::ReservedReturn);
+    CHECK_EQ(ret.location, Luau::Location(Luau::Position(5, 45), Luau::Position(5, 51)));
+
+    Lexeme trailing = lexer.next();
+    CHECK_EQ(trailing.type, Lexeme::Comment);
+    CHECK_EQ(trailing.location, Luau::Location(Luau::Position(5, 53), Luau::Position(5, 92)));
+
+    Lexeme interp = lexer.next();
+    CHECK_EQ(interp.type, Lexeme::InterpStringBegin);
+    CHECK_EQ(interp.location, Luau::Location(Luau::Position(6, 0), Luau::Position(6, 42)));
+}
+
+TEST_CASE("long_runs_stop_at_broken_strings")
+{
+    const std::string testInput = "\"a string that is longer than sixteen chars\n\"";
+    Luau::Allocator alloc;
+    AstNameTable table(alloc);
+    Lexer lexer(testInput.c_str(), testInput.size(), table);
+
+    Lexeme string = lexer.next();
+    CHECK_EQ(string.type, Lexeme::BrokenString);
+    CHECK_EQ(string.location, Luau::Location(Luau::Position(0, 0), Luau::Position(0, 43)));
+}
+
+TEST_CASE("name_table_can_start_from_a_seed")
+{
+    Luau::Allocator seedAlloc;
+    AstNameTable seed(seedAlloc);
+    AstName math = seed.getOrAdd("math");
+
+    Luau::Allocator alloc;
+    AstNameTable table(alloc, seed);
+
+    CHECK_EQ(table.get("math").value, math.value);
+    CHECK_EQ(table.getWithType("local", 5).second, Lexeme::ReservedLocal);
+
+    AstName other = table.getOrAdd("other");
+    CHECK(other.value != nullptr);
+    CHECK(seed.get("other").value == nullptr);
+}
+
 TEST_SUITE_END();
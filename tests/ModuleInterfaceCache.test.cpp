@@ -0,0 +1,282 @@
+// This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+#include "Luau/ModuleInterfaceCache.h"
+
+#include "Luau/BuiltinDefinitions.h"
+#include "Luau/Frontend.h"
+#include "Luau/Module.h"
+#include "Luau/ToString.h"
+
+#include "Fixture.h"
+
+#include "doctest.h"
+
+#include <unordered_map>
+
+using namespace Luau;
+
+LUAU_FASTFLAG(DebugLuauDeferredConstraintResolution)
+
+namespace
+{
+
+struct MemoryInterfaceCache : ModuleInterfaceCache
+{
+    std::optional<std::string> readInterface(const std::string& key) override
+    {
+        reads++;
+
+        auto it = entries.find(key);
+        if (it == entries.end())
+            return std::nullopt;
+
+        hits++;
+        return it->second;
+    }
+
+    void writeInterface(const std::string& key, const std::string& data) override
+    {
+        entries[key] = data;
+    }
+
+    std::unordered_map<std::string, std::string> entries;
+    int reads = 0;
+    int hits = 0;
+};
+
+struct InterfaceCacheFixture : BuiltinsFixture
+{
+    InterfaceCacheFixture()
+    {
+        addGlobalBinding(frontend.globals, "game", builtinTypes->anyType, "@test");
+
+        frontend.options.retainFullTypeGraphs = false;
+        frontend.interfaceCache = &cache;
+    }
+
+    MemoryInterfaceCache cache;
+};
+
+} // namespace
+
+TEST_SUITE_BEGIN("ModuleInterfaceCacheTests");
+
+TEST_CASE_FIXTURE(BuiltinsFixture, "interface_round_trip")
+{
+    CheckResult result = check(R"(
+        export type Pair<T> = {first: T, second: T}
+        export type Shape = "circle" | "square"
+
+        local M = {}
+
+        function M.swap<T>(p: Pair<T>): Pair<T>
+            return {first = p.second, second = p.first}
+        end
+
+        function M.area(shape: Shape, size: number): number
+            return if shape == "circle" then math.pi * size * size else size * size
+        end
+
+        M.floor = math.floor
+        M.names = {} :: {[string]: boolean?}
+
+        return M
+    )");
+
+    LUAU_REQUIRE_NO_ERRORS(result);
+
+    ModulePtr module = getMainModule();
+
+    std::string data = serializeModuleInterface(*module, builtinTypes, frontend.globals.globalScope);
+    REQUIRE(!data.empty());
+
+    Module loaded;
+    REQUIRE(deserializeModuleInterface(loaded, data, builtinTypes, frontend.globals.globalScope));
+
+    CHECK(toString(loaded.returnType) == toString(module->returnType));
+
+    REQUIRE(loaded.exportedTypeBindings.size() == 2);
+    CHECK(toString(loaded.exportedTypeBindings["Pair"].type) == toString(module->exportedTypeBindings["Pair"].type));
+    CHECK(toString(loaded.exportedTypeBindings["Shape"].type) == toString(module->exportedTypeBindings["Shape"].type));
+    CHECK(loaded.exportedTypeBindings["Pair"].typeParams.size() == 1);
+
+    // global functions are shared instead of copied
+    const TableType* mathTy = get<TableType>(follow(getGlobalBinding(frontend.globals, "math")));
+    REQUIRE(mathTy);
+
+    const TableType* ttv = get<TableType>(follow(first(loaded.returnType).value_or(builtinTypes->nilType)));
+    REQUIRE(ttv);
+    REQUIRE(ttv->props.count("floor"));
+    CHECK(follow(ttv->props.at("floor").type()) == follow(mathTy->props.at("floor").type()));
+
+    // serialization is deterministic, so the data can be used as a hash of the interface
+    CHECK(data == serializeModuleInterface(*module, builtinTypes, frontend.globals.globalScope));
+
+    Module truncated;
+    CHECK(!deserializeModuleInterface(truncated, data.substr(0, data.size() - 1), builtinTypes, frontend.globals.globalScope));
+}
+
+TEST_CASE_FIXTURE(InterfaceCacheFixture, "cached_interfaces_are_used_by_dependents")
+{
+    if (FFlag::DebugLuauDeferredConstraintResolution)
+        return;
+
+    fileResolver.source["game/A"] = R"(
+        export type Point = {x: number, y: number}
+        return {origin = {x = 0, y = 0} :: Point}
+    )";
+    fileResolver.source["game/B"] = R"(
+        local A = require(game.A)
+        local p: A.Point = A.origin
+        return p.x + p.y
+    )";
+
+    LUAU_REQUIRE_NO_ERRORS(frontend.check("game/B"));
+    CHECK(cache.entries.size() == 2);
+    CHECK(cache.hits == 0);
+
+    frontend.clear();
+
+    // a module with errors that depends on the cached interface is still checked against it
+    fileResolver.source["game/C"] = R"(
+        local A = require(game.A)
+        local s: string = A.origin.x
+    )";
+
+    LUAU_REQUIRE_NO_ERRORS(frontend.check("game/B"));
+    CHECK(cache.hits == 2);
+
+    CheckResult result = frontend.check("game/C");
+    LUAU_REQUIRE_ERROR_COUNT(1, result);
+    CHECK(toString(result.errors[0]) == "Type 'number' could not be converted into 'string'");
+    CHECK(cache.hits == 2);
+}
+
+TEST_CASE_FIXTURE(InterfaceCacheFixture, "changes_invalidate_dependents")
+{
+    if (FFlag::DebugLuauDeferredConstraintResolution)
+        return;
+
+    fileResolver.source["game/A"] = "return {value = 1}";
+    fileResolver.source["game/B"] = "local A = require(game.A) return A.value + 1";
+
+    LUAU_REQUIRE_NO_ERRORS(frontend.check("game/B"));
+    CHECK(cache.entries.size() == 2);
+
+    fileResolver.source["game/A"] = "return {value = 'one'}";
+    frontend.markDirty("game/A");
+
+    CheckResult result = frontend.check("game/B");
+    LUAU_REQUIRE_ERROR_COUNT(1, result);
+    CHECK(cache.hits == 0);
+
+    // new interface of A is stored, but B has errors and isn't
+    CHECK(cache.entries.size() == 3);
+}
+
+TEST_CASE_FIXTURE(InterfaceCacheFixture, "shared_cache_fills_local_cache")
+{
+    if (FFlag::DebugLuauDeferredConstraintResolution)
+        return;
+
+    fileResolver.source["game/A"] = "return {value = 1}";
+    fileResolver.source["game/B"] = "local A = require(game.A) return A.value + 1";
+
+    // another machine checks the modules and stores the interfaces in the shared cache
+    MemoryInterfaceCache shared;
+    LayeredModuleInterfaceCache writer{nullptr, &shared};
+    frontend.interfaceCache = &writer;
+
+    LUAU_REQUIRE_NO_ERRORS(frontend.check("game/B"));
+    CHECK(shared.entries.size() == 2);
+
+    frontend.clear();
+
+    // this machine reads them without writing to the shared cache and keeps local copies
+    LayeredModuleInterfaceCache layered{&cache, &shared, /* writeShared */ false};
+    frontend.interfaceCache = &layered;
+
+    LUAU_REQUIRE_NO_ERRORS(frontend.check("game/B"));
+    CHECK(shared.hits == 2);
+    CHECK(cache.entries.size() == 2);
+
+    frontend.clear();
+
+    LUAU_REQUIRE_NO_ERRORS(frontend.check("game/B"));
+    CHECK(cache.hits == 2);
+    CHECK(shared.reads == 4);
+
+    // new interfaces stay local
+    fileResolver.source["game/C"] = "return 1";
+    LUAU_REQUIRE_NO_ERRORS(frontend.check("game/C"));
+    CHECK(cache.entries.size() == 3);
+    CHECK(shared.entries.size() == 2);
+}
+
+TEST_CASE_FIXTURE(InterfaceCacheFixture, "definition_files_are_loaded_from_cache")
+{
+    const std::string source = R"(
+        declare class Vector3
+            x: number
+            function Dot(self, other: Vector3): number
+        end
+
+        declare class Part
+            Name: string
+            Position: Vector3
+        end
+
+        declare class Model extends Part
+            function GetChildren(self): {Part}
+        end
+
+        declare function makePart(name: string): Part
+        declare workspace: Model
+    )";
+
+    ScopePtr scratchScope = std::make_shared<Scope>(frontend.globals.globalScope);
+
+    unfreeze(frontend.globals.globalTypes);
+
+    LoadDefinitionFileResult first = frontend.loadDefinitionFile(frontend.globals, scratchScope, source, "@test", /* captureComments */ false);
+    REQUIRE(first.success);
+    CHECK(first.parseResult.root);
+    CHECK(cache.entries.size() == 1);
+    CHECK(cache.hits == 0);
+
+    LoadDefinitionFileResult second =
+        frontend.loadDefinitionFile(frontend.globals, frontend.globals.globalScope, source, "@test", /* captureComments */ false);
+    freeze(frontend.globals.globalTypes);
+
+    REQUIRE(second.success);
+    CHECK(!second.parseResult.root);
+    CHECK(cache.hits == 1);
+
+    REQUIRE(second.module);
+    CHECK(second.module->declaredGlobals.size() == 2);
+    CHECK(second.module->exportedTypeBindings.size() == 3);
+
+    frontend.options.retainFullTypeGraphs = true;
+
+    CheckResult result = check(R"(
+        local part = makePart("a")
+        local dot = part.Position:Dot(workspace.Position)
+        local children = workspace:GetChildren()
+        local name = children[1].Name
+    )");
+
+    LUAU_REQUIRE_NO_ERRORS(result);
+    CHECK(toString(requireType("part")) == "Part");
+    CHECK(toString(requireType("dot")) == "number");
+    CHECK(toString(requireType("name")) == "string");
+
+    // class hierarchy is restored along with the classes
+    const ClassType* model = get<ClassType>(follow(frontend.globals.globalScope->exportedTypeBindings["Model"].type));
+    REQUIRE(model);
+    REQUIRE(model->parent);
+    CHECK(follow(*model->parent) == follow(frontend.globals.globalScope->exportedTypeBindings["Part"].type));
+
+    CHECK(frontend.globals.globalScope->bindings[frontend.globals.globalNames.names->getOrAdd("workspace")].documentationSymbol ==
+          "@test/global/workspace");
+}
+
+TEST_SUITE_END();
@@ -940,4 +940,22 @@ TEST_CASE_FIXTURE(NormalizeFixture, "normalize_unknown")
     CHECK(toString(normalizer.typeFromNormal(*nt)) == "unknown");
 }
 
+TEST_CASE_FIXTURE(NormalizeFixture, "normal_forms_of_persistent_types_are_shared")
+{
+    TypeArena otherArena;
+    Normalizer otherNormalizer{&otherArena, builtinTypes, NotNull{&unifierState}};
+
+    const NormalizedType* norm = normalizer.normalize(builtinTypes->optionalNumberType);
+    REQUIRE(norm);
+
+    // cache of the normalizer doesn't keep the shared normal form alive
+    normalizer.clearCaches();
+
+    CHECK(otherNormalizer.normalize(builtinTypes->optionalNumberType) == norm);
+    CHECK(toString(normalizer.typeFromNormal(*norm)) == "number?");
+
+    TypeId local = arena.addType(UnionType{{builtinTypes->numberType, builtinTypes->nilType}});
+    CHECK(normalizer.normalize(local) != otherNormalizer.normalize(local));
+}
+
 TEST_SUITE_END();
@@ -1,5 +1,7 @@
 // This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
 #include "Luau/Parser.h"
+#include "Luau/AstJsonEncoder.h"
+#include "Luau/AstFingerprint.h"
 
 #include "AstQueryDsl.h"
 #include "Fixture.h"
@@ -37,6 +39,89 @@ struct Counter
 
 int Counter::instanceCount = 0;
 
+Position getPosition(const std::string& source, size_t offset)
+{
+    Position result{0, 0};
+
+    for (size_t i = 0; i < offset; ++i)
+    {
+        if (source[i] == '\n')
+            result = Position{result.line + 1, 0};
+        else
+            result.column++;
+    }
+
+    return result;
+}
+
+struct IncrementalParseFixture
+{
+    Allocator allocator;
+    AstNameTable names{allocator};
+    ParseOptions options;
+
+    std::string source;
+    ParseResult result;
+
+    IncrementalParseFixture()
+    {
+        options.captureComments = true;
+    }
+
+    void parse(const std::string& text)
+    {
+        source = text;
+        result = Parser::parse(source.data(), source.size(), names, allocator, options);
+    }
+
+    // Replaces the first occurrence of 'from' with 'to' and checks that the result is the same as the one of a full parse
+    void edit(const std::string& from, const std::string& to)
+    {
+        size_t offset = source.find(from);
+        REQUIRE(offset != std::string::npos);
+
+        std::string newSource = source.substr(0, offset) + to + source.substr(offset + from.size());
+
+        ParseEdit edit;
+        edit.range = Location{getPosition(source, offset), getPosition(source, offset + from.size())};
+        edit.newEnd = getPosition(newSource, offset + to.size());
+
+        source = std::move(newSource);
+        result = Parser::parseIncremental(source.data(), source.size(), names, allocator, result, edit, options);
+
+        Allocator fullAllocator;
+        AstNameTable fullNames{fullAllocator};
+        ParseResult full = Parser::parse(source.data(), source.size(), fullNames, fullAllocator, options);
+
+        REQUIRE(result.root);
+        REQUIRE(full.root);
+        CHECK_EQ(toJson(full.root, full.commentLocations), toJson(result.root, result.commentLocations));
+        CHECK_EQ(full.lines, result.lines);
+
+        REQUIRE_EQ(full.errors.size(), result.errors.size());
+
+        for (size_t i = 0; i < full.errors.size(); ++i)
+        {
+            CHECK_EQ(full.errors[i].getLocation(), result.errors[i].getLocation());
+            CHECK_EQ(full.errors[i].getMessage(), result.errors[i].getMessage());
+        }
+
+        REQUIRE_EQ(full.hotcomments.size(), result.hotcomments.size());
+
+        for (size_t i = 0; i < full.hotcomments.size(); ++i)
+        {
+            CHECK_EQ(full.hotcomments[i].header, result.hotcomments[i].header);
+            CHECK_EQ(full.hotcomments[i].location, result.hotcomments[i].location);
+            CHECK_EQ(full.hotcomments[i].content, result.hotcomments[i].content);
+        }
+    }
+
+    AstStat* last()
+    {
+        return result.root->body.data[result.root->body.size - 1];
+    }
+};
+
 // TODO: delete this and replace all other use of this function with matchParseError
 std::string getParseError(const std::string& code)
 {
@@ -104,6 +189,33 @@ TEST_CASE("initial_double_is_aligned")
     CHECK_EQ(0, reinterpret_cast<intptr_t>(one) & (alignof(double) - 1));
 }
 
+TEST_CASE("pages_can_be_sized_to_the_input")
+{
+    Luau::Allocator alloc(100000);
+
+    char* one = static_cast<char*>(alloc.allocate(40000));
+    char* two = static_cast<char*>(alloc.allocate(40000));
+    CHECK_EQ(one + 40000, two);
+
+    char* three = static_cast<char*>(alloc.allocate(40000));
+    CHECK_NE(two + 40000, three);
+}
+
+TEST_CASE("pages_are_reused_by_new_allocators")
+{
+    for (int i = 0; i < 100; ++i)
+    {
+        Luau::Allocator alloc;
+
+        int* first = alloc.alloc<int>(i);
+
+        for (int j = 0; j < 10000; ++j)
+            alloc.alloc<int>(j);
+
+        CHECK_EQ(*first, i);
+    }
+}
+
 TEST_SUITE_END();
 
 TEST_SUITE_BEGIN("ParserTests");
@@ -2291,6 +2403,34 @@ type C<X...> = Packed<(number, X...)>
     REQUIRE(stat != nullptr);
 }
 
+TEST_CASE_FIXTURE(Fixture, "fingerprint_ignores_locations_and_local_names")
+{
+    AstStatBlock* block = parse(R"(
+local up = 1
+local a = function(x: number) return x + up end
+local b = function(y: number)
+    return y    +    up
+end
+local c = function(x: string) return x + up end
+local d = function(x: number) return x + a end
+    )");
+    REQUIRE(block != nullptr);
+    REQUIRE(block->body.size == 5);
+
+    auto fingerprint = [&](size_t index) {
+        AstStatLocal* local = block->body.data[index]->as<AstStatLocal>();
+        REQUIRE(local);
+        return getFingerprint(local->values.data[0]);
+    };
+
+    CHECK(fingerprint(1) == fingerprint(2));
+    CHECK(fingerprint(1).hash == fingerprint(2).hash);
+
+    // annotations and the identity of upvalues are part of the structure
+    CHECK(fingerprint(1) != fingerprint(3));
+    CHECK(fingerprint(1) != fingerprint(4));
+}
+
 TEST_CASE_FIXTURE(Fixture, "invalid_type_forms")
 {
     matchParseError("type A = (b: number)", "Expected '->' when parsing function type, got <eof>");
@@ -3178,3 +3318,117 @@ TEST_CASE_FIXTURE(Fixture, "read_write_table_properties")
 }
 
 TEST_SUITE_END();
+
+TEST_SUITE_BEGIN("IncrementalParserTests");
+
+TEST_CASE_FIXTURE(IncrementalParseFixture, "statements_after_the_edit_are_reused")
+{
+    parse(R"(
+        local t = {}
+        print(t)
+        local a = 1
+        local b = a + 1
+        local c = b * 2
+        print(a, b, c)
+    )");
+
+    AstStat* reused = last();
+
+    edit("a + 1", "a + 10");
+    CHECK(last() == reused);
+
+    // the locals declared by the statements that were parsed again are the ones the reused statements refer to
+    edit("local b = a + 10", "local b =\n\n            a + 100");
+    CHECK(last() == reused);
+
+    edit("local a = 1", "local a = 1; print(a)");
+    CHECK(last() == reused);
+}
+
+TEST_CASE_FIXTURE(IncrementalParseFixture, "statements_after_the_edit_are_parsed_again_when_their_scope_changes")
+{
+    parse(R"(
+        local t = {}
+        print(t)
+        local a = 1
+        local b = a + 1
+        print(a, b)
+    )");
+
+    AstStat* reused = last();
+
+    edit("local b", "local bb");
+    CHECK(last() != reused);
+
+    reused = last();
+
+    edit("local a = 1", "local a = 1 local b = 2");
+    CHECK(last() != reused);
+}
+
+TEST_CASE_FIXTURE(IncrementalParseFixture, "locations_of_reused_statements_are_updated")
+{
+    options.allowDeclarationSyntax = true;
+
+    parse(R"(--!strict
+        local t = {}
+        print(t)
+        local x = 1; local y = x
+
+        -- comment
+        type T<U> = {read: U, [string]: number}
+        local function f(a: number, ...: string): (string, ...T<number>)
+            for i, v in pairs(t) do
+                t.x:y(i, v)
+            end
+
+            while a > 0 do
+                if a == 1 then break elseif a == 2 then a -= 1 else a = a - 2 end
+            end
+
+            return tostring(a), ...
+        end
+        declare function g<V>(a: V): (x: number) -> string --!nolint
+        return f, typeof(x)
+    )");
+
+    AstStat* reused = last();
+
+    edit("x = 1", "x = 100");
+    edit("-- comment", "--[[\nlong comment\n]]");
+    CHECK(last() == reused);
+
+    // edits of the first statement parse the whole source again
+    edit("t = {}", "t = {\n\n}");
+    CHECK(last() != reused);
+}
+
+TEST_CASE_FIXTURE(IncrementalParseFixture, "parse_errors_are_updated")
+{
+    parse(R"(
+        local a = 1
+        local b = a + 1
+        local c = b * 2
+        print(a, b, c
+        print(c)
+    )");
+
+    edit("b * 2", "b *");
+    edit("b *", "b * 3");
+    edit("print(a, b, c", "print(a, b, c)");
+    CHECK(result.errors.empty());
+}
+
+TEST_CASE_FIXTURE(IncrementalParseFixture, "edits_at_the_start_or_the_end")
+{
+    parse(R"(
+        local a = 1
+        local b = a + 1
+    )");
+
+    edit("local a = 1", "local a, z = 1, 2");
+    edit("a + 1", "a + 1\n        return a, b");
+    edit("return a, b", "return a, b\n        print(z)");
+}
+
+TEST_SUITE_END();
@@ -4,8 +4,11 @@
 #include "lua.h"
 #include "lualib.h"
 
+#include "Luau/Compiler.h"
+
 #include "Repl.h"
 #include "FileUtils.h"
+#include "Require.h"
 
 #include "doctest.h"
 
@@ -395,6 +398,29 @@ TEST_CASE_FIXTURE(ReplWithPathFixture, "RequirePathWithParentAlias")
 }
 
 
+TEST_CASE_FIXTURE(ReplWithPathFixture, "RequireSameModuleTwice")
+{
+    ScopedFastFlag sff{FFlag::LuauUpdatedRequireByStringSemantics, true};
+    std::string path = getLuauDirectory(PathType::Relative) + "/tests/require/with_config/src/alias_requirer";
+
+    // second require reuses the resolved path and has to produce the same module
+    runCode(L, "local a = require(\"" + path + "\") return a == require(\"" + path + "\")");
+    assertOutputContainsAll({"true"});
+}
+
+TEST_CASE_FIXTURE(ReplWithPathFixture, "RequirePreloadedModule")
+{
+    ScopedFastFlag sff{FFlag::LuauUpdatedRequireByStringSemantics, true};
+    std::string relativePath = getLuauDirectory(PathType::Relative) + "/tests/require/without_config/preloaded";
+    std::string absolutePath = getLuauDirectory(PathType::Absolute) + "/tests/require/without_config/preloaded";
+
+    // the module doesn't exist on disk, so it can only come from the preloaded bytecode
+    preloadModuleBytecode(absolutePath + ".luau", Luau::compile("return {\"result from bundle\"}"));
+
+    runProtectedRequire(relativePath);
+    assertOutputContainsAll({"true", "result from bundle"});
+}
+
 TEST_CASE_FIXTURE(ReplWithPathFixture, "RequireAliasThatDoesNotExist")
 {
     ScopedFastFlag sff{FFlag::LuauUpdatedRequireByStringSemantics, true};
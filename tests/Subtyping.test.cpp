@@ -1180,6 +1180,33 @@ TEST_CASE_FIXTURE(SubtypeFixture, "results_that_are_contingent_on_generics_are_n
     CHECK(subtyping.peekCache().empty());
 }
 
+TEST_CASE_FIXTURE(SubtypeFixture, "shared_cache_only_keeps_scope_independent_results")
+{
+    SubtypingResultCache sharedCache{{}};
+    subtyping.sharedCache = &sharedCache;
+
+    TypeId returnsNumber = fn({}, {builtinTypes->numberType});
+    TypeId returnsOptionalNumber = fn({}, {builtinTypes->optionalNumberType});
+
+    CHECK_IS_SUBTYPE(returnsNumber, returnsOptionalNumber);
+    CHECK(sharedCache.find({returnsNumber, returnsOptionalNumber}));
+
+    // T is only bound within moduleScope, so the result of this test is different in other scopes
+    TypeId returnsT = fn({}, {genericT});
+    CHECK_IS_NOT_SUBTYPE(returnsNumber, returnsT);
+    CHECK(subtyping.peekCache().find({returnsNumber, returnsT}));
+    CHECK(!sharedCache.find({returnsNumber, returnsT}));
+
+    Subtyping moduleSubtyping = mkSubtyping(moduleScope);
+    moduleSubtyping.sharedCache = &sharedCache;
+
+    CHECK(moduleSubtyping.isSubtype(returnsNumber, returnsT).isSubtype);
+    CHECK(moduleSubtyping.isSubtype(returnsNumber, returnsOptionalNumber).isSubtype);
+    CHECK(moduleSubtyping.peekCache().find({returnsNumber, returnsT}));
+    // the second test was answered from the shared cache without looking at the return types again
+    CHECK(!moduleSubtyping.peekCache().find({builtinTypes->numberType, builtinTypes->optionalNumberType}));
+}
+
 TEST_CASE_FIXTURE(SubtypeFixture, "dont_cache_tests_involving_cycles")
 {
     TypeId tableA = arena.addType(BlockedType{});
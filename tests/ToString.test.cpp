@@ -412,6 +412,49 @@ TEST_CASE_FIXTURE(Fixture, "stringifying_type_is_still_capped_when_exhaustive")
     }
 }
 
+TEST_CASE_FIXTURE(Fixture, "stringifying_large_table_stops_at_the_length_limit")
+{
+    TableType ttv{TableState::Sealed, TypeLevel{}};
+    for (int i = 0; i < 1000; ++i)
+        ttv.props["field" + std::to_string(i)] = {builtinTypes->numberType};
+
+    ToStringOptions o;
+    o.maxTableLength = 0;
+    o.maxTypeLength = 40;
+
+    Type tv{ttv};
+    ToStringResult result = toStringDetailed(&tv, o);
+    CHECK(result.truncated);
+    CHECK(result.name.size() < 80);
+}
+
+TEST_CASE_FIXTURE(Fixture, "to_string_cache_is_keyed_on_options")
+{
+    CheckResult result = check(R"(
+        local function f(x: number, y: string) return x end
+    )");
+    LUAU_REQUIRE_NO_ERRORS(result);
+
+    TypeId fn = requireType("f");
+    ToStringCache cache;
+
+    ToStringOptions o;
+    CHECK_EQ(cache.toString(fn, o), toString(fn));
+    CHECK_EQ(cache.toString(fn, o), toString(fn));
+    CHECK_EQ(1, cache.size());
+
+    ToStringOptions named;
+    named.functionTypeArguments = true;
+    CHECK_EQ(cache.toString(fn, named), "(x: number, y: string) -> number");
+    CHECK_EQ(2, cache.size());
+
+    // A caller-provided name map can change the output, so it bypasses the cache.
+    ToStringOptions withNames;
+    withNames.nameMap.types[builtinTypes->numberType] = "n";
+    cache.toString(fn, withNames);
+    CHECK_EQ(2, cache.size());
+}
+
 TEST_CASE_FIXTURE(Fixture, "stringifying_table_type_correctly_use_matching_table_state_braces")
 {
     TableType ttv{TableState::Sealed, TypeLevel{}};
@@ -123,4 +123,32 @@ TEST_CASE_FIXTURE(TxnLogFixture, "replacing_persistent_types_is_allowed_but_make
     CHECK(log.radioactive);
 }
 
+TEST_CASE_FIXTURE(TxnLogFixture, "concat_into_a_smaller_log_gives_priority_to_the_incoming_log")
+{
+    log.replace(a, BoundType{c});
+    log.replace(b, BoundType{c});
+
+    log2.replace(a, BoundType{b});
+    log2.replace(b, BoundType{builtinTypes.numberType});
+    log2.replace(c, BoundType{builtinTypes.stringType});
+    log2.pending(b)->dead = true;
+
+    log.concat(std::move(log2));
+
+    const PendingType* pa = log.pending(a);
+    REQUIRE(pa != nullptr);
+    CHECK(b == get_if<BoundType>(&pa->pending.ty)->boundTo);
+
+    // A dead incoming entry must not shadow the existing binding.
+    const PendingType* pb = log.pending(b);
+    REQUIRE(pb != nullptr);
+    CHECK(c == get_if<BoundType>(&pb->pending.ty)->boundTo);
+
+    const PendingType* pc = log.pending(c);
+    REQUIRE(pc != nullptr);
+    CHECK(builtinTypes.stringType == get_if<BoundType>(&pc->pending.ty)->boundTo);
+
+    CHECK(3 == log.getChanges().first.size());
+}
+
 TEST_SUITE_END();
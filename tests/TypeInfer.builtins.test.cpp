@@ -519,6 +519,19 @@ TEST_CASE_FIXTURE(BuiltinsFixture, "buffer_is_a_type")
     CHECK("buffer" == toString(requireType("b")));
 }
 
+TEST_CASE_FIXTURE(BuiltinsFixture, "string_unpack_accepts_buffers")
+{
+    CheckResult result = check(R"(
+        local b = buffer.create(10)
+        local x = string.unpack("i4", b)
+        local y = string.unpack("i4", "abcd", 1)
+        local z = string.unpack("i4", true)
+    )");
+
+    LUAU_REQUIRE_ERROR_COUNT(1, result);
+    CHECK(Location{{4, 38}, {4, 42}} == result.errors[0].location);
+}
+
 TEST_CASE_FIXTURE(BuiltinsFixture, "coroutine_resume_anything_goes")
 {
     CheckResult result = check(R"(
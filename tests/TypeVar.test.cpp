@@ -473,4 +473,29 @@ TEST_CASE("content_reassignment")
     CHECK(futureAny->owningArena == &arena);
 }
 
+TEST_CASE_FIXTURE(Fixture, "interned_types_are_shared")
+{
+    TypeArena arena;
+
+    TypeId a = arena.addInternedType(SingletonType{StringSingleton{"a"}});
+    TypeId b = arena.addInternedType(SingletonType{StringSingleton{"b"}});
+
+    CHECK(a == arena.addInternedType(SingletonType{StringSingleton{"a"}}));
+    CHECK(a != b);
+
+    TypeId ab = arena.addInternedType(UnionType{{a, b}});
+
+    CHECK(ab == arena.addInternedType(UnionType{{a, b}}));
+    CHECK(ab != arena.addInternedType(UnionType{{b, a}}));
+    CHECK(ab != arena.addInternedType(IntersectionType{{a, b}}));
+
+    // unions of persistent and interned types are interned as well
+    TypeId optionalAb = arena.addInternedType(UnionType{{builtinTypes->nilType, ab}});
+    CHECK(optionalAb == arena.addInternedType(UnionType{{builtinTypes->nilType, ab}}));
+
+    // types that can be mutated are never shared
+    TypeId free = arena.freshType(TypeLevel{});
+    CHECK(arena.addInternedType(UnionType{{free, a}}) != arena.addInternedType(UnionType{{free, a}}));
+}
+
 TEST_SUITE_END();
@@ -798,14 +798,14 @@ assert((function() function foo(...) return math.abs(...) end return foo(-5) end
 assert((function() function foo(...) local abs = math.abs return abs(...) end return foo(-5) end)() == 5)
 assert((function() local abs = math.abs function foo(...) return abs(...) end return foo(-5) end)() == 5)
 
--- NOTE: getfenv breaks fastcalls for the remainder of the source! hence why this is delayed until the end
+-- NOTE: writes to the environment returned by getfenv break fastcalls for the remainder of the source! hence why this is delayed until the end
 function testgetfenv()
     getfenv()
 
     -- declare constant so that at O2 this test doesn't interfere with constant folding which we can't deoptimize
     local negfive negfive = -5
 
-    -- getfenv breaks fastcalls (we assume we can't rely on knowing the semantics), but behavior shouldn't change
+    -- getfenv alone keeps fastcalls working, and behavior shouldn't change either way
     assert((function() return math.abs(negfive) end)() == 5)
     assert((function() local abs = math.abs return abs(negfive) end)() == 5)
     assert((function() local abs = math.abs function foo() return abs(negfive) end return foo() end)() == 5)
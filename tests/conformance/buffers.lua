@@ -574,6 +574,101 @@ end
 
 fill()
 
+local function bulkops()
+  local b = buffer.create(16)
+
+  buffer.writei32array(b, 0, {1, -2, 0x7fffffff, 0xffffffff})
+  assert(buffer.readi32(b, 0) == 1 and buffer.readi32(b, 4) == -2 and buffer.readi32(b, 8) == 0x7fffffff and buffer.readi32(b, 12) == -1)
+
+  local t = buffer.readi32array(b, 4, 3)
+  assert(#t == 3 and t[1] == -2 and t[2] == 0x7fffffff and t[3] == -1)
+  assert(#buffer.readi32array(b, 16, 0) == 0)
+
+  buffer.writef32array(b, 4, {0.5, "1.5", 1/0}, 2)
+  assert(buffer.readf32(b, 4) == 0.5 and buffer.readf32(b, 8) == 1.5 and buffer.readi32(b, 12) == -1)
+
+  t = buffer.readf32array(b, 4, 2)
+  assert(t[1] == 0.5 and t[2] == 1.5)
+
+  -- elements outside of the array part
+  buffer.writei32array(b, 0, {[1] = 5, [2] = 6, [3] = 7, [4] = 8})
+  assert(buffer.readi32(b, 12) == 8)
+
+  assert(ecall(function() buffer.writei32array(b, 0, {1, "x"}) end) == "invalid value (string) at index 2 in table")
+  assert(ecall(function() buffer.writei32array(b, 0, {1, 2, 3, 4, 5}) end) == "buffer access out of bounds")
+  assert(ecall(function() buffer.readi32array(b, 4, 4) end) == "buffer access out of bounds")
+  assert(ecall(function() buffer.readf32array(b, -4, 1) end) == "buffer access out of bounds")
+  assert(ecall(function() buffer.readi32array(b, 0, -1) end) == "invalid argument #3 to 'readi32array' (count)")
+
+  local p = buffer.fromstring("GET / HTTP/1.1\r\nHost: x\r\n\r\n")
+  assert(buffer.find(p, 0, "\r\n") == 14)
+  assert(buffer.find(p, 15, "\r\n") == 23)
+  assert(buffer.find(p, 0, "\r\n\r\n") == 23)
+  assert(buffer.find(p, 0, "G") == 0)
+  assert(buffer.find(p, 0, "z") == nil)
+  assert(buffer.find(p, 0, "") == 0)
+  assert(buffer.find(p, buffer.len(p), "") == buffer.len(p))
+  assert(buffer.find(p, buffer.len(p), "\n") == nil)
+  assert(ecall(function() buffer.find(p, buffer.len(p) + 1, "") end) == "buffer access out of bounds")
+  assert(ecall(function() buffer.find(p, -1, "") end) == "buffer access out of bounds")
+
+  local q = buffer.fromstring("xxGET /")
+  assert(buffer.equal(p, 0, q, 2, 5) == true)
+  assert(buffer.equal(p, 0, q, 1, 5) == false)
+  assert(buffer.equal(p, 3, q, 0, 0) == true)
+  assert(buffer.equal(q, 0, q, 0, buffer.len(q)) == true)
+  assert(ecall(function() buffer.equal(p, 0, q, 2, 6) end) == "buffer access out of bounds")
+  assert(ecall(function() buffer.equal(p, 0, q, 0, -1) end) == "buffer access out of bounds")
+end
+
+bulkops()
+
+local function externalbuffers()
+  if not externalbuffer then
+    return
+  end
+
+  local b = externalbuffer(16)
+  assert(buffer.len(b) == 16)
+  assert(buffer.tostring(b) == string.rep("\0", 16))
+
+  buffer.writeu8(b, 0, 0xff)
+  buffer.writei16(b, 2, -2)
+  buffer.writeu32(b, 4, 0xdeadbeef)
+  buffer.writef64(b, 8, 1.5)
+  assert(buffer.readi8(b, 0) == -1)
+  assert(buffer.readi16(b, 2) == -2)
+  assert(buffer.readu32(b, 4) == 0xdeadbeef)
+  assert(buffer.readf64(b, 8) == 1.5)
+
+  assert(ecall(function() buffer.readi8(b, 16) end) == "buffer access out of bounds")
+  assert(ecall(function() buffer.readf64(b, 9) end) == "buffer access out of bounds")
+
+  local c = buffer.create(16)
+  buffer.copy(c, 0, b)
+  assert(buffer.equal(b, 0, c, 0, 16))
+  assert(buffer.tostring(b) == buffer.tostring(c))
+
+  buffer.writestring(b, 0, "hello, world")
+  assert(buffer.readstring(b, 7, 5) == "world")
+  assert(buffer.find(b, 0, "world") == 7)
+  assert(buffer.find(b, 8, "world") == nil)
+
+  buffer.writei32array(b, 4, {1, 2, 3})
+  local t = buffer.readi32array(b, 0, 4)
+  assert(t[2] == 1 and t[3] == 2 and t[4] == 3)
+
+  buffer.fill(b, 0, 0x61)
+  assert(buffer.tostring(b) == string.rep("a", 16))
+
+  local e = externalbuffer(0)
+  assert(buffer.len(e) == 0)
+  assert(buffer.find(e, 0, "") == 0)
+  assert(ecall(function() buffer.readu8(e, 0) end) == "buffer access out of bounds")
+end
+
+externalbuffers()
+
 local function misc(t16)
   local b = buffer.create(1000)
 
@@ -618,6 +713,8 @@ local function testslowcalls()
   intuinttricky()
   fromtostring()
   fill()
+  bulkops()
+  externalbuffers()
   misc(table.create(16, 0))
 end
 
@@ -226,6 +226,33 @@ assert((function () return nil end)(4) == nil)
 assert((function () local a; return a end)(4) == nil)
 assert((function (a) return a end)() == nil)
 
+-- polymorphic method calls with methods in different __index slots, including shadowing and missing methods
+do
+  local classes = {}
+  for c = 1, 6 do
+    local C = {}
+    C.__index = C
+    for j = 1, c * 5 do C["pad" .. c .. "_" .. j] = j end
+    function C:get() return c end
+    classes[c] = C
+  end
+
+  local objs = {}
+  for i = 1, 60 do objs[i] = setmetatable({}, classes[i % 6 + 1]) end
+
+  -- object field shadows the method
+  objs[7].get = function() return 0 end
+
+  local sum = 0
+  for r = 1, 3 do
+    for i = 1, #objs do sum += objs[i]:get() end
+  end
+  assert(sum == 3 * (10 * 21 - 2))
+
+  classes[3].get = nil
+  assert(not pcall(function() for i = 1, #objs do objs[i]:get() end end))
+end
+
 -- C-stack overflow while handling C-stack overflow
 if not limitedstack then
   local function loop ()
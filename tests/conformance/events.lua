@@ -468,6 +468,82 @@ do
   end
 end
 
+-- lookups through chains of __index tables are cached and have to observe changes to every link of the chain
+do
+  local Base = {}
+  Base.__index = Base
+  function Base.name() return "base" end
+  Base.value = 1
+
+  local Mid = setmetatable({}, Base)
+  Mid.__index = Mid
+
+  local Leaf = setmetatable({}, Mid)
+  Leaf.__index = Leaf
+
+  local obj = setmetatable({}, Leaf)
+
+  local function get(o, k) return o[k] end
+
+  for i = 1, 3 do
+    assert(obj:name() == "base" and get(obj, "value") == 1 and get(obj, "missing") == nil)
+  end
+
+  -- shadowing in an intermediate table
+  function Mid.name() return "mid" end
+  assert(obj:name() == "mid")
+  Mid.name = nil
+  assert(obj:name() == "base")
+
+  -- new keys that were previously missing
+  Leaf.missing = 42
+  assert(get(obj, "missing") == 42)
+  Leaf.missing = nil
+  Base.missing = 43
+  assert(get(obj, "missing") == 43)
+  Base.missing = nil
+  assert(get(obj, "missing") == nil)
+
+  -- updates and removal in the table that holds the key
+  Base.value = 2
+  assert(get(obj, "value") == 2)
+  Base.value = nil
+  assert(get(obj, "value") == nil)
+  rawset(Base, "value", 3)
+  assert(get(obj, "value") == 3)
+
+  -- redirecting __index and replacing metatables
+  local Other = { value = "other" }
+  Mid.__index = Other
+  assert(get(obj, "value") == "other")
+  Mid.__index = Mid
+  assert(get(obj, "value") == 3)
+  setmetatable(Mid, { __index = Other })
+  assert(get(obj, "value") == "other")
+  setmetatable(Mid, nil)
+  assert(get(obj, "value") == nil)
+
+  -- a metatable appearing at the end of the chain
+  setmetatable(Mid, Base)
+  assert(get(obj, "other") == nil)
+  setmetatable(Base, { __index = function(t, k) return k .. "!" end })
+  assert(get(obj, "other") == "other!")
+  setmetatable(Base, nil)
+  assert(get(obj, "other") == nil)
+
+  -- tables in the chain being collected and replaced
+  for i = 1, 10 do
+    setmetatable(Mid, { __index = { value = i } })
+    collectgarbage()
+    assert(get(obj, "value") == i)
+  end
+
+  -- chains that are longer than the cache supports
+  local t = { deep = "deep" }
+  for i = 1, 10 do t = setmetatable({}, { __index = t }) end
+  assert(t.deep == "deep" and t.deep == "deep")
+end
+
 function testfenv()
   X = 20; B = 30
 
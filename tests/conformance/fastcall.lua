@@ -0,0 +1,44 @@
+-- This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+print("testing fast C functions")
+
+-- arguments that match the signature take the fast path
+local s = 0
+for i = 1, 100 do
+  s += add(i, 1)
+end
+assert(s == 5150)
+
+-- other arguments are handled by the regular function
+assert(add("1", 2) == 3)
+assert(not pcall(function() return add(1) end))
+assert(not pcall(function() return add(1, 2, 3) end))
+
+-- results are adjusted to the number of expected values
+local a, b, c = split(5)
+assert(a == 10 and b == true and c == nil)
+assert(split(-1) == -2)
+assert(select('#', split(5)) == 2)
+local t = {split(3)}
+assert(#t == 2 and t[1] == 6 and t[2] == true)
+
+-- vectors are passed unboxed
+assert(len(vector(3, 4, 0)) == 5)
+local v = scale(vector(1, 2, 3), 2)
+assert(v.X == 2 and v.Y == 4 and v.Z == 6)
+
+-- userdata is matched by tag
+local u = newud(42)
+assert(udvalue(u) == 42)
+assert(not pcall(function() return udvalue({}) end))
+
+-- fast functions can decline the call to let the regular function report errors
+assert(checked(16) == 4)
+local ok, err = pcall(function() return checked(-1) end)
+assert(not ok and err:find("negative"))
+
+-- calls through __call and pcall keep working
+assert(pcall(add, 1, 2))
+local callable = setmetatable({}, { __call = function(self, x) return add(x, x) end })
+assert(callable(2) == 4)
+
+return "OK"
@@ -350,4 +350,27 @@ do
   collectgarbage()
 end
 
+-- weak tables that are modified or lose their weak mode during a collection cycle have to be traversed again
+do
+  local a = setmetatable({}, {__mode = 'v'})
+  local keep = {}
+
+  for i = 1, 1000 do
+    a[i] = {i}
+    if i % 2 == 0 then keep[i] = a[i] end
+
+    -- interleave incremental steps with writes so that some writes land on traversed tables
+    collectgarbage("step")
+
+    if i == 500 then setmetatable(a, nil) end
+  end
+
+  collectgarbage()
+  for i = 1, 1000 do assert(i <= 500 and i % 2 == 1 or a[i][1] == i) end
+
+  setmetatable(a, {__mode = 'v'})
+  collectgarbage()
+  for i = 1, 1000 do assert((a[i] ~= nil) == (i % 2 == 0)) end
+end
+
 return('OK')
@@ -0,0 +1,141 @@
+-- This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+print("testing json library")
+
+local function ecall(fn, ...)
+  local ok, err = pcall(fn, ...)
+  assert(not ok)
+  return err
+end
+
+local function deepeq(a, b)
+  if type(a) ~= "table" or type(b) ~= "table" then
+    return a == b
+  end
+
+  for k, v in a do
+    if not deepeq(v, b[k]) then return false end
+  end
+
+  for k in b do
+    if a[k] == nil then return false end
+  end
+
+  return true
+end
+
+-- scalars
+assert(json.encode(nil) == "null")
+assert(json.encode(true) == "true")
+assert(json.encode(false) == "false")
+assert(json.encode(42) == "42")
+assert(json.encode(-0.5) == "-0.5")
+assert(json.encode(1e22) == "1e+22")
+assert(json.encode(2^53) == "9007199254740992")
+assert(json.encode("hello") == '"hello"')
+
+assert(json.decode("null") == nil)
+assert(json.decode("true") == true)
+assert(json.decode(" false ") == false)
+assert(json.decode("42") == 42)
+assert(json.decode("-0.5") == -0.5)
+assert(json.decode("1e22") == 1e22)
+assert(json.decode("1E-2") == 0.01)
+assert(json.decode("123456789012345") == 123456789012345)
+assert(json.decode("-9007199254740993") == -9007199254740992)
+assert(json.decode("0.1") == 0.1)
+assert(1 / json.decode("-0") < 0)
+
+-- strings
+assert(json.encode("a\"b\\c") == [["a\"b\\c"]])
+assert(json.encode("\n\r\t\b\f") == [["\n\r\t\b\f"]])
+assert(json.encode("\0\1\31") == [["\u0000\u0001\u001f"]])
+assert(json.encode("привет") == '"привет"')
+assert(json.encode(string.rep("abcdefgh", 10) .. "\"") == '"' .. string.rep("abcdefgh", 10) .. '\\""')
+
+assert(json.decode([["a\"b\\c\/"]]) == "a\"b\\c/")
+assert(json.decode([["\n\r\t\b\f"]]) == "\n\r\t\b\f")
+assert(json.decode([["\u0041\u00e9\u20AC"]]) == "Aé€")
+assert(json.decode([["\ud83d\ude00"]]) == "😀")
+assert(json.decode('"' .. string.rep("x", 100) .. '"') == string.rep("x", 100))
+assert(json.decode('"' .. string.rep("x", 100) .. '\\n"') == string.rep("x", 100) .. "\n")
+
+for i = 0, 255 do
+  local s = string.char(i) .. string.rep("q", i % 11) .. string.char(i)
+  assert(json.decode(json.encode(s)) == s)
+end
+
+-- arrays and objects
+assert(json.encode({}) == "[]")
+assert(json.encode({1, 2, 3}) == "[1,2,3]")
+assert(json.encode({{}, {true}}) == "[[],[true]]")
+assert(json.encode({a = 1}) == '{"a":1}')
+assert(json.encode({a = {b = {"c"}}}) == '{"a":{"b":["c"]}}')
+
+assert(deepeq(json.decode("[]"), {}))
+assert(deepeq(json.decode(" [ 1 , 2 , [ 3 ] ] "), {1, 2, {3}}))
+assert(deepeq(json.decode('{"a": 1, "b": [true, false], "c": {"d": "e"}}'), {a = 1, b = {true, false}, c = {d = "e"}}))
+assert(deepeq(json.decode('{"a": 1, "a": 2}'), {a = 2}))
+assert(deepeq(json.decode('{"a": null}'), {}))
+
+do
+  local t = json.decode("[1, null, 3]")
+  assert(t[1] == 1 and t[2] == nil and t[3] == 3)
+end
+
+-- large arrays and objects span multiple decoder batches
+do
+  local arr = {}
+  local obj = {}
+
+  for i = 1, 1000 do
+    arr[i] = i * 0.5
+    obj["k" .. i] = {i, tostring(i)}
+  end
+
+  assert(deepeq(json.decode(json.encode(arr)), arr))
+  assert(deepeq(json.decode(json.encode(obj)), obj))
+
+  local dups = {}
+  for i = 1, 40 do
+    table.insert(dups, '"k":' .. i)
+  end
+
+  assert(json.decode("{" .. table.concat(dups, ",") .. "}").k == 40)
+end
+
+-- encoding errors
+assert(ecall(json.encode, function() end):find("cannot encode function"))
+assert(ecall(json.encode, 0 / 0):find("non%-finite"))
+assert(ecall(json.encode, math.huge):find("non%-finite"))
+assert(ecall(json.encode, {1, nil, 3}))
+assert(ecall(json.encode, {1, a = 2}):find("keys must be"))
+assert(ecall(json.encode, {[true] = 1}):find("keys must be"))
+
+do
+  local t = {}
+  t.self = t
+  assert(ecall(json.encode, t):find("nesting is too deep"))
+end
+
+-- decoding errors
+assert(ecall(json.decode, ""):find("unexpected end of input"))
+assert(ecall(json.decode, "[1,]"):find("position 4"))
+assert(ecall(json.decode, "[1 2]"):find("expected ',' or ']'"))
+assert(ecall(json.decode, '{"a" 1}'):find("expected ':'"))
+assert(ecall(json.decode, "{1: 2}"):find("expected string key"))
+assert(ecall(json.decode, "1 2"):find("unexpected character after value"))
+assert(ecall(json.decode, "tru"):find("unexpected character"))
+assert(ecall(json.decode, "01"):find("unexpected character after value"))
+assert(ecall(json.decode, "1."):find("invalid number"))
+assert(ecall(json.decode, "-"):find("invalid number"))
+assert(ecall(json.decode, "0x10"):find("unexpected character after value"))
+assert(ecall(json.decode, "NaN"):find("unexpected character"))
+assert(ecall(json.decode, '"abc'):find("unterminated string"))
+assert(ecall(json.decode, '"a\nb"'):find("control character"))
+assert(ecall(json.decode, [["\x"]]):find("invalid escape"))
+assert(ecall(json.decode, [["\u12"]]):find("invalid unicode escape"))
+assert(ecall(json.decode, [["\ud83d"]]):find("invalid unicode escape"))
+assert(ecall(json.decode, [["\ude00"]]):find("invalid unicode escape"))
+assert(ecall(json.decode, string.rep("[", 1000) .. string.rep("]", 1000)):find("nesting is too deep"))
+
+return 'OK'
@@ -128,6 +128,24 @@ assert(eq(math.tanh(3.5), math.sinh(3.5)/math.cosh(3.5)))
 assert(tonumber(' 1.3e-2 ') == 1.3e-2)
 assert(tonumber(' -1.00000000000001 ') == -1.00000000000001)
 
+-- decimal conversion near the limits of the exact fast path
+assert(tonumber('9007199254740992') == 2^53)
+assert(tonumber('9007199254740993') == 2^53)
+assert(tonumber('9007199254740995') == 2^53 + 4)
+assert(tonumber('1e22') == 10^22 and tonumber('1e23') == 1e23 and tonumber('1e-22') == 1e-22)
+assert(tonumber('123456789e-30') == 1.23456789e-22)
+assert(tonumber('0.1') + tonumber('0.2') == 0.30000000000000004)
+assert(tonumber('00000000000000000000001') == 1)
+assert(1 / tonumber('-0') < 0 and 1 / tonumber('-0e5') < 0)
+assert(tonumber('1e99999') == math.huge and tonumber('1e-99999') == 0)
+assert(tonumber('0x10') == 16 and tonumber('1e') == nil and tonumber('1.5 ') == 1.5)
+
+for i = 1, 1000 do
+  local x = math.random() * 10 ^ math.random(-30, 30)
+  assert(tonumber(tostring(x)) == x)
+  assert(tonumber(string.format("%.17g", x)) == x)
+end
+
 -- testing constant limits
 -- 2^23 = 8388608
 assert(8388609 + -8388609 == 0)
@@ -278,6 +296,72 @@ assert(math.noise(0.5) == 0)
 assert(math.noise(0.5, 0.5) == -0.25)
 assert(math.noise(0.5, 0.5, -0.5) == 0.125)
 assert(math.noise(455.7204209769105, 340.80410508750134, 121.80087666537628) == 0.5010709762573242)
+assert(math.noise(0.5, nil, -0.5) == math.noise(0.5, 0, -0.5))
+assert(math.noise(0.5, 0.5, nil) == math.noise(0.5, 0.5))
+
+do
+  local function noises(x, y, z) return math.noise(x), math.noise(x, y), math.noise(x, y, z), math.noise(z, x, y), math.noise(y, z, x) end
+  local a, b, c, d, e = noises(0.3, 1.7, -2.9)
+  assert(a == math.noise(0.3, 0, 0) and b == math.noise(0.3, 1.7, 0) and c == math.noise(0.3, 1.7, -2.9))
+  assert(d == math.noise(-2.9, 0.3, 1.7) and e == math.noise(1.7, -2.9, 0.3))
+end
+
+-- noise over a grid matches individual noise calls, including points that can't use the vector path
+do
+  local function checkgrid(sx, sy, sz, x, y, z, step)
+    local b = buffer.create(4 + sx * sy * sz * 4)
+    math.noisegrid(b, 4, sx, sy, sz, x, y, z, step)
+
+    for k = 0, sz - 1 do
+      for j = 0, sy - 1 do
+        for i = 0, sx - 1 do
+          local expected = math.noise(x + i * (step or 1), y + j * (step or 1), z + k * (step or 1))
+          assert(buffer.readf32(b, 4 + ((k * sy + j) * sx + i) * 4) == expected)
+        end
+      end
+    end
+  end
+
+  checkgrid(7, 3, 2, 0.25, -1.5, 3.75, 0.37)
+  checkgrid(300, 1, 1, -40.1, 2.2, 0.3, 0.29)
+  checkgrid(9, 2, 2, 455.7204209769105, 340.80410508750134, 121.80087666537628)
+  checkgrid(8, 1, 1, 8388600, 0.5, 0.5, 1.5)
+  checkgrid(0, 4, 4, 0, 0, 0)
+
+  local b = buffer.create(16)
+  assert(not pcall(math.noisegrid, b, 0, 2, 2, 2, 0, 0, 0))
+  assert(not pcall(math.noisegrid, b, -4, 1, 1, 1, 0, 0, 0))
+  assert(not pcall(math.noisegrid, b, 0, -1, 1, 1, 0, 0, 0))
+end
+
+-- sqrt and sin over buffer ranges
+do
+  local function f32(v)
+    local t = buffer.create(4)
+    buffer.writef32(t, 0, v)
+    return buffer.readf32(t, 0)
+  end
+
+  local b = buffer.create(4 * 11)
+  for i = 0, 10 do buffer.writef32(b, i * 4, i * 1.7) end
+
+  math.sqrtbuffer(b, 4, 9)
+  assert(buffer.readf32(b, 0) == 0)
+  assert(buffer.readf32(b, 40) == f32(10 * 1.7))
+  for i = 1, 9 do
+    assert(buffer.readf32(b, i * 4) == f32(math.sqrt(f32(i * 1.7))))
+  end
+
+  for i = 0, 10 do buffer.writef32(b, i * 4, i * 0.9 - 3) end
+
+  math.sinbuffer(b, 0, 11)
+  for i = 0, 10 do
+    assert(buffer.readf32(b, i * 4) == f32(math.sin(f32(i * 0.9 - 3))))
+  end
+
+  assert(not pcall(math.sqrtbuffer, b, 4, 11))
+  assert(not pcall(math.sinbuffer, b, 0, -1))
+end
 
 local inf = math.huge * 2
 local nan = 0 / 0
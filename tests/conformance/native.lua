@@ -293,6 +293,20 @@ end
 
 assert(loopIteratorProtocol(0, table.create(100, 5)) == 5058)
 
+function loopInvariantScale(v, n)
+  local sum = v * 0
+
+  for i = 1, n do
+    sum += v * i
+  end
+
+  return sum
+end
+
+assert(loopInvariantScale(2, 10) == 110)
+assert(loopInvariantScale(vector(1, 2, 3), 10) == vector(55, 110, 165))
+assert(loopInvariantScale(2, 0) == 0)
+
 local function vec3compsum(a: vector)
   return a.X + a.Y + a.Z
 end
@@ -317,6 +331,16 @@ local function vec3mulconst(a: vector) return a * 4 end
 assert(vec3mulnum(vector(10, 20, 40), 4) == vector(40, 80, 160))
 assert(vec3mulconst(vector(10, 20, 40), 4) == vector(40, 80, 160))
 
+local function vec3chain(a: vector, b: vector)
+  local t = -(a * b) + a / 2
+  return t, t - b, typeof(t)
+end
+
+do
+  local t, u, ty = vec3chain(vector(2, 4, 8), vector(1, 2, 4))
+  assert(t == vector(-1, -6, -28) and u == vector(-2, -8, -32) and ty == "vector")
+end
+
 local function bufferbounds(zero)
   local b1 = buffer.create(1)
   local b2 = buffer.create(2)
@@ -389,4 +413,55 @@ end
 
 bufferbounds(0)
 
+local function stringbyte(s: string, i: number)
+  return string.byte(s, i), string.byte(s), (string.byte(s, i))
+end
+
+do
+  local a, b, c = stringbyte("abc", 1)
+  assert(a == 97 and b == 97 and c == 97)
+  a, b, c = stringbyte("abc", 3)
+  assert(a == 99 and b == 97 and c == 99)
+
+  -- negative, fractional and out of range positions go through the VM
+  a, b, c = stringbyte("abc", -1)
+  assert(a == 99 and b == 97 and c == 99)
+  a, b, c = stringbyte("abc", 2.5)
+  assert(a == 98 and b == 97 and c == 98)
+  assert(select('#', stringbyte("abc", 4)) == 3 and stringbyte("abc", 4) == nil and stringbyte("abc", 0) == nil)
+  assert(select(2, stringbyte("", 1)) == nil)
+  assert(stringbyte("\255\0", 2) == 0 and stringbyte("\255", 1) == 255)
+end
+
+local function stringsum(s: string)
+  local sum = 0
+  for i = 1, #s do
+    sum += string.byte(s, i)
+  end
+  return sum
+end
+
+assert(stringsum("") == 0)
+assert(stringsum("hello") == 532)
+assert(stringsum(string.rep("\1", 1000)) == 1000)
+
+local function bit32arith(a: number, b: number)
+  return bit32.bxor(bit32.bnot(a) - 5, bit32.bnot(b) + 1), bit32.band(bit32.bnot(a) + 4294967295, bit32.bnot(b) - -3)
+end
+
+do
+  local function check(a, b)
+    local x, y = bit32arith(a, b)
+    assert(x == bit32.bxor((0xffffffff - a % 2^32) - 5, (0xffffffff - b % 2^32) + 1))
+    assert(y == bit32.band((0xffffffff - a % 2^32) + 4294967295, (0xffffffff - b % 2^32) + 3))
+  end
+
+  check(0, 0)
+  check(1, 2)
+  check(0xfffffffe, 0xffffffff)
+  check(0xfffffffb, 0x80000000)
+  check(-1, -2)
+  check(12345678, 87654321)
+end
+
 return('OK')
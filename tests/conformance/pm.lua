@@ -314,4 +314,35 @@ assert(string.match("abc\0\0\0", "%\0%\0?") == "\0\0")
 assert(string.find("abc\0\0","\0.") == 4)
 assert(string.find("abcx\0\0abc\0abc","x\0\0abc\0a.") == 4)
 
+-- compiled patterns are reused across calls and collections
+do
+  local function check()
+    for i = 1, 200 do
+      local p = "^(%a+)" .. string.rep("[%d_]", i % 5) .. "(-?)%s*$"
+      assert(string.match("abc" .. string.rep("1", i % 5) .. "  ", p) == "abc")
+      assert(string.find("x1-", "%a%d(%-?)", 1) == 1)
+      assert(string.gsub("hello world", "%w+", "%0 %0") == "hello hello world world")
+      assert(string.gsub("^a^a", "^%^a", "") == "^a")
+    end
+  end
+
+  check()
+  collectgarbage()
+  check()
+
+  local n = 0
+  for k in string.gmatch("^a ^b ^c", "^%a") do n += 1 end
+  assert(n == 3)
+  assert(string.find("^a", "^a") == nil)
+
+  -- the same class is matched differently depending on the anchor
+  assert(string.match("^^a", "^^") == "^")
+  for k in string.gmatch("^^a", "^^") do assert(k == "^^") end
+
+  -- malformed patterns are still reported when reached
+  assert(string.find("b", "a[") == nil)
+  assert(not pcall(string.find, "a", "a["))
+  assert(not pcall(string.find, "a", "a["))
+end
+
 return('OK')
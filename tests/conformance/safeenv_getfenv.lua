@@ -0,0 +1,66 @@
+-- This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+print("safeenv getfenv")
+
+-- getfenv keeps the environment safe until it's written to, so every way of writing to it has to be observed
+
+local function getfenvWithoutWrites()
+	local ten
+	ten = 10
+
+	local env = getfenv()
+	assert(env == getfenv(0) and env == getfenv(1))
+	assert(math.abs(-ten) == 10)
+	assert((function() local abs = math.abs return abs(-ten) end)() == 10)
+	assert(rawget(env, "math") == nil)
+	assert(env.math == math)
+end
+
+local function envChangeInCoroutine()
+	local ten
+	ten = 10
+
+	local co = coroutine.wrap(function()
+		local env = getfenv(0)
+		coroutine.yield()
+		env.math = { abs = function(n) return n * 3 end }
+	end)
+
+	co()
+	assert(math.abs(-ten) == 10)
+	co()
+	assert(math.abs(-ten) == -30)
+
+	getfenv().math = nil
+	assert(math.abs(-ten) == 10)
+end
+
+local function envMetatableChange()
+	local ten
+	ten = 10
+
+	local env = getfenv()
+	local mt = getmetatable(env)
+	setmetatable(env, { __index = setmetatable({ math = { abs = function(n) return n + 1 end } }, mt) })
+	assert(math.abs(ten) == 11)
+	setmetatable(env, mt)
+	assert(math.abs(-ten) == 10)
+end
+
+local function envRawsetChange()
+	local ten
+	ten = 10
+
+	local env = getfenv()
+	local function square() return math.abs(ten) end
+
+	rawset(env, "math", { abs = function(n) return n * n end })
+	assert(square() == 100)
+	assert(math.abs(ten) == 100)
+end
+
+getfenvWithoutWrites()
+envChangeInCoroutine()
+envMetatableChange()
+envRawsetChange()
+
+return "OK"
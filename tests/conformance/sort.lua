@@ -33,6 +33,28 @@ checksort({3, 1, 1, 7, 1, 3, 5, 1, 9, 3}, nil, 1, 1, 1, 1, 3, 3, 3, 5, 7, 9)
 -- predicates
 checksort({3, 8, 1, 7, 10, 2, 5, 4, 9, 6}, function (a, b) return a > b end, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1)
 
+-- homogeneous arrays
+do
+  local nums, strs = {}, {}
+  for i = 1, 1000 do
+    nums[i] = (i * 7919) % 1009 - 500.5
+    strs[i] = tostring((i * 7919) % 1009)
+  end
+  table.sort(nums)
+  table.sort(strs)
+  for i = 2, 1000 do
+    assert(nums[i - 1] <= nums[i])
+    assert(strs[i - 1] <= strs[i])
+  end
+
+  checksort({-0, 0, -1, 1, math.huge, -math.huge}, nil, -math.huge, -1, 0, 0, 1, math.huge)
+  checksort({"b", "", "ab", "a\0", "a"}, nil, "", "a", "a\0", "ab", "b")
+
+  -- arrays with mixed types still fail the comparison
+  assert(pcall(table.sort, {1, "2", 3}) == false)
+  assert(pcall(table.sort, {"1", "2", 3}) == false)
+end
+
 -- can't sort readonly tables
 assert(pcall(table.sort, table.freeze({2, 1})) == false)
 
@@ -28,6 +28,8 @@ assert(string.sub("123456789",7,7) == "7")
 assert(string.sub("123456789",0,0) == "")
 assert(string.sub("123456789",-10,10) == "123456789")
 assert(string.sub("123456789",1,9) == "123456789")
+assert(string.sub(123456789, 1) == "123456789" and type(string.sub(123456789, 1, 9)) == "string")
+assert(string.sub("", 1) == "" and string.sub("", 1, 0) == "")
 assert(string.sub("123456789",-10,-20) == "")
 assert(string.sub("123456789",-1) == "9")
 assert(string.sub("123456789",-4) == "6789")
@@ -49,6 +51,12 @@ assert(string.find('', 'aaa', 1) == nil)
 assert(('alo(.)alo'):find('(.)', 1, 1) == 4)
 assert(string.find('', '1', 2) == nil)
 assert(string.find('123', '2', 0) == 2)
+assert(string.find("abacabad", "abad", 1, true) == 5)
+assert(string.find("aab", "ab", 1, true) == 2)
+assert(string.find("abcab", "ab", 2, true) == 4)
+assert(string.find("abc", "ac", 1, true) == nil)
+assert(string.find("a\0b\0c", "\0c", 1, true) == 4)
+assert(string.find(string.rep("a", 1000) .. "b", string.rep("a", 10) .. "b", 1, true) == 991)
 print('+')
 
 assert(string.len("") == 0)
@@ -101,6 +109,12 @@ for i=0,30 do assert(string.len(string.rep('a', i)) == i) end
 assert(type(tostring(nil)) == 'string')
 assert(type(tostring(12)) == 'string')
 assert(''..12 == '12' and type(12 .. '') == 'string')
+assert('' .. 'alo' == 'alo' and '' .. '' == '' and '' .. 'a' .. '' .. 'b' == 'ab')
+do
+  local acc = ''
+  for i = 1, 100 do acc = acc .. i % 10 end
+  assert(#acc == 100 and acc:sub(1, 11) == '12345678901')
+end
 assert(string.find(tostring{}, 'table:'))
 assert(string.find(tostring(print), 'function:'))
 assert(tostring(1234567890123) == '1234567890123')
@@ -136,6 +150,10 @@ assert(string.format('"-%20s.20s"', string.rep("%", 2000)) ==
        string.format("%q", "-"..string.rep("%", 2000)..".20s"))
 
 assert(string.format("%o %u %x %X", -1, -1, -1, -1) == "1777777777777777777777 18446744073709551615 ffffffffffffffff FFFFFFFFFFFFFFFF")
+assert(string.format("%d %i %d %d %d", 0, -7, 123.9, -123.9, -2^53) == "0 -7 123 -123 -9007199254740992")
+assert(string.format("%u %x %X %x", 0, 0, 3054, 2^40 + 255) == "0 0 BEE 100000000ff")
+assert(string.format("%5d|%-5x|%+d|%05u", 42, 42, 42, 42) == "   42|2a   |+42|00042")
+assert(string.format("a%db\0c%%%xd", 1, 255) == "a1b\0c%ffd")
 
 assert(string.format("%e %E", 1.5, -1.5) == "1.500000e+00 -1.500000E+00")
 
@@ -196,6 +214,10 @@ assert(table.concat(a, "b", 20, 20) == "xuxu")
 assert(table.concat(a, "", 20, 21) == "xuxuxuxu")
 assert(table.concat(a, "", 22, 21) == "")
 assert(table.concat(a, "3", 2999) == "xuxu3xuxu")
+assert(table.concat({"a", 1, "b"}, "-") == "a-1-b")
+assert(table.concat({"a", "b", [4] = "d"}, "-", 1, 2) == "a-b")
+assert(pcall(table.concat, {"a", {}, "b"}) == false)
+assert(table.concat(string.split(string.rep("ab,", 100), ","), "") == string.rep("ab", 100))
 
 a = {"a","b","c"}
 assert(table.concat(a, ",", 1, 0) == "")
@@ -223,6 +245,14 @@ do
   assert(eq(string.split("abc", "b"), {'a', 'c'}))
   assert(eq(string.split("abc", "d"), {'abc'}))
   assert(eq(string.split("abc", "c"), {'ab', ''}))
+  assert(eq(string.split("", ""), {}))
+  assert(eq(string.split("", ","), {''}))
+  assert(eq(string.split("a,,b,", ","), {'a', '', 'b', ''}))
+  assert(eq(string.split("a::b:::c", "::"), {'a', 'b', ':c'}))
+  assert(eq(string.split("aaaa", "aa"), {'', '', ''}))
+  assert(eq(string.split("a\0b\0\0c", "\0"), {'a', 'b', '', 'c'}))
+  assert(eq(string.split("ab", "abc"), {'ab'}))
+  assert(eq(string.split(string.rep("x", 100) .. "<>" .. string.rep("y", 100), "<>"), {string.rep("x", 100), string.rep("y", 100)}))
 end
 
 -- validate that variadic string fast calls get correct number of arguments
@@ -232,6 +262,69 @@ end
 
 assert(chr1("0") == "\0")
 
+-- string interning stays consistent while the string table grows
+do
+  local t = {}
+  for i = 1, 20000 do t[i] = "intern" .. i end
+  for i = 1, 20000 do assert(t[i] == "intern" .. i) end
+  local k = {}
+  for i = 1, 20000, 7 do k["intern" .. i] = i end
+  for i = 1, 20000, 7 do assert(k[t[i]] == i) end
+  t, k = nil, nil
+  collectgarbage()
+  for i = 1, 20000, 13 do assert(#("intern" .. i) == 6 + #tostring(i)) end
+end
+
+-- string.builder
+do
+  local b = string.builder()
+  assert(typeof(b) == "StringBuilder")
+  assert(b:tostring() == "" and #b == 0)
+
+  assert(b:append("a", 1, "b") == b)
+  assert(tostring(b) == "a1b" and b:len() == 3)
+
+  b:appendf("%d-%s-%q", 42, "x", "y\n")
+  assert(b:tostring() == 'a1b42-x-"y\\\n"')
+
+  -- growth keeps the contents and results are regular interned strings
+  local parts = {}
+  for i = 1, 1000 do
+    b:append(i, ",")
+    parts[#parts + 1] = tostring(i) .. ","
+  end
+  local expected = 'a1b42-x-"y\\\n"' .. table.concat(parts)
+  assert(b:tostring() == expected)
+  local t = {[expected] = true}
+  assert(t[b:tostring()])
+
+  -- builder filled exactly to the reserved size, followed by more appends and a clear
+  local e = string.builder(5)
+  e:append("hello")
+  local s = e:tostring()
+  assert(s == "hello" and e:tostring() == "hello")
+  e:append(" world")
+  assert(e:tostring() == "hello world" and s == "hello")
+  e:clear()
+  assert(e:tostring() == "" and s == "hello")
+  e:append("bye")
+  assert(e:tostring() == "bye")
+
+  -- results stay valid after the builders are collected
+  for i = 1, 100 do
+    local c = string.builder()
+    c:append(string.rep("z", i))
+    s = c:tostring()
+  end
+  collectgarbage()
+  assert(s == string.rep("z", 100))
+
+  assert(not pcall(b.append, b, {}))
+  assert(not pcall(b.append, {}, "x"))
+  assert(not pcall(string.builder, -1))
+  assert(getmetatable(b) == "The metatable is locked")
+end
+
 --[[
 local locales = { "ptb", "ISO-8859-1", "pt_BR" }
 local function trylocale (w)
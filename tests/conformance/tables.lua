@@ -410,6 +410,36 @@ do
 
   -- make sure table.find checks the hash portion as well by constructing a table literal that forces the value into the hash part
   assert(table.find({[(1)] = true}, true) == 1)
+
+  -- the array part scan has to agree with equality semantics for every value type and stop at the first nil
+  local big = {}
+  for i = 1, 100 do big[i] = i * 2 end
+  assert(table.find(big, 2) == 1 and table.find(big, 200) == 100 and table.find(big, 201) == nil)
+  assert(table.find(big, 50, 25) == 25 and table.find(big, 50, 26) == nil)
+  for i = 1, 100 do assert(table.find(big, i * 2) == i) end
+
+  local zeroes = {1, 2, 3, 4, 5, -0}
+  assert(table.find(zeroes, 0) == 6 and table.find({1, 2, 3, 4, 5, 0}, -0) == 6)
+  local nan = 0/0
+  assert(table.find({1, 2, 3, 4, nan, 6}, nan) == nil)
+
+  local holes = {1, 2, 3, 4, 5, 6, 7, 8}
+  holes[3] = nil
+  assert(table.find(holes, 7) == nil and table.find(holes, 7, 4) == 7)
+
+  local mixed = {"a", 1, true, false, print, coroutine.create(print), buffer.create(1), vector(1, 2, 3), {}, "b"}
+  for i, v in mixed do assert(table.find(mixed, v) == i) end
+  assert(table.find(mixed, "b") == 10 and table.find(mixed, vector(1, 2, 3)) == 8 and table.find(mixed, {}) == nil)
+
+  -- elements with __eq are only consulted when the searched value has the same metamethod
+  local mt = { __eq = function() return true end }
+  local eqs = {1, 2, 3, 4, setmetatable({}, mt)}
+  assert(table.find(eqs, setmetatable({}, mt)) == 5 and table.find(eqs, {}) == nil)
+
+  -- values stored past the array part are found by continuing into the hash part
+  local spill = table.create(4, 0)
+  spill[5] = "x"
+  assert(table.find(spill, "x") == 5 and table.find(spill, "x", 5) == 5)
 end
 
 -- test indexing with strings that have zeroes embedded in them
@@ -532,6 +562,133 @@ do
   assert(not pcall(table.clone, 42))
 end
 
+-- test clones of large tables that share storage until the first write
+do
+  local t = {}
+  for i = 1, 100 do t[i] = i end
+  for i = 1, 100 do t["k" .. i] = i end
+
+  local a = table.clone(t)
+  local b = table.clone(t)
+  local c = table.clone(a)
+
+  -- writes to either side stay private
+  a[1] = -1
+  a.k1 = -1
+  assert(t[1] == 1 and t.k1 == 1 and b[1] == 1 and c.k1 == 1)
+
+  t[2] = -2
+  t.new = true
+  assert(a[2] == 2 and b[2] == 2 and c[2] == 2 and b.new == nil)
+
+  rawset(b, 3, -3)
+  table.insert(c, 101)
+  assert(t[3] == 3 and #b == 100 and #c == 101 and #t == 100)
+
+  -- clearing a clone leaves the other tables intact
+  table.clear(b)
+  assert(next(b) == nil and t[50] == 50 and c.k50 == 50)
+
+  -- frozen templates produce writable clones and stay frozen
+  local f = table.freeze(table.clone(t))
+  local fc = table.clone(f)
+  assert(table.isfrozen(f) and not table.isfrozen(fc))
+  fc[1] = 0
+  assert(f[1] == 1 and not pcall(function() f[1] = 0 end))
+
+  -- sort predicate can clone the table that is being sorted
+  local s = {}
+  for i = 1, 100 do s[i] = 101 - i end
+  local snapshot
+  table.sort(s, function(x, y)
+    if not snapshot then snapshot = table.clone(s) end
+    return x < y
+  end)
+  assert(s[1] == 1 and s[100] == 100 and snapshot[1] == 100 and snapshot[100] == 1)
+
+  -- shared storage is released once all tables that use it are collected
+  t, a, b, c, f, fc, s, snapshot = nil
+  collectgarbage()
+end
+
+-- test table.reserve
+do
+  local t = {}
+  table.reserve(t, 100, 8)
+  assert(#t == 0 and next(t) == nil)
+
+  for i=1,100 do t[i] = i end
+  for i=1,8 do t["k" .. i] = i end
+  assert(#t == 100 and t[100] == 100 and t.k8 == 8)
+
+  -- reserving less than the current size keeps the contents
+  table.reserve(t, 10)
+  assert(#t == 100 and t.k1 == 1)
+
+  -- keys stored in the hash part move to the reserved array part
+  t = {[3] = 3, [4] = 4}
+  table.reserve(t, 4)
+  t[1], t[2] = 1, 2
+  assert(#t == 4)
+
+  assert(not pcall(table.reserve))
+  assert(not pcall(table.reserve, {}, -1))
+  assert(not pcall(table.reserve, {}, 1, -1))
+  assert(not pcall(table.reserve, table.freeze({}), 1))
+end
+
+-- test geometric growth of arrays filled in order
+do
+  local t = {}
+  for i=1,1000 do
+    t[i] = i
+    assert(#t == i)
+  end
+
+  -- keys from the hash part are moved into the grown array part
+  t = {[3] = 3, x = 1}
+  t[1] = 1
+  t[2] = 2
+  assert(#t == 3 and t.x == 1)
+end
+
+-- test small tables that keep their hash part inline as it grows and shrinks
+do
+  local function count(t)
+    local n = 0
+    for _ in pairs(t) do n += 1 end
+    return n
+  end
+
+  local t = {x = 1, y = 2}
+  assert(t.x == 1 and t.y == 2 and count(t) == 2)
+
+  -- grow past inline storage
+  for i = 1, 20 do t["k" .. i] = i end
+  assert(t.x == 1 and t.k20 == 20 and count(t) == 22)
+
+  -- shrink back into it; rehash only happens when the hash part runs out of free nodes
+  for i = 1, 20 do t["k" .. i] = nil end
+  for i = 1, 40 do t["n" .. i] = i; t["n" .. i] = nil end
+  assert(t.x == 1 and t.y == 2 and count(t) == 2)
+
+  -- clones of small tables get their own inline storage
+  local c = table.clone({a = 1, b = 2, c = 3})
+  c.d = 4
+  c.e = 5
+  assert(c.a == 1 and c.e == 5 and count(c) == 5)
+
+  -- all keys move to the array part
+  t = {a = 1}
+  t.a = nil
+  for i = 1, 10 do t[i] = i end
+  assert(#t == 10)
+
+  t = nil
+  c = nil
+  collectgarbage()
+end
+
 -- test boundary invariant maintenance during rehash
 do
   local arr = table.create(5, 42)
@@ -722,4 +879,14 @@ assert((function ()
   return t.hi
 end)() == nil)
 
+-- table.clear resets both parts of large tables and leaves them reusable
+do
+  local t = table.create(1000, 1)
+  for i = 1, 1000 do t["k" .. i] = i end
+  table.clear(t)
+  assert(next(t) == nil and #t == 0)
+  for i = 1, 1000 do t[i] = i; t["k" .. i] = i end
+  assert(#t == 1000 and t.k1000 == 1000 and t[500] == 500)
+end
+
 return"OK"
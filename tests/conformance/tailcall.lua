@@ -0,0 +1,133 @@
+-- This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+print("testing tail calls")
+
+-- tail calls reuse the frame of the caller so deep recursion doesn't overflow the call stack
+local function countdown(n)
+  if n == 0 then return "done" end
+  return countdown(n - 1)
+end
+
+assert(countdown(1000000) == "done")
+
+-- mutual recursion, as used by state machines
+local iseven, isodd
+
+function iseven(n)
+  if n == 0 then return true end
+  return isodd(n - 1)
+end
+
+function isodd(n)
+  if n == 0 then return false end
+  return iseven(n - 1)
+end
+
+assert(iseven(300000) == true)
+assert(isodd(300001) == true)
+
+-- arguments are adjusted to the parameters of the callee
+local function sum3(a, b, c)
+  return (a or 0) + (b or 0) + (c or 0)
+end
+
+local function spread(n, ...)
+  if n == 0 then return sum3(...) end
+  return spread(n - 1, ...)
+end
+
+assert(spread(100000, 1, 2, 3, 4) == 6)
+assert(spread(10, 1) == 1)
+assert(spread(10) == 0)
+
+-- variadic callers and callees, including tail calls that change the number of variadic arguments
+local function pack(...)
+  return select('#', ...), ...
+end
+
+local function shift(n, first, ...)
+  if n == 0 then return pack(first, ...) end
+  return shift(n - 1, ...)
+end
+
+local c, a, b = shift(2, 1, 2, 3, 4)
+assert(c == 2 and a == 3 and b == 4)
+assert(select('#', shift(0)) == 2)
+
+-- the caller of the first function receives all results of the last one, adjusted to the count it expects
+local function many() return 1, 2, 3 end
+local function none() end
+local function forward(f) return f() end
+
+local x, y = forward(many)
+assert(x == 1 and y == 2)
+assert(select('#', forward(many)) == 3)
+assert(#{forward(many)} == 3)
+local z = forward(none)
+assert(z == nil and select('#', forward(none)) == 0)
+
+-- method calls in tail position
+local machine = { count = 0 }
+
+function machine:step(n)
+  if n == 0 then return self.count end
+  self.count += 1
+  return self:step(n - 1)
+end
+
+assert(machine:step(100000) == 100000)
+
+-- C functions and __call targets in tail position are called as usual
+local function ctail(...) return pcall(...) end
+local ok, msg = ctail(error, "boom", 0)
+assert(not ok and msg == "boom")
+
+local callable = setmetatable({}, { __call = function(self, v) return v * 2 end })
+local function calltail(v) return callable(v) end
+assert(calltail(21) == 42)
+
+-- functions entered from C (here, pcall) keep their own frame and tail call from it
+assert(select(2, pcall(countdown, 100000)) == "done")
+
+-- captured locals are closed before the frame is reused
+local function capture(n)
+  local v = n
+  local function get() return v end
+  if n == 0 then return get end
+  return capture(n - 1)
+end
+
+assert(capture(1000)() == 0)
+
+local closures = {}
+local function collect(n)
+  if n == 0 then return closures end
+  local v = n
+  closures[n] = function() return v end
+  return collect(n - 1)
+end
+
+collect(100)
+for i = 1, 100 do assert(closures[i]() == i) end
+
+-- tail calls across yields
+local function ping(n)
+  if n == 0 then return coroutine.yield("yielded") end
+  return ping(n - 1)
+end
+
+local co = coroutine.create(function() return ping(10000) end)
+local ok1, v1 = coroutine.resume(co)
+assert(ok1 and v1 == "yielded")
+local ok2, v2 = coroutine.resume(co, "resumed")
+assert(ok2 and v2 == "resumed" and coroutine.status(co) == "dead")
+
+-- errors raised after a tail call are reported as usual
+local function fail(n)
+  if n == 0 then error("failed") end
+  return fail(n - 1)
+end
+
+local okf, errf = pcall(fail, 10)
+assert(not okf and errf:find("failed"))
+
+return "OK"
@@ -326,4 +326,15 @@ do    -- testing out of range values
   checkerror("missing size", unpack, "c-2", "")
 end
 
+do    -- unpacking from buffers
+  local x = pack("<i4 z s1 d", -5, "hello", "ab", 1.5)
+  local b = buffer.fromstring(x)
+  local i, z, s, d, p = unpack("<i4 z s1 d", b)
+  assert(i == -5 and z == "hello" and s == "ab" and d == 1.5 and p == #x + 1)
+  assert(unpack("<i4", b, p - 8 - 3 - 6) == unpack("<i4", x, p - 8 - 3 - 6))
+  checkerror("data string too short", unpack, "i4", buffer.create(3))
+  checkerror("unfinished string", unpack, "z", buffer.fromstring("abc"))
+  checkerror("out of string", unpack, "i1", buffer.create(1), 3)
+end
+
 return "OK"
@@ -0,0 +1,57 @@
+-- This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+print("testing userdata fields")
+
+local e = newentity()
+
+-- reads and writes of inline fields
+assert(e.health == 100)
+e.health = 50
+assert(e.health == 50)
+e.speed = 1.5
+assert(e.speed == 1.5)
+e.level = 3.7
+assert(e.level == 3)
+assert(e.alive == true)
+e.alive = false
+assert(e.alive == false)
+e.pos = vector(1, 2, 3)
+assert(e.pos == vector(1, 2, 3))
+assert(e.id == 7)
+
+-- fields are accessed with dynamic keys as well
+local k = "health"
+assert(e[k] == 50)
+e[k] = 10
+assert(e.health == 10)
+
+-- other keys go through metamethods
+assert(e.name == "index:name")
+assert(e[1] == "index:1")
+
+-- read-only fields and mismatched value types
+local ok, err = pcall(function() e.id = 5 end)
+assert(not ok and err:find("read%-only field 'id'"))
+ok, err = pcall(function() e.health = "x" end)
+assert(not ok and err:find("invalid value %(string%) for field 'health'"))
+ok, err = pcall(function() e.alive = 1 end)
+assert(not ok)
+assert(e.id == 7 and e.health == 10 and e.alive == false)
+
+-- repeated accesses from the same instruction
+local s = 0
+for i = 1, 100 do
+  e.level = i
+  s += e.level
+end
+assert(s == 5050)
+
+-- fields past the end of a smaller userdata with the same tag are not accessible
+local small = newsmall()
+assert(small.health == 100)
+assert(small.pos == "index:pos")
+
+-- userdata with other tags are not affected
+local proxy = newproxy()
+assert(not pcall(function() return proxy.health end))
+
+return "OK"
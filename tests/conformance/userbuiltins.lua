@@ -0,0 +1,26 @@
+-- This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+print("testing user builtins")
+
+-- calls with matching arguments are handled by the builtin
+local s = 0
+for i = 1, 100 do
+  s += clamp(i, 10, 90)
+end
+assert(s == 5040)
+
+assert(Engine.lerp(0, 10, 0.5) == 5)
+assert(Engine.lerp(vector(0, 0, 0), vector(2, 4, 6), 0.5) == vector(1, 2, 3))
+
+-- multiple results and MULTRET calls
+local a, b, c = Engine.minmax(3, 1)
+assert(a == 1 and b == 3 and c == nil)
+assert(select('#', Engine.minmax(1, 2)) == 2)
+local t = {Engine.minmax(5, 4)}
+assert(#t == 2 and t[1] == 4 and t[2] == 5)
+
+-- mismatched arguments and unregistered builtins go through the regular call
+assert(clamp("5", 0, 1) == 1)
+assert(not pcall(function() return clamp(1, 2) end))
+assert(unregistered(7) == 7)
+
+return "OK"
@@ -102,6 +102,26 @@ do    -- error indication in utf8.len
   check("汉字\xBF", #("汉字") + 1)
   check("\xBFhello", 1)
   check("hel\xBFlo", 4)
+  -- errors after and inside long ASCII runs
+  check(string.rep("a", 37) .. "\xE3" .. string.rep("b", 20), 38)
+  check(string.rep("a", 8) .. "\x80", 9)
+  check("\xE4\xB8\x80" .. string.rep("z", 16) .. "\xFF", 20)
+end
+
+do    -- ASCII runs mixed with multi-byte characters
+  local s = string.rep("abcdefg", 5) .. "\u{4E00}" .. string.rep("x", 9) .. "\u{1F600}" .. "tail"
+  assert(utf8.len(s) == 35 + 1 + 9 + 1 + 4)
+  for i = 1, #s do
+    for j = i, #s, 5 do
+      local n = 0
+      for p in utf8.codes(s) do
+        if p >= i and p <= j then n += 1 end
+      end
+      if utf8.len(s, i) then
+        assert(utf8.len(s, i, j) == n)
+      end
+    end
+  end
 end
 
 -- errors in utf8.codes
@@ -151,6 +151,30 @@ assert(selectmany(-2, 10, 20, 30) == "20,30")
 assert(selectone('3', 10, 20, 30) == 30)
 assert(selectmany('3', 10, 20, 30) == "30")
 
+function selecttwo(n, ...)
+    local a, b = select(n, ...)
+    return a, b
+end
+
+assert(select('#', selecttwo(2, 10, 20, 30)) == 2)
+assert(selecttwo(2, 10, 20, 30) == 20 and select(2, selecttwo(2, 10, 20, 30)) == 30)
+assert(select(2, selecttwo(3, 10, 20, 30)) == nil)
+assert(selecttwo(-1, 10, 20, 30) == 30)
+assert(selecttwo(1.5, 10, 20, 30) == 10)
+assert(selectmany(2.5, 10, 20, 30) == "20,30")
+assert(selectmany(-3, 10, 20, 30) == "10,20,30")
+
+assert(not pcall(selectone, 0, 10, 20))
+assert(not pcall(selectmany, -4, 10, 20, 30))
+assert(not pcall(selecttwo, 0))
+
+-- results that don't fit in the current stack go through the fallback
+do
+  local args = table.create(5000, 7)
+  local function count(...) return select('#', select(2, ...)) end
+  assert(count(table.unpack(args)) == 4999)
+end
+
 -- varargs for main chunks
 f = loadstring[[ return {...} ]]
 x = f(2,3)
@@ -5,10 +5,10 @@
 # This is useful to find memory leaks - reachability analysis answers the question "why is this set of objects not freed"
 # This tool can also be ran with just one snapshot, in which case it displays all allocated objects
 # The result of analysis is a .svg file which can be viewed in a browser
-# To generate these dumps, use luaC_dump, ideally preceded by luaC_fullgc
+# To generate these dumps, use luaC_dump or luaC_dumpbinary, ideally preceded by luaC_fullgc
 
 import argparse
-import json
+import heapsnapshot
 import sys
 import svg
 
@@ -52,13 +52,10 @@ def getkey(heap, obj, key):
 # load files
 if arguments.snapshotnew == None:
     dumpold = None
-    with open(arguments.snapshot) as f:
-        dump = json.load(f)
+    dump = heapsnapshot.load(arguments.snapshot)
 else:
-    with open(arguments.snapshot) as f:
-        dumpold = json.load(f)
-    with open(arguments.snapshotnew) as f:
-        dump = json.load(f)
+    dumpold = heapsnapshot.load(arguments.snapshot)
+    dump = heapsnapshot.load(arguments.snapshotnew)
 
 heap = dump["objects"]
 
@@ -0,0 +1,137 @@
+#!/usr/bin/python3
+# This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
+
+# Loads heap snapshots produced by luaC_dump (JSON) or luaC_dumpbinary (binary)
+# Both formats are loaded into the same structure with "objects", "roots" and "stats" sections, see luaC_dump for details
+
+import json
+import struct
+
+MAGIC = b"LUAUHEAP"
+
+TYPES = ["string", "table", "function", "userdata", "thread", "buffer", "proto", "upvalue"]
+
+# field kinds: 's' string, 'r' reference, 'l' reference list, 'i' integer, 'b' boolean, 'n' list of optional strings
+FIELDS = {
+    1: ("data", 's'),
+    2: ("pairs", 'l'),
+    3: ("array", 'l'),
+    4: ("metatable", 'r'),
+    5: ("env", 'r'),
+    6: ("name", 's'),
+    7: ("upvalues", 'l'),
+    8: ("proto", 'r'),
+    9: ("tag", 'i'),
+    10: ("source", 's'),
+    11: ("line", 'i'),
+    12: ("stack", 'l'),
+    13: ("stacknames", 'n'),
+    14: ("constants", 'l'),
+    15: ("protos", 'l'),
+    16: ("open", 'b'),
+    17: ("object", 'r'),
+}
+
+class Reader:
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def byte(self):
+        value = self.data[self.pos]
+        self.pos += 1
+        return value
+
+    def varint(self):
+        result = 0
+        shift = 0
+        while True:
+            value = self.data[self.pos]
+            self.pos += 1
+            result |= (value & 127) << shift
+            shift += 7
+            if value < 128:
+                return result
+
+    def ref(self):
+        value, = struct.unpack_from("<Q", self.data, self.pos)
+        self.pos += 8
+        return hex(value) if value else None
+
+    def refs(self):
+        count = self.varint()
+        values = struct.unpack_from("<{}Q".format(count), self.data, self.pos)
+        self.pos += count * 8
+        return [hex(v) if v else None for v in values]
+
+    def string(self):
+        length = self.varint()
+        value = self.data[self.pos:self.pos + length].decode("utf-8", errors = "replace")
+        self.pos += length
+        return value
+
+def loadbinary(data):
+    reader = Reader(data)
+    reader.pos = len(MAGIC)
+
+    version = reader.byte()
+    if version != 1:
+        raise ValueError("unsupported heap snapshot version {}".format(version))
+
+    objects = {}
+    roots = {}
+    stats = {"size": 0, "categories": {}}
+
+    while True:
+        tag = chr(reader.byte())
+
+        if tag == 'O':
+            addr = reader.ref()
+            obj = {"type": TYPES[reader.byte()], "cat": reader.byte(), "size": reader.varint()}
+
+            while True:
+                field = reader.byte()
+                if field == 0:
+                    break
+
+                name, kind = FIELDS[field]
+
+                if kind == 's':
+                    obj[name] = reader.string()
+                elif kind == 'r':
+                    obj[name] = reader.ref()
+                elif kind == 'l':
+                    obj[name] = reader.refs()
+                elif kind == 'i':
+                    obj[name] = reader.varint()
+                elif kind == 'b':
+                    obj[name] = reader.byte() != 0
+                elif kind == 'n':
+                    obj[name] = [reader.string() if reader.byte() else None for _ in range(reader.varint())]
+
+            objects[addr] = obj
+        elif tag == 'R':
+            name = reader.string()
+            roots[name] = reader.ref()
+        elif tag == 'T':
+            stats["size"] = reader.varint()
+        elif tag == 'C':
+            cat = reader.byte()
+            size = reader.varint()
+            name = reader.string()
+            stats["categories"][str(cat)] = {"name": name, "size": size} if name else {"size": size}
+        elif tag == 'E':
+            break
+        else:
+            raise ValueError("unexpected record {} at offset {}".format(tag, reader.pos - 1))
+
+    return {"objects": objects, "roots": roots, "stats": stats}
+
+def load(path):
+    with open(path, "rb") as f:
+        data = f.read()
+
+    if data.startswith(MAGIC):
+        return loadbinary(data)
+
+    return json.loads(data)
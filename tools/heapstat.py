@@ -2,9 +2,9 @@
 # This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
 
 # Given a heap snapshot, this tool gathers basic statistics about the allocated objects
-# To generate a snapshot, use luaC_dump, ideally preceded by luaC_fullgc
+# To generate a snapshot, use luaC_dump or luaC_dumpbinary, ideally preceded by luaC_fullgc
 
-import json
+import heapsnapshot
 import sys
 from collections import defaultdict
 
@@ -25,9 +25,8 @@ def getkey(heap, obj, key):
                 return None
     return None
 
-with open(sys.argv[1]) as f:
-    dump = json.load(f)
-    heap = dump["objects"]
+dump = heapsnapshot.load(sys.argv[1])
+heap = dump["objects"]
 
 size_type = {}
 size_udata = {}
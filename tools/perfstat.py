@@ -2,8 +2,11 @@
 # This file is part of the Luau programming language and is licensed under MIT License; see LICENSE.txt for details
 
 # Given a profile dump, this tool displays top functions based on the stacks listed in the profile
+# Given results of bench/bench_codegen.py, this tool displays tests that benefit the least from native code generation
 
 import argparse
+import json
+import sys
 
 class Node:
     def __init__(self):
@@ -19,13 +22,28 @@ class Node:
         else:
             return self.function
 
-argumentParser = argparse.ArgumentParser(description='Display summary statistics from Luau sampling profiler dumps')
+def displayCodegenResults(results):
+    print("Lowest native code speedup:")
+    for r in sorted(results, key=lambda r: r["speedup"])[:arguments.limit]:
+        print(f"{r['speedup']:8.2f}%: {r['name']} ({r['file']}, {r['nativeCodeSize']:,} bytes native code, {r['compileTime']:.3f} ms compile)")
+    print()
+    print("Largest native code per speedup:")
+    for r in sorted(results, key=lambda r: r["nativeCodeSize"] / max(r["speedup"], 1.0), reverse=True)[:arguments.limit]:
+        print(f"{r['nativeCodeSize']:12,} bytes ({r['speedup']:.2f}%): {r['name']} ({r['file']})")
+
+argumentParser = argparse.ArgumentParser(description='Display summary statistics from Luau sampling profiler dumps or native code generation benchmark results')
 argumentParser.add_argument('source_file', type=open)
 argumentParser.add_argument('--limit', dest='limit', type=int, default=10, help='Display top N functions')
 
 arguments = argumentParser.parse_args()
 
-dump = arguments.source_file.readlines()
+dump = arguments.source_file.read()
+
+if dump.lstrip().startswith("["):
+    displayCodegenResults(json.loads(dump))
+    sys.exit(0)
+
+dump = dump.splitlines()
 
 stats = {}
 total = 0